@@ -68,6 +68,38 @@ void Context::setDeterministicCuDNN(bool b) {
   deterministic_cudnn = b;
 }
 
+bool Context::lazyZeroFill() const {
+  return lazy_zero_fill;
+}
+
+void Context::setLazyZeroFill(bool b) {
+  lazy_zero_fill = b;
+}
+
+bool Context::deterministicScatter() const {
+  return deterministic_scatter;
+}
+
+void Context::setDeterministicScatter(bool b) {
+  deterministic_scatter = b;
+}
+
+bool Context::allowFP16ReductionCuBLAS() const {
+  return allow_fp16_reduction_cublas;
+}
+
+void Context::setAllowFP16ReductionCuBLAS(bool b) {
+  allow_fp16_reduction_cublas = b;
+}
+
+bool Context::allowFP32TensorOpCuBLAS() const {
+  return allow_fp32_tensor_op_cublas;
+}
+
+void Context::setAllowFP32TensorOpCuBLAS(bool b) {
+  allow_fp32_tensor_op_cublas = b;
+}
+
 bool Context::benchmarkCuDNN() const {
   return benchmark_cudnn;
 }
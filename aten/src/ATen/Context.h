@@ -130,6 +130,25 @@ class CAFFE2_API Context {
   void setBenchmarkCuDNN(bool);
   bool deterministicCuDNN() const;
   void setDeterministicCuDNN(bool);
+  // If set, large CPU zeros() tensors are backed by anonymous mappings,
+  // whose pages are only faulted in (already zeroed) when first touched.
+  bool lazyZeroFill() const;
+  void setLazyZeroFill(bool);
+  // If set, the CUDA kernels of scatter_add_ and index_add_ sum floating point
+  // values in an order that doesn't depend on scheduling, with a sorted
+  // segment reduction instead of atomics; slower, but reproducible.
+  bool deterministicScatter() const;
+  void setDeterministicScatter(bool);
+  // If set, half precision cuBLAS GEMMs accumulate in half precision on
+  // devices with tensor cores instead of in single precision; faster, but
+  // the sums of long rows lose precision.
+  bool allowFP16ReductionCuBLAS() const;
+  void setAllowFP16ReductionCuBLAS(bool);
+  // If set, single precision cuBLAS GEMMs may round their inputs to half
+  // precision to use the tensor cores (CUDA 10 and compute capability 7.0 or
+  // later), accumulating in single precision.
+  bool allowFP32TensorOpCuBLAS() const;
+  void setAllowFP32TensorOpCuBLAS(bool);
   std::unique_ptr<Generator>
     generator_registry[static_cast<int>(DeviceType::COMPILE_TIME_MAX_DEVICE_TYPES)];
 private:
@@ -154,6 +173,10 @@ private:
   bool enabled_cudnn = true;
   bool deterministic_cudnn = false;
   bool benchmark_cudnn = false;
+  bool lazy_zero_fill = false;
+  bool deterministic_scatter = false;
+  bool allow_fp16_reduction_cublas = false;
+  bool allow_fp32_tensor_op_cublas = false;
   std::atomic<size_t> next_id;
   std::unique_ptr<THCState, void(*)(THCState*)> thc_state;
   std::unique_ptr<THHState, void(*)(THHState*)> thh_state;
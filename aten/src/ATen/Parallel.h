@@ -1,16 +1,12 @@
 #pragma once
 #include <ATen/ATen.h>
+#include <ATen/Config.h>
 #include <c10/core/thread_pool.h>
 
 #include <atomic>
 #include <cstddef>
 #include <exception>
-
-#ifdef _OPENMP
-#define INTRA_OP_PARALLEL
-
-#include <omp.h>
-#endif
+#include <functional>
 
 namespace at {
 namespace internal {
@@ -37,56 +33,29 @@ CAFFE2_API size_t get_num_threads();
 
 // Returns the current thread number (starting from 0)
 // in the current parallel region, or 0 in the sequential region
-inline int get_thread_num() {
-#ifdef _OPENMP
-  return omp_get_thread_num();
-#else
-  return 0;
-#endif
-}
+CAFFE2_API int get_thread_num();
 
-inline bool in_parallel_region() {
-#ifdef _OPENMP
-  return omp_in_parallel();
-#else
-  return false;
-#endif
-}
+// Checks whether the code runs in parallel region
+CAFFE2_API bool in_parallel_region();
+
+/*
+parallel_for
+
+begin: index at which to start applying user function
+
+end: index at which to stop applying user function
 
+grain_size: number of elements per chunk. impacts the degree of parallelization
+
+f: user function applied in parallel to the chunks, signature:
+  void f(int64_t begin, int64_t end)
+*/
 template <class F>
 inline void parallel_for(
     const int64_t begin,
     const int64_t end,
     const int64_t grain_size,
-    const F& f) {
-#ifdef _OPENMP
-  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
-  std::exception_ptr eptr;
-#pragma omp parallel if (!omp_in_parallel() && ((end - begin) >= grain_size))
-  {
-    int64_t num_threads = omp_get_num_threads();
-    int64_t tid = omp_get_thread_num();
-    int64_t chunk_size = divup((end - begin), num_threads);
-    int64_t begin_tid = begin + tid * chunk_size;
-    if (begin_tid < end) {
-      try {
-        f(begin_tid, std::min(end, chunk_size + begin_tid));
-      } catch (...) {
-        if (!err_flag.test_and_set()) {
-          eptr = std::current_exception();
-        }
-      }
-    }
-  }
-  if (eptr) {
-    std::rethrow_exception(eptr);
-  }
-#else
-  if (begin < end) {
-    f(begin, end);
-  }
-#endif
-}
+    const F& f);
 
 /*
 parallel_reduce
@@ -128,26 +97,25 @@ inline scalar_t parallel_reduce(
     const int64_t grain_size,
     const scalar_t ident,
     const F f,
-    const SF sf) {
-  if (in_parallel_region() || get_num_threads() == 1) {
-    return f(begin, end, ident);
-  } else {
-    const int64_t num_results = divup((end - begin), grain_size);
-    std::vector<scalar_t> results(num_results);
-    scalar_t* results_data = results.data();
-#pragma omp parallel for if ((end - begin) >= grain_size)
-    for (int64_t id = 0; id < num_results; id++) {
-      int64_t i = begin + id * grain_size;
-      results_data[id] = f(i, i + std::min(end - i, grain_size), ident);
-    }
-    return std::accumulate(
-        results_data, results_data + results.size(), ident, sf);
-  }
-}
+    const SF sf);
 
 // Returns a detailed string describing parallelization settings
 CAFFE2_API std::string get_parallel_info();
 
+// Sets number of threads used for inter-op parallelism, i.e. for running
+// independent tasks such as TorchScript `fork`ed subgraphs concurrently.
+// Must be called before the inter-op pool is first used.
+CAFFE2_API void set_num_interop_threads(size_t);
+
+// Returns the number of threads used for inter-op parallelism
+CAFFE2_API size_t get_num_interop_threads();
+
+// Launches an inter-op parallel task on the shared inter-op thread pool.
+// Tasks of a higher priority are picked first.
+CAFFE2_API void launch(
+    const std::function<void()>& func,
+    c10::TaskPriority priority = c10::TaskPriority::NORMAL);
+
 class CAFFE2_API PTThreadPool : public c10::ThreadPool {
  public:
   explicit PTThreadPool(
@@ -158,3 +126,9 @@ class CAFFE2_API PTThreadPool : public c10::ThreadPool {
 };
 
 } // namespace at
+
+#if AT_PARALLEL_OPENMP
+#include <ATen/ParallelOpenMP.h>
+#elif AT_PARALLEL_NATIVE
+#include <ATen/ParallelNative.h>
+#endif
@@ -0,0 +1,315 @@
+#include <ATen/Parallel.h>
+
+#if AT_PARALLEL_NATIVE
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <c10/util/numa.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef TH_BLAS_MKL
+#include <mkl.h>
+#endif
+
+namespace at {
+
+namespace {
+// Number of threads set by the user, -1 if not set
+std::atomic<int> num_intraop_threads{-1};
+
+// Thread number of the current thread within the innermost parallel region
+thread_local int thread_num_ = 0;
+// Whether the current thread is executing a chunk of a parallel region
+thread_local bool in_parallel_region_ = false;
+
+int default_num_threads() {
+  auto nthreads = std::thread::hardware_concurrency();
+  return nthreads > 0 ? nthreads : 1;
+}
+
+// Intra-op pool threads run chunks of a parallel region themselves, so any
+// OpenMP or MKL code they call into is kept single threaded to avoid
+// oversubscription. Done on the first task a thread runs rather than in
+// init_thread(), which the pool threads may call before the derived
+// class is fully constructed.
+void init_intraop_thread() {
+  static thread_local bool initialized = false;
+  if (!initialized) {
+    initialized = true;
+#ifdef _OPENMP
+    omp_set_num_threads(1);
+#endif
+#ifdef TH_BLAS_MKL
+    mkl_set_num_threads(1);
+#endif
+  }
+}
+
+// The pool is sized once, the first time a parallel region is entered, with
+// one thread less than get_num_threads() since the calling thread also takes
+// part in the work.
+PTThreadPool& get_intraop_pool() {
+  static PTThreadPool pool(get_num_threads() - 1);
+  return pool;
+}
+
+// A slice of the chunk index space owned by one participant of a parallel
+// region. The owner pops chunks from the front; thieves split off the back.
+struct TaskSlice {
+  std::mutex mutex;
+  int64_t next = 0;
+  int64_t end = 0;
+};
+
+struct ParallelRegion {
+  ParallelRegion(
+      int64_t begin,
+      int64_t end,
+      int64_t grain_size,
+      int64_t num_slices,
+      const std::function<void(int64_t, int64_t)>& f)
+      : begin(begin),
+        end(end),
+        grain_size(grain_size),
+        num_chunks(divup(end - begin, grain_size)),
+        slices(num_slices),
+        remaining(num_chunks),
+        f(f) {
+    for (int64_t i = 0; i < num_slices; ++i) {
+      slices[i].next = i * num_chunks / num_slices;
+      slices[i].end = (i + 1) * num_chunks / num_slices;
+    }
+  }
+
+  // Claims the lower half (at least one chunk) of what is left in slot's
+  // slice, leaving the upper half to be stolen by idle threads. Halving keeps
+  // the number of calls into f per thread logarithmic in the number of chunks
+  // while the remaining work stays splittable until the end.
+  bool pop(int64_t slot, int64_t& chunk_begin, int64_t& chunk_end) {
+    auto& slice = slices[slot];
+    std::lock_guard<std::mutex> lock(slice.mutex);
+    if (slice.next < slice.end) {
+      chunk_begin = slice.next;
+      slice.next += std::max((slice.end - slice.next) / 2, (int64_t)1);
+      chunk_end = slice.next;
+      return true;
+    }
+    return false;
+  }
+
+  // Moves the upper half of the largest remaining slice into slot's slice.
+  // Returns false if there was nothing left to steal.
+  bool steal(int64_t slot) {
+    while (true) {
+      int64_t victim = -1;
+      int64_t victim_size = 0;
+      for (int64_t i = 0; i < (int64_t)slices.size(); ++i) {
+        if (i == slot) {
+          continue;
+        }
+        std::lock_guard<std::mutex> lock(slices[i].mutex);
+        auto size = slices[i].end - slices[i].next;
+        if (size > victim_size) {
+          victim = i;
+          victim_size = size;
+        }
+      }
+      if (victim < 0) {
+        return false;
+      }
+      int64_t stolen_begin, stolen_end;
+      {
+        auto& slice = slices[victim];
+        std::lock_guard<std::mutex> lock(slice.mutex);
+        if (slice.next >= slice.end) {
+          // The victim drained its slice in the meantime, look again
+          continue;
+        }
+        stolen_end = slice.end;
+        stolen_begin = slice.next + (slice.end - slice.next) / 2;
+        slice.end = stolen_begin;
+      }
+      auto& own = slices[slot];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      own.next = stolen_begin;
+      own.end = stolen_end;
+      return true;
+    }
+  }
+
+  void run_chunks(int64_t chunk_begin, int64_t chunk_end) {
+    if (!err_flag.load()) {
+      try {
+        f(begin + chunk_begin * grain_size,
+          std::min(end, begin + chunk_end * grain_size));
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!err_flag.exchange(true)) {
+          eptr = std::current_exception();
+        }
+      }
+    }
+    auto num_chunks_run = chunk_end - chunk_begin;
+    if (remaining.fetch_sub(num_chunks_run) == num_chunks_run) {
+      std::lock_guard<std::mutex> lock(mutex);
+      done.notify_all();
+    }
+  }
+
+  void work(int64_t slot) {
+    int64_t chunk_begin, chunk_end;
+    while (pop(slot, chunk_begin, chunk_end) ||
+           (steal(slot) && pop(slot, chunk_begin, chunk_end))) {
+      run_chunks(chunk_begin, chunk_end);
+    }
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return remaining.load() == 0; });
+  }
+
+  const int64_t begin;
+  const int64_t end;
+  const int64_t grain_size;
+  const int64_t num_chunks;
+  std::vector<TaskSlice> slices;
+  std::atomic<int64_t> remaining;
+  // Only dereferenced while a chunk is claimed, which happens strictly
+  // before the calling thread returns from _parallel_run
+  const std::function<void(int64_t, int64_t)>& f;
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::atomic<bool> err_flag{false};
+  std::exception_ptr eptr;
+};
+
+// Sets the thread number and parallel region flag for the duration of a
+// participant's share of a parallel region, restoring the enclosing region's
+// values afterwards so that nested regions don't leak their numbering.
+struct ParallelRegionGuard {
+  explicit ParallelRegionGuard(int thread_num)
+      : prev_thread_num_(thread_num_),
+        prev_in_parallel_region_(in_parallel_region_) {
+    thread_num_ = thread_num;
+    in_parallel_region_ = true;
+  }
+
+  ~ParallelRegionGuard() {
+    thread_num_ = prev_thread_num_;
+    in_parallel_region_ = prev_in_parallel_region_;
+  }
+
+ private:
+  int prev_thread_num_;
+  bool prev_in_parallel_region_;
+};
+
+} // namespace
+
+void init_num_threads() {
+  auto nthreads = num_intraop_threads.load();
+  if (nthreads > 0) {
+    set_num_threads(nthreads);
+  } else {
+#ifdef _OPENMP
+    // Non-ATen OpenMP code (e.g. MKL-DNN) shouldn't spin up another
+    // full-sized set of threads next to the intra-op pool
+    omp_set_num_threads(1);
+#endif
+  }
+}
+
+void set_num_threads(size_t nthreads) {
+  if (nthreads == 0) {
+    return;
+  }
+  num_intraop_threads.store(nthreads);
+#ifdef TH_BLAS_MKL
+  mkl_set_num_threads(nthreads);
+  mkl_set_dynamic(false);
+#endif
+}
+
+size_t get_num_threads() {
+  auto nthreads = num_intraop_threads.load();
+  return nthreads > 0 ? nthreads : default_num_threads();
+}
+
+int get_thread_num() {
+  return thread_num_;
+}
+
+bool in_parallel_region() {
+  return in_parallel_region_;
+}
+
+namespace internal {
+
+void _parallel_run(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& f) {
+  if (begin >= end) {
+    return;
+  }
+  const int64_t chunk_size = std::max(grain_size, (int64_t)1);
+  const int64_t num_slices =
+      std::min((int64_t)get_num_threads(), divup(end - begin, chunk_size));
+  auto region = std::make_shared<ParallelRegion>(
+      begin, end, chunk_size, num_slices, f);
+
+  // Helpers that are picked up by the pool only after all the work has been
+  // claimed find nothing to do and return without touching f. If the pool is
+  // busy (e.g. with the enclosing region of a nested call) the calling thread
+  // simply steals the helpers' slices itself.
+  //
+  // Under a NUMA policy other than the default (see c10/util/numa.h) the
+  // participants take the caller's policy and run on the node of their slot,
+  // the same contiguous grouping that slices the range, so that a slice
+  // normally runs on the node where its first touch placed the pages.
+  const int numa_policy = c10::GetNUMAPolicy();
+  auto& pool = get_intraop_pool();
+  const int64_t num_helpers =
+      std::min(num_slices - 1, (int64_t)pool.size());
+  for (int64_t slot = 1; slot <= num_helpers; ++slot) {
+    pool.run([region, slot, numa_policy, num_slices]() {
+      init_intraop_thread();
+      if (numa_policy != c10::kNUMAPolicyLocal) {
+        c10::NUMARunOnNode(
+            c10::GetNUMATaskNode(numa_policy, slot, num_slices));
+      }
+      ParallelRegionGuard guard(slot);
+      region->work(slot);
+    });
+  }
+
+  {
+    if (numa_policy != c10::kNUMAPolicyLocal && num_slices > 1) {
+      c10::NUMARunOnNode(c10::GetNUMATaskNode(numa_policy, 0, num_slices));
+    }
+    ParallelRegionGuard guard(0);
+    region->work(0);
+  }
+  region->wait();
+
+  if (region->eptr) {
+    std::rethrow_exception(region->eptr);
+  }
+}
+
+} // namespace internal
+
+} // namespace at
+
+#endif // AT_PARALLEL_NATIVE
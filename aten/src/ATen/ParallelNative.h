@@ -0,0 +1,87 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#define INTRA_OP_PARALLEL
+
+namespace at {
+namespace internal {
+
+// Runs f(begin, end) over disjoint subranges of [begin, end) that together
+// cover the whole range, using the calling thread and the intra-op thread
+// pool. The range is cut into grain_size chunks and every subrange starts
+// on a chunk boundary (begin + k * grain_size). Each thread starts on a
+// contiguous slice of chunks and, once it is done, steals the upper half of
+// the largest slice left to another thread, so one slow chunk doesn't hold
+// the others back. A thread may call f several times.
+// Exceptions thrown by f are rethrown in the calling thread.
+CAFFE2_API void _parallel_run(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const std::function<void(int64_t, int64_t)>& f);
+
+} // namespace internal
+
+template <class F>
+inline void parallel_for(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const F& f) {
+  if (begin >= end) {
+    return;
+  }
+  if ((end - begin) < grain_size || get_num_threads() == 1) {
+    f(begin, end);
+    return;
+  }
+  internal::_parallel_run(
+      begin,
+      end,
+      grain_size,
+      [&f](int64_t task_begin, int64_t task_end) {
+        f(task_begin, task_end);
+      });
+}
+
+template <class scalar_t, class F, class SF>
+inline scalar_t parallel_reduce(
+    const int64_t begin,
+    const int64_t end,
+    const int64_t grain_size,
+    const scalar_t ident,
+    const F f,
+    const SF sf) {
+  if (begin >= end) {
+    return ident;
+  }
+  if ((end - begin) < grain_size || get_num_threads() == 1) {
+    return f(begin, end, ident);
+  }
+  // Partial results are kept per grain_size chunk rather than per thread, so
+  // that the combination order (and hence the result of non-associative
+  // floating point reductions) doesn't depend on how work got stolen.
+  const int64_t num_results = divup((end - begin), grain_size);
+  std::vector<scalar_t> results(num_results, ident);
+  scalar_t* results_data = results.data();
+  internal::_parallel_run(
+      begin,
+      end,
+      grain_size,
+      [&](int64_t task_begin, int64_t task_end) {
+        for (int64_t i = task_begin; i < task_end; i += grain_size) {
+          results_data[(i - begin) / grain_size] =
+              f(i, std::min(task_end, i + grain_size), ident);
+        }
+      });
+  return std::accumulate(
+      results_data, results_data + results.size(), ident, sf);
+}
+
+} // namespace at
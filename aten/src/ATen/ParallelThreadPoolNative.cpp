@@ -0,0 +1,81 @@
+#include <ATen/Parallel.h>
+
+#include <atomic>
+#include <thread>
+
+namespace at {
+
+namespace {
+const int NOT_SET = -1;
+const int CONSUMED = -2;
+
+// Number of inter-op threads set by the user;
+// NOT_SET -> positive value -> CONSUMED
+// (CONSUMED - thread pool is initialized)
+// or
+// NOT_SET -> CONSUMED
+std::atomic<int> num_interop_threads{NOT_SET};
+
+size_t default_num_interop_threads() {
+  auto nthreads = std::thread::hardware_concurrency();
+  return nthreads > 0 ? nthreads : 1;
+}
+
+// Inter-op tasks (e.g. forked TorchScript subgraphs) are independent of each
+// other, so they get a pool of their own rather than sharing threads with
+// intra-op parallelism; a task blocked on a Future must not hold up the
+// parallel_for chunks of another op.
+std::shared_ptr<TaskThreadPoolBase> get_interop_pool() {
+  static std::shared_ptr<TaskThreadPoolBase> pool = []() {
+    int nthreads = num_interop_threads.exchange(CONSUMED);
+    return std::make_shared<PTThreadPool>(
+        nthreads > 0 ? nthreads : default_num_interop_threads());
+  }();
+  return pool;
+}
+
+// Factory function for ThreadPoolRegistry; c10::global_work_queue() resolves
+// to the shared inter-op pool.
+std::shared_ptr<TaskThreadPoolBase> createC10ThreadPool(
+    int device_id,
+    int pool_size,
+    bool create_new) {
+  // For now, the only accepted device id is 0
+  // for the JIT inter-op pool (CPU),
+  AT_ASSERT(device_id == 0);
+  // we use the shared thread pool
+  AT_ASSERT(!create_new);
+  // whose size is set with at::set_num_interop_threads
+  return get_interop_pool();
+}
+
+} // namespace
+
+void set_num_interop_threads(size_t nthreads) {
+  AT_CHECK(nthreads > 0, "Expected positive number of threads");
+
+  int no_value = NOT_SET;
+  AT_CHECK(
+      num_interop_threads.compare_exchange_strong(no_value, nthreads),
+      "Error: cannot set number of interop threads after parallel work "
+      "has started or set_num_interop_threads called");
+}
+
+size_t get_num_interop_threads() {
+  int nthreads = num_interop_threads.load();
+  if (nthreads > 0) {
+    return nthreads;
+  } else if (nthreads == NOT_SET) {
+    return default_num_interop_threads();
+  } else {
+    return get_interop_pool()->size();
+  }
+}
+
+void launch(const std::function<void()>& func, c10::TaskPriority priority) {
+  get_interop_pool()->runWithPriority(func, priority);
+}
+
+C10_REGISTER_CREATOR(ThreadPoolRegistry, C10, createC10ThreadPool);
+
+} // namespace at
@@ -4,6 +4,8 @@
 #include <c10/core/TensorImpl.h>
 #include <c10/util/Exception.h>
 
+#include <mutex>
+
 namespace at {
 struct CAFFE2_API SparseTensorImpl : public TensorImpl {
   // Stored in COO format, indices + values.
@@ -29,6 +31,15 @@ struct CAFFE2_API SparseTensorImpl : public TensorImpl {
   // because many algorithms proceed by merging two sorted lists (of indices).
   bool coalesced_ = false;
 
+  // Row pointers of the CSR form of a coalesced tensor with two sparse
+  // dimensions, computed lazily by sparse-dense matrix multiplication so that
+  // repeated products with the same matrix skip the conversion.  The cache
+  // is dropped whenever the indices, the sizes or the coalesced flag are
+  // changed through this class; like `coalesced_`, it is not kept in sync
+  // with in-place writes to the indices tensor.
+  Tensor crow_indices_;
+  mutable std::mutex crow_indices_mutex_;
+
 public:
   // Public for now...
   explicit SparseTensorImpl(at::TensorTypeId, const caffe2::TypeMeta&);
@@ -40,8 +51,23 @@ public:
   Tensor indices() const { return indices_; }
   Tensor values() const { return values_; }
 
+  // Returns the cached CSR row pointers, or an undefined tensor if they have
+  // not been computed since the last change to the indices.
+  Tensor crow_indices() const {
+    std::lock_guard<std::mutex> guard(crow_indices_mutex_);
+    return crow_indices_;
+  }
+
+  // NOTE: this function is only used internally and not exposed to Python frontend
+  void set_crow_indices(const Tensor& crow_indices) {
+    AT_ASSERT(coalesced_ && sparse_dim_ == 2);
+    AT_ASSERT(crow_indices.dim() == 1 && crow_indices.size(0) == sizes()[0] + 1);
+    std::lock_guard<std::mutex> guard(crow_indices_mutex_);
+    crow_indices_ = crow_indices;
+  }
+
   IntArrayRef strides() const override;
-  bool is_contiguous() const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
   int64_t stride(int64_t d) const override;
   void resize_dim(int64_t ndim) override;
   void set_size(int64_t dim, int64_t new_size) override;
@@ -58,10 +84,11 @@ public:
   // respect to indices and values
   void raw_resize_(int64_t sparse_dim, int64_t dense_dim, IntArrayRef size) {
     AT_CHECK(allow_tensor_metadata_change(), "raw_resize_ is not allowed on Tensor created from .data or .detach()");
-    sizes_ = size.vec();
+    sizes_and_strides_.set_sizes(size);
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
     refresh_numel();
+    clear_crow_indices();
   }
 
   // NOTE: This function preserves invariants of sparse_dim/dense_dim with respect to
@@ -128,7 +155,7 @@ public:
         "shrinking the size of dense dimensions (from ", dense_size_original, " to ", dense_size_new, ") on a non-empty sparse tensor is not supported.\n", alt_options_msg);
     }
 
-    if ((!size.equals(sizes_)) || (sparse_dim != sparse_dim_) || (dense_dim != dense_dim_)) {
+    if ((!size.equals(sizes())) || (sparse_dim != sparse_dim_) || (dense_dim != dense_dim_)) {
       auto nnz = values().size(0);
       std::vector<int64_t> values_size = {nnz};
       auto dense_size = size.slice(sparse_dim);
@@ -137,10 +164,11 @@ public:
       indices_.resize_({sparse_dim, nnz});
     }
 
-    sizes_ = size.vec();
+    sizes_and_strides_.set_sizes(size);
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
     refresh_numel();
+    clear_crow_indices();
   }
 
   // NOTE: this function will resize the sparse tensor and also set `indices` and `values` to empty.
@@ -148,7 +176,7 @@ public:
     AT_CHECK(allow_tensor_metadata_change(), "resize_and_clear_ is not allowed on Tensor created from .data or .detach()");
     AT_CHECK(sparse_dim + dense_dim == static_cast<int64_t>(size.size()), "number of dimensions must be sparse_dim (", sparse_dim, ") + dense_dim (", dense_dim, "), but got ", size.size());
 
-    sizes_ = size.vec();
+    sizes_and_strides_.set_sizes(size);
     sparse_dim_ = sparse_dim;
     dense_dim_ = dense_dim;
 
@@ -164,6 +192,7 @@ public:
   void set_coalesced(bool coalesced) {
     AT_CHECK(allow_tensor_metadata_change(), "set_coalesced is not allowed on Tensor created from .data or .detach()");
     coalesced_ = coalesced;
+    clear_crow_indices();
   }
 
   // NOTE: this function is only used internally and not exposed to Python frontend
@@ -172,6 +201,7 @@ public:
     AT_ASSERT(new_nnz <= nnz());
     indices_ = indices_.narrow(1, 0, new_nnz);
     values_ = values_.narrow(0, 0, new_nnz);
+    clear_crow_indices();
   }
 
   // Takes indices and values and directly puts them into the sparse tensor, no copy.
@@ -197,10 +227,10 @@ public:
     auto impl = c10::make_intrusive<SparseTensorImpl>(type_id(), dtype());
     // TensorImpl general fields
     // Note that these fields are not used in sparse tensor code, and we copy them here only for completeness.
-    impl->sizes_ = sizes_;
-    impl->strides_ = strides_;
+    impl->sizes_and_strides_ = sizes_and_strides_;
     impl->storage_offset_ = storage_offset_;
     impl->is_contiguous_ = is_contiguous_;
+    impl->is_channels_last_contiguous_ = is_channels_last_contiguous_;
     impl->is_wrapped_number_ = is_wrapped_number_;
     impl->reserved_ = reserved_;
 
@@ -211,10 +241,18 @@ public:
     impl->values_ = values();
     impl->device_opt_ = device();
     impl->coalesced_ = coalesced();
+    // The cached CSR row pointers are not copied: the copy shares the indices,
+    // so they could go stale without either tensor seeing a change through
+    // this class. The copy recomputes them on its first product.
     impl->refresh_numel();
     return impl;
   }
 private:
+    void clear_crow_indices() {
+      std::lock_guard<std::mutex> guard(crow_indices_mutex_);
+      crow_indices_.reset();
+    }
+
     explicit SparseTensorImpl(at::TensorTypeId, const caffe2::TypeMeta&, at::Tensor indices, at::Tensor values);
 };
 
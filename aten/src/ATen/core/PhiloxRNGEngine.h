@@ -0,0 +1,141 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <cstdint>
+
+namespace at {
+
+/**
+ * Philox4x32-10, the counter-based random number generator of Salmon et al.,
+ * "Parallel Random Numbers: As Easy as 1, 2, 3" (SC'11), which is also what
+ * curand_init sets up for the CUDA generator.
+ *
+ * Each 128-bit counter value is encrypted with the 64-bit seed as key into
+ * four 32-bit random numbers. The counter is made of a 64-bit subsequence
+ * and a 64-bit offset, so any position of any stream can be generated
+ * directly, without running the stream up to there. This lets the chunks of
+ * a parallel_for produce exactly the numbers of a serial loop.
+ */
+class philox_engine {
+ public:
+  C10_HOST_DEVICE inline explicit philox_engine(
+      uint64_t seed = 67280421310721,
+      uint64_t subsequence = 0,
+      uint64_t offset = 0) {
+    key_[0] = static_cast<uint32_t>(seed);
+    key_[1] = static_cast<uint32_t>(seed >> 32);
+    counter_[0] = 0;
+    counter_[1] = 0;
+    counter_[2] = static_cast<uint32_t>(subsequence);
+    counter_[3] = static_cast<uint32_t>(subsequence >> 32);
+    state_ = 0;
+    incr_n(offset);
+  }
+
+  // Returns the next 32 random bits of the stream
+  C10_HOST_DEVICE inline uint32_t operator()() {
+    if (state_ == 0) {
+      output_ = rand(counter_, key_);
+      incr();
+    }
+    uint32_t ret = output_[state_];
+    state_ = (state_ + 1) & 3;
+    return ret;
+  }
+
+  // Skips the next n 32-bit numbers of the stream
+  C10_HOST_DEVICE inline void discard(uint64_t n) {
+    // finish the current block first, so that state_ == 0 below
+    while (state_ != 0 && n > 0) {
+      (*this)();
+      n--;
+    }
+    incr_n(n / 4);
+    for (uint64_t i = 0; i < n % 4; i++) {
+      (*this)();
+    }
+  }
+
+  struct Block {
+    uint32_t x[4];
+    C10_HOST_DEVICE inline uint32_t& operator[](int i) { return x[i]; }
+    C10_HOST_DEVICE inline uint32_t operator[](int i) const { return x[i]; }
+  };
+
+  // One Philox4x32-10 encryption of counter with key
+  C10_HOST_DEVICE static inline Block rand(Block counter, Block key) {
+    for (int round = 0; round < 9; round++) {
+      counter = single_round(counter, key);
+      key[0] += kPhilox10A;
+      key[1] += kPhilox10B;
+    }
+    return single_round(counter, key);
+  }
+
+ private:
+  static constexpr uint32_t kPhilox10A = 0x9E3779B9;
+  static constexpr uint32_t kPhilox10B = 0xBB67AE85;
+  static constexpr uint32_t kPhiloxSA = 0xD2511F53;
+  static constexpr uint32_t kPhiloxSB = 0xCD9E8D57;
+
+  C10_HOST_DEVICE static inline uint32_t mulhilo32(uint32_t a, uint32_t b, uint32_t* hi) {
+    uint64_t product = static_cast<uint64_t>(a) * b;
+    *hi = static_cast<uint32_t>(product >> 32);
+    return static_cast<uint32_t>(product);
+  }
+
+  C10_HOST_DEVICE static inline Block single_round(Block ctr, Block key) {
+    uint32_t hi0, hi1;
+    uint32_t lo0 = mulhilo32(kPhiloxSA, ctr[0], &hi0);
+    uint32_t lo1 = mulhilo32(kPhiloxSB, ctr[2], &hi1);
+    Block ret;
+    ret[0] = hi1 ^ ctr[1] ^ key[0];
+    ret[1] = lo1;
+    ret[2] = hi0 ^ ctr[3] ^ key[1];
+    ret[3] = lo0;
+    return ret;
+  }
+
+  // Advances the offset half of the counter by n blocks, carrying into the
+  // subsequence half
+  C10_HOST_DEVICE inline void incr_n(uint64_t n) {
+    uint64_t offset = (static_cast<uint64_t>(counter_[1]) << 32) | counter_[0];
+    uint64_t new_offset = offset + n;
+    counter_[0] = static_cast<uint32_t>(new_offset);
+    counter_[1] = static_cast<uint32_t>(new_offset >> 32);
+    if (new_offset < offset && ++counter_[2] == 0) {
+      ++counter_[3];
+    }
+  }
+
+  C10_HOST_DEVICE inline void incr() {
+    if (++counter_[0]) {
+      return;
+    }
+    if (++counter_[1]) {
+      return;
+    }
+    if (++counter_[2]) {
+      return;
+    }
+    ++counter_[3];
+  }
+
+  Block counter_;
+  Block key_;
+  Block output_;
+  uint32_t state_;
+};
+
+// Uniform numbers in [0, 1) from the bits of a philox_engine
+C10_HOST_DEVICE inline float philox_uniform_float(uint32_t x) {
+  return (x >> 8) * (1.0f / (1u << 24));
+}
+
+C10_HOST_DEVICE inline double philox_uniform_double(uint32_t hi, uint32_t lo) {
+  uint64_t x = (static_cast<uint64_t>(hi) << 32) | lo;
+  return (x >> 11) * (1.0 / (uint64_t(1) << 53));
+}
+
+} // namespace at
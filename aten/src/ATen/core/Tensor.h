@@ -3,6 +3,7 @@
 #include <ATen/core/Type.h>
 #include <c10/core/Device.h>
 #include <c10/core/Layout.h>
+#include <c10/core/MemoryFormat.h>
 #include <c10/core/Scalar.h>
 #include <c10/core/ScalarType.h>
 #include <ATen/core/SparseTensorRef.h>
@@ -165,8 +166,20 @@ class CAFFE2_API Tensor {
   int64_t ndimension() const {
     return dim();
   }
-  bool is_contiguous() const {
-    return impl_->is_contiguous();
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const {
+    return impl_->is_contiguous(memory_format);
+  }
+
+  // The memory format an operator should allocate a result like this tensor
+  // in: ChannelsLast if this is a strided 4-d tensor laid out densely in
+  // channels last order (and not also C contiguous, as happens when sizes of
+  // one make both layouts coincide), Contiguous otherwise.
+  at::MemoryFormat suggest_memory_format() const {
+    if (!is_sparse() && !is_mkldnn() && !impl_->is_contiguous() &&
+        impl_->is_contiguous(at::MemoryFormat::ChannelsLast)) {
+      return at::MemoryFormat::ChannelsLast;
+    }
+    return at::MemoryFormat::Contiguous;
   }
 
   // Total bytes consumed by the "view" of elements of the array.  Does not
@@ -373,7 +386,7 @@ class CAFFE2_API Tensor {
   Tensor & clamp_max_(Scalar max);
   Tensor clamp_min(Scalar min) const;
   Tensor & clamp_min_(Scalar min);
-  Tensor contiguous() const;
+  Tensor contiguous(MemoryFormat memory_format=MemoryFormat::Contiguous) const;
   Tensor & copy_(const Tensor & src, bool non_blocking=false);
   Tensor cos() const;
   Tensor & cos_();
@@ -393,6 +406,7 @@ class CAFFE2_API Tensor {
   Tensor & div_(Scalar other);
   Tensor dot(const Tensor & tensor) const;
   Tensor & resize_(IntArrayRef size);
+  Tensor & reserve_(int64_t capacity);
   Tensor erf() const;
   Tensor & erf_();
   Tensor erfc() const;
@@ -453,6 +467,8 @@ class CAFFE2_API Tensor {
   std::tuple<Tensor,Tensor> median(int64_t dim, bool keepdim=false) const;
   std::tuple<Tensor,Tensor> min(int64_t dim, bool keepdim=false) const;
   Tensor min_values(IntArrayRef dim, bool keepdim=false) const;
+  std::tuple<Tensor,Tensor> aminmax() const;
+  std::tuple<Tensor,Tensor> aminmax(IntArrayRef dim, bool keepdim=false) const;
   Tensor mm(const Tensor & mat2) const;
   std::tuple<Tensor,Tensor> mode(int64_t dim=-1, bool keepdim=false) const;
   Tensor mul(const Tensor & other) const;
@@ -581,9 +597,13 @@ class CAFFE2_API Tensor {
   Tensor to_sparse() const;
   Tensor to_mkldnn() const;
   Tensor quantize_linear(double scale, int64_t zero_point) const;
+  Tensor quantize_linear_per_channel(const Tensor & scales, const Tensor & zero_points, IntArrayRef axis) const;
   Tensor dequantize() const;
   Scalar q_scale() const;
   Scalar q_zero_point() const;
+  Tensor q_per_channel_scales() const;
+  Tensor q_per_channel_zero_points() const;
+  int64_t q_scheme() const;
   Tensor int_repr() const;
   Tensor to(const TensorOptions & options, bool non_blocking=false, bool copy=false) const;
   Tensor to(Device device, ScalarType dtype, bool non_blocking=false, bool copy=false) const;
@@ -176,8 +176,8 @@ inline Tensor Tensor::clamp_min(Scalar min) const {
 inline Tensor & Tensor::clamp_min_(Scalar min) {
     return dispatch_type().clamp_min_(*this, min);
 }
-inline Tensor Tensor::contiguous() const {
-    return dispatch_type().contiguous(*this);
+inline Tensor Tensor::contiguous(MemoryFormat memory_format) const {
+    return dispatch_type().contiguous(*this, memory_format);
 }
 inline Tensor & Tensor::copy_(const Tensor & src, bool non_blocking) {
     return dispatch_type().copy_(*this, src, non_blocking);
@@ -236,6 +236,9 @@ inline Tensor Tensor::dot(const Tensor & tensor) const {
 inline Tensor & Tensor::resize_(IntArrayRef size) {
     return dispatch_type().resize_(*this, size);
 }
+inline Tensor & Tensor::reserve_(int64_t capacity) {
+    return dispatch_type().reserve_(*this, capacity);
+}
 inline Tensor Tensor::erf() const {
     return dispatch_type().erf(*this);
 }
@@ -416,6 +419,12 @@ inline std::tuple<Tensor,Tensor> Tensor::min(int64_t dim, bool keepdim) const {
 inline Tensor Tensor::min_values(IntArrayRef dim, bool keepdim) const {
     return dispatch_type().min_values(*this, dim, keepdim);
 }
+inline std::tuple<Tensor,Tensor> Tensor::aminmax() const {
+    return dispatch_type().aminmax(*this);
+}
+inline std::tuple<Tensor,Tensor> Tensor::aminmax(IntArrayRef dim, bool keepdim) const {
+    return dispatch_type().aminmax(*this, dim, keepdim);
+}
 inline Tensor Tensor::mm(const Tensor & mat2) const {
     return dispatch_type().mm(*this, mat2);
 }
@@ -800,6 +809,9 @@ inline Tensor Tensor::to_mkldnn() const {
 inline Tensor Tensor::quantize_linear(double scale, int64_t zero_point) const {
     return dispatch_type().quantize_linear(*this, scale, zero_point);
 }
+inline Tensor Tensor::quantize_linear_per_channel(const Tensor & scales, const Tensor & zero_points, IntArrayRef axis) const {
+    return dispatch_type().quantize_linear_per_channel(*this, scales, zero_points, axis);
+}
 inline Tensor Tensor::dequantize() const {
     return dispatch_type().dequantize(*this);
 }
@@ -809,6 +821,15 @@ inline Scalar Tensor::q_scale() const {
 inline Scalar Tensor::q_zero_point() const {
     return dispatch_type().q_zero_point(*this);
 }
+inline Tensor Tensor::q_per_channel_scales() const {
+    return dispatch_type().q_per_channel_scales(*this);
+}
+inline Tensor Tensor::q_per_channel_zero_points() const {
+    return dispatch_type().q_per_channel_zero_points(*this);
+}
+inline int64_t Tensor::q_scheme() const {
+    return dispatch_type().q_scheme(*this);
+}
 inline Tensor Tensor::int_repr() const {
     return dispatch_type().int_repr(*this);
 }
@@ -50,11 +50,15 @@ _(aten, _ctc_loss) \
 _(aten, _ctc_loss_backward) \
 _(aten, _cudnn_ctc_loss) \
 _(aten, _cudnn_init_dropout_state) \
+_(aten, _cudnn_load_benchmark_cache) \
 _(aten, _cudnn_rnn) \
 _(aten, _cudnn_rnn_backward) \
 _(aten, _cudnn_rnn_flatten_weight) \
+_(aten, _cudnn_save_benchmark_cache) \
 _(aten, _cufft_clear_plan_cache) \
+_(aten, _cufft_get_plan_cache_hits) \
 _(aten, _cufft_get_plan_cache_max_size) \
+_(aten, _cufft_get_plan_cache_misses) \
 _(aten, _cufft_get_plan_cache_size) \
 _(aten, _cufft_set_plan_cache_max_size) \
 _(aten, _cumprod) \
@@ -80,6 +84,7 @@ _(aten, _fused_dropout) \
 _(aten, _ger) \
 _(aten, _indexCopy) \
 _(aten, _indices) \
+_(aten, _linear_relu) \
 _(aten, _linspace) \
 _(aten, _local_scalar) \
 _(aten, _local_scalar_dense) \
@@ -292,6 +297,7 @@ _(aten, div) \
 _(aten, div_) \
 _(aten, dot) \
 _(aten, dropout) \
+_(aten, dropout_add_layer_norm) \
 _(aten, eig) \
 _(aten, einsum) \
 _(aten, elu) \
@@ -462,6 +468,8 @@ _(aten, miopen_depthwise_convolution) \
 _(aten, miopen_depthwise_convolution_backward) \
 _(aten, miopen_depthwise_convolution_backward_input) \
 _(aten, miopen_depthwise_convolution_backward_weight) \
+_(aten, mkl_linear_packed_weight) \
+_(aten, mkl_pack_linear_weight) \
 _(aten, mkldnn_convolution) \
 _(aten, mkldnn_convolution_backward) \
 _(aten, mkldnn_convolution_backward_input) \
@@ -544,6 +552,7 @@ _(aten, reflection_pad2d) \
 _(aten, reflection_pad2d_backward) \
 _(aten, reflection_pad2d_forward) \
 _(aten, relu) \
+_(aten, relu_) \
 _(aten, remainder) \
 _(aten, renorm) \
 _(aten, repeat) \
@@ -667,6 +676,7 @@ _(aten, threshold_backward) \
 _(aten, to) \
 _(aten, to_sparse) \
 _(aten, to_dense) \
+_(aten, to_mkldnn) \
 _(aten, topk) \
 _(aten, trace) \
 _(aten, transpose) \
@@ -32,9 +32,13 @@ using KernelCacheCreatorFunction = std::function<std::unique_ptr<c10::KernelCach
  * is registered. When a kernel is looked up from the dispatcher, a new
  * cache instance is created for it and each call to that kernel will get
  * this same cache instance.
+ * If the kernel also has an unboxed entry point, it is stored as well,
+ * otherwise unboxed calls to the kernel box their arguments and go through
+ * kernel_func.
  */
 struct DispatchTableEntry final {
   /*not-nullable*/ KernelFunction* kernel_func;
+  /*nullable*/ UnboxedKernelFunction* unboxed_kernel_func;
   /*not-nullable*/ KernelCacheCreatorFunction cache_creator_func;
 };
 
@@ -99,6 +103,58 @@ class KernelTable_ final {
  private:
    ska::flat_hash_map<TensorTypeId, DispatchTableEntry> map_;
 };
+
+struct DispatchStrategy final {
+  // this is caching the index so we don't have to parse the schema inputs
+  // again and again for each dispatcher lookup.
+  // reverse_index means this is the distance from the first tensor argument
+  // to argument_list.end(), i.e. from the top of the stack.
+  // Since it is distance to end(), this means it's 1-indexed,
+  // i.e. '1' is the last argument.
+  size_t reverse_index_of_first_tensor_arg_;
+  bool first_tensor_arg_is_tensor_list_;
+
+  // An invalid dispatch strategy means we can't dispatch any kernels.
+  // You're able to create a dispatch table with an invalid dispatch strategy,
+  // but adding kernels to it will fail.
+  // This is used to allow creating operators with empty argument lists
+  // as long as they only have fallback kernels and no dispatched kernels.
+  bool is_valid_;
+
+  TensorTypeId get_dispatch_key(const Stack* stack) const {
+    auto first_tensor_arg = torch::jit::peek(
+      *stack,
+      0,
+      reverse_index_of_first_tensor_arg_
+    );
+    if (first_tensor_arg_is_tensor_list_) {
+      const auto& tensor_list = first_tensor_arg.toTensorListRef();
+      if (tensor_list.size() == 0) {
+        throw std::runtime_error("Tried to dispatch based on an empty tensor list. When the first tensor argument of an operator is a tensor list, then it must not be empty.");
+      }
+      return tensor_list[0].type_id();
+    } else {
+      // TODO Avoid bumping the refcounter
+      return first_tensor_arg.toTensor().type_id();
+    }
+  }
+
+  static DispatchStrategy forSchema(const FunctionSchema& schema) {
+    for (size_t i = 0; i < schema.arguments().size(); ++i) {
+      const auto& type = schema.arguments()[i].type();
+      if (type->isSubtypeOf(TensorType::get())) {
+        return {schema.arguments().size() - i, false, true};
+      }
+      if (type->isSubtypeOf(ListType::ofTensors())) {
+        return {schema.arguments().size() - i, true, true};
+      }
+    }
+
+    // The function schema doesn't have tensor arguments.
+    // Return an invalid dispatch strategy.
+    return {0, false, false};
+  }
+};
 } // namespace detail
 
 /**
@@ -114,7 +170,7 @@ class DispatchTable final {
  public:
   DispatchTable(const FunctionSchema& schema)
   : kernels_()
-  , dispatch_strategy_(get_dispatch_strategy_(schema))
+  , dispatch_strategy_(detail::DispatchStrategy::forSchema(schema))
   , operator_name_(schema.name()) {}
 
   /**
@@ -151,34 +207,24 @@ class DispatchTable final {
    */
    const DispatchTableEntry& lookup(const Stack* stack) const {
      if (C10_LIKELY(dispatch_strategy_.is_valid_)) {
-       TensorTypeId dispatch_key = dispatch_strategy_.get_dispatch_key(stack);
-       auto found = kernels_.lookup(dispatch_key);
-       if (nullptr != found) {
-         return *found;
-       }
-
-       // regular dispatch didn't find a kernel, let's check the fallback kernel.
-       const DispatchTableEntry* fallbackKernel = fallback_kernel();
-       if (nullptr != fallbackKernel) {
-         return *fallbackKernel;
-       }
-
-       // no kernel found and fallback kernel doesn't exist either
-       AT_ERROR("Didn't find kernel to dispatch to for operator '", operator_name_,
-                "'. Tried to look up kernel for dispatch key '", detail::dispatch_key_to_string(dispatch_key),
-                "'. Registered dispatch keys are: ", list_all_dispatch_keys_());
+       return lookup_(dispatch_strategy_.get_dispatch_key(stack));
      } else {
-       // with an invalid dispatch key, only the fallback kernel is allowed.
-       const DispatchTableEntry* fallbackKernel = fallback_kernel();
-
-       AT_ASSERTM(kernels_.size() == ((nullptr == fallbackKernel)?0:1), "Cannot have an invalid dispatch key but registered kernels");
-
-       if (nullptr != fallbackKernel) {
-         return *fallbackKernel;
-       }
+       return lookupFallback_();
+     }
+   }
 
-       // no kernel registered and fallback kernel doesn't exist either
-       AT_ERROR("Didn't find kernel to dispatch to for operator '", operator_name_, "'");
+  /**
+   * Find the kernel to call for the given dispatch key, i.e. the type id of
+   * the first tensor argument. This is used by unboxed calls, which don't
+   * have a stack to look for the first tensor argument in.
+   * If the operator doesn't have tensor arguments, the dispatch key is
+   * ignored and the fallback kernel is returned.
+   */
+   const DispatchTableEntry& lookup(TensorTypeId dispatch_key) const {
+     if (C10_LIKELY(dispatch_strategy_.is_valid_)) {
+       return lookup_(dispatch_key);
+     } else {
+       return lookupFallback_();
      }
    }
 
@@ -187,60 +233,40 @@ class DispatchTable final {
    }
 
 private:
-  struct DispatchStrategy final {
-    // this is caching the index so we don't have to parse the schema inputs
-    // again and again for each dispatcher lookup.
-    // reverse_index means this is the distance from the first tensor argument
-    // to argument_list.end(), i.e. from the top of the stack.
-    // Since it is distance to end(), this means it's 1-indexed,
-    // i.e. '1' is the last argument.
-    size_t reverse_index_of_first_tensor_arg_;
-    bool first_tensor_arg_is_tensor_list_;
-
-    // An invalid dispatch strategy means we can't dispatch any kernels.
-    // You're able to create a dispatch table with an invalid dispatch strategy,
-    // but adding kernels to it will fail.
-    // This is used to allow creating operators with empty argument lists
-    // as long as they only have fallback kernels and no dispatched kernels.
-    bool is_valid_;
-
-    TensorTypeId get_dispatch_key(const Stack* stack) const {
-      auto first_tensor_arg = torch::jit::peek(
-        *stack,
-        0,
-        reverse_index_of_first_tensor_arg_
-      );
-      if (first_tensor_arg_is_tensor_list_) {
-        const auto& tensor_list = first_tensor_arg.toTensorListRef();
-        if (tensor_list.size() == 0) {
-          throw std::runtime_error("Tried to dispatch based on an empty tensor list. When the first tensor argument of an operator is a tensor list, then it must not be empty.");
-        }
-        return tensor_list[0].type_id();
-      } else {
-        // TODO Avoid bumping the refcounter
-        return first_tensor_arg.toTensor().type_id();
-      }
+  const DispatchTableEntry& lookup_(TensorTypeId dispatch_key) const {
+    auto found = kernels_.lookup(dispatch_key);
+    if (nullptr != found) {
+      return *found;
     }
-  };
 
-  const DispatchTableEntry* fallback_kernel() const {
-    return kernels_.lookup(TensorTypeIds::undefined());
+    // regular dispatch didn't find a kernel, let's check the fallback kernel.
+    const DispatchTableEntry* fallbackKernel = fallback_kernel();
+    if (nullptr != fallbackKernel) {
+      return *fallbackKernel;
+    }
+
+    // no kernel found and fallback kernel doesn't exist either
+    AT_ERROR("Didn't find kernel to dispatch to for operator '", operator_name_,
+             "'. Tried to look up kernel for dispatch key '", detail::dispatch_key_to_string(dispatch_key),
+             "'. Registered dispatch keys are: ", list_all_dispatch_keys_());
   }
 
-  static DispatchStrategy get_dispatch_strategy_(const FunctionSchema& schema) {
-    for (size_t i = 0; i < schema.arguments().size(); ++i) {
-      const auto& type = schema.arguments()[i].type();
-      if (type->isSubtypeOf(TensorType::get())) {
-        return {schema.arguments().size() - i, false, true};
-      }
-      if (type->isSubtypeOf(ListType::ofTensors())) {
-        return {schema.arguments().size() - i, true, true};
-      }
+  const DispatchTableEntry& lookupFallback_() const {
+    // with an invalid dispatch key, only the fallback kernel is allowed.
+    const DispatchTableEntry* fallbackKernel = fallback_kernel();
+
+    AT_ASSERTM(kernels_.size() == ((nullptr == fallbackKernel)?0:1), "Cannot have an invalid dispatch key but registered kernels");
+
+    if (nullptr != fallbackKernel) {
+      return *fallbackKernel;
     }
 
-    // The function schema doesn't have tensor arguments.
-    // Return an invalid dispatch strategy.
-    return {0, false, false};
+    // no kernel registered and fallback kernel doesn't exist either
+    AT_ERROR("Didn't find kernel to dispatch to for operator '", operator_name_, "'");
+  }
+
+  const DispatchTableEntry* fallback_kernel() const {
+    return kernels_.lookup(TensorTypeIds::undefined());
   }
 
   std::string list_all_dispatch_keys_() const {
@@ -252,7 +278,7 @@ private:
   }
 
   detail::KernelTable_ kernels_;
-  DispatchStrategy dispatch_strategy_;
+  detail::DispatchStrategy dispatch_strategy_;
   std::string operator_name_;
 };
 
@@ -101,14 +101,14 @@ void Dispatcher::deregisterSchema_(const OperatorHandle& op) {
   }
 }
 
-RegistrationHandleRAII Dispatcher::registerKernel(const OperatorHandle& op, TensorTypeId dispatch_key, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func) {
+RegistrationHandleRAII Dispatcher::registerKernel(const OperatorHandle& op, TensorTypeId dispatch_key, KernelFunction* kernel_func, UnboxedKernelFunction* unboxed_kernel_func, KernelCacheCreatorFunction cache_creator_func) {
   // note: this doesn't need the mutex to protect the iterator because write operations on the list keep iterators intact.
-  return op.operatorIterator_->op.registerKernel(std::move(dispatch_key), DispatchTableEntry{kernel_func, std::move(cache_creator_func)});
+  return op.operatorIterator_->op.registerKernel(std::move(dispatch_key), DispatchTableEntry{kernel_func, unboxed_kernel_func, std::move(cache_creator_func)});
 }
 
-RegistrationHandleRAII Dispatcher::registerFallbackKernel(const OperatorHandle& op, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func) {
+RegistrationHandleRAII Dispatcher::registerFallbackKernel(const OperatorHandle& op, KernelFunction* kernel_func, UnboxedKernelFunction* unboxed_kernel_func, KernelCacheCreatorFunction cache_creator_func) {
   // note: this doesn't need the mutex to protect the iterator because write operations on the list keep iterators intact.
-  return op.operatorIterator_->op.registerFallbackKernel(DispatchTableEntry{kernel_func, std::move(cache_creator_func)});
+  return op.operatorIterator_->op.registerFallbackKernel(DispatchTableEntry{kernel_func, unboxed_kernel_func, std::move(cache_creator_func)});
 }
 
 void Dispatcher::addRegistrationListener(std::unique_ptr<OpRegistrationListener> listener) {
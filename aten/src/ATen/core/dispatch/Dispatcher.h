@@ -10,6 +10,107 @@ namespace c10 {
 
 class CAFFE2_API OperatorHandle;
 
+namespace detail {
+  // unboxed_arg_to_ivalue<T>: Box an argument of an unboxed call to a kernel
+  // that doesn't have an unboxed entry point.
+  template<class T>
+  struct unboxed_arg_to_ivalue final {
+    static IValue call(T&& v) {
+      return IValue(std::move(v));
+    }
+  };
+  template<class T>
+  struct unboxed_arg_to_ivalue<ArrayRef<T>> final {
+    static IValue call(ArrayRef<T>&& v) {
+      return IValue(v.vec());
+    }
+  };
+  template<class T>
+  struct unboxed_arg_to_ivalue<optional<T>> final {
+    static IValue call(optional<T>&& v) {
+      if (!v.has_value()) {
+        return IValue();
+      }
+      return unboxed_arg_to_ivalue<T>::call(std::move(*v));
+    }
+  };
+
+  // ivalue_to_unboxed_return<T>: Unbox a result of such a kernel again.
+  template<class T>
+  struct ivalue_to_unboxed_return final {
+    static T call(IValue&& v) {
+      return std::move(v).to<T>();
+    }
+  };
+  template<class T>
+  struct ivalue_to_unboxed_return<optional<T>> final {
+    static optional<T> call(IValue&& v) {
+      if (v.isNone()) {
+        return nullopt;
+      }
+      return ivalue_to_unboxed_return<T>::call(std::move(v));
+    }
+  };
+
+  template<class Return>
+  struct pop_unboxed_return final {
+    static Return call(Stack* stack) {
+      AT_ASSERTM(stack->size() == 1, "Kernel returned ", stack->size(), " outputs, but the unboxed call expected 1.");
+      return ivalue_to_unboxed_return<Return>::call(std::move((*stack)[0]));
+    }
+  };
+  template<>
+  struct pop_unboxed_return<void> final {
+    static void call(Stack* stack) {
+      AT_ASSERTM(stack->size() == 0, "Kernel returned ", stack->size(), " outputs, but the unboxed call expected none.");
+    }
+  };
+  template<class... Returns>
+  struct pop_unboxed_return<std::tuple<Returns...>> final {
+    static std::tuple<Returns...> call(Stack* stack) {
+      AT_ASSERTM(stack->size() == sizeof...(Returns), "Kernel returned ", stack->size(), " outputs, but the unboxed call expected ", sizeof...(Returns), ".");
+      return call_(stack, guts::make_index_sequence<sizeof...(Returns)>());
+    }
+
+  private:
+    template<size_t... indices>
+    static std::tuple<Returns...> call_(Stack* stack, guts::index_sequence<indices...>) {
+      return std::tuple<Returns...>(ivalue_to_unboxed_return<Returns>::call(std::move((*stack)[indices]))...);
+    }
+  };
+
+  // unboxed_dispatch_key(args...): The dispatch key of an unboxed call, i.e.
+  // the type id of the first argument that is a tensor or a tensor list.
+  // This is the same argument the dispatch table looks at for boxed calls.
+  inline optional<TensorTypeId> unboxed_arg_dispatch_key(const at::Tensor& arg) {
+    return arg.type_id();
+  }
+  inline optional<TensorTypeId> unboxed_arg_dispatch_key(ArrayRef<at::Tensor> arg) {
+    AT_CHECK(arg.size() != 0, "Tried to dispatch based on an empty tensor list. When the first tensor argument of an operator is a tensor list, then it must not be empty.");
+    return arg[0].type_id();
+  }
+  inline optional<TensorTypeId> unboxed_arg_dispatch_key(const std::vector<at::Tensor>& arg) {
+    return unboxed_arg_dispatch_key(ArrayRef<at::Tensor>(arg));
+  }
+  template<class T>
+  inline optional<TensorTypeId> unboxed_arg_dispatch_key(const T&) {
+    return nullopt;
+  }
+
+  inline TensorTypeId unboxed_dispatch_key() {
+    // no tensor arguments, only a fallback kernel can be called.
+    return TensorTypeIds::undefined();
+  }
+  template<class Head, class... Tail>
+  inline TensorTypeId unboxed_dispatch_key(const Head& head, const Tail&... tail) {
+    auto dispatch_key = unboxed_arg_dispatch_key(head);
+    if (dispatch_key.has_value()) {
+      return *dispatch_key;
+    }
+    return unboxed_dispatch_key(tail...);
+  }
+}
+
 /**
  * This class represents an operator kernel, i.e. an operator *after* it was
  * dispatched to a certain device. You can use it to call the kernel.
@@ -39,12 +140,38 @@ public:
     return (*kernel_)(stack, cache_.get());
   }
 
+  /**
+   * Call the operator kernel with the given arguments without putting them
+   * on a stack. Kernels registered through the functor, function or lambda
+   * based APIs are called directly. Other (i.e. stack based) kernels get
+   * the arguments boxed into a stack and their results unboxed again.
+   *
+   * Return and Args must be the return and argument types of the kernel,
+   * with arguments by value, i.e. for a kernel
+   * `Tensor operator()(const Tensor& a, int64_t b)`, call
+   * `callUnboxed<Tensor, Tensor, int64_t>(a, b)`. This isn't checked.
+   */
+  template<class Return, class... Args>
+  Return callUnboxed(Args... args) const {
+    if (C10_LIKELY(unboxed_kernel_ != nullptr)) {
+      using Signature = Return (KernelCache*, Args...);
+      return (*reinterpret_cast<Signature*>(unboxed_kernel_))(cache_.get(), std::move(args)...);
+    }
+
+    Stack stack;
+    stack.reserve(sizeof...(Args));
+    (void)std::initializer_list<int>{(stack.push_back(detail::unboxed_arg_to_ivalue<Args>::call(std::move(args))), 0)...};
+    (*kernel_)(&stack, cache_.get());
+    return detail::pop_unboxed_return<Return>::call(&stack);
+  }
+
 private:
-  explicit OpKernel(KernelFunction* kernel, const KernelCacheCreatorFunction& cache_creator)
-  : kernel_(kernel), cache_(cache_creator()) {}
+  explicit OpKernel(KernelFunction* kernel, UnboxedKernelFunction* unboxed_kernel, const KernelCacheCreatorFunction& cache_creator)
+  : kernel_(kernel), unboxed_kernel_(unboxed_kernel), cache_(cache_creator()) {}
   friend class Dispatcher;
 
   KernelFunction* kernel_;
+  UnboxedKernelFunction* unboxed_kernel_;
   std::unique_ptr<c10::KernelCache> cache_;
 };
 
@@ -116,7 +243,7 @@ public:
    * @return A RAII object that manages the lifetime of the registration.
    *         Once that object is destructed, the kernel will be deregistered.
    */
-  RegistrationHandleRAII registerKernel(const OperatorHandle& op, TensorTypeId dispatch_key, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func);
+  RegistrationHandleRAII registerKernel(const OperatorHandle& op, TensorTypeId dispatch_key, KernelFunction* kernel_func, UnboxedKernelFunction* unboxed_kernel_func, KernelCacheCreatorFunction cache_creator_func);
 
   /**
    * Register a fallback kernel for an operator.
@@ -126,13 +253,29 @@ public:
    * @return A RAII object that manages the lifetime of the registration.
    *         Once that object is destructed, the kernel will be deregistered.
    */
-  RegistrationHandleRAII registerFallbackKernel(const OperatorHandle& op, KernelFunction* kernel_func, KernelCacheCreatorFunction cache_creator_func);
+  RegistrationHandleRAII registerFallbackKernel(const OperatorHandle& op, KernelFunction* kernel_func, UnboxedKernelFunction* unboxed_kernel_func, KernelCacheCreatorFunction cache_creator_func);
 
   /**
    * Perform a dynamic dispatch and get the kernel for an operator.
    */
   OpKernel lookup(const OperatorHandle& op, const Stack* stack) const;
 
+  /**
+   * Get the kernel for an operator and a dispatch key, i.e. the type id of
+   * the first tensor argument. This is for unboxed calls, see
+   * OpKernel::callUnboxed().
+   */
+  OpKernel lookup(const OperatorHandle& op, TensorTypeId dispatch_key) const;
+
+  /**
+   * Perform a dynamic dispatch on the given arguments and call the kernel
+   * without boxing them, see OpKernel::callUnboxed().
+   * This looks up the kernel, i.e. creates a new kernel cache, for each call.
+   * If you call an operator repeatedly, prefer keeping the OpKernel around.
+   */
+  template<class Return, class... Args>
+  Return callUnboxed(const OperatorHandle& op, Args... args) const;
+
   /**
    * Add a listener that gets called whenever a new op is registered or an existing
    * op is deregistered. Immediately after registering, this listener gets called
@@ -194,7 +337,20 @@ private:
 inline OpKernel Dispatcher::lookup(const OperatorHandle& op, const Stack* stack) const {
   // note: this doesn't need the mutex because write operations on the list keep iterators intact.
   const DispatchTableEntry& kernel = op.operatorIterator_->op.lookupKernel(stack);
-  return OpKernel(kernel.kernel_func, kernel.cache_creator_func);
+  return OpKernel(kernel.kernel_func, kernel.unboxed_kernel_func, kernel.cache_creator_func);
+}
+
+inline OpKernel Dispatcher::lookup(const OperatorHandle& op, TensorTypeId dispatch_key) const {
+  // note: this doesn't need the mutex because write operations on the list keep iterators intact.
+  const DispatchTableEntry& kernel = op.operatorIterator_->op.lookupKernel(dispatch_key);
+  return OpKernel(kernel.kernel_func, kernel.unboxed_kernel_func, kernel.cache_creator_func);
+}
+
+template<class Return, class... Args>
+inline Return Dispatcher::callUnboxed(const OperatorHandle& op, Args... args) const {
+  // note: the lookup must be done before the arguments are moved into the call.
+  OpKernel kernel = lookup(op, detail::unboxed_dispatch_key(args...));
+  return kernel.template callUnboxed<Return, Args...>(std::move(args)...);
 }
 
 } // namespace c10
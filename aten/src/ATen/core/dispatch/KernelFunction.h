@@ -13,4 +13,14 @@ using Stack = torch::jit::Stack; // TODO Instead of this, move torch::jit::Stack
  */
 using KernelFunction = void(Stack*, KernelCache* cache);
 
+/**
+ * Kernels registered through the functor or lambda based APIs additionally
+ * have an unboxed entry point with the signature
+ * `Return(KernelCache* cache, Args... args)`, which is called without
+ * putting the arguments on a stack. It is stored type-erased as an
+ * `UnboxedKernelFunction*` and cast back to its signature by
+ * OpKernel::callUnboxed().
+ */
+using UnboxedKernelFunction = void();
+
 }
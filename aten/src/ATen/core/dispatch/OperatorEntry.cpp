@@ -3,11 +3,75 @@
 namespace c10 {
 namespace impl {
 
+namespace {
+
+// Bumped after every change to the dispatch table of any operator. Cached
+// kernels are only used if they were looked up in the current epoch. It starts
+// at 1 so that the empty cache slots never match.
+std::atomic<uint64_t> dispatch_epoch{1};
+
+/// In the CAFFE2_FB_LIMITED_MOBILE_CAPABILITY build setting,
+/// thread_local is not supported. In that case, kernels are always
+/// looked up in the dispatch table.
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+
+struct CachedKernel final {
+  const OperatorEntry* op = nullptr;
+  TensorTypeId dispatch_key;
+  uint64_t epoch = 0;
+  DispatchTableEntry kernel{nullptr, nullptr, nullptr};
+};
+
+// Direct mapped, a collision just evicts the older kernel. A thread rarely
+// calls more than a few dozen (operator, dispatch key) pairs in a hot loop.
+constexpr size_t kKernelCacheSize = 64;
+thread_local std::array<CachedKernel, kKernelCacheSize> cached_kernels;
+
+CachedKernel& cacheSlot(const OperatorEntry* op, TensorTypeId dispatch_key) {
+  // operator entries are heap allocated, the low bits of their address are 0
+  const size_t hash = (reinterpret_cast<uintptr_t>(op) >> 4) ^
+      std::hash<TensorTypeId>()(dispatch_key);
+  return cached_kernels[hash & (kKernelCacheSize - 1)];
+}
+
+#endif
+
+} // namespace
+
 OperatorEntry::OperatorEntry(FunctionSchema&& schema)
 : schema_(std::move(schema))
+, dispatchStrategy_(detail::DispatchStrategy::forSchema(schema_))
 , dispatchTable_(schema_)
 , kernels_() {}
 
+DispatchTableEntry OperatorEntry::lookupKernel(TensorTypeId dispatch_key) const {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  // Load the epoch before reading the dispatch table, so that a kernel looked
+  // up while a registration is in flight is cached with the older epoch and
+  // looked up again next time.
+  const uint64_t epoch = dispatch_epoch.load(std::memory_order_acquire);
+  CachedKernel& slot = cacheSlot(this, dispatch_key);
+  if (C10_LIKELY(slot.epoch == epoch && slot.op == this &&
+                 slot.dispatch_key == dispatch_key)) {
+    return slot.kernel;
+  }
+  // If the lookup throws because there is no kernel, the slot is unchanged.
+  slot.kernel = lookupKernelUncached_(dispatch_key);
+  slot.op = this;
+  slot.dispatch_key = dispatch_key;
+  slot.epoch = epoch;
+  return slot.kernel;
+#else
+  return lookupKernelUncached_(dispatch_key);
+#endif
+}
+
+DispatchTableEntry OperatorEntry::lookupKernelUncached_(TensorTypeId dispatch_key) const {
+  return dispatchTable_.read([&] (const DispatchTable& dispatchTable) {
+    return dispatchTable.lookup(dispatch_key);
+  });
+}
+
 void OperatorEntry::prepareForDeregistration() {
   return dispatchTable_.read([&] (const DispatchTable& dispatchTable) {
     if (!dispatchTable.isEmpty()) {
@@ -52,6 +116,11 @@ void OperatorEntry::updateDispatchTable_(TensorTypeId dispatch_key) {
       dispatchTable.setKernel(dispatch_key, k->second.front());
     });
   }
+
+  // Invalidates the kernels cached by all threads. An operator entry that is
+  // destroyed has no kernels left, so this also happened after its last
+  // deregistration and a new entry at the same address can't hit the cache.
+  dispatch_epoch.fetch_add(1, std::memory_order_release);
 }
 
 void OperatorEntry::deregisterKernel_(TensorTypeId dispatch_key, std::list<DispatchTableEntry>::iterator kernel) {
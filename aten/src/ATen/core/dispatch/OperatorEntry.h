@@ -9,7 +9,7 @@ namespace impl {
 
 // This is a private class used inside the Dispatcher to represent an operator
 // and it's dispatch table. This is not part of the public API.
-class OperatorEntry final {
+class CAFFE2_API OperatorEntry final {
 public:
   explicit OperatorEntry(FunctionSchema&& schema);
 
@@ -23,11 +23,20 @@ public:
   }
 
   DispatchTableEntry lookupKernel(const Stack* stack) const {
-    return dispatchTable_.read([&] (const DispatchTable& dispatchTable) {
-      return dispatchTable.lookup(stack);
-    });
+    if (C10_LIKELY(dispatchStrategy_.is_valid_)) {
+      return lookupKernel(dispatchStrategy_.get_dispatch_key(stack));
+    }
+    // Operators without tensor arguments only have a fallback kernel,
+    // which the dispatch table returns for any dispatch key.
+    return lookupKernel(TensorTypeIds::undefined());
   }
 
+  // Kernels are looked up in a small thread local cache first, which is
+  // invalidated whenever a kernel of any operator is registered or
+  // deregistered. A cache hit doesn't touch the counters of dispatchTable_,
+  // so threads calling the same operators don't write to the same cache lines.
+  DispatchTableEntry lookupKernel(TensorTypeId dispatch_key) const;
+
   void prepareForDeregistration();
 
   RegistrationHandleRAII registerKernel(TensorTypeId dispatch_key, DispatchTableEntry kernel);
@@ -37,8 +46,14 @@ private:
   void deregisterKernel_(TensorTypeId dispatch_key, std::list<DispatchTableEntry>::iterator kernel);
   void deregisterFallbackKernel_();
 
+  DispatchTableEntry lookupKernelUncached_(TensorTypeId dispatch_key) const;
+
   FunctionSchema schema_;
 
+  // The dispatch strategy never changes after construction, so the dispatch
+  // key of a stack can be computed without reading dispatchTable_.
+  const detail::DispatchStrategy dispatchStrategy_;
+
   // The dispatchTable stores the current kernel for each dispatch key
   LeftRight<DispatchTable> dispatchTable_;
 
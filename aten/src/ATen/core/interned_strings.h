@@ -74,6 +74,7 @@ namespace c10 {
   _(prim, ConstantChunk)           \
   _(prim, MMTreeReduce)            \
   _(prim, MMBatchSide)             \
+  _(prim, MMBatchLinear)           \
   _(prim, min)                     \
   _(prim, max)                     \
   _(prim, abs)                     \
@@ -91,6 +92,8 @@ namespace c10 {
   _(prim, SetAttr)                 \
   _(prim, GetAttr)                 \
   _(prim, profile)                 \
+  _(prim, MemoryArena)             \
+  _(prim, ArenaBuffer)             \
   _(prim, AddStatValue)            \
   _(prim, TimePoint)               \
   _(aten, append)                  \
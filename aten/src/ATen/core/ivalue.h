@@ -138,20 +138,41 @@ struct CAFFE2_API IValue final {
       c10::raw::intrusive_ptr::incref(payload.as_intrusive_ptr);
     }
   }
-  IValue(IValue&& rhs) noexcept : IValue() {
-    swap(rhs);
+  IValue(IValue&& rhs) noexcept
+      : payload(rhs.payload),
+        tag(rhs.tag),
+        is_intrusive_ptr(rhs.is_intrusive_ptr) {
+    rhs.clearToNone();
   }
   ~IValue() {
     if (is_intrusive_ptr) {
       c10::raw::intrusive_ptr::decref(payload.as_intrusive_ptr);
     }
   }
+  // The interpreter moves and copies IValues holding ints, doubles and bools
+  // on and off the stack all the time, so assigning over a value that holds
+  // no reference is a plain copy of the payload and the tag.
   IValue & operator=(IValue && rhs) & noexcept {
-    IValue(std::move(rhs)).swap(*this); // this also sets rhs to None
+    if (&rhs == this) {
+      return *this;
+    }
+    if (is_intrusive_ptr) {
+      IValue(std::move(rhs)).swap(*this); // this also sets rhs to None
+      return *this;
+    }
+    payload = rhs.payload;
+    tag = rhs.tag;
+    is_intrusive_ptr = rhs.is_intrusive_ptr;
+    rhs.clearToNone();
     return *this;
   }
   IValue & operator=(IValue const & rhs) & {
-    IValue(rhs).swap(*this);
+    if (is_intrusive_ptr || rhs.is_intrusive_ptr) {
+      IValue(rhs).swap(*this);
+      return *this;
+    }
+    payload = rhs.payload;
+    tag = rhs.tag;
     return *this;
   }
 
@@ -462,6 +483,11 @@ struct CAFFE2_API IValue final {
     return static_cast<at::Layout>(toInt());
   }
 
+  // MemoryFormat
+  at::MemoryFormat toMemoryFormat() const {
+    return static_cast<at::MemoryFormat>(toInt());
+  }
+
   // for debugging
   std::string tagKind() const {
     switch(tag) {
@@ -812,6 +838,7 @@ DEFINE_TO(IValue, toIValue)
 DEFINE_TO(c10::Device, toDevice)
 DEFINE_TO(at::ScalarType, toScalarType)
 DEFINE_TO(at::Layout, toLayout)
+DEFINE_TO(at::MemoryFormat, toMemoryFormat)
 
 template <typename T>
 struct _fake_type {};
@@ -19,6 +19,7 @@ namespace detail {
   struct KernelRegistrationConfig final {
     c10::optional<TensorTypeId> dispatch_key = c10::nullopt;
     KernelFunction* kernel_func = nullptr;
+    UnboxedKernelFunction* unboxed_kernel_func = nullptr;
     KernelCacheCreatorFunction cache_creator_func = nullptr;
     std::unique_ptr<FunctionSchema> inferred_function_schema = nullptr;
   };
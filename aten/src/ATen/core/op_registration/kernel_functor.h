@@ -233,6 +233,26 @@ namespace detail {
     }
   };
 
+  // wrap_kernel_functor_unboxed is the unboxed entry point of a kernel functor,
+  // taking the arguments by value and moving them into the functor call.
+  // See OpKernel::callUnboxed().
+  template<class KernelFunctor, class ReturnType, class ParameterList> struct wrap_kernel_functor_unboxed_ final {};
+  template<class KernelFunctor, class ReturnType, class... ParameterTypes>
+  struct wrap_kernel_functor_unboxed_<KernelFunctor, ReturnType, guts::typelist::typelist<ParameterTypes...>> final {
+    static_assert(std::is_base_of<OperatorKernel, KernelFunctor>::value, "Tried to register a kernel functor using the kernel<Functor>() API, but it doesn't inherit from c10::OperatorKernel. Please have the functor inherit from it.");
+
+    static ReturnType call(KernelCache* cache, guts::decay_t<ParameterTypes>... args) {
+      KernelFunctor* functor = static_cast<KernelFunctor*>(cache);
+      return (*functor)(std::move(args)...);
+    }
+  };
+  template<class KernelFunctor>
+  using wrap_kernel_functor_unboxed = wrap_kernel_functor_unboxed_<
+      KernelFunctor,
+      typename guts::infer_function_traits_t<KernelFunctor>::return_type,
+      typename guts::infer_function_traits_t<KernelFunctor>::parameter_types
+  >;
+
   template<class KernelFunctor, class... Args>
   class KernelFactory final {
     static_assert(std::is_constructible<KernelFunctor, Args...>::value, "Wrong argument types for constructor of kernel functor.");
@@ -264,6 +284,7 @@ namespace detail {
   kernelFunctor(ConstructorParameters&&... constructorParameters) {
     return {
       &detail::wrap_kernel_functor<KernelFunctor, AllowDeprecatedTypes>::call,
+      reinterpret_cast<UnboxedKernelFunction*>(&detail::wrap_kernel_functor_unboxed<KernelFunctor>::call),
       detail::KernelFactory<KernelFunctor, guts::decay_t<ConstructorParameters>...>(std::forward<ConstructorParameters>(constructorParameters)...),
       detail::FunctionSchemaInferer<KernelFunctor>()
     };
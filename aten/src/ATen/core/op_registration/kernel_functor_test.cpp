@@ -69,6 +69,17 @@ TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernel_whenRegistered_the
   expectCallsIncrement(TensorType1());
 }
 
+TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernel_whenCalledUnboxed_thenCallsRightKernel) {
+  auto registrar = RegisterOperators()
+      .op("_test::my_op(Tensor dummy, int input) -> int", kernel<IncrementKernel>(), dispatchKey(TensorType1()))
+      .op("_test::my_op(Tensor dummy, int input) -> int", kernel<DecrementKernel>(), dispatchKey(TensorType2()));
+
+  auto op = c10::Dispatcher::singleton().findSchema("_test::my_op", "");
+  ASSERT_TRUE(op.has_value());
+  EXPECT_EQ(6, (callOpUnboxed<int64_t, Tensor, int64_t>(*op, dummyTensor(TensorType1()), 5)));
+  EXPECT_EQ(4, (callOpUnboxed<int64_t, Tensor, int64_t>(*op, dummyTensor(TensorType2()), 5)));
+}
+
 TEST(OperatorRegistrationTest_FunctorBasedKernel, givenMultipleOperatorsAndKernels_whenRegisteredInOneRegistrar_thenCallsRightKernel) {
   auto registrar = RegisterOperators()
       .op("_test::my_op(Tensor dummy, int input) -> int", kernel<IncrementKernel>(), dispatchKey(TensorType1()))
@@ -497,6 +508,19 @@ TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernelWithCache_thenCache
   EXPECT_EQ(6, stack[0].toInt());
 }
 
+TEST(OperatorRegistrationTest_FunctorBasedKernel, givenKernelWithCache_whenCalledUnboxed_thenCacheIsKeptCorrectly) {
+  auto registrar = RegisterOperators()
+      .op("_test::cache_op(Tensor input) -> int", kernel<KernelWithCache>(), dispatchKey(TensorType1()));
+
+  auto op = c10::Dispatcher::singleton().findSchema("_test::cache_op", "");
+  ASSERT_TRUE(op.has_value());
+
+  auto kernel = c10::Dispatcher::singleton().lookup(*op, TensorType1());
+  EXPECT_EQ(4, kernel.callUnboxed<int64_t>(dummyTensor(TensorType1())));
+  EXPECT_EQ(5, kernel.callUnboxed<int64_t>(dummyTensor(TensorType1())));
+  EXPECT_EQ(6, kernel.callUnboxed<int64_t>(dummyTensor(TensorType1())));
+}
+
 class KernelWithConstructorArg final : public OperatorKernel {
 public:
   explicit KernelWithConstructorArg(int64_t offset)
@@ -211,6 +211,24 @@ TEST(OperatorRegistrationTest_LambdaBasedKernel, givenKernelWithMultipleOutputs_
   EXPECT_EQ(TensorType2(), result[2].toTensorListRef()[1].type_id());
 }
 
+TEST(OperatorRegistrationTest_LambdaBasedKernel, givenKernelWithMultipleOutputs_whenCalledUnboxed_thenReturnsOutputs) {
+  auto registrar = RegisterOperators()
+     .op("_test::multiple_outputs(Tensor[] dummy, int[] ints) -> (Tensor, int)",
+       kernel([] (ArrayRef<Tensor> tensors, ArrayRef<int64_t> ints) -> std::tuple<Tensor, int64_t> {
+         return std::tuple<Tensor, int64_t>(tensors[1], ints.size());
+       }),
+       dispatchKey(TensorType1()));
+
+  auto op = c10::Dispatcher::singleton().findSchema("_test::multiple_outputs", "");
+  ASSERT_TRUE(op.has_value());
+
+  std::vector<Tensor> tensors = {dummyTensor(TensorType1()), dummyTensor(TensorType2())};
+  std::vector<int64_t> ints = {1, 2, 3};
+  auto result = callOpUnboxed<std::tuple<Tensor, int64_t>, ArrayRef<Tensor>, ArrayRef<int64_t>>(*op, tensors, ints);
+  EXPECT_EQ(TensorType2(), std::get<0>(result).type_id());
+  EXPECT_EQ(3, std::get<1>(result));
+}
+
 TEST(OperatorRegistrationTest_LambdaBasedKernel, givenKernelWithTensorInputByReference_withOutput_whenRegistered_thenCanBeCalled) {
   auto registrar = RegisterOperators()
       .op("_test::tensor_input(Tensor input) -> Tensor",
@@ -420,6 +438,18 @@ TEST(OperatorRegistrationTest_LambdaBasedKernel, givenFallbackKernelWithoutTenso
   EXPECT_EQ(4, outputs[0].toInt());
 }
 
+TEST(OperatorRegistrationTest_LambdaBasedKernel, givenFallbackKernelWithoutAnyArguments_whenCalledUnboxed_thenCanBeCalled) {
+  auto registrar = RegisterOperators()
+      .op("_test::no_tensor_args() -> ()", kernel([] () {called = true;}));
+
+  auto op = c10::Dispatcher::singleton().findSchema("_test::no_tensor_args", "");
+  ASSERT_TRUE(op.has_value());
+
+  called = false;
+  callOpUnboxed<void>(*op);
+  EXPECT_TRUE(called);
+}
+
 c10::optional<Tensor> called_arg2;
 c10::optional<int64_t> called_arg3;
 c10::optional<std::string> called_arg4;
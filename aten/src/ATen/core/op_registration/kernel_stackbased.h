@@ -26,26 +26,30 @@ namespace detail {
   template<class KernelCacheCreatorFunction_, class InferFunctionSchemaFunction>
   struct KernelRegistrationConfigParameter final {
     template<class KernelCacheCreatorFunction__>
-    constexpr KernelRegistrationConfigParameter(KernelFunction* kernel_func, KernelCacheCreatorFunction__&& cache_creator_func, InferFunctionSchemaFunction&& infer_function_schema_func)
+    constexpr KernelRegistrationConfigParameter(KernelFunction* kernel_func, UnboxedKernelFunction* unboxed_kernel_func, KernelCacheCreatorFunction__&& cache_creator_func, InferFunctionSchemaFunction&& infer_function_schema_func)
     : kernel_func_(kernel_func)
+    , unboxed_kernel_func_(unboxed_kernel_func)
     , cache_creator_func_(std::forward<KernelCacheCreatorFunction__>(cache_creator_func))
     , infer_function_schema_func_(std::forward<InferFunctionSchemaFunction>(infer_function_schema_func)) {
     }
 
     void apply(KernelRegistrationConfig* registration) const & {
       registration->kernel_func = kernel_func_;
+      registration->unboxed_kernel_func = unboxed_kernel_func_;
       registration->cache_creator_func = cache_creator_func_;
       registration->inferred_function_schema = infer_function_schema_func_();
     }
 
     void apply(KernelRegistrationConfig* registration) && {
       registration->kernel_func = kernel_func_;
+      registration->unboxed_kernel_func = unboxed_kernel_func_;
       registration->cache_creator_func = std::move(cache_creator_func_);
       registration->inferred_function_schema = std::move(infer_function_schema_func_)();
     }
 
   private:
     KernelFunction* kernel_func_;
+    UnboxedKernelFunction* unboxed_kernel_func_;
     KernelCacheCreatorFunction_ cache_creator_func_;
     InferFunctionSchemaFunction infer_function_schema_func_;
   };
@@ -75,7 +79,7 @@ template<class KernelCacheCreatorFunction_>
 inline constexpr detail::KernelRegistrationConfigParameter<guts::decay_t<KernelCacheCreatorFunction_>, detail::NoFunctionSchemaInference> kernel(KernelFunction* kernel_func, KernelCacheCreatorFunction_&& cache_creator) {
   static_assert(detail::is_registration_config_parameter<detail::KernelRegistrationConfigParameter<guts::decay_t<KernelCacheCreatorFunction_>, detail::NoFunctionSchemaInference>>::value, "KernelRegistrationConfigParameter must fulfill the registration config parameter concept");
 
-  return {kernel_func, std::forward<KernelCacheCreatorFunction_>(cache_creator), detail::NoFunctionSchemaInference()};
+  return {kernel_func, nullptr, std::forward<KernelCacheCreatorFunction_>(cache_creator), detail::NoFunctionSchemaInference()};
 }
 
 }
@@ -64,6 +64,17 @@ TEST(OperatorRegistrationTest_StackBasedKernel, givenKernel_whenRegistered_thenC
   expectCallsIncrement(TensorType1());
 }
 
+TEST(OperatorRegistrationTest_StackBasedKernel, givenKernel_whenCalledUnboxed_thenBoxesArguments) {
+  auto registrar = RegisterOperators()
+      .op("_test::my_op(Tensor dummy, int input) -> int", kernel(&incrementKernel, &noCache), dispatchKey(TensorType1()))
+      .op("_test::my_op(Tensor dummy, int input) -> int", kernel(&decrementKernel, &noCache), dispatchKey(TensorType2()));
+
+  auto op = c10::Dispatcher::singleton().findSchema("_test::my_op", "");
+  ASSERT_TRUE(op.has_value());
+  EXPECT_EQ(6, (callOpUnboxed<int64_t, at::Tensor, int64_t>(*op, dummyTensor(TensorType1()), 5)));
+  EXPECT_EQ(4, (callOpUnboxed<int64_t, at::Tensor, int64_t>(*op, dummyTensor(TensorType2()), 5)));
+}
+
 TEST(OperatorRegistrationTest_StackBasedKernel, givenMultipleOperatorsAndKernels_whenRegisteredInOneRegistrar_thenCallsRightKernel) {
   auto registrar = RegisterOperators()
       .op("_test::my_op(Tensor dummy, int input) -> int", kernel(&incrementKernel, &noCache), dispatchKey(TensorType1()))
@@ -12,16 +12,18 @@ static_assert(std::is_nothrow_move_assignable<c10::optional<RegistrationHandleRA
 // table deregisters it in the destructor.
 class RegisterOperators::OperatorRegistrar final {
 public:
-  explicit OperatorRegistrar(FunctionSchema&& schema, c10::optional<TensorTypeId> dispatch_key, KernelFunction* kernel, KernelCacheCreatorFunction&& cache_creator)
+  explicit OperatorRegistrar(FunctionSchema&& schema, c10::optional<TensorTypeId> dispatch_key, KernelFunction* kernel, UnboxedKernelFunction* unboxed_kernel, KernelCacheCreatorFunction&& cache_creator)
   : op_(Dispatcher::singleton().registerSchema(std::move(schema))), kernel_registration_handle_(c10::nullopt) {
     // either both, kernel and cache_creator, or none must be set.
     AT_ASSERT((kernel != nullptr) == static_cast<bool>(cache_creator));
+    // an unboxed kernel is optional, but it always comes with a boxed kernel.
+    AT_ASSERT(kernel != nullptr || unboxed_kernel == nullptr);
 
     if (kernel != nullptr) {
       if (dispatch_key.has_value()) {
-        kernel_registration_handle_ = Dispatcher::singleton().registerKernel(op_.opHandle(), *dispatch_key, kernel, std::move(cache_creator));
+        kernel_registration_handle_ = Dispatcher::singleton().registerKernel(op_.opHandle(), *dispatch_key, kernel, unboxed_kernel, std::move(cache_creator));
       } else {
-        kernel_registration_handle_ = Dispatcher::singleton().registerFallbackKernel(op_.opHandle(), kernel, std::move(cache_creator));
+        kernel_registration_handle_ = Dispatcher::singleton().registerFallbackKernel(op_.opHandle(), kernel, unboxed_kernel, std::move(cache_creator));
       }
     }
   }
@@ -79,7 +81,7 @@ void RegisterOperators::registerOp_(FunctionSchema&& schema, detail::KernelRegis
   // if kernel_func is set, so must be cache_creator_func, the API shouldn't allow anything else.
   AT_ASSERT((config.kernel_func != nullptr) == static_cast<bool>(config.cache_creator_func));
 
-  registrars_.emplace_back(std::move(schema), config.dispatch_key, config.kernel_func, std::move(config.cache_creator_func));
+  registrars_.emplace_back(std::move(schema), config.dispatch_key, config.kernel_func, config.unboxed_kernel_func, std::move(config.cache_creator_func));
 }
 
 RegisterOperators::RegisterOperators() = default;
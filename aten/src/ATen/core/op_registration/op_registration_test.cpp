@@ -265,6 +265,31 @@ TEST(OperatorRegistrationTest, givenKernelsWithSameDispatchKey_whenNewerKernelDe
   EXPECT_FALSE(called_kernel2);
 }
 
+TEST(OperatorRegistrationTest, givenOpCalled_whenNewerKernelRegisteredAndDeleted_thenCallsNewerAndThenOlderKernel) {
+  bool called_kernel1 = false;
+  bool called_kernel2 = false;
+  auto registrar1 = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", kernel<MockKernel>(&called_kernel1), dispatchKey(TensorType1()));
+
+  auto op = Dispatcher::singleton().findSchema("_test::dummy", "");
+  ASSERT_TRUE(op.has_value()); // assert schema is registered
+
+  // this caches the kernel of TensorType1 on this thread
+  callOp(*op, dummyTensor(TensorType1()));
+  EXPECT_TRUE(called_kernel1);
+
+  called_kernel1 = false;
+  auto registrar2 = c10::RegisterOperators().op("_test::dummy(Tensor dummy) -> ()", kernel<MockKernel>(&called_kernel2), dispatchKey(TensorType1()));
+  callOp(*op, dummyTensor(TensorType1()));
+  EXPECT_FALSE(called_kernel1);
+  EXPECT_TRUE(called_kernel2);
+
+  called_kernel2 = false;
+  registrar2 = c10::RegisterOperators(); // destruct the registrar
+  callOp(*op, dummyTensor(TensorType1()));
+  EXPECT_TRUE(called_kernel1);
+  EXPECT_FALSE(called_kernel2);
+}
+
 TEST(OperatorRegistrationTest, givenKernelsWithSameFallbackDispatchKey_whenNewerKernelDeletedAndOpCalled_thenCallsOlderKernel) {
   bool called_kernel1 = false;
   bool called_kernel2 = false;
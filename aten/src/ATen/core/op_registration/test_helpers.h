@@ -63,6 +63,11 @@ inline std::vector<c10::IValue> callOp(const c10::OperatorHandle& op, Args... ar
   return stack;
 }
 
+template<class Result, class... Args>
+inline Result callOpUnboxed(const c10::OperatorHandle& op, Args... args) {
+  return c10::Dispatcher::singleton().callUnboxed<Result, Args...>(op, std::move(args)...);
+}
+
 inline void expectDoesntFindKernel(const char* op_name, c10::TensorTypeId dispatch_key) {
   auto op = c10::Dispatcher::singleton().findSchema(op_name, "");
   EXPECT_ANY_THROW(
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <ATen/cpu/vec256/vec256_float.h>
+#include <c10/util/Half.h>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// Vec256<Half> holds 16 half precision values (256 bits in memory), which
+// are widened to two Vec256<float> by loadu and narrowed again by store,
+// using the F16C conversion instructions when they are available.
+// Every operation in between is carried out in single precision, so chained
+// operations, and the accumulators of reductions, keep fp32 intermediates and
+// only round to half precision once the result is stored.
+//
+// NB: as the values are kept in single precision, the all-ones masks produced
+// by comparisons are only meaningful as input to blendv and the bitwise
+// operators; stored to memory they read as NaN, not as all-ones halves.
+template <> class Vec256<Half> {
+private:
+  Vec256<float> lo;
+  Vec256<float> hi;
+
+  static inline Vec256<float> load_half8(const void* ptr) {
+#if defined(__AVX2__) && defined(__F16C__) && !defined(_MSC_VER)
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+#else
+    float values[8];
+    for (int64_t i = 0; i < 8; i++) {
+      values[i] = reinterpret_cast<const Half*>(ptr)[i];
+    }
+    return Vec256<float>::loadu(values);
+#endif
+  }
+  static inline void store_half8(void* ptr, const Vec256<float>& v) {
+#if defined(__AVX2__) && defined(__F16C__) && !defined(_MSC_VER)
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(ptr),
+        _mm256_cvtps_ph(v, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+#else
+    float values[8];
+    v.store(values);
+    for (int64_t i = 0; i < 8; i++) {
+      reinterpret_cast<Half*>(ptr)[i] = values[i];
+    }
+#endif
+  }
+public:
+  static constexpr int size() {
+    return 16;
+  }
+  Vec256() {}
+  Vec256(const Vec256<float>& lo, const Vec256<float>& hi) : lo(lo), hi(hi) {}
+  Vec256(Half val) : lo(static_cast<float>(val)), hi(static_cast<float>(val)) {}
+  // The lower and upper eight values, in single precision.
+  const Vec256<float>& low() const {
+    return lo;
+  }
+  const Vec256<float>& high() const {
+    return hi;
+  }
+  template <int64_t mask>
+  static Vec256<Half> blend(const Vec256<Half>& a, const Vec256<Half>& b) {
+    return Vec256<Half>(
+        Vec256<float>::blend<mask & 0xFF>(a.lo, b.lo),
+        Vec256<float>::blend<(mask >> 8) & 0xFF>(a.hi, b.hi));
+  }
+  static Vec256<Half> blendv(const Vec256<Half>& a, const Vec256<Half>& b,
+                             const Vec256<Half>& mask) {
+    return Vec256<Half>(
+        Vec256<float>::blendv(a.lo, b.lo, mask.lo),
+        Vec256<float>::blendv(a.hi, b.hi, mask.hi));
+  }
+  static Vec256<Half> arange(Half base = 0.f, Half step = 1.f) {
+    const float fbase = base;
+    const float fstep = step;
+    return Vec256<Half>(
+        Vec256<float>::arange(fbase, fstep),
+        Vec256<float>::arange(fbase + 8 * fstep, fstep));
+  }
+  static Vec256<Half> set(const Vec256<Half>& a, const Vec256<Half>& b,
+                          int64_t count = size()) {
+    if (count <= 8) {
+      return Vec256<Half>(Vec256<float>::set(a.lo, b.lo, count), a.hi);
+    }
+    return Vec256<Half>(b.lo, Vec256<float>::set(a.hi, b.hi, count - 8));
+  }
+  static Vec256<Half> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return Vec256<Half>(
+          load_half8(ptr), load_half8(reinterpret_cast<const Half*>(ptr) + 8));
+    }
+    Half tmp_values[size()];
+    std::memset(static_cast<void*>(tmp_values), 0, sizeof(tmp_values));
+    std::memcpy(tmp_values, ptr, count * sizeof(Half));
+    return Vec256<Half>(load_half8(tmp_values), load_half8(tmp_values + 8));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      store_half8(ptr, lo);
+      store_half8(reinterpret_cast<Half*>(ptr) + 8, hi);
+    } else if (count > 0) {
+      Half tmp_values[size()];
+      store_half8(tmp_values, lo);
+      store_half8(tmp_values + 8, hi);
+      std::memcpy(ptr, tmp_values, count * sizeof(Half));
+    }
+  }
+  const Half& operator[](int idx) const  = delete;
+  Half& operator[](int idx) = delete;
+  Vec256<Half> map(Half (*f)(Half)) const {
+    Half tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+#define DEFINE_UNARY_OP(op)                  \
+  Vec256<Half> op() const {                  \
+    return Vec256<Half>(lo.op(), hi.op());   \
+  }
+  DEFINE_UNARY_OP(abs)
+  DEFINE_UNARY_OP(acos)
+  DEFINE_UNARY_OP(asin)
+  DEFINE_UNARY_OP(atan)
+  DEFINE_UNARY_OP(erf)
+  DEFINE_UNARY_OP(erfc)
+  DEFINE_UNARY_OP(exp)
+  DEFINE_UNARY_OP(expm1)
+  DEFINE_UNARY_OP(log)
+  DEFINE_UNARY_OP(log2)
+  DEFINE_UNARY_OP(log10)
+  DEFINE_UNARY_OP(log1p)
+  DEFINE_UNARY_OP(frac)
+  DEFINE_UNARY_OP(sin)
+  DEFINE_UNARY_OP(sinh)
+  DEFINE_UNARY_OP(cos)
+  DEFINE_UNARY_OP(cosh)
+  DEFINE_UNARY_OP(ceil)
+  DEFINE_UNARY_OP(floor)
+  DEFINE_UNARY_OP(neg)
+  DEFINE_UNARY_OP(round)
+  DEFINE_UNARY_OP(tan)
+  DEFINE_UNARY_OP(tanh)
+  DEFINE_UNARY_OP(trunc)
+  DEFINE_UNARY_OP(sqrt)
+  DEFINE_UNARY_OP(reciprocal)
+  DEFINE_UNARY_OP(rsqrt)
+#undef DEFINE_UNARY_OP
+  Vec256<Half> pow(const Vec256<Half> &b) const {
+    return Vec256<Half>(lo.pow(b.lo), hi.pow(b.hi));
+  }
+#define DEFINE_COMP(binary_pred)                                          \
+  Vec256<Half> operator binary_pred(const Vec256<Half>& other) const {    \
+    return Vec256<Half>(lo binary_pred other.lo, hi binary_pred other.hi); \
+  }
+  DEFINE_COMP(==)
+  DEFINE_COMP(!=)
+  DEFINE_COMP(>=)
+  DEFINE_COMP(<=)
+  DEFINE_COMP(>)
+  DEFINE_COMP(<)
+#undef DEFINE_COMP
+};
+
+#define DEFINE_BINARY_OP(op)                                                   \
+template <>                                                                    \
+Vec256<Half> inline operator op(const Vec256<Half>& a, const Vec256<Half>& b) { \
+  return Vec256<Half>(a.low() op b.low(), a.high() op b.high());              \
+}
+DEFINE_BINARY_OP(+)
+DEFINE_BINARY_OP(-)
+DEFINE_BINARY_OP(*)
+DEFINE_BINARY_OP(/)
+DEFINE_BINARY_OP(&)
+DEFINE_BINARY_OP(|)
+DEFINE_BINARY_OP(^)
+#undef DEFINE_BINARY_OP
+
+template <>
+Vec256<Half> inline maximum(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return Vec256<Half>(maximum(a.low(), b.low()), maximum(a.high(), b.high()));
+}
+
+template <>
+Vec256<Half> inline minimum(const Vec256<Half>& a, const Vec256<Half>& b) {
+  return Vec256<Half>(minimum(a.low(), b.low()), minimum(a.high(), b.high()));
+}
+
+template <>
+Vec256<Half> inline fmadd(const Vec256<Half>& a, const Vec256<Half>& b, const Vec256<Half>& c) {
+  return Vec256<Half>(
+      fmadd(a.low(), b.low(), c.low()), fmadd(a.high(), b.high(), c.high()));
+}
+
+#if defined(__AVX2__) && defined(__F16C__) && !defined(_MSC_VER)
+
+template <>
+void convert(const Half* src, float* dst, int64_t n) {
+  int64_t i;
+  for (i = 0; i <= (n - 8); i += 8) {
+    _mm256_storeu_ps(
+        dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+  }
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <>
+void convert(const float* src, Half* dst, int64_t n) {
+  int64_t i;
+  for (i = 0; i <= (n - 8); i += 8) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i),
+        _mm256_cvtps_ph(_mm256_loadu_ps(src + i), (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+  }
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+#endif
+
+}}}
@@ -249,6 +249,90 @@ void convert(const int32_t *src, double *dst, int64_t n) {
   }
 }
 
+template <>
+void convert(const uint8_t *src, float *dst, int64_t n) {
+  int64_t i;
+  // widen eight bytes at a time to int32_t, which converts exactly to float
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto input_64_vec = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+    auto output_vec = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(input_64_vec));
+    _mm256_storeu_ps(reinterpret_cast<float*>(dst + i), output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+void convert(const int8_t *src, float *dst, int64_t n) {
+  int64_t i;
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    auto input_64_vec = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+    auto output_vec = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(input_64_vec));
+    _mm256_storeu_ps(reinterpret_cast<float*>(dst + i), output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+void convert(const int32_t *src, int64_t *dst, int64_t n) {
+  int64_t i;
+  // int32_t has half the size of int64_t
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<int64_t>::size()); i += Vec256<int64_t>::size()) {
+    auto input_128_vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    auto output_vec = _mm256_cvtepi32_epi64(input_128_vec);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<int64_t>(src[i]);
+  }
+}
+
+template <>
+void convert(const int64_t *src, int32_t *dst, int64_t n) {
+  int64_t i;
+  // keep the low half of every element, as static_cast does: gather the even
+  // 32 bit lanes of two vectors into one
+  const __m256i even_lanes = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (i = 0; i <= (n - Vec256<int32_t>::size()); i += Vec256<int32_t>::size()) {
+    auto a = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), even_lanes);
+    auto b = _mm256_permutevar8x32_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 4)), even_lanes);
+    auto output_vec = _mm256_permute2x128_si256(a, b, 0x20);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), output_vec);
+  }
+#ifndef _MSC_VER
+# pragma unroll
+#endif
+  for (; i < n; i++) {
+    dst[i] = static_cast<int32_t>(src[i]);
+  }
+}
+
 template <>
 struct Vec256<int16_t> : public Vec256i {
   static constexpr int size() {
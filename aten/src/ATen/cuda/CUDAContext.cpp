@@ -56,10 +56,6 @@ cusparseHandle_t getCurrentCUDASparseHandle() {
   return THCState_getCurrentSparseHandle(at::globalContext().getTHCState());
 }
 
-cublasHandle_t getCurrentCUDABlasHandle() {
-  return THCState_getCurrentBlasHandle(at::globalContext().getTHCState());
-}
-
 } // namespace cuda
 
 } // namespace at
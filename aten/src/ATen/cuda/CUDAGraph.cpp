@@ -0,0 +1,196 @@
+#include <ATen/cuda/CUDAGraph.h>
+
+#include <ATen/Context.h>
+#include <ATen/Functions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/cuda/PhiloxCudaState.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <THC/THCGeneral.h>
+#include <THC/THCTensorRandom.h>
+#include <THC/THCGenerator.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+THCGenerator* THCRandom_getGenerator(THCState* state);
+
+namespace at { namespace cuda {
+
+namespace {
+
+// Random ops of a capture in progress read their seed and offset from
+// seed and offset_extragraph, and the capture keeps track of the offsets
+// they consume
+struct RNGCapture {
+  const int64_t* seed;
+  const int64_t* offset_extragraph;
+  uint64_t offset_intragraph;
+};
+
+std::mutex rng_capture_mutex;
+std::unordered_map<unsigned long long, RNGCapture> rng_captures;
+// rng_captures.size(), to skip the lock when nothing is being captured
+std::atomic<int> num_rng_captures{0};
+
+// pool ids handed out to graphs that don't share the pool of another one
+std::atomic<uint64_t> next_mempool_id{1};
+
+} // namespace
+
+PhiloxCudaState philox_cuda_state(uint64_t increment) {
+#ifdef C10_CUDA_GRAPHS_SUPPORTED
+  if (num_rng_captures.load() > 0) {
+    cudaStreamCaptureStatus status;
+    unsigned long long capture_id;
+    AT_CUDA_CHECK(cudaStreamGetCaptureInfo(
+        getCurrentCUDAStream(), &status, &capture_id));
+    if (status == cudaStreamCaptureStatusActive) {
+      std::lock_guard<std::mutex> lock(rng_capture_mutex);
+      auto it = rng_captures.find(capture_id);
+      AT_CHECK(it != rng_captures.end(),
+          "Random number generation during a stream capture that was not "
+          "started by CUDAGraph::capture_begin");
+      auto& capture = it->second;
+      PhiloxCudaState state(
+          capture.seed, capture.offset_extragraph, capture.offset_intragraph);
+      capture.offset_intragraph += increment;
+      return state;
+    }
+  }
+#endif
+  auto gen = THCRandom_getGenerator(globalContext().getTHCState());
+  uint64_t offset = gen->state.philox_seed_offset.fetch_add(increment);
+  return PhiloxCudaState(gen->state.initial_seed, offset);
+}
+
+CUDAGraph::CUDAGraph()
+  : capture_stream_(getCurrentCUDAStream()) {}
+
+CUDAGraph::~CUDAGraph() {
+  reset();
+}
+
+void CUDAGraph::capture_begin(uint64_t pool) {
+#ifdef C10_CUDA_GRAPHS_SUPPORTED
+  AT_CHECK(!has_graph_exec_ && capture_dev_ == -1,
+      "This CUDAGraph instance already owns a captured graph. "
+      "To capture a new graph, create a new instance or call reset() first.");
+
+  auto stream = getCurrentCUDAStream();
+  AT_CHECK(stream != getDefaultCUDAStream(),
+      "CUDA graphs must be captured on a non-default stream. "
+      "(However, after capture, it's ok to replay them on the default stream.)");
+  capture_stream_ = stream;
+  capture_dev_ = stream.device_index();
+
+  // Allocated before the capture starts, so they don't come from its pool
+  auto options = TensorOptions().device(kCUDA).dtype(kLong);
+  seed_extragraph_ = at::empty({1}, options);
+  offset_extragraph_ = at::empty({1}, options);
+
+  AT_CUDA_CHECK(cudaStreamBeginCapture(stream, cudaStreamCaptureModeRelaxed));
+  cudaStreamCaptureStatus status;
+  AT_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &capture_id_));
+  AT_ASSERT(status == cudaStreamCaptureStatusActive);
+
+  mempool_id_ = pool != 0 ? pool : next_mempool_id.fetch_add(1);
+  c10::cuda::CUDACachingAllocator::notifyCaptureBegin(
+      capture_dev_, capture_id_, mempool_id_);
+  {
+    std::lock_guard<std::mutex> lock(rng_capture_mutex);
+    rng_captures[capture_id_] = RNGCapture{
+        seed_extragraph_.data<int64_t>(),
+        offset_extragraph_.data<int64_t>(),
+        0};
+    num_rng_captures++;
+  }
+#else
+  AT_ERROR("CUDA graphs require CUDA 10.1 or newer");
+#endif
+}
+
+void CUDAGraph::capture_end() {
+#ifdef C10_CUDA_GRAPHS_SUPPORTED
+  auto stream = getCurrentCUDAStream();
+  AT_CHECK(capture_dev_ != -1 && !has_graph_exec_,
+      "Called CUDAGraph::capture_end without a preceding capture_begin");
+  AT_CHECK(stream == capture_stream_,
+      "Capture must end on the same stream it began on.");
+
+  c10::cuda::CUDACachingAllocator::notifyCaptureEnd(capture_dev_, capture_id_);
+  {
+    std::lock_guard<std::mutex> lock(rng_capture_mutex);
+    wholegraph_increment_ = rng_captures.at(capture_id_).offset_intragraph;
+    rng_captures.erase(capture_id_);
+    num_rng_captures--;
+  }
+
+  cudaGraph_t graph = nullptr;
+  AT_CUDA_CHECK(cudaStreamEndCapture(stream, &graph));
+  AT_CHECK(graph != nullptr, "Invalid capture.");
+  cudaError_t err = cudaGraphInstantiate(&graph_exec_, graph, nullptr, nullptr, 0);
+  // The executable graph doesn't depend on the graph it was made from
+  AT_CUDA_CHECK(cudaGraphDestroy(graph));
+  AT_CUDA_CHECK(err);
+  has_graph_exec_ = true;
+#else
+  AT_ERROR("CUDA graphs require CUDA 10.1 or newer");
+#endif
+}
+
+void CUDAGraph::replay() {
+#ifdef C10_CUDA_GRAPHS_SUPPORTED
+  AT_CHECK(has_graph_exec_,
+      "Called CUDAGraph::replay without a preceding successful capture.");
+  c10::cuda::CUDAGuard device_guard(capture_dev_);
+
+  if (wholegraph_increment_ > 0) {
+    // Queued on the replay stream, so the graph sees the new values
+    auto gen = THCRandom_getGenerator(globalContext().getTHCState());
+    uint64_t offset =
+        gen->state.philox_seed_offset.fetch_add(wholegraph_increment_);
+    seed_extragraph_.fill_(static_cast<int64_t>(gen->state.initial_seed));
+    offset_extragraph_.fill_(static_cast<int64_t>(offset));
+  }
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, getCurrentCUDAStream()));
+#else
+  AT_ERROR("CUDA graphs require CUDA 10.1 or newer");
+#endif
+}
+
+void CUDAGraph::reset() {
+#ifdef C10_CUDA_GRAPHS_SUPPORTED
+  // Called by the destructor as well, so it can't throw
+  if (has_graph_exec_) {
+    cudaError_t err = cudaGraphExecDestroy(graph_exec_);
+    if (err != cudaSuccess) {
+      cudaGetLastError();
+      AT_WARN("Failed to destroy a CUDA graph: ", cudaGetErrorString(err));
+    }
+    has_graph_exec_ = false;
+  }
+  if (capture_dev_ != -1 && mempool_id_ != 0) {
+    try {
+      c10::cuda::CUDACachingAllocator::releasePool(capture_dev_, mempool_id_);
+    } catch (const c10::Error& e) {
+      AT_WARN("Failed to release the memory pool of a CUDA graph: ", e.msg());
+    }
+  }
+  capture_dev_ = -1;
+  mempool_id_ = 0;
+  wholegraph_increment_ = 0;
+  seed_extragraph_.reset();
+  offset_extragraph_.reset();
+#endif
+}
+
+uint64_t CUDAGraph::pool() const {
+  AT_CHECK(mempool_id_ != 0,
+      "Called CUDAGraph::pool() without a preceding capture_begin");
+  return mempool_id_;
+}
+
+}} // namespace at::cuda
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cstdint>
+
+namespace at { namespace cuda {
+
+/*
+* A CUDAGraph records the CUDA work queued on the current stream between
+* capture_begin() and capture_end() into a CUDA graph, which replay() then
+* launches again with a single cudaGraphLaunch, without going through the
+* host side of the captured ops. It is made for steps whose shapes, control
+* flow and input/output addresses don't change from one run to the next,
+* such as inference or training steps on static buffers: the user copies new
+* data into the input tensors used during capture, replays, and reads the
+* outputs from the tensors the capture produced.
+*
+* - Capture must happen on a non-default stream (replays don't have to), and
+*   each op should be run once before capture so that lazy initialization,
+*   cuDNN benchmarking and the like don't happen during it.
+* - Memory allocated during capture comes from a private pool of the caching
+*   allocator, which stays reserved for the graph until reset(). Graphs that
+*   are replayed in the order they were captured in can share a pool, by
+*   passing the pool() of one to capture_begin of the next.
+* - Philox based random ops (dropout, bernoulli, ...) read their seed and
+*   offset from device memory that replay() fills from the default CUDA
+*   generator, so each replay draws new numbers, and advances the generator
+*   like the captured ops would have.
+*
+* Requires CUDA 10.1 or newer.
+*/
+struct AT_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  CUDAGraph(const CUDAGraph&) = delete;
+  CUDAGraph& operator=(const CUDAGraph&) = delete;
+
+  // pool is the pool() of another graph to share memory with, or 0 for a
+  // new private pool
+  void capture_begin(uint64_t pool = 0);
+  void capture_end();
+  void replay();
+  // Destroys the graph and releases its memory pool
+  void reset();
+  uint64_t pool() const;
+
+ private:
+#ifdef C10_CUDA_GRAPHS_SUPPORTED
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+  bool has_graph_exec_ = false;
+
+  // id of the stream capture, and of the private memory pool
+  unsigned long long capture_id_ = 0;
+  uint64_t mempool_id_ = 0;
+  int capture_dev_ = -1;
+  c10::cuda::CUDAStream capture_stream_;
+
+  // Seed and offset the captured random ops read, refreshed at each replay
+  at::Tensor seed_extragraph_;
+  at::Tensor offset_extragraph_;
+  // Philox offsets consumed by one replay
+  uint64_t wholegraph_increment_ = 0;
+};
+
+}} // namespace at::cuda
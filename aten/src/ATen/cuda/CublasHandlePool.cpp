@@ -0,0 +1,41 @@
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/detail/DeviceThreadHandles.h>
+
+#include <THC/THCGeneral.h>
+
+namespace at { namespace cuda {
+
+namespace {
+
+void createCublasHandle(cublasHandle_t *handle) {
+  THCublasCheck(cublasCreate(handle));
+}
+
+void destroyCublasHandle(cublasHandle_t handle) {
+// As with the cuDNN handles, the cuda context may already be destroyed by the
+// time the handles are destroyed at exit.
+#ifdef NO_CUDNN_DESTROY_HANDLE
+#else
+  cublasDestroy(handle);
+#endif
+}
+
+using CuBlasPoolType = DeviceThreadHandlePool<cublasHandle_t, createCublasHandle, destroyCublasHandle>;
+
+} // namespace
+
+cublasHandle_t getCurrentCUDABlasHandle() {
+  int device;
+  AT_CUDA_CHECK(cudaGetDevice(&device));
+
+  // The PoolWindow of a thread is created the first time it requests a handle
+  // and destroyed when it terminates, releasing its reserved handles back to
+  // the pool.
+  static auto pool = std::make_shared<CuBlasPoolType>();
+  thread_local std::unique_ptr<CuBlasPoolType::PoolWindow> myPoolWindow(
+      pool->newPoolWindow());
+
+  return myPoolWindow->reserve(device);
+}
+
+}} // namespace at::cuda
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <c10/macros/Macros.h>
+
+#include <cstdint>
+#include <utility>
+
+namespace at { namespace cuda {
+
+// The seed and offset a philox based kernel initializes its curand state
+// with, as returned by philox_cuda_state.
+//
+// Outside of stream capture, they are plain values. While the kernel is
+// captured into a CUDA graph, the seed and offset must change at every
+// replay, so they are read on the device from tensors that CUDAGraph fills
+// before each replay, and the offset is advanced by offset_intragraph_: the
+// amount consumed by the kernels captured before this one.
+//
+// Kernels take the state by value and call philox::unpack on the device.
+struct PhiloxCudaState {
+  PhiloxCudaState() = default;
+  PhiloxCudaState(uint64_t seed, uint64_t offset)
+      : seed_(seed), offset_(offset) {}
+  PhiloxCudaState(
+      const int64_t* seed_ptr,
+      const int64_t* offset_extragraph,
+      uint64_t offset_intragraph)
+      : seed_ptr_(seed_ptr),
+        offset_extragraph_(offset_extragraph),
+        offset_intragraph_(offset_intragraph),
+        captured_(true) {}
+
+  uint64_t seed_ = 0;
+  uint64_t offset_ = 0;
+  const int64_t* seed_ptr_ = nullptr;
+  const int64_t* offset_extragraph_ = nullptr;
+  uint64_t offset_intragraph_ = 0;
+  bool captured_ = false;
+};
+
+namespace philox {
+
+// Returns (seed, offset) to pass to curand_init
+inline C10_HOST_DEVICE std::pair<uint64_t, uint64_t> unpack(
+    const PhiloxCudaState& state) {
+  if (state.captured_) {
+    return std::pair<uint64_t, uint64_t>(
+        static_cast<uint64_t>(*state.seed_ptr_),
+        static_cast<uint64_t>(*state.offset_extragraph_) +
+            state.offset_intragraph_);
+  }
+  return std::pair<uint64_t, uint64_t>(state.seed_, state.offset_);
+}
+
+} // namespace philox
+
+// Reserves increment philox offsets of the default CUDA generator for a
+// kernel launched on the current stream. increment should be at least the
+// number of curand() random numbers used in each thread.
+AT_CUDA_API PhiloxCudaState philox_cuda_state(uint64_t increment);
+
+}} // namespace at::cuda
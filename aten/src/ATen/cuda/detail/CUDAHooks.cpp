@@ -14,6 +14,7 @@
 
 #if AT_CUDNN_ENABLED()
 #include <ATen/cudnn/cudnn-wrapper.h>
+#include <ATen/native/cudnn/BenchmarkCache.h>
 #endif
 
 #ifdef USE_MAGMA
@@ -220,6 +221,22 @@ int64_t CUDAHooks::cuFFTGetPlanCacheSize(int64_t device_index) const {
 #endif
 }
 
+int64_t CUDAHooks::cuFFTGetPlanCacheHits(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_hits_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
+int64_t CUDAHooks::cuFFTGetPlanCacheMisses(int64_t device_index) const {
+#ifndef __HIP_PLATFORM_HCC__
+  return at::native::detail::cufft_get_plan_cache_misses_impl(device_index);
+#else
+  AT_ERROR("cuFFT with HIP is not supported");
+#endif
+}
+
 void CUDAHooks::cuFFTClearPlanCache(int64_t device_index) const {
 #ifndef __HIP_PLATFORM_HCC__
   at::native::detail::cufft_clear_plan_cache_impl(device_index);
@@ -228,6 +245,22 @@ void CUDAHooks::cuFFTClearPlanCache(int64_t device_index) const {
 #endif
 }
 
+int64_t CUDAHooks::saveCuDNNBenchmarkCache(const std::string& path) const {
+#if AT_CUDNN_ENABLED()
+  return at::native::detail::cudnn_save_benchmark_cache_impl(path);
+#else
+  AT_ERROR("Cannot save cuDNN benchmark cache if ATen_cuda is not built with CuDNN");
+#endif
+}
+
+int64_t CUDAHooks::loadCuDNNBenchmarkCache(const std::string& path) const {
+#if AT_CUDNN_ENABLED()
+  return at::native::detail::cudnn_load_benchmark_cache_impl(path);
+#else
+  AT_ERROR("Cannot load cuDNN benchmark cache if ATen_cuda is not built with CuDNN");
+#endif
+}
+
 int CUDAHooks::getNumGPUs() const {
   return at::cuda::device_count();
 }
@@ -123,10 +123,26 @@ struct CAFFE2_API CUDAHooksInterface {
     AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
   }
 
+  virtual int64_t cuFFTGetPlanCacheHits(int64_t device_index) const {
+    AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t cuFFTGetPlanCacheMisses(int64_t device_index) const {
+    AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual void cuFFTClearPlanCache(int64_t device_index) const {
     AT_ERROR("Cannot access cuFFT plan cache without ATen_cuda library. ", CUDA_HELP);
   }
 
+  virtual int64_t saveCuDNNBenchmarkCache(const std::string& path) const {
+    AT_ERROR("Cannot access cuDNN benchmark cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
+  virtual int64_t loadCuDNNBenchmarkCache(const std::string& path) const {
+    AT_ERROR("Cannot access cuDNN benchmark cache without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual int getNumGPUs() const {
     return 0;
   }
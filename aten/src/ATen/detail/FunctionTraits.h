@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <tuple>
 
 // Modified from https://stackoverflow.com/questions/7943525/is-it-possible-to-figure-out-the-parameter-type-and-return-type-of-a-lambda
@@ -40,6 +41,8 @@ struct function_traits<ReturnType(Args...)> {
 
   typedef ReturnType result_type;
 
+  typedef std::tuple<Args...> ArgsTuple;
+
   template <size_t i>
   struct arg
   {
@@ -14,6 +14,7 @@ static const double SELU_ALPHA = 1.6732632423543772848170429916717;
 static const double SELU_SCALE = 1.0507009873554804934193349852946;
 
 DEFINE_DISPATCH(threshold_stub);
+DEFINE_DISPATCH(bias_relu_stub);
 
 Tensor relu(const Tensor & self) {
   return at::threshold(self, 0, 0);
@@ -8,8 +8,11 @@ namespace at { struct TensorIterator; }
 namespace at { namespace native {
 
 using threshold_fn = void(*)(TensorIterator&, Scalar, Scalar);
+using bias_relu_fn = void(*)(TensorIterator&);
 
 DECLARE_DISPATCH(threshold_fn, threshold_stub);
+// computes `result = relu(self + bias)`, the epilogue of _linear_relu
+DECLARE_DISPATCH(bias_relu_fn, bias_relu_stub);
 
 
 }} // namespace at::native
@@ -271,6 +271,11 @@ namespace {
 
     if (output_size[0] == 1 && output_size[1] == 1) {
 //in this case, adaptive pooling is just computing mean over hw dimensions, which can be done more efficiently
+       if (input.suggest_memory_format() == MemoryFormat::ChannelsLast) {
+         // reduce in place instead of making a contiguous copy of the input;
+         // the (N, C, 1, 1) result is channels last contiguous as well
+         return input.mean({-1, -2}, /*keepdim=*/true);
+       }
        int64_t mean_size = input.size(-1) * input.size(-2);
        Tensor out = input.contiguous().view({-1, mean_size}).mean(-1);
        return input.ndimension() == 3 ? out.view({input.size(0), 1, 1}) : out.view({input.size(0), input.size(1), 1, 1});
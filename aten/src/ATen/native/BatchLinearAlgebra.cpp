@@ -9,6 +9,7 @@
 
 #include <TH/TH.h>  // for USE_LAPACK
 
+#include <algorithm>
 #include <vector>
 
 // First the required LAPACK implementations are registered here.
@@ -129,6 +130,20 @@ template<> void lapackTriangularSolve<float>(char uplo, char trans, char diag, i
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
 // in the main helper functions for the linear algebra operations
 
+// The batched functions below run LAPACK on the matrices of a batch in
+// parallel when they are at most kLapackBatchParallelMaxSize x
+// kLapackBatchParallelMaxSize; larger matrices are left to the threads of
+// the LAPACK library, one at a time. Each matrix records its own info, and
+// batchCheckErrors reports the first failure.
+static constexpr int64_t kLapackBatchParallelMaxSize = 64;
+
+static inline int64_t lapack_batch_grain_size(int64_t n, int64_t batch_size) {
+  if (n > kLapackBatchParallelMaxSize) {
+    return batch_size;
+  }
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, n * n * n));
+}
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 template<typename scalar_t>
@@ -141,26 +156,26 @@ static void apply_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  auto ipiv = at::empty({n}, b.options().dtype(kInt));
-
-  int info;
   if (b.dim() == 2) {
-    lapackSolve<scalar_t>(n, nrhs, A_data, n, ipiv.data<int>(), b_data, n, &info);
+    std::vector<int> ipiv(n);
+    int info;
+    lapackSolve<scalar_t>(n, nrhs, A_data, n, ipiv.data(), b_data, n, &info);
     infos[0] = info;
   } else {
     auto A_mat_stride = matrixStride(A);
     auto b_mat_stride = matrixStride(b);
     auto batch_size = batchCount(A);
 
-    for (int64_t i = 0; i < batch_size; i++) {
-      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-      lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv.data<int>(), b_working_ptr, n, &info);
-      infos[i] = info;
-      if (info != 0) {
-        return;
+    parallel_for(0, batch_size, lapack_batch_grain_size(n, batch_size), [&](int64_t begin, int64_t end) {
+      std::vector<int> ipiv(n);
+      for (int64_t i = begin; i < end; i++) {
+        int info;
+        scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+        scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+        lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv.data(), b_working_ptr, n, &info);
+        infos[i] = info;
       }
-    }
+    });
   }
 #endif
 }
@@ -212,34 +227,30 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  auto ipiv = at::empty({n}, self.options().dtype(kInt));
-  int lwork;
+  // The optimum work size of getri only depends on n, so it is queried once
+  // for the whole batch
+  int lwork = -1;
+  int info;
   scalar_t wkopt;
-  Tensor work;
-
-  for (int64_t i = 0; i < batch_size; i++) {
-    int info;
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv.data<int>(), &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
-
-    // Run twice, first to get the optimum work size
-    lwork = -1;
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv.data<int>(), &wkopt, lwork, &info);
-
-    lwork = static_cast<int>(wkopt);
-    work = at::empty({lwork}, self.options());
-
-    // now to compute the actual inverse
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv.data<int>(), work.data<scalar_t>(), lwork, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  std::vector<int> ipiv_query(n);
+  lapackGetri<scalar_t>(n, self_data, n, ipiv_query.data(), &wkopt, lwork, &info);
+  lwork = std::max<int>(1, static_cast<int>(wkopt));
+
+  parallel_for(0, batch_size, lapack_batch_grain_size(n, batch_size), [&](int64_t begin, int64_t end) {
+    std::vector<int> ipiv(n);
+    std::vector<scalar_t> work(lwork);
+    for (int64_t i = begin; i < end; i++) {
+      int info;
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv.data(), &info);
+      infos[i] = info;
+      if (info != 0) {
+        continue;
+      }
+      lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv.data(), work.data(), lwork, &info);
+      infos[i] = info;
     }
-  }
+  });
 #endif
 }
 
@@ -294,15 +305,15 @@ static void apply_cholesky_solve(Tensor& b, Tensor& A, bool upper, std::vector<i
     auto A_mat_stride = matrixStride(A);
     auto b_mat_stride = matrixStride(b);
     auto batch_size = batchCount(A);
-    for (int64_t i = 0; i < batch_size; i++) {
-      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-      lapackCholeskySolve<scalar_t>(uplo, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
-      infos[i] = info;
-      if (info != 0) {
-        return;
+    parallel_for(0, batch_size, lapack_batch_grain_size(n, batch_size), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        int info;
+        scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+        scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+        lapackCholeskySolve<scalar_t>(uplo, n, nrhs, A_working_ptr, n, b_working_ptr, n, &info);
+        infos[i] = info;
       }
-    }
+    });
   }
 #endif
 }
@@ -359,14 +370,14 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
   } else {
     auto self_matrix_stride = matrixStride(self);
     auto batch_size = batchCount(self);
-    for (int64_t i = 0; i < batch_size; i++) {
-      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-      lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
-      infos[i] = info;
-      if (info != 0) {
-        return;
+    parallel_for(0, batch_size, lapack_batch_grain_size(n, batch_size), [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        int info;
+        scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+        lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
+        infos[i] = info;
       }
-    }
+    });
   }
 #endif
 }
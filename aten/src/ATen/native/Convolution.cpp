@@ -1,5 +1,6 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/detail/CUDAHooksInterface.h>
 #include <ATen/native/utils/ParamUtils.h>
 
 #include <ATen/Config.h>
@@ -35,6 +36,8 @@ struct ConvParams {
   bool use_mkldnn(const at::Tensor& input) const;
   bool use_nnpack(const at::Tensor& input) const;
   bool is_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
+  bool use_cpu_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
+  bool use_cpu_pointwise(const at::Tensor& input, const at::Tensor& weight) const;
 };
 
 std::ostream& operator<<(std::ostream & out, const ConvParams& params) {
@@ -187,6 +190,50 @@ auto ConvParams::is_depthwise(
          weight.size(0) % input.size(1) == 0; // output channels must be a multiple of input channels
 }
 
+// Depthwise convolutions on CPU that MKL-DNN doesn't take use the direct
+// kernel of _depthwise_convolution rather than one im2col + GEMM per group.
+auto ConvParams::use_cpu_depthwise(
+        const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  return input.type().backend() == at::Backend::CPU &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+         !transposed &&
+         input.ndimension() == 4 &&
+         input.size(1) == groups &&
+         groups > 1 &&
+         weight.size(0) % input.size(1) == 0;
+}
+
+// 1x1 convolutions with unit stride and no padding are a matrix product of
+// the weight and every image, without thnn_conv2d's unfold of the input into
+// columns (which is a copy of the input for a 1x1 kernel). These are most of
+// the FLOPs of mobile networks built of depthwise separable convolutions.
+auto ConvParams::use_cpu_pointwise(
+        const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  return input.type().backend() == at::Backend::CPU &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+         !transposed &&
+         !is_strided() &&
+         !is_padded() &&
+         groups == 1 &&
+         input.ndimension() == 4 &&
+         weight.size(2) == 1 && weight.size(3) == 1;
+}
+
+static at::Tensor pointwise_convolution(
+    const at::Tensor& input, const at::Tensor& weight, const at::Tensor& bias) {
+  const auto batch = input.size(0);
+  const auto height = input.size(2);
+  const auto width = input.size(3);
+  const auto out_channels = weight.size(0);
+  auto output = at::matmul(
+      weight.reshape({out_channels, input.size(1)}),
+      input.reshape({batch, input.size(1), height * width}));
+  if (bias.defined()) {
+    output = output + bias.reshape({1, out_channels, 1});
+  }
+  return output.view({batch, out_channels, height, width});
+}
+
 static void check_shape_forward(const at::Tensor& input,
                                 const at::Tensor& weight, const at::Tensor& bias,
                                 const ConvParams& params, bool input_is_mkldnn) {
@@ -364,9 +411,12 @@ at::Tensor _convolution(
     bool benchmark, bool deterministic, bool cudnn_enabled) {
 
   const bool input_is_mkldnn = input_r.is_mkldnn();
+  // The memory format of the input is also the memory format of the output,
+  // so that channels last activations stay channels last through the network.
+  const auto memory_format = input_is_mkldnn ? MemoryFormat::Contiguous : input_r.suggest_memory_format();
   auto input = input_r;
   if (!input_is_mkldnn) {
-    input = input.contiguous();
+    input = input.contiguous(memory_format);
   }
   auto weight = weight_r;
   auto bias = bias_r;
@@ -393,6 +443,13 @@ at::Tensor _convolution(
 
   check_shape_forward(input, weight, bias, params, input_is_mkldnn);
 
+  // Only cuDNN reads channels last input as is; every other backend gets a
+  // contiguous copy and its output is converted back below.
+  if (memory_format == MemoryFormat::ChannelsLast &&
+      (params.is_depthwise(input, weight) || !params.use_cudnn(input))) {
+    input = input.contiguous();
+  }
+
   if (k == 3) {
     params.view1d_as_2d();
     input = view4d(input);
@@ -459,6 +516,15 @@ at::Tensor _convolution(
                                       params.padding, params.stride, params.dilation, params.groups);
     }
 #endif
+  } else if (params.use_cpu_depthwise(input, weight)) {
+    AT_CHECK(input.type() == weight.type(),
+             "Input type (", input.type().toString(), ") and weight type (", weight.type().toString(),
+             ") should be the same");
+    AT_CHECK(!bias.defined() || (input.type() == bias.type()),
+             "Input type (", input.type().toString(), ") and bias type (", bias.type().toString(),
+             ") should be the same");
+    output = at::_depthwise_convolution(
+        input, weight, bias, params.padding, params.stride, params.dilation);
   } else {
     if (params.groups == 1) {
       output = at::_convolution_nogroup(
@@ -480,6 +546,10 @@ at::Tensor _convolution(
     output = view3d(output);
   }
 
+  if (memory_format == MemoryFormat::ChannelsLast) {
+    output = output.contiguous(memory_format);
+  }
+
   return output;
 }
 
@@ -527,6 +597,8 @@ at::Tensor _convolution_nogroup(
           return at::_nnpack_spatial_convolution(
               input, weight, bias, padding);
 #endif
+        } else if (params.use_cpu_pointwise(input, weight)) {
+          return pointwise_convolution(input, weight, bias);
         } else {
           /* CPU implementation has specialized MM kernels
              for non-dilated case here */
@@ -778,4 +850,14 @@ std::tuple<Tensor,Tensor,Tensor> _convolution_double_backward(
   return std::tuple<Tensor,Tensor,Tensor>{ggO, gI, gW};
 }
 
+// These go through CUDA hooks because the cache lives in the CUDA build. See
+// native/cudnn/BenchmarkCache.h.
+int64_t _cudnn_save_benchmark_cache(std::string path) {
+  return detail::getCUDAHooks().saveCuDNNBenchmarkCache(path);
+}
+
+int64_t _cudnn_load_benchmark_cache(std::string path) {
+  return detail::getCUDAHooks().loadCuDNNBenchmarkCache(path);
+}
+
 }} // at::native
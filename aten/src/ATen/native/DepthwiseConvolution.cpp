@@ -0,0 +1,82 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/cpu/DepthwiseConvKernel.h>
+
+#include <tuple>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(depthwise_conv2d_stub);
+DEFINE_DISPATCH(depthwise_conv2d_backward_input_stub);
+DEFINE_DISPATCH(depthwise_conv2d_backward_weight_stub);
+
+static void check_depthwise_args(const Tensor& self, const Tensor& weight,
+                                 IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation) {
+  AT_CHECK(self.dim() == 4, "_depthwise_convolution: expected 4-D input, but got ",
+           self.dim(), "-D input");
+  AT_CHECK(weight.dim() == 4 && weight.size(1) == 1,
+           "_depthwise_convolution: expected weight of shape [out_channels, 1, kH, kW], but got ",
+           weight.sizes());
+  AT_CHECK(self.size(1) > 0 && weight.size(0) % self.size(1) == 0,
+           "_depthwise_convolution: the number of output channels (", weight.size(0),
+           ") must be a multiple of the number of input channels (", self.size(1), ")");
+  AT_CHECK(padding.size() == 2 && stride.size() == 2 && dilation.size() == 2,
+           "_depthwise_convolution: expected 2 elements of padding, stride and dilation");
+  for (int64_t i = 0; i < 2; i++) {
+    AT_CHECK(padding[i] >= 0 && stride[i] > 0 && dilation[i] > 0,
+             "_depthwise_convolution: expected non-negative padding and positive stride and dilation");
+  }
+}
+
+static std::vector<int64_t> depthwise_output_size(const Tensor& self, const Tensor& weight,
+                                                  IntArrayRef padding, IntArrayRef stride,
+                                                  IntArrayRef dilation) {
+  std::vector<int64_t> output_size = {self.size(0), weight.size(0), 0, 0};
+  for (int64_t i = 0; i < 2; i++) {
+    const int64_t kernel_extent = dilation[i] * (weight.size(i + 2) - 1) + 1;
+    output_size[i + 2] = (self.size(i + 2) + 2 * padding[i] - kernel_extent) / stride[i] + 1;
+    AT_CHECK(output_size[i + 2] > 0,
+             "_depthwise_convolution: calculated output size ", output_size,
+             " is too small for input of size ", self.sizes());
+  }
+  return output_size;
+}
+
+Tensor depthwise_convolution_cpu(
+    const Tensor& self, const Tensor& weight, const Tensor& bias,
+    IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation) {
+  check_depthwise_args(self, weight, padding, stride, dilation);
+  AT_CHECK(!bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0)),
+           "_depthwise_convolution: expected bias of size ", weight.size(0));
+  auto output = at::empty(depthwise_output_size(self, weight, padding, stride, dilation),
+                          self.options());
+  depthwise_conv2d_stub(kCPU, output, self.contiguous(), weight.contiguous(),
+                        bias.defined() ? bias.contiguous() : bias, padding, stride, dilation);
+  return output;
+}
+
+std::tuple<Tensor, Tensor, Tensor> depthwise_convolution_backward_cpu(
+    const Tensor& self, const Tensor& grad_output, const Tensor& weight,
+    IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation,
+    std::array<bool, 3> output_mask) {
+  check_depthwise_args(self, weight, padding, stride, dilation);
+  auto grad_output_contig = grad_output.contiguous();
+
+  Tensor grad_input, grad_weight, grad_bias;
+  if (output_mask[0]) {
+    grad_input = at::empty(self.sizes(), self.options());
+    depthwise_conv2d_backward_input_stub(kCPU, grad_input, grad_output_contig,
+                                         weight.contiguous(), padding, stride, dilation);
+  }
+  if (output_mask[1]) {
+    grad_weight = at::empty(weight.sizes(), weight.options());
+    depthwise_conv2d_backward_weight_stub(kCPU, grad_weight, grad_output_contig,
+                                          self.contiguous(), padding, stride, dilation);
+  }
+  if (output_mask[2]) {
+    grad_bias = grad_output_contig.sum(IntArrayRef{0, 2, 3});
+  }
+  return std::make_tuple(grad_input, grad_weight, grad_bias);
+}
+
+}} // namespace at::native
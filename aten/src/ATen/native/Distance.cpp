@@ -11,10 +11,52 @@ DEFINE_DISPATCH(pdist_backward_stub);
 DEFINE_DISPATCH(cdist_stub);
 DEFINE_DISPATCH(cdist_backward_stub);
 
+// For p = 2, distances between many vectors are computed from the expansion
+// ||x - y||^2 = ||x||^2 + ||y||^2 - 2 <x, y>, which turns the work into a
+// single matrix multiplication. Its rounding error grows with the norms of
+// the inputs rather than with their distance, so small problems and
+// low-dimensional points, where GEMM gains little and close pairs are common,
+// keep the direct computation.
+static constexpr int64_t kEuclideanDistMMMinRows = 25;
+static constexpr int64_t kEuclideanDistMMMinCols = 8;
+
+static inline bool use_mm_for_euclid_dist(int64_t r1, int64_t r2, int64_t c) {
+  return (r1 > kEuclideanDistMMMinRows || r2 > kEuclideanDistMMMinRows) &&
+         c >= kEuclideanDistMMMinCols;
+}
+
+// Returns the [r1, r2] matrix of euclidean distances between the rows of x1
+// and x2. The squared norms are folded into the operands so that a single
+// GEMM of inner size c + 2 yields the squared distances.
+static Tensor euclidean_dist_mm(const Tensor& x1, const Tensor& x2) {
+  auto x1_norm = x1.pow(2).sum(-1, true);
+  auto x1_pad = at::ones_like(x1_norm);
+  auto x2_norm = x2.pow(2).sum(-1, true);
+  auto x2_pad = at::ones_like(x2_norm);
+  auto x1_ = at::cat({x1.mul(-2), x1_norm, x1_pad}, -1);
+  auto x2_ = at::cat({x2, x2_pad, x2_norm}, -1);
+  auto result = x1_.mm(x2_.t());
+  return result.clamp_min_(0).sqrt_();
+}
+
+// Gradient of the euclidean distances `dist` between the rows of x1 and x2
+// with respect to x1: grad_x1[i] = sum_j ratio[i][j] * (x1[i] - x2[j]), where
+// ratio = grad / dist, and a zero distance contributes the zero subgradient.
+static Tensor euclidean_dist_backward_mm(const Tensor& ratio, const Tensor& x1, const Tensor& x2) {
+  return x1 * ratio.sum(-1, true) - ratio.mm(x2);
+}
+
 Tensor pairwise_distance(const Tensor& x1, const Tensor& x2, double p, double eps, bool keepdim) {
   return at::norm(x1 - x2 + eps, p, 1, keepdim);
 }
 
+// Mask of the strict upper triangle of the [n, n] distance matrix of the rows
+// of self, matching the pairs stored by pdist.
+static Tensor pdist_upper_mask(const Tensor& self) {
+  int64_t n = self.size(0);
+  return at::ones({n, n}, self.options().dtype(kByte)).triu_(1);
+}
+
 // This is to guarantee that the contiguous memory is passed to the backward pass
 Tensor pdist(const Tensor& self, const double p) {
   AT_CHECK(self.dim() == 2,
@@ -42,6 +84,9 @@ Tensor cdist(const Tensor& x1, const Tensor& x2, const double p) {
 
   int64_t r1 = x1.size(-2);
   int64_t r2 = x2.size(-2);
+  if (p == 2 && use_mm_for_euclid_dist(r1, r2, c1)) {
+    return euclidean_dist_mm(x1, x2);
+  }
   Tensor result = at::empty({r1, r2}, x1.options());
   if (r1 > 0 && r2 > 0) {
     if (c1 == 0) {
@@ -63,6 +108,11 @@ Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, c
   AT_CHECK(device1 == kCPU || device1 == kCUDA, "_cdist_backward only supports CPU and CUDA devices, X1 got: ", device1);
   auto device2 = x2.type().device_type();
   AT_CHECK(device2 == kCPU || device2 == kCUDA, "_cdist_backward only supports CPU and CUDA devices, X2 got: ", device2);
+  if (p == 2 && use_mm_for_euclid_dist(n, x2.size(-2), m)) {
+    Tensor ratio = grad / cdist;
+    ratio.masked_fill_(cdist == 0, 0);
+    return euclidean_dist_backward_mm(ratio, x1, x2);
+  }
   Tensor grad_x1 = at::empty({n, m}, x1.options());
   cdist_backward_stub(device1, grad_x1, grad, x1, x2, p, cdist);
   return grad_x1;
@@ -78,6 +128,11 @@ Tensor _pdist_forward(const Tensor& self, const double p) {
   } else {
     int64_t n = self.size(0);
     int64_t c = n * (n - 1) / 2;
+    if (p == 2 && use_mm_for_euclid_dist(n, n, self.size(1))) {
+      // keep the strict upper triangle of the full distance matrix, which
+      // is in the row-major order of the condensed result
+      return euclidean_dist_mm(self, self).masked_select(pdist_upper_mask(self));
+    }
     result.resize_({c});
     if (self.size(1) == 0) {
       result.fill_(0);
@@ -93,6 +148,15 @@ Tensor _pdist_backward(const Tensor& grad, const Tensor& self, const double p, c
   AT_CHECK(pdist.is_contiguous(), "_pdist_backward requires pdist to be contiguous");
   auto device = self.type().device_type();
   AT_CHECK(device == kCPU || device == kCUDA, "_pdist_backward only supports CPU and CUDA devices, got: ", device);
+  int64_t n = self.size(0);
+  if (p == 2 && use_mm_for_euclid_dist(n, n, self.size(1))) {
+    Tensor ratio = grad / pdist;
+    ratio.masked_fill_(pdist == 0, 0);
+    // every pair contributes to both of its rows
+    Tensor full_ratio = at::zeros({n, n}, self.options()).masked_scatter_(pdist_upper_mask(self), ratio);
+    full_ratio = full_ratio + full_ratio.t();
+    return euclidean_dist_backward_mm(full_ratio, self, self);
+  }
   Tensor result = at::empty_like(self);
   pdist_backward_stub(device, result, grad, self, p, pdist);
   return result;
@@ -4,6 +4,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/LegacyTHFunctions.h>
 #include <c10/util/Exception.h>
 
 #include <ATen/CPUGenerator.h>
@@ -125,32 +126,40 @@ Tensor& bernoulli_out(Tensor& result, const Tensor& self, Generator* gen) {
   return result.resize_(self.sizes()).bernoulli_(self, gen);
 }
 
+// Seed of the philox streams of one random fill of a CPU tensor. It is drawn
+// from the generator, so that manual_seed makes the fills reproducible.
+static uint64_t philox_cpu_seed(Generator* gen) {
+  THGenerator* generator = get_generator(gen);
+  std::lock_guard<std::mutex> lock(generator->mutex);
+  return THRandom_random64(generator);
+}
+
+// Fills non-contiguous tensors through a contiguous buffer, so that the
+// numbers don't depend on the strides of self either
+template <typename fill_t>
+static Tensor& random_fill_cpu(Tensor& self, const fill_t& fill) {
+  if (self.is_contiguous()) {
+    fill(self);
+    return self;
+  }
+  auto buffer = at::empty(self.sizes(), self.options());
+  fill(buffer);
+  return self.copy_(buffer);
+}
+
 Tensor& bernoulli_tensor_cpu_(Tensor& self, const Tensor& p_, Generator* gen) {
-  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "bernoulli_tensor_cpu_self_", [&] {
-    THGenerator* generator = get_generator(gen);
-    std::lock_guard<std::mutex> lock(generator->mutex);
-    using self_t = scalar_t;
-    if (p_.scalar_type() == kDouble) {
-      auto p = std::get<0>(expand_inplace(self, p_.to(kCPU)));
-      CPU_tensor_apply2<self_t, double>(
-        self, p, [generator](self_t& ret_val, double& p_val) {
-          ret_val = static_cast<self_t>(THRandom_bernoulli(generator, p_val));
-        });
-    } else {
-      AT_DISPATCH_FLOATING_TYPES(p_.scalar_type(), "bernoulli_tensor_cpu_p_", [&] {
-        auto p = std::get<0>(expand_inplace(self, p_.to(kCPU)));
-        using p_t = scalar_t;
-        CPU_tensor_apply2<self_t, p_t>(
-          self, p, [generator](self_t& ret_val, p_t& p_val) {
-            ret_val = static_cast<self_t>(THRandom_bernoulliFloat(generator, static_cast<p_t>(p_val)));
-          });
-      });
-    }
+  auto p = std::get<0>(expand_inplace(self, p_.to(kCPU))).contiguous();
+  const uint64_t seed = philox_cpu_seed(gen);
+  return random_fill_cpu(self, [&](Tensor& t) {
+    bernoulli_tensor_stub(kCPU, t, p, seed);
   });
-  return self;
 }
 
 DEFINE_DISPATCH(bernoulli_mkl_stub);
+DEFINE_DISPATCH(uniform_stub);
+DEFINE_DISPATCH(normal_stub);
+DEFINE_DISPATCH(bernoulli_scalar_stub);
+DEFINE_DISPATCH(bernoulli_tensor_stub);
 
 Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
   AT_CHECK(0 <= p && p <= 1, "bernoulli_ expects p to be in [0, 1], but got p=", p);
@@ -160,17 +169,34 @@ Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
     return self;
   }
 #endif
-  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
-    THGenerator* generator = get_generator(gen);
-    std::lock_guard<std::mutex> lock(generator->mutex);
-    CPU_tensor_apply1<scalar_t>(
-        self, [generator, p](scalar_t& ret_val) {
-          ret_val = static_cast<scalar_t>(THRandom_bernoulli(generator, p));
-        });
+  const uint64_t seed = philox_cpu_seed(gen);
+  return random_fill_cpu(self, [&](Tensor& t) {
+    bernoulli_scalar_stub(kCPU, t, p, seed);
   });
-  return self;
 }
 
+Tensor& uniform_(Tensor& self, double from, double to, Generator* gen) {
+  if (self.type().backend() == Backend::CPU && at::isFloatingType(self.scalar_type()) &&
+      self.scalar_type() != kHalf) {
+    const uint64_t seed = philox_cpu_seed(gen);
+    return random_fill_cpu(self, [&](Tensor& t) {
+      uniform_stub(kCPU, t, from, to, seed);
+    });
+  }
+  return at::legacy::th::_th_uniform_(self, from, to, gen);
+}
+
+Tensor& normal_(Tensor& self, double mean, double std, Generator* gen) {
+  if (self.type().backend() == Backend::CPU && at::isFloatingType(self.scalar_type()) &&
+      self.scalar_type() != kHalf) {
+    AT_CHECK(std > 0, "normal_ expects std > 0.0, but found std=", std);
+    const uint64_t seed = philox_cpu_seed(gen);
+    return random_fill_cpu(self, [&](Tensor& t) {
+      normal_stub(kCPU, t, mean, std, seed);
+    });
+  }
+  return at::legacy::th::_th_normal_(self, mean, std, gen);
+}
 
 Tensor _standard_gamma_grad_cpu(const Tensor& self, const Tensor& output) {
   Tensor ret = at::empty(self.sizes(), self.options());
@@ -2,11 +2,15 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/native/EmbeddingBag.h>
 
 #include <TH/THBlasUtils.h>
 
 #include <caffe2/perfkernels/embedding_lookup.h>
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup.h>
+#include <caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h>
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <memory>
@@ -32,14 +36,6 @@ static void make_offset2bag(const Tensor &offsets, const Tensor &indices, Tensor
 
 namespace {
 
-bool isFastPathIndexSelect(const Tensor& src, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1;
-}
-
-bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
-}
-
 // This function combines index_select (using select_indices as the index) and
 // index_add (using add_indices as the index), without creating an intermediary
 // tensor to hold the selected embeddings
@@ -68,57 +64,6 @@ void index_select_add(const Tensor &select_indices,
   }
 }
 
-template<>
-void index_select_add<float>(const Tensor &select_indices,
-                             const Tensor &add_indices,
-                             const Tensor &src,
-                             Tensor &output,
-                             const Tensor& offsets) {
-  int64_t ddim = src.size(1);
-  auto src_data = src.data<float>();
-  auto select_indices_data = select_indices.data<int64_t>();
-  auto output_data = output.data<float>();
-
-  if (isFastPathIndexSelect(src, output)) {
-    auto accessor = offsets.accessor<int64_t, 1>();
-    std::vector<int> lengths;
-
-    int64_t lower = accessor[0];
-    for (size_t i = 1; i < offsets.numel(); ++i) {
-      lengths.push_back(accessor[i] - lower);
-      lower = accessor[i];
-    }
-    lengths.push_back(select_indices.numel() - lower);
-
-    caffe2::EmbeddingLookup(
-      /*block_size=*/ddim,
-      /*output_size=*/lengths.size(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*lengths=*/lengths.data(),
-      /*weights=*/nullptr,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
-  } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto add_indices_data = add_indices.data<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto numel = add_indices.numel();
-    for (int64_t i = 0; i < numel; i++) {
-      THBlas_axpy<float>(ddim, 1,
-              src_data + src_stride0 * select_indices_data[i], src_stride1,
-              output_data + output_stride0 * add_indices_data[i], output_stride1);
-    }
-  }
-}
-
 // This function fuses the following three fns:
 // index_select (using select_indices as the index)
 // mul (scaling by per_sample_weights)
@@ -155,63 +100,93 @@ static void index_select_scale_add(const Tensor &select_indices,
   }
 }
 
-template<>
-void index_select_scale_add<float>(const Tensor &select_indices,
-                                          const Tensor &add_indices,
-                                          const Tensor &scale,
-                                          const Tensor &src,
-                                          Tensor &output,
-                                          const Tensor& offsets) {
-  int64_t ddim = src.size(1);
-  auto* scale_data = scale.data<float>();
-  auto select_indices_data = select_indices.data<int64_t>();
-  auto src_data = src.data<float>();
-  auto output_data = output.data<float>();
-
-  if (isFastPathIndexSelectScale(src, scale, output)) {
-    auto accessor = offsets.accessor<int64_t, 1>();
-    std::vector<int> lengths;
+// The caffe2 perfkernels read rows of `weight` at multiples of its row size,
+// and per-sample weights as a dense float array.
+bool isFastPathPerfkernels(const Tensor& weight,
+                           const Tensor& per_sample_weights) {
+  return weight.scalar_type() == kFloat && weight.is_contiguous() &&
+      (!per_sample_weights.defined() ||
+       (per_sample_weights.scalar_type() == kFloat &&
+        per_sample_weights.is_contiguous()));
+}
 
-    int64_t lower = accessor[0];
-    for (size_t i = 1; i < offsets.numel(); ++i) {
-      lengths.push_back(accessor[i] - lower);
-      lower = accessor[i];
-    }
-    lengths.push_back(select_indices.numel() - lower);
-
-    caffe2::EmbeddingLookup(
-      /*block_size=*/ddim,
-      /*output_size=*/lengths.size(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*lengths=*/lengths.data(),
-      /*weights=*/scale_data,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
-  } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto add_indices_data = add_indices.data<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto scale_stride = scale.stride(0);
-    auto numel = add_indices.numel();
-
-
-    for (int64_t i = 0; i < numel; i++) {
-      auto* src_base = src_data + src_stride0 * select_indices_data[i];
-      auto* output_base = output_data + output_stride0 * add_indices_data[i];
-      auto scale = scale_data[i * scale_stride];
-      for (int64_t j = 0; j < ddim; j++) {
-        output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
-      }
-    }
+// Calls `lookup(output_size, index_size, indices, lengths, weights, out)` on
+// chunks of consecutive bags in parallel, to sum the `ddim` wide rows of each
+// bag into `output_data` with a caffe2 perfkernel.
+template <typename Lookup>
+void parallel_embedding_lookup(const Tensor& indices,
+                               const Tensor& offsets,
+                               const Tensor& per_sample_weights,
+                               int64_t ddim,
+                               float* output_data,
+                               const Lookup& lookup) {
+  const int64_t num_bags = offsets.numel();
+  const int64_t numel = indices.numel();
+  auto offsets_data = offsets.data<int64_t>();
+  AT_CHECK(num_bags == 0 || offsets_data[0] == 0,
+      "embedding_bag: offsets[0] has to be 0, but got ", offsets_data[0]);
+
+  std::vector<int> lengths(num_bags);
+  for (int64_t i = 0; i < num_bags; ++i) {
+    const int64_t next_offset = i + 1 < num_bags ? offsets_data[i + 1] : numel;
+    AT_CHECK(offsets_data[i] <= next_offset && next_offset <= numel,
+        "embedding_bag: offsets have to be non-decreasing and at most the "
+        "number of indices (", numel, "), but got offsets[", i, "] = ",
+        offsets_data[i], " followed by ", next_offset);
+    lengths[i] = next_offset - offsets_data[i];
   }
+
+  auto indices_data = indices.data<int64_t>();
+  const float* weights_data = per_sample_weights.defined()
+      ? per_sample_weights.data<float>()
+      : nullptr;
+  // Bags vary in length, so size the chunks by the average bag.
+  const int64_t average_bag_numel =
+      std::max<int64_t>(1, ddim * numel / std::max<int64_t>(1, num_bags));
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / average_bag_numel);
+  at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+    const int64_t first = offsets_data[begin];
+    const int64_t last = end < num_bags ? offsets_data[end] : numel;
+    lookup(
+        end - begin,
+        last - first,
+        indices_data + first,
+        lengths.data() + begin,
+        weights_data ? weights_data + first : nullptr,
+        output_data + begin * ddim);
+  });
+}
+
+// Computes the sum or mean (depending on `mode`) of each bag of rows of a
+// float or half `weight` into the contiguous float tensor `output`.
+template <typename T>
+void embedding_bag_cpu_perfkernels(const Tensor& weight,
+                                   const Tensor& indices,
+                                   const Tensor& offsets,
+                                   const Tensor& per_sample_weights,
+                                   const int64_t mode,
+                                   Tensor& output) {
+  const int64_t ddim = weight.size(1);
+  const int64_t data_size = weight.size(0);
+  auto weight_data = weight.data<T>();
+  parallel_embedding_lookup(
+      indices, offsets, per_sample_weights, ddim, output.data<float>(),
+      [&](int64_t output_size, int64_t index_size, const int64_t* indices_data,
+          const int* lengths, const float* weights, float* out) {
+        caffe2::EmbeddingLookup(
+            /*block_size=*/ddim,
+            /*output_size=*/output_size,
+            /*index_size=*/index_size,
+            /*data_size=*/data_size,
+            /*input=*/weight_data,
+            /*indices=*/indices_data,
+            /*lengths=*/lengths,
+            /*weights=*/weights,
+            /*scale_bias=*/nullptr,
+            /*normalize_by_lengths=*/mode == MODE_MEAN,
+            /*out=*/out);
+      });
 }
 
 }  // namespace
@@ -336,7 +311,7 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
   auto offsets_arg = TensorArg(offsets, "offsets", 1);
   checkScalarType("embedding_bag", offsets_arg, kLong);
   auto weight_arg = TensorArg(weight, "weight", 1);
-  checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble});
+  checkScalarTypes("embedding_bag", weight_arg, {kFloat, kDouble, kHalf});
 
   if (per_sample_weights.defined()) {
     AT_CHECK(mode == MODE_SUM,
@@ -351,34 +326,50 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
   auto bag_size = at::zeros(offsets.sizes(), indices.options());
   make_bag_size(offsets, indices, mode, bag_size);
 
-  auto output = at::zeros({offsets.size(0), weight.size(1)}, weight.options());
-
-  // To save compute, if we are going to go down the fast path case for the 'sum'
-  // mode, we skip calculating offset2bag, since it is not going to be used.
-  auto fast_path_sum = [&weight, &per_sample_weights, &output]() {
-    if (per_sample_weights.defined()) {
-      return isFastPathIndexSelectScale(weight, per_sample_weights, output);
+  // The caffe2 perfkernels compute the 'sum' and 'mean' modes directly from
+  // the rows of the weight, accumulating in float. They are the only
+  // implementation of these modes for half weights, which are made contiguous
+  // for them. To save compute, we skip calculating offset2bag on this path,
+  // since it is not going to be used. The backward computes it if needed.
+  const bool is_half = weight.scalar_type() == kHalf;
+  if (mode != MODE_MAX &&
+      (is_half || isFastPathPerfkernels(weight, per_sample_weights))) {
+    Tensor output;
+    if (is_half) {
+      output = at::empty({offsets.size(0), weight.size(1)},
+                         weight.options().dtype(kFloat));
+      embedding_bag_cpu_perfkernels<at::Half>(
+          weight.contiguous(), indices, offsets,
+          per_sample_weights.defined()
+              ? per_sample_weights.to(kFloat).contiguous()
+              : per_sample_weights,
+          mode, output);
+      output = output.to(kHalf);
     } else {
-      return isFastPathIndexSelect(weight, output);
+      output = at::empty({offsets.size(0), weight.size(1)}, weight.options());
+      embedding_bag_cpu_perfkernels<float>(
+          weight, indices, offsets, per_sample_weights, mode, output);
     }
-  };
+    // Use an empty 0-element tensor as a sentinel that we have skipped the
+    // creation of offset2bag because autograd chokes when trying to use an
+    // undefined tensor as an input to a backward op.
+    auto offset2bag = at::empty({0}, offsets.options());
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(
+        output, offset2bag, bag_size, bag_size);
+  }
 
-  // Use an empty 0-element tensor as a sentinel that we have skipped the
-  // creation of offset2bag because autograd chokes when trying to use an
-  // undefined tensor as an input to a backward op.
-  Tensor offset2bag = at::empty({0}, offsets.options());
-  if (mode == MODE_MEAN || mode == MODE_MAX || !fast_path_sum()) {
-    // If the last entries are empty, that the last offsets are irrelevant as they
-    // won't change anything in the assignment of ID -> bag, but index_add would
-    // throw out of bounds error. So to keep it simple we just add one more
-    // entry to the end then get rid of it after make_offset2bag.
-    offset2bag = at::zeros(
-       {indices.sizes()[0] + 1}, indices.options()); // offset2bag = [0 0 0 0 0]
+  auto output = at::zeros({offsets.size(0), weight.size(1)}, weight.options());
 
-    make_offset2bag(offsets, indices, offset2bag);
+  // If the last entries are empty, that the last offsets are irrelevant as they
+  // won't change anything in the assignment of ID -> bag, but index_add would
+  // throw out of bounds error. So to keep it simple we just add one more
+  // entry to the end then get rid of it after make_offset2bag.
+  auto offset2bag = at::zeros(
+     {indices.sizes()[0] + 1}, indices.options()); // offset2bag = [0 0 0 0 0]
 
-    offset2bag.resize_({indices.sizes()[0]});
-  }
+  make_offset2bag(offsets, indices, offset2bag);
+
+  offset2bag.resize_({indices.sizes()[0]});
 
   if (mode == MODE_MEAN || mode == MODE_SUM) {
     AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_cpu", [&]() {
@@ -722,5 +713,102 @@ Tensor _embedding_bag_sparse_backward(
   return native::embedding_backward(index_grad, indices, num_weights, -1,
                                     scale_grad_by_freq, true);
 }
+
+Tensor fused_rowwise_embedding_bag_cpu(const char* name,
+                                       const int64_t bit_rate,
+                                       const Tensor &weight,
+                                       const Tensor &indices,
+                                       const Tensor &offsets,
+                                       const int64_t mode,
+                                       const Tensor &per_sample_weights) {
+  AT_ASSERT(bit_rate == 8 || bit_rate == 4 || bit_rate == 2);
+  // The quantized values of each row are followed by a float scale and bias
+  // for 8 bits, and by an fp16 scale and bias for fewer bits.
+  const int64_t scale_bias_bytes = bit_rate == 8 ? 8 : 4;
+  auto weight_arg = TensorArg(weight, "weight", 1);
+  checkScalarType(name, weight_arg, kByte);
+  checkDim(name, weight_arg, 2);
+  AT_CHECK(weight.size(1) > scale_bias_bytes,
+      name, ": weight must have more than ", scale_bias_bytes, " columns, "
+      "for the quantized values and the scale and bias of each row, but got ",
+      weight.size(1), " columns");
+  auto indices_arg = TensorArg(indices, "indices", 2);
+  checkScalarType(name, indices_arg, kLong);
+  checkDim(name, indices_arg, 1);
+  auto offsets_arg = TensorArg(offsets, "offsets", 3);
+  checkScalarType(name, offsets_arg, kLong);
+  checkDim(name, offsets_arg, 1);
+  AT_CHECK(mode == MODE_SUM || mode == MODE_MEAN,
+      name, ": only mode='sum' and mode='mean' are supported");
+
+  Tensor per_sample_weights_;
+  if (per_sample_weights.defined()) {
+    AT_CHECK(mode == MODE_SUM,
+        name, ": per_sample_weights only supported with mode='sum'");
+    auto per_sample_weights_arg =
+        TensorArg(per_sample_weights, "per_sample_weights", 5);
+    checkScalarType(name, per_sample_weights_arg, kFloat);
+    checkDim(name, per_sample_weights_arg, 1);
+    AT_CHECK(per_sample_weights.numel() == indices.numel(),
+        name, ": expected per_sample_weights to have one weight per index, "
+        "but got ", per_sample_weights.numel(), " weights for ",
+        indices.numel(), " indices");
+    per_sample_weights_ = per_sample_weights.contiguous();
+  }
+
+  auto weight_ = weight.contiguous();
+  auto indices_ = indices.contiguous();
+  auto offsets_ = offsets.contiguous();
+  const int64_t ddim =
+      (weight.size(1) - scale_bias_bytes) * (8 / bit_rate);
+  const int64_t data_size = weight.size(0);
+  auto weight_data = weight_.data<uint8_t>();
+  auto output = at::empty({offsets.size(0), ddim}, weight.options().dtype(kFloat));
+  parallel_embedding_lookup(
+      indices_, offsets_, per_sample_weights_, ddim, output.data<float>(),
+      [&](int64_t output_size, int64_t index_size, const int64_t* indices_data,
+          const int* lengths, const float* weights, float* out) {
+        if (bit_rate == 8) {
+          caffe2::Fused8BitRowwiseEmbeddingLookup(
+              /*block_size=*/ddim,
+              /*output_size=*/output_size,
+              /*index_size=*/index_size,
+              /*data_size=*/data_size,
+              /*input=*/weight_data,
+              /*indices=*/indices_data,
+              /*lengths=*/lengths,
+              /*weights=*/weights,
+              /*normalize_by_lengths=*/mode == MODE_MEAN,
+              /*out=*/out);
+        } else {
+          caffe2::FusedNBitRowwiseEmbeddingLookup(
+              /*bit_rate=*/bit_rate,
+              /*block_size=*/ddim,
+              /*output_size=*/output_size,
+              /*index_size=*/index_size,
+              /*data_size=*/data_size,
+              /*input=*/weight_data,
+              /*indices=*/indices_data,
+              /*lengths=*/lengths,
+              /*weights=*/weights,
+              /*normalize_by_lengths=*/mode == MODE_MEAN,
+              /*out=*/out);
+        }
+      });
+  return output;
+}
+
+// Each row of `weight` holds the 8-bit quantized values of an embedding,
+// followed by the float scale and bias to dequantize them with, as produced
+// by caffe2's FloatToFused8BitRowwiseQuantized operator.
+Tensor fused_8bit_rowwise_embedding_bag_cpu(const Tensor &weight,
+                                            const Tensor &indices,
+                                            const Tensor &offsets,
+                                            const int64_t mode,
+                                            const Tensor &per_sample_weights) {
+  return fused_rowwise_embedding_bag_cpu(
+      "fused_8bit_rowwise_embedding_bag", 8, weight, indices, offsets, mode,
+      per_sample_weights);
+}
 }
 } // namespace at::native
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Computes the sum (mode 0) or mean (mode 1) of every bag of rows of the
+// row-wise quantized uint8 `weight`, as a float tensor with one row per bag.
+// With a `bit_rate` of 8, each row of `weight` holds one byte per value
+// followed by a float scale and bias (caffe2's fused 8-bit rowwise format).
+// With a `bit_rate` of 4 or 2, the values are packed 8 / bit_rate to a byte
+// starting from the least significant bits, followed by an fp16 scale and
+// bias. `name` is the operator named in error messages.
+Tensor fused_rowwise_embedding_bag_cpu(const char* name,
+                                       const int64_t bit_rate,
+                                       const Tensor &weight,
+                                       const Tensor &indices,
+                                       const Tensor &offsets,
+                                       const int64_t mode,
+                                       const Tensor &per_sample_weights);
+
+}} // namespace at::native
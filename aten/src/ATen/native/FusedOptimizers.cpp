@@ -0,0 +1,251 @@
+#include <ATen/ATen.h>
+#include <ATen/DeviceGuard.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/FusedOptimizers.h>
+
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(fused_sgd_stub);
+DEFINE_DISPATCH(fused_adam_stub);
+DEFINE_DISPATCH(fused_adagrad_stub);
+DEFINE_DISPATCH(fused_rmsprop_stub);
+DEFINE_DISPATCH(unscale_grads_stub);
+
+namespace {
+
+// Checks that `list` holds a tensor like each of `params`, or is empty if it
+// is optional.
+void check_fused_list(
+    const char* name,
+    TensorList params,
+    TensorList list,
+    const char* list_name,
+    bool optional = false) {
+  if (optional && list.empty()) {
+    return;
+  }
+  AT_CHECK(
+      list.size() == params.size(),
+      name, ": expected ", params.size(), " tensors in ", list_name,
+      ", but got ", list.size());
+  for (size_t i = 0; i < params.size(); ++i) {
+    const auto& param = params[i];
+    const auto& tensor = list[i];
+    AT_CHECK(
+        tensor.defined() && tensor.device() == param.device() &&
+            tensor.scalar_type() == param.scalar_type() &&
+            tensor.sizes() == param.sizes(),
+        name, ": expected ", list_name, "[", i, "] to be a tensor like params[",
+        i, "], of type ", param.type(), " and size ", param.sizes());
+    AT_CHECK(
+        tensor.is_contiguous(),
+        name, ": expected ", list_name, "[", i, "] to be contiguous");
+  }
+}
+
+// Returns false if there is nothing to update.
+bool check_fused_params(const char* name, TensorList params) {
+  if (params.empty()) {
+    return false;
+  }
+  const auto& first = params.front();
+  AT_CHECK(
+      first.device().is_cpu() || first.device().is_cuda(),
+      name, ": expected CPU or CUDA tensors, but got ", first.device());
+  AT_CHECK(
+      first.is_floating_point(),
+      name, ": expected floating point tensors, but got ", first.scalar_type());
+  for (size_t i = 0; i < params.size(); ++i) {
+    AT_CHECK(
+        params[i].device() == first.device() &&
+            params[i].scalar_type() == first.scalar_type(),
+        name, ": expected all the params to be of type ", first.type(),
+        ", but params[", i, "] is of type ", params[i].type());
+    AT_CHECK(
+        params[i].is_contiguous(),
+        name, ": expected params[", i, "] to be contiguous");
+  }
+  return true;
+}
+
+} // namespace
+
+// The _fused_*_step functions apply one step of an optimizer of the C++
+// frontend to a list of parameters at once, instead of a few operators per
+// parameter. All the tensors of a call are updated by a handful of kernels
+// that each process chunks of many tensors (see cpu/MultiTensorApply.h and
+// cuda/MultiTensorApply.cuh), which saves most of the kernel launches of the
+// unfused step when there are many small parameters.
+//
+// Weight decay is applied to the gradient in the kernels; unlike the unfused
+// steps, the grads are left untouched.
+
+void _fused_sgd_step(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double weight_decay,
+    double momentum,
+    double dampening,
+    bool nesterov) {
+  const char* name = "_fused_sgd_step";
+  if (!check_fused_params(name, params)) {
+    return;
+  }
+  check_fused_list(name, params, grads, "grads");
+  check_fused_list(
+      name, params, momentum_buffers, "momentum_buffers", momentum == 0);
+  AT_CHECK(
+      momentum != 0 || !nesterov,
+      name, ": nesterov momentum requires a momentum");
+  fused_sgd_stub(
+      params.front().device().type(),
+      params,
+      grads,
+      momentum_buffers,
+      lr,
+      weight_decay,
+      momentum,
+      dampening,
+      nesterov);
+}
+
+void _fused_adam_step(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double step_size,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps) {
+  const char* name = "_fused_adam_step";
+  if (!check_fused_params(name, params)) {
+    return;
+  }
+  check_fused_list(name, params, grads, "grads");
+  check_fused_list(name, params, exp_avgs, "exp_avgs");
+  check_fused_list(name, params, exp_avg_sqs, "exp_avg_sqs");
+  check_fused_list(
+      name, params, max_exp_avg_sqs, "max_exp_avg_sqs", /*optional=*/true);
+  fused_adam_stub(
+      params.front().device().type(),
+      params,
+      grads,
+      exp_avgs,
+      exp_avg_sqs,
+      max_exp_avg_sqs,
+      step_size,
+      beta1,
+      beta2,
+      weight_decay,
+      eps);
+}
+
+void _fused_adagrad_step(
+    TensorList params,
+    TensorList grads,
+    TensorList state_sums,
+    double lr,
+    double weight_decay,
+    double eps) {
+  const char* name = "_fused_adagrad_step";
+  if (!check_fused_params(name, params)) {
+    return;
+  }
+  check_fused_list(name, params, grads, "grads");
+  check_fused_list(name, params, state_sums, "state_sums");
+  fused_adagrad_stub(
+      params.front().device().type(),
+      params,
+      grads,
+      state_sums,
+      lr,
+      weight_decay,
+      eps);
+}
+
+void _fused_rmsprop_step(
+    TensorList params,
+    TensorList grads,
+    TensorList square_avgs,
+    TensorList grad_avgs,
+    TensorList momentum_buffers,
+    double lr,
+    double alpha,
+    double eps,
+    double weight_decay,
+    double momentum) {
+  const char* name = "_fused_rmsprop_step";
+  if (!check_fused_params(name, params)) {
+    return;
+  }
+  check_fused_list(name, params, grads, "grads");
+  check_fused_list(name, params, square_avgs, "square_avgs");
+  check_fused_list(name, params, grad_avgs, "grad_avgs", /*optional=*/true);
+  check_fused_list(
+      name, params, momentum_buffers, "momentum_buffers", momentum <= 0);
+  fused_rmsprop_stub(
+      params.front().device().type(),
+      params,
+      grads,
+      square_avgs,
+      grad_avgs,
+      momentum_buffers,
+      lr,
+      alpha,
+      eps,
+      weight_decay,
+      momentum);
+}
+
+// Multiplies the gradients of a mixed precision step by inv_scale (the inverse
+// of the loss scale), and returns whether they are all finite. The dense and
+// contiguous grads are processed by one kernel per device and dtype, with the
+// check fused into the multiplication; the others fall back to regular ops.
+// Undefined grads are skipped.
+bool _unscale_grads_and_check_finite(TensorList grads, double inv_scale) {
+  bool finite = true;
+  std::map<std::tuple<DeviceType, int16_t, ScalarType>, std::vector<Tensor>>
+      groups;
+  for (Tensor grad : grads) {
+    if (!grad.defined()) {
+      continue;
+    }
+    AT_CHECK(
+        !grad.is_sparse(),
+        "_unscale_grads_and_check_finite: sparse grads are not supported");
+    AT_CHECK(
+        grad.is_floating_point(),
+        "_unscale_grads_and_check_finite: expected floating point grads, but "
+        "got ", grad.scalar_type());
+    const auto device = grad.device();
+    const bool kernel_supported = device.is_cuda() ||
+        (device.is_cpu() && grad.scalar_type() != kHalf);
+    if (kernel_supported && grad.is_contiguous()) {
+      groups[std::make_tuple(device.type(), device.index(), grad.scalar_type())]
+          .push_back(grad);
+    } else {
+      grad.mul_(inv_scale);
+      // x - x is NaN for an inf or a NaN x, and 0 otherwise.
+      finite = finite && !at::isnan(grad - grad).any().is_nonzero();
+    }
+  }
+  for (const auto& group : groups) {
+    const auto& tensors = group.second;
+    OptionalDeviceGuard device_guard(device_of(tensors.front()));
+    finite = unscale_grads_stub(
+                 tensors.front().device().type(), tensors, inv_scale) &&
+        finite;
+  }
+  return finite;
+}
+
+}} // namespace at::native
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The kernels of the _fused_*_step functions. They update every tensor of the
+// lists in place; the lists have been checked to hold contiguous tensors of
+// the same device, dtype and sizes as `params`, or to be empty when the
+// options don't use them.
+using fused_sgd_fn = void(*)(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double weight_decay,
+    double momentum,
+    double dampening,
+    bool nesterov);
+using fused_adam_fn = void(*)(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double step_size,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps);
+using fused_adagrad_fn = void(*)(
+    TensorList params,
+    TensorList grads,
+    TensorList state_sums,
+    double lr,
+    double weight_decay,
+    double eps);
+using fused_rmsprop_fn = void(*)(
+    TensorList params,
+    TensorList grads,
+    TensorList square_avgs,
+    TensorList grad_avgs,
+    TensorList momentum_buffers,
+    double lr,
+    double alpha,
+    double eps,
+    double weight_decay,
+    double momentum);
+
+// The kernel of _unscale_grads_and_check_finite, for a list of contiguous
+// tensors of the same device and dtype. Returns false if any of them holds an
+// inf or a NaN after the multiplication.
+using unscale_grads_fn = bool(*)(TensorList grads, double inv_scale);
+
+DECLARE_DISPATCH(fused_sgd_fn, fused_sgd_stub);
+DECLARE_DISPATCH(fused_adam_fn, fused_adam_stub);
+DECLARE_DISPATCH(fused_adagrad_fn, fused_adagrad_stub);
+DECLARE_DISPATCH(fused_rmsprop_fn, fused_rmsprop_stub);
+DECLARE_DISPATCH(unscale_grads_fn, unscale_grads_stub);
+
+}} // namespace at::native
@@ -55,6 +55,7 @@
 #include <ATen/LegacyTHFunctions.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/native/TensorIterator.h>
+#include <TH/THTensor.hpp>
 
 #include <algorithm>
 #include <functional>
@@ -65,6 +66,11 @@ namespace at { namespace native {
 
 DEFINE_DISPATCH(index_stub);
 DEFINE_DISPATCH(index_put_stub);
+DEFINE_DISPATCH(gather_stub);
+DEFINE_DISPATCH(scatter_stub);
+DEFINE_DISPATCH(scatter_fill_stub);
+DEFINE_DISPATCH(scatter_add_stub);
+DEFINE_DISPATCH(index_add_stub);
 
 [[noreturn]]
 static void invalid_mask(const Tensor & self, int64_t idx, const Tensor & mask, int64_t maskIdx) {
@@ -431,6 +437,79 @@ static std::unique_ptr<TensorIterator> make_index_put_iterator(const AdvancedInd
   return builder.build();
 }
 
+// Views t as [prod(sizes[:begin]), prod(sizes[begin:end]), prod(sizes[end:])],
+// returning an undefined tensor if that needs a copy
+static Tensor view_as_3d(const Tensor & t, int64_t begin, int64_t end) {
+  auto sizes = t.sizes();
+  auto prod = [&](int64_t from, int64_t to) {
+    return std::accumulate(sizes.begin() + from, sizes.begin() + to, (int64_t)1,
+                           std::multiplies<int64_t>());
+  };
+  std::vector<int64_t> shape = {prod(0, begin), prod(begin, end), prod(end, t.dim())};
+  if (auto stride = THTensor_compute_stride(sizes, t.strides(), shape)) {
+    return t.as_strided(shape, *stride);
+  }
+  return Tensor();
+}
+
+// index_put_ with accumulate=True of CPU tensors, as an index_add_ over the
+// linearized indexed dims. Returns false if self can't be viewed that way.
+static bool index_put_accumulate_cpu(Tensor & self, TensorList orig, const Tensor & value) {
+  if (!(isIntegralType(self.scalar_type()) || isFloatingType(self.scalar_type())) ||
+      self.scalar_type() == kHalf || self.scalar_type() == kBool) {
+    return false;
+  }
+  checkIndexTensorTypes(orig);
+  auto indices = expandTensors(self, orig);
+  indices = expand_outplace(indices);
+  while (indices.size() < (size_t)self.dim()) {
+    indices.emplace_back();
+  }
+  Tensor src = self;
+  if (!hasContiguousSubspace(indices)) {
+    std::tie(src, indices) = transposeToFront(self, indices);
+  }
+  int64_t first = -1, last = -1;
+  for (int64_t i = 0; i < src.dim(); i++) {
+    if (indices[i].defined()) {
+      if (first < 0) {
+        first = i;
+      }
+      last = i + 1;
+    }
+  }
+  if (first < 0) {
+    return false;
+  }
+  auto src3d = view_as_3d(src, first, last);
+  if (!src3d.defined()) {
+    return false;
+  }
+
+  // Linear index into the indexed dims, as if they were contiguous
+  Tensor linear_index;
+  int64_t stride = 1;
+  for (int64_t i = last - 1; i >= first; i--) {
+    auto index = wrapIndexOnce(indices[i], i, src.size(i)) * stride;
+    linear_index = linear_index.defined() ? linear_index + index : index;
+    stride *= src.size(i);
+  }
+
+  auto result_sizes = src.sizes().slice(0, first).vec();
+  auto index_sizes = linear_index.sizes();
+  result_sizes.insert(result_sizes.end(), index_sizes.begin(), index_sizes.end());
+  auto after_sizes = src.sizes().slice(last);
+  result_sizes.insert(result_sizes.end(), after_sizes.begin(), after_sizes.end());
+  if (!is_expandable_to(value.sizes(), result_sizes)) {
+    AT_ERROR("shape mismatch: value tensor of shape ", value.sizes(),
+             " cannot be broadcast to indexing result of shape ", result_sizes);
+  }
+  auto value3d = value.to(src.scalar_type()).expand(result_sizes).reshape(
+      {src3d.size(0), linear_index.numel(), src3d.size(2)});
+  index_add_stub(kCPU, src3d, linear_index.reshape(-1).contiguous(), value3d);
+  return true;
+}
+
 Tensor index(const Tensor & self, TensorList indices) {
   if (indices.size() > (size_t)self.dim()) {
     AT_INDEX_ERROR("too many indices for tensor of dimension ", self.dim(), " (got ", indices.size(), ")");
@@ -456,12 +535,43 @@ Tensor & index_put_(Tensor & self, TensorList indices, const Tensor & value, boo
     std::tie(expandedValue) = expand_inplace(linearIndex, value);
     return src.put_(linearIndex, expandedValue, true);
   }
+  if (accumulate && self.type().device_type() == kCPU &&
+      index_put_accumulate_cpu(self, indices, value)) {
+    return self;
+  }
   auto info = make_info(self, indices);
   auto iter = make_index_put_iterator(info, value);
   index_put_stub(iter->device_type(), *iter, info.indexed_sizes, info.indexed_strides, accumulate);
   return self;
 }
 
+Tensor & index_add_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  const auto device_type = self.type().device_type();
+  if ((device_type == kCPU || device_type == kCUDA) && index.scalar_type() == kLong &&
+      source.scalar_type() == self.scalar_type() && index.dim() <= 1 &&
+      self.dim() > 0 && source.dim() == self.dim()) {
+    AT_CHECK(index.numel() == source.size(dim),
+             "index_add_(): Number of indices should be equal to source.size(dim)");
+    bool same_slice_shape = true;
+    for (int64_t d = 0; d < self.dim(); d++) {
+      same_slice_shape &= (d == dim || self.size(d) == source.size(d));
+    }
+    if (same_slice_shape) {
+      if (self.numel() == 0 || index.numel() == 0) {
+        return self;
+      }
+      auto self3d = view_as_3d(self, dim, dim + 1);
+      if (self3d.defined()) {
+        auto source3d = source.reshape({self3d.size(0), index.numel(), self3d.size(2)});
+        index_add_stub(device_type, self3d, index.reshape(-1).contiguous(), source3d);
+        return self;
+      }
+    }
+  }
+  return at::legacy::th::_th_index_add_(self, dim, index, source);
+}
+
 Tensor & index_copy_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
   dim = maybe_wrap_dim(dim, self.dim());
 
@@ -531,6 +641,113 @@ Tensor scatter_add(const Tensor & self, int64_t dim, const Tensor & index, const
   return self.clone().scatter_add_(dim, index, source);
 }
 
+// gather and scatter treat zero-dim tensors as one-dim tensors of size 1
+static Tensor ensure_nonempty_dim(const Tensor & t) {
+  return t.dim() == 0 ? t.view({1}) : t;
+}
+
+static void gather_shape_check(const Tensor & self, int64_t dim, const Tensor & index) {
+  AT_CHECK(index.device() == self.device(),
+           "Expected index on device ", self.device(), " but got ", index.device());
+  AT_CHECK(index.dim() == self.dim(),
+           "Index tensor must have same dimensions as input tensor");
+  for (int64_t d = 0; d < self.dim(); d++) {
+    if (d != dim) {
+      AT_CHECK(index.size(d) == self.size(d),
+               "Expected index ", index.sizes(), " and input ", self.sizes(),
+               " to have the same size apart from dimension ", dim);
+    }
+  }
+}
+
+static void scatter_shape_check(const Tensor & self, int64_t dim, const Tensor & index,
+                                const Tensor & src) {
+  AT_CHECK(index.device() == self.device() && (!src.defined() || src.device() == self.device()),
+           "Expected index and src on device ", self.device());
+  AT_CHECK(index.dim() == self.dim(),
+           "Index tensor must be either empty or have same dimensions as output tensor");
+  if (src.defined()) {
+    AT_CHECK(src.dim() == self.dim(),
+             "Input tensor must have same dimensions as output tensor");
+  }
+  for (int64_t d = 0; d < self.dim(); d++) {
+    AT_CHECK((d == dim || index.size(d) <= self.size(d)) &&
+             (!src.defined() || index.size(d) <= src.size(d)),
+             "Expected index ", index.sizes(), " to be smaller size than src ",
+             src.defined() ? src.sizes() : self.sizes(), " and to be smaller than self ",
+             self.sizes(), " apart from dimension ", dim);
+  }
+}
+
+Tensor & gather_out(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  AT_CHECK(index.scalar_type() == kLong, "gather(): Expected dtype int64 for index");
+  AT_CHECK(result.scalar_type() == self.scalar_type(),
+           "gather(): Expected result of scalar type ", self.scalar_type(),
+           " but got ", result.scalar_type());
+  result.resize_(index.sizes());
+  auto result_ = ensure_nonempty_dim(result);
+  auto self_ = ensure_nonempty_dim(self);
+  auto index_ = ensure_nonempty_dim(index);
+  gather_shape_check(self_, dim, index_);
+  if (index.numel() > 0) {
+    gather_stub(self.device().type(), result_, self_, dim, index_);
+  }
+  return result;
+}
+
+Tensor gather(const Tensor & self, int64_t dim, const Tensor & index, bool sparse_grad) {
+  Tensor result = at::empty({0}, self.options());
+  return at::gather_out(result, self, dim, index, sparse_grad);
+}
+
+Tensor & scatter_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  AT_CHECK(index.scalar_type() == kLong, "scatter_(): Expected dtype int64 for index");
+  AT_CHECK(src.scalar_type() == self.scalar_type(),
+           "scatter_(): Expected src of scalar type ", self.scalar_type(),
+           " but got ", src.scalar_type());
+  if (index.numel() == 0) {
+    return self;
+  }
+  auto self_ = ensure_nonempty_dim(self);
+  auto index_ = ensure_nonempty_dim(index);
+  auto src_ = ensure_nonempty_dim(src);
+  scatter_shape_check(self_, dim, index_, src_);
+  scatter_stub(self.device().type(), self_, dim, index_, src_);
+  return self;
+}
+
+Tensor & scatter_(Tensor & self, int64_t dim, const Tensor & index, Scalar src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  AT_CHECK(index.scalar_type() == kLong, "scatter_(): Expected dtype int64 for index");
+  if (index.numel() == 0) {
+    return self;
+  }
+  auto self_ = ensure_nonempty_dim(self);
+  auto index_ = ensure_nonempty_dim(index);
+  scatter_shape_check(self_, dim, index_, Tensor());
+  scatter_fill_stub(self.device().type(), self_, dim, index_, src);
+  return self;
+}
+
+Tensor & scatter_add_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  AT_CHECK(index.scalar_type() == kLong, "scatter_add_(): Expected dtype int64 for index");
+  AT_CHECK(src.scalar_type() == self.scalar_type(),
+           "scatter_add_(): Expected src of scalar type ", self.scalar_type(),
+           " but got ", src.scalar_type());
+  if (index.numel() == 0) {
+    return self;
+  }
+  auto self_ = ensure_nonempty_dim(self);
+  auto index_ = ensure_nonempty_dim(index);
+  auto src_ = ensure_nonempty_dim(src);
+  scatter_shape_check(self_, dim, index_, src_);
+  scatter_add_stub(self.device().type(), self_, dim, index_, src_);
+  return self;
+}
+
 Tensor masked_scatter(const Tensor & self, const Tensor & mask, const Tensor & source) {
   Tensor _mask, _self;
   std::tie(_mask, _self) = expand_outplace(mask, self);
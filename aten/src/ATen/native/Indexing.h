@@ -17,4 +17,22 @@ using index_put_fn = void(*)(TensorIterator &, IntArrayRef indexed_sizes, IntArr
 DECLARE_DISPATCH(index_fn, index_stub);
 DECLARE_DISPATCH(index_put_fn, index_put_stub);
 
+// gather and scatter along dim; shapes and index types are checked before the
+// kernels are called, index values by the kernels
+using gather_fn = void(*)(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index);
+using scatter_fn = void(*)(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src);
+using scatter_fill_fn = void(*)(Tensor & self, int64_t dim, const Tensor & index, Scalar src);
+
+DECLARE_DISPATCH(gather_fn, gather_stub);
+DECLARE_DISPATCH(scatter_fn, scatter_stub);
+DECLARE_DISPATCH(scatter_fill_fn, scatter_fill_stub);
+DECLARE_DISPATCH(scatter_fn, scatter_add_stub);
+
+// self[b][index[n]][a] += source[b][n][a] for three-dim views of self and
+// source and a one-dim contiguous index; used for index_add_ and for
+// index_put_ with accumulate=True
+using index_add_fn = void(*)(Tensor & self, const Tensor & index, const Tensor & source);
+
+DECLARE_DISPATCH(index_add_fn, index_add_stub);
+
 }} // namespace at::native
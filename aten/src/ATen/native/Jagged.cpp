@@ -0,0 +1,292 @@
+// A jagged batch is a batch of sequences of different lengths stored without
+// padding, as a pair of tensors:
+//
+//  - `values`, of size [total_length, *], holds the sequences one after the
+//    other along its first dimension;
+//  - `offsets`, a 1D CPU int64 tensor of size [batch_size + 1], holds where
+//    each sequence starts in `values`, followed by `total_length`, so that
+//    sequence `b` is `values[offsets[b]:offsets[b + 1]]`.
+//
+// Since `values` is a regular tensor, elementwise operations apply to it
+// directly, and so does everything that treats the elements of the batch
+// independently (e.g. linear layers). The functions below cover the
+// operations that work on whole sequences, without padding them.
+//
+// `offsets` lives on the CPU like the `lengths` of `_pack_padded_sequence`,
+// since the functions loop over the sequences on the host.
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+void checkOffsets(const Tensor& values, const Tensor& offsets) {
+  AT_CHECK(offsets.dim() == 1 && offsets.device().type() == at::kCPU &&
+           offsets.scalar_type() == at::kLong,
+           "'offsets' argument should be a 1D CPU int64 tensor");
+  AT_CHECK(offsets.numel() > 0, "'offsets' must hold at least one element");
+  AT_CHECK(values.dim() >= 1, "jagged 'values' must have at least one dimension");
+  auto offsets_t = offsets.contiguous();
+  const int64_t* data = offsets_t.data<int64_t>();
+  AT_CHECK(data[0] == 0, "'offsets' must start at 0, but starts at ", data[0]);
+  for (int64_t b = 0; b + 1 < offsets_t.numel(); b++) {
+    AT_CHECK(data[b] <= data[b + 1],
+             "'offsets' must be non-decreasing, but offsets[", b, "] = ", data[b],
+             " > offsets[", b + 1, "] = ", data[b + 1]);
+  }
+  AT_CHECK(data[offsets_t.numel() - 1] == values.size(0),
+           "The last element of 'offsets' should be the length of 'values' (",
+           values.size(0), "), but got ", data[offsets_t.numel() - 1]);
+}
+
+// The rows of a [batch_size * max_length, *] padded tensor that hold the
+// elements of the sequences, in order.
+Tensor paddedRows(const Tensor& offsets, int64_t max_length, const Tensor& like) {
+  auto offsets_t = offsets.contiguous();
+  const int64_t* data = offsets_t.data<int64_t>();
+  const int64_t batch_size = offsets_t.numel() - 1;
+  auto rows = at::empty({data[batch_size]}, offsets_t.options());
+  int64_t* rows_data = rows.data<int64_t>();
+  for (int64_t b = 0; b < batch_size; b++) {
+    for (int64_t i = data[b]; i < data[b + 1]; i++) {
+      *rows_data++ = b * max_length + (i - data[b]);
+    }
+  }
+  return rows.to(like.device());
+}
+
+int64_t maxLength(const Tensor& offsets) {
+  auto offsets_t = offsets.contiguous();
+  const int64_t* data = offsets_t.data<int64_t>();
+  int64_t max_length = 0;
+  for (int64_t b = 0; b + 1 < offsets_t.numel(); b++) {
+    max_length = std::max(max_length, data[b + 1] - data[b]);
+  }
+  return max_length;
+}
+
+// The sizes of a padded tensor of `values` with `batch_size` sequences.
+std::vector<int64_t> paddedSizes(const Tensor& values, int64_t batch_size, int64_t max_length) {
+  std::vector<int64_t> sizes = {batch_size, max_length};
+  sizes.insert(sizes.end(), values.sizes().begin() + 1, values.sizes().end());
+  return sizes;
+}
+
+template <typename scalar_t>
+void jagged_softmax_kernel(
+    const scalar_t* input,
+    scalar_t* output,
+    const int64_t* offsets,
+    int64_t batch_size,
+    int64_t features) {
+  at::parallel_for(0, batch_size, 1, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> max(features);
+    std::vector<scalar_t> sum(features);
+    for (int64_t b = begin; b < end; b++) {
+      const int64_t row_begin = offsets[b];
+      const int64_t row_end = offsets[b + 1];
+      if (row_begin == row_end) {
+        continue;
+      }
+      std::fill(max.begin(), max.end(), -std::numeric_limits<scalar_t>::infinity());
+      std::fill(sum.begin(), sum.end(), scalar_t(0));
+      for (int64_t i = row_begin; i < row_end; i++) {
+        const scalar_t* in = input + i * features;
+        for (int64_t f = 0; f < features; f++) {
+          max[f] = std::max(max[f], in[f]);
+        }
+      }
+      for (int64_t i = row_begin; i < row_end; i++) {
+        const scalar_t* in = input + i * features;
+        scalar_t* out = output + i * features;
+        for (int64_t f = 0; f < features; f++) {
+          out[f] = std::exp(in[f] - max[f]);
+          sum[f] += out[f];
+        }
+      }
+      for (int64_t i = row_begin; i < row_end; i++) {
+        scalar_t* out = output + i * features;
+        for (int64_t f = 0; f < features; f++) {
+          out[f] /= sum[f];
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void jagged_softmax_backward_kernel(
+    const scalar_t* grad,
+    const scalar_t* output,
+    scalar_t* grad_input,
+    const int64_t* offsets,
+    int64_t batch_size,
+    int64_t features) {
+  at::parallel_for(0, batch_size, 1, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> dot(features);
+    for (int64_t b = begin; b < end; b++) {
+      const int64_t row_begin = offsets[b];
+      const int64_t row_end = offsets[b + 1];
+      std::fill(dot.begin(), dot.end(), scalar_t(0));
+      for (int64_t i = row_begin; i < row_end; i++) {
+        const scalar_t* g = grad + i * features;
+        const scalar_t* out = output + i * features;
+        for (int64_t f = 0; f < features; f++) {
+          dot[f] += g[f] * out[f];
+        }
+      }
+      for (int64_t i = row_begin; i < row_end; i++) {
+        const scalar_t* g = grad + i * features;
+        const scalar_t* out = output + i * features;
+        scalar_t* gi = grad_input + i * features;
+        for (int64_t f = 0; f < features; f++) {
+          gi[f] = out[f] * (g[f] - dot[f]);
+        }
+      }
+    }
+  });
+}
+
+} // namespace
+
+Tensor _jagged_to_padded(const Tensor& values, const Tensor& offsets, Scalar padding_value, int64_t max_length) {
+  checkOffsets(values, offsets);
+  const int64_t batch_size = offsets.numel() - 1;
+  const int64_t longest = maxLength(offsets);
+  if (max_length < 0) {
+    max_length = longest;
+  }
+  AT_CHECK(max_length >= longest,
+           "Expected max_length to be at least the length of the longest sequence (",
+           longest, "), but got ", max_length);
+  auto sizes = paddedSizes(values, batch_size, max_length);
+  auto rows_sizes = sizes;
+  rows_sizes.erase(rows_sizes.begin());
+  rows_sizes[0] = batch_size * max_length;
+  auto padded = at::full(rows_sizes, padding_value, values.options());
+  return padded.index_copy(0, paddedRows(offsets, max_length, values), values).view(sizes);
+}
+
+std::tuple<Tensor, Tensor> _padded_to_jagged(const Tensor& padded, const Tensor& lengths) {
+  AT_CHECK(lengths.dim() == 1 && lengths.device().type() == at::kCPU &&
+           lengths.scalar_type() == at::kLong,
+           "'lengths' argument should be a 1D CPU int64 tensor");
+  AT_CHECK(padded.dim() >= 2, "Expected a padded tensor of size [batch_size, max_length, *]");
+  AT_CHECK(lengths.numel() == padded.size(0),
+           "Expected `len(lengths)` to be equal to batch_size, but got ", lengths.numel(),
+           " (batch_size=", padded.size(0), ")");
+  const int64_t max_length = padded.size(1);
+  auto lengths_t = lengths.contiguous();
+  const int64_t* lengths_data = lengths_t.data<int64_t>();
+  auto offsets = at::empty({lengths_t.numel() + 1}, lengths_t.options());
+  int64_t* offsets_data = offsets.data<int64_t>();
+  offsets_data[0] = 0;
+  for (int64_t b = 0; b < lengths_t.numel(); b++) {
+    AT_CHECK(lengths_data[b] >= 0 && lengths_data[b] <= max_length,
+             "Expected lengths between 0 and the padded length ", max_length,
+             ", but found ", lengths_data[b]);
+    offsets_data[b + 1] = offsets_data[b] + lengths_data[b];
+  }
+  std::vector<int64_t> rows_sizes = {padded.size(0) * max_length};
+  rows_sizes.insert(rows_sizes.end(), padded.sizes().begin() + 2, padded.sizes().end());
+  auto values = padded.reshape(rows_sizes).index_select(0, paddedRows(offsets, max_length, padded));
+  return std::make_tuple(values, offsets);
+}
+
+Tensor _jagged_matmul(const Tensor& values, const Tensor& offsets, const Tensor& other) {
+  checkOffsets(values, offsets);
+  const int64_t batch_size = offsets.numel() - 1;
+  AT_CHECK(values.dim() == 2, "Expected 2D jagged values of size [total_length, k], but got ",
+           values.dim(), "D values");
+  AT_CHECK(other.dim() == 3 && other.size(0) == batch_size,
+           "Expected a 3D tensor of size [batch_size, k, n] with batch_size = ", batch_size,
+           ", but got one of size ", other.sizes());
+  auto offsets_t = offsets.contiguous();
+  const int64_t* data = offsets_t.data<int64_t>();
+  std::vector<Tensor> results;
+  results.reserve(batch_size);
+  for (int64_t b = 0; b < batch_size; b++) {
+    results.push_back(at::mm(values.narrow(0, data[b], data[b + 1] - data[b]), other[b]));
+  }
+  if (results.empty()) {
+    return at::empty({0, other.size(2)}, values.options());
+  }
+  return at::cat(results, 0);
+}
+
+Tensor jagged_softmax_cpu(const Tensor& values, const Tensor& offsets) {
+  checkOffsets(values, offsets);
+  auto input = values.contiguous();
+  auto output = at::empty_like(input);
+  auto offsets_t = offsets.contiguous();
+  const int64_t features = input.size(0) == 0 ? 0 : input.numel() / input.size(0);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "jagged_softmax", [&] {
+    jagged_softmax_kernel<scalar_t>(
+        input.data<scalar_t>(),
+        output.data<scalar_t>(),
+        offsets_t.data<int64_t>(),
+        offsets_t.numel() - 1,
+        features);
+  });
+  return output;
+}
+
+Tensor jagged_softmax_backward_cpu(const Tensor& grad, const Tensor& output, const Tensor& offsets) {
+  auto grad_t = grad.contiguous();
+  auto output_t = output.contiguous();
+  auto grad_input = at::empty_like(output_t);
+  auto offsets_t = offsets.contiguous();
+  const int64_t features = output_t.size(0) == 0 ? 0 : output_t.numel() / output_t.size(0);
+  AT_DISPATCH_FLOATING_TYPES(output_t.scalar_type(), "jagged_softmax_backward", [&] {
+    jagged_softmax_backward_kernel<scalar_t>(
+        grad_t.data<scalar_t>(),
+        output_t.data<scalar_t>(),
+        grad_input.data<scalar_t>(),
+        offsets_t.data<int64_t>(),
+        offsets_t.numel() - 1,
+        features);
+  });
+  return grad_input;
+}
+
+// On CUDA, the sequences are normalized one at a time by the regular softmax
+// kernels, which is what a segmented kernel would save launches over.
+Tensor jagged_softmax_cuda(const Tensor& values, const Tensor& offsets) {
+  checkOffsets(values, offsets);
+  auto output = at::empty_like(values);
+  auto offsets_t = offsets.contiguous();
+  const int64_t* data = offsets_t.data<int64_t>();
+  for (int64_t b = 0; b + 1 < offsets_t.numel(); b++) {
+    if (data[b] < data[b + 1]) {
+      output.narrow(0, data[b], data[b + 1] - data[b])
+          .copy_(at::_softmax(values.narrow(0, data[b], data[b + 1] - data[b]), 0, false));
+    }
+  }
+  return output;
+}
+
+Tensor jagged_softmax_backward_cuda(const Tensor& grad, const Tensor& output, const Tensor& offsets) {
+  auto grad_input = at::empty_like(output);
+  auto offsets_t = offsets.contiguous();
+  const int64_t* data = offsets_t.data<int64_t>();
+  for (int64_t b = 0; b + 1 < offsets_t.numel(); b++) {
+    const int64_t length = data[b + 1] - data[b];
+    if (length > 0) {
+      auto out = output.narrow(0, data[b], length);
+      grad_input.narrow(0, data[b], length)
+          .copy_(at::_softmax_backward_data(grad.narrow(0, data[b], length), out, 0, out));
+    }
+  }
+  return grad_input;
+}
+
+}} // namespace at::native
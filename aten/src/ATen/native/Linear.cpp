@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/WrapDimUtilsMulti.h>
+#include <ATen/native/Activation.h>
+#include <ATen/native/TensorIterator.h>
 
 #include <array>
 #include <cctype>
@@ -27,6 +29,27 @@ Tensor linear(const Tensor& input, const Tensor& weight, const Tensor& bias) {
   return output;
 }
 
+// linear followed by relu makes three passes over the output: addmm copies
+// the bias into it, the GEMM reads it back, and relu writes a new tensor.
+// Here the GEMM writes the output without reading it and one elementwise
+// kernel adds the bias and applies the relu in place.
+Tensor _linear_relu(const Tensor& input, const Tensor& weight, const Tensor& bias) {
+  if (input.is_mkldnn()) {
+    return at::relu(at::mkldnn_linear(input, weight, bias));
+  }
+  AT_CHECK(input.dim() >= 1, "_linear_relu: expected input with at least 1 dimension");
+  auto output = at::mm(input.reshape({-1, input.size(-1)}), weight.t());
+  if (bias.defined()) {
+    auto iter = TensorIterator::binary_op(output, output, bias);
+    bias_relu_stub(iter->device_type(), *iter);
+  } else {
+    output.relu_();
+  }
+  auto output_size = input.sizes().vec();
+  output_size.back() = weight.size(0);
+  return output.view(output_size);
+}
+
 // sumproduct_pair computes `(left*right).sum(sumdims)` by means of permutation and
 // batch matrix multiplication
 // its main purpose is to provide a pairwise reduction for einsum
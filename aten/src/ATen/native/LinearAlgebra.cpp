@@ -6,6 +6,7 @@
 #include <ATen/native/LinearAlgebraUtils.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/Parallel.h>
+#include <algorithm>
 #include <functional>
 #include <numeric>
 #include <vector>
@@ -212,44 +213,118 @@ Tensor& addr_out(Tensor &result, const Tensor& self, const Tensor& vec1, const T
   return at::legacy::th::_th_addr_out(result, self, vec1, vec2, beta, alpha);
 }
 
+// Matrices with all sizes up to kSmallGemmMaxSize are multiplied by
+// small_gemm below rather than handed to BLAS, whose per-call overhead
+// dominates at these sizes.
+static constexpr int64_t kSmallGemmMaxSize = 16;
+
+// One item of the batch: r = beta * r + alpha * (a @ b) for an m x k matrix
+// a and a k x n matrix b with arbitrary strides. The product is accumulated
+// in acc (m * n elements, row major), so that when the sizes are compile-time
+// constants the loops unroll and acc stays in registers. As in BLAS, r is not
+// read when beta is zero (or for bmm).
+template <typename scalar_t, bool is_bmm>
+static inline void small_gemm(
+    int64_t m, int64_t n, int64_t k, scalar_t* acc,
+    scalar_t* r, int64_t r_s0, int64_t r_s1,
+    const scalar_t* a, int64_t a_s0, int64_t a_s1,
+    const scalar_t* b, int64_t b_s0, int64_t b_s1,
+    scalar_t beta, scalar_t alpha) {
+  for (int64_t i = 0; i < m * n; i++) {
+    acc[i] = 0;
+  }
+  for (int64_t l = 0; l < k; l++) {
+    for (int64_t i = 0; i < m; i++) {
+      const scalar_t a_il = a[i * a_s0 + l * a_s1];
+      for (int64_t j = 0; j < n; j++) {
+        acc[i * n + j] += a_il * b[l * b_s0 + j * b_s1];
+      }
+    }
+  }
+  for (int64_t i = 0; i < m; i++) {
+    for (int64_t j = 0; j < n; j++) {
+      scalar_t& out = r[i * r_s0 + j * r_s1];
+      if (is_bmm) {
+        out = acc[i * n + j];
+      } else if (beta == scalar_t(0)) {
+        out = alpha * acc[i * n + j];
+      } else {
+        out = beta * out + alpha * acc[i * n + j];
+      }
+    }
+  }
+}
+
+// Register-blocked kernel for an S x S x S product
+template <typename scalar_t, bool is_bmm, int64_t S>
+static void small_gemm_square(
+    int64_t m, int64_t n, int64_t k,
+    scalar_t* r, int64_t r_s0, int64_t r_s1,
+    const scalar_t* a, int64_t a_s0, int64_t a_s1,
+    const scalar_t* b, int64_t b_s0, int64_t b_s1,
+    scalar_t beta, scalar_t alpha) {
+  scalar_t acc[S * S];
+  small_gemm<scalar_t, is_bmm>(S, S, S, acc, r, r_s0, r_s1, a, a_s0, a_s1,
+                               b, b_s0, b_s1, beta, alpha);
+}
+
+template <typename scalar_t, bool is_bmm>
+static void small_gemm_any(
+    int64_t m, int64_t n, int64_t k,
+    scalar_t* r, int64_t r_s0, int64_t r_s1,
+    const scalar_t* a, int64_t a_s0, int64_t a_s1,
+    const scalar_t* b, int64_t b_s0, int64_t b_s1,
+    scalar_t beta, scalar_t alpha) {
+  scalar_t acc[kSmallGemmMaxSize * kSmallGemmMaxSize];
+  small_gemm<scalar_t, is_bmm>(m, n, k, acc, r, r_s0, r_s1, a, a_s0, a_s1,
+                               b, b_s0, b_s1, beta, alpha);
+}
+
+// result[b] = beta * result[b] + alpha * (self[b] @ mat2[b]) for result
+// items of at most kSmallGemmMaxSize x kSmallGemmMaxSize, in parallel over
+// the batch.
 template <typename scalar_t, bool is_bmm>
 inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const Tensor& mat2, Scalar beta_, Scalar alpha_) {
   int64_t bs = result.size(0);
   int64_t is = result.size(1);
   int64_t js = result.size(2);
   int64_t ks = self.size(2);
+  AT_ASSERT(is * js <= kSmallGemmMaxSize * kSmallGemmMaxSize);
 
   scalar_t alpha = alpha_.to<scalar_t>();
   scalar_t beta = beta_.to<scalar_t>();
 
-  auto r0 = result.accessor<scalar_t, 3>();
-  auto s0 = self.accessor<scalar_t, 3>();
-  auto m0 = mat2.accessor<scalar_t, 3>();
+  using gemm_fn = void(*)(int64_t, int64_t, int64_t,
+                          scalar_t*, int64_t, int64_t,
+                          const scalar_t*, int64_t, int64_t,
+                          const scalar_t*, int64_t, int64_t,
+                          scalar_t, scalar_t);
+  gemm_fn gemm = &small_gemm_any<scalar_t, is_bmm>;
+  if (is == js && js == ks) {
+    switch (is) {
+      case 2: gemm = &small_gemm_square<scalar_t, is_bmm, 2>; break;
+      case 3: gemm = &small_gemm_square<scalar_t, is_bmm, 3>; break;
+      case 4: gemm = &small_gemm_square<scalar_t, is_bmm, 4>; break;
+      case 8: gemm = &small_gemm_square<scalar_t, is_bmm, 8>; break;
+      default: break;
+    }
+  }
+
+  scalar_t* r_data = result.data<scalar_t>();
+  const scalar_t* s_data = self.data<scalar_t>();
+  const scalar_t* m_data = mat2.data<scalar_t>();
+  const int64_t r_s0 = result.stride(0), r_s1 = result.stride(1), r_s2 = result.stride(2);
+  const int64_t s_s0 = self.stride(0), s_s1 = self.stride(1), s_s2 = self.stride(2);
+  const int64_t m_s0 = mat2.stride(0), m_s1 = mat2.stride(1), m_s2 = mat2.stride(2);
 
-  int64_t grain_size = std::min(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
+  int64_t grain_size = std::max(internal::GRAIN_SIZE / (is * js * ks), (int64_t)1);
   parallel_for(0, bs, grain_size, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t b = b_begin; b < b_end; b++) {
-        auto r1 = r0[b];
-        auto s1 = s0[b];
-        auto m1 = m0[b];
-        for (int64_t i = 0; i < is; i++) {
-          auto r2 = r1[i];
-          auto s2 = s1[i];
-          for (int64_t j = 0; j < js; j++) {
-            scalar_t &r = r2[j];
-            if (is_bmm) {
-              r = 0;
-              for (int64_t k = 0; k < ks; k++) {
-                r += s2[k] * m1[k][j];
-              }
-            } else {
-              r *= beta;
-              for (int64_t k = 0; k < ks; k++) {
-                r += alpha * s2[k] * m1[k][j];
-              }
-            }
-          }
-        }
+        gemm(is, js, ks,
+             r_data + b * r_s0, r_s1, r_s2,
+             s_data + b * s_s0, s_s1, s_s2,
+             m_data + b * m_s0, m_s1, m_s2,
+             beta, alpha);
       }
     });
 }
@@ -301,7 +376,19 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             || (t.stride(1) == 1 && t.stride(2) >= t.size(1));
   };
 
-  if (contraction_size * res_rows * res_cols < 400) {
+  const bool use_mkl = at::hasMKL() && at::native::is_floating_point(self_or_result)
+            && batch_items_contiguous_or_transposed(batch1)
+            && batch_items_contiguous_or_transposed(batch2)
+            && self_or_result.is_contiguous();
+  // Tiny products always go to the small-matrix kernel. Up to 8 it also beats
+  // MKL's gemm_batch, and without MKL it beats one BLAS call per item up to
+  // kSmallGemmMaxSize.
+  const int64_t max_size = std::max({contraction_size, res_rows, res_cols});
+  const bool use_small_gemm = res_rows * res_cols <= kSmallGemmMaxSize * kSmallGemmMaxSize
+      && (contraction_size * res_rows * res_cols < 400 || max_size <= 8
+          || (max_size <= kSmallGemmMaxSize && !use_mkl));
+
+  if (use_small_gemm) {
     if (is_bmm_out) {
       AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
@@ -311,10 +398,7 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
           baddbmm_cpu_kernel<scalar_t, false>(self_or_result, batch1, batch2, beta, alpha);
         });
     }
-  } else if (at::hasMKL() && at::native::is_floating_point(self_or_result)
-            && batch_items_contiguous_or_transposed(batch1)
-            && batch_items_contiguous_or_transposed(batch2)
-            && self_or_result.is_contiguous()) {
+  } else if (use_mkl) {
     at::native::_baddbmm_mkl_(self_or_result, batch1, batch2, beta, alpha);
   } else { // split along batch dimension
     if (is_bmm_out) {
@@ -0,0 +1,138 @@
+#include <ATen/ATen.h>
+#include <ATen/DeviceGuard.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/MultiTensorNorm.h>
+
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <vector>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(multi_tensor_norm_stub);
+DEFINE_DISPATCH(multi_tensor_scale_stub);
+
+namespace {
+
+using GroupKey = std::tuple<DeviceType, int16_t, ScalarType>;
+
+// Whether multi_tensor_norm_stub and multi_tensor_scale_stub support tensors
+// of the device and dtype of `tensor`, if they are contiguous.
+bool kernel_supported(const Tensor& tensor) {
+  return tensor.is_cuda() ||
+      (tensor.device().is_cpu() && tensor.scalar_type() != kHalf);
+}
+
+GroupKey group_key(const Tensor& tensor) {
+  return std::make_tuple(
+      tensor.device().type(), tensor.device().index(), tensor.scalar_type());
+}
+
+void check_tensor(const char* name, const Tensor& tensor) {
+  AT_CHECK(!tensor.is_sparse(), name, ": sparse tensors are not supported");
+  AT_CHECK(
+      tensor.is_floating_point(),
+      name, ": expected floating point tensors, but got ",
+      tensor.scalar_type());
+}
+
+} // namespace
+
+// The p-norm of all the elements of `tensors`, as if they were concatenated
+// into a single vector, computed with one multi-tensor reduction per device
+// and dtype instead of a norm per tensor. The result stays on the device of
+// the first tensor, in fp32 (or fp64 if any tensor is fp64), so that nothing
+// waits for it on the host. Undefined tensors are skipped.
+Tensor _multi_tensor_norm(TensorList tensors, double norm_type) {
+  const char* name = "_multi_tensor_norm";
+  AT_CHECK(
+      norm_type > 0,
+      name, ": expected a positive norm_type, but got ", norm_type);
+  std::map<GroupKey, std::vector<Tensor>> groups;
+  Device device = kCPU;
+  ScalarType dtype = kFloat;
+  bool first = true;
+  for (const auto& tensor : tensors) {
+    if (!tensor.defined()) {
+      continue;
+    }
+    check_tensor(name, tensor);
+    if (first) {
+      device = tensor.device();
+      first = false;
+    }
+    if (tensor.scalar_type() == kDouble) {
+      dtype = kDouble;
+    }
+    // Only read, so a copy does for the tensors the kernels don't support.
+    auto input = kernel_supported(tensor) ? tensor.contiguous()
+                                          : tensor.to(kFloat).contiguous();
+    groups[group_key(input)].push_back(input);
+  }
+  if (groups.empty()) {
+    return at::zeros({}, TensorOptions(device).dtype(dtype));
+  }
+
+  std::vector<Tensor> partials;
+  for (const auto& group : groups) {
+    const auto& inputs = group.second;
+    OptionalDeviceGuard device_guard(device_of(inputs.front()));
+    partials.push_back(
+        multi_tensor_norm_stub(inputs.front().device().type(), inputs, norm_type)
+            .to(device, dtype));
+  }
+  const auto all_partials =
+      partials.size() == 1 ? partials.front() : at::cat(partials);
+  if (std::isinf(norm_type)) {
+    return all_partials.max();
+  }
+  const auto sum = all_partials.sum();
+  if (norm_type == 1) {
+    return sum;
+  }
+  return norm_type == 2 ? sum.sqrt() : sum.pow(1 / norm_type);
+}
+
+// Clips the gradients `grads` in place so that their global p-norm (see
+// _multi_tensor_norm) is at most max_norm, and returns that norm before
+// clipping. The clip coefficient min(1, max_norm / (norm + 1e-6)) is computed
+// and applied on the device, with one fused kernel per device and dtype, so
+// the call never waits for the device; gradients under the limit are
+// multiplied by 1. Non-contiguous gradients fall back to a mul_.
+Tensor _clip_grads_by_norm(
+    TensorList grads,
+    double max_norm,
+    double norm_type) {
+  const auto total_norm = at::native::_multi_tensor_norm(grads, norm_type);
+  const auto clip_coef =
+      (total_norm + 1e-6).reciprocal().mul_(max_norm).clamp_max_(1.0);
+
+  std::map<GroupKey, std::vector<Tensor>> groups;
+  for (Tensor grad : grads) {
+    if (!grad.defined()) {
+      continue;
+    }
+    if (kernel_supported(grad) && grad.is_contiguous()) {
+      groups[group_key(grad)].push_back(grad);
+    } else {
+      grad.mul_(clip_coef.to(grad.device(), grad.scalar_type()));
+    }
+  }
+  for (const auto& group : groups) {
+    const auto& tensors = group.second;
+    const auto& front = tensors.front();
+    OptionalDeviceGuard device_guard(device_of(front));
+    // The accumulate type of the kernels.
+    const auto scale_dtype = front.scalar_type() == kDouble || front.device().is_cpu()
+        ? kDouble
+        : kFloat;
+    multi_tensor_scale_stub(
+        front.device().type(),
+        tensors,
+        clip_coef.to(front.device(), scale_dtype));
+  }
+  return total_norm;
+}
+
+}} // namespace at::native
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The kernels of _multi_tensor_norm and _clip_grads_by_norm, for a list of
+// contiguous tensors of the same device and dtype.
+//
+// multi_tensor_norm returns a 1-d tensor on the device of the tensors, of
+// their accumulate type, whose sum is the sum of |x|^norm_type over all the
+// elements x of the tensors; or whose max is the max of |x|, if norm_type is
+// inf. multi_tensor_scale multiplies the tensors in place by `scale`, a one
+// element tensor of their accumulate type on their device.
+using multi_tensor_norm_fn = Tensor(*)(TensorList tensors, double norm_type);
+using multi_tensor_scale_fn = void(*)(TensorList tensors, const Tensor& scale);
+
+DECLARE_DISPATCH(multi_tensor_norm_fn, multi_tensor_norm_stub);
+DECLARE_DISPATCH(multi_tensor_scale_fn, multi_tensor_scale_stub);
+
+}} // namespace at::native
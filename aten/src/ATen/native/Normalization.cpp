@@ -6,6 +6,7 @@
 #include <ATen/Config.h>
 
 #include <ATen/detail/CUDAHooksInterface.h>
+#include <ATen/native/cpu/BatchNormKernel.h>
 
 #include <vector>
 
@@ -54,74 +55,44 @@ struct Var {
   }
 };
 
-/// A fast path for CPU inference when all tensors are contiguous.
-/// This code achieves machine bandwidth peak without AVX support.
-/// If this changes for future architectures, we can move it to the cpu/
-/// directory.
+/// Collect the linear and constant terms regarding the input.
+/// output(n, c, h, w)
+///     = (input(n, c, h, w) - mean(c)) * invstd(c) * weight(c) + bias(c)
+///     = input(n, c, h, w) * invstd(c) * weight(c) +
+///         - mean(c) * invstd(c) * weight(c) + bias(c),
+/// where invstd(c) is the saved inverse standard deviation in training, and
+/// 1 / sqrt(var(c) + eps) of the running variance in evaluation.
+/// So the linear term, alpha(c) = invstd(c) * weight(c),
+///   the constant term beta(c) = bias(c) - mean(c) * invstd(c) * weight(c)
 template<typename scalar_t>
-void batch_norm_cpu_inference_contiguous(Tensor& output, const Tensor& input,
+static void batch_norm_cpu_collect_linear_and_constant_terms(
+    Tensor& alpha, Tensor& beta, int64_t n_channel,
     const Tensor& weight /* optional */, const Tensor& bias /* optional */,
-    const Tensor& mean, const Tensor& variance, double eps) {
-  int64_t n_batch = input.size(0);
-  int64_t n_channel = input.size(1);
-  int64_t image_size = input.numel() / n_batch / n_channel;
-
-  scalar_t* output_data = output.data<scalar_t>();
-  const scalar_t* input_data = input.data<scalar_t>();
-  const scalar_t* weight_data = weight.defined() ? weight.data<scalar_t>() : nullptr;
-  const scalar_t* bias_data = bias.defined() ? bias.data<scalar_t>() : nullptr;
-  const scalar_t* mean_data = mean.data<scalar_t>();
-  const scalar_t* var_data = variance.data<scalar_t>();
-
-  /// Collect the linear and constant terms regarding the input.
-  /// output(n, c, h, w)
-  ///     = (input(n, c, h, w) - mean(c)) / sqrt(var(c) + eps) * weight(c)
-  ///         + bias(c)
-  ///     = input(n, c, h, w) * inv_var(c) * weight(c) +
-  ///         - mean(c) * inv_var(c) * weight(c) + bias(c),
-  /// where inv_var(c) = 1 / sqrt(var(c) + eps).
-  /// So the linear term, alpha(c) = inv_var(c) * weight(c),
-  ///   the constant term beta(c) = bias(c) - mean(c) * inv_var(c) * weight(c)
-  /// Note that this is only a good idea if (input_size >> c), in degenerate
-  /// cases where image_size == 1 && batch_size == 1, it is slow.
-  Tensor alpha = at::empty_like(mean);
-  Tensor beta = at::empty_like(mean);
+    const Tensor& save_mean /* optional */, const Tensor& save_invstd /* optional */,
+    const Tensor& running_mean /* optional */, const Tensor& running_var /* optional */,
+    bool train, double eps) {
+  auto weight_a = conditional_accessor_1d<scalar_t>(weight);
+  auto bias_a = conditional_accessor_1d<scalar_t>(bias);
+  auto save_mean_a = conditional_accessor_1d<scalar_t>(save_mean);
+  auto save_invstd_a = conditional_accessor_1d<scalar_t>(save_invstd);
+  auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
+  auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
+
   scalar_t* alpha_data = alpha.data<scalar_t>();
   scalar_t* beta_data = beta.data<scalar_t>();
   for (int64_t c = 0; c < n_channel; c++) {
-    scalar_t inv_var = 1 / std::sqrt(var_data[c] + static_cast<scalar_t>(eps));
-    scalar_t weight_v = weight_data ? weight_data[c] : 1;
-    scalar_t bias_v = bias_data ? bias_data[c] : 0;
-    alpha_data[c] = inv_var * weight_v;
-    beta_data[c] = bias_v - mean_data[c] * inv_var * weight_v;
-  }
-
-  // Apply the linear terms to the input,
-  // output(n, c, h, w) = input(n, c, h, w) * alpha(c) + beta(c)
-  // No need to use parallel_for as this function is supposed to be
-  // memory-limited.
-  // Keep the loop struture simple to make sure compiler vetorization kicks in.
-  if (image_size != 1) {
-    for (int64_t n = 0; n < n_batch; ++n) {
-      for (int64_t c = 0; c < n_channel; ++c) {
-        for (int64_t i = 0; i < image_size; ++i) {
-          // Keep all the offset calculation within the inner loop for
-          // simplicity. Compilers are very good at hoisting the common part
-          // outside.
-          int64_t offset = n * n_channel * image_size + c * image_size + i;
-          output_data[offset] = input_data[offset] * alpha_data[c] +
-              beta_data[c];
-        }
-      }
-    }
-  } else {
-    // image_size == 1
-    for (int64_t n = 0; n < n_batch; ++n) {
-      for (int64_t c = 0; c < n_channel; ++c) {
-        int64_t offset = n * n_channel + c;
-        output_data[offset] = input_data[offset] * alpha_data[c] + beta_data[c];
-      }
+    scalar_t mean, invstd;
+    if (train) {
+      mean = save_mean_a[c];
+      invstd = save_invstd_a[c];
+    } else {
+      mean = running_mean_a[c];
+      invstd = 1 / std::sqrt(running_var_a[c] + static_cast<scalar_t>(eps));
     }
+    scalar_t weight_v = weight.defined() ? weight_a[c] : 1;
+    scalar_t bias_v = bias.defined() ? bias_a[c] : 0;
+    alpha_data[c] = invstd * weight_v;
+    beta_data[c] = bias_v - mean * invstd * weight_v;
   }
 }
 
@@ -132,16 +103,22 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     const Tensor& running_mean /* optional */, const Tensor& running_var /* optional */,
     bool train, double eps) {
 
-  Tensor output = at::empty_like(input);
-
-  // Check if we should use the fast path.
-  if (!train && input.is_contiguous()
-      && (!weight.defined() || weight.is_contiguous())
-      && (!bias.defined() || bias.is_contiguous())
-      && running_mean.is_contiguous()
-      && running_var.is_contiguous()) {
-    batch_norm_cpu_inference_contiguous<scalar_t>(output, input, weight, bias,
-      running_mean, running_var, eps);
+  // Keep the memory format of the input, so that channels last activations
+  // stay channels last through the network.
+  Tensor output = at::empty(input.sizes(), input.options(), input.suggest_memory_format());
+
+  // Check if we should use the fast path: the vectorized kernel applies
+  // output = input * alpha + beta to contiguous and channels last tensors.
+  if ((input.is_contiguous() && output.is_contiguous()) ||
+      (input.is_contiguous(MemoryFormat::ChannelsLast) &&
+       output.is_contiguous(MemoryFormat::ChannelsLast))) {
+    int64_t n_channel = input.size(1);
+    Tensor alpha = at::empty({n_channel}, input.options());
+    Tensor beta = at::empty({n_channel}, input.options());
+    batch_norm_cpu_collect_linear_and_constant_terms<scalar_t>(
+        alpha, beta, n_channel, weight, bias, save_mean, save_invstd,
+        running_mean, running_var, train, eps);
+    batch_norm_cpu_transform_stub(kCPU, output, input, alpha, beta);
     return std::make_tuple(output, save_mean, save_invstd);
   }
   int64_t n_input = input.size(1);
@@ -240,7 +217,7 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_weight;
   Tensor grad_bias;
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input);
+    grad_input = at::empty(input.sizes(), input.options(), input.suggest_memory_format());
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight);
@@ -372,7 +349,7 @@ std::tuple<Tensor, Tensor, Tensor, int64_t> _batch_norm_impl_index(
   if (use_cudnn && eps >= detail::getCUDAHooks().batchnormMinEpsilonCuDNN()) {
     return std::tuple_cat(
              at::cudnn_batch_norm(
-               input.contiguous(), weight.contiguous(),
+               input.contiguous(input.suggest_memory_format()), weight.contiguous(),
                bias.contiguous(),
                running_mean.defined() ? running_mean.contiguous() : running_mean,
                running_var.defined() ? running_var.contiguous() : running_var,
@@ -462,9 +439,8 @@ Tensor instance_norm(
   return out.view(input.sizes());
 }
 
-Tensor layer_norm(const Tensor& input, IntArrayRef normalized_shape,
-    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
-    double eps, bool cudnn_enabled) {
+static void check_layer_norm_inputs(const Tensor& input, IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */) {
 
     int64_t normalized_ndim = normalized_shape.size();
 
@@ -496,6 +472,17 @@ Tensor layer_norm(const Tensor& input, IntArrayRef normalized_shape,
       ss << "], but got input of size" << input_shape;
       AT_ERROR(ss.str());
     }
+}
+
+Tensor layer_norm(const Tensor& input, IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
+    double eps, bool cudnn_enabled) {
+
+    check_layer_norm_inputs(input, normalized_shape, weight, bias);
+
+    auto input_shape = input.sizes();
+    auto input_ndim = input.dim();
+    int64_t normalized_ndim = normalized_shape.size();
 
     int64_t n = 1;
     for (int64_t i = 0; i < input_ndim - normalized_ndim; i++) {
@@ -520,6 +507,32 @@ Tensor layer_norm(const Tensor& input, IntArrayRef normalized_shape,
     }
 }
 
+// layer_norm(dropout(input, p, train) + residual), as found at the end of the
+// sublayers of transformer blocks. On CUDA it runs as a single kernel, which
+// saves the dropout mask with one bit per element for the backward.
+Tensor dropout_add_layer_norm(const Tensor& input, const Tensor& residual,
+    IntArrayRef normalized_shape, const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */, double p, bool train, double eps) {
+
+    AT_CHECK(p >= 0 && p <= 1,
+             "dropout probability has to be between 0 and 1, but got ", p);
+    AT_CHECK(input.sizes().equals(residual.sizes()),
+             "Expected input and residual of the same shape, but got input of "
+             "shape ", input.sizes(), " and residual of shape ", residual.sizes());
+    check_layer_norm_inputs(input, normalized_shape, weight, bias);
+
+    auto same_type = [&](const Tensor& t) {
+      return !t.defined() || t.type() == input.type();
+    };
+    if (input.is_cuda() && input.numel() > 0 && same_type(residual) &&
+        same_type(weight) && same_type(bias)) {
+      return std::get<0>(at::_fused_dropout_add_layer_norm(
+          input, residual, normalized_shape, weight, bias, train ? p : 0, eps));
+    }
+    return at::layer_norm(at::dropout(input, p, train).add(residual),
+                          normalized_shape, weight, bias, eps, true);
+}
+
 Tensor group_norm(const Tensor& input, int64_t num_groups,
     const Tensor& weight /* optional */, const Tensor& bias /* optional */,
     double eps, bool cudnn_enabled) {
@@ -595,4 +608,6 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu(const Tensor& grad_ou
     });
 }
 
+DEFINE_DISPATCH(batch_norm_cpu_transform_stub);
+
 }} // at::native
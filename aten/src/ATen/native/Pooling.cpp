@@ -120,6 +120,12 @@ Tensor max_pool2d(
   }
   auto output_and_indices = at::max_pool2d_with_indices(
       self, kernel_size, stride, padding, dilation, ceil_mode);
+  // The THNN kernels compute in contiguous layout; hand a channels last
+  // input its result back in channels last format.
+  auto memory_format = self.suggest_memory_format();
+  if (memory_format != MemoryFormat::Contiguous) {
+    return std::get<0>(output_and_indices).contiguous(memory_format);
+  }
   return std::get<0>(output_and_indices);
 }
 
@@ -2,6 +2,8 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/native/cpu/RNNKernel.h>
 
 namespace at { namespace native {
 
@@ -171,6 +173,19 @@ static std::vector<CellParams> gather_params(TensorList params, bool has_biases)
   return result;
 }
 
+// The input projections of a layer do not depend on the hidden state, so on
+// CPU they are computed for all timesteps at once by a single GEMM, and the
+// cells are handed the projected inputs. Quantized weights are excluded:
+// they pick the input quantization parameters per call, so projecting the
+// whole sequence at once would change the results.
+static bool can_pre_compute_input(const Tensor& input, const CellParams& params) {
+  return input.device().is_cpu();
+}
+
+static bool can_pre_compute_input(const Tensor& input, const QuantizedCellParams& params) {
+  return false;
+}
+
 static std::vector<QuantizedCellParams> gather_quantized_params(TensorList params) {
   static at::Tensor undefined;
   std::vector<QuantizedCellParams> result;
@@ -229,6 +244,7 @@ tpair_of<Tensor> hidden_slice(const tpair_of<Tensor>& t, int64_t start, int64_t
 // (Tensor input, hidden_type hidden, CellParams) -> hidden_type
 //
 // which means that it consumes an input tensor, and updates the previous hidden state.
+// With pre_compute_input, the input tensor already holds params.linear_ih(input).
 // It's a struct only because functional programming in C++ is a pain, and it's easier
 // to pass around "vtable pointers" than actual function pointers.
 
@@ -237,14 +253,17 @@ struct Cell {
   using hidden_type = hidden_type_tmpl;
   using cell_params = cell_params_tmpl;
   virtual ~Cell() {} // This is really dumb, but enables projects with -Wnon-virtual-dtor to compile...
-  virtual hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params) const = 0;
+  virtual hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params,
+                                 bool pre_compute_input = false) const = 0;
 };
 
 template<typename nonlinearity, typename cell_params>
 struct SimpleCell : Cell<Tensor, cell_params> {
   using hidden_type = Tensor;
-  Tensor operator()(const Tensor& input, const Tensor& hidden, const cell_params& params) const override {
-    return nonlinearity{}(params.linear_ih(input) + params.linear_hh(hidden));
+  Tensor operator()(const Tensor& input, const Tensor& hidden, const cell_params& params,
+                    bool pre_compute_input = false) const override {
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    return nonlinearity{}(igates + params.linear_hh(hidden));
   }
 };
 
@@ -252,11 +271,12 @@ struct SimpleCell : Cell<Tensor, cell_params> {
 template <typename cell_params>
 struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
   using hidden_type = std::tuple<Tensor, Tensor>;
-  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params) const override {
+  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params,
+                         bool pre_compute_input = false) const override {
     auto hx = std::get<0>(hidden);
     auto cx = std::get<1>(hidden);
 
-    if (input.is_cuda()) {
+    if (input.is_cuda() && !pre_compute_input) {
       auto igates = params.matmul_ih(input);
       auto hgates = params.matmul_hh(hx);
       auto result = at::_thnn_fused_lstm_cell(igates, hgates, cx, params.b_ih, params.b_hh);
@@ -264,7 +284,14 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
       return std::make_tuple(std::get<0>(result), std::get<1>(result));
     }
 
-    auto gates = params.linear_ih(input) + params.linear_hh(hx);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    if (input.device().is_cpu()) {
+      // The biases are already part of both projections.
+      auto result = at::_thnn_fused_lstm_cell(igates, params.linear_hh(hx), cx);
+      return std::make_tuple(std::get<0>(result), std::get<1>(result));
+    }
+
+    auto gates = igates + params.linear_hh(hx);
     auto chunked_gates = gates.chunk(4, 1);
 
     auto ingate = chunked_gates[0].sigmoid();
@@ -282,8 +309,9 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
 template <typename cell_params>
 struct GRUCell : Cell<Tensor, cell_params> {
   using hidden_type = Tensor;
-  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params) const override {
-    if (input.is_cuda()) {
+  hidden_type operator()(const Tensor& input, const hidden_type& hidden, const cell_params& params,
+                         bool pre_compute_input = false) const override {
+    if (input.is_cuda() && !pre_compute_input) {
       auto igates = params.matmul_ih(input);
       auto hgates = params.matmul_hh(hidden);
       auto result = at::_thnn_fused_gru_cell(igates, hgates, hidden, params.b_ih, params.b_hh);
@@ -291,8 +319,12 @@ struct GRUCell : Cell<Tensor, cell_params> {
       return std::get<0>(result);
     }
 
-    auto igates = params.linear_ih(input);
-    auto hgates = params.linear_hh(hidden);
+    const auto igates = pre_compute_input ? input : params.linear_ih(input);
+    const auto hgates = params.linear_hh(hidden);
+    if (input.device().is_cpu()) {
+      return std::get<0>(at::_thnn_fused_gru_cell(igates, hgates, hidden));
+    }
+
     auto chunked_igates = igates.chunk(3, 1);
     auto chunked_hgates = hgates.chunk(3, 1);
 
@@ -336,18 +368,21 @@ struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
   FullLayer(Cell<hidden_type, cell_params>& cell)
     : cell_(cell) {};
 
-  unstacked_output_type operator()(std::vector<Tensor> step_inputs, const hidden_type& input_hidden, const cell_params& params) const {
+  unstacked_output_type operator()(std::vector<Tensor> step_inputs, const hidden_type& input_hidden, const cell_params& params,
+                                   bool pre_compute_input = false) const {
     std::vector<Tensor> step_outputs;
     auto hidden = input_hidden;
     for (size_t i = 0; i < step_inputs.size(); i++) {
-      hidden = cell_(step_inputs[i], hidden, params);
+      hidden = cell_(step_inputs[i], hidden, params, pre_compute_input);
       step_outputs.push_back(hidden_as_output(hidden));
     }
     return {step_outputs, hidden};
   }
 
   output_type operator()(const Tensor& inputs, const hidden_type& input_hidden, const cell_params& params) const override {
-    auto unstacked_output = (*this)(inputs.unbind(0), input_hidden, params);
+    const bool pre_compute_input = can_pre_compute_input(inputs, params);
+    const auto cell_inputs = pre_compute_input ? params.linear_ih(inputs) : inputs;
+    auto unstacked_output = (*this)(cell_inputs.unbind(0), input_hidden, params, pre_compute_input);
     return {at::stack(unstacked_output.outputs, 0), unstacked_output.final_hidden};
   }
 
@@ -364,12 +399,16 @@ struct FullBidirectionalLayer : Layer<Tensor, pair_of<dir_hidden_type>, pair_of<
     : layer_(cell) {};
 
   output_type operator()(const Tensor& input, const hidden_type& input_hidden, const param_type& params) const override {
-    auto step_inputs = input.unbind(0);
-    auto fw_result = layer_(step_inputs, input_hidden.first, params.first);
+    const bool pre_compute_input = can_pre_compute_input(input, params.first);
+    auto step_inputs = pre_compute_input ? params.first.linear_ih(input).unbind(0) : input.unbind(0);
+    auto fw_result = layer_(step_inputs, input_hidden.first, params.first, pre_compute_input);
     auto fw_output = at::stack(fw_result.outputs, 0);
 
+    if (pre_compute_input) {
+      step_inputs = params.second.linear_ih(input).unbind(0);
+    }
     auto rev_step_inputs = reverse(std::move(step_inputs));
-    auto rev_result = layer_(rev_step_inputs, input_hidden.second, params.second);
+    auto rev_result = layer_(rev_step_inputs, input_hidden.second, params.second, pre_compute_input);
     std::reverse(rev_result.outputs.begin(), rev_result.outputs.end());
     auto rev_output = at::stack(rev_result.outputs, 0);
 
@@ -399,6 +438,8 @@ struct PackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
     int64_t num_steps = input.batch_sizes.size(0);
     int64_t* batch_sizes = input.batch_sizes.data<int64_t>();
     int64_t last_batch_size = batch_sizes[0];
+    const bool pre_compute_input = can_pre_compute_input(input.data, params);
+    const auto cell_inputs = pre_compute_input ? params.linear_ih(input.data) : input.data;
 
     // Batch sizes is a sequence of decreasing lengths, which are offsets
     // into a 1D list of inputs. At every step we slice out batch_size elements,
@@ -409,7 +450,7 @@ struct PackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
     auto hidden = input_hidden;
     for (int64_t i = 0; i < num_steps; ++i) {
       int64_t batch_size = batch_sizes[i];
-      auto step_input = input.data.narrow(0, input_offset, batch_size);
+      auto step_input = cell_inputs.narrow(0, input_offset, batch_size);
       input_offset += batch_size;
 
       int64_t dec = last_batch_size - batch_size;
@@ -419,7 +460,7 @@ struct PackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
       }
 
       last_batch_size = batch_size;
-      hidden = cell_(step_input, hidden, params);
+      hidden = cell_(step_input, hidden, params, pre_compute_input);
       step_outputs.push_back(hidden_as_output(hidden));
     }
     hiddens.push_back(hidden);
@@ -444,6 +485,8 @@ struct ReversedPackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
     int64_t num_steps = input.batch_sizes.size(0);
     int64_t* batch_sizes = input.batch_sizes.data<int64_t>();
     int64_t last_batch_size = batch_sizes[num_steps - 1];
+    const bool pre_compute_input = can_pre_compute_input(input.data, params);
+    const auto cell_inputs = pre_compute_input ? params.linear_ih(input.data) : input.data;
 
     // Here the situation is similar to that above, except we start out with
     // the smallest batch size (and a small set of hidden states we actually use),
@@ -457,11 +500,11 @@ struct ReversedPackedLayer : Layer<PackedSequence, hidden_type, cell_params> {
         hidden = hidden_concat(ArrayRef<hidden_type>{hidden, hidden_slice(input_hidden, last_batch_size, batch_size)});
       }
 
-      auto step_input = input.data.narrow(0, input_offset - batch_size, batch_size);
+      auto step_input = cell_inputs.narrow(0, input_offset - batch_size, batch_size);
       input_offset -= batch_size;
 
       last_batch_size = batch_size;
-      hidden = cell_(step_input, hidden, params);
+      hidden = cell_(step_input, hidden, params, pre_compute_input);
       step_outputs.push_back(hidden_as_output(hidden));
     }
     std::reverse(step_outputs.begin(), step_outputs.end());
@@ -592,8 +635,134 @@ std::tuple<io_type, Tensor, Tensor> _lstm_impl(
   return std::make_tuple(result.outputs, at::stack(hy, 0), at::stack(cy, 0));
 }
 
+// Factor is 3 for GRU and 4 for LSTM
+void check_fused_cell_sizes(CheckedFrom c,
+                            const TensorArg& input_gates, const TensorArg& hidden_gates,
+                            const TensorArg& input_bias, const TensorArg& hidden_bias,
+                            int64_t factor, const TensorArg& prev_hidden) {
+  checkDim(c, input_gates, 2);
+  checkSameSize(c, input_gates, hidden_gates);
+  int64_t gates_size = input_gates->size(1);
+
+  if (input_bias->defined()) {
+    checkDim(c, input_bias, 1);
+    checkNumel(c, input_bias, gates_size);
+    checkSameSize(c, input_bias, hidden_bias);
+  }
+
+  checkDim(c, prev_hidden, 2);
+  checkSize(c, prev_hidden, {input_gates->size(0), gates_size / factor});
+  AT_CHECK(gates_size == prev_hidden->size(1) * factor,
+           "Expected ", factor, " gates per hidden feature (while checking arguments for ", c, ")");
+
+  checkAllSameType(c, {input_gates, hidden_gates, input_bias, hidden_bias, prev_hidden});
+}
+
+Tensor contiguous_if_defined(const Tensor& t) {
+  return t.defined() ? t.contiguous() : t;
+}
+
 } // anonymous namespace
 
+////////////////////////////////////////////////////////////////////////////////
+// FUSED CELL KERNELS
+//
+// CPU counterparts of the fused CUDA cells in cuda/RNN.cu. They share their
+// workspace layouts, and thus the derivative formulas in derivatives.yaml.
+////////////////////////////////////////////////////////////////////////////////
+
+DEFINE_DISPATCH(lstm_cell_fused_stub);
+DEFINE_DISPATCH(lstm_cell_fused_backward_stub);
+DEFINE_DISPATCH(gru_cell_fused_stub);
+DEFINE_DISPATCH(gru_cell_fused_backward_stub);
+
+std::tuple<Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& cx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_lstm_cell_cpu",
+                         {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+                         {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+                         /*factor=*/4, {cx, "prev_hidden", 5});
+
+  auto workspace = at::empty_like(input_gates);
+  auto hy = at::empty_like(cx);
+  auto cy = at::empty_like(cx);
+  lstm_cell_fused_stub(kCPU, hy, cy, workspace, input_gates.contiguous(), hidden_gates.contiguous(),
+                       contiguous_if_defined(input_bias), contiguous_if_defined(hidden_bias),
+                       cx.contiguous());
+  return std::make_tuple(hy, cy, workspace);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_lstm_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& grad_cy,
+      const Tensor& cx, const Tensor& cy,
+      const Tensor& workspace, bool has_bias) {
+  CheckedFrom c = "_thnn_fused_lstm_cell_backward_cpu";
+  AT_CHECK(grad_hy.defined() || grad_cy.defined(), c, ": expected grad_hy or grad_cy to be defined");
+  const TensorArg cx_arg{cx, "cx", 3};
+  checkDim(c, cx_arg, 2);
+  if (grad_hy.defined()) {
+    checkSize(c, TensorArg{grad_hy, "grad_hy", 1}, cx.sizes());
+  }
+  if (grad_cy.defined()) {
+    checkSize(c, TensorArg{grad_cy, "grad_cy", 2}, cx.sizes());
+  }
+  checkSize(c, TensorArg{cy, "cy", 4}, cx.sizes());
+  checkSize(c, TensorArg{workspace, "workspace", 5}, {cx.size(0), cx.size(1) * 4});
+
+  auto grad_gates = at::empty_like(workspace);
+  auto grad_cx = at::empty_like(cx);
+  lstm_cell_fused_backward_stub(kCPU, grad_gates, grad_cx, contiguous_if_defined(grad_hy),
+                                contiguous_if_defined(grad_cy), cx.contiguous(), cy.contiguous(),
+                                workspace.contiguous());
+
+  auto grad_bias = has_bias ? grad_gates.sum(0, /*keepdim=*/false) : at::Tensor{};
+  return std::make_tuple(grad_gates, grad_gates, grad_cx, grad_bias, grad_bias);
+}
+
+static constexpr int64_t GRU_WORKSPACE_MULTIPLIER = 5;
+
+std::tuple<Tensor, Tensor> _thnn_fused_gru_cell_cpu(
+      const Tensor& input_gates, const Tensor& hidden_gates,
+      const Tensor& hx,
+      const Tensor& input_bias, const Tensor& hidden_bias) {
+  check_fused_cell_sizes("_thnn_fused_gru_cell_cpu",
+                         {input_gates, "input_gates", 1}, {hidden_gates, "hidden_gates", 2},
+                         {input_bias, "input_bias", 3}, {hidden_bias, "hidden_bias", 4},
+                         /*factor=*/3, {hx, "prev_hidden", 5});
+
+  auto workspace = at::empty({hx.size(0), hx.size(1) * GRU_WORKSPACE_MULTIPLIER}, hx.options());
+  auto hy = at::empty_like(hx);
+  gru_cell_fused_stub(kCPU, hy, workspace, input_gates.contiguous(), hidden_gates.contiguous(),
+                      contiguous_if_defined(input_bias), contiguous_if_defined(hidden_bias),
+                      hx.contiguous());
+  return std::make_tuple(hy, workspace);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _thnn_fused_gru_cell_backward_cpu(
+      const Tensor& grad_hy, const Tensor& workspace, bool has_bias) {
+  CheckedFrom c = "_thnn_fused_gru_cell_backward_cpu";
+  const TensorArg grad_hy_arg{grad_hy, "grad_hy", 1};
+  checkDim(c, grad_hy_arg, 2);
+  checkSize(c, TensorArg{workspace, "workspace", 2}, {grad_hy.size(0), grad_hy.size(1) * GRU_WORKSPACE_MULTIPLIER});
+
+  int64_t hidden_size = grad_hy.size(1);
+  auto grad_input_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hidden_gates = at::empty({workspace.size(0), hidden_size * 3}, workspace.options());
+  auto grad_hx = at::empty_like(grad_hy);
+  gru_cell_fused_backward_stub(kCPU, grad_input_gates, grad_hidden_gates, grad_hx,
+                               grad_hy.contiguous(), workspace.contiguous());
+
+  at::Tensor grad_input_bias, grad_hidden_bias;
+  if (has_bias) {
+    grad_input_bias = grad_input_gates.sum(0, /*keepdim=*/false);
+    grad_hidden_bias = grad_hidden_gates.sum(0, /*keepdim=*/false);
+  }
+
+  return std::make_tuple(grad_input_gates, grad_hidden_gates, grad_hx, grad_input_bias, grad_hidden_bias);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // PUBLIC FUNCTIONS
 ////////////////////////////////////////////////////////////////////////////////
@@ -749,6 +918,49 @@ std::tuple<Tensor, Tensor, Tensor> quantized_lstm(
   return results;
 }
 
+std::tuple<Tensor, Tensor, Tensor> quantized_lstm(
+      const Tensor& data, const Tensor& batch_sizes, TensorList hx,
+      TensorList _params, bool has_biases,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional) {
+  AT_CHECK(hx.size() == 2, "lstm expects two hidden states");
+  AT_CHECK(has_biases, "quantized LSTM requires biases");
+  PackedSequence input { data, batch_sizes };
+  auto params = gather_quantized_params(_params);
+  auto result = _lstm_impl<PackedLayer, PackedBidirectionalLayer>(
+      input, params, hx[0], hx[1], num_layers, dropout_p, train, bidirectional);
+  auto & packed_output = std::get<0>(result);
+  return std::make_tuple(packed_output.data, std::get<1>(result), std::get<2>(result));
+}
+
+std::tuple<Tensor, Tensor> quantized_gru(
+      const Tensor& _input, const Tensor& hx,
+      TensorList _params, bool has_biases,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional, bool batch_first) {
+  check_device(_input, _params, hx);
+  auto input = batch_first ? _input.transpose(0, 1) : _input;
+  AT_CHECK(has_biases, "quantized GRU requires biases");
+  auto params = gather_quantized_params(_params);
+  auto results = _rnn_impl_with_concat<GRUCell<QuantizedCellParams>, FullLayer, FullBidirectionalLayer>(
+      input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+  if (batch_first) {
+    std::get<0>(results) = std::get<0>(results).transpose(0, 1);
+  }
+  return results;
+}
+
+std::tuple<Tensor, Tensor> quantized_gru(
+      const Tensor& data, const Tensor& batch_sizes, const Tensor& hx,
+      TensorList _params, bool has_biases,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional) {
+  AT_CHECK(has_biases, "quantized GRU requires biases");
+  PackedSequence input { data, batch_sizes };
+  auto params = gather_quantized_params(_params);
+  auto result = _rnn_impl_with_concat<GRUCell<QuantizedCellParams>, PackedLayer, PackedBidirectionalLayer>(
+      input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+  auto & packed_output = std::get<0>(result);
+  return std::make_tuple(packed_output.data, std::get<1>(result));
+}
+
 #define DEFINE_QUANTIZED_RNN_CELL(name, hx_type, cell_type, return_type, prepare_hx_fn) \
 return_type name( \
     const Tensor& input, \
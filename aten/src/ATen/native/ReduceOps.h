@@ -19,7 +19,10 @@ DECLARE_DISPATCH(reduce_fn, and_stub);
 DECLARE_DISPATCH(reduce_fn, or_stub);
 DECLARE_DISPATCH(reduce_fn, min_values_stub);
 DECLARE_DISPATCH(reduce_fn, max_values_stub);
+DECLARE_DISPATCH(reduce_fn, aminmax_stub);
 
+// The iterator has either one output (std or var) or two outputs, the second
+// of which receives the mean.
 using reduce_std_var_function =
   void (*)(TensorIterator&, bool unbiased, bool take_sqrt);
 DECLARE_DISPATCH(reduce_std_var_function, std_var_stub);
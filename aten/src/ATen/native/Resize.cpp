@@ -10,4 +10,9 @@ Tensor& resize_cpu_(Tensor& self, IntArrayRef size) {
   return self;
 }
 
+Tensor& reserve_cpu_(Tensor& self, int64_t capacity) {
+  reserve_storage_cpu(self.unsafeGetTensorImpl(), capacity);
+  return self;
+}
+
 }}
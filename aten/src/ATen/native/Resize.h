@@ -9,6 +9,20 @@ namespace at { namespace native {
 // They are not in TH/THTensor.cpp because the at namespace is easier
 // to benchmark than TH; I can't get gbenchmark to call fns from THTensor.cpp
 
+// Storage of tensors that have space reserved (see reserve_) grows by at least
+// this much, so that appending to them by repeated resize_ is amortized O(1).
+static constexpr float kReservedGrowthPct = 50;
+
+// Returns the number of elements the storage of `self` should be resized to so
+// that it can hold `new_size` elements past the storage offset.
+static inline int64_t storage_size_for_resize(TensorImpl* self, int64_t new_size) {
+  int64_t required = new_size + self->storage_offset();
+  if (!self->reserved()) {
+    return required;
+  }
+  return c10::grown_capacity(self->storage().numel(), required, kReservedGrowthPct);
+}
+
 static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size) {
   if (new_size + self->storage_offset() > 0) {
     if (!THTensor_getStoragePtr(self)) {
@@ -17,7 +31,7 @@ static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size)
     if (new_size + self->storage_offset() > self->storage().numel()) {
       THStorage_resize(
           THTensor_getStoragePtr(self),
-          new_size + self->storage_offset());
+          storage_size_for_resize(self, new_size));
     }
   }
 }
@@ -52,6 +66,23 @@ inline TensorImpl* resize_impl_cpu_(
   return self;
 }
 
+// Makes sure the storage of `self` holds at least `capacity` elements past
+// the storage offset, and makes later resizes of `self` grow it geometrically.
+static inline void reserve_storage_cpu(TensorImpl* self, int64_t capacity) {
+  AT_CHECK(capacity >= 0, "reserve_: capacity must be non-negative, but got ", capacity);
+  if (capacity + self->storage_offset() > 0) {
+    if (!THTensor_getStoragePtr(self)) {
+      THTensor_stealAndSetStoragePtr(self, THStorage_new(self->dtype()));
+    }
+    if (capacity + self->storage_offset() > self->storage().numel()) {
+      THStorage_resize(
+          THTensor_getStoragePtr(self),
+          capacity + self->storage_offset());
+    }
+  }
+  self->set_reserved(true);
+}
+
 static inline void checkInBoundsForStorage(
     IntArrayRef size,
     IntArrayRef stride,
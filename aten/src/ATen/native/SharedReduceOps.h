@@ -42,7 +42,9 @@ struct WelfordData {
 };
 
 
-template <typename scalar_t, typename acc_scalar_t, typename index_t, typename combine_t>
+// project returns res_t {var or std, mean}; a reduction with a single output
+// keeps only the first element.
+template <typename scalar_t, typename acc_scalar_t, typename index_t, typename combine_t, typename res_t>
 struct WelfordOps {
   bool unbiased;
   bool take_sqrt;
@@ -80,12 +82,12 @@ struct WelfordOps {
       new_count
     };
   }
-  inline C10_DEVICE scalar_t project(acc_t acc) const {
+  inline C10_DEVICE res_t project(acc_t acc) const {
     combine_t divisor = unbiased ? (acc.nf - 1) : acc.nf;
     auto ret = (divisor > 0) ?
       (take_sqrt ? device_sqrt(acc.m2 / divisor) : (acc.m2 / divisor))
       : NAN;
-    return (scalar_t) ret;
+    return res_t((scalar_t) ret, (scalar_t) acc.mean);
   }
 #if defined(__CUDACC__) || defined(__HIPCC__)
   inline __device__ acc_t warp_shfl_down(acc_t acc, int offset) const {
@@ -102,6 +104,31 @@ struct WelfordOps {
   }
 };
 
+// Computes the minimum and the maximum in one pass; acc_t is a pair of
+// scalar_t holding {min, max}. NaNs propagate to both results.
+template <typename scalar_t, typename acc_t>
+struct MinMaxOps {
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data) const {
+    return combine(acc, acc_t(data, data));
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return acc_t(
+      (a.first != a.first || a.first < b.first) ? a.first : b.first,
+      (a.second != a.second || a.second > b.second) ? a.second : b.second);
+  }
+
+  inline C10_DEVICE acc_t project(acc_t acc) const {
+    return acc;
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t acc, int offset) const {
+    return acc_t(WARP_SHFL_DOWN(acc.first, offset), WARP_SHFL_DOWN(acc.second, offset));
+  }
+#endif
+};
+
 template <typename acc_t, typename factor_t>
 struct MeanOps {
   factor_t factor;
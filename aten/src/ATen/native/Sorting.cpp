@@ -1,9 +1,19 @@
 #include <ATen/ATen.h>
+#include <ATen/LegacyTHFunctions.h>
 #include <ATen/NumericUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace at {
 namespace native {
 
@@ -125,6 +135,371 @@ void quick_select_template(
   } while (1);
 }
 
+// Like dim_apply, but calls f(offsets, scratch) with the element offset of
+// each slice in each tensor instead of narrowing the tensors, which costs
+// more than sorting a short slice. scratch is shared by the slices of a
+// parallel chunk, so that buffers are allocated once per chunk. When a single
+// chunk covers all slices, f runs outside of a parallel region, so that it
+// can parallelize within a slice.
+template <typename Scratch, typename Fn>
+void dim_apply_offsets(TensorList tensors, int64_t dim, const Fn& f) {
+  AT_ASSERT(tensors.size() > 0);
+  auto sizes = tensors[0].sizes();
+  int64_t ndim = tensors[0].dim();
+  int64_t itersize = 1;
+  for (int64_t i = 0; i < ndim; i++) {
+    if (i != dim) {
+      itersize *= sizes[i];
+    }
+  }
+  const int64_t grain_size = std::max<int64_t>(
+      1, internal::GRAIN_SIZE / std::max<int64_t>(1, sizes[dim]));
+  auto apply = [&](int64_t i_begin, int64_t i_end) {
+    Scratch scratch;
+    std::vector<int64_t> offsets(tensors.size());
+    for (int64_t it = i_begin; it < i_end; it++) {
+      for (size_t ti = 0; ti < tensors.size(); ti++) {
+        int64_t i = it;
+        int64_t offset = 0;
+        for (int64_t d = 0; d < ndim; d++) {
+          if (d != dim) {
+            offset += (i % sizes[d]) * tensors[ti].stride(d);
+            i = i / sizes[d];
+          }
+        }
+        offsets[ti] = offset;
+      }
+      f(offsets.data(), scratch);
+    }
+  };
+  if (itersize <= grain_size) {
+    apply(0, itersize);
+  } else {
+    parallel_for(0, itersize, grain_size, apply);
+  }
+}
+
+// Slices at least this long are sorted with a radix sort on the bit
+// patterns of the values rather than with std::sort
+constexpr int64_t RADIX_SORT_MIN_SIZE = 4096;
+// Slices at least this long are split into chunks that select top-k
+// candidates in parallel, when not already in a parallel region
+constexpr int64_t PARALLEL_TOPK_MIN_SIZE = 65536;
+// Top-k of at most a slice's size / TOPK_HEAP_RATIO elements keeps a heap of
+// the k best elements; larger k partitions a copy of the slice
+constexpr int64_t TOPK_HEAP_RATIO = 16;
+
+template <typename scalar_t>
+struct SortScratch {
+  std::vector<std::pair<scalar_t, int64_t>> pairs;
+  std::vector<scalar_t> values;
+  std::vector<typename std::make_unsigned<
+      typename std::conditional<
+          std::is_floating_point<scalar_t>::value,
+          typename std::conditional<sizeof(scalar_t) == 4, int32_t, int64_t>::
+              type,
+          scalar_t>::type>::type>
+      keys, keys_tmp;
+  std::vector<int64_t> indices, indices_tmp;
+};
+
+// Maps values to unsigned keys with the same order, NaN being the largest
+// value as in the comparison sort
+template <
+    typename scalar_t,
+    typename std::enable_if<std::is_integral<scalar_t>::value, int>::type = 0>
+typename std::make_unsigned<scalar_t>::type radix_key(scalar_t x) {
+  using key_t = typename std::make_unsigned<scalar_t>::type;
+  key_t key = static_cast<key_t>(x);
+  if (std::is_signed<scalar_t>::value) {
+    key ^= key_t(1) << (sizeof(key_t) * 8 - 1);
+  }
+  return key;
+}
+
+inline uint32_t radix_key(float x) {
+  if (std::isnan(x)) {
+    return std::numeric_limits<uint32_t>::max();
+  }
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+inline uint64_t radix_key(double x) {
+  if (std::isnan(x)) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  return (bits & 0x8000000000000000ull) ? ~bits
+                                        : (bits | 0x8000000000000000ull);
+}
+
+// Stable LSD radix sort of keys and their indices, one byte per pass;
+// passes in which all keys have the same byte are skipped
+template <typename key_t>
+void radix_sort(
+    std::vector<key_t>& keys,
+    std::vector<int64_t>& indices,
+    std::vector<key_t>& keys_tmp,
+    std::vector<int64_t>& indices_tmp) {
+  constexpr int num_passes = sizeof(key_t);
+  const int64_t n = keys.size();
+  std::array<int64_t, num_passes * 256> counts{};
+  for (int64_t i = 0; i < n; i++) {
+    for (int pass = 0; pass < num_passes; pass++) {
+      counts[pass * 256 + ((keys[i] >> (8 * pass)) & 0xff)]++;
+    }
+  }
+  keys_tmp.resize(n);
+  indices_tmp.resize(n);
+  for (int pass = 0; pass < num_passes; pass++) {
+    int64_t* count = &counts[pass * 256];
+    if (count[(keys[0] >> (8 * pass)) & 0xff] == n) {
+      continue;
+    }
+    int64_t offset = 0;
+    for (int digit = 0; digit < 256; digit++) {
+      const int64_t c = count[digit];
+      count[digit] = offset;
+      offset += c;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      const int64_t pos = count[(keys[i] >> (8 * pass)) & 0xff]++;
+      keys_tmp[pos] = keys[i];
+      indices_tmp[pos] = indices[i];
+    }
+    keys.swap(keys_tmp);
+    indices.swap(indices_tmp);
+  }
+}
+
+// Sorts a strided slice of n values into values_data and indices_data. The
+// slice is read completely before the results are written, so values may
+// alias the input.
+template <typename scalar_t>
+void sort_slice(
+    const scalar_t* self_data,
+    int64_t self_stride,
+    int64_t n,
+    bool descending,
+    scalar_t* values_data,
+    int64_t values_stride,
+    int64_t* indices_data,
+    int64_t indices_stride,
+    SortScratch<scalar_t>& scratch) {
+  if (n >= RADIX_SORT_MIN_SIZE) {
+    using key_t = typename decltype(scratch.keys)::value_type;
+    auto& keys = scratch.keys;
+    auto& indices = scratch.indices;
+    auto& values = scratch.values;
+    keys.resize(n);
+    indices.resize(n);
+    values.resize(n);
+    for (int64_t i = 0; i < n; i++) {
+      values[i] = self_data[i * self_stride];
+      const key_t key = radix_key(values[i]);
+      keys[i] = descending ? static_cast<key_t>(~key) : key;
+      indices[i] = i;
+    }
+    radix_sort(keys, indices, scratch.keys_tmp, scratch.indices_tmp);
+    for (int64_t i = 0; i < n; i++) {
+      values_data[i * values_stride] = values[indices[i]];
+      indices_data[i * indices_stride] = indices[i];
+    }
+    return;
+  }
+
+  auto& pairs = scratch.pairs;
+  pairs.resize(n);
+  for (int64_t i = 0; i < n; i++) {
+    pairs[i] = std::make_pair(self_data[i * self_stride], i);
+  }
+  // we want NaN to be sorted as top for numpy compatibility
+  auto gt_or_nan = [](scalar_t x, scalar_t y) -> bool {
+    return (_isnan<scalar_t>(x) && !_isnan<scalar_t>(y)) || (x > y);
+  };
+  if (descending) {
+    std::sort(
+        pairs.begin(),
+        pairs.end(),
+        [&](const std::pair<scalar_t, int64_t>& a,
+            const std::pair<scalar_t, int64_t>& b) {
+          return gt_or_nan(a.first, b.first);
+        });
+  } else {
+    std::sort(
+        pairs.begin(),
+        pairs.end(),
+        [&](const std::pair<scalar_t, int64_t>& a,
+            const std::pair<scalar_t, int64_t>& b) {
+          return gt_or_nan(b.first, a.first);
+        });
+  }
+  for (int64_t i = 0; i < n; i++) {
+    values_data[i * values_stride] = pairs[i].first;
+    indices_data[i * indices_stride] = pairs[i].second;
+  }
+}
+
+// Appends the k elements of [begin, end) of a strided slice that come first
+// in the order of before (or the whole range if it is shorter) to
+// candidates, in no particular order
+template <typename scalar_t, typename Before>
+void topk_candidates(
+    const scalar_t* self_data,
+    int64_t self_stride,
+    int64_t begin,
+    int64_t end,
+    int64_t k,
+    const Before& before,
+    std::vector<std::pair<scalar_t, int64_t>>& candidates) {
+  const auto first = candidates.size();
+  const int64_t n = end - begin;
+  if (k == 0) {
+    return;
+  }
+  if (k * TOPK_HEAP_RATIO <= n) {
+    // A heap with the worst of the k best elements seen so far on top; most
+    // elements of a long slice are rejected by a single comparison
+    for (int64_t i = begin; i < begin + k; i++) {
+      candidates.emplace_back(self_data[i * self_stride], i);
+    }
+    auto heap_begin = candidates.begin() + first;
+    std::make_heap(heap_begin, candidates.end(), before);
+    for (int64_t i = begin + k; i < end; i++) {
+      const scalar_t x = self_data[i * self_stride];
+      if (before(std::make_pair(x, i), *heap_begin)) {
+        std::pop_heap(heap_begin, candidates.end(), before);
+        candidates.back() = std::make_pair(x, i);
+        std::push_heap(heap_begin, candidates.end(), before);
+      }
+    }
+    return;
+  }
+  for (int64_t i = begin; i < end; i++) {
+    candidates.emplace_back(self_data[i * self_stride], i);
+  }
+  if (k < n) {
+    std::nth_element(
+        candidates.begin() + first,
+        candidates.begin() + first + k,
+        candidates.end(),
+        before);
+    candidates.resize(first + k);
+  }
+}
+
+template <typename scalar_t, typename Comp>
+void topk_slice_impl(
+    const scalar_t* self_data,
+    int64_t self_stride,
+    int64_t n,
+    int64_t k,
+    bool sorted,
+    const Comp& comp,
+    scalar_t* values_data,
+    int64_t values_stride,
+    int64_t* indices_data,
+    int64_t indices_stride,
+    SortScratch<scalar_t>& scratch) {
+  auto before = [&](const std::pair<scalar_t, int64_t>& a,
+                    const std::pair<scalar_t, int64_t>& b) {
+    return comp(a.first, b.first);
+  };
+  auto& candidates = scratch.pairs;
+  candidates.clear();
+  const int64_t num_chunks = std::min<int64_t>(
+      get_num_threads(), n / (PARALLEL_TOPK_MIN_SIZE / 2));
+  if (n >= PARALLEL_TOPK_MIN_SIZE && num_chunks > 1 && !in_parallel_region() &&
+      k * TOPK_HEAP_RATIO <= n / num_chunks) {
+    // Each chunk of the slice picks its own k candidates, and the top-k is
+    // picked among those
+    std::vector<std::vector<std::pair<scalar_t, int64_t>>> chunk_candidates(
+        num_chunks);
+    const int64_t chunk_size = divup(n, num_chunks);
+    parallel_for(0, num_chunks, 1, [&](int64_t c_begin, int64_t c_end) {
+      for (int64_t c = c_begin; c < c_end; c++) {
+        topk_candidates(
+            self_data,
+            self_stride,
+            c * chunk_size,
+            std::min(n, (c + 1) * chunk_size),
+            k,
+            before,
+            chunk_candidates[c]);
+      }
+    });
+    for (const auto& c : chunk_candidates) {
+      candidates.insert(candidates.end(), c.begin(), c.end());
+    }
+    if ((int64_t)candidates.size() > k) {
+      std::nth_element(
+          candidates.begin(), candidates.begin() + k, candidates.end(), before);
+      candidates.resize(k);
+    }
+  } else {
+    topk_candidates(self_data, self_stride, 0, n, k, before, candidates);
+  }
+  if (sorted) {
+    std::sort(candidates.begin(), candidates.end(), before);
+  }
+  for (int64_t i = 0; i < k; i++) {
+    values_data[i * values_stride] = candidates[i].first;
+    indices_data[i * indices_stride] = candidates[i].second;
+  }
+}
+
+// Writes the k largest (or smallest) values of a strided slice of n values
+// and their indices, in order if sorted is true. NaN is the largest value,
+// as in sort.
+template <typename scalar_t>
+void topk_slice(
+    const scalar_t* self_data,
+    int64_t self_stride,
+    int64_t n,
+    int64_t k,
+    bool largest,
+    bool sorted,
+    scalar_t* values_data,
+    int64_t values_stride,
+    int64_t* indices_data,
+    int64_t indices_stride,
+    SortScratch<scalar_t>& scratch) {
+  if (largest) {
+    topk_slice_impl(
+        self_data,
+        self_stride,
+        n,
+        k,
+        sorted,
+        [](scalar_t x, scalar_t y) -> bool {
+          return (_isnan<scalar_t>(x) && !_isnan<scalar_t>(y)) || (x > y);
+        },
+        values_data,
+        values_stride,
+        indices_data,
+        indices_stride,
+        scratch);
+  } else {
+    topk_slice_impl(
+        self_data,
+        self_stride,
+        n,
+        k,
+        sorted,
+        [](scalar_t x, scalar_t y) -> bool {
+          return (_isnan<scalar_t>(y) && !_isnan<scalar_t>(x)) || (x < y);
+        },
+        values_data,
+        values_stride,
+        indices_data,
+        indices_stride,
+        scratch);
+  }
+}
+
 } // namespace
 
 std::tuple<Tensor&, Tensor&> kthvalue_out_cpu(
@@ -190,6 +565,129 @@ std::tuple<Tensor&, Tensor&> kthvalue_out_cpu(
   return std::forward_as_tuple(values, indices);
 }
 
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  _sort_allocate_or_resize_output(values, indices, self, self.sizes());
+  if (self.dim() == 0) {
+    values.copy_(self);
+    indices.zero_();
+    return std::forward_as_tuple(values, indices);
+  }
+  if (self.numel() == 0) {
+    return std::forward_as_tuple(values, indices);
+  }
+  const int64_t slice_size = self.size(dim);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "sort_cpu", [&] {
+    const scalar_t* self_data = self.data<scalar_t>();
+    scalar_t* values_data = values.data<scalar_t>();
+    int64_t* indices_data = indices.data<int64_t>();
+    const int64_t self_stride = self.stride(dim);
+    const int64_t values_stride = values.stride(dim);
+    const int64_t indices_stride = indices.stride(dim);
+    dim_apply_offsets<SortScratch<scalar_t>>(
+        {self, values, indices},
+        dim,
+        [&](const int64_t* offsets, SortScratch<scalar_t>& scratch) {
+          sort_slice(
+              self_data + offsets[0],
+              self_stride,
+              slice_size,
+              descending,
+              values_data + offsets[1],
+              values_stride,
+              indices_data + offsets[2],
+              indices_stride,
+              scratch);
+        });
+  });
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  at::sort_out(values, indices, self, dim, descending);
+  return std::make_tuple(values, indices);
+}
+
+Tensor argsort(const Tensor& self, int64_t dim, bool descending) {
+  return std::get<1>(at::sort(self, dim, descending));
+}
+
+std::tuple<Tensor&, Tensor&> topk_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim_,
+    bool largest,
+    bool sorted) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  AT_CHECK(
+      k >= 0 && k <= (self.dim() > 0 ? self.size(dim) : 1),
+      "selected index k out of range");
+  auto result_sizes = self.sizes().vec();
+  if (result_sizes.size() > 0) {
+    result_sizes[dim] = k;
+  }
+  _sort_allocate_or_resize_output(values, indices, self, result_sizes);
+  if (self.dim() == 0) {
+    values.copy_(self);
+    indices.zero_();
+    return std::forward_as_tuple(values, indices);
+  }
+  if (values.numel() == 0) {
+    return std::forward_as_tuple(values, indices);
+  }
+  const int64_t slice_size = self.size(dim);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
+    const scalar_t* self_data = self.data<scalar_t>();
+    scalar_t* values_data = values.data<scalar_t>();
+    int64_t* indices_data = indices.data<int64_t>();
+    const int64_t self_stride = self.stride(dim);
+    const int64_t values_stride = values.stride(dim);
+    const int64_t indices_stride = indices.stride(dim);
+    dim_apply_offsets<SortScratch<scalar_t>>(
+        {self, values, indices},
+        dim,
+        [&](const int64_t* offsets, SortScratch<scalar_t>& scratch) {
+          topk_slice(
+              self_data + offsets[0],
+              self_stride,
+              slice_size,
+              k,
+              largest,
+              sorted,
+              values_data + offsets[1],
+              values_stride,
+              indices_data + offsets[2],
+              indices_stride,
+              scratch);
+        });
+  });
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> topk(
+    const Tensor& self,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  at::topk_out(values, indices, self, k, dim, largest, sorted);
+  return std::make_tuple(values, indices);
+}
+
 std::tuple<Tensor, Tensor> kthvalue(
     const Tensor& self,
     int64_t k,
@@ -11,6 +11,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/LegacyTHFunctions.h>
 #include <ATen/LegacyTHDispatcher.h>
+#include <c10/core/CPUAllocator.h>
 #include <c10/core/ScalarType.h>
 #include <c10/util/Deprecated.h>
 #include <ATen/native/Resize.h>
@@ -91,7 +92,7 @@ Tensor _dim_arange(const Tensor& like, int64_t dim) {
 }
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ empty ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-Tensor empty_cpu(IntArrayRef size, const TensorOptions& options) {
+Tensor empty_cpu(IntArrayRef size, const TensorOptions& options, c10::optional<MemoryFormat> optional_memory_format) {
   AT_ASSERT(options.backend() == Backend::CPU);
   AT_ASSERT(!options.is_variable());  // is_variable should have been 'unpacked'  // TODO: remove this when Variable and Tensor are merged
   check_size_nonnegative(size);
@@ -117,6 +118,9 @@ Tensor empty_cpu(IntArrayRef size, const TensorOptions& options) {
   if (size.size() != 1 || size[0] != 0) {
     tensor.unsafeGetTensorImpl()->set_sizes_contiguous(size);
   }
+  if (optional_memory_format.has_value()) {
+    tensor.unsafeGetTensorImpl()->empty_tensor_restride(*optional_memory_format);
+  }
   return tensor;
 }
 
@@ -127,12 +131,21 @@ Tensor empty_strided_cpu(IntArrayRef size, IntArrayRef stride, const TensorOptio
   return t;
 }
 
-Tensor& empty_out(Tensor& result, IntArrayRef size) {
+Tensor& empty_out(
+    Tensor& result,
+    IntArrayRef size,
+    c10::optional<MemoryFormat> optional_memory_format) {
   check_size_nonnegative(size);
   if (result.is_sparse()) {
+    AT_CHECK(
+        !optional_memory_format.has_value(),
+        "memory format is not supported by sparse tensors");
     result.sparse_resize_and_clear_(size, size.size(), 0);
   } else {
     result.resize_(size);
+    if (optional_memory_format.has_value()) {
+      result.unsafeGetTensorImpl()->empty_tensor_restride(*optional_memory_format);
+    }
   }
   return result;
 }
@@ -572,7 +585,36 @@ Tensor triu_indices_cpu(
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ zeros ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+namespace {
+
+// Like empty_cpu, but the storage comes from alloc_zeroed_cpu, so large
+// tensors never touch their pages until they are used.  The storage keeps the
+// regular CPU allocator for resizes.
+Tensor zeros_cpu_lazy(IntArrayRef size, const TensorOptions& options) {
+  check_size_nonnegative(size);
+  int64_t nelements = prod_intlist(size);
+  auto dtype = options.dtype();
+  auto storage_impl = c10::make_intrusive<StorageImpl>(
+    dtype,
+    nelements,
+    c10::alloc_zeroed_cpu(nelements * dtype.itemsize()),
+    at::getCPUAllocator(),
+    /*resizeable=*/true);
+
+  auto tensor = detail::make_tensor<TensorImpl>(storage_impl, at::CPUTensorId());
+  if (size.size() != 1 || size[0] != 0) {
+    tensor.unsafeGetTensorImpl()->set_sizes_contiguous(size);
+  }
+  return tensor;
+}
+
+} // namespace
+
 Tensor zeros(IntArrayRef size, const TensorOptions& options) {
+  if (options.backend() == Backend::CPU && !options.is_variable() &&
+      !options.pinned_memory() && globalContext().lazyZeroFill()) {
+    return zeros_cpu_lazy(size, options);
+  }
   auto result = at::empty(size, options);
   return result.zero_();
 }
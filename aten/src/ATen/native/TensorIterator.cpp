@@ -1,6 +1,7 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <array>
+#include <cmath>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 
@@ -380,6 +381,23 @@ void TensorIterator::serial_for_each(const loop_t& loop, Range range) const {
   serial_for_each(loop_wrapper(loop), range);
 }
 
+// Traverses a size0 x size1 block in square tiles of `tile_size` elements.
+static void tiled_loop_2d(const loop2d_t& loop, int ntensors, const PtrVector& base,
+                          const int64_t* strides, int64_t size0, int64_t size1,
+                          int64_t tile_size) {
+  const int64_t* outer_strides = &strides[ntensors];
+  auto ptrs = PtrVector(base.begin(), base.end());
+  for (int64_t j = 0; j < size1; j += tile_size) {
+    for (int64_t i = 0; i < size0; i += tile_size) {
+      for (int arg = 0; arg < ntensors; arg++) {
+        ptrs[arg] = base[arg] + i * strides[arg] + j * outer_strides[arg];
+      }
+      loop(ntensors, ptrs.data(), strides,
+           std::min(tile_size, size0 - i), std::min(tile_size, size1 - j));
+    }
+  }
+}
+
 void TensorIterator::serial_for_each(const loop2d_t& loop, Range range) const {
   if (range.size() == 0) {
     return;
@@ -395,15 +413,57 @@ void TensorIterator::serial_for_each(const loop2d_t& loop, Range range) const {
     loop(ntensors(), ptrs.data(), strides.data(), range.size(), 1);
   } else {
     auto counter = DimCounter(shape_, range);
+    auto tile_size = tile_size_2d();
     while (!counter.is_done()) {
       auto ptrs = get_data_ptrs(base_ptrs, counter.values);
       auto step = counter.max_2d_step();
-      loop(ntensors(), ptrs.data(), strides.data(), step[0], step[1]);
+      if (tile_size > 0 && step[1] > 1) {
+        tiled_loop_2d(loop, ntensors(), ptrs, strides.data(), step[0], step[1], tile_size);
+      } else {
+        loop(ntensors(), ptrs.data(), strides.data(), step[0], step[1]);
+      }
       counter.increment(step);
     }
   }
 }
 
+int64_t TensorIterator::tile_size_2d() const {
+  if (ndim() < 2 || is_reduction_) {
+    return 0;
+  }
+  // Tiles of all operands should fit in half of a 32 KiB L1 data cache.
+  constexpr int64_t kTileBytes = 16 * 1024;
+  constexpr int64_t kMinTileSize = 16;
+
+  // reorder_dimensions() made dim 0 the fastest moving dimension for the
+  // operands it could; the traversal only needs tiles if some other operand
+  // moves faster along dim 1.
+  bool conflicting_strides = false;
+  int64_t max_element_size = 1;
+  for (auto& op : operands_) {
+    auto stride0 = std::abs(op.stride_bytes[0]);
+    auto stride1 = std::abs(op.stride_bytes[1]);
+    if (op.is_output && (stride0 == 0 || stride1 == 0)) {
+      return 0;
+    }
+    if (stride0 != 0 && stride1 != 0 && stride1 < stride0) {
+      conflicting_strides = true;
+    }
+    max_element_size = std::max<int64_t>(max_element_size, elementSize(op.dtype));
+  }
+  if (!conflicting_strides) {
+    return 0;
+  }
+  auto tile_size = static_cast<int64_t>(
+      std::sqrt(kTileBytes / (ntensors() * max_element_size)));
+  // keep the inner loop long enough to be vectorized
+  tile_size = std::max(kMinTileSize, tile_size - tile_size % kMinTileSize);
+  if (shape_[0] <= tile_size) {
+    return 0;
+  }
+  return tile_size;
+}
+
 bool TensorIterator::is_trivial_1d() const {
   // TODO: check for casting once it's supported
   return ndim() == 1;
@@ -497,6 +557,25 @@ std::unique_ptr<TensorIterator> TensorIterator::reduce_op(Tensor& out, const Ten
   return builder.build();
 }
 
+std::unique_ptr<TensorIterator> TensorIterator::reduce_op(Tensor& out1, Tensor& out2, const Tensor& a) {
+  AT_ASSERT(out1.defined());
+  AT_ASSERT(out2.defined());
+  AT_CHECK(out1.dim() == out2.dim(), "reduce_op(): expected both outputs to have same number of dims, but output1 has ", out1.dim(),
+           " and output2 has ", out2.dim());
+  AT_CHECK(out1.sizes() == out2.sizes(), "reduce_op(): expected both outputs to have same sizes, but output1 has ", out1.sizes(),
+           " and output2 has ", out2.sizes());
+  AT_CHECK(out1.strides() == out2.strides(), "reduce_op(): expected both outputs to have same strides, but output1 has ", out1.strides(),
+           " and output2 has ", out2.strides());
+  auto builder = TensorIterator::Builder();
+  builder.add_output(out1);
+  builder.add_output(out2);
+  builder.add_input(a);
+  builder.iter_->promote_gpu_output_dtypes_ = true;
+  builder.iter_->resize_outputs_ = false;
+  builder.iter_->is_reduction_ = true;
+  return builder.build();
+}
+
 void TensorIterator::mark_outputs() {
   for (int i = 0; i < num_outputs_; i++) {
     operands_[i].is_output = true;
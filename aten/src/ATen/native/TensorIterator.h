@@ -32,6 +32,19 @@
 //     return a + b;
 //   });
 //
+// An iterator can have several outputs, which are added before the inputs
+// and come first in the operand list. They are computed in a single pass by
+// CPU kernels that return a std::tuple (see multiple_outputs_kernel in
+// Loops.h):
+//
+//   builder.add_output(out1);
+//   builder.add_output(out2);
+//   builder.add_input(input);
+//   ...
+//   multiple_outputs_kernel(*iter, [](float a) {
+//     return std::make_tuple(std::sin(a), std::cos(a));
+//   });
+//
 // Note [Result type computation]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // TensorIterator handles limited mixed-type operations. The result type is
@@ -147,11 +160,14 @@ struct CAFFE2_API TensorIterator {
   static std::unique_ptr<TensorIterator> binary_op(Tensor& out, const Tensor& a, const Tensor& b);
   static std::unique_ptr<TensorIterator> unary_op(Tensor& out, const Tensor& a);
   static std::unique_ptr<TensorIterator> reduce_op(Tensor& out, const Tensor& a);
+  static std::unique_ptr<TensorIterator> reduce_op(Tensor& out1, Tensor& out2, const Tensor& a);
 
   int ndim() const { return shape_.size(); }
   IntArrayRef shape() const { return shape_; }
   int64_t numel() const;
   int ntensors() const { return operands_.size(); }
+  int noutputs() const { return num_outputs_; }
+  int ninputs() const { return ntensors() - noutputs(); }
 
   /// number of elements in the output operand. this is the same as numel() for
   /// operations that are not reductions.
@@ -255,6 +271,12 @@ protected:
   std::pair<Backend, ScalarType> compute_common_type();
   void allocate_outputs();
   void coalesce_dimensions();
+  /// Side of the square tiles serial_for_each traverses dims 0 and 1 in, or 0
+  /// to traverse them row by row. Tiles are used when some input runs faster
+  /// along dim 1 than along dim 0 (e.g. a transposed or channels-last input
+  /// with a contiguous output), so that both its rows and the output's stay
+  /// in L1 while a tile is processed.
+  int64_t tile_size_2d() const;
 
 protected:
   DimVector shape_;
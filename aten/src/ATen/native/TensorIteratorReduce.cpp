@@ -43,9 +43,13 @@ static void two_pass_reduction(TensorIterator& iter, const loop2d_t& loop) {
 
   at::parallel_for(0, iter.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
     int thread_num = at::get_thread_num();
-    written[thread_num] = true;
     auto slice = buffer[thread_num];
-    slice.copy_(dst);
+    // A thread may be handed several chunks, so only initialize its slice
+    // of the buffer the first time around.
+    if (!written[thread_num]) {
+      written[thread_num] = true;
+      slice.copy_(dst);
+    }
 
     auto sub_iter = TensorIterator::reduce_op(slice, iter.tensor(1));
     sub_iter->serial_for_each(loop, {begin, end});
@@ -117,7 +121,7 @@ static void parallel_dim_reduction(TensorIterator& iter, const loop2d_t& loop) {
 }
 
 void TensorIterator::foreach_reduced_elt(const loop_subiter_t &loop, bool parallelize) {
-  AT_ASSERT(ntensors() == 2 && num_outputs_ == 1);
+  AT_ASSERT(ninputs() == 1 && noutputs() >= 1);
 
   auto shape = this->shape();
   if (tensor(0).numel() == 0) {
@@ -52,11 +52,15 @@ Tensor & detach_(Tensor & self) {
   return self;
 }
 
-Tensor contiguous(const Tensor & self) {
-  if (self.is_contiguous()) {
+Tensor contiguous(const Tensor & self, MemoryFormat memory_format) {
+  if (self.is_contiguous(memory_format)) {
     return self;
   }
-  return self.clone();
+  if (memory_format == MemoryFormat::Contiguous) {
+    return self.clone();
+  }
+  auto result = at::empty(self.sizes(), self.options(), memory_format);
+  return result.copy_(self);
 }
 
 }
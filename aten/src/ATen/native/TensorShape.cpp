@@ -10,6 +10,7 @@
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
 #include <ATen/native/Resize.h>
+#include <ATen/native/cpu/CatKernel.h>
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <algorithm>
@@ -18,6 +19,29 @@
 namespace at {
 namespace native {
 
+namespace {
+
+// Fast path for the view functions below: creates the TensorImpl of the view
+// of a strided CPU or CUDA tensor directly, instead of dispatching to
+// as_strided, which has to check the new geometry against the storage again.
+// The sizes, strides and storage offset must describe a part of self.
+Tensor alias_with_sizes_and_strides(
+    const Tensor& self,
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    int64_t storage_offset) {
+  auto tid = self.type_id();
+  if (self.is_variable() || (tid != CPUTensorId() && tid != CUDATensorId())) {
+    return self.as_strided(sizes, strides, storage_offset);
+  }
+  auto impl = c10::make_intrusive<TensorImpl>(Storage(self.storage()), tid);
+  impl->set_storage_offset(storage_offset);
+  impl->set_sizes_and_strides(sizes, strides);
+  return Tensor(std::move(impl));
+}
+
+} // namespace
+
 Tensor _reshape_from_tensor(const Tensor& self, const Tensor& shape_tensor) {
   AT_CHECK(shape_tensor.dim() == 1);
   std::vector<int64_t> shape;
@@ -45,9 +69,83 @@ static void check_cat_no_zero_dim(TensorList tensors) {
   }
 }
 
+DEFINE_DISPATCH(cat_contiguous_stub);
+
+static void check_cat_tensor_type(const Tensor & result, const Tensor & t, size_t i) {
+  if (t.type().backend() != result.type().backend()) {
+    AT_ERROR("Expected object of backend ", result.type().backend(), " but got backend ", t.type().backend(),
+             " for sequence element ", i, " in sequence argument at position #1 'tensors'");
+  }
+  if (t.scalar_type() != result.scalar_type()) {
+    AT_ERROR("Expected object of scalar type ", result.scalar_type(), " but got scalar type ", t.scalar_type(),
+             " for sequence element ", i, " in sequence argument at position #1 'tensors'");
+  }
+}
+
+// CPU cat with the output offsets computed up front, so that contiguous
+// inputs are copied in parallel. Like THTensor_(catArray), 1-dim tensors of
+// size 0 are skipped for backwards compatibility.
+static Tensor & cat_out_cpu(Tensor & result, TensorList tensors, int64_t dim) {
+  auto should_skip = [](const Tensor & t) { return t.dim() == 1 && t.size(0) == 0; };
+  const Tensor* not_skipped = nullptr;
+  for (size_t i = 0; i < tensors.size(); i++) {
+    check_cat_tensor_type(result, tensors[i], i);
+    if (!not_skipped && !should_skip(tensors[i])) {
+      not_skipped = &tensors[i];
+    }
+  }
+  if (!not_skipped) {
+    return result;
+  }
+  AT_CHECK(dim >= 0 && dim < not_skipped->dim(), "invalid dimension ", dim);
+
+  auto size = not_skipped->sizes().vec();
+  std::vector<Tensor> inputs;
+  std::vector<int64_t> dim_sizes;
+  bool all_contiguous = true;
+  for (auto& t : tensors) {
+    if (should_skip(t)) {
+      continue;
+    }
+    AT_CHECK(t.dim() == not_skipped->dim(),
+             "Tensors must have same number of dimensions: got ", not_skipped->dim(), " and ", t.dim());
+    for (int64_t d = 0; d < t.dim(); d++) {
+      AT_CHECK(d == dim || t.size(d) == size[d],
+               "Sizes of tensors must match except in dimension ", dim, ". Got ", size[d],
+               " and ", t.size(d), " in dimension ", d);
+    }
+    inputs.push_back(t);
+    dim_sizes.push_back(t.size(dim));
+    all_contiguous &= t.is_contiguous();
+  }
+  size[dim] = std::accumulate(dim_sizes.begin(), dim_sizes.end(), (int64_t)0);
+  result.resize_(size);
+
+  if (all_contiguous && result.is_contiguous()) {
+    int64_t outer = 1, inner = 1;
+    for (int64_t d = 0; d < dim; d++) {
+      outer *= size[d];
+    }
+    for (size_t d = dim + 1; d < size.size(); d++) {
+      inner *= size[d];
+    }
+    cat_contiguous_stub(kCPU, result, inputs, dim_sizes, outer, inner);
+  } else {
+    int64_t offset = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      result.narrow(dim, offset, dim_sizes[i]).copy_(inputs[i]);
+      offset += dim_sizes[i];
+    }
+  }
+  return result;
+}
+
 Tensor & cat_out(Tensor & result, TensorList tensors, int64_t dim) {
   check_cat_no_zero_dim(tensors);
   dim = legacy_cat_wrap_dim(dim, tensors);
+  if (result.type().backend() == Backend::CPU) {
+    return cat_out_cpu(result, tensors, dim);
+  }
   return at::legacy::th::_th_cat_out(result, tensors, dim);
 }
 
@@ -178,6 +276,10 @@ Tensor cat(TensorList tensors, int64_t dim) {
   }
   check_cat_no_zero_dim(tensors);
   dim = legacy_cat_wrap_dim(dim, tensors);
+  if (tensors.size() > 0 && tensors[0].type().backend() == Backend::CPU) {
+    auto result = at::empty({0}, tensors[0].options());
+    return cat_out_cpu(result, tensors, dim);
+  }
   return at::legacy::th::_th_cat(tensors, dim);
 }
 
@@ -249,7 +351,7 @@ Tensor diagonal(const Tensor& self, int64_t offset, int64_t dim1_, int64_t dim2_
   strides.push_back(self.stride(dim1)+self.stride(dim2));
 
   // return view with new parameters
-  return self.as_strided(sizes, strides, storage_offset);
+  return alias_with_sizes_and_strides(self, sizes, strides, storage_offset);
 }
 
 Tensor diag_embed(const Tensor& self, int64_t offset, int64_t dim1_, int64_t dim2_) {
@@ -460,12 +562,12 @@ Tensor select(const Tensor& self, int64_t dim, int64_t index) {
   if (index < 0) {
     index += size;
   }
-  auto sizes = self.sizes().vec();
-  auto strides = self.strides().vec();
+  DimVector sizes(self.sizes().begin(), self.sizes().end());
+  DimVector strides(self.strides().begin(), self.strides().end());
   auto storage_offset = self.storage_offset() + index * strides[dim];
   sizes.erase(sizes.begin() + dim);
   strides.erase(strides.begin() + dim);
-  return self.as_strided(sizes, strides, storage_offset);
+  return alias_with_sizes_and_strides(self, sizes, strides, storage_offset);
 }
 
 Tensor slice(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_t step) {
@@ -474,8 +576,8 @@ Tensor slice(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_
     AT_INDEX_ERROR("slice() cannot be applied to a 0-dim tensor.");
   }
   dim = maybe_wrap_dim(dim, ndim);
-  auto sizes = self.sizes().vec();
-  auto strides = self.strides().vec();
+  DimVector sizes(self.sizes().begin(), self.sizes().end());
+  DimVector strides(self.strides().begin(), self.strides().end());
   // TODO: support negative strides
   AT_CHECK(step > 0, "slice step must be positive");
   if (start < 0) {
@@ -498,7 +600,7 @@ Tensor slice(const Tensor& self, int64_t dim, int64_t start, int64_t end, int64_
   auto len = end - start;
   sizes[dim] = (len + step - 1) / step;  // round-up
   strides[dim] *= step;
-  return self.as_strided(sizes, strides, storage_offset);
+  return alias_with_sizes_and_strides(self, sizes, strides, storage_offset);
 }
 
 std::vector<Tensor> split(const Tensor& self, int64_t split_size, int64_t dim) {
@@ -555,10 +657,47 @@ static inline std::vector<Tensor> get_stack_inputs(TensorList tensors, int64_t d
   return inputs;
 }
 
+// Stacks contiguous CPU tensors of the same shape and type into result
+// without unsqueezing each of them. Returns false if they aren't, which
+// leaves it to cat to copy them or report the mismatch.
+static bool stack_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
+  const auto& first = tensors[0];
+  if (result.type().backend() != Backend::CPU || result.scalar_type() != first.scalar_type()) {
+    return false;
+  }
+  for (auto& t : tensors) {
+    if (t.type() != first.type() || t.sizes() != first.sizes() || !t.is_contiguous()) {
+      return false;
+    }
+  }
+  auto size = first.sizes().vec();
+  size.insert(size.begin() + dim, tensors.size());
+  result.resize_(size);
+  if (!result.is_contiguous()) {
+    return false;
+  }
+  int64_t outer = 1, inner = 1;
+  for (int64_t d = 0; d < dim; d++) {
+    outer *= size[d];
+  }
+  for (size_t d = dim + 1; d < size.size(); d++) {
+    inner *= size[d];
+  }
+  std::vector<int64_t> dim_sizes(tensors.size(), 1);
+  cat_contiguous_stub(kCPU, result, tensors, dim_sizes, outer, inner);
+  return true;
+}
+
 Tensor stack(TensorList tensors, int64_t dim) {
   AT_CHECK(tensors.size() > 0,
            "stack expects a non-empty TensorList");
   dim = maybe_wrap_dim(dim, tensors[0].dim() + 1);
+  if (tensors[0].type().backend() == Backend::CPU) {
+    auto result = at::empty({0}, tensors[0].options());
+    if (stack_out_cpu(result, tensors, dim)) {
+      return result;
+    }
+  }
   return at::cat(get_stack_inputs(tensors, dim), dim);
 }
 
@@ -566,6 +705,9 @@ Tensor& stack_out(Tensor& result, TensorList tensors, int64_t dim) {
   AT_CHECK(tensors.size() > 0,
            "stack expects a non-empty TensorList");
   dim = maybe_wrap_dim(dim, tensors[0].dim() + 1);
+  if (stack_out_cpu(result, tensors, dim)) {
+    return result;
+  }
   return at::cat_out(result, get_stack_inputs(tensors, dim), dim);
 }
 
@@ -633,11 +775,11 @@ Tensor transpose(const Tensor & self, int64_t dim0, int64_t dim1) {
     return sparse_transpose_(self_clone, dim0, dim1);
   }
 
-  auto strides = self.strides().vec();
-  auto sizes = self.sizes().vec();
+  DimVector strides(self.strides().begin(), self.strides().end());
+  DimVector sizes(self.sizes().begin(), self.sizes().end());
   std::swap(strides[dim0], strides[dim1]);
   std::swap(sizes[dim0], sizes[dim1]);
-  return self.as_strided(sizes, strides);
+  return alias_with_sizes_and_strides(self, sizes, strides, self.storage_offset());
 }
 
 static void check_t(const Tensor& self, const char *fn) {
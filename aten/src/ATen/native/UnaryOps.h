@@ -42,6 +42,13 @@ DECLARE_DISPATCH(unary_fn, trunc_stub);
 
 DECLARE_DISPATCH(void(*)(Tensor&, const double, Generator *), bernoulli_mkl_stub);
 
+// Random fills of contiguous CPU tensors, where element i only depends on the
+// philox seed and on i, so that they are the same for any number of threads
+DECLARE_DISPATCH(void(*)(Tensor&, const double, const double, const uint64_t), uniform_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, const double, const double, const uint64_t), normal_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, const double, const uint64_t), bernoulli_scalar_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, const Tensor&, const uint64_t), bernoulli_tensor_stub);
+
 // Missing unary functions
 // digamma
 // lgamma
@@ -2,17 +2,42 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <c10/util/flat_hash_map.h>
 
+#include <functional>
+#include <numeric>
 #include <set>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Unique elements are collected in kUniquePartitions hash tables, picked by a
+// hash of the value, so that the tables can be filled in parallel. The
+// number of partitions doesn't depend on the number of threads.
+constexpr int64_t kUniquePartitions = 64;
+constexpr int64_t kUniqueParallelMinSize = 1 << 16;
+
+// A different mix than the one ska::flat_hash_map applies to std::hash, so
+// that the values of a partition still spread over its table
+template <typename scalar_t>
+inline uint8_t unique_partition(scalar_t value) {
+  uint64_t h = std::hash<scalar_t>()(value);
+  h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+  return (h ^ (h >> 31)) & (kUniquePartitions - 1);
+}
+
+// Orders NaNs after all other values, like sort
+template <typename scalar_t>
+inline bool unique_less(scalar_t lhs, scalar_t rhs) {
+  return lhs < rhs || (rhs != rhs && lhs == lhs);
+}
+
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -22,53 +47,155 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
+  int64_t* inverse_data = nullptr;
+  if (return_inverse) {
+    inverse_indices.resize_(input.sizes());
+    inverse_data = inverse_indices.data<int64_t>();
+  }
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data<scalar_t>();
+  // Small inputs use one table. This only depends on numel, so that the
+  // unsorted output doesn't depend on the number of threads either.
+  const bool partitioned = numel >= kUniqueParallelMinSize;
+  const int64_t num_partitions = partitioned ? kUniquePartitions : 1;
 
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
+  // Group the positions of input by partition, keeping them in increasing
+  // order within each partition
+  std::vector<uint8_t> partition_of;
+  std::vector<int64_t> positions;
+  std::vector<int64_t> partition_offsets(num_partitions + 1, 0);
+  if (partitioned) {
+    partition_of.resize(numel);
+    positions.resize(numel);
+    const int64_t num_chunks = std::min<int64_t>(
+        get_num_threads(), divup(numel, internal::GRAIN_SIZE));
+    const int64_t chunk_size = divup(numel, num_chunks);
+    std::vector<int64_t> histogram(num_chunks * num_partitions, 0);
+    parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* hist = &histogram[c * num_partitions];
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          partition_of[i] = unique_partition(input_data[i]);
+          hist[partition_of[i]]++;
+        }
+      }
+    });
+    int64_t offset = 0;
+    for (int64_t p = 0; p < num_partitions; p++) {
+      partition_offsets[p] = offset;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        int64_t n = histogram[c * num_partitions + p];
+        histogram[c * num_partitions + p] = offset;
+        offset += n;
+      }
+    }
+    partition_offsets[num_partitions] = numel;
+    parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* hist = &histogram[c * num_partitions];
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          positions[hist[partition_of[i]]++] = i;
+        }
+      }
+    });
   } else {
-    std::copy(set.begin(), set.end(), output_data);
+    partition_offsets[1] = numel;
   }
 
-  if (return_inverse || return_counts) {
-    inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
+  // Each partition numbers its unique values in order of first occurrence.
+  // inverse_indices holds these local ids until the partitions are merged.
+  std::vector<std::vector<scalar_t>> partition_values(num_partitions);
+  std::vector<std::vector<int64_t>> partition_counts(num_partitions);
+  parallel_for(0, num_partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      ska::flat_hash_map<scalar_t, int64_t> ids;
+      auto& values = partition_values[p];
+      auto& part_counts = partition_counts[p];
+      for (int64_t j = partition_offsets[p]; j < partition_offsets[p + 1]; j++) {
+        const int64_t i = partitioned ? positions[j] : j;
+        auto it = ids.emplace(input_data[i], values.size());
+        if (it.second) {
+          values.push_back(input_data[i]);
+          if (return_counts) {
+            part_counts.push_back(0);
+          }
+        }
+        const int64_t id = it.first->second;
+        if (return_inverse) {
+          inverse_data[i] = id;
+        }
+        if (return_counts) {
+          part_counts[id]++;
+        }
+      }
+    }
+  });
+
+  std::vector<int64_t> unique_offsets(num_partitions + 1, 0);
+  for (int64_t p = 0; p < num_partitions; p++) {
+    unique_offsets[p + 1] = unique_offsets[p] + partition_values[p].size();
+  }
+  const int64_t num_unique = unique_offsets[num_partitions];
+  Tensor output = at::empty({num_unique}, input.options());
+  scalar_t* output_data = output.data<scalar_t>();
+  int64_t* counts_data = nullptr;
+  if (return_counts) {
+    counts.resize_({num_unique});
+    counts_data = counts.data<int64_t>();
+  }
+
+  // rank[u] is the position in output of the u-th unique value in partition
+  // order, when sorting changes it
+  std::vector<int64_t> rank;
+  if (sorted) {
+    std::vector<std::pair<scalar_t, int64_t>> order;
+    order.reserve(num_unique);
+    for (int64_t p = 0; p < num_partitions; p++) {
+      for (size_t u = 0; u < partition_values[p].size(); u++) {
+        order.emplace_back(partition_values[p][u], unique_offsets[p] + u);
+      }
     }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+    std::sort(order.begin(), order.end(),
+      [](const std::pair<scalar_t, int64_t>& a, const std::pair<scalar_t, int64_t>& b) {
+        return unique_less(a.first, b.first);
+      });
+    rank.resize(num_unique);
+    for (int64_t r = 0; r < num_unique; r++) {
+      output_data[r] = order[r].first;
+      rank[order[r].second] = r;
     }
     if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
-      }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+      for (int64_t p = 0; p < num_partitions; p++) {
+        for (size_t u = 0; u < partition_counts[p].size(); u++) {
+          counts_data[rank[unique_offsets[p] + u]] = partition_counts[p][u];
+        }
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+    }
+  } else {
+    for (int64_t p = 0; p < num_partitions; p++) {
+      std::copy(partition_values[p].begin(), partition_values[p].end(),
+                output_data + unique_offsets[p]);
+      if (return_counts) {
+        std::copy(partition_counts[p].begin(), partition_counts[p].end(),
+                  counts_data + unique_offsets[p]);
       }
     }
   }
+
+  if (return_inverse && (sorted || partitioned)) {
+    parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        int64_t u = unique_offsets[partitioned ? partition_of[i] : 0] + inverse_data[i];
+        inverse_data[i] = sorted ? rank[u] : u;
+      }
+    });
+  }
   return std::make_tuple(output, inverse_indices, counts);
 }
 
+// In parallel, each chunk of input first counts the groups that start in
+// it, which gives the output position of its groups
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
     const Tensor& self,
@@ -77,46 +204,74 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output = at::empty({numel}, input.options());
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
-
-  scalar_t *output_data = output.data<scalar_t>();
-  int64_t *inverse_data = nullptr;
-  int64_t *counts_data = nullptr;
-  if (numel > 0) {
-    *output_data = *input_data;
-  }
+  int64_t* inverse_data = nullptr;
   if (return_inverse) {
     inverse_indices.resize_(input.sizes());
     inverse_data = inverse_indices.data<int64_t>();
   }
-  if (return_counts) {
-    counts.resize_(input.sizes());
-    counts_data = counts.data<int64_t>();
+  if (numel == 0) {
+    return std::make_tuple(at::empty({0}, input.options()), inverse_indices, counts);
   }
-  scalar_t *p = output_data;
-  int64_t *q = counts_data;
-  int64_t last = 0;
-  for (int64_t i = 0; i < numel; i++) {
-    if (input_data[i] != *p) {
-      *(++p) = input_data[i];
-      if (return_counts) {
-        *(q++) = i - last;
-        last = i;
+
+  auto starts_group = [&](int64_t i) {
+    return i == 0 || input_data[i] != input_data[i - 1];
+  };
+  const int64_t num_chunks = (get_num_threads() > 1 && !in_parallel_region())
+      ? std::min<int64_t>(get_num_threads(), divup(numel, internal::GRAIN_SIZE)) : 1;
+  const int64_t chunk_size = divup(numel, num_chunks);
+  std::vector<int64_t> chunk_offsets(num_chunks + 1, 0);
+  if (num_chunks > 1) {
+    parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t groups = 0;
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          groups += starts_group(i);
+        }
+        chunk_offsets[c + 1] = groups;
       }
-    }
-    if (return_inverse) {
-      inverse_data[i] = p - output_data;
-    }
-  }
-  int64_t output_size = p - output_data + 1;
-  if (return_counts && numel > 0) {
-    *q = numel - last;
-    counts.resize_({output_size});
+    });
+    std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
+  } else {
+    chunk_offsets[1] = numel;
   }
+
+  // Without the counting pass, output and group_starts are allocated for
+  // one group per element and shrunk afterwards
+  const int64_t max_groups = chunk_offsets[num_chunks];
+  Tensor output = at::empty({max_groups}, input.options());
+  scalar_t* output_data = output.data<scalar_t>();
+  std::vector<int64_t> group_starts(return_counts ? max_groups + 1 : 0);
+  std::vector<int64_t> chunk_ends(num_chunks);
+  parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t group = chunk_offsets[c] - 1;
+      for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+        if (starts_group(i)) {
+          output_data[++group] = input_data[i];
+          if (return_counts) {
+            group_starts[group] = i;
+          }
+        }
+        if (return_inverse) {
+          inverse_data[i] = group;
+        }
+      }
+      chunk_ends[c] = group + 1;
+    }
+  });
+  const int64_t output_size = chunk_ends[num_chunks - 1];
   output.resize_({output_size});
 
+  if (return_counts) {
+    group_starts[output_size] = numel;
+    counts.resize_({output_size});
+    int64_t* counts_data = counts.data<int64_t>();
+    for (int64_t g = 0; g < output_size; g++) {
+      counts_data[g] = group_starts[g + 1] - group_starts[g];
+    }
+  }
   return std::make_tuple(output, inverse_indices, counts);
 }
 
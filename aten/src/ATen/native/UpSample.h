@@ -133,6 +133,58 @@ static inline void upsample_3d_shape_check(
   }
 }
 
+// Result of a 2-D upsampling on CPU before it is resized: channels last
+// inputs get a channels last output, which upsample_2d_cpu_forward fills
+// without making the input contiguous.
+static inline Tensor upsample_2d_cpu_empty_output(
+    const Tensor& input,
+    IntArrayRef output_size) {
+  if (input.suggest_memory_format() == MemoryFormat::ChannelsLast &&
+      output_size.size() == 2 && output_size[0] > 0 && output_size[1] > 0) {
+    return at::empty(
+               {input.size(0), output_size[0], output_size[1], input.size(1)},
+               input.options())
+        .permute({0, 3, 1, 2});
+  }
+  return at::empty({0}, input.options());
+}
+
+// Runs kernel(output, input) for a resized output. Both are channels last if
+// the input is channels last and the output already is; otherwise both are
+// contiguous, going through a temporary if the output isn't.
+template <typename kernel_t>
+static inline void upsample_2d_cpu_forward(
+    Tensor& output,
+    const Tensor& input,
+    const kernel_t& kernel) {
+  if (input.suggest_memory_format() == MemoryFormat::ChannelsLast &&
+      output.is_contiguous(MemoryFormat::ChannelsLast)) {
+    kernel(output, input);
+  } else if (output.is_contiguous()) {
+    kernel(output, input.contiguous());
+  } else {
+    auto output_contig = at::empty(output.sizes(), output.options());
+    kernel(output_contig, input.contiguous());
+    output.copy_(output_contig);
+  }
+}
+
+// Runs kernel(grad_input, grad_output) on contiguous tensors for a resized
+// grad_input, which the kernel overwrites.
+template <typename kernel_t>
+static inline void upsample_cpu_backward(
+    Tensor& grad_input,
+    const Tensor& grad_output,
+    const kernel_t& kernel) {
+  if (grad_input.is_contiguous()) {
+    kernel(grad_input, grad_output.contiguous());
+  } else {
+    auto grad_input_contig = at::empty(grad_input.sizes(), grad_input.options());
+    kernel(grad_input_contig, grad_output.contiguous());
+    grad_input.copy_(grad_input_contig);
+  }
+}
+
 template <typename scalar_t>
 static inline scalar_t area_pixel_compute_scale(
     int64_t input_size,
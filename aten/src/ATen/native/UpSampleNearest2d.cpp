@@ -1,119 +1,15 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/UpSample.h>
+#include <ATen/native/cpu/UpSampleKernel.h>
 
 namespace at {
 namespace native {
-namespace {
-
-template <typename scalar_t>
-static void upsample_nearest2d_out_frame(
-    scalar_t* odata,
-    scalar_t* idata,
-    int64_t input_height,
-    int64_t input_width,
-    int64_t output_height,
-    int64_t output_width,
-    int64_t nbatch,
-    int64_t channels) {
-  const float height_scale = (float)input_height / (float)output_height;
-  const float width_scale = (float)input_width / (float)output_width;
-
-  channels = channels * nbatch;
-
-  // special case: just copy
-  if (input_height == output_height && input_width == output_width) {
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 = h2;
-
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 = w2;
-        const scalar_t* pos1 = &idata[h1 * input_width + w1];
-        scalar_t* pos2 = &odata[h2 * output_width + w2];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          pos2[0] = pos1[0];
-          pos1 += input_height * input_width;
-          pos2 += output_height * output_width;
-        }
-      }
-    }
-    return;
-  }
-
-  for (int64_t h2 = 0; h2 < output_height; ++h2) {
-    const int64_t h1 =
-        nearest_neighbor_compute_source_index(height_scale, h2, input_height);
-
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const int64_t w1 =
-          nearest_neighbor_compute_source_index(width_scale, w2, input_width);
-
-      const scalar_t* pos1 = &idata[h1 * input_width + w1];
-      scalar_t* pos2 = &odata[h2 * output_width + w2];
-
-      for (int64_t c = 0; c < channels; ++c) {
-        pos2[0] = pos1[0];
-        pos1 += input_height * input_width;
-        pos2 += output_height * output_width;
-      }
-    }
-  }
-}
-
-template <typename scalar_t>
-static void upsample_nearest2d_backward_out_frame(
-    scalar_t* odata,
-    scalar_t* idata,
-    int64_t input_height,
-    int64_t input_width,
-    int64_t output_height,
-    int64_t output_width,
-    int64_t nbatch,
-    int64_t channels) {
-  const float height_scale = (float)input_height / (float)output_height;
-  const float width_scale = (float)input_width / (float)output_width;
-
-  channels = channels * nbatch;
-
-  // special case: just copy
-  if (input_height == output_height && input_width == output_width) {
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 = h2;
 
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 = w2;
-        scalar_t* pos1 = &idata[h1 * input_width + w1];
-        const scalar_t* pos2 = &odata[h2 * output_width + w2];
+DEFINE_DISPATCH(upsample_nearest2d_stub);
+DEFINE_DISPATCH(upsample_nearest2d_backward_stub);
 
-        for (int64_t c = 0; c < channels; ++c) {
-          pos1[0] = pos2[0];
-          pos1 += input_height * input_width;
-          pos2 += output_height * output_width;
-        }
-      }
-    }
-    return;
-  }
-
-  for (int64_t h2 = 0; h2 < output_height; ++h2) {
-    const int64_t h1 =
-        nearest_neighbor_compute_source_index(height_scale, h2, input_height);
-
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const int64_t w1 =
-          nearest_neighbor_compute_source_index(width_scale, w2, input_width);
-      scalar_t* pos1 = &idata[h1 * input_width + w1];
-      const scalar_t* pos2 = &odata[h2 * output_width + w2];
-
-      for (int64_t c = 0; c < channels; ++c) {
-        pos1[0] += pos2[0];
-        pos1 += input_height * input_width;
-        pos2 += output_height * output_width;
-      }
-    }
-  }
-}
+namespace {
 
 static void upsample_nearest2d_out_cpu_template(
     Tensor& output,
@@ -142,26 +38,15 @@ static void upsample_nearest2d_out_cpu_template(
       output_height,
       output_width);
 
-  auto input = input_.contiguous();
-
   output.resize_({nbatch, channels, output_height, output_width});
-  output.zero_();
 
-  AT_ASSERT(input_width > 0 && output_width > 0);
-
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "upsample_nearest2d", [&] {
-    auto* idata = input.data<scalar_t>();
-    auto* odata = output.data<scalar_t>();
+  if (input_height == output_height && input_width == output_width) {
+    output.copy_(input_);
+    return;
+  }
 
-    upsample_nearest2d_out_frame<scalar_t>(
-        odata,
-        idata,
-        input_height,
-        input_width,
-        output_height,
-        output_width,
-        nbatch,
-        channels);
+  upsample_2d_cpu_forward(output, input_, [&](Tensor& out, const Tensor& in) {
+    upsample_nearest2d_stub(kCPU, out, in);
   });
 }
 
@@ -199,25 +84,15 @@ static void upsample_nearest2d_backward_out_cpu_template(
       output_width);
 
   grad_input.resize_({nbatch, channels, input_height, input_width});
-  grad_input.zero_();
-
-  auto grad_output = grad_output_.contiguous();
 
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
-      grad_output.scalar_type(), "upsample_nearest2d_backward", [&] {
-        scalar_t* idata = grad_input.data<scalar_t>();
-        scalar_t* odata = grad_output.data<scalar_t>();
+  if (input_height == output_height && input_width == output_width) {
+    grad_input.copy_(grad_output_);
+    return;
+  }
 
-        upsample_nearest2d_backward_out_frame<scalar_t>(
-            odata,
-            idata,
-            input_height,
-            input_width,
-            output_height,
-            output_width,
-            nbatch,
-            channels);
-      });
+  upsample_cpu_backward(grad_input, grad_output_, [&](Tensor& grad_in, const Tensor& grad_out) {
+    upsample_nearest2d_backward_stub(kCPU, grad_in, grad_out);
+  });
 }
 } // namespace
 
@@ -230,7 +105,7 @@ Tensor& upsample_nearest2d_out_cpu(
 }
 
 Tensor upsample_nearest2d_cpu(const Tensor& input, IntArrayRef output_size) {
-  auto output = at::empty({0}, input.options());
+  auto output = upsample_2d_cpu_empty_output(input, output_size);
   upsample_nearest2d_out_cpu_template(output, input, output_size);
   return output;
 }
@@ -249,7 +124,7 @@ Tensor upsample_nearest2d_backward_cpu(
     const Tensor& grad_output,
     IntArrayRef output_size,
     IntArrayRef input_size) {
-  auto grad_input = at::zeros(input_size, grad_output.options());
+  auto grad_input = at::empty(input_size, grad_output.options());
   upsample_nearest2d_backward_out_cpu_template(
       grad_input, grad_output, output_size, input_size);
   return grad_input;
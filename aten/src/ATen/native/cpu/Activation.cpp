@@ -24,8 +24,25 @@ static void threshold_kernel(TensorIterator& iter, Scalar threshold_scalar, Scal
   });
 }
 
+static void bias_relu_kernel(TensorIterator& iter) {
+  AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "bias_relu_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    binary_kernel_vec(
+      iter,
+      [](scalar_t x, scalar_t bias) -> scalar_t {
+        const scalar_t y = x + bias;
+        return y <= 0 ? scalar_t(0) : y;
+      },
+      [](Vec x, Vec bias) -> Vec {
+        const Vec y = x + bias;
+        return Vec::blendv(y, Vec(0), y <= Vec(0));
+      });
+  });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(threshold_stub, &threshold_kernel);
+REGISTER_DISPATCH(bias_relu_stub, &bias_relu_kernel);
 
 }} // namespace at::native
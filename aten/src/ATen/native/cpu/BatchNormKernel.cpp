@@ -0,0 +1,99 @@
+#include <ATen/native/cpu/BatchNormKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Contiguous input: every (n, c) plane is a run of image_size elements that
+// share alpha(c) and beta(c).
+template <typename scalar_t>
+void batch_norm_transform_nchw(Tensor& output, const Tensor& input,
+                               const scalar_t* alpha, const scalar_t* beta) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t n_channel = input.size(1);
+  const int64_t n_plane = input.size(0) * n_channel;
+  const int64_t image_size = input.numel() / n_plane;
+  const scalar_t* input_data = input.data<scalar_t>();
+  scalar_t* output_data = output.data<scalar_t>();
+
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / image_size);
+  parallel_for(0, n_plane, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const Vec a(alpha[i % n_channel]);
+      const Vec b(beta[i % n_channel]);
+      vec256::map(
+          [a, b](Vec x) { return vec256::fmadd(x, a, b); },
+          output_data + i * image_size,
+          input_data + i * image_size,
+          image_size);
+    }
+  });
+}
+
+// Channels last input, and contiguous input without spatial dimensions:
+// every pixel is a run of n_channel elements, which are vectorized together
+// with alpha and beta.
+template <typename scalar_t>
+void batch_norm_transform_nhwc(Tensor& output, const Tensor& input,
+                               const scalar_t* alpha, const scalar_t* beta) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t n_channel = input.size(1);
+  const int64_t n_pixel = input.numel() / n_channel;
+  const scalar_t* input_data = input.data<scalar_t>();
+  scalar_t* output_data = output.data<scalar_t>();
+
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / n_channel);
+  parallel_for(0, n_pixel, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      const scalar_t* in = input_data + p * n_channel;
+      scalar_t* out = output_data + p * n_channel;
+      int64_t c = 0;
+      for (; c <= n_channel - Vec::size(); c += Vec::size()) {
+        vec256::fmadd(Vec::loadu(in + c), Vec::loadu(alpha + c), Vec::loadu(beta + c))
+            .store(out + c);
+      }
+      if (c < n_channel) {
+        const int64_t count = n_channel - c;
+        vec256::fmadd(Vec::loadu(in + c, count), Vec::loadu(alpha + c, count),
+                      Vec::loadu(beta + c, count))
+            .store(out + c, count);
+      }
+    }
+  });
+}
+
+void batch_norm_transform_kernel(Tensor& output, const Tensor& input,
+                                 const Tensor& alpha, const Tensor& beta) {
+  if (input.numel() == 0) {
+    return;
+  }
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "batch_norm_transform", [&] {
+    const scalar_t* alpha_data = alpha.data<scalar_t>();
+    const scalar_t* beta_data = beta.data<scalar_t>();
+    if (input.is_contiguous() && output.is_contiguous()) {
+      if (input.numel() == input.size(0) * input.size(1)) {
+        batch_norm_transform_nhwc<scalar_t>(output, input, alpha_data, beta_data);
+      } else {
+        batch_norm_transform_nchw<scalar_t>(output, input, alpha_data, beta_data);
+      }
+    } else {
+      AT_ASSERT(input.is_contiguous(MemoryFormat::ChannelsLast) &&
+                output.is_contiguous(MemoryFormat::ChannelsLast));
+      batch_norm_transform_nhwc<scalar_t>(output, input, alpha_data, beta_data);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(batch_norm_cpu_transform_stub, &batch_norm_transform_kernel);
+
+}} // namespace at::native
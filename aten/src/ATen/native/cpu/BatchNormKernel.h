@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Batch normalization with known statistics, folded into a per-channel scale
+// and shift: output(n, c, ...) = input(n, c, ...) * alpha(c) + beta(c).
+// input and output are either both contiguous or both channels last, and
+// alpha and beta are contiguous tensors of input.size(1) elements. output
+// may be input itself, so the kernel can also be applied in place, e.g. to
+// the output of a convolution.
+using batch_norm_fn = void(*)(Tensor & output, const Tensor & input,
+                              const Tensor & alpha, const Tensor & beta);
+
+DECLARE_DISPATCH(batch_norm_fn, batch_norm_cpu_transform_stub);
+
+}} // namespace at::native
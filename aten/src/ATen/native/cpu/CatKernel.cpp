@@ -0,0 +1,112 @@
+#include <ATen/native/cpu/CatKernel.h>
+
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace at { namespace native {
+namespace {
+
+// Outputs this much larger than the last level cache are written with
+// non-temporal stores: they would evict everything else from the cache
+// without being read back from it.
+static int64_t non_temporal_min_bytes() {
+  static const int64_t min_bytes = [] {
+    int64_t llc_size = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    llc_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+    if (llc_size <= 0) {
+      llc_size = 32 << 20;
+    }
+    return 4 * llc_size;
+  }();
+  return min_bytes;
+}
+
+static void copy_bytes(char* dst, const char* src, int64_t n, bool non_temporal) {
+#if defined(__SSE2__)
+  if (non_temporal && n >= 4096) {
+    int64_t head = (16 - reinterpret_cast<uintptr_t>(dst) % 16) % 16;
+    std::memcpy(dst, src, head);
+    int64_t i = head;
+    for (; i + 16 <= n; i += 16) {
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    }
+    std::memcpy(dst + i, src + i, n - i);
+    return;
+  }
+#endif
+  std::memcpy(dst, src, n);
+}
+
+// The output is split into ranges of elements, so that the work is balanced
+// whether there are a few large inputs, or many small ones, or many rows
+// (outer) of small pieces. Each range finds the input piece it starts in
+// and copies piece by piece.
+void cat_contiguous_kernel(Tensor & result, TensorList inputs, IntArrayRef dim_sizes,
+                           int64_t outer, int64_t inner) {
+  const int64_t num_inputs = inputs.size();
+  const int64_t element_size = result.element_size();
+  // row_offsets[i] is the offset of input i in a row of result
+  std::vector<int64_t> row_offsets(num_inputs + 1, 0);
+  std::vector<const char*> input_data(num_inputs);
+  for (int64_t i = 0; i < num_inputs; i++) {
+    row_offsets[i + 1] = row_offsets[i] + dim_sizes[i] * inner;
+    input_data[i] = static_cast<const char*>(inputs[i].data_ptr());
+  }
+  const int64_t row_size = row_offsets[num_inputs];
+  const int64_t numel = outer * row_size;
+  if (numel == 0) {
+    return;
+  }
+  char* result_data = static_cast<char*>(result.data_ptr());
+  const bool non_temporal = numel * element_size >= non_temporal_min_bytes();
+
+  parallel_for(0, numel, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t row = begin / row_size;
+    int64_t pos = begin % row_size;
+    int64_t i = std::upper_bound(row_offsets.begin(), row_offsets.end(), pos) -
+        row_offsets.begin() - 1;
+    int64_t offset = begin;
+    while (offset < end) {
+      const int64_t piece_size = row_offsets[i + 1] - row_offsets[i];
+      const int64_t piece_pos = pos - row_offsets[i];
+      const int64_t n = std::min(piece_size - piece_pos, end - offset);
+      copy_bytes(result_data + offset * element_size,
+                 input_data[i] + (row * piece_size + piece_pos) * element_size,
+                 n * element_size, non_temporal);
+      offset += n;
+      pos += n;
+      // skip to the next non-empty piece
+      while (pos == row_offsets[i + 1] && offset < end) {
+        if (++i == num_inputs) {
+          i = 0;
+          pos = 0;
+          row++;
+        }
+      }
+    }
+#if defined(__SSE2__)
+    if (non_temporal) {
+      _mm_sfence();
+    }
+#endif
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(cat_contiguous_stub, &cat_contiguous_kernel);
+
+}} // namespace at::native
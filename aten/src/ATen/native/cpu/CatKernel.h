@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Copies contiguous inputs into contiguous result, viewed as [outer, sum of
+// dim_sizes, inner] with input i of size [outer, dim_sizes[i], inner]
+using cat_contiguous_fn = void(*)(Tensor & result, TensorList inputs, IntArrayRef dim_sizes,
+                                  int64_t outer, int64_t inner);
+
+DECLARE_DISPATCH(cat_contiguous_fn, cat_contiguous_stub);
+
+}} // namespace at::native
@@ -27,9 +27,25 @@ void copy_kernel_cast_t_impl(Tensor& self, const Tensor& src) {
       src.scalar_type(),
       "copy_kernel_cast",
       [&] {
-        at::native::unary_kernel(*iter, [=](scalar_t a) -> self_T {
-          return static_cast<self_T>(
-              static_cast<at::native::inter_copy_type_t<self_T>>(a));
+        // Contiguous runs go through vec256::convert, which has vectorized
+        // specializations for the common pairs (uint8/int8 -> float,
+        // float <-> Half, int32 <-> int64, ...) and falls back to the same
+        // element-wise cast as the strided loop below for the others.
+        iter->for_each([](int ntensor, char** data, const int64_t* strides, int64_t n) {
+          if (strides[0] == sizeof(self_T) && strides[1] == sizeof(scalar_t)) {
+            vec256::convert(
+                reinterpret_cast<const scalar_t*>(data[1]),
+                reinterpret_cast<self_T*>(data[0]),
+                n);
+            return;
+          }
+          char* dst = data[0];
+          const char* src = data[1];
+          for (int64_t i = 0; i < n; i++) {
+            *reinterpret_cast<self_T*>(dst + i * strides[0]) = static_cast<self_T>(
+                static_cast<at::native::inter_copy_type_t<self_T>>(
+                    *reinterpret_cast<const scalar_t*>(src + i * strides[1])));
+          }
         });
       });
 }
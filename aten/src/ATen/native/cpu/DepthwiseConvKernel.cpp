@@ -0,0 +1,244 @@
+#include <ATen/native/cpu/DepthwiseConvKernel.h>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <vector>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Sizes of one depthwise convolution, and for every kernel row and column
+// the range of output rows and columns whose input element is inside the
+// input (the rest only see padding).
+struct DepthwiseGeometry {
+  int64_t batch, in_channels, out_channels, multiplier;
+  int64_t in_h, in_w, out_h, out_w, k_h, k_w;
+  int64_t stride_h, stride_w, pad_h, pad_w, dilation_h, dilation_w;
+  std::vector<int64_t> row_begin, row_end, col_begin, col_end;
+
+  DepthwiseGeometry(const Tensor& input, const Tensor& output, const Tensor& weight,
+                    IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation)
+    : batch(input.size(0)), in_channels(input.size(1)), out_channels(output.size(1)),
+      multiplier(output.size(1) / input.size(1)),
+      in_h(input.size(2)), in_w(input.size(3)), out_h(output.size(2)), out_w(output.size(3)),
+      k_h(weight.size(2)), k_w(weight.size(3)),
+      stride_h(stride[0]), stride_w(stride[1]), pad_h(padding[0]), pad_w(padding[1]),
+      dilation_h(dilation[0]), dilation_w(dilation[1]) {
+    valid_range(k_h, in_h, out_h, stride_h, pad_h, dilation_h, row_begin, row_end);
+    valid_range(k_w, in_w, out_w, stride_w, pad_w, dilation_w, col_begin, col_end);
+  }
+
+  // Offset of the input element of output 0 for kernel column kw
+  int64_t col_offset(int64_t kw) const {
+    return kw * dilation_w - pad_w;
+  }
+
+  int64_t row_offset(int64_t kh) const {
+    return kh * dilation_h - pad_h;
+  }
+
+ private:
+  // Output positions o with 0 <= o * stride - pad + k * dilation < in_size
+  static void valid_range(int64_t k_size, int64_t in_size, int64_t out_size,
+                          int64_t stride, int64_t pad, int64_t dilation,
+                          std::vector<int64_t>& begin, std::vector<int64_t>& end) {
+    begin.resize(k_size);
+    end.resize(k_size);
+    for (int64_t k = 0; k < k_size; k++) {
+      const int64_t lo = pad - k * dilation;
+      const int64_t hi = in_size - 1 + pad - k * dilation;
+      int64_t b = lo <= 0 ? 0 : (lo + stride - 1) / stride;
+      int64_t e = hi < 0 ? 0 : std::min(hi / stride + 1, out_size);
+      begin[k] = std::min(b, e);
+      end[k] = e;
+    }
+  }
+};
+
+// out[i * out_stride] += w * in[i * in_stride] for i in [0, n)
+template <typename scalar_t>
+static inline void axpy(scalar_t* out, int64_t out_stride, const scalar_t* in, int64_t in_stride,
+                        scalar_t w, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  int64_t i = 0;
+  if (out_stride == 1 && in_stride == 1) {
+    const Vec w_vec(w);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      fmadd(w_vec, Vec::loadu(in + i), Vec::loadu(out + i)).store(out + i);
+    }
+  }
+  for (; i < n; i++) {
+    out[i * out_stride] += w * in[i * in_stride];
+  }
+}
+
+// Sum of a[i] * b[i * b_stride] for i in [0, n)
+template <typename scalar_t>
+static inline scalar_t dot(const scalar_t* a, const scalar_t* b, int64_t b_stride, int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  int64_t i = 0;
+  scalar_t sum = 0;
+  if (b_stride == 1 && n >= Vec::size()) {
+    Vec acc(0);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      acc = fmadd(Vec::loadu(a + i), Vec::loadu(b + i), acc);
+    }
+    __at_align32__ scalar_t buf[Vec::size()];
+    acc.store(buf);
+    for (int64_t j = 0; j < Vec::size(); j++) {
+      sum += buf[j];
+    }
+  }
+  for (; i < n; i++) {
+    sum += a[i] * b[i * b_stride];
+  }
+  return sum;
+}
+
+// Each (batch, output channel) plane is computed by one thread, one output
+// row at a time: the row starts as the bias and every kernel element adds a
+// scaled input row to the columns it reaches.
+void depthwise_conv2d_kernel(Tensor& output, const Tensor& input, const Tensor& weight,
+                             const Tensor& bias, IntArrayRef padding, IntArrayRef stride,
+                             IntArrayRef dilation) {
+  const DepthwiseGeometry g(input, output, weight, padding, stride, dilation);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "depthwise_conv2d_cpu", [&] {
+    const scalar_t* input_data = input.data<scalar_t>();
+    const scalar_t* weight_data = weight.data<scalar_t>();
+    const scalar_t* bias_data = bias.defined() ? bias.data<scalar_t>() : nullptr;
+    scalar_t* output_data = output.data<scalar_t>();
+
+    const int64_t work = std::max<int64_t>(1, g.out_h * g.out_w * g.k_h * g.k_w);
+    parallel_for(0, g.batch * g.out_channels, std::max<int64_t>(1, internal::GRAIN_SIZE / work),
+                 [&](int64_t begin, int64_t end) {
+      for (int64_t plane = begin; plane < end; plane++) {
+        const int64_t n = plane / g.out_channels;
+        const int64_t oc = plane % g.out_channels;
+        const scalar_t* in_plane = input_data + (n * g.in_channels + oc / g.multiplier) * g.in_h * g.in_w;
+        const scalar_t* w = weight_data + oc * g.k_h * g.k_w;
+        scalar_t* out_plane = output_data + plane * g.out_h * g.out_w;
+        const scalar_t b = bias_data ? bias_data[oc] : scalar_t(0);
+
+        for (int64_t oh = 0; oh < g.out_h; oh++) {
+          scalar_t* out_row = out_plane + oh * g.out_w;
+          std::fill(out_row, out_row + g.out_w, b);
+          for (int64_t kh = 0; kh < g.k_h; kh++) {
+            if (oh < g.row_begin[kh] || oh >= g.row_end[kh]) {
+              continue;
+            }
+            const scalar_t* in_row = in_plane + (oh * g.stride_h + g.row_offset(kh)) * g.in_w;
+            for (int64_t kw = 0; kw < g.k_w; kw++) {
+              const int64_t ow = g.col_begin[kw];
+              axpy(out_row + ow, 1, in_row + ow * g.stride_w + g.col_offset(kw), g.stride_w,
+                   w[kh * g.k_w + kw], g.col_end[kw] - ow);
+            }
+          }
+        }
+      }
+    });
+  });
+}
+
+// The transpose of the forward: each (batch, input channel) plane of
+// grad_input is owned by one thread, which scatters the rows of grad_output
+// of all the output channels reading it, so no two threads write the same
+// element.
+void depthwise_conv2d_backward_input_kernel(Tensor& grad_input, const Tensor& grad_output,
+                                            const Tensor& weight, IntArrayRef padding,
+                                            IntArrayRef stride, IntArrayRef dilation) {
+  const DepthwiseGeometry g(grad_input, grad_output, weight, padding, stride, dilation);
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "depthwise_conv2d_backward_input_cpu", [&] {
+    const scalar_t* grad_output_data = grad_output.data<scalar_t>();
+    const scalar_t* weight_data = weight.data<scalar_t>();
+    scalar_t* grad_input_data = grad_input.data<scalar_t>();
+
+    const int64_t work = std::max<int64_t>(1, g.multiplier * g.out_h * g.out_w * g.k_h * g.k_w);
+    parallel_for(0, g.batch * g.in_channels, std::max<int64_t>(1, internal::GRAIN_SIZE / work),
+                 [&](int64_t begin, int64_t end) {
+      for (int64_t plane = begin; plane < end; plane++) {
+        const int64_t n = plane / g.in_channels;
+        const int64_t ic = plane % g.in_channels;
+        scalar_t* gi_plane = grad_input_data + plane * g.in_h * g.in_w;
+        std::fill(gi_plane, gi_plane + g.in_h * g.in_w, scalar_t(0));
+
+        for (int64_t m = 0; m < g.multiplier; m++) {
+          const int64_t oc = ic * g.multiplier + m;
+          const scalar_t* go_plane = grad_output_data + (n * g.out_channels + oc) * g.out_h * g.out_w;
+          const scalar_t* w = weight_data + oc * g.k_h * g.k_w;
+          for (int64_t oh = 0; oh < g.out_h; oh++) {
+            const scalar_t* go_row = go_plane + oh * g.out_w;
+            for (int64_t kh = 0; kh < g.k_h; kh++) {
+              if (oh < g.row_begin[kh] || oh >= g.row_end[kh]) {
+                continue;
+              }
+              scalar_t* gi_row = gi_plane + (oh * g.stride_h + g.row_offset(kh)) * g.in_w;
+              for (int64_t kw = 0; kw < g.k_w; kw++) {
+                const int64_t ow = g.col_begin[kw];
+                axpy(gi_row + ow * g.stride_w + g.col_offset(kw), g.stride_w, go_row + ow, 1,
+                     w[kh * g.k_w + kw], g.col_end[kw] - ow);
+              }
+            }
+          }
+        }
+      }
+    });
+  });
+}
+
+// Each output channel's kernel is reduced by one thread over the batch, so
+// the result doesn't depend on the number of threads.
+void depthwise_conv2d_backward_weight_kernel(Tensor& grad_weight, const Tensor& grad_output,
+                                             const Tensor& input, IntArrayRef padding,
+                                             IntArrayRef stride, IntArrayRef dilation) {
+  const DepthwiseGeometry g(input, grad_output, grad_weight, padding, stride, dilation);
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "depthwise_conv2d_backward_weight_cpu", [&] {
+    using acc_t = acc_type<scalar_t, false>;
+    const scalar_t* grad_output_data = grad_output.data<scalar_t>();
+    const scalar_t* input_data = input.data<scalar_t>();
+    scalar_t* grad_weight_data = grad_weight.data<scalar_t>();
+
+    const int64_t work = std::max<int64_t>(1, g.batch * g.out_h * g.out_w * g.k_h * g.k_w);
+    parallel_for(0, g.out_channels, std::max<int64_t>(1, internal::GRAIN_SIZE / work),
+                 [&](int64_t begin, int64_t end) {
+      std::vector<acc_t> acc(g.k_h * g.k_w);
+      for (int64_t oc = begin; oc < end; oc++) {
+        std::fill(acc.begin(), acc.end(), acc_t(0));
+        for (int64_t n = 0; n < g.batch; n++) {
+          const scalar_t* go_plane = grad_output_data + (n * g.out_channels + oc) * g.out_h * g.out_w;
+          const scalar_t* in_plane = input_data + (n * g.in_channels + oc / g.multiplier) * g.in_h * g.in_w;
+          for (int64_t oh = 0; oh < g.out_h; oh++) {
+            const scalar_t* go_row = go_plane + oh * g.out_w;
+            for (int64_t kh = 0; kh < g.k_h; kh++) {
+              if (oh < g.row_begin[kh] || oh >= g.row_end[kh]) {
+                continue;
+              }
+              const scalar_t* in_row = in_plane + (oh * g.stride_h + g.row_offset(kh)) * g.in_w;
+              for (int64_t kw = 0; kw < g.k_w; kw++) {
+                const int64_t ow = g.col_begin[kw];
+                acc[kh * g.k_w + kw] += dot(go_row + ow, in_row + ow * g.stride_w + g.col_offset(kw),
+                                            g.stride_w, g.col_end[kw] - ow);
+              }
+            }
+          }
+        }
+        scalar_t* gw = grad_weight_data + oc * g.k_h * g.k_w;
+        for (int64_t k = 0; k < g.k_h * g.k_w; k++) {
+          gw[k] = static_cast<scalar_t>(acc[k]);
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(depthwise_conv2d_stub, &depthwise_conv2d_kernel);
+REGISTER_DISPATCH(depthwise_conv2d_backward_input_stub, &depthwise_conv2d_backward_input_kernel);
+REGISTER_DISPATCH(depthwise_conv2d_backward_weight_stub, &depthwise_conv2d_backward_weight_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Direct depthwise 2-D convolution of contiguous NCHW tensors. The weight has
+// shape [out_channels, 1, kH, kW], and output channel c reads input channel
+// c / (out_channels / in_channels). bias may be undefined.
+using depthwise_conv2d_fn = void(*)(Tensor & output, const Tensor & input, const Tensor & weight,
+                                    const Tensor & bias, IntArrayRef padding, IntArrayRef stride,
+                                    IntArrayRef dilation);
+using depthwise_conv2d_backward_input_fn = void(*)(Tensor & grad_input, const Tensor & grad_output,
+                                                   const Tensor & weight, IntArrayRef padding,
+                                                   IntArrayRef stride, IntArrayRef dilation);
+using depthwise_conv2d_backward_weight_fn = void(*)(Tensor & grad_weight, const Tensor & grad_output,
+                                                    const Tensor & input, IntArrayRef padding,
+                                                    IntArrayRef stride, IntArrayRef dilation);
+
+DECLARE_DISPATCH(depthwise_conv2d_fn, depthwise_conv2d_stub);
+DECLARE_DISPATCH(depthwise_conv2d_backward_input_fn, depthwise_conv2d_backward_input_stub);
+DECLARE_DISPATCH(depthwise_conv2d_backward_weight_fn, depthwise_conv2d_backward_weight_stub);
+
+}} // namespace at::native
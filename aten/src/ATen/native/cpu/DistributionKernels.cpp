@@ -0,0 +1,143 @@
+#include <ATen/native/UnaryOps.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Element i of a fill uses the 32-bit numbers [i * numbers, (i + 1) * numbers)
+// of the philox stream, wherever the chunks of parallel_for start.
+template <typename scalar_t>
+struct philox_uniform;
+
+template <>
+struct philox_uniform<float> {
+  static constexpr int64_t numbers = 1;
+  static float next(philox_engine& engine) {
+    return philox_uniform_float(engine());
+  }
+};
+
+template <>
+struct philox_uniform<double> {
+  static constexpr int64_t numbers = 2;
+  static double next(philox_engine& engine) {
+    uint32_t hi = engine();
+    return philox_uniform_double(hi, engine());
+  }
+};
+
+static philox_engine engine_at(uint64_t seed, int64_t position) {
+  philox_engine engine(seed);
+  engine.discard(position);
+  return engine;
+}
+
+// Uniform in [0, 1) with 32 bits of precision, for comparing with p
+static inline double uniform_32(philox_engine& engine) {
+  return engine() * (1.0 / 4294967296.0);
+}
+
+void uniform_kernel(Tensor& self, const double from, const double to, const uint64_t seed) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "uniform_cpu", [&] {
+    using uniform = philox_uniform<scalar_t>;
+    scalar_t* data = self.data<scalar_t>();
+    const scalar_t from_ = static_cast<scalar_t>(from);
+    const scalar_t range = static_cast<scalar_t>(to - from);
+    parallel_for(0, self.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      auto engine = engine_at(seed, begin * uniform::numbers);
+      for (int64_t i = begin; i < end; i++) {
+        data[i] = uniform::next(engine) * range + from_;
+      }
+    });
+  });
+}
+
+// Box-Muller on a block of 2 * Vec::size() uniform numbers: the first half
+// gives the radii and the second half the angles, as in THVector normal_fill
+template <typename scalar_t>
+static void normal_fill_block(scalar_t* data, const Vec256<scalar_t>& mean, const Vec256<scalar_t>& std) {
+  using Vec = Vec256<scalar_t>;
+  const Vec u1 = Vec(1) - Vec::loadu(data);
+  const Vec u2 = Vec::loadu(data + Vec::size());
+  const Vec radius = (Vec(-2) * u1.log()).sqrt();
+  const Vec theta = Vec(2.0 * M_PI) * u2;
+  (radius * theta.cos() * std + mean).store(data);
+  (radius * theta.sin() * std + mean).store(data + Vec::size());
+}
+
+void normal_kernel(Tensor& self, const double mean, const double std, const uint64_t seed) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "normal_cpu", [&] {
+    using uniform = philox_uniform<scalar_t>;
+    using Vec = Vec256<scalar_t>;
+    constexpr int64_t block_size = 2 * Vec::size();
+    scalar_t* data = self.data<scalar_t>();
+    const int64_t numel = self.numel();
+    const Vec mean_vec(static_cast<scalar_t>(mean));
+    const Vec std_vec(static_cast<scalar_t>(std));
+    const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / block_size);
+    parallel_for(0, divup(numel, block_size), grain_size, [&](int64_t begin, int64_t end) {
+      auto engine = engine_at(seed, begin * block_size * uniform::numbers);
+      scalar_t buffer[block_size];
+      for (int64_t block = begin; block < end; block++) {
+        // The last block is computed in full in buffer; its numbers past
+        // numel are generated, but not stored
+        const int64_t n = std::min(block_size, numel - block * block_size);
+        scalar_t* out = n == block_size ? data + block * block_size : buffer;
+        for (int64_t j = 0; j < block_size; j++) {
+          out[j] = uniform::next(engine);
+        }
+        normal_fill_block(out, mean_vec, std_vec);
+        if (out == buffer) {
+          std::copy(buffer, buffer + n, data + block * block_size);
+        }
+      }
+    });
+  });
+}
+
+void bernoulli_scalar_kernel(Tensor& self, const double p, const uint64_t seed) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
+    scalar_t* data = self.data<scalar_t>();
+    parallel_for(0, self.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      auto engine = engine_at(seed, begin);
+      for (int64_t i = begin; i < end; i++) {
+        data[i] = static_cast<scalar_t>(uniform_32(engine) < p);
+      }
+    });
+  });
+}
+
+// p is contiguous and has the size of self
+void bernoulli_tensor_kernel(Tensor& self, const Tensor& p, const uint64_t seed) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "bernoulli_tensor_cpu_self_", [&] {
+    using self_t = scalar_t;
+    self_t* data = self.data<self_t>();
+    AT_DISPATCH_FLOATING_TYPES(p.scalar_type(), "bernoulli_tensor_cpu_p_", [&] {
+      const scalar_t* p_data = p.data<scalar_t>();
+      parallel_for(0, self.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+        auto engine = engine_at(seed, begin);
+        for (int64_t i = begin; i < end; i++) {
+          data[i] = static_cast<self_t>(uniform_32(engine) < p_data[i]);
+        }
+      });
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(uniform_stub, &uniform_kernel);
+REGISTER_DISPATCH(normal_stub, &normal_kernel);
+REGISTER_DISPATCH(bernoulli_scalar_stub, &bernoulli_scalar_kernel);
+REGISTER_DISPATCH(bernoulli_tensor_stub, &bernoulli_tensor_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,214 @@
+#include <ATen/native/FusedOptimizers.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/cpu/MultiTensorApply.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace at { namespace native { namespace {
+
+using namespace vec256;
+
+// Runs op(i, count) on the Vec256 of `count` elements at i, for every Vec256
+// of a chunk of n elements; only the last one can be partial.
+template <typename scalar_t, typename Op>
+inline void vectorized_chunk(int64_t n, const Op& op) {
+  constexpr int64_t size = Vec256<scalar_t>::size();
+  for (int64_t i = 0; i < n; i += size) {
+    op(i, std::min(size, n - i));
+  }
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> load(const scalar_t* ptr, int64_t count) {
+  return count == Vec256<scalar_t>::size() ? Vec256<scalar_t>::loadu(ptr)
+                                           : Vec256<scalar_t>::loadu(ptr, count);
+}
+
+void fused_sgd_kernel(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double weight_decay,
+    double momentum,
+    double dampening,
+    bool nesterov) {
+  const bool use_momentum = momentum != 0;
+  AT_DISPATCH_FLOATING_TYPES(params.front().scalar_type(), "fused_sgd_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec lr_vec(lr), weight_decay_vec(weight_decay),
+        momentum_vec(momentum), dampening_vec(dampening);
+    multi_tensor_apply<3, scalar_t>(
+        {{params, grads, use_momentum ? momentum_buffers : TensorList()}},
+        [&](const std::array<scalar_t*, 3>& ptrs, int64_t n) {
+          vectorized_chunk<scalar_t>(n, [&](int64_t i, int64_t count) {
+            auto param = load(ptrs[0] + i, count);
+            auto update = load(ptrs[1] + i, count) + param * weight_decay_vec;
+            if (use_momentum) {
+              const auto buffer = load(ptrs[2] + i, count) * momentum_vec +
+                  update * dampening_vec;
+              buffer.store(ptrs[2] + i, count);
+              update = nesterov ? update + buffer * momentum_vec : buffer;
+            }
+            param = param - update * lr_vec;
+            param.store(ptrs[0] + i, count);
+          });
+        });
+  });
+}
+
+void fused_adam_kernel(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double step_size,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps) {
+  const bool amsgrad = !max_exp_avg_sqs.empty();
+  AT_DISPATCH_FLOATING_TYPES(params.front().scalar_type(), "fused_adam_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec step_size_vec(step_size), beta1_vec(beta1),
+        one_minus_beta1_vec(1 - beta1), beta2_vec(beta2),
+        one_minus_beta2_vec(1 - beta2), weight_decay_vec(weight_decay),
+        eps_vec(eps);
+    multi_tensor_apply<5, scalar_t>(
+        {{params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs}},
+        [&](const std::array<scalar_t*, 5>& ptrs, int64_t n) {
+          vectorized_chunk<scalar_t>(n, [&](int64_t i, int64_t count) {
+            auto param = load(ptrs[0] + i, count);
+            const auto grad =
+                load(ptrs[1] + i, count) + param * weight_decay_vec;
+            const auto exp_avg = load(ptrs[2] + i, count) * beta1_vec +
+                grad * one_minus_beta1_vec;
+            const auto exp_avg_sq = load(ptrs[3] + i, count) * beta2_vec +
+                grad * grad * one_minus_beta2_vec;
+            exp_avg.store(ptrs[2] + i, count);
+            exp_avg_sq.store(ptrs[3] + i, count);
+            auto denom = exp_avg_sq;
+            if (amsgrad) {
+              denom = maximum(load(ptrs[4] + i, count), exp_avg_sq);
+              denom.store(ptrs[4] + i, count);
+            }
+            param = param - step_size_vec * exp_avg / (denom.sqrt() + eps_vec);
+            param.store(ptrs[0] + i, count);
+          });
+        });
+  });
+}
+
+void fused_adagrad_kernel(
+    TensorList params,
+    TensorList grads,
+    TensorList state_sums,
+    double lr,
+    double weight_decay,
+    double eps) {
+  AT_DISPATCH_FLOATING_TYPES(params.front().scalar_type(), "fused_adagrad_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec lr_vec(lr), weight_decay_vec(weight_decay), eps_vec(eps);
+    multi_tensor_apply<3, scalar_t>(
+        {{params, grads, state_sums}},
+        [&](const std::array<scalar_t*, 3>& ptrs, int64_t n) {
+          vectorized_chunk<scalar_t>(n, [&](int64_t i, int64_t count) {
+            auto param = load(ptrs[0] + i, count);
+            const auto grad =
+                load(ptrs[1] + i, count) + param * weight_decay_vec;
+            const auto state_sum = load(ptrs[2] + i, count) + grad * grad;
+            state_sum.store(ptrs[2] + i, count);
+            param = param - lr_vec * grad / (state_sum.sqrt() + eps_vec);
+            param.store(ptrs[0] + i, count);
+          });
+        });
+  });
+}
+
+void fused_rmsprop_kernel(
+    TensorList params,
+    TensorList grads,
+    TensorList square_avgs,
+    TensorList grad_avgs,
+    TensorList momentum_buffers,
+    double lr,
+    double alpha,
+    double eps,
+    double weight_decay,
+    double momentum) {
+  const bool centered = !grad_avgs.empty();
+  const bool use_momentum = momentum > 0;
+  AT_DISPATCH_FLOATING_TYPES(params.front().scalar_type(), "fused_rmsprop_cpu", [&] {
+    using Vec = Vec256<scalar_t>;
+    const Vec lr_vec(lr), alpha_vec(alpha), one_minus_alpha_vec(1 - alpha),
+        eps_vec(eps), weight_decay_vec(weight_decay), momentum_vec(momentum);
+    multi_tensor_apply<5, scalar_t>(
+        {{params,
+          grads,
+          square_avgs,
+          grad_avgs,
+          use_momentum ? momentum_buffers : TensorList()}},
+        [&](const std::array<scalar_t*, 5>& ptrs, int64_t n) {
+          vectorized_chunk<scalar_t>(n, [&](int64_t i, int64_t count) {
+            auto param = load(ptrs[0] + i, count);
+            const auto grad =
+                load(ptrs[1] + i, count) + param * weight_decay_vec;
+            const auto square_avg = load(ptrs[2] + i, count) * alpha_vec +
+                grad * grad * one_minus_alpha_vec;
+            square_avg.store(ptrs[2] + i, count);
+            auto avg = square_avg;
+            if (centered) {
+              const auto grad_avg = load(ptrs[3] + i, count) * alpha_vec +
+                  grad * one_minus_alpha_vec;
+              grad_avg.store(ptrs[3] + i, count);
+              avg = avg - grad_avg * grad_avg;
+            }
+            avg = avg.sqrt() + eps_vec;
+            if (use_momentum) {
+              const auto buffer =
+                  load(ptrs[4] + i, count) * momentum_vec + grad / avg;
+              buffer.store(ptrs[4] + i, count);
+              param = param - lr_vec * buffer;
+            } else {
+              param = param - lr_vec * grad / avg;
+            }
+            param.store(ptrs[0] + i, count);
+          });
+        });
+  });
+}
+
+bool unscale_grads_kernel(TensorList grads, double inv_scale) {
+  std::atomic<bool> found_non_finite{false};
+  AT_DISPATCH_FLOATING_TYPES(grads.front().scalar_type(), "unscale_grads_cpu", [&] {
+    const auto scale = static_cast<scalar_t>(inv_scale);
+    multi_tensor_apply<1, scalar_t>(
+        {{grads}}, [&](const std::array<scalar_t*, 1>& ptrs, int64_t n) {
+          bool finite = true;
+          for (int64_t i = 0; i < n; ++i) {
+            const scalar_t value = ptrs[0][i] * scale;
+            ptrs[0][i] = value;
+            finite = finite && std::isfinite(value);
+          }
+          if (!finite) {
+            found_non_finite = true;
+          }
+        });
+  });
+  return !found_non_finite;
+}
+
+} // namespace
+
+REGISTER_DISPATCH(fused_sgd_stub, &fused_sgd_kernel);
+REGISTER_DISPATCH(fused_adam_stub, &fused_adam_kernel);
+REGISTER_DISPATCH(fused_adagrad_stub, &fused_adagrad_kernel);
+REGISTER_DISPATCH(fused_rmsprop_stub, &fused_rmsprop_kernel);
+REGISTER_DISPATCH(unscale_grads_stub, &unscale_grads_kernel);
+
+}} // namespace at::native
@@ -6,6 +6,11 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec256/functional.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
 
 namespace at { namespace native {
 namespace {
@@ -103,8 +108,8 @@ void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
   // NOTE: duplicate indices are only supported if accumulate is true.
   AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, iter.dtype(), "index_put", [&] {
     if (accumulate) {
-      // TODO: investigate parallelization of the accumulate kernel. Unlike the non-accumulate case,
-      // this needs to be thread-safe.
+      // Only reached for Half and Bool, or when self can't be viewed for
+      // index_add_kernel, so it stays serial to be thread-safe.
       cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
         *(scalar_t*)(dst + offset) += *(scalar_t*)src;
       }, /*serial_execution=*/true);
@@ -116,10 +121,102 @@ void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
   });
 }
 
+// dst[i * dst_stride] += src[i * src_stride] for i in [0, size)
+template <typename scalar_t>
+static void add_row(scalar_t* dst, int64_t dst_stride, scalar_t* src, int64_t src_stride, int64_t size) {
+  if (dst_stride == 1 && src_stride == 1) {
+    map2([](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a + b; }, dst, dst, src, size);
+  } else {
+    for (int64_t i = 0; i < size; i++) {
+      dst[i * dst_stride] += src[i * src_stride];
+    }
+  }
+}
+
+// Atomics or a thread per source row would make index_add non-deterministic
+// with duplicate indices. Instead, the positions of index are bucketed by
+// destination and each row of self is summed by one thread, adding its
+// sources in order of position, so the result doesn't depend on the number
+// of threads.
+template <typename scalar_t>
+void cpu_index_add_kernel(Tensor & self, const Tensor & index, const Tensor & source) {
+  const int64_t outer_size = self.size(0);
+  const int64_t dim_size = self.size(1);
+  const int64_t inner_size = self.size(2);
+  const int64_t num_indices = index.numel();
+  const int64_t* index_data = index.data<int64_t>();
+
+  for (int64_t n = 0; n < num_indices; n++) {
+    AT_CHECK(index_data[n] >= 0 && index_data[n] < dim_size,
+             "index_add_(): index ", index_data[n],
+             " is out of bounds for dimension with size ", dim_size);
+  }
+
+  // Positions of index grouped by destination, in increasing order within
+  // each group. Counting sort if there aren't many more destinations than
+  // positions.
+  std::vector<int64_t> order(num_indices);
+  if (dim_size <= 2 * num_indices) {
+    std::vector<int64_t> offsets(dim_size + 1, 0);
+    for (int64_t n = 0; n < num_indices; n++) {
+      offsets[index_data[n] + 1]++;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    for (int64_t n = 0; n < num_indices; n++) {
+      order[offsets[index_data[n]]++] = n;
+    }
+  } else {
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+      return index_data[a] < index_data[b];
+    });
+  }
+  std::vector<int64_t> segment_dests;
+  std::vector<int64_t> segment_offsets;
+  for (int64_t i = 0; i < num_indices; i++) {
+    if (i == 0 || index_data[order[i]] != index_data[order[i - 1]]) {
+      segment_dests.push_back(index_data[order[i]]);
+      segment_offsets.push_back(i);
+    }
+  }
+  segment_offsets.push_back(num_indices);
+  const int64_t num_segments = segment_dests.size();
+
+  scalar_t* self_data = self.data<scalar_t>();
+  scalar_t* source_data = source.data<scalar_t>();
+  const int64_t self_outer_stride = self.stride(0);
+  const int64_t self_dim_stride = self.stride(1);
+  const int64_t self_inner_stride = self.stride(2);
+  const int64_t source_outer_stride = source.stride(0);
+  const int64_t source_dim_stride = source.stride(1);
+  const int64_t source_inner_stride = source.stride(2);
+
+  const int64_t row_work = std::max<int64_t>(1, inner_size * num_indices / num_segments);
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / row_work);
+  parallel_for(0, outer_size * num_segments, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t b = row / num_segments;
+      const int64_t segment = row % num_segments;
+      scalar_t* dst = self_data + b * self_outer_stride + segment_dests[segment] * self_dim_stride;
+      for (int64_t i = segment_offsets[segment]; i < segment_offsets[segment + 1]; i++) {
+        scalar_t* src = source_data + b * source_outer_stride + order[i] * source_dim_stride;
+        add_row(dst, self_inner_stride, src, source_inner_stride, inner_size);
+      }
+    }
+  });
+}
+
+void index_add_kernel(Tensor & self, const Tensor & index, const Tensor & source) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "index_add_cpu", [&] {
+    cpu_index_add_kernel<scalar_t>(self, index, source);
+  });
+}
+
 } // anonymous namespace
 
 
 REGISTER_DISPATCH(index_stub, &index_kernel);
 REGISTER_DISPATCH(index_put_stub, &index_put_kernel);
+REGISTER_DISPATCH(index_add_stub, &index_add_kernel);
 
 }} // namespace at::native
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <stdint.h>
+#include <tuple>
 #include <ATen/detail/FunctionTraits.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/cpu/Vectorized.h>
+#include <c10/util/C++17.h>
 
 namespace at { namespace native { namespace {
 
@@ -62,13 +65,19 @@ static inline bool is_reduction(char** data, const int64_t* strides) {
   const char* in1_ptr = data[1]; \
   int64_t s0 = strides[0], s1 = strides[1];
 
-#define UNARY_VEC_HEADER(func_t) \
+// The vector type is the one the vectorized op works on, which is either
+// Vec256<scalar_t> or, for kernels written against Vectorized<scalar_t>, the
+// widest vector type of the CPU capability.
+#define VEC_TYPE(vec_func_t) \
+  typename std::decay<typename function_traits<vec_func_t>::result_type>::type
+
+#define UNARY_VEC_HEADER(func_t, vec_func_t) \
   using traits = unary_function_traits<func_t>; \
   using scalar_t = typename traits::result_type; \
-  using Vec = Vec256<scalar_t>;
+  using Vec = VEC_TYPE(vec_func_t);
 
-#define UNARY_VEC_LOOP_HEADER(func_t, data) \
-  UNARY_VEC_HEADER(func_t) \
+#define UNARY_VEC_LOOP_HEADER(func_t, vec_func_t, data) \
+  UNARY_VEC_HEADER(func_t, vec_func_t) \
   char* out_ptr = data[0]; \
   const char* in1_ptr = data[1];
 
@@ -82,13 +91,13 @@ static inline bool is_reduction(char** data, const int64_t* strides) {
   const char* in2_ptr = data[2]; \
   int64_t s0 = strides[0], s1 = strides[1], s2 = strides[2];
 
-#define VEC_HEADER(func_t) \
+#define VEC_HEADER(func_t, vec_func_t) \
   using traits = binary_function_traits<func_t>; \
   using scalar_t = typename traits::result_type; \
-  using Vec = Vec256<scalar_t>;
+  using Vec = VEC_TYPE(vec_func_t);
 
-#define VEC_LOOP_HEADER(func_t, data) \
-  VEC_HEADER(func_t) \
+#define VEC_LOOP_HEADER(func_t, vec_func_t, data) \
+  VEC_HEADER(func_t, vec_func_t) \
   char* out_ptr = data[0]; \
   const char* in1_ptr = data[1]; \
   const char* in2_ptr = data[2];
@@ -108,7 +117,7 @@ static inline void unary_loop(char** data, const int64_t* strides, int64_t i, in
 // computes out = op(in1)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_unary_loop(char** data, int64_t n, func_t op, vec_func_t vop) {
-  UNARY_VEC_LOOP_HEADER(func_t, data)
+  UNARY_VEC_LOOP_HEADER(func_t, vec_func_t, data)
   int64_t i = 0;
   for (; i <= n - 2 * Vec::size(); i += 2 * Vec::size()) {
     auto a1 = Vec::loadu(in1_ptr + i * sizeof(scalar_t));
@@ -138,7 +147,7 @@ static inline void binary_loop(char** data, const int64_t* strides, int64_t i, i
 // computes out = op(in1, in2)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_binary_loop(char** data, int64_t n, func_t op, vec_func_t vop) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
   int64_t i = 0;
   for (; i <= n - 2 * Vec::size(); i += 2 * Vec::size()) {
     auto a1 = Vec::loadu(in1_ptr + i * sizeof(scalar_t));
@@ -157,7 +166,7 @@ static inline void vectorized_binary_loop(char** data, int64_t n, func_t op, vec
 // computes out = op(in1, in2) where in1 is a constant
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_binary_loop_s1(char** data, int64_t n, func_t op, vec_func_t vop) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
   int64_t i = 0;
   auto a = Vec(*(scalar_t*)in1_ptr);
   for (; i <= n - 2 * Vec::size(); i += 2 * Vec::size()) {
@@ -175,7 +184,7 @@ static inline void vectorized_binary_loop_s1(char** data, int64_t n, func_t op,
 // computes out = op(in1, in2) where in2 is a constant
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_binary_loop_s2(char** data, int64_t n, func_t op, vec_func_t vop) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
   int64_t i = 0;
   auto b = Vec(*(scalar_t*)in2_ptr);
   for (; i <= n - 2 * Vec::size(); i += 2 * Vec::size()) {
@@ -192,7 +201,7 @@ static inline void vectorized_binary_loop_s2(char** data, int64_t n, func_t op,
 
 template <typename func_t, typename vec_func_t>
 static inline void reduction128(char** data, int64_t n, int64_t stride, func_t op, vec_func_t vop, bool reduce) {
-  VEC_HEADER(func_t)
+  VEC_HEADER(func_t, vec_func_t)
   char* out_ptr = data[0];
   char* in_ptr = data[1];
   Vec acc[4];
@@ -224,6 +233,21 @@ static inline void reduction128(char** data, int64_t n, int64_t stride, func_t o
   }
 }
 
+// computes out[0:Vec::size()] = op(out, reduce(in, dim=0)) for n rows of a
+// single vector column; used for the columns left over by reduction128
+template <typename func_t, typename vec_func_t>
+static inline void reduction_vec(char** data, int64_t n, int64_t stride, func_t op, vec_func_t vop) {
+  VEC_HEADER(func_t, vec_func_t)
+  char* out_ptr = data[0];
+  char* in_ptr = data[1];
+  Vec acc = Vec::loadu(in_ptr);
+  for (int64_t i = 1; i < n; i++) {
+    acc = vop(acc, Vec::loadu(in_ptr + stride * i));
+  }
+  acc = vop(acc, Vec::loadu(out_ptr));
+  acc.store(out_ptr);
+}
+
 template <typename F>
 static inline void UNARY_OUTER_LOOP(char* data[2], const int64_t strides[2], int64_t n, F f) {
   for (int j = 0; j < n; j++) {
@@ -236,7 +260,7 @@ static inline void UNARY_OUTER_LOOP(char* data[2], const int64_t strides[2], int
 // computes the reduction out = op(out, in)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_inner_reduction(char** data, int64_t n, func_t op, vec_func_t vop) {
-  VEC_HEADER(func_t)
+  VEC_HEADER(func_t, vec_func_t)
   int64_t vector_stride = 4 * Vec::size() * sizeof(scalar_t);
   int64_t count = n / (4 * Vec::size());
   if (count > 0) {
@@ -250,17 +274,25 @@ static inline void vectorized_inner_reduction(char** data, int64_t n, func_t op,
 // computes the reduction out = op(out, in)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_outer_reduction(char** data, int64_t inner_stride, int64_t size0, int64_t size1, func_t op, vec_func_t vop) {
-  VEC_HEADER(func_t)
+  VEC_HEADER(func_t, vec_func_t)
 
-  // reduce down each column of 4 * Vec::size() elements (128 bytes)
-  int64_t outer_stride[2] = { 128, 128 };
+  // reduce down each column of 4 * Vec::size() elements (128 bytes for
+  // Vec256, 256 bytes for Vec512)
+  int64_t outer_stride[2] = { 4 * Vec::size() * sizeof(scalar_t),
+                              4 * Vec::size() * sizeof(scalar_t) };
   UNARY_OUTER_LOOP(data, outer_stride, size1 / (4 * Vec::size()), [&] {
     reduction128(data, size0, inner_stride, op, vop, /*reduce=*/false);
   });
 
-  // reduce down the remaining columns
-  int64_t step[] = { sizeof(scalar_t), sizeof(scalar_t) };
+  // reduce down the remaining columns, one vector at a time while possible
+  int64_t vec_step[] = { Vec::size() * sizeof(scalar_t), Vec::size() * sizeof(scalar_t) };
   int64_t remaining = size1 % (4 * Vec::size());
+  UNARY_OUTER_LOOP(data, vec_step, remaining / Vec::size(), [&] {
+    reduction_vec(data, size0, inner_stride, op, vop);
+  });
+
+  int64_t step[] = { sizeof(scalar_t), sizeof(scalar_t) };
+  remaining = remaining % Vec::size();
   UNARY_OUTER_LOOP(data, step, remaining, [&] {
     char* ptrs[3] = { data[0], data[0], data[1] };
     int64_t strides[] = { 0, 0, inner_stride };
@@ -344,4 +376,162 @@ void binary_kernel_vec(TensorIterator& iter, func_t op, vec_func_t vop) {
   });
 }
 
+// Kernels with multiple outputs. The scalar op takes one argument per input
+// and returns a std::tuple with one element per output; the operands of the
+// iterator are the outputs followed by the inputs, in the same order. All
+// outputs are computed in a single pass over the inputs, e.g.
+//
+//   multiple_outputs_kernel(iter, [](float a, float b) {
+//     return std::make_tuple(a + b, a * b);
+//   });
+
+template <typename traits, std::size_t... I>
+static inline std::tuple<typename std::decay<typename traits::template arg<I>::type>::type...>
+dereference_impl(char** data, const int64_t* strides, int64_t i,
+                 c10::guts::index_sequence<I...>) {
+  return std::make_tuple(
+      *(typename std::decay<typename traits::template arg<I>::type>::type*)
+          (data[I] + i * strides[I])...);
+}
+
+// loads the i-th element of every input of a function with `traits`
+template <typename traits>
+static inline auto dereference(char** data, const int64_t* strides, int64_t i)
+    -> decltype(dereference_impl<traits>(data, strides, i,
+          c10::guts::make_index_sequence<traits::arity>{})) {
+  return dereference_impl<traits>(data, strides, i,
+      c10::guts::make_index_sequence<traits::arity>{});
+}
+
+template <typename tuple_t, std::size_t... I>
+static inline void store_outputs_impl(char** data, const int64_t* strides, int64_t i,
+                                      const tuple_t& outputs,
+                                      c10::guts::index_sequence<I...>) {
+  // one store per output; the initializer list only sequences them
+  (void)std::initializer_list<int>{
+      (*(typename std::tuple_element<I, tuple_t>::type*)(data[I] + i * strides[I]) =
+           std::get<I>(outputs), 0)...};
+}
+
+template <typename tuple_t>
+static inline void store_outputs(char** data, const int64_t* strides, int64_t i,
+                                 const tuple_t& outputs) {
+  store_outputs_impl(data, strides, i, outputs,
+      c10::guts::make_index_sequence<std::tuple_size<tuple_t>::value>{});
+}
+
+template <typename vec_traits, std::size_t... I>
+static inline std::tuple<typename std::decay<typename vec_traits::template arg<I>::type>::type...>
+load_vec_impl(char** data, int64_t offset, c10::guts::index_sequence<I...>) {
+  return std::make_tuple(
+      std::decay<typename vec_traits::template arg<I>::type>::type::loadu(
+          data[I] + offset)...);
+}
+
+// loads a vector at byte `offset` from every input of a vectorized function
+// with `vec_traits`
+template <typename vec_traits>
+static inline auto load_vec(char** data, int64_t offset)
+    -> decltype(load_vec_impl<vec_traits>(data, offset,
+          c10::guts::make_index_sequence<vec_traits::arity>{})) {
+  return load_vec_impl<vec_traits>(data, offset,
+      c10::guts::make_index_sequence<vec_traits::arity>{});
+}
+
+template <typename tuple_t, std::size_t... I>
+static inline void store_vec_impl(char** data, int64_t offset, const tuple_t& outputs,
+                                  c10::guts::index_sequence<I...>) {
+  (void)std::initializer_list<int>{
+      (std::get<I>(outputs).store(data[I] + offset), 0)...};
+}
+
+template <typename tuple_t>
+static inline void store_vec(char** data, int64_t offset, const tuple_t& outputs) {
+  store_vec_impl(data, offset, outputs,
+      c10::guts::make_index_sequence<std::tuple_size<tuple_t>::value>{});
+}
+
+// Basic loop for an op with multiple outputs. May be auto-vectorized by the
+// compiler.
+template <typename func_t>
+static inline void multiple_outputs_loop(char** data, const int64_t* strides, int64_t i, int64_t n, func_t op) {
+  using traits = function_traits<func_t>;
+  constexpr int noutputs = std::tuple_size<typename traits::result_type>::value;
+  for (; i < n; i++) {
+    auto outputs = c10::guts::apply(
+        op, dereference<traits>(data + noutputs, strides + noutputs, i));
+    store_outputs(data, strides, i, outputs);
+  }
+}
+
+// computes (out1, out2, ...) = op(in1, in2, ...) where all operands are
+// contiguous
+template <typename func_t, typename vec_func_t>
+static inline void vectorized_multiple_outputs_loop(char** data, int64_t n, func_t op, vec_func_t vop) {
+  using traits = function_traits<func_t>;
+  using vec_traits = function_traits<vec_func_t>;
+  using scalar_t = typename std::decay<typename traits::template arg<0>::type>::type;
+  using Vec = typename std::decay<typename std::tuple_element<
+      0, typename vec_traits::result_type>::type>::type;
+  constexpr int noutputs = std::tuple_size<typename traits::result_type>::value;
+  constexpr int ntensors = noutputs + traits::arity;
+  int64_t i = 0;
+  for (; i <= n - 2 * Vec::size(); i += 2 * Vec::size()) {
+    auto out1 = c10::guts::apply(
+        vop, load_vec<vec_traits>(data + noutputs, i * sizeof(scalar_t)));
+    auto out2 = c10::guts::apply(
+        vop, load_vec<vec_traits>(data + noutputs, (i + Vec::size()) * sizeof(scalar_t)));
+    store_vec(data, i * sizeof(scalar_t), out1);
+    store_vec(data, (i + Vec::size()) * sizeof(scalar_t), out2);
+  }
+  int64_t strides[ntensors];
+  for (int arg = 0; arg < ntensors; arg++) {
+    strides[arg] = sizeof(scalar_t);
+  }
+  multiple_outputs_loop(data, strides, i, n, op);
+}
+
+template <typename func_t>
+static inline void check_multiple_outputs_kernel(const TensorIterator& iter) {
+  using traits = function_traits<func_t>;
+  constexpr int noutputs = std::tuple_size<typename traits::result_type>::value;
+  constexpr int ninputs = traits::arity;
+  AT_ASSERTM(
+      iter.noutputs() == noutputs,
+      "expected ", noutputs, " outputs, but the iterator has ", iter.noutputs());
+  AT_ASSERTM(
+      iter.ninputs() == ninputs,
+      "expected ", ninputs, " inputs, but the iterator has ", iter.ninputs());
+}
+
+template <typename func_t>
+void multiple_outputs_kernel(TensorIterator& iter, func_t op) {
+  check_multiple_outputs_kernel<func_t>(iter);
+
+  iter.for_each([&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+    multiple_outputs_loop(data, strides, 0, n, op);
+  });
+}
+
+// The vectorized op takes and returns Vec256<scalar_t> or Vectorized<scalar_t>
+// in place of every scalar_t; all operands must have the same scalar type.
+template <typename func_t, typename vec_func_t>
+void multiple_outputs_kernel_vec(TensorIterator& iter, func_t op, vec_func_t vop) {
+  using traits = function_traits<func_t>;
+  using scalar_t = typename std::decay<typename traits::template arg<0>::type>::type;
+  check_multiple_outputs_kernel<func_t>(iter);
+
+  iter.for_each([&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+    bool contiguous = true;
+    for (int arg = 0; arg < ntensor; arg++) {
+      contiguous = contiguous && strides[arg] == sizeof(scalar_t);
+    }
+    if (contiguous) {
+      vectorized_multiple_outputs_loop(data, n, op, vop);
+    } else {
+      multiple_outputs_loop(data, strides, 0, n, op);
+    }
+  });
+}
+
 }}}  // namespace at::native::<anonymous>
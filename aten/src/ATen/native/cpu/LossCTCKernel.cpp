@@ -0,0 +1,355 @@
+// CPU kernels of the Connectionist Temporal Loss, see LossCTC.cpp for the
+// references and the notation (l' is the extended target, of length
+// 2 * target_length + 1, with blanks at the even positions).
+//
+// For a given t, the alphas (and betas) of all positions s only depend on
+// those of t - 1 (t + 1), so every time step is a vectorized log-sum-exp over
+// the row of the previous one. The recursion over t is sequential, and a row
+// (at most a few hundred positions for common targets) is too short to be
+// split among threads, so the recursions are parallelized over the batch,
+// while the gradient wrap-up, which dominates for large label sets, is
+// parallelized over all (t, b) rows.
+
+#include <ATen/native/cpu/LossCTCKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+template <typename scalar_t>
+inline Vec256<scalar_t> load(const scalar_t* ptr, int64_t count) {
+  using Vec = Vec256<scalar_t>;
+  return count == Vec::size() ? Vec::loadu(ptr) : Vec::loadu(ptr, count);
+}
+
+// The extended target of one sample. skip[s] is 0 if the transition
+// s - 2 -> s is allowed (l'[s] is not a blank and differs from l'[s - 2]),
+// and -inf otherwise, so that it can simply be added to a log-probability.
+template <typename scalar_t>
+struct ExtendedTarget {
+  std::vector<int64_t> labels;
+  std::vector<scalar_t> skip;
+
+  template <typename target_t>
+  ExtendedTarget(const target_t* targets, int64_t offset, int64_t stride,
+                 int64_t target_length, int64_t BLANK)
+    : labels(2 * target_length + 1, BLANK),
+      skip(2 * target_length + 1, -std::numeric_limits<scalar_t>::infinity()) {
+    for (int64_t i = 0; i < target_length; i++) {
+      labels[2 * i + 1] = targets[offset + stride * i];
+    }
+    for (int64_t s = 3; s < (int64_t) labels.size(); s += 2) {
+      if (labels[s] != labels[s - 2]) {
+        skip[s] = 0;
+      }
+    }
+  }
+
+  int64_t size() const {
+    return labels.size();
+  }
+};
+
+// log(exp(a) + exp(b)), and -inf if both are -inf. Clamping the maximum to
+// the lowest finite value avoids computing -inf - -inf.
+template <typename scalar_t>
+inline scalar_t log_sum_exp2(scalar_t a, scalar_t b) {
+  scalar_t m = std::max(std::max(a, b), std::numeric_limits<scalar_t>::lowest());
+  return std::log(std::exp(a - m) + std::exp(b - m)) + m;
+}
+
+// out[i] = log(exp(a1[i]) + exp(a2[i]) + exp(a3[i] + mask3[i])) + lp[i]
+template <typename scalar_t>
+void log_sum_exp3_row(scalar_t* out, const scalar_t* a1, const scalar_t* a2,
+                      const scalar_t* a3, const scalar_t* mask3, const scalar_t* lp,
+                      int64_t n) {
+  using Vec = Vec256<scalar_t>;
+  const Vec lowest(std::numeric_limits<scalar_t>::lowest());
+  for (int64_t i = 0; i < n; i += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), n - i);
+    const Vec v1 = load(a1 + i, count);
+    const Vec v2 = load(a2 + i, count);
+    const Vec v3 = load(a3 + i, count) + load(mask3 + i, count);
+    const Vec m = maximum(maximum(v1, v2), maximum(v3, lowest));
+    const Vec r = ((v1 - m).exp() + (v2 - m).exp() + (v3 - m).exp()).log() + m + load(lp + i, count);
+    r.store(out + i, count);
+  }
+}
+
+// lp_ext[s] = log_probs[t][l'[s]]
+template <typename scalar_t>
+inline void gather_log_probs(scalar_t* lp_ext, const TensorAccessor<scalar_t, 2>& log_probs_a,
+                             int64_t t, const ExtendedTarget<scalar_t>& target) {
+  for (int64_t s = 0; s < target.size(); s++) {
+    lp_ext[s] = log_probs_a[t][target.labels[s]];
+  }
+}
+
+template <typename scalar_t, typename target_t>
+void ctc_loss_kernel_impl(
+    Tensor& neg_log_likelihood, Tensor& log_alpha,
+    const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t max_input_length = log_alpha.size(1);
+  const int64_t alpha_row = log_alpha.size(2);
+
+  auto lpp = log_probs.permute({1, 0, 2});
+  auto log_probs_a_global = lpp.accessor<scalar_t, 3>();
+  scalar_t* log_alpha_data = log_alpha.data<scalar_t>();
+  const target_t* targets_data = targets.data<target_t>();
+  scalar_t* nll_data = neg_log_likelihood.data<scalar_t>();
+
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    std::vector<scalar_t> lp_ext;
+    for (int64_t b = start; b < end; b++) {
+      const int64_t input_length = input_lengths[b];
+      const int64_t target_length = target_lengths[b];
+      auto log_probs_a = log_probs_a_global[b];
+      scalar_t* la = log_alpha_data + b * max_input_length * alpha_row;
+      const ExtendedTarget<scalar_t> target(targets_data, tg_batch_offsets[b], tg_target_stride,
+                                            target_length, BLANK);
+      const int64_t S = target.size();
+      lp_ext.resize(S);
+
+      // the alphas for t = 0, the three equations for alpha_1 above eq (6)
+      if (input_length > 0) {
+        std::fill(la, la + alpha_row, neginf);
+        la[0] = log_probs_a[0][BLANK];
+        if (target_length > 0) {
+          la[1] = log_probs_a[0][target.labels[1]];
+        }
+      }
+
+      // eq (6) and (7) for all s of one t at a time
+      for (int64_t t = 1; t < input_length; t++) {
+        const scalar_t* prev = la + (t - 1) * alpha_row;
+        scalar_t* cur = la + t * alpha_row;
+        gather_log_probs(lp_ext.data(), log_probs_a, t, target);
+        cur[0] = prev[0] + lp_ext[0];
+        if (S > 1) {
+          cur[1] = log_sum_exp2(prev[1], prev[0]) + lp_ext[1];
+        }
+        if (S > 2) {
+          log_sum_exp3_row(cur + 2, prev + 2, prev + 1, prev, target.skip.data() + 2,
+                           lp_ext.data() + 2, S - 2);
+        }
+      }
+
+      // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
+      if (input_length == 0) {
+        nll_data[b] = target_length == 0 ? 0 : std::numeric_limits<scalar_t>::infinity();
+      } else {
+        const scalar_t* last = la + (input_length - 1) * alpha_row;
+        nll_data[b] = target_length == 0 ? -last[0] : -log_sum_exp2(last[S - 1], last[S - 2]);
+      }
+    }
+  });
+}
+
+template <typename scalar_t, typename target_t>
+void ctc_loss_backward_kernel_impl(
+    Tensor& grad, const Tensor& grad_out,
+    const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+    const Tensor& neg_log_likelihood, const Tensor& log_alpha,
+    int64_t BLANK, bool zero_infinity) {
+  using Vec = Vec256<scalar_t>;
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  constexpr scalar_t inf = std::numeric_limits<scalar_t>::infinity();
+  const scalar_t lowest = std::numeric_limits<scalar_t>::lowest();
+  const int64_t max_input_length = log_probs.size(0);
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t num_labels = log_probs.size(2);
+  const int64_t alpha_row = log_alpha.size(2);
+
+  auto lpp = log_probs.permute({1, 0, 2});
+  auto log_probs_a_global = lpp.accessor<scalar_t, 3>();
+  const scalar_t* log_alpha_data = log_alpha.data<scalar_t>();
+  const target_t* targets_data = targets.data<target_t>();
+  auto nll_a = neg_log_likelihood.accessor<scalar_t, 1>();
+  auto grad_out_a = grad_out.accessor<scalar_t, 1>();
+  // grad is input_len x batch_size x num_labels
+  scalar_t* grad_data = grad.data<scalar_t>();
+
+  // a) the betas of eq (10) and (11), of which only two rows are kept, and
+  // b) for every t, the logarithm of the sum over the s with l'[s] = c of
+  //    alpha[t][s] * beta[t][s], the collection of eq (16), in grad[t][c]
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    std::vector<scalar_t> beta_next, beta_cur, lp_ext, log_alpha_beta, label_max_ext;
+    std::vector<scalar_t> label_max(num_labels), label_sum(num_labels);
+    for (int64_t b = start; b < end; b++) {
+      const int64_t input_length = input_lengths[b];
+      if (input_length == 0 || (zero_infinity && nll_a[b] == inf)) {
+        continue;
+      }
+      auto log_probs_a = log_probs_a_global[b];
+      const scalar_t* la = log_alpha_data + b * max_input_length * alpha_row;
+      const int64_t target_length = target_lengths[b];
+      const ExtendedTarget<scalar_t> target(targets_data, tg_batch_offsets[b], tg_target_stride,
+                                            target_length, BLANK);
+      const int64_t S = target.size();
+      beta_next.resize(S);
+      beta_cur.resize(S);
+      lp_ext.resize(S);
+      log_alpha_beta.resize(S);
+      label_max_ext.resize(S);
+
+      auto collect = [&](int64_t t) {
+        const scalar_t* alpha = la + t * alpha_row;
+        for (int64_t s = 0; s < S; s += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), S - s);
+          (load(alpha + s, count) + load(beta_cur.data() + s, count)).store(log_alpha_beta.data() + s, count);
+        }
+        // several s share the label c (all the blanks, and repeated
+        // labels), so the log-sum-exp per label is taken in two passes:
+        // the maximum, then the sum of the exponentials relative to it
+        for (int64_t s = 0; s < S; s++) {
+          label_max[target.labels[s]] = neginf;
+          label_sum[target.labels[s]] = 0;
+        }
+        for (int64_t s = 0; s < S; s++) {
+          scalar_t& m = label_max[target.labels[s]];
+          m = std::max(m, log_alpha_beta[s]);
+        }
+        for (int64_t s = 0; s < S; s++) {
+          label_max_ext[s] = std::max(label_max[target.labels[s]], lowest);
+        }
+        for (int64_t s = 0; s < S; s += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), S - s);
+          (load(log_alpha_beta.data() + s, count) - load(label_max_ext.data() + s, count)).exp()
+              .store(log_alpha_beta.data() + s, count);
+        }
+        for (int64_t s = 0; s < S; s++) {
+          label_sum[target.labels[s]] += log_alpha_beta[s];
+        }
+        scalar_t* grad_row = grad_data + (t * batch_size + b) * num_labels;
+        for (int64_t s = 0; s < S; s++) {
+          const int64_t c = target.labels[s];
+          grad_row[c] = std::log(label_sum[c]) + label_max_ext[s];
+        }
+      };
+
+      // the initialization of beta before eq (10)
+      std::fill(beta_cur.begin(), beta_cur.end(), neginf);
+      beta_cur[S - 1] = log_probs_a[input_length - 1][BLANK];
+      if (target_length > 0) {
+        beta_cur[S - 2] = log_probs_a[input_length - 1][target.labels[S - 2]];
+      }
+      collect(input_length - 1);
+
+      // eq (10) and (11) for all s of one t at a time
+      for (int64_t t = input_length - 2; t >= 0; t--) {
+        std::swap(beta_next, beta_cur);
+        const scalar_t* next = beta_next.data();
+        scalar_t* cur = beta_cur.data();
+        gather_log_probs(lp_ext.data(), log_probs_a, t, target);
+        cur[S - 1] = next[S - 1] + lp_ext[S - 1];
+        if (S > 1) {
+          cur[S - 2] = log_sum_exp2(next[S - 2], next[S - 1]) + lp_ext[S - 2];
+        }
+        if (S > 2) {
+          // the transition s + 2 -> s is allowed if s + 2 -> s + 4 is
+          log_sum_exp3_row(cur, next, next + 1, next + 2, target.skip.data() + 2,
+                           lp_ext.data(), S - 2);
+        }
+        collect(t);
+      }
+    }
+  });
+
+  // now grad has the sum of eq (16) for the labels in the targets, and -inf
+  // elsewhere. Wrap up the calculation by adding in the remaining items of
+  // eq (16). Note that the likelihood -nll is the Z of eq (16).
+  const bool lp_contiguous_labels = log_probs.stride(2) == 1;
+  const int64_t rows = max_input_length * batch_size;
+  at::parallel_for(0, rows, std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, num_labels)),
+                   [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      const int64_t t = row / batch_size;
+      const int64_t b = row % batch_size;
+      scalar_t* res = grad_data + row * num_labels;
+      const scalar_t nll = nll_a[b];
+      if (t >= input_lengths[b] || (zero_infinity && nll == inf)) {
+        std::fill(res, res + num_labels, scalar_t(0));
+        continue;
+      }
+      const scalar_t gr = grad_out_a[b];
+      auto lp = log_probs_a_global[b][t];
+      int64_t c = 0;
+      if (lp_contiguous_labels) {
+        const scalar_t* lp_data = lp.data();
+        const Vec nll_vec(nll);
+        const Vec gr_vec(gr);
+        for (; c < num_labels; c += Vec::size()) {
+          const int64_t count = std::min<int64_t>(Vec::size(), num_labels - c);
+          const Vec lp_vec = load(lp_data + c, count);
+          const Vec r = (lp_vec.exp() - (load(res + c, count) + nll_vec - lp_vec).exp()) * gr_vec;
+          r.store(res + c, count);
+        }
+      } else {
+        for (; c < num_labels; c++) {
+          res[c] = (std::exp(lp[c]) - std::exp(res[c] + nll - lp[c])) * gr;
+        }
+      }
+    }
+  });
+}
+
+void ctc_loss_kernel(
+    Tensor& neg_log_likelihood, Tensor& log_alpha,
+    const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets, int64_t tg_target_stride, int64_t BLANK) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_kernel_impl<scalar_t, int64_t>(neg_log_likelihood, log_alpha, log_probs, targets,
+                                              input_lengths, target_lengths, tg_batch_offsets,
+                                              tg_target_stride, BLANK);
+    } else {
+      ctc_loss_kernel_impl<scalar_t, int>(neg_log_likelihood, log_alpha, log_probs, targets,
+                                          input_lengths, target_lengths, tg_batch_offsets,
+                                          tg_target_stride, BLANK);
+    }
+  });
+}
+
+void ctc_loss_backward_kernel(
+    Tensor& grad, const Tensor& grad_out,
+    const Tensor& log_probs, const Tensor& targets,
+    IntArrayRef input_lengths, IntArrayRef target_lengths,
+    IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+    const Tensor& neg_log_likelihood, const Tensor& log_alpha,
+    int64_t BLANK, bool zero_infinity) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_backward_kernel_impl<scalar_t, int64_t>(
+          grad, grad_out, log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+          tg_target_stride, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+    } else {
+      ctc_loss_backward_kernel_impl<scalar_t, int>(
+          grad, grad_out, log_probs, targets, input_lengths, target_lengths, tg_batch_offsets,
+          tg_target_stride, neg_log_likelihood, log_alpha, BLANK, zero_infinity);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(ctc_loss_stub, &ctc_loss_kernel);
+REGISTER_DISPATCH(ctc_loss_backward_stub, &ctc_loss_backward_kernel);
+
+}} // namespace at::native
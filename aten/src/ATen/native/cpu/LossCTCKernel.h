@@ -0,0 +1,29 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// The alpha and beta recursions of the CTC loss on CPU. log_probs is
+// input_len x batch_size x num_labels, and the target of sample b starts at
+// targets_data + tg_batch_offsets[b] with a stride of tg_target_stride
+// elements. log_alpha is a contiguous batch_size x input_len x
+// (2 * max_target_length + 1) tensor, written by the forward and read by the
+// backward, and grad is a contiguous tensor of the size of log_probs.
+using ctc_loss_fn = void(*)(Tensor & neg_log_likelihood, Tensor & log_alpha,
+                            const Tensor & log_probs, const Tensor & targets,
+                            IntArrayRef input_lengths, IntArrayRef target_lengths,
+                            IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+                            int64_t BLANK);
+using ctc_loss_backward_fn = void(*)(Tensor & grad, const Tensor & grad_out,
+                                     const Tensor & log_probs, const Tensor & targets,
+                                     IntArrayRef input_lengths, IntArrayRef target_lengths,
+                                     IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+                                     const Tensor & neg_log_likelihood, const Tensor & log_alpha,
+                                     int64_t BLANK, bool zero_infinity);
+
+DECLARE_DISPATCH(ctc_loss_fn, ctc_loss_stub);
+DECLARE_DISPATCH(ctc_loss_backward_fn, ctc_loss_backward_stub);
+
+}} // namespace at::native
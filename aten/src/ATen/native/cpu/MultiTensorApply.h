@@ -0,0 +1,90 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace at { namespace native { namespace {
+
+// The number of elements of the chunks multi_tensor_apply splits the
+// tensors into.
+constexpr int64_t kMultiTensorApplyChunkSize = internal::GRAIN_SIZE;
+
+// Calls op(ptrs, n) on chunks of `depth` lists of contiguous tensors, in
+// parallel, where ptrs[d] points to the start of the chunk in the tensor of
+// lists[d] and n is the number of elements of the chunk (at most
+// kMultiTensorApplyChunkSize). The tensors at the same index of the lists must
+// have the same number of elements. A list may be empty, in which case its
+// pointers are nullptr.
+//
+// Chunks of all the tensors are distributed over the threads together, so a
+// list of many small tensors is processed in a single parallel region instead
+// of one small region per tensor.
+template <int depth, typename scalar_t, typename Op>
+void multi_tensor_apply(const std::array<TensorList, depth>& lists, const Op& op) {
+  const auto& tensors = lists[0];
+  std::vector<std::array<scalar_t*, depth>> data(tensors.size());
+  std::vector<std::pair<size_t, int64_t>> chunks;
+  for (size_t t = 0; t < tensors.size(); ++t) {
+    for (int d = 0; d < depth; ++d) {
+      data[t][d] = lists[d].empty() ? nullptr : lists[d][t].template data<scalar_t>();
+    }
+    const auto numel = tensors[t].numel();
+    for (int64_t start = 0; start < numel;
+         start += kMultiTensorApplyChunkSize) {
+      chunks.emplace_back(t, start);
+    }
+  }
+  parallel_for(0, chunks.size(), 1, [&](int64_t begin, int64_t end) {
+    std::array<scalar_t*, depth> ptrs;
+    for (int64_t c = begin; c < end; ++c) {
+      const auto t = chunks[c].first;
+      const auto start = chunks[c].second;
+      for (int d = 0; d < depth; ++d) {
+        ptrs[d] = data[t][d] ? data[t][d] + start : nullptr;
+      }
+      op(ptrs,
+         std::min(kMultiTensorApplyChunkSize, tensors[t].numel() - start));
+    }
+  });
+}
+
+// Reduces the elements of a list of contiguous tensors in parallel, where
+// op(ptr, n) reduces the n elements at ptr of a chunk (at most
+// kMultiTensorApplyChunkSize) into an acc_t. The results of the chunks are
+// combined with combine(a, b) in the order of the chunks, starting from
+// identity, so that the result does not depend on the number of threads.
+template <typename scalar_t, typename acc_t, typename Op, typename Combine>
+acc_t multi_tensor_reduce(
+    TensorList tensors,
+    acc_t identity,
+    const Op& op,
+    const Combine& combine) {
+  std::vector<std::pair<const scalar_t*, int64_t>> chunks;
+  for (const auto& tensor : tensors) {
+    const auto data = tensor.template data<scalar_t>();
+    const auto numel = tensor.numel();
+    for (int64_t start = 0; start < numel;
+         start += kMultiTensorApplyChunkSize) {
+      chunks.emplace_back(
+          data + start, std::min(kMultiTensorApplyChunkSize, numel - start));
+    }
+  }
+  std::vector<acc_t> partials(chunks.size(), identity);
+  parallel_for(0, chunks.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; ++c) {
+      partials[c] = op(chunks[c].first, chunks[c].second);
+    }
+  });
+  acc_t result = identity;
+  for (const auto& partial : partials) {
+    result = combine(result, partial);
+  }
+  return result;
+}
+
+}}} // namespace at::native::<anonymous>
@@ -0,0 +1,65 @@
+#include <ATen/native/MultiTensorNorm.h>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/cpu/MultiTensorApply.h>
+
+#include <cmath>
+
+namespace at { namespace native { namespace {
+
+Tensor multi_tensor_norm_kernel(TensorList tensors, double norm_type) {
+  Tensor result;
+  AT_DISPATCH_FLOATING_TYPES(tensors.front().scalar_type(), "multi_tensor_norm_cpu", [&] {
+    using acc_t = acc_type<scalar_t, false>;
+    const bool inf = std::isinf(norm_type);
+    const acc_t p = norm_type;
+    const acc_t value = multi_tensor_reduce<scalar_t, acc_t>(
+        tensors,
+        0,
+        [&](const scalar_t* data, int64_t n) {
+          acc_t partial = 0;
+          for (int64_t i = 0; i < n; ++i) {
+            const acc_t x = std::abs(static_cast<acc_t>(data[i]));
+            if (inf) {
+              // Propagates NaNs, like max().
+              partial = (x > partial || std::isnan(x)) ? x : partial;
+            } else if (p == 2) {
+              partial += x * x;
+            } else if (p == 1) {
+              partial += x;
+            } else {
+              partial += std::pow(x, p);
+            }
+          }
+          return partial;
+        },
+        [&](acc_t a, acc_t b) {
+          if (inf) {
+            return (b > a || std::isnan(b)) ? b : a;
+          }
+          return a + b;
+        });
+    result = at::full({1}, value, tensors.front().options().dtype(kDouble));
+  });
+  return result;
+}
+
+void multi_tensor_scale_kernel(TensorList tensors, const Tensor& scale) {
+  AT_DISPATCH_FLOATING_TYPES(tensors.front().scalar_type(), "multi_tensor_scale_cpu", [&] {
+    const auto factor = static_cast<scalar_t>(scale.item<double>());
+    multi_tensor_apply<1, scalar_t>(
+        {{tensors}}, [&](const std::array<scalar_t*, 1>& ptrs, int64_t n) {
+          for (int64_t i = 0; i < n; ++i) {
+            ptrs[0][i] *= factor;
+          }
+        });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(multi_tensor_norm_stub, &multi_tensor_norm_kernel);
+REGISTER_DISPATCH(multi_tensor_scale_stub, &multi_tensor_scale_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,236 @@
+#include <ATen/native/cpu/RNNKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// All kernels below walk a row of `hidden_size` elements in vectors; the last
+// vector of a row is loaded and stored partially.
+template <typename scalar_t>
+inline Vec256<scalar_t> load(const scalar_t* ptr, int64_t count) {
+  using Vec = Vec256<scalar_t>;
+  return count == Vec::size() ? Vec::loadu(ptr) : Vec::loadu(ptr, count);
+}
+
+// Undefined biases and output gradients are read as zeros.
+template <typename scalar_t>
+inline Vec256<scalar_t> load_or_zero(const scalar_t* ptr, int64_t count) {
+  return ptr ? load(ptr, count) : Vec256<scalar_t>(0);
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(const Vec256<scalar_t>& x) {
+  const Vec256<scalar_t> one(1);
+  return one / (one + x.neg().exp());
+}
+
+template <typename scalar_t>
+inline const scalar_t* data_or_null(const Tensor& t) {
+  return t.defined() ? t.data<scalar_t>() : nullptr;
+}
+
+inline int64_t grain_size(int64_t row_size) {
+  return std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(1, row_size));
+}
+
+void lstm_cell_fused_kernel(
+    Tensor& hy, Tensor& cy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias,
+    const Tensor& cx) {
+  const int64_t batch = cx.size(0);
+  const int64_t hsz = cx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_fused", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* igates = input_gates.data<scalar_t>();
+    const scalar_t* hgates = hidden_gates.data<scalar_t>();
+    const scalar_t* b1 = data_or_null<scalar_t>(input_bias);
+    const scalar_t* b2 = data_or_null<scalar_t>(hidden_bias);
+    const scalar_t* cx_data = cx.data<scalar_t>();
+    scalar_t* hy_data = hy.data<scalar_t>();
+    scalar_t* cy_data = cy.data<scalar_t>();
+    scalar_t* ws = workspace.data<scalar_t>();
+
+    parallel_for(0, batch, grain_size(4 * hsz), [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        const scalar_t* ig_row = igates + b * 4 * hsz;
+        const scalar_t* hg_row = hgates + b * 4 * hsz;
+        scalar_t* ws_row = ws + b * 4 * hsz;
+        for (int64_t j = 0; j < hsz; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+          Vec gates[4];
+          for (int64_t k = 0; k < 4; k++) {
+            const int64_t off = k * hsz + j;
+            gates[k] = load(ig_row + off, n) + load(hg_row + off, n) +
+                load_or_zero(b1 ? b1 + off : nullptr, n) +
+                load_or_zero(b2 ? b2 + off : nullptr, n);
+          }
+          const Vec ig = sigmoid(gates[0]);
+          const Vec fg = sigmoid(gates[1]);
+          const Vec cg = gates[2].tanh();
+          const Vec og = sigmoid(gates[3]);
+          const Vec c = fg * load(cx_data + b * hsz + j, n) + ig * cg;
+          const Vec h = og * c.tanh();
+          c.store(cy_data + b * hsz + j, n);
+          h.store(hy_data + b * hsz + j, n);
+          ig.store(ws_row + 0 * hsz + j, n);
+          fg.store(ws_row + 1 * hsz + j, n);
+          cg.store(ws_row + 2 * hsz + j, n);
+          og.store(ws_row + 3 * hsz + j, n);
+        }
+      }
+    });
+  });
+}
+
+void lstm_cell_fused_backward_kernel(
+    Tensor& grad_gates, Tensor& grad_cx,
+    const Tensor& grad_hy, const Tensor& grad_cy,
+    const Tensor& cx, const Tensor& cy,
+    const Tensor& workspace) {
+  const int64_t batch = cx.size(0);
+  const int64_t hsz = cx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(cx.scalar_type(), "lstm_cell_fused_backward", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* ws = workspace.data<scalar_t>();
+    const scalar_t* gh = data_or_null<scalar_t>(grad_hy);
+    const scalar_t* gc = data_or_null<scalar_t>(grad_cy);
+    const scalar_t* cx_data = cx.data<scalar_t>();
+    const scalar_t* cy_data = cy.data<scalar_t>();
+    scalar_t* gg = grad_gates.data<scalar_t>();
+    scalar_t* gcx_data = grad_cx.data<scalar_t>();
+
+    parallel_for(0, batch, grain_size(4 * hsz), [&](int64_t begin, int64_t end) {
+      const Vec one(1);
+      for (int64_t b = begin; b < end; b++) {
+        const scalar_t* ws_row = ws + b * 4 * hsz;
+        scalar_t* gg_row = gg + b * 4 * hsz;
+        for (int64_t j = 0; j < hsz; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+          const int64_t i = b * hsz + j;
+          const Vec ig = load(ws_row + 0 * hsz + j, n);
+          const Vec fg = load(ws_row + 1 * hsz + j, n);
+          const Vec cg = load(ws_row + 2 * hsz + j, n);
+          const Vec og = load(ws_row + 3 * hsz + j, n);
+          const Vec go = load_or_zero(gh ? gh + i : nullptr, n);
+          const Vec goc = load_or_zero(gc ? gc + i : nullptr, n);
+
+          const Vec tanh_cy = load(cy_data + i, n).tanh();
+          const Vec gcx = go * og * (one - tanh_cy * tanh_cy) + goc;
+          (gcx * cg * (one - ig) * ig).store(gg_row + 0 * hsz + j, n);
+          (gcx * load(cx_data + i, n) * (one - fg) * fg).store(gg_row + 1 * hsz + j, n);
+          (gcx * ig * (one - cg * cg)).store(gg_row + 2 * hsz + j, n);
+          (go * tanh_cy * (one - og) * og).store(gg_row + 3 * hsz + j, n);
+          (gcx * fg).store(gcx_data + i, n);
+        }
+      }
+    });
+  });
+}
+
+void gru_cell_fused_kernel(
+    Tensor& hy, Tensor& workspace,
+    const Tensor& input_gates, const Tensor& hidden_gates,
+    const Tensor& input_bias, const Tensor& hidden_bias,
+    const Tensor& hx) {
+  const int64_t batch = hx.size(0);
+  const int64_t hsz = hx.size(1);
+  AT_DISPATCH_FLOATING_TYPES(hx.scalar_type(), "gru_cell_fused", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* igates = input_gates.data<scalar_t>();
+    const scalar_t* hgates = hidden_gates.data<scalar_t>();
+    const scalar_t* b1 = data_or_null<scalar_t>(input_bias);
+    const scalar_t* b2 = data_or_null<scalar_t>(hidden_bias);
+    const scalar_t* hx_data = hx.data<scalar_t>();
+    scalar_t* hy_data = hy.data<scalar_t>();
+    scalar_t* ws = workspace.data<scalar_t>();
+
+    parallel_for(0, batch, grain_size(3 * hsz), [&](int64_t begin, int64_t end) {
+      for (int64_t b = begin; b < end; b++) {
+        const scalar_t* ig_row = igates + b * 3 * hsz;
+        const scalar_t* hg_row = hgates + b * 3 * hsz;
+        scalar_t* ws_row = ws + b * 5 * hsz;
+        for (int64_t j = 0; j < hsz; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+          Vec in[3], hn[3];
+          for (int64_t k = 0; k < 3; k++) {
+            const int64_t off = k * hsz + j;
+            in[k] = load(ig_row + off, n) + load_or_zero(b1 ? b1 + off : nullptr, n);
+            hn[k] = load(hg_row + off, n) + load_or_zero(b2 ? b2 + off : nullptr, n);
+          }
+          const Vec rg = sigmoid(in[0] + hn[0]);
+          const Vec ig = sigmoid(in[1] + hn[1]);
+          const Vec ng = (in[2] + rg * hn[2]).tanh();
+          const Vec h = load(hx_data + b * hsz + j, n);
+          (ng + ig * (h - ng)).store(hy_data + b * hsz + j, n);
+          rg.store(ws_row + 0 * hsz + j, n);
+          ig.store(ws_row + 1 * hsz + j, n);
+          ng.store(ws_row + 2 * hsz + j, n);
+          h.store(ws_row + 3 * hsz + j, n);
+          hn[2].store(ws_row + 4 * hsz + j, n);
+        }
+      }
+    });
+  });
+}
+
+void gru_cell_fused_backward_kernel(
+    Tensor& grad_input_gates, Tensor& grad_hidden_gates, Tensor& grad_hx,
+    const Tensor& grad_hy, const Tensor& workspace) {
+  const int64_t batch = grad_hy.size(0);
+  const int64_t hsz = grad_hy.size(1);
+  AT_DISPATCH_FLOATING_TYPES(grad_hy.scalar_type(), "gru_cell_fused_backward", [&] {
+    using Vec = Vec256<scalar_t>;
+    const scalar_t* ws = workspace.data<scalar_t>();
+    const scalar_t* gh = grad_hy.data<scalar_t>();
+    scalar_t* gig_data = grad_input_gates.data<scalar_t>();
+    scalar_t* ghg_data = grad_hidden_gates.data<scalar_t>();
+    scalar_t* ghx_data = grad_hx.data<scalar_t>();
+
+    parallel_for(0, batch, grain_size(5 * hsz), [&](int64_t begin, int64_t end) {
+      const Vec one(1);
+      for (int64_t b = begin; b < end; b++) {
+        const scalar_t* ws_row = ws + b * 5 * hsz;
+        scalar_t* gi_row = gig_data + b * 3 * hsz;
+        scalar_t* gh_row = ghg_data + b * 3 * hsz;
+        for (int64_t j = 0; j < hsz; j += Vec::size()) {
+          const int64_t n = std::min<int64_t>(Vec::size(), hsz - j);
+          const int64_t i = b * hsz + j;
+          const Vec rg = load(ws_row + 0 * hsz + j, n);
+          const Vec ig = load(ws_row + 1 * hsz + j, n);
+          const Vec ng = load(ws_row + 2 * hsz + j, n);
+          const Vec hx = load(ws_row + 3 * hsz + j, n);
+          const Vec hn = load(ws_row + 4 * hsz + j, n);
+          const Vec go = load(gh + i, n);
+
+          const Vec gig = go * (hx - ng) * (one - ig) * ig;
+          const Vec gin = go * (one - ig) * (one - ng * ng);
+          const Vec grg = gin * hn * (one - rg) * rg;
+          grg.store(gi_row + 0 * hsz + j, n);
+          gig.store(gi_row + 1 * hsz + j, n);
+          gin.store(gi_row + 2 * hsz + j, n);
+          grg.store(gh_row + 0 * hsz + j, n);
+          gig.store(gh_row + 1 * hsz + j, n);
+          (gin * rg).store(gh_row + 2 * hsz + j, n);
+          (go * ig).store(ghx_data + i, n);
+        }
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_cell_fused_stub, &lstm_cell_fused_kernel);
+REGISTER_DISPATCH(lstm_cell_fused_backward_stub, &lstm_cell_fused_backward_kernel);
+REGISTER_DISPATCH(gru_cell_fused_stub, &gru_cell_fused_kernel);
+REGISTER_DISPATCH(gru_cell_fused_backward_stub, &gru_cell_fused_backward_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Fused gate nonlinearities of one LSTM or GRU step for a batch of
+// contiguous rows. The gates are the sums of the input and hidden
+// projections and the optional (possibly undefined) biases. The workspace
+// layouts match the CUDA kernels: [batch, 4 * hidden] gate activations for
+// LSTM, and [batch, 5 * hidden] holding the reset, input and new gates, hx
+// and the hidden new-gate projection for GRU.
+using lstm_cell_fn = void(*)(Tensor & hy, Tensor & cy, Tensor & workspace,
+                             const Tensor & input_gates, const Tensor & hidden_gates,
+                             const Tensor & input_bias, const Tensor & hidden_bias,
+                             const Tensor & cx);
+// grad_hy and grad_cy may be undefined.
+using lstm_cell_backward_fn = void(*)(Tensor & grad_gates, Tensor & grad_cx,
+                                      const Tensor & grad_hy, const Tensor & grad_cy,
+                                      const Tensor & cx, const Tensor & cy,
+                                      const Tensor & workspace);
+using gru_cell_fn = void(*)(Tensor & hy, Tensor & workspace,
+                            const Tensor & input_gates, const Tensor & hidden_gates,
+                            const Tensor & input_bias, const Tensor & hidden_bias,
+                            const Tensor & hx);
+using gru_cell_backward_fn = void(*)(Tensor & grad_input_gates, Tensor & grad_hidden_gates,
+                                     Tensor & grad_hx, const Tensor & grad_hy,
+                                     const Tensor & workspace);
+
+DECLARE_DISPATCH(lstm_cell_fn, lstm_cell_fused_stub);
+DECLARE_DISPATCH(lstm_cell_backward_fn, lstm_cell_fused_backward_stub);
+DECLARE_DISPATCH(gru_cell_fn, gru_cell_fused_stub);
+DECLARE_DISPATCH(gru_cell_backward_fn, gru_cell_fused_backward_stub);
+
+}} // namespace at::native
@@ -4,7 +4,9 @@
 #include <ATen/Parallel.h>
 #include <c10/util/TypeList.h>
 
+#include <algorithm>
 #include <sstream>
+#include <utility>
 
 namespace at { namespace native { namespace {
 
@@ -30,7 +32,158 @@ struct all_same : c10::guts::conjunction<
   std::is_same<T, Args>...
 > {};
 
-// data_t is the input/output data type.
+template <typename res_t>
+static inline void set_result(const int index, const res_t result, const TensorIterator &iter, const int num_outputs) {
+  if (index < num_outputs) {
+    char *out = (char *) iter.data_ptr(index);
+    *(res_t *) out = result;
+  }
+}
+
+template <typename res_t>
+static inline void set_results(const res_t result, const TensorIterator &iter, const int num_outputs) {
+  AT_ASSERT(num_outputs == 1);
+  set_result(0, result, iter, num_outputs);
+}
+
+template <typename res_t>
+static inline void set_results(const std::pair<res_t, res_t> &result, const TensorIterator &iter, const int num_outputs) {
+  AT_ASSERT(num_outputs >= 1 && num_outputs <= 2);
+  set_result(0, result.first, iter, num_outputs);
+  set_result(1, result.second, iter, num_outputs);
+}
+
+template <typename res_t>
+static inline void store_results(const res_t result, char** out, const int num_outputs) {
+  *(res_t *) out[0] = result;
+}
+
+template <typename res_t>
+static inline void store_results(const std::pair<res_t, res_t> &result, char** out, const int num_outputs) {
+  *(res_t *) out[0] = result.first;
+  if (num_outputs > 1) {
+    *(res_t *) out[1] = result.second;
+  }
+}
+
+// A reduction over the outermost dimension(s) of an input that is contiguous
+// along the first kept dimension, such as sum(dim=0) of a [N, D] tensor.
+// Reducing one output element at a time would walk the input with a stride of
+// D elements; binary_kernel_reduce_columns instead keeps a block of
+// accumulators and walks each row of the block contiguously.
+static inline bool is_column_reduction(const TensorIterator& iter, int64_t input_element_size) {
+  int input = iter.ntensors() - 1;
+  return iter.ninputs() == 1 && iter.ndim() >= 2 && iter.num_reduce_dims() == 1 &&
+         iter.shape()[0] > 1 && iter.shape()[1] > 1 &&
+         iter.strides(input)[1] == input_element_size;
+}
+
+template <typename ops_t, typename acc_t, typename data_t>
+void binary_kernel_reduce_columns(TensorIterator& iter, const ops_t& ops, const acc_t& init) {
+  // number of columns whose accumulators are kept together
+  constexpr int64_t kBlock = 64;
+
+  const int num_outputs = iter.noutputs();
+  const int input = iter.ntensors() - 1;
+  const int ndim = iter.ndim();
+  const auto shape = iter.shape();
+  const int64_t rows = shape[0];
+  const int64_t cols = shape[1];
+  const int64_t row_stride = iter.strides(input)[0];
+  int64_t outer = 1;
+  for (int dim = 2; dim < ndim; dim++) {
+    outer *= shape[dim];
+  }
+
+  auto outer_ptr = [&](int arg, int64_t index) {
+    char* ptr = (char*)iter.data_ptr(arg);
+    for (int dim = 2; dim < ndim; dim++) {
+      ptr += (index % shape[dim]) * iter.strides(arg)[dim];
+      index /= shape[dim];
+    }
+    return ptr;
+  };
+
+  const int64_t col_blocks = (cols + kBlock - 1) / kBlock;
+  const int64_t blocks = outer * col_blocks;
+
+  // With fewer blocks than threads, also split the rows and combine the
+  // partial accumulators of each block afterwards, in row order.
+  int64_t row_chunks = 1;
+  if (iter.numel() >= at::internal::GRAIN_SIZE && at::get_num_threads() > 1 &&
+      !at::in_parallel_region() && blocks < at::get_num_threads()) {
+    int64_t min_rows = std::max<int64_t>(at::internal::GRAIN_SIZE / std::min(cols, kBlock), 1);
+    row_chunks = std::min<int64_t>(
+        (at::get_num_threads() + blocks - 1) / blocks,
+        (rows + min_rows - 1) / min_rows);
+  }
+  std::vector<acc_t> partial(row_chunks > 1 ? blocks * row_chunks * kBlock : 0);
+
+  auto store_block = [&](int64_t block, const acc_t* acc) {
+    int64_t col_begin = (block % col_blocks) * kBlock;
+    int64_t ncols = std::min(kBlock, cols - col_begin);
+    char* out[2] = {nullptr, nullptr};
+    int64_t out_stride[2] = {0, 0};
+    for (int arg = 0; arg < num_outputs; arg++) {
+      out_stride[arg] = iter.strides(arg)[1];
+      out[arg] = outer_ptr(arg, block / col_blocks) + col_begin * out_stride[arg];
+    }
+    for (int64_t j = 0; j < ncols; j++) {
+      store_results(ops.project(acc[j]), out, num_outputs);
+      out[0] += out_stride[0];
+      out[1] += out_stride[1];
+    }
+  };
+
+  int64_t work_per_task = std::max<int64_t>(rows / row_chunks * std::min(cols, kBlock), 1);
+  int64_t grain_size = std::max<int64_t>(at::internal::GRAIN_SIZE / work_per_task, 1);
+  at::parallel_for(0, blocks * row_chunks, grain_size, [&](int64_t begin, int64_t end) {
+    acc_t acc[kBlock];
+    for (int64_t task = begin; task < end; task++) {
+      int64_t block = task / row_chunks;
+      int64_t chunk = task % row_chunks;
+      int64_t col_begin = (block % col_blocks) * kBlock;
+      int64_t ncols = std::min(kBlock, cols - col_begin);
+      int64_t row_begin = rows * chunk / row_chunks;
+      int64_t row_end = rows * (chunk + 1) / row_chunks;
+
+      for (int64_t j = 0; j < ncols; j++) {
+        acc[j] = init;
+      }
+      const char* in = outer_ptr(input, block / col_blocks) +
+                       col_begin * sizeof(data_t) + row_begin * row_stride;
+      for (int64_t row = row_begin; row < row_end; row++) {
+        const data_t* row_data = (const data_t*)in;
+        for (int64_t j = 0; j < ncols; j++) {
+          acc[j] = ops.reduce(acc[j], row_data[j]);
+        }
+        in += row_stride;
+      }
+
+      if (row_chunks == 1) {
+        store_block(block, acc);
+      } else {
+        std::copy(acc, acc + ncols, partial.begin() + task * kBlock);
+      }
+    }
+  });
+
+  if (row_chunks > 1) {
+    acc_t acc[kBlock];
+    for (int64_t block = 0; block < blocks; block++) {
+      auto block_partial = partial.begin() + block * row_chunks * kBlock;
+      std::copy(block_partial, block_partial + kBlock, acc);
+      for (int64_t chunk = 1; chunk < row_chunks; chunk++) {
+        for (int64_t j = 0; j < kBlock; j++) {
+          acc[j] = ops.combine(acc[j], block_partial[chunk * kBlock + j]);
+        }
+      }
+      store_block(block, acc);
+    }
+  }
+}
+
+// data_t is the input data type.
 // acc_t is a type that contains all the necessary data
 // to continue reducing.
 //
@@ -38,7 +191,10 @@ struct all_same : c10::guts::conjunction<
 // the following.
 // reduce: (acc_t, data_t) -> acc_t adds one data point to the accumulated value.
 // combine: (acc_t, acc_t) -> acc_t combines two accumulated values into one.
-// project: acc_t -> data_t finishes the reduction, getting the required output.
+// project: acc_t -> res_t finishes the reduction, getting the required output.
+// res_t is either the output data type, or a std::pair of them for
+// reductions with two outputs (such as var_mean), in which case the
+// iterator may also have a single output that only receives the first one.
 //
 // Additionally, acc_t must be default-constructible:
 // acc_t {} is an identity for combine,
@@ -50,7 +206,9 @@ struct all_same : c10::guts::conjunction<
 //
 // If there is more than one output element,
 // our parallelization strategy is to use one thread for each of them,
-// which means that `combine` will never be called.
+// which means that `combine` will never be called. The exception are
+// column reductions (see is_column_reduction), which are parallelized over
+// blocks of output elements and, if there are too few of those, over rows.
 //
 // If, on the other hand, there is only one, then we split the input into
 // into several pieces, reduce each separately, and then combine them.
@@ -64,7 +222,7 @@ void binary_kernel_reduce(TensorIterator& iter, ops_t ops, init_t init) {
   using c_traits = binary_function_traits<cf_t>;
   using p_traits = unary_function_traits<pf_t>;
   using acc_t = typename p_traits::arg1_t;
-  using data_t = typename p_traits::result_type;
+  using data_t = typename r_traits::arg2_t;
   static_assert(
     all_same<
       acc_t,
@@ -75,19 +233,21 @@ void binary_kernel_reduce(TensorIterator& iter, ops_t ops, init_t init) {
       typename c_traits::arg2_t,
       typename c_traits::result_type>::value,
     "all accumulate types must match");
-  static_assert(
-    std::is_same<data_t, typename r_traits::arg2_t>::value,
-    "all data types must match");
   static_assert(
     std::is_default_constructible<acc_t>::value,
     "the accumulate type must be default-constructible"
   );
+  if (is_column_reduction(iter, sizeof(data_t))) {
+    binary_kernel_reduce_columns<ops_t, acc_t, data_t>(iter, ops, init);
+    return;
+  }
+  const int num_outputs = iter.noutputs();
   iter.foreach_reduced_elt([&](TensorIterator &sub_iter) {
     auto reduction_body = [&](acc_t acc, int64_t begin, int64_t end) -> acc_t {
-      sub_iter.serial_for_each([&acc, &ops](int ntensors, char** data, const int64_t* strides, int64_t size) {
-        AT_ASSERT(ntensors == 2);
-        char *in = data[1];
-        int64_t stride = strides[1];
+      sub_iter.serial_for_each([&acc, &ops, num_outputs](int ntensors, char** data, const int64_t* strides, int64_t size) {
+        AT_ASSERT(ntensors - num_outputs == 1);
+        char *in = data[ntensors - 1];
+        int64_t stride = strides[ntensors - 1];
         for (int64_t i = 0; i < size; ++i) {
           acc = ops.reduce(acc, *(data_t*)in);
           in += stride;
@@ -118,8 +278,7 @@ void binary_kernel_reduce(TensorIterator& iter, ops_t ops, init_t init) {
         total_acc = ops.combine(total_acc, buffer[i]);
       }
     }
-    char *out = (char *)sub_iter.data_ptr(0);
-    *(data_t*)out = ops.project(total_acc);
+    set_results(ops.project(total_acc), sub_iter, num_outputs);
   });
 }
 
@@ -1,9 +1,12 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <limits>
+#include <utility>
 
 #include <ATen/Dispatch.h>
 #include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/cpu/Vectorized.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/SharedReduceOps.h>
@@ -15,11 +18,11 @@ namespace at { namespace native { namespace {
 using namespace vec256;
 
 static void sum_kernel_impl(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES(iter.dtype(), "sum_cpu", [&] {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, iter.dtype(), "sum_cpu", [&] {
     binary_kernel_reduce_vec(
       iter,
       [=](scalar_t a, scalar_t b) -> scalar_t { return a + b; },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a + b; });
+      [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a + b; });
   });
 }
 
@@ -38,18 +41,18 @@ static void std_var_kernel_impl(TensorIterator &iter, bool unbiased, bool take_s
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "std_cpu", [&] {
     binary_kernel_reduce(
       iter,
-      WelfordOps<scalar_t, double, int64_t, double> { unbiased, take_sqrt },
+      WelfordOps<scalar_t, double, int64_t, double, std::pair<scalar_t, scalar_t>> { unbiased, take_sqrt },
       WelfordData<double, int64_t, double>()
     );
   });
 }
 
 static void prod_kernel_impl(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES(iter.dtype(), "prod_cpu", [&] {
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, iter.dtype(), "prod_cpu", [&] {
     binary_kernel_reduce_vec(
       iter,
       [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a * b; },
+      [=](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return a * b; },
       /*identity=*/1);
   });
 }
@@ -114,7 +117,7 @@ static void and_kernel_impl(TensorIterator& iter) {
   binary_kernel_reduce_vec(
     iter,
     [=](uint8_t a, uint8_t b) -> uint8_t { return a && b; },
-    [=](Vec256<uint8_t> a, Vec256<uint8_t> b) {
+    [=](Vectorized<uint8_t> a, Vectorized<uint8_t> b) {
       // Adding the implementation here instead of in vec256_base to avoid
       // return value inconsistency. Other comparison operators in vec256_base
       // return -1/0 (all bit 1 / all bit 0) as true/false to follow the AVX2
@@ -125,8 +128,8 @@ static void and_kernel_impl(TensorIterator& iter) {
       //
       // In this method, users would expect, e.g., all(), to return 1/0 as
       // true/false.
-      Vec256<uint8_t> c = Vec256<uint8_t>();
-      for (int i = 0; i != Vec256<uint8_t>::size(); i++) {
+      Vectorized<uint8_t> c = Vectorized<uint8_t>();
+      for (int i = 0; i != Vectorized<uint8_t>::size(); i++) {
         c[i] = a[i] && b[i];
       }
       return c;
@@ -138,9 +141,9 @@ static void or_kernel_impl(TensorIterator& iter) {
   binary_kernel_reduce_vec(
     iter,
     [=](uint8_t a, uint8_t b) -> uint8_t { return a || b; },
-    [=](Vec256<uint8_t> a, Vec256<uint8_t> b) {
-      Vec256<uint8_t> c = Vec256<uint8_t>();
-      for (int i = 0; i != Vec256<uint8_t>::size(); i++) {
+    [=](Vectorized<uint8_t> a, Vectorized<uint8_t> b) {
+      Vectorized<uint8_t> c = Vectorized<uint8_t>();
+      for (int i = 0; i != Vectorized<uint8_t>::size(); i++) {
         c[i] = a[i] || b[i];
       }
       return c;
@@ -153,7 +156,7 @@ static void min_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return std::min(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return minimum(a, b); });
+      [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return minimum(a, b); });
   });
 }
 
@@ -162,7 +165,19 @@ static void max_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return std::max(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return maximum(a, b); });
+      [](Vectorized<scalar_t> a, Vectorized<scalar_t> b) { return maximum(a, b); });
+  });
+}
+
+static void aminmax_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.dtype(), "aminmax_cpu", [&iter] {
+    using acc_t = std::pair<scalar_t, scalar_t>;
+    using limits = std::numeric_limits<scalar_t>;
+    binary_kernel_reduce(
+      iter,
+      MinMaxOps<scalar_t, acc_t> {},
+      acc_t(limits::has_infinity ? limits::infinity() : limits::max(),
+            limits::has_infinity ? -limits::infinity() : limits::lowest()));
   });
 }
 
@@ -177,5 +192,6 @@ REGISTER_DISPATCH(and_stub, &and_kernel_impl);
 REGISTER_DISPATCH(or_stub, &or_kernel_impl);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_impl);
 
 }}  // namespace at::native
@@ -0,0 +1,169 @@
+#include <ATen/native/Indexing.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/TensorIterator.h>
+
+namespace at { namespace native {
+namespace {
+
+// Views t with the shape of index, with the sizes of dim replaced by
+// dim_size and its stride by dim_stride
+static Tensor restride_dim(const Tensor & t, int64_t dim, const Tensor & index,
+                           int64_t dim_size, int64_t dim_stride) {
+  auto sizes = index.sizes().vec();
+  auto strides = t.strides().vec();
+  sizes[dim] = dim_size;
+  strides[dim] = dim_stride;
+  return t.as_strided(sizes, strides);
+}
+
+static void check_index(int64_t idx, int64_t size, const char* method_name) {
+  AT_CHECK(idx >= 0 && idx < size,
+           "Invalid index in ", method_name, ": index ", idx,
+           " is out of bounds for dimension with size ", size);
+}
+
+// gather is elementwise over result and index: self is viewed with the shape
+// of index and stride 0 along dim, and each element adds its index times the
+// original stride of dim.
+void gather_kernel(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  auto builder = TensorIterator::Builder();
+  builder.dont_compute_common_dtype();
+  builder.dont_resize_outputs();
+  builder.add_output(result);
+  builder.add_input(restride_dim(self, dim, index, index.size(dim), 0));
+  builder.add_input(index);
+  auto iter = builder.build();
+
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "gather_cpu", [&] {
+    iter->for_each([&](int ntensor, char** data, const int64_t* strides, int64_t n) {
+      char* result_data = data[0];
+      char* self_data = data[1];
+      char* index_data = data[2];
+      for (int64_t i = 0; i < n; i++) {
+        int64_t idx = *(int64_t*)(index_data + i * strides[2]);
+        check_index(idx, self_dim_size, "gather");
+        *(scalar_t*)(result_data + i * strides[0]) =
+            ((scalar_t*)(self_data + i * strides[1]))[idx * self_dim_stride];
+      }
+    });
+  });
+}
+
+// scatter can't be elementwise over index, since elements that differ only
+// along dim may write to the same element of self. Instead, the iterator
+// runs over the slices along dim (the shape of index with dim squashed to
+// size 1) and each slice is handled by one thread in order along dim.
+// Different slices write disjoint elements of self, so the result doesn't
+// depend on the number of threads, even for scatter_add_.
+//
+// When there are too few slices to keep the threads busy, the threads take
+// disjoint ranges of dim in self instead and each go over all the slices,
+// skipping the elements that scatter outside of their range. Elements of
+// self are still written in index order.
+template <typename scalar_t, typename func_t>
+void cpu_scatter_kernel(Tensor & self, int64_t dim, const Tensor & index,
+                        const Tensor & src, const char* method_name, const func_t& f) {
+  const int64_t index_dim_size = index.size(dim);
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  const int64_t index_dim_stride = index.stride(dim);
+  const int64_t src_dim_stride = src.defined() ? src.stride(dim) : 0;
+
+  auto builder = TensorIterator::Builder();
+  builder.dont_compute_common_dtype();
+  builder.dont_resize_outputs();
+  builder.add_output(restride_dim(self, dim, index, 1, self_dim_stride));
+  builder.add_input(restride_dim(index, dim, index, 1, index_dim_stride));
+  if (src.defined()) {
+    builder.add_input(restride_dim(src, dim, index, 1, src_dim_stride));
+  }
+  auto iter = builder.build();
+
+  auto make_loop = [&](int64_t self_begin, int64_t self_end) {
+    return [&, self_begin, self_end](int ntensor, char** data, const int64_t* strides, int64_t n) {
+      char* self_data = data[0];
+      char* index_data = data[1];
+      char* src_data = ntensor > 2 ? data[2] : nullptr;
+      const int64_t src_stride = ntensor > 2 ? strides[2] : 0;
+      auto scatter_one = [&](int64_t elem, int64_t i) {
+        int64_t idx = *(int64_t*)(index_data + elem * strides[1] +
+                                  i * index_dim_stride * sizeof(int64_t));
+        check_index(idx, self_dim_size, method_name);
+        if (idx >= self_begin && idx < self_end) {
+          f((scalar_t*)(self_data + elem * strides[0]) + idx * self_dim_stride,
+            (scalar_t*)(src_data + elem * src_stride) + i * src_dim_stride);
+        }
+      };
+      // Keep the inner loop on the smaller stride of index
+      if (index_dim_stride * (int64_t)sizeof(int64_t) < strides[1]) {
+        for (int64_t elem = 0; elem < n; elem++) {
+          for (int64_t i = 0; i < index_dim_size; i++) {
+            scatter_one(elem, i);
+          }
+        }
+      } else {
+        for (int64_t i = 0; i < index_dim_size; i++) {
+          for (int64_t elem = 0; elem < n; elem++) {
+            scatter_one(elem, i);
+          }
+        }
+      }
+    };
+  };
+
+  const int64_t num_slices = iter->numel();
+  const int64_t num_threads = get_num_threads();
+  if (num_slices < num_threads && self_dim_size > 1 &&
+      index.numel() >= internal::GRAIN_SIZE && !in_parallel_region()) {
+    const int64_t range_size = divup(self_dim_size, std::min(num_threads, self_dim_size));
+    parallel_for(0, self_dim_size, range_size, [&](int64_t begin, int64_t end) {
+      iter->serial_for_each(make_loop(begin, end), {0, num_slices});
+    });
+  } else {
+    const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / index_dim_size);
+    parallel_for(0, num_slices, grain_size, [&](int64_t begin, int64_t end) {
+      iter->serial_for_each(make_loop(0, self_dim_size), {begin, end});
+    });
+  }
+}
+
+void scatter_kernel(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "scatter_cpu", [&] {
+    cpu_scatter_kernel<scalar_t>(self, dim, index, src, "scatter",
+      [](scalar_t* self_data, const scalar_t* src_data) {
+        *self_data = *src_data;
+      });
+  });
+}
+
+void scatter_fill_kernel(Tensor & self, int64_t dim, const Tensor & index, Scalar src) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "scatter_fill_cpu", [&] {
+    const scalar_t value = src.to<scalar_t>();
+    cpu_scatter_kernel<scalar_t>(self, dim, index, Tensor(), "scatter",
+      [value](scalar_t* self_data, const scalar_t* src_data) {
+        *self_data = value;
+      });
+  });
+}
+
+void scatter_add_kernel(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "scatter_add_cpu", [&] {
+    cpu_scatter_kernel<scalar_t>(self, dim, index, src, "scatter_add",
+      [](scalar_t* self_data, const scalar_t* src_data) {
+        *self_data += *src_data;
+      });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(gather_stub, &gather_kernel);
+REGISTER_DISPATCH(scatter_stub, &scatter_kernel);
+REGISTER_DISPATCH(scatter_fill_stub, &scatter_fill_kernel);
+REGISTER_DISPATCH(scatter_add_stub, &scatter_add_kernel);
+
+}} // namespace at::native
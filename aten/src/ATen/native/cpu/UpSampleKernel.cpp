@@ -0,0 +1,318 @@
+#include <ATen/native/cpu/UpSampleKernel.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/UpSample.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// The interpolation along one axis: output position o reads the input
+// positions index[o * taps + k] with weights weight[o * taps + k], for k in
+// [0, taps). Indices are already clamped to the input, so the kernels below
+// are the same for every mode and only differ in their taps.
+template <typename scalar_t>
+struct AxisTaps {
+  int64_t taps;
+  std::vector<int64_t> index;
+  std::vector<scalar_t> weight;
+
+  AxisTaps(int64_t taps, int64_t output_size)
+    : taps(taps), index(taps * output_size), weight(taps * output_size) {}
+};
+
+template <typename scalar_t>
+static AxisTaps<scalar_t> nearest_taps(int64_t input_size, int64_t output_size) {
+  AxisTaps<scalar_t> t(1, output_size);
+  const float scale = (float)input_size / (float)output_size;
+  for (int64_t o = 0; o < output_size; o++) {
+    t.index[o] = nearest_neighbor_compute_source_index(scale, o, input_size);
+    t.weight[o] = scalar_t(1);
+  }
+  return t;
+}
+
+template <typename scalar_t>
+static AxisTaps<scalar_t> linear_taps(int64_t input_size, int64_t output_size, bool align_corners) {
+  AxisTaps<scalar_t> t(2, output_size);
+  const scalar_t scale = area_pixel_compute_scale<scalar_t>(input_size, output_size, align_corners);
+  for (int64_t o = 0; o < output_size; o++) {
+    const scalar_t real = area_pixel_compute_source_index<scalar_t>(
+        scale, o, align_corners, /*cubic=*/false);
+    const int64_t i = real;
+    const scalar_t lambda1 = real - i;
+    t.index[2 * o] = i;
+    t.index[2 * o + 1] = i + ((i < input_size - 1) ? 1 : 0);
+    t.weight[2 * o] = static_cast<scalar_t>(1.) - lambda1;
+    t.weight[2 * o + 1] = lambda1;
+  }
+  return t;
+}
+
+template <typename scalar_t>
+static AxisTaps<scalar_t> cubic_taps(int64_t input_size, int64_t output_size, bool align_corners) {
+  AxisTaps<scalar_t> t(4, output_size);
+  const scalar_t scale = area_pixel_compute_scale<scalar_t>(input_size, output_size, align_corners);
+  for (int64_t o = 0; o < output_size; o++) {
+    const scalar_t real = area_pixel_compute_source_index<scalar_t>(
+        scale, o, align_corners, /*cubic=*/true);
+    const int64_t i = floorf(real);
+    get_cubic_upsample_coefficients<scalar_t>(&t.weight[4 * o], real - i);
+    for (int64_t k = 0; k < 4; k++) {
+      t.index[4 * o + k] = std::max<int64_t>(std::min<int64_t>(i - 1 + k, input_size - 1), 0);
+    }
+  }
+  return t;
+}
+
+// out[x] = sum of weights[k] * rows[k][x] over k in [0, taps), for x in [0, n)
+template <typename scalar_t>
+static inline void row_sum_scalar(scalar_t* out, const scalar_t* const* rows, const scalar_t* weights,
+                                  int64_t taps, int64_t begin, int64_t n) {
+  for (int64_t x = begin; x < n; x++) {
+    scalar_t sum = weights[0] * rows[0][x];
+    for (int64_t k = 1; k < taps; k++) {
+      sum += weights[k] * rows[k][x];
+    }
+    out[x] = sum;
+  }
+}
+
+template <typename scalar_t>
+struct RowSum {
+  static void apply(scalar_t* out, const scalar_t* const* rows, const scalar_t* weights,
+                    int64_t taps, int64_t n) {
+    row_sum_scalar(out, rows, weights, taps, 0, n);
+  }
+};
+
+template <typename scalar_t>
+struct VecRowSum {
+  static void apply(scalar_t* out, const scalar_t* const* rows, const scalar_t* weights,
+                    int64_t taps, int64_t n) {
+    using Vec = Vec256<scalar_t>;
+    int64_t x = 0;
+    for (; x + Vec::size() <= n; x += Vec::size()) {
+      Vec sum = Vec(weights[0]) * Vec::loadu(rows[0] + x);
+      for (int64_t k = 1; k < taps; k++) {
+        sum = fmadd(Vec(weights[k]), Vec::loadu(rows[k] + x), sum);
+      }
+      sum.store(out + x);
+    }
+    row_sum_scalar(out, rows, weights, taps, x, n);
+  }
+};
+
+template <> struct RowSum<float> : VecRowSum<float> {};
+template <> struct RowSum<double> : VecRowSum<double> {};
+
+// NCHW: every output row is computed by one thread in two passes. The input
+// rows it reads are first combined into one row of input width with the
+// vertical weights (vectorized), which is then sampled with the horizontal
+// taps. The taps of both axes are computed once per call.
+template <typename scalar_t>
+static void upsample_2d_nchw(Tensor& output, const Tensor& input,
+                             const AxisTaps<scalar_t>& h, const AxisTaps<scalar_t>& w) {
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+  const int64_t planes = input.size(0) * input.size(1);
+  const scalar_t* idata = input.data<scalar_t>();
+  scalar_t* odata = output.data<scalar_t>();
+
+  const int64_t work = input_width * h.taps + output_width * w.taps;
+  parallel_for(0, planes * output_height, std::max<int64_t>(1, internal::GRAIN_SIZE / work),
+               [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> buffer(input_width);
+    for (int64_t r = begin; r < end; r++) {
+      const int64_t plane = r / output_height;
+      const int64_t oh = r % output_height;
+      const scalar_t* in_plane = idata + plane * input_height * input_width;
+      scalar_t* out_row = odata + r * output_width;
+
+      const scalar_t* in_row;
+      if (h.taps == 1) {
+        in_row = in_plane + h.index[oh] * input_width;
+      } else {
+        const scalar_t* rows[4];
+        for (int64_t k = 0; k < h.taps; k++) {
+          rows[k] = in_plane + h.index[oh * h.taps + k] * input_width;
+        }
+        RowSum<scalar_t>::apply(buffer.data(), rows, &h.weight[oh * h.taps], h.taps, input_width);
+        in_row = buffer.data();
+      }
+
+      for (int64_t ow = 0; ow < output_width; ow++) {
+        const int64_t* index = &w.index[ow * w.taps];
+        const scalar_t* weight = &w.weight[ow * w.taps];
+        scalar_t sum = weight[0] * in_row[index[0]];
+        for (int64_t k = 1; k < w.taps; k++) {
+          sum += weight[k] * in_row[index[k]];
+        }
+        out_row[ow] = sum;
+      }
+    }
+  });
+}
+
+// NHWC: every output pixel is a weighted sum of h.taps * w.taps input
+// pixels, vectorized over the channels. Each output row is computed by one
+// thread.
+template <typename scalar_t>
+static void upsample_2d_nhwc(Tensor& output, const Tensor& input,
+                             const AxisTaps<scalar_t>& h, const AxisTaps<scalar_t>& w) {
+  const int64_t nbatch = input.size(0);
+  const int64_t channels = input.size(1);
+  const int64_t input_height = input.size(2);
+  const int64_t input_width = input.size(3);
+  const int64_t output_height = output.size(2);
+  const int64_t output_width = output.size(3);
+  const scalar_t* idata = input.data<scalar_t>();
+  scalar_t* odata = output.data<scalar_t>();
+  const int64_t taps = h.taps * w.taps;
+
+  const int64_t work = output_width * channels * taps;
+  parallel_for(0, nbatch * output_height, std::max<int64_t>(1, internal::GRAIN_SIZE / work),
+               [&](int64_t begin, int64_t end) {
+    const scalar_t* pixels[16];
+    scalar_t weights[16];
+    for (int64_t r = begin; r < end; r++) {
+      const int64_t n = r / output_height;
+      const int64_t oh = r % output_height;
+      const scalar_t* in_image = idata + n * input_height * input_width * channels;
+      for (int64_t ow = 0; ow < output_width; ow++) {
+        scalar_t* out_pixel = odata + (r * output_width + ow) * channels;
+        for (int64_t kh = 0; kh < h.taps; kh++) {
+          for (int64_t kw = 0; kw < w.taps; kw++) {
+            const int64_t ih = h.index[oh * h.taps + kh];
+            const int64_t iw = w.index[ow * w.taps + kw];
+            pixels[kh * w.taps + kw] = in_image + (ih * input_width + iw) * channels;
+            weights[kh * w.taps + kw] = h.weight[oh * h.taps + kh] * w.weight[ow * w.taps + kw];
+          }
+        }
+        if (taps == 1) {
+          std::copy(pixels[0], pixels[0] + channels, out_pixel);
+        } else {
+          RowSum<scalar_t>::apply(out_pixel, pixels, weights, taps, channels);
+        }
+      }
+    }
+  });
+}
+
+// Backward of upsample_2d_nchw. Each grad_input plane is owned by one
+// thread, which scatters the grad_output plane into it in order, so the
+// result doesn't depend on the number of threads.
+template <typename scalar_t>
+static void upsample_2d_backward_nchw(Tensor& grad_input, const Tensor& grad_output,
+                                      const AxisTaps<scalar_t>& h, const AxisTaps<scalar_t>& w) {
+  const int64_t input_height = grad_input.size(2);
+  const int64_t input_width = grad_input.size(3);
+  const int64_t output_height = grad_output.size(2);
+  const int64_t output_width = grad_output.size(3);
+  const int64_t planes = grad_input.size(0) * grad_input.size(1);
+  scalar_t* idata = grad_input.data<scalar_t>();
+  const scalar_t* odata = grad_output.data<scalar_t>();
+
+  const int64_t work = output_height * output_width * h.taps * w.taps;
+  parallel_for(0, planes, std::max<int64_t>(1, internal::GRAIN_SIZE / work),
+               [&](int64_t begin, int64_t end) {
+    for (int64_t plane = begin; plane < end; plane++) {
+      scalar_t* in_plane = idata + plane * input_height * input_width;
+      const scalar_t* out_plane = odata + plane * output_height * output_width;
+      std::fill(in_plane, in_plane + input_height * input_width, scalar_t(0));
+      for (int64_t oh = 0; oh < output_height; oh++) {
+        for (int64_t ow = 0; ow < output_width; ow++) {
+          const scalar_t value = out_plane[oh * output_width + ow];
+          for (int64_t kh = 0; kh < h.taps; kh++) {
+            scalar_t* in_row = in_plane + h.index[oh * h.taps + kh] * input_width;
+            const scalar_t h_weight = h.weight[oh * h.taps + kh];
+            for (int64_t kw = 0; kw < w.taps; kw++) {
+              in_row[w.index[ow * w.taps + kw]] += h_weight * w.weight[ow * w.taps + kw] * value;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+static void upsample_2d(Tensor& output, const Tensor& input,
+                        const AxisTaps<scalar_t>& h, const AxisTaps<scalar_t>& w) {
+  if (input.is_contiguous()) {
+    upsample_2d_nchw<scalar_t>(output, input, h, w);
+  } else {
+    AT_ASSERT(input.is_contiguous(MemoryFormat::ChannelsLast) &&
+              output.is_contiguous(MemoryFormat::ChannelsLast));
+    upsample_2d_nhwc<scalar_t>(output, input, h, w);
+  }
+}
+
+void upsample_nearest2d_kernel(Tensor& output, const Tensor& input) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "upsample_nearest2d", [&] {
+    upsample_2d<scalar_t>(output, input,
+                          nearest_taps<scalar_t>(input.size(2), output.size(2)),
+                          nearest_taps<scalar_t>(input.size(3), output.size(3)));
+  });
+}
+
+void upsample_nearest2d_backward_kernel(Tensor& grad_input, const Tensor& grad_output) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad_output.scalar_type(), "upsample_nearest2d_backward", [&] {
+    upsample_2d_backward_nchw<scalar_t>(grad_input, grad_output,
+                                        nearest_taps<scalar_t>(grad_input.size(2), grad_output.size(2)),
+                                        nearest_taps<scalar_t>(grad_input.size(3), grad_output.size(3)));
+  });
+}
+
+void upsample_bilinear2d_kernel(Tensor& output, const Tensor& input, bool align_corners) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "upsample_bilinear2d", [&] {
+    upsample_2d<scalar_t>(output, input,
+                          linear_taps<scalar_t>(input.size(2), output.size(2), align_corners),
+                          linear_taps<scalar_t>(input.size(3), output.size(3), align_corners));
+  });
+}
+
+void upsample_bilinear2d_backward_kernel(Tensor& grad_input, const Tensor& grad_output, bool align_corners) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad_output.scalar_type(), "upsample_bilinear2d_backward", [&] {
+    upsample_2d_backward_nchw<scalar_t>(
+        grad_input, grad_output,
+        linear_taps<scalar_t>(grad_input.size(2), grad_output.size(2), align_corners),
+        linear_taps<scalar_t>(grad_input.size(3), grad_output.size(3), align_corners));
+  });
+}
+
+void upsample_bicubic2d_kernel(Tensor& output, const Tensor& input, bool align_corners) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "upsample_bicubic2d", [&] {
+    upsample_2d<scalar_t>(output, input,
+                          cubic_taps<scalar_t>(input.size(2), output.size(2), align_corners),
+                          cubic_taps<scalar_t>(input.size(3), output.size(3), align_corners));
+  });
+}
+
+void upsample_bicubic2d_backward_kernel(Tensor& grad_input, const Tensor& grad_output, bool align_corners) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad_output.scalar_type(), "upsample_bicubic2d_backward", [&] {
+    upsample_2d_backward_nchw<scalar_t>(
+        grad_input, grad_output,
+        cubic_taps<scalar_t>(grad_input.size(2), grad_output.size(2), align_corners),
+        cubic_taps<scalar_t>(grad_input.size(3), grad_output.size(3), align_corners));
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(upsample_nearest2d_stub, &upsample_nearest2d_kernel);
+REGISTER_DISPATCH(upsample_nearest2d_backward_stub, &upsample_nearest2d_backward_kernel);
+REGISTER_DISPATCH(upsample_bilinear2d_stub, &upsample_bilinear2d_kernel);
+REGISTER_DISPATCH(upsample_bilinear2d_backward_stub, &upsample_bilinear2d_backward_kernel);
+REGISTER_DISPATCH(upsample_bicubic2d_stub, &upsample_bicubic2d_kernel);
+REGISTER_DISPATCH(upsample_bicubic2d_backward_stub, &upsample_bicubic2d_backward_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// 2-D upsampling of a 4-D input into an output of the same batch and channel
+// sizes. The forward kernels take contiguous or channels last input and
+// output tensors of the same memory format; the backward kernels take
+// contiguous grad_input and grad_output and overwrite grad_input.
+using upsample_2d_fn = void(*)(Tensor & output, const Tensor & input, bool align_corners);
+using upsample_nearest_2d_fn = void(*)(Tensor & output, const Tensor & input);
+
+DECLARE_DISPATCH(upsample_2d_fn, upsample_bilinear2d_stub);
+DECLARE_DISPATCH(upsample_2d_fn, upsample_bilinear2d_backward_stub);
+DECLARE_DISPATCH(upsample_2d_fn, upsample_bicubic2d_stub);
+DECLARE_DISPATCH(upsample_2d_fn, upsample_bicubic2d_backward_stub);
+DECLARE_DISPATCH(upsample_nearest_2d_fn, upsample_nearest2d_stub);
+DECLARE_DISPATCH(upsample_nearest_2d_fn, upsample_nearest2d_backward_stub);
+
+}} // namespace at::native
@@ -0,0 +1,39 @@
+#pragma once
+
+// Vectorized<T> is the widest vector type available for the CPU capability
+// the including kernel file is compiled for: Vec512<T> for
+// CPU_CAPABILITY_AVX512 and Vec256<T> otherwise. Kernels written against
+// Vectorized<T> (and calling fmadd, maximum, minimum, ... unqualified) get the
+// full vector width on AVX512 machines; kernels that name Vec256<T> directly
+// keep working unchanged in every build.
+//
+// Vectorized<Half> is always Vec256<Half>, which computes in single precision
+// on two Vec256<float>; Vec512 has no Half specialization.
+
+#include <ATen/cpu/vec256/vec256.h>
+#if defined(CPU_CAPABILITY_AVX512)
+#include <ATen/cpu/vec512/vec512.h>
+#endif
+
+namespace at { namespace native {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+template <typename T>
+struct VectorizedType {
+#if defined(CPU_CAPABILITY_AVX512)
+  using type = vec512::Vec512<T>;
+#else
+  using type = vec256::Vec256<T>;
+#endif
+};
+
+template <>
+struct VectorizedType<Half> {
+  using type = vec256::Vec256<Half>;
+};
+
+template <typename T>
+using Vectorized = typename VectorizedType<T>::type;
+
+}}} // namespace at::native::<anonymous>
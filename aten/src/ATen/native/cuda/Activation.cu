@@ -1,4 +1,5 @@
 #include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Dispatch.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
@@ -291,6 +292,17 @@ static void threshold_kernel(TensorIterator& iter, Scalar threshold, Scalar valu
   });
 }
 
+static void bias_relu_kernel(TensorIterator& iter) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "bias_relu_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    gpu_binary_kernel(iter, []GPU_LAMBDA(scalar_t x, scalar_t bias) -> scalar_t {
+      const accscalar_t y = static_cast<accscalar_t>(x) + static_cast<accscalar_t>(bias);
+      return y <= 0 ? scalar_t(0) : static_cast<scalar_t>(y);
+    });
+  });
+}
+
 REGISTER_DISPATCH(threshold_stub, &threshold_kernel);
+REGISTER_DISPATCH(bias_relu_stub, &bias_relu_kernel);
 
 }}  // namespace at::native
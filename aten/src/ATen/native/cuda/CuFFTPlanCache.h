@@ -376,12 +376,16 @@ public:
   CuFFTParamsLRUCache(CuFFTParamsLRUCache&& other) noexcept :
     _usage_list(std::move(other._usage_list)),
     _cache_map(std::move(other._cache_map)),
-    _max_size(other._max_size) {}
+    _max_size(other._max_size),
+    _hits(other._hits),
+    _misses(other._misses) {}
 
   CuFFTParamsLRUCache& operator=(CuFFTParamsLRUCache&& other) noexcept {
     _usage_list = std::move(other._usage_list);
     _cache_map = std::move(other._cache_map);
     _max_size = other._max_size;
+    _hits = other._hits;
+    _misses = other._misses;
     return *this;
   }
 
@@ -397,11 +401,13 @@ public:
     map_kkv_iter_t map_it = _cache_map.find(key);
     // Hit, put to list front
     if (map_it != _cache_map.end()) {
+      _hits++;
       _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
       return map_it->second->second;
     }
 
     // Miss
+    _misses++;
     // remove if needed
     if (_usage_list.size() >= _max_size) {
       auto last = _usage_list.end();
@@ -421,9 +427,12 @@ public:
     return kv_it->second;
   }
 
+  // Also resets the hit and miss counts
   void clear() {
     _cache_map.clear();
     _usage_list.clear();
+    _hits = 0;
+    _misses = 0;
   }
 
   void resize(int64_t new_size) {
@@ -443,6 +452,11 @@ public:
 
   size_t max_size() const noexcept { return _max_size; }
 
+  // Lookups that found a plan in the cache, and that had to create one, since
+  // the cache was last cleared
+  size_t hits() const noexcept { return _hits; }
+  size_t misses() const noexcept { return _misses; }
+
   std::mutex mutex;
 
 private:
@@ -461,6 +475,8 @@ private:
   std::list<kv_t> _usage_list;
   map_t _cache_map;
   size_t _max_size;
+  size_t _hits = 0;
+  size_t _misses = 0;
 };
 
 // Since ATen is separated into CPU build and CUDA build, we need a way to call
@@ -468,10 +484,13 @@ private:
 // (at cuda/detail/CUDAHooks.cpp), and call the hooked functions from the actual
 // native function counterparts (at native/SpectralOps.cpp), i.e.,
 // _cufft_get_plan_cache_max_size, _cufft_set_plan_cache_max_size
-// _cufft_get_plan_cache_size, and _cufft_clear_plan_cache.
+// _cufft_get_plan_cache_size, _cufft_get_plan_cache_hits,
+// _cufft_get_plan_cache_misses, and _cufft_clear_plan_cache.
 int64_t cufft_get_plan_cache_max_size_impl(int64_t device_index);
 void cufft_set_plan_cache_max_size_impl(int64_t device_index, int64_t max_size);
 int64_t cufft_get_plan_cache_size_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_hits_impl(int64_t device_index);
+int64_t cufft_get_plan_cache_misses_impl(int64_t device_index);
 void cufft_clear_plan_cache_impl(int64_t device_index);
 
 }}} // namespace at::native::detail
@@ -0,0 +1,464 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Utils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/cuda/PhiloxCudaState.h>
+#include <ATen/native/cuda/DeviceSqrt.cuh>
+#include <c10/macros/Macros.h>
+#include <curand_kernel.h>
+
+#include <THC/THCDeviceUtils.cuh>
+
+#include <array>
+#include <limits>
+
+// layer_norm(dropout(input) + residual) in one pass over each row, where a
+// row is the last prod(normalized_shape) elements of the input.
+//
+// The forward saves the sum before normalization, the per-row mean and
+// inverse standard deviation, and the dropout mask with one bit per element:
+// each thread draws the random numbers of a group of 8 consecutive elements
+// from its own philox subsequence, and stores their mask as one byte.
+// The backward of the dropout and of the add then come for free in the
+// backward of the normalization.
+
+namespace at {
+namespace native {
+
+namespace {
+
+#if defined(__HIP_PLATFORM_HCC__)
+constexpr int WARP_SIZE = 64;
+#else
+constexpr int WARP_SIZE = 32;
+#endif
+
+constexpr int kMaxThreads = 256;
+// Elements per mask byte, and per thread of the forward. curand_uniform4
+// makes 4 of them at a time.
+constexpr int kGroupSize = 8;
+
+// Threads of the block that normalizes one row
+int rowThreads(int64_t work) {
+  int threads = WARP_SIZE;
+  while (threads < work && threads < kMaxThreads) {
+    threads *= 2;
+  }
+  return threads;
+}
+
+// Sum of val over the block, returned to every thread. blockDim.x must be a
+// multiple of the warp size, and smem hold one value per warp.
+template <typename T>
+__device__ __forceinline__ T blockSum(T val, T* smem) {
+#pragma unroll
+  for (int offset = WARP_SIZE / 2; offset > 0; offset /= 2) {
+    val += WARP_SHFL_DOWN(val, offset);
+  }
+  const int lane = threadIdx.x % WARP_SIZE;
+  const int warp = threadIdx.x / WARP_SIZE;
+  // smem may still be read by the previous call
+  __syncthreads();
+  if (lane == 0) {
+    smem[warp] = val;
+  }
+  __syncthreads();
+  if (warp == 0) {
+    val = lane < blockDim.x / WARP_SIZE ? smem[lane] : T(0);
+#pragma unroll
+    for (int offset = WARP_SIZE / 2; offset > 0; offset /= 2) {
+      val += WARP_SHFL_DOWN(val, offset);
+    }
+    if (lane == 0) {
+      smem[0] = val;
+    }
+  }
+  __syncthreads();
+  return smem[0];
+}
+
+// One block per row
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kMaxThreads)
+__global__ void dropout_add_layer_norm_kernel(
+    const scalar_t* input,
+    const scalar_t* residual,
+    const scalar_t* weight,
+    const scalar_t* bias,
+    scalar_t* output,
+    scalar_t* pre_norm,
+    uint8_t* mask,
+    accscalar_t* mean_out,
+    accscalar_t* rstd_out,
+    int64_t D,
+    bool apply_dropout,
+    float keep_prob,
+    accscalar_t scale,
+    accscalar_t eps,
+    at::cuda::PhiloxCudaState philox_args) {
+  __shared__ accscalar_t smem[kMaxThreads / WARP_SIZE];
+  const int64_t row = blockIdx.x;
+  const int64_t ngroups = (D + kGroupSize - 1) / kGroupSize;
+  const int64_t offset = row * D;
+  auto seeds = at::cuda::philox::unpack(philox_args);
+
+  // Each thread only reads back the elements of pre_norm it wrote
+  accscalar_t sum = 0;
+  for (int64_t g = threadIdx.x; g < ngroups; g += blockDim.x) {
+    uint8_t bits = 0xff;
+    if (apply_dropout) {
+      curandStatePhilox4_32_10_t state;
+      curand_init(seeds.first, row * ngroups + g, seeds.second, &state);
+      float4 rand[kGroupSize / 4];
+#pragma unroll
+      for (int k = 0; k < kGroupSize / 4; ++k) {
+        rand[k] = curand_uniform4(&state);
+      }
+      bits = 0;
+#pragma unroll
+      for (int i = 0; i < kGroupSize; ++i) {
+        bits |= static_cast<uint8_t>((&rand[0].x)[i] < keep_prob) << i;
+      }
+    }
+#pragma unroll
+    for (int i = 0; i < kGroupSize; ++i) {
+      const int64_t j = g * kGroupSize + i;
+      if (j < D) {
+        const accscalar_t keep = (bits >> i) & 1;
+        const scalar_t y = static_cast<accscalar_t>(input[offset + j]) * keep * scale +
+            static_cast<accscalar_t>(residual[offset + j]);
+        pre_norm[offset + j] = y;
+        sum += static_cast<accscalar_t>(y);
+      }
+    }
+    mask[row * ngroups + g] = bits;
+  }
+  const accscalar_t mean = blockSum(sum, smem) / D;
+
+  accscalar_t sum_sq = 0;
+  for (int64_t g = threadIdx.x; g < ngroups; g += blockDim.x) {
+#pragma unroll
+    for (int i = 0; i < kGroupSize; ++i) {
+      const int64_t j = g * kGroupSize + i;
+      if (j < D) {
+        const accscalar_t d = static_cast<accscalar_t>(pre_norm[offset + j]) - mean;
+        sum_sq += d * d;
+      }
+    }
+  }
+  const accscalar_t var = blockSum(sum_sq, smem) / D;
+  const accscalar_t rstd =
+      accscalar_t(1) / static_cast<accscalar_t>(device_sqrt(var + eps));
+
+  for (int64_t g = threadIdx.x; g < ngroups; g += blockDim.x) {
+#pragma unroll
+    for (int i = 0; i < kGroupSize; ++i) {
+      const int64_t j = g * kGroupSize + i;
+      if (j < D) {
+        accscalar_t out = (static_cast<accscalar_t>(pre_norm[offset + j]) - mean) * rstd;
+        if (weight != nullptr) {
+          out *= static_cast<accscalar_t>(weight[j]);
+        }
+        if (bias != nullptr) {
+          out += static_cast<accscalar_t>(bias[j]);
+        }
+        output[offset + j] = out;
+      }
+    }
+  }
+  if (threadIdx.x == 0) {
+    mean_out[row] = mean;
+    rstd_out[row] = rstd;
+  }
+}
+
+// Gradient of pre_norm, through to input and residual. One block per row.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kMaxThreads)
+__global__ void dropout_add_layer_norm_backward_kernel(
+    const scalar_t* grad_out,
+    const scalar_t* pre_norm,
+    const uint8_t* mask,
+    const accscalar_t* mean,
+    const accscalar_t* rstd,
+    const scalar_t* weight,
+    scalar_t* grad_input,
+    scalar_t* grad_residual,
+    int64_t D,
+    accscalar_t scale) {
+  __shared__ accscalar_t smem[kMaxThreads / WARP_SIZE];
+  const int64_t row = blockIdx.x;
+  const int64_t ngroups = (D + kGroupSize - 1) / kGroupSize;
+  const int64_t offset = row * D;
+  const accscalar_t row_mean = mean[row];
+  const accscalar_t row_rstd = rstd[row];
+
+  auto grad_normalized = [&](int64_t j) {
+    accscalar_t g = static_cast<accscalar_t>(grad_out[offset + j]);
+    if (weight != nullptr) {
+      g *= static_cast<accscalar_t>(weight[j]);
+    }
+    return g;
+  };
+
+  accscalar_t sum_g = 0;
+  accscalar_t sum_g_xhat = 0;
+  for (int64_t j = threadIdx.x; j < D; j += blockDim.x) {
+    const accscalar_t xhat =
+        (static_cast<accscalar_t>(pre_norm[offset + j]) - row_mean) * row_rstd;
+    const accscalar_t g = grad_normalized(j);
+    sum_g += g;
+    sum_g_xhat += g * xhat;
+  }
+  const accscalar_t mean_g = blockSum(sum_g, smem) / D;
+  const accscalar_t mean_g_xhat = blockSum(sum_g_xhat, smem) / D;
+
+  for (int64_t j = threadIdx.x; j < D; j += blockDim.x) {
+    const accscalar_t xhat =
+        (static_cast<accscalar_t>(pre_norm[offset + j]) - row_mean) * row_rstd;
+    const accscalar_t grad_sum =
+        row_rstd * (grad_normalized(j) - mean_g - xhat * mean_g_xhat);
+    if (grad_residual != nullptr) {
+      grad_residual[offset + j] = grad_sum;
+    }
+    if (grad_input != nullptr) {
+      const accscalar_t keep =
+          (mask[row * ngroups + j / kGroupSize] >> (j % kGroupSize)) & 1;
+      grad_input[offset + j] = grad_sum * keep * scale;
+    }
+  }
+}
+
+constexpr int kColumnThreads = 32;
+constexpr int kRowThreads = 8;
+constexpr int kMaxRowChunks = 64;
+
+// Sums of grad_out * xhat and grad_out over the rows of a chunk, for the
+// gradients of weight and bias. Block (kColumnThreads, kRowThreads) adds up
+// kColumnThreads columns, and blockIdx.y is the chunk of rows.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kColumnThreads * kRowThreads)
+__global__ void layer_norm_weight_backward_kernel(
+    const scalar_t* grad_out,
+    const scalar_t* pre_norm,
+    const accscalar_t* mean,
+    const accscalar_t* rstd,
+    accscalar_t* partial_grad_weight,
+    accscalar_t* partial_grad_bias,
+    int64_t n,
+    int64_t D) {
+  __shared__ accscalar_t s_weight[kRowThreads][kColumnThreads + 1];
+  __shared__ accscalar_t s_bias[kRowThreads][kColumnThreads + 1];
+  const int64_t col = blockIdx.x * kColumnThreads + threadIdx.x;
+
+  accscalar_t sum_weight = 0;
+  accscalar_t sum_bias = 0;
+  if (col < D) {
+    for (int64_t row = blockIdx.y * kRowThreads + threadIdx.y; row < n;
+         row += gridDim.y * kRowThreads) {
+      const accscalar_t dy = static_cast<accscalar_t>(grad_out[row * D + col]);
+      const accscalar_t xhat =
+          (static_cast<accscalar_t>(pre_norm[row * D + col]) - mean[row]) * rstd[row];
+      sum_weight += dy * xhat;
+      sum_bias += dy;
+    }
+  }
+  s_weight[threadIdx.y][threadIdx.x] = sum_weight;
+  s_bias[threadIdx.y][threadIdx.x] = sum_bias;
+  __syncthreads();
+
+  if (threadIdx.y == 0 && col < D) {
+    for (int i = 1; i < kRowThreads; ++i) {
+      sum_weight += s_weight[i][threadIdx.x];
+      sum_bias += s_bias[i][threadIdx.x];
+    }
+    if (partial_grad_weight != nullptr) {
+      partial_grad_weight[blockIdx.y * D + col] = sum_weight;
+    }
+    if (partial_grad_bias != nullptr) {
+      partial_grad_bias[blockIdx.y * D + col] = sum_bias;
+    }
+  }
+}
+
+template <typename T>
+T* data_or_null(const Tensor& t) {
+  return t.defined() ? t.data<T>() : nullptr;
+}
+
+ScalarType mean_scalar_type(const Tensor& t) {
+  return t.scalar_type() == kHalf ? kFloat : t.scalar_type();
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> fused_dropout_add_layer_norm_cuda(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double p,
+    double eps) {
+  AT_CHECK(p >= 0 && p <= 1,
+      "dropout probability has to be between 0 and 1, but got ", p);
+  AT_CHECK(input.sizes().equals(residual.sizes()),
+      "Expected input and residual of the same shape, but got input of shape ",
+      input.sizes(), " and residual of shape ", residual.sizes());
+  const int64_t normalized_ndim = normalized_shape.size();
+  AT_CHECK(normalized_ndim >= 1 && input.dim() >= normalized_ndim &&
+      input.sizes().slice(input.dim() - normalized_ndim).equals(normalized_shape),
+      "Given normalized_shape=", normalized_shape,
+      ", expected input with the same trailing dimensions, but got input of size",
+      input.sizes());
+  AT_CHECK(!weight.defined() || weight.sizes().equals(normalized_shape),
+      "Expected weight of the shape of normalized_shape");
+  AT_CHECK(!bias.defined() || bias.sizes().equals(normalized_shape),
+      "Expected bias of the shape of normalized_shape");
+
+  const int64_t D = prod_intlist(normalized_shape);
+  const int64_t n = D == 0 ? 0 : input.numel() / D;
+  const int64_t ngroups = (D + kGroupSize - 1) / kGroupSize;
+  AT_CHECK(n <= std::numeric_limits<int>::max(),
+      "dropout_add_layer_norm: too many rows to normalize (", n, ")");
+
+  auto x = input.contiguous();
+  auto r = residual.contiguous();
+  auto w = weight.defined() ? weight.contiguous() : weight;
+  auto b = bias.defined() ? bias.contiguous() : bias;
+  auto output = at::empty_like(x);
+  auto pre_norm = at::empty_like(x);
+  auto mask = at::empty({n, ngroups}, x.options().dtype(kByte));
+  auto stats_options = x.options().dtype(mean_scalar_type(x));
+  auto mean = at::empty({n}, stats_options);
+  auto rstd = at::empty({n}, stats_options);
+  if (n == 0 || D == 0) {
+    return std::make_tuple(output, pre_norm, mask, mean, rstd);
+  }
+
+  const bool apply_dropout = p > 0;
+  // Only draws random numbers when some elements can be dropped
+  at::cuda::PhiloxCudaState philox_args;
+  if (apply_dropout) {
+    philox_args = at::cuda::philox_cuda_state(kGroupSize);
+  }
+  const int threads = rowThreads(ngroups);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(x.scalar_type(), "fused_dropout_add_layer_norm", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    dropout_add_layer_norm_kernel<scalar_t, accscalar_t>
+        <<<n, threads, 0, at::cuda::getCurrentCUDAStream()>>>(
+            x.data<scalar_t>(),
+            r.data<scalar_t>(),
+            data_or_null<scalar_t>(w),
+            data_or_null<scalar_t>(b),
+            output.data<scalar_t>(),
+            pre_norm.data<scalar_t>(),
+            mask.data<uint8_t>(),
+            mean.data<accscalar_t>(),
+            rstd.data<accscalar_t>(),
+            D,
+            apply_dropout,
+            static_cast<float>(1 - p),
+            static_cast<accscalar_t>(p < 1 ? 1 / (1 - p) : 0),
+            static_cast<accscalar_t>(eps),
+            philox_args);
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return std::make_tuple(output, pre_norm, mask, mean, rstd);
+}
+
+std::tuple<Tensor, Tensor, Tensor, Tensor> fused_dropout_add_layer_norm_backward_cuda(
+    const Tensor& grad_out,
+    const Tensor& pre_norm,
+    const Tensor& mask,
+    const Tensor& mean,
+    const Tensor& rstd,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    double p,
+    std::array<bool, 4> output_mask) {
+  AT_CHECK(mask.scalar_type() == kByte, "mask should be torch.uint8 dtype");
+  AT_CHECK(grad_out.sizes().equals(pre_norm.sizes()),
+      "Expected grad_out of the shape of pre_norm");
+  const int64_t D = prod_intlist(normalized_shape);
+  const int64_t n = mean.numel();
+
+  auto options = pre_norm.options();
+  Tensor grad_input, grad_residual, grad_weight, grad_bias;
+  if (output_mask[0]) {
+    grad_input = at::empty_like(pre_norm);
+  }
+  if (output_mask[1]) {
+    grad_residual = at::empty_like(pre_norm);
+  }
+  if (output_mask[2]) {
+    grad_weight = at::zeros(normalized_shape, options);
+  }
+  if (output_mask[3]) {
+    grad_bias = at::zeros(normalized_shape, options);
+  }
+  if (n == 0 || D == 0) {
+    return std::make_tuple(grad_input, grad_residual, grad_weight, grad_bias);
+  }
+
+  auto dy = grad_out.contiguous();
+  auto y = pre_norm.contiguous();
+  auto w = weight.defined() ? weight.contiguous() : weight;
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(y.scalar_type(), "fused_dropout_add_layer_norm_backward", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    if (output_mask[0] || output_mask[1]) {
+      dropout_add_layer_norm_backward_kernel<scalar_t, accscalar_t>
+          <<<n, rowThreads(D), 0, stream>>>(
+              dy.data<scalar_t>(),
+              y.data<scalar_t>(),
+              mask.data<uint8_t>(),
+              mean.data<accscalar_t>(),
+              rstd.data<accscalar_t>(),
+              data_or_null<scalar_t>(w),
+              data_or_null<scalar_t>(grad_input),
+              data_or_null<scalar_t>(grad_residual),
+              D,
+              static_cast<accscalar_t>(p < 1 ? 1 / (1 - p) : 0));
+      AT_CUDA_CHECK(cudaGetLastError());
+    }
+    if (output_mask[2] || output_mask[3]) {
+      const int64_t chunks = std::min<int64_t>(
+          (n + kRowThreads - 1) / kRowThreads, kMaxRowChunks);
+      auto partial_options = options.dtype(mean.scalar_type());
+      Tensor partial_weight, partial_bias;
+      if (output_mask[2]) {
+        partial_weight = at::empty({chunks, D}, partial_options);
+      }
+      if (output_mask[3]) {
+        partial_bias = at::empty({chunks, D}, partial_options);
+      }
+      dim3 grid((D + kColumnThreads - 1) / kColumnThreads, chunks);
+      dim3 block(kColumnThreads, kRowThreads);
+      layer_norm_weight_backward_kernel<scalar_t, accscalar_t>
+          <<<grid, block, 0, stream>>>(
+              dy.data<scalar_t>(),
+              y.data<scalar_t>(),
+              mean.data<accscalar_t>(),
+              rstd.data<accscalar_t>(),
+              data_or_null<accscalar_t>(partial_weight),
+              data_or_null<accscalar_t>(partial_bias),
+              n,
+              D);
+      AT_CUDA_CHECK(cudaGetLastError());
+      if (output_mask[2]) {
+        grad_weight.copy_(partial_weight.sum(0).view(normalized_shape));
+      }
+      if (output_mask[3]) {
+        grad_bias.copy_(partial_bias.sum(0).view(normalized_shape));
+      }
+    }
+  });
+  return std::make_tuple(grad_input, grad_residual, grad_weight, grad_bias);
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,260 @@
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/cuda/CUDAContext.h>
+
+#include <THC/THCDeviceUtils.cuh>
+#include <THC/THCThrustAllocator.cuh>
+
+#include <thrust/execution_policy.h>
+#include <thrust/iterator/counting_iterator.h>
+#include <thrust/scan.h>
+#include <thrust/unique.h>
+
+namespace at { namespace native {
+
+namespace {
+
+#ifdef __HIP_PLATFORM_HCC__
+static const int WARP_SIZE = 64;
+#else
+static const int WARP_SIZE = 32;
+#endif
+
+// Occurrences of a row reduced by one thread, before the partial sums of the
+// row are added up
+constexpr int NROWS_PER_THREAD = 10;
+constexpr int BLOCK_SIZE = 128;
+
+// Number of partial segments of each segment
+__global__ void krn_partials_per_segment(
+    int64_t* ret, const int64_t* segment_offsets,
+    int64_t num_of_segments, int64_t numel) {
+  const int64_t id = (int64_t)blockIdx.x * blockDim.x + threadIdx.x;
+  if (id < num_of_segments) {
+    const int64_t idx_start = segment_offsets[id];
+    const int64_t idx_end =
+        (id == num_of_segments - 1) ? numel : segment_offsets[id + 1];
+    const int64_t size = idx_end - idx_start;
+    ret[id] = THCCeilDiv(size, (int64_t)NROWS_PER_THREAD);
+  }
+}
+
+// Where each partial segment begins in sorted_indices
+__global__ void krn_partial_segment_offset(
+    int64_t* ret, const int64_t* partials_per_segment,
+    const int64_t* partials_per_segment_offset,
+    const int64_t* segment_offsets, int64_t num_of_segments) {
+  const int64_t id = (int64_t)blockIdx.x * blockDim.x + threadIdx.x;
+  if (id < num_of_segments) {
+    int64_t idx = partials_per_segment_offset[id];
+    const int64_t num_partials = partials_per_segment[id];
+    const int64_t segment_offset = segment_offsets[id];
+    for (int64_t i = 0; i < num_partials; ++i) {
+      ret[idx++] = segment_offset + i * NROWS_PER_THREAD;
+    }
+  }
+}
+
+// One thread per partial segment and feature; stride_warped rounds the
+// features up to whole warps, so that a warp never spans two partials
+template <typename scalar_t, typename accscalar_t>
+__global__ void compute_grad_weight(
+    const int64_t* orig_indices,
+    const scalar_t* grad_output,
+    const int64_t* count,
+    const int64_t* offset2bag,
+    const int64_t* bag_size,
+    const scalar_t* per_sample_weights,
+    int64_t per_sample_weights_stride,
+    int64_t stride,
+    int64_t stride_warped,
+    const int64_t* partial_segment_offset,
+    int64_t num_of_partial_segments,
+    int64_t numel,
+    accscalar_t* grad_weight_per_segment) {
+  const int64_t id = (int64_t)blockIdx.x * blockDim.x + threadIdx.x;
+  const int64_t partial = id / stride_warped;
+  const int64_t feature = id % stride_warped;
+  if (feature >= stride || partial >= num_of_partial_segments) {
+    return;
+  }
+  const int64_t idx_begin = partial_segment_offset[partial];
+  const int64_t idx_end = (partial == num_of_partial_segments - 1)
+      ? numel : partial_segment_offset[partial + 1];
+
+  accscalar_t weight = 0;
+  for (int64_t idx = idx_begin; idx < idx_end; ++idx) {
+    const int64_t orig_row = orig_indices[idx];
+    const int64_t grad_row = offset2bag ? offset2bag[orig_row] : orig_row;
+    accscalar_t gradient =
+        static_cast<accscalar_t>(grad_output[grad_row * stride + feature]);
+    if (bag_size) {
+      gradient /= bag_size[grad_row];
+    }
+    if (per_sample_weights) {
+      gradient *= static_cast<accscalar_t>(
+          per_sample_weights[orig_row * per_sample_weights_stride]);
+    }
+    if (count) {
+      gradient /= count[idx];
+    }
+    weight += gradient;
+  }
+  grad_weight_per_segment[partial * stride + feature] = weight;
+}
+
+// One thread per segment and feature, adding up the partial sums of the
+// segment in order
+template <typename scalar_t, typename accscalar_t>
+__global__ void sum_and_scatter(
+    const int64_t* sorted_indices,
+    scalar_t* grad_weight,
+    int64_t stride,
+    int64_t stride_warped,
+    const int64_t* segment_offsets,
+    int64_t num_of_segments,
+    const accscalar_t* grad_weight_per_segment,
+    const int64_t* partials_per_segment_offset,
+    int64_t num_of_partial_segments,
+    int64_t padding_idx) {
+  const int64_t id = (int64_t)blockIdx.x * blockDim.x + threadIdx.x;
+  const int64_t segment = id / stride_warped;
+  const int64_t feature = id % stride_warped;
+  if (feature >= stride || segment >= num_of_segments) {
+    return;
+  }
+  const int64_t weight_row = sorted_indices[segment_offsets[segment]];
+  if (weight_row == padding_idx) {
+    return;
+  }
+  const int64_t idx_begin = partials_per_segment_offset[segment];
+  const int64_t idx_end = (segment == num_of_segments - 1)
+      ? num_of_partial_segments : partials_per_segment_offset[segment + 1];
+
+  accscalar_t weight = 0;
+  for (int64_t idx = idx_begin; idx < idx_end; ++idx) {
+    weight += grad_weight_per_segment[idx * stride + feature];
+  }
+  grad_weight[weight_row * stride + feature] = static_cast<scalar_t>(weight);
+}
+
+} // anonymous namespace
+
+Tensor embedding_backward_cuda_kernel(
+    const Tensor& grad,
+    const Tensor& orig_indices,
+    const Tensor& sorted_indices,
+    const Tensor& count,
+    int64_t num_weights,
+    int64_t padding_idx,
+    const Tensor& offset2bag,
+    const Tensor& bag_size,
+    const Tensor& per_sample_weights) {
+  auto grad_weight = at::zeros({num_weights, grad.size(-1)}, grad.options());
+  const int64_t numel = sorted_indices.numel();
+  if (numel == 0) {
+    return grad_weight;
+  }
+  const int64_t stride = grad_weight.stride(0);
+  const int64_t stride_warped = THCCeilDiv(stride, (int64_t)WARP_SIZE) * WARP_SIZE;
+
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  auto policy = thrust::cuda::par(allocator).on(stream);
+  using device_ptr = thrust::device_ptr<int64_t>;
+
+  // Compute where each run of equal indices begins:
+  // sorted:          2 5 5 5 7 7 8 9 9
+  // segment_offsets: 0 1 4 6 7
+  auto segment_offsets = at::empty({numel}, orig_indices.options());
+  int64_t num_of_segments;
+  {
+    auto sorted_data = device_ptr(sorted_indices.data<int64_t>());
+    auto unique_indices = at::empty_like(sorted_indices);
+    auto unique_data = device_ptr(unique_indices.data<int64_t>());
+    auto offsets_data = device_ptr(segment_offsets.data<int64_t>());
+    auto ends = thrust::unique_by_key_copy(
+        policy, sorted_data, sorted_data + numel,
+        thrust::counting_iterator<int64_t>(0), unique_data, offsets_data);
+    num_of_segments = thrust::get<0>(ends) - unique_data;
+  }
+
+  // Split the segments into partial segments of at most NROWS_PER_THREAD
+  // indices, so that heavy segments are reduced by many threads:
+  // segment sizes:                 1 30 2 1 2
+  // partials_per_segment:          1  3 1 1 1
+  // partials_per_segment_offset:   0  1 4 5 6
+  auto partials_per_segment = at::empty({num_of_segments}, orig_indices.options());
+  krn_partials_per_segment<<<THCCeilDiv(num_of_segments, (int64_t)BLOCK_SIZE), BLOCK_SIZE, 0, stream>>>(
+      partials_per_segment.data<int64_t>(),
+      segment_offsets.data<int64_t>(),
+      num_of_segments,
+      numel);
+  THCudaCheck(cudaGetLastError());
+
+  auto partials_per_segment_offset = at::empty({num_of_segments}, orig_indices.options());
+  thrust::exclusive_scan(
+      policy,
+      device_ptr(partials_per_segment.data<int64_t>()),
+      device_ptr(partials_per_segment.data<int64_t>() + num_of_segments),
+      device_ptr(partials_per_segment_offset.data<int64_t>()));
+
+  const int64_t num_of_partial_segments =
+      partials_per_segment[num_of_segments - 1].item<int64_t>() +
+      partials_per_segment_offset[num_of_segments - 1].item<int64_t>();
+
+  auto partial_segment_offset = at::empty({num_of_partial_segments}, orig_indices.options());
+  krn_partial_segment_offset<<<THCCeilDiv(num_of_segments, (int64_t)BLOCK_SIZE), BLOCK_SIZE, 0, stream>>>(
+      partial_segment_offset.data<int64_t>(),
+      partials_per_segment.data<int64_t>(),
+      partials_per_segment_offset.data<int64_t>(),
+      segment_offsets.data<int64_t>(),
+      num_of_segments);
+  THCudaCheck(cudaGetLastError());
+
+  const auto acc_scalar_type =
+      grad.scalar_type() == kHalf ? kFloat : grad.scalar_type();
+  auto grad_weight_per_segment = at::empty(
+      {num_of_partial_segments, stride}, grad.options().dtype(acc_scalar_type));
+
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grad.scalar_type(), "embedding_backward", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const int64_t partial_grid =
+        THCCeilDiv(num_of_partial_segments * stride_warped, (int64_t)BLOCK_SIZE);
+    compute_grad_weight<scalar_t, accscalar_t><<<partial_grid, BLOCK_SIZE, 0, stream>>>(
+        orig_indices.data<int64_t>(),
+        grad.data<scalar_t>(),
+        count.defined() ? count.data<int64_t>() : nullptr,
+        offset2bag.defined() ? offset2bag.data<int64_t>() : nullptr,
+        bag_size.defined() ? bag_size.data<int64_t>() : nullptr,
+        per_sample_weights.defined() ? per_sample_weights.data<scalar_t>() : nullptr,
+        per_sample_weights.defined() ? per_sample_weights.stride(0) : 0,
+        stride,
+        stride_warped,
+        partial_segment_offset.data<int64_t>(),
+        num_of_partial_segments,
+        numel,
+        grad_weight_per_segment.data<accscalar_t>());
+    THCudaCheck(cudaGetLastError());
+
+    const int64_t segment_grid =
+        THCCeilDiv(num_of_segments * stride_warped, (int64_t)BLOCK_SIZE);
+    sum_and_scatter<scalar_t, accscalar_t><<<segment_grid, BLOCK_SIZE, 0, stream>>>(
+        sorted_indices.data<int64_t>(),
+        grad_weight.data<scalar_t>(),
+        stride,
+        stride_warped,
+        segment_offsets.data<int64_t>(),
+        num_of_segments,
+        grad_weight_per_segment.data<accscalar_t>(),
+        partials_per_segment_offset.data<int64_t>(),
+        num_of_partial_segments,
+        padding_idx);
+    THCudaCheck(cudaGetLastError());
+  });
+
+  return grad_weight;
+}
+
+}} // namespace at::native
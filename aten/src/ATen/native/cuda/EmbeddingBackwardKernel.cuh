@@ -0,0 +1,39 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Deterministic backward of the rows of an embedding table gathered by a
+// forward pass, shared by embedding and embedding_bag (sum and mean modes).
+//
+// The occurrences of each row in sorted_indices form a segment, whose
+// gradient is the sum of the grad rows of its occurrences. Segments are cut
+// into partial segments of a few occurrences each, which are reduced in
+// parallel, a warp per partial segment and 32 features; the partial sums of
+// each segment are then added up in order and written to its row. Hot rows
+// are thus spread over many warps without atomics, and the result doesn't
+// depend on scheduling.
+//
+// - sorted_indices are the indices in ascending order, and orig_indices their
+//   position before sorting.
+// - count, if defined, holds the size of the segment of each sorted index
+//   (scale_grad_by_freq).
+// - Rows equal to padding_idx get no gradient.
+// - offset2bag, if defined, maps each index to the row of grad it was summed
+//   into; bag_size, if defined, has the size of each bag (mean mode), and
+//   per_sample_weights the weight of each index.
+//
+// grad must be contiguous, with rows of the size of the embedding rows.
+Tensor embedding_backward_cuda_kernel(
+    const Tensor& grad,
+    const Tensor& orig_indices,
+    const Tensor& sorted_indices,
+    const Tensor& count,
+    int64_t num_weights,
+    int64_t padding_idx = -1,
+    const Tensor& offset2bag = Tensor(),
+    const Tensor& bag_size = Tensor(),
+    const Tensor& per_sample_weights = Tensor());
+
+}} // namespace at::native
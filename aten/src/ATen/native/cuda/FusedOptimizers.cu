@@ -0,0 +1,236 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/FusedOptimizers.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+#include <THC/THCNumerics.cuh>
+
+namespace at { namespace native {
+
+namespace {
+
+// The functors applied by multi_tensor_apply to each element, following
+// the kernels in cpu/FusedOptimizersKernel.cpp. They compute in accscalar_t.
+
+template <typename scalar_t, typename accscalar_t>
+struct SGDFunctor {
+  accscalar_t lr, weight_decay, momentum, dampening;
+  bool use_momentum, nesterov;
+
+  __device__ void operator()(scalar_t* const* ptrs, int64_t i) const {
+    const accscalar_t param = ptrs[0][i];
+    accscalar_t update = static_cast<accscalar_t>(ptrs[1][i]) + weight_decay * param;
+    if (use_momentum) {
+      const accscalar_t buffer =
+          momentum * static_cast<accscalar_t>(ptrs[2][i]) + dampening * update;
+      ptrs[2][i] = buffer;
+      update = nesterov ? update + momentum * buffer : buffer;
+    }
+    ptrs[0][i] = param - lr * update;
+  }
+};
+
+template <typename scalar_t, typename accscalar_t>
+struct AdamFunctor {
+  accscalar_t step_size, beta1, beta2, weight_decay, eps;
+  bool amsgrad;
+
+  __device__ void operator()(scalar_t* const* ptrs, int64_t i) const {
+    const accscalar_t param = ptrs[0][i];
+    const accscalar_t grad = static_cast<accscalar_t>(ptrs[1][i]) + weight_decay * param;
+    const accscalar_t exp_avg =
+        beta1 * static_cast<accscalar_t>(ptrs[2][i]) + (1 - beta1) * grad;
+    const accscalar_t exp_avg_sq =
+        beta2 * static_cast<accscalar_t>(ptrs[3][i]) + (1 - beta2) * grad * grad;
+    ptrs[2][i] = exp_avg;
+    ptrs[3][i] = exp_avg_sq;
+    accscalar_t denom = exp_avg_sq;
+    if (amsgrad) {
+      const accscalar_t max_exp_avg_sq = ptrs[4][i];
+      // Propagates a NaN of exp_avg_sq, like torch::max.
+      denom = max_exp_avg_sq > exp_avg_sq ? max_exp_avg_sq : exp_avg_sq;
+      ptrs[4][i] = denom;
+    }
+    ptrs[0][i] = param -
+        step_size * exp_avg / (THCNumerics<accscalar_t>::sqrt(denom) + eps);
+  }
+};
+
+template <typename scalar_t, typename accscalar_t>
+struct AdagradFunctor {
+  accscalar_t lr, weight_decay, eps;
+
+  __device__ void operator()(scalar_t* const* ptrs, int64_t i) const {
+    const accscalar_t param = ptrs[0][i];
+    const accscalar_t grad = static_cast<accscalar_t>(ptrs[1][i]) + weight_decay * param;
+    const accscalar_t state_sum = static_cast<accscalar_t>(ptrs[2][i]) + grad * grad;
+    ptrs[2][i] = state_sum;
+    ptrs[0][i] =
+        param - lr * grad / (THCNumerics<accscalar_t>::sqrt(state_sum) + eps);
+  }
+};
+
+template <typename scalar_t, typename accscalar_t>
+struct RMSpropFunctor {
+  accscalar_t lr, alpha, eps, weight_decay, momentum;
+  bool centered, use_momentum;
+
+  __device__ void operator()(scalar_t* const* ptrs, int64_t i) const {
+    const accscalar_t param = ptrs[0][i];
+    const accscalar_t grad = static_cast<accscalar_t>(ptrs[1][i]) + weight_decay * param;
+    const accscalar_t square_avg =
+        alpha * static_cast<accscalar_t>(ptrs[2][i]) + (1 - alpha) * grad * grad;
+    ptrs[2][i] = square_avg;
+    accscalar_t avg = square_avg;
+    if (centered) {
+      const accscalar_t grad_avg =
+          alpha * static_cast<accscalar_t>(ptrs[3][i]) + (1 - alpha) * grad;
+      ptrs[3][i] = grad_avg;
+      avg -= grad_avg * grad_avg;
+    }
+    avg = THCNumerics<accscalar_t>::sqrt(avg) + eps;
+    if (use_momentum) {
+      const accscalar_t buffer =
+          momentum * static_cast<accscalar_t>(ptrs[4][i]) + grad / avg;
+      ptrs[4][i] = buffer;
+      ptrs[0][i] = param - lr * buffer;
+    } else {
+      ptrs[0][i] = param - lr * grad / avg;
+    }
+  }
+};
+
+template <typename scalar_t, typename accscalar_t>
+struct UnscaleFunctor {
+  accscalar_t inv_scale;
+  int* found_non_finite;
+
+  __device__ void operator()(scalar_t* const* ptrs, int64_t i) const {
+    const accscalar_t value = static_cast<accscalar_t>(ptrs[0][i]) * inv_scale;
+    ptrs[0][i] = value;
+    if (!::isfinite(value)) {
+      *found_non_finite = 1;
+    }
+  }
+};
+
+void fused_sgd_kernel_cuda(
+    TensorList params,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double weight_decay,
+    double momentum,
+    double dampening,
+    bool nesterov) {
+  const bool use_momentum = momentum != 0;
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params.front().scalar_type(), "fused_sgd_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const SGDFunctor<scalar_t, accscalar_t> op{
+        static_cast<accscalar_t>(lr),
+        static_cast<accscalar_t>(weight_decay),
+        static_cast<accscalar_t>(momentum),
+        static_cast<accscalar_t>(dampening),
+        use_momentum,
+        nesterov};
+    multi_tensor_apply<3, scalar_t>(
+        {{params, grads, use_momentum ? momentum_buffers : TensorList()}}, op);
+  });
+}
+
+void fused_adam_kernel_cuda(
+    TensorList params,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    double step_size,
+    double beta1,
+    double beta2,
+    double weight_decay,
+    double eps) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params.front().scalar_type(), "fused_adam_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const AdamFunctor<scalar_t, accscalar_t> op{
+        static_cast<accscalar_t>(step_size),
+        static_cast<accscalar_t>(beta1),
+        static_cast<accscalar_t>(beta2),
+        static_cast<accscalar_t>(weight_decay),
+        static_cast<accscalar_t>(eps),
+        !max_exp_avg_sqs.empty()};
+    multi_tensor_apply<5, scalar_t>(
+        {{params, grads, exp_avgs, exp_avg_sqs, max_exp_avg_sqs}}, op);
+  });
+}
+
+void fused_adagrad_kernel_cuda(
+    TensorList params,
+    TensorList grads,
+    TensorList state_sums,
+    double lr,
+    double weight_decay,
+    double eps) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params.front().scalar_type(), "fused_adagrad_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const AdagradFunctor<scalar_t, accscalar_t> op{
+        static_cast<accscalar_t>(lr),
+        static_cast<accscalar_t>(weight_decay),
+        static_cast<accscalar_t>(eps)};
+    multi_tensor_apply<3, scalar_t>({{params, grads, state_sums}}, op);
+  });
+}
+
+void fused_rmsprop_kernel_cuda(
+    TensorList params,
+    TensorList grads,
+    TensorList square_avgs,
+    TensorList grad_avgs,
+    TensorList momentum_buffers,
+    double lr,
+    double alpha,
+    double eps,
+    double weight_decay,
+    double momentum) {
+  const bool use_momentum = momentum > 0;
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(params.front().scalar_type(), "fused_rmsprop_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const RMSpropFunctor<scalar_t, accscalar_t> op{
+        static_cast<accscalar_t>(lr),
+        static_cast<accscalar_t>(alpha),
+        static_cast<accscalar_t>(eps),
+        static_cast<accscalar_t>(weight_decay),
+        static_cast<accscalar_t>(momentum),
+        !grad_avgs.empty(),
+        use_momentum};
+    multi_tensor_apply<5, scalar_t>(
+        {{params,
+          grads,
+          square_avgs,
+          grad_avgs,
+          use_momentum ? momentum_buffers : TensorList()}},
+        op);
+  });
+}
+
+bool unscale_grads_kernel_cuda(TensorList grads, double inv_scale) {
+  auto found_non_finite = at::zeros({1}, grads.front().options().dtype(kInt));
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(grads.front().scalar_type(), "unscale_grads_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const UnscaleFunctor<scalar_t, accscalar_t> op{
+        static_cast<accscalar_t>(inv_scale),
+        found_non_finite.data<int>()};
+    multi_tensor_apply<1, scalar_t>({{grads}}, op);
+  });
+  return found_non_finite.item<int>() == 0;
+}
+
+} // namespace
+
+REGISTER_DISPATCH(fused_sgd_stub, &fused_sgd_kernel_cuda);
+REGISTER_DISPATCH(fused_adam_stub, &fused_adam_kernel_cuda);
+REGISTER_DISPATCH(fused_adagrad_stub, &fused_adagrad_kernel_cuda);
+REGISTER_DISPATCH(fused_rmsprop_stub, &fused_rmsprop_kernel_cuda);
+REGISTER_DISPATCH(unscale_grads_stub, &unscale_grads_kernel_cuda);
+
+}} // namespace at::native
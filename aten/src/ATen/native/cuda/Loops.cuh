@@ -7,6 +7,8 @@
 #include <ATen/native/TensorIterator.h>
 #include <c10/macros/Macros.h>
 
+#include <cstdint>
+
 // Marks a lambda as executable on both the host and device. The __host__
 // attribute is important so that we can access static type information from
 // the host, even if the function is typically only executed on the device.
@@ -50,6 +52,109 @@ __global__ void elementwise_kernel(int N, func_t f) {
   }
 }
 
+// Contiguous operands whose data pointers are aligned for it are loaded and
+// stored vec_size elements at a time, with up to 16 byte memory accesses
+// (float4, or 4 halves). Each thread handles one vector per iteration of a
+// grid-stride loop over a grid that just fills the device, and the last
+// numel % vec_size elements are handled one by one.
+namespace memory {
+
+template <typename scalar_t, int vec_size>
+struct alignas(sizeof(scalar_t) * vec_size) aligned_vector {
+  scalar_t val[vec_size];
+};
+
+constexpr int min_int(int a, int b) {
+  return a < b ? a : b;
+}
+
+// At most 4 elements, in at most 16 bytes
+template <typename scalar_t>
+constexpr int max_vec_size() {
+  return sizeof(scalar_t) >= 16 ? 1 : min_int(4, 16 / sizeof(scalar_t));
+}
+
+template <int vec_size, typename scalar_t>
+bool is_aligned(const char* ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % (sizeof(scalar_t) * vec_size) == 0;
+}
+
+} // namespace memory
+
+static inline int64_t vectorized_grid_size(int64_t nvec, int block_size) {
+  auto* props = at::cuda::getCurrentDeviceProperties();
+  int64_t max_blocks =
+      props->multiProcessorCount * (props->maxThreadsPerMultiProcessor / block_size);
+  int64_t blocks = (nvec + block_size - 1) / block_size;
+  return std::max<int64_t>(std::min(blocks, max_blocks), 1);
+}
+
+template<int vec_size, typename func_t, typename out_t>
+C10_LAUNCH_BOUNDS_1(launch_size_1d)
+__global__ void vectorized_nullary_kernel(int N, func_t f, out_t* out) {
+  using out_vec_t = memory::aligned_vector<out_t, vec_size>;
+  int nvec = N / vec_size;
+  int tid = blockIdx.x * blockDim.x + threadIdx.x;
+  for (int i = tid; i < nvec; i += blockDim.x * gridDim.x) {
+    out_vec_t r;
+    #pragma unroll
+    for (int j = 0; j < vec_size; j++) {
+      r.val[j] = f();
+    }
+    reinterpret_cast<out_vec_t*>(out)[i] = r;
+  }
+  int idx = nvec * vec_size + tid;
+  if (idx < N) {
+    out[idx] = f();
+  }
+}
+
+template<int vec_size, typename func_t, typename out_t, typename in1_t>
+C10_LAUNCH_BOUNDS_1(launch_size_1d)
+__global__ void vectorized_unary_kernel(int N, func_t f, out_t* out, const in1_t* in1) {
+  using out_vec_t = memory::aligned_vector<out_t, vec_size>;
+  using in1_vec_t = memory::aligned_vector<in1_t, vec_size>;
+  int nvec = N / vec_size;
+  int tid = blockIdx.x * blockDim.x + threadIdx.x;
+  for (int i = tid; i < nvec; i += blockDim.x * gridDim.x) {
+    in1_vec_t a = reinterpret_cast<const in1_vec_t*>(in1)[i];
+    out_vec_t r;
+    #pragma unroll
+    for (int j = 0; j < vec_size; j++) {
+      r.val[j] = f(a.val[j]);
+    }
+    reinterpret_cast<out_vec_t*>(out)[i] = r;
+  }
+  int idx = nvec * vec_size + tid;
+  if (idx < N) {
+    out[idx] = f(in1[idx]);
+  }
+}
+
+template<int vec_size, typename func_t, typename out_t, typename in1_t, typename in2_t>
+C10_LAUNCH_BOUNDS_1(launch_size_1d)
+__global__ void vectorized_binary_kernel(int N, func_t f, out_t* out, const in1_t* in1, const in2_t* in2) {
+  using out_vec_t = memory::aligned_vector<out_t, vec_size>;
+  using in1_vec_t = memory::aligned_vector<in1_t, vec_size>;
+  using in2_vec_t = memory::aligned_vector<in2_t, vec_size>;
+  int nvec = N / vec_size;
+  int tid = blockIdx.x * blockDim.x + threadIdx.x;
+  for (int i = tid; i < nvec; i += blockDim.x * gridDim.x) {
+    in1_vec_t a = reinterpret_cast<const in1_vec_t*>(in1)[i];
+    in2_vec_t b = reinterpret_cast<const in2_vec_t*>(in2)[i];
+    out_vec_t r;
+    #pragma unroll
+    for (int j = 0; j < vec_size; j++) {
+      r.val[j] = f(a.val[j], b.val[j]);
+    }
+    reinterpret_cast<out_vec_t*>(out)[i] = r;
+  }
+  int idx = nvec * vec_size + tid;
+  if (idx < N) {
+    out[idx] = f(in1[idx], in2[idx]);
+  }
+}
+
 template<int N>
 static OffsetCalculator<N> make_offset_calculator(const TensorIterator& iter) {
   AT_ASSERT(N == iter.ntensors());
@@ -92,7 +197,15 @@ void gpu_nullary_kernel(TensorIterator& iter, const func_t& f) {
   if (numel == 0) {
     return;
   }
-  if (iter.is_trivial_1d()) {
+  constexpr int vec_size = memory::max_vec_size<arg0_t>();
+  if (iter.is_trivial_1d() && iter.get_inner_strides()[0] == sizeof(arg0_t) &&
+      memory::is_aligned<vec_size, arg0_t>(out_data)) {
+    int64_t grid = vectorized_grid_size(numel / vec_size, launch_size_1d);
+    vectorized_nullary_kernel<vec_size>
+        <<<grid, launch_size_1d, 0, at::cuda::getCurrentCUDAStream()>>>(
+            numel, f, (arg0_t*)out_data);
+    AT_CUDA_CHECK(cudaGetLastError());
+  } else if (iter.is_trivial_1d()) {
     auto strides = iter.get_inner_strides();
     int stride0 = strides[0];
     launch_kernel<launch_size_1d, 1>(numel, [=]__device__(int idx) {
@@ -126,6 +239,8 @@ void gpu_unary_kernel(TensorIterator& iter, const func_t& f) {
   using traits = unary_function_traits<func_t>;
   using arg0_t = typename traits::result_type;
   using arg1_t = typename traits::arg1_t;
+  constexpr int vec_size = memory::min_int(
+      memory::max_vec_size<arg0_t>(), memory::max_vec_size<arg1_t>());
 
   int64_t numel = iter.numel();
   if (numel == 0) {
@@ -137,6 +252,16 @@ void gpu_unary_kernel(TensorIterator& iter, const func_t& f) {
     gpu_nullary_kernel(iter, [=]GPU_LAMBDA(void) {
       return f(a);
     });
+  } else if (iter.is_trivial_1d() &&
+             iter.get_inner_strides()[0] == sizeof(arg0_t) &&
+             iter.get_inner_strides()[1] == sizeof(arg1_t) &&
+             memory::is_aligned<vec_size, arg0_t>(out_data) &&
+             memory::is_aligned<vec_size, arg1_t>(in1_data)) {
+    int64_t grid = vectorized_grid_size(numel / vec_size, launch_size_1d);
+    vectorized_unary_kernel<vec_size>
+        <<<grid, launch_size_1d, 0, at::cuda::getCurrentCUDAStream()>>>(
+            numel, f, (arg0_t*)out_data, (const arg1_t*)in1_data);
+    AT_CUDA_CHECK(cudaGetLastError());
   } else if (iter.is_trivial_1d()) {
     auto strides = iter.get_inner_strides();
     int stride0 = strides[0];
@@ -176,6 +301,8 @@ void gpu_binary_kernel(TensorIterator& iter, const func_t& f) {
   using arg0_t = typename traits::result_type;
   using arg1_t = typename traits::arg1_t;
   using arg2_t = typename traits::arg2_t;
+  constexpr int vec_size = memory::min_int(memory::max_vec_size<arg0_t>(),
+      memory::min_int(memory::max_vec_size<arg1_t>(), memory::max_vec_size<arg2_t>()));
 
   int numel = iter.numel();
   if (numel == 0) {
@@ -193,6 +320,18 @@ void gpu_binary_kernel(TensorIterator& iter, const func_t& f) {
     gpu_unary_kernel(iter, [=]GPU_LAMBDA(arg1_t a) {
       return f(a, b);
     });
+  } else if (iter.is_trivial_1d() &&
+             iter.get_inner_strides()[0] == sizeof(arg0_t) &&
+             iter.get_inner_strides()[1] == sizeof(arg1_t) &&
+             iter.get_inner_strides()[2] == sizeof(arg2_t) &&
+             memory::is_aligned<vec_size, arg0_t>(out_data) &&
+             memory::is_aligned<vec_size, arg1_t>(in1_data) &&
+             memory::is_aligned<vec_size, arg2_t>(in2_data)) {
+    int64_t grid = vectorized_grid_size(numel / vec_size, launch_size_1d);
+    vectorized_binary_kernel<vec_size>
+        <<<grid, launch_size_1d, 0, at::cuda::getCurrentCUDAStream()>>>(
+            numel, f, (arg0_t*)out_data, (const arg1_t*)in1_data, (const arg2_t*)in2_data);
+    AT_CUDA_CHECK(cudaGetLastError());
   } else if (iter.is_trivial_1d()) {
     auto strides = iter.get_inner_strides();
     int stride0 = strides[0];
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+
+#include <array>
+
+namespace at { namespace native {
+
+// Applies a functor to chunks of `depth` lists of contiguous tensors, with a
+// single kernel launch for as many tensors as fit in the kernel arguments.
+//
+// The addresses and sizes of the tensors, and which chunk of which tensor each
+// block processes, are passed by value in a TensorListMetadata, which must
+// stay below the 4KB limit of the kernel arguments; hence the number of
+// tensors and blocks per launch decreases with the depth. Lists of more
+// tensors, or of more chunks, are processed by several launches.
+//
+// Adapted from the multi_tensor_apply of NVIDIA's apex.
+
+constexpr int kMultiTensorApplyBlockSize = 512;
+constexpr int64_t kMultiTensorApplyChunkSize = 65536;
+constexpr int kMultiTensorApplyMaxTensors[] = {110, 64, 48, 36, 30};
+constexpr int kMultiTensorApplyMaxBlocks[] = {320, 320, 320, 320, 320};
+
+template <int depth>
+struct TensorListMetadata {
+  void* addresses[depth][kMultiTensorApplyMaxTensors[depth - 1]];
+  int64_t sizes[kMultiTensorApplyMaxTensors[depth - 1]];
+  unsigned char block_to_tensor[kMultiTensorApplyMaxBlocks[depth - 1]];
+  int block_to_chunk[kMultiTensorApplyMaxBlocks[depth - 1]];
+};
+
+// Each block calls op(ptrs, i) for the elements i of its chunk, where ptrs[d]
+// points to the start of the chunk in the tensor of list d (or is nullptr if
+// list d is empty).
+template <int depth, typename scalar_t, typename Op>
+__global__ void multi_tensor_apply_kernel(TensorListMetadata<depth> tl, Op op) {
+  const int tensor = tl.block_to_tensor[blockIdx.x];
+  const int64_t start =
+      static_cast<int64_t>(tl.block_to_chunk[blockIdx.x]) *
+      kMultiTensorApplyChunkSize;
+  const int64_t remaining = tl.sizes[tensor] - start;
+  const int64_t n = remaining < kMultiTensorApplyChunkSize
+      ? remaining
+      : kMultiTensorApplyChunkSize;
+  scalar_t* ptrs[depth];
+#pragma unroll
+  for (int d = 0; d < depth; ++d) {
+    ptrs[d] = tl.addresses[d][tensor]
+        ? static_cast<scalar_t*>(tl.addresses[d][tensor]) + start
+        : nullptr;
+  }
+  for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+    op(ptrs, i);
+  }
+}
+
+// Packs chunks of `depth` lists of contiguous tensors into TensorListMetadata
+// and calls launch(tl, num_blocks) for each of them, where block b of a launch
+// is to process chunk tl.block_to_chunk[b] of tensor tl.block_to_tensor[b].
+// Every chunk is processed exactly once, in order, so the blocks of the
+// successive launches number the chunks of all the tensors consecutively.
+// The tensors at the same index of the lists must have the same number of
+// elements; a list may be empty.
+template <int depth, typename Launch>
+void multi_tensor_apply_blocks(
+    const std::array<TensorList, depth>& lists,
+    const Launch& launch) {
+  constexpr int max_tensors = kMultiTensorApplyMaxTensors[depth - 1];
+  constexpr int max_blocks = kMultiTensorApplyMaxBlocks[depth - 1];
+  const auto& tensors = lists[0];
+
+  TensorListMetadata<depth> tl;
+  int num_tensors = 0;
+  int num_blocks = 0;
+  for (size_t t = 0; t < tensors.size(); ++t) {
+    const auto numel = tensors[t].numel();
+    if (numel == 0) {
+      continue;
+    }
+    for (int d = 0; d < depth; ++d) {
+      tl.addresses[d][num_tensors] =
+          lists[d].empty() ? nullptr : lists[d][t].data_ptr();
+    }
+    tl.sizes[num_tensors] = numel;
+    ++num_tensors;
+    const int64_t num_chunks =
+        (numel + kMultiTensorApplyChunkSize - 1) / kMultiTensorApplyChunkSize;
+    for (int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+      tl.block_to_tensor[num_blocks] = num_tensors - 1;
+      tl.block_to_chunk[num_blocks] = chunk;
+      ++num_blocks;
+      const bool last_chunk = chunk == num_chunks - 1;
+      if (num_blocks == max_blocks || (num_tensors == max_tensors && last_chunk)) {
+        launch(tl, num_blocks);
+        num_blocks = 0;
+        if (last_chunk) {
+          num_tensors = 0;
+        } else {
+          // The next launch carries on with the rest of the current tensor.
+          for (int d = 0; d < depth; ++d) {
+            tl.addresses[d][0] = tl.addresses[d][num_tensors - 1];
+          }
+          tl.sizes[0] = tl.sizes[num_tensors - 1];
+          num_tensors = 1;
+        }
+      }
+    }
+  }
+  if (num_blocks > 0) {
+    launch(tl, num_blocks);
+  }
+}
+
+// The tensors at the same index of the lists must have the same number of
+// elements; a list may be empty.
+template <int depth, typename scalar_t, typename Op>
+void multi_tensor_apply(const std::array<TensorList, depth>& lists, const Op& op) {
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  multi_tensor_apply_blocks<depth>(
+      lists, [&](const TensorListMetadata<depth>& tl, int num_blocks) {
+        multi_tensor_apply_kernel<depth, scalar_t, Op>
+            <<<num_blocks, kMultiTensorApplyBlockSize, 0, stream>>>(tl, op);
+        AT_CUDA_CHECK(cudaGetLastError());
+      });
+}
+
+}} // namespace at::native
@@ -0,0 +1,132 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/native/MultiTensorNorm.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+
+#include <cmath>
+
+namespace at { namespace native {
+
+namespace {
+
+// How the elements are reduced, by norm_type.
+enum class NormMode { P, One, Two, Inf };
+
+template <typename accscalar_t>
+__device__ __forceinline__ accscalar_t combine(
+    NormMode mode,
+    accscalar_t a,
+    accscalar_t b) {
+  if (mode == NormMode::Inf) {
+    // Propagates NaNs, like max().
+    return (b > a || ::isnan(b)) ? b : a;
+  }
+  return a + b;
+}
+
+// Each block reduces its chunk into partials[blockIdx.x].
+template <typename scalar_t, typename accscalar_t>
+__global__ void multi_tensor_norm_kernel(
+    TensorListMetadata<1> tl,
+    accscalar_t* partials,
+    NormMode mode,
+    accscalar_t p) {
+  const int tensor = tl.block_to_tensor[blockIdx.x];
+  const int64_t start =
+      static_cast<int64_t>(tl.block_to_chunk[blockIdx.x]) *
+      kMultiTensorApplyChunkSize;
+  const int64_t remaining = tl.sizes[tensor] - start;
+  const int64_t n = remaining < kMultiTensorApplyChunkSize
+      ? remaining
+      : kMultiTensorApplyChunkSize;
+  const scalar_t* data = static_cast<const scalar_t*>(tl.addresses[0][tensor]) + start;
+
+  accscalar_t partial = 0;
+  for (int64_t i = threadIdx.x; i < n; i += blockDim.x) {
+    const accscalar_t x = ::fabs(static_cast<accscalar_t>(data[i]));
+    switch (mode) {
+      case NormMode::Two:
+        partial += x * x;
+        break;
+      case NormMode::One:
+        partial += x;
+        break;
+      case NormMode::Inf:
+        partial = combine(mode, partial, x);
+        break;
+      default:
+        partial += ::pow(x, p);
+    }
+  }
+
+  __shared__ accscalar_t shared[kMultiTensorApplyBlockSize];
+  shared[threadIdx.x] = partial;
+  __syncthreads();
+  for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+    if (threadIdx.x < stride) {
+      shared[threadIdx.x] =
+          combine(mode, shared[threadIdx.x], shared[threadIdx.x + stride]);
+    }
+    __syncthreads();
+  }
+  if (threadIdx.x == 0) {
+    partials[blockIdx.x] = shared[0];
+  }
+}
+
+template <typename scalar_t, typename accscalar_t>
+struct ScaleFunctor {
+  const accscalar_t* scale;
+
+  __device__ void operator()(scalar_t* const* ptrs, int64_t i) const {
+    ptrs[0][i] = static_cast<accscalar_t>(ptrs[0][i]) * *scale;
+  }
+};
+
+Tensor multi_tensor_norm_kernel_cuda(TensorList tensors, double norm_type) {
+  int64_t num_chunks = 0;
+  for (const auto& tensor : tensors) {
+    num_chunks += (tensor.numel() + kMultiTensorApplyChunkSize - 1) /
+        kMultiTensorApplyChunkSize;
+  }
+  const NormMode mode = std::isinf(norm_type)
+      ? NormMode::Inf
+      : norm_type == 2 ? NormMode::Two
+                       : norm_type == 1 ? NormMode::One : NormMode::P;
+  const auto& front = tensors.front();
+  const auto options =
+      front.options().dtype(front.scalar_type() == kDouble ? kDouble : kFloat);
+  // Every block writes its partial; an empty list reduces to 0.
+  auto partials = num_chunks > 0 ? at::empty({num_chunks}, options)
+                                 : at::zeros({1}, options);
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(front.scalar_type(), "multi_tensor_norm_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+    accscalar_t* output = partials.data<accscalar_t>();
+    multi_tensor_apply_blocks<1>(
+        {{tensors}}, [&](const TensorListMetadata<1>& tl, int num_blocks) {
+          multi_tensor_norm_kernel<scalar_t, accscalar_t>
+              <<<num_blocks, kMultiTensorApplyBlockSize, 0, stream>>>(
+                  tl, output, mode, static_cast<accscalar_t>(norm_type));
+          AT_CUDA_CHECK(cudaGetLastError());
+          output += num_blocks;
+        });
+  });
+  return partials;
+}
+
+void multi_tensor_scale_kernel_cuda(TensorList tensors, const Tensor& scale) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(tensors.front().scalar_type(), "multi_tensor_scale_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    const ScaleFunctor<scalar_t, accscalar_t> op{scale.data<accscalar_t>()};
+    multi_tensor_apply<1, scalar_t>({{tensors}}, op);
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(multi_tensor_norm_stub, &multi_tensor_norm_kernel_cuda);
+REGISTER_DISPATCH(multi_tensor_scale_stub, &multi_tensor_scale_kernel_cuda);
+
+}} // namespace at::native
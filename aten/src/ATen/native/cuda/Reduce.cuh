@@ -11,6 +11,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cuda/Loops.cuh>
 #include <c10/macros/Macros.h>
+#include <thrust/pair.h>
 #include <functional>
 #include <iosfwd>
 #include <tuple>
@@ -200,9 +201,10 @@ template <typename index_t>
 static OffsetCalculator<2, index_t> make_output_calculator(const TensorIterator& iter) {
   int num_reduce_dims = iter.num_reduce_dims();
   int num_output_dims = iter.ndim() - num_reduce_dims;
+  int input_index = iter.ntensors() - 1;
   std::array<const int64_t*, 2> strides = {
     iter.strides(0).data() + num_reduce_dims,
-    iter.strides(1).data() + num_reduce_dims,
+    iter.strides(input_index).data() + num_reduce_dims,
   };
   auto shape = iter.shape().data() + num_reduce_dims;
   return OffsetCalculator<2, index_t>(num_output_dims, shape, strides.data());
@@ -211,8 +213,9 @@ static OffsetCalculator<2, index_t> make_output_calculator(const TensorIterator&
 template <typename index_t>
 static OffsetCalculator<1, index_t> make_input_calculator(const TensorIterator& iter) {
   int num_reduce_dims = iter.num_reduce_dims();
+  int input_index = iter.ntensors() - 1;
   std::array<const int64_t*, 1> strides = {
-    iter.strides(1).data(),
+    iter.strides(input_index).data(),
   };
   return OffsetCalculator<1, index_t>(num_reduce_dims, iter.shape().data(), strides.data());
 }
@@ -277,7 +280,10 @@ struct ReduceOp {
   InputCalculator input_calc;
   OutputCalculator output_calc;
   const void* src;
-  void* dst;
+  // Every output shares the offsets of the first one; the second output is
+  // only written when project() returns a pair and noutputs is 2.
+  void* dst[2];
+  int noutputs;
   // acc_buf used for accumulation among sub Tensor Iterator when accumulation on
   // output is not permissible
   void* acc_buf;
@@ -294,7 +300,8 @@ struct ReduceOp {
     , input_calc(input_calc)
     , output_calc(output_calc)
     , src(src)
-    , dst(dst)
+    , dst{dst, nullptr}
+    , noutputs(1)
     , acc_buf(acc_buf)
     , cta_buf(cta_buf)
     , semaphores(semaphores)
@@ -320,7 +327,7 @@ struct ReduceOp {
       value = block_x_reduce(value, shared_memory);
     }
 
-    auto out = (out_scalar_t*)((char*)dst + base_offsets[0]);
+    auto out = (out_scalar_t*)((char*)dst[0] + base_offsets[0]);
     arg_t* acc = nullptr;
     if (acc_buf != nullptr) {
       size_t numerator = sizeof(arg_t);
@@ -330,19 +337,23 @@ struct ReduceOp {
     }
 
     if (config.should_global_reduce()) {
-      value = global_reduce(value, out, acc, shared_memory);
+      value = global_reduce(value, out, base_offsets[0], acc, shared_memory);
     } else if (config.should_store(output_idx)) {
       if (acc == nullptr) {
         if (accumulate) {
           value = accumulate_in_output<can_accumulate_in_output>(out, value);
         }
-        *out = project_if_necessary<can_accumulate_in_output>(value);
+        if (final_output) {
+          set_results_to_output(value, base_offsets[0]);
+        } else {
+          *out = get_accumulated_output<can_accumulate_in_output>(out, value);
+        }
       } else {
         if (accumulate) {
           value = ops.combine(*acc, value);
         }
         if (final_output) {
-          *out = ops.project(value);
+          set_results_to_output(value, base_offsets[0]);
         } else {
           *acc = value;
         }
@@ -453,11 +464,12 @@ struct ReduceOp {
   }
 
   template <bool can_acc>
-  C10_DEVICE out_scalar_t project_if_necessary(
-    arg_t value,
+  C10_DEVICE out_scalar_t get_accumulated_output(
+    out_scalar_t* out, arg_t value,
     typename std::enable_if<can_acc>::type* = nullptr
   ) const {
-    return final_output ? (out_scalar_t)ops.project(value) : (out_scalar_t)value;
+    assert(!final_output);
+    return (out_scalar_t)value;
   }
 
 
@@ -473,16 +485,44 @@ struct ReduceOp {
     return arg_t {};
   }
 
+  // This function should never be called --
+  // it's the version of `get_accumulated_output`
+  // when accumulation in the output is not possible.
   template <bool can_acc>
-  C10_DEVICE out_scalar_t project_if_necessary(
-    arg_t value,
+  C10_DEVICE out_scalar_t get_accumulated_output(
+    out_scalar_t* out, arg_t value,
     typename std::enable_if<!can_acc>::type* = nullptr
   ) const {
+    assert(false);
+    return *out;
+  }
+
+  template<class T>
+  C10_DEVICE void set_results(const T x, const index_t base_offset) const {
+    auto res = (out_scalar_t*)((char*)dst[0] + base_offset);
+    *res = x;
+  }
+
+  // Writes the first element to the first output, and the second one to the
+  // second output if there is one (var_mean has two outputs, var only one).
+  template<class T>
+  C10_DEVICE void set_results(const thrust::pair<T, T> x, const index_t base_offset) const {
+    if (noutputs >= 1) {
+      auto res0 = (out_scalar_t*)((char*)dst[0] + base_offset);
+      *res0 = x.first;
+    }
+    if (noutputs >= 2) {
+      auto res1 = (out_scalar_t*)((char*)dst[1] + base_offset);
+      *res1 = x.second;
+    }
+  }
+
+  C10_DEVICE void set_results_to_output(arg_t value, index_t base_offset) const {
     assert(final_output);
-    return ops.project(value);
+    set_results(ops.project(value), base_offset);
   }
 
-  C10_DEVICE arg_t global_reduce(arg_t value, out_scalar_t* out, arg_t* acc, char* shared_memory) const {
+  C10_DEVICE arg_t global_reduce(arg_t value, out_scalar_t* out, index_t base_offset, arg_t* acc, char* shared_memory) const {
     arg_t* reduce_buffer = (arg_t*)cta_buf;
 
     bool should_store = config.should_store(config.output_idx());
@@ -523,13 +563,17 @@ struct ReduceOp {
           if (accumulate) {
             value = accumulate_in_output<can_accumulate_in_output>(out, value);
           }
-          *out = project_if_necessary<can_accumulate_in_output>(value);
+          if (final_output) {
+            set_results_to_output(value, base_offset);
+          } else {
+            *out = get_accumulated_output<can_accumulate_in_output>(out, value);
+          }
         } else {
           if (accumulate) {
             value = ops.combine(*acc, value);
           }
           if (final_output) {
-            *out = ops.project(value);
+            set_results_to_output(value, base_offset);
           } else {
             *acc = value;
           }
@@ -590,7 +634,7 @@ struct AccumulationBuffer {
 template <typename scalar_t, typename out_scalar_t, int vt0=4, typename ops_t, typename ident_t=double>
 inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t ident=0,
                               AccumulationBuffer* acc_buf_ptr=nullptr) {
-  AT_ASSERT(iter.numel() > 0 && iter.ntensors() == 2);
+  AT_ASSERT(iter.numel() > 0 && iter.ntensors() - iter.noutputs() == 1 && iter.noutputs() >= 1);
 
   using traits = binary_function_traits<decltype(&ops_t::reduce)>;
   using arg_t = typename traits::arg1_t;
@@ -628,7 +672,9 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
   }
 
   char* out_data = (char*)iter.data_ptr(0);
-  const char* in_data = (char*)iter.data_ptr(1);
+  char* out_data_extra = iter.noutputs() > 1 ? (char*)iter.data_ptr(1) : nullptr;
+  const int input_index = iter.ntensors() - 1;
+  const char* in_data = (char*)iter.data_ptr(input_index);
   char* acc_data = acc_buf_ptr->get_acc_slice(out_data);
 
   // Start by assuming that each thread handles a single output and all
@@ -641,7 +687,7 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
   int64_t dim0;
   int64_t dim1;
   // adjust block size to fit width to fast changing dimension
-  if (iter.strides(/*arg=*/1)[0] == sizeof(scalar_t)) {
+  if (iter.strides(/*arg=*/input_index)[0] == sizeof(scalar_t)) {
     dim0 = iter.shape()[0];
     dim1 = num_outputs;
   } else {
@@ -654,7 +700,7 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
   int block_width = config.block_width;
   int block_height = config.block_height;
 
-  if (iter.ndim() == 0 || iter.strides(/*arg=*/1)[0] == sizeof(scalar_t)) {
+  if (iter.ndim() == 0 || iter.strides(/*arg=*/input_index)[0] == sizeof(scalar_t)) {
     // Split the input across lanes if the input is contiguous in the reduced
     // dimension. This will require reduction between threads using warp
     // shuffle instructions and shared memory (if block_width > warpSize).
@@ -712,6 +758,10 @@ inline void gpu_reduce_kernel(TensorIterator& iter, const ops_t& ops, ident_t id
       ident);
   reduce.accumulate = iter.should_accumulate();
   reduce.final_output = iter.is_final_output();
+  if (out_data_extra != nullptr) {
+    reduce.noutputs = iter.noutputs();
+    reduce.dst[1] = out_data_extra;
+  }
 
   launch_reduce_kernel<ReduceConfig::MAX_NUM_THREADS>(config, reduce);
 }
@@ -27,14 +27,14 @@ template <typename scalar_t>
 void std_var_kernel_impl(TensorIterator& iter, bool unbiased, bool take_sqrt) {
   // reducing unrolling factor to 2 for welford kernel
   // This is necessary to lower register usage that leads to register spills.
-  gpu_reduce_kernel<scalar_t, scalar_t, 2>(iter, WelfordOps<scalar_t, scalar_t, int32_t, float> { unbiased, take_sqrt }, WelfordData<scalar_t, int32_t, float> {});
+  gpu_reduce_kernel<scalar_t, scalar_t, 2>(iter, WelfordOps<scalar_t, scalar_t, int32_t, float, thrust::pair<scalar_t, scalar_t>> { unbiased, take_sqrt }, WelfordData<scalar_t, int32_t, float> {});
 }
 
 template <>
 void std_var_kernel_impl<at::Half>(TensorIterator& iter, bool unbiased, bool take_sqrt) {
   // reducing unrolling factor to 2 for welford kernel
   // This is necessary to lower register usage that leads to register spills.
-  gpu_reduce_kernel<at::Half, at::Half, 2>(iter, WelfordOps<at::Half, float, int32_t, float> { unbiased, take_sqrt }, WelfordData<float, int32_t, float> {});
+  gpu_reduce_kernel<at::Half, at::Half, 2>(iter, WelfordOps<at::Half, float, int32_t, float, thrust::pair<at::Half, at::Half>> { unbiased, take_sqrt }, WelfordData<float, int32_t, float> {});
 }
 
 template <typename scalar_t, typename acc_t=scalar_t>
@@ -155,6 +155,14 @@ void min_values_kernel_cuda_impl(TensorIterator& iter) {
     }), at::numeric_limits<scalar_t>::upper_bound());
 }
 
+template <typename scalar_t>
+void aminmax_kernel_cuda_impl(TensorIterator& iter) {
+  using acc_t = thrust::pair<scalar_t, scalar_t>;
+  gpu_reduce_kernel<scalar_t, scalar_t>(
+    iter, MinMaxOps<scalar_t, acc_t> {},
+    acc_t(at::numeric_limits<scalar_t>::upper_bound(), at::numeric_limits<scalar_t>::lower_bound()));
+}
+
 void max_values_kernel_cuda(TensorIterator& iter) {
   AT_DISPATCH_ALL_TYPES(iter.dtype(), "max_values_cuda", [&]() {
     max_values_kernel_cuda_impl<scalar_t>(iter);
@@ -167,6 +175,12 @@ void min_values_kernel_cuda(TensorIterator& iter) {
   });
 }
 
+void aminmax_kernel_cuda(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.dtype(), "aminmax_cuda", [&]() {
+    aminmax_kernel_cuda_impl<scalar_t>(iter);
+  });
+}
+
 REGISTER_DISPATCH(std_var_stub, &std_var_kernel_cuda);
 REGISTER_DISPATCH(sum_stub, &sum_kernel_cuda);
 REGISTER_DISPATCH(prod_stub, &prod_kernel_cuda);
@@ -176,5 +190,6 @@ REGISTER_DISPATCH(and_stub, &and_kernel_cuda);
 REGISTER_DISPATCH(or_stub, &or_kernel_cuda);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_cuda);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_cuda);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_cuda);
 
 }} // namespace at::native
@@ -12,4 +12,9 @@ Tensor& resize_cuda_(Tensor& self, IntArrayRef size) {
   return self;
 }
 
+Tensor& reserve_cuda_(Tensor& self, int64_t capacity) {
+  reserve_storage_cuda(self.unsafeGetTensorImpl(), capacity);
+  return self;
+}
+
 }}
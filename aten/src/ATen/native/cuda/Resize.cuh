@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/ATen.h>
+#include <ATen/native/Resize.h>
 #include <THC/THCTensor.hpp>
 
 #include <c10/cuda/CUDAGuard.h>
@@ -20,11 +21,27 @@ static inline void maybe_resize_storage_cuda(TensorImpl* self, int64_t new_size)
       THCStorage_resize(
           globalContext().getTHCState(),
           THTensor_getStoragePtr(self),
-          new_size + self->storage_offset());
+          storage_size_for_resize(self, new_size));
     }
   }
 }
 
+static inline void reserve_storage_cuda(TensorImpl* self, int64_t capacity) {
+  AT_CHECK(capacity >= 0, "reserve_: capacity must be non-negative, but got ", capacity);
+  if (capacity + self->storage_offset() > 0) {
+    if (!THTensor_getStoragePtr(self)) {
+      AT_ERROR("Tensor: invalid null storage");
+    }
+    if (capacity + self->storage_offset() > self->storage().numel()) {
+      THCStorage_resize(
+          globalContext().getTHCState(),
+          THTensor_getStoragePtr(self),
+          capacity + self->storage_offset());
+    }
+  }
+  self->set_reserved(true);
+}
+
 inline TensorImpl* resize_impl_cuda_(
     TensorImpl* self,
     IntArrayRef size,
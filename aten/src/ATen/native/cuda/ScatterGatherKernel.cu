@@ -0,0 +1,329 @@
+#include <ATen/native/Indexing.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/cuda/Array.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/detail/IndexUtils.cuh>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/EmbeddingBackwardKernel.cuh>
+#include <ATen/native/cuda/Loops.cuh>
+
+#include <THC/THCAtomics.cuh>
+#include <THC/THCThrustAllocator.cuh>
+
+#include <thrust/execution_policy.h>
+#include <thrust/sequence.h>
+#include <thrust/sort.h>
+
+#include <cuda_fp16.h>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace at { namespace native {
+namespace {
+
+// The kernels that only move elements are templated on an opaque, self-aligned
+// type of the correct size, like the index kernels.
+template <int N> struct alignas(N) OpaqueType { char data[N]; };
+
+// Views t with the shape of index, with the sizes of dim replaced by
+// dim_size and its stride by dim_stride
+static Tensor restride_dim(const Tensor & t, int64_t dim, const Tensor & index,
+                           int64_t dim_size, int64_t dim_stride) {
+  auto sizes = index.sizes().vec();
+  auto strides = t.strides().vec();
+  sizes[dim] = dim_size;
+  strides[dim] = dim_stride;
+  return t.as_strided(sizes, strides);
+}
+
+// Calls f(ptrs) for each element of iter, where ptrs[t] points to the element
+// of operand t. Iterators that need 64-bit offsets are split into ones that
+// don't.
+template <int N, typename func_t>
+void gpu_scatter_gather_kernel(TensorIterator& iter, const func_t& f) {
+  if (iter.numel() == 0) {
+    return;
+  }
+  if (!iter.can_use_32bit_indexing()) {
+    for (auto& sub_iter : iter.with_32bit_indexing()) {
+      gpu_scatter_gather_kernel<N>(sub_iter, f);
+    }
+    return;
+  }
+  auto data = cuda::Array<char*, N>(nullptr);
+  for (int t = 0; t < N; t++) {
+    data[t] = (char*)iter.data_ptr(t);
+  }
+  auto offset_calc = make_offset_calculator<N>(iter);
+  launch_kernel<launch_size_nd, launch_bound2>(iter.numel(), [=]__device__(int i) {
+    auto offsets = offset_calc.get(i);
+    cuda::Array<char*, N> ptrs;
+    #pragma unroll
+    for (int t = 0; t < N; t++) {
+      ptrs[t] = data[t] + offsets[t];
+    }
+    f(ptrs);
+  });
+}
+
+// gather is elementwise over result and index: self is viewed with the shape
+// of index and stride 0 along dim, and each element adds its index times the
+// original stride of dim, as on CPU.
+void gather_kernel(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  auto builder = TensorIterator::Builder();
+  builder.dont_compute_common_dtype();
+  builder.dont_resize_outputs();
+  builder.add_output(result);
+  builder.add_input(restride_dim(self, dim, index, index.size(dim), 0));
+  builder.add_input(index);
+  auto iter = builder.build();
+
+  AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, self.scalar_type(), "gather_cuda", [&] {
+    using dtype = OpaqueType<sizeof(scalar_t)>;
+    gpu_scatter_gather_kernel<3>(*iter, [=]__device__(cuda::Array<char*, 3> ptrs) {
+      const int64_t idx = *(int64_t*)ptrs[2];
+      assert(idx >= 0 && idx < self_dim_size && "gather(): index out of bounds");
+      *(dtype*)ptrs[0] = ((dtype*)ptrs[1])[idx * self_dim_stride];
+    });
+  });
+}
+
+// Unlike on CPU, scatter is elementwise over index too: self is viewed like in
+// gather, and the elements that write the same element of self do so in an
+// unspecified order. scatter_add_ accumulates with atomics, see
+// deterministic_scatter_add for the alternative.
+TensorIterator::Builder scatter_builder(Tensor & self, int64_t dim, const Tensor & index) {
+  auto builder = TensorIterator::Builder();
+  builder.dont_compute_common_dtype();
+  builder.dont_resize_outputs();
+  builder.add_output(restride_dim(self, dim, index, index.size(dim), 0));
+  builder.add_input(index);
+  return builder;
+}
+
+void scatter_kernel(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  auto builder = scatter_builder(self, dim, index);
+  builder.add_input(restride_dim(src, dim, index, index.size(dim), src.stride(dim)));
+  auto iter = builder.build();
+
+  AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, self.scalar_type(), "scatter_cuda", [&] {
+    using dtype = OpaqueType<sizeof(scalar_t)>;
+    gpu_scatter_gather_kernel<3>(*iter, [=]__device__(cuda::Array<char*, 3> ptrs) {
+      const int64_t idx = *(int64_t*)ptrs[1];
+      assert(idx >= 0 && idx < self_dim_size && "scatter(): index out of bounds");
+      ((dtype*)ptrs[0])[idx * self_dim_stride] = *(dtype*)ptrs[2];
+    });
+  });
+}
+
+void scatter_fill_kernel(Tensor & self, int64_t dim, const Tensor & index, Scalar src) {
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  auto iter = scatter_builder(self, dim, index).build();
+
+  AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, self.scalar_type(), "scatter_fill_cuda", [&] {
+    const scalar_t value = src.to<scalar_t>();
+    gpu_scatter_gather_kernel<2>(*iter, [=]__device__(cuda::Array<char*, 2> ptrs) {
+      const int64_t idx = *(int64_t*)ptrs[1];
+      assert(idx >= 0 && idx < self_dim_size && "scatter(): index out of bounds");
+      ((scalar_t*)ptrs[0])[idx * self_dim_stride] = value;
+    });
+  });
+}
+
+// Returns the num_rows rows whose row i is the sum of the rows of the two-dim
+// source at the positions of i in the one-dim index, added in the order of
+// the positions whatever the scheduling: each sum is a segment reduction over
+// the occurrences of the row in the sorted indices, by the kernel of the
+// embedding backward.
+Tensor deterministic_sum_rows(const Tensor & index, const Tensor & source, int64_t num_rows) {
+  const int64_t num_indices = index.numel();
+  auto sorted_index = index.clone();
+  auto orig_index = at::empty_like(index);
+  {
+    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+    auto policy = thrust::cuda::par(allocator).on(at::cuda::getCurrentCUDAStream());
+    using device_ptr = thrust::device_ptr<int64_t>;
+    auto sorted_data = device_ptr(sorted_index.data<int64_t>());
+    auto orig_data = device_ptr(orig_index.data<int64_t>());
+    thrust::sequence(policy, orig_data, orig_data + num_indices);
+    thrust::stable_sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data);
+  }
+  // The segment reduction writes the rows of the sorted indices unchecked
+  AT_CHECK(sorted_index[0].item<int64_t>() >= 0 &&
+           sorted_index[num_indices - 1].item<int64_t>() < num_rows,
+           "index out of bounds for dimension with size ", num_rows);
+  return embedding_backward_cuda_kernel(
+      source.contiguous(), orig_index, sorted_index, Tensor(), num_rows);
+}
+
+// scatter_add_ of floating point tensors with deterministicScatter() set: the
+// elements of src are summed into rows of one element, one per element of
+// the memory of self, given by the offsets in self of their destinations.
+void deterministic_scatter_add(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  auto offsets = at::empty(index.sizes(), index.options());
+  auto builder = TensorIterator::Builder();
+  builder.dont_compute_common_dtype();
+  builder.dont_resize_outputs();
+  builder.add_output(offsets);
+  builder.add_input(restride_dim(self, dim, index, index.size(dim), 0));
+  builder.add_input(index);
+  auto iter = builder.build();
+  const char* self_data = (const char*)self.data_ptr();
+  const int64_t element_size = self.element_size();
+  gpu_scatter_gather_kernel<3>(*iter, [=]__device__(cuda::Array<char*, 3> ptrs) {
+    const int64_t idx = *(int64_t*)ptrs[2];
+    assert(idx >= 0 && idx < self_dim_size && "scatter_add(): index out of bounds");
+    *(int64_t*)ptrs[0] = (ptrs[1] - self_data) / element_size + idx * self_dim_stride;
+  });
+
+  int64_t extent = 1;
+  for (int64_t d = 0; d < self.dim(); d++) {
+    extent += (self.size(d) - 1) * self.stride(d);
+  }
+  auto sums = deterministic_sum_rows(
+      offsets.view(-1), src.contiguous().view({-1, 1}), extent);
+  self.add_(sums.as_strided(self.sizes(), self.strides()));
+}
+
+void scatter_add_kernel(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  auto src_ = restride_dim(src, dim, index, index.size(dim), src.stride(dim));
+  if (globalContext().deterministicScatter() && isFloatingType(self.scalar_type())) {
+    deterministic_scatter_add(self, dim, index, src_);
+    return;
+  }
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_dim_stride = self.stride(dim);
+  auto builder = scatter_builder(self, dim, index);
+  builder.add_input(src_);
+  auto iter = builder.build();
+
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, self.scalar_type(), "scatter_add_cuda", [&] {
+    gpu_scatter_gather_kernel<3>(*iter, [=]__device__(cuda::Array<char*, 3> ptrs) {
+      const int64_t idx = *(int64_t*)ptrs[1];
+      assert(idx >= 0 && idx < self_dim_size && "scatter_add(): index out of bounds");
+      atomicAdd((scalar_t*)ptrs[0] + idx * self_dim_stride, *(scalar_t*)ptrs[2]);
+    });
+  });
+}
+
+constexpr int kIndexAddBlockSize = 512;
+
+// self[b][index[i]][a] += source[b][i][a], a thread per element of source
+template <typename scalar_t, typename index_t>
+__global__ void index_add_kernel_impl(
+    scalar_t* self, const scalar_t* source, const int64_t* index,
+    index_t numel, index_t num_indices, index_t inner_size, int64_t self_dim_size,
+    index_t self_outer_stride, index_t self_dim_stride, index_t self_inner_stride,
+    index_t source_outer_stride, index_t source_dim_stride, index_t source_inner_stride) {
+  for (index_t linear = (index_t)blockIdx.x * blockDim.x + threadIdx.x; linear < numel;
+       linear += (index_t)blockDim.x * gridDim.x) {
+    const index_t a = linear % inner_size;
+    const index_t i = (linear / inner_size) % num_indices;
+    const index_t b = linear / inner_size / num_indices;
+    const int64_t idx = index[i];
+    assert(idx >= 0 && idx < self_dim_size && "index_add(): index out of bounds");
+    atomicAdd(self + b * self_outer_stride + idx * self_dim_stride + a * self_inner_stride,
+              source[b * source_outer_stride + i * source_dim_stride + a * source_inner_stride]);
+  }
+}
+
+// The same for contiguous rows of half of even size, a thread per pair of
+// elements, with the packed atomics of sm_60 and newer.
+template <typename index_t>
+__global__ void index_add_half2_kernel(
+    at::Half* self, const at::Half* source, const int64_t* index,
+    index_t num_pairs, index_t num_indices, index_t inner_pairs, int64_t self_dim_size,
+    index_t self_outer_stride, index_t self_dim_stride,
+    index_t source_outer_stride, index_t source_dim_stride) {
+  for (index_t linear = (index_t)blockIdx.x * blockDim.x + threadIdx.x; linear < num_pairs;
+       linear += (index_t)blockDim.x * gridDim.x) {
+    const index_t a = (linear % inner_pairs) * 2;
+    const index_t i = (linear / inner_pairs) % num_indices;
+    const index_t b = linear / inner_pairs / num_indices;
+    const int64_t idx = index[i];
+    assert(idx >= 0 && idx < self_dim_size && "index_add(): index out of bounds");
+    at::Half* dst = self + b * self_outer_stride + idx * self_dim_stride + a;
+    const at::Half* src = source + b * source_outer_stride + i * source_dim_stride + a;
+#if defined(__CUDA_ARCH__) && __CUDA_ARCH__ >= 600 && !defined(__HIP_PLATFORM_HCC__)
+    atomicAdd(reinterpret_cast<__half2*>(dst), *reinterpret_cast<const __half2*>(src));
+#else
+    atomicAdd(dst, src[0]);
+    atomicAdd(dst + 1, src[1]);
+#endif
+  }
+}
+
+static int64_t index_add_grid_size(int64_t numel) {
+  const int64_t max_grid = at::cuda::getCurrentDeviceProperties()->multiProcessorCount * 8;
+  return std::min((numel + kIndexAddBlockSize - 1) / kIndexAddBlockSize, max_grid);
+}
+
+template <typename scalar_t, typename index_t>
+void launch_index_add_kernel(Tensor & self, const Tensor & index, const Tensor & source) {
+  const int64_t numel = source.numel();
+  auto stream = at::cuda::getCurrentCUDAStream();
+  const bool use_half2 = std::is_same<scalar_t, at::Half>::value &&
+      source.size(2) % 2 == 0 && self.stride(2) == 1 && source.stride(2) == 1 &&
+      self.stride(0) % 2 == 0 && self.stride(1) % 2 == 0 &&
+      source.stride(0) % 2 == 0 && source.stride(1) % 2 == 0 &&
+      (size_t)self.data_ptr() % 4 == 0 && (size_t)source.data_ptr() % 4 == 0;
+  if (use_half2) {
+    index_add_half2_kernel<index_t>
+        <<<index_add_grid_size(numel / 2), kIndexAddBlockSize, 0, stream>>>(
+        (at::Half*)self.data_ptr(), (const at::Half*)source.data_ptr(), index.data<int64_t>(),
+        numel / 2, source.size(1), source.size(2) / 2, self.size(1),
+        self.stride(0), self.stride(1), source.stride(0), source.stride(1));
+  } else {
+    index_add_kernel_impl<scalar_t, index_t>
+        <<<index_add_grid_size(numel), kIndexAddBlockSize, 0, stream>>>(
+        self.data<scalar_t>(), source.data<scalar_t>(), index.data<int64_t>(),
+        numel, source.size(1), source.size(2), self.size(1),
+        self.stride(0), self.stride(1), self.stride(2),
+        source.stride(0), source.stride(1), source.stride(2));
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+// self and source are three-dim views and index is one-dim and contiguous, see
+// index_add_fn. The atomics add the rows to the same row of self in an
+// unspecified order; with deterministicScatter() set, floating point rows are
+// summed by a segment reduction instead.
+void index_add_kernel(Tensor & self, const Tensor & index, const Tensor & source) {
+  if (globalContext().deterministicScatter() && isFloatingType(self.scalar_type())) {
+    // The rows of the index dim, with the outer dim moved into them
+    const int64_t outer_size = source.size(0);
+    const int64_t inner_size = source.size(2);
+    auto rows = source.transpose(0, 1).reshape({index.numel(), outer_size * inner_size});
+    auto sums = deterministic_sum_rows(index, rows, self.size(1));
+    self.add_(sums.view({self.size(1), outer_size, inner_size}).transpose(0, 1));
+    return;
+  }
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Half, self.scalar_type(), "index_add_cuda", [&] {
+    if (cuda::detail::canUse32BitIndexMath(self) &&
+        cuda::detail::canUse32BitIndexMath(source)) {
+      launch_index_add_kernel<scalar_t, uint32_t>(self, index, source);
+    } else {
+      launch_index_add_kernel<scalar_t, uint64_t>(self, index, source);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(gather_stub, &gather_kernel);
+REGISTER_DISPATCH(scatter_stub, &scatter_kernel);
+REGISTER_DISPATCH(scatter_fill_stub, &scatter_fill_kernel);
+REGISTER_DISPATCH(scatter_add_stub, &scatter_add_kernel);
+REGISTER_DISPATCH(index_add_stub, &index_add_kernel);
+
+}} // namespace at::native
@@ -8,7 +8,11 @@
 #include <THC/THCThrustAllocator.cuh>
 
 #include <ATen/AccumulateType.h>
+#include <ATen/core/Reduction.h>
 #include <ATen/cuda/NumericLimits.cuh>
+#include <THC/THCDeviceUtils.cuh>
+#include <cstdint>
+#include <limits>
 #include <type_traits>
 
 namespace at {
@@ -470,9 +474,216 @@ cunn_SoftMaxBackward(scalar_t *gradInput, outscalar_t *output, outscalar_t *grad
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+// Online kernel (for long rows; requires inner_size == 1)
+////////////////////////////////////////////////////////////////////////////////
+// The regular kernel reads each row three times: for the max, for the sum of
+// exponentials, and for the output. Here each thread keeps a running max and
+// a sum of exponentials relative to it, so one read gives both, and rows are
+// read with 16 byte loads when their size allows it. A fixed number of blocks
+// (as many as fit on the device) loop over the rows.
+
+// Rows at least this long use the online kernel
+constexpr int64_t online_softmax_min_size = 4096;
+
+template <typename T, int N>
+struct alignas(sizeof(T) * N) aligned_vector {
+  T val[N];
+};
+
+template <typename AccumT>
+__device__ __forceinline__ void onlineMaxSum(AccumT& max_k, AccumT& sum, AccumT v) {
+  if (v > max_k) {
+    sum = sum * std::exp(max_k - v) + AccumT(1);
+    max_k = v;
+  } else {
+    sum += std::exp(v - max_k);
+  }
+}
+
+// Merges the running max and sum of another thread
+template <typename AccumT>
+__device__ __forceinline__ void combineMaxSum(
+    AccumT& max_k, AccumT& sum, AccumT other_max, AccumT other_sum) {
+  AccumT new_max = ::max(max_k, other_max);
+  sum = sum * std::exp(max_k - new_max) + other_sum * std::exp(other_max - new_max);
+  max_k = new_max;
+}
+
+template <typename AccumT>
+__device__ __forceinline__ void warpReduceMaxSum(AccumT& max_k, AccumT& sum) {
+#pragma unroll
+  for (int offset = 16; offset > 0; offset /= 2) {
+    combineMaxSum(max_k, sum, WARP_SHFL_DOWN(max_k, offset), WARP_SHFL_DOWN(sum, offset));
+  }
+}
+
+// smem must hold 64 values. Leaves the max and sum of the whole block in
+// max_k and sum of every thread.
+template <typename AccumT>
+__device__ __forceinline__ void blockReduceMaxSum(AccumT* smem, AccumT& max_k, AccumT& sum) {
+  warpReduceMaxSum(max_k, sum);
+  const int lane = threadIdx.x % 32;
+  const int warp = threadIdx.x / 32;
+  // smem may still be read for the previous row
+  __syncthreads();
+  if (lane == 0) {
+    smem[warp] = max_k;
+    smem[32 + warp] = sum;
+  }
+  __syncthreads();
+  if (warp == 0) {
+    max_k = lane < blockDim.x / 32 ? smem[lane] : -at::numeric_limits<AccumT>::max();
+    sum = lane < blockDim.x / 32 ? smem[32 + lane] : AccumT(0);
+    warpReduceMaxSum(max_k, sum);
+    if (lane == 0) {
+      smem[0] = max_k;
+      smem[32] = sum;
+    }
+  }
+  __syncthreads();
+  max_k = smem[0];
+  sum = smem[32];
+}
+
+// Running max and sum of exponentials of a row of classes elements, where
+// classes is a multiple of VEC and the row is aligned for VEC wide loads
+template <int VEC, typename scalar_t, typename accscalar_t>
+__device__ __forceinline__ void rowMaxSum(
+    accscalar_t* smem, const scalar_t* input, int classes,
+    accscalar_t& max_k, accscalar_t& sum) {
+  using LoadT = aligned_vector<scalar_t, VEC>;
+  const LoadT* vec_input = reinterpret_cast<const LoadT*>(input);
+  max_k = -at::numeric_limits<accscalar_t>::max();
+  sum = 0;
+  for (int i = threadIdx.x; i < classes / VEC; i += blockDim.x) {
+    LoadT v = vec_input[i];
+#pragma unroll
+    for (int j = 0; j < VEC; ++j) {
+      onlineMaxSum(max_k, sum, static_cast<accscalar_t>(v.val[j]));
+    }
+  }
+  blockReduceMaxSum(smem, max_k, sum);
+}
+
+template <int VEC, typename scalar_t, typename accscalar_t, typename outscalar_t, template <typename, typename, typename> class Epilogue>
+__global__ void
+cunn_SoftMaxForwardOnline(outscalar_t *output, const scalar_t *input, int64_t rows, int classes)
+{
+  using LoadT = aligned_vector<scalar_t, VEC>;
+  __shared__ accscalar_t smem[64];
+  for (int64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+    const scalar_t* row_input = input + row * classes;
+    outscalar_t* row_output = output + row * classes;
+    accscalar_t max_k, sum;
+    rowMaxSum<VEC>(smem, row_input, classes, max_k, sum);
+
+    Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(max_k, sum);
+    const LoadT* vec_input = reinterpret_cast<const LoadT*>(row_input);
+    for (int i = threadIdx.x; i < classes / VEC; i += blockDim.x) {
+      LoadT v = vec_input[i];
+#pragma unroll
+      for (int j = 0; j < VEC; ++j) {
+        row_output[i * VEC + j] = epilogue(v.val[j]);
+      }
+    }
+  }
+}
+
+// nll_loss(log_softmax(input, 1), target) for 2d inputs, without the
+// log_softmax output. The forward saves the log of the sum of exponentials
+// of each row, from which the backward computes softmax - one_hot(target).
+template <int VEC, typename scalar_t, typename accscalar_t>
+__global__ void
+cunn_LogSoftMaxNLLForward(
+    accscalar_t *row_loss, accscalar_t *row_weight, accscalar_t *logsumexp,
+    const scalar_t *input, const int64_t *target, const scalar_t *weight,
+    int64_t rows, int classes, int64_t ignore_index)
+{
+  __shared__ accscalar_t smem[64];
+  for (int64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+    const scalar_t* row_input = input + row * classes;
+    accscalar_t max_k, sum;
+    rowMaxSum<VEC>(smem, row_input, classes, max_k, sum);
+
+    if (threadIdx.x == 0) {
+      const accscalar_t lse = max_k + std::log(sum);
+      const int64_t t = target[row];
+      logsumexp[row] = lse;
+      if (t == ignore_index) {
+        row_loss[row] = 0;
+        row_weight[row] = 0;
+      } else {
+        assert(t >= 0 && t < classes);
+        const accscalar_t w = weight != nullptr ? static_cast<accscalar_t>(weight[t]) : accscalar_t(1);
+        row_loss[row] = (lse - static_cast<accscalar_t>(row_input[t])) * w;
+        row_weight[row] = w;
+      }
+    }
+  }
+}
+
+// row_grad is the gradient of the loss of each row
+template <int VEC, typename scalar_t, typename accscalar_t>
+__global__ void
+cunn_LogSoftMaxNLLBackward(
+    scalar_t *grad_input, const scalar_t *input, const int64_t *target,
+    const scalar_t *weight, const accscalar_t *logsumexp, const accscalar_t *row_grad,
+    int64_t rows, int classes, int64_t ignore_index)
+{
+  using LoadT = aligned_vector<scalar_t, VEC>;
+  for (int64_t row = blockIdx.x; row < rows; row += gridDim.x) {
+    const int64_t t = target[row];
+    accscalar_t scale = 0;
+    if (t != ignore_index) {
+      scale = row_grad[row] * (weight != nullptr ? static_cast<accscalar_t>(weight[t]) : accscalar_t(1));
+    }
+    const accscalar_t lse = logsumexp[row];
+    const LoadT* vec_input = reinterpret_cast<const LoadT*>(input + row * classes);
+    LoadT* vec_grad = reinterpret_cast<LoadT*>(grad_input + row * classes);
+    for (int i = threadIdx.x; i < classes / VEC; i += blockDim.x) {
+      LoadT v = vec_input[i];
+      LoadT g;
+#pragma unroll
+      for (int j = 0; j < VEC; ++j) {
+        const accscalar_t p = std::exp(static_cast<accscalar_t>(v.val[j]) - lse);
+        const accscalar_t target_p = i * VEC + j == t ? accscalar_t(1) : accscalar_t(0);
+        g.val[j] = static_cast<scalar_t>((p - target_p) * scale);
+      }
+      vec_grad[i] = g;
+    }
+  }
+}
 
+// Width of the loads of the online kernels: 16 bytes when every row is
+// aligned for them, otherwise one element at a time
+template <typename scalar_t>
+int onlineSoftMaxVecSize(const void* data, int64_t classes) {
+  constexpr int vec = 16 / sizeof(scalar_t);
+  if (reinterpret_cast<uintptr_t>(data) % 16 == 0 && classes % vec == 0) {
+    return vec;
+  }
+  return 1;
+}
 
+// Enough blocks of block threads to fill the device, and no more than rows
+inline dim3 onlineSoftMaxGridSize(dim3 block, int64_t rows) {
+  auto* props = at::cuda::getCurrentDeviceProperties();
+  int64_t max_blocks =
+      props->multiProcessorCount * (props->maxThreadsPerMultiProcessor / block.x);
+  return dim3(std::max<int64_t>(std::min(rows, max_blocks), 1));
+}
 
+#define ONLINE_SOFTMAX_VEC_DISPATCH(VEC_SIZE, VEC_MAX, ...)  \
+  [&] {                                                      \
+    if (VEC_SIZE == VEC_MAX) {                               \
+      constexpr int VEC = VEC_MAX;                           \
+      __VA_ARGS__();                                         \
+    } else {                                                 \
+      constexpr int VEC = 1;                                 \
+      __VA_ARGS__();                                         \
+    }                                                        \
+  }()
 
 template<template<typename, typename, typename> class Epilogue>
 Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_to_float){
@@ -493,9 +704,29 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
       outer_size *= input.size(i);
     for (int64_t i = dim + 1; i < input.dim(); ++i)
       inner_size *= input.size(i);
+    if (inner_size == 1 && dim_size >= online_softmax_min_size &&
+        dim_size <= std::numeric_limits<int>::max()) {
+      AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "host_softmax", [&] {
+      using accscalar_t = acc_type<scalar_t, true>;
+      constexpr int vec_max = 16 / sizeof(scalar_t);
+      const int vec_size = onlineSoftMaxVecSize<scalar_t>(input.data_ptr(), dim_size);
+      ONLINE_SOFTMAX_VEC_DISPATCH(vec_size, vec_max, [&] {
+        dim3 block = SoftMax_getBlockSize(VEC, dim_size);
+        dim3 grid = onlineSoftMaxGridSize(block, outer_size);
+        if (!half_to_float) {
+          cunn_SoftMaxForwardOnline<VEC, scalar_t, accscalar_t, scalar_t, Epilogue>
+            <<<grid, block, 0, stream>>>(
+              output.data<scalar_t>(), input.data<scalar_t>(), outer_size, dim_size);
+        } else {
+          cunn_SoftMaxForwardOnline<VEC, scalar_t, accscalar_t, accscalar_t, Epilogue>
+            <<<grid, block, 0, stream>>>(
+              output.data<accscalar_t>(), input.data<scalar_t>(), outer_size, dim_size);
+        }
+      });
+      });
     // This kernel spawns a block per each element in the batch.
     // XXX: it assumes that inner_size == 1
-    if (inner_size == 1) {
+    } else if (inner_size == 1) {
       const int ILP = 2;
       dim3 grid(outer_size);
       dim3 block = SoftMax_getBlockSize(ILP, dim_size);
@@ -634,6 +865,104 @@ Tensor log_softmax_backward_cuda(const Tensor &grad, const Tensor &output, int64
   return host_softmax_backward<LogSoftMaxBackwardEpilogue>(grad, output, dim, half_to_float);
 }
 
+std::tuple<Tensor, Tensor, Tensor> log_softmax_nll_loss_cuda(
+    const Tensor& self, const Tensor& target, const Tensor& weight,
+    int64_t reduction, int64_t ignore_index) {
+  AT_CHECK(self.dim() == 2, "expected a 2D input, but got ", self.dim(), "D");
+  AT_CHECK(target.dim() == 1 && target.size(0) == self.size(0),
+      "expected a 1D target of size ", self.size(0), ", but got target of size ",
+      target.sizes());
+  AT_CHECK(target.scalar_type() == ScalarType::Long, "expected a Long target");
+  AT_CHECK(self.size(1) > 0 && self.size(1) <= std::numeric_limits<int>::max(),
+      "invalid number of classes ", self.size(1));
+  AT_CHECK(!weight.defined() ||
+      (weight.numel() == self.size(1) && weight.scalar_type() == self.scalar_type()),
+      "expected a weight of ", self.size(1), " elements of the type of the input");
+  auto input = self.contiguous();
+  auto target_ = target.contiguous();
+  auto weight_ = weight.defined() ? weight.contiguous() : weight;
+  const int64_t rows = input.size(0);
+  const int classes = input.size(1);
+
+  auto acc_options = input.options().dtype(
+      input.scalar_type() == ScalarType::Half ? ScalarType::Float : input.scalar_type());
+  auto row_loss = at::empty({rows}, acc_options);
+  auto row_weight = at::empty({rows}, acc_options);
+  auto logsumexp = at::empty({rows}, acc_options);
+  if (rows > 0) {
+    cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "log_softmax_nll_loss", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    constexpr int vec_max = 16 / sizeof(scalar_t);
+    const int vec_size = onlineSoftMaxVecSize<scalar_t>(input.data_ptr(), classes);
+    ONLINE_SOFTMAX_VEC_DISPATCH(vec_size, vec_max, [&] {
+      dim3 block = SoftMax_getBlockSize(VEC, classes);
+      dim3 grid = onlineSoftMaxGridSize(block, rows);
+      cunn_LogSoftMaxNLLForward<VEC, scalar_t, accscalar_t>
+        <<<grid, block, 0, stream>>>(
+          row_loss.data<accscalar_t>(), row_weight.data<accscalar_t>(),
+          logsumexp.data<accscalar_t>(), input.data<scalar_t>(),
+          target_.data<int64_t>(),
+          weight_.defined() ? weight_.data<scalar_t>() : nullptr,
+          rows, classes, ignore_index);
+    });
+    });
+    THCudaCheck(cudaGetLastError());
+  }
+
+  auto total_weight = row_weight.sum();
+  Tensor loss;
+  if (reduction == Reduction::None) {
+    loss = row_loss.to(input.scalar_type());
+  } else if (reduction == Reduction::Sum) {
+    loss = row_loss.sum().to(input.scalar_type());
+  } else {
+    loss = (row_loss.sum() / total_weight).to(input.scalar_type());
+  }
+  return std::make_tuple(loss, logsumexp, total_weight);
+}
+
+Tensor log_softmax_nll_loss_backward_cuda(
+    const Tensor& grad_output, const Tensor& self, const Tensor& target,
+    const Tensor& weight, int64_t reduction, int64_t ignore_index,
+    const Tensor& logsumexp, const Tensor& total_weight) {
+  auto input = self.contiguous();
+  auto target_ = target.contiguous();
+  auto weight_ = weight.defined() ? weight.contiguous() : weight;
+  const int64_t rows = input.size(0);
+  const int classes = input.size(1);
+  Tensor grad_input = at::empty_like(input);
+  if (rows == 0) {
+    return grad_input;
+  }
+
+  auto row_grad = grad_output.to(logsumexp.scalar_type());
+  if (reduction == Reduction::Mean) {
+    row_grad = row_grad / total_weight;
+  }
+  row_grad = row_grad.expand({rows}).contiguous();
+
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "log_softmax_nll_loss_backward", [&] {
+  using accscalar_t = acc_type<scalar_t, true>;
+  constexpr int vec_max = 16 / sizeof(scalar_t);
+  const int vec_size = onlineSoftMaxVecSize<scalar_t>(input.data_ptr(), classes);
+  ONLINE_SOFTMAX_VEC_DISPATCH(vec_size, vec_max, [&] {
+    dim3 block = SoftMax_getBlockSize(VEC, classes);
+    dim3 grid = onlineSoftMaxGridSize(block, rows);
+    cunn_LogSoftMaxNLLBackward<VEC, scalar_t, accscalar_t>
+      <<<grid, block, 0, stream>>>(
+        grad_input.data<scalar_t>(), input.data<scalar_t>(),
+        target_.data<int64_t>(),
+        weight_.defined() ? weight_.data<scalar_t>() : nullptr,
+        logsumexp.data<accscalar_t>(), row_grad.data<accscalar_t>(),
+        rows, classes, ignore_index);
+  });
+  });
+  THCudaCheck(cudaGetLastError());
+  return grad_input;
+}
+
 Tensor softmax_cuda(const Tensor &input, const int64_t dim, const bool half_to_float){
   return host_softmax<SoftMaxForwardEpilogue>(input, dim, half_to_float);
 }
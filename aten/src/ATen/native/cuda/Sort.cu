@@ -0,0 +1,269 @@
+#include <ATen/ATen.h>
+#include <ATen/LegacyTHFunctions.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/Exceptions.h>
+#include <ATen/native/cuda/SortingCommon.cuh>
+
+#include <cub/block/block_load.cuh>
+#include <cub/block/block_radix_sort.cuh>
+#include <cub/device/device_segmented_radix_sort.cuh>
+
+#include <cstring>
+#include <limits>
+
+// Sorting of the slices of a tensor along one dimension.
+//
+// - Slices of up to 2048 elements (1024 for 8 byte types) are sorted in place
+//   by the bitonic sort of THC, with one block per slice.
+// - Slices of up to kMaxBlockSortSize elements are loaded by one block each,
+//   and sorted in shared memory and registers with cub::BlockRadixSort.
+// - Longer slices are sorted by cub::DeviceSegmentedRadixSort, one segment
+//   per slice.
+// - Half tensors and tensors of more than INT_MAX elements keep using THC,
+//   which falls back to a global Thrust sort for long slices.
+//
+// The two radix sorts work on contiguous slices: the sorted dimension is
+// moved innermost first, which copies the input if it isn't already laid out
+// that way.
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kBlockSortThreads = 256;
+constexpr int64_t kMaxBlockSortSize = kBlockSortThreads * 16;
+
+// Largest slice THC sorts with its bitonic sort
+int64_t maxBitonicSortSize(const Tensor& self) {
+  return self.element_size() == 8 ? 1024 : 2048;
+}
+
+// A key that the radix sort orders after every other key (before every other
+// one when descending), used to pad slices to the size of the block sort.
+// Padding comes after the slice in the input, and the sort is stable, so it
+// also stays behind real keys with the same bits.
+template <typename scalar_t>
+__device__ __forceinline__ scalar_t radixSortPadding(bool descending) {
+  using Traits = cub::Traits<scalar_t>;
+  typename Traits::UnsignedBits bits =
+      descending ? Traits::LOWEST_KEY : Traits::MAX_KEY;
+  scalar_t key;
+  memcpy(&key, &bits, sizeof(scalar_t));
+  return key;
+}
+
+// One block per slice of keys, for slices of at most
+// kBlockSortThreads * ITEMS_PER_THREAD elements
+template <typename scalar_t, int ITEMS_PER_THREAD>
+C10_LAUNCH_BOUNDS_1(kBlockSortThreads)
+__global__ void blockRadixSortSlices(
+    const scalar_t* keys_in,
+    scalar_t* keys_out,
+    int64_t* indices_out,
+    int64_t numSlices,
+    int sliceSize,
+    bool descending) {
+  using BlockLoad = cub::BlockLoad<
+      scalar_t,
+      kBlockSortThreads,
+      ITEMS_PER_THREAD,
+      cub::BLOCK_LOAD_TRANSPOSE>;
+  using BlockRadixSort =
+      cub::BlockRadixSort<scalar_t, kBlockSortThreads, ITEMS_PER_THREAD, int>;
+  __shared__ union {
+    typename BlockLoad::TempStorage load;
+    typename BlockRadixSort::TempStorage sort;
+  } temp_storage;
+
+  const scalar_t padding = radixSortPadding<scalar_t>(descending);
+  for (int64_t slice = blockIdx.x; slice < numSlices; slice += gridDim.x) {
+    const int64_t offset = slice * sliceSize;
+    scalar_t keys[ITEMS_PER_THREAD];
+    int values[ITEMS_PER_THREAD];
+    // Blocked arrangement, so that the position of an item in the block is
+    // its index in the slice
+    BlockLoad(temp_storage.load).Load(keys_in + offset, keys, sliceSize, padding);
+#pragma unroll
+    for (int i = 0; i < ITEMS_PER_THREAD; ++i) {
+      values[i] = threadIdx.x * ITEMS_PER_THREAD + i;
+    }
+    __syncthreads();
+
+    if (descending) {
+      BlockRadixSort(temp_storage.sort).SortDescendingBlockedToStriped(keys, values);
+    } else {
+      BlockRadixSort(temp_storage.sort).SortBlockedToStriped(keys, values);
+    }
+#pragma unroll
+    for (int i = 0; i < ITEMS_PER_THREAD; ++i) {
+      const int rank = i * kBlockSortThreads + threadIdx.x;
+      if (rank < sliceSize) {
+        keys_out[offset + rank] = keys[i];
+        indices_out[offset + rank] = values[i];
+      }
+    }
+    __syncthreads();
+  }
+}
+
+template <typename scalar_t, int ITEMS_PER_THREAD>
+void launchBlockRadixSort(
+    const scalar_t* keys_in,
+    scalar_t* keys_out,
+    int64_t* indices_out,
+    int64_t numSlices,
+    int64_t sliceSize,
+    bool descending) {
+  // Blocks loop over the slices beyond the grid size
+  dim3 grid(std::min(numSlices, MAX_GRID_SIZE));
+  blockRadixSortSlices<scalar_t, ITEMS_PER_THREAD>
+      <<<grid, kBlockSortThreads, 0, at::cuda::getCurrentCUDAStream()>>>(
+          keys_in, keys_out, indices_out, numSlices, sliceSize, descending);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+template <typename scalar_t>
+void segmentedRadixSort(
+    const scalar_t* keys_in,
+    scalar_t* keys_out,
+    int64_t* indices_out,
+    int64_t numSlices,
+    int64_t sliceSize,
+    bool descending,
+    const TensorOptions& options) {
+  const int numItems = numSlices * sliceSize;
+  // Index of each element within its slice, and where each slice begins
+  auto indices_in =
+      at::arange(sliceSize, options.dtype(kLong)).repeat({numSlices});
+  auto offsets = at::arange(0, numItems + 1, sliceSize, options.dtype(kInt));
+  const int* begin_offsets = offsets.data<int>();
+  const int* end_offsets = begin_offsets + 1;
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  auto sort = [&](void* temp, size_t& temp_bytes) {
+    if (descending) {
+      return cub::DeviceSegmentedRadixSort::SortPairsDescending(
+          temp, temp_bytes, keys_in, keys_out,
+          indices_in.data<int64_t>(), indices_out,
+          numItems, numSlices, begin_offsets, end_offsets,
+          0, sizeof(scalar_t) * 8, stream);
+    }
+    return cub::DeviceSegmentedRadixSort::SortPairs(
+        temp, temp_bytes, keys_in, keys_out,
+        indices_in.data<int64_t>(), indices_out,
+        numItems, numSlices, begin_offsets, end_offsets,
+        0, sizeof(scalar_t) * 8, stream);
+  };
+  size_t temp_bytes = 0;
+  AT_CUDA_CHECK(sort(nullptr, temp_bytes));
+  auto temp = at::empty({static_cast<int64_t>(temp_bytes)}, options.dtype(kByte));
+  AT_CUDA_CHECK(sort(temp.data_ptr(), temp_bytes));
+}
+
+template <typename scalar_t>
+void radixSortSlices(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  const int64_t last = self.dim() - 1;
+  const int64_t sliceSize = self.size(dim);
+  const int64_t numSlices = self.numel() / sliceSize;
+
+  auto input = self.transpose(dim, last).contiguous();
+  // Sort straight into the outputs when they have the layout of input
+  const bool direct = dim == last && values.is_contiguous() &&
+      indices.is_contiguous() && !values.is_same(self);
+  Tensor keys_out = direct ? values : at::empty_like(input);
+  Tensor indices_out = direct ? indices : at::empty(input.sizes(), indices.options());
+
+  const scalar_t* keys_in_ptr = input.data<scalar_t>();
+  scalar_t* keys_out_ptr = keys_out.data<scalar_t>();
+  int64_t* indices_out_ptr = indices_out.data<int64_t>();
+  if (sliceSize <= kBlockSortThreads * 8) {
+    launchBlockRadixSort<scalar_t, 8>(
+        keys_in_ptr, keys_out_ptr, indices_out_ptr,
+        numSlices, sliceSize, descending);
+  } else if (sliceSize <= kMaxBlockSortSize) {
+    launchBlockRadixSort<scalar_t, 16>(
+        keys_in_ptr, keys_out_ptr, indices_out_ptr,
+        numSlices, sliceSize, descending);
+  } else {
+    segmentedRadixSort<scalar_t>(
+        keys_in_ptr, keys_out_ptr, indices_out_ptr,
+        numSlices, sliceSize, descending, input.options());
+  }
+
+  if (!direct) {
+    values.transpose(dim, last).copy_(keys_out);
+    indices.transpose(dim, last).copy_(indices_out);
+  }
+}
+
+} // namespace
+
+std::tuple<Tensor&, Tensor&> sort_out_cuda(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  if (self.dim() == 0 || self.numel() == 0 ||
+      self.size(dim) <= maxBitonicSortSize(self) ||
+      self.scalar_type() == at::ScalarType::Half ||
+      self.numel() > std::numeric_limits<int>::max()) {
+    return at::legacy::th::_th_sort_out(values, indices, self, dim, descending);
+  }
+  AT_CHECK(
+      self.dim() <= MAX_TENSORINFO_DIMS,
+      "cannot operate on more than ",
+      MAX_TENSORINFO_DIMS,
+      " dimensions");
+  AT_CHECK(
+      values.type() == self.type(),
+      "output values must be of same type as input");
+  AT_CHECK(
+      indices.dtype() == kLong, "output indices must be of scalar type Long");
+  values.resize_(self.sizes());
+  indices.resize_(self.sizes());
+
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "sort_cuda", [&] {
+    radixSortSlices<scalar_t>(values, indices, self, dim, descending);
+  });
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor&, Tensor&> topk_out_cuda(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim_,
+    bool largest,
+    bool sorted) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  // THC sorts the selected values with its own sort, which is only fast
+  // for short slices
+  if (!sorted || self.dim() == 0 || k <= maxBitonicSortSize(self) ||
+      self.scalar_type() == at::ScalarType::Half) {
+    return at::legacy::th::_th_topk_out(
+        values, indices, self, k, dim, largest, sorted);
+  }
+  Tensor selected = at::empty({0}, self.options());
+  Tensor selected_indices = at::empty({0}, indices.options());
+  at::legacy::th::_th_topk_out(
+      selected, selected_indices, self, k, dim, largest, /*sorted=*/false);
+
+  Tensor order = at::empty({0}, indices.options());
+  at::native::sort_out_cuda(values, order, selected, dim, /*descending=*/largest);
+  indices.resize_(order.sizes());
+  at::gather_out(indices, selected_indices, dim, order);
+  return std::forward_as_tuple(values, indices);
+}
+
+} // namespace native
+} // namespace at
@@ -4,6 +4,7 @@
 #include <c10/macros/Macros.h>
 #include <stdlib.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/detail/TensorInfo.cuh>
 #include <THC/THCDeviceUtils.cuh> // only for THCRoundUp?
 #include <THC/THCNumerics.cuh>
@@ -96,6 +97,217 @@ __global__ void gatherKthValue(
   }
 }
 
+// Slices of up to kWarpSelectMaxSliceSize elements are selected by a warp
+// each, so that many small slices don't each take a block and its
+// synchronizations.
+constexpr int64_t kWarpSelectMaxSliceSize = 256;
+constexpr int kWarpSelectWarpsPerBlock = 4;
+
+template <typename scalar_t, typename index_t, int Dim>
+__global__ void gatherKthValueWarp(
+    cuda::detail::TensorInfo<scalar_t, index_t> input,
+    index_t inputSliceSize,
+    index_t k,
+
+    index_t numInputSlices,
+    index_t inputWithinSliceStride,
+
+    cuda::detail::TensorInfo<scalar_t, index_t> kthValue,
+    cuda::detail::TensorInfo<int64_t, index_t> indices) {
+  // The block size is a multiple of the warp size, so whole warps return
+  index_t slice = getLinearBlockId<index_t>() * kWarpSelectWarpsPerBlock +
+      threadIdx.x / WARP_SIZE;
+  if (slice >= numInputSlices) {
+    return;
+  }
+
+  scalar_t* inputSliceStart = &input.data[
+      cuda::detail::IndexToOffset<scalar_t, index_t, Dim>::get(slice, input)];
+  index_t kValueIndex = warpRadixSelect<
+      scalar_t,
+      typename TopKTypeConfig<scalar_t>::RadixType,
+      index_t>(inputSliceStart, k, inputSliceSize, inputWithinSliceStride);
+
+  if (getLaneId() == 0) {
+    kthValue.data[cuda::detail::IndexToOffset<scalar_t, index_t, Dim>::get(
+        slice, kthValue)] = inputSliceStart[kValueIndex * inputWithinSliceStride];
+    indices.data[cuda::detail::IndexToOffset<int64_t, index_t, Dim>::get(
+        slice, indices)] = kValueIndex;
+  }
+}
+
+// A few huge slices are selected by several blocks each, in a pass per digit
+// of a wider radix: the blocks of a slice count the digits of their part of
+// it into counts, then a thread per slice picks the digit of the k-th element
+// as in radixSelect, until its pattern is unique or complete. The blocks then
+// look for the first element matching the pattern.
+constexpr int kMultiBlockRadixBits = 8;
+constexpr int kMultiBlockRadixSize = 1 << kMultiBlockRadixBits;
+constexpr int kMultiBlockRadixMask = kMultiBlockRadixSize - 1;
+constexpr int kMultiBlockSize = 512;
+// The minimum number of elements per block
+constexpr int64_t kMultiBlockSliceChunk = kMultiBlockSize * 16;
+
+template <typename bitwise_t>
+struct MultiBlockSelectState {
+  bitwise_t desired;
+  bitwise_t desiredMask;
+  int64_t kToFind;
+  // The first position of the element matching the pattern, once known
+  unsigned long long index;
+  bool unique;
+};
+
+template <typename bitwise_t>
+__global__ void multiBlockSelectInit(
+    MultiBlockSelectState<bitwise_t>* state,
+    int64_t numSlices,
+    int64_t k) {
+  const int64_t slice = blockIdx.x * blockDim.x + threadIdx.x;
+  if (slice < numSlices) {
+    state[slice].desired = 0;
+    state[slice].desiredMask = 0;
+    state[slice].kToFind = k;
+    state[slice].index = ~0ull;
+    state[slice].unique = false;
+  }
+}
+
+template <typename scalar_t, typename bitwise_t, typename index_t, int Dim>
+__global__ void multiBlockCountRadix(
+    cuda::detail::TensorInfo<scalar_t, index_t> input,
+    index_t inputSliceSize,
+    index_t inputWithinSliceStride,
+    index_t blocksPerSlice,
+    const MultiBlockSelectState<bitwise_t>* state,
+    unsigned long long* counts,
+    int digitPos) {
+  __shared__ unsigned long long smem[kMultiBlockRadixSize];
+
+  const index_t slice = blockIdx.x / blocksPerSlice;
+  const index_t part = blockIdx.x % blocksPerSlice;
+  const auto s = state[slice];
+  if (s.unique) {
+    return;
+  }
+
+  for (int i = threadIdx.x; i < kMultiBlockRadixSize; i += blockDim.x) {
+    smem[i] = 0;
+  }
+  __syncthreads();
+
+  const scalar_t* data = &input.data[
+      cuda::detail::IndexToOffset<scalar_t, index_t, Dim>::get(slice, input)];
+  for (index_t i = part * blockDim.x + threadIdx.x; i < inputSliceSize;
+       i += blocksPerSlice * blockDim.x) {
+    const bitwise_t val =
+        TopKTypeConfig<scalar_t>::convert(doLdg(&data[i * inputWithinSliceStride]));
+    if ((val & s.desiredMask) == s.desired) {
+      atomicAdd(
+          &smem[Bitfield<bitwise_t>::getBitfield(val, digitPos, kMultiBlockRadixBits)],
+          1ull);
+    }
+  }
+  __syncthreads();
+
+  for (int i = threadIdx.x; i < kMultiBlockRadixSize; i += blockDim.x) {
+    if (smem[i] > 0) {
+      atomicAdd(&counts[slice * kMultiBlockRadixSize + i], smem[i]);
+    }
+  }
+}
+
+// Picks the digit of the k-th element from the counts, and zeroes them for
+// the next pass.
+template <typename bitwise_t>
+__global__ void multiBlockSelectDigit(
+    MultiBlockSelectState<bitwise_t>* state,
+    unsigned long long* counts,
+    int64_t numSlices,
+    int digitPos) {
+  const int64_t slice = blockIdx.x * blockDim.x + threadIdx.x;
+  if (slice >= numSlices) {
+    return;
+  }
+  auto& s = state[slice];
+  unsigned long long* sliceCounts = counts + slice * kMultiBlockRadixSize;
+  bool found = s.unique;
+  for (int i = 0; i < kMultiBlockRadixSize; ++i) {
+    const unsigned long long count = sliceCounts[i];
+    sliceCounts[i] = 0;
+    if (found) {
+      continue;
+    }
+    if (count >= static_cast<unsigned long long>(s.kToFind)) {
+      s.desired = Bitfield<bitwise_t>::setBitfield(
+          s.desired, i, digitPos, kMultiBlockRadixBits);
+      s.desiredMask = Bitfield<bitwise_t>::setBitfield(
+          s.desiredMask, kMultiBlockRadixMask, digitPos, kMultiBlockRadixBits);
+      s.unique = count == 1;
+      found = true;
+    } else {
+      s.kToFind -= count;
+    }
+  }
+}
+
+template <typename scalar_t, typename bitwise_t, typename index_t, int Dim>
+__global__ void multiBlockFindPattern(
+    cuda::detail::TensorInfo<scalar_t, index_t> input,
+    index_t inputSliceSize,
+    index_t inputWithinSliceStride,
+    index_t blocksPerSlice,
+    MultiBlockSelectState<bitwise_t>* state) {
+  const index_t slice = blockIdx.x / blocksPerSlice;
+  const index_t part = blockIdx.x % blocksPerSlice;
+  const bitwise_t desired = state[slice].desired;
+  const bitwise_t desiredMask = state[slice].desiredMask;
+
+  const scalar_t* data = &input.data[
+      cuda::detail::IndexToOffset<scalar_t, index_t, Dim>::get(slice, input)];
+  // The first match of each thread is the first one of its elements
+  for (index_t i = part * blockDim.x + threadIdx.x; i < inputSliceSize;
+       i += blocksPerSlice * blockDim.x) {
+    const bitwise_t val =
+        TopKTypeConfig<scalar_t>::convert(doLdg(&data[i * inputWithinSliceStride]));
+    if ((val & desiredMask) == desired) {
+      atomicMin(&state[slice].index, static_cast<unsigned long long>(i));
+      break;
+    }
+  }
+}
+
+template <typename scalar_t, typename bitwise_t, typename index_t, int Dim>
+__global__ void multiBlockGatherKthValue(
+    cuda::detail::TensorInfo<scalar_t, index_t> input,
+    index_t inputWithinSliceStride,
+    index_t numInputSlices,
+    const MultiBlockSelectState<bitwise_t>* state,
+    cuda::detail::TensorInfo<scalar_t, index_t> kthValue,
+    cuda::detail::TensorInfo<int64_t, index_t> indices) {
+  const index_t slice = blockIdx.x * blockDim.x + threadIdx.x;
+  if (slice >= numInputSlices) {
+    return;
+  }
+  const index_t kValueIndex = static_cast<index_t>(state[slice].index);
+  kthValue.data[cuda::detail::IndexToOffset<scalar_t, index_t, Dim>::get(
+      slice, kthValue)] = input.data[
+      cuda::detail::IndexToOffset<scalar_t, index_t, Dim>::get(slice, input) +
+      kValueIndex * inputWithinSliceStride];
+  indices.data[cuda::detail::IndexToOffset<int64_t, index_t, Dim>::get(
+      slice, indices)] = kValueIndex;
+}
+
+// The number of blocks per slice that keeps the device busy with a few huge
+// slices; 1 unless each block would still get kMultiBlockSliceChunk elements.
+static int64_t multiBlockSelectBlocksPerSlice(int64_t num_slices, int64_t slice_size) {
+  const int64_t target_blocks =
+      at::cuda::getCurrentDeviceProperties()->multiProcessorCount * 4;
+  return std::max<int64_t>(1, std::min(
+      cuda::ATenCeilDiv(slice_size, kMultiBlockSliceChunk),
+      target_blocks / num_slices));
+}
+
 struct KthValueLauncher {
   int64_t k;
 
@@ -111,6 +323,43 @@ struct KthValueLauncher {
       int collapse_self_dim,
       int64_t num_slices,
       int64_t slice_size) {
+    auto stream = at::cuda::getCurrentCUDAStream();
+    /* The actual dimension that the k-selection is running in */
+    /* may have changed from collapseDims() */
+    const index_t within_slice_stride = self_info.strides[collapse_self_dim];
+
+    if (slice_size <= kWarpSelectMaxSliceSize) {
+      dim3 grid;
+      if (!getGridFromTiles(
+              cuda::ATenCeilDiv(num_slices, (int64_t)kWarpSelectWarpsPerBlock), grid)) {
+        AT_ERROR("slices are too many");
+      }
+      gatherKthValueWarp<scalar_t, index_t, all_dims>
+          <<<grid, kWarpSelectWarpsPerBlock * WARP_SIZE, 0, stream>>>(
+          self_info,
+          slice_size,
+          k,
+          num_slices,
+          within_slice_stride,
+          values_info,
+          indices_info);
+      return;
+    }
+
+    const int64_t blocks_per_slice =
+        multiBlockSelectBlocksPerSlice(num_slices, slice_size);
+    if (blocks_per_slice > 1) {
+      launch_multi_block<scalar_t, index_t, all_dims>(
+          values_info,
+          indices_info,
+          self_info,
+          within_slice_stride,
+          num_slices,
+          slice_size,
+          blocks_per_slice);
+      return;
+    }
+
     dim3 grid;
     if (!getGridFromTiles(num_slices, grid)) {
       AT_ERROR("slices are too many");
@@ -118,18 +367,63 @@ struct KthValueLauncher {
 
     dim3 block(
         std::min(THCRoundUp(slice_size, (int64_t)WARP_SIZE), (int64_t)1024));
-    auto stream = at::cuda::getCurrentCUDAStream();
     gatherKthValue<scalar_t, index_t, all_dims><<<grid, block, 0, stream>>>(
         self_info,
         slice_size,
         k,
         num_slices,
-        /* The actual dimension that the k-selection is running in */
-        /* may have changed from collapseDims() */
-        self_info.strides[collapse_self_dim],
+        within_slice_stride,
         values_info,
         indices_info);
   }
+
+  template <typename scalar_t, typename index_t, int all_dims>
+  void launch_multi_block(
+      cuda::detail::TensorInfo<scalar_t, index_t> values_info,
+      cuda::detail::TensorInfo<int64_t, index_t> indices_info,
+      cuda::detail::TensorInfo<scalar_t, index_t> self_info,
+      index_t within_slice_stride,
+      int64_t num_slices,
+      int64_t slice_size,
+      int64_t blocks_per_slice) {
+    using bitwise_t = typename TopKTypeConfig<scalar_t>::RadixType;
+    using State = MultiBlockSelectState<bitwise_t>;
+    auto stream = at::cuda::getCurrentCUDAStream();
+    const auto options = at::device(kCUDA);
+    auto state_buffer = at::empty(
+        {num_slices * (int64_t)sizeof(State)}, options.dtype(kByte));
+    auto counts_buffer =
+        at::zeros({num_slices, kMultiBlockRadixSize}, options.dtype(kLong));
+    auto state = reinterpret_cast<State*>(state_buffer.data_ptr());
+    auto counts = reinterpret_cast<unsigned long long*>(counts_buffer.data_ptr());
+
+    const int slice_threads = 256;
+    const int64_t slice_blocks = cuda::ATenCeilDiv(num_slices, (int64_t)slice_threads);
+    const int64_t blocks = num_slices * blocks_per_slice;
+    multiBlockSelectInit<bitwise_t><<<slice_blocks, slice_threads, 0, stream>>>(
+        state, num_slices, k);
+    for (int digit_pos = sizeof(scalar_t) * 8 - kMultiBlockRadixBits;
+         digit_pos >= 0;
+         digit_pos -= kMultiBlockRadixBits) {
+      multiBlockCountRadix<scalar_t, bitwise_t, index_t, all_dims>
+          <<<blocks, kMultiBlockSize, 0, stream>>>(
+          self_info,
+          slice_size,
+          within_slice_stride,
+          blocks_per_slice,
+          state,
+          counts,
+          digit_pos);
+      multiBlockSelectDigit<bitwise_t><<<slice_blocks, slice_threads, 0, stream>>>(
+          state, counts, num_slices, digit_pos);
+    }
+    multiBlockFindPattern<scalar_t, bitwise_t, index_t, all_dims>
+        <<<blocks, kMultiBlockSize, 0, stream>>>(
+        self_info, slice_size, within_slice_stride, blocks_per_slice, state);
+    multiBlockGatherKthValue<scalar_t, bitwise_t, index_t, all_dims>
+        <<<slice_blocks, slice_threads, 0, stream>>>(
+        self_info, within_slice_stride, num_slices, state, values_info, indices_info);
+  }
 };
 
 template <typename scalar_t>
@@ -192,7 +486,8 @@ Tensor median_cuda_template(const Tensor& self) {
   if (self.dim() == 0 && self.numel() == 1) {
     return self.clone();
   }
-  auto self_copy = self.clone().view(-1);
+  // The selection doesn't modify its input
+  auto self_flat = self.reshape(-1);
   auto values = at::empty({1}, self.options());
   auto indices = at::empty({1}, self.options().dtype(kLong));
   AT_CHECK(
@@ -209,16 +504,16 @@ Tensor median_cuda_template(const Tensor& self) {
     run_launcher<scalar_t, uint32_t>(
         values,
         indices,
-        self_copy,
+        self_flat,
         0,
-        KthValueLauncher((self_copy.size(0) + 1) / 2)); // KthValue is 1-based
+        KthValueLauncher((self_flat.size(0) + 1) / 2)); // KthValue is 1-based
   } else {
     run_launcher<scalar_t, uint64_t>(
         values,
         indices,
-        self_copy,
+        self_flat,
         0,
-        KthValueLauncher((self_copy.size(0) + 1) / 2)); // KthValue is 1-based
+        KthValueLauncher((self_flat.size(0) + 1) / 2)); // KthValue is 1-based
   }
   return values.view({});
 }
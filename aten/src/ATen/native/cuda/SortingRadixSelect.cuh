@@ -392,5 +392,83 @@ __device__ void radixSelect(
   // matching `desired` exactly
   *topK = TopKTypeConfig<scalar_t>::deconvert(desired);
 }
+
+// Returns, to all the lanes of a warp, the position in the slice of the
+// k-th smallest element (the first one if there are several), by the same
+// radix selection as radixSelect without shared memory or block
+// synchronization: the counts of each digit are reduced by warp votes. Each
+// warp can thus select in its own small slice; all the lanes of the warp
+// must call it.
+template <typename scalar_t, typename bitwise_t, typename index_t>
+__device__ index_t warpRadixSelect(
+    scalar_t* data,
+    index_t k,
+    index_t sliceSize,
+    index_t withinSliceStride) {
+  bitwise_t desired = 0;
+  bitwise_t desiredMask = 0;
+  index_t kToFind = k;
+  const int laneId = getLaneId();
+
+  bool unique = false;
+  for (int digitPos = sizeof(scalar_t) * 8 - RADIX_BITS;
+       digitPos >= 0 && !unique;
+       digitPos -= RADIX_BITS) {
+    index_t counts[RADIX_SIZE];
+#pragma unroll
+    for (int j = 0; j < RADIX_SIZE; ++j) {
+      counts[j] = 0;
+    }
+    for (index_t base = 0; base < sliceSize; base += WARP_SIZE) {
+      const index_t i = base + laneId;
+      const bool inRange = i < sliceSize;
+      const bitwise_t val = inRange
+          ? TopKTypeConfig<scalar_t>::convert(doLdg(&data[i * withinSliceStride]))
+          : static_cast<bitwise_t>(0);
+      const bool hasVal = inRange && ((val & desiredMask) == desired);
+      const bitwise_t digitInRadix =
+          Bitfield<bitwise_t>::getBitfield(val, digitPos, RADIX_BITS);
+#pragma unroll
+      for (int j = 0; j < RADIX_SIZE; ++j) {
+        const bool vote = hasVal && (digitInRadix == j);
+#if defined(__HIP_PLATFORM_HCC__)
+        counts[j] += __popcll(WARP_BALLOT(vote));
+#else
+        counts[j] += __popc(WARP_BALLOT(vote));
+#endif
+      }
+    }
+
+    // The counts are the same in all the lanes, and so are the branches
+    for (int j = 0; j < RADIX_SIZE; ++j) {
+      if (counts[j] >= kToFind) {
+        desired =
+            Bitfield<bitwise_t>::setBitfield(desired, j, digitPos, RADIX_BITS);
+        desiredMask = Bitfield<bitwise_t>::setBitfield(
+            desiredMask, RADIX_MASK, digitPos, RADIX_BITS);
+        // The k-th element is the only one matching the pattern so far
+        unique = counts[j] == 1;
+        break;
+      }
+      kToFind -= counts[j];
+    }
+  }
+
+  // The first element matching the pattern
+  for (index_t base = 0; base < sliceSize; base += WARP_SIZE) {
+    const index_t i = base + laneId;
+    const bool matches = i < sliceSize &&
+        ((TopKTypeConfig<scalar_t>::convert(doLdg(&data[i * withinSliceStride])) &
+          desiredMask) == desired);
+    const auto vote = WARP_BALLOT(matches);
+    if (vote) {
+      return base + __ffsll(static_cast<long long>(vote)) - 1;
+    }
+  }
+
+  // should not get here
+  assert(false);
+  return 0;
+}
 } // namespace native
 } // namespace at
@@ -74,7 +74,13 @@ std::tuple<Tensor, Tensor, Tensor> cudnn_batch_norm(
   }
   checkAllSameType(c, {weight, bias, running_mean, running_var});
   // TODO: is weight required to be contiguous?
-  checkAllContiguous(c, {input, weight, bias, running_mean, running_var});
+  checkAllContiguous(c, {weight, bias, running_mean, running_var});
+  // The input may be either contiguous or channels last contiguous; the
+  // descriptors are built from the strides and the output keeps the format.
+  auto memory_format = input->suggest_memory_format();
+  AT_CHECK(input->is_contiguous(memory_format),
+           "Expected input to be contiguous in ", memory_format,
+           " memory format (while checking arguments for ", c, ")");
   checkDimRange(c, input, 2, 6 /* exclusive */);
   auto num_features = input->size(1);
   for (auto t : {weight, bias, running_mean, running_var}) {
@@ -94,7 +100,7 @@ std::tuple<Tensor, Tensor, Tensor> cudnn_batch_norm(
     // video R(2+1)D. We will fall back to the normal CUDNN_BATCHNORM_SPATIAL
   }
 
-  auto output_t = at::empty(input->sizes(), input->options());
+  auto output_t = at::empty(input->sizes(), input->options(), memory_format);
   TensorArg output{ output_t, "output", 0 };
 
   auto handle = getCudnnHandle();
@@ -171,7 +177,13 @@ std::tuple<Tensor, Tensor, Tensor> cudnn_batch_norm_backward(
   checkAllSameType(c, {input, grad_output});
   checkAllSameType(c, {weight, save_mean, save_var});
   // TODO: is weight required to be contiguous?
-  checkAllContiguous(c, {input, grad_output, save_mean, save_var});
+  checkAllContiguous(c, {save_mean, save_var});
+  // input, grad_output and grad_input share a descriptor, so they all have
+  // to be laid out in the same memory format.
+  auto memory_format = input->suggest_memory_format();
+  AT_CHECK(input->is_contiguous(memory_format) && grad_output->is_contiguous(memory_format),
+           "Expected input and grad_output to be contiguous in ", memory_format,
+           " memory format (while checking arguments for ", c, ")");
   checkDimRange(c, input, 2, 6 /* exclusive */);
   checkSameSize(c, input, grad_output);
   auto num_features = input->size(1);
@@ -190,7 +202,7 @@ std::tuple<Tensor, Tensor, Tensor> cudnn_batch_norm_backward(
     mode = CUDNN_BATCHNORM_SPATIAL;
   }
 
-  auto grad_input_t  = at::empty(input->sizes(), input->options());
+  auto grad_input_t  = at::empty(input->sizes(), input->options(), memory_format);
   auto grad_weight_t = at::empty(weight->sizes(), weight->options());
   auto grad_bias_t   = at::empty(weight->sizes(), weight->options());
 
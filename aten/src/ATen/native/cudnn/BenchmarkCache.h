@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace at { namespace native { namespace detail {
+
+// The algorithms picked by cudnnFind* when benchmarking (see
+// native/cudnn/Conv.cpp) are cached per process. These dump the cache to a
+// file and load a dumped cache, so that new processes don't have to run the
+// benchmarks again. Loading keeps the entries for the cuDNN version that is
+// loaded and the model of the current GPU, and returns how many there were.
+//
+// Since ATen is separated into CPU build and CUDA build, they are called
+// through CUDA hooks (at cuda/detail/CUDAHooks.cpp), from the native functions
+// _cudnn_save_benchmark_cache and _cudnn_load_benchmark_cache.
+int64_t cudnn_save_benchmark_cache_impl(const std::string& path);
+int64_t cudnn_load_benchmark_cache_impl(const std::string& path);
+
+}}} // namespace at::native::detail
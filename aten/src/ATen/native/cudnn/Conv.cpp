@@ -81,7 +81,10 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> cudnn_convolution_transpose_backwar
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
 #include <ATen/cudnn/Utils.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/cudnn/BenchmarkCache.h>
 #include <ATen/native/utils/ParamsHash.h>
+#include <c10/cuda/CUDAFunctions.h>
 
 #include <ATen/TensorUtils.h>
 
@@ -89,6 +92,9 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> cudnn_convolution_transpose_backwar
 #include <iterator>
 #include <sstream>
 #include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
 #include <memory>
 #include <mutex>
 #include <stdint.h>
@@ -284,6 +290,9 @@ struct ConvolutionParams
   int dilation[max_dim];
   int64_t groups;
   bool deterministic;
+  // The layout of the filter, which follows the input (see
+  // cudnn_convolution_forward); input_stride alone does not capture it.
+  at::MemoryFormat memory_format;
   // NB: transposed purposely omitted: transposed just swaps
   // forward and backward, so you can reuse the benchmark entry,
 };
@@ -319,6 +328,7 @@ void setConvolutionParams(
   // CuDNN, but it doesn't seem worth the effort to actually do this.
   params->groups = groups;
   params->deterministic = deterministic;
+  params->memory_format = weight.suggest_memory_format();
 }
 
 // Convenience struct for passing around descriptors and data
@@ -344,8 +354,17 @@ struct ConvolutionArgs {
 // TODO: Use something less heavy duty than a big honking mutex
 template <typename T>
 struct BenchmarkCache {
+  struct Entry {
+    T perf;
+    // Largest workspace the search was allowed to use, 0 if it didn't
+    // benchmark
+    size_t workspace_limit;
+    // Device the entry was found on, to tell which GPU model it is for
+    int device;
+  };
+
   std::mutex mutex;
-  std::unordered_map<ConvolutionParams, T, ParamsHash<ConvolutionParams>, ParamsEqual<ConvolutionParams>> map;
+  std::unordered_map<ConvolutionParams, Entry, ParamsHash<ConvolutionParams>, ParamsEqual<ConvolutionParams>> map;
 
   bool find(const ConvolutionParams& params, T* results) {
     std::lock_guard<std::mutex> guard(mutex);
@@ -353,13 +372,17 @@ struct BenchmarkCache {
     if (it == map.end()) {
       return false;
     }
-    *results = it->second;
+    *results = it->second.perf;
     return true;
   }
 
-  void insert(const ConvolutionParams& params, const T& results) {
+  void insert(const ConvolutionParams& params, const T& results, size_t workspace_limit = 0) {
+    insert(params, Entry{results, workspace_limit, static_cast<int>(c10::cuda::current_device())});
+  }
+
+  void insert(const ConvolutionParams& params, const Entry& entry) {
     std::lock_guard<std::mutex> guard(mutex);
-    map[params] = results;
+    map[params] = entry;
   }
 };
 
@@ -509,7 +532,7 @@ struct algorithm_search<cudnnConvolutionFwdAlgoPerf_t> {
   static constexpr auto DEFAULT_ALGO = CUDNN_CONVOLUTION_FWD_ALGO_IMPLICIT_PRECOMP_GEMM;
   static BenchmarkCache<perf_t>& cache() { return fwd_algos; }
 
-  static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark) {
+  static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark, size_t* workspace_limit) {
     static const algo_t algos[] = {
          CUDNN_CONVOLUTION_FWD_ALGO_GEMM,
          CUDNN_CONVOLUTION_FWD_ALGO_FFT,
@@ -537,6 +560,7 @@ struct algorithm_search<cudnnConvolutionFwdAlgoPerf_t> {
           perf_results.get()));
     } else {
       size_t max_ws_size = getMaxWorkspaceSize(args, algos, num_algos);
+      *workspace_limit = max_ws_size;
       Workspace ws(max_ws_size);
       AT_CUDNN_CHECK(cudnnFindConvolutionForwardAlgorithmEx(
           args.handle,
@@ -576,7 +600,7 @@ struct algorithm_search<cudnnConvolutionBwdDataAlgoPerf_t> {
   static constexpr auto DEFAULT_ALGO = CUDNN_CONVOLUTION_BWD_DATA_ALGO_1;
   static BenchmarkCache<perf_t>& cache() { return bwd_data_algos; }
 
-  static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark) {
+  static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark, size_t* workspace_limit) {
     static const algo_t algos[] = {
         CUDNN_CONVOLUTION_BWD_DATA_ALGO_0,
         CUDNN_CONVOLUTION_BWD_DATA_ALGO_1,
@@ -602,6 +626,7 @@ struct algorithm_search<cudnnConvolutionBwdDataAlgoPerf_t> {
           perf_results.get()));
     } else {
       size_t max_ws_size = getMaxWorkspaceSize(args, algos, num_algos);
+      *workspace_limit = max_ws_size;
       Workspace ws(max_ws_size);
       AT_CUDNN_CHECK(cudnnFindConvolutionBackwardDataAlgorithmEx(
           args.handle,
@@ -642,7 +667,7 @@ struct algorithm_search<cudnnConvolutionBwdFilterAlgoPerf_t> {
 
   static BenchmarkCache<perf_t>& cache() { return bwd_filter_algos; }
 
-  static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark) {
+  static perf_t findAlgorithm(const ConvolutionArgs& args, bool benchmark, size_t* workspace_limit) {
     static const algo_t algos[] = {
         CUDNN_CONVOLUTION_BWD_FILTER_ALGO_0,
         CUDNN_CONVOLUTION_BWD_FILTER_ALGO_1,
@@ -669,6 +694,7 @@ struct algorithm_search<cudnnConvolutionBwdFilterAlgoPerf_t> {
           perf_results.get()));
     } else {
       size_t max_ws_size = getMaxWorkspaceSize(args, algos, num_algos);
+      *workspace_limit = max_ws_size;
       Workspace ws(max_ws_size);
       AT_CUDNN_CHECK(cudnnFindConvolutionBackwardFilterAlgorithmEx(
           args.handle,
@@ -725,7 +751,8 @@ void findAlgorithm(const ConvolutionArgs& args, bool benchmark, perf_t* algoPerf
     }
   } 
 
-  auto perfResults = search::findAlgorithm(args, benchmark);
+  size_t workspace_limit = 0;
+  auto perfResults = search::findAlgorithm(args, benchmark, &workspace_limit);
   // for deterministic algo, look at all the perf results and return the best
   // deterministic algo
   if (perfResults.status == CUDNN_STATUS_SUCCESS &&
@@ -733,7 +760,7 @@ void findAlgorithm(const ConvolutionArgs& args, bool benchmark, perf_t* algoPerf
       
       // if benchmarking, map the original params with the found algo+math type for re-use
       if (benchmark) {
-        cache.insert(args.params, perfResults);
+        cache.insert(args.params, perfResults, workspace_limit);
 
         // Free the cached blocks in our caching allocator. They are
         // needed here because the above benchmarking uses a huge amount of memory,
@@ -781,6 +808,179 @@ Workspace chooseAlgorithm(
   }
 }
 
+// ---------------------------------------------------------------------
+//
+// Benchmark cache persistence
+//
+// ---------------------------------------------------------------------
+
+// The file starts with a header line
+//
+//     cudnn_benchmark_cache <format version> <sizeof(ConvolutionParams)>
+//
+// followed by one line per cached algorithm:
+//
+//     <kind> <cuDNN version> <params> <algo> <math type> <determinism>
+//         <workspace size> <workspace limit> <time> <GPU name>
+//
+// where kind is fwd, bwd_data or bwd_filter, and params are the bytes of the
+// ConvolutionParams in hex.  The GPU name, which may contain spaces, runs to
+// the end of the line.  Entries only apply to the cuDNN version and the GPU
+// model they were found with; the size of ConvolutionParams guards against
+// files written by a different build.
+
+constexpr const char* kBenchmarkCacheMagic = "cudnn_benchmark_cache";
+constexpr int kBenchmarkCacheFormatVersion = 1;
+
+std::string paramsToHex(const ConvolutionParams& params) {
+  std::ostringstream ss;
+  ss << std::hex << std::setfill('0');
+  auto bytes = reinterpret_cast<const uint8_t*>(&params);
+  for (size_t i = 0; i < sizeof(ConvolutionParams); ++i) {
+    ss << std::setw(2) << static_cast<int>(bytes[i]);
+  }
+  return ss.str();
+}
+
+bool paramsFromHex(const std::string& hex, ConvolutionParams* params) {
+  if (hex.size() != 2 * sizeof(ConvolutionParams)) {
+    return false;
+  }
+  auto bytes = reinterpret_cast<uint8_t*>(params);
+  for (size_t i = 0; i < sizeof(ConvolutionParams); ++i) {
+    char digits[3] = {hex[2 * i], hex[2 * i + 1], '\0'};
+    char* end = nullptr;
+    bytes[i] = static_cast<uint8_t>(std::strtoul(digits, &end, 16));
+    if (end != digits + 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename perf_t>
+int64_t saveBenchmarkCache(std::ostream& out, const char* kind) {
+  auto& cache = algorithm_search<perf_t>::cache();
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  for (const auto& kv : cache.map) {
+    const auto& entry = kv.second;
+    out << kind << ' ' << cudnnGetVersion() << ' ' << paramsToHex(kv.first)
+        << ' ' << static_cast<int>(entry.perf.algo)
+        << ' ' << static_cast<int>(entry.perf.mathType)
+        << ' ' << static_cast<int>(entry.perf.determinism)
+        << ' ' << entry.perf.memory << ' ' << entry.workspace_limit
+        << ' ' << entry.perf.time
+        << ' ' << at::cuda::getDeviceProperties(entry.device)->name << '\n';
+  }
+  return cache.map.size();
+}
+
+template<typename perf_t>
+void loadBenchmarkCacheEntry(
+    const ConvolutionParams& params, int algo, int math_type, int determinism,
+    size_t memory, size_t workspace_limit, float time, int device) {
+  using search = algorithm_search<perf_t>;
+  typename BenchmarkCache<perf_t>::Entry entry;
+  memset(&entry.perf, 0, sizeof(perf_t));
+  entry.perf.algo = static_cast<typename search::algo_t>(algo);
+  entry.perf.status = CUDNN_STATUS_SUCCESS;
+  entry.perf.time = time;
+  entry.perf.memory = memory;
+  entry.perf.determinism = static_cast<cudnnDeterminism_t>(determinism);
+  entry.perf.mathType = static_cast<cudnnMathType_t>(math_type);
+  entry.workspace_limit = workspace_limit;
+  entry.device = device;
+  search::cache().insert(params, entry);
+}
+
+namespace detail {
+
+int64_t cudnn_save_benchmark_cache_impl(const std::string& path) {
+  // Write to a temporary file first, so that processes loading the cache
+  // never see a partially written one.
+  const auto tmp_path = path + ".tmp";
+  int64_t count = 0;
+  {
+    std::ofstream out(tmp_path);
+    AT_CHECK(out, "_cudnn_save_benchmark_cache: could not open ", tmp_path);
+    out << kBenchmarkCacheMagic << ' ' << kBenchmarkCacheFormatVersion << ' '
+        << sizeof(ConvolutionParams) << '\n';
+    out << std::setprecision(9);
+    count += saveBenchmarkCache<cudnnConvolutionFwdAlgoPerf_t>(out, "fwd");
+    count += saveBenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t>(out, "bwd_data");
+    count += saveBenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t>(out, "bwd_filter");
+    out.flush();
+    AT_CHECK(out, "_cudnn_save_benchmark_cache: could not write ", tmp_path);
+  }
+  AT_CHECK(std::rename(tmp_path.c_str(), path.c_str()) == 0,
+           "_cudnn_save_benchmark_cache: could not rename ", tmp_path, " to ", path);
+  return count;
+}
+
+int64_t cudnn_load_benchmark_cache_impl(const std::string& path) {
+  std::ifstream in(path);
+  AT_CHECK(in, "_cudnn_load_benchmark_cache: could not open ", path);
+  std::string magic;
+  int format_version = 0;
+  size_t params_size = 0;
+  in >> magic >> format_version >> params_size;
+  AT_CHECK(in && magic == kBenchmarkCacheMagic,
+           "_cudnn_load_benchmark_cache: ", path, " is not a cuDNN benchmark cache");
+  AT_CHECK(format_version == kBenchmarkCacheFormatVersion,
+           "_cudnn_load_benchmark_cache: unsupported format version ", format_version,
+           " in ", path);
+  if (params_size != sizeof(ConvolutionParams)) {
+    AT_WARN("_cudnn_load_benchmark_cache: ", path, " was written by a different "
+            "build of PyTorch, no algorithm was loaded");
+    return 0;
+  }
+
+  const int device = c10::cuda::current_device();
+  const std::string gpu_name = at::cuda::getDeviceProperties(device)->name;
+  const size_t cudnn_version = cudnnGetVersion();
+  int64_t count = 0;
+  std::string line;
+  std::getline(in, line);  // rest of the header
+  for (int line_number = 2; std::getline(in, line); ++line_number) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream ss(line);
+    std::string kind, hex, entry_gpu_name;
+    size_t entry_cudnn_version = 0, memory = 0, workspace_limit = 0;
+    int algo = 0, math_type = 0, determinism = 0;
+    float time = 0;
+    ss >> kind >> entry_cudnn_version >> hex >> algo >> math_type >> determinism
+       >> memory >> workspace_limit >> time;
+    const bool parsed = !ss.fail();
+    ss >> std::ws;
+    std::getline(ss, entry_gpu_name);
+    ConvolutionParams params;
+    memset(&params, 0, sizeof(ConvolutionParams));
+    AT_CHECK(parsed && !entry_gpu_name.empty() && paramsFromHex(hex, &params),
+             "_cudnn_load_benchmark_cache: malformed entry at ", path, ":", line_number);
+    if (entry_cudnn_version != cudnn_version || entry_gpu_name != gpu_name) {
+      continue;
+    }
+    if (kind == "fwd") {
+      loadBenchmarkCacheEntry<cudnnConvolutionFwdAlgoPerf_t>(
+          params, algo, math_type, determinism, memory, workspace_limit, time, device);
+    } else if (kind == "bwd_data") {
+      loadBenchmarkCacheEntry<cudnnConvolutionBwdDataAlgoPerf_t>(
+          params, algo, math_type, determinism, memory, workspace_limit, time, device);
+    } else if (kind == "bwd_filter") {
+      loadBenchmarkCacheEntry<cudnnConvolutionBwdFilterAlgoPerf_t>(
+          params, algo, math_type, determinism, memory, workspace_limit, time, device);
+    } else {
+      AT_ERROR("_cudnn_load_benchmark_cache: unknown kind ", kind, " at ", path, ":", line_number);
+    }
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace detail
+
 // ---------------------------------------------------------------------
 //
 // Bias addition
@@ -899,17 +1099,20 @@ Tensor cudnn_convolution_forward(
   checkAllSameType(c, {input, weight});
   checkAllSameGPU(c, {input, weight});
 
+  // cuDNN requires the input, the output and the filter to share a layout;
+  // a channels last input gets a channels last output and filter.
+  auto memory_format = input->suggest_memory_format();
   auto output_t = at::empty(
                     conv_output_size(input->sizes(), weight->sizes(),
                                      padding, stride, dilation, groups),
-                    input->options());
+                    input->options(), memory_format);
 
   // Avoid ambiguity of "output" when this is being used as backwards
   TensorArg output{ output_t, "result", 0 };
   convolution_shape_check(c, input, weight, output, padding, stride, dilation, groups);
 
   // See #4500
-  Tensor weight_contig = weight->contiguous();
+  Tensor weight_contig = weight->contiguous(memory_format);
 
   raw_cudnn_convolution_forward_out(
       *output, *input, weight_contig,
@@ -956,7 +1159,7 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> cudnn_convolution_transpose_backwar
     IntArrayRef padding, IntArrayRef output_padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups,
     bool benchmark, bool deterministic, std::array<bool,3> output_mask) {
 
-  Tensor grad_output = grad_output_t.contiguous();
+  Tensor grad_output = grad_output_t.contiguous(input.suggest_memory_format());
 
   Tensor grad_input, grad_weight, grad_bias;
   if (output_mask[0]) {
@@ -1035,14 +1238,15 @@ Tensor cudnn_convolution_backward_input(
   checkAllSameType(c, {grad_output, weight});
   checkAllSameGPU(c, {grad_output, weight});
 
-  auto grad_input_t = at::empty(input_size, grad_output->options());
+  auto memory_format = grad_output->suggest_memory_format();
+  auto grad_input_t = at::empty(input_size, grad_output->options(), memory_format);
 
   // Avoid "grad_input" when this is being used as transposed convolution
   TensorArg grad_input{ grad_input_t, "result", 0 };
   convolution_shape_check(c, grad_input, weight, grad_output, padding, stride, dilation, groups);
 
   // See #4500
-  Tensor weight_contig = weight->contiguous();
+  Tensor weight_contig = weight->contiguous(memory_format);
 
   raw_cudnn_convolution_backward_input_out(
       *grad_input, *grad_output, weight_contig,
@@ -1082,7 +1286,7 @@ std::tuple<at::Tensor,at::Tensor,at::Tensor> cudnn_convolution_backward(
     IntArrayRef padding, IntArrayRef stride, IntArrayRef dilation, int64_t groups,
     bool benchmark, bool deterministic, std::array<bool,3> output_mask) {
 
-  Tensor grad_output = grad_output_t.contiguous();
+  Tensor grad_output = grad_output_t.contiguous(input.suggest_memory_format());
 
   Tensor grad_input, grad_weight, grad_bias;
   if (output_mask[0]) {
@@ -1165,7 +1369,7 @@ Tensor cudnn_convolution_backward_weight(
   checkAllSameType(c, {grad_output, input});
   checkAllSameGPU(c, {grad_output, input});
 
-  auto grad_weight_t = at::empty(weight_size, grad_output->options());
+  auto grad_weight_t = at::empty(weight_size, grad_output->options(), input->suggest_memory_format());
 
   // For uniformity with everything else, although it seems grad_weight
   // would be unambiguous too.
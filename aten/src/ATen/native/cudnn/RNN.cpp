@@ -63,6 +63,14 @@ Tensor _cudnn_init_dropout_state(double dropout, bool train, int64_t dropout_see
 #include <ATen/cudnn/Descriptors.h>
 #include <ATen/cudnn/Types.h>
 #include <ATen/cudnn/Utils.h>
+#include <ATen/native/utils/ParamsHash.h>
+#include <c10/cuda/CUDAFunctions.h>
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace at { namespace native {
 
@@ -313,28 +321,201 @@ namespace {
     TensorDescriptorListParams tensors;
   };
 
-  // NB: Doesn't include the weight descriptor
-  struct RNNDescriptors {
+  // Descriptor caching
+  //
+  // Setting up the RNN descriptor (with the dropout descriptor it owns) and
+  // the per-timestep tensor descriptors takes a number of cuDNN calls, which
+  // shows when every call only runs a few short timesteps, as in streaming
+  // inference. They are fully determined by the POD keys below, so they are
+  // built once and shared by all calls with the same key. The caches are
+  // never destroyed, so that no descriptor outlives cuDNN at exit.
+
+  struct RNNDescriptorCacheKey {
+    cudnnHandle_t handle;
+    int64_t hidden_size;
+    int64_t num_layers;
+    cudnnDirectionMode_t bidirectional;
+    cudnnRNNMode_t mode;
+    cudnnDataType_t datatype;
+    cudnnDataType_t input_datatype;
+    cudnnRNNAlgo_t algo;
+    cudnnRNNInputMode_t input_mode;
+    double dropout; // 0 when not training
+    void* dropout_state;
+    // The plan of CUDNN_RNN_ALGO_PERSIST_DYNAMIC is built for one mini-batch
+    // size; 0 for the other algorithms
+    int64_t plan_mini_batch;
+  };
+
+  // Only used for unpacked input, where all timesteps have the same shape
+  struct TensorDescriptorCacheKey {
+    cudnnDataType_t datatype;
+    cudnnDataType_t hidden_datatype;
+    int64_t seq_length;
+    int64_t mini_batch;
+    int64_t input_size;
+    int64_t output_size;
+    int64_t num_hidden; // num_layers * num_directions
+    int64_t hidden_size;
+    // Strides of a timestep of x and y
+    int64_t x_strides[2];
+    int64_t y_strides[2];
+  };
+
+  struct CachedRNNDescriptor {
     RNNDescriptor rnn_desc;
-    // NB: this won't actually lay out the tensor descriptor pointers
-    // in the right way, so you'll have to preprocess them
+#if CUDNN_VERSION >= 7200 && CUDA_VERSION >= 9010
+    cudnnPersistentRNNPlan_t plan = nullptr;
+    ~CachedRNNDescriptor() {
+      if (plan) {
+        cudnnDestroyPersistentRNNPlan(plan);
+      }
+    }
+#endif
+  };
+
+  struct CachedTensorDescriptors {
     std::vector<TensorDescriptor> x_descs;
     std::vector<TensorDescriptor> y_descs;
     TensorDescriptor hx_desc;
-    TensorDescriptor hy_desc;
-    TensorDescriptor cx_desc;
-    TensorDescriptor cy_desc;
-
-    RNNDescriptors(const RNNParams& fn, cudnnHandle_t handle, Tensor x, Tensor y, Tensor hx, Tensor cx) {
-      rnn_desc = fn.rnn.descriptor(handle, fn.dropout.descriptor(handle));
-      x_descs = fn.tensors.descriptors(x);
-      y_descs = fn.tensors.descriptors(y);
-      hx_desc.set(hx, 5);
-      hy_desc.set(hx, 5);
-      if (cx.defined()) {
-        cx_desc.set(cx, 5);
-        cy_desc.set(cx, 5);
+  };
+
+  template <typename Key, typename Value>
+  struct DescriptorCache {
+    // Bounds the memory held by descriptors of shapes that don't come back,
+    // and the dropout states kept alive by the cached dropout descriptors
+    static constexpr size_t kMaxEntries = 1024;
+
+    std::mutex mutex;
+    std::unordered_map<Key, std::shared_ptr<const Value>, ParamsHash<Key>, ParamsEqual<Key>> map;
+
+    template <typename F>
+    std::shared_ptr<const Value> get(const Key& key, F make) {
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        auto it = map.find(key);
+        if (it != map.end()) {
+          return it->second;
+        }
+      }
+      // Built outside of the lock, as it makes cuDNN calls. Entries are not
+      // modified once built, so they can be shared without further locking.
+      std::shared_ptr<const Value> value = make();
+      std::lock_guard<std::mutex> guard(mutex);
+      if (map.size() >= kMaxEntries) {
+        map.clear();
       }
+      map.emplace(key, value);
+      return value;
+    }
+  };
+
+  DescriptorCache<RNNDescriptorCacheKey, CachedRNNDescriptor>& rnn_descriptor_cache() {
+    static auto* cache = new DescriptorCache<RNNDescriptorCacheKey, CachedRNNDescriptor>();
+    return *cache;
+  }
+
+  DescriptorCache<TensorDescriptorCacheKey, CachedTensorDescriptors>& tensor_descriptor_cache() {
+    static auto* cache = new DescriptorCache<TensorDescriptorCacheKey, CachedTensorDescriptors>();
+    return *cache;
+  }
+
+  std::shared_ptr<const CachedRNNDescriptor> get_rnn_descriptor(const RNNParams& fn, cudnnHandle_t handle) {
+    RNNDescriptorCacheKey key;
+    memset(&key, 0, sizeof(key));
+    key.handle = handle;
+    key.hidden_size = fn.rnn.hidden_size;
+    key.num_layers = fn.rnn.num_layers;
+    key.bidirectional = fn.rnn.bidirectional;
+    key.mode = fn.rnn.mode;
+    key.datatype = fn.rnn.datatype;
+    key.input_datatype = fn.rnn.input_datatype;
+    key.algo = fn.rnn.algo;
+    key.input_mode = fn.rnn.input_mode;
+    if (fn.dropout.train && fn.dropout.dropout != 0) {
+      key.dropout = fn.dropout.dropout;
+      key.dropout_state = fn.dropout.dropout_state.data_ptr();
+    }
+#if CUDNN_VERSION >= 7200 && CUDA_VERSION >= 9010
+    if (fn.rnn.algo == CUDNN_RNN_ALGO_PERSIST_DYNAMIC) {
+      key.plan_mini_batch = fn.tensors.mini_batch;
+    }
+#endif
+    return rnn_descriptor_cache().get(key, [&] {
+      auto entry = std::make_shared<CachedRNNDescriptor>();
+      entry->rnn_desc = fn.rnn.descriptor(handle, fn.dropout.descriptor(handle));
+#if CUDNN_VERSION >= 7200 && CUDA_VERSION >= 9010
+      if (fn.rnn.algo == CUDNN_RNN_ALGO_PERSIST_DYNAMIC) {
+        AT_CUDNN_CHECK(cudnnCreatePersistentRNNPlan(
+              entry->rnn_desc.desc(), fn.tensors.mini_batch, fn.rnn.input_datatype, &entry->plan));
+        AT_CUDNN_CHECK(cudnnSetPersistentRNNPlan(entry->rnn_desc.desc(), entry->plan));
+      }
+#endif
+      return entry;
+    });
+  }
+
+  std::shared_ptr<const CachedTensorDescriptors> get_tensor_descriptors(
+      const RNNParams& fn, const Tensor& x, const Tensor& y, const Tensor& hx) {
+    auto make = [&] {
+      auto entry = std::make_shared<CachedTensorDescriptors>();
+      entry->x_descs = fn.tensors.descriptors(x);
+      entry->y_descs = fn.tensors.descriptors(y);
+      entry->hx_desc.set(hx, 5);
+      return entry;
+    };
+    if (fn.tensors.is_input_packed()) {
+      // The batch sizes make the key unbounded, so don't cache these
+      return std::shared_ptr<const CachedTensorDescriptors>(make());
+    }
+    TensorDescriptorCacheKey key;
+    memset(&key, 0, sizeof(key));
+    key.datatype = getCudnnDataType(x);
+    key.hidden_datatype = getCudnnDataType(hx);
+    key.seq_length = fn.tensors.seq_length;
+    key.mini_batch = fn.tensors.mini_batch;
+    key.input_size = fn.tensors.input_size;
+    key.output_size = fn.rnn.hidden_size * fn.rnn.num_directions();
+    key.num_hidden = fn.rnn.num_layers * fn.rnn.num_directions();
+    key.hidden_size = fn.rnn.hidden_size;
+    for (int i = 0; i < 2; i++) {
+      key.x_strides[i] = x.stride(i + 1);
+      key.y_strides[i] = y.stride(i + 1);
+    }
+    return tensor_descriptor_cache().get(key, make);
+  }
+
+  // NB: Doesn't include the weight descriptor
+  struct RNNDescriptors {
+    // Keep the shared descriptors alive; the members below refer into them
+    std::shared_ptr<const CachedRNNDescriptor> rnn_entry;
+    std::shared_ptr<const CachedTensorDescriptors> tensor_entry;
+
+    const RNNDescriptor& rnn_desc;
+    // NB: this won't actually lay out the tensor descriptor pointers
+    // in the right way, so you'll have to preprocess them
+    const std::vector<TensorDescriptor>& x_descs;
+    const std::vector<TensorDescriptor>& y_descs;
+    const TensorDescriptor& hx_desc;
+    const TensorDescriptor& hy_desc;
+    // hx, hy, cx and cy all have the same shape; the cell descriptors are
+    // left unset for RNNs without a cell state
+    TensorDescriptor no_cell_desc;
+    const TensorDescriptor& cx_desc;
+    const TensorDescriptor& cy_desc;
+
+    RNNDescriptors(const RNNParams& fn, cudnnHandle_t handle, Tensor x, Tensor y, Tensor hx, Tensor cx)
+      : rnn_entry(get_rnn_descriptor(fn, handle)),
+        tensor_entry(get_tensor_descriptors(fn, x, y, hx)),
+        rnn_desc(rnn_entry->rnn_desc),
+        x_descs(tensor_entry->x_descs),
+        y_descs(tensor_entry->y_descs),
+        hx_desc(tensor_entry->hx_desc),
+        hy_desc(tensor_entry->hx_desc),
+        cx_desc(cx.defined() ? tensor_entry->hx_desc : no_cell_desc),
+        cy_desc(cx.defined() ? tensor_entry->hx_desc : no_cell_desc) {
+      AT_CHECK(!cx.defined() || cx.scalar_type() == hx.scalar_type(),
+               "rnn: expected cx to have the same dtype as hx, got ", cx.scalar_type(), " and ", hx.scalar_type());
     }
 
     // TODO: This is annoying, having to put the cudnnTensorDescriptor_t
@@ -602,6 +783,190 @@ namespace {
 #endif
   }
 
+  // Algorithm selection
+  //
+  // With torch.backends.cudnn.benchmark set, the first forward call with new
+  // parameters times every algorithm on its input, and the fastest one is
+  // remembered for those parameters. Backward calls only look the choice up,
+  // because they must use the same algorithm as their forward: as the reserve
+  // layout depends on it, the flag must not be flipped between a forward and
+  // its backward. Without the flag, or for packed input, get_algo()'s
+  // heuristic picks the algorithm.
+
+  struct RNNAlgoCacheKey {
+    int device;
+    cudnnRNNMode_t mode;
+    cudnnDirectionMode_t bidirectional;
+    cudnnDataType_t datatype;
+    cudnnDataType_t input_datatype;
+    int64_t hidden_size;
+    int64_t num_layers;
+    int64_t seq_length;
+    int64_t mini_batch;
+    int64_t input_size;
+    bool train;
+  };
+
+  struct RNNAlgoCache {
+    std::mutex mutex;
+    std::unordered_map<RNNAlgoCacheKey, cudnnRNNAlgo_t, ParamsHash<RNNAlgoCacheKey>, ParamsEqual<RNNAlgoCacheKey>> map;
+
+    bool find(const RNNAlgoCacheKey& key, cudnnRNNAlgo_t* algo) {
+      std::lock_guard<std::mutex> guard(mutex);
+      auto it = map.find(key);
+      if (it == map.end()) {
+        return false;
+      }
+      *algo = it->second;
+      return true;
+    }
+
+    void insert(const RNNAlgoCacheKey& key, cudnnRNNAlgo_t algo) {
+      std::lock_guard<std::mutex> guard(mutex);
+      map[key] = algo;
+    }
+  };
+
+  RNNAlgoCache rnn_algos;
+
+  RNNAlgoCacheKey get_algo_cache_key(const RNNParams& fn) {
+    RNNAlgoCacheKey key;
+    memset(&key, 0, sizeof(key));
+    key.device = static_cast<int>(c10::cuda::current_device());
+    key.mode = fn.rnn.mode;
+    key.bidirectional = fn.rnn.bidirectional;
+    key.datatype = fn.rnn.datatype;
+    key.input_datatype = fn.rnn.input_datatype;
+    key.hidden_size = fn.rnn.hidden_size;
+    key.num_layers = fn.rnn.num_layers;
+    key.seq_length = fn.tensors.seq_length;
+    key.mini_batch = fn.tensors.mini_batch;
+    key.input_size = fn.tensors.input_size;
+    key.train = fn.dropout.train;
+    return key;
+  }
+
+  bool should_benchmark_algo(const RNNParams& fn) {
+    return at::globalContext().benchmarkCuDNN() && !fn.tensors.is_input_packed();
+  }
+
+  // Returns whether a benchmarked algorithm is known for these parameters
+  bool find_benchmarked_algo(const RNNParams& fn, cudnnRNNAlgo_t* algo) {
+    return should_benchmark_algo(fn) && rnn_algos.find(get_algo_cache_key(fn), algo);
+  }
+
+  // Runs the forward pass and returns the reserve for the backward pass, which
+  // is empty in inference
+  Tensor rnn_forward(
+      cudnnHandle_t handle, const RNNParams& fn, RNNDescriptors& descs,
+      const FilterDescriptor& w_desc, const Tensor& weight_buf,
+      const Tensor& x, const Tensor& hx, const Tensor& cx,
+      const Tensor& y, const Tensor& hy, const Tensor& cy) {
+    size_t workspace_size;
+    auto x_descs_arr = descs.get_x_descs();
+    auto y_descs_arr = descs.get_y_descs();
+    AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
+          handle,
+          descs.rnn_desc.desc(),
+          fn.tensors.seq_length,
+          x_descs_arr.data(),
+          &workspace_size
+          ));
+    Tensor workspace = at::empty(workspace_size, x.options().dtype(kByte));
+
+    Tensor reserve;
+    // NB: Previously, the test was for fn.requires_grad, but we don't have
+    // this information.  Use 'train' as a proxy.
+    if (fn.dropout.train) {
+      size_t reserve_size;
+      AT_CUDNN_CHECK(cudnnGetRNNTrainingReserveSize(
+            handle,
+            descs.rnn_desc.desc(),
+            fn.tensors.seq_length,
+            x_descs_arr.data(),
+            &reserve_size
+            ));
+      reserve = at::empty(reserve_size, x.options().dtype(kByte));
+      AT_CUDNN_CHECK(cudnnRNNForwardTraining(
+            handle,
+            descs.rnn_desc.desc(),
+            fn.tensors.seq_length,
+            x_descs_arr.data(), x.data_ptr(),
+            descs.hx_desc.desc(), hx.data_ptr(),
+            descs.cx_desc.desc(), cx.defined() ? cx.data_ptr() : nullptr,
+            w_desc.desc(), weight_buf.data_ptr(),
+            y_descs_arr.data(), y.data_ptr(),
+            descs.hy_desc.desc(), hy.data_ptr(),
+            descs.cy_desc.desc(), cy.defined() ? cy.data_ptr() : nullptr,
+            workspace.data_ptr(), workspace.size(0),
+            reserve.data_ptr(), reserve.size(0)
+            ));
+    } else { // inference
+      reserve = at::empty({0}, x.options().dtype(kByte));
+      AT_CUDNN_CHECK(cudnnRNNForwardInference(
+            handle,
+            descs.rnn_desc.desc(),
+            fn.tensors.seq_length,
+            x_descs_arr.data(), x.data_ptr(),
+            descs.hx_desc.desc(), hx.data_ptr(),
+            descs.cx_desc.desc(), cx.defined() ? cx.data_ptr() : nullptr,
+            w_desc.desc(), weight_buf.data_ptr(),
+            y_descs_arr.data(), y.data_ptr(),
+            descs.hy_desc.desc(), hy.data_ptr(),
+            descs.cy_desc.desc(), cy.defined() ? cy.data_ptr() : nullptr,
+            workspace.data_ptr(), workspace.size(0)
+            ));
+    }
+    return reserve;
+  }
+
+  // Times the forward pass with every algorithm, writing into the outputs of
+  // the call, and remembers the fastest one. Algorithms that don't support
+  // the parameters are skipped. In training, every run advances the dropout
+  // RNG state, as the real call does.
+  cudnnRNNAlgo_t benchmark_algo(
+      cudnnHandle_t handle, RNNParams fn,
+      const FilterDescriptor& w_desc, const Tensor& weight_buf,
+      const Tensor& x, const Tensor& hx, const Tensor& cx,
+      const Tensor& y, const Tensor& hy, const Tensor& cy) {
+    const cudnnRNNAlgo_t algos[] = {
+      CUDNN_RNN_ALGO_STANDARD,
+#if CUDNN_VERSION >= 7200 && CUDA_VERSION >= 9010
+      CUDNN_RNN_ALGO_PERSIST_STATIC,
+      CUDNN_RNN_ALGO_PERSIST_DYNAMIC,
+#endif
+    };
+    constexpr int kIterations = 3;
+    cudnnRNNAlgo_t best_algo = CUDNN_RNN_ALGO_STANDARD;
+    float best_time = std::numeric_limits<float>::max();
+    for (auto algo : algos) {
+      fn.rnn.set_algo(algo);
+      float time;
+      try {
+        RNNDescriptors descs(fn, handle, x, y, hx, cx);
+        // Warm up, which also rejects unsupported algorithms
+        rnn_forward(handle, fn, descs, w_desc, weight_buf, x, hx, cx, y, hy, cy);
+        at::cuda::CUDAEvent start(cudaEventDefault);
+        at::cuda::CUDAEvent stop(cudaEventDefault);
+        start.record();
+        for (int i = 0; i < kIterations; i++) {
+          rnn_forward(handle, fn, descs, w_desc, weight_buf, x, hx, cx, y, hy, cy);
+        }
+        stop.record();
+        stop.synchronize();
+        time = start.elapsed_time(stop);
+      } catch (const c10::Error&) {
+        continue;
+      }
+      if (time < best_time) {
+        best_time = time;
+        best_algo = algo;
+      }
+    }
+    rnn_algos.insert(get_algo_cache_key(fn), best_algo);
+    return best_algo;
+  }
+
   cudnnDataType_t promote_rnn_math_type(cudnnDataType_t dtype) {
 #if CUDNN_VERSION != 7103
 // CUDNN 7.1.3 enforces RNN descriptor type to be identical to input/weight. This check throws an error for type
@@ -731,19 +1096,23 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
   auto y = output;
 
   auto handle = getCudnnHandle();
-  cudnnRNNAlgo_t algo = get_algo(fn.rnn, fn.tensors, input);
+  cudnnRNNAlgo_t algo;
+  bool benchmarked = find_benchmarked_algo(fn, &algo);
+  if (!benchmarked) {
+    algo = get_algo(fn.rnn, fn.tensors, input);
+  }
   fn.rnn.set_algo(algo);
-  RNNDescriptors descs(fn, handle, x, y, hx, cx);
+  std::unique_ptr<RNNDescriptors> descs(new RNNDescriptors(fn, handle, x, y, hx, cx));
 
   FilterDescriptor w_desc;
   if (!weight_buf.defined()) {
-    auto num_weights = get_num_weights(handle, descs.rnn_desc, descs.x_descs[0], datatype);
+    auto num_weights = get_num_weights(handle, descs->rnn_desc, descs->x_descs[0], datatype);
     weight_buf = at::empty(num_weights, x.options());
     w_desc.set(weight_buf, 3);
     weight_buf.zero_();
     std::vector<Tensor> params;
     size_t params_stride0;
-    std::tie(params, params_stride0) = get_parameters(handle, fn.rnn, descs.rnn_desc, descs.x_descs[0], w_desc, weight_buf);
+    std::tie(params, params_stride0) = get_parameters(handle, fn.rnn, descs->rnn_desc, descs->x_descs[0], w_desc, weight_buf);
     _copyParams(MatrixRef<Tensor>{weight, static_cast<size_t>(weight_stride0)},
                 MatrixRef<Tensor>{params, params_stride0});
   } else {
@@ -753,63 +1122,18 @@ std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor> _cudnn_rnn(
   AT_CHECK(!cx.defined() || cx.sizes().equals(hidden_size),
            "Expected cell size ", IntArrayRef{hidden_size}, ", got ", cx.sizes());
 
-  size_t workspace_size;
-  auto x_descs_arr = descs.get_x_descs();
-  auto y_descs_arr = descs.get_y_descs();
-  AT_CUDNN_CHECK(cudnnGetRNNWorkspaceSize(
-        handle,
-        descs.rnn_desc.desc(),
-        fn.tensors.seq_length,
-        x_descs_arr.data(),
-        &workspace_size
-        ));
-  Tensor workspace = at::empty(workspace_size, input.options().dtype(kByte));
-
-  Tensor reserve;
-  // NB: Previously, the test was for fn.requires_grad, but we don't have
-  // this information.  Use 'train' as a proxy.
-  if (fn_train) {
-    size_t reserve_size;
-    AT_CUDNN_CHECK(cudnnGetRNNTrainingReserveSize(
-          handle,
-          descs.rnn_desc.desc(),
-          fn.tensors.seq_length,
-          x_descs_arr.data(),
-          &reserve_size
-          ));
-    reserve = at::empty(reserve_size, input.options().dtype(kByte));
-    AT_CUDNN_CHECK(cudnnRNNForwardTraining(
-          handle,
-          descs.rnn_desc.desc(),
-          fn.tensors.seq_length,
-          x_descs_arr.data(), x.data_ptr(),
-          descs.hx_desc.desc(), hx.data_ptr(),
-          descs.cx_desc.desc(), cx.defined() ? cx.data_ptr() : nullptr,
-          w_desc.desc(), weight_buf.data_ptr(),
-          y_descs_arr.data(), y.data_ptr(),
-          descs.hy_desc.desc(), hy.data_ptr(),
-          descs.cy_desc.desc(), cy.defined() ? cy.data_ptr() : nullptr,
-          workspace.data_ptr(), workspace.size(0),
-          reserve.data_ptr(), reserve.size(0)
-          ));
-  } else { // inference
-    reserve = at::empty({0}, input.options().dtype(kByte));
-    AT_CUDNN_CHECK(cudnnRNNForwardInference(
-          handle,
-          descs.rnn_desc.desc(),
-          fn.tensors.seq_length,
-          x_descs_arr.data(), x.data_ptr(),
-          descs.hx_desc.desc(), hx.data_ptr(),
-          descs.cx_desc.desc(), cx.defined() ? cx.data_ptr() : nullptr,
-          w_desc.desc(), weight_buf.data_ptr(),
-          y_descs_arr.data(), y.data_ptr(),
-          descs.hy_desc.desc(), hy.data_ptr(),
-          descs.cy_desc.desc(), cy.defined() ? cy.data_ptr() : nullptr,
-          workspace.data_ptr(), workspace.size(0)
-          ));
-
+  if (!benchmarked && should_benchmark_algo(fn)) {
+    // The weight layout doesn't depend on the algorithm, so the buffer set
+    // up above works with all of them
+    auto best_algo = benchmark_algo(handle, fn, w_desc, weight_buf, x, hx, cx, y, hy, cy);
+    if (best_algo != algo) {
+      fn.rnn.set_algo(best_algo);
+      descs.reset(new RNNDescriptors(fn, handle, x, y, hx, cx));
+    }
   }
 
+  Tensor reserve = rnn_forward(handle, fn, *descs, w_desc, weight_buf, x, hx, cx, y, hy, cy);
+
   if (batch_first && !is_input_packed) {
     output.transpose_(0, 1);
   }
@@ -893,7 +1217,10 @@ std::tuple<Tensor, Tensor, Tensor> _cudnn_rnn_backward_input(
   AT_CHECK(dhy.is_cuda() && dy.is_cuda() && (!dcy.defined() || dcy.is_cuda()),
            "Gradients aren't CUDA tensors");
 
-  cudnnRNNAlgo_t algo = get_algo(fn.rnn, fn.tensors, input);
+  cudnnRNNAlgo_t algo;
+  if (!find_benchmarked_algo(fn, &algo)) {
+    algo = get_algo(fn.rnn, fn.tensors, input);
+  }
   fn.rnn.set_algo(algo);
   RNNDescriptors descs(fn, handle, x, y, hx, cx);
 
@@ -998,7 +1325,10 @@ std::vector<Tensor> _cudnn_rnn_backward_weight(
   const auto& y = output;
   auto dw = at::zeros(weight_buf.sizes(), weight_buf.options());
 
-  cudnnRNNAlgo_t algo = get_algo(fn.rnn, fn.tensors, input);
+  cudnnRNNAlgo_t algo;
+  if (!find_benchmarked_algo(fn, &algo)) {
+    algo = get_algo(fn.rnn, fn.tensors, input);
+  }
   fn.rnn.set_algo(algo);
   RNNDescriptors descs(fn, handle, x, y, hx, cx);
 
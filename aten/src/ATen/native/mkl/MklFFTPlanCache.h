@@ -0,0 +1,170 @@
+#pragma once
+
+// Like the files in ATen/mkl, this header assumes that MKL is available and
+// must only be included under #if AT_MKL_ENABLED().
+
+#include <ATen/ATen.h>
+#include <ATen/mkl/Descriptors.h>
+#include <ATen/native/utils/ParamsHash.h>
+
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace at { namespace native { namespace detail {
+
+constexpr int mkl_fft_max_rank = 3;
+
+// This POD struct holds everything that goes into a committed MKL DFTI
+// descriptor, so that it can be hashed and compared byte-wise.
+// It will be the **key** to the plan cache.
+// Distances and strides are counted in real or complex elements, as MKL
+// expects them.
+struct MklFFTParams
+{
+  at::ScalarType scalar_type_;
+  uint8_t signal_ndim_;  // between 1 and mkl_fft_max_rank
+  bool complex_input_;
+  bool complex_output_;
+  bool inverse_;
+  bool normalized_;
+  int64_t batch_;
+  int64_t idist_;
+  int64_t odist_;
+  int64_t signal_sizes_[mkl_fft_max_rank];
+  int64_t istrides_[mkl_fft_max_rank];
+  int64_t ostrides_[mkl_fft_max_rank];
+  // Upper bound on the threads MKL may use for one execution of the plan.
+  int64_t num_threads_;
+};
+
+// NB: This can't be a constructor, because then MklFFTParams
+// would not be a POD anymore.
+static inline void setMklFFTParams(MklFFTParams* params,
+    const Tensor& input, const Tensor& output, int64_t signal_ndim,
+    bool complex_input, bool complex_output, bool inverse,
+    IntArrayRef checked_signal_sizes, bool normalized, int64_t num_threads) {
+
+  memset(params, 0, sizeof(MklFFTParams));
+  params->scalar_type_ = input.scalar_type();
+  params->signal_ndim_ = (uint8_t) signal_ndim;
+  params->complex_input_ = complex_input;
+  params->complex_output_ = complex_output;
+  params->inverse_ = inverse;
+  params->normalized_ = normalized;
+  params->batch_ = input.size(0);
+  // batch dim stride, i.e., dist between each data
+  params->idist_ = complex_input ? input.stride(0) >> 1 : input.stride(0);
+  params->odist_ = complex_output ? output.stride(0) >> 1 : output.stride(0);
+  for (int64_t i = 0; i < signal_ndim; i++) {
+    params->signal_sizes_[i] = checked_signal_sizes[i];
+    params->istrides_[i] = complex_input ? input.stride(i + 1) >> 1 : input.stride(i + 1);
+    params->ostrides_[i] = complex_output ? output.stride(i + 1) >> 1 : output.stride(i + 1);
+  }
+  params->num_threads_ = num_threads;
+}
+
+// The default max cache size is arbitrary. Committed descriptors of large
+// transforms hold sizeable twiddle tables, so this is smaller than the cuFFT
+// default.
+constexpr size_t MKL_FFT_DEFAULT_CACHE_SIZE = 256;
+
+// An LRU cache of committed descriptors, keyed by MklFFTParams. Unlike the
+// cuFFT plan cache, lookups hand out shared ownership of the descriptor: a
+// committed descriptor may be executed from several threads at once, so the
+// mutex only needs to be held while the cache itself is read or modified,
+// and a descriptor evicted while in use stays alive until its last user is
+// done.
+// This is **NOT** thread-safe. Please use the mutex when calling any of
+// the methods.
+class MklFFTParamsLRUCache {
+public:
+  using value_t = std::shared_ptr<DftiDescriptor>;
+  using kv_t = typename std::pair<MklFFTParams, value_t>;
+  using map_t = typename std::unordered_map<std::reference_wrapper<const MklFFTParams>,
+                                            typename std::list<kv_t>::iterator,
+                                            ParamsHash<MklFFTParams>,
+                                            ParamsEqual<MklFFTParams>>;
+
+  MklFFTParamsLRUCache() : MklFFTParamsLRUCache(MKL_FFT_DEFAULT_CACHE_SIZE) {}
+
+  MklFFTParamsLRUCache(int64_t max_size) {
+    _set_max_size(max_size);
+  }
+
+  // Returns the cached descriptor for key and marks it as most recently
+  // used, or returns nullptr if there is none.
+  value_t lookup(const MklFFTParams& key) {
+    auto map_it = _cache_map.find(std::cref(key));
+    if (map_it == _cache_map.end()) {
+      _misses++;
+      return nullptr;
+    }
+    _hits++;
+    _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
+    return map_it->second->second;
+  }
+
+  // Inserts a descriptor for key, evicting the least recently used one if
+  // the cache is full. Keeps the existing descriptor if another thread
+  // inserted one for the same key in the meantime.
+  void insert(const MklFFTParams& key, value_t value) {
+    if (_max_size == 0 || _cache_map.count(std::cref(key)) != 0) {
+      return;
+    }
+    if (_usage_list.size() >= _max_size) {
+      _cache_map.erase(_usage_list.back().first);
+      _usage_list.pop_back();
+    }
+    _usage_list.emplace_front(key, std::move(value));
+    auto kv_it = _usage_list.begin();
+    _cache_map.emplace(std::cref(kv_it->first), kv_it);
+  }
+
+  // Also resets the hit and miss counts
+  void clear() {
+    _cache_map.clear();
+    _usage_list.clear();
+    _hits = 0;
+    _misses = 0;
+  }
+
+  void resize(int64_t new_size) {
+    _set_max_size(new_size);
+    while (_usage_list.size() > _max_size) {
+      _cache_map.erase(_usage_list.back().first);
+      _usage_list.pop_back();
+    }
+  }
+
+  size_t size() const { return _cache_map.size(); }
+
+  size_t max_size() const noexcept { return _max_size; }
+
+  // Lookups that found a plan in the cache, and that had to create one, since
+  // the cache was last cleared
+  size_t hits() const noexcept { return _hits; }
+  size_t misses() const noexcept { return _misses; }
+
+  std::mutex mutex;
+
+private:
+  void _set_max_size(int64_t new_size) {
+    AT_CHECK(new_size >= 0,
+             "MKL FFT plan cache size must be non-negative, but got ", new_size);
+    _max_size = static_cast<size_t>(new_size);
+  }
+
+  std::list<kv_t> _usage_list;
+  map_t _cache_map;
+  size_t _max_size;
+  size_t _hits = 0;
+  size_t _misses = 0;
+};
+
+// The process-wide cache used by _fft_mkl.
+CAFFE2_API MklFFTParamsLRUCache& mkl_fft_get_plan_cache();
+
+}}} // namespace at::native::detail
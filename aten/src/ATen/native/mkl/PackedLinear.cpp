@@ -0,0 +1,144 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Config.h>
+
+#if !AT_MKL_ENABLED()
+
+namespace at { namespace native {
+
+Tensor mkl_pack_linear_weight(const Tensor& weight) {
+  AT_ERROR("mkl_pack_linear_weight: ATen not compiled with MKL support");
+}
+
+Tensor mkl_linear_packed_weight(
+    const Tensor& input, const Tensor& packed_weight, const Tensor& bias) {
+  AT_ERROR("mkl_linear_packed_weight: ATen not compiled with MKL support");
+}
+
+}}
+
+#else // AT_MKL_ENABLED
+
+#include <ATen/cpp_custom_type_hack.h>
+
+#include <memory>
+
+#include <mkl.h>
+
+namespace at { namespace native {
+
+struct MKLFree {
+  void operator()(float* ptr) const {
+    mkl_free(ptr);
+  }
+};
+
+// A linear layer weight of size out_features x in_features, packed by
+// cblas_sgemm_pack as the (transposed) B operand of input * weight^T. The
+// packed layout does not depend on the number of input rows, so the same
+// weight serves every batch size without being re-read or re-packed.
+struct MKLPackedLinearWeight {
+  std::unique_ptr<float, MKLFree> packed;
+  int64_t out_features;
+  int64_t in_features;
+};
+
+}} // namespace at::native
+
+namespace caffe2 {
+// Required for cpp_custom_type_hack to work
+CAFFE_KNOWN_TYPE(at::native::MKLPackedLinearWeight);
+} // namespace caffe2
+
+namespace at { namespace native {
+
+Tensor mkl_pack_linear_weight(const Tensor& weight) {
+  AT_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == kFloat &&
+          weight.device().is_cpu() && weight.layout() == kStrided,
+      "mkl_pack_linear_weight: expected a 2-dimensional dense float CPU weight");
+  auto weight_contig = weight.contiguous();
+  const MKL_INT N = weight.size(0);
+  const MKL_INT K = weight.size(1);
+
+  auto packed = guts::make_unique<MKLPackedLinearWeight>();
+  packed->out_features = N;
+  packed->in_features = K;
+  if (N == 0 || K == 0) {
+    return cpp_custom_type_hack::create(std::move(packed), weight.options());
+  }
+  // m only bounds the rows of A used with the packed B; the layout of B is
+  // the same for any m.
+  const size_t nbytes = cblas_sgemm_pack_get_size(CblasBMatrix, 1, N, K);
+  packed->packed.reset(static_cast<float*>(mkl_malloc(nbytes, 64)));
+  AT_CHECK(packed->packed, "mkl_pack_linear_weight: out of memory");
+  cblas_sgemm_pack(
+      CblasRowMajor,
+      CblasBMatrix,
+      CblasTrans,
+      /*m=*/1,
+      /*n=*/N,
+      /*k=*/K,
+      /*alpha=*/1.0f,
+      weight_contig.data<float>(),
+      /*ldb=*/K,
+      packed->packed.get());
+  return cpp_custom_type_hack::create(std::move(packed), weight.options());
+}
+
+Tensor mkl_linear_packed_weight(
+    const Tensor& input, const Tensor& packed_weight, const Tensor& bias) {
+  auto& packed = cpp_custom_type_hack::cast<MKLPackedLinearWeight>(packed_weight);
+  const int64_t N = packed.out_features;
+  const int64_t K = packed.in_features;
+  AT_CHECK(
+      input.scalar_type() == kFloat && input.device().is_cpu() &&
+          input.layout() == kStrided,
+      "mkl_linear_packed_weight: expected a dense float CPU input");
+  AT_CHECK(
+      input.dim() >= 1 && input.size(-1) == K,
+      "mkl_linear_packed_weight: expected input with ", K,
+      " features in its last dimension, but got input of size ", input.sizes());
+
+  auto input_contig = input.contiguous();
+  auto output_size = input.sizes().vec();
+  output_size.back() = N;
+  int64_t M = 1;
+  for (int64_t i = 0; i < input.dim() - 1; ++i) {
+    M *= input.size(i);
+  }
+
+  auto output = at::empty({M, N}, input.options());
+  float beta = 0.0f;
+  if (bias.defined()) {
+    AT_CHECK(
+        bias.dim() == 1 && bias.size(0) == N,
+        "mkl_linear_packed_weight: expected bias of size [", N, "], but got ",
+        bias.sizes());
+    output.copy_(bias.expand({M, N}));
+    beta = 1.0f;
+  }
+  if (M > 0 && N > 0 && K > 0) {
+    cblas_sgemm_compute(
+        CblasRowMajor,
+        CblasNoTrans,
+        CblasPacked,
+        /*m=*/M,
+        /*n=*/N,
+        /*k=*/K,
+        input_contig.data<float>(),
+        /*lda=*/K,
+        packed.packed.get(),
+        /*ldb=*/K,
+        beta,
+        output.data<float>(),
+        /*ldc=*/N);
+  } else if (!bias.defined()) {
+    output.zero_();
+  }
+  return output.view(output_size);
+}
+
+}} // namespace at::native
+
+#endif
@@ -30,11 +30,14 @@ Tensor _fft_mkl(const Tensor& input, int64_t signal_ndim,
 #include <vector>
 #include <numeric>
 #include <cmath>
+#include <memory>
+#include <mutex>
 
 #include <mkl_dfti.h>
 #include <ATen/mkl/Exceptions.h>
 #include <ATen/mkl/Descriptors.h>
 #include <ATen/mkl/Limits.h>
+#include <ATen/native/mkl/MklFFTPlanCache.h>
 
 
 namespace at { namespace native {
@@ -144,6 +147,72 @@ static inline void _fft_fill_with_conjugate_symmetry_(Tensor& input,
   });
 }
 
+namespace detail {
+
+MklFFTParamsLRUCache& mkl_fft_get_plan_cache() {
+  static MklFFTParamsLRUCache plan_cache;
+  return plan_cache;
+}
+
+} // namespace detail
+
+// Creates and commits a descriptor for the transform described by params.
+static std::shared_ptr<DftiDescriptor> _mkl_fft_plan(const detail::MklFFTParams& params) {
+  const int64_t signal_ndim = params.signal_ndim_;
+  // precision
+  DFTI_CONFIG_VALUE prec = params.scalar_type_ == ScalarType::Double ? DFTI_DOUBLE : DFTI_SINGLE;
+  // signal type
+  DFTI_CONFIG_VALUE signal_type;
+  if (!params.inverse_) {
+    signal_type = params.complex_input_ ? DFTI_COMPLEX : DFTI_REAL;
+  } else {
+    signal_type = params.complex_output_ ? DFTI_COMPLEX : DFTI_REAL;
+  }
+  // create descriptor with signal size
+  std::vector<MKL_LONG> mkl_signal_sizes(params.signal_sizes_, params.signal_sizes_ + signal_ndim);
+  auto descriptor = std::make_shared<DftiDescriptor>();
+  descriptor->init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
+  // out of place FFT
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
+  // batch mode
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_NUMBER_OF_TRANSFORMS, static_cast<MKL_LONG>(params.batch_)));
+  // batch dim stride, i.e., dist between each data
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_INPUT_DISTANCE, static_cast<MKL_LONG>(params.idist_)));
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_OUTPUT_DISTANCE, static_cast<MKL_LONG>(params.odist_)));
+  // signal strides
+  // first val is offset, set to zero (ignored)
+  std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
+  for (int64_t i = 1; i <= signal_ndim; i++) {
+    mkl_istrides[i] = params.istrides_[i - 1];
+    mkl_ostrides[i] = params.ostrides_[i - 1];
+  }
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
+  // if conjugate domain of real is involved, set standard CCE storage type
+  // this will become default in MKL in future
+  if (!params.complex_input_ || !params.complex_output_) {
+    MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
+  }
+  // rescale if needed by normalized flag or inverse transform
+  if (params.normalized_ || params.inverse_) {
+    auto signal_numel = at::prod_intlist(IntArrayRef(params.signal_sizes_, signal_ndim));
+    double double_scale;
+    if (params.normalized_) {
+      double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+    } else {
+      double_scale = 1.0 / static_cast<double>(signal_numel);
+    }
+    MKL_DFTI_CHECK(DftiSetValue(descriptor->get(),
+      params.inverse_ ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
+      prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
+  }
+  // threads one execution of the plan may use
+  MKL_DFTI_CHECK(DftiSetValue(descriptor->get(), DFTI_THREAD_LIMIT, static_cast<MKL_LONG>(params.num_threads_)));
+  // finalize
+  MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor->get()));
+  return descriptor;
+}
+
 // MKL DFTI
 Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
                 bool complex_input, bool complex_output,
@@ -195,74 +264,44 @@ Tensor _fft_mkl(const Tensor& self, int64_t signal_ndim,
   Tensor output = at::empty(output_sizes, input.options());
 
   // precision
-  DFTI_CONFIG_VALUE prec;
-  if (input.scalar_type() == ScalarType::Float) {
-    prec = DFTI_SINGLE;
-  } else if (input.scalar_type() == ScalarType::Double) {
-    prec = DFTI_DOUBLE;
-  } else {
+  if (input.scalar_type() != ScalarType::Float && input.scalar_type() != ScalarType::Double) {
     std::ostringstream ss;
     ss << "MKL FFT doesn't support tensor of type: "
        << toString(input.scalar_type());
     AT_ERROR(ss.str());
   }
-  // signal type
-  DFTI_CONFIG_VALUE signal_type;
-  if (!inverse) {
-    signal_type = complex_input ? DFTI_COMPLEX : DFTI_REAL;
-  } else {
-    signal_type = complex_output ? DFTI_COMPLEX : DFTI_REAL;
-  }
-  // create descriptor with signal size
-  std::vector<MKL_LONG> mkl_signal_sizes(checked_signal_sizes.begin(), checked_signal_sizes.end());
-  DftiDescriptor descriptor;
-  descriptor.init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
-  // out of place FFT
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_PLACEMENT, DFTI_NOT_INPLACE));
-  // batch mode
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_NUMBER_OF_TRANSFORMS, batch));
 
-  auto istrides = input.strides();
-  auto ostrides = output.strides();
-  // batch dim stride, i.e., dist between each data
-  MKL_LONG idist = complex_input ? istrides[0] >> 1 : istrides[0];
-  MKL_LONG odist = complex_output ? ostrides[0] >> 1 : ostrides[0];
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_DISTANCE, idist));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_DISTANCE, odist));
-  // signal strides
-  // first val is offset, set to zero (ignored)
-  std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
-  for (int64_t i = 1; i <= signal_ndim; i++) {
-    mkl_istrides[i] = complex_input ? istrides[i] >> 1 : istrides[i];
-    mkl_ostrides[i] = complex_output ? ostrides[i] >> 1 : ostrides[i];
-  }
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_INPUT_STRIDES, mkl_istrides.data()));
-  MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
-  // if conjugate domain of real is involved, set standard CCE storage type
-  // this will become default in MKL in future
-  if (!complex_input || !complex_output) {
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(), DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
-  }
-  // rescale if needed by normalized flag or inverse transform
-  if (normalized || inverse) {
-    auto signal_numel = at::prod_intlist(checked_signal_sizes);
-    double double_scale;
-    if (normalized) {
-      double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
-    } else {
-      double_scale = 1.0 / static_cast<double>(signal_numel);
+  // Let MKL use the intra-op threads only for transforms that are worth
+  // splitting, and never from within a parallel region.
+  int64_t work = batch * at::prod_intlist(checked_signal_sizes);
+  int64_t num_threads = (work < internal::GRAIN_SIZE || at::in_parallel_region())
+      ? 1 : static_cast<int64_t>(at::get_num_threads());
+
+  detail::MklFFTParams params;
+  detail::setMklFFTParams(&params, input, output, signal_ndim, complex_input,
+      complex_output, inverse, checked_signal_sizes, normalized, num_threads);
+
+  // Committed descriptors are reused through the plan cache, as creating and
+  // committing one can cost more than a small transform itself.
+  auto& plan_cache = detail::mkl_fft_get_plan_cache();
+  std::shared_ptr<DftiDescriptor> descriptor;
+  {
+    std::lock_guard<std::mutex> guard(plan_cache.mutex);
+    if (plan_cache.max_size() > 0) {
+      descriptor = plan_cache.lookup(params);
     }
-    MKL_DFTI_CHECK(DftiSetValue(descriptor.get(),
-      inverse ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
-      prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
   }
-  // finalize
-  MKL_DFTI_CHECK(DftiCommitDescriptor(descriptor.get()));
+  if (!descriptor) {
+    descriptor = _mkl_fft_plan(params);
+    std::lock_guard<std::mutex> guard(plan_cache.mutex);
+    plan_cache.insert(params, descriptor);
+  }
+
   // run
   if (!inverse) {
-    MKL_DFTI_CHECK(DftiComputeForward(descriptor.get(), input.data_ptr(), output.data_ptr()));
+    MKL_DFTI_CHECK(DftiComputeForward(descriptor->get(), input.data_ptr(), output.data_ptr()));
   } else {
-    MKL_DFTI_CHECK(DftiComputeBackward(descriptor.get(), input.data_ptr(), output.data_ptr()));
+    MKL_DFTI_CHECK(DftiComputeBackward(descriptor->get(), input.data_ptr(), output.data_ptr()));
   }
   // now if needed, fill out the other half using Hermitian symmetry dim
   if (!complex_input && complex_output && !onesided) {
@@ -126,11 +126,19 @@ at::Tensor mkldnn_convolution(
     IntArrayRef stride,
     IntArrayRef dilation,
     int64_t groups) {
-  const ideep::tensor mkldnn_input = get_mkldnn_tensor(input);
-  const ideep::tensor mkldnn_weight = get_mkldnn_tensor(weight);
+  // views of dense tensors ignore strides, so those have to be contiguous
+  auto contiguous = [](const at::Tensor& t) {
+    return t.is_mkldnn() ? t : t.contiguous();
+  };
+  const at::Tensor input_contig = contiguous(input);
+  const at::Tensor weight_contig = contiguous(weight);
+  const ideep::tensor mkldnn_input = get_mkldnn_tensor(input_contig);
+  const ideep::tensor mkldnn_weight = get_mkldnn_tensor(weight_contig);
+  at::Tensor bias_contig;
   c10::optional<ideep::tensor> mkldnn_bias{c10::nullopt};
   if (bias.defined()) {
-    mkldnn_bias = get_mkldnn_tensor(bias);
+    bias_contig = contiguous(bias);
+    mkldnn_bias = get_mkldnn_tensor(bias_contig);
   }
 
   ideep::tensor mkldnn_output = _mkldnn_conv2d(
@@ -12,22 +12,67 @@ Tensor quantize_linear_cpu(const Tensor& self, double scale, int64_t zero_point)
   return quantizer->quantize(self);
 }
 
+Tensor quantize_linear_per_channel_cpu(
+    const Tensor& self,
+    const Tensor& scales,
+    const Tensor& zero_points,
+    IntArrayRef axis) {
+  auto quantizer = make_per_channel_affine_quantizer(scales, zero_points, axis);
+  return quantizer->quantize(self);
+}
+
 Tensor dequantize_quant(const Tensor& self) {
   return get_qtensorimpl(self)->quantizer()->dequantize(self);
 }
 
 Scalar q_scale_quant(const Tensor& self) {
   auto quantizer = get_qtensorimpl(self)->quantizer();
-  AT_ASSERT(quantizer->qscheme() == kPerTensorAffine);
+  AT_CHECK(
+      quantizer->qscheme() == kPerTensorAffine,
+      "q_scale is only defined for per tensor affine quantization, but got ",
+      toString(quantizer->qscheme()));
   return Scalar(static_cast<PerTensorAffineQuantizer*>(quantizer.get())->scale());
 }
 
 Scalar q_zero_point_quant(const Tensor& self) {
   auto quantizer = get_qtensorimpl(self)->quantizer();
-  AT_ASSERT(quantizer->qscheme() == kPerTensorAffine);
+  AT_CHECK(
+      quantizer->qscheme() == kPerTensorAffine,
+      "q_zero_point is only defined for per tensor affine quantization, but got ",
+      toString(quantizer->qscheme()));
   return Scalar(static_cast<PerTensorAffineQuantizer*>(quantizer.get())->zero_point());
 }
 
+static PerChannelAffineQuantizer* per_channel_quantizer(
+    const char* name,
+    const Tensor& self) {
+  auto* quantizer = get_qtensorimpl(self)->quantizer().get();
+  AT_CHECK(
+      quantizer->qscheme() == kPerChannelAffine,
+      name, " is only defined for per channel affine quantization, but got ",
+      toString(quantizer->qscheme()));
+  return static_cast<PerChannelAffineQuantizer*>(quantizer);
+}
+
+Tensor q_per_channel_scales_quant(const Tensor& self) {
+  auto scales = per_channel_quantizer("q_per_channel_scales", self)->scales();
+  Tensor result = at::empty({static_cast<int64_t>(scales.size())}, self.options().dtype(kDouble));
+  std::copy(scales.begin(), scales.end(), result.data<double>());
+  return result;
+}
+
+Tensor q_per_channel_zero_points_quant(const Tensor& self) {
+  auto zero_points =
+      per_channel_quantizer("q_per_channel_zero_points", self)->zero_points();
+  Tensor result = at::empty({static_cast<int64_t>(zero_points.size())}, self.options().dtype(kLong));
+  std::copy(zero_points.begin(), zero_points.end(), result.data<int64_t>());
+  return result;
+}
+
+int64_t q_scheme_quant(const Tensor& self) {
+  return static_cast<int64_t>(get_qtensorimpl(self)->quantizer()->qscheme());
+}
+
 Quantizer* quantizer(const Tensor& self) {
   return get_qtensorimpl(self)->quantizer().get();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #ifdef USE_FBGEMM
+#include <c10/core/QScheme.h>
 #include "fbgemm/Fbgemm.h"
 #include "fbgemm/QuantUtils.h"
 
@@ -13,11 +14,27 @@
 // of the A rows. The column offsets are needed for the asymmetric quantization
 // (affine quantization) of input matrix.
 // Note that in JIT mode we can think of a way to fuse col_offsets with bias.
+// For per channel affine quantization, w_scale and w_zp hold a value for each
+// output channel, otherwise a single value.
 struct FBGEMM_API PackedFCWeight {
   std::unique_ptr<fbgemm::PackBMatrix<int8_t>> w;
   std::vector<int32_t> col_offsets;
+  std::vector<float> w_scale;
+  std::vector<int32_t> w_zp;
+  c10::QScheme q_scheme;
+};
+
+// The struct for the packed weight matrix of a 2D convolution, prepared by
+// the prepacking step. Like for the fully connected layer, the column offsets
+// include the scalar term B_zero_point * K, where K is the reduction length
+// kernel_h * kernel_w * C / groups. The kernel sizes are kept since they can
+// not be recovered from the packed matrix.
+struct FBGEMM_API PackedConvWeight {
+  std::unique_ptr<fbgemm::PackBMatrix<int8_t>> w;
+  std::vector<int32_t> col_offsets;
+  std::vector<int64_t> kernel;
   float w_scale;
-  int w_zp;
+  int32_t w_zp;
 };
 
 // Convert the weight from uint8 to int8.
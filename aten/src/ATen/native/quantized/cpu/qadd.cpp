@@ -0,0 +1,60 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/Loops.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+
+namespace at { namespace native {
+namespace {
+
+// Adds two per-tensor affine quantized tensors and requantizes the sum with
+// the given parameters, element by element on the integer representation,
+// without materializing the float operands.
+template <bool ReluFused>
+class QAddInt8 final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(at::Tensor qa, at::Tensor qb,
+                    double scale, int64_t zero_point) {
+    AT_CHECK(qa.sizes() == qb.sizes(),
+             "quantized::add operands must be the same size, but got ",
+             qa.sizes(), " and ", qb.sizes());
+    const float a_scale = qa.q_scale().toFloat();
+    const int32_t a_zero_point = qa.q_zero_point().toInt();
+    const float b_scale = qb.q_scale().toFloat();
+    const int32_t b_zero_point = qb.q_zero_point().toInt();
+    const float c_scale = static_cast<float>(scale);
+    const auto c_zero_point = static_cast<uint8_t>(zero_point);
+
+    Tensor qc = at::_empty_affine_quantized(qa.sizes(),
+                                            at::device(kCPU).dtype(kQInt8),
+                                            scale,
+                                            zero_point);
+    auto iter = TensorIterator::binary_op(qc, qa, qb);
+    binary_kernel(*iter, [&](c10::qint8 a, c10::qint8 b) -> c10::qint8 {
+      const float c = (static_cast<int32_t>(a.val_) - a_zero_point) * a_scale +
+          (static_cast<int32_t>(b.val_) - b_zero_point) * b_scale;
+      auto qvalue = quantize_uint8(c_scale, c_zero_point, c);
+      if (ReluFused) {
+        qvalue.val_ = std::max(qvalue.val_, c_zero_point);
+      }
+      return qvalue;
+    });
+    return qc;
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::add(Tensor qa, Tensor qb, float scale, int zero_point)"
+            "-> Tensor qc",
+            c10::kernel<QAddInt8<false>>(),
+            c10::dispatchKey(QuantizedCPUTensorId()))
+        .op("quantized::add_relu(Tensor qa, Tensor qb, float scale, int zero_point)"
+            "-> Tensor qc",
+            c10::kernel<QAddInt8<true>>(),
+            c10::dispatchKey(QuantizedCPUTensorId()));
+}  // namespace
+}}  // namespace at::native
@@ -0,0 +1,99 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+// Concatenates per-tensor affine quantized tensors along `axis` and
+// requantizes them to the given parameters. The inputs are copied block by
+// block on their integer representation; inputs already quantized with the
+// output parameters are copied without requantization.
+class QCat final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      c10::ArrayRef<Tensor> qxs,
+      int64_t axis,
+      double scale,
+      int64_t zero_point) {
+    AT_CHECK(!qxs.empty(), "quantized::cat expects a non-empty list of tensors");
+    const auto& first = qxs[0];
+    axis = maybe_wrap_dim(axis, first.dim());
+
+    std::vector<int64_t> output_size = first.sizes().vec();
+    output_size[axis] = 0;
+    for (const auto& qx : qxs) {
+      AT_CHECK(
+          qx.dim() == first.dim(),
+          "quantized::cat expects tensors with the same number of dimensions");
+      for (int64_t d = 0; d < first.dim(); ++d) {
+        AT_CHECK(
+            d == axis || qx.size(d) == first.size(d),
+            "quantized::cat: sizes of tensors must match except in dimension ",
+            axis, ", but got ", qx.sizes(), " and ", first.sizes());
+      }
+      output_size[axis] += qx.size(axis);
+    }
+
+    Tensor qy = at::_empty_affine_quantized(
+        output_size, at::device(kCPU).dtype(kQInt8), scale, zero_point);
+    int64_t outer = 1;
+    for (int64_t d = 0; d < axis; ++d) {
+      outer *= output_size[d];
+    }
+    const int64_t output_inner = qy.numel() / std::max<int64_t>(outer, 1);
+    auto* y = reinterpret_cast<uint8_t*>(qy.data<c10::qint8>());
+
+    const float y_scale = static_cast<float>(scale);
+    const auto y_zero_point = static_cast<uint8_t>(zero_point);
+    int64_t offset = 0;
+    for (const auto& qx : qxs) {
+      const int64_t inner = outer == 0 ? 0 : qx.numel() / outer;
+      if (inner == 0) {
+        continue;
+      }
+      auto qx_contig = qx.contiguous();
+      const auto* x =
+          reinterpret_cast<const uint8_t*>(qx_contig.data<c10::qint8>());
+      const float x_scale = qx.q_scale().toFloat();
+      const int32_t x_zero_point = qx.q_zero_point().toInt();
+      const bool same_qparams =
+          x_scale == y_scale && x_zero_point == y_zero_point;
+      at::parallel_for(0, outer, 0, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          const uint8_t* src = x + i * inner;
+          uint8_t* dst = y + i * output_inner + offset;
+          if (same_qparams) {
+            std::memcpy(dst, src, inner);
+            continue;
+          }
+          for (int64_t j = 0; j < inner; ++j) {
+            const float value =
+                (static_cast<int32_t>(src[j]) - x_zero_point) * x_scale;
+            dst[j] = quantize_uint8(y_scale, y_zero_point, value).val_;
+          }
+        }
+      });
+      offset += inner;
+    }
+    return qy;
+  }
+};
+
+static auto registry = c10::RegisterOperators().op(
+    "quantized::cat(Tensor[] qx, int axis, float scale, int zero_point)"
+    " -> Tensor",
+    c10::kernel<QCat>(),
+    c10::dispatchKey(QuantizedCPUTensorId()));
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,176 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+template <bool ReluFused>
+class QConvInt8 final : public c10::OperatorKernel {
+ public:
+#ifdef USE_FBGEMM
+  // The activations are in the NHWC layout and so is the output.
+  at::Tensor operator()(
+      at::Tensor act,
+      at::Tensor packed_weight,
+      at::Tensor bias,
+      c10::ArrayRef<int64_t> stride,
+      c10::ArrayRef<int64_t> padding,
+      c10::ArrayRef<int64_t> dilation,
+      int64_t groups,
+      double output_scale,
+      int64_t output_zero_point) {
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        fbgemm::fbgemmSupportedCPU(), "Your CPU does not support FBGEMM.");
+    AT_CHECK(
+        act.dim() == 4,
+        "quantized::fbgemm_conv2d: expected 4-dimensional NHWC activations");
+    AT_CHECK(
+        stride.size() == 2 && padding.size() == 2 && dilation.size() == 2,
+        "quantized::fbgemm_conv2d: expected 2 values for stride, padding and dilation");
+    AT_CHECK(
+        dilation[0] == 1 && dilation[1] == 1,
+        "quantized::fbgemm_conv2d: dilation is not supported yet");
+
+    const int N = act.size(0);
+    const int H = act.size(1);
+    const int W = act.size(2);
+    const int C = act.size(3);
+
+    // Pull out the PackBMatrix and col_offsets instance from the owning tensor.
+    auto& pack_ptr = cpp_custom_type_hack::cast<PackedConvWeight>(packed_weight);
+    auto packB = pack_ptr.w.get();
+    auto& col_offsets = pack_ptr.col_offsets;
+    auto& kernel = pack_ptr.kernel;
+
+    const int K = col_offsets.size();
+    AT_CHECK(
+        C % groups == 0 && K == packB->numCols() * groups,
+        "quantized::fbgemm_conv2d: groups (", groups,
+        ") does not match the packed weight");
+    const int kernel_dim = kernel[0] * kernel[1] * (C / groups);
+    AT_CHECK(
+        kernel_dim == packB->numRows(),
+        "quantized::fbgemm_conv2d: the number of input channels (", C,
+        ") does not match the packed weight");
+    AT_CHECK(
+        bias.dim() == 1 && bias.size(0) == K,
+        "quantized::fbgemm_conv2d: expected an int32 bias of size [", K, "]");
+
+    fbgemm::conv_param_t<> conv_p(
+        N,
+        C,
+        K,
+        {H, W},
+        groups,
+        {static_cast<int>(kernel[0]), static_cast<int>(kernel[1])},
+        {static_cast<int>(stride[0]), static_cast<int>(stride[1])},
+        {static_cast<int>(padding[0]),
+         static_cast<int>(padding[1]),
+         static_cast<int>(padding[0]),
+         static_cast<int>(padding[1])});
+
+    float act_scale_float = act.q_scale().toFloat();
+    int32_t act_zero_point_int32 = act.q_zero_point().toInt();
+
+    float output_multiplier_float = (act_scale_float * pack_ptr.w_scale) /
+        static_cast<float>(output_scale);
+    int32_t output_zero_point_int32 = static_cast<int32_t>(output_zero_point);
+
+    // TODO: contiguous is called for further jit optimizations.
+    auto act_contig = act.contiguous();
+    const auto* act_ptr =
+        reinterpret_cast<uint8_t*>(act_contig.data<c10::qint8>());
+
+    // Unfolds the activation patches on the fly, packing the result into
+    // cache friendly tiles and computing the row offsets needed for the
+    // affine quantization of the weight. Padded elements take the activation
+    // zero point.
+    std::vector<int32_t> row_offset_buf(
+        fbgemm::PackAWithIm2Col<uint8_t>::rowOffsetBufferSize());
+    fbgemm::PackAWithIm2Col<uint8_t> packA(
+        /*conv_param=*/conv_p,
+        /*sdata=*/act_ptr,
+        /*pmat=*/nullptr,
+        /*zero_pt=*/act_zero_point_int32,
+        /*row_offset=*/row_offset_buf.data());
+
+    // This is the end of the pipeline, pass the resulting matrix through.
+    fbgemm::DoNothing<> doNothingObj{};
+
+    auto bias_contig = bias.contiguous();
+
+    fbgemm::ReQuantizeOutput<ReluFused> outputProcObj(
+        /*nextop=*/doNothingObj,
+        /*C_multiplier=*/&output_multiplier_float,
+        /*C_zero_point=*/output_zero_point_int32,
+        /*Aq_zero_point=*/act_zero_point_int32,
+        /*Bq_zero_point=*/&pack_ptr.w_zp,
+        /*row_offsets=*/packA.getRowOffsetBuffer(),
+        /*col_offsets=*/col_offsets.data(),
+        /*bias=*/bias_contig.data<int32_t>(),
+        /*nCol=*/K,
+        /*groups=*/groups);
+
+    // Allocate output Tensor and a buffer for fbgemmPacked to use
+    auto output = _empty_affine_quantized(
+        {N, conv_p.OUT_DIM[0], conv_p.OUT_DIM[1], K},
+        at::device(kCPU).dtype(kQInt8),
+        output_scale,
+        output_zero_point);
+    auto buffer = at::zeros_like(output, output.options().dtype(at::kInt));
+
+    // Do the convolution as a GEMM of the unfolded activations.
+    fbgemm::fbgemmPacked(
+        /*packA=*/packA,
+        /*packB=*/*packB,
+        /*C=*/reinterpret_cast<uint8_t*>(output.data<c10::qint8>()),
+        /*C_buffer=*/buffer.data<int32_t>(),
+        /*ldc=*/K,
+        /*outProcess=*/outputProcObj,
+        /*thread_id=*/0,
+        /*num_threads=*/1);
+
+    return output;
+  }
+#else // USE_FBGEMM
+  at::Tensor operator()(
+      at::Tensor /* act */,
+      at::Tensor /* packed_weight */,
+      at::Tensor /* bias */,
+      c10::ArrayRef<int64_t> /* stride */,
+      c10::ArrayRef<int64_t> /* padding */,
+      c10::ArrayRef<int64_t> /* dilation */,
+      int64_t /* groups */,
+      double /* output_scale */,
+      int64_t /* output_zero_point */) {
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        false, "This PyTorch installation was not built with FBGEMM operators");
+  }
+#endif // USE_FBGEMM
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::fbgemm_conv2d(Tensor X, Tensor W_prepack, Tensor b, int[] stride, int[] padding, int[] dilation, int groups, float Y_scale, int Y_zero_point) -> Tensor Y",
+            c10::kernel<QConvInt8<false>>(),
+            c10::dispatchKey(QuantizedCPUTensorId()))
+        .op("quantized::fbgemm_conv2d_relu(Tensor X, Tensor W_prepack, Tensor b, int[] stride, int[] padding, int[] dilation, int groups, float Y_scale, int Y_zero_point) -> Tensor Y",
+            c10::kernel<QConvInt8<true>>(),
+            c10::dispatchKey(QuantizedCPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
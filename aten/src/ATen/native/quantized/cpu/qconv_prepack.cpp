@@ -0,0 +1,113 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace caffe2 {
+#ifdef USE_FBGEMM
+// Required for cpp_custom_type_hack to work
+CAFFE_KNOWN_TYPE(PackedConvWeight);
+#endif // USE_FBGEMM
+} // namespace caffe2
+
+namespace at {
+namespace native {
+namespace {
+
+class QConvPackWeightInt8 final : public c10::OperatorKernel {
+ public:
+#ifdef USE_FBGEMM
+  // Calculate the column offsets of the K x kernel_dim weight matrix.
+  // As for the fully connected layer, this includes the scalar term
+  // B_zero_point * kernel_dim.
+  void calc_col_offsets_transpose(
+      int kernel_dim,
+      int K,
+      const int8_t* Bint8,
+      int32_t B_zero_point,
+      int32_t* col_offsets) {
+    for (size_t i = 0; i < K; ++i) {
+      int32_t sum = 0;
+      for (size_t j = 0; j < kernel_dim; ++j) {
+        sum += Bint8[i * kernel_dim + j];
+      }
+      col_offsets[i] = sum - B_zero_point * kernel_dim;
+    }
+  }
+
+  // The weight is expected in the KRSC layout, i.e. of size
+  // [K, kernel_h, kernel_w, C / groups], to match the NHWC activations.
+  at::Tensor operator()(at::Tensor weight, int64_t groups) {
+    AT_CHECK(
+        weight.dim() == 4,
+        "quantized::fbgemm_conv_prepack: expected a 4-dimensional weight");
+    AT_CHECK(groups > 0, "quantized::fbgemm_conv_prepack: groups must be positive");
+    const int K = weight.size(0);
+    const int kernel_h = weight.size(1);
+    const int kernel_w = weight.size(2);
+    const int C_per_G = weight.size(3);
+    AT_CHECK(
+        K % groups == 0,
+        "quantized::fbgemm_conv_prepack: the number of output channels (", K,
+        ") is not divisible by groups (", groups, ")");
+    const int K_per_G = K / groups;
+    const int kernel_dim = kernel_h * kernel_w * C_per_G;
+
+    int32_t weight_zero_point_int32 = weight.q_zero_point().toInt() - 128;
+
+    auto weight_contig = weight.contiguous();
+
+    std::vector<int8_t> weight_int8(K * kernel_dim);
+    int8_t* weight_ptr_int8 = weight_int8.data();
+    uint8_t* weight_ptr_uint8 =
+        reinterpret_cast<uint8_t*>(weight_contig.data<c10::qint8>());
+    convert_uint8_int8(kernel_dim, K, weight_ptr_uint8, weight_ptr_int8);
+
+    std::vector<int32_t> col_offsets(K);
+    calc_col_offsets_transpose(
+        /*kernel_dim=*/kernel_dim,
+        /*K=*/K,
+        /*Bint8=*/weight_ptr_int8,
+        /*B_zero_point=*/weight_zero_point_int32,
+        /*col_offsets=*/col_offsets.data());
+
+    // Each group packs a kernel_dim x K_per_G matrix, stored transposed.
+    auto ret_ptr = guts::make_unique<PackedConvWeight>(PackedConvWeight{
+        guts::make_unique<fbgemm::PackBMatrix<int8_t>>(
+            /*trans=*/fbgemm::matrix_op_t::Transpose,
+            /*nRow=*/kernel_dim,
+            /*nCol=*/K_per_G,
+            /*smat=*/weight_ptr_int8,
+            /*ld=*/kernel_dim,
+            /*pmat=*/nullptr, // PackBMatrix manages ownership of pmat
+            /*groups=*/groups),
+        col_offsets,
+        {kernel_h, kernel_w},
+        weight.q_scale().toFloat(),
+        weight_zero_point_int32});
+
+    return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
+  }
+#else // USE_FBGEMM
+  at::Tensor operator()(at::Tensor /* weight */, int64_t /* groups */) {
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+    AT_ASSERTM(
+        false, "This PyTorch installation was not built with FBGEMM operators");
+  }
+#endif // USE_FBGEMM
+};
+
+static auto registry = c10::RegisterOperators().op(
+    "quantized::fbgemm_conv_prepack(Tensor W, int groups) -> Tensor W_prepack",
+    c10::kernel<QConvPackWeightInt8>(),
+    c10::dispatchKey(QuantizedCPUTensorId()));
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,50 @@
+#include <ATen/ATen.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/EmbeddingBag.h>
+
+namespace at {
+namespace native {
+namespace {
+
+// Sums (mode 0) or averages (mode 1) the bags of rows of a weight in the
+// fused rowwise layout produced by quantized::embedding_bag_byte_prepack or
+// quantized::embedding_bag_4bit_prepack, like embedding_bag does for a float
+// weight. Rows are dequantized on the fly by the caffe2 perfkernels.
+template <int64_t BIT_RATE>
+class QEmbeddingBag final : public c10::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor weight,
+      at::Tensor indices,
+      at::Tensor offsets,
+      int64_t mode,
+      c10::optional<at::Tensor> per_sample_weights) {
+    return fused_rowwise_embedding_bag_cpu(
+        BIT_RATE == 8 ? "quantized::embedding_bag_byte"
+                      : "quantized::embedding_bag_4bit",
+        BIT_RATE,
+        weight,
+        indices,
+        offsets,
+        mode,
+        per_sample_weights ? *per_sample_weights : at::Tensor());
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::embedding_bag_byte(Tensor weight, Tensor indices, "
+            "Tensor offsets, int mode=0, Tensor? per_sample_weights=None) "
+            "-> Tensor",
+            c10::kernel<QEmbeddingBag<8>>(),
+            c10::dispatchKey(CPUTensorId()))
+        .op("quantized::embedding_bag_4bit(Tensor weight, Tensor indices, "
+            "Tensor offsets, int mode=0, Tensor? per_sample_weights=None) "
+            "-> Tensor",
+            c10::kernel<QEmbeddingBag<4>>(),
+            c10::dispatchKey(CPUTensorId()));
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,191 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace at {
+namespace native {
+namespace {
+
+// Returns the name of the prepack or unpack operator for `bit_rate` bits.
+const char* embedding_bag_op_name(int64_t bit_rate, bool prepack) {
+  if (bit_rate == 8) {
+    return prepack ? "quantized::embedding_bag_byte_prepack"
+                   : "quantized::embedding_bag_byte_unpack";
+  }
+  return prepack ? "quantized::embedding_bag_4bit_prepack"
+                 : "quantized::embedding_bag_4bit_unpack";
+}
+
+// Quantizes every row of a float `weight` to 2^BIT_RATE steps between its
+// minimum and maximum into the fused rowwise layout read by
+// quantized::embedding_bag_byte and quantized::embedding_bag_4bit. With 8
+// bits, every row holds one byte per value followed by a float scale and
+// bias. This matches caffe2's FloatToFused8BitRowwiseQuantized. With 4 bits,
+// two values are packed to a byte, starting from the least significant bits,
+// followed by an fp16 scale and bias.
+template <int64_t BIT_RATE>
+class QEmbeddingBagPackWeight final : public c10::OperatorKernel {
+ public:
+  at::Tensor operator()(at::Tensor weight) {
+    const char* name = embedding_bag_op_name(BIT_RATE, /*prepack=*/true);
+    AT_CHECK(
+        weight.scalar_type() == kFloat && weight.dim() == 2,
+        name, ": expected a 2-dimensional float weight, but got a ",
+        weight.dim(), "-dimensional ", weight.scalar_type(), " weight");
+    constexpr int64_t values_per_byte = 8 / BIT_RATE;
+    const int64_t rows = weight.size(0);
+    const int64_t dim = weight.size(1);
+    AT_CHECK(
+        dim > 0 && dim % values_per_byte == 0,
+        name, ": the embedding dimension must be a positive multiple of ",
+        values_per_byte, ", but got ", dim);
+    const int64_t packed_dim = dim / values_per_byte;
+    const int64_t scale_bias_bytes = BIT_RATE == 8 ? 8 : 4;
+
+    auto weight_contig = weight.contiguous();
+    auto output = at::empty(
+        {rows, packed_dim + scale_bias_bytes}, weight.options().dtype(kByte));
+    const float* input_data = weight_contig.data<float>();
+    uint8_t* output_data = output.data<uint8_t>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, at::internal::GRAIN_SIZE / dim);
+    at::parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        quantize_row(
+            input_data + row * dim,
+            dim,
+            output_data + row * (packed_dim + scale_bias_bytes));
+      }
+    });
+    return output;
+  }
+
+ private:
+  static void quantize_row(const float* input, int64_t dim, uint8_t* output) {
+    const auto minmax = std::minmax_element(input, input + dim);
+    float minimum = *minmax.first;
+    const float maximum = *minmax.second;
+    if (BIT_RATE == 8) {
+      // Same as caffe2's FloatToFused8BitRowwiseQuantized.
+      constexpr float kEpsilon = 1e-8f;
+      const float range = maximum - minimum;
+      const float scale_bias[2] = {range / 255.0f, minimum};
+      const float inverse_scale = 255.0f / (range + kEpsilon);
+      for (int64_t k = 0; k < dim; ++k) {
+        output[k] = static_cast<uint8_t>(
+            std::round((input[k] - minimum) * inverse_scale));
+      }
+      std::memcpy(output + dim, scale_bias, sizeof(scale_bias));
+      return;
+    }
+    // Quantize relative to the fp16 rounded bias and scale, since those are
+    // what the values are dequantized with.
+    constexpr int64_t max_value = (1 << BIT_RATE) - 1;
+    const at::Half bias = minimum;
+    minimum = bias;
+    float scale = (maximum - minimum) / max_value;
+    at::Half scale_fp16 = scale;
+    scale = scale_fp16;
+    float inverse_scale = 1.0f / scale;
+    if (scale == 0 || std::isinf(inverse_scale)) {
+      // All values are (nearly) the same, so any scale works.
+      scale_fp16 = 1.0f;
+      inverse_scale = 1.0f;
+    }
+    constexpr int64_t values_per_byte = 8 / BIT_RATE;
+    std::memset(output, 0, dim / values_per_byte);
+    for (int64_t k = 0; k < dim; ++k) {
+      const int64_t value = std::min<int64_t>(
+          max_value,
+          std::max<int64_t>(
+              0, std::lrintf((input[k] - minimum) * inverse_scale)));
+      output[k / values_per_byte] |=
+          static_cast<uint8_t>(value << ((k % values_per_byte) * BIT_RATE));
+    }
+    uint8_t* scale_bias = output + dim / values_per_byte;
+    std::memcpy(scale_bias, &scale_fp16, sizeof(at::Half));
+    std::memcpy(scale_bias + sizeof(at::Half), &bias, sizeof(at::Half));
+  }
+};
+
+// Dequantizes a weight in the fused rowwise layout produced by
+// QEmbeddingBagPackWeight back to floats.
+template <int64_t BIT_RATE>
+class QEmbeddingBagUnpackWeight final : public c10::OperatorKernel {
+ public:
+  at::Tensor operator()(at::Tensor packed_weight) {
+    const char* name = embedding_bag_op_name(BIT_RATE, /*prepack=*/false);
+    const int64_t scale_bias_bytes = BIT_RATE == 8 ? 8 : 4;
+    AT_CHECK(
+        packed_weight.scalar_type() == kByte && packed_weight.dim() == 2 &&
+            packed_weight.size(1) > scale_bias_bytes,
+        name, ": expected a 2-dimensional uint8 weight with more than ",
+        scale_bias_bytes, " columns");
+    constexpr int64_t values_per_byte = 8 / BIT_RATE;
+    const int64_t rows = packed_weight.size(0);
+    const int64_t packed_dim = packed_weight.size(1) - scale_bias_bytes;
+    const int64_t dim = packed_dim * values_per_byte;
+
+    auto packed_contig = packed_weight.contiguous();
+    auto output =
+        at::empty({rows, dim}, packed_weight.options().dtype(kFloat));
+    const uint8_t* input_data = packed_contig.data<uint8_t>();
+    float* output_data = output.data<float>();
+    const int64_t grain_size =
+        std::max<int64_t>(1, at::internal::GRAIN_SIZE / dim);
+    at::parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        const uint8_t* input =
+            input_data + row * (packed_dim + scale_bias_bytes);
+        float* out = output_data + row * dim;
+        float scale, bias;
+        if (BIT_RATE == 8) {
+          std::memcpy(&scale, input + packed_dim, sizeof(float));
+          std::memcpy(
+              &bias, input + packed_dim + sizeof(float), sizeof(float));
+        } else {
+          at::Half scale_fp16, bias_fp16;
+          std::memcpy(&scale_fp16, input + packed_dim, sizeof(at::Half));
+          std::memcpy(
+              &bias_fp16,
+              input + packed_dim + sizeof(at::Half),
+              sizeof(at::Half));
+          scale = scale_fp16;
+          bias = bias_fp16;
+        }
+        for (int64_t k = 0; k < dim; ++k) {
+          const int64_t value =
+              (input[k / values_per_byte] >>
+               ((k % values_per_byte) * BIT_RATE)) &
+              ((1 << BIT_RATE) - 1);
+          out[k] = scale * value + bias;
+        }
+      }
+    });
+    return output;
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::embedding_bag_byte_prepack(Tensor weight) -> Tensor",
+            c10::kernel<QEmbeddingBagPackWeight<8>>(),
+            c10::dispatchKey(CPUTensorId()))
+        .op("quantized::embedding_bag_byte_unpack(Tensor weight) -> Tensor",
+            c10::kernel<QEmbeddingBagUnpackWeight<8>>(),
+            c10::dispatchKey(CPUTensorId()))
+        .op("quantized::embedding_bag_4bit_prepack(Tensor weight) -> Tensor",
+            c10::kernel<QEmbeddingBagPackWeight<4>>(),
+            c10::dispatchKey(CPUTensorId()))
+        .op("quantized::embedding_bag_4bit_unpack(Tensor weight) -> Tensor",
+            c10::kernel<QEmbeddingBagUnpackWeight<4>>(),
+            c10::dispatchKey(CPUTensorId()));
+
+} // namespace
+} // namespace native
+} // namespace at
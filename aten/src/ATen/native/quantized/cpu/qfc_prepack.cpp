@@ -2,7 +2,9 @@
 #include <ATen/core/Type.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
+#include <ATen/WrapDimUtils.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/quantized/QTensorImpl.h>
 #include <ATen/quantized/Quantizer.h>
 
 #include <algorithm>
@@ -26,18 +28,20 @@ class QFCPackWeightInt8 final : public c10::OperatorKernel {
   // Note this includes the sum of the columns as well as the scalar term
   // B_zero_point * K, whereas the row_offsets created by
   // PackAWithQuantRowOffset is only the sum of the A rows.
+  // B_zero_point holds either a single zero point or one per column.
   void calc_col_offsets_transpose(
       int K,
       int N,
       const int8_t* Bint8,
-      int32_t B_zero_point,
+      const std::vector<int32_t>& B_zero_point,
       int32_t* col_offsets) {
     for (size_t i = 0; i < N; ++i) {
       int32_t sum = 0;
       for (size_t j = 0; j < K; ++j) {
         sum += Bint8[i * K + j];
       }
-      col_offsets[i] = sum - B_zero_point * K;
+      col_offsets[i] =
+          sum - B_zero_point[B_zero_point.size() == 1 ? 0 : i] * K;
     }
   }
 
@@ -45,7 +49,31 @@ class QFCPackWeightInt8 final : public c10::OperatorKernel {
     auto N = weight.size(0);
     auto K = weight.size(1);
 
-    int32_t weight_zero_point_int32 = weight.q_zero_point().toInt() - 128;
+    // The int8 zero points are shifted by 128 from the uint8 ones.
+    auto* quantizer = get_qtensorimpl(weight)->quantizer().get();
+    const auto qscheme = quantizer->qscheme();
+    std::vector<float> weight_scales;
+    std::vector<int32_t> weight_zero_points_int32;
+    if (qscheme == kPerTensorAffine) {
+      weight_scales.push_back(weight.q_scale().toFloat());
+      weight_zero_points_int32.push_back(weight.q_zero_point().toInt() - 128);
+    } else if (qscheme == kPerChannelAffine) {
+      auto* per_channel =
+          static_cast<PerChannelAffineQuantizer*>(quantizer);
+      AT_CHECK(
+          maybe_wrap_dim(per_channel->axis()[0], weight.dim()) == 0,
+          "quantized::fbgemm_linear_prepack: the weight must be quantized per "
+          "output channel (axis 0)");
+      weight_scales = per_channel->scales();
+      for (auto zero_point : per_channel->zero_points()) {
+        weight_zero_points_int32.push_back(
+            static_cast<int32_t>(zero_point) - 128);
+      }
+    } else {
+      AT_ERROR(
+          "quantized::fbgemm_linear_prepack: unsupported quantization scheme ",
+          toString(qscheme));
+    }
 
     // TODO: contiguous is called for further JIT optimizations.
     auto weight_contig = weight.contiguous();
@@ -61,7 +89,7 @@ class QFCPackWeightInt8 final : public c10::OperatorKernel {
         /*K=*/K,
         /*N=*/N,
         /*Bint8=*/weight_ptr_int8,
-        /*B_zero_point=*/weight_zero_point_int32,
+        /*B_zero_point=*/weight_zero_points_int32,
         /*col_offsets=*/col_offsets.data());
 
     auto ret_ptr = guts::make_unique<PackedFCWeight>(PackedFCWeight{
@@ -74,8 +102,9 @@ class QFCPackWeightInt8 final : public c10::OperatorKernel {
             /*pmat=*/nullptr, // PackBMatrix manages ownership of pmat
             /*groups=*/1),
         col_offsets,
-        weight.q_scale().toFloat(),
-        weight_zero_point_int32});
+        weight_scales,
+        weight_zero_points_int32,
+        qscheme});
 
     // TODO: we will need to replace this with torchscript classes at a later
     // point.
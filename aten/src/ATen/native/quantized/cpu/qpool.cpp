@@ -0,0 +1,204 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/Type.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+// The geometry of a 2D pooling window over NHWC activations. The channels are
+// innermost, so every window position reads and writes C contiguous values.
+struct Pool2dParams {
+  int64_t nbatch, iH, iW, C;
+  int64_t oH, oW;
+  int64_t kH, kW;
+  int64_t sH, sW;
+  int64_t pH, pW;
+  int64_t dH, dW;
+};
+
+Pool2dParams pool2d_params(
+    const char* name,
+    const Tensor& qx,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  AT_CHECK(
+      qx.dim() == 4, name, ": expected 4-dimensional NHWC input, but got ",
+      qx.dim(), " dimensions");
+  // an empty stride defaults to the kernel size, as in the float operators
+  if (stride.empty()) {
+    stride = kernel_size;
+  }
+  AT_CHECK(
+      kernel_size.size() == 2 && stride.size() == 2 && padding.size() == 2 &&
+          dilation.size() == 2,
+      name, ": expected 2 values for kernel_size, stride, padding and dilation");
+  Pool2dParams p;
+  p.nbatch = qx.size(0);
+  p.iH = qx.size(1);
+  p.iW = qx.size(2);
+  p.C = qx.size(3);
+  p.kH = kernel_size[0];
+  p.kW = kernel_size[1];
+  p.sH = stride[0];
+  p.sW = stride[1];
+  p.pH = padding[0];
+  p.pW = padding[1];
+  p.dH = dilation[0];
+  p.dW = dilation[1];
+  AT_CHECK(
+      p.kH > 0 && p.kW > 0 && p.sH > 0 && p.sW > 0 && p.dH > 0 && p.dW > 0,
+      name, ": kernel_size, stride and dilation must be positive");
+  AT_CHECK(
+      p.pH >= 0 && p.pW >= 0 && p.pH <= p.kH / 2 && p.pW <= p.kW / 2,
+      name, ": padding must be non-negative and at most half the kernel size");
+  p.oH = (p.iH + 2 * p.pH - p.dH * (p.kH - 1) - 1) / p.sH + 1;
+  p.oW = (p.iW + 2 * p.pW - p.dW * (p.kW - 1) - 1) / p.sW + 1;
+  AT_CHECK(
+      p.oH > 0 && p.oW > 0, name, ": input of size ", qx.sizes(),
+      " is too small for the pooling window");
+  return p;
+}
+
+class QMaxPool2D final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor qx,
+      c10::ArrayRef<int64_t> kernel_size,
+      c10::ArrayRef<int64_t> stride,
+      c10::ArrayRef<int64_t> padding,
+      c10::ArrayRef<int64_t> dilation) {
+    const auto p = pool2d_params(
+        "quantized::max_pool2d", qx, kernel_size, stride, padding, dilation);
+    // The maximum commutes with the monotonic quantization, so the output
+    // keeps the quantization parameters of the input.
+    Tensor qy = at::_empty_affine_quantized(
+        {p.nbatch, p.oH, p.oW, p.C},
+        at::device(kCPU).dtype(kQInt8),
+        qx.q_scale().toDouble(),
+        qx.q_zero_point().toLong());
+    auto qx_contig = qx.contiguous();
+    const auto* x =
+        reinterpret_cast<const uint8_t*>(qx_contig.data<c10::qint8>());
+    auto* y = reinterpret_cast<uint8_t*>(qy.data<c10::qint8>());
+
+    at::parallel_for(0, p.nbatch * p.oH, 0, [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; ++row) {
+        const int64_t n = row / p.oH;
+        const int64_t oh = row % p.oH;
+        for (int64_t ow = 0; ow < p.oW; ++ow) {
+          uint8_t* out = y + (row * p.oW + ow) * p.C;
+          std::fill(out, out + p.C, std::numeric_limits<uint8_t>::min());
+          for (int64_t kh = 0; kh < p.kH; ++kh) {
+            const int64_t ih = oh * p.sH - p.pH + kh * p.dH;
+            if (ih < 0 || ih >= p.iH) {
+              continue;
+            }
+            for (int64_t kw = 0; kw < p.kW; ++kw) {
+              const int64_t iw = ow * p.sW - p.pW + kw * p.dW;
+              if (iw < 0 || iw >= p.iW) {
+                continue;
+              }
+              const uint8_t* in = x + ((n * p.iH + ih) * p.iW + iw) * p.C;
+              for (int64_t c = 0; c < p.C; ++c) {
+                out[c] = std::max(out[c], in[c]);
+              }
+            }
+          }
+        }
+      }
+    });
+    return qy;
+  }
+};
+
+class QAvgPool2D final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor qx,
+      c10::ArrayRef<int64_t> kernel_size,
+      c10::ArrayRef<int64_t> stride,
+      c10::ArrayRef<int64_t> padding,
+      bool count_include_pad) {
+    const std::vector<int64_t> dilation{1, 1};
+    const auto p = pool2d_params(
+        "quantized::avg_pool2d", qx, kernel_size, stride, padding, dilation);
+    const int32_t zero_point = qx.q_zero_point().toInt();
+    Tensor qy = at::_empty_affine_quantized(
+        {p.nbatch, p.oH, p.oW, p.C},
+        at::device(kCPU).dtype(kQInt8),
+        qx.q_scale().toDouble(),
+        zero_point);
+    auto qx_contig = qx.contiguous();
+    const auto* x =
+        reinterpret_cast<const uint8_t*>(qx_contig.data<c10::qint8>());
+    auto* y = reinterpret_cast<uint8_t*>(qy.data<c10::qint8>());
+
+    at::parallel_for(0, p.nbatch * p.oH, 0, [&](int64_t begin, int64_t end) {
+      // With the scale shared by input and output, the average is taken
+      // over the values relative to the zero point; padded elements are
+      // zeros and so contribute nothing but a count.
+      std::vector<int32_t> acc(p.C);
+      for (int64_t row = begin; row < end; ++row) {
+        const int64_t n = row / p.oH;
+        const int64_t oh = row % p.oH;
+        const int64_t hstart = oh * p.sH - p.pH;
+        const int64_t hend = std::min(hstart + p.kH, p.iH + p.pH);
+        for (int64_t ow = 0; ow < p.oW; ++ow) {
+          const int64_t wstart = ow * p.sW - p.pW;
+          const int64_t wend = std::min(wstart + p.kW, p.iW + p.pW);
+          int64_t divisor = (hend - hstart) * (wend - wstart);
+          const int64_t ih0 = std::max<int64_t>(hstart, 0);
+          const int64_t ih1 = std::min(hend, p.iH);
+          const int64_t iw0 = std::max<int64_t>(wstart, 0);
+          const int64_t iw1 = std::min(wend, p.iW);
+          if (!count_include_pad) {
+            divisor = (ih1 - ih0) * (iw1 - iw0);
+          }
+
+          std::fill(acc.begin(), acc.end(), 0);
+          for (int64_t ih = ih0; ih < ih1; ++ih) {
+            for (int64_t iw = iw0; iw < iw1; ++iw) {
+              const uint8_t* in = x + ((n * p.iH + ih) * p.iW + iw) * p.C;
+              for (int64_t c = 0; c < p.C; ++c) {
+                acc[c] += in[c] - zero_point;
+              }
+            }
+          }
+          uint8_t* out = y + (row * p.oW + ow) * p.C;
+          for (int64_t c = 0; c < p.C; ++c) {
+            const int32_t qvalue = static_cast<int32_t>(
+                std::nearbyint(static_cast<float>(acc[c]) / divisor)) +
+                zero_point;
+            out[c] = static_cast<uint8_t>(std::min<int32_t>(
+                std::max<int32_t>(qvalue, std::numeric_limits<uint8_t>::min()),
+                std::numeric_limits<uint8_t>::max()));
+          }
+        }
+      }
+    });
+    return qy;
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::max_pool2d(Tensor qx, int[] kernel_size, int[] stride, int[] padding, int[] dilation) -> Tensor",
+            c10::kernel<QMaxPool2D>(),
+            c10::dispatchKey(QuantizedCPUTensorId()))
+        .op("quantized::avg_pool2d(Tensor qx, int[] kernel_size, int[] stride, int[] padding, bool count_include_pad) -> Tensor",
+            c10::kernel<QAvgPool2D>(),
+            c10::dispatchKey(QuantizedCPUTensorId()));
+
+} // namespace
+} // namespace native
+} // namespace at
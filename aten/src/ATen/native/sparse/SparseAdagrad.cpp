@@ -0,0 +1,161 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <caffe2/perfkernels/adagrad.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+// How many unique rows ahead of the current one to prefetch, as in caffe2's
+// sparse_adagrad.
+constexpr int64_t kPrefetchDistance = 16;
+} // namespace
+
+// Applies an Adagrad step to the rows of `self` touched by the sparse `grad`,
+// without coalescing or densifying the gradient first. Duplicate indices are
+// grouped by sorting a permutation of the nonzeros, and their gradient rows are
+// summed into a per-thread buffer before the single update of their row.
+// state_sum is updated in place too, as its Tensor(b!) annotation says. Like
+// the other written arguments that are not the first, it is passed as a const
+// reference.
+//
+// If `state_sum` has the size of `self`, this is element-wise Adagrad:
+//   state_sum += g * g;  self -= lr * g / (sqrt(state_sum) + eps)
+// If `state_sum` holds one value per row of `self`, this is rowwise Adagrad,
+// which accumulates the mean of the squared gradient over each row:
+//   state_sum[i] += mean(g[i] * g[i])
+//   self[i] -= lr * g[i] / (sqrt(state_sum[i]) + eps)
+Tensor& sparse_adagrad_cpu_(
+    Tensor& self,
+    const Tensor& state_sum,
+    const Tensor& grad,
+    double lr,
+    double eps) {
+  AT_CHECK(
+      self.scalar_type() == kFloat && state_sum.scalar_type() == kFloat,
+      "_sparse_adagrad_: expected float parameter and state_sum, but got ",
+      self.scalar_type(),
+      " and ",
+      state_sum.scalar_type());
+  AT_CHECK(
+      self.is_contiguous() && state_sum.is_contiguous(),
+      "_sparse_adagrad_: expected a contiguous parameter and state_sum");
+  AT_CHECK(
+      self.dim() >= 1,
+      "_sparse_adagrad_: expected a parameter with at least one dimension");
+  AT_CHECK(
+      grad.is_sparse() && grad.sparse_dim() == 1 &&
+          grad.sizes() == self.sizes(),
+      "_sparse_adagrad_: expected a sparse gradient with one sparse dimension "
+      "and the size of the parameter ",
+      self.sizes(),
+      ", but got ",
+      grad.sizes());
+  AT_CHECK(
+      grad.scalar_type() == kFloat,
+      "_sparse_adagrad_: expected a float gradient, but got ",
+      grad.scalar_type());
+
+  const int64_t rows = self.size(0);
+  const bool rowwise = state_sum.sizes() != self.sizes();
+  AT_CHECK(
+      !rowwise || (state_sum.dim() == 1 && state_sum.size(0) == rows),
+      "_sparse_adagrad_: expected state_sum to have the size of the parameter ",
+      self.sizes(),
+      ", or one value per row, but got ",
+      state_sum.sizes());
+
+  const auto indices = grad._indices().select(0, 0).contiguous();
+  const auto values = grad._values().contiguous();
+  const int64_t nnz = indices.numel();
+  if (nnz == 0 || self.numel() == 0) {
+    return self;
+  }
+  const int64_t block_size = self.numel() / rows;
+  AT_CHECK(
+      block_size <= std::numeric_limits<int>::max(),
+      "_sparse_adagrad_: rows of ",
+      block_size,
+      " elements are not supported");
+
+  const int64_t* index_data = indices.data<int64_t>();
+  for (int64_t i = 0; i < nnz; ++i) {
+    AT_CHECK(
+        index_data[i] >= 0 && index_data[i] < rows,
+        "_sparse_adagrad_: index ",
+        index_data[i],
+        " is out of bounds for a parameter with ",
+        rows,
+        " rows");
+  }
+
+  // Group the nonzeros by row. The sort is stable so that duplicates are
+  // always summed in the same order.
+  std::vector<int64_t> order(nnz);
+  std::iota(order.begin(), order.end(), 0);
+  if (!grad.is_coalesced()) {
+    std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+      return index_data[a] < index_data[b];
+    });
+  }
+  std::vector<int64_t> segment_starts;
+  for (int64_t i = 0; i < nnz; ++i) {
+    if (i == 0 || index_data[order[i]] != index_data[order[i - 1]]) {
+      segment_starts.push_back(i);
+    }
+  }
+  const int64_t segments = segment_starts.size();
+  segment_starts.push_back(nnz);
+
+  const float* value_data = values.data<float>();
+  float* weight_data = self.data<float>();
+  float* state_data = state_sum.data<float>();
+  const int64_t state_block_size = rowwise ? 1 : block_size;
+  const float step = -static_cast<float>(lr);
+  const float epsilon = static_cast<float>(eps);
+
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / block_size);
+  at::parallel_for(0, segments, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<float> buffer(block_size);
+    for (int64_t s = begin; s < end; ++s) {
+      const int64_t first = segment_starts[s];
+      const int64_t last = segment_starts[s + 1];
+      const float* g = value_data + order[first] * block_size;
+      if (last - first > 1) {
+        std::copy(g, g + block_size, buffer.begin());
+        for (int64_t k = first + 1; k < last; ++k) {
+          const float* gk = value_data + order[k] * block_size;
+          for (int64_t j = 0; j < block_size; ++j) {
+            buffer[j] += gk[j];
+          }
+        }
+        g = buffer.data();
+      }
+
+      const int64_t row = index_data[order[first]];
+      const int64_t row_pref = index_data
+          [order[segment_starts[std::min(s + kPrefetchDistance, end - 1)]]];
+      float* w = weight_data + row * block_size;
+      float* w_n = weight_data + row_pref * block_size;
+      float* h = state_data + row * state_block_size;
+      float* h_n = state_data + row_pref * state_block_size;
+      if (rowwise) {
+        caffe2::rowwise_adagrad_update(
+            block_size, w, w_n, g, h, h_n, epsilon, step);
+      } else {
+        caffe2::adagrad_update_prefetch(
+            block_size, w, w_n, g, h, h_n, w, w_n, h, h_n, epsilon, step);
+      }
+    }
+  });
+  return self;
+}
+
+}} // namespace at::native
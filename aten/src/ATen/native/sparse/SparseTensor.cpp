@@ -10,6 +10,10 @@
 
 #include <TH/THBlasUtils.h>
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 namespace at { namespace native {
 
 using namespace at::sparse;
@@ -108,8 +112,11 @@ SparseTensor new_with_dims_and_tensor_sparse(
 /** Public creation API that dispatch to methods above **/
 
 /** Empty init **/
-Tensor empty_sparse(IntArrayRef size, const TensorOptions& options) {
+Tensor empty_sparse(IntArrayRef size, const TensorOptions& options, c10::optional<MemoryFormat> optional_memory_format) {
   AT_CHECK(!options.pinned_memory(), "Only dense CPU tensors can be pinned");
+  AT_CHECK(
+      !optional_memory_format.has_value(),
+      "memory format is not supported by sparse tensors");
   return new_with_dims_sparse(size.size(), 0, size, options);
 }
 
@@ -336,6 +343,87 @@ SparseTensor& copy_sparse_(SparseTensor& self, const SparseTensor& src, bool non
   return self._coalesced_(src.is_coalesced());
 }
 
+namespace {
+
+// The least significant digit radix sort of coalesce sorts the indices by
+// digits of this many bits.
+constexpr int kCoalesceRadixBits = 8;
+constexpr int64_t kCoalesceRadix = 1 << kCoalesceRadixBits;
+// The sort is split into chunks of at least this many indices, one per thread.
+constexpr int64_t kCoalesceMinChunk = 16384;
+
+// The chunks of [0, n) that the threads sort, histogram and reduce.
+struct CoalesceChunks {
+  explicit CoalesceChunks(int64_t n)
+      : n(n),
+        count(std::max<int64_t>(1, std::min<int64_t>(
+            at::get_num_threads(), n / kCoalesceMinChunk))),
+        size((n + count - 1) / count) {}
+
+  int64_t begin(int64_t chunk) const {
+    return std::min(n, chunk * size);
+  }
+  int64_t end(int64_t chunk) const {
+    return std::min(n, (chunk + 1) * size);
+  }
+
+  const int64_t n;
+  const int64_t count;
+  const int64_t size;
+};
+
+// Sorts the n keys, which are below 2^bits, along with perm. The sort is
+// stable, so indices with the same key keep their order.
+void coalesce_radix_sort(int64_t* keys, int64_t* perm, int64_t n, int bits) {
+  const CoalesceChunks chunks(n);
+  std::vector<int64_t> keys_buffer(n);
+  std::vector<int64_t> perm_buffer(n);
+  int64_t* keys_in = keys;
+  int64_t* perm_in = perm;
+  int64_t* keys_out = keys_buffer.data();
+  int64_t* perm_out = perm_buffer.data();
+  std::vector<int64_t> offsets(chunks.count * kCoalesceRadix);
+  for (int shift = 0; shift < bits; shift += kCoalesceRadixBits) {
+    // Count the digits of every chunk, then turn the counts into where each
+    // chunk writes the keys of each digit.
+    std::fill(offsets.begin(), offsets.end(), 0);
+    at::parallel_for(0, chunks.count, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* count = offsets.data() + c * kCoalesceRadix;
+        for (int64_t i = chunks.begin(c); i < chunks.end(c); i++) {
+          count[(keys_in[i] >> shift) & (kCoalesceRadix - 1)]++;
+        }
+      }
+    });
+    int64_t total = 0;
+    for (int64_t digit = 0; digit < kCoalesceRadix; digit++) {
+      for (int64_t c = 0; c < chunks.count; c++) {
+        const int64_t count = offsets[c * kCoalesceRadix + digit];
+        offsets[c * kCoalesceRadix + digit] = total;
+        total += count;
+      }
+    }
+    at::parallel_for(0, chunks.count, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* offset = offsets.data() + c * kCoalesceRadix;
+        for (int64_t i = chunks.begin(c); i < chunks.end(c); i++) {
+          const int64_t j = offset[(keys_in[i] >> shift) & (kCoalesceRadix - 1)]++;
+          keys_out[j] = keys_in[i];
+          perm_out[j] = perm_in[i];
+        }
+      }
+    });
+    std::swap(keys_in, keys_out);
+    std::swap(perm_in, perm_out);
+  }
+  if (keys_in != keys) {
+    std::copy(keys_in, keys_in + n, keys);
+    std::copy(perm_in, perm_in + n, perm);
+  }
+}
+
+} // namespace
+
 SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   AT_ASSERT(self.defined());
   AT_ASSERT(!self.is_variable());  // TODO: change this to check `.requires_grad()` and `GradMode::is_enabled()` when Variable and Tensor are merged
@@ -358,7 +446,34 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   int64_t dense_dim = self.dense_dim();
   int64_t nnz = self._nnz();
 
-  LongTensor indices_scalar = flatten_indices(indices, self.sizes());
+  // The flattened indices are sorted in place.
+  LongTensor indices_scalar = flatten_indices(indices, self.sizes(), /*force_clone=*/true);
+  int64_t* keys = indices_scalar.data<int64_t>();
+
+  // Check whether the indices are sorted, and find the largest one to skip
+  // the radix sort passes of its leading zero digits.
+  const CoalesceChunks chunks(nnz);
+  std::vector<uint8_t> chunk_sorted(chunks.count, 1);
+  std::vector<uint8_t> chunk_unique(chunks.count, 1);
+  std::vector<int64_t> chunk_max(chunks.count, 0);
+  at::parallel_for(0, chunks.count, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t max = keys[chunks.begin(c)];
+      for (int64_t i = std::max<int64_t>(chunks.begin(c), 1); i < chunks.end(c); i++) {
+        chunk_sorted[c] &= keys[i - 1] <= keys[i];
+        chunk_unique[c] &= keys[i - 1] != keys[i];
+        max = std::max(max, keys[i]);
+      }
+      chunk_max[c] = max;
+    }
+  });
+  const bool sorted = std::all_of(chunk_sorted.begin(), chunk_sorted.end(), [](uint8_t b) { return b; });
+  const bool unique = std::all_of(chunk_unique.begin(), chunk_unique.end(), [](uint8_t b) { return b; });
+  if (sorted && unique) {
+    SparseTensor dst = self.clone();
+    dst._coalesced_(true);
+    return dst;
+  }
 
   SparseTensor dst = new_sparse(self.options());
   get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
@@ -367,44 +482,82 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   Tensor newValues = at::empty(values.sizes(), values.options());
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
-  // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
+  LongTensor indicesPermutation = at::arange(nnz, indices.options());
+  int64_t* perm = indicesPermutation.data<int64_t>();
+  if (!sorted) {
+    const uint64_t max = *std::max_element(chunk_max.begin(), chunk_max.end());
+    int bits = 0;
+    while (bits < 64 && (max >> bits) != 0) {
+      bits++;
+    }
+    coalesce_radix_sort(keys, perm, nnz, bits);
+  }
+
+  // Find where the runs of equal indices start, in parallel over the chunks.
+  std::vector<int64_t> chunk_runs(chunks.count + 1, 0);
+  at::parallel_for(0, chunks.count, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t runs = 0;
+      for (int64_t i = chunks.begin(c); i < chunks.end(c); i++) {
+        runs += i == 0 || keys[i - 1] != keys[i];
+      }
+      chunk_runs[c + 1] = runs;
+    }
+  });
+  std::partial_sum(chunk_runs.begin(), chunk_runs.end(), chunk_runs.begin());
+  const int64_t newNnz = chunk_runs[chunks.count];
+  std::vector<int64_t> run_starts(newNnz + 1);
+  run_starts[newNnz] = nnz;
+  at::parallel_for(0, chunks.count, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      int64_t run = chunk_runs[c];
+      for (int64_t i = chunks.begin(c); i < chunks.end(c); i++) {
+        if (i == 0 || keys[i - 1] != keys[i]) {
+          run_starts[run++] = i;
+        }
+      }
+    }
+  });
+
+  // Sum the values of every run into its first one. The runs are independent,
+  // and their values blocks are summed with BLAS.
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
-
-  int64_t i = -1;
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
         int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data<scalar_t>();
         scalar_t* newValues_ptr = newValues.data<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
+        const bool has_values = values.numel() > 0;  // if values is an empty tensor, there are no elements to copy
+        at::parallel_for(0, newNnz, std::max<int64_t>(1, kCoalesceMinChunk / std::max<int64_t>(blockSize, 1)),
+                         [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            const int64_t first = perm[run_starts[i]];
             for (int64_t d = 0; d < sparse_dim; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
+              newIndicesAccessor[d][i] = indicesAccessor[d][first];
+            }
+            if (!has_values) {
+              continue;
             }
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+            scalar_t* dst_ptr = newValues_ptr + i * blockSize;
+            if (blockSize == 1) {
+              scalar_t sum = values_ptr[first];
+              for (int64_t j = run_starts[i] + 1; j < run_starts[i + 1]; j++) {
+                sum += values_ptr[perm[j]];
+              }
+              *dst_ptr = sum;
+              continue;
+            }
+            THBlas_copy<scalar_t>(blockSize, values_ptr + first * blockSize, 1, dst_ptr, 1);
+            for (int64_t j = run_starts[i] + 1; j < run_starts[i + 1]; j++) {
+              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + perm[j] * blockSize, 1, dst_ptr, 1);
             }
           }
-          prev = curr;
-        }
+        });
     });
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
+  get_sparse_impl(dst)->set_nnz_and_narrow(newNnz);
 
   return dst;
 }
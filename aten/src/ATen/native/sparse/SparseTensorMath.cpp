@@ -480,10 +480,55 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
 // D = beta * D1 + alpha * mm(S, D2)
 // --------------------------------------------------------------------
 
-template <typename scalar_t>
-void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t i;
+// Returns the CSR row pointers of a 2-D sparse matrix, and for an uncoalesced
+// matrix also the permutation that groups its nonzeros by row (stably, so the
+// result does not depend on the number of threads). The row pointers of a
+// coalesced matrix are cached on the tensor and reused by later products.
+static LongTensor s_addmm_row_pointers(const SparseTensor& sparse, const LongTensor& indices,
+                                       int64_t dim_i, int64_t nnz, LongTensor& perm) {
+  auto rows = indices.select(0, 0);
+  auto rows_accessor = rows.accessor<int64_t, 1>();
+  if (sparse.is_coalesced()) {
+    auto impl = get_sparse_impl(sparse);
+    LongTensor csr = impl->crow_indices();
+    if (csr.defined()) {
+      return csr;
+    }
+    // The rows of a coalesced matrix are sorted, so checking the first and
+    // the last one is enough
+    for (int64_t row : {rows_accessor[0], rows_accessor[nnz - 1]}) {
+      if (row < 0 || row >= dim_i) {
+        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+      }
+    }
+    csr = _to_csr(rows.contiguous().data<int64_t>(), dim_i, nnz);
+    impl->set_crow_indices(csr);
+    return csr;
+  }
 
+  LongTensor csr = native::zeros({dim_i + 1}, kLong);
+  int64_t* csr_ptr = csr.data<int64_t>();
+  for (int64_t i = 0; i < nnz; i++) {
+    int64_t row = rows_accessor[i];
+    if (row < 0 || row >= dim_i) {
+      AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+    }
+    csr_ptr[row + 1]++;
+  }
+  for (int64_t h = 0; h < dim_i; h++) {
+    csr_ptr[h + 1] += csr_ptr[h];
+  }
+  perm = at::empty({nnz}, kLong);
+  int64_t* perm_ptr = perm.data<int64_t>();
+  std::vector<int64_t> next(csr_ptr, csr_ptr + dim_i);
+  for (int64_t i = 0; i < nnz; i++) {
+    perm_ptr[next[rows_accessor[i]]++] = i;
+  }
+  return csr;
+}
+
+template <typename scalar_t>
+void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const SparseTensor& sparse, const Tensor& indices, const Tensor& values, const Tensor& dense) {
   // r_ = alpha * sparse * dense
   scalar_t cast_alpha = alpha.to<scalar_t>();
   scalar_t cast_beta = beta.to<scalar_t>();
@@ -497,8 +542,12 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
     at::mul_out(r, t, scalar_to_tensor(beta));
   }
 
-  auto indices_accessor = indices.accessor<int64_t, 2>();
+  LongTensor perm;
+  LongTensor csr = s_addmm_row_pointers(sparse, indices, dim_i, nnz, perm);
+  const int64_t* csr_ptr = csr.data<int64_t>();
+  const int64_t* perm_ptr = perm.defined() ? perm.data<int64_t>() : nullptr;
 
+  auto indices_accessor = indices.accessor<int64_t, 2>();
   auto values_accessor = values.accessor<scalar_t, 1>();
   scalar_t* dense_ptr = dense.data<scalar_t>();
   scalar_t* r_ptr = r.data<scalar_t>();
@@ -507,23 +556,25 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
   int64_t dense_stride1 = dense.stride(1);
   int64_t r_stride0 = r.stride(0);
   int64_t r_stride1 = r.stride(1);
-  for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
-    int64_t row = indices_accessor[0][i];
-    int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
+
+  // Every row of r is written by exactly one thread, which accumulates the
+  // nonzeros of that row in their original order.
+  int64_t grain_size = std::max<int64_t>(internal::GRAIN_SIZE / std::max<int64_t>(nnz / dim_i * dim_k, 1), 1);
+  at::parallel_for(0, dim_i, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t row = start; row < end; row++) {
+      for (int64_t p = csr_ptr[row]; p < csr_ptr[row + 1]; p++) {
+        int64_t i = perm_ptr ? perm_ptr[p] : p;
+        int64_t col = indices_accessor[1][i];
+        if (col < 0 || col >= dim_j) {
+          AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
+        }
+        THBlas_axpy<scalar_t>(dim_k,
+              cast_alpha * values_accessor[i],
+              dense_ptr + col * dense_stride0, dense_stride1,
+              r_ptr + row * r_stride0, r_stride1);
       }
     }
-  }
+  });
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -570,7 +621,7 @@ Tensor& s_addmm_out_sparse_dense_cpu(
 
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "addmm_sparse_dense", [&] {
-        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, indices, values, dense);
+        s_addmm_out_sparse_dense_worker<scalar_t>(nnz, dim_i, dim_j, dim_k, r, beta, t, alpha, sparse_, indices, values, dense);
       }
   );
 
@@ -9,6 +9,10 @@
 #include <THC/THCThrustAllocator.cuh>
 #include <THC/THCTensorSort.cuh>
 
+#include <cub/device/device_radix_sort.cuh>
+
+#include <limits>
+
 #include <thrust/device_ptr.h>
 #include <thrust/device_vector.h>
 #include <thrust/gather.h>
@@ -71,10 +75,43 @@ SparseTensor coalesce_sparse_cuda(const SparseTensor& self) {
   thrust::copy(policy, countIterI, countIterI + nnz, origIndicesIter);
   thrust::copy(policy, countIterO, countIterO + nnz, uniqueOffsetsIter);
 
-  thrust::sort_by_key(policy,
-    indicesIter, indicesIter + nnz,
-    origIndicesIter, ThrustLTOp<int64_t>()
-  );
+  // Indices that are already sorted only need their duplicates merged. This
+  // check is a single pass, much cheaper than the sort.
+  if (!thrust::is_sorted(policy, indicesIter, indicesIter + nnz)) {
+    if (nnz <= std::numeric_limits<int>::max()) {
+      // The flattened indices are below the number of sparse elements, so the
+      // radix sort only needs to look at the bits up to its highest one.
+      int64_t numel = 1;
+      for (int64_t d = 0; d < sparse_dim; d++) {
+        numel *= self.size(d);
+      }
+      int end_bit = 0;
+      while (end_bit < 64 && (static_cast<uint64_t>(numel - 1) >> end_bit) != 0) {
+        end_bit++;
+      }
+      LongTensor sortedIndices = at::empty_like(indices1D);
+      LongTensor sortedOrigIndices = at::empty_like(origIndices);
+      auto sort = [&](void* temp, size_t& temp_bytes) {
+        return cub::DeviceRadixSort::SortPairs(
+            temp, temp_bytes,
+            indices1D.data<int64_t>(), sortedIndices.data<int64_t>(),
+            origIndices.data<int64_t>(), sortedOrigIndices.data<int64_t>(),
+            static_cast<int>(nnz), 0, std::max(end_bit, 1), stream);
+      };
+      size_t temp_bytes = 0;
+      AT_CUDA_CHECK(sort(nullptr, temp_bytes));
+      auto temp = at::empty({static_cast<int64_t>(temp_bytes)}, self._indices().options().dtype(kByte));
+      AT_CUDA_CHECK(sort(temp.data_ptr(), temp_bytes));
+      indices1D = sortedIndices;
+      origIndices = sortedOrigIndices;
+      indicesIter = thrust_ptr(indices1D.data<int64_t>());
+    } else {
+      thrust::sort_by_key(policy,
+        indicesIter, indicesIter + nnz,
+        origIndicesIter, ThrustLTOp<int64_t>()
+      );
+    }
+  }
 
   // this forces device-host synchronization!
   thrust::pair<thrust_ptr, thrust_ptr> newEnd = thrust::unique_by_key(policy,
@@ -2,6 +2,7 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/Type.h>
+#include <ATen/WrapDimUtils.h>
 #include <ATen/native/TensorFactories.h>
 #include <ATen/quantized/QTensorImpl.h>
 
@@ -18,6 +19,24 @@ QuantizerPtr make_per_tensor_affine_quantizer(
       static_cast<float>(scale), static_cast<uint8_t>(zero_point));
 }
 
+QuantizerPtr make_per_channel_affine_quantizer(
+    const Tensor& scales,
+    const Tensor& zero_points,
+    IntArrayRef axis) {
+  AT_CHECK(
+      scales.dim() == 1 && zero_points.dim() == 1,
+      "Per channel affine quantization expects 1-d scales and zero_points.");
+  auto scales_double = scales.to(kDouble).contiguous();
+  auto zero_points_long = zero_points.to(kLong).contiguous();
+  const double* scales_data = scales_double.data<double>();
+  const int64_t* zero_points_data = zero_points_long.data<int64_t>();
+  std::vector<float> scales_vec(scales_data, scales_data + scales.numel());
+  std::vector<uint8_t> zero_points_vec(
+      zero_points_data, zero_points_data + zero_points.numel());
+  return c10::make_intrusive<PerChannelAffineQuantizer>(
+      scales_vec, zero_points_vec, axis.vec());
+}
+
 QTensorImpl* get_qtensorimpl(const Tensor& self) {
   // TODO: remove this when Variable and Tensor are merged
   AT_ASSERTM(
@@ -76,6 +95,58 @@ qint8 quantize_uint8(float scale, uint8_t zero_point, float value) {
   return static_cast<qint8>(qvalue);
 }
 
+namespace {
+
+// Quantizes len contiguous values sharing a scale and zero_point.
+void quantize_block(
+    const float* src,
+    qint8* dst,
+    int64_t len,
+    float scale,
+    uint8_t zero_point) {
+#ifdef USE_FBGEMM
+  fbgemm::TensorQuantizationParams qparams;
+  qparams.scale = scale;
+  qparams.zero_point = zero_point;
+  qparams.precision = 8;
+  fbgemm::Quantize<uint8_t>(/*src=*/src,
+                            /*dst=*/reinterpret_cast<uint8_t*>(dst),
+                            /*len=*/len,
+                            /*qparams=*/qparams);
+#else
+  for (int64_t i = 0; i < len; ++i) {
+    dst[i] = quantize_uint8(scale, zero_point, src[i]);
+  }
+#endif
+}
+
+// Dequantizes len contiguous values sharing a scale and zero_point.
+void dequantize_block(
+    const qint8* src,
+    float* dst,
+    int64_t len,
+    float scale,
+    uint8_t zero_point) {
+#ifdef USE_FBGEMM
+  fbgemm::TensorQuantizationParams qparams;
+  qparams.scale = scale;
+  qparams.zero_point = zero_point;
+  qparams.precision = 8;
+  fbgemm::Dequantize<uint8_t>(/*src=*/reinterpret_cast<const uint8_t*>(src),
+                              /*dst=*/dst,
+                              /*len=*/len,
+                              /*qparams=*/qparams);
+#else
+  for (int64_t i = 0; i < len; ++i) {
+    // We need to convert the qint8 value to float to ensure the subtraction
+    // subexpression returns a float
+    dst[i] = (static_cast<float>(src[i].val_) - zero_point) * scale;
+  }
+#endif
+}
+
+} // namespace
+
 Tensor PerTensorAffineQuantizer::quantize(Tensor tensor) {
   IntArrayRef sizes = tensor.sizes();
   // Here we need a std::intrusive_ptr<Quantizer>.. but actually "this" is the
@@ -89,24 +160,8 @@ Tensor PerTensorAffineQuantizer::quantize(Tensor tensor) {
       intrusive_from_this());
 
   tensor = tensor.contiguous();
-  const float* svd = tensor.data<float>();
-
-#ifdef USE_FBGEMM
-  auto qvd = reinterpret_cast<uint8_t*>(qv.data<qint8>());
-  fbgemm::TensorQuantizationParams qparams;
-  qparams.scale = scale_;
-  qparams.zero_point = zero_point_;
-  qparams.precision = 8;
-  fbgemm::Quantize<uint8_t>(/*src=*/svd,
-                            /*dst=*/qvd,
-                            /*len=*/tensor.numel(),
-                            /*qparams=*/qparams);
-#else
-  auto qvd = qv.data<qint8>();
-  for (int i = 0; i < tensor.numel(); ++i) {
-    qvd[i] = quantize_uint8(scale_, zero_point_, svd[i]);
-  }
-#endif
+  quantize_block(
+      tensor.data<float>(), qv.data<qint8>(), tensor.numel(), scale_, zero_point_);
   return qv;
 }
 
@@ -115,28 +170,79 @@ Tensor PerTensorAffineQuantizer::dequantize(Tensor tensor) {
   at::TensorOptions options = tensor.options().dtype(at::kFloat);
 
   Tensor rv = at::empty(sizes, options);
-  float* rvd = rv.data<float>();
   tensor = tensor.contiguous();
+  dequantize_block(
+      tensor.data<qint8>(), rv.data<float>(), tensor.numel(), scale_, zero_point_);
+  return rv;
+}
 
-#ifdef USE_FBGEMM
-  const auto* qvd = reinterpret_cast<const uint8_t*>(tensor.data<qint8>());
-  fbgemm::TensorQuantizationParams qparams;
-  qparams.scale = scale_;
-  qparams.zero_point = zero_point_;
-  qparams.precision = 8;
-  fbgemm::Dequantize<uint8_t>(/*src=*/qvd,
-                              /*dst=*/rvd,
-                              /*len=*/tensor.numel(),
-                              /*qparams=*/qparams);
-#else
-  const auto* qvd = tensor.data<qint8>();
-  for (auto i = 0; i < tensor.numel(); ++i) {
-    // We need to convert the qint8 value to float to ensure the subtraction
-    // subexpression returns a float
-    rvd[i] = (static_cast<float>(qvd[i].val_) - zero_point_) * scale_;
+// Returns the axis of the channels of `tensor` after checking that it has one
+// channel for each of the `num_channels` quantization parameters.
+static int64_t check_channel_axis(
+    const Tensor& tensor,
+    IntArrayRef axis,
+    size_t num_channels) {
+  AT_CHECK(
+      tensor.dim() > 0,
+      "Per channel affine quantization does not support 0-dim Tensors.");
+  const int64_t channel_axis = maybe_wrap_dim(axis[0], tensor.dim());
+  AT_CHECK(
+      tensor.size(channel_axis) == num_channels,
+      "Per channel affine quantization expects ", num_channels,
+      " channels along axis ", channel_axis, ", but got a Tensor of size ",
+      tensor.sizes());
+  return channel_axis;
+}
+
+// The number of contiguous elements in each channel of a contiguous Tensor.
+static int64_t channel_block_size(const Tensor& tensor, int64_t axis) {
+  return at::prod_intlist(tensor.sizes().slice(axis + 1));
+}
+
+Tensor PerChannelAffineQuantizer::quantize(Tensor tensor) {
+  AT_CHECK(
+      tensor.options().device() == kCPU,
+      "quantize only works for CPU backend right now.");
+  const int64_t axis = check_channel_axis(tensor, axis_, scales_.size());
+  Tensor qv = new_qtensor_cpu(
+      tensor.sizes(),
+      tensor.options().dtype(at::kQInt8),
+      intrusive_from_this());
+
+  tensor = tensor.contiguous();
+  const float* svd = tensor.data<float>();
+  qint8* qvd = qv.data<qint8>();
+  // Each (outer, channel) pair is a contiguous block of inner elements.
+  const int64_t channels = scales_.size();
+  const int64_t inner = channel_block_size(tensor, axis);
+  const int64_t outer = at::prod_intlist(tensor.sizes().slice(0, axis));
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t c = 0; c < channels; ++c) {
+      const int64_t offset = (o * channels + c) * inner;
+      quantize_block(
+          svd + offset, qvd + offset, inner, scales_[c], zero_points_[c]);
+    }
   }
-#endif
+  return qv;
+}
 
+Tensor PerChannelAffineQuantizer::dequantize(Tensor tensor) {
+  const int64_t axis = check_channel_axis(tensor, axis_, scales_.size());
+  Tensor rv = at::empty(tensor.sizes(), tensor.options().dtype(at::kFloat));
+
+  tensor = tensor.contiguous();
+  const qint8* qvd = tensor.data<qint8>();
+  float* rvd = rv.data<float>();
+  const int64_t channels = scales_.size();
+  const int64_t inner = channel_block_size(tensor, axis);
+  const int64_t outer = at::prod_intlist(tensor.sizes().slice(0, axis));
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t c = 0; c < channels; ++c) {
+      const int64_t offset = (o * channels + c) * inner;
+      dequantize_block(
+          qvd + offset, rvd + offset, inner, scales_[c], zero_points_[c]);
+    }
+  }
   return rv;
 }
 
@@ -189,6 +189,11 @@ struct CAFFE2_API PerTensorAffineQuantizer : public AffineQuantizer {
  * PerChannelAffineQuantizer is the same as PerTensorAffineQuantizer
  * except that we have an independent scale and zero_point parameter
  * for each channel.
+ *
+ * The channels are the slices of the Tensor along axis, so for the usual case
+ * of a weight quantized per output channel (axis 0), each channel is a
+ * contiguous block that is quantized and dequantized in a single vectorized
+ * pass.
  */
 struct CAFFE2_API PerChannelAffineQuantizer : public AffineQuantizer {
   explicit PerChannelAffineQuantizer(
@@ -202,8 +207,16 @@ struct CAFFE2_API PerChannelAffineQuantizer : public AffineQuantizer {
     AT_CHECK(
         axis_.size() == 1,
         "Per channel affine quantization in multiple axis is not supported yet.");
+    AT_CHECK(
+        scales_.size() == zero_points_.size(),
+        "Per channel affine quantization expects as many scales as zero_points, "
+        "but got ", scales_.size(), " scales and ", zero_points_.size(),
+        " zero_points.");
   }
 
+  Tensor quantize(Tensor tensor) override;
+  Tensor dequantize(Tensor tensor) override;
+
   std::vector<float> scales() const {
     return scales_;
   }
@@ -237,6 +250,13 @@ CAFFE2_API qint8 quantize_uint8(float scale, uint8_t zero_point, float value);
 CAFFE2_API QuantizerPtr
 make_per_tensor_affine_quantizer(double scale, int64_t zero_point);
 
+// scales and zero_points are 1-d Tensors holding a value for each channel
+// along the single axis in axis
+CAFFE2_API QuantizerPtr make_per_channel_affine_quantizer(
+    const Tensor& scales,
+    const Tensor& zero_points,
+    IntArrayRef axis);
+
 // Create a Quantized Tensor given arguments for normal Tensor and a quantizer
 CAFFE2_API Tensor new_qtensor_cpu(
     IntArrayRef sizes,
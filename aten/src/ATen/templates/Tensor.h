@@ -3,6 +3,7 @@
 #include <ATen/core/Type.h>
 #include <c10/core/Device.h>
 #include <c10/core/Layout.h>
+#include <c10/core/MemoryFormat.h>
 #include <c10/core/Scalar.h>
 #include <c10/core/ScalarType.h>
 #include <ATen/core/SparseTensorRef.h>
@@ -165,8 +166,20 @@ class CAFFE2_API Tensor {
   int64_t ndimension() const {
     return dim();
   }
-  bool is_contiguous() const {
-    return impl_->is_contiguous();
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const {
+    return impl_->is_contiguous(memory_format);
+  }
+
+  // The memory format an operator should allocate a result like this tensor
+  // in: ChannelsLast if this is a strided 4-d tensor laid out densely in
+  // channels last order (and not also C contiguous, as happens when sizes of
+  // one make both layouts coincide), Contiguous otherwise.
+  at::MemoryFormat suggest_memory_format() const {
+    if (!is_sparse() && !is_mkldnn() && !impl_->is_contiguous() &&
+        impl_->is_contiguous(at::MemoryFormat::ChannelsLast)) {
+      return at::MemoryFormat::ChannelsLast;
+    }
+    return at::MemoryFormat::Contiguous;
   }
 
   // Total bytes consumed by the "view" of elements of the array.  Does not
@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <cuda_runtime.h>
+
+#include <thread>
+
+cublasHandle_t getBlasHandleOnNewThread() {
+  cublasHandle_t handle = nullptr;
+  std::thread t([&] { handle = at::cuda::getCurrentCUDABlasHandle(); });
+  t.join();
+  return handle;
+}
+
+TEST(CUDAHandlePoolTest, ThreadsGetTheirOwnHandles) {
+  if (!at::cuda::is_available()) return;
+  auto handle = at::cuda::getCurrentCUDABlasHandle();
+  ASSERT_EQ(handle, at::cuda::getCurrentCUDABlasHandle());
+  // This thread keeps its handle while the other one runs
+  ASSERT_NE(handle, getBlasHandleOnNewThread());
+}
+
+TEST(CUDAHandlePoolTest, HandlesAreReusedAfterThreadsExit) {
+  if (!at::cuda::is_available()) return;
+  auto handle = getBlasHandleOnNewThread();
+  ASSERT_NE(handle, nullptr);
+  for (int i = 0; i < 10; i++) {
+    ASSERT_EQ(handle, getBlasHandleOnNewThread());
+  }
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDACachingAllocator.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <ATen/cuda/CUDAMultiStreamGuard.h>
 #include <ATen/cuda/CUDAEvent.h>
@@ -256,3 +257,48 @@ TEST(TestStream, CrossDeviceTest) {
   cudaStreamSynchronize(stream0);
   ASSERT_TRUE(event0.query());
 }
+
+// Verifies that streams of a group share cached blocks
+TEST(TestStream, StreamGroupTest) {
+  if (!at::cuda::is_available()) return;
+  at::cuda::CUDAStream pool_stream = at::cuda::getStreamFromPool();
+  at::cuda::CUDAStream stream = at::cuda::getStreamFromPool();
+  ASSERT_NE_CUDA(pool_stream, stream);
+  c10::cuda::CUDACachingAllocator::setStreamGroup(stream, pool_stream);
+
+  void* ptr;
+  {
+    at::cuda::CUDAStreamGuard guard(pool_stream);
+    at::Tensor t = at::ones({1024, 1024}, at::kCUDA);
+    ptr = t.data_ptr();
+  }
+
+  // The block freed on pool_stream is reused by the other stream, which
+  // orders its work after what was queued before the free
+  at::cuda::CUDAStreamGuard guard(stream);
+  at::Tensor t = at::zeros({1024, 1024}, at::kCUDA);
+  ASSERT_EQ(t.data_ptr(), ptr);
+  ASSERT_EQ(t.sum().item<float>(), 0);
+}
+
+// Verifies that the blocks cached for a stream's own pool move to the group's
+// pool when the stream joins it
+TEST(TestStream, StreamGroupMovesCachedBlocksTest) {
+  if (!at::cuda::is_available()) return;
+  at::cuda::CUDAStream pool_stream = at::cuda::getStreamFromPool();
+  at::cuda::CUDAStream stream = at::cuda::getStreamFromPool();
+  ASSERT_NE_CUDA(pool_stream, stream);
+
+  void* ptr;
+  {
+    at::cuda::CUDAStreamGuard guard(stream);
+    at::Tensor t = at::ones({1024, 1023}, at::kCUDA);
+    ptr = t.data_ptr();
+  }
+  c10::cuda::CUDACachingAllocator::setStreamGroup(stream, pool_stream);
+
+  at::cuda::CUDAStreamGuard guard(pool_stream);
+  at::Tensor t = at::zeros({1024, 1023}, at::kCUDA);
+  ASSERT_EQ(t.data_ptr(), ptr);
+  ASSERT_EQ(t.sum().item<float>(), 0);
+}
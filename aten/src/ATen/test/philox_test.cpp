@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <ATen/core/PhiloxRNGEngine.h>
+
+#include <vector>
+
+using at::philox_engine;
+
+// Known answers from the Random123 test vectors
+TEST(PhiloxTest, KnownAnswers) {
+  auto check = [](philox_engine::Block counter, philox_engine::Block key,
+                  philox_engine::Block expected) {
+    auto result = philox_engine::rand(counter, key);
+    for (int i = 0; i < 4; i++) {
+      ASSERT_EQ(result[i], expected[i]);
+    }
+  };
+  check({{0, 0, 0, 0}}, {{0, 0, 0, 0}},
+        {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}});
+  check({{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}}, {{0xffffffff, 0xffffffff, 0, 0}},
+        {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}});
+  check({{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}}, {{0xa4093822, 0x299f31d0, 0, 0}},
+        {{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}});
+}
+
+TEST(PhiloxTest, OffsetAndDiscard) {
+  philox_engine serial(123, 4);
+  std::vector<uint32_t> numbers;
+  for (int i = 0; i < 64; i++) {
+    numbers.push_back(serial());
+  }
+  for (int start = 0; start < 64; start++) {
+    philox_engine engine(123, 4);
+    engine.discard(start);
+    ASSERT_EQ(engine(), numbers[start]);
+  }
+  // offsets count blocks of four numbers
+  philox_engine engine(123, 4, 3);
+  ASSERT_EQ(engine(), numbers[12]);
+
+  // subsequences are different streams
+  philox_engine other(123, 5);
+  ASSERT_NE(other(), numbers[0]);
+}
+
+TEST(PhiloxTest, OffsetCarriesIntoSubsequence) {
+  philox_engine engine(7, 0, ~uint64_t(0));
+  engine.discard(4);
+  philox_engine next(7, 1, 0);
+  ASSERT_EQ(engine(), next());
+}
+
+TEST(PhiloxTest, UniformRange) {
+  ASSERT_EQ(at::philox_uniform_float(0), 0.0f);
+  ASSERT_LT(at::philox_uniform_float(0xffffffff), 1.0f);
+  ASSERT_EQ(at::philox_uniform_double(0, 0), 0.0);
+  ASSERT_LT(at::philox_uniform_double(0xffffffff, 0xffffffff), 1.0);
+}
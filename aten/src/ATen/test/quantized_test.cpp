@@ -96,3 +96,26 @@ TEST(TestQTensor, EmptyQuantized) {
     ASSERT_EQ(r_data[i], (val - zero_point) * scale);
   }
 }
+
+TEST(TestQTensor, PerChannelQuantDequant) {
+  const int64_t channels = 3, inner = 4;
+  Tensor r = at::rand({2, channels, inner}) * 4 - 2;
+  Tensor scales = at::tensor(std::vector<double>{0.1, 0.02, 0.5});
+  Tensor zero_points = at::tensor(std::vector<int64_t>{5, 128, 250});
+  Tensor qr = r.quantize_linear_per_channel(scales, zero_points, {1});
+  ASSERT_TRUE(qr.is_quantized());
+  ASSERT_TRUE(qr.q_per_channel_scales().equal(scales));
+  ASSERT_TRUE(qr.q_per_channel_zero_points().equal(zero_points));
+
+  auto* r_data = r.data<float>();
+  auto* qr_data = qr.data<qint8>();
+  Tensor rqr = qr.dequantize();
+  auto* rqr_data = rqr.data<float>();
+  for (int64_t i = 0; i < r.numel(); ++i) {
+    const int64_t c = (i / inner) % channels;
+    const float scale = scales[c].item<double>();
+    const auto zero_point = zero_points[c].item<int64_t>();
+    ASSERT_EQ(quantize_uint8(scale, zero_point, r_data[i]).val_, qr_data[i].val_);
+    ASSERT_EQ((qr_data[i].val_ - zero_point) * scale, rqr_data[i]);
+  }
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/Loops.h>
+
+using namespace at;
+
+namespace {
+
+std::unique_ptr<TensorIterator> make_two_output_iter(
+    Tensor& out1, Tensor& out2, const Tensor& a, const Tensor& b) {
+  auto builder = TensorIterator::Builder();
+  builder.add_output(out1);
+  builder.add_output(out2);
+  builder.add_input(a);
+  builder.add_input(b);
+  return builder.build();
+}
+
+} // namespace
+
+TEST(TensorIteratorTest, MultipleOutputs) {
+  auto a = randn({3, 5});
+  auto b = randn({3, 5});
+  Tensor sum, product;
+  auto iter = make_two_output_iter(sum, product, a, b);
+  ASSERT_EQ(iter->noutputs(), 2);
+  ASSERT_EQ(iter->ninputs(), 2);
+  native::multiple_outputs_kernel(*iter, [](float x, float y) {
+    return std::make_tuple(x + y, x * y);
+  });
+  ASSERT_TRUE(iter->output(0).allclose(a + b));
+  ASSERT_TRUE(iter->output(1).allclose(a * b));
+}
+
+TEST(TensorIteratorTest, MultipleOutputsBroadcast) {
+  auto a = randn({4, 1});
+  auto b = randn({1, 6});
+  auto sum = empty({4, 6});
+  auto difference = empty({4, 6});
+  auto iter = make_two_output_iter(sum, difference, a, b);
+  native::multiple_outputs_kernel(*iter, [](float x, float y) {
+    return std::make_tuple(x + y, x - y);
+  });
+  ASSERT_TRUE(sum.allclose(a + b));
+  ASSERT_TRUE(difference.allclose(a - b));
+}
+
+TEST(TensorIteratorTest, MultipleOutputsVectorized) {
+  // contiguous operands long enough for the vectorized loop and a scalar tail;
+  // the transposed operands go through the strided loop instead
+  for (bool transpose : {false, true}) {
+    auto a = randn({67, 35});
+    auto b = randn({67, 35});
+    if (transpose) {
+      a = a.t();
+      b = b.t();
+    }
+    Tensor larger, smaller;
+    auto iter = make_two_output_iter(larger, smaller, a, b);
+    native::multiple_outputs_kernel_vec(
+        *iter,
+        [](float x, float y) {
+          return std::make_tuple(std::max(x, y), std::min(x, y));
+        },
+        [](vec256::Vec256<float> x, vec256::Vec256<float> y) {
+          return std::make_tuple(vec256::maximum(x, y), vec256::minimum(x, y));
+        });
+    ASSERT_TRUE(iter->output(0).equal(at::max(a, b)));
+    ASSERT_TRUE(iter->output(1).equal(at::min(a, b)));
+  }
+}
+
+TEST(TensorIteratorTest, MultipleOutputsWrongArity) {
+  auto a = randn({3});
+  auto b = randn({3});
+  Tensor out1, out2;
+  auto iter = make_two_output_iter(out1, out2, a, b);
+  ASSERT_ANY_THROW(native::multiple_outputs_kernel(*iter, [](float x) {
+    return std::make_tuple(x, x);
+  }));
+}
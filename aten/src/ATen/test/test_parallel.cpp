@@ -4,6 +4,7 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
 #include <iostream>
 #include <string.h>
 #include <sstream>
@@ -51,3 +52,57 @@ TEST(TestParallel, Exceptions) {
     }),
     std::runtime_error);
 }
+
+TEST(TestParallel, CoversRangeOnce) {
+  set_num_threads(4);
+  const int64_t numel = 100003;
+  std::vector<std::atomic<int>> hits(numel);
+  for (auto& hit : hits) {
+    hit = 0;
+  }
+  std::atomic<bool> bad_thread_num{false};
+  at::parallel_for(0, numel, 7, [&](int64_t begin, int64_t end) {
+    auto thread_num = at::get_thread_num();
+    if (thread_num < 0 || thread_num >= (int)at::get_num_threads()) {
+      bad_thread_num = true;
+    }
+    for (int64_t i = begin; i < end; i++) {
+      hits[i]++;
+    }
+  });
+  ASSERT_FALSE(bad_thread_num);
+  for (auto& hit : hits) {
+    ASSERT_EQ(hit, 1);
+  }
+  ASSERT_FALSE(at::in_parallel_region());
+  ASSERT_EQ(at::get_thread_num(), 0);
+}
+
+TEST(TestParallel, ParallelReduce) {
+  set_num_threads(4);
+  const int64_t numel = 1000000;
+  auto sum = at::parallel_reduce(
+      0, numel, 1000, (int64_t)0,
+      [](int64_t begin, int64_t end, int64_t ident) {
+        auto partial = ident;
+        for (int64_t i = begin; i < end; i++) {
+          partial += i;
+        }
+        return partial;
+      },
+      [](int64_t x, int64_t y) { return x + y; });
+  ASSERT_EQ(sum, numel * (numel - 1) / 2);
+}
+
+TEST(TestParallel, NestedParallelFor) {
+  set_num_threads(4);
+  std::atomic<int64_t> total{0};
+  at::parallel_for(0, 8, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      at::parallel_for(0, 1000, 10, [&](int64_t inner_begin, int64_t inner_end) {
+        total += inner_end - inner_begin;
+      });
+    }
+  });
+  ASSERT_EQ(total, 8000);
+}
@@ -1,10 +1,20 @@
 #include <THC/THCBlas.h>
 #include <THC/THCGeneral.h>
 #include <TH/THHalf.h>
+#include <ATen/Context.h>
 #include <ATen/cuda/CUDAContext.h>
 
 #include <algorithm>
 
+#if CUDA_VERSION >= 10000 && !defined(__HIP_PLATFORM_HCC__)
+// Whether single precision GEMMs may round their inputs to half precision to
+// use the tensor cores, see Context::allowFP32TensorOpCuBLAS
+static bool useFP32TensorOp() {
+  return at::globalContext().allowFP32TensorOpCuBLAS() &&
+      at::cuda::getCurrentDeviceProperties()->major >= 7;
+}
+#endif
+
 float THCudaBlas_Sdot(THCState *state, int64_t n, float *x, int64_t incx, float *y, int64_t incy)
 {
   if (n == 1) {
@@ -256,6 +266,17 @@ void THCudaBlas_Sgemm(THCState *state, char transa, char transb, int64_t m, int6
 
     cublasHandle_t handle = THCState_getCurrentBlasHandle(state);
     cublasSetStream(handle, THCState_getCurrentStream(state));
+#if CUDA_VERSION >= 10000 && !defined(__HIP_PLATFORM_HCC__)
+    // The handle is shared by all the GEMMs on this device, so the math mode
+    // is restored before reporting an error.
+    if (useFP32TensorOp()) {
+      THCublasCheck(cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH));
+      cublasStatus_t status = cublasSgemm(handle, opa, opb, i_m, i_n, i_k, &alpha, a, i_lda, b, i_ldb, &beta, c, i_ldc);
+      THCublasCheck(cublasSetMathMode(handle, CUBLAS_DEFAULT_MATH));
+      THCublasCheck(status);
+      return;
+    }
+#endif
     THCublasCheck(cublasSgemm(handle, opa, opb, i_m, i_n, i_k, &alpha, a, i_lda, b, i_ldb, &beta, c, i_ldc));
     return;
   }
@@ -307,12 +328,18 @@ void THCudaBlas_Hgemm(THCState *state, char transa, char transb, int64_t m, int6
 #else
       cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
       if (prop->major >= 5){
+        // With a half precision compute type, alpha and beta are halfs too
+        const bool fp16_reduction =
+            at::globalContext().allowFP16ReductionCuBLAS() && prop->major >= 7;
+        const void* alpha_ptr = fp16_reduction ? static_cast<const void*>(&alpha) : &fAlpha;
+        const void* beta_ptr = fp16_reduction ? static_cast<const void*>(&beta) : &fBeta;
         THCublasCheck(cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH));
         THCublasCheck(cublasGemmEx(handle, opa, opb,
-                                   i_m, i_n, i_k, &fAlpha,
+                                   i_m, i_n, i_k, alpha_ptr,
                                    a, CUDA_R_16F, i_lda, b, CUDA_R_16F,
-                                   i_ldb, &fBeta, c, CUDA_R_16F, i_ldc,
-                                   CUDA_R_32F, CUBLAS_GEMM_DFALT_TENSOR_OP));
+                                   i_ldb, beta_ptr, c, CUDA_R_16F, i_ldc,
+                                   fp16_reduction ? CUDA_R_16F : CUDA_R_32F,
+                                   CUBLAS_GEMM_DFALT_TENSOR_OP));
         THCublasCheck(cublasSetMathMode(handle, CUBLAS_DEFAULT_MATH));
       }else{
         THCublasCheck(cublasSgemmEx(handle, opa, opb,
@@ -381,13 +408,18 @@ void THCudaBlas_HgemmStridedBatched(THCState *state, char transa, char transb, i
                                    (int) batchCount, rocblas_datatype_f32_r, rocblas_gemm_algo_standard,
                                    0, 0, NULL, NULL));
 #else
+  const bool fp16_reduction = at::globalContext().allowFP16ReductionCuBLAS() &&
+      at::cuda::getCurrentDeviceProperties()->major >= 7;
+  const void* alpha_ptr = fp16_reduction ? static_cast<const void*>(&alpha) : &fAlpha;
+  const void* beta_ptr = fp16_reduction ? static_cast<const void*>(&beta) : &fBeta;
   THCublasCheck(cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH));
   THCublasCheck(cublasGemmStridedBatchedEx(handle,
                                    opa, opb, (int)m, (int)n, (int)k,
-                                   (void*)&fAlpha, a, CUDA_R_16F, (int)lda, strideA,
+                                   alpha_ptr, a, CUDA_R_16F, (int)lda, strideA,
                                    b, CUDA_R_16F, (int)ldb, strideB,
-                                   (void*)&fBeta, c, CUDA_R_16F, (int)ldc, strideC,
-                                   (int)batchCount, CUDA_R_32F, CUBLAS_GEMM_DEFAULT_TENSOR_OP));
+                                   beta_ptr, c, CUDA_R_16F, (int)ldc, strideC,
+                                   (int)batchCount, fp16_reduction ? CUDA_R_16F : CUDA_R_32F,
+                                   CUBLAS_GEMM_DEFAULT_TENSOR_OP));
   THCublasCheck(cublasSetMathMode(handle, CUBLAS_DEFAULT_MATH));
 #endif
 }
@@ -444,6 +476,18 @@ void THCudaBlas_SgemmStridedBatched(THCState *state, char transa, char transb, i
 
   cublasHandle_t handle = THCState_getCurrentBlasHandle(state);
   cublasSetStream(handle, THCState_getCurrentStream(state));
+#if CUDA_VERSION >= 10000 && !defined(__HIP_PLATFORM_HCC__)
+  if (useFP32TensorOp()) {
+    THCublasCheck(cublasSetMathMode(handle, CUBLAS_TENSOR_OP_MATH));
+    cublasStatus_t status = cublasSgemmStridedBatched(handle,
+                                   opa, opb, (int)m, (int)n, (int)k,
+                                   &alpha, a, (int)lda, strideA, b, (int)ldb, strideB, &beta, c, (int)ldc, strideC,
+                                   (int)batchCount);
+    THCublasCheck(cublasSetMathMode(handle, CUBLAS_DEFAULT_MATH));
+    THCublasCheck(status);
+    return;
+  }
+#endif
   THCublasCheck(cublasSgemmStridedBatched(handle,
                                    opa, opb, (int)m, (int)n, (int)k,
                                    &alpha, a, (int)lda, strideA, b, (int)ldb, strideB, &beta, c, (int)ldc, strideC,
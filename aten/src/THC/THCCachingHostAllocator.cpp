@@ -2,6 +2,7 @@
 
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -13,6 +14,11 @@
 
 namespace {
 
+// all sizes are rounded to at least 512 bytes
+constexpr size_t kMinBlockSize = 512;
+// the rest of a cached block is split off if it is at least this large
+constexpr size_t kMinSplitRemainder = 1048576;
+
 struct BlockSize
 {
   size_t  size; // allocation size
@@ -26,9 +32,15 @@ struct Block : public BlockSize
   bool  allocated;    // true if the block is currently allocated
   int   event_count;  // number of outstanding cuda events
   std::unordered_set<at::cuda::CUDAStream> streams;
+  Block* prev;        // prev block if split from a larger allocation
+  Block* next;        // next block if split from a larger allocation
 
   Block(size_t size, void* ptr, bool allocated) :
-      BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
+      BlockSize(size, ptr), allocated(allocated), event_count(0), streams(),
+      prev(nullptr), next(nullptr) {}
+
+  // true if the block can be handed out, or merged with its neighbours
+  bool is_free() const { return !allocated && event_count == 0; }
 };
 
 static bool BlockComparator(const BlockSize& a, const BlockSize& b)
@@ -40,6 +52,14 @@ static bool BlockComparator(const BlockSize& a, const BlockSize& b)
   return (uintptr_t)a.ptr < (uintptr_t)b.ptr;
 }
 
+static size_t roundSize(size_t size)
+{
+  if (size < kMinBlockSize) {
+    return kMinBlockSize;
+  }
+  return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
+}
+
 struct HostAllocator
 {
   typedef bool (*Comparison)(const BlockSize&, const BlockSize&);
@@ -56,6 +76,8 @@ struct HostAllocator
   // outstanding cuda events
   std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
 
+  THCCachingHostAllocatorStats stats;
+
   HostAllocator() : available(BlockComparator) {}
 
   cudaError_t malloc(void** ptr, size_t size)
@@ -68,28 +90,49 @@ struct HostAllocator
       return err;
     }
 
+    size = roundSize(size);
+
     // search for the smallest block which can hold this allocation
     BlockSize search_key(size);
     auto it = available.lower_bound(search_key);
     if (it != available.end()) {
-      Block& block = blocks.at(it->ptr);
-      THAssert(!block.allocated && block.event_count == 0);
-      block.allocated = true;
-      *ptr = block.ptr;
+      Block* block = &blocks.at(it->ptr);
+      THAssert(block->is_free());
       available.erase(it);
+      if (block->size - size >= kMinSplitRemainder) {
+        // keep the rest of the block cached
+        void* rest_ptr = static_cast<char*>(block->ptr) + size;
+        Block* rest = &blocks.emplace(
+            rest_ptr, Block(block->size - size, rest_ptr, false)).first->second;
+        rest->prev = block;
+        rest->next = block->next;
+        if (rest->next) {
+          rest->next->prev = rest;
+        }
+        block->next = rest;
+        block->size = size;
+        available.insert(*rest);
+      }
+      block->allocated = true;
+      *ptr = block->ptr;
+      increaseAllocated(block->size);
       return cudaSuccess;
     }
 
-    // note that cudaHostAlloc may not touch pointer if size is 0
-    *ptr = 0;
-
     // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    err = hostAlloc(ptr, size);
+    if (err == cudaErrorMemoryAllocation) {
+      // free the cached regions and retry
+      cudaGetLastError();
+      releaseCachedBlocks();
+      err = hostAlloc(ptr, size);
+    }
     if (err != cudaSuccess) {
       return err;
     }
 
     blocks.insert({*ptr, Block(size, *ptr, true)});
+    increaseAllocated(size);
     return cudaSuccess;
   }
 
@@ -116,6 +159,7 @@ struct HostAllocator
     // free (on valid memory) shouldn't fail, so mark unallocated before
     // we process the streams.
     block.allocated = false;
+    stats.allocated -= block.size;
 
     // insert CUDA events for each stream on which this block was used. This
     err = insertEvents(block);
@@ -125,7 +169,7 @@ struct HostAllocator
 
     if (block.event_count == 0) {
       // the block can be re-used if there are no outstanding cuda events
-      available.insert(block);
+      makeAvailable(&block);
     }
     return cudaSuccess;
   }
@@ -169,12 +213,12 @@ struct HostAllocator
         return err;
       }
 
-      Block& block = blocks.at(e.second);
-      block.event_count--;
-      if (block.event_count == 0 && !block.allocated) {
-        available.insert(block);
-      }
+      Block* block = &blocks.at(e.second);
       cuda_events.pop_front();
+      block->event_count--;
+      if (block->is_free()) {
+        makeAvailable(block);
+      }
     }
     return cudaSuccess;
   }
@@ -183,31 +227,96 @@ struct HostAllocator
   {
     std::lock_guard<std::mutex> lock(mutex);
 
-    // remove events for freed blocks
-    for (auto it = cuda_events.begin(); it != cuda_events.end(); ++it) {
-      cudaEvent_t event = it->first;
-      Block& block = blocks.at(it->second);
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaEventDestroy(event));
-        block.event_count--;
-      }
+    // blocks whose events have completed can be released too
+    THCudaCheckWarn(processEvents());
+    releaseCachedBlocks();
+  }
+
+  cudaError_t reserve(size_t size)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    void* ptr;
+    size = roundSize(size);
+    cudaError_t err = hostAlloc(&ptr, size);
+    if (err != cudaSuccess) {
+      return err;
     }
+    Block& block = blocks.insert({ptr, Block(size, ptr, false)}).first->second;
+    available.insert(block);
+    return cudaSuccess;
+  }
 
-    // all cuda_events have been processed
-    cuda_events.clear();
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+  }
+
+  cudaError_t hostAlloc(void** ptr, size_t size)
+  {
+    // note that cudaHostAlloc may not touch pointer if size is 0
+    *ptr = 0;
+    cudaError_t err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    if (err != cudaSuccess) {
+      return err;
+    }
+    stats.num_host_allocs++;
+    stats.cached += size;
+    stats.max_cached = std::max(stats.max_cached, stats.cached);
+    return cudaSuccess;
+  }
 
-    // clear list of available blocks
-    available.clear();
+  void increaseAllocated(size_t size)
+  {
+    stats.allocated += size;
+    stats.max_allocated = std::max(stats.max_allocated, stats.allocated);
+  }
 
-    // free and erase non-allocated blocks
-    for (auto it = blocks.begin(); it != blocks.end();) {
-      Block& block = it->second;
-      if (!block.allocated) {
-        THCudaCheckWarn(cudaFreeHost(block.ptr));
-        it = blocks.erase(it);
-      } else {
+  // Merges a block that just became free with its free neighbours, and
+  // caches the result
+  void makeAvailable(Block* block)
+  {
+    Block* prev = block->prev;
+    if (prev && prev->is_free()) {
+      available.erase(*prev);
+      prev->size += block->size;
+      prev->next = block->next;
+      if (prev->next) {
+        prev->next->prev = prev;
+      }
+      blocks.erase(block->ptr);
+      block = prev;
+    }
+    Block* next = block->next;
+    if (next && next->is_free()) {
+      available.erase(*next);
+      block->size += next->size;
+      block->next = next->next;
+      if (block->next) {
+        block->next->prev = block;
+      }
+      blocks.erase(next->ptr);
+    }
+    available.insert(*block);
+  }
+
+  // Frees the cudaHostAlloc regions that are entirely cached. Free blocks
+  // are always merged with their free neighbours, so those are the free
+  // blocks without neighbours.
+  void releaseCachedBlocks()
+  {
+    for (auto it = available.begin(); it != available.end();) {
+      Block& block = blocks.at(it->ptr);
+      if (block.prev || block.next) {
         ++it;
+        continue;
       }
+      THCudaCheckWarn(cudaFreeHost(block.ptr));
+      stats.num_host_frees++;
+      stats.cached -= block.size;
+      blocks.erase(block.ptr);
+      it = available.erase(it);
     }
   }
 
@@ -254,6 +363,16 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+cudaError_t THCCachingHostAllocator_reserve(size_t size)
+{
+  return allocator.reserve(size);
+}
+
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
@@ -18,16 +18,38 @@
 // call between host and device. We implement this for storages and tensors in
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
-// Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// Like the caching device allocator, it hands out the front of a cached block
+// that is much larger than the request, and keeps the rest cached; freed
+// neighbours from the same cudaHostAlloc region are merged again. Pinning new
+// memory is slow (the pages are locked by the driver), so a process can
+// reserve a region upfront with THCCachingHostAllocator_reserve, which later
+// allocations are carved from.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
+// Bytes handed out and held by the allocator, and counts of the calls it made
+// to CUDA to pin and unpin memory
+struct THCCachingHostAllocatorStats {
+  size_t allocated = 0;
+  size_t max_allocated = 0;
+  size_t cached = 0;
+  size_t max_cached = 0;
+  size_t num_host_allocs = 0;
+  size_t num_host_frees = 0;
+};
+
 // Records an event in the specified stream. The allocation 'ptr' will not be
 // re-used until the event has occurred.
 THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUDAStream stream);
 
-// Releases cached pinned memory allocations via cudaHostFree
+// Releases cached pinned memory allocations via cudaHostFree. Regions that
+// are partly in use, or whose blocks still wait on CUDA events, are kept.
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+// Pins a region of size bytes and adds it to the cache, so that the next
+// allocations don't have to pin memory
+THC_API cudaError_t THCCachingHostAllocator_reserve(size_t size);
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+
 #endif
@@ -75,25 +75,8 @@ void THCudaInit(THCState* state)
         state->p2pAccessEnabled[i][j] = -1;
   }
 
-  for (int i = 0; i < numDevices; ++i) {
-    THCCudaResourcesPerDevice* res = THCState_getDeviceResourcePtr(state, i);
-    THCudaCheck(cudaSetDevice(i));
-
-    /* The scratch space that we want to have available per each device is
-       based on the number of SMs available per device. We guarantee a
-       minimum of 128kb of space per device, but to future-proof against
-       future architectures that may have huge #s of SMs, we guarantee that
-       we have at least 16 bytes for each SM. */
-    int numSM = at::cuda::getDeviceProperties(i)->multiProcessorCount;
-    size_t sizePerStream =
-      MIN_GLOBAL_SCRATCH_SPACE_PER_DEVICE >= numSM * MIN_GLOBAL_SCRATCH_SPACE_PER_SM_STREAM ?
-      MIN_GLOBAL_SCRATCH_SPACE_PER_DEVICE :
-      numSM * MIN_GLOBAL_SCRATCH_SPACE_PER_SM_STREAM;
-    res->scratchSpacePerStream = sizePerStream;
-  }
-
-  /* Restore to previous device */
-  THCudaCheck(cudaSetDevice(device));
+  // The per-device resources are set up the first time each device is used,
+  // so that the devices that are never used are not initialized.
 }
 
 void THCudaShutdown(THCState* state)
@@ -115,16 +98,11 @@ void THCudaShutdown(THCState* state)
 
   /* cleanup per-device state */
   for (int dev = 0; dev < deviceCount; ++dev) {
-    THCudaCheck(cudaSetDevice(dev));
     THCCudaResourcesPerDevice* res = &(state->resourcesPerDevice[dev]);
 
-    // Frees BLAS handle
-    if (res->blasHandle) {
-      THCublasCheck(cublasDestroy(res->blasHandle));
-    }
-
     // Frees sparse handle
     if (res->sparseHandle) {
+      THCudaCheck(cudaSetDevice(dev));
       THCusparseCheck(cusparseDestroy(res->sparseHandle));
     }
   }
@@ -219,16 +197,7 @@ cublasHandle_t THCState_getCurrentBlasHandle(THCState *state)
     return NULL;
   }
 
-  int device;
-  THCudaCheck(cudaGetDevice(&device));
-
-  // Creates the BLAS handle if not created yet
-  THCCudaResourcesPerDevice* res = THCState_getDeviceResourcePtr(state, device);
-  if (!res->blasHandle) {
-    THCublasCheck(cublasCreate(&res->blasHandle));
-  }
-
-  return res->blasHandle;
+  return at::cuda::getCurrentCUDABlasHandle();
 }
 
 cusparseHandle_t THCState_getCurrentSparseHandle(THCState *state)
@@ -257,6 +226,18 @@ size_t THCState_getCurrentDeviceScratchSpaceSize(THCState* state)
   int device = -1;
   THCudaCheck(cudaGetDevice(&device));
   THCCudaResourcesPerDevice* res = THCState_getDeviceResourcePtr(state, device);
+  if (res->scratchSpacePerStream == 0) {
+    /* The scratch space that we want to have available per each device is
+       based on the number of SMs available per device. We guarantee a
+       minimum of 128kb of space per device, but to future-proof against
+       future architectures that may have huge #s of SMs, we guarantee that
+       we have at least 16 bytes for each SM. */
+    int numSM = at::cuda::getDeviceProperties(device)->multiProcessorCount;
+    res->scratchSpacePerStream =
+      MIN_GLOBAL_SCRATCH_SPACE_PER_DEVICE >= numSM * MIN_GLOBAL_SCRATCH_SPACE_PER_SM_STREAM ?
+      MIN_GLOBAL_SCRATCH_SPACE_PER_DEVICE :
+      numSM * MIN_GLOBAL_SCRATCH_SPACE_PER_SM_STREAM;
+  }
   return res->scratchSpacePerStream;
 }
 
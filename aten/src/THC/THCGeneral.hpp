@@ -5,9 +5,9 @@
 /* Global state of THC. */
 struct THCState {
   struct THCRNGState* rngState;
-  /* Set of all allocated resources. blasHandles and sparseHandles do not have
-     a default and must be explicitly initialized. We always initialize 1
-     blasHandle and 1 sparseHandle but we can use more.
+  /* Set of all allocated resources. The sparseHandles are created the first
+     time they are requested. The cuBLAS handles are pooled per thread, see
+     at::cuda::getCurrentCUDABlasHandle.
   */
   THCCudaResourcesPerDevice* resourcesPerDevice;
   /* Captured number of devices upon startup; convenience for bounds checking */
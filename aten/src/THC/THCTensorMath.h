@@ -46,9 +46,6 @@
 #include <THC/generic/THCTensorMasked.h>
 #include <THC/THCGenerateAllTypes.h>
 
-#include <THC/generic/THCTensorScatterGather.h>
-#include <THC/THCGenerateAllTypes.h>
-
 #include <THC/generic/THCTensorIndex.h>
 #include <THC/THCGenerateAllTypes.h>
 
@@ -0,0 +1,98 @@
+from __future__ import print_function
+import argparse
+import gc
+import timeit
+
+import torch
+
+
+# Ops on tensors small enough that the time of a call is spent in the
+# framework (argument parsing, dispatch, autograd bookkeeping) and not in
+# the kernel.
+def make_ops(size):
+    a = torch.randn(size)
+    b = torch.randn(size)
+    m = torch.randn(size, size)
+    idx = torch.zeros(1, dtype=torch.long)
+    return [
+        ('add', lambda a, b, m: a + b, (a, b, m)),
+        ('mul_scalar', lambda a, b, m: a * 2, (a, b, m)),
+        ('relu', lambda a, b, m: a.relu(), (a, b, m)),
+        ('sum', lambda a, b, m: a.sum(), (a, b, m)),
+        ('view', lambda a, b, m: a.view(-1), (a, b, m)),
+        ('index_select', lambda a, b, m: a.index_select(0, idx), (a, b, m)),
+        ('mm', lambda a, b, m: m.mm(m), (a, b, m)),
+        ('chunk', lambda a, b, m: m.chunk(2), (a, b, m)),
+        # view ops, which indexing-heavy code creates by the million
+        ('select', lambda a, b, m: m[0], (a, b, m)),
+        ('narrow', lambda a, b, m: m.narrow(0, 0, 1), (a, b, m)),
+        ('slice', lambda a, b, m: m[:, 1:], (a, b, m)),
+        ('transpose', lambda a, b, m: m.t(), (a, b, m)),
+        ('as_strided', lambda a, b, m: m.as_strided((1,), (1,)), (a, b, m)),
+    ]
+
+
+def with_requires_grad(args):
+    return tuple(t.detach().requires_grad_() for t in args)
+
+
+class no_context(object):
+    def __enter__(self):
+        pass
+
+    def __exit__(self, *args):
+        pass
+
+
+MODES = {
+    # inputs don't require grad: no graph is recorded
+    'no_grad_inputs': (lambda args: args, no_context),
+    # inputs require grad: a graph node is created for each call
+    'requires_grad': (with_requires_grad, no_context),
+    # inputs require grad, but grad mode is off
+    'no_grad_mode': (with_requires_grad, torch.no_grad),
+}
+
+
+def time_op(fn, args, context, nloops, repeat):
+    def run():
+        with context():
+            for _ in range(nloops):
+                fn(*args)
+    run()  # warmup
+    gc.collect()
+    best = min(timeit.repeat(run, number=1, repeat=repeat))
+    return best / nloops * 1e6
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Per-op framework overhead')
+    parser.add_argument('--size', type=int, default=2)
+    parser.add_argument('--nloops', type=int, default=10000)
+    parser.add_argument('--repeat', type=int, default=5)
+    parser.add_argument('--ops', nargs='*', default=None,
+                        help='ops to run (default: all)')
+    parser.add_argument('--modes', nargs='*', default=sorted(MODES.keys()),
+                        choices=sorted(MODES.keys()))
+    args = parser.parse_args()
+
+    torch.set_num_threads(1)
+    ops = make_ops(args.size)
+    if args.ops:
+        ops = [op for op in ops if op[0] in args.ops]
+
+    colwidth = 16
+    print('us per call (best of {} runs of {} calls); calls per second = 1e6 / us'.format(
+        args.repeat, args.nloops))
+    print(''.join(['op'.rjust(colwidth)] + [mode.rjust(colwidth) for mode in args.modes]))
+    for name, fn, inputs in ops:
+        row = [name.rjust(colwidth)]
+        for mode in args.modes:
+            prepare, context = MODES[mode]
+            us = time_op(fn, prepare(inputs), context, args.nloops, args.repeat)
+            row.append('{:.3f}'.format(us).rjust(colwidth))
+        print(''.join(row))
+
+
+if __name__ == '__main__':
+    main()
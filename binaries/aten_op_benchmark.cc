@@ -0,0 +1,273 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Microbenchmarks of ATen CPU kernels, called directly through at:: without
+// Python or autograd in the way.
+//
+// Every op is swept over shapes, dtypes, contiguous and transposed inputs,
+// and intra-op thread counts. Besides time, each run reports
+//   bytes_per_second  the bytes the op has to read and write at least,
+//                     divided by its time,
+//   roofline          bytes_per_second as a fraction of the streaming
+//                     bandwidth measured at startup (a large contiguous
+//                     copy with all threads), i.e. how close a memory-bound
+//                     kernel gets to the machine's limit,
+//   flops             for the compute-bound ops (mm), their rate.
+//
+// Use the google-benchmark flags to filter and to emit JSON, e.g.
+//   aten_op_benchmark --benchmark_filter='add/float' \
+//       --benchmark_format=json --benchmark_out=add.json
+// and --peak_bandwidth=<bytes per second> to pin the roofline to a known
+// peak instead of the measured one.
+
+#include "benchmark/benchmark.h"
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+double peak_bandwidth = 0;
+
+// Bytes per second of a large contiguous copy, the best of a few runs.
+double measure_peak_bandwidth() {
+  const int64_t numel = 64 * 1024 * 1024;
+  at::Tensor src = at::ones({numel}, at::kFloat);
+  at::Tensor dst = at::empty({numel}, at::kFloat);
+  dst.copy_(src);
+  double best = 0;
+  for (int i = 0; i < 5; i++) {
+    auto start = std::chrono::steady_clock::now();
+    dst.copy_(src);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    best = std::max(best, 2 * numel * sizeof(float) / seconds.count());
+  }
+  return best;
+}
+
+struct Config {
+  std::vector<int64_t> sizes;
+  at::ScalarType dtype;
+  bool transposed;
+  int threads;
+};
+
+std::string config_name(const std::string& op, const Config& config) {
+  std::string name = op + "/" + at::toString(config.dtype) + "/";
+  for (size_t i = 0; i < config.sizes.size(); i++) {
+    name += (i ? "x" : "") + std::to_string(config.sizes[i]);
+  }
+  name += config.transposed ? "/transposed" : "/contiguous";
+  name += "/threads:" + std::to_string(config.threads);
+  return name;
+}
+
+// Inputs are created in the transposed layout of their last two dimensions
+// when requested, so that the kernels see non-contiguous strides.
+at::Tensor make_input(const Config& config, at::ScalarType dtype) {
+  std::vector<int64_t> sizes = config.sizes;
+  if (config.transposed) {
+    std::swap(sizes[sizes.size() - 1], sizes[sizes.size() - 2]);
+  }
+  at::Tensor t = at::randn(sizes, at::kFloat).to(dtype);
+  return config.transposed ? t.transpose(-1, -2) : t;
+}
+
+// An op under benchmark: builds its inputs once, returns the work of one
+// iteration, and the bytes and flops that iteration needs.
+struct Op {
+  std::string name;
+  std::vector<at::ScalarType> dtypes;
+  std::vector<std::vector<int64_t>> shapes;
+  std::function<std::function<void()>(const Config&, int64_t* bytes, int64_t* flops)> setup;
+};
+
+void run(benchmark::State& state, const Op& op, const Config& config) {
+  at::set_num_threads(config.threads);
+  int64_t bytes = 0;
+  int64_t flops = 0;
+  std::function<void()> iteration = op.setup(config, &bytes, &flops);
+  iteration();  // warm up allocator and caches
+  while (state.KeepRunning()) {
+    iteration();
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+  if (peak_bandwidth > 0) {
+    // a rate divided by the peak rate: the counter is scaled by 1 / time
+    state.counters["roofline"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * bytes) / peak_bandwidth,
+        benchmark::Counter::kIsRate);
+  }
+  if (flops > 0) {
+    state.counters["flops"] = benchmark::Counter(
+        static_cast<double>(state.iterations() * flops), benchmark::Counter::kIsRate);
+  }
+}
+
+int64_t nbytes(const at::Tensor& t) {
+  return t.numel() * t.element_size();
+}
+
+std::vector<Op> make_ops() {
+  const std::vector<at::ScalarType> floating = {at::kFloat, at::kDouble};
+  const std::vector<std::vector<int64_t>> pointwise_shapes = {
+      {64, 64}, {1024, 1024}, {32, 64, 56, 56}};
+  std::vector<Op> ops;
+
+  auto binary = [&](const std::string& name,
+                    std::function<at::Tensor(const at::Tensor&, const at::Tensor&)> fn) {
+    ops.push_back({name, {at::kFloat, at::kDouble, at::kInt, at::kLong}, pointwise_shapes,
+        [fn](const Config& config, int64_t* bytes, int64_t*) -> std::function<void()> {
+          at::Tensor a = make_input(config, config.dtype);
+          at::Tensor b = make_input(config, config.dtype);
+          *bytes = 3 * nbytes(a);
+          return [fn, a, b] { benchmark::DoNotOptimize(fn(a, b)); };
+        }});
+  };
+  binary("add", [](const at::Tensor& a, const at::Tensor& b) { return a + b; });
+  binary("mul", [](const at::Tensor& a, const at::Tensor& b) { return a * b; });
+
+  auto unary = [&](const std::string& name, std::function<at::Tensor(const at::Tensor&)> fn) {
+    ops.push_back({name, floating, pointwise_shapes,
+        [fn](const Config& config, int64_t* bytes, int64_t*) -> std::function<void()> {
+          at::Tensor a = make_input(config, config.dtype);
+          *bytes = 2 * nbytes(a);
+          return [fn, a] { benchmark::DoNotOptimize(fn(a)); };
+        }});
+  };
+  unary("exp", [](const at::Tensor& a) { return a.exp(); });
+  unary("tanh", [](const at::Tensor& a) { return a.tanh(); });
+  unary("sigmoid", [](const at::Tensor& a) { return a.sigmoid(); });
+  unary("softmax", [](const at::Tensor& a) { return a.softmax(-1); });
+
+  // dtype conversions read one dtype and write another
+  auto cast = [&](const std::string& name, at::ScalarType to,
+                  std::vector<at::ScalarType> from) {
+    ops.push_back({name, from, pointwise_shapes,
+        [to](const Config& config, int64_t* bytes, int64_t*) -> std::function<void()> {
+          at::Tensor a = make_input(config, config.dtype);
+          *bytes = nbytes(a) + a.numel() * at::elementSize(to);
+          return [a, to] { benchmark::DoNotOptimize(a.to(to)); };
+        }});
+  };
+  cast("to_float", at::kFloat, {at::kByte, at::kHalf, at::kDouble, at::kLong});
+  cast("to_int", at::kInt, {at::kByte, at::kFloat, at::kLong});
+
+  ops.push_back({"sum_last_dim", floating, pointwise_shapes,
+      [](const Config& config, int64_t* bytes, int64_t*) -> std::function<void()> {
+        at::Tensor a = make_input(config, config.dtype);
+        *bytes = nbytes(a);
+        return [a] { benchmark::DoNotOptimize(a.sum(-1)); };
+      }});
+  ops.push_back({"sum_first_dim", floating, pointwise_shapes,
+      [](const Config& config, int64_t* bytes, int64_t*) -> std::function<void()> {
+        at::Tensor a = make_input(config, config.dtype);
+        *bytes = nbytes(a);
+        return [a] { benchmark::DoNotOptimize(a.sum(0)); };
+      }});
+
+  ops.push_back({"batch_norm_eval", floating, {{32, 64, 56, 56}, {256, 512, 7, 7}},
+      [](const Config& config, int64_t* bytes, int64_t*) -> std::function<void()> {
+        at::Tensor a = make_input(config, config.dtype);
+        const int64_t channels = a.size(1);
+        at::Tensor weight = at::rand({channels}, a.options());
+        at::Tensor bias = at::rand({channels}, a.options());
+        at::Tensor mean = at::rand({channels}, a.options());
+        at::Tensor var = at::rand({channels}, a.options()) + 1;
+        *bytes = 2 * nbytes(a);
+        return [a, weight, bias, mean, var] {
+          benchmark::DoNotOptimize(at::batch_norm(
+              a, weight, bias, mean, var, false, 0.1, 1e-5, false));
+        };
+      }});
+
+  ops.push_back({"mm", floating, {{64, 64}, {256, 256}, {1024, 1024}},
+      [](const Config& config, int64_t* bytes, int64_t* flops) -> std::function<void()> {
+        at::Tensor a = make_input(config, config.dtype);
+        at::Tensor b = make_input(config, config.dtype);
+        *bytes = 3 * nbytes(a);
+        *flops = 2 * a.size(0) * a.size(1) * b.size(1);
+        return [a, b] { benchmark::DoNotOptimize(a.mm(b)); };
+      }});
+
+  return ops;
+}
+
+std::vector<int> thread_counts() {
+  const int max_threads = at::get_num_threads();
+  std::vector<int> counts = {1};
+  for (int t = 2; t < max_threads; t *= 2) {
+    counts.push_back(t);
+  }
+  if (max_threads > 1) {
+    counts.push_back(max_threads);
+  }
+  return counts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  at::init_num_threads();
+
+  // Flags of our own are taken out before google-benchmark sees the rest.
+  std::vector<char*> args;
+  for (int i = 0; i < argc; i++) {
+    const char* flag = "--peak_bandwidth=";
+    if (std::strncmp(argv[i], flag, std::strlen(flag)) == 0) {
+      peak_bandwidth = std::atof(argv[i] + std::strlen(flag));
+    } else {
+      args.push_back(argv[i]);
+    }
+  }
+  int benchmark_argc = static_cast<int>(args.size());
+  benchmark::Initialize(&benchmark_argc, args.data());
+
+  if (peak_bandwidth <= 0) {
+    peak_bandwidth = measure_peak_bandwidth();
+  }
+  std::cerr << at::get_parallel_info()
+            << "peak bandwidth: " << peak_bandwidth << " bytes/s" << std::endl;
+
+  static const std::vector<Op> ops = make_ops();
+  for (const Op& op : ops) {
+    for (at::ScalarType dtype : op.dtypes) {
+      for (const auto& sizes : op.shapes) {
+        for (bool transposed : {false, true}) {
+          for (int threads : thread_counts()) {
+            Config config{sizes, dtype, transposed, threads};
+            benchmark::RegisterBenchmark(
+                config_name(op.name, config).c_str(),
+                [&op, config](benchmark::State& state) { run(state, op, config); })
+                ->UseRealTime();
+          }
+        }
+      }
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
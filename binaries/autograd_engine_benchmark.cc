@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Time the autograd engine spends per function on graphs where the math is
+// negligible:
+//   chain   the long chain of small ops an LSTM cell unrolls to,
+//   fan_in  many producers feeding the gradient of one function.
+// Items are functions, so the reported items per second are the inverse of
+// the engine's time per function, e.g.
+//   autograd_engine_benchmark --benchmark_filter='fan_in'
+
+#include "benchmark/benchmark.h"
+
+#include <torch/torch.h>
+
+#include <vector>
+
+namespace {
+
+torch::Tensor chainLoss(const torch::Tensor& x, int64_t nodes) {
+  auto y = x;
+  for (int64_t i = 0; i < nodes; i++) {
+    y = y * 1.0001;
+  }
+  return y.sum();
+}
+
+torch::Tensor fanInLoss(const torch::Tensor& x, int64_t nodes) {
+  std::vector<torch::Tensor> branches;
+  for (int64_t i = 0; i < nodes; i++) {
+    branches.push_back(x * 1.0001);
+  }
+  return torch::stack(branches).sum();
+}
+
+using MakeLoss = torch::Tensor (*)(const torch::Tensor&, int64_t);
+
+void runBackward(benchmark::State& state, MakeLoss make) {
+  const auto nodes = state.range(0);
+  auto x = torch::ones({1}, torch::requires_grad());
+  auto loss = make(x, nodes);
+  // the first backward pass allocates the grad of x
+  loss.backward({}, /*keep_graph=*/true);
+  while (state.KeepRunning()) {
+    loss.backward({}, /*keep_graph=*/true);
+  }
+  // reported as the functions evaluated per second
+  state.SetItemsProcessed(state.iterations() * nodes);
+}
+
+} // namespace
+
+BENCHMARK_CAPTURE(runBackward, chain, chainLoss)
+    ->Arg(2000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(runBackward, fan_in, fanInLoss)
+    ->Arg(2000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -32,34 +32,97 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_bool(
+    use_key_ranges,
+    false,
+    "If true, split the db into one range of keys per reading thread, each "
+    "read with its own cursor.");
+C10_DEFINE_bool(
+    zero_copy,
+    false,
+    "If true, read values through views instead of copying them.");
+C10_DEFINE_int(
+    readahead,
+    0,
+    "If positive, the number of records the cursors prefetch.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
 using caffe2::db::DBReader;
+using caffe2::db::DBView;
 using caffe2::string;
 
-void TestThroughputWithDB() {
-  std::unique_ptr<DB> in_db(caffe2::db::CreateDB(
-      FLAGS_input_db_type, FLAGS_input_db, caffe2::db::READ));
-  std::unique_ptr<Cursor> cursor(in_db->NewCursor());
+std::unique_ptr<Cursor> MaybePrefetch(std::unique_ptr<Cursor> cursor) {
+  if (FLAGS_readahead > 0) {
+    cursor.reset(
+        new caffe2::db::PrefetchingCursor(std::move(cursor), FLAGS_readahead));
+  }
+  return cursor;
+}
+
+void TestThroughputWithCursor(Cursor* cursor, int thread_id) {
+  size_t bytes = 0;
   for (int iter_id = 0; iter_id < FLAGS_repeat; ++iter_id) {
     caffe2::Timer timer;
     for (int i = 0; i < FLAGS_report_interval; ++i) {
-      string key = cursor->key();
-      string value = cursor->value();
-      //VLOG(1) << "Key " << key;
-      cursor->Next();
       if (!cursor->Valid()) {
         cursor->SeekToFirst();
+        CAFFE_ENFORCE(cursor->Valid(), "Nothing to read.");
+      }
+      string key = cursor->key();
+      if (FLAGS_zero_copy) {
+        DBView value = cursor->valueView();
+        bytes += value.size();
+      } else {
+        string value = cursor->value();
+        bytes += value.size();
       }
+      //VLOG(1) << "Key " << key;
+      cursor->Next();
     }
     double elapsed_seconds = timer.Seconds();
     printf(
-        "Iteration %03d, took %4.5f seconds, throughput %f items/sec.\n",
+        "Thread %03d iteration %03d, took %4.5f seconds, "
+        "throughput %f items/sec.\n",
+        thread_id,
         iter_id,
         elapsed_seconds,
         FLAGS_report_interval / elapsed_seconds);
   }
+  VLOG(1) << "Thread " << thread_id << " read " << bytes << " bytes.";
+}
+
+void TestThroughputWithDB() {
+  std::unique_ptr<DB> in_db(caffe2::db::CreateDB(
+      FLAGS_input_db_type, FLAGS_input_db, caffe2::db::READ));
+  std::unique_ptr<Cursor> cursor = MaybePrefetch(in_db->NewCursor());
+  TestThroughputWithCursor(cursor.get(), 0);
+}
+
+void TestThroughputWithKeyRanges() {
+  std::unique_ptr<DB> in_db(caffe2::db::CreateDB(
+      FLAGS_input_db_type, FLAGS_input_db, caffe2::db::READ));
+  std::vector<string> splits;
+  {
+    std::unique_ptr<Cursor> cursor(in_db->NewCursor());
+    splits = caffe2::db::SplitKeyRanges(cursor.get(), FLAGS_num_read_threads);
+  }
+  std::vector<std::unique_ptr<Cursor>> cursors;
+  for (size_t i = 0; i <= splits.size(); ++i) {
+    std::unique_ptr<Cursor> cursor(new caffe2::db::RangeCursor(
+        std::unique_ptr<Cursor>(in_db->NewCursor()),
+        i == 0 ? string() : splits[i - 1],
+        i == splits.size() ? string() : splits[i]));
+    cursors.push_back(MaybePrefetch(std::move(cursor)));
+  }
+  std::vector<std::unique_ptr<std::thread>> reading_threads(cursors.size());
+  for (int i = 0; i < reading_threads.size(); ++i) {
+    reading_threads[i].reset(
+        new std::thread(TestThroughputWithCursor, cursors[i].get(), i));
+  }
+  for (int i = 0; i < reading_threads.size(); ++i) {
+    reading_threads[i]->join();
+  }
 }
 
 void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
@@ -97,6 +160,8 @@ int main(int argc, char** argv) {
   caffe2::GlobalInit(&argc, &argv);
   if (FLAGS_use_reader) {
     TestThroughputWithReader();
+  } else if (FLAGS_use_key_ranges) {
+    TestThroughputWithKeyRanges();
   } else {
     TestThroughputWithDB();
   }
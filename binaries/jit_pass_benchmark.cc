@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Compile-time benchmarks of JIT graph passes on large generated graphs,
+// shaped like the output of loop unrolling:
+//   unrolled  a long straight-line chain that repeats a few constants and
+//             computes every step twice,
+//   nested    the same, with every step inside a few levels of prim::If
+//             that recompute what the enclosing blocks already computed.
+// The graphs are swept over their number of steps and google-benchmark fits
+// the complexity of every pass, which should come out linear, e.g.
+//   jit_pass_benchmark --benchmark_filter='cse'
+
+#include "benchmark/benchmark.h"
+
+#include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/common_subexpression_elimination.h>
+#include <torch/csrc/jit/passes/constant_pooling.h>
+
+#include <memory>
+
+using torch::jit::Block;
+using torch::jit::Graph;
+using torch::jit::Node;
+using torch::jit::Value;
+using torch::jit::WithInsertPoint;
+namespace aten = torch::jit::aten;
+namespace prim = torch::jit::prim;
+
+namespace {
+
+// Indices of a loop unrolled by 8 repeat every 8 steps.
+Value* step(Graph& graph, Value* x, int64_t i) {
+  Value* c = graph.insertConstant(i % 8);
+  Value* a = graph.insert(aten::mul, {x, c});
+  Value* b = graph.insert(aten::mul, {x, c});
+  return graph.insert(aten::add, {a, b});
+}
+
+std::shared_ptr<Graph> unrolledGraph(int64_t steps) {
+  auto graph = std::make_shared<Graph>();
+  Value* x = graph->addInput()->setType(torch::jit::TensorType::get());
+  for (int64_t i = 0; i < steps; i++) {
+    x = step(*graph, x, i);
+  }
+  graph->registerOutput(x);
+  return graph;
+}
+
+Value* nestedStep(Graph& graph, Value* x, Value* cond, int64_t i, int depth) {
+  if (depth == 0) {
+    return step(graph, x, i);
+  }
+  Node* n = graph.insertNode(graph.create(prim::If, {cond}, 1));
+  n->output()->setType(torch::jit::TensorType::get());
+  Block* thenBlock = n->addBlock();
+  Block* elseBlock = n->addBlock();
+  {
+    WithInsertPoint guard(thenBlock);
+    thenBlock->registerOutput(nestedStep(graph, x, cond, i, depth - 1));
+  }
+  {
+    WithInsertPoint guard(elseBlock);
+    elseBlock->registerOutput(step(graph, x, i));
+  }
+  return n->output();
+}
+
+std::shared_ptr<Graph> nestedGraph(int64_t steps) {
+  auto graph = std::make_shared<Graph>();
+  Value* x = graph->addInput()->setType(torch::jit::TensorType::get());
+  Value* cond = graph->addInput()->setType(torch::jit::BoolType::get());
+  for (int64_t i = 0; i < steps; i++) {
+    // the outer step is what the nested blocks recompute
+    x = step(*graph, x, i);
+    x = nestedStep(*graph, x, cond, i, 3);
+  }
+  graph->registerOutput(x);
+  return graph;
+}
+
+size_t countNodes(Block* block) {
+  size_t count = 0;
+  for (Node* n : block->nodes()) {
+    count++;
+    for (Block* b : n->blocks()) {
+      count += countNodes(b);
+    }
+  }
+  return count;
+}
+
+using MakeGraph = std::shared_ptr<Graph> (*)(int64_t);
+using Pass = void (*)(std::shared_ptr<Graph>&);
+
+void runPass(benchmark::State& state, MakeGraph make, Pass pass) {
+  const auto graph = make(state.range(0));
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    auto copy = graph->copy();
+    state.ResumeTiming();
+    pass(copy);
+  }
+  state.SetComplexityN(state.range(0));
+  state.counters["nodes"] = countNodes(graph->block());
+}
+
+void cse(std::shared_ptr<Graph>& graph) {
+  torch::jit::EliminateCommonSubexpression(graph);
+}
+
+void constantPooling(std::shared_ptr<Graph>& graph) {
+  torch::jit::ConstantPooling(graph);
+}
+
+void aliasDb(std::shared_ptr<Graph>& graph) {
+  torch::jit::AliasDb db(graph);
+  benchmark::DoNotOptimize(db);
+}
+
+} // namespace
+
+#define JIT_PASS_BENCHMARK(name, make, pass)    \
+  BENCHMARK_CAPTURE(runPass, name, make, pass) \
+      ->RangeMultiplier(4)                      \
+      ->Range(256, 16384)                       \
+      ->Unit(benchmark::kMillisecond)           \
+      ->Complexity()
+
+JIT_PASS_BENCHMARK(cse/unrolled, unrolledGraph, cse);
+JIT_PASS_BENCHMARK(cse/nested, nestedGraph, cse);
+JIT_PASS_BENCHMARK(constant_pooling/unrolled, unrolledGraph, constantPooling);
+JIT_PASS_BENCHMARK(constant_pooling/nested, nestedGraph, constantPooling);
+JIT_PASS_BENCHMARK(alias_db/unrolled, unrolledGraph, aliasDb);
+JIT_PASS_BENCHMARK(alias_db/nested, nestedGraph, aliasDb);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,405 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Serving-style benchmark of a TorchScript module: runs forward on random
+// inputs of the given shapes from several concurrent request threads, for
+// every combination of intra-op thread count and concurrency, and reports
+// throughput and the latency distribution (mean, percentiles and a
+// histogram). With --profile, the ops of a few extra single-threaded
+// iterations are timed with the autograd profiler.
+//
+//   torchscript_benchmark --model=model.pt --input_dims="1,3,224,224" \
+//       --threads=1,4 --concurrency=1,8 --report_format=json
+
+#include <torch/script.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/profiler.h>
+
+#include <ATen/Parallel.h>
+#include <c10/util/Flags.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+C10_DEFINE_string(model, "", "The serialized TorchScript module to benchmark.");
+C10_DEFINE_string(
+    input_dims,
+    "",
+    "The dimensions of the inputs of forward, as comma separated numbers. "
+    "If multiple inputs are needed, use semicolon to separate the dimensions "
+    "of different tensors.");
+C10_DEFINE_string(
+    input_type,
+    "",
+    "The dtypes of the inputs (float/double/int64/int32/uint8), separated by "
+    "semicolons like input_dims. Defaults to float for all inputs.");
+C10_DEFINE_int(warmup, 10, "The number of warm up iterations of every request thread.");
+C10_DEFINE_int(iter, 100, "The number of timed iterations of every request thread.");
+C10_DEFINE_string(
+    threads,
+    "",
+    "Comma separated intra-op thread counts to benchmark. Defaults to the "
+    "current at::get_num_threads().");
+C10_DEFINE_int(
+    interop_threads,
+    0,
+    "The size of the inter-op thread pool, if positive. It can only be set "
+    "once per process.");
+C10_DEFINE_string(
+    concurrency,
+    "1",
+    "Comma separated numbers of request threads calling forward at once.");
+C10_DEFINE_bool(profile, false, "Whether to report a per-op time breakdown.");
+C10_DEFINE_int(profile_iter, 10, "The number of profiled iterations.");
+C10_DEFINE_string(report_format, "json", "The report format, json or csv.");
+C10_DEFINE_string(report_file, "", "Where to write the report. Defaults to stdout.");
+
+namespace {
+
+std::vector<std::string> split(const std::string& str, char separator) {
+  std::vector<std::string> pieces;
+  std::stringstream ss(str);
+  std::string piece;
+  while (std::getline(ss, piece, separator)) {
+    if (!piece.empty()) {
+      pieces.push_back(piece);
+    }
+  }
+  return pieces;
+}
+
+std::vector<int64_t> parse_ints(const std::string& str) {
+  std::vector<int64_t> values;
+  for (const auto& piece : split(str, ',')) {
+    values.push_back(std::stoll(piece));
+  }
+  return values;
+}
+
+at::ScalarType parse_dtype(const std::string& name) {
+  if (name == "float") {
+    return at::kFloat;
+  } else if (name == "double") {
+    return at::kDouble;
+  } else if (name == "int64") {
+    return at::kLong;
+  } else if (name == "int32") {
+    return at::kInt;
+  } else if (name == "uint8") {
+    return at::kByte;
+  }
+  AT_ERROR("unsupported input type: ", name);
+}
+
+std::vector<torch::jit::IValue> make_inputs() {
+  const auto dims = split(FLAGS_input_dims, ';');
+  const auto types = split(FLAGS_input_type, ';');
+  AT_CHECK(types.empty() || types.size() == dims.size(),
+           "input_type must name a type for every tensor of input_dims");
+  std::vector<torch::jit::IValue> inputs;
+  for (size_t i = 0; i < dims.size(); i++) {
+    const auto sizes = parse_ints(dims[i]);
+    const auto dtype = types.empty() ? at::kFloat : parse_dtype(types[i]);
+    if (at::isFloatingType(dtype)) {
+      inputs.emplace_back(torch::randn(sizes, at::TensorOptions(dtype)));
+    } else {
+      inputs.emplace_back(torch::randint(0, 10, sizes, at::TensorOptions(dtype)));
+    }
+  }
+  return inputs;
+}
+
+struct Result {
+  int64_t threads;
+  int64_t concurrency;
+  double seconds;
+  // per request, in milliseconds, sorted
+  std::vector<double> latencies;
+
+  double throughput() const {
+    return latencies.size() / seconds;
+  }
+  double mean() const {
+    double sum = 0;
+    for (double l : latencies) {
+      sum += l;
+    }
+    return sum / latencies.size();
+  }
+  double percentile(double p) const {
+    const size_t index = std::min(
+        latencies.size() - 1, static_cast<size_t>(p / 100 * latencies.size()));
+    return latencies[index];
+  }
+  // Counts of latencies in power-of-two buckets of milliseconds, as
+  // (upper bound, count) pairs that cover all latencies.
+  std::vector<std::pair<double, int64_t>> histogram() const {
+    std::vector<std::pair<double, int64_t>> buckets;
+    double bound = 1.0 / 64;
+    size_t i = 0;
+    while (i < latencies.size()) {
+      int64_t count = 0;
+      for (; i < latencies.size() && latencies[i] <= bound; i++) {
+        count++;
+      }
+      if (count > 0 || !buckets.empty()) {
+        buckets.emplace_back(bound, count);
+      }
+      bound *= 2;
+    }
+    return buckets;
+  }
+};
+
+// A request thread: sets up its thread-local state, warms up, waits for the
+// others, then times every forward.
+void request_loop(torch::jit::script::Module& module,
+                  const std::vector<torch::jit::IValue>& inputs,
+                  int64_t threads, std::mutex& mutex,
+                  std::condition_variable& cv, int& waiting, bool& start,
+                  std::vector<double>& latencies) {
+  // the intra-op thread count and NoGrad are per thread
+  at::set_num_threads(threads);
+  torch::autograd::AutoGradMode no_grad(false);
+  for (int i = 0; i < FLAGS_warmup; i++) {
+    module.forward(inputs);
+  }
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    waiting--;
+    cv.notify_all();
+    cv.wait(lock, [&] { return start; });
+  }
+  latencies.reserve(FLAGS_iter);
+  for (int i = 0; i < FLAGS_iter; i++) {
+    auto begin = std::chrono::steady_clock::now();
+    module.forward(inputs);
+    std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - begin;
+    latencies.push_back(elapsed.count());
+  }
+}
+
+Result benchmark(torch::jit::script::Module& module,
+                 const std::vector<torch::jit::IValue>& inputs,
+                 int64_t threads, int64_t concurrency) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  int waiting = concurrency;
+  bool start = false;
+  std::vector<std::vector<double>> latencies(concurrency);
+  std::vector<std::thread> workers;
+  for (int64_t i = 0; i < concurrency; i++) {
+    workers.emplace_back(
+        request_loop, std::ref(module), std::cref(inputs), threads,
+        std::ref(mutex), std::ref(cv), std::ref(waiting), std::ref(start),
+        std::ref(latencies[i]));
+  }
+  std::chrono::steady_clock::time_point begin;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return waiting == 0; });
+    start = true;
+    begin = std::chrono::steady_clock::now();
+  }
+  cv.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+  Result result{threads, concurrency, elapsed.count(), {}};
+  for (const auto& l : latencies) {
+    result.latencies.insert(result.latencies.end(), l.begin(), l.end());
+  }
+  std::sort(result.latencies.begin(), result.latencies.end());
+  return result;
+}
+
+struct OpStats {
+  int64_t count = 0;
+  // inclusive of the ops called from within, in milliseconds
+  double total_ms = 0;
+};
+
+// Runs forward under the CPU profiler and sums the time of every op name
+// over matching push/pop range pairs.
+std::vector<std::pair<std::string, OpStats>> profile(
+    torch::jit::script::Module& module,
+    const std::vector<torch::jit::IValue>& inputs) {
+  namespace profiler = torch::autograd::profiler;
+  torch::autograd::AutoGradMode no_grad(false);
+  profiler::enableProfiler(profiler::ProfilerConfig(profiler::ProfilerState::CPU, false));
+  for (int i = 0; i < FLAGS_profile_iter; i++) {
+    module.forward(inputs);
+  }
+  profiler::thread_event_lists event_lists = profiler::disableProfiler();
+
+  std::map<std::string, OpStats> stats;
+  for (auto& events : event_lists) {
+    std::vector<profiler::Event*> stack;
+    for (auto& event : events) {
+      if (event.event_kind() == profiler::EventKind::PushRange) {
+        stack.push_back(&event);
+      } else if (event.event_kind() == profiler::EventKind::PopRange && !stack.empty()) {
+        profiler::Event* push = stack.back();
+        stack.pop_back();
+        OpStats& s = stats[push->name()];
+        s.count++;
+        s.total_ms += push->cpu_elapsed_us(event) / 1000;
+      }
+    }
+  }
+  std::vector<std::pair<std::string, OpStats>> sorted(stats.begin(), stats.end());
+  std::sort(sorted.begin(), sorted.end(),
+            [](const std::pair<std::string, OpStats>& a, const std::pair<std::string, OpStats>& b) {
+              return a.second.total_ms > b.second.total_ms;
+            });
+  return sorted;
+}
+
+std::string json_escape(const std::string& str) {
+  std::string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void write_json(std::ostream& out, const std::vector<Result>& results,
+                const std::vector<std::pair<std::string, OpStats>>& ops) {
+  out << "{\n  \"model\": \"" << json_escape(FLAGS_model) << "\",\n"
+      << "  \"interop_threads\": " << at::get_num_interop_threads() << ",\n"
+      << "  \"results\": [";
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& r = results[i];
+    out << (i ? "," : "") << "\n    {\"threads\": " << r.threads
+        << ", \"concurrency\": " << r.concurrency
+        << ", \"requests\": " << r.latencies.size()
+        << ", \"throughput_per_s\": " << r.throughput()
+        << ", \"latency_ms\": {\"mean\": " << r.mean()
+        << ", \"min\": " << r.latencies.front()
+        << ", \"p50\": " << r.percentile(50)
+        << ", \"p90\": " << r.percentile(90)
+        << ", \"p99\": " << r.percentile(99)
+        << ", \"max\": " << r.latencies.back() << "}"
+        << ", \"histogram\": [";
+    const auto histogram = r.histogram();
+    for (size_t b = 0; b < histogram.size(); b++) {
+      out << (b ? ", " : "") << "{\"le_ms\": " << histogram[b].first
+          << ", \"count\": " << histogram[b].second << "}";
+    }
+    out << "]}";
+  }
+  out << "\n  ],\n  \"ops\": [";
+  for (size_t i = 0; i < ops.size(); i++) {
+    out << (i ? "," : "") << "\n    {\"name\": \"" << json_escape(ops[i].first)
+        << "\", \"count\": " << ops[i].second.count
+        << ", \"total_ms\": " << ops[i].second.total_ms << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+void write_csv(std::ostream& out, const std::vector<Result>& results,
+               const std::vector<std::pair<std::string, OpStats>>& ops) {
+  out << "threads,concurrency,requests,throughput_per_s,"
+      << "mean_ms,min_ms,p50_ms,p90_ms,p99_ms,max_ms\n";
+  for (const Result& r : results) {
+    out << r.threads << "," << r.concurrency << "," << r.latencies.size() << ","
+        << r.throughput() << "," << r.mean() << "," << r.latencies.front() << ","
+        << r.percentile(50) << "," << r.percentile(90) << ","
+        << r.percentile(99) << "," << r.latencies.back() << "\n";
+  }
+  if (!ops.empty()) {
+    out << "\nop,count,total_ms\n";
+    for (const auto& op : ops) {
+      out << "\"" << op.first << "\"," << op.second.count << "," << op.second.total_ms << "\n";
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  c10::SetUsageMessage("Benchmarks a TorchScript module. See the flags for details.");
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags" << std::endl;
+    return 1;
+  }
+  AT_CHECK(!FLAGS_model.empty(), "--model is required");
+  AT_CHECK(FLAGS_iter > 0, "--iter must be positive");
+  AT_CHECK(FLAGS_report_format == "json" || FLAGS_report_format == "csv",
+           "--report_format must be json or csv");
+
+  if (FLAGS_interop_threads > 0) {
+    at::set_num_interop_threads(FLAGS_interop_threads);
+  }
+  at::init_num_threads();
+
+  auto module = torch::jit::load(FLAGS_model);
+  const auto inputs = make_inputs();
+
+  std::vector<int64_t> thread_counts = parse_ints(FLAGS_threads);
+  if (thread_counts.empty()) {
+    thread_counts.push_back(at::get_num_threads());
+  }
+  const std::vector<int64_t> concurrencies = parse_ints(FLAGS_concurrency);
+  AT_CHECK(!concurrencies.empty(), "--concurrency must not be empty");
+
+  std::vector<Result> results;
+  for (int64_t threads : thread_counts) {
+    for (int64_t concurrency : concurrencies) {
+      results.push_back(benchmark(*module, inputs, threads, concurrency));
+      const Result& r = results.back();
+      std::cerr << "threads " << threads << " concurrency " << concurrency
+                << ": " << r.throughput() << " requests/s, p50 "
+                << r.percentile(50) << " ms, p99 " << r.percentile(99) << " ms"
+                << std::endl;
+    }
+  }
+
+  std::vector<std::pair<std::string, OpStats>> ops;
+  if (FLAGS_profile) {
+    at::set_num_threads(thread_counts.front());
+    ops = profile(*module, inputs);
+  }
+
+  std::ofstream file;
+  if (!FLAGS_report_file.empty()) {
+    file.open(FLAGS_report_file);
+    AT_CHECK(file, "could not open ", FLAGS_report_file);
+  }
+  std::ostream& out = FLAGS_report_file.empty() ? std::cout : file;
+  if (FLAGS_report_format == "json") {
+    write_json(out, results, ops);
+  } else {
+    write_csv(out, results, ops);
+  }
+  return 0;
+}
@@ -1,6 +1,10 @@
 #include <c10/core/CPUAllocator.h>
 #include <c10/core/DeviceType.h>
 
+#ifndef _MSC_VER
+#include <sys/mman.h>
+#endif
+
 // TODO: rename flags to C10
 C10_DEFINE_bool(
     caffe2_report_cpu_memory_usage,
@@ -60,8 +64,9 @@ void* alloc_cpu(size_t nbytes) {
       "DefaultCPUAllocator: not enough memory: you tried to allocate %dGB. Buy new RAM!",
       nbytes / 1073741824);
 
-  // move data to a thread's NUMA node
-  NUMAMove(data, nbytes, GetCurrentNUMANode());
+  // move data to the NUMA node picked by the NUMA policy, by default the
+  // thread's node
+  NUMAMove(data, nbytes, GetNUMAAllocationNode());
   CHECK(
       !FLAGS_caffe2_cpu_allocator_do_zero_fill ||
       !FLAGS_caffe2_cpu_allocator_do_junk_fill)
@@ -83,27 +88,56 @@ void free_cpu(void* data) {
 #endif
 }
 
-// A virtual struct that is used to report C10's memory allocation and
-// deallocation status
-class C10_API MemoryAllocationReporter {
- public:
-  MemoryAllocationReporter() : allocated_(0) {}
-  void New(void* ptr, size_t nbytes);
-  void Delete(void* ptr);
-
- private:
-  std::mutex mutex_;
-  std::unordered_map<void*, size_t> size_table_;
-  size_t allocated_;
+#ifndef _MSC_VER
+namespace {
+
+struct MappedZeroedMemory {
+  void* data;
+  size_t nbytes;
 };
 
+void free_mapped_zeroed(void* ctx) {
+  auto* mapping = static_cast<MappedZeroedMemory*>(ctx);
+  munmap(mapping->data, mapping->nbytes);
+  delete mapping;
+}
+
+} // namespace
+#endif
+
+at::DataPtr alloc_zeroed_cpu(size_t nbytes) {
+  const at::Device device(at::DeviceType::CPU);
+#ifndef _MSC_VER
+  // Memory reporting and junk filling need the regular allocation path.
+  if (nbytes >= kZeroedMmapThreshold && !FLAGS_caffe2_report_cpu_memory_usage &&
+      !FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    void* data = mmap(
+        nullptr,
+        nbytes,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0);
+    if (data != MAP_FAILED) {
+      auto* mapping = new MappedZeroedMemory{data, nbytes};
+      return {data, mapping, &free_mapped_zeroed, device};
+    }
+  }
+#endif
+  void* data = alloc_cpu(nbytes);
+  if (data && !FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(data, 0, nbytes);
+  }
+  return {data, data, &free_cpu, device};
+}
+
 struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
     void* data = alloc_cpu(nbytes);
     if (FLAGS_caffe2_report_cpu_memory_usage && nbytes > 0) {
-      getMemoryAllocationReporter().New(data, nbytes);
+      GetMemoryAllocationReporter().New(data, nbytes);
       return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
     }
     return {data, data, &free_cpu, at::Device(at::DeviceType::CPU)};
@@ -113,7 +147,7 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
     if (!ptr) {
       return;
     }
-    getMemoryAllocationReporter().Delete(ptr);
+    GetMemoryAllocationReporter().Delete(ptr);
     free_cpu(ptr);
   }
 
@@ -123,13 +157,6 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
     }
     return &free_cpu;
   }
-
- protected:
-  static MemoryAllocationReporter& getMemoryAllocationReporter() {
-    static MemoryAllocationReporter reporter_;
-    return reporter_;
-  }
-
 };
 
 void NoDelete(void*) {}
@@ -151,6 +178,11 @@ at::Allocator* GetDefaultCPUAllocator() {
 
 REGISTER_ALLOCATOR(DeviceType::CPU, &g_cpu_alloc);
 
+MemoryAllocationReporter& GetMemoryAllocationReporter() {
+  static MemoryAllocationReporter reporter_;
+  return reporter_;
+}
+
 void MemoryAllocationReporter::New(void* ptr, size_t nbytes) {
   std::lock_guard<std::mutex> guard(mutex_);
   size_table_[ptr] = nbytes;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstring>
+#include <mutex>
 #include <unordered_map>
 
 #include <c10/core/Allocator.h>
@@ -30,6 +31,17 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
+// Allocations of at least this many bytes are served by alloc_zeroed_cpu
+// with anonymous pages straight from the kernel.
+constexpr size_t kZeroedMmapThreshold = 128 * 1024;
+
+// Allocate nbytes of zeroed CPU memory.  Large allocations are mapped
+// anonymously, so that the kernel hands out zero pages lazily and pages that
+// are never touched cost no memset and no physical memory; smaller ones are
+// allocated with alloc_cpu and cleared.  The returned DataPtr owns its own
+// deleter, which is not the raw deleter of any allocator.
+C10_API at::DataPtr alloc_zeroed_cpu(size_t nbytes);
+
 // Get the CPU Alloctor.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
@@ -39,4 +51,22 @@ C10_API void SetCPUAllocator(at::Allocator* alloc);
 // Get the Default CPU Allocator
 C10_API at::Allocator* GetDefaultCPUAllocator();
 
+// A virtual struct that is used to report C10's memory allocation and
+// deallocation status
+class C10_API MemoryAllocationReporter {
+ public:
+  MemoryAllocationReporter() : allocated_(0) {}
+  void New(void* ptr, size_t nbytes);
+  void Delete(void* ptr);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> size_table_;
+  size_t allocated_;
+};
+
+// Get the reporter shared by the CPU allocators; only used if
+// FLAGS_caffe2_report_cpu_memory_usage is set.
+C10_API MemoryAllocationReporter& GetMemoryAllocationReporter();
+
 } // namespace c10
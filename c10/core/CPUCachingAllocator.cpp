@@ -0,0 +1,278 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/DeviceType.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 64;  // all sizes are rounded to at least 64 bytes
+constexpr size_t kSmallSize = 512;    // sizes up to 512 bytes are rounded to 64 bytes
+constexpr size_t kNumSmallClasses = kSmallSize / kMinBlockSize;
+// four size classes for every power of two above kSmallSize
+constexpr size_t kNumSizeClasses = kNumSmallClasses + 4 * (64 - 9);
+// largest block kept in the per-thread caches
+constexpr size_t kMaxThreadCachedSize = 262144;      // 256 KiB
+// per-thread cap on cached bytes, the rest goes back to the global pool
+constexpr size_t kMaxThreadCachedBytes = 4194304;    // 4 MiB
+
+// Every block starts with a header recording its size class, so that the
+// deleter (a plain function pointer) knows where to return it. The header
+// takes up a full alignment unit so the user pointer stays aligned.
+struct alignas(gAlignment) BlockHeader {
+  size_t size_class;
+  size_t nbytes;
+};
+static_assert(sizeof(BlockHeader) == gAlignment, "BlockHeader must be gAlignment bytes");
+
+size_t highest_bit(size_t n) {
+  size_t bit = 0;
+  while (n >>= 1) {
+    ++bit;
+  }
+  return bit;
+}
+
+size_t size_class_of(size_t nbytes) {
+  if (nbytes <= kSmallSize) {
+    return nbytes == 0 ? 0 : (nbytes - 1) / kMinBlockSize;
+  }
+  size_t n = nbytes - 1;
+  size_t bit = highest_bit(n);
+  return kNumSmallClasses + 4 * (bit - 9) + ((n >> (bit - 2)) & 3);
+}
+
+size_t class_size(size_t size_class) {
+  if (size_class < kNumSmallClasses) {
+    return (size_class + 1) * kMinBlockSize;
+  }
+  size_t bit = (size_class - kNumSmallClasses) / 4 + 9;
+  size_t step = (size_class - kNumSmallClasses) % 4;
+  return (4 + step + 1) << (bit - 2);
+}
+
+void update_peak(std::atomic<uint64_t>& peak, uint64_t value) {
+  uint64_t prev = peak.load();
+  while (prev < value && !peak.compare_exchange_weak(prev, value)) {
+  }
+}
+
+struct GlobalPool {
+  std::mutex mutex;
+  std::array<std::vector<BlockHeader*>, kNumSizeClasses> free_blocks;
+
+  std::atomic<uint64_t> allocated_bytes{0};
+  std::atomic<uint64_t> peak_allocated_bytes{0};
+  std::atomic<uint64_t> reserved_bytes{0};
+  std::atomic<uint64_t> peak_reserved_bytes{0};
+  std::atomic<uint64_t> cached_bytes{0};
+  std::atomic<uint64_t> num_allocs{0};
+  std::atomic<uint64_t> num_cache_hits{0};
+
+  BlockHeader* pop(size_t size_class) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& blocks = free_blocks[size_class];
+    if (blocks.empty()) {
+      return nullptr;
+    }
+    auto block = blocks.back();
+    blocks.pop_back();
+    return block;
+  }
+
+  void push(BlockHeader* block) {
+    std::lock_guard<std::mutex> lock(mutex);
+    free_blocks[block->size_class].push_back(block);
+  }
+
+  void release(BlockHeader* block) {
+    auto size = class_size(block->size_class) + sizeof(BlockHeader);
+    cached_bytes -= size;
+    reserved_bytes -= size;
+    free_cpu(block);
+  }
+
+  void empty() {
+    std::vector<BlockHeader*> blocks;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto& list : free_blocks) {
+        blocks.insert(blocks.end(), list.begin(), list.end());
+        list.clear();
+      }
+    }
+    for (auto block : blocks) {
+      release(block);
+    }
+  }
+};
+
+// Intentionally leaked so that thread caches can flush into it while the
+// process is shutting down.
+GlobalPool& global_pool() {
+  static GlobalPool* pool = new GlobalPool();
+  return *pool;
+}
+
+struct ThreadCache {
+  std::array<std::vector<BlockHeader*>, kNumSizeClasses> free_blocks;
+  size_t cached_bytes = 0;
+
+  ~ThreadCache() {
+    flush();
+  }
+
+  BlockHeader* pop(size_t size_class) {
+    auto& blocks = free_blocks[size_class];
+    if (blocks.empty()) {
+      return nullptr;
+    }
+    auto block = blocks.back();
+    blocks.pop_back();
+    cached_bytes -= class_size(size_class);
+    return block;
+  }
+
+  bool push(BlockHeader* block) {
+    auto size = class_size(block->size_class);
+    if (size > kMaxThreadCachedSize ||
+        cached_bytes + size > kMaxThreadCachedBytes) {
+      return false;
+    }
+    free_blocks[block->size_class].push_back(block);
+    cached_bytes += size;
+    return true;
+  }
+
+  void flush() {
+    auto& pool = global_pool();
+    for (auto& blocks : free_blocks) {
+      for (auto block : blocks) {
+        pool.push(block);
+      }
+      blocks.clear();
+    }
+    cached_bytes = 0;
+  }
+};
+
+ThreadCache& thread_cache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+void* cached_alloc(size_t nbytes) {
+  auto& pool = global_pool();
+  auto size_class = size_class_of(nbytes);
+  BlockHeader* block = nullptr;
+  if (class_size(size_class) <= kMaxThreadCachedSize) {
+    block = thread_cache().pop(size_class);
+  }
+  if (!block) {
+    block = pool.pop(size_class);
+  }
+  auto block_size = class_size(size_class) + sizeof(BlockHeader);
+  if (block) {
+    pool.cached_bytes -= block_size;
+    ++pool.num_cache_hits;
+  } else {
+    block = static_cast<BlockHeader*>(alloc_cpu(block_size));
+    block->size_class = size_class;
+    update_peak(pool.peak_reserved_bytes, pool.reserved_bytes += block_size);
+  }
+  block->nbytes = nbytes;
+  ++pool.num_allocs;
+  update_peak(pool.peak_allocated_bytes, pool.allocated_bytes += nbytes);
+
+  void* data = block + 1;
+  if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+    memset(data, 0, nbytes);
+  } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+    memset_junk(data, nbytes);
+  }
+  return data;
+}
+
+void cached_free(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  auto& pool = global_pool();
+  auto block = static_cast<BlockHeader*>(ptr) - 1;
+  pool.allocated_bytes -= block->nbytes;
+  pool.cached_bytes += class_size(block->size_class) + sizeof(BlockHeader);
+  if (!thread_cache().push(block)) {
+    pool.push(block);
+  }
+}
+
+void ReportAndDelete(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  GetMemoryAllocationReporter().Delete(ptr);
+  cached_free(ptr);
+}
+
+struct CachingCPUAllocator final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes == 0) {
+      return {nullptr, nullptr, &cached_free, at::Device(at::DeviceType::CPU)};
+    }
+    void* data = cached_alloc(nbytes);
+    if (FLAGS_caffe2_report_cpu_memory_usage) {
+      GetMemoryAllocationReporter().New(data, nbytes);
+      return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
+    }
+    return {data, data, &cached_free, at::Device(at::DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    if (FLAGS_caffe2_report_cpu_memory_usage) {
+      return &ReportAndDelete;
+    }
+    return &cached_free;
+  }
+};
+
+CachingCPUAllocator caching_allocator;
+
+} // namespace
+
+Allocator* get() {
+  return &caching_allocator;
+}
+
+void emptyCache() {
+  thread_cache().flush();
+  global_pool().empty();
+}
+
+Stats getStats() {
+  auto& pool = global_pool();
+  Stats stats;
+  stats.allocated_bytes = pool.allocated_bytes;
+  stats.peak_allocated_bytes = pool.peak_allocated_bytes;
+  stats.reserved_bytes = pool.reserved_bytes;
+  stats.peak_reserved_bytes = pool.peak_reserved_bytes;
+  stats.cached_bytes = pool.cached_bytes;
+  stats.num_allocs = pool.num_allocs;
+  stats.num_cache_hits = pool.num_cache_hits;
+  return stats;
+}
+
+void resetPeakStats() {
+  auto& pool = global_pool();
+  pool.peak_allocated_bytes = pool.allocated_bytes.load();
+  pool.peak_reserved_bytes = pool.reserved_bytes.load();
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// A caching allocator for CPU memory, meant for workloads (e.g. inference)
+// that allocate and free buffers of the same few sizes over and over.
+//
+// Requests are rounded up to a size class (four classes per power of two, so
+// at most 25% is wasted) and freed blocks are kept in a per size class free
+// list instead of being returned to the system. Each thread keeps a small
+// cache of recently freed small blocks that is used without any locking;
+// everything else goes through a global, mutex protected pool.
+//
+// The allocator is opt-in:
+//
+//   c10::SetCPUAllocator(c10::CPUCachingAllocator::get());
+//
+// Memory already handed out by the default allocator stays valid, it is
+// freed by the deleter it was allocated with.
+namespace CPUCachingAllocator {
+
+struct Stats {
+  // bytes requested by live allocations
+  uint64_t allocated_bytes = 0;
+  uint64_t peak_allocated_bytes = 0;
+  // bytes held by the allocator, in use or cached, including rounding
+  uint64_t reserved_bytes = 0;
+  uint64_t peak_reserved_bytes = 0;
+  // bytes sitting in free lists, ready to be reused
+  uint64_t cached_bytes = 0;
+  uint64_t num_allocs = 0;
+  // allocations served from a free list rather than the system
+  uint64_t num_cache_hits = 0;
+};
+
+C10_API Allocator* get();
+
+// Returns the cached blocks of the global pool and of the calling thread's
+// cache to the system. Blocks cached by other threads are released when
+// those threads exit.
+C10_API void emptyCache();
+
+C10_API Stats getStats();
+C10_API void resetPeakStats();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+// Memory format is not the property of a Tensor. It is the way to tell an
+// operator how the result should be organized in memory and nothing more.
+// That means memory format should never be used as return value for any
+// tensor state interrogation functions (internally and externally).
+//
+// Possible options are:
+//  Contiguous:
+//    Regular C style contiguous memory layout, the strides of the tensor are
+//    decreasing from the outermost to the innermost dimension.
+//
+//  ChannelsLast:
+//    Only valid for 4-dimensional (N, C, H, W) tensors. The channels are the
+//    innermost dimension in memory (NHWC order), i.e. the strides are
+//    (H * W * C, 1, W * C, C). This is the layout preferred by the cuDNN
+//    tensor core kernels and by the MKL-DNN convolution primitives.
+
+namespace c10 {
+enum class MemoryFormat : int8_t { Contiguous, ChannelsLast };
+
+inline std::ostream& operator<<(
+    std::ostream& stream,
+    at::MemoryFormat memory_format) {
+  switch (memory_format) {
+    case MemoryFormat::Contiguous:
+      return stream << "Contiguous";
+    case MemoryFormat::ChannelsLast:
+      return stream << "ChannelsLast";
+    default:
+      AT_ERROR("Unknown memory format");
+  }
+}
+
+// The strides of a channels last tensor of the given (N, C, H, W) sizes.
+// Like the contiguous strides, sizes of zero are treated as one, so the
+// strides stay meaningful for empty tensors.
+inline std::vector<int64_t> get_channels_last_strides(IntArrayRef sizes) {
+  AT_CHECK(
+      sizes.size() == 4,
+      "ChannelsLast memory format is only supported for 4-dimensional tensors, "
+      "got a tensor with ",
+      sizes.size(),
+      " dimensions");
+  std::vector<int64_t> strides(sizes.size());
+  strides[1] = 1;
+  strides[3] = std::max<int64_t>(sizes[1], 1);
+  strides[2] = strides[3] * std::max<int64_t>(sizes[3], 1);
+  strides[0] = strides[2] * std::max<int64_t>(sizes[2], 1);
+  return strides;
+}
+
+} // namespace c10
@@ -42,7 +42,6 @@ TensorImpl::TensorImpl(TensorTypeId type_id, const caffe2::TypeMeta& data_type,
 TensorImpl::TensorImpl(Storage&& storage, TensorTypeId type_id, const caffe2::TypeMeta& data_type,
                        c10::optional<c10::Device> device_opt)
     : storage_(std::move(storage)),
-      sizes_{0},
       storage_offset_(0),
       numel_(0),
       data_type_(data_type),
@@ -52,15 +51,14 @@ TensorImpl::TensorImpl(Storage&& storage, TensorTypeId type_id, const caffe2::Ty
             device_opt_.has_value());
   // we would also like to check that non-cpu devices have an index, but some Caffe2 operators create
   // Storages with default devices.
-  strides_.push_back(1);
 }
 
 IntArrayRef TensorImpl::sizes() const {
-  return sizes_;
+  return sizes_and_strides_.sizes_arrayref();
 }
 
 IntArrayRef TensorImpl::strides() const {
-  return strides_;
+  return sizes_and_strides_.strides_arrayref();
 }
 
 bool TensorImpl::compute_contiguous() const {
@@ -81,6 +79,31 @@ bool TensorImpl::compute_contiguous() const {
   return is_contiguous;
 }
 
+bool TensorImpl::compute_channels_last_contiguous() const {
+  if (dim() != 4) {
+    return false;
+  }
+  // Test the sizes rather than numel_: update_to_contiguous_strides calls
+  // this before the number of elements is refreshed.
+  for (auto s : sizes()) {
+    if (s == 0) {
+      return true;
+    }
+  }
+  // Walk the dimensions from the innermost in memory (C) to the outermost (N).
+  int64_t z = 1;
+  for (auto d : {1, 3, 2, 0}) {
+    if (size(d) != 1) {
+      if (stride(d) == z) {
+        z *= size(d);
+      } else {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 void TensorImpl::release_resources() {
   if (storage_) {
     storage_ = {};
@@ -88,17 +111,17 @@ void TensorImpl::release_resources() {
 }
 
 int64_t TensorImpl::dim() const {
-  return sizes_.size();
+  return sizes_and_strides_.size();
 }
 
 int64_t TensorImpl::size(int64_t d) const {
   d = at::maybe_wrap_dim(d, dim(), false);
-  return sizes_[d];
+  return sizes_and_strides_.size_at(d);
 }
 
 int64_t TensorImpl::stride(int64_t d) const {
   d = at::maybe_wrap_dim(d, dim(), false);
-  return strides_[d];
+  return sizes_and_strides_.stride_at(d);
 }
 
 TensorImpl* TensorImpl::maybe_zero_dim(bool condition_when_zero_dim) {
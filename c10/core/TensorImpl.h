@@ -5,11 +5,13 @@
 #include <numeric>
 
 #include <c10/core/Backend.h>
+#include <c10/core/MemoryFormat.h>
 #include <c10/core/Storage.h>
 #include <c10/core/TensorOptions.h>
 #include <c10/core/TensorTypeId.h>
 #include <c10/core/TensorTypeIdRegistration.h>
 #include <c10/core/CopyBytes.h>
+#include <c10/core/impl/SizesAndStrides.h>
 
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
@@ -95,6 +97,21 @@ inline int canonical_axis_index_(int axis_index, int ndims) {
   return axis_index;
 }
 
+/**
+ * Returns how many items a buffer that currently holds `current` items must
+ * grow to in order to hold `required` items. The buffer grows by at least
+ * growthPct percent, so that growing it one step at a time takes amortized
+ * O(1) time per step.
+ */
+inline int64_t grown_capacity(
+    int64_t current,
+    int64_t required,
+    float growthPct) {
+  return std::max<int64_t>(
+      required,
+      static_cast<int64_t>(std::ceil(current * (growthPct + 100) / 100)));
+}
+
 using PlacementDtor = void (*)(void*, size_t);
 
 /*
@@ -381,11 +398,20 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    * Tensors with non-trivial strides are not contiguous.  See
    * compute_contiguous() for the exact definition of whether or not
    * a tensor is contiguous or not.
+   *
+   * With MemoryFormat::ChannelsLast, whether or not the tensor is a 4-d
+   * tensor laid out densely in (N, H, W, C) order; see
+   * compute_channels_last_contiguous().
    */
-  virtual bool is_contiguous() const {
+  virtual bool is_contiguous(
+      at::MemoryFormat memory_format = at::MemoryFormat::Contiguous) const {
 #ifdef DEBUG
     AT_ASSERT(compute_contiguous() == is_contiguous_);
+    AT_ASSERT(compute_channels_last_contiguous() == is_channels_last_contiguous_);
 #endif
+    if (memory_format == at::MemoryFormat::ChannelsLast) {
+      return is_channels_last_contiguous_;
+    }
     return is_contiguous_;
   }
 
@@ -736,8 +762,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    */
   virtual void resize_dim(int64_t ndim) {
     AT_CHECK(allow_tensor_metadata_change(), "resize_dim is not allowed on Tensor created from .data or .detach()");
-    sizes_.resize(ndim, 0);
-    strides_.resize(ndim, 0);
+    sizes_and_strides_.resize(ndim);
     refresh_numel();
     refresh_contiguous();
   }
@@ -752,7 +777,9 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    */
   virtual void set_size(int64_t dim, int64_t new_size) {
     AT_CHECK(allow_tensor_metadata_change(), "set_size is not allowed on Tensor created from .data or .detach()");
-    sizes_.at(dim) = new_size;
+    AT_CHECK(dim >= 0 && static_cast<size_t>(dim) < sizes_and_strides_.size(),
+        "set_size: dimension ", dim, " is out of range for a tensor of dimension ", this->dim());
+    sizes_and_strides_.size_at(dim) = new_size;
     refresh_numel();
     refresh_contiguous();
   }
@@ -765,7 +792,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    */
   virtual void set_stride(int64_t dim, int64_t new_stride) {
     AT_CHECK(allow_tensor_metadata_change(), "set_stride is not allowed on Tensor created from .data or .detach()");
-    strides_[dim] = new_stride;
+    sizes_and_strides_.stride_at(dim) = new_stride;
     refresh_numel();
     refresh_contiguous();
   }
@@ -795,18 +822,45 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
   void set_sizes_contiguous(IntArrayRef new_size) {
     AT_CHECK(allow_tensor_metadata_change(), "set_sizes_contiguous is not allowed on Tensor created from .data or .detach()");
     AT_ASSERT(!is_variable());  // TODO: remove this when Variable and Tensor are merged
-    auto old_dim = sizes_.size();
-    auto new_dim = new_size.size();
-
-    sizes_.resize(new_dim);
-    for (size_t dim = 0; dim < new_dim; ++dim) {
-      sizes_[dim] = new_size[dim];
-    }
+    auto old_dim = sizes_and_strides_.size();
+    sizes_and_strides_.set_sizes(new_size);
 
     update_to_contiguous_strides(old_dim);
     refresh_numel();
   }
 
+  /**
+   * Replace the strides of a freshly allocated tensor by the strides of its
+   * sizes in the requested memory format, e.g. to lay out the result of
+   * empty() in channels last order.  The sizes and the number of elements are
+   * not changed, so the storage stays large enough.
+   *
+   * WARNING: This function reinterprets whatever data is in the storage, so
+   * it is only meaningful on a tensor whose data has not been written yet.
+   *
+   * WARNING: It is NOT valid to call this method on a Variable.
+   * See Note [We regret making Variable hold a Tensor]
+   */
+  void empty_tensor_restride(MemoryFormat memory_format) {
+    AT_CHECK(allow_tensor_metadata_change(), "empty_tensor_restride is not allowed on Tensor created from .data or .detach()");
+    AT_ASSERT(!is_variable());  // TODO: remove this when Variable and Tensor are merged
+    switch (memory_format) {
+      case MemoryFormat::Contiguous: {
+        update_to_contiguous_strides(sizes_and_strides_.size());
+        break;
+      }
+      case MemoryFormat::ChannelsLast: {
+        auto new_strides = get_channels_last_strides(sizes());
+        sizes_and_strides_.resize(new_strides.size());
+        std::copy(new_strides.begin(), new_strides.end(), sizes_and_strides_.strides_begin());
+        refresh_contiguous();
+        break;
+      }
+      default:
+        AT_ERROR("Unsupported memory format ", memory_format, " for a new tensor");
+    }
+  }
+
   /**
    * Set the sizes and strides of a tensor.
    *
@@ -829,25 +883,23 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
         ")");
     auto new_dim = new_size.size();
 
-    sizes_.resize(new_dim);
-    for (size_t dim = 0; dim < new_dim; ++dim) {
-      sizes_[dim] = new_size[dim];
-    }
+    sizes_and_strides_.set_sizes(new_size);
 
-    strides_.resize(new_dim);
     if (new_dim > 0) {
       for (size_t dim = new_dim - 1; ; dim--) {
         if (new_stride[dim] >= 0) {
-          strides_[dim] = new_stride[dim];
+          sizes_and_strides_.stride_at(dim) = new_stride[dim];
         } else {
           // XXX: This behavior is surprising and may need to be removed to
           // support negative strides. Some pytorch functions rely on it:
           // for example, torch.cat (run TestTorch.test_cat_empty).
           if (dim == new_dim - 1) {
-            strides_[dim] = 1;
+            sizes_and_strides_.stride_at(dim) = 1;
           } else {
             // Keep stride monotonically increasing to match NumPy.
-            strides_[dim] = std::max<int64_t>(sizes_[dim + 1], 1) * strides_[dim + 1];
+            sizes_and_strides_.stride_at(dim) =
+                std::max<int64_t>(sizes_and_strides_.size_at(dim + 1), 1) *
+                sizes_and_strides_.stride_at(dim + 1);
           }
         }
         if (dim == 0) break;
@@ -873,6 +925,19 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    */
   bool is_variable() const { return autograd_meta_ != nullptr; };
 
+  /**
+   * Whether space was reserved for this tensor to grow into, through
+   * Extend(), ReserveSpace() or at::Tensor::reserve_(). Resizing a reserved
+   * tensor grows its storage geometrically and never frees it.
+   */
+  bool reserved() const {
+    return reserved_;
+  }
+
+  void set_reserved(bool reserved) {
+    reserved_ = reserved;
+  }
+
   /**
    * Set whether a tensor allows changes to its metadata (e.g. sizes / strides / storage / storage_offset).
    */
@@ -983,12 +1048,12 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    * This op is auto-asynchronous if the underlying device (CUDA) supports it.
    */
   void Extend(int64_t num, float growthPct) {
-    AT_ASSERT(sizes_.size() >= 1u);
+    AT_ASSERT(sizes_and_strides_.size() >= 1u);
     AT_ASSERTM(num >= 0, "`num` must be non-negative for Extend");
     AT_ASSERTM(
         is_contiguous_,
         "Right now Extend is only supported for contiguous Tensor.");
-    auto newDims = sizes_;
+    SmallVector<int64_t, 5> newDims(sizes().begin(), sizes().end());
     newDims[0] += num;
     if (!storage_.data()) {
       Resize(newDims);
@@ -1000,16 +1065,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
         static_cast<int64_t>(1),
         std::multiplies<int64_t>());
     if (newNumel * storage_.itemsize() <= storage_.capacity()) {
-      sizes_ = newDims;
+      sizes_and_strides_.set_sizes(newDims);
       numel_ = newNumel;
       return;
     }
-    auto newCapacity = sizes_;
-    newCapacity[0] = std::max<size_t>(
-        newDims[0], std::ceil(sizes_[0] * (growthPct + 100) / 100));
+    SmallVector<int64_t, 5> newCapacity(sizes().begin(), sizes().end());
+    newCapacity[0] =
+        grown_capacity(sizes_and_strides_.size_at(0), newDims[0], growthPct);
     auto oldData = std::move(storage_.data_ptr());
     auto oldSize = numel_;
-    auto oldDims = sizes_;
     Resize(newCapacity);
     auto* newData = raw_mutable_data(data_type_);
     if (data_type_.copy()) {
@@ -1036,7 +1100,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
           true); // non-blocking
     }
     reserved_ = true;
-    sizes_ = newDims;
+    sizes_and_strides_.set_sizes(newDims);
     numel_ = newNumel;
   }
 
@@ -1053,7 +1117,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
         "Right now ReserveSpace is only supported for contiguous Tensor.");
     AT_ASSERTM(
         storage_.unique(), "Can't call ReserveSpace on shared storage.");
-    auto newCapacity = sizes_;
+    SmallVector<int64_t, 5> newCapacity(sizes().begin(), sizes().end());
     newCapacity[0] = outer_dim;
     auto newNumel = std::accumulate(
         newCapacity.begin(),
@@ -1066,11 +1130,11 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     // Old data is discarded
     storage_.data_ptr().clear();
     auto oldSize = numel_;
-    auto oldDims = sizes_;
+    SmallVector<int64_t, 5> oldDims(sizes().begin(), sizes().end());
     Resize(newCapacity);
     // Allocate new memory but don't copy over the data
     raw_mutable_data(data_type_);
-    sizes_ = oldDims;
+    sizes_and_strides_.set_sizes(oldDims);
     numel_ = oldSize;
     reserved_ = true;
   }
@@ -1139,8 +1203,8 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
         " The old caffe2 mixes Reshape and Resize but this behavior has "
         "been changed. If you find this error, most likely you will need "
         "to change corresponding code from Reshape to Resize.");
-    auto old_dim = sizes_.size();
-    sizes_ = dims;
+    auto old_dim = sizes_and_strides_.size();
+    sizes_and_strides_.set_sizes(dims);
     update_to_contiguous_strides(old_dim);
   }
 
@@ -1357,12 +1421,12 @@ private:
       typename = typename std::enable_if<std::is_integral<T>::value>::type>
   bool SetDimsTemplate(ArrayRef<T> src) {
     auto old_numel = numel_;
-    auto old_dim = sizes_.size();
-    sizes_.resize(src.size());
+    auto old_dim = sizes_and_strides_.size();
+    sizes_and_strides_.resize(src.size());
     int64_t new_numel = 1;
     for (size_t i = 0; i < src.size(); ++i) {
       new_numel *= src[i];
-      sizes_[i] = src[i];
+      sizes_and_strides_.size_at(i) = src[i];
     }
     update_to_contiguous_strides(old_dim);
     numel_ = new_numel;
@@ -1402,15 +1466,16 @@ private:
   }
 
   inline void update_to_contiguous_strides(size_t old_dim) {
-    strides_.resize(sizes_.size(), 0);
     if (dim() > 0) {
       int last_idx = dim() - 1;
-      strides_[last_idx] = 1;
+      sizes_and_strides_.stride_at(last_idx) = 1;
       for (auto i = last_idx - 1; i >= 0; --i) {
-        strides_[i] = strides_[i + 1] * std::max<int64_t>(sizes_[i + 1], 1);
+        sizes_and_strides_.stride_at(i) = sizes_and_strides_.stride_at(i + 1) *
+            std::max<int64_t>(sizes_and_strides_.size_at(i + 1), 1);
       }
     }
     is_contiguous_ = true;
+    is_channels_last_contiguous_ = compute_channels_last_contiguous();
   }
 
   /**
@@ -1430,6 +1495,13 @@ private:
    */
   bool compute_contiguous() const;
 
+  /**
+   * Compute whether or not a tensor is a 4-d tensor whose strides are the
+   * channels last strides of its sizes (see get_channels_last_strides), up to
+   * the strides of dimensions of size one.
+   */
+  bool compute_channels_last_contiguous() const;
+
 protected:
   /**
    * Recompute the cached numel of a tensor.  Call this if you modify sizes.
@@ -1446,6 +1518,7 @@ protected:
   void refresh_contiguous() {
     AT_ASSERT(!is_variable());  // TODO: remove this when Variable and Tensor are merged
     is_contiguous_ = compute_contiguous();
+    is_channels_last_contiguous_ = compute_channels_last_contiguous();
   }
 
 protected:
@@ -1460,18 +1533,14 @@ protected:
 
   PyObject* pyobj_ = nullptr; // weak reference
 
-  // We could save a word or two by combining the SmallVector structs,
-  // since their size is redundant, and if we need to overflow the buffer space
-  // we could keep the two pointers together. However, that would require
-  // implementing another struct from scratch, so only do this if we're desperate.
-  SmallVector<int64_t,5> sizes_;
-  SmallVector<int64_t,5> strides_;
+  // Sizes and strides share their length and a single buffer, see
+  // SizesAndStrides.
+  c10::impl::SizesAndStrides sizes_and_strides_;
 
   int64_t storage_offset_ = 0;
-  // If sizes and strides are empty, the numel is 1!!  However, most of the
-  // time, we will immediately set sizes to {0} and reset numel to 0.
-  // (Can't do that in the default initializers, because there's no way to
-  // spell "allocate a one-element array" for strides_).
+  // If sizes and strides are empty, the numel is 1!!  However, the sizes
+  // start out as {0} (see SizesAndStrides), so the constructors reset numel
+  // to 0.
   int64_t numel_ = 1;
 
   // INVARIANT: When storage is non-null, this type meta must
@@ -1493,6 +1562,7 @@ protected:
   // should pack this into a bitfield.
   TensorTypeId type_id_;
   bool is_contiguous_ = true;
+  bool is_channels_last_contiguous_ = false;
   bool is_wrapped_number_ = false;
 
   // Previously, if we change the tensor metadata (e.g. sizes / strides / storage / storage_offset)
@@ -1547,22 +1617,17 @@ protected:
 //    version counter (word 0)
 //    version counter (word 1)
 //    PyObject pointer
-//    sizes SmallVector (begin)
-//    sizes SmallVector (end)
-//    sizes SmallVector (capacity)
-//    sizes SmallVector (pre-allocated 0)
-//    sizes SmallVector (pre-allocated 1)
-//    sizes SmallVector (pre-allocated 2)
-//    sizes SmallVector (pre-allocated 3)
-//    sizes SmallVector (pre-allocated 4)
-//    strides SmallVector (begin)
-//    strides SmallVector (end)
-//    strides SmallVector (capacity)
-//    strides SmallVector (pre-allocated 0)
-//    strides SmallVector (pre-allocated 1)
-//    strides SmallVector (pre-allocated 2)
-//    strides SmallVector (pre-allocated 3)
-//    strides SmallVector (pre-allocated 4)
+//    SizesAndStrides size
+//    SizesAndStrides sizes (pre-allocated 0)
+//    SizesAndStrides sizes (pre-allocated 1)
+//    SizesAndStrides sizes (pre-allocated 2)
+//    SizesAndStrides sizes (pre-allocated 3)
+//    SizesAndStrides sizes (pre-allocated 4)
+//    SizesAndStrides strides (pre-allocated 0)
+//    SizesAndStrides strides (pre-allocated 1)
+//    SizesAndStrides strides (pre-allocated 2)
+//    SizesAndStrides strides (pre-allocated 3)
+//    SizesAndStrides strides (pre-allocated 4)
 //    storage offset
 //    numel
 //    data type pointer
@@ -1570,7 +1635,7 @@ protected:
 //    miscellaneous bitfield
 //
 static_assert(sizeof(void*) != sizeof(int64_t) || // if 64-bit...
-              sizeof(TensorImpl) == sizeof(int64_t) * 29,
+              sizeof(TensorImpl) == sizeof(int64_t) * 24,
               "You changed the size of TensorImpl on 64-bit arch."
               "See Note [TensorImpl size constraints] on how to proceed.");
 
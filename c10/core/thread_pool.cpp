@@ -3,12 +3,14 @@
 namespace c10 {
 
 ThreadPool::ThreadPool(std::size_t pool_size, int numa_node_id)
-    : threads_(pool_size),
+    : num_tasks_(0),
+      threads_(pool_size),
       running_(true),
       complete_(true),
       available_(threads_.size()),
       total_(threads_.size()),
       numa_node_id_(numa_node_id) {
+  skipped_.fill(0);
   for (std::size_t i = 0; i < threads_.size(); ++i) {
     threads_[i] = std::thread(std::bind(&ThreadPool::main_loop, this, i));
   }
@@ -48,15 +50,78 @@ bool ThreadPool::inThreadPool() const {
 }
 
 void ThreadPool::run(const std::function<void()>& func) {
+  runWithPriority(func, TaskPriority::NORMAL);
+}
+
+void ThreadPool::runWithPriority(
+    std::function<void()> func,
+    TaskPriority priority) {
   std::unique_lock<std::mutex> lock(mutex_);
 
   // Set task and signal condition variable so that a worker thread will
   // wake up and use the task.
-  tasks_.push(task_element_t(func));
-  complete_ = false;
+  push_task(task_element_t(std::move(func)), priority);
   condition_.notify_one();
 }
 
+void ThreadPool::runBatch(
+    std::vector<std::function<void()>> funcs,
+    TaskPriority priority) {
+  if (funcs.empty()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto& func : funcs) {
+    push_task(task_element_t(std::move(func)), priority);
+  }
+  // Wake up as many workers as there are tasks, at most all of them.
+  if (funcs.size() >= available_) {
+    condition_.notify_all();
+  } else {
+    for (size_t i = 0; i < funcs.size(); ++i) {
+      condition_.notify_one();
+    }
+  }
+}
+
+void ThreadPool::push_task(task_element_t task, TaskPriority priority) {
+  tasks_[static_cast<size_t>(priority)].push_back(std::move(task));
+  ++num_tasks_;
+  complete_ = false;
+}
+
+ThreadPool::task_element_t ThreadPool::pop_task() {
+  // Take the task of the highest priority, unless a lower priority queue was
+  // skipped too often. Skipping the queues of a lower priority counts against
+  // them only while they have tasks waiting.
+  size_t picked = kNumTaskPriorities;
+  for (size_t i = kNumTaskPriorities; i-- > 0;) {
+    if (!tasks_[i].empty() && skipped_[i] >= kMaxSkippedTasks) {
+      picked = i;
+      break;
+    }
+  }
+  if (picked == kNumTaskPriorities) {
+    for (size_t i = 0; i < kNumTaskPriorities; ++i) {
+      if (!tasks_[i].empty()) {
+        picked = i;
+        break;
+      }
+    }
+  }
+  for (size_t i = picked + 1; i < kNumTaskPriorities; ++i) {
+    if (!tasks_[i].empty()) {
+      ++skipped_[i];
+    }
+  }
+  skipped_[picked] = 0;
+
+  task_element_t task = std::move(tasks_[picked].front());
+  tasks_[picked].pop_front();
+  --num_tasks_;
+  return task;
+}
+
 void ThreadPool::waitWorkComplete() {
   std::unique_lock<std::mutex> lock(mutex_);
   while (!complete_) {
@@ -71,7 +136,7 @@ void ThreadPool::main_loop(std::size_t index) {
   while (running_) {
     // Wait on condition variable while the task is empty and
     // the pool is still running.
-    while (tasks_.empty() && running_) {
+    while (num_tasks_ == 0 && running_) {
       condition_.wait(lock);
     }
     // If pool is no longer running, break out of loop.
@@ -85,8 +150,7 @@ void ThreadPool::main_loop(std::size_t index) {
     // useful in the event that the function contains
     // shared_ptr arguments bound via bind.
     {
-      auto tasks = tasks_.front();
-      tasks_.pop();
+      auto tasks = pop_task();
       // Decrement count, indicating thread is no longer available.
       --available_;
 
@@ -108,7 +172,7 @@ void ThreadPool::main_loop(std::size_t index) {
 
       // Increment count, indicating thread is available.
       ++available_;
-      if (tasks_.empty() && available_ == total_) {
+      if (num_tasks_ == 0 && available_ == total_) {
         complete_ = true;
         completed_.notify_one();
       }
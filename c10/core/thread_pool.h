@@ -1,11 +1,13 @@
 #pragma once
 
+#include <array>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <mutex>
-#include <queue>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <c10/util/Optional.h>
 #include <c10/util/intrusive_ptr.h>
@@ -18,11 +20,45 @@ namespace ivalue {
 struct Future;
 } // namespace ivalue
 
+/**
+ * Workers pick the tasks of a higher priority first. Tasks submitted without
+ * a priority are NORMAL.
+ */
+enum class TaskPriority : uint8_t {
+  HIGH = 0,
+  NORMAL = 1,
+  LOW = 2,
+};
+
+constexpr size_t kNumTaskPriorities = 3;
+
 // TODO: move this to C10 and make it C10_API
 class C10_API TaskThreadPoolBase {
  public:
   virtual void run(const std::function<void()>& func) = 0;
 
+  /**
+   * Runs func with the given priority. Pools without priorities run it like
+   * any other task.
+   */
+  virtual void runWithPriority(
+      std::function<void()> func,
+      TaskPriority /* priority */) {
+    run(func);
+  }
+
+  /**
+   * Submits all of funcs at once. Pools that support it take their lock and
+   * wake up their workers once for the whole batch instead of once per task.
+   */
+  virtual void runBatch(
+      std::vector<std::function<void()>> funcs,
+      TaskPriority priority = TaskPriority::NORMAL) {
+    for (auto& func : funcs) {
+      runWithPriority(std::move(func), priority);
+    }
+  }
+
   virtual size_t size() const = 0;
 
   /**
@@ -40,18 +76,30 @@ class C10_API TaskThreadPoolBase {
 
 class C10_API ThreadPool : public c10::TaskThreadPoolBase {
  protected:
+  // Tasks are moved in and out of the queues, so the captures of a function
+  // that doesn't fit in the small buffer of std::function are allocated once.
   struct task_element_t {
     bool run_with_id;
-    const std::function<void()> no_id;
-    const std::function<void(std::size_t)> with_id;
+    std::function<void()> no_id;
+    std::function<void(std::size_t)> with_id;
 
-    explicit task_element_t(const std::function<void()>& f)
-        : run_with_id(false), no_id(f), with_id(nullptr) {}
-    explicit task_element_t(const std::function<void(std::size_t)>& f)
-        : run_with_id(true), no_id(nullptr), with_id(f) {}
+    explicit task_element_t(std::function<void()> f)
+        : run_with_id(false), no_id(std::move(f)), with_id(nullptr) {}
+    explicit task_element_t(std::function<void(std::size_t)> f)
+        : run_with_id(true), no_id(nullptr), with_id(std::move(f)) {}
   };
 
-  std::queue<task_element_t> tasks_;
+  // A task of a lower priority that waits while this many tasks of a higher
+  // priority are picked before it is picked next, so that a steady stream of
+  // high priority tasks can't starve it.
+  static constexpr std::size_t kMaxSkippedTasks = 16;
+
+  // One queue per priority, all guarded by mutex_.
+  std::array<std::deque<task_element_t>, kNumTaskPriorities> tasks_;
+  // Number of tasks picked from a higher priority queue since a task was last
+  // picked from this one while it wasn't empty.
+  std::array<std::size_t, kNumTaskPriorities> skipped_;
+  std::size_t num_tasks_;
   std::vector<std::thread> threads_;
   std::mutex mutex_;
   std::condition_variable condition_;
@@ -79,15 +127,22 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
 
   void run(const std::function<void()>& func) override;
 
+  void runWithPriority(std::function<void()> func, TaskPriority priority)
+      override;
+
+  void runBatch(
+      std::vector<std::function<void()>> funcs,
+      TaskPriority priority = TaskPriority::NORMAL) override;
+
   template <typename Task>
   void runTaskWithID(Task task) {
     std::unique_lock<std::mutex> lock(mutex_);
 
     // Set task and signal condition variable so that a worker thread will
     // wake up and use the task.
-    tasks_.push(
-        task_element_t(static_cast<std::function<void(std::size_t)>>(task)));
-    complete_ = false;
+    push_task(
+        task_element_t(static_cast<std::function<void(std::size_t)>>(task)),
+        TaskPriority::NORMAL);
     condition_.notify_one();
   }
 
@@ -100,6 +155,12 @@ class C10_API ThreadPool : public c10::TaskThreadPoolBase {
  private:
   // @brief Entry point for pool threads.
   void main_loop(std::size_t index);
+
+  // Requires mutex_.
+  void push_task(task_element_t task, TaskPriority priority);
+  // Removes the next task to run from the queues. Requires mutex_ and a
+  // task in the queues.
+  task_element_t pop_task();
 };
 
 C10_API void setNumThreads(size_t v);
@@ -3,19 +3,30 @@
 #include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/util/StaticTracepoint.h>
 #include <c10/util/UniqueVoidPtr.h>
 
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <cstdlib>
 #include <deque>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDART_VERSION) && \
+    CUDART_VERSION >= 10020
+#include <cuda.h>
+#define C10_CUDA_EXPANDABLE_SEGMENTS_SUPPORTED
+#endif
+
 namespace c10 {
 
 C10_DEFINE_REGISTRY(FreeCudaMemoryCallbacksRegistry, FreeMemoryCallback);
@@ -49,6 +60,52 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Stream groups (setStreamGroup):
+// - Cached blocks are normally only reused by the stream that allocated them.
+//   A group of streams can share one pool instead: a block freed by one
+//   member gets an event recorded on its stream, and a member that reuses it
+//   waits on that event with cudaStreamWaitEvent, without blocking the host.
+// - A block keeps at most one such event per stream, and completed events
+//   are dropped whenever blocks are merged or reused.
+// - When a stream joins a group, the blocks of its own pool move to the
+//   group's pool.
+//
+// Expandable segments (PYTORCH_CUDA_ALLOC_CONF=expandable_segments:True,
+// CUDA 10.2+):
+// - Instead of cudaMalloc'ing separate segments, large allocations on a
+//   (device, stream) pair are carved out of a single range of virtual
+//   addresses that is reserved up front and backed by physical pages that
+//   are mapped in on demand at its end (cuMemCreate/cuMemMap).
+// - Because all large blocks of a stream live in one contiguous segment,
+//   freed blocks always merge with their free neighbours, and the free space
+//   at the end of a segment can grow to fit a bigger request instead of
+//   forcing a new, separately fragmented cudaMalloc.
+// - When memory is released (emptyCache or out of memory), the free pages
+//   at the end of a segment are unmapped so the segment shrinks again.
+// - Small allocations still use the 2 MiB small pool. Memory of expandable
+//   segments can't be shared through CUDA IPC.
+//
+// CUDA IPC (getIpcMemHandle, getIpcDevPtr):
+// - Tensors are shared as an offset into the segment they were carved out
+//   of. The IPC handle of a segment is only computed on its first share and
+//   kept until the segment is cudaFree'd.
+// - A receiving process maps every segment once, for all the tensors in it.
+//   The mapping is closed when the last of them goes away, unless
+//   PYTORCH_CUDA_ALLOC_CONF=ipc_cache_size:N is set: then the N most recently
+//   used mappings stay open (until emptyCache), so that segments a producer
+//   keeps sending aren't mapped again for every tensor. Mappings kept open
+//   also keep the memory of the segment alive if the producer frees it.
+//
+// Private pools (notifyCaptureBegin, CUDA 10.1+):
+// - While a stream is captured into a CUDA graph, its allocations are served
+//   from a pool keyed by a fake stream that belongs to the graph instead of
+//   the pool of the stream. The blocks of a private pool are neither reused
+//   outside of captures into it nor returned to CUDA while it is in use, so
+//   the addresses baked into the graph stay valid for its replays.
+// - Private pools don't use events: blocks freed during a capture are reused
+//   by later allocations of the capture, which the graph orders after the
+//   kernels that used them. They never use expandable segments either.
+//
 
 
 
@@ -92,13 +149,84 @@ struct DeviceStats {
   }
 };
 
+struct AllocatorConfig {
+  bool expandable_segments = false;
+  size_t ipc_cache_size = 0;
+
+  // Parses a comma separated list of key:value pairs, e.g.
+  // PYTORCH_CUDA_ALLOC_CONF=expandable_segments:True
+  AllocatorConfig() {
+    const char* env = std::getenv("PYTORCH_CUDA_ALLOC_CONF");
+    if (!env) {
+      return;
+    }
+    std::string conf(env);
+    size_t begin = 0;
+    while (begin < conf.size()) {
+      size_t end = conf.find(',', begin);
+      if (end == std::string::npos) {
+        end = conf.size();
+      }
+      std::string option = conf.substr(begin, end - begin);
+      size_t sep = option.find(':');
+      AT_CHECK(
+          sep != std::string::npos,
+          "Invalid PYTORCH_CUDA_ALLOC_CONF option, expected key:value but got: ",
+          option);
+      std::string key = option.substr(0, sep);
+      std::string value = option.substr(sep + 1);
+      if (key == "expandable_segments") {
+        AT_CHECK(
+            value == "True" || value == "False",
+            "Expected True or False for expandable_segments but got: ",
+            value);
+        expandable_segments = value == "True";
+#ifndef C10_CUDA_EXPANDABLE_SEGMENTS_SUPPORTED
+        if (expandable_segments) {
+          AT_WARN(
+              "expandable_segments requires CUDA 10.2 or newer, ignoring it");
+          expandable_segments = false;
+        }
+#endif
+      } else if (key == "ipc_cache_size") {
+        size_t pos = 0;
+        int64_t size = -1;
+        try {
+          size = std::stoll(value, &pos);
+        } catch (const std::exception&) {
+        }
+        AT_CHECK(
+            pos == value.size() && size >= 0,
+            "Expected a non-negative integer for ipc_cache_size but got: ",
+            value);
+        ipc_cache_size = size;
+      } else {
+        AT_ERROR("Unrecognized PYTORCH_CUDA_ALLOC_CONF option: ", key);
+      }
+      begin = end + 1;
+    }
+  }
+};
+
 struct Block;
+struct ExpandableSegment;
 typedef bool (*Comparison)(const Block*, const Block*);
 typedef std::set<Block*, Comparison> BlockPool;
 
+// CUDA events are pooled by the allocator; an EventPtr returns its event to
+// the pool once the last reference goes away.
+typedef std::shared_ptr<std::remove_pointer<cudaEvent_t>::type> EventPtr;
+
+// Marks the point at which a block was freed on a stream of a shared pool
+struct FreeEvent {
+  EventPtr event;
+  cudaStream_t stream;
+};
+
 struct Block {
   int           device;      // gpu
-  cudaStream_t  stream;      // allocation stream
+  cudaStream_t  stream;      // stream of the pool the block belongs to
+  cudaStream_t  alloc_stream; // stream of the current / last allocation
   stream_set    stream_uses; // streams on which the block was used
   size_t        size;        // block size in bytes
   BlockPool*    pool;        // owning memory pool
@@ -107,17 +235,156 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* segment; // owning expandable segment, if any
+  // work that has to complete before the block is reused by another stream
+  std::vector<FreeEvent> free_events;
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
-    device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    device(device), stream(stream), alloc_stream(stream), stream_uses(),
+    size(size), pool(pool), ptr(ptr), allocated(0), prev(nullptr),
+    next(nullptr), event_count(0), segment(nullptr) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
-    device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    device(device), stream(stream), alloc_stream(stream), stream_uses(),
+    size(size), pool(nullptr), ptr(nullptr), allocated(0), prev(nullptr),
+    next(nullptr), event_count(0), segment(nullptr) { }
 };
 
+#ifdef C10_CUDA_EXPANDABLE_SEGMENTS_SUPPORTED
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                    \
+  do {                                                                 \
+    CUresult __err = EXPR;                                             \
+    if (__err != CUDA_SUCCESS) {                                       \
+      const char* err_str;                                             \
+      cuGetErrorString(__err, &err_str);                               \
+      AT_ERROR("CUDA driver error: ", err_str);                        \
+    }                                                                  \
+  } while (0)
+
+// A range of virtual addresses reserved for the large blocks of one
+// (device, pool stream) pair. Physical memory is mapped in granularity sized
+// pages, one allocation handle per page, so the mapped prefix
+// [ptr, ptr + mapped_size) can grow and shrink page by page.
+struct ExpandableSegment {
+  ExpandableSegment(int device, cudaStream_t stream)
+      : device(device), stream(stream), base(0), reserved_size(0),
+        granularity(0), mapped_size(0), tail(nullptr) {
+    prop = CUmemAllocationProp();
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    C10_CUDA_DRIVER_CHECK(cuMemGetAllocationGranularity(
+        &granularity, &prop, CU_MEM_ALLOC_GRANULARITY_MINIMUM));
+
+    // Reserve enough addresses to map all of the device's memory
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+    reserved_size = round_up(device_total);
+    C10_CUDA_DRIVER_CHECK(
+        cuMemAddressReserve(&base, reserved_size, 0, 0, 0));
+    handles.resize(reserved_size / granularity, 0);
+  }
+
+  size_t round_up(size_t size) const {
+    return granularity * ((size + granularity - 1) / granularity);
+  }
+
+  void* ptr() const {
+    return reinterpret_cast<void*>(base);
+  }
+
+  // Maps pages at the end of the segment until at least `size` more bytes
+  // are mapped. Returns the number of bytes that were mapped, or 0 if the
+  // device ran out of memory (nothing is mapped in that case).
+  size_t grow(size_t size) {
+    size = round_up(size);
+    if (mapped_size + size > reserved_size) {
+      return 0;
+    }
+    size_t first_page = mapped_size / granularity;
+    size_t last_page = (mapped_size + size) / granularity;
+    for (size_t i = first_page; i < last_page; ++i) {
+      CUmemGenericAllocationHandle handle;
+      CUresult err = cuMemCreate(&handle, granularity, &prop, 0);
+      if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+        for (size_t j = first_page; j < i; ++j) {
+          release_page(j);
+        }
+        return 0;
+      }
+      C10_CUDA_DRIVER_CHECK(err);
+      C10_CUDA_DRIVER_CHECK(
+          cuMemMap(base + i * granularity, granularity, 0, handle, 0));
+      handles[i] = handle;
+    }
+    CUmemAccessDesc desc;
+    desc.location = prop.location;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(
+        cuMemSetAccess(base + mapped_size, size, &desc, 1));
+    mapped_size += size;
+    return size;
+  }
+
+  // Unmaps all pages past `offset` (rounded up to a page boundary) and
+  // returns the number of bytes released.
+  size_t unmap(size_t offset) {
+    offset = round_up(offset);
+    if (offset >= mapped_size) {
+      return 0;
+    }
+    // Pages can only be unmapped once the work using them is done, which
+    // may run on any stream sharing the pool
+    CUDAGuard device_guard(device);
+    C10_CUDA_CHECK(cudaDeviceSynchronize());
+    for (size_t i = offset / granularity; i < mapped_size / granularity; ++i) {
+      release_page(i);
+    }
+    size_t released = mapped_size - offset;
+    mapped_size = offset;
+    return released;
+  }
+
+  void release_page(size_t i) {
+    C10_CUDA_DRIVER_CHECK(cuMemUnmap(base + i * granularity, granularity));
+    C10_CUDA_DRIVER_CHECK(cuMemRelease(handles[i]));
+    handles[i] = 0;
+  }
+
+  int device;
+  cudaStream_t stream;
+  CUmemAllocationProp prop;
+  CUdeviceptr base;
+  size_t reserved_size;
+  size_t granularity;
+  size_t mapped_size;
+  std::vector<CUmemGenericAllocationHandle> handles;
+  // block ending at ptr() + mapped_size, nullptr if nothing is mapped
+  Block* tail;
+};
+
+#else
+
+// Placeholder so that the allocator compiles without the CUDA VMM API;
+// AllocatorConfig never enables expandable segments in that case.
+struct ExpandableSegment {
+  ExpandableSegment(int device, cudaStream_t stream)
+      : device(device), mapped_size(0), tail(nullptr) {
+    AT_ERROR("expandable segments are not supported by this build");
+  }
+  void* ptr() const { return nullptr; }
+  size_t grow(size_t size) { return 0; }
+  size_t unmap(size_t offset) { return 0; }
+  int device;
+  size_t mapped_size;
+  Block* tail;
+};
+
+#endif // C10_CUDA_EXPANDABLE_SEGMENTS_SUPPORTED
+
 static bool BlockComparator(const Block* a, const Block* b)
 {
   if (a->device != b->device) {
@@ -173,8 +440,50 @@ struct THCCachingAllocator
   // allocated blocks by device pointer
   std::unordered_map<void*, Block*> allocated_blocks;
 
-  // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
+  // outstanding cuda events of recordStream uses, by the device and stream
+  // they were recorded on. Events on one stream complete in order, so each
+  // queue is only polled up to its first pending event.
+  std::map<std::pair<int, cudaStream_t>,
+           std::deque<std::pair<EventPtr, Block*>>> cuda_events;
+
+  // unused events by device, reused instead of creating new ones
+  std::vector<std::vector<cudaEvent_t>> event_pools;
+
+  // streams allocating from the pool of another stream (see setStreamGroup)
+  std::unordered_map<cudaStream_t, cudaStream_t> stream_groups;
+
+  // streams whose pool is shared with other streams
+  std::unordered_set<cudaStream_t> shared_pools;
+
+  AllocatorConfig config;
+
+  // IPC handles of the segments shared with other processes, by base address
+  std::unordered_map<void*, std::string> ipc_handles;
+
+  // ring buffer of allocator events, only filled while record_history is set
+  bool record_history = false;
+  ContextRecorder context_recorder = nullptr;
+  size_t alloc_trace_max_entries = 1;
+  size_t alloc_trace_next = 0;
+  std::vector<TraceEntry> alloc_trace;
+
+  // expandable segments by device and stream; never destroyed, like the
+  // cached blocks, since the driver may be gone by the time this is
+  std::map<std::pair<int, cudaStream_t>, ExpandableSegment*>
+      expandable_segments;
+
+  // private pools of CUDA graphs, by device and pool id
+  struct PrivatePool {
+    int use_count;
+    cudaStream_t key; // stream the blocks of the pool are keyed by
+  };
+  std::map<std::pair<int, uint64_t>, PrivatePool> graph_pools;
+
+  // keys of the private pools that are still in use
+  std::unordered_set<cudaStream_t> live_graph_pools;
+
+  // private pool key of each stream capture in progress
+  std::unordered_map<unsigned long long, cudaStream_t> capture_pools;
 
   THCCachingAllocator() :
       large_blocks(BlockComparator),
@@ -203,6 +512,11 @@ struct THCCachingAllocator
 
     DeviceStats &stats = get_stats_for_device(device);
 
+    // the stream whose pool serves the request, which is what blocks are
+    // keyed by; alloc_stream is the one the memory is used on
+    cudaStream_t alloc_stream = stream;
+    stream = get_pool_stream(stream);
+
     Block search_key(device, stream, size);
     auto& pool = get_pool(size);
 
@@ -228,6 +542,22 @@ struct THCCachingAllocator
         block = find_free_block();
       }
     }
+    if (block == nullptr && config.expandable_segments &&
+        &pool == &large_blocks && !live_graph_pools.count(stream)) {
+      block = expand_segment_retry(device, stream, size);
+      if (block == nullptr) {
+        size_t device_free;
+        size_t device_total;
+        C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+        AT_ERROR(
+          "CUDA out of memory. Tried to allocate ", format_size(size),
+          " (GPU ", device, "; ",
+          format_size(device_total), " total capacity; ",
+          format_size(stats.amount_allocated), " already allocated; ",
+          format_size(device_free), " free; ",
+          format_size(stats.amount_cached - stats.amount_allocated), " cached)");
+      }
+    }
     if (block == nullptr) {
       void* ptr;
       size_t alloc_size = get_allocation_size(size);
@@ -270,16 +600,32 @@ struct THCCachingAllocator
         }
       }
       stats.increaseCached(alloc_size);
+      C10_SDT(cuda_segment_alloc, device, ptr, alloc_size, stream);
       block = new Block(device, stream, alloc_size, &pool, ptr);
+      if (record_history) {
+        record_trace(TraceEntry::SEGMENT_ALLOC, device, ptr, alloc_size,
+            stream);
+      }
     }
 
     Block* remaining = nullptr;
     AT_ASSERT(block);
+    // Order the new use after the work that was pending when the block (or
+    // the blocks merged into it) was last freed on other streams. The
+    // remaining part of a split keeps its events for its own next use.
+    drop_completed_events(block->free_events);
+    for (const FreeEvent& free_event : block->free_events) {
+      if (free_event.stream != alloc_stream) {
+        C10_CUDA_CHECK(
+            cudaStreamWaitEvent(alloc_stream, free_event.event.get(), 0));
+      }
+    }
     if (should_split(block, size)) {
 
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->segment = remaining->segment;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -292,12 +638,21 @@ struct THCCachingAllocator
       pool.insert(remaining);
     }
 
+    if (!remaining) {
+      block->free_events.clear();
+    }
+    block->alloc_stream = alloc_stream;
     block->allocated = true;
     allocated_blocks[block->ptr] = block;
 
     *devPtr = block->ptr;
 
     stats.increaseAllocated(block->size);
+    C10_SDT(cuda_malloc, device, block->ptr, block->size, alloc_stream);
+    if (record_history) {
+      record_trace(TraceEntry::ALLOC, block->device, block->ptr, block->size,
+          block->alloc_stream);
+    }
   }
 
   void free(void* ptr)
@@ -317,6 +672,26 @@ struct THCCachingAllocator
     block->allocated = false;
 
     get_stats_for_device(block->device).decreaseAllocated(block->size);
+    C10_SDT(cuda_free, block->device, block->ptr, block->size,
+        block->alloc_stream);
+    if (record_history) {
+      record_trace(TraceEntry::FREE, block->device, block->ptr, block->size,
+          block->alloc_stream);
+    }
+    if (live_graph_pools.count(block->stream)) {
+      // The graph orders the later uses of the block by its capture, and
+      // recording events on a capturing stream would add them to the graph
+      block->stream_uses.clear();
+      free_block(block);
+      return;
+    }
+    if (shared_pools.count(block->stream)) {
+      // Other streams of the pool may only reuse the block once the work
+      // queued so far on the allocation stream is done
+      add_free_event(block->free_events,
+          FreeEvent{record_event(block->device, block->alloc_stream),
+                    block->alloc_stream});
+    }
     if (!block->stream_uses.empty()) {
       insert_events(block);
     } else {
@@ -331,6 +706,219 @@ struct THCCachingAllocator
     synchronize_and_free_events(nullopt);
     free_blocks(large_blocks, large_blocks.begin(), large_blocks.end());
     free_blocks(small_blocks, small_blocks.begin(), small_blocks.end());
+    for (auto& it : expandable_segments) {
+      shrink_segment(it.second);
+    }
+    for (auto& events : event_pools) {
+      for (cudaEvent_t event : events) {
+        C10_CUDA_CHECK(cudaEventDestroy(event));
+      }
+      events.clear();
+    }
+  }
+
+  /** makes allocations on `stream` use the memory pool of `pool_stream` */
+  void setStreamGroup(cuda::CUDAStream stream, cuda::CUDAStream pool_stream)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    AT_CHECK(stream.device_index() == pool_stream.device_index(),
+        "setStreamGroup: streams must be on the same device, got ",
+        stream.device_index(), " and ", pool_stream.device_index());
+    cudaStream_t leader = get_pool_stream(pool_stream.stream());
+    if (leader == stream.stream()) {
+      return;
+    }
+    AT_CHECK(!shared_pools.count(stream.stream()),
+        "setStreamGroup: the stream's own pool is already shared with other "
+        "streams");
+    if (!stream_groups.count(stream.stream())) {
+      // The blocks of the stream's own pool would be unreachable otherwise
+      move_pool(stream.device_index(), stream.stream(), leader);
+    }
+    stream_groups[stream.stream()] = leader;
+    shared_pools.insert(leader);
+  }
+
+  /** moves the blocks keyed by `from` (cached, allocated or waiting for
+   *  events) into the shared pool of `to`. Cached blocks get a free event on
+   *  `from`, so that other streams of the pool only reuse them once the work
+   *  queued on `from` so far is done. */
+  void move_pool(int device, cudaStream_t from, cudaStream_t to)
+  {
+    EventPtr event;
+    for (BlockPool* pool : {&large_blocks, &small_blocks}) {
+      Block search_key(device, from, 0);
+      std::vector<Block*> moved;
+      auto it = pool->lower_bound(&search_key);
+      while (it != pool->end() && (*it)->device == device &&
+             (*it)->stream == from) {
+        moved.push_back(*it);
+        it = pool->erase(it);
+      }
+      for (Block* block : moved) {
+        if (!event) {
+          event = record_event(device, from);
+        }
+        add_free_event(block->free_events, FreeEvent{event, from});
+        block->stream = to;
+        pool->insert(block);
+      }
+    }
+    for (auto& it : allocated_blocks) {
+      Block* block = it.second;
+      if (block->device == device && block->stream == from) {
+        block->stream = to;
+      }
+    }
+    for (auto& it : cuda_events) {
+      for (auto& e : it.second) {
+        Block* block = e.second;
+        if (block->device == device && block->stream == from) {
+          block->stream = to;
+        }
+      }
+    }
+    auto segment = expandable_segments.find(std::make_pair(device, from));
+    if (segment != expandable_segments.end() &&
+        !expandable_segments.count(std::make_pair(device, to))) {
+      // Otherwise the segment is kept under its old key, where emptyCache
+      // still shrinks it, and its blocks merge with each other as before
+      expandable_segments[std::make_pair(device, to)] = segment->second;
+      expandable_segments.erase(segment);
+    }
+  }
+
+  /** adds `event` to the events a block waits for before its next use on
+   *  another stream. Events on one stream complete in order, so the newer
+   *  event replaces an older one recorded on the same stream. */
+  static void add_free_event(std::vector<FreeEvent>& events, FreeEvent event)
+  {
+    for (FreeEvent& e : events) {
+      if (e.stream == event.stream) {
+        e = std::move(event);
+        return;
+      }
+    }
+    events.push_back(std::move(event));
+  }
+
+  /** drops the free events that have completed, returning them to the
+   *  event pool */
+  static void drop_completed_events(std::vector<FreeEvent>& events)
+  {
+    auto end = std::remove_if(events.begin(), events.end(),
+        [](const FreeEvent& e) {
+          cudaError_t err = cudaEventQuery(e.event.get());
+          if (err == cudaErrorNotReady) {
+            // ignore and clear the error if not ready
+            cudaGetLastError();
+            return false;
+          }
+          C10_CUDA_CHECK(err);
+          return true;
+        });
+    events.erase(end, events.end());
+  }
+
+  cudaStream_t get_pool_stream(cudaStream_t stream)
+  {
+#ifdef C10_CUDA_GRAPHS_SUPPORTED
+    if (!capture_pools.empty()) {
+      cudaStreamCaptureStatus status;
+      unsigned long long capture_id;
+      C10_CUDA_CHECK(cudaStreamGetCaptureInfo(stream, &status, &capture_id));
+      if (status == cudaStreamCaptureStatusActive) {
+        auto it = capture_pools.find(capture_id);
+        if (it != capture_pools.end()) {
+          return it->second;
+        }
+      }
+    }
+#endif
+    if (stream_groups.empty()) {
+      return stream;
+    }
+    auto it = stream_groups.find(stream);
+    return it == stream_groups.end() ? stream : it->second;
+  }
+
+  /** routes the allocations of a stream capture to a private pool */
+  void notifyCaptureBegin(
+      int device,
+      unsigned long long capture_id,
+      uint64_t pool_id)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    AT_CHECK(!capture_pools.count(capture_id),
+        "notifyCaptureBegin: capture ", capture_id, " already has a pool");
+    auto it = graph_pools.find(std::make_pair(device, pool_id));
+    if (it == graph_pools.end()) {
+      // Keys are never freed, so that a key can't be reused by another pool
+      // while blocks of a released pool are still cached under it
+      auto key = reinterpret_cast<cudaStream_t>(new char);
+      it = graph_pools.emplace(
+          std::make_pair(device, pool_id), PrivatePool{0, key}).first;
+      live_graph_pools.insert(key);
+    }
+    it->second.use_count++;
+    capture_pools[capture_id] = it->second.key;
+  }
+
+  void notifyCaptureEnd(int device, unsigned long long capture_id)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    capture_pools.erase(capture_id);
+  }
+
+  /** drops a reference on a private pool, and frees its cached blocks once
+   * it is no longer used */
+  void releasePool(int device, uint64_t pool_id)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(std::make_pair(device, pool_id));
+    AT_CHECK(it != graph_pools.end(),
+        "releasePool: no private pool ", pool_id, " on device ", device);
+    if (--it->second.use_count > 0) {
+      return;
+    }
+    cudaStream_t key = it->second.key;
+    graph_pools.erase(it);
+    live_graph_pools.erase(key);
+
+    // Blocks still allocated are cached under the key when freed, until
+    // emptyCache or an out of memory retry
+    Block lower_bound(device, key, 0);
+    Block upper_bound(device, key, std::numeric_limits<size_t>::max());
+    free_blocks(
+        large_blocks,
+        large_blocks.lower_bound(&lower_bound),
+        large_blocks.upper_bound(&upper_bound));
+    free_blocks(
+        small_blocks,
+        small_blocks.lower_bound(&lower_bound),
+        small_blocks.upper_bound(&upper_bound));
+  }
+
+  /** returns an event recorded on the given stream, from the event pool */
+  EventPtr record_event(int device, cudaStream_t stream)
+  {
+    CUDAGuard device_guard(device);
+    if ((size_t) device >= event_pools.size()) {
+      event_pools.resize(device + 1);
+    }
+    auto& events = event_pools[device];
+    cudaEvent_t event;
+    if (events.empty()) {
+      C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+    } else {
+      event = events.back();
+      events.pop_back();
+    }
+    C10_CUDA_CHECK(cudaEventRecord(event, stream));
+    // Blocks and events are only touched with the allocator lock held
+    return EventPtr(event, [this, device](cudaEvent_t event) {
+      event_pools[device].push_back(event);
+    });
   }
 
   void* getBaseAllocation(void* ptr, size_t* outSize)
@@ -355,6 +943,133 @@ struct THCCachingAllocator
     return basePtr;
   }
 
+  /** returns the CUDA IPC handle of the segment starting at base_ptr */
+  std::string getIpcMemHandle(void* base_ptr)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = ipc_handles.find(base_ptr);
+    if (it != ipc_handles.end()) {
+      return it->second;
+    }
+    cudaIpcMemHandle_t handle;
+    C10_CUDA_CHECK(cudaIpcGetMemHandle(&handle, base_ptr));
+    std::string handle_str(reinterpret_cast<const char*>(&handle), CUDA_IPC_HANDLE_SIZE);
+    ipc_handles.emplace(base_ptr, handle_str);
+    return handle_str;
+  }
+
+  /** returns a description of every segment and its blocks */
+  std::vector<SegmentInfo> snapshot()
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+
+    // Blocks waiting on events are in neither the pools nor allocated_blocks
+    std::unordered_set<Block*> pending_free;
+    for (auto& queue : cuda_events) {
+      for (auto& e : queue.second) {
+        pending_free.insert(e.second);
+      }
+    }
+
+    // Every segment is a list of blocks starting with one without prev
+    std::vector<Block*> heads;
+    auto add_head = [&](Block* block) {
+      if (!block->prev) {
+        heads.push_back(block);
+      }
+    };
+    for (Block* block : large_blocks) {
+      add_head(block);
+    }
+    for (Block* block : small_blocks) {
+      add_head(block);
+    }
+    for (auto& it : allocated_blocks) {
+      add_head(it.second);
+    }
+    for (Block* block : pending_free) {
+      add_head(block);
+    }
+    std::sort(heads.begin(), heads.end(), [](const Block* a, const Block* b) {
+      return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
+    });
+
+    std::vector<SegmentInfo> segments;
+    segments.reserve(heads.size());
+    for (Block* head : heads) {
+      segments.emplace_back();
+      SegmentInfo& info = segments.back();
+      info.device = head->device;
+      info.address = reinterpret_cast<int64_t>(head->ptr);
+      info.stream = head->stream;
+      info.is_large = head->pool == &large_blocks;
+      info.is_expandable = head->segment != nullptr;
+      for (Block* block = head; block; block = block->next) {
+        info.blocks.emplace_back();
+        BlockInfo& block_info = info.blocks.back();
+        block_info.size = block->size;
+        block_info.allocated = block->allocated;
+        block_info.pending_free = pending_free.count(block) > 0;
+        info.total_size += block->size;
+        if (block->allocated) {
+          info.allocated_size += block->size;
+        }
+      }
+    }
+    return segments;
+  }
+
+  void recordHistory(
+      bool enabled,
+      ContextRecorder recorder,
+      size_t max_entries)
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    record_history = enabled;
+    if (enabled) {
+      context_recorder = recorder;
+      alloc_trace_max_entries = std::max(max_entries, (size_t)1);
+      alloc_trace_next = 0;
+      alloc_trace.clear();
+      alloc_trace.reserve(alloc_trace_max_entries);
+    }
+  }
+
+  std::vector<TraceEntry> getHistory()
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    // Once the buffer is full, alloc_trace_next is where the oldest entry is
+    std::vector<TraceEntry> result;
+    result.reserve(alloc_trace.size());
+    result.insert(result.end(),
+        alloc_trace.begin() + alloc_trace_next, alloc_trace.end());
+    result.insert(result.end(),
+        alloc_trace.begin(), alloc_trace.begin() + alloc_trace_next);
+    return result;
+  }
+
+  void record_trace(
+      TraceEntry::Action action,
+      int device,
+      void* ptr,
+      size_t size,
+      cudaStream_t stream)
+  {
+    TraceEntry entry;
+    entry.action = action;
+    entry.device = device;
+    entry.address = reinterpret_cast<int64_t>(ptr);
+    entry.size = size;
+    entry.stream = stream;
+    entry.stack_id = context_recorder ? context_recorder() : 0;
+    if (alloc_trace.size() < alloc_trace_max_entries) {
+      alloc_trace.push_back(entry);
+    } else {
+      alloc_trace[alloc_trace_next] = entry;
+      alloc_trace_next = (alloc_trace_next + 1) % alloc_trace_max_entries;
+    }
+  }
+
   // Accumulates sizes of all memory blocks for given device in given pool
   void cacheInfoAux(BlockPool& blocks, int dev_id, size_t* total, size_t* largest)
   {
@@ -383,7 +1098,7 @@ struct THCCachingAllocator
     if (!block) {
       AT_ERROR("invalid device pointer: %p", ptr);
     }
-    if (stream.stream() == block->stream) {
+    if (stream.stream() == block->alloc_stream) {
       // ignore uses on the allocation stream, since those don't require any
       // special synchronization
       return;
@@ -418,7 +1133,14 @@ struct THCCachingAllocator
       if (dst->next) {
         dst->next->prev = dst;
       }
+      if (src->segment && src->segment->tail == src) {
+        src->segment->tail = dst;
+      }
+    }
+    for (FreeEvent& free_event : src->free_events) {
+      add_free_event(dst->free_events, std::move(free_event));
     }
+    drop_completed_events(dst->free_events);
     dst->size += src->size;
     pool.erase(src);
     delete src;
@@ -477,12 +1199,106 @@ struct THCCachingAllocator
     return cudaSuccess;
   }
 
+  ExpandableSegment* get_segment(int device, cudaStream_t stream)
+  {
+    auto& segment = expandable_segments[std::make_pair(device, stream)];
+    if (!segment) {
+      segment = new ExpandableSegment(device, stream);
+    }
+    return segment;
+  }
+
+  /** grows the expandable segment of (device, stream) so that its free tail
+   *  block fits `size` bytes and returns that block, removed from the pool.
+   *  Returns nullptr if the device is out of memory. */
+  Block* expand_segment(int device, cudaStream_t stream, size_t size)
+  {
+    ExpandableSegment* segment = get_segment(device, stream);
+    Block* tail = segment->tail;
+    bool tail_free = tail && !tail->allocated && tail->event_count == 0;
+    size_t available = tail_free ? tail->size : 0;
+
+    size_t offset = segment->mapped_size;
+    size_t grown = segment->grow(size - available);
+    if (grown == 0) {
+      return nullptr;
+    }
+    get_stats_for_device(device).increaseCached(grown);
+    if (record_history) {
+      record_trace(TraceEntry::SEGMENT_ALLOC, device,
+          static_cast<char*>(segment->ptr()) + offset, grown, stream);
+    }
+
+    if (tail_free) {
+      large_blocks.erase(tail);
+      tail->size += grown;
+      return tail;
+    }
+    Block* block = new Block(device, stream, grown, &large_blocks,
+        static_cast<char*>(segment->ptr()) + offset);
+    block->segment = segment;
+    block->prev = tail;
+    if (tail) {
+      tail->next = block;
+    }
+    segment->tail = block;
+    return block;
+  }
+
+  Block* expand_segment_retry(int device, cudaStream_t stream, size_t size)
+  {
+    Block* block = expand_segment(device, stream, size);
+    if (block == nullptr) {
+      free_cached_blocks(device);
+      block = expand_segment(device, stream, size);
+    }
+    return block;
+  }
+
+  /** unmaps the free pages at the end of an expandable segment */
+  void shrink_segment(ExpandableSegment* segment)
+  {
+    Block* tail = segment->tail;
+    if (!tail || tail->allocated || tail->event_count > 0) {
+      return;
+    }
+    size_t tail_offset =
+        static_cast<char*>(tail->ptr) - static_cast<char*>(segment->ptr());
+    size_t released = segment->unmap(tail_offset);
+    if (released == 0) {
+      return;
+    }
+    get_stats_for_device(segment->device).decreaseCached(released);
+    if (record_history) {
+      record_trace(TraceEntry::SEGMENT_FREE, segment->device,
+          static_cast<char*>(segment->ptr()) + segment->mapped_size, released,
+          tail->stream);
+    }
+    large_blocks.erase(tail);
+    if (released == tail->size) {
+      segment->tail = tail->prev;
+      if (tail->prev) {
+        tail->prev->next = nullptr;
+      }
+      delete tail;
+    } else {
+      tail->size -= released;
+      large_blocks.insert(tail);
+    }
+  }
+
   void free_cached_blocks(int device)
   {
     // First ensure that all blocks that can't currently be allocated due to
     // outstanding events are returned to the pool.
     synchronize_and_free_events(device);
 
+    for (auto& it : expandable_segments) {
+      if (it.first.first == device) {
+        shrink_segment(it.second);
+      }
+    }
+
     // Free all non-split cached blocks on device
     Block lower_bound(device, nullptr, 0);
     Block upper_bound(device + 1, nullptr, 0);
@@ -499,13 +1315,22 @@ struct THCCachingAllocator
 
   void free_blocks(BlockPool& blocks, BlockPool::iterator it, BlockPool::iterator end)
   {
-    // Frees all non-split blocks between `it` and `end`
+    // Frees all non-split blocks between `it` and `end`, except those of
+    // private pools in use, which graphs may still read or write
     std::lock_guard<std::mutex> lock(cuda_free_mutex);
     while (it != end) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
+      if (!block->prev && !block->next && !block->segment &&
+          !live_graph_pools.count(block->stream)) {
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+        ipc_handles.erase(block->ptr);
         get_stats_for_device(block->device).decreaseCached(block->size);
+        C10_SDT(cuda_segment_free, block->device, block->ptr, block->size,
+            block->stream);
+        if (record_history) {
+          record_trace(TraceEntry::SEGMENT_FREE, block->device, block->ptr,
+              block->size, block->stream);
+        }
         auto cur = it;
         ++it;
         blocks.erase(cur);
@@ -519,27 +1344,24 @@ struct THCCachingAllocator
   void synchronize_and_free_events(optional<int> device) {
     // Synchronize on outstanding events and then free associated blocks.
     // Limited to blocks on the given device if specified.
-
-    auto remaining_events = decltype(cuda_events)();
-
-    for (auto& e : cuda_events) {
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
-      if (device.has_value() && block->device != *device) {
-        remaining_events.push_back(e);
+    for (auto it = cuda_events.begin(); it != cuda_events.end();) {
+      if (device.has_value() && it->first.first != *device) {
+        ++it;
         continue;
       }
-
-      C10_CUDA_CHECK(cudaEventSynchronize(event));
-      C10_CUDA_CHECK(cudaEventDestroy(event));
-
-      block->event_count--;
-      if (block->event_count == 0) {
-        free_block(block);
+      for (auto& e : it->second) {
+        C10_CUDA_CHECK(cudaEventSynchronize(e.first.get()));
+        release_event_use(e.second);
       }
+      it = cuda_events.erase(it);
     }
+  }
 
-    std::swap(cuda_events, remaining_events);
+  void release_event_use(Block* block) {
+    block->event_count--;
+    if (block->event_count == 0) {
+      free_block(block);
+    }
   }
 
   Block* find_allocated_block(void *ptr) {
@@ -552,53 +1374,44 @@ struct THCCachingAllocator
 
   void insert_events(Block* block)
   {
-    int prev_device;
-    C10_CUDA_CHECK(cudaGetDevice(&prev_device));
-
     stream_set streams(std::move(block->stream_uses));
     AT_ASSERT(block->stream_uses.empty());
     for (auto it = streams.begin(); it != streams.end(); ++it) {
-      C10_CUDA_CHECK(cudaSetDevice(it->device_index()));
-
-      cudaEvent_t event;
-      C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
-      C10_CUDA_CHECK(cudaEventRecord(event, it->stream()));
-
+      EventPtr event = record_event(it->device_index(), it->stream());
       block->event_count++;
-      cuda_events.emplace_back(event, block);
+      cuda_events[std::make_pair((int) it->device_index(), it->stream())]
+          .emplace_back(std::move(event), block);
     }
-
-    C10_CUDA_CHECK(cudaSetDevice(prev_device));
   }
 
   void process_events()
   {
     // Process outstanding cudaEvents. Events that are completed are removed
-    // from the queue, and the 'event_count' for the corresponding allocation
-    // is decremented. Stops at the first event which has not been completed.
-    // Since events on different devices or streams may occur out of order,
-    // the processing of some events may be delayed.
-    while (!cuda_events.empty()) {
-      auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
-
-      cudaError_t err = cudaEventQuery(event);
-      if (err == cudaErrorNotReady) {
-        // ignore and clear the error if not ready
-        cudaGetLastError();
-        break;
-      } else if (err != cudaSuccess) {
-        C10_CUDA_CHECK(err);
+    // from their stream's queue, and the 'event_count' for the corresponding
+    // allocation is decremented. Since events on one stream complete in
+    // order, each queue is only queried up to its first pending event, so
+    // a busy stream doesn't delay the blocks freed on other streams.
+    for (auto it = cuda_events.begin(); it != cuda_events.end();) {
+      auto& queue = it->second;
+      while (!queue.empty()) {
+        auto& e = queue.front();
+        cudaError_t err = cudaEventQuery(e.first.get());
+        if (err == cudaErrorNotReady) {
+          // ignore and clear the error if not ready
+          cudaGetLastError();
+          break;
+        } else if (err != cudaSuccess) {
+          C10_CUDA_CHECK(err);
+        }
+        Block* block = e.second;
+        queue.pop_front();
+        release_event_use(block);
       }
-
-      C10_CUDA_CHECK(cudaEventDestroy(event));
-
-      block->event_count--;
-      if (block->event_count == 0) {
-        free_block(block);
+      if (queue.empty()) {
+        it = cuda_events.erase(it);
+      } else {
+        ++it;
       }
-      cuda_events.pop_front();
     }
   }
 };
@@ -634,8 +1447,11 @@ Allocator* get(void)
   return &device_allocator;
 }
 
+static void emptyIpcCache();
+
 void emptyCache(void) {
   caching_allocator.emptyCache();
+  emptyIpcCache();
 }
 
 void cacheInfo(int dev_id, size_t* cachedAndFree, size_t* largestBlock) {
@@ -647,16 +1463,62 @@ void* getBaseAllocation(void *ptr, size_t *size)
   return caching_allocator.getBaseAllocation(ptr, size);
 }
 
+std::string getIpcMemHandle(void* base_ptr)
+{
+  return caching_allocator.getIpcMemHandle(base_ptr);
+}
+
 void recordStream(void *ptr, cuda::CUDAStream stream)
 {
   caching_allocator.recordStream(ptr, stream);
 }
 
+void setStreamGroup(cuda::CUDAStream stream, cuda::CUDAStream pool_stream)
+{
+  caching_allocator.setStreamGroup(stream, pool_stream);
+}
+
+void notifyCaptureBegin(
+    int device,
+    unsigned long long capture_id,
+    uint64_t pool_id)
+{
+  caching_allocator.notifyCaptureBegin(device, capture_id, pool_id);
+}
+
+void notifyCaptureEnd(int device, unsigned long long capture_id)
+{
+  caching_allocator.notifyCaptureEnd(device, capture_id);
+}
+
+void releasePool(int device, uint64_t pool_id)
+{
+  caching_allocator.releasePool(device, pool_id);
+}
+
 std::mutex* getFreeMutex()
 {
   return &caching_allocator.cuda_free_mutex;
 }
 
+std::vector<SegmentInfo> snapshot()
+{
+  return caching_allocator.snapshot();
+}
+
+void recordHistory(
+    bool enabled,
+    ContextRecorder context_recorder,
+    size_t max_entries)
+{
+  caching_allocator.recordHistory(enabled, context_recorder, max_entries);
+}
+
+std::vector<TraceEntry> getHistory()
+{
+  return caching_allocator.getHistory();
+}
+
 static inline void assertValidDevice(int device) {
   int device_num = device_count();
   AT_ASSERTM(0 <= device && device < device_num, "Invalid device argument.");
@@ -712,18 +1574,54 @@ void resetMaxMemoryCached(int device) {
 // will be used to reconstruct all storages in this CudaMalloc allocation.
 // And it will deleted in cudaIpcCloseMemHandle when its reference count is 0.
 //
+// With ipc_cache_size set, ipc_recent_devptrs also keeps the most recently
+// used device pointers alive, most recent first.
+//
 namespace {
   std::mutex IpcMutex;
   std::unordered_map<std::string, std::weak_ptr<void>> ipcMemHandle_to_devptr;
+  std::deque<std::shared_ptr<void>> ipc_recent_devptrs;
+
+  // Precondition: IpcMutex is locked. Evicted device pointers are moved to
+  // evicted, so that they are closed after IpcMutex is unlocked.
+  void mark_ipc_devptr_used(
+      const std::shared_ptr<void>& devptr,
+      std::vector<std::shared_ptr<void>>& evicted) {
+    const size_t max_size = caching_allocator.config.ipc_cache_size;
+    if (max_size == 0) {
+      return;
+    }
+    auto it = std::find(ipc_recent_devptrs.begin(), ipc_recent_devptrs.end(), devptr);
+    if (it != ipc_recent_devptrs.end()) {
+      ipc_recent_devptrs.erase(it);
+    }
+    ipc_recent_devptrs.push_front(devptr);
+    while (ipc_recent_devptrs.size() > max_size) {
+      evicted.push_back(std::move(ipc_recent_devptrs.back()));
+      ipc_recent_devptrs.pop_back();
+    }
+  }
+}
+
+static void emptyIpcCache() {
+  std::deque<std::shared_ptr<void>> evicted;
+  {
+    std::lock_guard<std::mutex> lock(IpcMutex);
+    std::swap(evicted, ipc_recent_devptrs);
+  }
 }
 
 std::shared_ptr<void> getIpcDevPtr(std::string handle) {
+  std::vector<std::shared_ptr<void>> evicted;
   std::lock_guard<std::mutex> lock(IpcMutex);
 
   auto iter = ipcMemHandle_to_devptr.find(handle);
   if (iter != ipcMemHandle_to_devptr.end()) {
     auto devptr = iter->second.lock();
-    if (devptr) return devptr;
+    if (devptr) {
+      mark_ipc_devptr_used(devptr, evicted);
+      return devptr;
+    }
   }
   // This ipcMemHandle hasn't been opened, or already expired, open it to
   // enable IPC access to that mem block.
@@ -746,6 +1644,7 @@ std::shared_ptr<void> getIpcDevPtr(std::string handle) {
   // But in the deleter for sp we erased the entry,
   // this should be safe to do now.
   ipcMemHandle_to_devptr.insert(iter, {handle, wp});
+  mark_ipc_devptr_used(sp, evicted);
 
   return sp;
 }
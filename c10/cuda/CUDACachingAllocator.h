@@ -7,6 +7,14 @@
 #include <c10/util/Registry.h>
 
 #include <mutex>
+#include <string>
+#include <vector>
+
+// Stream capture into CUDA graphs, with cudaStreamCaptureModeRelaxed
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDART_VERSION) && \
+    CUDART_VERSION >= 10010
+#define C10_CUDA_GRAPHS_SUPPORTED
+#endif
 
 namespace c10 {
 
@@ -39,6 +47,51 @@ namespace cuda {
 
 namespace CUDACachingAllocator {
 
+// A block of a segment, as reported by snapshot()
+struct BlockInfo {
+  int64_t size = 0;
+  bool allocated = false;
+  // freed, but still waiting on events of the streams it was used on
+  bool pending_free = false;
+};
+
+// A piece of device memory obtained by the allocator from CUDA, e.g. through
+// one cudaMalloc, and the blocks it is currently split into (in address
+// order)
+struct SegmentInfo {
+  int64_t device = 0;
+  int64_t address = 0;
+  int64_t total_size = 0;
+  int64_t allocated_size = 0;
+  cudaStream_t stream = 0;
+  bool is_large = false;
+  bool is_expandable = false;
+  std::vector<BlockInfo> blocks;
+};
+
+// An allocator event recorded while history recording is on
+struct TraceEntry {
+  enum Action {
+    ALLOC,          // a block was handed out by malloc
+    FREE,           // a block was returned by free
+    SEGMENT_ALLOC,  // memory was obtained from CUDA
+    SEGMENT_FREE    // memory was released to CUDA
+  };
+  Action action;
+  int device;
+  int64_t address;
+  int64_t size;
+  cudaStream_t stream;
+  // returned by the context recorder passed to recordHistory when the event
+  // happened, 0 if there is none
+  uint64_t stack_id;
+};
+
+// Returns an id identifying the calling context (e.g. an interned stack
+// trace) of an allocator event. Called with the allocator lock held, so it
+// must not allocate CUDA memory.
+using ContextRecorder = uint64_t (*)();
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void raw_delete(void* ptr);
 
@@ -46,7 +99,39 @@ C10_CUDA_API Allocator* get();
 C10_CUDA_API void emptyCache();
 C10_CUDA_API void cacheInfo(int dev_id, size_t* cachedAndFree, size_t* largestBlock);
 C10_CUDA_API void* getBaseAllocation(void *ptr, size_t *size);
+// Returns the CUDA IPC handle of the segment starting at base_ptr (as
+// returned by getBaseAllocation), computed only once per segment.
+C10_CUDA_API std::string getIpcMemHandle(void* base_ptr);
 C10_CUDA_API void recordStream(void *ptr, CUDAStream stream);
+// Makes allocations on `stream` share the cached blocks of `pool_stream`
+// (or of the stream whose pool `pool_stream` uses), e.g. for a set of
+// streams serving concurrent requests. A block freed on one stream of the
+// group is reused by another only after an event recorded at free time,
+// which the reusing stream waits on without synchronizing the host.
+// Both streams must be on the same device. The blocks cached for the own
+// pool of `stream` move to the shared pool.
+C10_CUDA_API void setStreamGroup(CUDAStream stream, CUDAStream pool_stream);
+
+// Private pools of CUDA graphs (see CUDAGraph in ATen):
+// From notifyCaptureBegin to notifyCaptureEnd, allocations made on device
+// by the streams that take part in the stream capture capture_id come from
+// the private pool pool_id, whose blocks are never handed out to code
+// outside of captures into that pool. The memory a graph reads and writes
+// thus stays valid for its replays, whatever happens outside of the graph.
+// Blocks freed during the capture can be reused later in the same capture,
+// since the graph keeps the order of the kernels that use them.
+//
+// Several graphs may share a pool, as long as they are replayed in the order
+// they were captured in. Each notifyCaptureBegin takes a reference on the
+// pool, and each releasePool drops one; the cached blocks of the pool go
+// back to the allocator (and to CUDA on emptyCache) when the last reference
+// is gone.
+C10_CUDA_API void notifyCaptureBegin(
+    int device,
+    unsigned long long capture_id,
+    uint64_t pool_id);
+C10_CUDA_API void notifyCaptureEnd(int device, unsigned long long capture_id);
+C10_CUDA_API void releasePool(int device, uint64_t pool_id);
 C10_CUDA_API uint64_t currentMemoryAllocated(int device);
 C10_CUDA_API uint64_t maxMemoryAllocated(int device);
 C10_CUDA_API void     resetMaxMemoryAllocated(int device);
@@ -56,6 +141,20 @@ C10_CUDA_API void     resetMaxMemoryCached(int device);
 
 C10_CUDA_API std::mutex* getFreeMutex();
 
+// Lists all segments held by the allocator, on every device, sorted by
+// address
+C10_CUDA_API std::vector<SegmentInfo> snapshot();
+
+// Starts or stops recording allocator events in a ring buffer keeping the
+// last max_entries of them. Turning recording on clears the buffer, turning
+// it off keeps what was recorded so far.
+C10_CUDA_API void recordHistory(
+    bool enabled,
+    ContextRecorder context_recorder,
+    size_t max_entries);
+// Returns the recorded events, oldest first
+C10_CUDA_API std::vector<TraceEntry> getHistory();
+
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
 
 } // namespace CUDACachingAllocator
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <thread>
+
+using namespace c10;
+
+TEST(CPUCachingAllocator, ReusesFreedBlocks) {
+  auto allocator = CPUCachingAllocator::get();
+  void* first;
+  {
+    auto data = allocator->allocate(1000);
+    first = data.get();
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % gAlignment, 0);
+  }
+  auto hits = CPUCachingAllocator::getStats().num_cache_hits;
+  // 1000 and 1020 bytes fall into the same size class
+  auto data = allocator->allocate(1020);
+  ASSERT_EQ(data.get(), first);
+  ASSERT_EQ(CPUCachingAllocator::getStats().num_cache_hits, hits + 1);
+}
+
+TEST(CPUCachingAllocator, Stats) {
+  auto allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  auto before = CPUCachingAllocator::getStats();
+  {
+    auto small = allocator->allocate(100);
+    auto large = allocator->allocate(1 << 20);
+    auto during = CPUCachingAllocator::getStats();
+    ASSERT_EQ(during.allocated_bytes, before.allocated_bytes + 100 + (1 << 20));
+    ASSERT_GE(during.reserved_bytes, during.allocated_bytes);
+  }
+  auto after = CPUCachingAllocator::getStats();
+  ASSERT_EQ(after.allocated_bytes, before.allocated_bytes);
+  ASSERT_GT(after.cached_bytes, before.cached_bytes);
+  ASSERT_GE(after.peak_allocated_bytes, before.allocated_bytes + 100 + (1 << 20));
+
+  CPUCachingAllocator::emptyCache();
+  auto emptied = CPUCachingAllocator::getStats();
+  ASSERT_EQ(emptied.cached_bytes, 0);
+  ASSERT_EQ(emptied.reserved_bytes, emptied.allocated_bytes);
+}
+
+TEST(CPUCachingAllocator, CrossThreadFree) {
+  auto allocator = CPUCachingAllocator::get();
+  auto data = allocator->allocate(4096);
+  std::thread t([&]() {
+    // freed blocks land in the freeing thread's cache, which is flushed to
+    // the global pool when the thread exits
+    data.clear();
+  });
+  t.join();
+  auto other = allocator->allocate(4096);
+  ASSERT_NE(other.get(), nullptr);
+}
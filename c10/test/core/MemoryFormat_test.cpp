@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/MemoryFormat.h>
+#include <c10/core/TensorImpl.h>
+
+using namespace c10;
+
+namespace {
+
+c10::intrusive_ptr<TensorImpl> make_float_tensor(IntArrayRef sizes) {
+  auto impl = c10::make_intrusive<TensorImpl>(
+      Storage(caffe2::TypeMeta::Make<float>(), 0, GetCPUAllocator(), true),
+      CPUTensorId());
+  impl->set_sizes_contiguous(sizes);
+  return impl;
+}
+
+} // namespace
+
+TEST(MemoryFormatTest, ChannelsLastStrides) {
+  EXPECT_EQ(
+      get_channels_last_strides({2, 3, 4, 5}),
+      std::vector<int64_t>({60, 1, 15, 3}));
+  // Sizes of zero are treated as one, like for contiguous strides.
+  EXPECT_EQ(
+      get_channels_last_strides({2, 0, 4, 5}),
+      std::vector<int64_t>({20, 1, 5, 1}));
+  EXPECT_ANY_THROW(get_channels_last_strides({2, 3, 4}));
+}
+
+TEST(MemoryFormatTest, EmptyTensorRestride) {
+  auto impl = make_float_tensor({2, 3, 4, 5});
+  EXPECT_TRUE(impl->is_contiguous());
+  EXPECT_FALSE(impl->is_contiguous(MemoryFormat::ChannelsLast));
+
+  impl->empty_tensor_restride(MemoryFormat::ChannelsLast);
+  EXPECT_EQ(impl->strides(), IntArrayRef({60, 1, 15, 3}));
+  EXPECT_FALSE(impl->is_contiguous());
+  EXPECT_TRUE(impl->is_contiguous(MemoryFormat::ChannelsLast));
+
+  impl->empty_tensor_restride(MemoryFormat::Contiguous);
+  EXPECT_EQ(impl->strides(), IntArrayRef({60, 20, 5, 1}));
+  EXPECT_TRUE(impl->is_contiguous());
+  EXPECT_FALSE(impl->is_contiguous(MemoryFormat::ChannelsLast));
+}
+
+TEST(MemoryFormatTest, ChannelsLastContiguity) {
+  // With a single channel, or a 1x1 image, both layouts coincide.
+  auto single_channel = make_float_tensor({2, 1, 4, 5});
+  EXPECT_TRUE(single_channel->is_contiguous());
+  EXPECT_TRUE(single_channel->is_contiguous(MemoryFormat::ChannelsLast));
+
+  auto pixel = make_float_tensor({2, 3, 1, 1});
+  EXPECT_TRUE(pixel->is_contiguous());
+  EXPECT_TRUE(pixel->is_contiguous(MemoryFormat::ChannelsLast));
+
+  // Only 4-dimensional tensors can be channels last.
+  auto three_dim = make_float_tensor({2, 3, 4});
+  EXPECT_FALSE(three_dim->is_contiguous(MemoryFormat::ChannelsLast));
+  EXPECT_ANY_THROW(three_dim->empty_tensor_restride(MemoryFormat::ChannelsLast));
+}
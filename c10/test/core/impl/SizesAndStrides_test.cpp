@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/impl/SizesAndStrides.h>
+
+using namespace c10;
+using namespace c10::impl;
+
+static void checkData(
+    const SizesAndStrides& sz,
+    IntArrayRef sizes,
+    IntArrayRef strides) {
+  ASSERT_EQ(sizes.size(), strides.size())
+      << "bad test case: size() of sizes and strides don't match";
+  ASSERT_EQ(sz.size(), sizes.size());
+
+  int idx = 0;
+  for (auto x : sizes) {
+    ASSERT_EQ(sz.size_at(idx), x) << "index: " << idx;
+    ASSERT_EQ(sz.sizes_data()[idx], x) << "index: " << idx;
+    ASSERT_EQ(*(sz.sizes_begin() + idx), x) << "index: " << idx;
+    idx++;
+  }
+  ASSERT_EQ(sz.sizes_arrayref(), sizes);
+
+  idx = 0;
+  for (auto x : strides) {
+    ASSERT_EQ(sz.stride_at(idx), x) << "index: " << idx;
+    ASSERT_EQ(sz.strides_data()[idx], x) << "index: " << idx;
+    ASSERT_EQ(*(sz.strides_begin() + idx), x) << "index: " << idx;
+    idx++;
+  }
+  ASSERT_EQ(sz.strides_arrayref(), strides);
+}
+
+TEST(SizesAndStridesTest, DefaultConstructor) {
+  SizesAndStrides sz;
+  checkData(sz, {0}, {1});
+}
+
+TEST(SizesAndStridesTest, SetSizes) {
+  SizesAndStrides sz;
+  sz.set_sizes({5, 6, 7, 8});
+  checkData(sz, {5, 6, 7, 8}, {1, 0, 0, 0});
+}
+
+TEST(SizesAndStridesTest, SetSizesAndStrides) {
+  SizesAndStrides sz;
+  sz.set_sizes_and_strides({2, 3}, {3, 1});
+  checkData(sz, {2, 3}, {3, 1});
+
+  sz.set_sizes_and_strides({1, 2, 3, 4, 5, 6, 7}, {7, 6, 5, 4, 3, 2, 1});
+  checkData(sz, {1, 2, 3, 4, 5, 6, 7}, {7, 6, 5, 4, 3, 2, 1});
+}
+
+TEST(SizesAndStridesTest, Resize) {
+  SizesAndStrides sz;
+
+  sz.resize(2);
+
+  // Small to small growing.
+  checkData(sz, {0, 0}, {1, 0});
+
+  // Small to small growing, again.
+  sz.size_at(0) = 1;
+  sz.size_at(1) = 2;
+  sz.stride_at(0) = 2;
+  sz.stride_at(1) = 1;
+  sz.resize(5);
+  checkData(sz, {1, 2, 0, 0, 0}, {2, 1, 0, 0, 0});
+
+  for (int ii = 0; ii < sz.size(); ++ii) {
+    sz.size_at(ii) = ii + 1;
+    sz.stride_at(ii) = 2 * (ii + 1);
+  }
+  checkData(sz, {1, 2, 3, 4, 5}, {2, 4, 6, 8, 10});
+
+  // Small to small, shrinking.
+  sz.resize(4);
+  checkData(sz, {1, 2, 3, 4}, {2, 4, 6, 8});
+
+  // Small to small with no size change.
+  sz.resize(4);
+  checkData(sz, {1, 2, 3, 4}, {2, 4, 6, 8});
+
+  // Small to small, growing back so that we can confirm that our "shrink"
+  // really zeroed the new entries.
+  sz.resize(5);
+  checkData(sz, {1, 2, 3, 4, 0}, {2, 4, 6, 8, 0});
+
+  // Small to big.
+  sz.resize(6);
+  checkData(sz, {1, 2, 3, 4, 0, 0}, {2, 4, 6, 8, 0, 0});
+
+  sz.size_at(5) = 6;
+  sz.stride_at(5) = 12;
+  checkData(sz, {1, 2, 3, 4, 0, 6}, {2, 4, 6, 8, 0, 12});
+
+  // Big to big, growing.
+  sz.resize(7);
+  checkData(sz, {1, 2, 3, 4, 0, 6, 0}, {2, 4, 6, 8, 0, 12, 0});
+
+  // Big to big with no size change.
+  sz.resize(7);
+  checkData(sz, {1, 2, 3, 4, 0, 6, 0}, {2, 4, 6, 8, 0, 12, 0});
+
+  sz.size_at(6) = 11;
+  sz.stride_at(6) = 22;
+  checkData(sz, {1, 2, 3, 4, 0, 6, 11}, {2, 4, 6, 8, 0, 12, 22});
+
+  // Big to big, shrinking.
+  sz.resize(6);
+  checkData(sz, {1, 2, 3, 4, 0, 6}, {2, 4, 6, 8, 0, 12});
+
+  // Big to small.
+  sz.resize(3);
+  checkData(sz, {1, 2, 3}, {2, 4, 6});
+}
+
+static SizesAndStrides makeSmall(int offset = 0) {
+  SizesAndStrides small;
+  small.set_sizes_and_strides({1 + offset, 2 + offset}, {2 + offset, 1 + offset});
+  return small;
+}
+
+static SizesAndStrides makeBig(int offset = 0) {
+  SizesAndStrides big;
+  big.set_sizes_and_strides(
+      {1 + offset, 2 + offset, 3 + offset, 4 + offset, 5 + offset, 6 + offset},
+      {6 + offset, 5 + offset, 4 + offset, 3 + offset, 2 + offset, 1 + offset});
+  return big;
+}
+
+static void checkSmall(const SizesAndStrides& sm, int offset = 0) {
+  checkData(sm, {1 + offset, 2 + offset}, {2 + offset, 1 + offset});
+}
+
+static void checkBig(const SizesAndStrides& big, int offset = 0) {
+  checkData(
+      big,
+      {1 + offset, 2 + offset, 3 + offset, 4 + offset, 5 + offset, 6 + offset},
+      {6 + offset, 5 + offset, 4 + offset, 3 + offset, 2 + offset, 1 + offset});
+}
+
+TEST(SizesAndStridesTest, CopyConstructor) {
+  auto small = makeSmall();
+  SizesAndStrides copy(small);
+  checkSmall(small);
+  checkSmall(copy);
+
+  auto big = makeBig();
+  SizesAndStrides copy2(big);
+  checkBig(big);
+  checkBig(copy2);
+}
+
+TEST(SizesAndStridesTest, CopyAssignment) {
+  auto small = makeSmall();
+  auto big = makeBig();
+
+  SizesAndStrides smallTarget = makeSmall(1);
+  smallTarget = small;
+  checkSmall(smallTarget);
+  checkSmall(small);
+
+  smallTarget = big;
+  checkBig(smallTarget);
+  checkBig(big);
+
+  SizesAndStrides bigTarget = makeBig(1);
+  bigTarget = makeBig(2);
+  checkBig(bigTarget, 2);
+
+  bigTarget = small;
+  checkSmall(bigTarget);
+  checkSmall(small);
+
+  // Self-assignment.
+  auto& self = bigTarget;
+  bigTarget = self;
+  checkSmall(bigTarget);
+}
+
+TEST(SizesAndStridesTest, MoveConstructor) {
+  auto small = makeSmall();
+  SizesAndStrides movedSmall(std::move(small));
+  checkSmall(movedSmall);
+  EXPECT_EQ(small.size(), 0);
+
+  auto big = makeBig();
+  SizesAndStrides movedBig(std::move(big));
+  checkBig(movedBig);
+  EXPECT_EQ(big.size(), 0);
+}
+
+TEST(SizesAndStridesTest, MoveAssignment) {
+  SizesAndStrides smallTarget = makeSmall(1);
+  smallTarget = makeSmall();
+  checkSmall(smallTarget);
+
+  smallTarget = makeBig();
+  checkBig(smallTarget);
+
+  SizesAndStrides bigTarget = makeBig(1);
+  bigTarget = makeBig(2);
+  checkBig(bigTarget, 2);
+
+  bigTarget = makeSmall();
+  checkSmall(bigTarget);
+}
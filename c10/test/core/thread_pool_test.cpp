@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+// Blocks the only worker of a pool until release() is called, so that the
+// tasks submitted in the meantime are all queued when the worker picks them.
+struct Gate {
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    entered = true;
+    cv.notify_all();
+    while (!open) {
+      cv.wait(lock);
+    }
+  }
+  void waitEntered() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!entered) {
+      cv.wait(lock);
+    }
+  }
+  void release() {
+    std::lock_guard<std::mutex> lock(mutex);
+    open = true;
+    cv.notify_all();
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool entered = false;
+  bool open = false;
+};
+
+} // namespace
+
+TEST(ThreadPoolTest, RunBatchRunsAllTasks) {
+  ThreadPool pool(4);
+  std::atomic<int> count{0};
+  std::vector<std::function<void()>> funcs;
+  for (int i = 0; i < 1000; ++i) {
+    funcs.emplace_back([&count]() { ++count; });
+  }
+  pool.runBatch(std::move(funcs));
+  pool.waitWorkComplete();
+  ASSERT_EQ(count.load(), 1000);
+}
+
+TEST(ThreadPoolTest, RunsHigherPriorityFirst) {
+  ThreadPool pool(1);
+  Gate gate;
+  pool.run([&gate]() { gate.wait(); });
+  gate.waitEntered();
+
+  std::vector<int> order;
+  pool.runWithPriority([&order]() { order.push_back(2); }, TaskPriority::LOW);
+  pool.runWithPriority(
+      [&order]() { order.push_back(1); }, TaskPriority::NORMAL);
+  pool.runWithPriority([&order]() { order.push_back(0); }, TaskPriority::HIGH);
+  gate.release();
+  pool.waitWorkComplete();
+  ASSERT_EQ(order, std::vector<int>({0, 1, 2}));
+}
+
+TEST(ThreadPoolTest, LowPriorityIsNotStarved) {
+  ThreadPool pool(1);
+  Gate gate;
+  pool.run([&gate]() { gate.wait(); });
+  gate.waitEntered();
+
+  std::vector<int> order;
+  pool.runWithPriority([&order]() { order.push_back(-1); }, TaskPriority::LOW);
+  std::vector<std::function<void()>> high;
+  for (int i = 0; i < 100; ++i) {
+    high.emplace_back([&order, i]() { order.push_back(i); });
+  }
+  pool.runBatch(std::move(high), TaskPriority::HIGH);
+  gate.release();
+  pool.waitWorkComplete();
+
+  ASSERT_EQ(order.size(), 101u);
+  const auto low = std::find(order.begin(), order.end(), -1) - order.begin();
+  ASSERT_GT(low, 0);
+  ASSERT_LT(low, 100);
+}
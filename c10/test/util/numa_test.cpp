@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/numa.h>
+
+#include <thread>
+
+using namespace c10;
+
+TEST(NUMATest, DefaultPolicy) {
+  EXPECT_EQ(GetNUMAPolicy(), kNUMAPolicyLocal);
+  EXPECT_EQ(GetNUMATaskNode(kNUMAPolicyLocal, 0, 4), -1);
+}
+
+TEST(NUMATest, ThreadPolicyOverridesProcessPolicy) {
+  SetNUMAPolicy(kNUMAPolicySpread);
+  EXPECT_EQ(GetNUMAPolicy(), kNUMAPolicySpread);
+
+  SetThreadNUMAPolicy(0);
+  EXPECT_EQ(GetNUMAPolicy(), 0);
+  EXPECT_EQ(GetNUMAAllocationNode(), 0);
+  int other_thread_policy = kNUMAPolicyUnset;
+  std::thread t([&] { other_thread_policy = GetNUMAPolicy(); });
+  t.join();
+  EXPECT_EQ(other_thread_policy, kNUMAPolicySpread);
+
+  SetThreadNUMAPolicy(kNUMAPolicyUnset);
+  EXPECT_EQ(GetNUMAPolicy(), kNUMAPolicySpread);
+  EXPECT_EQ(GetNUMAAllocationNode(), -1);
+
+  SetNUMAPolicy(kNUMAPolicyLocal);
+  EXPECT_EQ(GetNUMAPolicy(), kNUMAPolicyLocal);
+}
+
+TEST(NUMATest, InvalidPolicy) {
+  EXPECT_ANY_THROW(SetNUMAPolicy(kNUMAPolicyUnset));
+  EXPECT_ANY_THROW(SetThreadNUMAPolicy(-4));
+}
+
+TEST(NUMATest, TaskNode) {
+  // A fixed node binds every task
+  EXPECT_EQ(GetNUMATaskNode(1, 0, 4), 1);
+  EXPECT_EQ(GetNUMATaskNode(1, 3, 4), 1);
+
+  // Spreading groups contiguous tasks on a node
+  const int num_nodes = GetNumNUMANodes();
+  if (num_nodes > 1) {
+    const int64_t num_tasks = 4 * num_nodes;
+    int prev_node = 0;
+    for (int64_t task = 0; task < num_tasks; ++task) {
+      int node = GetNUMATaskNode(kNUMAPolicySpread, task, num_tasks);
+      EXPECT_GE(node, prev_node);
+      EXPECT_LT(node, num_nodes);
+      prev_node = node;
+    }
+    EXPECT_EQ(prev_node, num_nodes - 1);
+  } else {
+    EXPECT_EQ(GetNUMATaskNode(kNUMAPolicySpread, 1, 4), -1);
+  }
+}
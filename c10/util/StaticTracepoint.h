@@ -0,0 +1,30 @@
+#pragma once
+
+// Statically defined tracepoints (USDT probes). A probe compiles to a single
+// nop plus an entry in the .note.stapsdt ELF section, so it costs nothing
+// until a tracer such as bpftrace, perf or SystemTap attaches to it, e.g.
+//
+//   bpftrace -e 'usdt:/path/to/libc10.so:pytorch:cuda_malloc
+//                { @bytes = hist(arg2); }'
+//
+// Probe arguments are still evaluated when no tracer is attached, so only
+// pass values that are already at hand (pointers, sizes, string literals).
+//
+// C10_SDT(name, ...) places a probe under the `pytorch` provider;
+// C10_SDT_PROVIDER(provider, name, ...) lets other components (e.g. caffe2)
+// use their own provider name. Up to 8 arguments are supported.
+
+#if defined(__ELF__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(__CUDACC__)
+#include <cstddef>
+
+#include <c10/util/StaticTracepointElfx86.h>
+
+#define C10_SDT_PROVIDER(provider, name, ...)                      \
+  C10_SDT_PROBE_N(                                                 \
+    provider, name, C10_SDT_NARG(0, ##__VA_ARGS__), ##__VA_ARGS__)
+#else
+#define C10_SDT_PROVIDER(provider, name, ...) do {} while(0)
+#endif
+
+#define C10_SDT(name, ...) C10_SDT_PROVIDER(pytorch, name, ##__VA_ARGS__)
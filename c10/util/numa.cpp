@@ -1,5 +1,7 @@
 #include "c10/util/numa.h"
 
+#include <atomic>
+
 C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 
 #if defined(__linux__) && !defined(C10_DISABLE_NUMA) && !defined(C10_MOBILE)
@@ -14,6 +16,62 @@ C10_DEFINE_bool(caffe2_cpu_numa_enabled, false, "Use NUMA whenever possible.");
 
 namespace c10 {
 
+namespace {
+
+std::atomic<int> process_numa_policy{kNUMAPolicyLocal};
+thread_local int thread_numa_policy = kNUMAPolicyUnset;
+
+void checkNUMAPolicy(int policy) {
+  AT_CHECK(
+      policy >= kNUMAPolicyUnset,
+      "Invalid NUMA policy ",
+      policy);
+}
+
+} // namespace
+
+void SetNUMAPolicy(int policy) {
+  checkNUMAPolicy(policy);
+  AT_CHECK(
+      policy != kNUMAPolicyUnset, "The process NUMA policy can't be unset");
+  process_numa_policy = policy;
+}
+
+void SetThreadNUMAPolicy(int policy) {
+  checkNUMAPolicy(policy);
+  thread_numa_policy = policy;
+}
+
+int GetNUMAPolicy() {
+  return thread_numa_policy != kNUMAPolicyUnset ? thread_numa_policy
+                                                : process_numa_policy.load();
+}
+
+int GetNUMAAllocationNode() {
+  const int policy = GetNUMAPolicy();
+  if (policy >= 0) {
+    return policy;
+  }
+  if (policy == kNUMAPolicyLocal) {
+    return GetCurrentNUMANode();
+  }
+  return -1;
+}
+
+int GetNUMATaskNode(int policy, int64_t task_id, int64_t num_tasks) {
+  if (policy >= 0) {
+    return policy;
+  }
+  if (policy != kNUMAPolicySpread || num_tasks <= 0) {
+    return -1;
+  }
+  const int num_nodes = GetNumNUMANodes();
+  if (num_nodes <= 1) {
+    return -1;
+  }
+  return static_cast<int>(task_id * num_nodes / num_tasks);
+}
+
 #ifdef C10_ENABLE_NUMA
 bool IsNUMAEnabled() {
   return FLAGS_caffe2_cpu_numa_enabled && numa_available() >= 0;
@@ -103,6 +161,26 @@ int GetCurrentNUMANode() {
   return n;
 }
 
+void NUMARunOnNode(int numa_node_id) {
+  // Intra-op threads are rebound on every parallel region, so remember the
+  // node to skip the syscall when it doesn't change
+  static thread_local int bound_numa_node = -1;
+  if (numa_node_id == bound_numa_node) {
+    return;
+  }
+  if (!IsNUMAEnabled()) {
+    return;
+  }
+  AT_CHECK(
+      numa_node_id <= numa_max_node(),
+      "NUMA node id ",
+      numa_node_id,
+      " is unavailable");
+  if (numa_run_on_node(numa_node_id) == 0) {
+    bound_numa_node = numa_node_id;
+  }
+}
+
 #else // C10_ENABLE_NUMA
 
 bool IsNUMAEnabled() {
@@ -127,6 +205,9 @@ int GetCurrentNUMANode() {
   return -1;
 }
 
+void NUMARunOnNode(int numa_node_id) {
+}
+
 #endif // C10_NUMA_ENABLED
 
 } // namespace c10
@@ -37,4 +37,56 @@ C10_API void NUMAMove(void* ptr, size_t size, int numa_node_id);
  */
 C10_API int GetCurrentNUMANode();
 
+/**
+ * NUMA policies for CPU tensors and intra-op threads.  A policy is either a
+ * NUMA node id, or one of:
+ *
+ *  kNUMAPolicyLocal (default): memory is moved to the node of the allocating
+ *    thread, threads are left where the OS schedules them.
+ *  kNUMAPolicySpread: memory is left to first touch, intra-op tasks are bound
+ *    to nodes in contiguous groups, so that task i of n runs on node
+ *    i * num_nodes / n.
+ *  node id >= 0: memory is moved to the node and intra-op tasks run on it,
+ *    e.g. to serve one model per socket.
+ *
+ * Policies only take effect when NUMA is enabled (--caffe2_cpu_numa_enabled).
+ */
+constexpr int kNUMAPolicyUnset = -3;
+constexpr int kNUMAPolicySpread = -2;
+constexpr int kNUMAPolicyLocal = -1;
+
+/**
+ * Set the NUMA policy of the process
+ */
+C10_API void SetNUMAPolicy(int policy);
+
+/**
+ * Set the NUMA policy of the calling thread, overriding the process policy;
+ * kNUMAPolicyUnset goes back to the process policy
+ */
+C10_API void SetThreadNUMAPolicy(int policy);
+
+/**
+ * Get the NUMA policy in effect for the calling thread
+ */
+C10_API int GetNUMAPolicy();
+
+/**
+ * Get the NUMA node to move new CPU memory to under the current policy, or
+ * -1 to leave it where it is
+ */
+C10_API int GetNUMAAllocationNode();
+
+/**
+ * Get the NUMA node that task `task_id` out of `num_tasks` of a parallel
+ * region runs on under `policy`, or -1 if it isn't bound
+ */
+C10_API int GetNUMATaskNode(int policy, int64_t task_id, int64_t num_tasks);
+
+/**
+ * Run the calling thread on the CPUs of a given NUMA node; -1 lets it run
+ * anywhere.  Cheap if the thread already runs on that node.
+ */
+C10_API void NUMARunOnNode(int numa_node_id);
+
 } // namespace c10
@@ -6,6 +6,10 @@
 #include "caffe2/core/blob.h"
 #include "caffe2/utils/proto_utils.h"
 
+#ifdef CAFFE2_USE_ZSTD
+#include <zstd.h>
+#endif
+
 C10_DEFINE_int(
     caffe2_tensor_chunk_size,
     1000000,
@@ -21,6 +25,18 @@ C10_DEFINE_bool(
     false,
     "Serialize FLOAT16 tensors using byte_data field");
 
+C10_DEFINE_bool(
+    caffe2_serialize_using_raw_data,
+    false,
+    "Serialize the chunks of tensors of fundamental types as their raw bytes "
+    "in the raw_data field, instead of in the typed repeated fields");
+
+C10_DEFINE_int(
+    caffe2_serialize_zstd_level,
+    0,
+    "If positive, the zstd compression level of the chunks serialized with "
+    "caffe2_serialize_using_raw_data. Needs caffe2 to be built with zstd");
+
 namespace caffe2 {
 /**
  * @brief StringSerializer is the serializer for String.
@@ -226,6 +242,11 @@ void TensorSerializer::Serialize(
   // TODO: use CUDAGuard here instead of context and employ explicit sync
   // copy
   auto uniq_ptr = CreateContext(input.GetDevice());
+  if (FLAGS_caffe2_serialize_using_raw_data &&
+      detail::CanStoreAsRawData(data_type)) {
+    detail::StoreRawData(input, chunkBegin, chunkSize, uniq_ptr.get(), &proto);
+    return;
+  }
   // A lot of copypaste is error prone. Should we create a macro for this?
   switch (data_type) {
     case TensorProto_DataType_FLOAT:
@@ -343,6 +364,127 @@ void TensorSerializer::Serialize(
   }
 }
 
+namespace detail {
+
+bool CanStoreAsRawData(TensorProto::DataType data_type) {
+  switch (data_type) {
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+    case TensorProto_DataType_BOOL:
+    case TensorProto_DataType_UINT8:
+    case TensorProto_DataType_INT8:
+    case TensorProto_DataType_UINT16:
+    case TensorProto_DataType_INT16:
+    case TensorProto_DataType_INT64:
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static void EnforceLittleEndian() {
+  const int kValue = 1;
+  CAFFE_ENFORCE_EQ(
+      reinterpret_cast<const char*>(&kValue)[0],
+      1,
+      "Serialization of raw data on big endian platform is not written yet.");
+}
+
+void StoreRawData(
+    const Tensor& input,
+    size_t chunkBegin,
+    int32_t chunkSize,
+    BaseContext* context,
+    TensorProto* proto) {
+  EnforceLittleEndian();
+  const size_t nbytes = chunkSize * input.itemsize();
+  const char* data =
+      static_cast<const char*>(input.raw_data()) + chunkBegin * input.itemsize();
+  std::string* raw_data = proto->mutable_raw_data();
+  proto->set_storage_type(TensorProto_StorageType_RAW);
+#ifdef CAFFE2_USE_ZSTD
+  if (FLAGS_caffe2_serialize_zstd_level > 0 && nbytes > 0) {
+    // zstd works on host memory
+    std::string buffer;
+    const char* src = data;
+    if (input.GetDeviceType() != CPU) {
+      buffer.resize(nbytes);
+      context->CopyBytesToCPU(nbytes, data, &buffer[0]);
+      context->FinishDeviceComputation();
+      src = buffer.data();
+    }
+    raw_data->resize(ZSTD_compressBound(nbytes));
+    const size_t compressed = ZSTD_compress(
+        &(*raw_data)[0],
+        raw_data->size(),
+        src,
+        nbytes,
+        FLAGS_caffe2_serialize_zstd_level);
+    CAFFE_ENFORCE(
+        !ZSTD_isError(compressed),
+        "zstd compression failed: ",
+        ZSTD_getErrorName(compressed));
+    if (compressed < nbytes) {
+      raw_data->resize(compressed);
+      proto->set_storage_type(TensorProto_StorageType_RAW_ZSTD);
+      return;
+    }
+    // Data that does not compress is stored as is.
+    if (!buffer.empty()) {
+      raw_data->swap(buffer);
+      return;
+    }
+  }
+#else
+  if (FLAGS_caffe2_serialize_zstd_level > 0) {
+    C10_LOG_EVERY_MS(WARNING, 1000)
+        << "caffe2 is built without zstd, serializing without compression.";
+  }
+#endif
+  raw_data->resize(nbytes);
+  context->CopyBytesToCPU(nbytes, data, &(*raw_data)[0]);
+  context->FinishDeviceComputation();
+}
+
+void LoadRawData(
+    const TensorProto& proto,
+    int64_t chunkBegin,
+    int64_t chunkSize,
+    BaseContext* context,
+    Tensor* tensor) {
+  EnforceLittleEndian();
+  const size_t itemsize = tensor->itemsize();
+  const size_t nbytes = chunkSize * itemsize;
+  char* data = static_cast<char*>(tensor->raw_mutable_data(tensor->dtype())) +
+      chunkBegin * itemsize;
+  const std::string& raw_data = proto.raw_data();
+  if (proto.storage_type() == TensorProto_StorageType_RAW_ZSTD) {
+#ifdef CAFFE2_USE_ZSTD
+    std::string buffer(nbytes, '\0');
+    const size_t decompressed = ZSTD_decompress(
+        &buffer[0], nbytes, raw_data.data(), raw_data.size());
+    CAFFE_ENFORCE(
+        !ZSTD_isError(decompressed),
+        "zstd decompression failed: ",
+        ZSTD_getErrorName(decompressed));
+    CAFFE_ENFORCE_EQ(decompressed, nbytes, "Incorrect proto field size.");
+    context->CopyBytesFromCPU(nbytes, buffer.data(), data);
+#else
+    CAFFE_THROW(
+        "The tensor ",
+        proto.name(),
+        " is compressed with zstd, but caffe2 is built without it.");
+#endif
+  } else {
+    CAFFE_ENFORCE_EQ(nbytes, raw_data.size(), "Incorrect proto field size.");
+    context->CopyBytesFromCPU(nbytes, raw_data.data(), data);
+  }
+}
+
+} // namespace detail
+
 int GetGPUIDForPointer(const void* ptr);
 
 void TensorSerializer::StoreDeviceDetail(
@@ -506,6 +648,13 @@ void TensorDeserializer::DeserializeToTensor(
       tensor->numel());
   auto chunkSize = chunkEnd - chunkBegin;
 
+  if (tensor_proto.storage_type() == TensorProto_StorageType_RAW ||
+      tensor_proto.storage_type() == TensorProto_StorageType_RAW_ZSTD) {
+    detail::LoadRawData(tensor_proto, chunkBegin, chunkSize, context, tensor);
+    context->FinishDeviceComputation();
+    return;
+  }
+
   switch (tensor_proto.data_type()) {
     case TensorProto_DataType_FLOAT:
       detail::CopyFromProtoAsIs(
@@ -16,6 +16,8 @@
 C10_DECLARE_int(caffe2_tensor_chunk_size);
 C10_DECLARE_int(caffe2_max_tensor_serializer_threads);
 C10_DECLARE_bool(caffe2_serialize_fp16_as_bytes);
+C10_DECLARE_bool(caffe2_serialize_using_raw_data);
+C10_DECLARE_int(caffe2_serialize_zstd_level);
 
 namespace caffe2 {
 
@@ -220,6 +222,28 @@ inline void CopyFromProtoWithCast(
   context->template CopyFromCPU<DstType>(size, buffer.get(), dst);
 }
 
+
+// Whether the chunks of tensors of the data type can be stored as raw bytes,
+// see caffe2_serialize_using_raw_data.
+CAFFE2_API bool CanStoreAsRawData(TensorProto::DataType data_type);
+
+// Stores a chunk of a tensor as its raw bytes in the raw_data field of the
+// proto, compressed if caffe2_serialize_zstd_level is set and that makes it
+// smaller.
+CAFFE2_API void StoreRawData(
+    const Tensor& input,
+    size_t chunkBegin,
+    int32_t chunkSize,
+    BaseContext* context,
+    TensorProto* proto);
+
+// Loads a chunk stored by StoreRawData into the tensor.
+CAFFE2_API void LoadRawData(
+    const TensorProto& proto,
+    int64_t chunkBegin,
+    int64_t chunkSize,
+    BaseContext* context,
+    Tensor* tensor);
 }  // namespace detail
 
 ////////////////////////////////////////////////////////////////////////////////
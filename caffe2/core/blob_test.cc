@@ -1062,6 +1062,53 @@ TEST(CustomChunkSize, BigTensorSerialization) {
   EXPECT_EQ(counter, 1);
 }
 
+TEST(CustomChunkSize, RawDataSerialization) {
+  const int64_t kSize = 10000;
+  Blob blob;
+  TensorCPU* tensor = BlobGetMutableTensor(&blob, CPU);
+  tensor->Resize(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    tensor->mutable_data<float>()[i] = i % 100;
+  }
+  for (int level : {0, 3}) {
+    FLAGS_caffe2_serialize_using_raw_data = true;
+    FLAGS_caffe2_serialize_zstd_level = level;
+    std::vector<std::string> chunks;
+    std::mutex mutex;
+    auto acceptor = [&](const std::string& /*key*/, const std::string& value) {
+      std::lock_guard<std::mutex> guard(mutex);
+      chunks.push_back(value);
+    };
+    SerializeBlob(blob, "test", acceptor, kSize / 4);
+    FLAGS_caffe2_serialize_using_raw_data = false;
+    FLAGS_caffe2_serialize_zstd_level = 0;
+    EXPECT_EQ(chunks.size(), 4);
+
+    Blob new_blob;
+    for (const auto& chunk : chunks) {
+      BlobProto proto;
+      CHECK(proto.ParseFromString(chunk));
+      const TensorProto& tensor_proto = proto.tensor();
+      EXPECT_EQ(tensor_proto.float_data().size(), 0);
+#ifdef CAFFE2_USE_ZSTD
+      EXPECT_EQ(
+          tensor_proto.storage_type(),
+          level > 0 ? TensorProto_StorageType_RAW_ZSTD
+                    : TensorProto_StorageType_RAW);
+#else
+      EXPECT_EQ(tensor_proto.storage_type(), TensorProto_StorageType_RAW);
+      EXPECT_EQ(tensor_proto.raw_data().size(), kSize / 4 * sizeof(float));
+#endif
+      EXPECT_NO_THROW(DeserializeBlob(chunk, &new_blob));
+    }
+    const TensorCPU& new_tensor = new_blob.Get<TensorCPU>();
+    EXPECT_EQ(new_tensor.numel(), kSize);
+    for (int i = 0; i < kSize; ++i) {
+      EXPECT_EQ(new_tensor.data<float>()[i], i % 100);
+    }
+  }
+}
+
 TEST(QTensor, QTensorSizingTest) {
   vector<int> dims(3);
   dims[0] = 2;
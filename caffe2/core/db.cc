@@ -171,6 +171,176 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+RangeCursor::RangeCursor(
+    std::unique_ptr<Cursor> cursor,
+    const string& begin,
+    const string& end)
+    : cursor_(std::move(cursor)), begin_(begin), end_(end), valid_(false) {
+  CAFFE_ENFORCE(
+      cursor_->SupportsSeek(),
+      "A RangeCursor needs a database that supports seeking.");
+  SeekToFirst();
+}
+
+void RangeCursor::Seek(const string& key) {
+  if (key < begin_) {
+    SeekToFirst();
+    return;
+  }
+  cursor_->Seek(key);
+  UpdateValid();
+}
+
+void RangeCursor::SeekToFirst() {
+  if (begin_.empty()) {
+    cursor_->SeekToFirst();
+  } else {
+    cursor_->Seek(begin_);
+  }
+  UpdateValid();
+}
+
+void RangeCursor::Next() {
+  cursor_->Next();
+  UpdateValid();
+}
+
+void RangeCursor::UpdateValid() {
+  valid_ = cursor_->Valid() && (end_.empty() || cursor_->key() < end_);
+}
+
+PrefetchingCursor::PrefetchingCursor(
+    std::unique_ptr<Cursor> cursor,
+    size_t readahead)
+    : cursor_(std::move(cursor)),
+      readahead_(readahead),
+      supports_seek_(cursor_->SupportsSeek()) {
+  CAFFE_ENFORCE_GT(readahead_, 0, "A PrefetchingCursor needs a readahead.");
+  Start();
+  // Read in the first entry, like the other cursors.
+  Next();
+}
+
+PrefetchingCursor::~PrefetchingCursor() {
+  Stop();
+}
+
+void PrefetchingCursor::Seek(const string& key) {
+  Stop();
+  cursor_->Seek(key);
+  Start();
+  Next();
+}
+
+void PrefetchingCursor::SeekToFirst() {
+  Stop();
+  cursor_->SeekToFirst();
+  Start();
+  Next();
+}
+
+void PrefetchingCursor::Next() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  records_changed_.wait(lock, [this] { return !records_.empty() || done_; });
+  if (records_.empty()) {
+    valid_ = false;
+    if (error_) {
+      std::exception_ptr error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+    return;
+  }
+  current_ = std::move(records_.front());
+  records_.pop_front();
+  valid_ = true;
+  lock.unlock();
+  records_changed_.notify_all();
+}
+
+string PrefetchingCursor::key() {
+  return current_.first;
+}
+
+string PrefetchingCursor::value() {
+  return current_.second;
+}
+
+DBView PrefetchingCursor::valueView() {
+  return DBView(current_.second.data(), current_.second.size());
+}
+
+void PrefetchingCursor::Start() {
+  thread_ = std::thread(&PrefetchingCursor::Prefetch, this);
+}
+
+void PrefetchingCursor::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  records_changed_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  records_.clear();
+  stop_ = false;
+  done_ = false;
+  error_ = nullptr;
+  valid_ = false;
+}
+
+void PrefetchingCursor::Prefetch() {
+  std::exception_ptr error;
+  try {
+    while (cursor_->Valid()) {
+      std::pair<string, string> record(cursor_->key(), cursor_->value());
+      cursor_->Next();
+      std::unique_lock<std::mutex> lock(mutex_);
+      records_changed_.wait(
+          lock, [this] { return stop_ || records_.size() < readahead_; });
+      if (stop_) {
+        return;
+      }
+      records_.push_back(std::move(record));
+      lock.unlock();
+      records_changed_.notify_all();
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = error;
+    done_ = true;
+  }
+  records_changed_.notify_all();
+}
+
+std::vector<string> SplitKeyRanges(Cursor* cursor, int num_shards) {
+  CAFFE_ENFORCE_GT(num_shards, 0);
+  int64_t count = 0;
+  for (cursor->SeekToFirst(); cursor->Valid(); cursor->Next()) {
+    count++;
+  }
+  std::vector<string> splits;
+  int shard = 1;
+  int64_t index = 0;
+  for (cursor->SeekToFirst(); cursor->Valid() && shard < num_shards;
+       cursor->Next(), index++) {
+    if (index == count * shard / num_shards) {
+      if (index > 0) {
+        splits.push_back(cursor->key());
+      }
+      // With fewer records than shards, several shards would start here.
+      while (shard < num_shards && count * shard / num_shards <= index) {
+        shard++;
+      }
+    }
+  }
+  return splits;
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
@@ -1,7 +1,11 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 #include "c10/util/Registry.h"
 #include "caffe2/core/blob_serialization.h"
@@ -16,6 +20,24 @@ namespace db {
  */
 enum Mode { READ, WRITE, NEW };
 
+/**
+ * A view of a key or value of the database, which does not own the data it
+ * points to.
+ */
+class CAFFE2_API DBView {
+ public:
+  DBView() : data_(nullptr), size_(0) {}
+  DBView(const char* data, size_t size) : data_(data), size_(size) {}
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+  string ToString() const { return string(data_, size_); }
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
 /**
  * An abstract class for the cursor of the database while reading.
  */
@@ -46,15 +68,112 @@ class CAFFE2_API Cursor {
    * Returns the current value.
    */
   virtual string value() = 0;
+  /**
+   * Returns a view of the current value, which stays valid until the cursor
+   * moves. Databases that can point into their own storage, like LMDB into
+   * its memory map, override this to not copy the value. In default, the
+   * value is copied into a buffer of the cursor.
+   */
+  virtual DBView valueView() {
+    value_buffer_ = value();
+    return DBView(value_buffer_.data(), value_buffer_.size());
+  }
   /**
    * Returns whether the current location is valid - for example, if we have
    * reached the end of the database, return false.
    */
   virtual bool Valid() = 0;
 
+ private:
+  string value_buffer_;
+
   C10_DISABLE_COPY_AND_ASSIGN(Cursor);
 };
 
+/**
+ * A cursor over the records of a database whose keys are in [begin, end),
+ * e.g. to read a database from several threads, each with its own range of
+ * keys (see SplitKeyRanges). An empty end means the end of the database.
+ * The underlying cursor must support seeking.
+ */
+class CAFFE2_API RangeCursor : public Cursor {
+ public:
+  RangeCursor(
+      std::unique_ptr<Cursor> cursor,
+      const string& begin,
+      const string& end);
+
+  /**
+   * Seeks to the key, or to the beginning of the range if the key is before
+   * it.
+   */
+  void Seek(const string& key) override;
+  bool SupportsSeek() override { return true; }
+  void SeekToFirst() override;
+  void Next() override;
+  string key() override { return cursor_->key(); }
+  string value() override { return cursor_->value(); }
+  DBView valueView() override { return cursor_->valueView(); }
+  bool Valid() override { return valid_; }
+
+ private:
+  void UpdateValid();
+
+  std::unique_ptr<Cursor> cursor_;
+  string begin_;
+  string end_;
+  bool valid_;
+};
+
+/**
+ * A cursor that reads ahead: a background thread moves the underlying cursor
+ * and keeps up to `readahead` of the next records in memory, so that reading
+ * from storage overlaps with the work of the reader. The underlying cursor
+ * is owned by the background thread and must not be used directly.
+ */
+class CAFFE2_API PrefetchingCursor : public Cursor {
+ public:
+  PrefetchingCursor(std::unique_ptr<Cursor> cursor, size_t readahead);
+  ~PrefetchingCursor() override;
+
+  void Seek(const string& key) override;
+  bool SupportsSeek() override { return supports_seek_; }
+  void SeekToFirst() override;
+  void Next() override;
+  string key() override;
+  string value() override;
+  DBView valueView() override;
+  bool Valid() override { return valid_; }
+
+ private:
+  // Starts and stops the background thread.
+  void Start();
+  void Stop();
+  void Prefetch();
+
+  std::unique_ptr<Cursor> cursor_;
+  const size_t readahead_;
+  const bool supports_seek_;
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable records_changed_;
+  std::deque<std::pair<string, string>> records_;
+  bool stop_ = false;
+  bool done_ = false;
+  std::exception_ptr error_;
+  std::pair<string, string> current_;
+  bool valid_ = false;
+};
+
+/**
+ * Splits the records of a database into num_shards ranges of consecutive
+ * keys with about the same number of records each, by scanning the keys
+ * once. Returns the first key of every range but the first one, which starts
+ * at the beginning of the database, e.g. for RangeCursors. Ranges that would
+ * be empty, when there are fewer records than shards, are left out.
+ */
+CAFFE2_API std::vector<string> SplitKeyRanges(Cursor* cursor, int num_shards);
+
 /**
  * An abstract class for the current database transaction while writing.
  */
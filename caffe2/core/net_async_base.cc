@@ -532,6 +532,10 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "priority_scheduling") {
+      CAFFE_ENFORCE(arg.has_i(), "priority_scheduling should be an int");
+      use_priority_scheduling_ = arg.i() == 1;
+    }
   }
 
   run_root_tasks_inline_ = FLAGS_caffe2_net_async_run_root_tasks_inline;
@@ -53,6 +53,10 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // dispatch the ready tasks with the longest path to the end of the net
+  // first, weighting tasks by their ops' profiled times if report_stats_ is
+  // set, or else by their number of ops
+  bool use_priority_scheduling_ = false;
 };
 
 class CAFFE2_API AsyncNetBase : public NetBase {
@@ -2,12 +2,18 @@
 
 #include "caffe2/core/net_async_tracing.h"
 
+#include <algorithm>
+
 namespace caffe2 {
 
 AsyncSchedulingNet::AsyncSchedulingNet(
     const std::shared_ptr<const NetDef>& net_def,
     Workspace* ws)
-    : AsyncNetBase(net_def, ws), running_(false) {}
+    : AsyncNetBase(net_def, ws), running_(false) {
+  if (options_.use_priority_scheduling_) {
+    computePriorities();
+  }
+}
 
 void AsyncSchedulingNet::reset() {
   AsyncNetBase::reset();
@@ -35,7 +41,10 @@ bool AsyncSchedulingNet::isInlineTask(int parent_id, int child_id) const {
 // schedule() is not supposed to throw, all exceptions in the ops are caught
 // and reported in the end of the graph's execution, the full graph of tasks
 // is expected to be scheduled
-void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
+void AsyncSchedulingNet::schedule(
+    int task_id,
+    bool run_inline,
+    PendingJobs* pending) noexcept {
   if (!testAndSetScheduled(task_id)) {
     return;
   }
@@ -72,6 +81,8 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
         }
       }
 
+      // The children that become ready together are submitted in one batch
+      PendingJobs pending_children;
       for (auto child_id : children(task_id)) {
         int parent_count = updateParentCount(child_id);
         if (parent_count == 0) {
@@ -85,7 +96,8 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
               options_.finish_chain_ || canSchedule(child_id)) {
             // if DFS scheduling is enabled, run children inline,
             // ignore DFS scheduling in callbacks
-            schedule(child_id, isInlineTask(task_id, child_id));
+            schedule(
+                child_id, isInlineTask(task_id, child_id), &pending_children);
           } else {
             bool parent_failed = false;
             bool parent_needs_polling = false;
@@ -123,15 +135,22 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
             if (parent_failed) {
               // one of parents failed, set failure flag and wrap up execution
               success_ = false;
-              schedule(child_id, isInlineTask(task_id, child_id));
+              schedule(
+                  child_id,
+                  isInlineTask(task_id, child_id),
+                  &pending_children);
             } else if (parent_needs_polling) {
               // some parents are blocking us from scheduling a child and don't
               // support callbacks, using polling
               const auto& child_device_option =
                   event(child_id).GetDeviceOption();
               pool(child_device_option)
-                  ->run(std::bind(
-                      &AsyncSchedulingNet::pollAndSchedule, this, child_id));
+                  ->runWithPriority(
+                      std::bind(
+                          &AsyncSchedulingNet::pollAndSchedule,
+                          this,
+                          child_id),
+                      c10::TaskPriority::LOW);
             } else if (!parents_with_callback.empty()) {
               // some parents are blocking us from scheduling a child and they
               // support callbacks
@@ -141,11 +160,15 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
               }
             } else {
               // we're ready to schedule a child
-              schedule(child_id, isInlineTask(task_id, child_id));
+              schedule(
+                  child_id,
+                  isInlineTask(task_id, child_id),
+                  &pending_children);
             }
           }
         }
       }
+      runPendingJobs(pending_children);
 
       // In case of net's failure, make sure all pending tasks are finished
       if (!success_) {
@@ -186,7 +209,108 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
     schedule_func();
   } else {
     const auto& device_option = event(task_id).GetDeviceOption();
-    pool(device_option)->run(schedule_func);
+    auto* task_pool = pool(device_option);
+    std::function<void()> job;
+    if (options_.use_priority_scheduling_) {
+      {
+        std::lock_guard<std::mutex> lock(ready_tasks_mutex_);
+        ready_tasks_[task_pool].push(
+            {priorities_[task_id], task_id, std::move(schedule_func)});
+      }
+      job = std::bind(&AsyncSchedulingNet::runReadyTask, this, task_pool);
+    } else {
+      job = std::move(schedule_func);
+    }
+    const auto priority = taskPriority(task_id);
+    if (pending) {
+      (*pending)[std::make_pair(task_pool, priority)].push_back(
+          std::move(job));
+    } else {
+      task_pool->runWithPriority(std::move(job), priority);
+    }
+  }
+}
+
+void AsyncSchedulingNet::runPendingJobs(PendingJobs& pending) {
+  for (auto& jobs : pending) {
+    jobs.first.first->runBatch(std::move(jobs.second), jobs.first.second);
+  }
+  pending.clear();
+}
+
+c10::TaskPriority AsyncSchedulingNet::taskPriority(int task_id) const {
+  if (options_.use_priority_scheduling_ && on_critical_path_[task_id]) {
+    return c10::TaskPriority::HIGH;
+  }
+  return c10::TaskPriority::NORMAL;
+}
+
+// Every task pushed into ready_tasks_ posts one job, so a job always finds a
+// task to run, though not necessarily the one it was posted for.
+void AsyncSchedulingNet::runReadyTask(TaskThreadPoolBase* task_pool) {
+  std::function<void()> func;
+  {
+    std::lock_guard<std::mutex> lock(ready_tasks_mutex_);
+    auto& ready_tasks = ready_tasks_[task_pool];
+    func = ready_tasks.top().func;
+    ready_tasks.pop();
+  }
+  func();
+}
+
+void AsyncSchedulingNet::computePriorities() {
+  const auto op_times = options_.report_stats_ ? counters_.GetMeanTimePerOp()
+                                               : std::vector<float>();
+  // Visit the tasks in reverse topological order, so that the priorities of
+  // all children are known before their parents'.
+  priorities_.assign(tasksNum(), 0.0);
+  std::vector<int> pending_children(tasksNum());
+  std::vector<int> ready;
+  for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
+    pending_children[task_id] = children(task_id).size();
+    if (pending_children[task_id] == 0) {
+      ready.push_back(task_id);
+    }
+  }
+  while (!ready.empty()) {
+    const auto task_id = ready.back();
+    ready.pop_back();
+    float cost = 0.0;
+    for (auto op_id : chains_[task_id]) {
+      cost += op_times.empty() ? 1.0 : op_times[op_id];
+    }
+    float longest_path = 0.0;
+    for (auto child_id : children(task_id)) {
+      longest_path = std::max(longest_path, priorities_[child_id]);
+    }
+    priorities_[task_id] = cost + longest_path;
+    for (auto parent_id : parents(task_id)) {
+      if (--pending_children[parent_id] == 0) {
+        ready.push_back(parent_id);
+      }
+    }
+  }
+
+  // The critical path starts at the root of the highest priority and follows
+  // the child of the highest priority down to a sink.
+  on_critical_path_.assign(tasksNum(), false);
+  int critical_task = -1;
+  for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
+    if (parents(task_id).empty() &&
+        (critical_task < 0 ||
+         priorities_[task_id] > priorities_[critical_task])) {
+      critical_task = task_id;
+    }
+  }
+  while (critical_task >= 0) {
+    on_critical_path_[critical_task] = true;
+    int next_task = -1;
+    for (auto child_id : children(critical_task)) {
+      if (next_task < 0 || priorities_[child_id] > priorities_[next_task]) {
+        next_task = child_id;
+      }
+    }
+    critical_task = next_task;
   }
 }
 
@@ -218,8 +342,11 @@ void AsyncSchedulingNet::pollAndSchedule(int task_id) {
     schedule(task_id);
   } else {
     const auto& device_option = event(task_id).GetDeviceOption();
+    // Polling must not hold up the tasks that are ready to run
     pool(device_option)
-        ->run(std::bind(&AsyncSchedulingNet::pollAndSchedule, this, task_id));
+        ->runWithPriority(
+            std::bind(&AsyncSchedulingNet::pollAndSchedule, this, task_id),
+            c10::TaskPriority::LOW);
   }
 }
 
@@ -245,6 +372,10 @@ bool AsyncSchedulingNet::RunAsync() {
     }
     running_ = true;
     reset();
+    if (options_.use_priority_scheduling_ && options_.report_stats_) {
+      // refresh the priorities with the latest operator timings
+      computePriorities();
+    }
 
     StartAllObservers();
     tracing::startIter(tracer_);
@@ -263,11 +394,13 @@ bool AsyncSchedulingNet::RunAsync() {
 
   // schedule() is not expected to throw, at this moment all the initial tasks
   // will be scheduled and the full graph of tasks will be executed
+  PendingJobs pending_roots;
   for (auto task_id = 0; task_id < tasksNum(); ++task_id) {
     if (parents(task_id).empty()) {
-      schedule(task_id, options_.run_root_tasks_inline_);
+      schedule(task_id, options_.run_root_tasks_inline_, &pending_roots);
     }
   }
+  runPendingJobs(pending_roots);
 
   if (tasksNum() == 0) {
     finishRun();
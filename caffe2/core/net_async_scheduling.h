@@ -1,6 +1,13 @@
 #ifndef CAFFE2_CORE_NET_ASYNC_SCHEDULING_H_
 #define CAFFE2_CORE_NET_ASYNC_SCHEDULING_H_
 
+#include <functional>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "caffe2/core/net_async_base.h"
 
 namespace caffe2 {
@@ -17,8 +24,21 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
  protected:
   bool RunAsync() override;
 
+  // Pool jobs of the tasks made ready together, e.g. the children of a task,
+  // submitted with one runBatch per pool and priority.
+  using PendingJobs = std::map<
+      std::pair<TaskThreadPoolBase*, c10::TaskPriority>,
+      std::vector<std::function<void()>>>;
+
   void pollAndSchedule(int task_id);
-  void schedule(int task_id, bool run_inline = false) noexcept;
+  // Runs the task inline or submits its job to its pool, or adds the job to
+  // pending if given, to be submitted later with runPendingJobs.
+  void schedule(
+      int task_id,
+      bool run_inline = false,
+      PendingJobs* pending = nullptr) noexcept;
+  void runPendingJobs(PendingJobs& pending);
+  c10::TaskPriority taskPriority(int task_id) const;
   void reset() override;
   virtual void finishRun();
   void parentCallback(int parent_id);
@@ -30,6 +50,31 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   std::atomic<int> processed_tasks_num_;
 
+  // Priority scheduling: instead of running the tasks in the order they become
+  // ready, each pool job runs the ready task of its pool with the highest
+  // priority, that is the longest path to a sink of the task graph. The jobs
+  // of the tasks on the critical path, the longest path of the graph, are
+  // submitted with a HIGH pool priority, ahead of the jobs of other nets.
+  void computePriorities();
+  void runReadyTask(TaskThreadPoolBase* pool);
+
+  struct ReadyTask {
+    float priority;
+    int task_id;
+    std::function<void()> func;
+
+    bool operator<(const ReadyTask& other) const {
+      return priority < other.priority ||
+          (priority == other.priority && task_id > other.task_id);
+    }
+  };
+
+  std::vector<float> priorities_;
+  std::vector<bool> on_critical_path_;
+  std::mutex ready_tasks_mutex_;
+  std::unordered_map<TaskThreadPoolBase*, std::priority_queue<ReadyTask>>
+      ready_tasks_;
+
   C10_DISABLE_COPY_AND_ASSIGN(AsyncSchedulingNet);
 };
 
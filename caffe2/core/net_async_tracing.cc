@@ -62,6 +62,9 @@ Tracer::Tracer(
       iter_(0),
       dumping_iter_(0),
       config_(config) {
+  if (net_) {
+    ops_ = net_->GetOperators();
+  }
   std::replace(filename_.begin(), filename_.end(), '/', '_');
   filename_ = this->config().filepath + "/" + filename_ + "_id_" +
       c10::to_string(getCounterForNetName(net_name));
@@ -103,20 +106,26 @@ std::string Tracer::opBlobsInfo(const OperatorBase& op) {
   return blobs_info;
 }
 
+std::string Tracer::serializeThreadId(const TracerEvent& event) {
+  std::stringstream tid;
+  if (event.thread_label_ >= 0) {
+    tid << event.thread_label_;
+  } else {
+    tid << event.tid_;
+  }
+  return tid.str();
+}
+
 std::string Tracer::serializeEvent(const TracerEvent& event) {
   std::stringstream serialized_event;
   serialized_event << std::fixed;
   serialized_event << "{\n";
   serialized_event << " \"ts\": " << event.timestamp_ << ",\n";
   serialized_event << " \"pid\": 0,\n"; // not using pid field
-  if (event.thread_label_ >= 0) {
-    serialized_event << " \"tid\": " << event.thread_label_ << ",\n";
-  } else {
-    serialized_event << " \"tid\": " << event.tid_ << ",\n";
-  }
+  serialized_event << " \"tid\": " << serializeThreadId(event) << ",\n";
 
   if (event.is_beginning_) {
-    std::unordered_map<std::string, int> int_args;
+    std::unordered_map<std::string, long> int_args;
     std::unordered_map<std::string, std::string> string_args;
     if (event.name_) {
       serialized_event << " \"name\": \"" << event.name_ << "\",\n";
@@ -139,6 +148,12 @@ std::string Tracer::serializeEvent(const TracerEvent& event) {
       int_args["device_type"] = op->device_option().device_type();
       int_args["device_id"] = DeviceId(op->device_option());
       string_args["blobs"] = opBlobsInfo(*op);
+      if (config_.detailed) {
+        string_args["input_shapes"] = event.input_shapes_;
+        if (event.flops_ >= 0) {
+          int_args["flops"] = event.flops_;
+        }
+      }
     }
 
     if (event.task_id_ >= 0) {
@@ -170,13 +185,72 @@ std::string Tracer::serializeEvent(const TracerEvent& event) {
       serialized_event << "\n }";
     }
   } else {
-    serialized_event << " \"ph\": \"E\"\n";
+    serialized_event << " \"ph\": \"E\"";
+    if (event.output_bytes_ >= 0) {
+      serialized_event << ",\n \"args\": {\n";
+      serialized_event << "  \"output_bytes\": " << event.output_bytes_
+                       << ",\n";
+      serialized_event << "  \"allocated_bytes\": " << event.allocated_bytes_;
+      serialized_event << "\n }";
+    }
   }
   serialized_event << "\n}";
 
   return serialized_event.str();
 }
 
+std::vector<std::string> Tracer::serializeFlowEvents() {
+  std::vector<std::string> flow_events;
+  const auto* async_net = dynamic_cast_if_rtti<const AsyncNetBase*>(net_);
+  if (!config_.detailed || !async_net) {
+    return flow_events;
+  }
+
+  auto serialize = [this](const TracerEvent& event, const char* phase, int id) {
+    std::stringstream serialized_event;
+    serialized_event << "{\n";
+    serialized_event << " \"ts\": " << event.timestamp_ << ",\n";
+    serialized_event << " \"pid\": 0,\n";
+    serialized_event << " \"tid\": " << serializeThreadId(event) << ",\n";
+    serialized_event << " \"name\": \"dependency\",\n";
+    serialized_event << " \"cat\": \"flow\",\n";
+    serialized_event << " \"id\": " << id << ",\n";
+    if (phase[0] == 'f') {
+      // bind to the slice of the child op rather than the next one
+      serialized_event << " \"bp\": \"e\",\n";
+    }
+    serialized_event << " \"ph\": \"" << phase << "\"\n";
+    serialized_event << "}";
+    return serialized_event.str();
+  };
+
+  // Events are recorded in order, so when a task starts, the latest run of
+  // the last op of each of its parents is the one it waited for
+  std::unordered_map<int, const TracerEvent*> last_op_events;
+  int flow_id = 0;
+  for (const auto& event : events_) {
+    if (!event.is_beginning_ || event.op_id_ < 0 || event.task_id_ < 0) {
+      continue;
+    }
+    if (event.op_id_ == async_net->firstTaskOpId(event.task_id_)) {
+      for (auto parent_id : async_net->parents(event.task_id_)) {
+        auto it = last_op_events.find(parent_id);
+        if (it == last_op_events.end() ||
+            it->second->timestamp_ > event.timestamp_) {
+          continue;
+        }
+        flow_events.push_back(serialize(*it->second, "s", flow_id));
+        flow_events.push_back(serialize(event, "f", flow_id));
+        ++flow_id;
+      }
+    }
+    if (event.op_id_ == async_net->lastTaskOpId(event.task_id_)) {
+      last_op_events[event.task_id_] = &event;
+    }
+  }
+  return flow_events;
+}
+
 // fix occasional cases with zero duration events
 void Tracer::linearizeEvents() {
   std::unordered_map<long, long> time_offsets;
@@ -268,11 +342,19 @@ void Tracer::dumpTracingResultAndClearEvents(const std::string& file_suffix) {
   }
   linearizeEvents();
   renameThreads();
+  std::vector<std::string> serialized_events;
+  serialized_events.reserve(events_.size());
+  for (const auto& event : events_) {
+    serialized_events.push_back(serializeEvent(event));
+  }
+  for (auto& flow_event : serializeFlowEvents()) {
+    serialized_events.push_back(std::move(flow_event));
+  }
   std::stringstream serialized;
   serialized << "[\n";
-  for (size_t idx = 0; idx < events_.size(); ++idx) {
-    serialized << serializeEvent(events_[idx]);
-    if (idx != events_.size() - 1) {
+  for (size_t idx = 0; idx < serialized_events.size(); ++idx) {
+    serialized << serialized_events[idx];
+    if (idx != serialized_events.size() - 1) {
       serialized << ",\n";
     }
   }
@@ -284,6 +366,71 @@ void Tracer::dumpTracingResultAndClearEvents(const std::string& file_suffix) {
   events_.clear();
 }
 
+namespace {
+
+long outputsCapacity(OperatorBase* op) {
+  long bytes = 0;
+  for (const auto* blob : op->Outputs()) {
+    auto tensor_info_fun = GetTensorInfoFunction(blob->meta().id());
+    if (tensor_info_fun) {
+      size_t capacity = 0;
+      DeviceOption device;
+      tensor_info_fun(blob->GetRaw(), &capacity, &device);
+      bytes += capacity;
+    }
+  }
+  return bytes;
+}
+
+} // namespace
+
+void Tracer::recordOpDetails(TracerEvent* event) {
+  if (!config_.detailed || event->op_id_ < 0) {
+    return;
+  }
+  auto* op = ops_.at(event->op_id_);
+  auto shapes = op->InputTensorShapes();
+  std::stringstream input_shapes;
+  for (size_t idx = 0; idx < shapes.size(); ++idx) {
+    if (idx > 0) {
+      input_shapes << "; ";
+    }
+    if (shapes[idx].unknown_shape()) {
+      input_shapes << "?";
+      continue;
+    }
+    input_shapes << "[";
+    for (int dim = 0; dim < shapes[idx].dims_size(); ++dim) {
+      input_shapes << (dim > 0 ? ", " : "") << shapes[idx].dims(dim);
+    }
+    input_shapes << "]";
+  }
+  event->input_shapes_ = input_shapes.str();
+
+  const auto* schema = OpSchemaRegistry::Schema(op->type());
+  if (op->has_debug_def() && schema && schema->HasCostInferenceFunction()) {
+    try {
+      event->flops_ = schema->InferCost(op->debug_def(), shapes).flops;
+    } catch (const std::exception& e) {
+      VLOG(1) << "Cost inference failed for " << op->type() << ": "
+              << e.what();
+    }
+  }
+  event->output_bytes_ = outputsCapacity(op);
+}
+
+void Tracer::recordOpOutputBytes(TracerEvent* event) {
+  if (!config_.detailed || event->op_id_ < 0) {
+    return;
+  }
+  auto* op = ops_.at(event->op_id_);
+  auto start_bytes = event->output_bytes_;
+  event->output_bytes_ = outputsCapacity(op);
+  event->allocated_bytes_ = std::max(0L, event->output_bytes_ - start_bytes);
+  event->input_shapes_.clear();
+  event->flops_ = -1;
+}
+
 Tracer::~Tracer() {
   dumpTracingResultAndClearEvents("final_batch");
 }
@@ -341,6 +488,7 @@ void TracerGuard::recordEventStart() {
       event_.tid_ = std::this_thread::get_id();
     }
     event_.is_beginning_ = true;
+    tracer_->recordOpDetails(&event_);
     event_.timestamp_ = (long)caffe2::round(tracer_->timer_.MicroSeconds());
     tracer_->recordEvent(event_);
   }
@@ -349,6 +497,7 @@ void TracerGuard::recordEventStart() {
 TracerGuard::~TracerGuard() {
   if (enabled_) {
     event_.is_beginning_ = false;
+    tracer_->recordOpOutputBytes(&event_);
     event_.timestamp_ = (long)caffe2::round(tracer_->timer_.MicroSeconds());
     tracer_->recordEvent(event_);
   }
@@ -425,6 +574,8 @@ TracingConfig getTracingConfigFromNet(const NetBase* net) {
   cfg.trace_every_n_ms = arg_helper.GetSingleArgument<int>(
       "trace_every_n_ms", cfg.trace_every_n_ms);
 
+  cfg.detailed = arg_helper.GetSingleArgument<bool>("detailed_tracing", false);
+
   return cfg;
 };
 
@@ -39,6 +39,14 @@ struct CAFFE2_API TracerEvent {
   bool is_beginning_ = false;
   long thread_label_ = -1;
   std::thread::id tid_;
+
+  // Filled in for op events in detailed tracing mode, -1 or empty otherwise
+  std::string input_shapes_;
+  long flops_ = -1;
+  // Capacity of the output tensors when the op starts; on the end event,
+  // their capacity when the op finishes and the bytes allocated in between
+  long output_bytes_ = -1;
+  long allocated_bytes_ = -1;
 };
 
 enum TracingField {
@@ -66,6 +74,11 @@ struct TracingConfig {
   // for TracingMode::GLOBAL_TIMESLICE
   int64_t trace_every_n_ms = 2 * 60 * 1000; // 2min
   int64_t trace_for_n_ms = 1000; // 1sec
+
+  // Record the input shapes, the FLOPs estimated by the cost inference
+  // function of the schema and the output bytes of each op, and add flow
+  // events between dependent tasks (e.g. from CPU to GPU streams)
+  bool detailed = false;
 };
 
 class CAFFE2_API Tracer {
@@ -79,6 +92,9 @@ class CAFFE2_API Tracer {
   std::string opTraceName(const OperatorBase* op);
   std::string opBlobsInfo(const OperatorBase& op);
   std::string serializeEvent(const TracerEvent& event);
+  // Flow events linking the last op of each task to the first op of its
+  // children, for the events recorded so far
+  std::vector<std::string> serializeFlowEvents();
   void linearizeEvents();
   void renameThreads();
   void setEnabled(bool enabled);
@@ -95,7 +111,12 @@ class CAFFE2_API Tracer {
   virtual ~Tracer();
 
  private:
+  std::string serializeThreadId(const TracerEvent& event);
+  void recordOpDetails(TracerEvent* event);
+  void recordOpOutputBytes(TracerEvent* event);
+
   const NetBase* net_ = nullptr;
+  std::vector<OperatorBase*> ops_;
   std::string filename_;
   std::vector<TracerEvent> events_;
   std::mutex tracer_mutex_;
@@ -16,6 +16,7 @@
 
 #include <gtest/gtest.h>
 #include "caffe2/core/net_async_tracing.h"
+#include "caffe2/utils/proto_utils.h"
 
 namespace caffe2 {
 
@@ -109,6 +110,76 @@ TEST(NetAsyncTracingTest, GlobalTimeSlice) {
   net->Run();
 }
 
+TEST(NetAsyncTracingTest, DetailedTracing) {
+  const auto spec = R"DOC(
+      name: "detailed_example"
+      type: "async_scheduling"
+      arg {
+        name: "enable_tracing"
+        i: 1
+      }
+      arg {
+        name: "detailed_tracing"
+        i: 1
+      }
+      arg {
+        name: "tracing_filepath"
+        s: "/tmp"
+      }
+      arg {
+        name: "trace_every_nth_batch"
+        i: 1
+      }
+      arg {
+        name: "dump_every_nth_batch"
+        i: 1
+      }
+      op {
+        output: "a"
+        type: "ConstantFill"
+        arg {
+          name: "shape"
+          ints: 4
+          ints: 8
+        }
+      }
+      op {
+        output: "b"
+        type: "ConstantFill"
+        arg {
+          name: "shape"
+          ints: 4
+          ints: 8
+        }
+      }
+      op {
+        input: "a"
+        input: "b"
+        output: "out"
+        type: "Mul"
+      }
+)DOC";
+
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+
+  Workspace ws;
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  ASSERT_TRUE(net->Run());
+  // Dumps the events of the first run
+  ASSERT_TRUE(net->Run());
+
+  std::string trace;
+  ASSERT_TRUE(
+      ReadStringFromFile("/tmp/detailed_example_id_1_iter_1.json", &trace));
+  EXPECT_NE(
+      trace.find("\"input_shapes\": \"[4, 8]; [4, 8]\""), string::npos);
+  EXPECT_NE(trace.find("\"flops\": 32"), string::npos);
+  EXPECT_NE(trace.find("\"output_bytes\": 128"), string::npos);
+  EXPECT_NE(trace.find("\"ph\": \"s\""), string::npos);
+  EXPECT_NE(trace.find("\"ph\": \"f\""), string::npos);
+}
+
 } // namespace tracing
 
 } // namespace caffe2
@@ -7,6 +7,10 @@
 
 #include <google/protobuf/text_format.h>
 
+#include <chrono>
+#include <mutex>
+#include <thread>
+
 namespace caffe2 {
 
 namespace {
@@ -1101,4 +1105,109 @@ TEST(NetTest, ProfDAGNetErrorTest) {
   testProfDAGNetErrorCase(/*test_error=*/true);
 }
 
+namespace {
+
+std::mutex run_order_mutex;
+std::vector<std::string> run_order;
+
+// Records the name of its output when it runs, after sleeping for "sleep_ms".
+class RecordRunOrderOp final : public Operator<CPUContext> {
+ public:
+  RecordRunOrderOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<CPUContext>(operator_def, ws),
+        sleep_ms_(this->template GetSingleArgument<int>("sleep_ms", 0)) {}
+
+  bool RunOnDevice() override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_ms_));
+    std::lock_guard<std::mutex> lock(run_order_mutex);
+    run_order.push_back(debug_def().output(0));
+    return true;
+  }
+
+ private:
+  const int sleep_ms_;
+};
+
+REGISTER_CPU_OPERATOR(RecordRunOrder, RecordRunOrderOp);
+
+OPERATOR_SCHEMA(RecordRunOrder).NumInputs(0, INT_MAX).NumOutputs(1);
+
+// After "r", a single worker can either run "d", or the longer chain "a", "b",
+// "c", which come later in the net.
+const auto priority_spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        num_workers: 1
+        arg {
+          name: "priority_scheduling"
+          i: 1
+        }
+        arg {
+          name: "enable_profiling"
+          i: <PROFILING>
+        }
+        op {
+          output: "r"
+          type: "RecordRunOrder"
+        }
+        op {
+          input: "r"
+          output: "d"
+          type: "RecordRunOrder"
+          arg {
+            name: "sleep_ms"
+            i: <SLEEP_MS>
+          }
+        }
+        op {
+          input: "r"
+          output: "a"
+          type: "RecordRunOrder"
+        }
+        op {
+          input: "a"
+          output: "b"
+          type: "RecordRunOrder"
+        }
+        op {
+          input: "b"
+          output: "c"
+          type: "RecordRunOrder"
+        }
+)DOC";
+
+std::vector<std::string> runPriorityNet(
+    bool profiling,
+    int sleep_ms,
+    int num_runs) {
+  std::string net_spec = priority_spec;
+  ReplaceAll(net_spec, "<PROFILING>", profiling ? "1" : "0");
+  ReplaceAll(net_spec, "<SLEEP_MS>", c10::to_string(sleep_ms).c_str());
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(net_spec, &net_def));
+  Workspace ws;
+  auto net = CreateNet(net_def, &ws);
+  for (auto run = 0; run < num_runs; ++run) {
+    run_order.clear();
+    EXPECT_TRUE(net->Run());
+  }
+  return run_order;
+}
+
+} // namespace
+
+TEST(NetTest, PriorityScheduling) {
+  // Without timings, the chain is the longest path.
+  EXPECT_EQ(
+      runPriorityNet(/*profiling=*/false, /*sleep_ms=*/0, /*num_runs=*/1),
+      (std::vector<std::string>{"r", "a", "b", "c", "d"}));
+}
+
+TEST(NetTest, PrioritySchedulingWithTimings) {
+  // Once the first runs are profiled, "d" is slower than the whole chain.
+  EXPECT_EQ(
+      runPriorityNet(/*profiling=*/true, /*sleep_ms=*/50, /*num_runs=*/4),
+      (std::vector<std::string>{"r", "d", "a", "b", "c"}));
+}
+
 } // namespace caffe2
@@ -10,6 +10,7 @@
 #include "caffe2/core/timer.h"
 #include "caffe2/core/workspace.h"
 #include "caffe2/proto/caffe2_pb.h"
+#include "caffe2/queue/blobs_queue.h"
 
 C10_DEFINE_bool(
     caffe2_handle_executor_threads_exceptions,
@@ -201,6 +202,9 @@ struct ExecutionStepWrapper {
     CompiledExecutionStep* operator->() {
       return compiledRef_;
     }
+    CompiledExecutionStep& operator*() {
+      return *compiledRef_;
+    }
 
    private:
     CompiledGuard() {}
@@ -243,7 +247,7 @@ struct CompiledExecutionStep {
       ShouldContinue externalShouldContinue,
       NetDefMap* netDefs,
       WorkspaceIdInjector* ws_id_injector)
-      : step(mainStep) {
+      : step(mainStep), netDefs(netDefs), wsIdInjector(ws_id_injector) {
     if (mainStep->create_workspace()) {
       localWorkspace_.reset(new Workspace(externalWorkspace));
       workspace = localWorkspace_.get();
@@ -277,7 +281,8 @@ struct CompiledExecutionStep {
 
     if (step->substep_size()) {
       ShouldContinue substepShouldContinue;
-      if (!step->concurrent_substeps() || step->substep().size() <= 1) {
+      if ((!step->concurrent_substeps() || step->substep().size() <= 1) &&
+          !step->pipelined_substeps()) {
         substepShouldContinue = externalShouldContinue;
       } else {
         substepShouldContinue = [this, externalShouldContinue](int64_t it) {
@@ -286,6 +291,12 @@ struct CompiledExecutionStep {
       }
 
       for (const auto& ss : step->substep()) {
+        // The stages of a pipeline are compiled for each of their copies when
+        // the pipeline runs, see ExecutePipeline.
+        if (step->pipelined_substeps() && !ss.has_run_every_ms()) {
+          pipelineStages.push_back(&ss);
+          continue;
+        }
         auto compiledSubstep = std::make_shared<ExecutionStepWrapper>(
             &ss, workspace, substepShouldContinue, netDefs, ws_id_injector);
         if (ss.has_run_every_ms()) {
@@ -294,6 +305,7 @@ struct CompiledExecutionStep {
           recurringSubsteps.push_back(compiledSubstep);
         }
       }
+      pipelineShouldContinue = substepShouldContinue;
     } else {
       for (const string& network_name : step->network()) {
         networks.push_back(createAndGetNet(network_name));
@@ -323,8 +335,12 @@ struct CompiledExecutionStep {
 
   const ExecutionStep* step;
   Workspace* workspace;
+  NetDefMap* netDefs;
+  WorkspaceIdInjector* wsIdInjector;
   vector<std::shared_ptr<ExecutionStepWrapper>> reportSubsteps;
   vector<std::shared_ptr<ExecutionStepWrapper>> recurringSubsteps;
+  vector<const ExecutionStep*> pipelineStages;
+  ShouldContinue pipelineShouldContinue;
 
   vector<NetBase*> networks;
   NetBase* reportNet;
@@ -353,6 +369,198 @@ std::unique_ptr<CompiledExecutionStep> ExecutionStepWrapper::doCompile() {
     return true;                                                  \
   }
 
+bool ExecuteStepRecursive(ExecutionStepWrapper& stepWrapper);
+
+// A copy of a stage of a pipelined step, which runs in a workspace of its own.
+struct PipelineStageInstance {
+  // The stage, changed to run a single iteration.
+  ExecutionStep step;
+  std::unique_ptr<Workspace> workspace;
+  std::unique_ptr<ExecutionStepWrapper> wrapper;
+  std::vector<Blob*> inputs;
+  std::vector<Blob*> outputs;
+  Blob* shouldStop{nullptr};
+  int64_t numIterations{0};
+};
+
+// Runs the stages of a pipelined step until the first one is done and all the
+// entries it produced went through the pipeline.
+bool ExecutePipeline(CompiledExecutionStep& compiled) {
+  const auto& step = *compiled.step;
+  const auto& stages = compiled.pipelineStages;
+  const auto numStages = stages.size();
+  CAFFE_ENFORCE_GT(
+      step.pipeline_queue_capacity(),
+      0,
+      "Pipelined step ",
+      step.name(),
+      " must have a positive pipeline_queue_capacity");
+  CAFFE_ENFORCE(
+      stages.back()->pipeline_output_blobs_size() == 0,
+      "The last stage of pipelined step ",
+      step.name(),
+      " has no next stage to pass pipeline_output_blobs to");
+
+  // The queues hold their blobs in a workspace of their own, so that they
+  // don't show in the workspace of the step. queues[s] connects stage s to
+  // stage s + 1.
+  Workspace queueWorkspace;
+  std::vector<std::shared_ptr<BlobsQueue>> queues;
+  for (size_t s = 0; s + 1 < numStages; ++s) {
+    const auto& names = stages[s]->pipeline_output_blobs();
+    queues.push_back(std::make_shared<BlobsQueue>(
+        &queueWorkspace,
+        step.name() + "/pipeline_" + c10::to_string(s),
+        step.pipeline_queue_capacity(),
+        names.size(),
+        /* enforceUniqueName */ false,
+        std::vector<std::string>(names.begin(), names.end())));
+  }
+
+  // The nets are created here, on a single thread, since creating them
+  // updates netDefs.
+  std::vector<std::vector<std::unique_ptr<PipelineStageInstance>>> instances(
+      numStages);
+  for (size_t s = 0; s < numStages; ++s) {
+    // Only the first stage runs for its num_iter iterations, the other ones
+    // run until their input is exhausted.
+    const auto& stage = *stages[s];
+    const int numInstances = stage.has_num_concurrent_instances()
+        ? std::max(stage.num_concurrent_instances(), 1)
+        : 1;
+    for (int i = 0; i < numInstances; ++i) {
+      auto instance = caffe2::make_unique<PipelineStageInstance>();
+      instance->step = stage;
+      instance->step.clear_num_iter();
+      instance->step.clear_should_stop_blob();
+      instance->step.clear_only_once();
+      instance->step.clear_num_concurrent_instances();
+      instance->workspace.reset(new Workspace(compiled.workspace));
+      compiled.wsIdInjector->InjectWorkspaceId(instance->workspace.get());
+      if (s > 0) {
+        for (const auto& name : stages[s - 1]->pipeline_output_blobs()) {
+          instance->inputs.push_back(
+              instance->workspace->CreateLocalBlob(name));
+        }
+      }
+      for (const auto& name : stage.pipeline_output_blobs()) {
+        instance->outputs.push_back(instance->workspace->CreateLocalBlob(name));
+      }
+      instance->wrapper.reset(new ExecutionStepWrapper(
+          &instance->step,
+          instance->workspace.get(),
+          compiled.pipelineShouldContinue,
+          compiled.netDefs,
+          compiled.wsIdInjector));
+      if (stage.has_should_stop_blob()) {
+        instance->shouldStop =
+            instance->workspace->GetBlob(stage.should_stop_blob());
+        CAFFE_ENFORCE(
+            instance->shouldStop,
+            "blob ",
+            stage.should_stop_blob(),
+            " does not exist");
+      }
+      instances[s].push_back(std::move(instance));
+    }
+  }
+
+  auto closeQueues = [&]() {
+    for (auto& queue : queues) {
+      queue->close();
+    }
+  };
+  std::vector<std::atomic<size_t>> remaining(numStages);
+  for (size_t s = 0; s < numStages; ++s) {
+    remaining[s] = instances[s].size();
+  }
+  const auto firstStageShouldContinue =
+      getContinuationTest(compiled.workspace, *stages[0]);
+
+  std::mutex exception_mutex;
+  string first_exception;
+  auto worker = [&](size_t s, PipelineStageInstance* instance) {
+    try {
+      for (int64_t iter = 0; compiled.pipelineShouldContinue(iter) &&
+           (s > 0 || firstStageShouldContinue(iter));
+           ++iter) {
+        if (s > 0 && !queues[s - 1]->blockingRead(instance->inputs)) {
+          // The previous stage is done, or failed.
+          break;
+        }
+        if (!ExecuteStepRecursive(*instance->wrapper)) {
+          compiled.gotFailure = true;
+          closeQueues();
+          break;
+        }
+        ++instance->numIterations;
+        if (s + 1 < numStages &&
+            !queues[s]->blockingWrite(instance->outputs)) {
+          // The next stage is done, or failed.
+          break;
+        }
+        if (getShouldStop(instance->shouldStop)) {
+          VLOG(1) << "Pipeline stage " << instance->step.name()
+                  << " stopped by " << stages[s]->should_stop_blob();
+          break;
+        }
+      }
+    } catch (const std::exception& ex) {
+      {
+        std::lock_guard<std::mutex> guard(exception_mutex);
+        if (!first_exception.size()) {
+          first_exception = c10::GetExceptionString(ex);
+          LOG(ERROR) << "Pipeline worker exception:\n" << first_exception;
+        }
+      }
+      compiled.gotFailure = true;
+      closeQueues();
+      if (!FLAGS_caffe2_handle_executor_threads_exceptions) {
+        throw;
+      }
+    }
+    // Once all the copies of a stage are done, the next stage gets no more
+    // input, and the previous one must stop producing.
+    if (--remaining[s] == 0) {
+      if (s + 1 < numStages) {
+        queues[s]->close();
+      }
+      if (s > 0) {
+        queues[s - 1]->close();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t s = 0; s < numStages; ++s) {
+    for (auto& instance : instances[s]) {
+      threads.emplace_back(worker, s, instance.get());
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t s = 0; s < numStages; ++s) {
+    int64_t numIterations = 0;
+    for (const auto& instance : instances[s]) {
+      numIterations += instance->numIterations;
+    }
+    VLOG(1) << "Pipeline stage " << stages[s]->name() << " of step "
+            << step.name() << " ran " << numIterations << " iterations on "
+            << instances[s].size() << " threads";
+  }
+  if (compiled.gotFailure) {
+    LOG(ERROR) << "One of the pipeline workers failed.";
+    if (first_exception.size()) {
+      CAFFE_THROW(
+          "One of the pipeline workers died with an unhandled exception ",
+          first_exception);
+    }
+    return false;
+  }
+  return true;
+}
+
 bool ExecuteStepRecursive(ExecutionStepWrapper& stepWrapper) {
   const auto& step = stepWrapper.step();
   auto compiledStep = stepWrapper.compiled();
@@ -383,7 +591,18 @@ bool ExecuteStepRecursive(ExecutionStepWrapper& stepWrapper) {
 
   const Blob* shouldStop = compiledStep->shouldStop;
 
-  if (step.substep_size()) {
+  if (!compiledStep->pipelineStages.empty()) {
+    for (int64_t iter = 0; compiledStep->shouldContinue(iter); ++iter) {
+      VLOG(1) << "Executing step " << step.name() << " iteration " << iter
+              << " with " << compiledStep->pipelineStages.size()
+              << " pipelined substeps";
+      if (!ExecutePipeline(*compiledStep)) {
+        return false;
+      }
+      CHECK_SHOULD_STOP(step, shouldStop);
+    }
+    return true;
+  } else if (step.substep_size()) {
     bool sequential =
         (!step.concurrent_substeps() || step.substep().size() <= 1) &&
         (!step.has_num_concurrent_instances() ||
@@ -117,6 +117,18 @@ void ProfDAGCounters::ReportRunEnd() {
   }
 }
 
+std::vector<float> ProfDAGCounters::GetMeanTimePerOp() const {
+  std::vector<float> mean_times;
+  if (report_.runtime_stats_.cnt() == 0) {
+    return mean_times;
+  }
+  mean_times.reserve(report_.time_per_op_total_.size());
+  for (const auto& stats : report_.time_per_op_total_) {
+    mean_times.push_back(stats.cnt() > 0 ? stats.sum() / stats.cnt() : 0.0);
+  }
+  return mean_times;
+}
+
 ProfDAGReport ProfDAGCounters::GetReport() const {
   return report_;
 }
@@ -105,6 +105,10 @@ class ProfDAGCounters {
   void AddPerOpAsyncEndTime(size_t op_id);
   ProfDAGReport GetReport() const;
 
+  // Returns the mean time in ms of each operator of the net over the profiled
+  // runs, or an empty vector if no run has been profiled yet.
+  std::vector<float> GetMeanTimePerOp() const;
+
  private:
   Timer timer_;
 
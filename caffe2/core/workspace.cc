@@ -74,15 +74,13 @@ vector<string> Workspace::LocalBlobs() const {
   for (auto& entry : blob_map_) {
     names.push_back(entry.first);
   }
+  // The blob map is not ordered, but the listed blobs are sorted by name.
+  std::sort(names.begin(), names.end());
   return names;
 }
 
 vector<string> Workspace::Blobs() const {
-  vector<string> names;
-  names.reserve(blob_map_.size());
-  for (auto& entry : blob_map_) {
-    names.push_back(entry.first);
-  }
+  vector<string> names = LocalBlobs();
   for (const auto& forwarded : forwarded_blobs_) {
     const auto parent_ws = forwarded.second.first;
     const auto& parent_name = forwarded.second.second;
@@ -158,11 +156,14 @@ bool Workspace::RemoveBlob(const string& name) {
 }
 
 const Blob* Workspace::GetBlob(const string& name) const {
-  if (blob_map_.count(name)) {
-    return blob_map_.at(name).get();
-  } else if (forwarded_blobs_.count(name)) {
-    const auto parent_ws = forwarded_blobs_.at(name).first;
-    const auto& parent_name = forwarded_blobs_.at(name).second;
+  const auto it = blob_map_.find(name);
+  if (it != blob_map_.end()) {
+    return it->second.get();
+  }
+  const auto forwarded = forwarded_blobs_.find(name);
+  if (forwarded != forwarded_blobs_.end()) {
+    const auto parent_ws = forwarded->second.first;
+    const auto& parent_name = forwarded->second.second;
     return parent_ws->GetBlob(parent_name);
   } else if (shared_ && shared_->HasBlob(name)) {
     return shared_->GetBlob(name);
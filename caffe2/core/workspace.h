@@ -8,6 +8,7 @@
 #include <cstddef>
 #include <mutex>
 #include <typeinfo>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -47,7 +48,8 @@ struct CAFFE2_API StopOnSignal {
 class CAFFE2_API Workspace {
  public:
   typedef std::function<bool(int)> ShouldContinue;
-  typedef CaffeMap<string, unique_ptr<Blob> > BlobMap;
+  // Blobs are looked up by name on every feed and fetch, so they are hashed.
+  typedef std::unordered_map<string, unique_ptr<Blob> > BlobMap;
   typedef CaffeMap<string, unique_ptr<NetBase> > NetMap;
   /**
    * Initializes an empty workspace.
@@ -181,9 +183,11 @@ class CAFFE2_API Workspace {
     // Then, check the forwarding map, then the parent workspace
     if (blob_map_.count(name)) {
       return true;
-    } else if (forwarded_blobs_.count(name)) {
-      const auto parent_ws = forwarded_blobs_.at(name).first;
-      const auto& parent_name = forwarded_blobs_.at(name).second;
+    }
+    const auto forwarded = forwarded_blobs_.find(name);
+    if (forwarded != forwarded_blobs_.end()) {
+      const auto parent_ws = forwarded->second.first;
+      const auto& parent_name = forwarded->second.second;
       return parent_ws->HasBlob(parent_name);
     } else if (shared_) {
       return shared_->HasBlob(name);
@@ -216,6 +220,11 @@ class CAFFE2_API Workspace {
   /**
    * Gets the blob with the given name as a const pointer. If the blob does not
    * exist, a nullptr is returned.
+   *
+   * The pointer stays valid until the blob is removed from the workspace that
+   * owns it (renaming keeps the blob), so code that feeds or fetches the same
+   * blobs on every run can resolve them once and reuse the pointers, like
+   * operators do.
    */
   const Blob* GetBlob(const string& name) const;
   /**
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 
 #include "caffe2/core/operator.h"
@@ -53,6 +54,23 @@ TEST(WorkspaceTest, BlobAccess) {
   EXPECT_FALSE(ws.HasBlob("newblob"));
 }
 
+TEST(WorkspaceTest, BlobPointersAreStable) {
+  Workspace ws;
+  Blob* blob = ws.CreateBlob("b");
+  *blob->GetMutable<int>() = 7;
+  for (int i = 0; i < 100; ++i) {
+    ws.CreateBlob("pad" + c10::to_string(i));
+  }
+  // Growing the blob map must not move existing blobs.
+  EXPECT_EQ(ws.GetBlob("b"), blob);
+  EXPECT_EQ(ws.RenameBlob("b", "c"), blob);
+  EXPECT_EQ(ws.GetBlob("c")->Get<int>(), 7);
+
+  const auto names = ws.LocalBlobs();
+  EXPECT_EQ(names.size(), 101);
+  EXPECT_TRUE(std::is_sorted(names.begin(), names.end()));
+}
+
 TEST(WorkspaceTest, RunEmptyPlan) {
   PlanDef plan_def;
   Workspace ws;
@@ -196,5 +196,63 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(DBRangeCursorTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  std::unique_ptr<DB> db(CreateDB("leveldb", name, READ));
+
+  std::unique_ptr<Cursor> cursor(db->NewCursor());
+  std::vector<string> splits = SplitKeyRanges(cursor.get(), 3);
+  EXPECT_EQ(splits, std::vector<string>({"03", "06"}));
+  // There are no empty ranges.
+  EXPECT_EQ(SplitKeyRanges(cursor.get(), 20).size(), kMaxItems - 1);
+  EXPECT_TRUE(SplitKeyRanges(cursor.get(), 1).empty());
+
+  RangeCursor range(std::unique_ptr<Cursor>(db->NewCursor()), "03", "06");
+  EXPECT_EQ(range.key(), "03");
+  EXPECT_EQ(range.valueView().ToString(), "03");
+  range.Next();
+  EXPECT_EQ(range.key(), "04");
+  range.Next();
+  EXPECT_EQ(range.key(), "05");
+  range.Next();
+  EXPECT_FALSE(range.Valid());
+  // Seeking before the range gives us its first key.
+  range.Seek("01");
+  EXPECT_EQ(range.key(), "03");
+  range.Seek("05");
+  EXPECT_EQ(range.key(), "05");
+  range.Seek("07");
+  EXPECT_FALSE(range.Valid());
+
+  // A range without an end reads to the end of the db.
+  RangeCursor last(std::unique_ptr<Cursor>(db->NewCursor()), "06", "");
+  int count = 0;
+  for (; last.Valid(); last.Next()) {
+    count++;
+  }
+  EXPECT_EQ(count, 4);
+}
+
+TEST(DBPrefetchingCursorTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  std::unique_ptr<DB> db(CreateDB("leveldb", name, READ));
+  for (size_t readahead : {1, 3, 100}) {
+    PrefetchingCursor cursor(
+        std::unique_ptr<Cursor>(db->NewCursor()), readahead);
+    for (int i = 0; i < kMaxItems; ++i) {
+      std::stringstream ss;
+      ss << std::setw(2) << std::setfill('0') << i;
+      EXPECT_TRUE(cursor.Valid());
+      EXPECT_EQ(cursor.key(), ss.str());
+      EXPECT_EQ(cursor.valueView().ToString(), ss.str());
+      cursor.Next();
+    }
+    EXPECT_FALSE(cursor.Valid());
+    TestCursor(&cursor);
+  }
+}
+
 }  // namespace db
 }  // namespace caffe2
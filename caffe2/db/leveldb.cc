@@ -25,6 +25,10 @@ class LevelDBCursor : public Cursor {
   void Next() override { iter_->Next(); }
   string key() override { return iter_->key().ToString(); }
   string value() override { return iter_->value().ToString(); }
+  DBView valueView() override {
+    leveldb::Slice value = iter_->value();
+    return DBView(value.data(), value.size());
+  }
   bool Valid() override { return iter_->Valid(); }
 
  private:
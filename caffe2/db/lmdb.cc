@@ -68,6 +68,13 @@ class LMDBCursor : public Cursor {
         mdb_value_.mv_size);
   }
 
+  // The value is in the memory map of the database, which stays valid as
+  // long as the read transaction of the cursor.
+  DBView valueView() override {
+    return DBView(
+        static_cast<const char*>(mdb_value_.mv_data), mdb_value_.mv_size);
+  }
+
   bool Valid() override { return valid_; }
 
  private:
@@ -11,9 +11,18 @@
 #include <chrono>
 #include <iostream>
 #include <thread>
+#include <unordered_set>
 
 #if defined(_MSC_VER)
 #include <direct.h> // for _mkdir
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
 #endif
 
 #include "c10/util/StringUtil.h"
@@ -38,7 +47,9 @@ static std::string encodeName(const std::string& name) {
 
 FileStoreHandler::FileStoreHandler(
     const std::string& path,
-    const std::string& prefix) {
+    const std::string& prefix,
+    bool useInotify)
+    : useInotify_(useInotify) {
   basePath_ = realPath(path);
   if (!prefix.empty()) {
     basePath_ = basePath_ + "/" + encodeName(prefix);
@@ -123,6 +134,26 @@ int64_t FileStoreHandler::add(
 }
 
 bool FileStoreHandler::check(const std::vector<std::string>& names) {
+#if !defined(_MSC_VER)
+  if (names.size() > 1) {
+    // One scan of the directory is much cheaper than opening every file,
+    // especially on shared filesystems.
+    DIR* dir = opendir(basePath_.c_str());
+    CAFFE_ENFORCE(dir != nullptr, "opendir: ", strerror(errno));
+    std::unordered_set<std::string> files;
+    while (struct dirent* entry = readdir(dir)) {
+      files.insert(entry->d_name);
+    }
+    closedir(dir);
+    for (const auto& name : names) {
+      if (files.count(encodeName(name)) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+#endif
+
   std::vector<std::string> paths;
   for (const auto& name : names) {
     paths.push_back(objectPath(name));
@@ -148,7 +179,13 @@ bool FileStoreHandler::check(const std::vector<std::string>& names) {
 void FileStoreHandler::wait(
     const std::vector<std::string>& names,
     const std::chrono::milliseconds& timeout) {
-  // Not using inotify because it doesn't work on many
+#if defined(__linux__)
+  if (useInotify_) {
+    waitWithInotify(names, timeout);
+    return;
+  }
+#endif
+  // Not using inotify by default because it doesn't work on many
   // shared filesystems (such as NFS).
   const auto start = std::chrono::steady_clock::now();
   while (!check(names)) {
@@ -162,4 +199,42 @@ void FileStoreHandler::wait(
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
   }
 }
+
+#if defined(__linux__)
+// inotify only sees the values set on this host, so this still checks once
+// in a while for values set by other hosts on a shared filesystem.
+void FileStoreHandler::waitWithInotify(
+    const std::vector<std::string>& names,
+    const std::chrono::milliseconds& timeout) {
+  constexpr int kPollIntervalMs = 100;
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  CAFFE_ENFORCE_NE(fd, -1, "inotify_init1: ", strerror(errno));
+  // set moves the values into place
+  if (inotify_add_watch(fd, basePath_.c_str(), IN_MOVED_TO | IN_CREATE) ==
+      -1) {
+    const int error = errno;
+    close(fd);
+    CAFFE_THROW("inotify_add_watch: ", strerror(error));
+  }
+
+  // Checking after adding the watch doesn't miss values set in between
+  const auto start = std::chrono::steady_clock::now();
+  while (!check(names)) {
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    if (timeout != kNoTimeout && elapsed > timeout) {
+      close(fd);
+      STORE_HANDLER_TIMEOUT(
+          "Wait timeout for name(s): ", c10::Join(" ", names));
+    }
+    struct pollfd pfd = {fd, POLLIN, 0};
+    poll(&pfd, 1, kPollIntervalMs);
+    // Drain the events, we only care that the directory changed
+    std::array<char, 4096> events;
+    while (read(fd, events.data(), events.size()) > 0) {
+    }
+  }
+  close(fd);
+}
+#endif
 }
@@ -6,7 +6,12 @@ namespace caffe2 {
 
 class CAFFE2_API FileStoreHandler : public StoreHandler {
  public:
-  explicit FileStoreHandler(const std::string& path, const std::string& prefix);
+  // With useInotify, wait wakes up as soon as a value is set on this host,
+  // see wait.
+  explicit FileStoreHandler(
+      const std::string& path,
+      const std::string& prefix,
+      bool useInotify = false);
   virtual ~FileStoreHandler();
 
   virtual void set(const std::string& name, const std::string& data) override;
@@ -25,12 +30,19 @@ class CAFFE2_API FileStoreHandler : public StoreHandler {
 
  protected:
   std::string basePath_;
+  bool useInotify_;
 
   std::string realPath(const std::string& path);
 
   std::string tmpPath(const std::string& name);
 
   std::string objectPath(const std::string& name);
+
+#if defined(__linux__)
+  void waitWithInotify(
+      const std::vector<std::string>& names,
+      const std::chrono::milliseconds& timeout);
+#endif
 };
 
 } // namespace caffe2
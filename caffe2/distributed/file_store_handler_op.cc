@@ -19,6 +19,10 @@ don't interfere.
 )DOC")
     .Arg("path", "base path used by the FileStoreHandler")
     .Arg("prefix", "prefix for all keys used by this store")
+    .Arg(
+        "use_inotify",
+        "wake up waits with inotify as soon as a key is set on this host, "
+        "still polling for keys set by other hosts (default false)")
     .Output(0, "handler", "unique_ptr<StoreHandler>");
 
 NO_GRADIENT(FileStoreHandlerCreateOp);
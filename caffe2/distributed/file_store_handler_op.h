@@ -17,13 +17,16 @@ class FileStoreHandlerCreateOp final : public Operator<Context> {
             OperatorBase::template GetSingleArgument<std::string>("path", "")),
         prefix_(OperatorBase::template GetSingleArgument<std::string>(
             "prefix",
-            "")) {
+            "")),
+        useInotify_(OperatorBase::template GetSingleArgument<bool>(
+            "use_inotify",
+            false)) {
     CAFFE_ENFORCE_NE(basePath_, "", "path is a required argument");
   }
 
   bool RunOnDevice() override {
-    auto ptr =
-        std::unique_ptr<StoreHandler>(new FileStoreHandler(basePath_, prefix_));
+    auto ptr = std::unique_ptr<StoreHandler>(
+        new FileStoreHandler(basePath_, prefix_, useInotify_));
     *OperatorBase::Output<std::unique_ptr<StoreHandler>>(HANDLER) =
         std::move(ptr);
     return true;
@@ -32,6 +35,7 @@ class FileStoreHandlerCreateOp final : public Operator<Context> {
  private:
   std::string basePath_;
   std::string prefix_;
+  bool useInotify_;
 
   OUTPUT_TAGS(HANDLER);
 };
@@ -31,7 +31,7 @@ class TestFileStoreHandlerOp(TestCase):
         shutil.rmtree(self.tmpdir)
         super(TestFileStoreHandlerOp, self).tearDown()
 
-    def create_store_handler(self):
+    def create_store_handler(self, use_inotify=False):
         # Use new path for every test so they are isolated
         path = self.tmpdir + "/" + str(TestFileStoreHandlerOp.testCounter)
 
@@ -50,13 +50,21 @@ class TestFileStoreHandlerOp(TestCase):
                 "FileStoreHandlerCreate",
                 [],
                 [store_handler],
-                path=path))
+                path=path,
+                use_inotify=use_inotify))
 
         return store_handler
 
     def test_set_get(self):
         StoreOpsTests.test_set_get(self.create_store_handler)
 
+    def test_set_get_inotify(self):
+        StoreOpsTests.test_set_get(
+            lambda: self.create_store_handler(use_inotify=True))
+
+    def test_set_wait(self):
+        StoreOpsTests.test_set_wait(self.create_store_handler)
+
     def test_get_timeout(self):
         with self.assertRaises(StoreHandlerTimeoutError):
             StoreOpsTests.test_get_timeout(self.create_store_handler)
@@ -76,6 +76,76 @@ int64_t RedisStoreHandler::add(const std::string& name, int64_t value) {
   return reply->integer;
 }
 
+std::unique_ptr<redisReply, void (*)(void*)> RedisStoreHandler::commandArgv(
+    const std::vector<std::string>& args) {
+  std::vector<const char*> argv;
+  std::vector<size_t> argvlen;
+  for (const auto& arg : args) {
+    argv.push_back(arg.c_str());
+    argvlen.push_back(arg.length());
+  }
+  void* ptr =
+      redisCommandArgv(redis_, argv.size(), argv.data(), argvlen.data());
+  CAFFE_ENFORCE_NE(ptr, (void*)nullptr, redis_->errstr);
+  return std::unique_ptr<redisReply, void (*)(void*)>(
+      static_cast<redisReply*>(ptr), freeReplyObject);
+}
+
+void RedisStoreHandler::multiSet(
+    const std::vector<std::string>& names,
+    const std::vector<std::string>& data) {
+  CAFFE_ENFORCE_EQ(
+      names.size(), data.size(), "multiSet needs as much data as names");
+  if (names.empty()) {
+    return;
+  }
+  // MSETNX sets all of the keys, or none if any of them exists
+  std::vector<std::string> args;
+  args.reserve(2 * names.size() + 1);
+  args.push_back("MSETNX");
+  for (size_t i = 0; i < names.size(); ++i) {
+    args.push_back(compoundKey(names[i]));
+    args.push_back(data[i]);
+  }
+  auto reply = commandArgv(args);
+  CAFFE_ENFORCE_EQ(reply->type, REDIS_REPLY_INTEGER);
+  CAFFE_ENFORCE_EQ(
+      reply->integer,
+      1,
+      "A value at one of ",
+      c10::Join(" ", names),
+      " was already set",
+      " (perhaps you reused a run ID you have used before?)");
+}
+
+std::vector<std::string> RedisStoreHandler::multiGet(
+    const std::vector<std::string>& names,
+    const std::chrono::milliseconds& timeout) {
+  if (names.empty()) {
+    return {};
+  }
+  // Block until all keys are set
+  wait(names, timeout);
+
+  std::vector<std::string> args;
+  args.reserve(names.size() + 1);
+  args.push_back("MGET");
+  for (const auto& name : names) {
+    args.push_back(compoundKey(name));
+  }
+  auto reply = commandArgv(args);
+  CAFFE_ENFORCE_EQ(reply->type, REDIS_REPLY_ARRAY);
+  CAFFE_ENFORCE_EQ(reply->elements, names.size());
+  std::vector<std::string> data;
+  data.reserve(names.size());
+  for (size_t i = 0; i < reply->elements; ++i) {
+    const redisReply* element = reply->element[i];
+    CAFFE_ENFORCE_EQ(element->type, REDIS_REPLY_STRING);
+    data.emplace_back(element->str, element->len);
+  }
+  return data;
+}
+
 bool RedisStoreHandler::check(const std::vector<std::string>& names) {
   std::vector<std::string> args;
   args.push_back("EXISTS");
@@ -6,6 +6,7 @@ extern "C" {
 #include <hiredis/hiredis.h>
 }
 
+#include <memory>
 #include <string>
 
 namespace caffe2 {
@@ -29,6 +30,14 @@ class CAFFE2_API RedisStoreHandler : public StoreHandler {
       const std::vector<std::string>& names,
       const std::chrono::milliseconds& timeout = kDefaultTimeout) override;
 
+  virtual void multiSet(
+      const std::vector<std::string>& names,
+      const std::vector<std::string>& data) override;
+
+  virtual std::vector<std::string> multiGet(
+      const std::vector<std::string>& names,
+      const std::chrono::milliseconds& timeout = kDefaultTimeout) override;
+
  private:
   std::string host_;
   int port_;
@@ -37,6 +46,10 @@ class CAFFE2_API RedisStoreHandler : public StoreHandler {
   redisContext* redis_;
 
   std::string compoundKey(const std::string& name);
+
+  // Runs a command of one argument per string, e.g. {"MGET", key1, key2}.
+  std::unique_ptr<redisReply, void (*)(void*)> commandArgv(
+      const std::vector<std::string>& args);
 };
 
 } // namespace caffe2
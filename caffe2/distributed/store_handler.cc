@@ -4,6 +4,8 @@
 
 #include <c10/util/typeid.h>
 
+#include "caffe2/core/logging.h"
+
 namespace caffe2 {
 
 constexpr std::chrono::milliseconds StoreHandler::kDefaultTimeout;
@@ -14,6 +16,29 @@ StoreHandler::~StoreHandler() {
   // symbols for this abstract class.
 }
 
+void StoreHandler::multiSet(
+    const std::vector<std::string>& names,
+    const std::vector<std::string>& data) {
+  CAFFE_ENFORCE_EQ(
+      names.size(), data.size(), "multiSet needs as much data as names");
+  for (size_t i = 0; i < names.size(); ++i) {
+    set(names[i], data[i]);
+  }
+}
+
+std::vector<std::string> StoreHandler::multiGet(
+    const std::vector<std::string>& names,
+    const std::chrono::milliseconds& timeout) {
+  // Wait for all of them first, so that the timeout applies to all of them
+  wait(names, timeout);
+  std::vector<std::string> data;
+  data.reserve(names.size());
+  for (const auto& name : names) {
+    data.push_back(get(name, timeout));
+  }
+  return data;
+}
+
 CAFFE_KNOWN_TYPE(std::unique_ptr<StoreHandler>);
 
 } // namespace caffe2
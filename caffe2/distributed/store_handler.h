@@ -52,6 +52,23 @@ class CAFFE2_API StoreHandler {
   virtual void wait(
       const std::vector<std::string>& names,
       const std::chrono::milliseconds& timeout = kDefaultTimeout) = 0;
+
+  /*
+   * Set data for several keys, like set does for each of them.
+   * The default implementation calls set for every key; store handlers
+   * that can, override it to set all of them in one round trip.
+   */
+  virtual void multiSet(
+      const std::vector<std::string>& names,
+      const std::vector<std::string>& data);
+
+  /*
+   * Get the data for several keys, waiting until all of them are stored.
+   * The default implementation calls get for every key.
+   */
+  virtual std::vector<std::string> multiGet(
+      const std::vector<std::string>& names,
+      const std::chrono::milliseconds& timeout = kDefaultTimeout);
 };
 
 /*
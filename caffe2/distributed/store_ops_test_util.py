@@ -68,6 +68,23 @@ class StoreOpsTests(object):
         if not queue.empty():
             raise queue.get()
 
+    @classmethod
+    def test_set_wait(cls, create_store_handler_fn):
+        store_handler = create_store_handler_fn()
+        blobs = ["blob_{}".format(i) for i in range(10)]
+        net = core.Net('set_blobs')
+        for blob in blobs:
+            workspace.FeedBlob(blob, np.full(1, 1, np.float32))
+            net.StoreSet([store_handler, blob], [], blob_name=blob)
+        workspace.RunNetOnce(net)
+        workspace.RunOperatorOnce(
+            core.CreateOperator(
+                "StoreWait",
+                [store_handler],
+                [],
+                blob_names=blobs))
+        workspace.ResetWorkspace()
+
     @classmethod
     def test_get_timeout(cls, create_store_handler_fn):
         store_handler = create_store_handler_fn()
@@ -80,6 +80,9 @@ The dimension of the output image will always be cropxcrop
     .Arg("warp", "If 1, both dimensions of the image will be set to minsize or"
          " scale; otherwise, the other dimension is proportionally scaled."
          " Defaults to 0")
+    .Arg("reduced_decode", "If 1, JPEG images at least twice as large as "
+         "scale are decoded at 1/2, 1/4 or 1/8 of their size. Only used with "
+         "scale and without scale jittering or bounding boxes. Defaults to 0")
     .Arg("crop", "Size to crop the image to. Must be provided")
     .Arg("mirror", "Whether or not to mirror the image. Defaults to 0")
     .Arg("mean", "Mean by which to normalize color channels."
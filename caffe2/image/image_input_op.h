@@ -84,11 +84,12 @@ class ImageInputOp final
       const std::string& value, float *image_data, int item_id,
       const int channels, std::size_t thread_index);
   void DecodeAndTransposeOnly(
-      const std::string& value, uint8_t *image_data, int item_id,
-      const int channels, std::size_t thread_index);
+      const std::string& value, uint8_t *image_data, float *color_params,
+      int item_id, const int channels, std::size_t thread_index);
   bool ApplyTransformOnGPU(
       const std::vector<std::int64_t>& dims,
       const c10::Device& type);
+  int DecodeFlags(const char* data, size_t size, const PerImageArg& info);
 
   unique_ptr<db::DBReader> owned_reader_;
   const db::DBReader* reader_;
@@ -97,6 +98,9 @@ class ImageInputOp final
   vector<Tensor> prefetched_additional_outputs_;
   Tensor prefetched_image_on_device_;
   Tensor prefetched_label_on_device_;
+  // random color jitter and lighting of the images for the GPU transform
+  Tensor prefetched_color_params_;
+  Tensor prefetched_color_params_on_device_;
   vector<Tensor> prefetched_additional_outputs_on_device_;
   // Default parameters for images
   PerImageArg default_arg_;
@@ -120,6 +124,9 @@ class ImageInputOp final
   // it ensures that both dimensions of the image are at least minsize_
   int minsize_;
   bool warp_;
+  // decode JPEG images at a reduced size when they are larger than what they
+  // get scaled to anyway, which libjpeg does in the DCT domain
+  bool reduced_decode_;
   int crop_;
   std::vector<float> mean_;
   std::vector<float> std_;
@@ -129,6 +136,8 @@ class ImageInputOp final
   bool is_test_;
   bool use_caffe_datum_;
   bool gpu_transform_;
+  // whether the GPU transform applies color jitter or lighting
+  bool gpu_color_transform_;
   bool mean_std_copied_ = false;
 
   // thread pool for parse + decode
@@ -189,6 +198,8 @@ ImageInputOp<Context>::ImageInputOp(
       scale_(OperatorBase::template GetSingleArgument<int>("scale", -1)),
       minsize_(OperatorBase::template GetSingleArgument<int>("minsize", -1)),
       warp_(OperatorBase::template GetSingleArgument<int>("warp", 0)),
+      reduced_decode_(
+          OperatorBase::template GetSingleArgument<int>("reduced_decode", 0)),
       crop_(OperatorBase::template GetSingleArgument<int>("crop", -1)),
       mirror_(OperatorBase::template GetSingleArgument<int>("mirror", 0)),
       is_test_(OperatorBase::template GetSingleArgument<int>(
@@ -199,6 +210,9 @@ ImageInputOp<Context>::ImageInputOp(
       gpu_transform_(OperatorBase::template GetSingleArgument<int>(
           "use_gpu_transform",
           0)),
+      gpu_color_transform_(
+          gpu_transform_ && color_ && !is_test_ &&
+          (color_jitter_ || color_lighting_)),
       num_decode_threads_(
           OperatorBase::template GetSingleArgument<int>("decode_threads", 4)),
       additional_output_sizes_(OperatorBase::template GetRepeatedArgument<int>(
@@ -327,6 +341,9 @@ ImageInputOp<Context>::ImageInputOp(
   if (gpu_transform_) {
     LOG(INFO) << "    Performing transformation on GPU";
   }
+  if (reduced_decode_) {
+    LOG(INFO) << "    Decoding JPEG images at a reduced size when possible;";
+  }
   LOG(INFO) << "    Outputting in batches of " << batch_size_ << " images;";
   LOG(INFO) << "    Treating input image as "
             << (color_ ? "color " : "grayscale ") << "image;";
@@ -387,6 +404,12 @@ ImageInputOp<Context>::ImageInputOp(
        int64_t(crop_),
        int64_t(color_ ? 3 : 1)},
       at::dtype<uint8_t>().device(CPU));
+  if (gpu_color_transform_) {
+    ReinitializeTensor(
+        &prefetched_color_params_,
+        {int64_t(batch_size_), int64_t(kNumColorParams)},
+        at::dtype<float>().device(CPU));
+  }
   std::vector<int64_t> sizes;
   if (label_type_ != SINGLE_LABEL && label_type_ != SINGLE_LABEL_WEIGHTED) {
     sizes = std::vector<int64_t>{int64_t(batch_size_), int64_t(num_labels_)};
@@ -448,6 +471,84 @@ bool RandomSizedCropping(
   return inception_scale_jitter;
 }
 
+// Reads the size of a JPEG image from its frame header, without decoding it.
+// Returns false if the data does not look like a JPEG image.
+inline bool ReadJpegSize(
+    const char* encoded,
+    size_t size,
+    int* height,
+    int* width) {
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(encoded);
+  if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+    return false;
+  }
+  size_t pos = 2;
+  while (pos + 4 <= size) {
+    if (data[pos] != 0xFF) {
+      return false;
+    }
+    const uint8_t marker = data[pos + 1];
+    if (marker == 0xFF) {
+      // fill byte
+      pos++;
+      continue;
+    }
+    if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+      // markers without a segment
+      pos += 2;
+      continue;
+    }
+    if (marker == 0xD9 || marker == 0xDA) {
+      // end of image or start of scan, before any frame header
+      return false;
+    }
+    // SOF0 to SOF15, except for DHT, JPG and DAC
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 &&
+        marker != 0xC8 && marker != 0xCC) {
+      if (pos + 9 > size) {
+        return false;
+      }
+      *height = (data[pos + 5] << 8) | data[pos + 6];
+      *width = (data[pos + 7] << 8) | data[pos + 8];
+      return *height > 0 && *width > 0;
+    }
+    pos += 2 + ((data[pos + 2] << 8) | data[pos + 3]);
+  }
+  return false;
+}
+
+// The imdecode flags of an encoded image. With reduced_decode, JPEG images
+// whose shorter side is at least twice the scale are decoded at 1/2, 1/4 or
+// 1/8 of their size, as long as that still is at least the scale. The
+// images get resized to the scale anyway, so this only changes how they are
+// downsampled, while saving most of the work of decoding and resizing. This
+// is never done when the result depends on the original size: for minsize,
+// for inception style scale jittering and for bounding boxes.
+template <class Context>
+int ImageInputOp<Context>::DecodeFlags(
+    const char* data,
+    size_t size,
+    const PerImageArg& info) {
+  const int flags = color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE;
+#if CV_MAJOR_VERSION > 3 || (CV_MAJOR_VERSION == 3 && CV_MINOR_VERSION >= 2)
+  int height, width;
+  if (!reduced_decode_ || scale_ <= 0 || random_scaling_ ||
+      scale_jitter_type_ != NO_SCALE_JITTER || info.bounding_params.valid ||
+      !ReadJpegSize(data, size, &height, &width)) {
+    return flags;
+  }
+  const int64_t min_side = std::min(height, width);
+  if (min_side >= int64_t(scale_) * 8) {
+    return color_ ? cv::IMREAD_REDUCED_COLOR_8 : cv::IMREAD_REDUCED_GRAYSCALE_8;
+  } else if (min_side >= int64_t(scale_) * 4) {
+    return color_ ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_GRAYSCALE_4;
+  } else if (min_side >= int64_t(scale_) * 2) {
+    return color_ ? cv::IMREAD_REDUCED_COLOR_2 : cv::IMREAD_REDUCED_GRAYSCALE_2;
+  }
+#endif
+  return flags;
+}
+
 template <class Context>
 bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     const string& value,
@@ -480,7 +581,7 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
                 datum.data().size(),
                 CV_8UC1,
                 const_cast<char*>(datum.data().data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+            DecodeFlags(datum.data().data(), datum.data().size(), info));
         if (src.rows == 0 || src.cols == 0) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
@@ -555,7 +656,8 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
                 &encoded_size,
                 CV_8UC1,
                 const_cast<char*>(encoded_image_str.data())),
-            color_ ? cv::IMREAD_COLOR : cv::IMREAD_GRAYSCALE);
+            DecodeFlags(
+                encoded_image_str.data(), encoded_image_str.size(), info));
         if (src.rows == 0 || src.cols == 0) {
           num_decode_errors_in_batch_++;
           src = cv::Mat::zeros(cv::Size(224, 224), CV_8UC3);
@@ -927,6 +1029,73 @@ void ColorLighting(
 
 }
 
+// Draws the color jitter and lighting of an image for TransformColorOnGPU,
+// the same way ColorJitter and ColorLighting do. Saturation and contrast
+// keep the gray mean of an image and brightness scales it, so the mean the
+// contrast blends with follows from the mean of the uint8 crop.
+// assume HWC order and color channels BGR
+template <class Context>
+void RandomColorParams(
+  const uint8_t* img,
+  const int img_size,
+  const bool color_jitter,
+  const float saturation,
+  const float brightness,
+  const float contrast,
+  const bool color_lighting,
+  const float color_lighting_std,
+  const std::vector<std::vector<float>>& eigvecs,
+  const std::vector<float>& eigvals,
+  std::mt19937* randgen,
+  float* params
+) {
+  std::vector<int> jitter_order{0, 1, 2};
+  std::vector<float> alphas{1.0f, 1.0f, 1.0f};
+  float gray_mean = 0;
+  if (color_jitter) {
+    std::shuffle(jitter_order.begin(), jitter_order.end(), *randgen);
+    const float alpha_rands[] = {saturation, brightness, contrast};
+    for (int i = 0; i < 3; ++i) {
+      alphas[i] = 1.0f +
+        std::uniform_real_distribution<float>(
+          -alpha_rands[i], alpha_rands[i])(*randgen);
+    }
+    for (int p = 0; p < img_size * img_size; ++p) {
+      // BGR to Gray scale image: R -> 0.299, G -> 0.587, B -> 0.114
+      gray_mean += img[3 * p] * 0.114f + img[3 * p + 1] * 0.587f +
+        img[3 * p + 2] * 0.299f;
+    }
+    gray_mean /= (img_size * img_size);
+    for (int i = 0; i < 3 && jitter_order[i] != 2; ++i) {
+      if (jitter_order[i] == 1) {
+        gray_mean *= alphas[1];
+      }
+    }
+  }
+  for (int i = 0; i < 3; ++i) {
+    params[i] = jitter_order[i];
+    params[3 + i] = alphas[i];
+  }
+  params[6] = gray_mean;
+
+  std::vector<float> delta_rgb(3, 0.0);
+  if (color_lighting) {
+    std::normal_distribution<float> d(0, color_lighting_std);
+    std::vector<float> lighting_alphas(3);
+    for (int i = 0; i < 3; ++i) {
+      lighting_alphas[i] = d(*randgen);
+    }
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        delta_rgb[i] += eigvecs[i][j] * eigvals[j] * lighting_alphas[j];
+      }
+    }
+  }
+  for (int c = 0; c < 3; ++c) {
+    params[7 + c] = delta_rgb[2 - c];
+  }
+}
+
 // assume HWC order and color channels BGR
 // mean subtraction and scaling.
 template <class Context>
@@ -1098,8 +1267,8 @@ void ImageInputOp<Context>::DecodeAndTransform(
 
 template <class Context>
 void ImageInputOp<Context>::DecodeAndTransposeOnly(
-    const std::string& value, uint8_t *image_data, int item_id,
-    const int channels, std::size_t thread_index) {
+    const std::string& value, uint8_t *image_data, float *color_params,
+    int item_id, const int channels, std::size_t thread_index) {
 
   CAFFE_ENFORCE((int)thread_index < num_decode_threads_);
 
@@ -1115,6 +1284,13 @@ void ImageInputOp<Context>::DecodeAndTransposeOnly(
   // Factor out the image transformation
   CropTransposeImage<Context>(img, channels, image_data, crop_, mirror_,
                               randgen, &mirror_this_image, is_test_);
+  // The GPU transform applies the color jitter and lighting
+  if (color_params) {
+    RandomColorParams<Context>(image_data, crop_, color_jitter_,
+      img_saturation_, img_brightness_, img_contrast_, color_lighting_,
+      color_lighting_std_, color_lighting_eigvecs_, color_lighting_eigvals_,
+      randgen, color_params);
+  }
 }
 
 
@@ -1188,16 +1364,20 @@ bool ImageInputOp<Context>::Prefetch() {
     }
 
     // launch into thread pool for processing
-    // TODO: support color jitter and color lighting in gpu_transform
     if (gpu_transform_) {
       // output of decode will still be int8
       uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
           crop_ * crop_ * channels * item_id;
+      float* color_params = gpu_color_transform_
+          ? prefetched_color_params_.mutable_data<float>() +
+              kNumColorParams * item_id
+          : nullptr;
       thread_pool_->runTaskWithID(std::bind(
           &ImageInputOp<Context>::DecodeAndTransposeOnly,
           this,
           std::string(value),
           image_data,
+          color_params,
           item_id,
           channels,
           std::placeholders::_1));
@@ -1234,6 +1414,12 @@ bool ImageInputOp<Context>::Prefetch() {
         &prefetched_image_on_device_, device, prefetched_image_);
     ReinitializeAndCopyFrom(
         &prefetched_label_on_device_, device, prefetched_label_);
+    if (gpu_color_transform_) {
+      ReinitializeAndCopyFrom(
+          &prefetched_color_params_on_device_,
+          device,
+          prefetched_color_params_);
+    }
 
     for (int i = 0; i < prefetched_additional_outputs_on_device_.size(); ++i) {
       ReinitializeAndCopyFrom(
@@ -1266,7 +1452,6 @@ bool ImageInputOp<Context>::CopyPrefetched() {
           i, options, prefetched_additional_outputs_[i - 2], /* async */ true);
     }
   } else {
-    // TODO: support color jitter and color lighting in gpu_transform
     if (gpu_transform_) {
       if (!mean_std_copied_) {
         ReinitializeTensor(
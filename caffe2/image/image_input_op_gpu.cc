@@ -12,21 +12,41 @@ bool ImageInputOp<CUDAContext>::ApplyTransformOnGPU(
   if (output_type_ == TensorProto_DataType_FLOAT) {
     auto* image_output =
         OperatorBase::OutputTensor(0, dims, at::dtype<float>().device(type));
-    TransformOnGPU<uint8_t, float, CUDAContext>(
-        prefetched_image_on_device_,
-        image_output,
-        mean_gpu_,
-        std_gpu_,
-        &context_);
+    if (gpu_color_transform_) {
+      TransformColorOnGPU<uint8_t, float, CUDAContext>(
+          prefetched_image_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          prefetched_color_params_on_device_,
+          &context_);
+    } else {
+      TransformOnGPU<uint8_t, float, CUDAContext>(
+          prefetched_image_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          &context_);
+    }
   } else if (output_type_ == TensorProto_DataType_FLOAT16) {
     auto* image_output =
         OperatorBase::OutputTensor(0, dims, at::dtype<at::Half>().device(type));
-    TransformOnGPU<uint8_t, at::Half, CUDAContext>(
-        prefetched_image_on_device_,
-        image_output,
-        mean_gpu_,
-        std_gpu_,
-        &context_);
+    if (gpu_color_transform_) {
+      TransformColorOnGPU<uint8_t, at::Half, CUDAContext>(
+          prefetched_image_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          prefetched_color_params_on_device_,
+          &context_);
+    } else {
+      TransformOnGPU<uint8_t, at::Half, CUDAContext>(
+          prefetched_image_on_device_,
+          image_output,
+          mean_gpu_,
+          std_gpu_,
+          &context_);
+    }
   } else {
     return false;
   }
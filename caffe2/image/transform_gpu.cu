@@ -46,6 +46,64 @@ __global__ void transform_kernel(
   }
 }
 
+// input in (int8, NHWC BGR), output in (fp32, NCHW), with the color jitter
+// and lighting of kNumColorParams params per image
+template <typename In, typename Out>
+__global__ void transform_color_kernel(
+    const int N,
+    const int H,
+    const int W,
+    const float* mean,
+    const float* std,
+    const float* params,
+    const In* in,
+    Out* out) {
+  const int n = blockIdx.x;
+  const int C = 3;
+
+  const int nStride = C*H*W;
+
+  // pointers to data for this image
+  const In* input_ptr = &in[n*nStride];
+  Out* output_ptr = &out[n*nStride];
+  const float* p = &params[n*kNumColorParams];
+
+  for (int h=threadIdx.y; h < H; h += blockDim.y) {
+    for (int w=threadIdx.x; w < W; w += blockDim.x) {
+      float v[3];
+      for (int c=0; c < C; ++c) {
+        v[c] = convert::To<In,float>(input_ptr[c + C*w + C*W*h]);  // HWC
+      }
+      for (int i=0; i < 3; ++i) {
+        const int op = static_cast<int>(p[i]);
+        const float alpha = p[3 + op];
+        if (op == 0) {
+          // saturation
+          const float gray = v[0]*0.114f + v[1]*0.587f + v[2]*0.299f;
+          for (int c=0; c < C; ++c) {
+            v[c] = v[c]*alpha + gray*(1.0f - alpha);
+          }
+        } else if (op == 1) {
+          // brightness
+          for (int c=0; c < C; ++c) {
+            v[c] *= alpha;
+          }
+        } else {
+          // contrast
+          for (int c=0; c < C; ++c) {
+            v[c] = v[c]*alpha + p[6]*(1.0f - alpha);
+          }
+        }
+      }
+      for (int c=0; c < C; ++c) {
+        int out_idx = c*H*W + h*W + w;  // CHW
+        output_ptr[out_idx] = convert::To<float,Out>(
+          (v[c] + p[7 + c] - mean[c]) * std[c]);
+      }
+    }
+  }
+}
+
 }
 
 template <typename T_IN, typename T_OUT, class Context>
@@ -67,6 +125,27 @@ bool TransformOnGPU(
   return true;
 };
 
+template <typename T_IN, typename T_OUT, class Context>
+bool TransformColorOnGPU(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    Tensor& params,
+    Context* context) {
+  const int N = X.dim32(0), C = X.dim32(3), H = X.dim32(1), W = X.dim32(2);
+  CAFFE_ENFORCE_EQ(C, 3, "Color transforms need BGR images.");
+  CAFFE_ENFORCE_EQ(params.numel(), N * kNumColorParams);
+  auto* input_data = X.template data<T_IN>();
+  auto* output_data = Y->template mutable_data<T_OUT>();
+
+  transform_color_kernel<
+    T_IN, T_OUT><<<N, dim3(16, 16), 0, context->cuda_stream()>>>(
+      N, H, W, mean.template data<float>(), std.template data<float>(),
+      params.template data<float>(), input_data, output_data);
+  return true;
+};
+
 template bool TransformOnGPU<uint8_t, float, CUDAContext>(
     Tensor& X,
     Tensor* Y,
@@ -81,4 +160,20 @@ template bool TransformOnGPU<uint8_t, at::Half, CUDAContext>(
     Tensor& std,
     CUDAContext* context);
 
+template bool TransformColorOnGPU<uint8_t, float, CUDAContext>(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    Tensor& params,
+    CUDAContext* context);
+
+template bool TransformColorOnGPU<uint8_t, at::Half, CUDAContext>(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    Tensor& params,
+    CUDAContext* context);
+
 }  // namespace caffe2
@@ -38,6 +38,24 @@ bool TransformOnGPU(
     Tensor& std,
     Context* context);
 
+// The number of per-image parameters of TransformColorOnGPU: the order of
+// the color jitter operations (0 for saturation, 1 for brightness and 2 for
+// contrast), their alphas in that same 0, 1, 2 order, the gray mean the
+// contrast blends with and the lighting offsets of the B, G and R channels.
+constexpr int kNumColorParams = 10;
+
+// Like TransformOnGPU for BGR images, applying the color jitter and lighting
+// of every image, with params of shape [N, kNumColorParams], before the
+// normalization.
+template <typename T_IN, typename T_OUT, class Context>
+bool TransformColorOnGPU(
+    Tensor& X,
+    Tensor* Y,
+    Tensor& mean,
+    Tensor& std,
+    Tensor& params,
+    Context* context);
+
 }  // namespace caffe2
 
 #endif
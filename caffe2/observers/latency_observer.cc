@@ -0,0 +1,236 @@
+#include "latency_observer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+C10_DEFINE_int64(
+    caffe2_latency_observer_export_interval_ms,
+    10000,
+    "How often the operator latencies recorded by LatencyObservers are "
+    "exported into the StatRegistry");
+
+namespace caffe2 {
+
+namespace {
+
+// Types are recorded by all the threads that run ops, instances by one thread
+// at a time.
+constexpr size_t kMaxTypeShards = 8;
+
+size_t threadShard() {
+  static thread_local const size_t shard =
+      std::hash<std::thread::id>()(std::this_thread::get_id());
+  return shard;
+}
+
+} // namespace
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int LatencyHistogram::kMaxBits;
+constexpr int LatencyHistogram::kNumBuckets;
+
+LatencyHistogram::Shard::Shard() {
+  for (auto& count : counts) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+LatencyHistogram::LatencyHistogram(size_t numShards) {
+  CAFFE_ENFORCE_GT(numShards, 0);
+  for (size_t i = 0; i < numShards; ++i) {
+    shards_.emplace_back(new Shard());
+  }
+}
+
+size_t LatencyHistogram::bucket(int64_t nanos) {
+  if (nanos < kSubBuckets) {
+    return std::max<int64_t>(nanos, 0);
+  }
+  uint64_t value = std::min<uint64_t>(nanos, (uint64_t(1) << kMaxBits) - 1);
+  int bits = 0;
+  while (value >> (bits + 1)) {
+    ++bits;
+  }
+  // value is in [2^bits, 2^(bits + 1)), split into kSubBuckets buckets.
+  const auto shift = bits - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + (value >> shift) - kSubBuckets;
+}
+
+int64_t LatencyHistogram::bucketValue(size_t bucket) {
+  if (bucket < kSubBuckets) {
+    return bucket;
+  }
+  const auto shift = bucket / kSubBuckets - 1;
+  const auto lower = int64_t(kSubBuckets + bucket % kSubBuckets) << shift;
+  return lower + ((int64_t(1) << shift) >> 1);
+}
+
+void LatencyHistogram::record(int64_t nanos) {
+  auto& shard = *shards_[threadShard() % shards_.size()];
+  shard.counts[bucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<int64_t> LatencyHistogram::counts(bool reset) {
+  std::vector<int64_t> result(kNumBuckets, 0);
+  for (auto& shard : shards_) {
+    for (int i = 0; i < kNumBuckets; ++i) {
+      result[i] += reset
+          ? shard->counts[i].exchange(0, std::memory_order_relaxed)
+          : shard->counts[i].load(std::memory_order_relaxed);
+    }
+  }
+  return result;
+}
+
+int64_t LatencyHistogram::percentile(
+    const std::vector<int64_t>& counts,
+    double q) {
+  int64_t total = 0;
+  for (auto count : counts) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+  const auto rank = std::max<int64_t>(1, std::ceil(q * total));
+  int64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return bucketValue(i);
+    }
+  }
+  return bucketValue(counts.size() - 1);
+}
+
+OperatorLatencyStats& OperatorLatencyStats::get() {
+  static OperatorLatencyStats stats;
+  return stats;
+}
+
+LatencyHistogram* OperatorLatencyStats::histogram(
+    std::unordered_map<std::string, std::unique_ptr<LatencyHistogram>>& map,
+    const std::string& key,
+    size_t numShards) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& histogram = map[key];
+  if (!histogram) {
+    histogram.reset(new LatencyHistogram(numShards));
+  }
+  return histogram.get();
+}
+
+LatencyHistogram* OperatorLatencyStats::typeHistogram(const std::string& type) {
+  const size_t numShards = std::max<size_t>(
+      1, std::min<size_t>(kMaxTypeShards, std::thread::hardware_concurrency()));
+  return histogram(types_, type, numShards);
+}
+
+LatencyHistogram* OperatorLatencyStats::instanceHistogram(
+    const std::string& name) {
+  return histogram(instances_, name, 1);
+}
+
+void OperatorLatencyStats::publish(ExportedStatList& exported, bool reset) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  const auto ts = std::chrono::high_resolution_clock::now();
+  auto publishAll = [&](
+      const std::unordered_map<std::string, std::unique_ptr<LatencyHistogram>>&
+          map,
+      const std::string& prefix) {
+    for (const auto& kv : map) {
+      const auto counts = kv.second->counts(reset);
+      const auto key = prefix + kv.first + "/";
+      int64_t total = 0;
+      for (auto count : counts) {
+        total += count;
+      }
+      exported.push_back({key + "count", total, ts});
+      exported.push_back(
+          {key + "p50_ns", LatencyHistogram::percentile(counts, 0.5), ts});
+      exported.push_back(
+          {key + "p90_ns", LatencyHistogram::percentile(counts, 0.9), ts});
+      exported.push_back(
+          {key + "p99_ns", LatencyHistogram::percentile(counts, 0.99), ts});
+    }
+  };
+  publishAll(types_, "operator_latency/type/");
+  publishAll(instances_, "operator_latency/instance/");
+}
+
+void OperatorLatencyStats::maybeExport() {
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now().time_since_epoch())
+                          .count();
+  auto last = lastExportMs_.load();
+  if (now - last < FLAGS_caffe2_latency_observer_export_interval_ms ||
+      !lastExportMs_.compare_exchange_strong(last, now)) {
+    return;
+  }
+  ExportedStatList exported;
+  publish(exported, /* reset */ true);
+  auto& registry = StatRegistry::get();
+  for (const auto& stat : exported) {
+    registry.add(stat.key)->reset(stat.value);
+  }
+}
+
+LatencyOperatorObserver::LatencyOperatorObserver(
+    OperatorBase* subject,
+    const LatencyObserver* netObserver)
+    : ObserverBase<OperatorBase>(subject), netObserver_(netObserver) {
+  const auto& type = subject->debug_def().type();
+  typeHistogram_ = OperatorLatencyStats::get().typeHistogram(type);
+  instanceHistogram_ = OperatorLatencyStats::get().instanceHistogram(
+      netObserver->subject()->Name() + "/" +
+      c10::to_string(subject->net_position()) + "_" + type);
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>> LatencyOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int /* rnn_order */) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new LatencyOperatorObserver(subject, netObserver_));
+}
+
+void LatencyOperatorObserver::Start() {
+  sampled_ = netObserver_->sampling();
+  if (sampled_) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+void LatencyOperatorObserver::Stop() {
+  if (!sampled_) {
+    return;
+  }
+  const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start_)
+                         .count();
+  typeHistogram_->record(nanos);
+  instanceHistogram_->record(nanos);
+}
+
+LatencyObserver::LatencyObserver(NetBase* subject, int sampleRate)
+    : OperatorAttachingNetObserver<LatencyOperatorObserver, LatencyObserver>(
+          subject,
+          this),
+      sampleRate_(sampleRate) {
+  CAFFE_ENFORCE_GT(sampleRate_, 0);
+}
+
+void LatencyObserver::Start() {
+  sampling_.store(runs_++ % sampleRate_ == 0, std::memory_order_relaxed);
+}
+
+void LatencyObserver::Stop() {
+  if (sampling()) {
+    sampling_.store(false, std::memory_order_relaxed);
+    OperatorLatencyStats::get().maybeExport();
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/stats.h"
+#include "caffe2/observers/operator_attaching_net_observer.h"
+
+namespace caffe2 {
+
+// A histogram of durations in nanoseconds, with buckets of logarithmic width
+// like HDR histograms: durations below kSubBuckets have a bucket each, and
+// every larger power of two is split into kSubBuckets buckets, so that a
+// percentile is within 1 / kSubBuckets of the durations it stands for.
+//
+// Recording is a relaxed atomic increment. The counts are split into shards,
+// picked by thread, so that threads recording at the same time don't contend
+// on the same cache lines.
+class CAFFE2_API LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // Durations of 2^40ns (about 18 minutes) and more go to the last bucket.
+  static constexpr int kMaxBits = 40;
+  static constexpr int kNumBuckets =
+      (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+  explicit LatencyHistogram(size_t numShards = 1);
+
+  void record(int64_t nanos);
+
+  // The counts of all the shards, per bucket. If reset is true, the
+  // histogram is emptied; a count recorded meanwhile is never lost.
+  std::vector<int64_t> counts(bool reset = false);
+
+  static size_t bucket(int64_t nanos);
+
+  // The duration a bucket stands for, in the middle of its range.
+  static int64_t bucketValue(size_t bucket);
+
+  // The duration below which a fraction q of the counted durations are, or 0
+  // if there are none.
+  static int64_t percentile(const std::vector<int64_t>& counts, double q);
+
+ private:
+  struct Shard {
+    Shard();
+    std::array<std::atomic<int64_t>, kNumBuckets> counts;
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// The latency histograms of operators, per operator type and per operator
+// instance, which are shared by all the LatencyObservers of the process.
+//
+// The histograms are periodically exported into StatRegistry::get() as
+//   operator_latency/type/<type>/{count,p50_ns,p90_ns,p99_ns}
+//   operator_latency/instance/<net>/<position>_<type>/{count,p50_ns,...}
+// and emptied, so that the exported values describe the last
+// caffe2_latency_observer_export_interval_ms.
+class CAFFE2_API OperatorLatencyStats {
+ public:
+  static OperatorLatencyStats& get();
+
+  // The histograms are never destroyed.
+  LatencyHistogram* typeHistogram(const std::string& type);
+  LatencyHistogram* instanceHistogram(const std::string& name);
+
+  // Appends the count and percentiles of every histogram.
+  void publish(ExportedStatList& exported, bool reset = false);
+
+  // Publishes into StatRegistry::get(), and resets the histograms, if the
+  // last export is older than the export interval.
+  void maybeExport();
+
+ private:
+  OperatorLatencyStats() = default;
+
+  LatencyHistogram* histogram(
+      std::unordered_map<std::string, std::unique_ptr<LatencyHistogram>>& map,
+      const std::string& key,
+      size_t numShards);
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<LatencyHistogram>> types_;
+  std::unordered_map<std::string, std::unique_ptr<LatencyHistogram>>
+      instances_;
+  std::atomic<int64_t> lastExportMs_{0};
+};
+
+class LatencyObserver;
+
+class CAFFE2_API LatencyOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  LatencyOperatorObserver(
+      OperatorBase* subject,
+      const LatencyObserver* netObserver);
+
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  const LatencyObserver* netObserver_;
+  LatencyHistogram* typeHistogram_;
+  LatencyHistogram* instanceHistogram_;
+  bool sampled_ = false;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Records the latencies of the operators of a net into OperatorLatencyStats,
+// in one out of sampleRate runs. The other runs only cost a check of a flag
+// per operator.
+class CAFFE2_API LatencyObserver final
+    : public OperatorAttachingNetObserver<
+          LatencyOperatorObserver,
+          LatencyObserver> {
+ public:
+  explicit LatencyObserver(NetBase* subject, int sampleRate = 100);
+
+  bool sampling() const {
+    return sampling_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  const int sampleRate_;
+  int64_t runs_ = 0;
+  std::atomic<bool> sampling_{false};
+};
+
+} // namespace caffe2
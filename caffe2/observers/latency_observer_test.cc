@@ -0,0 +1,106 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/operator.h"
+#include "latency_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+C10_DECLARE_int64(caffe2_latency_observer_export_interval_ms);
+
+namespace caffe2 {
+
+namespace {
+
+class LatencyTestSleepOp final : public OperatorBase {
+ public:
+  using OperatorBase::OperatorBase;
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    StopAllObservers();
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(LatencyTestSleepOp, LatencyTestSleepOp);
+
+OPERATOR_SCHEMA(LatencyTestSleepOp).NumInputs(0).NumOutputs(0);
+
+int64_t statValue(const ExportedStatList& stats, const std::string& key) {
+  for (const auto& stat : stats) {
+    if (stat.key == key) {
+      return stat.value;
+    }
+  }
+  ADD_FAILURE() << "no stat " << key;
+  return -1;
+}
+
+} // namespace
+
+TEST(LatencyHistogramTest, Buckets) {
+  for (int64_t nanos = 0; nanos < LatencyHistogram::kSubBuckets * 4; ++nanos) {
+    const auto bucket = LatencyHistogram::bucket(nanos);
+    EXPECT_LE(LatencyHistogram::bucket(nanos - 1), bucket);
+    EXPECT_LT(bucket, LatencyHistogram::kNumBuckets);
+  }
+  for (int64_t nanos = 1; nanos < (int64_t(1) << 40); nanos = nanos * 3 + 1) {
+    const auto value =
+        LatencyHistogram::bucketValue(LatencyHistogram::bucket(nanos));
+    EXPECT_LE(
+        std::abs(value - nanos), nanos / LatencyHistogram::kSubBuckets + 1);
+  }
+  EXPECT_EQ(
+      LatencyHistogram::bucket(int64_t(1) << 50),
+      LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram(4);
+  EXPECT_EQ(LatencyHistogram::percentile(histogram.counts(), 0.5), 0);
+  for (int64_t i = 1; i <= 1000; ++i) {
+    histogram.record(i * 1000);
+  }
+  const auto counts = histogram.counts(/* reset */ true);
+  EXPECT_NEAR(LatencyHistogram::percentile(counts, 0.5), 500000, 500000 / 8);
+  EXPECT_NEAR(LatencyHistogram::percentile(counts, 0.99), 990000, 990000 / 8);
+  EXPECT_EQ(LatencyHistogram::percentile(histogram.counts(), 0.5), 0);
+}
+
+TEST(LatencyObserverTest, SamplesRuns) {
+  Workspace ws;
+  NetDef net_def;
+  net_def.set_name("latency_observer_test");
+  net_def.add_op()->set_type("LatencyTestSleepOp");
+  net_def.add_op()->set_type("LatencyTestSleepOp");
+  unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  net->AttachObserver(caffe2::make_unique<LatencyObserver>(net.get(), 3));
+
+  // Keep the interval from resetting the histograms during the test.
+  FLAGS_caffe2_latency_observer_export_interval_ms =
+      std::numeric_limits<int64_t>::max();
+  ExportedStatList stats;
+  OperatorLatencyStats::get().publish(stats, /* reset */ true);
+  for (int i = 0; i < 9; ++i) {
+    net->Run();
+  }
+  stats.clear();
+  OperatorLatencyStats::get().publish(stats);
+
+  EXPECT_EQ(
+      statValue(stats, "operator_latency/type/LatencyTestSleepOp/count"), 6);
+  EXPECT_EQ(
+      statValue(
+          stats,
+          "operator_latency/instance/latency_observer_test/1_"
+          "LatencyTestSleepOp/count"),
+      3);
+  EXPECT_GE(
+      statValue(stats, "operator_latency/type/LatencyTestSleepOp/p50_ns"),
+      2000000 * 7 / 8);
+}
+
+} // namespace caffe2
@@ -0,0 +1,82 @@
+#include "caffe2/operators/fc_relu_op.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "caffe2/operators/fc_inference.h"
+
+namespace caffe2 {
+
+using namespace std::placeholders;
+
+template <>
+bool FCReluOp<CPUContext>::RunOnDevice() {
+  const auto& X = Input(0);
+  const auto& W = Input(1);
+  const auto& b = Input(2);
+
+  CAFFE_ENFORCE(b.dim() == 1, b.dim());
+  const auto canonical_axis = X.canonical_axis_index(axis_);
+  const auto M = X.size_to_dim(canonical_axis);
+  const auto K = X.size_from_dim(canonical_axis);
+  const auto canonical_axis_w = W.canonical_axis_index(axis_w_);
+  const auto N = W.size_to_dim(canonical_axis_w);
+  CAFFE_ENFORCE_EQ(M, X.numel() / K);
+  CAFFE_ENFORCE_EQ(K, W.numel() / N);
+  CAFFE_ENFORCE_EQ(N, b.numel());
+
+  Y_shape_cache_ = X.sizes().vec();
+  Y_shape_cache_.resize(canonical_axis + 1);
+  Y_shape_cache_[canonical_axis] = N;
+  auto* Y = Output(0, Y_shape_cache_, at::dtype<float>());
+  auto* Y_data = Y->template mutable_data<float>();
+  if (X.numel() == 0) {
+    return true;
+  }
+
+  math::Gemm<float, CPUContext>(
+      CblasNoTrans,
+      CblasTrans,
+      M,
+      N,
+      K,
+      1,
+      X.template data<float>(),
+      W.template data<float>(),
+      0,
+      Y_data,
+      &context_);
+
+  const auto* b_data = b.template data<float>();
+  for (int64_t i = 0; i < M; ++i) {
+    auto* row = Y_data + i * N;
+    for (int64_t j = 0; j < N; ++j) {
+      row[j] = std::max(row[j] + b_data[j], 0.0f);
+    }
+  }
+  return true;
+}
+
+REGISTER_CPU_OPERATOR(FCRelu, FCReluOp<CPUContext>);
+
+OPERATOR_SCHEMA(FCRelu)
+    .NumInputs(3)
+    .NumOutputs(1)
+    .TensorInferenceFunction(std::bind(FCShapeInference, _1, _2, false))
+    .CostInferenceFunction(std::bind(CostInferenceForFC, _1, _2, false))
+    .SetDoc(R"DOC(
+Computes $Y = max(XW^T + b, 0)$, i.e. an FC followed by a Relu, with the same
+arguments and input shapes as FC. The bias and the activation are applied in
+one pass over the output. It is produced from FC + Relu by the server
+inference fusion passes of caffe2/opt.
+)DOC")
+    .Arg("axis", "*(type: int; default: 1)* Same as for FC.")
+    .Arg("axis_w", "*(type: int; default: 1)* Same as for FC.")
+    .Input(0, "X", "Input blob to be coerced into a 2D matrix of shape $(M,K)$.")
+    .Input(1, "W", "Weight blob of shape $(N,K)$.")
+    .Input(2, "b", "Bias blob of shape $(N)$.")
+    .Output(0, "Y", "Output blob of shape $(M,N)$.");
+
+SHOULD_NOT_DO_GRADIENT(FCRelu);
+
+} // namespace caffe2
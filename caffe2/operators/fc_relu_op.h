@@ -0,0 +1,33 @@
+#ifndef CAFFE2_OPERATORS_FC_RELU_OP_H_
+#define CAFFE2_OPERATORS_FC_RELU_OP_H_
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/utils/math.h"
+
+namespace caffe2 {
+
+// FC followed by Relu. The bias and the activation are applied in a single
+// pass over the output of the Gemm, instead of the bias Gemm of FC and the
+// extra read and write of Y by Relu.
+template <class Context>
+class FCReluOp final : public Operator<Context> {
+ public:
+  USE_OPERATOR_CONTEXT_FUNCTIONS;
+  template <class... Args>
+  explicit FCReluOp(Args&&... args)
+      : Operator<Context>(std::forward<Args>(args)...),
+        axis_(this->template GetSingleArgument<int32_t>("axis", 1)),
+        axis_w_(this->template GetSingleArgument<int32_t>("axis_w", 1)) {}
+
+  bool RunOnDevice() override;
+
+ protected:
+  size_t axis_{1};
+  size_t axis_w_{1};
+  vector<int64_t> Y_shape_cache_;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_FC_RELU_OP_H_
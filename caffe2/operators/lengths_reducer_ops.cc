@@ -143,4 +143,182 @@ OPERATOR_SCHEMA(SparseLengthsMeanGradient)
     .NumOutputs(1)
     .DisallowInputFillers();
 REGISTER_GRADIENT(SparseLengthsMean, SparseLengthsMeanDef::GetGradient)
+
+bool CPUSparseLengthsSumMultiOp::RunOnDevice() {
+  tasks_.clear();
+  output_data_.clear();
+  for (int t = 0; t < OutputSize(); ++t) {
+    const auto& dataInput = Input(3 * t);
+    const auto& indicesInput = Input(3 * t + 1);
+    const auto& lengthsInput = Input(3 * t + 2);
+    CAFFE_ENFORCE(
+        dataInput.IsType<float>() || dataInput.IsType<at::Half>(),
+        "DATA ",
+        t,
+        " must be float or float16, got ",
+        dataInput.dtype().name());
+    CAFFE_ENFORCE(
+        indicesInput.IsType<int32_t>() || indicesInput.IsType<int64_t>(),
+        "INDICES ",
+        t,
+        " must be int32 or int64, got ",
+        indicesInput.dtype().name());
+    CAFFE_ENFORCE_EQ(1, indicesInput.dim(), "INDICES must be a vector");
+    CAFFE_ENFORCE_EQ(1, lengthsInput.dim(), "LENGTHS must be a vector");
+    const int64_t M = lengthsInput.size(0);
+
+    auto shape = dataInput.sizes().vec();
+    shape[0] = M;
+    auto* output = Output(t, shape, at::dtype<float>());
+    output_data_.push_back(output->template mutable_data<float>());
+
+    // Cut the bags of the table into tasks of lookups_per_task_ lookups, or a
+    // bit more to end them on a bag boundary.
+    const int* lengths = lengthsInput.template data<int>();
+    Task task{t, 0, 0, 0, 0};
+    for (int64_t i = 0; i < M; ++i) {
+      CAFFE_ENFORCE_GE(lengths[i], 0, "LENGTHS must be non-negative");
+      task.end_bag = i + 1;
+      task.end_index += lengths[i];
+      if (task.end_index - task.begin_index >= lookups_per_task_) {
+        tasks_.push_back(task);
+        task.begin_bag = task.end_bag;
+        task.begin_index = task.end_index;
+      }
+    }
+    CAFFE_ENFORCE_EQ(
+        task.end_index,
+        indicesInput.numel(),
+        "LENGTHS ",
+        t,
+        " must sum to the number of indices");
+    if (task.end_bag > task.begin_bag) {
+      tasks_.push_back(task);
+    }
+  }
+
+  if (tasks_.size() <= 1) {
+    for (const auto& task : tasks_) {
+      RunTask(task);
+    }
+    return true;
+  }
+  // The lookups throw on out of range indices, which must not escape the
+  // pool's worker threads.
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  ws_->GetThreadPool()->run(
+      [&](int /* unused */, size_t i) {
+        try {
+          RunTask(tasks_[i]);
+        } catch (...) {
+          std::lock_guard<std::mutex> guard(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      },
+      tasks_.size());
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return true;
+}
+
+void CPUSparseLengthsSumMultiOp::RunTask(const Task& task) {
+  if (Input(3 * task.table).IsType<float>()) {
+    RunTaskWithType<float>(task);
+  } else {
+    RunTaskWithType<at::Half>(task);
+  }
+}
+
+template <typename InputType>
+void CPUSparseLengthsSumMultiOp::RunTaskWithType(const Task& task) {
+  if (Input(3 * task.table + 1).IsType<int32_t>()) {
+    RunTaskWithType2<InputType, int32_t>(task);
+  } else {
+    RunTaskWithType2<InputType, int64_t>(task);
+  }
+}
+
+template <typename InputType, typename IndexType>
+void CPUSparseLengthsSumMultiOp::RunTaskWithType2(const Task& task) {
+  const auto& dataInput = Input(3 * task.table);
+  const auto& indicesInput = Input(3 * task.table + 1);
+  const auto& lengthsInput = Input(3 * task.table + 2);
+  const int64_t D = dataInput.size_from_dim(1);
+
+  EmbeddingLookup<IndexType, InputType, float>(
+      D,
+      task.end_bag - task.begin_bag,
+      task.end_index - task.begin_index,
+      dataInput.size(0),
+      dataInput.template data<InputType>(),
+      indicesInput.template data<IndexType>() + task.begin_index,
+      lengthsInput.template data<int>() + task.begin_bag,
+      nullptr, // weights
+      nullptr, // scale_bias
+      false, // normalize_by_lengths
+      output_data_[task.table] + task.begin_bag * D);
+}
+
+REGISTER_CPU_OPERATOR(SparseLengthsSumMulti, CPUSparseLengthsSumMultiOp);
+
+OPERATOR_SCHEMA(SparseLengthsSumMulti)
+    .NumInputs([](int n) { return n > 0 && n % 3 == 0; })
+    .NumInputsOutputs([](int in, int out) { return in == 3 * out; })
+    .SetDoc(R"DOC(
+Computes the SparseLengthsSum of several tables in one operator. The inputs are
+N triples (DATA, INDICES, LENGTHS) and the i-th output is the SparseLengthsSum
+of the i-th triple, i.e. has the same value the op
+
+  SparseLengthsSum(DATA_i, INDICES_i, LENGTHS_i)
+
+would produce. The bags of all the tables are looked up in parallel on the
+workspace's thread pool, which saves the dispatch overhead of many small
+SparseLengthsSum ops.
+)DOC")
+    .Arg(
+        "lookups_per_task",
+        "(int, default 4096) the number of lookups the bags are grouped into for "
+        "every parallel task")
+    .Input(0, "DATA_0", "Data of the first table, float or float16")
+    .Input(
+        1,
+        "INDICES_0",
+        "Integer vector of the rows of DATA_0 that are summed")
+    .Input(
+        2,
+        "LENGTHS_0",
+        "Vector of the number of INDICES_0 in each bag, summing to the size of "
+        "INDICES_0")
+    .Output(0, "OUTPUT_0", "Sums of the bags of the first table")
+    .TensorInferenceFunction([](const OperatorDef& /* unused */,
+                                const vector<TensorShape>& in) {
+      vector<TensorShape> out(in.size() / 3);
+      for (size_t i = 0; i < out.size(); ++i) {
+        out[i] = in[3 * i];
+        out[i].set_dims(0, in[3 * i + 2].dims(0));
+        out[i].set_data_type(TensorProto::FLOAT);
+      }
+      return out;
+    });
+
+class GetSparseLengthsSumMultiGradient : public GradientMakerBase {
+  using GradientMakerBase::GradientMakerBase;
+  vector<OperatorDef> GetGradientDefs() override {
+    vector<OperatorDef> grads;
+    for (int t = 0; t < def_.output_size(); ++t) {
+      grads.push_back(CreateOperatorDef(
+          "SparseLengthsIndicesInGradientSumGradient",
+          "",
+          vector<string>{GO(t), I(3 * t + 2), I(3 * t + 1)},
+          vector<string>{GI_V(3 * t)}));
+      SetSparse(3 * t, I(3 * t + 1), GI_V(3 * t));
+    }
+    return grads;
+  }
+};
+REGISTER_GRADIENT(SparseLengthsSumMulti, GetSparseLengthsSumMultiGradient);
 } // namespace caffe2
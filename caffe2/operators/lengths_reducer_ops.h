@@ -3,6 +3,9 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/perfkernels/embedding_lookup.h"
 
+#include <exception>
+#include <mutex>
+
 namespace caffe2 {
 
 // A templated class that implements SparseLengths[Sum,WeightedSum,Mean].
@@ -102,4 +105,50 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
   };
 };
 
+// SparseLengthsSum over several tables at once: the inputs are N triples
+// (DATA, INDICES, LENGTHS) and output i is the SparseLengthsSum of triple i.
+// The bags of all the tables are split into tasks of about lookups_per_task
+// lookups, which run on the workspace's thread pool, so that many small
+// lookups cost a single operator dispatch.
+class CPUSparseLengthsSumMultiOp final : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  CPUSparseLengthsSumMultiOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<CPUContext>(operator_def, ws),
+        ws_(ws),
+        lookups_per_task_(
+            this->template GetSingleArgument<int64_t>("lookups_per_task", 4096)) {
+    CAFFE_ENFORCE_EQ(
+        InputSize(),
+        3 * OutputSize(),
+        "SparseLengthsSumMulti takes a (DATA, INDICES, LENGTHS) triple per output");
+    CAFFE_ENFORCE_GT(lookups_per_task_, 0);
+  }
+
+  bool RunOnDevice() override;
+
+ private:
+  // A range of the bags of one table.
+  struct Task {
+    int table;
+    int64_t begin_bag;
+    int64_t end_bag;
+    int64_t begin_index;
+    int64_t end_index;
+  };
+
+  void RunTask(const Task& task);
+
+  template <typename InputType>
+  void RunTaskWithType(const Task& task);
+
+  template <typename InputType, typename IndexType>
+  void RunTaskWithType2(const Task& task);
+
+  Workspace* ws_;
+  int64_t lookups_per_task_;
+  std::vector<Task> tasks_;
+  std::vector<float*> output_data_;
+};
+
 } // namespace caffe2
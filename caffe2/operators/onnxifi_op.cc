@@ -194,7 +194,13 @@ std::vector<int> OnnxifiOp<CPUContext>::extractOutputBatchSizes() const {
     if (shape.empty()) {
       adjusted_output_batch.push_back(0);
     } else {
-      const auto max_output_batch_size = shape.front();
+      auto max_output_batch_size = shape.front();
+      // Outputs of a bucket graph are sized for the bucket instead of the
+      // maximum batch size
+      if (current_bucket_ &&
+          max_output_batch_size == static_cast<uint64_t>(current_bucket_)) {
+        max_output_batch_size = max_batch_size_;
+      }
       const auto it = batch_pos_map_.find(max_output_batch_size);
       if (it == batch_pos_map_.end()) {
         if (use_onnx_) {
@@ -260,11 +266,25 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     SetInputTensorDescriptorTypeAndBuffer(input_tensor, &tensor_descriptor);
   }
 
+  // Pick the graph compiled for the smallest batch size that fits the inputs
+  onnxBackend backend = backend_;
+  onnxGraph graph = graph_;
+  current_bucket_ = pickBatchBucket();
+  if (current_bucket_) {
+    const auto bucket_graph = getBucketGraph(current_bucket_);
+    backend = bucket_graph->backend;
+    graph = bucket_graph->graph;
+  }
+
   CAFFE_ENFORCE_EQ(output_desc_.size(), OutputSize());
   for (unsigned i = 0U; i < OutputSize(); ++i) {
     tensor_dims_int64_.clear();
     std::vector<size_t> tensor_dims;
     uint64_t type = SetOutputShapeAndType(i, &tensor_dims);
+    if (current_bucket_ && !tensor_dims.empty() &&
+        tensor_dims.front() == static_cast<size_t>(max_batch_size_)) {
+      tensor_dims.front() = current_bucket_;
+    }
     auto& tensor_descriptor = output_desc_[i];
     tensor_descriptor.tag = ONNXIFI_TAG_TENSOR_DESCRIPTOR_V1;
     tensor_descriptor.memoryType = ONNXIFI_MEMORY_TYPE_CPU;
@@ -318,7 +338,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     }
     CAFFE_ENFORCE_EQ(
         (*onnxSetIOAndRunGraphPointer_)(
-            graph_,
+            graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -336,7 +356,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
   if (!ext_supported) {
     CAFFE_ENFORCE_EQ(
         lib_->onnxSetGraphIO(
-            graph_,
+            graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -346,7 +366,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     input_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     input_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
     CAFFE_ENFORCE_EQ(
-        lib_->onnxInitEvent(backend_, &input_fence.event),
+        lib_->onnxInitEvent(backend, &input_fence.event),
         ONNXIFI_STATUS_SUCCESS);
     output_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     output_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
@@ -354,7 +374,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     // Call the async run on backend, signal event on input fence and wait for
     // the event on output fence
     CAFFE_ENFORCE_EQ(
-        lib_->onnxRunGraph(graph_, &input_fence, &output_fence),
+        lib_->onnxRunGraph(graph, &input_fence, &output_fence),
         ONNXIFI_STATUS_SUCCESS);
     CAFFE_ENFORCE_EQ(
         lib_->onnxSignalEvent(input_fence.event), ONNXIFI_STATUS_SUCCESS);
@@ -391,5 +411,14 @@ OPERATOR_SCHEMA(Onnxifi)
         "Initialization pair indicating the mapping of the name between NetDef and ONNX model")
     .Arg(
         "output_resize_hints",
-        "A list of key/value pairs indicating which input index to look up for real batch size for the given max output batch size");
+        "A list of key/value pairs indicating which input index to look up for real batch size for the given max output batch size")
+    .Arg(
+        "batch_buckets",
+        "(list of ints, c2 model only) Batch sizes smaller than max_batch_size to compile extra backend graphs for. Each run uses the smallest one the inputs fit in")
+    .Arg(
+        "max_batch_size",
+        "(int) Batch size the shapes in the model were bound to")
+    .Arg(
+        "max_cached_buckets",
+        "(int default=4) Maximum number of batch bucket graphs to keep compiled");
 } // namespace caffe2
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <list>
 #include <unordered_map>
 
 #include "onnx/onnx_pb.h"
@@ -10,6 +12,7 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/onnx/onnxifi_graph_info.h"
 #include "caffe2/onnx/onnxifi_init.h"
+#include "caffe2/utils/proto_utils.h"
 #include "caffe2/utils/string_utils.h"
 
 namespace caffe2 {
@@ -85,11 +88,33 @@ class OnnxifiOp final : public Operator<Context> {
       batch_pos_map_.emplace(k, output_resize_hints[i]);
     }
 
-    // Encode arguments starting with "custom_" to backend
-    std::vector<uint64_t> property_pointers;
-    std::vector<int64_t> int_args;
-    std::vector<float> float_args;
-    buildPropertyList(operator_def, &property_pointers, &int_args, &float_args);
+    // Get batch buckets to compile smaller backend graphs for
+    batch_buckets_ =
+        this->template GetRepeatedArgument<int>("batch_buckets");
+    max_batch_size_ =
+        this->template GetSingleArgument<int>("max_batch_size", 0);
+    max_cached_buckets_ =
+        this->template GetSingleArgument<int>("max_cached_buckets", 4);
+    if (!batch_buckets_.empty()) {
+      if (use_onnx_) {
+        LOG(WARNING)
+            << "Batch buckets are only supported for the c2 model format";
+        batch_buckets_.clear();
+      } else {
+        CAFFE_ENFORCE_GT(
+            max_batch_size_, 0, "batch_buckets requires max_batch_size");
+        std::sort(batch_buckets_.begin(), batch_buckets_.end());
+        CAFFE_ENFORCE_GT(batch_buckets_.front(), 0);
+        CAFFE_ENFORCE_LT(batch_buckets_.back(), max_batch_size_);
+        findBatchInputs(onnx_model_str);
+      }
+    }
+
+    // Encode arguments starting with "custom_" to backend. They are kept
+    // around for compiling batch bucket graphs later.
+    ws_ = ws;
+    buildPropertyList(
+        operator_def, &property_pointers_, &int_args_, &float_args_);
 
     // Initialize the backend if it has not been already created. When we
     // initialized the backend, we will get the weights (initializers) from the
@@ -97,10 +122,16 @@ class OnnxifiOp final : public Operator<Context> {
     // Subsequent call of this function with the same model id should find a
     // cached backend and therefore there is no need to repeat the above
     // process.
-    buildBackendAndGraph(ws, property_pointers, onnx_model_str);
+    buildBackendAndGraph(ws, property_pointers_, onnx_model_str);
+    if (!batch_buckets_.empty()) {
+      onnx_model_str_ = onnx_model_str;
+    }
   }
 
   ~OnnxifiOp() {
+    while (!bucket_graphs_.empty()) {
+      evictBucketGraph();
+    }
     backend_graph_shared_ptr_.reset();
     backend_graph_map_ptr_->remove(op_id_string_);
 #ifdef ONNXIFI_ENABLE_EXT
@@ -149,6 +180,23 @@ class OnnxifiOp final : public Operator<Context> {
         this->template GetSingleArgument<std::string>("model_id", "") + ":" +
         this->template GetSingleArgument<std::string>("net_pos", "");
 
+    backend_graph_shared_ptr_ = createBackendGraph(
+        ws, property_pointers, onnx_model_str, op_id_string_);
+
+    backend_id_ = backend_graph_shared_ptr_->backend_id;
+    backend_ = backend_graph_shared_ptr_->backend;
+    graph_ = backend_graph_shared_ptr_->graph;
+
+    getExtFunctionPointers();
+  }
+
+  // Returns the backend graph of `onnx_model_str` registered under `key`,
+  // compiling it if no other op has done so yet.
+  onnx::SharedPtrBackendGraphInfo createBackendGraph(
+      Workspace* ws,
+      const std::vector<uint64_t>& property_pointers,
+      const std::string& onnx_model_str,
+      const std::string& key) {
     auto initializers =
         this->template GetRepeatedArgument<std::string>("initializers");
     // Build the Onnxifi engine
@@ -214,14 +262,7 @@ class OnnxifiOp final : public Operator<Context> {
       return std::make_shared<onnx::BackendGraphInfo>(
           backend_id, backend, graph, lib_);
     };
-    backend_graph_shared_ptr_ =
-        backend_graph_map_ptr_->insert(op_id_string_, creator);
-
-    backend_id_ = backend_graph_shared_ptr_->backend_id;
-    backend_ = backend_graph_shared_ptr_->backend;
-    graph_ = backend_graph_shared_ptr_->graph;
-
-    getExtFunctionPointers();
+    return backend_graph_map_ptr_->insert(key, creator);
   }
 
   /// Set up function pointer if onnxifi_ext is enabled
@@ -249,6 +290,122 @@ class OnnxifiOp final : public Operator<Context> {
 
   std::vector<int> extractOutputBatchSizes() const;
 
+  // Batch buckets: inputs are bound to the maximum batch size, so small
+  // batches pay for the full one. To avoid that, the op can be given a list of
+  // smaller batch sizes. Each run uses the graph of the smallest bucket the
+  // inputs fit in. The graphs are compiled on first use, and only the most
+  // recently used max_cached_buckets_ of them are kept.
+
+  // Records which inputs have the maximum batch size as their first dimension
+  // in the shape info of the c2 model.
+  void findBatchInputs(const std::string& onnx_model_str) {
+    caffe2::NetDef net;
+    CAFFE_ENFORCE(
+        ParseProtoFromLargeString(onnx_model_str, &net),
+        "Cannot parse c2 model of Onnxifi op");
+    std::unordered_set<std::string> batch_inputs;
+    for (const auto& arg : net.arg()) {
+      if (arg.name() == "input_shape_info") {
+        for (const auto& t : arg.tensors()) {
+          if (t.dims_size() > 0 && t.dims(0) == max_batch_size_) {
+            batch_inputs.emplace(t.name());
+          }
+        }
+      } else if (arg.name() == "input_qshape_info") {
+        for (const auto& t : arg.qtensors()) {
+          if (t.dims_size() > 0 && t.dims(0) == max_batch_size_) {
+            batch_inputs.emplace(t.name());
+          }
+        }
+      }
+    }
+    for (int i = 0; i < input_names_.size(); ++i) {
+      if (batch_inputs.count(input_names_[i])) {
+        batch_input_pos_.push_back(i);
+      }
+    }
+  }
+
+  // Returns the c2 model with the maximum batch size replaced by `bucket`.
+  std::string buildBucketModel(int bucket) const {
+    caffe2::NetDef net;
+    CAFFE_ENFORCE(ParseProtoFromLargeString(onnx_model_str_, &net));
+    for (auto& arg : *net.mutable_arg()) {
+      if (arg.name() == "input_shape_info") {
+        for (auto& t : *arg.mutable_tensors()) {
+          if (t.dims_size() > 0 && t.dims(0) == max_batch_size_) {
+            t.set_dims(0, bucket);
+          }
+        }
+      } else if (arg.name() == "input_qshape_info") {
+        for (auto& t : *arg.mutable_qtensors()) {
+          if (t.dims_size() > 0 && t.dims(0) == max_batch_size_) {
+            t.set_dims(0, bucket);
+          }
+        }
+      }
+    }
+    std::string model_str;
+    net.SerializeToString(&model_str);
+    return model_str;
+  }
+
+  // Returns the smallest batch bucket that fits the current inputs, or 0 if
+  // the full graph has to be used.
+  int pickBatchBucket() const {
+    if (batch_buckets_.empty() || batch_input_pos_.empty()) {
+      return 0;
+    }
+    uint64_t batch_size = 0;
+    for (const auto pos : batch_input_pos_) {
+      const auto& shape = input_shapes_[pos];
+      if (!shape.empty()) {
+        batch_size = std::max(batch_size, shape.front());
+      }
+    }
+    for (const auto bucket : batch_buckets_) {
+      if (batch_size <= static_cast<uint64_t>(bucket)) {
+        return bucket;
+      }
+    }
+    return 0;
+  }
+
+  std::string bucketKey(int bucket) const {
+    return c10::str(op_id_string_, ":batch", bucket);
+  }
+
+  // Returns the backend graph for `bucket`, compiling it if needed and
+  // evicting the least recently used one if there are too many.
+  onnx::SharedPtrBackendGraphInfo getBucketGraph(int bucket) {
+    auto it = std::find_if(
+        bucket_graphs_.begin(),
+        bucket_graphs_.end(),
+        [bucket](const std::pair<int, onnx::SharedPtrBackendGraphInfo>& p) {
+          return p.first == bucket;
+        });
+    if (it != bucket_graphs_.end()) {
+      bucket_graphs_.splice(bucket_graphs_.begin(), bucket_graphs_, it);
+      return bucket_graphs_.front().second;
+    }
+    const auto model_str = buildBucketModel(bucket);
+    bucket_graphs_.emplace_front(
+        bucket,
+        createBackendGraph(
+            ws_, property_pointers_, model_str, bucketKey(bucket)));
+    while (bucket_graphs_.size() >
+           static_cast<size_t>(std::max(max_cached_buckets_, 1))) {
+      evictBucketGraph();
+    }
+    return bucket_graphs_.front().second;
+  }
+
+  void evictBucketGraph() {
+    const auto key = bucketKey(bucket_graphs_.back().first);
+    bucket_graphs_.pop_back();
+    backend_graph_map_ptr_->remove(key);
+  }
+
   void maybeAdjustOutputBatchSizes(
       const std::vector<int>& real_output_batch_sizes);
 
@@ -321,6 +478,26 @@ class OnnxifiOp final : public Operator<Context> {
   std::unordered_map<int, int> batch_pos_map_;
   // Whether we enable tracing in one run of inference
   bool enable_tracing_{false};
+
+  // Workspace holding the weights, and the backend properties, needed to
+  // compile batch bucket graphs lazily
+  Workspace* ws_{nullptr};
+  std::vector<uint64_t> property_pointers_;
+  std::vector<int64_t> int_args_;
+  std::vector<float> float_args_;
+
+  // Sorted batch sizes smaller than max_batch_size_ to compile graphs for
+  std::vector<int> batch_buckets_;
+  int max_batch_size_{0};
+  int max_cached_buckets_{4};
+  // Positions of the inputs whose first dimension is the batch size
+  std::vector<int> batch_input_pos_;
+  // The c2 model, kept around to compile bucket graphs from
+  std::string onnx_model_str_;
+  // Compiled bucket graphs, most recently used first
+  std::list<std::pair<int, onnx::SharedPtrBackendGraphInfo>> bucket_graphs_;
+  // Batch bucket used by the current run, 0 if the full graph is used
+  int current_bucket_{0};
 };
 
 } // namespace caffe2
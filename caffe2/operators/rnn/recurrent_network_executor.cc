@@ -37,6 +37,10 @@ bool ThreadedRecurrentNetworkExecutor::Run(int T) {
   }
 
   CAFFE_ENFORCE(timestep_ops_.size() >= T);
+  if (num_threads_ == 1) {
+    _ExecSerial(T, 1);
+    return true;
+  }
   countdown_ = T * timestep_ops_[0].size();
   finished_timesteps_ = 0;
 
@@ -63,6 +67,10 @@ bool ThreadedRecurrentNetworkExecutor::RunBackwards(int T) {
   }
 
   CAFFE_ENFORCE(timestep_ops_.size() >= T);
+  if (num_threads_ == 1) {
+    _ExecSerial(T, -1);
+    return true;
+  }
   countdown_ = T * timestep_ops_[0].size();
   finished_timesteps_ = 0;
 
@@ -81,70 +89,116 @@ bool ThreadedRecurrentNetworkExecutor::RunBackwards(int T) {
 
 /**
  * Runs a single op and updates its dependencies when finished. If
- * dependent ops are ready to run, adds them to the task_queue.
+ * dependent ops are ready to run, adds them to the task_queue. The last
+ * ready dependency is not queued but run directly on this thread, so chains
+ * of small ops (as in a typical LSTM step net) do not pay a queue round trip
+ * per op.
  */
 void ThreadedRecurrentNetworkExecutor::RunOp(OpTask job, int /*thread_id*/) {
-  bool first_timestep =
-      ((job.forward() && job.timestep == 0) ||
-       (job.backward() && job.timestep == job.T - 1));
-  bool last_timestep =
-      ((job.backward() && job.timestep == 0) ||
-       (job.forward() && job.timestep == job.T - 1));
-  auto& rnn_op = timestep_ops_[job.timestep][job.op_idx];
-  if (rnn_op.num_dynamic_inputs > 0 && !rnn_op.frontier) {
-    CAFFE_ENFORCE_EQ(
-        rnn_op.proc_inputs,
-        rnn_op.num_dynamic_inputs -
-            first_timestep * rnn_op.num_recurrent_inputs,
-        "Error at operator ",
-        job.op_idx,
-        " on timestep ",
-        job.timestep,
-        " T=",
-        job.T,
-        " first =",
-        first_timestep);
-  }
+  bool have_job = true;
+  while (have_job && !failed_) {
+    have_job = false;
+    bool first_timestep =
+        ((job.forward() && job.timestep == 0) ||
+         (job.backward() && job.timestep == job.T - 1));
+    bool last_timestep =
+        ((job.backward() && job.timestep == 0) ||
+         (job.forward() && job.timestep == job.T - 1));
+    auto& rnn_op = timestep_ops_[job.timestep][job.op_idx];
+    if (rnn_op.num_dynamic_inputs > 0 && !rnn_op.frontier) {
+      CAFFE_ENFORCE_EQ(
+          rnn_op.proc_inputs,
+          rnn_op.num_dynamic_inputs -
+              first_timestep * rnn_op.num_recurrent_inputs,
+          "Error at operator ",
+          job.op_idx,
+          " on timestep ",
+          job.timestep,
+          " T=",
+          job.T,
+          " first =",
+          first_timestep);
+    }
 
-  // Reset input dependency counter
-  rnn_op.proc_inputs = 0;
+    // Reset input dependency counter
+    rnn_op.proc_inputs = 0;
 
-  // Run the operator
-  rnn_op.op->Run();
+    // Run the operator
+    rnn_op.op->Run();
 
-  // Knock down dependencies and start next ops, if this
-  // was last dependency fulfilled.
-  for (int depidx : rnn_op.dependencies) {
-    int t = job.timestep;
-    bool for_next_timestep = depidx <= rnn_op.order;
-    if (!last_timestep && for_next_timestep) {
-      t += job.direction;
-    } else if (for_next_timestep) {
-      continue;
+    // Knock down dependencies and start next ops, if this
+    // was last dependency fulfilled.
+    OpTask next;
+    bool have_next = false;
+    for (int depidx : rnn_op.dependencies) {
+      int t = job.timestep;
+      bool for_next_timestep = depidx <= rnn_op.order;
+      if (!last_timestep && for_next_timestep) {
+        t += job.direction;
+      } else if (for_next_timestep) {
+        continue;
+      }
+
+      auto& dep_op = timestep_ops_[t][depidx];
+      int proc_inputs = dep_op.proc_inputs.fetch_add(1) + 1;
+
+      // Schedule next op, if this was the last dependency. Note that on
+      // first timestep we don't have recurrent inputs.
+      int num_req_inputs = dep_op.num_dynamic_inputs;
+      if (first_timestep && !for_next_timestep) {
+        num_req_inputs -= dep_op.num_recurrent_inputs;
+      }
+
+      if (proc_inputs == num_req_inputs || num_req_inputs == 0) {
+        // Keep one ready op for ourselves, preferring one in the current
+        // timestep since its inputs are most likely still in cache.
+        OpTask task(t, depidx, job.T, job.direction);
+        if (!have_next) {
+          next = task;
+          have_next = true;
+        } else if (next.timestep != job.timestep && t == job.timestep) {
+          task_queue_.Push(next);
+          next = task;
+        } else {
+          task_queue_.Push(task);
+        }
+      }
     }
 
-    auto& dep_op = timestep_ops_[t][depidx];
-    int proc_inputs = dep_op.proc_inputs.fetch_add(1) + 1;
+    if (job.op_idx == timestep_ops_template_.size() - 1) {
+      finished_timesteps_.fetch_add(1);
+    }
 
-    // Schedule next op, if this was the last dependency. Note that on
-    // first timestep we don't have recurrent inputs.
-    int num_req_inputs = dep_op.num_dynamic_inputs;
-    if (first_timestep && !for_next_timestep) {
-      num_req_inputs -= dep_op.num_recurrent_inputs;
+    if (have_next) {
+      if (WithinParallelTimesteps(next)) {
+        job = next;
+        have_job = true;
+      } else {
+        task_queue_.Push(next);
+      }
     }
 
-    if (proc_inputs == num_req_inputs || num_req_inputs == 0) {
-      task_queue_.Push(OpTask(t, depidx, job.T, job.direction));
+    // Decrement countdown: when at zero, we have run all ops and can
+    // notify the caller thread.
+    if (countdown_.fetch_sub(1) == 1) {
+      CAFFE_ENFORCE_EQ(0, task_queue_.size());
+      std::unique_lock<std::mutex> lk(countdown_mtx_);
+      cv_.notify_one();
     }
   }
+}
 
-  // Decrement countdown: when at zero, we have run all ops and can
-  // notify the caller thread.
-  if (countdown_.fetch_sub(1) == 1) {
-    CAFFE_ENFORCE_EQ(0, task_queue_.size());
-    std::unique_lock<std::mutex> lk(countdown_mtx_);
-    cv_.notify_one();
+/**
+ * Check for limited timestep parallelism: returns false if running the task
+ * now would start too many timesteps concurrently.
+ */
+bool ThreadedRecurrentNetworkExecutor::WithinParallelTimesteps(
+    const OpTask& job) {
+  if (max_parallel_timesteps_ <= 0) {
+    return true;
   }
+  int t = (job.direction == 1 ? job.timestep : job.T - job.timestep + 1);
+  return t - finished_timesteps_ < max_parallel_timesteps_;
 }
 
 /**
@@ -162,22 +216,15 @@ void ThreadedRecurrentNetworkExecutor::WorkerFunction() {
       break;
     }
 
-    // Check for limited timestep parallelism, and if too many timesteps would
-    // be started concurrently, return the task to task queue.
-    if (max_parallel_timesteps_ > 0) {
-      int t = (job.direction == 1 ? job.timestep : job.T - job.timestep + 1);
-      if (t - finished_timesteps_ >= max_parallel_timesteps_) {
-        // Return to queue
-        task_queue_.Push(job);
-        continue;
-      }
+    // If too many timesteps would be started concurrently, return the task
+    // to task queue.
+    if (!WithinParallelTimesteps(job)) {
+      task_queue_.Push(job);
+      continue;
     }
 
     try {
       RunOp(job, id);
-      if (job.op_idx == timestep_ops_template_.size() - 1) {
-        finished_timesteps_.fetch_add(1);
-      }
       num_jobs++;
     } catch (::caffe2::EnforceNotMet& enf) {
       std::unique_lock<std::mutex> lk(countdown_mtx_);
@@ -193,6 +240,23 @@ void ThreadedRecurrentNetworkExecutor::WorkerFunction() {
   VLOG(1) << "Worker exiting, did run: " << num_jobs << " jobs";
 }
 
+/**
+ * Runs all T timesteps on the calling thread, in step net order. This is
+ * the schedule a plain SimpleNet per timestep would follow, so it needs no
+ * dependency bookkeeping, queue or worker threads. Used when the executor
+ * is configured with a single thread.
+ */
+void ThreadedRecurrentNetworkExecutor::_ExecSerial(int T, int direction) {
+  CAFFE_ENFORCE_EQ(
+      false, failed_, "Tried to execute a previously failed RNN executor");
+  for (int i = 0; i < T; i++) {
+    int t = direction == 1 ? i : T - 1 - i;
+    for (auto& rnn_op : timestep_ops_[t]) {
+      rnn_op.op->Run();
+    }
+  }
+}
+
 /**
  * Start worker threads if not started yet, wait until all tasks
  * finished, or a failure. Called by Run() and RunBackwards().
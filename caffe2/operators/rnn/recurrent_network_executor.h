@@ -511,6 +511,10 @@ class CAFFE2_API ThreadedRecurrentNetworkExecutor : public RecurrentNetworkExecu
 
   void WorkerFunction();
 
+  void _ExecSerial(int T, int direction);
+
+  bool WithinParallelTimesteps(const OpTask& job);
+
   void RunOp(OpTask job, int thread_id);
 
   SimpleQueue<OpTask> task_queue_;
@@ -0,0 +1,196 @@
+#include "caffe2/opt/arena_planner.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "caffe2/core/blob.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/types.h"
+
+namespace caffe2 {
+
+namespace {
+
+// Ops whose output shares the storage of their first input
+const std::unordered_set<std::string>& aliasingOps() {
+  static const std::unordered_set<std::string> ops{"Alias"};
+  return ops;
+}
+
+size_t alignUp(size_t nbytes, size_t alignment) {
+  return (nbytes + alignment - 1) / alignment * alignment;
+}
+
+// Returns 0 if the blob can't be placed in the arena.
+size_t tensorBytes(const ShapeInfo& info) {
+  const auto& shape = info.shape;
+  if (info.is_quantized || shape.unknown_shape() ||
+      shape.unknown_dims_size() > 0 || !shape.has_data_type() ||
+      shape.data_type() == TensorProto_DataType_UNDEFINED ||
+      shape.data_type() == TensorProto_DataType_STRING) {
+    return 0;
+  }
+  const auto& meta = DataTypeToTypeMeta(shape.data_type());
+  if (meta.placementNew()) {
+    return 0;
+  }
+  size_t nbytes = meta.itemsize();
+  for (const auto dim : shape.dims()) {
+    if (dim < 0) {
+      return 0;
+    }
+    nbytes *= dim;
+  }
+  return nbytes;
+}
+
+void deleteArenaBuffer(void* ptr) {
+  delete static_cast<std::shared_ptr<at::DataPtr>*>(ptr);
+}
+
+} // namespace
+
+ArenaPlan planInferenceArena(
+    const NetDef& net,
+    const ShapeInfoMap& shape_info,
+    const std::set<std::string>& static_blobs,
+    size_t alignment) {
+  CAFFE_ENFORCE_GT(alignment, 0);
+  if (net.type() != "" && net.type() != "simple") {
+    LOG(INFO) << "Arena planning assumes sequential execution, but the net "
+              << net.name() << " is of type " << net.type();
+  }
+
+  std::unordered_set<std::string> excluded(
+      static_blobs.begin(), static_blobs.end());
+  excluded.insert(net.external_input().begin(), net.external_input().end());
+  excluded.insert(net.external_output().begin(), net.external_output().end());
+
+  // Step 1: find the range of ops that use each blob
+  std::vector<ArenaBlob> blobs;
+  std::unordered_map<std::string, size_t> index;
+  // Blob whose storage an alias refers to
+  std::unordered_map<std::string, std::string> alias_of;
+  auto storage = [&alias_of](const std::string& name) -> const std::string& {
+    const auto it = alias_of.find(name);
+    return it == alias_of.end() ? name : it->second;
+  };
+  for (int i = 0; i < net.op_size(); ++i) {
+    const auto& op = net.op(i);
+    for (const auto& input : op.input()) {
+      const auto it = index.find(storage(input));
+      if (it != index.end()) {
+        blobs[it->second].last_op = i;
+      } else if (!alias_of.count(input)) {
+        // Read before being written
+        excluded.insert(input);
+      }
+    }
+
+    const bool aliasing = aliasingOps().count(op.type()) && op.input_size() > 0;
+    for (const auto& output : op.output()) {
+      if (excluded.count(output)) {
+        continue;
+      }
+      if (aliasing && !index.count(output)) {
+        alias_of[output] = storage(op.input(0));
+        continue;
+      }
+      const auto it = index.find(storage(output));
+      if (it != index.end()) {
+        blobs[it->second].last_op = i;
+        continue;
+      }
+      const auto info = shape_info.find(output);
+      const size_t nbytes =
+          info == shape_info.end() ? 0 : tensorBytes(info->second);
+      if (nbytes == 0) {
+        VLOG(1) << "Not planning blob " << output << " of op " << op.type();
+        excluded.insert(output);
+        continue;
+      }
+      ArenaBlob blob;
+      blob.name = output;
+      blob.shape = info->second.shape;
+      blob.nbytes = alignUp(nbytes, alignment);
+      blob.first_op = i;
+      blob.last_op = i;
+      index.emplace(output, blobs.size());
+      blobs.push_back(std::move(blob));
+    }
+  }
+
+  // Step 2: place the largest blobs first, each at the lowest offset that
+  // doesn't overlap with the placed blobs that are live at the same time
+  std::vector<size_t> order(blobs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&blobs](size_t a, size_t b) {
+    return blobs[a].nbytes > blobs[b].nbytes;
+  });
+  ArenaPlan plan;
+  std::vector<size_t> placed;
+  placed.reserve(blobs.size());
+  for (const auto idx : order) {
+    auto& blob = blobs[idx];
+    std::vector<std::pair<size_t, size_t>> busy;
+    for (const auto other_idx : placed) {
+      const auto& other = blobs[other_idx];
+      if (other.first_op <= blob.last_op && blob.first_op <= other.last_op) {
+        busy.emplace_back(other.offset, other.offset + other.nbytes);
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+    size_t offset = 0;
+    for (const auto& range : busy) {
+      if (range.first >= offset + blob.nbytes) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    blob.offset = offset;
+    plan.total_bytes = std::max(plan.total_bytes, offset + blob.nbytes);
+    placed.push_back(idx);
+  }
+  plan.blobs = std::move(blobs);
+  return plan;
+}
+
+ArenaPlan planInferenceArena(
+    const NetDef& net,
+    const BoundShapeSpec& spec,
+    const ShapeInfoMap& input_info,
+    const std::set<std::string>& static_blobs,
+    size_t alignment) {
+  BoundShapeInferencer inferencer(spec);
+  inferencer.InferBoundShapeAndType(net, input_info);
+  return planInferenceArena(
+      net, inferencer.shape_info(), static_blobs, alignment);
+}
+
+InferenceArena::InferenceArena(ArenaPlan plan)
+    : plan_(std::move(plan)),
+      buffer_(std::make_shared<at::DataPtr>(
+          GetCPUAllocator()->allocate(plan_.total_bytes))) {}
+
+void InferenceArena::bind(Workspace* ws) const {
+  CAFFE_ENFORCE(ws);
+  auto* base = static_cast<char*>(buffer_->get());
+  for (const auto& blob : plan_.blobs) {
+    const auto& meta = DataTypeToTypeMeta(blob.shape.data_type());
+    auto* tensor = BlobGetMutableTensor(ws->CreateBlob(blob.name), CPU);
+    tensor->Resize(
+        std::vector<int64_t>(blob.shape.dims().begin(), blob.shape.dims().end()));
+    tensor->ShareExternalPointer(
+        at::DataPtr(
+            base + blob.offset,
+            new std::shared_ptr<at::DataPtr>(buffer_),
+            &deleteArenaBuffer,
+            at::Device(CPU)),
+        meta,
+        blob.nbytes);
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/bound_shape_inferencer.h"
+#include "caffe2/opt/shape_info.h"
+#include "caffe2/proto/caffe2_pb.h"
+
+namespace caffe2 {
+
+/// The placement of one intermediate blob in an inference arena.
+struct CAFFE2_API ArenaBlob {
+  std::string name;
+  // Bound shape and type of the blob
+  TensorShape shape;
+  size_t offset{0};
+  // Size reserved in the arena, rounded up to the alignment
+  size_t nbytes{0};
+  // First and last op that use the blob
+  int first_op{0};
+  int last_op{0};
+};
+
+struct CAFFE2_API ArenaPlan {
+  size_t total_bytes{0};
+  std::vector<ArenaBlob> blobs;
+};
+
+/// Plans the placement of the intermediate blobs of a sequential inference net
+/// in a single buffer, from their bound shapes. Two blobs can share bytes of
+/// the buffer if no op uses both, i.e. if their [first op, last op] ranges
+/// don't overlap. Blobs are placed from the largest down, each at the lowest
+/// offset that doesn't overlap with the blobs it is live with.
+///
+/// Blobs that are external inputs or outputs of the net, that appear in
+/// static_blobs, or that are read before being written are not planned, nor
+/// are blobs without a known shape and fundamental type. Outputs of ops that
+/// alias their input (Alias) use the storage of that input, which is kept live
+/// for as long as the alias is.
+CAFFE2_API ArenaPlan planInferenceArena(
+    const NetDef& net,
+    const ShapeInfoMap& shape_info,
+    const std::set<std::string>& static_blobs = {},
+    size_t alignment = 64);
+
+/// Same as above, with the shapes inferred by BoundShapeInferencer from the
+/// shapes of the inputs and parameters.
+CAFFE2_API ArenaPlan planInferenceArena(
+    const NetDef& net,
+    const BoundShapeSpec& spec,
+    const ShapeInfoMap& input_info,
+    const std::set<std::string>& static_blobs = {},
+    size_t alignment = 64);
+
+/// Owns the buffer of an ArenaPlan and binds the planned blobs of workspaces
+/// to it.
+///
+/// Each planned blob is set to a CPU tensor of its bound shape, whose storage
+/// is its slice of the buffer. Operators that write an output of at most its
+/// bound size and of the planned type then reuse that storage instead of
+/// allocating, so that running the net does not allocate intermediates in
+/// steady state. An op that needs more than the bound falls back to the
+/// allocator for that blob.
+///
+/// The buffer stays alive as long as any tensor still refers to it.
+class CAFFE2_API InferenceArena {
+ public:
+  explicit InferenceArena(ArenaPlan plan);
+
+  /// Creates the planned blobs in ws, sharing the buffer of the arena.
+  /// Workspaces bound to the same arena must not run concurrently.
+  void bind(Workspace* ws) const;
+
+  const ArenaPlan& plan() const {
+    return plan_;
+  }
+
+  const void* data() const {
+    return buffer_->get();
+  }
+
+  size_t nbytes() const {
+    return plan_.total_bytes;
+  }
+
+ private:
+  ArenaPlan plan_;
+  std::shared_ptr<at::DataPtr> buffer_;
+};
+
+} // namespace caffe2
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/common.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/arena_planner.h"
+#include "caffe2/utils/proto_utils.h"
+
+using namespace caffe2;
+namespace {
+
+ShapeInfo makeTensorInfo(
+    ShapeInfo::DimType t,
+    const std::vector<int64_t>& dims,
+    TensorProto::DataType dtype = TensorProto_DataType_FLOAT) {
+  ShapeInfo info;
+  info.dim_type = t;
+  TensorShape& shape = info.shape;
+  for (const auto d : dims) {
+    shape.add_dims(d);
+  }
+  shape.set_data_type(dtype);
+  return info;
+}
+
+const ArenaBlob& findBlob(const ArenaPlan& plan, const std::string& name) {
+  for (const auto& blob : plan.blobs) {
+    if (blob.name == name) {
+      return blob;
+    }
+  }
+  CAFFE_THROW("Blob ", name, " is not in the plan");
+}
+
+bool inPlan(const ArenaPlan& plan, const std::string& name) {
+  for (const auto& blob : plan.blobs) {
+    if (blob.name == name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// X -> FC -> A -> Relu -> B -> FC -> C -> Relu -> Y
+NetDef makeMLP() {
+  NetDef net;
+  net.set_name("mlp");
+  net.add_op()->CopyFrom(
+      CreateOperatorDef("FC", "", {"X", "W1", "b1"}, {"A"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"A"}, {"B"}, {}));
+  net.add_op()->CopyFrom(
+      CreateOperatorDef("FC", "", {"B", "W2", "b2"}, {"C"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"C"}, {"Y"}, {}));
+  for (const auto& name : {"X", "W1", "b1", "W2", "b2"}) {
+    net.add_external_input(name);
+  }
+  net.add_external_output("Y");
+  return net;
+}
+
+void fillTensor(Workspace* ws, const std::string& name, at::IntArrayRef dims) {
+  auto* tensor = BlobGetMutableTensor(ws->CreateBlob(name), CPU);
+  tensor->Resize(dims);
+  auto* data = tensor->template mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = static_cast<float>((i * 7 + name.size()) % 11) / 11 - 0.5f;
+  }
+}
+
+void fillInputs(Workspace* ws) {
+  fillTensor(ws, "X", {4, 8});
+  fillTensor(ws, "W1", {16, 8});
+  fillTensor(ws, "b1", {16});
+  fillTensor(ws, "W2", {8, 16});
+  fillTensor(ws, "b2", {8});
+}
+
+} // namespace
+
+TEST(ArenaPlanner, ReusesMemoryOfDeadBlobs) {
+  ShapeInfoMap shape_map;
+  shape_map.emplace("A", makeTensorInfo(ShapeInfo::DimType::BATCH, {4, 16}));
+  shape_map.emplace("B", makeTensorInfo(ShapeInfo::DimType::BATCH, {4, 16}));
+  shape_map.emplace("C", makeTensorInfo(ShapeInfo::DimType::BATCH, {4, 8}));
+  shape_map.emplace("Y", makeTensorInfo(ShapeInfo::DimType::BATCH, {4, 8}));
+  const auto plan = planInferenceArena(makeMLP(), shape_map);
+
+  ASSERT_EQ(plan.blobs.size(), 3);
+  EXPECT_FALSE(inPlan(plan, "Y"));
+  const auto& a = findBlob(plan, "A");
+  const auto& b = findBlob(plan, "B");
+  const auto& c = findBlob(plan, "C");
+  EXPECT_EQ(a.nbytes, 256);
+  EXPECT_EQ(b.nbytes, 256);
+  EXPECT_EQ(c.nbytes, 128);
+  EXPECT_EQ(a.first_op, 0);
+  EXPECT_EQ(a.last_op, 1);
+  EXPECT_EQ(c.first_op, 2);
+  EXPECT_EQ(c.last_op, 3);
+  // A and B are live together, C reuses the memory of A
+  EXPECT_EQ(a.offset, 0);
+  EXPECT_EQ(b.offset, 256);
+  EXPECT_EQ(c.offset, 0);
+  EXPECT_EQ(plan.total_bytes, 512);
+}
+
+TEST(ArenaPlanner, SkipsStaticAndUnknownBlobs) {
+  ShapeInfoMap shape_map;
+  shape_map.emplace("A", makeTensorInfo(ShapeInfo::DimType::BATCH, {4, 16}));
+  TensorShape unknown;
+  unknown.set_unknown_shape(true);
+  shape_map.emplace("C", ShapeInfo(ShapeInfo::DimType::BATCH, unknown));
+  const auto plan = planInferenceArena(makeMLP(), shape_map, {"A"});
+  // A is static, B has no shape, and C has an unknown one
+  EXPECT_TRUE(plan.blobs.empty());
+  EXPECT_EQ(plan.total_bytes, 0);
+}
+
+TEST(ArenaPlanner, AliasKeepsStorageLive) {
+  NetDef net;
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"X"}, {"A"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Alias", "", {"A"}, {"B"}, {}));
+  net.add_op()->CopyFrom(CreateOperatorDef("Relu", "", {"X"}, {"C"}, {}));
+  net.add_op()->CopyFrom(
+      CreateOperatorDef("Add", "", {"B", "C"}, {"Y"}, {}));
+  net.add_external_input("X");
+  net.add_external_output("Y");
+  ShapeInfoMap shape_map;
+  for (const auto& name : {"A", "B", "C"}) {
+    shape_map.emplace(
+        name, makeTensorInfo(ShapeInfo::DimType::BATCH, {4, 16}));
+  }
+  const auto plan = planInferenceArena(net, shape_map);
+
+  ASSERT_EQ(plan.blobs.size(), 2);
+  EXPECT_FALSE(inPlan(plan, "B"));
+  const auto& a = findBlob(plan, "A");
+  const auto& c = findBlob(plan, "C");
+  // A is read through B by the last op, so C can't take its place
+  EXPECT_EQ(a.last_op, 3);
+  EXPECT_NE(a.offset, c.offset);
+  EXPECT_EQ(plan.total_bytes, 512);
+}
+
+TEST(ArenaPlanner, BoundShapesAndSteadyState) {
+  const auto net = makeMLP();
+  ShapeInfoMap input_info;
+  input_info.emplace("X", makeTensorInfo(ShapeInfo::DimType::BATCH, {4, 8}));
+  input_info.emplace(
+      "W1", makeTensorInfo(ShapeInfo::DimType::CONSTANT, {16, 8}));
+  input_info.emplace("b1", makeTensorInfo(ShapeInfo::DimType::CONSTANT, {16}));
+  input_info.emplace(
+      "W2", makeTensorInfo(ShapeInfo::DimType::CONSTANT, {8, 16}));
+  input_info.emplace("b2", makeTensorInfo(ShapeInfo::DimType::CONSTANT, {8}));
+  BoundShapeSpec spec(4, 100);
+  const InferenceArena arena(planInferenceArena(net, spec, input_info));
+  EXPECT_EQ(arena.nbytes(), 512);
+
+  // Reference run without the arena
+  Workspace ref_ws;
+  fillInputs(&ref_ws);
+  ASSERT_TRUE(ref_ws.RunNetOnce(net));
+  const auto& expected = BlobGetTensor(*ref_ws.GetBlob("Y"), CPU);
+
+  Workspace ws;
+  fillInputs(&ws);
+  arena.bind(&ws);
+  ASSERT_TRUE(ws.CreateNet(net));
+  const auto* begin = static_cast<const char*>(arena.data());
+  for (int iter = 0; iter < 3; ++iter) {
+    ASSERT_TRUE(ws.RunNet(net.name()));
+    for (const auto& blob : arena.plan().blobs) {
+      const auto& tensor = BlobGetTensor(*ws.GetBlob(blob.name), CPU);
+      EXPECT_EQ(
+          static_cast<const char*>(tensor.raw_data()), begin + blob.offset)
+          << blob.name << " was reallocated";
+    }
+    const auto& output = BlobGetTensor(*ws.GetBlob("Y"), CPU);
+    ASSERT_EQ(output.sizes(), expected.sizes());
+    for (int64_t i = 0; i < output.numel(); ++i) {
+      EXPECT_FLOAT_EQ(output.data<float>()[i], expected.data<float>()[i]);
+    }
+  }
+}
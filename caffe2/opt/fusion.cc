@@ -1,5 +1,11 @@
 #include "caffe2/opt/fusion.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
 #include "caffe2/core/logging.h"
+#include "caffe2/utils/proto_utils.h"
 #include "caffe2/opt/converter.h"
 #include "caffe2/opt/passes.h"
 
@@ -121,5 +127,287 @@ void fuseConvBN(nom::repr::NNModule* nn, caffe2::Workspace* ws) {
 
 REGISTER_WS_OPT_PASS_FROM_FUNC(FuseConvBN, fuseConvBN);
 
+namespace {
+
+caffe2::OperatorDef* getMutableOpDef(repr::NNGraph::NodeRef node) {
+  auto* annotation =
+      repr::nn::get<repr::NeuralNetOperator>(node)->getMutableAnnotation();
+  if (!annotation || !isa<caffe2::Caffe2Annotation>(annotation)) {
+    return nullptr;
+  }
+  return dyn_cast<caffe2::Caffe2Annotation>(annotation)
+      ->getMutableOperatorDef();
+}
+
+std::string getOpType(repr::NNGraph::NodeRef node) {
+  return repr::nn::get<repr::NeuralNetOperator>(node)->getName();
+}
+
+bool isExternal(const repr::NNModule* nn, repr::NNGraph::NodeRef tensor) {
+  return nn->inputs.count(tensor) || nn->outputs.count(tensor);
+}
+
+// The nomnigraph form of a net has one tensor node per write of a blob.
+// Counting them tells whether a blob is written only once, in which case it
+// can be renamed, or read in place of another blob, without reordering
+// any write.
+std::unordered_map<std::string, int> countTensorNames(repr::NNModule* nn) {
+  std::unordered_map<std::string, int> counts;
+  for (auto node : nn->dataFlow.getMutableNodes()) {
+    if (repr::nn::is<repr::NeuralNetData>(node)) {
+      ++counts[repr::nn::getName(node)];
+    }
+  }
+  return counts;
+}
+
+// Makes the consumers of `from` read `to` instead, and deletes `from`, whose
+// producer must have been deleted already. Input positions are kept.
+void forwardTensor(
+    repr::NNModule* nn,
+    repr::NNGraph::NodeRef from,
+    repr::NNGraph::NodeRef to) {
+  nn->dataFlow.replaceOutEdges(from, to);
+  nn->dataFlow.deleteNode(from);
+}
+
+bool isUnused(const repr::NNModule* nn, repr::NNGraph::NodeRef tensor) {
+  return !repr::nn::hasConsumer(tensor) && !isExternal(nn, tensor);
+}
+
+int concatAxis(const caffe2::OperatorDef& def) {
+  ArgumentHelper helper(def);
+  if (helper.HasArgument("axis")) {
+    return helper.GetSingleArgument<int>("axis", -1);
+  }
+  return helper.GetSingleArgument<std::string>("order", "NCHW") == "NHWC" ? 3
+                                                                          : 1;
+}
+
+bool fuseActivationsInPlaceHelper(repr::NNModule* nn) {
+  static const std::unordered_set<std::string> kInPlaceActivations{
+      "Relu", "Sigmoid", "Tanh"};
+  auto counts = countTensorNames(nn);
+  for (auto node : repr::nn::nodeIterator<repr::NeuralNetOperator>(
+           nn->dataFlow)) {
+    NOM_REQUIRE_OR_CONT(kInPlaceActivations.count(getOpType(node)));
+    auto inputs = repr::nn::getInputs(node);
+    auto outputs = repr::nn::getOutputs(node);
+    NOM_REQUIRE_OR_CONT(inputs.size() == 1 && outputs.size() == 1);
+    auto input = inputs.front();
+    auto output = outputs.front();
+    auto input_name = repr::nn::getName(input);
+    auto output_name = repr::nn::getName(output);
+    NOM_REQUIRE_OR_CONT(input_name != output_name);
+    NOM_REQUIRE_OR_CONT(repr::nn::is<repr::Tensor>(input));
+    NOM_REQUIRE_OR_CONT(repr::nn::hasProducer(input));
+    NOM_REQUIRE_OR_CONT(!isExternal(nn, input));
+    NOM_REQUIRE_OR_CONT(repr::nn::getConsumers(input).size() == 1);
+    NOM_REQUIRE_OR_CONT(counts[input_name] == 1 && counts[output_name] == 1);
+
+    // The producer writes the output blob, which the activation updates
+    repr::nn::get<repr::Tensor>(input)->setName(output_name);
+    return true;
+  }
+  return false;
+}
+
+bool fuseCopiesHelper(repr::NNModule* nn) {
+  auto counts = countTensorNames(nn);
+  for (auto node : repr::nn::nodeIterator<repr::NeuralNetOperator>(
+           nn->dataFlow)) {
+    NOM_REQUIRE_OR_CONT(getOpType(node) == "Copy");
+    auto inputs = repr::nn::getInputs(node);
+    auto outputs = repr::nn::getOutputs(node);
+    NOM_REQUIRE_OR_CONT(inputs.size() == 1 && outputs.size() == 1);
+    auto input = inputs.front();
+    auto output = outputs.front();
+    NOM_REQUIRE_OR_CONT(!isExternal(nn, output));
+    NOM_REQUIRE_OR_CONT(counts[repr::nn::getName(input)] == 1);
+
+    nn->dataFlow.deleteNode(node);
+    forwardTensor(nn, output, input);
+    return true;
+  }
+  return false;
+}
+
+// Reshape(Reshape(X)) is Reshape(X) with the shape of the second one, unless
+// that shape copies dims of the intermediate tensor with 0.
+bool fuseReshapesHelper(repr::NNModule* nn) {
+  auto counts = countTensorNames(nn);
+  for (auto node : repr::nn::nodeIterator<repr::NeuralNetOperator>(
+           nn->dataFlow)) {
+    NOM_REQUIRE_OR_CONT(getOpType(node) == "Reshape");
+    auto* def = getMutableOpDef(node);
+    NOM_REQUIRE_OR_CONT(def);
+    auto inputs = repr::nn::getInputs(node);
+    NOM_REQUIRE_OR_CONT(inputs.size() == 1);
+    // The second output holds the old shape, which changes when fused
+    auto outputs = repr::nn::getOutputs(node);
+    NOM_REQUIRE_OR_CONT(outputs.size() < 2 || isUnused(nn, outputs[1]));
+    auto shape = ArgumentHelper(*def).GetRepeatedArgument<int64_t>("shape");
+    NOM_REQUIRE_OR_CONT(!shape.empty());
+    NOM_REQUIRE_OR_CONT(std::find(shape.begin(), shape.end(), 0) == shape.end());
+
+    auto reshaped = inputs.front();
+    NOM_REQUIRE_OR_CONT(repr::nn::hasProducer(reshaped));
+    auto first = repr::nn::getProducer(reshaped);
+    NOM_REQUIRE_OR_CONT(getOpType(first) == "Reshape");
+    auto first_inputs = repr::nn::getInputs(first);
+    NOM_REQUIRE_OR_CONT(first_inputs.size() >= 1);
+    auto first_outputs = repr::nn::getOutputs(first);
+    NOM_REQUIRE_OR_CONT(first_outputs.front() == reshaped);
+    NOM_REQUIRE_OR_CONT(
+        first_outputs.size() < 2 || isUnused(nn, first_outputs[1]));
+    NOM_REQUIRE_OR_CONT(!isExternal(nn, reshaped));
+    NOM_REQUIRE_OR_CONT(repr::nn::getConsumers(reshaped).size() == 1);
+    auto input = first_inputs.front();
+    NOM_REQUIRE_OR_CONT(counts[repr::nn::getName(input)] == 1);
+
+    std::vector<repr::NNGraph::NodeRef> unused(
+        first_outputs.begin() + 1, first_outputs.end());
+    nn->dataFlow.deleteNode(first);
+    for (auto tensor : unused) {
+      nn->dataFlow.deleteNode(tensor);
+    }
+    forwardTensor(nn, reshaped, input);
+    return true;
+  }
+  return false;
+}
+
+// A Concat of a single input is a copy, and a Concat input produced by
+// another Concat along the same axis can be replaced by the inputs of the
+// latter, as long as nothing reads the split info of either.
+bool fuseConcatsHelper(repr::NNModule* nn) {
+  auto counts = countTensorNames(nn);
+  for (auto node_pair : repr::nn::dataIterator<repr::Concat>(nn->dataFlow)) {
+    repr::NNGraph::NodeRef node;
+    repr::Concat* concat;
+    std::tie(concat, node) = node_pair;
+    auto* def = getMutableOpDef(node);
+    NOM_REQUIRE_OR_CONT(def && !concat->getAddAxis());
+    auto outputs = repr::nn::getOutputs(node);
+    NOM_REQUIRE_OR_CONT(outputs.size() < 2 || isUnused(nn, outputs[1]));
+    auto inputs = repr::nn::getInputs(node);
+
+    if (inputs.size() == 1) {
+      auto input = inputs.front();
+      auto output = outputs.front();
+      NOM_REQUIRE_OR_CONT(!isExternal(nn, output));
+      NOM_REQUIRE_OR_CONT(counts[repr::nn::getName(input)] == 1);
+      std::vector<repr::NNGraph::NodeRef> unused(
+          outputs.begin() + 1, outputs.end());
+      nn->dataFlow.deleteNode(node);
+      for (auto tensor : unused) {
+        nn->dataFlow.deleteNode(tensor);
+      }
+      forwardTensor(nn, output, input);
+      return true;
+    }
+
+    for (size_t pos = 0; pos < inputs.size(); ++pos) {
+      auto input = inputs[pos];
+      NOM_REQUIRE_OR_CONT(repr::nn::hasProducer(input));
+      auto inner = repr::nn::getProducer(input);
+      NOM_REQUIRE_OR_CONT(repr::nn::is<repr::Concat>(inner));
+      NOM_REQUIRE_OR_CONT(!repr::nn::get<repr::Concat>(inner)->getAddAxis());
+      auto* inner_def = getMutableOpDef(inner);
+      NOM_REQUIRE_OR_CONT(
+          inner_def && concatAxis(*inner_def) == concatAxis(*def));
+      NOM_REQUIRE_OR_CONT(
+          inner_def->device_option().device_type() ==
+              def->device_option().device_type() &&
+          inner_def->device_option().device_id() ==
+              def->device_option().device_id());
+      auto inner_outputs = repr::nn::getOutputs(inner);
+      NOM_REQUIRE_OR_CONT(inner_outputs.front() == input);
+      NOM_REQUIRE_OR_CONT(
+          inner_outputs.size() < 2 || isUnused(nn, inner_outputs[1]));
+      NOM_REQUIRE_OR_CONT(!isExternal(nn, input));
+      NOM_REQUIRE_OR_CONT(repr::nn::getConsumers(input).size() == 1);
+      auto inner_inputs = repr::nn::getInputs(inner);
+      bool rewritten = false;
+      for (auto inner_input : inner_inputs) {
+        rewritten |= counts[repr::nn::getName(inner_input)] != 1;
+      }
+      NOM_REQUIRE_OR_CONT(!rewritten);
+
+      // Splice the inputs of the inner Concat in at the position of its output
+      nn->dataFlow.deleteNode(inner);
+      for (auto tensor : inner_outputs) {
+        nn->dataFlow.deleteNode(tensor);
+      }
+      for (auto inner_input : inner_inputs) {
+        nn->dataFlow.createEdge(inner_input, node);
+      }
+      auto edges = node->getInEdges();
+      std::rotate(
+          edges.begin() + pos, edges.end() - inner_inputs.size(), edges.end());
+      node->setInEdges(edges);
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+void fuseFCRelu(repr::NNModule* nn) {
+  auto should_fuse = [](const repr::FC& fc) {
+    const auto* annotation = fc.getAnnotation();
+    if (!annotation || !isa<caffe2::Caffe2Annotation>(annotation)) {
+      return false;
+    }
+    const auto& def =
+        dyn_cast<caffe2::Caffe2Annotation>(annotation)->getOperatorDef();
+    // FCRelu only has a CPU implementation of the float FC
+    return def.type() == "FC" && def.engine().empty() &&
+        def.device_option().device_type() == caffe2::PROTO_CPU &&
+        !ArgumentHelper::HasArgument(def, "float16_compute");
+  };
+  auto postprocess = [](repr::NNGraph::NodeRef fc_node) {
+    getMutableOpDef(fc_node)->set_type("FCRelu");
+  };
+  fuseActivation<repr::FC, repr::Relu>(nn, should_fuse, postprocess);
+}
+
+void fuseActivationsInPlace(repr::NNModule* nn) {
+  while (fuseActivationsInPlaceHelper(nn)) {
+  }
+}
+
+void fuseCopies(repr::NNModule* nn) {
+  while (fuseCopiesHelper(nn)) {
+  }
+}
+
+void fuseReshapes(repr::NNModule* nn) {
+  while (fuseReshapesHelper(nn)) {
+  }
+}
+
+void fuseConcats(repr::NNModule* nn) {
+  while (fuseConcatsHelper(nn)) {
+  }
+}
+
+void fuseForServerInference(repr::NNModule* nn) {
+  fuseFCRelu(nn);
+  fuseCopies(nn);
+  fuseReshapes(nn);
+  fuseConcats(nn);
+  // Last, since removing glue ops gives more activations a single consumer
+  fuseActivationsInPlace(nn);
+}
+
+REGISTER_OPT_PASS_FROM_FUNC(FuseFCRelu, fuseFCRelu);
+REGISTER_OPT_PASS_FROM_FUNC(FuseActivationsInPlace, fuseActivationsInPlace);
+REGISTER_OPT_PASS_FROM_FUNC(FuseCopies, fuseCopies);
+REGISTER_OPT_PASS_FROM_FUNC(FuseReshapes, fuseReshapes);
+REGISTER_OPT_PASS_FROM_FUNC(FuseConcats, fuseConcats);
+REGISTER_OPT_PASS_FROM_FUNC(FuseForServerInference, fuseForServerInference);
+
 } // namespace opt
 } // namespace caffe2
@@ -27,6 +27,31 @@ using namespace nom;
 
 CAFFE2_API void fuseConvBN(repr::NNModule* nn, caffe2::Workspace* ws);
 
+// Fusions for server inference. They only rewrite the graph, and keep the
+// names of the external inputs and outputs of the net.
+
+// Replaces CPU float FC followed by Relu with FCRelu.
+CAFFE2_API void fuseFCRelu(repr::NNModule* nn);
+
+// Runs Relu, Sigmoid and Tanh in place when their input is an intermediate
+// read by nothing else, by having its producer write their output blob.
+CAFFE2_API void fuseActivationsInPlace(repr::NNModule* nn);
+
+// Removes Copy ops whose output is an intermediate, so that its consumers
+// read the source blob.
+CAFFE2_API void fuseCopies(repr::NNModule* nn);
+
+// Collapses chains of Reshape with a constant shape into the last one.
+CAFFE2_API void fuseReshapes(repr::NNModule* nn);
+
+// Removes Concat of a single input, and merges a Concat consumed only by
+// another Concat along the same axis into it.
+CAFFE2_API void fuseConcats(repr::NNModule* nn);
+
+// Runs all the graph fusions above. Used by opt::optimize at level 2, with
+// fuseConvBN when a workspace is given.
+CAFFE2_API void fuseForServerInference(repr::NNModule* nn);
+
 // Generic activation fusion helper.
 //
 // \tparam OperationT The operator to be fused.
@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/common.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/opt/converter.h"
+#include "caffe2/opt/fusion.h"
+#include "caffe2/utils/proto_utils.h"
+
+using namespace caffe2;
+namespace {
+
+void addOp(
+    NetDef* net,
+    const std::string& type,
+    const std::vector<std::string>& inputs,
+    const std::vector<std::string>& outputs,
+    const std::vector<Argument>& args = {}) {
+  net->add_op()->CopyFrom(CreateOperatorDef(type, "", inputs, outputs, args));
+}
+
+NetDef fuse(const NetDef& net) {
+  auto nn = convertToNNModule(net);
+  opt::fuseForServerInference(&nn);
+  return convertToCaffe2Proto(nn, net);
+}
+
+std::vector<std::string> inputsOf(const OperatorDef& op) {
+  return {op.input().begin(), op.input().end()};
+}
+
+std::vector<std::string> outputsOf(const OperatorDef& op) {
+  return {op.output().begin(), op.output().end()};
+}
+
+void fillTensor(Workspace* ws, const std::string& name, at::IntArrayRef dims) {
+  auto* tensor = BlobGetMutableTensor(ws->CreateBlob(name), CPU);
+  tensor->Resize(dims);
+  auto* data = tensor->template mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = static_cast<float>((i * 5 + name.size()) % 13) / 13 - 0.5f;
+  }
+}
+
+} // namespace
+
+TEST(Fusion, FCRelu) {
+  NetDef net;
+  addOp(&net, "FC", {"X", "W", "b"}, {"A"});
+  addOp(&net, "Relu", {"A"}, {"Y"});
+  for (const auto& name : {"X", "W", "b"}) {
+    net.add_external_input(name);
+  }
+  net.add_external_output("Y");
+  const auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 1);
+  EXPECT_EQ(fused.op(0).type(), "FCRelu");
+  EXPECT_EQ(inputsOf(fused.op(0)), (std::vector<std::string>{"X", "W", "b"}));
+  EXPECT_EQ(outputsOf(fused.op(0)), std::vector<std::string>{"Y"});
+
+  Workspace ws;
+  fillTensor(&ws, "X", {3, 5});
+  fillTensor(&ws, "W", {4, 5});
+  fillTensor(&ws, "b", {4});
+  ASSERT_TRUE(ws.RunNetOnce(net));
+  Tensor expected(BlobGetTensor(*ws.GetBlob("Y"), CPU).Clone());
+  ASSERT_TRUE(ws.RunNetOnce(fused));
+  const auto& output = BlobGetTensor(*ws.GetBlob("Y"), CPU);
+  ASSERT_EQ(output.sizes(), expected.sizes());
+  for (int64_t i = 0; i < output.numel(); ++i) {
+    EXPECT_FLOAT_EQ(output.data<float>()[i], expected.data<float>()[i]);
+  }
+}
+
+TEST(Fusion, ActivationsInPlace) {
+  NetDef net;
+  addOp(&net, "Mul", {"X", "X"}, {"A"});
+  addOp(&net, "Sigmoid", {"A"}, {"B"});
+  addOp(&net, "Tanh", {"X"}, {"C"});
+  net.add_external_input("X");
+  net.add_external_output("B");
+  net.add_external_output("C");
+  const auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 3);
+  EXPECT_EQ(outputsOf(fused.op(0)), std::vector<std::string>{"B"});
+  EXPECT_EQ(inputsOf(fused.op(1)), std::vector<std::string>{"B"});
+  EXPECT_EQ(outputsOf(fused.op(1)), std::vector<std::string>{"B"});
+  // X is an external input, so it isn't overwritten
+  EXPECT_EQ(inputsOf(fused.op(2)), std::vector<std::string>{"X"});
+  EXPECT_EQ(outputsOf(fused.op(2)), std::vector<std::string>{"C"});
+}
+
+TEST(Fusion, Copies) {
+  NetDef net;
+  addOp(&net, "Copy", {"X"}, {"A"});
+  addOp(&net, "Fake", {"A"}, {"Y"});
+  addOp(&net, "Copy", {"Y"}, {"Z"});
+  net.add_external_input("X");
+  net.add_external_output("Z");
+  const auto fused = fuse(net);
+  // The last copy writes an output of the net
+  ASSERT_EQ(fused.op_size(), 2);
+  EXPECT_EQ(fused.op(0).type(), "Fake");
+  EXPECT_EQ(inputsOf(fused.op(0)), std::vector<std::string>{"X"});
+  EXPECT_EQ(fused.op(1).type(), "Copy");
+  EXPECT_EQ(outputsOf(fused.op(1)), std::vector<std::string>{"Z"});
+}
+
+TEST(Fusion, CopyOfRewrittenBlob) {
+  NetDef net;
+  addOp(&net, "Fake", {"X"}, {"A"});
+  addOp(&net, "Copy", {"A"}, {"B"});
+  addOp(&net, "Fake", {"A"}, {"A"});
+  addOp(&net, "Sum", {"A", "B"}, {"Y"});
+  net.add_external_input("X");
+  net.add_external_output("Y");
+  // B must keep the value of A before it is updated in place
+  EXPECT_EQ(fuse(net).op_size(), 4);
+}
+
+TEST(Fusion, Reshapes) {
+  NetDef net;
+  addOp(
+      &net,
+      "Reshape",
+      {"X"},
+      {"A", "A_shape"},
+      {MakeArgument<std::vector<int64_t>>("shape", {2, 8})});
+  addOp(
+      &net,
+      "Reshape",
+      {"A"},
+      {"Y", "Y_shape"},
+      {MakeArgument<std::vector<int64_t>>("shape", {4, -1})});
+  net.add_external_input("X");
+  net.add_external_output("Y");
+  const auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 1);
+  EXPECT_EQ(inputsOf(fused.op(0)), std::vector<std::string>{"X"});
+  EXPECT_EQ(outputsOf(fused.op(0)), (std::vector<std::string>{"Y", "Y_shape"}));
+  EXPECT_EQ(
+      ArgumentHelper(fused.op(0)).GetRepeatedArgument<int64_t>("shape"),
+      (std::vector<int64_t>{4, -1}));
+}
+
+TEST(Fusion, Concats) {
+  NetDef net;
+  addOp(
+      &net,
+      "Concat",
+      {"a", "b"},
+      {"ab", "ab_info"},
+      {MakeArgument<int>("axis", 1)});
+  addOp(&net, "Concat", {"c"}, {"c2", "c2_info"});
+  addOp(
+      &net,
+      "Concat",
+      {"c2", "ab", "d"},
+      {"Y", "Y_info"},
+      {MakeArgument<int>("axis", 1)});
+  for (const auto& name : {"a", "b", "c", "d"}) {
+    net.add_external_input(name);
+  }
+  net.add_external_output("Y");
+  const auto fused = fuse(net);
+  ASSERT_EQ(fused.op_size(), 1);
+  EXPECT_EQ(
+      inputsOf(fused.op(0)), (std::vector<std::string>{"c", "a", "b", "d"}));
+  EXPECT_EQ(outputsOf(fused.op(0)), (std::vector<std::string>{"Y", "Y_info"}));
+}
+
+TEST(Fusion, ConcatsAlongOtherAxis) {
+  NetDef net;
+  addOp(
+      &net,
+      "Concat",
+      {"a", "b"},
+      {"ab", "ab_info"},
+      {MakeArgument<int>("axis", 0)});
+  addOp(
+      &net,
+      "Concat",
+      {"ab", "c"},
+      {"Y", "Y_info"},
+      {MakeArgument<int>("axis", 1)});
+  for (const auto& name : {"a", "b", "c"}) {
+    net.add_external_input(name);
+  }
+  net.add_external_output("Y");
+  EXPECT_EQ(fuse(net).op_size(), 2);
+}
@@ -381,6 +381,21 @@ OperatorDef OnnxifiTransformer::BuildOnnxifiOp(
     AddArgument("permit_unknown_output_batch_size", 1, &op);
   }
 
+  // Add batch buckets to compile smaller backend graphs for
+  if (!opts_.use_onnx && !opts_.batch_buckets.empty()) {
+    std::vector<int> batch_buckets;
+    for (const auto b : opts_.batch_buckets) {
+      if (b > 0 && b < opts_.bound_shape_spec.max_batch_size) {
+        batch_buckets.push_back(b);
+      }
+    }
+    if (!batch_buckets.empty()) {
+      AddArgument("batch_buckets", batch_buckets, &op);
+      AddArgument(
+          "max_batch_size", opts_.bound_shape_spec.max_batch_size, &op);
+    }
+  }
+
   return op;
 }
 
@@ -38,6 +38,11 @@ struct OnnxifiTransformerOptions {
 
   // Bound shape spec
   BoundShapeSpec bound_shape_spec;
+
+  // Batch sizes smaller than bound_shape_spec.max_batch_size that the Onnxifi
+  // op may compile extra backend graphs for, so that small batches don't pay
+  // for the maximum one. Only supported when use_onnx is false.
+  std::vector<int> batch_buckets;
 };
 
 class CAFFE2_API OnnxifiTransformer final : public BackendTransformerBase {
@@ -9,6 +9,7 @@ namespace opt {
 
 void workspaceOptimizations(nom::repr::NNModule* nn, Workspace* ws, int level) {
   switch (level) {
+    case 2:
     case 1:
       opt::fuseConvBN(nn, ws);
     case 0:
@@ -19,6 +20,9 @@ void workspaceOptimizations(nom::repr::NNModule* nn, Workspace* ws, int level) {
 
 void graphOptimzations(nom::repr::NNModule* nn, int level) {
   switch (level) {
+    case 2:
+      opt::fuseForServerInference(nn);
+      break;
     case 1:
 #ifdef USE_NNPACK 
       opt::addNNPACK(nn, false);
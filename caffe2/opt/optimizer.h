@@ -8,6 +8,10 @@
 namespace caffe2 {
 namespace opt {
 
+// Levels: 0 does nothing, 1 folds BN into Conv and uses NNPACK where
+// available (mobile), and 2 folds BN into Conv and runs the server inference
+// fusions of caffe2/opt/fusion.h. Passes that need the parameters are only
+// run when ws is given.
 CAFFE2_API NetDef optimize(NetDef net, Workspace* ws, int level = 1);
 CAFFE2_API NetDef optimize(NetDef net, int level = 1);
 
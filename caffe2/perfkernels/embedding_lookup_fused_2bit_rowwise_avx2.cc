@@ -0,0 +1,1404 @@
+//// --------------------------
+//// ATTENTION:
+//// THIS CODE IS AUTOGENERATED
+//// BY hp_emblookup_codegen.py
+//// DO NOT MODIFY!!!
+//// --------------------------
+
+#include "caffe2/perfkernels/cvtsh_ss_bugfix.h"
+
+#include <c10/util/Half.h>
+#include <immintrin.h>
+namespace caffe2 {
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 16;
+  const int64_t packed_block_size = (block_size + 3) / 4;
+  const int64_t fused_block_size = packed_block_size + 4;
+  const __m128i vshuf =
+      _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+  const __m256i vshift =
+      _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const __m256i vmask = _mm256_set1_epi32(3);
+  int dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 16 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      __m256 vop64 = _mm256_setzero_ps();
+      __m256 vop72 = _mm256_setzero_ps();
+      __m256 vop80 = _mm256_setzero_ps();
+      __m256 vop88 = _mm256_setzero_ps();
+      __m256 vop96 = _mm256_setzero_ps();
+      __m256 vop104 = _mm256_setzero_ps();
+      __m256 vop112 = _mm256_setzero_ps();
+      __m256 vop120 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (4))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (6))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (8))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (10))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (12))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (14))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+        vop64 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (16))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop64, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop72 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (18))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop72, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[18])
+        vop80 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (20))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop80, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop88 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (22))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop88, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[22])
+        vop96 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (24))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop96, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop104 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (26))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop104, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[26])
+        vop112 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (28))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop112, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop120 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (30))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop120, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[30])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+        _mm256_storeu_ps(&op[64], vop64);
+        _mm256_storeu_ps(&op[72], vop72);
+        _mm256_storeu_ps(&op[80], vop80);
+        _mm256_storeu_ps(&op[88], vop88);
+        _mm256_storeu_ps(&op[96], vop96);
+        _mm256_storeu_ps(&op[104], vop104);
+        _mm256_storeu_ps(&op[112], vop112);
+        _mm256_storeu_ps(&op[120], vop120);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+        _mm256_storeu_ps(&op[64], _mm256_mul_ps(vop64, vlen_inv));
+        _mm256_storeu_ps(&op[72], _mm256_mul_ps(vop72, vlen_inv));
+        _mm256_storeu_ps(&op[80], _mm256_mul_ps(vop80, vlen_inv));
+        _mm256_storeu_ps(&op[88], _mm256_mul_ps(vop88, vlen_inv));
+        _mm256_storeu_ps(&op[96], _mm256_mul_ps(vop96, vlen_inv));
+        _mm256_storeu_ps(&op[104], _mm256_mul_ps(vop104, vlen_inv));
+        _mm256_storeu_ps(&op[112], _mm256_mul_ps(vop112, vlen_inv));
+        _mm256_storeu_ps(&op[120], _mm256_mul_ps(vop120, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (4))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (6))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (8))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (10))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (12))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (14))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (4))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (6))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 2 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 8 <= block_size; j += 8) {
+        _mm256_storeu_ps(op + j, _mm256_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j],
+              _mm256_fmadd_ps(
+                  vwgt,
+                  _mm256_cvtepi32_ps(_mm256_and_si256(
+                      _mm256_srlv_epi32(
+                          _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                              _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(&ip[j / 4])), vshuf)),
+                          vshift),
+                      vmask)),
+                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));
+          _mm_prefetch(
+              reinterpret_cast<const char*>(&ip_next_T0[j / 4]),
+              _MM_HINT_T0);
+        }
+        for (; j < block_size; j++) {
+          op[j] += wgt * ((ip[j / 4] >> ((j % 4) * 2)) & 3) + bio;
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m256 vlen_inv = _mm256_set1_ps(len_inv);
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_false__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_true__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 16;
+  const int64_t packed_block_size = (block_size + 3) / 4;
+  const int64_t fused_block_size = packed_block_size + 4;
+  const __m128i vshuf =
+      _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+  const __m256i vshift =
+      _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const __m256i vmask = _mm256_set1_epi32(3);
+  int64_t dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 16 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      __m256 vop64 = _mm256_setzero_ps();
+      __m256 vop72 = _mm256_setzero_ps();
+      __m256 vop80 = _mm256_setzero_ps();
+      __m256 vop88 = _mm256_setzero_ps();
+      __m256 vop96 = _mm256_setzero_ps();
+      __m256 vop104 = _mm256_setzero_ps();
+      __m256 vop112 = _mm256_setzero_ps();
+      __m256 vop120 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (4))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (6))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (8))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (10))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (12))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (14))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+        vop64 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (16))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop64, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[16])
+        vop72 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (18))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop72, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[18])
+        vop80 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (20))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop80, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[20])
+        vop88 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (22))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop88, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[22])
+        vop96 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (24))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop96, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[24])
+        vop104 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (26))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop104, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[26])
+        vop112 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (28))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop112, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[28])
+        vop120 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (30))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop120, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[30])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+        _mm256_storeu_ps(&op[64], vop64);
+        _mm256_storeu_ps(&op[72], vop72);
+        _mm256_storeu_ps(&op[80], vop80);
+        _mm256_storeu_ps(&op[88], vop88);
+        _mm256_storeu_ps(&op[96], vop96);
+        _mm256_storeu_ps(&op[104], vop104);
+        _mm256_storeu_ps(&op[112], vop112);
+        _mm256_storeu_ps(&op[120], vop120);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+        _mm256_storeu_ps(&op[64], _mm256_mul_ps(vop64, vlen_inv));
+        _mm256_storeu_ps(&op[72], _mm256_mul_ps(vop72, vlen_inv));
+        _mm256_storeu_ps(&op[80], _mm256_mul_ps(vop80, vlen_inv));
+        _mm256_storeu_ps(&op[88], _mm256_mul_ps(vop88, vlen_inv));
+        _mm256_storeu_ps(&op[96], _mm256_mul_ps(vop96, vlen_inv));
+        _mm256_storeu_ps(&op[104], _mm256_mul_ps(vop104, vlen_inv));
+        _mm256_storeu_ps(&op[112], _mm256_mul_ps(vop112, vlen_inv));
+        _mm256_storeu_ps(&op[120], _mm256_mul_ps(vop120, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      __m256 vop32 = _mm256_setzero_ps();
+      __m256 vop40 = _mm256_setzero_ps();
+      __m256 vop48 = _mm256_setzero_ps();
+      __m256 vop56 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (4))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (6))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+        vop32 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (8))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop32, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[8])
+        vop40 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (10))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop40, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[10])
+        vop48 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (12))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop48, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[12])
+        vop56 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (14))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop56, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[14])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+        _mm256_storeu_ps(&op[32], vop32);
+        _mm256_storeu_ps(&op[40], vop40);
+        _mm256_storeu_ps(&op[48], vop48);
+        _mm256_storeu_ps(&op[56], vop56);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+        _mm256_storeu_ps(&op[32], _mm256_mul_ps(vop32, vlen_inv));
+        _mm256_storeu_ps(&op[40], _mm256_mul_ps(vop40, vlen_inv));
+        _mm256_storeu_ps(&op[48], _mm256_mul_ps(vop48, vlen_inv));
+        _mm256_storeu_ps(&op[56], _mm256_mul_ps(vop56, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      __m256 vop16 = _mm256_setzero_ps();
+      __m256 vop24 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+        vop16 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (4))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop16, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[4])
+        vop24 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (6))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop24, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[6])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+        _mm256_storeu_ps(&op[16], vop16);
+        _mm256_storeu_ps(&op[24], vop24);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+        _mm256_storeu_ps(&op[16], _mm256_mul_ps(vop16, vlen_inv));
+        _mm256_storeu_ps(&op[24], _mm256_mul_ps(vop24, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 2 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m256 vop0 = _mm256_setzero_ps();
+      __m256 vop8 = _mm256_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (0))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop8 = _mm256_fmadd_ps(
+            vwgt,
+            _mm256_cvtepi32_ps(_mm256_and_si256(
+                _mm256_srlv_epi32(
+                    _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                        _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(ip + (2))), vshuf)),
+                    vshift),
+                vmask)),
+            _mm256_add_ps(vop8, vbio));
+        // skip unnecessary prefetch of (&ip_next_T0[2])
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm256_storeu_ps(&op[0], vop0);
+        _mm256_storeu_ps(&op[8], vop8);
+      } else {
+        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm256_storeu_ps(&op[0], _mm256_mul_ps(vop0, vlen_inv));
+        _mm256_storeu_ps(&op[8], _mm256_mul_ps(vop8, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 8 <= block_size; j += 8) {
+        _mm256_storeu_ps(op + j, _mm256_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+            &input[idx * fused_block_size + packed_block_size]);
+        bio = wgt * _cvtsh_ss(scale_bias[1].x);
+        wgt = wgt * _cvtsh_ss(scale_bias[0].x);
+        __m256 vbio = _mm256_set1_ps(bio);
+        __m256 vwgt = _mm256_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j],
+              _mm256_fmadd_ps(
+                  vwgt,
+                  _mm256_cvtepi32_ps(_mm256_and_si256(
+                      _mm256_srlv_epi32(
+                          _mm256_cvtepu8_epi32(_mm_shuffle_epi8(
+                              _mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>(&ip[j / 4])), vshuf)),
+                          vshift),
+                      vmask)),
+                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));
+          _mm_prefetch(
+              reinterpret_cast<const char*>(&ip_next_T0[j / 4]),
+              _MM_HINT_T0);
+        }
+        for (; j < block_size; j++) {
+          op[j] += wgt * ((ip[j / 4] >> ((j % 4) * 2)) & 3) + bio;
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m256 vlen_inv = _mm256_set1_ps(len_inv);
+        j = 0;
+        for (; j + 8 <= block_size; j += 8) {
+          _mm256_storeu_ps(
+              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_true__avx2_fma(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused2BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+} // namespace caffe2
@@ -109,6 +109,9 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         normalize_by_lengths,                                                            \
         out);                                                                            \
   }                                                                                      \
+  decltype(                                                                              \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx512;   \
   decltype(                                                                              \
       Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
       Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx2_fma; \
@@ -128,6 +131,18 @@ static bool Fused8BitRowwiseEmbeddingLookupGenericSlow(
         reinterpret_cast<const uint8_t*>(&one)[0],                                       \
         1,                                                                               \
         "Fused8BitRowwiseEmbeddingLookup is not supported on this platform");            \
+    AVX512_DO(                                                                           \
+        Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                      \
+        output_size,                                                                     \
+        index_size,                                                                      \
+        data_size,                                                                       \
+        input,                                                                           \
+        indices,                                                                         \
+        lengths,                                                                         \
+        weights,                                                                         \
+        normalize_by_lengths,                                                            \
+        out);                                                                            \
     AVX2_FMA_DO(                                                                         \
         Fused8BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
         block_size,                                                                      \
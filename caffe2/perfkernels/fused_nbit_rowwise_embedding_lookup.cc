@@ -0,0 +1,245 @@
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
+
+#include "caffe2/core/types.h"
+#include "caffe2/perfkernels/common.h"
+#include "caffe2/utils/cpuid.h"
+#include "caffe2/utils/math.h"
+
+namespace caffe2 {
+
+/**
+ * Base implementation does runtime dispatch for each segment of reduction
+ * @return false if there is an out-of-bound error
+ */
+template <
+    typename IndexType,
+    typename InType,
+    typename OutType,
+    bool IS_WEIGHT_POSITIONAL = false>
+static bool FusedNBitRowwiseEmbeddingLookupGenericSlow(
+    const int bit_rate,
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const InType* input,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights, // optional, can be null for sum reducer
+    bool normalize_by_lengths,
+    OutType* out) {
+  // block_size is the number of elements and fused_block_size is the size of
+  // an entire row, including the fp16 scale and bias.
+  const int num_elem_per_byte = 8 / bit_rate;
+  const int64_t packed_block_size =
+      (block_size + num_elem_per_byte - 1) / num_elem_per_byte;
+  const int64_t fused_block_size = packed_block_size + 2 * sizeof(at::Half);
+  const int mask = (1 << bit_rate) - 1;
+  int64_t current = 0;
+  for (int m = 0; m < output_size; ++m) {
+    memset(out, 0, sizeof(OutType) * block_size);
+    if (current + lengths[m] > index_size) {
+      return false;
+    }
+    for (int i = 0; i < lengths[m]; ++i) {
+      int64_t idx = indices[current];
+      if (idx < 0 || idx >= data_size) {
+        return false;
+      }
+#ifdef __GNUC__
+      if (current + 1 < index_size) {
+        __builtin_prefetch(
+            input + fused_block_size * indices[current + 1], 0, 1);
+      }
+#endif // __GNUC__
+
+      const InType* row = input + fused_block_size * idx;
+      const at::Half* scale_bias =
+          reinterpret_cast<const at::Half*>(row + packed_block_size);
+
+      float weight = 1.0f;
+      if (weights) {
+        weight = weights[IS_WEIGHT_POSITIONAL ? i : current];
+      }
+      const float scale = weight * scale_bias[0];
+      const float bias = weight * scale_bias[1];
+
+      for (int64_t k = 0; k < block_size; ++k) {
+        const int quantized = (row[k / num_elem_per_byte] >>
+                               ((k % num_elem_per_byte) * bit_rate)) &
+            mask;
+        out[k] += scale * quantized + bias;
+      }
+
+      ++current;
+    }
+    if (normalize_by_lengths && lengths[m]) {
+      // hack: context is not really used
+      math::Scale<float, OutType, CPUContext>(
+          block_size, 1.f / lengths[m], out, out, nullptr);
+    }
+    out += block_size;
+  }
+  return current == index_size;
+}
+
+// Proxy back to generic implementation
+#define FUSED_NBIT_ROWWISE_EMBEDDING_BIT_RATE(BitRate, IndexType, OutType)                         \
+  bool                                                                                             \
+      Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base(     \
+          const int64_t block_size,                                                                \
+          const int64_t output_size,                                                               \
+          const int64_t index_size,                                                                \
+          const int64_t data_size,                                                                 \
+          const uint8_t* input,                                                                    \
+          const IndexType* indices,                                                                \
+          const int* lengths,                                                                      \
+          const float* weights,                                                                    \
+          bool normalize_by_lengths,                                                               \
+          OutType* out) {                                                                          \
+    return FusedNBitRowwiseEmbeddingLookupGenericSlow<                                             \
+        IndexType,                                                                                 \
+        uint8_t,                                                                                   \
+        OutType,                                                                                   \
+        false>(                                                                                    \
+        BitRate,                                                                                   \
+        block_size,                                                                                \
+        output_size,                                                                               \
+        index_size,                                                                                \
+        data_size,                                                                                 \
+        input,                                                                                     \
+        indices,                                                                                   \
+        lengths,                                                                                   \
+        weights,                                                                                   \
+        normalize_by_lengths,                                                                      \
+        out);                                                                                      \
+  }                                                                                                \
+  decltype(                                                                                        \
+      Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx512;   \
+  decltype(                                                                                        \
+      Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__base)     \
+      Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false__avx2_fma; \
+  bool Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(                  \
+      const int64_t block_size,                                                                    \
+      const int64_t output_size,                                                                   \
+      const int64_t index_size,                                                                    \
+      const int64_t data_size,                                                                     \
+      const uint8_t* input,                                                                        \
+      const IndexType* indices,                                                                    \
+      const int* lengths,                                                                          \
+      const float* weights,                                                                        \
+      bool normalize_by_lengths,                                                                   \
+      OutType* out) {                                                                              \
+    AVX512_DO(                                                                                     \
+        Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                                \
+        output_size,                                                                               \
+        index_size,                                                                                \
+        data_size,                                                                                 \
+        input,                                                                                     \
+        indices,                                                                                   \
+        lengths,                                                                                   \
+        weights,                                                                                   \
+        normalize_by_lengths,                                                                      \
+        out);                                                                                      \
+    AVX2_FMA_DO(                                                                                   \
+        Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                                \
+        output_size,                                                                               \
+        index_size,                                                                                \
+        data_size,                                                                                 \
+        input,                                                                                     \
+        indices,                                                                                   \
+        lengths,                                                                                   \
+        weights,                                                                                   \
+        normalize_by_lengths,                                                                      \
+        out);                                                                                      \
+    BASE_DO(                                                                                       \
+        Fused##BitRate##BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##_false,         \
+        block_size,                                                                                \
+        output_size,                                                                               \
+        index_size,                                                                                \
+        data_size,                                                                                 \
+        input,                                                                                     \
+        indices,                                                                                   \
+        lengths,                                                                                   \
+        weights,                                                                                   \
+        normalize_by_lengths,                                                                      \
+        out);                                                                                      \
+  }
+
+#define FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(IndexType, OutType)          \
+  FUSED_NBIT_ROWWISE_EMBEDDING_BIT_RATE(4, IndexType, OutType)                   \
+  FUSED_NBIT_ROWWISE_EMBEDDING_BIT_RATE(2, IndexType, OutType)                   \
+  template <>                                                                    \
+  void FusedNBitRowwiseEmbeddingLookup<IndexType, uint8_t, OutType, false>(      \
+      const int bit_rate,                                                        \
+      const int64_t block_size,                                                  \
+      const int64_t output_size,                                                 \
+      const int64_t index_size,                                                  \
+      const int64_t data_size,                                                   \
+      const uint8_t* input,                                                      \
+      const IndexType* indices,                                                  \
+      const int* lengths,                                                        \
+      const float* weights,                                                      \
+      bool normalize_by_lengths,                                                 \
+      OutType* out) {                                                            \
+    const int32_t one = 1;                                                       \
+    CAFFE_ENFORCE_EQ(                                                            \
+        reinterpret_cast<const uint8_t*>(&one)[0],                               \
+        1,                                                                       \
+        "FusedNBitRowwiseEmbeddingLookup is not supported on this platform");    \
+    CAFFE_ENFORCE(                                                               \
+        bit_rate == 2 || bit_rate == 4,                                          \
+        "FusedNBitRowwiseEmbeddingLookup only supports bit rates 2 and 4, ",     \
+        "but got ",                                                              \
+        bit_rate);                                                               \
+    decltype(Fused4BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType)*   \
+        lookup = bit_rate == 4                                                   \
+        ? Fused4BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType        \
+        : Fused2BitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType;       \
+    bool success = lookup(                                                       \
+        block_size,                                                              \
+        output_size,                                                             \
+        index_size,                                                              \
+        data_size,                                                               \
+        input,                                                                   \
+        indices,                                                                 \
+        lengths,                                                                 \
+        weights,                                                                 \
+        normalize_by_lengths,                                                    \
+        out);                                                                    \
+    if (success) {                                                               \
+      return;                                                                    \
+    }                                                                            \
+    int64_t current = 0;                                                         \
+    for (int m = 0; m < output_size; ++m) {                                      \
+      for (int i = 0; i < lengths[m]; ++i) {                                     \
+        CAFFE_ENFORCE_LT(current, index_size);                                   \
+        IndexType idx = indices[current];                                        \
+        CAFFE_ENFORCE(                                                           \
+            0 <= idx && idx < data_size,                                         \
+            "Index ",                                                            \
+            current,                                                             \
+            " is out of bounds: ",                                               \
+            idx,                                                                 \
+            ", range 0 to ",                                                     \
+            data_size);                                                          \
+        ++current;                                                               \
+      }                                                                          \
+    }                                                                            \
+    CAFFE_ENFORCE_EQ(                                                            \
+        current,                                                                 \
+        index_size,                                                              \
+        "Your input seems to be incorrect: the sum of lengths values should be " \
+        "the size of the indices tensor, but it appears not.");                  \
+  }
+
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int32_t, float);
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int64_t, float);
+
+#undef FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION
+#undef FUSED_NBIT_ROWWISE_EMBEDDING_BIT_RATE
+
+} // namespace caffe2
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+namespace caffe2 {
+
+/**
+ * Embedding lookup with reduction over data quantized to bit_rate bits.
+ *
+ * `input` of size data_size * (ceil(block_size * bit_rate / 8) + 4B)
+ * `indices` of size index_size
+ * `lengths` of size output_size
+ * `weights` nullptr or array of size index_size
+ * `out` of size output_size * block_size
+ * sum(lengths[i]) == index_size
+ *
+ * Each row of the data holds block_size quantized values of bit_rate bits,
+ * packed 8 / bit_rate to a byte starting from the least significant bits,
+ * followed by 2 bytes for a fp16 scale and 2 bytes for a fp16 bias. bit_rate
+ * must be 2 or 4.
+ *
+ * Behavior is roughly equivalent to pseudocode:
+ *
+ * pos = 0
+ * packed_block_size = ceil(block_size * bit_rate / 8)
+ * fused_block_size = packed_block_size + 4B // quantized values, scale, bias
+ * for (i = 0..index_size-1)
+ *   for (k = 0..block_size-1)
+ *     out[i*block_size + k] = 0
+ *   for (j = 0..lengths[i]-1)
+ *     row = &input[indices[pos]*fused_block_size]
+ *     for (k = 0..block_size-1)
+ *       q = (row[k * bit_rate / 8] >> ((k % (8 / bit_rate)) * bit_rate)) &
+ *           ((1 << bit_rate) - 1)
+ *       out[i*block_size + k] += (scale(row) * q + bias(row)) *
+ *           (weights ? weights[IS_WEIGHT_POSITIONAL ? j : pos] : 1.0)
+ *     pos += 1
+ *   if (normalize_weights && lengths[i] > 0)
+ *     for (k = 0..block_size-1)
+ *       out[i*block_size + k] /= lengths[i]
+ *
+ */
+
+template <
+    typename IndexType,
+    typename InType,
+    typename OutType,
+    bool IS_WEIGHT_POSITIONAL = false>
+void FusedNBitRowwiseEmbeddingLookup(
+    const int bit_rate,
+    const std::int64_t block_size,
+    const std::int64_t output_size,
+    const std::int64_t index_size,
+    const std::int64_t data_size,
+    const InType* input,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights, // optional, can be null for non-weighted sum
+    bool normalize_by_lengths,
+    OutType* out);
+} // namespace caffe2
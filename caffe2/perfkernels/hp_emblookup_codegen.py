@@ -6,31 +6,199 @@ import sys
 
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
+# Vector ISAs kernels can be generated for. `width` is the number of floats
+# per register, and `p` the prefix of the intrinsics operating on registers.
+# Loads are split into the intrinsic and its argument for line breaking.
+isas = {
+    "avx2": {
+        "suffix": "__avx2_fma",
+        "width": 8,
+        "vec": "__m256",
+        "ivec": "__m256i",
+        "p": "_mm256",
+        "and": "_mm256_and_si256",
+        "half_load": ("_mm_loadu_si128(", "reinterpret_cast<const __m128i*>({}))"),
+        "uint8_load": ("_mm_loadl_epi64(", "reinterpret_cast<const __m128i*>({}))"),
+    },
+    "avx512": {
+        "suffix": "__avx512",
+        "width": 16,
+        "vec": "__m512",
+        "ivec": "__m512i",
+        "p": "_mm512",
+        "and": "_mm512_and_si512",
+        "half_load": ("_mm256_loadu_si256(", "reinterpret_cast<const __m256i*>({}))"),
+        "uint8_load": ("_mm_loadu_si128(", "reinterpret_cast<const __m128i*>({}))"),
+    },
+}
+
+# Loads of the bytes holding the packed values of one register.
+nbit_load = {
+    2: "_mm_cvtsi32_si128(*reinterpret_cast<const uint16_t*>({}))",
+    4: "_mm_cvtsi32_si128(*reinterpret_cast<const int*>({}))",
+    8: "_mm_loadl_epi64(reinterpret_cast<const __m128i*>({}))",
+}
+
+
+def load(intrinsic, ptr):
+    return intrinsic[0] + intrinsic[1].format(ptr)
+
+
+def nbit_decode(isa, bit_rate, ptr, indent):
+    # Spreads the bytes over the lanes with vshuf, shifts the value of each
+    # lane to the lowest bits with vshift and masks the others off with vmask.
+    p = isa["p"]
+    packed = nbit_load[isa["width"] * bit_rate // 8].format(ptr)
+    lines = [
+        "{p}_cvtepi32_ps({a}(",
+        "    {p}_srlv_epi32(",
+        "        {p}_cvtepu8_epi32(_mm_shuffle_epi8(",
+        "            {packed}, vshuf)),",
+        "        vshift),",
+        "    vmask))",
+    ]
+    return ("\n" + " " * indent).join(lines).format(
+        p=p, a=isa["and"], packed=packed
+    )
+
+
+def nbit_constants(isa, bit_rate):
+    num_elem_per_byte = 8 // bit_rate
+    shuf = [str(i // num_elem_per_byte) for i in range(16)]
+    shift = [str((i % num_elem_per_byte) * bit_rate) for i in range(isa["width"])]
+    code = []
+    code.append(
+        "  const __m128i vshuf =\n      _mm_setr_epi8({});".format(", ".join(shuf))
+    )
+    code.append(
+        "  const {} vshift =\n      {}_setr_epi32({});".format(
+            isa["ivec"], isa["p"], ", ".join(shift)
+        )
+    )
+    code.append(
+        "  const {} vmask = {}_set1_epi32({});".format(
+            isa["ivec"], isa["p"], (1 << bit_rate) - 1
+        )
+    )
+    return code
+
+
+def scale_bias_code(InType, isa, fused, bit_rate):
+    code = []
+    if fused and bit_rate < 8:
+        code.append(
+            "        const at::Half* scale_bias = reinterpret_cast<const at::Half*>(\n"
+            "            &input[idx * fused_block_size + packed_block_size]);"
+        )
+        code.append("        bio = wgt * _cvtsh_ss(scale_bias[1].x);")
+        code.append("        wgt = wgt * _cvtsh_ss(scale_bias[0].x);")
+    elif fused:
+        code.append(
+            "        const float* scale_bias = reinterpret_cast<const float*>(\n"
+            "            &input[idx * fused_block_size + block_size]);"
+        )
+        code.append("        bio = wgt * scale_bias[1];")
+        code.append("        wgt = wgt * scale_bias[0];")
+    else:
+        code.append("        bio = wgt * scale_bias[2 * idx + 1];")
+        code.append("        wgt = wgt * scale_bias[2 * idx];")
+    code.append("        {} vbio = {}_set1_ps(bio);".format(isa["vec"], isa["p"]))
+    return code
+
+
+def weights_code(IndexType, InType, OutType, isa, fused, bit_rate):
+    code = []
+    code.append("        " + OutType + " wgt = 1.f;")
+    if InType == "uint8_t":
+        code.append("        " + OutType + " bio;")
+    code.append("        if (weights) {")
+    code.append(
+        "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
+    )
+    code.append("        }")
+    if InType == "uint8_t":
+        code.extend(scale_bias_code(InType, isa, fused, bit_rate))
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa["vec"], isa["p"]))
+
+    code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
+    code.append(
+        "        const {} next_T0 = (dataInd < index_size - prefdist_T0)\n"
+        "            ? (dataInd + prefdist_T0)\n            : dataInd;".format(
+            IndexType
+        )
+    )
+    code.append("        const " + IndexType + " idx_pref_T0 = indices[next_T0];")
+    code.append(
+        "        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {\n"
+        + "          return false;\n"
+        + "        }"
+    )
+    code.append(
+        "        const {}* ip_next_T0 = "
+        "&input[idx_pref_T0 * fused_block_size];".format(InType)
+    )
+    return code
+
+
+def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, bit_rate):
+    p = isa["p"]
+    width = isa["width"]
 
-def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
         if InType == "float":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
-                % (regid, regid, regid)
+                "        vop%d = %s_fmadd_ps(vwgt, %s_loadu_ps(ip + (%d)), vop%d);"  # noqa
+                % (regid, p, p, regid, regid)
             )
         elif InType == "at::Half":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtph_ps(\n"
-                "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d)))),\n"  # noqa
-                "            vop%d);" % (regid, regid, regid)
+                "            %s_cvtph_ps(\n"
+                "                %s),\n"
+                "            vop%d);"
+                % (
+                    regid,
+                    p,
+                    p,
+                    load(isa["half_load"], "ip + (%d)" % regid),
+                    regid,
+                )
+            )
+        elif InType == "uint8_t" and bit_rate < 8:
+            code.append(
+                "        vop%d = %s_fmadd_ps(\n"
+                "            vwgt,\n"
+                "            %s,\n"
+                "            %s_add_ps(vop%d, vbio));"
+                % (
+                    regid,
+                    p,
+                    nbit_decode(
+                        isa, bit_rate, "ip + (%d)" % byteoffset(regid), 12
+                    ),
+                    p,
+                    regid,
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "        vop%d = _mm256_fmadd_ps(\n"
+                "        vop%d = %s_fmadd_ps(\n"
                 "            vwgt,\n"
-                "            _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(\n"
-                "                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
-                "            _mm256_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                "            %s_cvtepi32_ps(%s_cvtepu8_epi32(\n"
+                "                %s)),\n"
+                "            %s_add_ps(vop%d, vbio));"
+                % (
+                    regid,
+                    p,
+                    p,
+                    p,
+                    load(isa["uint8_load"], "ip + (%d)" % regid),
+                    p,
+                    regid,
+                )
             )
         else:
             assert False
@@ -39,15 +207,21 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
             code.append(
                 "        _mm_prefetch(\n"
                 "            reinterpret_cast<const char*>(&ip_next_T0[%d]), _MM_HINT_T0);"
-                % (regid)
+                % (byteoffset(regid) // sizeof[InType])
             )
         else:
             code.append(
-                "        // skip unnecessary prefetch of (&ip_next_T0[%d])" % (regid)
+                "        // skip unnecessary prefetch of (&ip_next_T0[%d])"
+                % (byteoffset(regid) // sizeof[InType])
             )
 
         return code
 
+    def byteoffset(regid):
+        if InType == "uint8_t":
+            return regid * bit_rate // 8
+        return sizeof[InType] * regid
+
     code = []
     code.append("    // unrolling " + str(uf) + " times")
     code.append(
@@ -57,8 +231,10 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
     )
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = width * i
+        code.append(
+            "      {} vop{} = {}_setzero_ps();".format(isa["vec"], j, p)
+        )
 
     # inner loop
     code.append(
@@ -78,77 +254,34 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
         + "        }"
     )
 
-    if InType == "uint8_t":
-        code.append("        " + OutType + " wgt = 1.f;")
-        code.append("        " + OutType + " bio;")
-        code.append("        if (weights) {")
-        code.append(
-            "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
-        )
-        code.append("        }")
-        if fused:
-            code.append(
-                "        const float* scale_bias = reinterpret_cast<const float*>(\n"
-                "            &input[idx * fused_block_size + block_size]);"
-            )
-            code.append("        bio = wgt * scale_bias[1];")
-            code.append("        wgt = wgt * scale_bias[0];")
-        else:
-            code.append("        bio = wgt * scale_bias[2 * idx + 1];")
-            code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
-    else:
-        code.append("        " + OutType + " wgt = 1.f;")
-        code.append("        if (weights) {")
-        code.append(
-            "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
-        )
-        code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
-
-    code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
-    code.append(
-        "        const {} next_T0 = (dataInd < index_size - prefdist_T0)\n"
-        "            ? (dataInd + prefdist_T0)\n            : dataInd;".format(
-            IndexType
-        )
-    )
-    code.append("        const " + IndexType + " idx_pref_T0 = indices[next_T0];")
-    code.append(
-        "        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {\n"
-        + "          return false;\n"
-        + "        }"
-    )
-
-    code.append(
-        "        const {}* ip_next_T0 = "
-        "&input[idx_pref_T0 * fused_block_size];".format(InType)
-    )
+    code.extend(weights_code(IndexType, InType, OutType, isa, fused, bit_rate))
 
     for i in range(0, uf):
-        j = 8 * i
+        j = width * i
         cachelinesize = 64
-        byteoffset = sizeof[InType] * j
-        prefetch = (byteoffset % cachelinesize) == 0
+        prefetch = (byteoffset(j) % cachelinesize) == 0
         code.extend(compute(j, InType, use_weights, isa, prefetch))
     code.append("      }")
 
     code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = width * i
+        code.append(
+            "        {}_storeu_ps(&op[{}], vop{});".format(p, j, j)
+        )
     code.append("      } else {")
     # inv of length
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+    code.append(
+        "        {} vlen_inv = {}_set1_ps(1.0f / lengths[rangeIndex]);".format(
+            isa["vec"], p
+        )
+    )
     for i in range(0, uf):
-        j = 8 * i
+        j = width * i
         code.append(
-            "        _mm256_storeu_ps(&op["
-            + str(j)
-            + "], _mm256_mul_ps("
-            + "vop"
-            + str(j)
-            + ", vlen_inv));"
+            "        {}_storeu_ps(&op[{}], {}_mul_ps(vop{}, vlen_inv));".format(
+                p, j, p, j
+            )
         )
     code.append("      }")
 
@@ -156,43 +289,91 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused):
     return code
 
 
-def generic(IndexType, InType, OutType, use_weights, isa, fused):
+def generic(IndexType, InType, OutType, use_weights, isa, fused, bit_rate):
+    p = isa["p"]
+    width = isa["width"]
+    num_elem_per_byte = 8 // bit_rate
+
     def compute(InType, use_weights, isa):
         code = []
         if InType == "float":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
-                "                  vwgt, _mm256_loadu_ps(&ip[j]), _mm256_loadu_ps(&op[j])));"  # noqa
+                "              %s_fmadd_ps(\n"
+                "                  vwgt, %s_loadu_ps(&ip[j]), %s_loadu_ps(&op[j])));"  # noqa
+                % (p, p, p, p)
             )
         elif InType == "at::Half":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
+                "              &op[j],\n"
+                "              %s_fmadd_ps(\n"
+                "                  vwgt,\n"
+                "                  %s_cvtph_ps(%s\n"
+                "                      %s),\n"
+                "                  %s_loadu_ps(&op[j])));"
+                % (
+                    p,
+                    p,
+                    p,
+                    isa["half_load"][0],
+                    isa["half_load"][1].format("&ip[j]"),
+                    p,
+                )
+            )
+        elif InType == "uint8_t" and bit_rate < 8:
+            code.append(
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtph_ps(_mm_loadu_si128(\n"
-                "                      reinterpret_cast<const __m128i*>(&ip[j]))),\n"
-                "                  _mm256_loadu_ps(&op[j])));"
+                "                  %s,\n"
+                "                  %s_add_ps(%s_loadu_ps(&op[j]), vbio)));"
+                % (
+                    p,
+                    p,
+                    nbit_decode(
+                        isa, bit_rate, "&ip[j / %d]" % num_elem_per_byte, 18
+                    ),
+                    p,
+                    p,
+                )
             )
         elif InType == "uint8_t":
             code.append(
-                "          _mm256_storeu_ps(\n"
+                "          %s_storeu_ps(\n"
                 "              &op[j],\n"
-                "              _mm256_fmadd_ps(\n"
+                "              %s_fmadd_ps(\n"
                 "                  vwgt,\n"
-                "                  _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(\n"  # noqa
-                "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
-                "                  _mm256_add_ps(_mm256_loadu_ps(&op[j]), vbio)));"
+                "                  %s_cvtepi32_ps(%s_cvtepu8_epi32(%s\n"
+                "                      %s)),\n"
+                "                  %s_add_ps(%s_loadu_ps(&op[j]), vbio)));"
+                % (
+                    p,
+                    p,
+                    p,
+                    p,
+                    isa["uint8_load"][0],
+                    isa["uint8_load"][1].format("&ip[j]"),
+                    p,
+                    p,
+                )
             )
         else:
             assert False
 
-        code.append(
-            "          _mm_prefetch(\n"
-            "              reinterpret_cast<const char*>(&ip_next_T0[j]), _MM_HINT_T0);"
-        )
+        if InType == "uint8_t" and bit_rate < 8:
+            code.append(
+                "          _mm_prefetch(\n"
+                "              reinterpret_cast<const char*>(&ip_next_T0[j / %d]),\n"
+                "              _MM_HINT_T0);" % num_elem_per_byte
+            )
+        else:
+            code.append(
+                "          _mm_prefetch(\n"
+                "              reinterpret_cast<const char*>(&ip_next_T0[j]), _MM_HINT_T0);"
+            )
 
         return code
 
@@ -206,8 +387,8 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append("      for (; j + {} <= block_size; j += {}) {{".format(width, width))
+    code.append("        {}_storeu_ps(op + j, {}_setzero_ps());".format(p, p))
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -231,55 +412,11 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
         + "        }"
     )
 
-    if InType == "uint8_t":
-        code.append("        " + OutType + " wgt = 1.f;")
-        code.append("        " + OutType + " bio;")
-        code.append("        if (weights) {")
-        code.append(
-            "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
-        )
-        code.append("        }")
-        if fused:
-            code.append(
-                "        const float* scale_bias = reinterpret_cast<const float*>(\n"
-                "            &input[idx * fused_block_size + block_size]);"
-            )
-            code.append("        bio = wgt * scale_bias[1];")
-            code.append("        wgt = wgt * scale_bias[0];")
-        else:
-            code.append("        bio = wgt * scale_bias[2 * idx + 1];")
-            code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
-    else:
-        code.append("        " + OutType + " wgt = 1.f;")
-        code.append("        if (weights) {")
-        code.append(
-            "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
-        )
-        code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
-
-    code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
-    code.append(
-        "        const {} next_T0 = (dataInd < index_size - prefdist_T0)\n"
-        "            ? (dataInd + prefdist_T0)\n            : dataInd;".format(
-            IndexType
-        )
-    )
-    code.append("        const " + IndexType + " idx_pref_T0 = indices[next_T0];")
-    code.append(
-        "        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {\n"
-        + "          return false;\n"
-        + "        }"
-    )
-    code.append(
-        "        const {}* ip_next_T0 = "
-        "&input[idx_pref_T0 * fused_block_size];".format(InType)
-    )
+    code.extend(weights_code(IndexType, InType, OutType, isa, fused, bit_rate))
 
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + {} <= block_size; j += {}) {{".format(width, width))
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -292,6 +429,12 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
         code.append("          vtmp1[0] = ip[j];")
         code.append("          __m256 vtmp2 = _mm256_cvtph_ps(*((__m128i*)vtmp1));")
         code.append("          op[j] += wgt * ((float*)(&vtmp2))[0];")
+    elif InType == "uint8_t" and bit_rate < 8:
+        code.append(
+            "          op[j] += wgt * ((ip[j / {e}] >> ((j % {e}) * {b})) & {m}) + bio;".format(
+                e=num_elem_per_byte, b=bit_rate, m=(1 << bit_rate) - 1
+            )
+        )
     elif InType == "uint8_t":
         code.append("          op[j] += wgt * ((float)ip[j]) + bio;")
     else:
@@ -303,12 +446,14 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 
     code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
     code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append("        {} vlen_inv = {}_set1_ps(len_inv);".format(isa["vec"], p))
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append("        for (; j + {} <= block_size; j += {}) {{".format(width, width))
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "          {}_storeu_ps(\n"
+        "              &op[j], {}_mul_ps({}_loadu_ps(&op[j]), vlen_inv));".format(
+            p, p, p
+        )
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -325,22 +470,47 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused):
 parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
+parser.add_argument(
+    "--bit-rate",
+    type=int,
+    choices=[8, 4, 2],
+    default=8,
+    help="bits per value of fused rowwise quantized data",
+)
+parser.add_argument("--isa", choices=sorted(isas.keys()), default="avx2")
+parser.add_argument(
+    "--prefetch",
+    type=int,
+    default=16,
+    help="number of lookups ahead to prefetch rows for",
+)
 opts = parser.parse_args()
+if opts.bit_rate != 8 and not opts.fused:
+    parser.error("--bit-rate is only supported with --fused")
+isa = isas[opts.isa]
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
-    filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+    filename = "embedding_lookup_fused_{}bit_rowwise_{}.cc".format(
+        opts.bit_rate, opts.isa
+    )
 else:
-    filename = "embedding_lookup_avx2.cc"
+    filename = "embedding_lookup_{}.cc".format(opts.isa)
 
-options = [
-    ["int32_t", "int", "float", "float", "float", "float"],
-    ["int64_t", "int64_t", "float", "float", "float", "float"],
-    ["int32_t", "int", "half", "at::Half", "float", "float"],
-    ["int64_t", "int64_t", "half", "at::Half", "float", "float"],
-    ["int32_t", "int", "uint8_t", "uint8_t", "float", "float"],
-    ["int64_t", "int64_t", "uint8_t", "uint8_t", "float", "float"],
-]
+if opts.bit_rate < 8:
+    options = [
+        ["int32_t", "int", "uint8_t", "uint8_t", "float", "float"],
+        ["int64_t", "int64_t", "uint8_t", "uint8_t", "float", "float"],
+    ]
+else:
+    options = [
+        ["int32_t", "int", "float", "float", "float", "float"],
+        ["int64_t", "int64_t", "float", "float", "float", "float"],
+        ["int32_t", "int", "half", "at::Half", "float", "float"],
+        ["int64_t", "int64_t", "half", "at::Half", "float", "float"],
+        ["int32_t", "int", "uint8_t", "uint8_t", "float", "float"],
+        ["int64_t", "int64_t", "uint8_t", "uint8_t", "float", "float"],
+    ]
 
 code = []
 # includes
@@ -351,6 +521,8 @@ code.append("//// BY {}".format(sys.argv[0]))
 code.append("//// DO NOT MODIFY!!!")
 code.append("//// --------------------------\n")
 
+if opts.bit_rate < 8:
+    code.append('#include "caffe2/perfkernels/cvtsh_ss_bugfix.h"\n')
 code.append("#include <c10/util/Half.h>")
 code.append("#include <immintrin.h>")
 
@@ -358,12 +530,15 @@ code.append("namespace caffe2 {\n")
 for o in options:
     [IndexTypeName, IndexType, InTypeName, InType, OutTypeName, OutType] = o
 
-    prefix = "Fused8BitRowwise" if opts.fused else ""
+    if not opts.fused:
+        prefix = ""
+    else:
+        prefix = "Fused{}BitRowwise".format(opts.bit_rate)
     code.append("template <bool IS_WEIGHT_POSITIONAL>")
     fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
         prefix, IndexTypeName, InTypeName, OutTypeName
     )
-    suffix = "__avx2_fma"
+    suffix = isa["suffix"]
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -382,28 +557,50 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
-    # block_size is the number of elements and fused_block_size is the size of
-    # an entire row, including scale and bias.
-    offset = (8 // sizeof[InType]) if opts.fused else 0
-    code.append(
-        "  const {} fused_block_size = block_size + {};".format(IndexType, offset)
-    )
+    code.append("  const {} prefdist_T0 = {};".format(IndexType, opts.prefetch))
+    if opts.bit_rate < 8:
+        # The values of a row are packed into packed_block_size bytes, which
+        # are followed by the fp16 scale and bias of the row. Rows are
+        # addressed in 64 bits, since quantized tables can exceed 2GB.
+        num_elem_per_byte = 8 // opts.bit_rate
+        code.append(
+            "  const int64_t packed_block_size = (block_size + {}) / {};".format(
+                num_elem_per_byte - 1, num_elem_per_byte
+            )
+        )
+        code.append("  const int64_t fused_block_size = packed_block_size + 4;")
+        code += nbit_constants(isa, opts.bit_rate)
+    else:
+        # block_size is the number of elements and fused_block_size is the
+        # size of an entire row, including scale and bias.
+        offset = (8 // sizeof[InType]) if opts.fused else 0
+        code.append(
+            "  const {} fused_block_size = block_size + {};".format(
+                IndexType, offset
+            )
+        )
     code.append("  " + IndexType + " dataInd = 0;")
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused)
+    block_sizes = [128, 64, 32, 16]
+    for b, block_size in enumerate(block_sizes):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if b else "", block_size)
+        )
+        code += unroll(
+            block_size // isa["width"],
+            IndexType,
+            InType,
+            OutType,
+            True,
+            isa,
+            opts.fused,
+            opts.bit_rate,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused, opts.bit_rate)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
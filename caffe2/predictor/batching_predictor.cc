@@ -0,0 +1,249 @@
+#include "caffe2/predictor/batching_predictor.h"
+
+#include <algorithm>
+#include <exception>
+#include <unordered_set>
+
+#include "caffe2/core/context.h"
+
+namespace caffe2 {
+
+namespace {
+
+bool compatible(
+    const BatchingPredictor::TensorList& a,
+    const BatchingPredictor::TensorList& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].dtype() != b[i].dtype() || a[i].dim() != b[i].dim() ||
+        !std::equal(
+            a[i].sizes().begin() + 1,
+            a[i].sizes().end(),
+            b[i].sizes().begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+BatchingPredictor::BatchingPredictor(
+    PredictorConfig config,
+    size_t max_batch_size,
+    std::chrono::microseconds max_batch_delay,
+    size_t num_workers)
+    : config_(std::move(config)),
+      max_batch_size_(max_batch_size),
+      max_batch_delay_(max_batch_delay) {
+  CAFFE_ENFORCE_GT(max_batch_size_, 0, "max_batch_size must be positive");
+  CAFFE_ENFORCE_GT(num_workers, 0, "num_workers must be positive");
+
+  // The inputs are the external inputs named in the config, or the ones that
+  // the parent workspace does not provide. The leading external inputs must be
+  // inputs, to be fed by position.
+  const auto& net = *config_.predict_net;
+  std::unordered_set<std::string> inputs{config_.input_names.begin(),
+                                         config_.input_names.end()};
+  if (inputs.empty()) {
+    for (const auto& name : net.external_input()) {
+      if (!config_.ws->HasBlob(name)) {
+        inputs.insert(name);
+      }
+    }
+  }
+  while (num_inputs_ < static_cast<size_t>(net.external_input_size()) &&
+         inputs.count(net.external_input(num_inputs_))) {
+    ++num_inputs_;
+  }
+
+  for (size_t i = 0; i < num_workers; ++i) {
+    auto ws = caffe2::make_unique<Workspace>(config_.ws.get());
+    // Create the blobs that each worker writes before the net, so that its
+    // operators don't resolve them to the blobs of the shared workspace.
+    for (const auto& name : inputs) {
+      BlobGetMutableTensor(ws->CreateLocalBlob(name), CPU);
+    }
+    for (const auto& op : net.op()) {
+      for (const auto& output : op.output()) {
+        ws->CreateLocalBlob(output);
+      }
+    }
+    CAFFE_ENFORCE(ws->CreateNet(config_.predict_net));
+    workspaces_.push_back(std::move(ws));
+  }
+  for (auto& ws : workspaces_) {
+    workers_.emplace_back(&BatchingPredictor::worker, this, ws.get());
+  }
+}
+
+BatchingPredictor::~BatchingPredictor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool BatchingPredictor::operator()(
+    const TensorList& inputs,
+    TensorList* outputs) {
+  CAFFE_ENFORCE(!inputs.empty(), "BatchingPredictor requires inputs");
+  CAFFE_ENFORCE_LE(
+      inputs.size(),
+      num_inputs_,
+      "Only the first ",
+      num_inputs_,
+      " external inputs of the net are inputs rather than parameters");
+  for (const auto& input : inputs) {
+    CAFFE_ENFORCE_GT(input.dim(), 0, "Inputs must have a batch dimension");
+    CAFFE_ENFORCE_EQ(
+        input.size(0),
+        inputs.front().size(0),
+        "All inputs must have the same size in their first dimension");
+  }
+
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  request.rows = inputs.front().size(0);
+  request.arrival = std::chrono::steady_clock::now();
+  auto done = request.done.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(&request);
+    queued_rows_ += request.rows;
+  }
+  cv_.notify_all();
+  return done.get();
+}
+
+void BatchingPredictor::worker(Workspace* ws) {
+  while (true) {
+    std::vector<Request*> batch;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      // Wait for the batch to fill up, or for the oldest request to have
+      // waited long enough.
+      while (!stop_ && !queue_.empty() && queued_rows_ < max_batch_size_) {
+        const auto deadline = queue_.front()->arrival + max_batch_delay_;
+        if (cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+          break;
+        }
+      }
+      if (queue_.empty()) {
+        continue;
+      }
+      batch = takeBatch();
+    }
+    // Let another worker pick up what is left.
+    cv_.notify_all();
+    runBatch(ws, batch);
+  }
+}
+
+std::vector<BatchingPredictor::Request*> BatchingPredictor::takeBatch() {
+  std::vector<Request*> batch;
+  std::deque<Request*> rest;
+  const auto& first = *queue_.front()->inputs;
+  int64_t rows = 0;
+  for (auto* request : queue_) {
+    if (batch.empty() ||
+        (rows + request->rows <= static_cast<int64_t>(max_batch_size_) &&
+         compatible(first, *request->inputs))) {
+      batch.push_back(request);
+      rows += request->rows;
+    } else {
+      rest.push_back(request);
+    }
+  }
+  queue_.swap(rest);
+  queued_rows_ -= rows;
+  return batch;
+}
+
+void BatchingPredictor::runBatch(
+    Workspace* ws,
+    const std::vector<Request*>& batch) {
+  const auto& net = *config_.predict_net;
+  try {
+    CPUContext context;
+    int64_t rows = 0;
+    for (const auto* request : batch) {
+      rows += request->rows;
+    }
+
+    const auto& first = *batch.front()->inputs;
+    for (size_t i = 0; i < first.size(); ++i) {
+      auto* blob = ws->GetBlob(net.external_input(i));
+      if (batch.size() == 1) {
+        // This is evil and shares the same underlying tensor
+        BlobSetTensor(blob, first[i].UnsafeSharedInstance());
+        continue;
+      }
+      auto dims = first[i].sizes().vec();
+      dims[0] = rows;
+      Tensor input(dims, CPU);
+      auto* data =
+          static_cast<char*>(input.raw_mutable_data(first[i].dtype()));
+      for (const auto* request : batch) {
+        const auto& part = (*request->inputs)[i];
+        context.CopyItemsSameDevice(
+            part.dtype(), part.numel(), part.raw_data(), data);
+        data += part.nbytes();
+      }
+      BlobSetTensor(blob, std::move(input));
+    }
+
+    if (!ws->RunNet(net.name())) {
+      for (auto* request : batch) {
+        request->done.set_value(false);
+      }
+      return;
+    }
+
+    for (auto* request : batch) {
+      request->outputs->clear();
+    }
+    for (const auto& name : net.external_output()) {
+      const auto& output = BlobGetTensor(*ws->GetBlob(name), CPU);
+      CAFFE_ENFORCE(
+          output.dim() > 0 && output.size(0) == rows,
+          "Output ",
+          name,
+          " must have one row per input row to be split into requests");
+      const auto* data = static_cast<const char*>(output.raw_data());
+      for (auto* request : batch) {
+        auto dims = output.sizes().vec();
+        dims[0] = request->rows;
+        Tensor part(dims, CPU);
+        context.CopyItemsSameDevice(
+            output.dtype(),
+            part.numel(),
+            data,
+            part.raw_mutable_data(output.dtype()));
+        data += part.nbytes();
+        request->outputs->push_back(std::move(part));
+      }
+    }
+  } catch (...) {
+    for (auto* request : batch) {
+      request->done.set_exception(std::current_exception());
+    }
+    return;
+  }
+  for (auto* request : batch) {
+    request->done.set_value(true);
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/net.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/predictor/predictor_config.h"
+
+namespace caffe2 {
+
+/**
+ * A predictor that batches concurrent requests together.
+ *
+ * Each call to operator() enqueues its inputs and blocks until the outputs
+ * are ready. A pool of worker threads, each with its own workspace, gathers
+ * the queued requests into batches of at most `max_batch_size` rows, waiting
+ * at most `max_batch_delay` after the oldest request arrived for the batch to
+ * fill up. The inputs of a batch are concatenated along their first
+ * dimension, the net is run once, and its outputs are split back along their
+ * first dimension into the outputs of each request.
+ *
+ * The workspaces of the workers are children of `config.ws`, so they share
+ * its parameters, while the inputs and all blobs written by the net are local
+ * to each worker.
+ *
+ * Only requests with the same number of inputs, each with the same type and
+ * the same sizes past the first dimension, are batched together. The net must
+ * treat the rows of its inputs independently, and each of its outputs must
+ * have one row per input row.
+ */
+class CAFFE2_API BatchingPredictor {
+ public:
+  using TensorList = std::vector<TensorCPU>;
+
+  BatchingPredictor(
+      PredictorConfig config,
+      size_t max_batch_size,
+      std::chrono::microseconds max_batch_delay,
+      size_t num_workers = 1);
+
+  // Runs the requests that are still queued, then stops the workers.
+  ~BatchingPredictor();
+
+  BatchingPredictor(const BatchingPredictor&) = delete;
+  BatchingPredictor& operator=(const BatchingPredictor&) = delete;
+
+  // Executes `run_net` on the inputs, batched with concurrent requests.
+  // The first `inputs.size()` inputs from run_net::external_inputs are
+  // set to the (concatenated) data in `inputs`, which must all have the same
+  // size in their first dimension.
+
+  // Unlike Predictor, the outputs are owned by the caller and stay valid after
+  // further executions.
+
+  // Returns true on success. Errors raised while running the batch are
+  // rethrown in every request of the batch.
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+
+  const NetDef& def() const {
+    return *config_.predict_net;
+  }
+
+  size_t max_batch_size() const {
+    return max_batch_size_;
+  }
+
+ private:
+  struct Request {
+    const TensorList* inputs;
+    TensorList* outputs;
+    int64_t rows;
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<bool> done;
+  };
+
+  void worker(Workspace* ws);
+
+  // Moves the oldest request, and the compatible requests that still fit, out
+  // of the queue.
+  std::vector<Request*> takeBatch();
+
+  void runBatch(Workspace* ws, const std::vector<Request*>& batch);
+
+  PredictorConfig config_;
+  const size_t max_batch_size_;
+  const std::chrono::microseconds max_batch_delay_;
+  // The number of leading external inputs of the net that are inputs rather
+  // than parameters.
+  size_t num_inputs_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request*> queue_;
+  size_t queued_rows_ = 0;
+  bool stop_ = false;
+
+  std::vector<std::unique_ptr<Workspace>> workspaces_;
+  std::vector<std::thread> workers_;
+};
+
+} // namespace caffe2
@@ -0,0 +1,194 @@
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/predictor/batching_predictor.h"
+#include "caffe2/predictor/predictor.h"
+#include "caffe2/utils/math.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+const char* predictSpec = R"DOC(
+        name: "predict"
+        type: "dag"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          input: "W"
+          input: "b"
+          output: "y"
+          type: "FC"
+        }
+)DOC";
+
+const char* initSpec = R"DOC(
+        name: "init"
+        type: "dag"
+        op {
+          type: "GivenTensorFill"
+          output: "W"
+          arg {
+            name: "shape"
+            ints: 3
+            ints: 4
+          }
+          arg {
+            name: "values"
+            floats: [1, 2, 3, 4, -1, -2, -3, -4, 0.5, 0.25, 0, -0.5]
+          }
+        }
+        op {
+          type: "ConstantFill"
+          output: "b"
+          arg {
+            name: "shape"
+            ints: 3
+          }
+          arg {
+            name: "value"
+            f: 1.0
+          }
+        }
+)DOC";
+
+NetDef parseNetDef(const std::string& value) {
+  NetDef def;
+  CAFFE_ENFORCE(
+      TextFormat::ParseFromString(value, &def),
+      "Failed to parse NetDef with value: ",
+      value);
+  return def;
+}
+
+PredictorConfig makeConfig() {
+  return makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec));
+}
+
+TensorCPU randomInput(int64_t rows, CPUContext* ctx) {
+  TensorCPU t(std::vector<int64_t>{rows, 4}, CPU);
+  math::RandUniform<float, CPUContext>(
+      t.numel(), -1.0, 1.0, t.template mutable_data<float>(), ctx);
+  return t;
+}
+
+// y = data * W^T + b
+void expectOutput(const TensorCPU& input, const TensorCPU& output) {
+  const float W[3][4] = {{1, 2, 3, 4}, {-1, -2, -3, -4}, {0.5, 0.25, 0, -0.5}};
+  ASSERT_EQ(output.dim(), 2);
+  ASSERT_EQ(output.size(0), input.size(0));
+  ASSERT_EQ(output.size(1), 3);
+  for (int64_t r = 0; r < input.size(0); ++r) {
+    for (int j = 0; j < 3; ++j) {
+      float expected = 1;
+      for (int k = 0; k < 4; ++k) {
+        expected += input.data<float>()[r * 4 + k] * W[j][k];
+      }
+      EXPECT_NEAR(output.data<float>()[r * 3 + j], expected, 1e-4);
+    }
+  }
+}
+
+} // namespace
+
+class BatchingPredictorTest : public testing::Test {
+ public:
+  void SetUp() override {
+    DeviceOption op;
+    op.set_random_seed(1701);
+    ctx_ = caffe2::make_unique<CPUContext>(op);
+  }
+
+  std::unique_ptr<CPUContext> ctx_;
+};
+
+TEST_F(BatchingPredictorTest, SingleRequest) {
+  BatchingPredictor predictor(
+      makeConfig(), /*max_batch_size=*/8, std::chrono::microseconds(0));
+  BatchingPredictor::TensorList inputs;
+  inputs.push_back(randomInput(2, ctx_.get()));
+  BatchingPredictor::TensorList outputs;
+  EXPECT_TRUE(predictor(inputs, &outputs));
+  ASSERT_EQ(outputs.size(), 1);
+  expectOutput(inputs.front(), outputs.front());
+}
+
+TEST_F(BatchingPredictorTest, ConcurrentRequests) {
+  const size_t kThreads = 8;
+  const size_t kRequestsPerThread = 20;
+  BatchingPredictor predictor(
+      makeConfig(),
+      /*max_batch_size=*/6,
+      std::chrono::microseconds(2000),
+      /*num_workers=*/2);
+
+  std::vector<std::vector<BatchingPredictor::TensorList>> inputs(kThreads);
+  for (size_t t = 0; t < kThreads; ++t) {
+    for (size_t i = 0; i < kRequestsPerThread; ++i) {
+      BatchingPredictor::TensorList request;
+      request.push_back(randomInput(1 + (t + i) % 3, ctx_.get()));
+      inputs[t].push_back(std::move(request));
+    }
+  }
+  std::vector<std::vector<BatchingPredictor::TensorList>> outputs(kThreads);
+  for (auto& thread_outputs : outputs) {
+    thread_outputs.resize(kRequestsPerThread);
+  }
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (size_t i = 0; i < kRequestsPerThread; ++i) {
+        EXPECT_TRUE(predictor(inputs[t][i], &outputs[t][i]));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t t = 0; t < kThreads; ++t) {
+    for (size_t i = 0; i < kRequestsPerThread; ++i) {
+      ASSERT_EQ(outputs[t][i].size(), 1);
+      expectOutput(inputs[t][i].front(), outputs[t][i].front());
+    }
+  }
+}
+
+TEST_F(BatchingPredictorTest, OutputsOutliveLaterRequests) {
+  BatchingPredictor predictor(
+      makeConfig(), /*max_batch_size=*/8, std::chrono::microseconds(0));
+  BatchingPredictor::TensorList first_inputs, second_inputs;
+  first_inputs.push_back(randomInput(3, ctx_.get()));
+  second_inputs.push_back(randomInput(3, ctx_.get()));
+  BatchingPredictor::TensorList first_outputs, second_outputs;
+  EXPECT_TRUE(predictor(first_inputs, &first_outputs));
+  EXPECT_TRUE(predictor(second_inputs, &second_outputs));
+  expectOutput(first_inputs.front(), first_outputs.front());
+  expectOutput(second_inputs.front(), second_outputs.front());
+}
+
+TEST_F(BatchingPredictorTest, RejectsInvalidInputs) {
+  BatchingPredictor predictor(
+      makeConfig(), /*max_batch_size=*/8, std::chrono::microseconds(0));
+  BatchingPredictor::TensorList outputs;
+
+  BatchingPredictor::TensorList scalar;
+  scalar.emplace_back(std::vector<int64_t>{}, CPU);
+  scalar.back().mutable_data<float>();
+  EXPECT_THROW(predictor(scalar, &outputs), EnforceNotMet);
+
+  // Only "data" is an input, "W" and "b" come from the shared workspace.
+  BatchingPredictor::TensorList too_many;
+  too_many.push_back(randomInput(1, ctx_.get()));
+  too_many.push_back(randomInput(1, ctx_.get()));
+  EXPECT_THROW(predictor(too_many, &outputs), EnforceNotMet);
+}
+
+} // namespace caffe2
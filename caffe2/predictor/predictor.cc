@@ -20,8 +20,9 @@ Blob* getBlob(Workspace* ws, const std::string& name) {
   return blob;
 }
 
-const Tensor& getTensor(Workspace* ws, const std::string& name) {
-  return *BlobGetMutableTensor(getBlob(ws, name), CPU);
+const Tensor& getTensor(Blob* blob) {
+  CAFFE_ENFORCE(BlobIsTensorType(*blob, CPU), "Output blob is not a CPU Tensor");
+  return *BlobGetMutableTensor(blob, CPU);
 }
 
 } // namespace
@@ -40,6 +41,28 @@ Predictor::Predictor(
           optimization)) {}
 
 Predictor::Predictor(PredictorConfig config) : config_(std::move(config)) {
+  if (config_.shared_ws) {
+    // Everything the net writes, and its inputs, are local to this predictor,
+    // and hide any blob of the same name in the shared workspace.
+    const std::unordered_set<std::string> parameters{
+        config_.parameter_names.begin(), config_.parameter_names.end()};
+    for (const auto& op : config_.predict_net->op()) {
+      for (const auto& output : op.output()) {
+        CAFFE_ENFORCE(
+            !parameters.count(output),
+            "Net ",
+            config_.predict_net->name(),
+            " writes the shared parameter ",
+            output);
+        config_.ws->CreateLocalBlob(output);
+      }
+    }
+    for (const auto& name : config_.predict_net->external_input()) {
+      if (!parameters.count(name)) {
+        BlobGetMutableTensor(config_.ws->CreateLocalBlob(name), CPU);
+      }
+    }
+  }
   const auto& initialized_vec = config_.ws->Blobs();
   const std::unordered_set<std::string> initialized{initialized_vec.begin(),
                                                     initialized_vec.end()};
@@ -50,6 +73,29 @@ Predictor::Predictor(PredictorConfig config) : config_(std::move(config)) {
     }
   }
   CAFFE_ENFORCE(config_.ws->CreateNet(config_.predict_net));
+  resolveBlobs();
+}
+
+void Predictor::resolveBlobs() {
+  auto* ws = config_.ws.get();
+  for (const auto& name : config_.predict_net->external_input()) {
+    auto* blob = ws->GetBlob(name);
+    if (config_.shared_ws && config_.shared_ws->HasBlob(name) &&
+        blob == config_.shared_ws->GetBlob(name)) {
+      blob = nullptr;
+    }
+    input_blobs_.push_back(blob);
+    input_blobs_by_name_.emplace(name, blob);
+  }
+  // The outputs may be created by the net only when it runs; they are looked
+  // up on the first run then.
+  for (const auto& name : config_.predict_net->external_output()) {
+    output_blobs_.push_back(ws->HasBlob(name) ? getBlob(ws, name) : nullptr);
+  }
+  for (const auto& name : output_names()) {
+    named_output_blobs_.push_back(
+        ws->HasBlob(name) ? getBlob(ws, name) : nullptr);
+  }
 }
 
 bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
@@ -57,10 +103,13 @@ bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
       inputs.size() <=
       static_cast<unsigned>(config_.predict_net->external_input_size()));
   for (size_t i = 0; i < inputs.size(); ++i) {
+    auto* blob = input_blobs_[i];
+    if (!blob) {
+      // Throws for the shared parameter
+      blob = getInputBlob(config_.predict_net->external_input(i));
+    }
     // This is evil and shares the same underlying tensor
-    BlobSetTensor(
-        getBlob(config_.ws.get(), config_.predict_net->external_input(i)),
-        inputs[i].UnsafeSharedInstance());
+    BlobSetTensor(blob, inputs[i].UnsafeSharedInstance());
   }
 
   if (!config_.ws->RunNet(config_.predict_net->name())) {
@@ -68,13 +117,29 @@ bool Predictor::operator()(const TensorList& inputs, TensorList* outputs) {
   }
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
-    outputs->emplace_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
-            .UnsafeSharedInstance());
+    outputs->emplace_back(getTensor(getOutputBlob(i)).UnsafeSharedInstance());
   }
   return true;
 }
 
+Blob* Predictor::getOutputBlob(size_t i) {
+  if (!output_blobs_[i]) {
+    output_blobs_[i] =
+        getBlob(config_.ws.get(), config_.predict_net->external_output(i));
+  }
+  return output_blobs_[i];
+}
+
+Blob* Predictor::getInputBlob(const std::string& name) {
+  auto* blob = getBlob(config_.ws.get(), name);
+  CAFFE_ENFORCE(
+      !config_.shared_ws || blob != config_.shared_ws->GetBlob(name),
+      "Input ",
+      name,
+      " would overwrite the shared parameter of the same name");
+  return blob;
+}
+
 bool Predictor::run_map_workspace(const TensorMap& inputs) {
   if (!config_.input_names.empty()) {
     CAFFE_ENFORCE_EQ(inputs.size(), input_names().size());
@@ -87,10 +152,12 @@ bool Predictor::run_map_workspace(const TensorMap& inputs) {
           "Input can't be found: ",
           input.first);
     }
+    const auto it = input_blobs_by_name_.find(input.first);
+    auto* blob = it != input_blobs_by_name_.end() && it->second
+        ? it->second
+        : getInputBlob(input.first);
     // This is evil and shares the same underlying tensor
-    BlobSetTensor(
-        getBlob(config_.ws.get(), input.first),
-        input.second.UnsafeSharedInstance());
+    BlobSetTensor(blob, input.second.UnsafeSharedInstance());
   }
 
   return config_.ws->RunNet(config_.predict_net->name());
@@ -102,9 +169,7 @@ bool Predictor::operator()(const TensorMap& inputs, TensorList* outputs) {
   }
   outputs->clear();
   for (size_t i = 0; i < config_.predict_net->external_output_size(); ++i) {
-    outputs->push_back(
-        getTensor(config_.ws.get(), config_.predict_net->external_output(i))
-            .UnsafeSharedInstance());
+    outputs->push_back(getTensor(getOutputBlob(i)).UnsafeSharedInstance());
   }
   return true;
 }
@@ -114,10 +179,13 @@ bool Predictor::operator()(const TensorMap& inputs, TensorMap* outputs) {
     return false;
   }
 
-  for (const std::string& outputName : output_names()) {
+  for (size_t i = 0; i < output_names().size(); ++i) {
+    if (!named_output_blobs_[i]) {
+      named_output_blobs_[i] = getBlob(config_.ws.get(), output_names()[i]);
+    }
     outputs->emplace(
-        outputName,
-        getTensor(config_.ws.get(), outputName).UnsafeSharedInstance());
+        output_names()[i],
+        getTensor(named_output_blobs_[i]).UnsafeSharedInstance());
   }
   return true;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include <unordered_set>
 #include "caffe2/core/net.h"
 #include "caffe2/core/tensor.h"
@@ -65,7 +66,27 @@ class CAFFE2_API Predictor {
  private:
   bool run_map_workspace(const TensorMap& inputs);
 
+  // Returns the blob to feed the input `name` into, which must not be a shared
+  // parameter.
+  Blob* getInputBlob(const std::string& name);
+
+  // Looks up the blobs of the inputs and outputs once, so that the runs feed
+  // and fetch them without going through the workspace.
+  void resolveBlobs();
+
+  // Returns the blob of run_net::external_outputs(i).
+  Blob* getOutputBlob(size_t i);
+
  protected:
   PredictorConfig config_;
+
+ private:
+  // The blobs of run_net::external_inputs, nullptr for the shared parameters,
+  // which can't be fed.
+  std::vector<Blob*> input_blobs_;
+  std::unordered_map<std::string, Blob*> input_blobs_by_name_;
+  // The blobs of run_net::external_outputs and of output_names().
+  std::vector<Blob*> output_blobs_;
+  std::vector<Blob*> named_output_blobs_;
 };
 } // namespace caffe2
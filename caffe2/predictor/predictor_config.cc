@@ -1,6 +1,7 @@
 #include "predictor_config.h"
 
 #include <atomic>
+#include <unordered_set>
 
 #include "caffe2/core/init.h"
 #include "caffe2/utils/proto_utils.h"
@@ -94,4 +95,35 @@ PredictorConfig makePredictorConfig(
   return config;
 }
 
+PredictorConfig makeSharedPredictorConfig(const PredictorConfig& config) {
+  CAFFE_ENFORCE(config.ws, "The config to share has no workspace");
+  PredictorConfig shared;
+  shared.parameters = config.parameters;
+  shared.predict_net = config.predict_net;
+  shared.input_names = config.input_names;
+  shared.output_names = config.output_names;
+  shared.parameter_names = config.parameter_names;
+  // Configs made from a shared config share the same parameters workspace.
+  shared.shared_ws = config.shared_ws ? config.shared_ws : config.ws;
+  if (shared.parameter_names.empty()) {
+    std::unordered_set<std::string> excluded{config.input_names.begin(),
+                                             config.input_names.end()};
+    for (const auto& op : config.predict_net->op()) {
+      excluded.insert(op.output().begin(), op.output().end());
+    }
+    for (const auto& name : shared.shared_ws->Blobs()) {
+      const auto* blob = shared.shared_ws->GetBlob(name);
+      // Skip the placeholders a Predictor creates for its inputs.
+      if (excluded.count(name) ||
+          (BlobIsTensorType(*blob, CPU) &&
+           !blob->Get<Tensor>().storage_initialized())) {
+        continue;
+      }
+      shared.parameter_names.push_back(name);
+    }
+  }
+  shared.ws = std::make_shared<Workspace>(shared.shared_ws.get());
+  return shared;
+}
+
 } // namespace caffe2
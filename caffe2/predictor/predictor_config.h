@@ -34,6 +34,11 @@ struct CAFFE2_API PredictorConfig {
   // passed in by a user might contain extra tensors used by other models
   std::vector<std::string> parameter_names;
 
+  // Read-only workspace holding the parameters, which `ws` is a child of.
+  // Set by makeSharedPredictorConfig(), so that the predictors of many configs
+  // share one copy of the parameters. Each config keeps it alive.
+  std::shared_ptr<Workspace> shared_ws;
+
   // TODO We still save ws is because of the current design of workspace and
   // tensor. Once tensor support intrusive_ptr, we'll get rid of this and use
   // parameters to construct Workspace
@@ -47,6 +52,12 @@ CAFFE2_API PredictorConfig makePredictorConfig(
     Workspace* parent = nullptr,
     bool run_init = true);
 
+/**
+ * `optimization` is the level of opt::optimize run on run_net once the init
+ * net has run. Servers should use 2, which adds the inference fusions of
+ * caffe2/opt/fusion.h (FC + Relu, in-place activations, and removal of
+ * redundant Copy, Reshape and Concat ops).
+ */
 CAFFE2_API PredictorConfig makePredictorConfig(
     const NetDef& init_net,
     const NetDef& run_net,
@@ -54,4 +65,18 @@ CAFFE2_API PredictorConfig makePredictorConfig(
     bool run_init = true,
     int optimization = 1);
 
+/**
+ * Makes a config for another Predictor of the net of `config`, with its own
+ * workspace on top of the parameters in the workspace of `config`, which are
+ * shared rather than copied. This is how to run one Predictor per thread
+ * with a single copy of the weights.
+ *
+ * The parameters are `config.parameter_names`, or if empty, the blobs of
+ * `config.ws` that hold data and are neither inputs nor written by the net.
+ * They must not be modified once shared: a Predictor on the returned config
+ * refuses nets that write any of them, and inputs that would overwrite them.
+ */
+CAFFE2_API PredictorConfig makeSharedPredictorConfig(
+    const PredictorConfig& config);
+
 } // namespace caffe2
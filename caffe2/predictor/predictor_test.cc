@@ -2,10 +2,15 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
 #include "caffe2/predictor/predictor.h"
+#include "caffe2/predictor/predictor_utils.h"
 #include "caffe2/utils/math.h"
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
+#include <fstream>
+#include <set>
+
 namespace caffe2 {
 
 namespace {
@@ -205,4 +210,79 @@ TEST_F(PredictorTest, SimpleBatchSizedMapInput) {
   EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
 }
 
+TEST_F(PredictorTest, SharedParameters) {
+  auto base =
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec));
+  Predictor p1(makeSharedPredictorConfig(base));
+  Predictor p2(makeSharedPredictorConfig(base));
+  const auto local = p1.ws()->LocalBlobs();
+  EXPECT_EQ(
+      std::set<std::string>(local.begin(), local.end()),
+      (std::set<std::string>{"data", "y"}));
+  EXPECT_EQ(p1.ws()->GetBlob("W"), base.ws->GetBlob("W"));
+  EXPECT_EQ(p2.ws()->GetBlob("W"), base.ws->GetBlob("W"));
+  EXPECT_NE(p1.ws()->GetBlob("y"), p2.ws()->GetBlob("y"));
+
+  auto inputData = randomTensor({1, 4}, ctx_.get());
+  Predictor::TensorList input;
+  input.emplace_back(BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList output1, output2;
+  p1(input, &output1);
+  p2(input, &output2);
+  EXPECT_NEAR(output1.front().data<float>()[4], 0.1209, 1E-4);
+  EXPECT_NEAR(output2.front().data<float>()[4], 0.1209, 1E-4);
+}
+
+TEST_F(PredictorTest, SharedParametersAreReadOnly) {
+  auto base =
+      makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec));
+  auto writing = makeSharedPredictorConfig(base);
+  writing.predict_net = std::make_shared<NetDef>(*base.predict_net);
+  auto* op = writing.predict_net->add_op();
+  op->set_type("Scale");
+  op->add_input("W");
+  op->add_output("W");
+  EXPECT_THROW(Predictor{writing}, EnforceNotMet);
+
+  Predictor p(makeSharedPredictorConfig(base));
+  auto inputData = randomTensor({10, 4}, ctx_.get());
+  Predictor::TensorMap input;
+  input.emplace("W", BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList output;
+  EXPECT_THROW(p(input, &output), EnforceNotMet);
+}
+
+TEST_F(PredictorTest, MMapParameters) {
+  const std::vector<float> W(40, 2.0f);
+  const std::vector<float> b(10, 2.0f);
+  const std::string path = std::tmpnam(nullptr);
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(W.data()), W.size() * 4);
+    file.write(reinterpret_cast<const char*>(b.data()), b.size() * 4);
+  }
+
+  auto base = makePredictorConfig(
+      NetDef(), parseNetDef(predictSpec), nullptr, /*run_init=*/false);
+  predictor_utils::mmapParameters(
+      path,
+      {{"W", TypeMeta::Make<float>(), {10, 4}, 0},
+       {"b", TypeMeta::Make<float>(), {10}, W.size() * 4}},
+      base.ws.get());
+  std::remove(path.c_str());
+
+  Predictor p(makeSharedPredictorConfig(base));
+  auto inputData = randomTensor({1, 4}, ctx_.get());
+  Predictor::TensorList input;
+  input.emplace_back(BlobGetMutableTensor(inputData.get(), CPU)->Alias());
+  Predictor::TensorList output;
+  p(input, &output);
+  EXPECT_NEAR(output.front().data<float>()[4], 0.1209, 1E-4);
+
+  EXPECT_THROW(
+      predictor_utils::mmapParameters(
+          path, {{"W", TypeMeta::Make<float>(), {10, 4}, 0}}, base.ws.get()),
+      EnforceNotMet);
+}
+
 } // namespace caffe2
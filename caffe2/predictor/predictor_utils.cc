@@ -6,9 +6,37 @@
 #include "caffe2/proto/predictor_consts.pb.h"
 #include "caffe2/utils/proto_utils.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace caffe2 {
 namespace predictor_utils {
 
+namespace {
+
+struct MappedFile {
+  MappedFile(void* data, size_t size) : data(data), size(size) {}
+  ~MappedFile() {
+#ifndef _WIN32
+    munmap(data, size);
+#endif
+  }
+  void* data;
+  size_t size;
+};
+
+// Deleter of the DataPtrs created by mmapParameters(), whose context holds a
+// reference to the mapping.
+void deleteMappedFile(void* ctx) {
+  delete static_cast<std::shared_ptr<MappedFile>*>(ctx);
+}
+
+} // namespace
+
 CAFFE2_API const NetDef& getNet(
     const MetaNetDef& def,
     const std::string& name) {
@@ -78,5 +106,62 @@ std::unique_ptr<MetaNetDef> runGlobalInitialization(
   return metaNetDef;
 }
 
+void mmapParameters(
+    const std::string& path,
+    const std::vector<MMapParameter>& parameters,
+    Workspace* ws) {
+#ifdef _WIN32
+  CAFFE_THROW("mmapParameters is not supported on Windows");
+#else
+  CAFFE_ENFORCE(ws);
+  const int fd = open(path.c_str(), O_RDONLY);
+  CAFFE_ENFORCE_GE(fd, 0, "Failed to open ", path);
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    CAFFE_THROW("Failed to stat ", path);
+  }
+  const size_t size = file_stat.st_size;
+  void* data = size == 0
+      ? MAP_FAILED
+      : mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the file is closed.
+  close(fd);
+  CAFFE_ENFORCE(data != MAP_FAILED, "Failed to map ", path);
+  const auto mapping = std::make_shared<MappedFile>(data, size);
+
+  for (const auto& parameter : parameters) {
+    CAFFE_ENFORCE(
+        parameter.dtype.id() != TypeIdentifier::uninitialized() &&
+            !parameter.dtype.placementNew(),
+        "Parameter ",
+        parameter.name,
+        " must have a fundamental type to be mapped");
+    size_t nbytes = parameter.dtype.itemsize();
+    for (const auto dim : parameter.dims) {
+      CAFFE_ENFORCE_GE(dim, 0, "Invalid dims of parameter ", parameter.name);
+      nbytes *= dim;
+    }
+    CAFFE_ENFORCE(
+        parameter.offset % parameter.dtype.itemsize() == 0 &&
+            parameter.offset <= size && nbytes <= size - parameter.offset,
+        "The data of parameter ",
+        parameter.name,
+        " is misaligned or lies outside of ",
+        path);
+    auto* tensor = BlobGetMutableTensor(ws->CreateBlob(parameter.name), CPU);
+    tensor->Resize(parameter.dims);
+    tensor->ShareExternalPointer(
+        at::DataPtr(
+            static_cast<char*>(data) + parameter.offset,
+            new std::shared_ptr<MappedFile>(mapping),
+            &deleteMappedFile,
+            at::Device(CPU)),
+        parameter.dtype,
+        nbytes);
+  }
+#endif
+}
+
 } // namespace predictor_utils
 } // namespace caffe2
@@ -23,5 +23,24 @@ CAFFE2_API std::unique_ptr<MetaNetDef> runGlobalInitialization(
     std::unique_ptr<db::DBReader> db,
     Workspace* master);
 
+// A tensor of fundamental type stored contiguously at `offset` bytes into a
+// file, for mmapParameters().
+struct CAFFE2_API MMapParameter {
+  std::string name;
+  TypeMeta dtype;
+  std::vector<int64_t> dims;
+  size_t offset;
+};
+
+// Maps the file at `path` read-only, and creates a blob in `ws` for each of
+// `parameters` with a tensor whose data lives in the mapping. The data is
+// paged in lazily and shared through the page cache by every process that
+// maps the file, and any attempt to write to it faults. This is meant for the
+// shared workspace of makeSharedPredictorConfig().
+CAFFE2_API void mmapParameters(
+    const std::string& path,
+    const std::vector<MMapParameter>& parameters,
+    Workspace* ws);
+
 } // namespace predictor_utils
 } // namespace caffe2
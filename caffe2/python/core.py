@@ -2710,6 +2710,23 @@ class ExecutionStep(object):
         assert not self.HasNets(), 'Cannot have both network and substeps.'
         self._step.concurrent_substeps = concurrent_substeps
 
+    def SetPipelinedSubsteps(self, pipelined_substeps, queue_capacity=None):
+        """
+        Run the substeps as the stages of a pipeline, connected by queues of
+        queue_capacity entries that carry the pipeline_output_blobs of each
+        stage to the next one.
+        """
+        self._assert_can_mutate()
+        assert not self.HasNets(), 'Cannot have both network and substeps.'
+        self._step.pipelined_substeps = pipelined_substeps
+        if queue_capacity is not None:
+            self._step.pipeline_queue_capacity = queue_capacity
+
+    def SetPipelineOutputBlobs(self, blobs):
+        """ The blobs this stage of a pipelined step passes to the next. """
+        self._assert_can_mutate()
+        self._step.pipeline_output_blobs.extend([str(b) for b in blobs])
+
     def AddNet(self, net):
         self._assert_can_mutate()
         assert not self.HasSubsteps(), 'Cannot have both network and substeps.'
@@ -2897,7 +2914,10 @@ def execution_step(default_name,
                    only_once=None,
                    num_concurrent_instances=None,
                    create_workspace=False,
-                   run_every_ms=None):
+                   run_every_ms=None,
+                   pipelined_substeps=None,
+                   pipeline_queue_capacity=None,
+                   pipeline_output_blobs=None):
     """
     Helper for creating an ExecutionStep.
     - steps_or_nets can be:
@@ -2911,6 +2931,10 @@ def execution_step(default_name,
       - If specified and true, then this step will return immediately.
       - Be sure to handle race conditions if setting from concurrent threads.
     - if no should_stop_blob or num_iter is provided, defaults to num_iter=1
+    - pipelined_substeps runs the substeps as the stages of a pipeline, each
+      stage passing its pipeline_output_blobs to the next one through a queue
+      of pipeline_queue_capacity entries. The stages run in
+      num_concurrent_instances threads each.
     """
     assert should_stop_blob is None or num_iter is None, (
         'Cannot set both should_stop_blob and num_iter.')
@@ -2935,6 +2959,8 @@ def execution_step(default_name,
         step.SetCreateWorkspace(True)
     if run_every_ms:
         step.RunEveryMillis(run_every_ms)
+    if pipeline_output_blobs is not None:
+        step.SetPipelineOutputBlobs(pipeline_output_blobs)
 
     if isinstance(steps_or_nets, ExecutionStep):
         step.AddSubstep(steps_or_nets)
@@ -2950,6 +2976,8 @@ def execution_step(default_name,
     elif steps_or_nets:
         raise ValueError(
             'steps_or_nets must be a step, a net, or a list of nets or steps.')
+    if pipelined_substeps is not None:
+        step.SetPipelinedSubsteps(pipelined_substeps, pipeline_queue_capacity)
     return step
 
 
@@ -1351,6 +1351,43 @@ class TestOperators(hu.HypothesisTestCase):
             v += self.ws.blobs[str(counter)].fetch().tolist()
         self.assertEqual(v, truth)
 
+    @given(num_producers=st.integers(1, 3),
+           num_workers=st.integers(1, 3),
+           num_iter=st.integers(1, 10),
+           capacity=st.integers(1, 3))
+    def test_pipelined_substeps(self, num_producers, num_workers, num_iter,
+                                capacity):
+        init_net = core.Net('init_net')
+        counter = init_net.ConstantFill([], 'counter', shape=[1], value=0.0)
+
+        read_net = core.Net('read')
+        read_net.ConstantFill([], 'x', shape=[1], value=1.0, run_once=False)
+        process_net = core.Net('process')
+        process_net.Scale('x', 'y', scale=2.0)
+        # A single copy of the last stage updates the counter.
+        sum_net = core.Net('sum')
+        sum_net.Add([counter, 'y'], counter)
+
+        pipeline = core.execution_step('pipeline', [
+            core.execution_step(
+                'read', read_net, num_iter=num_iter,
+                num_concurrent_instances=num_producers,
+                pipeline_output_blobs=['x']),
+            core.execution_step(
+                'process', process_net,
+                num_concurrent_instances=num_workers,
+                pipeline_output_blobs=['y']),
+            core.execution_step('sum', sum_net),
+        ], pipelined_substeps=True, pipeline_queue_capacity=capacity)
+
+        plan = core.Plan('test')
+        plan.AddStep(core.execution_step('init', init_net))
+        plan.AddStep(pipeline)
+        self.ws.run(plan)
+        self.assertEqual(
+            self.ws.blobs['counter'].fetch().tolist(),
+            [2.0 * num_producers * num_iter])
+
     @given(num_queues=st.integers(1, 5),
            num_iter=st.integers(5, 10),
            capacity=st.integers(1, 5),
@@ -24,9 +24,13 @@ def onnxifi_caffe2_net(
         debug=False,
         use_onnx=True,
         adjust_batch=True,
-        black_list=None):
+        black_list=None,
+        batch_buckets=None):
     """
     Transform the caffe2_net by collapsing ONNXIFI-runnable nodes into Onnxifi c2 ops
+
+    batch_buckets lists batch sizes smaller than max_batch_size for which the
+    Onnxifi ops compile extra backend graphs on demand (c2 path only).
     """
     shape_hints = {}
     for k, v in input_shapes.items():
@@ -38,7 +42,8 @@ def onnxifi_caffe2_net(
                              max_seq_size,
                              adjust_batch,
                              debug,
-                             use_onnx)
+                             use_onnx,
+                             batch_buckets if batch_buckets else [])
     pred_net_cut = caffe2_pb2.NetDef()
     pred_net_cut.ParseFromString(pred_net_str)
     return pred_net_cut
@@ -165,23 +165,74 @@ class TestReBatchingQueue(TestCase):
                 workspace.FetchBlob(tensors[idx])[:5]
             )
 
+    def test_rebatching_queue_writing_outputs_keeps_queued_elements(self):
+        net = core.Net('net')
+        workspace.FeedBlob(
+            "tensors", np.array([x for x in range(10)], np.int32)
+        )
+
+        queue = net.CreateRebatchingQueue([], 1, capacity=10, num_blobs=1)
+
+        net.EnqueueRebatchingQueue([queue, "tensors"], [], enqueue_batch=True)
+        first = net.DequeueRebatchingQueue([queue], 1, num_elements=5)
+        # Overwrite the first batch in place with more elements than it has
+        net.ConstantFill([], first, shape=[8], value=-1, dtype=core.DataType.INT32)
+        second = net.DequeueRebatchingQueue([queue], 1, num_elements=5)
+
+        workspace.RunNetOnce(net)
+
+        npt.assert_array_equal(workspace.FetchBlob(first), [-1] * 8)
+        npt.assert_array_equal(
+            workspace.FetchBlob(second), workspace.FetchBlob("tensors")[5:]
+        )
+
+    def test_rebatching_queue_capacity_bytes(self):
+        net = core.Net('net')
+        workspace.FeedBlob(
+            "tensors", np.array([[x] * 4 for x in range(3)], np.int32)
+        )
+
+        # Each element takes 16 bytes, more than the capacity, but an element
+        # always fits once the queue is empty.
+        queue = net.CreateRebatchingQueue(
+            [], 1, capacity=10, num_blobs=1, capacity_bytes=8
+        )
+
+        results = []
+        for _ in range(3):
+            net.EnqueueRebatchingQueue(
+                [queue, "tensors"], [], enqueue_batch=False
+            )
+            results.append(
+                net.DequeueRebatchingQueue([queue], 1, num_elements=1)
+            )
+
+        workspace.RunNetOnce(net)
+
+        for result in results:
+            npt.assert_array_equal(
+                workspace.FetchBlob(result), [workspace.FetchBlob("tensors")]
+            )
+
     @given(
         num_producers=st.integers(1, 5),
         num_consumers=st.integers(1, 5),
         producer_input_size=st.integers(1, 10),
         producer_num_iterations=st.integers(1, 10),
-        capacity=st.integers(1, 10)
+        capacity=st.integers(1, 10),
+        capacity_bytes=st.sampled_from([0, 4, 20]),
     )
     def test_rebatching_parallel_producer_consumer(
         self, num_producers, num_consumers, producer_input_size,
-        producer_num_iterations, capacity
+        producer_num_iterations, capacity, capacity_bytes
     ):
         ### Init ###
         total_inputs = producer_num_iterations * producer_input_size * num_producers
         inputs = []
         init_net = core.Net('init_net')
         queue = init_net.CreateRebatchingQueue(
-            [], 1, capacity=capacity, num_blobs=1
+            [], 1, capacity=capacity, num_blobs=1,
+            capacity_bytes=capacity_bytes
         )
 
         ### Producers ###
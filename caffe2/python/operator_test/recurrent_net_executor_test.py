@@ -4,7 +4,8 @@ from __future__ import print_function
 from __future__ import unicode_literals
 
 from caffe2.proto import caffe2_pb2
-from caffe2.python import model_helper, workspace, core, rnn_cell, test_util
+from caffe2.python import (
+    model_helper, workspace, core, rnn_cell, test_util, utils)
 from caffe2.python.attention import AttentionType
 
 import numpy as np
@@ -218,6 +219,27 @@ class TestRNNExecutor(test_util.TestCase):
             model, _ = self.init_lstm_model(T, num_layers, forward_only)
             self._compare(model, forward_only)
 
+    @given(
+        num_layers=st.integers(1, 4),
+        T=st.integers(4, 50),
+        forward_only=st.booleans())
+    def test_lstm_single_thread_equal_simplenet(self, num_layers, T,
+                                                forward_only):
+        '''
+        Test that the single-threaded executor, which runs the step nets
+        inline instead of through the task queue, matches simple nets.
+        '''
+        self.Tseq = [T, T // 2, T // 2 + T // 4, T, T // 2 + 1]
+
+        workspace.ResetWorkspace()
+        with core.DeviceScope(caffe2_pb2.DeviceOption()):
+            model, _ = self.init_lstm_model(T, num_layers, forward_only)
+            for op in model.net.Proto().op:
+                if op.type.startswith("RecurrentNetwork"):
+                    op.arg.extend(
+                        [utils.MakeArgument("rnn_executor.num_threads", 1)])
+            self._compare(model, forward_only)
+
     def _compare(self, model, forward_only):
         # Store list of blobs that exist in the beginning
         workspace.RunNetOnce(model.param_init_net)
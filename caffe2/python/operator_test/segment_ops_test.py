@@ -636,6 +636,48 @@ class TestSegmentOps(hu.HypothesisTestCase):
         with self.assertRaises(RuntimeError):
             workspace.RunOperatorOnce(op)
 
+    @given(
+        num_tables=st.integers(1, 4),
+        lookups_per_task=st.sampled_from([1, 7, 4096]),
+        **hu.gcs_cpu_only
+    )
+    def test_sparse_lengths_sum_multi(
+            self, num_tables, lookups_per_task, gc, dc):
+        inputs = []
+        for t in range(num_tables):
+            D = np.random.rand(20 + t, 3 + t).astype(np.float32)
+            L = np.random.randint(0, 5, size=4 + t).astype(np.int32)
+            I = np.random.randint(0, D.shape[0], size=L.sum()).astype(
+                np.int64 if t % 2 else np.int32)
+            inputs.extend([D, I, L])
+        names = ["in_{}".format(i) for i in range(len(inputs))]
+        op = core.CreateOperator(
+            "SparseLengthsSumMulti",
+            names,
+            ["out_{}".format(t) for t in range(num_tables)],
+            lookups_per_task=lookups_per_task)
+
+        def ref(*inputs):
+            outputs = []
+            for t in range(num_tables):
+                D, I, L = inputs[3 * t:3 * t + 3]
+                starts = np.cumsum(L) - L
+                outputs.append(np.stack([
+                    D[I[s:s + l]].sum(axis=0) for s, l in zip(starts, L)
+                ]).astype(np.float32))
+            return outputs
+
+        self.assertReferenceChecks(gc, op, inputs, ref)
+        for t in range(num_tables):
+            self.assertGradientChecks(gc, op, inputs, 3 * t, [t])
+
+        inputs[1] = inputs[1] + inputs[0].shape[0]
+        for name, value in zip(names, inputs):
+            workspace.FeedBlob(name, value)
+        if inputs[1].size > 0:
+            with self.assertRaises(RuntimeError):
+                workspace.RunOperatorOnce(op)
+
     @serial.given(**hu.gcs_cpu_only)
     def test_sparse_lengths_positional_weighted_sum(
             self, gc, dc):
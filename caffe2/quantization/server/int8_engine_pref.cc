@@ -0,0 +1,58 @@
+#include "int8_engine_pref.h"
+
+#include "caffe2/core/init.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/utils/cpuid.h"
+
+C10_DEFINE_bool(
+    caffe2_dnnlowp_prefer_for_int8_ops,
+    false,
+    "If true, Int8Conv, Int8ConvRelu and Int8FC ops that don't specify an "
+    "engine run their DNNLOWP (fbgemm) implementation instead of the default "
+    "QNNPACK one on CPUs that support AVX2");
+
+namespace caffe2 {
+
+namespace {
+
+// QNNPACK is tuned for mobile CPUs, and on x86 servers fbgemm is much faster
+// for the compute bound int8 ops. Both take the same quantized weights, so a
+// net can run on either without changes and each backend packs its weights
+// once, the first time the op runs.
+const char* const kInt8OpsPreferringDNNLowP[] = {
+    "Int8Conv",
+    "Int8ConvRelu",
+    "Int8FC",
+};
+
+bool Caffe2PreferDNNLowPForInt8Ops(int*, char***) {
+  if (FLAGS_caffe2_dnnlowp_prefer_for_int8_ops) {
+    PreferDNNLowPForInt8Ops();
+  }
+  return true;
+}
+
+} // namespace
+
+bool PreferDNNLowPForInt8Ops() {
+  if (!GetCpuId().avx2()) {
+    return false;
+  }
+  for (const char* op_type : kInt8OpsPreferringDNNLowP) {
+    if (!CPUOperatorRegistry()->Has(op_type) ||
+        !CPUOperatorRegistry()->Has(OpRegistryKey(op_type, "DNNLOWP"))) {
+      continue;
+    }
+    VLOG(1) << "Preferring the DNNLOWP engine for " << op_type;
+    SetOpEnginePref(op_type, {{CPU, {"DNNLOWP"}}});
+  }
+  return true;
+}
+
+REGISTER_CAFFE2_INIT_FUNCTION(
+    Caffe2PreferDNNLowPForInt8Ops,
+    &Caffe2PreferDNNLowPForInt8Ops,
+    "Prefer the DNNLOWP engine for int8 ops on CPUs that support AVX2 if "
+    "--caffe2_dnnlowp_prefer_for_int8_ops is set.");
+
+} // namespace caffe2
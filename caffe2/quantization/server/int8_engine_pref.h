@@ -0,0 +1,15 @@
+#pragma once
+
+#include "caffe2/core/common.h"
+
+namespace caffe2 {
+
+/**
+ * Makes the Int8Conv, Int8ConvRelu and Int8FC ops that don't specify an engine
+ * run their DNNLOWP (fbgemm) implementation instead of the default QNNPACK
+ * one. Returns false, changing nothing, on CPUs that don't support AVX2.
+ * Called at init if --caffe2_dnnlowp_prefer_for_int8_ops is set.
+ */
+CAFFE2_API bool PreferDNNLowPForInt8Ops();
+
+} // namespace caffe2
@@ -0,0 +1,109 @@
+#include "int8_engine_pref.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "caffe2/core/operator.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/operators/quantized/int8_test_utils.h"
+#include "caffe2/utils/proto_utils.h"
+
+namespace caffe2 {
+
+namespace {
+
+// Restores the default engine of the int8 ops when a test is done, so that
+// the other tests of the binary keep running QNNPACK.
+struct Int8EnginePrefGuard {
+  ~Int8EnginePrefGuard() {
+    for (const char* op_type : {"Int8Conv", "Int8ConvRelu", "Int8FC"}) {
+      SetOpEnginePref(op_type, {{CPU, {}}});
+    }
+  }
+};
+
+// Runs `def` with the engine set to `engine` ("" for none) in `ws` and checks
+// that it ran on `expected_engine`. Returns the uint8 output.
+std::vector<uint8_t> runInt8Op(
+    Workspace* ws,
+    OperatorDef def,
+    const std::string& engine,
+    const std::string& expected_engine) {
+  def.set_engine(engine);
+  auto op = CreateOperator(def, ws);
+  EXPECT_EQ(op->engine(), expected_engine);
+  EXPECT_TRUE(op->Run());
+  const auto& YQ = ws->GetBlob("YQ")->Get<int8::Int8TensorCPU>();
+  return std::vector<uint8_t>(
+      YQ.t.data<uint8_t>(), YQ.t.data<uint8_t>() + YQ.t.numel());
+}
+
+// The engine-less op runs DNNLOWP within one quantization step of QNNPACK,
+// which still runs when it is asked for explicitly.
+void checkPreferredEngine(const OperatorDef& def, Workspace* ws) {
+  const auto qnnpack = runInt8Op(ws, def, "DEFAULT", "DEFAULT");
+  const auto dnnlowp = runInt8Op(ws, def, "", "DNNLOWP");
+  ASSERT_EQ(dnnlowp.size(), qnnpack.size());
+  for (size_t i = 0; i < dnnlowp.size(); ++i) {
+    EXPECT_LE(std::abs(int(dnnlowp[i]) - int(qnnpack[i])), 1) << "at " << i;
+  }
+  runInt8Op(ws, def, "DNNLOWP", "DNNLOWP");
+}
+
+} // namespace
+
+TEST(Int8EnginePref, Conv) {
+  Int8EnginePrefGuard guard;
+  if (!PreferDNNLowPForInt8Ops()) {
+    // no AVX2
+    return;
+  }
+  Workspace ws;
+  int8Copy(ws.CreateBlob("XQ")->GetMutable<int8::Int8TensorCPU>(),
+           *q({2, 9, 9, 8}));
+  int8Copy(ws.CreateBlob("WQ")->GetMutable<int8::Int8TensorCPU>(),
+           *q({16, 3, 3, 8}));
+  int8Copy(ws.CreateBlob("BQ")->GetMutable<int8::Int8TensorCPU>(),
+           *biasq({16}, 0.01 * 0.01));
+  for (const char* op_type : {"Int8Conv", "Int8ConvRelu"}) {
+    checkPreferredEngine(
+        CreateOperatorDef(
+            op_type,
+            "",
+            {"XQ", "WQ", "BQ"},
+            {"YQ"},
+            {MakeArgument<int>("kernel", 3),
+             MakeArgument<string>("order", "NHWC"),
+             MakeArgument<int>("Y_zero_point", 127),
+             MakeArgument<float>("Y_scale", 0.1)}),
+        &ws);
+  }
+}
+
+TEST(Int8EnginePref, FC) {
+  Int8EnginePrefGuard guard;
+  if (!PreferDNNLowPForInt8Ops()) {
+    // no AVX2
+    return;
+  }
+  Workspace ws;
+  int8Copy(ws.CreateBlob("XQ")->GetMutable<int8::Int8TensorCPU>(),
+           *q({4, 64}));
+  int8Copy(ws.CreateBlob("WQ")->GetMutable<int8::Int8TensorCPU>(),
+           *q({16, 64}));
+  int8Copy(ws.CreateBlob("BQ")->GetMutable<int8::Int8TensorCPU>(),
+           *biasq({16}, 0.01 * 0.01));
+  checkPreferredEngine(
+      CreateOperatorDef(
+          "Int8FC",
+          "",
+          {"XQ", "WQ", "BQ"},
+          {"YQ"},
+          {MakeArgument<int>("Y_zero_point", 127),
+           MakeArgument<float>("Y_scale", 0.1)}),
+      &ws);
+}
+
+} // namespace caffe2
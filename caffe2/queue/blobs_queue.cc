@@ -29,15 +29,17 @@ BlobsQueue::BlobsQueue(
     size_t numBlobs,
     bool enforceUniqueName,
     const std::vector<std::string>& fieldNames)
-    : numBlobs_(numBlobs), name_(queueName), stats_(queueName) {
+    : numBlobs_(numBlobs),
+      queue_(capacity),
+      name_(queueName),
+      stats_(queueName) {
   if (!fieldNames.empty()) {
     CAFFE_ENFORCE_EQ(
         fieldNames.size(), numBlobs, "Wrong number of fieldNames provided.");
     stats_.queue_dequeued_bytes.setDetails(fieldNames);
   }
-  queue_.reserve(capacity);
   for (size_t i = 0; i < capacity; ++i) {
-    std::vector<Blob*> blobs;
+    auto& blobs = queue_.slot(i);
     blobs.reserve(numBlobs);
     for (size_t j = 0; j < numBlobs; ++j) {
       const auto blobName = queueName + "_" + to_string(i) + "_" + to_string(j);
@@ -49,57 +51,85 @@ BlobsQueue::BlobsQueue(
       }
       blobs.push_back(ws->CreateBlob(blobName));
     }
-    queue_.push_back(blobs);
   }
-  DCHECK_EQ(queue_.size(), capacity);
+  DCHECK_EQ(queue_.capacity(), capacity);
 }
 
-bool BlobsQueue::blockingRead(
-    const std::vector<Blob*>& inputs,
+template <typename F>
+size_t BlobsQueue::readRecords(
+    size_t numRecords,
+    F recordInputs,
     float timeout_secs) {
   Timer readTimer;
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_read_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  auto canRead = [this]() {
-    CAFFE_ENFORCE_LE(reader_, writer_);
-    return reader_ != writer_;
-  };
+  for (size_t record = 0; record < numRecords; ++record) {
+    CAFFE_ENFORCE(recordInputs(record).size() >= numBlobs_);
+  }
   // Decrease queue balance before reading to indicate queue read pressure
   // is being increased (-ve queue balance indicates more reads than writes)
   CAFFE_EVENT(stats_, queue_balance, -1);
+  size_t record = 0;
+  auto reader = [this, &record, &recordInputs](std::vector<Blob*>& result) {
+    const auto& inputs = recordInputs(record++);
+    for (auto i = 0; i < result.size(); ++i) {
+      auto bytes = BlobStat::sizeBytes(*result[i]);
+      CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
+      using std::swap;
+      swap(*(inputs[i]), *(result[i]));
+    }
+  };
+  size_t read = 0;
   if (timeout_secs > 0) {
-    std::chrono::milliseconds timeout_ms(int(timeout_secs * 1000));
-    cv_.wait_for(
-        g, timeout_ms, [this, canRead]() { return closing_ || canRead(); });
+    read = queue_.blockingRead(
+        numRecords,
+        reader,
+        std::chrono::milliseconds(int(timeout_secs * 1000)));
   } else {
-    cv_.wait(g, [this, canRead]() { return closing_ || canRead(); });
+    read = queue_.blockingRead(numRecords, reader);
   }
-  if (!canRead()) {
-    if (timeout_secs > 0 && !closing_) {
+  if (read == 0) {
+    if (timeout_secs > 0 && !queue_.isClosed()) {
       LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
       CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
     } else {
       CAFFE_SDT(queue_read_end, name, (void*)this, SDT_CANCEL);
     }
-    return false;
+    return 0;
   }
-  DCHECK(canRead());
-  auto& result = queue_[reader_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
-  for (auto i = 0; i < result.size(); ++i) {
-    auto bytes = BlobStat::sizeBytes(*result[i]);
-    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
-    using std::swap;
-    swap(*(inputs[i]), *(result[i]));
+  if (read > 1) {
+    CAFFE_EVENT(stats_, queue_balance, 1 - static_cast<int64_t>(read));
   }
-  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - reader_);
-  CAFFE_EVENT(stats_, queue_dequeued_records);
-  ++reader_;
-  cv_.notify_all();
+  CAFFE_SDT(queue_read_end, name, (void*)this, queue_.size());
+  CAFFE_EVENT(stats_, queue_dequeued_records, read);
   CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
-  return true;
+  return read;
+}
+
+bool BlobsQueue::blockingRead(
+    const std::vector<Blob*>& inputs,
+    float timeout_secs) {
+  return readRecords(
+             1,
+             [&inputs](size_t /* unused */) -> const std::vector<Blob*>& {
+               return inputs;
+             },
+             timeout_secs) == 1;
+}
+
+size_t BlobsQueue::blockingReadMany(
+    const std::vector<std::vector<Blob*>>& inputs,
+    float timeout_secs) {
+  if (inputs.empty()) {
+    return 0;
+  }
+  return readRecords(
+      inputs.size(),
+      [&inputs](size_t record) -> const std::vector<Blob*>& {
+        return inputs[record];
+      },
+      timeout_secs);
 }
 
 bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
@@ -107,16 +137,21 @@ bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_NONBLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  if (!canWrite()) {
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
+  if (!queue_.tryWrite([this, &inputs](std::vector<Blob*>& result) {
+        doWrite(inputs, result);
+      })) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
-  // Increase queue balance before writing to indicate queue write pressure is
+  // Increase queue balance after writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  DCHECK(canWrite());
-  doWrite(inputs);
+  CAFFE_SDT(
+      queue_write_end,
+      name,
+      (void*)this,
+      queue_.capacity() - queue_.size());
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -126,48 +161,36 @@ bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
+  CAFFE_ENFORCE(inputs.size() >= numBlobs_);
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  cv_.wait(g, [this]() { return closing_ || canWrite(); });
-  if (!canWrite()) {
+  if (!queue_.blockingWrite([this, &inputs](std::vector<Blob*>& result) {
+        doWrite(inputs, result);
+      })) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
-  DCHECK(canWrite());
-  doWrite(inputs);
+  CAFFE_SDT(
+      queue_write_end,
+      name,
+      (void*)this,
+      queue_.capacity() - queue_.size());
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
 
 void BlobsQueue::close() {
-  closing_ = true;
-
-  std::lock_guard<std::mutex> g(mutex_);
-  cv_.notify_all();
-}
-
-bool BlobsQueue::canWrite() {
-  // writer is always within [reader, reader + size)
-  // we can write if reader is within [reader, reader + size)
-  CAFFE_ENFORCE_LE(reader_, writer_);
-  CAFFE_ENFORCE_LE(writer_, reader_ + queue_.size());
-  return writer_ != reader_ + queue_.size();
+  queue_.close();
 }
 
-void BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
-  auto& result = queue_[writer_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
-  const auto& name = name_.c_str();
+void BlobsQueue::doWrite(
+    const std::vector<Blob*>& inputs,
+    std::vector<Blob*>& result) {
   for (auto i = 0; i < result.size(); ++i) {
     using std::swap;
     swap(*(inputs[i]), *(result[i]));
   }
-  CAFFE_SDT(
-      queue_write_end, name, (void*)this, reader_ + queue_.size() - writer_);
-  ++writer_;
-  cv_.notify_all();
 }
 
 } // namespace caffe2
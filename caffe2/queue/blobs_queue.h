@@ -11,11 +11,12 @@
 #include "caffe2/core/stats.h"
 #include "caffe2/core/tensor.h"
 #include "caffe2/core/workspace.h"
+#include "caffe2/queue/mpmc_ring.h"
 
 namespace caffe2 {
 
 // A thread-safe, bounded, blocking queue.
-// Modelled as a circular buffer.
+// Modelled as a lock-free circular buffer (see MPMCRing).
 
 // Containing blobs are owned by the workspace.
 // On read, we swap out the underlying data for the blob passed in for blobs
@@ -37,6 +38,13 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   bool blockingRead(
       const std::vector<Blob*>& inputs,
       float timeout_secs = 0.0f);
+  // Waits for at least one record, then reads as many of the available
+  // records as there are entries in `inputs`, at once. Returns the number of
+  // records read, into the first entries of `inputs`, or 0 if the queue was
+  // closed or the read timed out.
+  size_t blockingReadMany(
+      const std::vector<std::vector<Blob*>>& inputs,
+      float timeout_secs = 0.0f);
   bool tryWrite(const std::vector<Blob*>& inputs);
   bool blockingWrite(const std::vector<Blob*>& inputs);
   void close();
@@ -45,17 +53,12 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   }
 
  private:
-  bool canWrite();
-  void doWrite(const std::vector<Blob*>& inputs);
-
-  std::atomic<bool> closing_{false};
+  template <typename F>
+  size_t readRecords(size_t numRecords, F recordInputs, float timeout_secs);
+  void doWrite(const std::vector<Blob*>& inputs, std::vector<Blob*>& result);
 
   size_t numBlobs_;
-  std::mutex mutex_; // protects all variables in the class.
-  std::condition_variable cv_;
-  int64_t reader_{0};
-  int64_t writer_{0};
-  std::vector<std::vector<Blob*>> queue_;
+  MPMCRing<std::vector<Blob*>> queue_;
   const std::string name_;
 
   struct QueueStats {
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+
+// A bounded, blocking, multi-producer multi-consumer ring buffer.
+//
+// Producers and consumers claim slots with a compare-and-swap on the write or
+// read position, and each slot carries a sequence number that tells whether
+// it is free or holds an entry for the current lap (Dmitry Vyukov's bounded
+// MPMC queue). Neither reads nor writes take a lock when the ring is neither
+// empty nor full. A thread that finds it empty (or full) spins for a while,
+// then sleeps on a condition variable, which the other side only notifies
+// when some thread is actually sleeping.
+//
+// Entries are not copied in or out of the ring: writers and readers get a
+// reference to the slot, so that they can swap or move its contents. Each slot
+// keeps its value after being read, and is reused by a later write.
+//
+// After close(), blocked writers return false if the ring is still full, and
+// readers return 0 once the ring is empty. Entries written before can still be
+// read.
+template <typename T>
+class MPMCRing {
+ public:
+  explicit MPMCRing(size_t capacity)
+      : capacity_(capacity), slots_(new Slot[capacity]) {
+    CAFFE_ENFORCE_GT(capacity, 0, "MPMCRing requires a positive capacity");
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MPMCRing(const MPMCRing&) = delete;
+  MPMCRing& operator=(const MPMCRing&) = delete;
+
+  size_t capacity() const {
+    return capacity_;
+  }
+
+  // Direct access to the i-th slot, to initialize its contents before the
+  // ring is used. Not thread-safe.
+  T& slot(size_t i) {
+    return slots_[i].value;
+  }
+
+  // Approximate number of entries, exact when no write or read is in flight.
+  size_t size() const {
+    const auto writePos = writePos_.load(std::memory_order_acquire);
+    const auto readPos = readPos_.load(std::memory_order_acquire);
+    return writePos > readPos ? writePos - readPos : 0;
+  }
+
+  // Calls writer(T&) on the next free slot, and returns true, unless the ring
+  // is full. The writer must not throw.
+  template <typename F>
+  bool tryWrite(F&& writer) {
+    auto pos = writePos_.load(std::memory_order_relaxed);
+    for (;;) {
+      auto& slot = slots_[pos % capacity_];
+      const auto seq = slot.seq.load(std::memory_order_acquire);
+      if (seq == pos) {
+        if (writePos_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          writer(slot.value);
+          slot.seq.store(pos + 1, std::memory_order_release);
+          notify(readersWaiting_, notEmpty_);
+          return true;
+        }
+      } else if (seq < pos) {
+        // The slot still holds the entry of the previous lap.
+        return false;
+      } else {
+        pos = writePos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Calls reader(T&) on up to maxItems consecutive entries, oldest first, and
+  // returns how many were read, which is 0 if the ring is empty. The reader
+  // must not throw.
+  template <typename F>
+  size_t tryRead(size_t maxItems, F&& reader) {
+    if (maxItems > capacity_) {
+      maxItems = capacity_;
+    }
+    auto pos = readPos_.load(std::memory_order_relaxed);
+    for (;;) {
+      size_t count = 0;
+      while (count < maxItems &&
+             slots_[(pos + count) % capacity_].seq.load(
+                 std::memory_order_acquire) == pos + count + 1) {
+        ++count;
+      }
+      if (count == 0) {
+        const auto seq =
+            slots_[pos % capacity_].seq.load(std::memory_order_acquire);
+        if (seq <= pos) {
+          // Not written yet.
+          return 0;
+        }
+        // Another reader took it.
+        pos = readPos_.load(std::memory_order_relaxed);
+        continue;
+      }
+      // The entries can only be taken by the reader that moves the read
+      // position past them.
+      if (readPos_.compare_exchange_weak(
+              pos, pos + count, std::memory_order_relaxed)) {
+        for (size_t i = 0; i < count; ++i) {
+          auto& slot = slots_[(pos + i) % capacity_];
+          reader(slot.value);
+          slot.seq.store(pos + i + capacity_, std::memory_order_release);
+        }
+        notify(writersWaiting_, notFull_);
+        return count;
+      }
+    }
+  }
+
+  // Like tryWrite, but waits for a free slot. Returns false if the ring was
+  // closed while full.
+  template <typename F>
+  bool blockingWrite(F&& writer) {
+    for (int spin = 0;; ++spin) {
+      if (tryWrite(writer)) {
+        return true;
+      }
+      if (closed_.load()) {
+        return false;
+      }
+      if (spin < kSpinCount) {
+        std::this_thread::yield();
+        continue;
+      }
+      wait(writersWaiting_, notFull_, [this] { return canWrite(); }, nullptr);
+    }
+  }
+
+  // Like tryRead, but waits for at least one entry. Returns 0 if the ring is
+  // empty and closed.
+  template <typename F>
+  size_t blockingRead(size_t maxItems, F&& reader) {
+    return blockingRead(maxItems, std::forward<F>(reader), nullptr);
+  }
+
+  // Returns 0 as well if nothing could be read within the timeout.
+  template <typename F>
+  size_t blockingRead(
+      size_t maxItems,
+      F&& reader,
+      std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    return blockingRead(maxItems, std::forward<F>(reader), &deadline);
+  }
+
+  void close() {
+    closed_.store(true);
+    {
+      // Wake up the threads that checked for closing before it happened.
+      std::lock_guard<std::mutex> g(mutex_);
+    }
+    notEmpty_.notify_all();
+    notFull_.notify_all();
+  }
+
+  bool isClosed() const {
+    return closed_.load();
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> seq{0};
+    T value;
+  };
+
+  static constexpr int kSpinCount = 64;
+
+  template <typename F>
+  size_t blockingRead(
+      size_t maxItems,
+      F&& reader,
+      const std::chrono::steady_clock::time_point* deadline) {
+    for (int spin = 0;; ++spin) {
+      const auto count = tryRead(maxItems, reader);
+      if (count > 0) {
+        return count;
+      }
+      if (closed_.load()) {
+        // Entries written right before closing are still readable.
+        return tryRead(maxItems, reader);
+      }
+      if (spin < kSpinCount) {
+        std::this_thread::yield();
+        continue;
+      }
+      if (!wait(
+              readersWaiting_,
+              notEmpty_,
+              [this] { return canRead(); },
+              deadline)) {
+        return 0;
+      }
+    }
+  }
+
+  bool canWrite() const {
+    const auto pos = writePos_.load(std::memory_order_relaxed);
+    return slots_[pos % capacity_].seq.load(std::memory_order_acquire) >= pos;
+  }
+
+  bool canRead() const {
+    const auto pos = readPos_.load(std::memory_order_relaxed);
+    return slots_[pos % capacity_].seq.load(std::memory_order_acquire) > pos;
+  }
+
+  // Sleeps until ready() or closing, and returns false on timeout.
+  template <typename P>
+  bool wait(
+      std::atomic<int>& waiters,
+      std::condition_variable& cv,
+      P ready,
+      const std::chrono::steady_clock::time_point* deadline) {
+    std::unique_lock<std::mutex> g(mutex_);
+    waiters.fetch_add(1);
+    // Either we see the entry (or slot) published by the other side, or it
+    // sees us waiting and notifies.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto predicate = [this, &ready] { return closed_.load() || ready(); };
+    bool result = true;
+    if (deadline) {
+      result = cv.wait_until(g, *deadline, predicate);
+    } else {
+      cv.wait(g, predicate);
+    }
+    waiters.fetch_sub(1);
+    return result;
+  }
+
+  void notify(std::atomic<int>& waiters, std::condition_variable& cv) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load(std::memory_order_relaxed) > 0) {
+      {
+        std::lock_guard<std::mutex> g(mutex_);
+      }
+      cv.notify_all();
+    }
+  }
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // Keep the positions on separate cache lines, since they are written by
+  // different threads.
+  char pad0_[64];
+  std::atomic<uint64_t> writePos_{0};
+  char pad1_[64];
+  std::atomic<uint64_t> readPos_{0};
+  char pad2_[64];
+
+  std::atomic<bool> closed_{false};
+  std::atomic<int> readersWaiting_{0};
+  std::atomic<int> writersWaiting_{0};
+  std::mutex mutex_; // only used to sleep and wake up
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+};
+
+template <typename T>
+constexpr int MPMCRing<T>::kSpinCount;
+
+} // namespace caffe2
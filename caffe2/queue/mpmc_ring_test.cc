@@ -0,0 +1,139 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "caffe2/queue/mpmc_ring.h"
+
+namespace caffe2 {
+
+namespace {
+
+std::function<void(int&)> writeValue(int value) {
+  return [value](int& slot) { slot = value; };
+}
+
+} // namespace
+
+TEST(MPMCRingTest, FullAndEmpty) {
+  MPMCRing<int> ring(3);
+  int value = -1;
+  auto readValue = [&value](int& slot) { value = slot; };
+  EXPECT_EQ(ring.tryRead(1, readValue), 0);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(ring.tryWrite(writeValue(i)));
+  }
+  EXPECT_FALSE(ring.tryWrite(writeValue(3)));
+  EXPECT_EQ(ring.size(), 3);
+
+  EXPECT_EQ(ring.tryRead(1, readValue), 1);
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(ring.tryWrite(writeValue(3)));
+  for (int i = 1; i < 4; ++i) {
+    EXPECT_EQ(ring.blockingRead(1, readValue), 1);
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_EQ(ring.size(), 0);
+}
+
+TEST(MPMCRingTest, ReadMany) {
+  MPMCRing<int> ring(4);
+  std::vector<int> values;
+  auto readValue = [&values](int& slot) { values.push_back(slot); };
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(ring.blockingWrite(writeValue(i)));
+  }
+  // Only reads what is available
+  EXPECT_EQ(ring.blockingRead(5, readValue), 3);
+  EXPECT_EQ(values, (std::vector<int>{0, 1, 2}));
+
+  // Wraps around the end of the ring
+  for (int i = 3; i < 7; ++i) {
+    EXPECT_TRUE(ring.blockingWrite(writeValue(i)));
+  }
+  values.clear();
+  EXPECT_EQ(ring.blockingRead(2, readValue), 2);
+  EXPECT_EQ(ring.blockingRead(4, readValue), 2);
+  EXPECT_EQ(values, (std::vector<int>{3, 4, 5, 6}));
+}
+
+TEST(MPMCRingTest, Close) {
+  MPMCRing<int> ring(2);
+  int value = -1;
+  auto readValue = [&value](int& slot) { value = slot; };
+
+  std::thread reader([&] { EXPECT_EQ(ring.blockingRead(1, readValue), 0); });
+  ring.close();
+  reader.join();
+
+  // Writes still succeed while there is room, and can be read
+  EXPECT_TRUE(ring.blockingWrite(writeValue(1)));
+  EXPECT_TRUE(ring.blockingWrite(writeValue(2)));
+  EXPECT_FALSE(ring.blockingWrite(writeValue(3)));
+  EXPECT_EQ(ring.blockingRead(1, readValue), 1);
+  EXPECT_EQ(value, 1);
+  EXPECT_EQ(ring.blockingRead(1, readValue), 1);
+  EXPECT_EQ(value, 2);
+  EXPECT_EQ(ring.blockingRead(1, readValue), 0);
+}
+
+TEST(MPMCRingTest, Timeout) {
+  MPMCRing<int> ring(1);
+  auto ignore = [](int& /* unused */) {};
+  EXPECT_EQ(ring.blockingRead(1, ignore, std::chrono::milliseconds(10)), 0);
+  EXPECT_FALSE(ring.isClosed());
+  EXPECT_TRUE(ring.tryWrite(writeValue(1)));
+  EXPECT_EQ(ring.blockingRead(1, ignore, std::chrono::milliseconds(10)), 1);
+}
+
+TEST(MPMCRingTest, MultipleProducersMultipleConsumers) {
+  const int kProducers = 4;
+  const int kConsumers = 4;
+  const int kValuesPerProducer = 10000;
+  MPMCRing<int> ring(16);
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; ++p) {
+    producers.emplace_back([&ring, p] {
+      for (int i = 0; i < kValuesPerProducer; ++i) {
+        EXPECT_TRUE(ring.blockingWrite(writeValue(p * kValuesPerProducer + i)));
+      }
+    });
+  }
+  std::vector<std::vector<int>> consumed(kConsumers);
+  std::vector<std::thread> consumers;
+  for (int c = 0; c < kConsumers; ++c) {
+    consumers.emplace_back([&ring, &consumed, c] {
+      auto readValue = [&consumed, c](int& slot) {
+        consumed[c].push_back(slot);
+      };
+      // Readers alternate between single and batched reads
+      while (ring.blockingRead(c % 2 == 0 ? 1 : 8, readValue) > 0) {
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ring.close();
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  // Every value is read exactly once, and the values of each producer are
+  // read in order by each consumer
+  std::vector<int> counts(kProducers * kValuesPerProducer, 0);
+  for (const auto& values : consumed) {
+    std::vector<int> last(kProducers, -1);
+    for (auto value : values) {
+      ++counts[value];
+      auto p = value / kValuesPerProducer;
+      EXPECT_GT(value, last[p]);
+      last[p] = value;
+    }
+  }
+  for (auto count : counts) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+} // namespace caffe2
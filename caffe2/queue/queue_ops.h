@@ -130,23 +130,38 @@ class SafeDequeueBlobsOp final : public Operator<Context> {
   bool dequeueMany(std::shared_ptr<BlobsQueue>& queue) {
     auto size = queue->getNumBlobs();
 
-    if (blobs_.size() != size) {
-      blobs_.resize(size);
-      blobPtrs_.resize(size);
-      for (int col = 0; col < size; ++col) {
-        blobPtrs_.at(col) = &blobs_.at(col);
+    if (blobs_.size() != numRecords_ * size) {
+      blobs_.resize(numRecords_ * size);
+      blobPtrs_.resize(numRecords_);
+      for (int i = 0; i < numRecords_; ++i) {
+        blobPtrs_.at(i).resize(size);
+        for (int col = 0; col < size; ++col) {
+          blobPtrs_.at(i).at(col) = &blobs_.at(i * size + col);
+        }
       }
     }
 
-    const int kTensorGrowthPct = 40;
-    for (int i = 0; i < numRecords_; ++i) {
-      if (!queue->blockingRead(blobPtrs_)) {
-        // if we read at least one record, status is still true
-        return i > 0;
+    // Read the records in batches of what is available in the queue
+    int numRead = 0;
+    while (numRead < numRecords_) {
+      std::vector<std::vector<Blob*>> records(
+          blobPtrs_.begin() + numRead, blobPtrs_.end());
+      auto read = queue->blockingReadMany(records);
+      if (read == 0) {
+        break;
       }
+      numRead += read;
+    }
+    // if we read at least one record, status is still true
+    if (numRead == 0) {
+      return false;
+    }
+
+    const int kTensorGrowthPct = 40;
+    for (int i = 0; i < numRead; ++i) {
       for (int col = 0; col < size; ++col) {
         auto* out = this->Output(col);
-        const auto& in = blobPtrs_.at(col)->template Get<Tensor>();
+        const auto& in = blobPtrs_.at(i).at(col)->template Get<Tensor>();
         if (i == 0) {
           out->CopyFrom(in);
         } else {
@@ -195,7 +210,7 @@ class SafeDequeueBlobsOp final : public Operator<Context> {
  private:
   int numRecords_;
   std::vector<Blob> blobs_;
-  std::vector<Blob*> blobPtrs_;
+  std::vector<std::vector<Blob*>> blobPtrs_;
 };
 
 template <typename Context>
@@ -1,37 +1,68 @@
 #include "rebatching_queue.h"
-#include "caffe2/utils/smart_tensor_printer.h"
+#include "caffe2/utils/threadpool/ThreadPool.h"
+
+#include <algorithm>
 
 namespace caffe2 {
 
 namespace {
 
+// Batches smaller than this are concatenated on the calling thread.
+constexpr size_t kParallelConcatMinBytes = 1 << 20;
+
+size_t rowBytes(const std::vector<TensorCPU>& row) {
+  size_t bytes = 0;
+  for (const auto& tensor : row) {
+    bytes += tensor.nbytes();
+  }
+  return bytes;
+}
+
+// Whether next directly follows prev in the same storage.
+bool isNextRow(const TensorCPU& prev, const TensorCPU& next) {
+  return prev.numel() > 0 &&
+      prev.unsafeGetTensorImpl()->storage().unsafeGetStorageImpl() ==
+      next.unsafeGetTensorImpl()->storage().unsafeGetStorageImpl() &&
+      static_cast<const char*>(prev.raw_data()) + prev.nbytes() ==
+      next.raw_data();
+}
+
+// Makes output a view of consecutive rows. The view gets a storage of its
+// own, which covers just these rows and keeps the storage of the rows alive,
+// so that writing to the output can't overwrite other rows still in the
+// queue.
+void shareRows(
+    const std::vector<std::vector<TensorCPU>>& rows,
+    size_t blob,
+    std::vector<int64_t> dims,
+    TensorCPU* output) {
+  const auto& first = rows[0][blob];
+  auto* storage = new at::Storage(first.unsafeGetTensorImpl()->storage());
+  at::DataPtr dataPtr(
+      const_cast<void*>(first.raw_data()),
+      storage,
+      [](void* ctx) { delete static_cast<at::Storage*>(ctx); },
+      at::Device(CPU));
+  output->Resize(dims);
+  output->ShareExternalPointer(
+      std::move(dataPtr), first.dtype(), rows.size() * first.nbytes());
+}
+
 // This concat function will always create a new first dimension to concat
 void concat(
     CPUContext& context,
     const std::vector<std::vector<TensorCPU>>& inputs,
-    const std::vector<TensorCPU*>& outputs) {
+    const std::vector<TensorCPU*>& outputs,
+    ThreadPool* pool) {
   CAFFE_ENFORCE(!inputs.empty());
 
   const auto& inputZero = inputs[0];
   const auto numTensors = inputZero.size();
   const auto numRows = inputs.size();
 
-  // Precompute the output sizes to avoid resizing
-  std::vector<std::vector<int64_t>> outputDims(numTensors);
-
-  for (size_t i = 0; i < numTensors; ++i) {
-    SmartTensorPrinter::PrintTensor(inputZero.at(i));
-    outputDims[i] = inputZero.at(i).sizes().vec();
-    outputDims[i].insert(outputDims[i].begin(), numRows);
-  }
-
-  // Resize to the final output size
-  std::vector<void*> destinations(numTensors);
-  for (size_t i = 0; i < numTensors; ++i) {
-    outputs[i]->Resize(outputDims[i]);
-    destinations[i] = outputs[i]->raw_mutable_data(inputZero[i].meta());
-  }
-
+  // Check all the rows before copying, which may happen on the pool's threads,
+  // and find the outputs that can be views of their rows.
+  std::vector<bool> contiguous(numTensors, true);
   for (size_t i = 0; i < numRows; ++i) {
     CAFFE_ENFORCE_EQ(inputs[i].size(), numTensors);
 
@@ -44,23 +75,56 @@ void concat(
       for (int k = 0; k < input.dim(); ++k) {
         CAFFE_ENFORCE_EQ(input.sizes()[k], inputZero[j].size(k));
       }
+      contiguous[j] = contiguous[j] &&
+          (i == 0 ? input.numel() > 0 : isNextRow(inputs[i - 1][j], input));
+    }
+  }
 
-      // Skip empty tensors
-      if (input.numel() == 0) {
+  // Precompute the output sizes to avoid resizing
+  std::vector<void*> destinations(numTensors, nullptr);
+  size_t copyBytes = 0;
+  for (size_t i = 0; i < numTensors; ++i) {
+    auto dims = inputZero.at(i).sizes().vec();
+    dims.insert(dims.begin(), numRows);
+    if (contiguous[i]) {
+      shareRows(inputs, i, std::move(dims), outputs[i]);
+      continue;
+    }
+    outputs[i]->Resize(dims);
+    destinations[i] = outputs[i]->raw_mutable_data(inputZero[i].meta());
+    copyBytes += numRows * inputZero[i].nbytes();
+  }
+
+  auto copyRows = [&](size_t begin, size_t end) {
+    for (int j = 0; j < numTensors; ++j) {
+      // Skip views and empty tensors
+      if (!destinations[j] || inputZero[j].numel() == 0) {
         continue;
       }
-
-      context.CopyItemsToCPU(
-          input.dtype(),
-          input.numel(),
-          input.raw_data() /* src */,
-          destinations[j] /* dst */
-      );
-
-      destinations[j] =
-          (char*)destinations[j] + input.numel() * input.itemsize();
+      const auto bytes = inputZero[j].nbytes();
+      for (size_t i = begin; i < end; ++i) {
+        const auto& input = inputs[i][j];
+        context.CopyItemsToCPU(
+            input.dtype(),
+            input.numel(),
+            input.raw_data() /* src */,
+            static_cast<char*>(destinations[j]) + i * bytes /* dst */
+        );
+      }
     }
+  };
+
+  if (!pool || copyBytes < kParallelConcatMinBytes || numRows < 2) {
+    copyRows(0, numRows);
+    return;
   }
+  const size_t numTasks =
+      std::min<size_t>(numRows, std::max(pool->getNumThreads(), 1));
+  pool->run(
+      [&](int /* unused */, size_t task) {
+        copyRows(task * numRows / numTasks, (task + 1) * numRows / numTasks);
+      },
+      numTasks);
 }
 
 std::vector<std::vector<TensorCPU>> split(
@@ -76,20 +140,32 @@ std::vector<std::vector<TensorCPU>> split(
 
     const auto& input = *inputPtr;
     const auto innerSize = input.size_from_dim(1);
-    const auto itemSize = input.dtype().itemsize();
 
     auto outputDims = input.sizes().vec();
     CAFFE_ENFORCE(!outputDims.empty());
     outputDims.erase(outputDims.begin());
     CAFFE_ENFORCE_EQ(input.sizes().at(0), outputSize);
 
+    // The rows are views of a single copy of the input.
+    Tensor batch(input.sizes(), CPU);
+    context.CopyItemsToCPU(
+        input.dtype(),
+        input.numel(),
+        input.raw_data() /* src */,
+        batch.raw_mutable_data(input.dtype()) /* dst */);
+    const auto* batchImpl = batch.unsafeGetTensorImpl();
+
     for (int i = 0; i < outputSize; ++i) {
       outputs[i].push_back(Tensor(outputDims, CPU));
-      context.CopyItemsToCPU(
-          input.dtype(),
-          innerSize,
-          (char*)input.raw_data() + i * innerSize * itemSize /* src */,
-          outputs[i].back().raw_mutable_data(input.dtype()) /* dst */);
+      auto& row = outputs[i].back();
+      if (innerSize == 0) {
+        row.raw_mutable_data(input.dtype());
+        continue;
+      }
+      auto* rowImpl = row.unsafeGetTensorImpl();
+      rowImpl->set_storage(batchImpl->storage());
+      rowImpl->set_storage_offset(
+          batchImpl->storage_offset() + i * innerSize);
     }
   }
 
@@ -97,64 +173,50 @@ std::vector<std::vector<TensorCPU>> split(
 }
 } // anonymous namespace
 
-RebatchingQueue::RebatchingQueue(size_t capacity, size_t numBlobs)
-    : capacity_(capacity), numBlobs_(numBlobs), queue_(capacity) {}
+RebatchingQueue::RebatchingQueue(
+    size_t capacity,
+    size_t numBlobs,
+    size_t capacityBytes)
+    : capacity_(capacity),
+      numBlobs_(numBlobs),
+      capacityBytes_(capacityBytes),
+      queue_(capacity) {}
 
 RebatchingQueue::~RebatchingQueue() {
   close();
 }
 
-bool RebatchingQueue::canRead() const {
-  return tail_ < head_;
-}
-
 bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
-    const std::vector<TensorCPU*>& outputs) {
+    const std::vector<TensorCPU*>& outputs,
+    ThreadPool* pool) {
   std::vector<std::vector<TensorCPU>> results;
   results.reserve(numElements);
 
-  for (;;) {
-    if (results.size() == numElements) {
+  size_t bytes = 0;
+  auto reader = [&results, &bytes](std::vector<TensorCPU>& entry) {
+    bytes += rowBytes(entry);
+    results.push_back(std::move(entry));
+  };
+  while (results.size() < numElements) {
+    // We only want to stop reading if the queue is empty and closed
+    if (queue_.blockingRead(numElements - results.size(), reader) == 0) {
       break;
     }
-
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-
-      cvEmpty_.wait(lock, [this] { return canRead() || isClosed_; });
-
-      // We only want to stop reading if the queue is empty and closed
-      if (!canRead() && isClosed_) {
-        break;
-      }
-
-      do {
-        results.push_back(std::move(queue_[tail_++ % capacity()]));
-      } while (canRead() && results.size() < numElements);
-    }
-
-    if (numElements == 1) {
-      cvOverflow_.notify_one();
-    } else {
-      cvOverflow_.notify_all();
-    }
   }
 
+  releaseBytes(bytes);
+
   if (results.empty()) {
     return false;
   }
 
-  concat(context, results, outputs);
+  concat(context, results, outputs, pool);
 
   return true;
 }
 
-bool RebatchingQueue::canWrite() const {
-  return tail_ + capacity() > head_;
-}
-
 bool RebatchingQueue::enqueueOne(
     CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
@@ -181,54 +243,78 @@ bool RebatchingQueue::enqueueMany(
 
 bool RebatchingQueue::enqueue(
     std::vector<std::vector<TensorCPU>> splittedInputs) {
-  int idx = 0;
-  for (;;) {
-    if (idx >= splittedInputs.size()) {
-      break;
+  for (auto& entry : splittedInputs) {
+    const auto bytes = rowBytes(entry);
+    if (!reserveBytes(bytes)) {
+      return false;
     }
-
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-
-      cvOverflow_.wait(lock, [this] { return canWrite() || isClosed_; });
-
-      if (isClosed_) {
-        // If we are here it means that we didn't apply the entire batch and if
-        // we get closed in the middle of enquing we treat it as a non-success.
-        return false;
-      }
-
-      do {
-        queue_[head_++ % capacity()] = std::move(splittedInputs[idx++]);
-      } while (canWrite() && idx < splittedInputs.size());
+    // If we get closed in the middle of enquing we treat it as a non-success,
+    // even though part of the batch has been applied.
+    if (queue_.isClosed() ||
+        !queue_.blockingWrite([&entry](std::vector<TensorCPU>& slot) {
+          slot = std::move(entry);
+        })) {
+      releaseBytes(bytes);
+      return false;
     }
-
-    cvEmpty_.notify_all();
   }
 
   return true;
 }
 
+bool RebatchingQueue::reserveBytes(size_t bytes) {
+  std::unique_lock<std::mutex> lock(bytesMutex_);
+  if (capacityBytes_ > 0) {
+    bytesReleased_.wait(lock, [&] {
+      return queue_.isClosed() || bytes_ == 0 ||
+          bytes_ + bytes <= capacityBytes_;
+    });
+  }
+  if (queue_.isClosed()) {
+    return false;
+  }
+  bytes_ += bytes;
+  return true;
+}
+
+void RebatchingQueue::releaseBytes(size_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(bytesMutex_);
+    bytes_ -= bytes;
+  }
+  bytesReleased_.notify_all();
+}
+
 size_t RebatchingQueue::capacity() const {
   return capacity_;
 }
 
+size_t RebatchingQueue::capacityBytes() const {
+  return capacityBytes_;
+}
+
+size_t RebatchingQueue::sizeBytes() const {
+  std::lock_guard<std::mutex> guard(bytesMutex_);
+  return bytes_;
+}
+
 size_t RebatchingQueue::numBlobs() const {
   return numBlobs_;
 }
 
 bool RebatchingQueue::isClosed() const {
-  std::lock_guard<std::mutex> g(mutex_);
-  return isClosed_;
+  return queue_.isClosed();
 }
 
 void RebatchingQueue::close() {
+  queue_.close();
   {
-    std::lock_guard<std::mutex> g(mutex_);
-    isClosed_ = true;
+    // Wake up the writers that checked for closing before it happened.
+    std::lock_guard<std::mutex> guard(bytesMutex_);
   }
-
-  cvEmpty_.notify_all();
-  cvOverflow_.notify_all();
+  bytesReleased_.notify_all();
 }
 } // caffe2
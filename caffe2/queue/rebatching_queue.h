@@ -10,16 +10,27 @@
 #include "caffe2/core/operator.h"
 #include "caffe2/core/stats.h"
 #include "caffe2/core/tensor.h"
+#include "caffe2/queue/mpmc_ring.h"
 
 namespace caffe2 {
 
-// TODO: This is a very naive implementation with a single mutex. We can do the
-// atomic index + circular queue optimizations or pull something more
-// heavy-weight later
-
+class ThreadPool;
+
+// A queue of rows, i.e. of numBlobs tensors without the batch dimension, that
+// are enqueued one at a time or as batches and dequeued as batches of any
+// size.
+//
+// The rows of an enqueued batch are views of a single copy of its tensors,
+// and a dequeued batch whose rows all come from the same enqueued batch is a
+// view of that copy as well. Other batches are concatenated, in parallel on
+// the given thread pool if they are large.
+//
+// Besides the number of rows, capacityBytes (if not 0) bounds the memory of
+// the enqueued rows: enqueuing waits until the rows fit, unless the queue is
+// empty, so that a single row larger than capacityBytes can still go through.
 class RebatchingQueue {
  public:
-  RebatchingQueue(size_t capacity, size_t numBlobs);
+  RebatchingQueue(size_t capacity, size_t numBlobs, size_t capacityBytes = 0);
 
   ~RebatchingQueue();
 
@@ -34,10 +45,16 @@ class RebatchingQueue {
   bool dequeue(
       CPUContext& context,
       size_t numElements,
-      const std::vector<TensorCPU*>& outputs);
+      const std::vector<TensorCPU*>& outputs,
+      ThreadPool* pool = nullptr);
 
   size_t capacity() const;
 
+  size_t capacityBytes() const;
+
+  // Number of bytes of the rows in the queue.
+  size_t sizeBytes() const;
+
   size_t numBlobs() const;
 
   bool isClosed() const;
@@ -47,22 +64,18 @@ class RebatchingQueue {
  private:
   bool enqueue(std::vector<std::vector<TensorCPU>> splittedInputs);
 
-  bool canWrite() const;
-  bool canRead() const;
+  bool reserveBytes(size_t bytes);
+
+  void releaseBytes(size_t bytes);
 
   const size_t capacity_;
   const size_t numBlobs_;
+  const size_t capacityBytes_;
 
-  mutable std::mutex mutex_;
-
-  bool isClosed_{false};
-
-  uint64_t head_{0};
-  uint64_t tail_{0};
-
-  std::condition_variable cvEmpty_;
-  std::condition_variable cvOverflow_;
+  mutable std::mutex bytesMutex_;
+  std::condition_variable bytesReleased_;
+  size_t bytes_{0};
 
-  std::vector<std::vector<TensorCPU>> queue_;
+  MPMCRing<std::vector<TensorCPU>> queue_;
 };
 } // caffe2
@@ -26,7 +26,12 @@ Creates the Queue.
     .Arg("num_blobs", "Number of input tensors the queue will support")
     .Arg(
         "capacity",
-        "Maximal number of elements the queue can hold at any given point");
+        "Maximal number of elements the queue can hold at any given point")
+    .Arg(
+        "capacity_bytes",
+        "If positive, maximal number of bytes the elements in the queue can "
+        "take. Enqueuing waits until the elements fit, unless the queue is "
+        "empty.");
 
 OPERATOR_SCHEMA(CloseRebatchingQueue)
     .NumInputs(1)
@@ -61,7 +66,8 @@ OPERATOR_SCHEMA(DequeueRebatchingQueue)
 Dequeue Tensors from the Queue.
 If the Queue is closed this might return less elements than asked.
 If num_elements > 1 the returned elements will be concatenated into one
-tensor per component.
+tensor per component. Elements that were enqueued together as a batch are
+returned without a copy, as views of the enqueued batch.
 )DOC")
     .Input(0, "rebatching_queue", "object representing the queue")
     .Input(1, "tensor", "First tensor to enqueue")
@@ -15,7 +15,8 @@ class CreateRebatchingQueueOp : public Operator<CPUContext> {
     *OperatorBase::Output<RebatchingQueuePtr>(0) =
         RebatchingQueuePtr(new RebatchingQueue(
             OperatorBase::GetSingleArgument<int>("capacity", 1),
-            OperatorBase::GetSingleArgument<int>("num_blobs", 1)));
+            OperatorBase::GetSingleArgument<int>("num_blobs", 1),
+            OperatorBase::GetSingleArgument<int64_t>("capacity_bytes", 0)));
     return true;
   }
 };
@@ -48,6 +49,7 @@ class DequeueRebatchingQueueOp : public Operator<CPUContext> {
  public:
   DequeueRebatchingQueueOp(const OperatorDef& operator_def, Workspace* ws)
       : Operator(operator_def, ws),
+        ws_(ws),
         numElements_(OperatorBase::GetSingleArgument<int>("num_elements", 1)) {}
 
   bool RunOnDevice() override {
@@ -60,10 +62,12 @@ class DequeueRebatchingQueueOp : public Operator<CPUContext> {
       outputTensors.push_back(Output(i));
     }
 
-    return queue->dequeue(context_, numElements_, outputTensors);
+    return queue->dequeue(
+        context_, numElements_, outputTensors, ws_->GetThreadPool());
   }
 
  private:
+  Workspace* ws_;
   int numElements_;
 };
 
@@ -2,26 +2,105 @@
 #include <c10/util/Exception.h>
 #include "caffe2/core/common.h"
 
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace caffe2 {
 namespace serialize {
 
-FileAdapter::FileAdapter(const std::string& file_name) {
+struct FileAdapter::MappedFile {
+  MappedFile(void* data, size_t size) : data(data), size(size) {}
+  ~MappedFile() {
+#ifndef _WIN32
+    munmap(data, size);
+#endif
+  }
+  void* data;
+  size_t size;
+};
+
+namespace {
+
+bool mmapEnabled() {
+  const char* env = std::getenv("PYTORCH_JIT_LOAD_MMAP");
+  return env && std::strcmp(env, "1") == 0;
+}
+
+// Deleter of the DataPtrs returned by map(), whose context holds a reference to
+// the mapping.
+template <typename T>
+void deleteSharedPtr(void* ctx) {
+  delete static_cast<std::shared_ptr<T>*>(ctx);
+}
+
+} // namespace
+
+FileAdapter::FileAdapter(const std::string& file_name)
+    : FileAdapter(file_name, mmapEnabled()) {}
+
+FileAdapter::FileAdapter(const std::string& file_name, bool use_mmap) {
   file_stream_.open(file_name, std::ifstream::in | std::ifstream::binary);
   if (!file_stream_) {
     AT_ERROR("open file failed, file path: ", file_name);
   }
   istream_adapter_ = caffe2::make_unique<IStreamAdapter>(&file_stream_);
+#ifndef _WIN32
+  if (use_mmap) {
+    int fd = open(file_name.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd >= 0 && fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+      const size_t size = file_stat.st_size;
+      void* data =
+          mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        mapping_ = std::make_shared<MappedFile>(data, size);
+      }
+    }
+    // the mapping stays valid after the file is closed
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+#endif
 }
 
 size_t FileAdapter::size() const {
+  if (mapping_) {
+    return mapping_->size;
+  }
   return istream_adapter_->size();
 }
 
 size_t FileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
     const {
+  if (mapping_) {
+    if (pos + n > mapping_->size) {
+      AT_ERROR("file reader failed: ", what, ", reading past the end of file.");
+    }
+    std::memcpy(buf, static_cast<char*>(mapping_->data) + pos, n);
+    return n;
+  }
   return istream_adapter_->read(pos, buf, n, what);
 }
 
+at::DataPtr FileAdapter::map(uint64_t pos, size_t n) const {
+  if (!mapping_ || pos + n > mapping_->size) {
+    return at::DataPtr();
+  }
+  return at::DataPtr(
+      static_cast<char*>(mapping_->data) + pos,
+      new std::shared_ptr<MappedFile>(mapping_),
+      deleteSharedPtr<MappedFile>,
+      at::kCPU);
+}
+
 FileAdapter::~FileAdapter() {}
 
 } // namespace serialize
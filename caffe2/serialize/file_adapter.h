@@ -10,18 +10,31 @@
 namespace caffe2 {
 namespace serialize {
 
+// Reads from a file. With use_mmap (by default, when the PYTORCH_JIT_LOAD_MMAP
+// environment variable is set to 1), the file is also mapped in memory
+// (privately, so writes to the mapped records never reach the file), and map()
+// returns records without copying them; their pages are only read from disk
+// when first touched, and are shared through the page cache with the other
+// processes mapping the same file until they are written to. The file must
+// then not be truncated while anything loaded from it is alive.
 class CAFFE2_API FileAdapter final : public ReadAdapterInterface {
  public:
   C10_DISABLE_COPY_AND_ASSIGN(FileAdapter);
   explicit FileAdapter(const std::string& file_name);
+  FileAdapter(const std::string& file_name, bool use_mmap);
   size_t size() const override;
   size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const override;
+  at::DataPtr map(uint64_t pos, size_t n) const override;
   ~FileAdapter();
 
  private:
+  struct MappedFile;
+
   std::ifstream file_stream_;
   std::unique_ptr<IStreamAdapter> istream_adapter_;
+  // shared with the DataPtrs returned by map(), which may outlive the adapter
+  std::shared_ptr<MappedFile> mapping_;
 };
 
 } // namespace serialize
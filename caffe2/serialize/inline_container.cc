@@ -176,12 +176,29 @@ size_t PyTorchStreamReader::getFileID(const std::string& name) {
   return result;
 }
 
+static int64_t read_le_16(uint8_t* buf) {
+  return buf[0] + (buf[1] << 8);
+}
+
 // return dataptr, size
 std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
   size_t key = getFileID(name);
   mz_zip_archive_file_stat stat;
   mz_zip_reader_file_stat(ar_.get(), key, &stat);
   valid("retrieving file meta-data");
+  // records written by PyTorchStreamWriter are stored and aligned, so they can
+  // be used in place
+  if (stat.m_method == 0 && stat.m_comp_size == stat.m_uncomp_size &&
+      stat.m_uncomp_size > 0) {
+    size_t offset = getDataOffset(stat.m_local_header_ofs);
+    if (offset % kFieldAlignment == 0) {
+      at::DataPtr mapped = in_->map(offset, stat.m_uncomp_size);
+      if (mapped) {
+        return std::make_tuple(std::move(mapped), stat.m_uncomp_size);
+      }
+    }
+  }
   void * ptr = malloc(stat.m_uncomp_size);
   mz_zip_reader_extract_to_mem(ar_.get(), key, ptr, stat.m_uncomp_size, 0);
   valid("reading file");
@@ -190,23 +207,24 @@ std::tuple<at::DataPtr, size_t> PyTorchStreamReader::getRecord(const std::string
   return std::make_tuple(std::move(retval), stat.m_uncomp_size);
 }
 
-static int64_t read_le_16(uint8_t* buf) {
-  return buf[0] + (buf[1] << 8);
-}
-
-size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
-  mz_zip_archive_file_stat stat;
-  mz_zip_reader_file_stat(ar_.get(), getFileID(name), &stat);
-  valid("retriving file meta-data");
+size_t PyTorchStreamReader::getDataOffset(uint64_t local_header_offset) {
   uint8_t local_header[MZ_ZIP_LOCAL_DIR_HEADER_SIZE];
   in_->read(
-      stat.m_local_header_ofs,
+      local_header_offset,
       local_header,
       MZ_ZIP_LOCAL_DIR_HEADER_SIZE,
       "reading file header");
   size_t filename_len = read_le_16(local_header + MZ_ZIP_LDH_FILENAME_LEN_OFS);
   size_t extra_len = read_le_16(local_header + MZ_ZIP_LDH_EXTRA_LEN_OFS);
-  return stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+  return local_header_offset + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
+}
+
+size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
+  std::lock_guard<std::mutex> guard(reader_lock_);
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), getFileID(name), &stat);
+  valid("retriving file meta-data");
+  return getDataOffset(stat.m_local_header_ofs);
 }
 
 
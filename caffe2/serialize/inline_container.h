@@ -4,6 +4,7 @@
 #include <cstring>
 #include <cerrno>
 #include <istream>
+#include <mutex>
 #include <ostream>
 #include <fstream>
 
@@ -105,6 +106,8 @@ class CAFFE2_API PyTorchStreamReader final {
   explicit PyTorchStreamReader(std::unique_ptr<ReadAdapterInterface> in);
 
   // return dataptr, size
+  // Uncompressed records are not copied when the reader adapter can map them
+  // (see ReadAdapterInterface::map). Safe to call from multiple threads.
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
 
   size_t getRecordOffset(const std::string& name);
@@ -116,12 +119,15 @@ class CAFFE2_API PyTorchStreamReader final {
   size_t read(uint64_t pos, char* buf, size_t n);
   void valid(const char* what);
   size_t getFileID(const std::string& name);
+  size_t getDataOffset(uint64_t local_header_offset);
 
   friend size_t
   istream_read_func(void* pOpaque, uint64_t file_ofs, void* pBuf, size_t n);
   std::unique_ptr<mz_zip_archive> ar_;
   std::string archive_name_;
   std::unique_ptr<ReadAdapterInterface> in_;
+  // the zip archive isn't safe to access concurrently
+  std::mutex reader_lock_;
 };
 
 class CAFFE2_API PyTorchStreamWriter final {
@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 
+#include "caffe2/serialize/file_adapter.h"
 #include "caffe2/serialize/inline_container.h"
 
 namespace caffe2 {
@@ -58,6 +59,41 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+#ifndef _WIN32
+TEST(PyTorchStreamWriterAndReader, LoadMappedFile) {
+  std::array<char, 127> data;
+  for (int i = 0; i < data.size(); ++i) {
+    data[i] = data.size() - i;
+  }
+  {
+    PyTorchStreamWriter writer("mapped.zip");
+    writer.writeRecord("key1", data.data(), data.size());
+    writer.writeEndOfFile();
+  }
+
+  at::DataPtr data_ptr;
+  int64_t size;
+  {
+    PyTorchStreamReader reader(
+        caffe2::make_unique<FileAdapter>("mapped.zip", /*use_mmap=*/true));
+    std::tie(data_ptr, size) = reader.getRecord("key1");
+  }
+  // the record points into the mapping, which outlives the reader
+  ASSERT_NE(data_ptr.get(), data_ptr.get_context());
+  ASSERT_EQ(size, data.size());
+  ASSERT_EQ(memcmp(data_ptr.get(), data.data(), data.size()), 0);
+
+  // the mapping is private, so writes don't reach the file
+  static_cast<char*>(data_ptr.get())[0] = 0;
+  PyTorchStreamReader reader(
+      caffe2::make_unique<FileAdapter>("mapped.zip", /*use_mmap=*/false));
+  std::tie(data_ptr, size) = reader.getRecord("key1");
+  ASSERT_EQ(data_ptr.get(), data_ptr.get_context());
+  ASSERT_EQ(memcmp(data_ptr.get(), data.data(), data.size()), 0);
+  std::remove("mapped.zip");
+}
+#endif
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "c10/core/Allocator.h"
 #include "c10/macros/Macros.h"
 
 namespace caffe2 {
@@ -16,6 +17,10 @@ class CAFFE2_API ReadAdapterInterface {
   virtual size_t size() const = 0;
   virtual size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
       const = 0;
+  // Returns n bytes at pos without copying them, sharing the memory of the
+  // underlying source, or an empty DataPtr when the source can't be mapped.
+  // The default implementation never maps.
+  virtual at::DataPtr map(uint64_t pos, size_t n) const;
   virtual ~ReadAdapterInterface();
 };
 
@@ -2,6 +2,8 @@
 #include "WorkersPool.h"
 #include "caffe2/core/logging.h"
 
+#include <algorithm>
+
 #include <cpuinfo.h>
 
 C10_DEFINE_bool(
@@ -15,12 +17,53 @@ C10_DEFINE_int(caffe2_threadpool_android_cap, true, "");
 // Whether or not threadpool caps apply to iOS
 C10_DEFINE_int(caffe2_threadpool_ios_cap, true, "");
 
+C10_DEFINE_int(
+    caffe2_threadpool_chunks_per_thread,
+    4,
+    "The number of chunks per thread the range of a ThreadPool::run is split "
+    "into; threads that are done with a chunk claim the next one");
+
+C10_DEFINE_bool(
+    caffe2_threadpool_pin_big_cores,
+    false,
+    "On big.LITTLE CPUs, pin the threadpool workers to the fastest cores and "
+    "use at most one thread per fast core");
+
 namespace caffe2 {
 
 // Default smallest amount of work that will be partitioned between
 // multiple threads; the runtime value is configurable
 constexpr size_t kDefaultMinWorkSize = 1;
 
+namespace {
+
+// The Linux ids of the processors of the cores with the highest frequency, or
+// nothing if all the cores run at the same frequency (or it is unknown).
+std::vector<int> bigCoreProcessors() {
+  std::vector<int> processors;
+#if defined(__linux__)
+  uint64_t maxFrequency = 0;
+  bool heterogeneous = false;
+  for (uint32_t i = 0; i < cpuinfo_get_cores_count(); ++i) {
+    const auto frequency = cpuinfo_get_core(i)->frequency;
+    heterogeneous |= i > 0 && frequency != maxFrequency;
+    maxFrequency = std::max(maxFrequency, frequency);
+  }
+  if (!heterogeneous || maxFrequency == 0) {
+    return processors;
+  }
+  for (uint32_t i = 0; i < cpuinfo_get_processors_count(); ++i) {
+    const auto* processor = cpuinfo_get_processor(i);
+    if (processor->core->frequency == maxFrequency) {
+      processors.push_back(processor->linux_id);
+    }
+  }
+#endif
+  return processors;
+}
+
+} // namespace
+
 std::unique_ptr<ThreadPool> ThreadPool::defaultThreadPool() {
   CAFFE_ENFORCE(cpuinfo_initialize(), "cpuinfo initialization failed");
   int numThreads = cpuinfo_get_processors_count();
@@ -73,13 +116,23 @@ std::unique_ptr<ThreadPool> ThreadPool::defaultThreadPool() {
         break;
     }
   }
+  std::vector<int> workerCpus;
+  if (FLAGS_caffe2_threadpool_pin_big_cores) {
+    workerCpus = bigCoreProcessors();
+    if (!workerCpus.empty()) {
+      // The calling thread runs a share of the work too, and isn't pinned.
+      numThreads = std::min<int>(numThreads, workerCpus.size());
+      LOG(INFO) << "Pinning thread pool workers to " << workerCpus.size()
+                << " big cores";
+    }
+  }
   LOG(INFO) << "Constructing thread pool with " << numThreads << " threads";
-  return caffe2::make_unique<ThreadPool>(numThreads);
+  return caffe2::make_unique<ThreadPool>(numThreads, std::move(workerCpus));
 }
 
-ThreadPool::ThreadPool(int numThreads)
+ThreadPool::ThreadPool(int numThreads, std::vector<int> workerCpus)
     : minWorkSize_(kDefaultMinWorkSize), numThreads_(numThreads),
-      workersPool_(std::make_shared<WorkersPool>()) {}
+      workersPool_(std::make_shared<WorkersPool>(std::move(workerCpus))) {}
 
 ThreadPool::~ThreadPool() {}
 
@@ -116,35 +169,43 @@ void ThreadPool::run(const std::function<void(int, size_t)>& fn, size_t range) {
     ~FnTask() override{};
     const std::function<void(int, size_t)> *fn_;
     int idx_;
-    size_t start_;
-    size_t end_;
+    std::atomic<size_t>* nextChunk_;
+    size_t chunkSize_;
+    size_t range_;
     void Run() override {
-      for (auto i = start_; i < end_; ++i) {
-        (*fn_)(idx_, i);
+      while (true) {
+        const auto start =
+            nextChunk_->fetch_add(chunkSize_, std::memory_order_relaxed);
+        if (start >= range_) {
+          return;
+        }
+        const auto end = std::min(range_, start + chunkSize_);
+        for (auto i = start; i < end; ++i) {
+          (*fn_)(idx_, i);
+        }
       }
     }
   };
 
   CAFFE_ENFORCE_GE(numThreads_, 1);
-  const size_t unitsPerTask = (range + numThreads_ - 1) / numThreads_;
-  tasks_.resize(numThreads_);
-  for (size_t i = 0; i < numThreads_; ++i) {
+  const size_t numTasks = std::min(numThreads_, range);
+  const size_t chunksPerTask =
+      std::max(FLAGS_caffe2_threadpool_chunks_per_thread, 1);
+  const size_t chunkSize =
+      std::max<size_t>(1, range / (numTasks * chunksPerTask));
+  nextChunk_.store(0, std::memory_order_relaxed);
+  tasks_.resize(numTasks);
+  for (size_t i = 0; i < numTasks; ++i) {
     if (!tasks_[i]) {
       tasks_[i].reset(new FnTask());
     }
     auto *task = (FnTask *)tasks_[i].get();
     task->fn_ = &fn;
     task->idx_ = i;
-    task->start_ = std::min<size_t>(range, i * unitsPerTask);
-    task->end_ = std::min<size_t>(range, (i + 1) * unitsPerTask);
-    if (task->start_ >= task->end_) {
-      tasks_.resize(i);
-      break;
-    }
-    CAFFE_ENFORCE_LE(task->start_, range);
-    CAFFE_ENFORCE_LE(task->end_, range);
+    task->nextChunk_ = &nextChunk_;
+    task->chunkSize_ = chunkSize;
+    task->range_ = range;
   }
-  CAFFE_ENFORCE_LE(tasks_.size(), numThreads_);
   CAFFE_ENFORCE_GE(tasks_.size(), 1);
   workersPool_->Execute(tasks_);
 }
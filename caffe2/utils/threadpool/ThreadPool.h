@@ -3,6 +3,7 @@
 
 #include "ThreadPoolCommon.h"
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -32,7 +33,8 @@ constexpr size_t kCacheLineSize = 64;
 class CAFFE2_API /*alignas(kCacheLineSize)*/ ThreadPool {
  public:
   static std::unique_ptr<ThreadPool> defaultThreadPool();
-  ThreadPool(int numThreads);
+  // If workerCpus isn't empty, the worker threads only run on these cores.
+  ThreadPool(int numThreads, std::vector<int> workerCpus = {});
   ~ThreadPool();
   // Returns the number of threads currently in use
   int getNumThreads() const;
@@ -42,6 +44,10 @@ class CAFFE2_API /*alignas(kCacheLineSize)*/ ThreadPool {
   // main (calling) thread
   void setMinWorkSize(size_t size);
   size_t getMinWorkSize() const { return minWorkSize_; }
+
+  // Runs fn(threadId, i) for every i in [0, range). The threads claim chunks
+  // of the range as they go, rather than being handed an equal share up
+  // front, so that faster (or less loaded) cores do more of the work.
   void run(const std::function<void(int, size_t)>& fn, size_t range);
 
   // Run an arbitrary function in a thread-safe manner accessing the Workers
@@ -54,6 +60,8 @@ class CAFFE2_API /*alignas(kCacheLineSize)*/ ThreadPool {
   size_t numThreads_;
   std::shared_ptr<WorkersPool> workersPool_;
   std::vector<std::shared_ptr<Task>> tasks_;
+  // The start of the next chunk of the range to be claimed by a task.
+  std::atomic<size_t> nextChunk_{0};
 };
 
 } // namespace caffe2
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <thread>
+#include <vector>
 #include "c10/util/thread_name.h"
 #include "caffe2/core/common.h"
 #include "caffe2/core/logging.h"
@@ -11,6 +13,10 @@
 #include <intrin.h>
 #endif
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 namespace caffe2 {
 
 // Uses code derived from gemmlowp,
@@ -24,6 +30,8 @@ namespace caffe2 {
 // - cache-line align Worker.
 // - use std::atomic instead of volatile and custom barriers.
 // - use std::mutex/std::condition_variable instead of raw pthreads.
+// - adapt the busy-waiting of each worker to how long it waits for work.
+// - optionally pin the workers to a set of cores.
 
 constexpr size_t kGEMMLOWPCacheLineSize = 64;
 
@@ -79,6 +87,8 @@ struct MakeAligned {
 };
 
 const int kMaxBusyWaitNOPs = 32 * 1000 * 1000;
+// The least a worker busy-waits for work, however long it usually waits.
+const int kMinBusyWaitNOPs = 16 * 1000;
 
 #if defined(_MSC_VER)
 #define GEMMLOWP_NOP __nop();
@@ -116,9 +126,15 @@ inline int Do256NOPs() {
 // still the value of *var when this function returns, since *var is
 // not assumed to be guarded by any lock.
 //
-// First does some busy-waiting for a fixed number of no-op cycles,
-// then falls back to passive waiting for the given condvar, guarded
-// by the given mutex.
+// First does some busy-waiting for a number of no-op cycles, then falls
+// back to passive waiting for the given condvar, guarded by the given mutex.
+//
+// If busy_wait_nops is given, it is the number of no-op cycles to busy-wait
+// for, and it adapts to how long the waits are: it is doubled (up to
+// kMaxBusyWaitNOPs) when the variable changes while busy-waiting, and halved
+// (down to kMinBusyWaitNOPs) when it falls back to passive waiting. A thread
+// waiting for sparse work thus soon stops burning cycles (and battery) in
+// every wait, while a thread given work in quick succession keeps spinning.
 //
 // The idea of doing some initial busy-waiting is to help get
 // better and more consistent multithreading benefits for small GEMM sizes.
@@ -133,9 +149,11 @@ template <typename T>
 T WaitForVariableChange(std::atomic<T>* var,
                         T initial_value,
                         std::condition_variable* cond,
-                        std::mutex* mutex) {
+                        std::mutex* mutex,
+                        int* busy_wait_nops = nullptr) {
   // If we are on a platform that supports it, spin for some time.
   {
+    const int max_nops = busy_wait_nops ? *busy_wait_nops : kMaxBusyWaitNOPs;
     int nops = 0;
     // First, trivial case where the variable already changed value.
     T new_value = var->load(std::memory_order_relaxed);
@@ -144,14 +162,20 @@ T WaitForVariableChange(std::atomic<T>* var,
       return new_value;
     }
     // Then try busy-waiting.
-    while (nops < kMaxBusyWaitNOPs) {
+    while (nops < max_nops) {
       nops += Do256NOPs();
       new_value = var->load(std::memory_order_relaxed);
       if (new_value != initial_value) {
         std::atomic_thread_fence(std::memory_order_acquire);
+        if (busy_wait_nops) {
+          *busy_wait_nops = std::min(kMaxBusyWaitNOPs / 2, max_nops) * 2;
+        }
         return new_value;
       }
     }
+    if (busy_wait_nops) {
+      *busy_wait_nops = std::max(kMinBusyWaitNOPs, max_nops / 2);
+    }
   }
 
   // Finally, do real passive waiting.
@@ -227,10 +251,15 @@ class alignas(kGEMMLOWPCacheLineSize) Worker {
     ExitAsSoonAsPossible // Should exit at earliest convenience.
   };
 
-  explicit Worker(BlockingCounter* counter_to_decrement_when_ready)
+  // If cpus isn't empty, the worker thread only runs on these cores (on
+  // Linux and Android, elsewhere it is ignored).
+  Worker(
+      BlockingCounter* counter_to_decrement_when_ready,
+      const std::vector<int>& cpus = {})
       : task_(nullptr),
         state_(State::ThreadStartup),
-        counter_to_decrement_when_ready_(counter_to_decrement_when_ready) {
+        counter_to_decrement_when_ready_(counter_to_decrement_when_ready),
+        cpus_(cpus) {
     thread_ = caffe2::make_unique<std::thread>([this]() { this->ThreadFunc(); });
   }
 
@@ -268,6 +297,7 @@ class alignas(kGEMMLOWPCacheLineSize) Worker {
   // Thread entry point.
   void ThreadFunc() {
     c10::setThreadName("CaffeWorkersPool");
+    SetAffinity();
     ChangeState(State::Ready);
 
     // Thread main loop
@@ -275,8 +305,8 @@ class alignas(kGEMMLOWPCacheLineSize) Worker {
       // Get a state to act on
       // In the 'Ready' state, we have nothing to do but to wait until
       // we switch to another state.
-      State state_to_act_upon =
-          WaitForVariableChange(&state_, State::Ready, &state_cond_, &state_mutex_);
+      State state_to_act_upon = WaitForVariableChange(
+          &state_, State::Ready, &state_cond_, &state_mutex_, &busy_wait_nops_);
 
       // We now have a state to act on, so act.
       switch (state_to_act_upon) {
@@ -310,6 +340,23 @@ class alignas(kGEMMLOWPCacheLineSize) Worker {
   }
 
  private:
+  void SetAffinity() {
+#if defined(__linux__)
+    if (cpus_.empty()) {
+      return;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpus_) {
+      CPU_SET(cpu, &cpu_set);
+    }
+    // A failure (e.g. the cores went offline) leaves the thread unpinned.
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      LOG(WARNING) << "Failed to set the affinity of a WorkersPool thread";
+    }
+#endif
+  }
+
   // The underlying thread.
   std::unique_ptr<std::thread> thread_;
 
@@ -326,11 +373,19 @@ class alignas(kGEMMLOWPCacheLineSize) Worker {
   // pointer to the master's thread BlockingCounter object, to notify the
   // master thread of when this worker switches to the 'Ready' state.
   BlockingCounter* const counter_to_decrement_when_ready_;
+
+  // The cores the thread runs on, or empty for any core.
+  const std::vector<int> cpus_;
+
+  // How long the thread busy-waits for work before sleeping; only used by
+  // the worker thread.
+  int busy_wait_nops_{kMaxBusyWaitNOPs};
 };
 
 class WorkersPool {
  public:
-  WorkersPool() {}
+  // If cpus isn't empty, the workers only run on these cores.
+  explicit WorkersPool(std::vector<int> cpus = {}) : cpus_(std::move(cpus)) {}
 
   void Execute(const std::vector<std::shared_ptr<Task>>& tasks) {
     CAFFE_ENFORCE_GE(tasks.size(), 1);
@@ -359,12 +414,14 @@ class WorkersPool {
     }
     counter_to_decrement_when_ready_.Reset(workers_count - workers_.size());
     while (workers_.size() < workers_count) {
-      workers_.push_back(MakeAligned<Worker>::make(&counter_to_decrement_when_ready_));
+      workers_.push_back(MakeAligned<Worker>::make(
+          &counter_to_decrement_when_ready_, cpus_));
     }
     counter_to_decrement_when_ready_.Wait();
   }
 
   C10_DISABLE_COPY_AND_ASSIGN(WorkersPool);
+  const std::vector<int> cpus_;
   std::vector<std::unique_ptr<Worker, AlignedDeleter<Worker>>> workers_;
   // The BlockingCounter used to wait for the workers.
   BlockingCounter counter_to_decrement_when_ready_;
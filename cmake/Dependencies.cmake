@@ -718,6 +718,17 @@ if(USE_MPI)
   endif()
 endif()
 
+# ---[ ATen parallel backend
+set(AT_PARALLEL_OPENMP 0)
+set(AT_PARALLEL_NATIVE 0)
+if(ATEN_THREADING STREQUAL "OMP")
+  set(AT_PARALLEL_OPENMP 1)
+elseif(ATEN_THREADING STREQUAL "NATIVE")
+  set(AT_PARALLEL_NATIVE 1)
+else()
+  message(FATAL_ERROR "Unknown ATen parallel backend: ${ATEN_THREADING}")
+endif()
+
 # ---[ OpenMP
 if(USE_OPENMP)
   # OpenMP support?
@@ -1007,6 +1018,7 @@ if (USE_ZSTD)
   include_directories(SYSTEM ${CMAKE_CURRENT_LIST_DIR}/../third_party/zstd/lib)
   add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/../third_party/zstd/build/cmake)
   set_property(TARGET libzstd_static PROPERTY POSITION_INDEPENDENT_CODE ON)
+  set(CAFFE2_USE_ZSTD 1)
 endif()
 
 # ---[ Onnx
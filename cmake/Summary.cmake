@@ -114,6 +114,7 @@ function (caffe2_print_configuration_summary)
     message(STATUS "    OpenCV version      : ${OpenCV_VERSION}")
   endif()
   message(STATUS "  USE_OPENMP            : ${USE_OPENMP}")
+  message(STATUS "  ATEN_THREADING        : ${ATEN_THREADING}")
   message(STATUS "  USE_PROF              : ${USE_PROF}")
   message(STATUS "  USE_QNNPACK           : ${USE_QNNPACK}")
   message(STATUS "  USE_REDIS             : ${USE_REDIS}")
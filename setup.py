@@ -70,6 +70,10 @@
 #   USE_OPENMP=0
 #     disables use of OpenMP for parallelization
 #
+#   ATEN_THREADING
+#     intra-op parallel backend for ATen, OMP (OpenMP, the default) or
+#     NATIVE (work-stealing scheduler on top of c10::ThreadPool)
+#
 #   USE_FFMPEG
 #     enables use of ffmpeg for additional operators
 #
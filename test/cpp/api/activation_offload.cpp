@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/cuda/activation_offload.h>
+#include <torch/nn/modules/functional.h>
+#include <torch/nn/modules/linear.h>
+#include <torch/nn/modules/sequential.h>
+#include <torch/types.h>
+#include <torch/utils.h>
+
+#include <test/cpp/api/support.h>
+
+#include <vector>
+
+struct ActivationOffloadTest : torch::test::SeedingFixture {};
+
+TEST_F(ActivationOffloadTest, MatchesTheGradientsWithoutOffloading_CUDA) {
+  torch::nn::Sequential model(
+      torch::nn::Linear(64, 256),
+      torch::nn::Functional(torch::tanh),
+      torch::nn::Linear(256, 256),
+      torch::nn::Functional(torch::sigmoid),
+      torch::nn::Linear(256, 8));
+  model->to(torch::kCUDA);
+  const auto input = torch::randn({32, 64}, torch::kCUDA);
+
+  std::vector<std::vector<torch::Tensor>> grads;
+  for (bool offload : {false, true}) {
+    model->zero_grad();
+    torch::cuda::ActivationOffloadOptions options;
+    options.min_bytes = 1024;
+    torch::cuda::ActivationOffloader offloader(options);
+    torch::Tensor output;
+    {
+      torch::autograd::SavedTensorHooksGuard guard(
+          offload ? &offloader : nullptr);
+      output = model->forward(input);
+    }
+    // The parameters and the small tensors stay on the device.
+    ASSERT_EQ(offloader.num_offloaded() > 0, offload);
+    output.pow(2).sum().backward();
+    grads.emplace_back();
+    for (const auto& parameter : model->parameters()) {
+      grads.back().push_back(parameter.grad().clone());
+    }
+  }
+  for (size_t i = 0; i < grads[0].size(); ++i) {
+    ASSERT_TRUE(grads[1][i].allclose(grads[0][i]));
+  }
+}
+
+TEST_F(ActivationOffloadTest, SkipsCPUAndSmallTensors_CUDA) {
+  torch::cuda::ActivationOffloadOptions options;
+  options.min_bytes = 4096;
+  torch::cuda::ActivationOffloader offloader(options);
+  auto small = torch::randn({16}, torch::device(torch::kCUDA).requires_grad(true));
+  auto cpu = torch::randn({4096}, torch::requires_grad());
+  {
+    torch::autograd::SavedTensorHooksGuard guard(&offloader);
+    (small * 2).exp().sum().backward();
+    cpu.exp().sum().backward();
+  }
+  ASSERT_EQ(offloader.num_offloaded(), 0u);
+}
@@ -8,9 +8,11 @@
 #include <test/cpp/api/support.h>
 
 #include <c10/util/ArrayRef.h>
+#include <c10/util/tempfile.h>
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <iterator>
@@ -219,6 +221,65 @@ TEST(DataTest, OrderedSequencerReOrdersValues) {
   }
 }
 
+TEST(DataTest, WindowedSequencerReturnsResultsWithinTheWindow) {
+  using namespace torch::data::detail::sequencers; // NOLINT
+  struct S {
+    size_t sequence_number;
+  };
+  const size_t kWindow = 2;
+  const size_t kMaxJobs = 4;
+  WindowedSequencer<S> sequencer(kWindow, kMaxJobs);
+
+  std::vector<size_t> v = {1, 3, 2, 0, 4, 5};
+  size_t index = 0;
+  auto getter = [&v, &index]() -> torch::optional<S> {
+    if (index == v.size()) {
+      return torch::nullopt;
+    }
+    return S{v.at(index++)};
+  };
+
+  // 1 is within [0, 2), so it is returned right away.
+  ASSERT_EQ(sequencer.next(getter).value().sequence_number, 1);
+  ASSERT_EQ(index, 1);
+  // 3 and 2 are too far ahead of 0 and get buffered, 0 is returned.
+  ASSERT_EQ(sequencer.next(getter).value().sequence_number, 0);
+  ASSERT_EQ(index, 4);
+  // Now the window is [2, 4), which holds both buffered results.
+  ASSERT_EQ(sequencer.next(getter).value().sequence_number, 2);
+  ASSERT_EQ(sequencer.next(getter).value().sequence_number, 3);
+  ASSERT_EQ(index, 4);
+  ASSERT_EQ(sequencer.next(getter).value().sequence_number, 4);
+  ASSERT_EQ(sequencer.next(getter).value().sequence_number, 5);
+  ASSERT_FALSE(sequencer.next(getter).has_value());
+}
+
+TEST(DataTest, WindowedSequencerWithWindowOfOneIsOrdered) {
+  using namespace torch::data::detail::sequencers; // NOLINT
+  struct S {
+    size_t sequence_number;
+  };
+  const size_t kMaxJobs = 5;
+  WindowedSequencer<S> sequencer(/*window=*/1, kMaxJobs);
+
+  std::vector<size_t> v = {4, 2, 0, 3, 1};
+  size_t index = 0;
+  auto getter = [&v, &index]() { return S{v.at(index++)}; };
+  for (size_t i = 0; i < v.size(); ++i) {
+    ASSERT_EQ(sequencer.next(getter).value().sequence_number, i);
+  }
+}
+
+TEST(DataTest, WindowedSequencerThrowsForEmptyWindow) {
+  using namespace torch::data::detail::sequencers; // NOLINT
+  struct S {
+    size_t sequence_number;
+  };
+  ASSERT_THROWS_WITH(
+      WindowedSequencer<S>(/*window=*/0, /*max_jobs=*/2),
+      "The reorder window must be at least one");
+}
+
 TEST(DataTest, BatchLambdaAppliesFunctionToBatch) {
   using InputBatch = std::vector<int>;
   using OutputBatch = std::string;
@@ -442,6 +503,80 @@ TEST(DataTest, TensorDatasetConstructsFromInitializerListOfTensors) {
       torch::tensor({0, 0, 1, 0, 0}, torch::kFloat32).allclose(dataset.get(2)));
 }
 
+TEST(DataTest, MMapTensorDatasetRoundTrips) {
+  auto tempfile = c10::make_tempfile();
+  auto features = torch::randn({10, 3, 2});
+  auto labels = torch::arange(10, torch::kLong);
+  datasets::MMapTensorDataset::write(
+      tempfile.name, {"features", "labels"}, {features, labels});
+
+  datasets::MMapTensorDataset dataset(tempfile.name);
+  ASSERT_EQ(dataset.size().value(), 10);
+  ASSERT_EQ(
+      dataset.column_names(),
+      std::vector<std::string>({"features", "labels"}));
+  ASSERT_TRUE(dataset.column("features").equal(features));
+  ASSERT_TRUE(dataset.column("labels").equal(labels));
+  ASSERT_THROWS_WITH(dataset.column("weights"), "No column named 'weights'");
+}
+
+TEST(DataTest, MMapTensorDatasetReturnsViewsForContiguousRows) {
+  auto tempfile = c10::make_tempfile();
+  auto features = torch::randn({10, 4});
+  datasets::MMapTensorDataset::write(tempfile.name, {"features"}, {features});
+  datasets::MMapTensorDataset dataset(tempfile.name);
+
+  auto batch = dataset.get_batch({3, 4, 5});
+  ASSERT_EQ(batch.size(), 1);
+  ASSERT_TRUE(batch[0].equal(features.narrow(0, 3, 3)));
+  const auto& column = dataset.column("features");
+  ASSERT_EQ(
+      batch[0].data<float>(), column.data<float>() + 3 * column.size(1));
+
+  batch = dataset.get_batch({7, 2, 2, 9});
+  ASSERT_TRUE(batch[0].equal(
+      features.index_select(0, torch::tensor({7, 2, 2, 9}, torch::kLong))));
+
+  ASSERT_THROWS_WITH(dataset.get_batch({1, 10}), "Index 10 is out of range");
+}
+
+TEST(DataTest, MMapTensorDatasetWorksWithDataLoader) {
+  auto tempfile = c10::make_tempfile();
+  datasets::MMapTensorDataset::write(
+      tempfile.name, {"values"}, {torch::arange(20, torch::kLong)});
+  auto data_loader = torch::data::make_data_loader(
+      datasets::MMapTensorDataset(tempfile.name),
+      samplers::SequentialSampler(20),
+      DataLoaderOptions(8).workers(2));
+  int64_t expected = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_EQ(batch.size(), 1);
+    for (int64_t i = 0; i < batch[0].numel(); ++i) {
+      ASSERT_EQ(batch[0][i].item<int64_t>(), expected++);
+    }
+  }
+  ASSERT_EQ(expected, 20);
+}
+
+TEST(DataTest, MMapTensorDatasetRejectsInvalidInput) {
+  auto tempfile = c10::make_tempfile();
+  ASSERT_THROWS_WITH(
+      datasets::MMapTensorDataset::write(
+          tempfile.name, {"a", "b"}, {torch::ones(3), torch::ones(4)}),
+      "All columns must have the same number of rows");
+  ASSERT_THROWS_WITH(
+      datasets::MMapTensorDataset::write(
+          tempfile.name, {"a", "a"}, {torch::ones(3), torch::ones(3)}),
+      "Duplicate column name 'a'");
+  {
+    std::ofstream stream(tempfile.name, std::ios::binary);
+    stream << "not a dataset";
+  }
+  ASSERT_THROWS_WITH(
+      datasets::MMapTensorDataset(tempfile.name),
+      "is not a MMapTensorDataset file");
+}
+
 TEST(DataTest, StackTransformWorksForExample) {
   struct D : public datasets::Dataset<D> {
     Example<> get(size_t index) override {
@@ -477,6 +612,96 @@ TEST(DataTest, StackTransformWorksForTensorExample) {
   ASSERT_TRUE(second.data.allclose(torch::eye(4).slice(/*dim=*/0, 2, 4)));
 }
 
+// A tensor-backed dataset that counts how often `get()` is called.
+struct StackableDataset : datasets::Dataset<StackableDataset> {
+  Example<> get(size_t index) override {
+    ++*gets;
+    return {data[index], target[index]};
+  }
+
+  Example<> get_stacked_batch(
+      torch::ArrayRef<size_t> indices,
+      bool pin_memory = false) {
+    return {datasets::detail::gather_rows(data, indices, pin_memory),
+            datasets::detail::gather_rows(target, indices, pin_memory)};
+  }
+
+  torch::optional<size_t> size() const override {
+    return data.size(0);
+  }
+
+  torch::Tensor data{torch::arange(16, torch::kFloat32).view({4, 1, 2, 2})};
+  torch::Tensor target{torch::arange(4, torch::kLong)};
+  std::shared_ptr<size_t> gets = std::make_shared<size_t>(0);
+};
+
+TEST(DataTest, TensorDatasetGathersStackedBatches) {
+  datasets::TensorDataset dataset(torch::arange(12).view({6, 2}));
+
+  auto batch = dataset.get_stacked_batch({2, 3, 4});
+  ASSERT_TRUE(batch.data.equal(dataset.tensor.narrow(0, 2, 3)));
+  // Consecutive rows are returned as a view.
+  ASSERT_EQ(batch.data.data_ptr(), dataset.tensor[2].data_ptr());
+
+  batch = dataset.get_stacked_batch({5, 0, 5});
+  ASSERT_TRUE(batch.data.equal(torch::stack(
+      {dataset.tensor[5], dataset.tensor[0], dataset.tensor[5]})));
+
+  ASSERT_THROWS_WITH(
+      dataset.get_stacked_batch({6}),
+      "Index 6 is out of range for a dataset of 6 rows");
+}
+
+TEST(DataTest, StackTransformGathersStackedBatchesDirectly) {
+  StackableDataset source;
+  auto d = source.map(transforms::Stack<>());
+
+  Example<> batch = d.get_batch({3, 1});
+  ASSERT_EQ(*source.gets, 0);
+  ASSERT_TRUE(batch.data.equal(torch::stack({source.data[3], source.data[1]})));
+  ASSERT_TRUE(batch.target.equal(torch::tensor({3, 1}, torch::kLong)));
+}
+
+TEST(DataTest, BatchwiseTransformsAreAppliedToStackedBatches) {
+  StackableDataset source;
+  auto d = source.map(transforms::Normalize<>(0.5, 0.25))
+               .map(transforms::Stack<>());
+
+  Example<> batch = d.get_batch({0, 2});
+  ASSERT_EQ(*source.gets, 0);
+  auto data = source.data;
+  ASSERT_TRUE(batch.data.allclose(
+      torch::stack({data[0], data[2]}).sub(0.5).div(0.25)));
+  ASSERT_TRUE(batch.target.equal(torch::tensor({0, 2}, torch::kLong)));
+}
+
+TEST(DataTest, NonBatchwiseTransformsAreAppliedPerExample) {
+  StackableDataset source;
+  auto d = source
+               .map(transforms::TensorLambda<>(
+                   [](torch::Tensor input) { return input * 2; }))
+               .map(transforms::Stack<>());
+
+  Example<> batch = d.get_batch({0, 1});
+  ASSERT_EQ(*source.gets, 2);
+  auto data = source.data;
+  ASSERT_TRUE(batch.data.allclose(torch::stack({data[0], data[1]}) * 2));
+}
+
+TEST(DataTest, StackTransformPinsStackedBatches_CUDA) {
+  auto d = StackableDataset().map(transforms::Stack<>(/*pin_memory=*/true));
+  Example<> batch = d.get_batch({1, 2});
+  ASSERT_TRUE(batch.data.device().is_cpu());
+  ASSERT_TRUE(batch.data.equal(StackableDataset().data.narrow(0, 1, 2)));
+  auto cuda = batch.data.to(torch::kCUDA, /*non_blocking=*/true);
+  ASSERT_TRUE(cuda.cpu().equal(batch.data));
+
+  auto gathered = datasets::TensorDataset(torch::eye(3))
+                         .map(transforms::Stack<TensorExample>(true));
+  ASSERT_TRUE(gathered.get_batch({0, 1}).data.equal(
+      torch::eye(3).narrow(0, 0, 2)));
+}
+
 // Template classes cannot be nested in functions.
 template <typename Target>
 struct T : transforms::TensorTransform<Target> {
@@ -680,6 +905,50 @@ TEST(DataTest, QueueClearEmptiesTheQueue) {
   ASSERT_THROWS_WITH(queue.pop(1 * kMillisecond), "Timeout");
 }
 
+TEST(DataTest, WorkStealingQueuePopsOwnDequeFirst) {
+  torch::data::detail::WorkStealingQueue<int> queue(/*consumers=*/2);
+  // Values are distributed round-robin over the two deques.
+  queue.push(1);
+  queue.push(2);
+  queue.push(3);
+  queue.push(4);
+  ASSERT_EQ(queue.pop(1), 2);
+  ASSERT_EQ(queue.pop(1), 4);
+  // The deque of consumer 1 is empty now, so it steals from consumer 0.
+  ASSERT_EQ(queue.pop(1), 1);
+  ASSERT_EQ(queue.pop(0), 3);
+}
+
+TEST(DataTest, WorkStealingQueueConsumersBlockUntilPush) {
+  torch::data::detail::WorkStealingQueue<int> queue(/*consumers=*/4);
+  std::vector<std::future<int>> futures;
+  for (size_t c = 0; c < queue.consumers(); ++c) {
+    futures.push_back(
+        std::async(std::launch::async, [&queue, c] { return queue.pop(c); }));
+  }
+  std::this_thread::sleep_for(20 * kMillisecond);
+  for (int i = 0; i < 4; ++i) {
+    queue.push(i);
+  }
+  std::vector<int> values;
+  for (auto& future : futures) {
+    values.push_back(future.get());
+  }
+  std::sort(values.begin(), values.end());
+  ASSERT_EQ(values, std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST(DataTest, WorkStealingQueueClearEmptiesAllDeques) {
+  torch::data::detail::WorkStealingQueue<int> queue(/*consumers=*/3);
+  for (int i = 0; i < 5; ++i) {
+    queue.push(i);
+  }
+  ASSERT_EQ(queue.clear(), 5);
+  ASSERT_EQ(queue.clear(), 0);
+  queue.push(7);
+  ASSERT_EQ(queue.pop(2), 7);
+}
+
 TEST(DataTest, DataShuttleCanPushAndPopJob) {
   torch::data::detail::DataShuttle<int, int> shuttle;
   shuttle.push_job(1);
@@ -926,6 +1195,85 @@ TEST(DataTest, CanSaveAndLoadDistributedRandomSampler) {
   }
 }
 
+TEST(DataTest, DistributedFeistelSamplerSingleReplicaProduceCorrectSamples) {
+  for (size_t sample_count : {1, 2, 10, 17, 1000}) {
+    samplers::DistributedFeistelSampler dfs(sample_count);
+
+    std::vector<size_t> res;
+    torch::optional<std::vector<size_t>> idx;
+    while ((idx = dfs.next(3)).has_value()) {
+      res.insert(std::end(res), std::begin(*idx), std::end(*idx));
+    }
+
+    ASSERT_EQ(res.size(), sample_count);
+
+    std::sort(res.begin(), res.end());
+    for (size_t i = 0; i < res.size(); ++i) {
+      ASSERT_EQ(res[i], i);
+    }
+  }
+}
+
+TEST(DataTest, DistributedFeistelSamplerMultiReplicaProduceCorrectSamples) {
+  size_t sample_count = 10;
+  size_t num_replicas = 3;
+
+  auto test_function = [&](bool allow_duplicates,
+                           size_t local_sample_count,
+                           std::vector<size_t>& output,
+                           size_t batch_size) {
+    std::vector<size_t> res;
+    for (size_t i = 0; i < num_replicas; ++i) {
+      samplers::DistributedFeistelSampler sampler(
+          sample_count, num_replicas, i, allow_duplicates);
+      torch::optional<std::vector<size_t>> idx;
+      while ((idx = sampler.next(batch_size)).has_value()) {
+        res.insert(std::end(res), std::begin(*idx), std::end(*idx));
+      }
+      ASSERT_EQ(res.size(), local_sample_count * (i + 1));
+    }
+    std::sort(res.begin(), res.end());
+    ASSERT_EQ(res, output);
+  };
+
+  for (size_t batch_size = 1; batch_size <= 3; ++batch_size) {
+    std::vector<size_t> output1{0, 0, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    test_function(true, 4, output1, batch_size);
+
+    // Without duplicates, the sample that is left out is random.
+    samplers::DistributedFeistelSampler sampler(sample_count, num_replicas, 0, false);
+    ASSERT_EQ(sampler.next(10)->size(), 3);
+  }
+}
+
+TEST(DataTest, DistributedFeistelSamplerShufflesPerEpoch) {
+  auto epoch_samples = [](size_t epoch, uint64_t seed) {
+    samplers::DistributedFeistelSampler sampler(100, 1, 0, true, seed);
+    sampler.set_epoch(epoch);
+    sampler.reset();
+    return *sampler.next(100);
+  };
+  ASSERT_EQ(epoch_samples(1, 0), epoch_samples(1, 0));
+  ASSERT_NE(epoch_samples(1, 0), epoch_samples(2, 0));
+  ASSERT_NE(epoch_samples(1, 0), epoch_samples(1, 1));
+}
+
+TEST(DataTest, CanSaveAndLoadDistributedFeistelSampler) {
+  samplers::DistributedFeistelSampler a(100, 2, 1, true, /*seed=*/42);
+  a.set_epoch(3);
+  a.reset();
+  a.next(7);
+  ASSERT_EQ(a.index(), 57);
+  std::stringstream stream;
+  torch::save(a, stream);
+
+  samplers::DistributedFeistelSampler b(100, 2, 1);
+  torch::load(b, stream);
+  ASSERT_EQ(b.index(), 57);
+  ASSERT_EQ(b.epoch(), 3);
+  ASSERT_EQ(a.next(10), b.next(10));
+}
+
 TEST(DataTest, DistributedSequentialSamplerSingleReplicaProduceCorrectSamples) {
   size_t sample_count = 10;
   size_t batch_size = 3;
@@ -1013,6 +1361,126 @@ TEST(DataTest, CanSaveAndLoadDistributedSequentialSampler) {
   }
 }
 
+std::vector<size_t> bucket_test_lengths() {
+  std::vector<size_t> lengths;
+  for (size_t i = 0; i < 40; ++i) {
+    lengths.push_back((i * 7) % 13 + 1);
+  }
+  return lengths;
+}
+
+TEST(DataTest, BucketBatchSamplerReturnsEveryIndexOnce) {
+  const auto lengths = bucket_test_lengths();
+  samplers::BucketBatchSampler sampler(lengths, /*max_tokens=*/0, /*bucket_size=*/8);
+
+  std::vector<size_t> res;
+  torch::optional<std::vector<size_t>> batch;
+  while ((batch = sampler.next(3)).has_value()) {
+    ASSERT_LE(batch->size(), 3);
+    ASSERT_TRUE(std::is_sorted(
+        batch->begin(), batch->end(), [&](size_t a, size_t b) {
+          return lengths[a] > lengths[b];
+        }));
+    res.insert(res.end(), batch->begin(), batch->end());
+  }
+  std::sort(res.begin(), res.end());
+  std::vector<size_t> expected(lengths.size());
+  std::iota(expected.begin(), expected.end(), 0);
+  ASSERT_EQ(res, expected);
+}
+
+TEST(DataTest, BucketBatchSamplerGroupsSimilarLengths) {
+  const auto lengths = bucket_test_lengths();
+  size_t padded_tokens = 0;
+  samplers::BucketBatchSampler sampler(lengths);
+  torch::optional<std::vector<size_t>> batch;
+  while ((batch = sampler.next(4)).has_value()) {
+    padded_tokens += lengths[batch->front()] * batch->size();
+  }
+  // With a single bucket, the batches are cut from the sorted lengths.
+  std::vector<size_t> sorted(lengths);
+  std::sort(sorted.rbegin(), sorted.rend());
+  size_t expected = 0;
+  for (size_t i = 0; i < sorted.size(); i += 4) {
+    expected += sorted[i] * std::min<size_t>(4, sorted.size() - i);
+  }
+  ASSERT_EQ(padded_tokens, expected);
+}
+
+TEST(DataTest, BucketBatchSamplerLimitsTokens) {
+  const auto lengths = bucket_test_lengths();
+  samplers::BucketBatchSampler sampler(lengths, /*max_tokens=*/20);
+  torch::optional<std::vector<size_t>> batch;
+  size_t count = 0;
+  while ((batch = sampler.next(100)).has_value()) {
+    ASSERT_LE(lengths[batch->front()] * batch->size(), 20);
+    count += batch->size();
+  }
+  ASSERT_EQ(count, lengths.size());
+}
+
+TEST(DataTest, BucketBatchSamplerShufflesBatchesPerEpoch) {
+  const auto lengths = bucket_test_lengths();
+  auto epoch_batches = [&](size_t epoch) {
+    samplers::BucketBatchSampler sampler(lengths, 0, 10);
+    sampler.set_epoch(epoch);
+    sampler.reset();
+    std::vector<std::vector<size_t>> batches;
+    torch::optional<std::vector<size_t>> batch;
+    while ((batch = sampler.next(2)).has_value()) {
+      batches.push_back(*batch);
+    }
+    return batches;
+  };
+  ASSERT_EQ(epoch_batches(1), epoch_batches(1));
+  ASSERT_NE(epoch_batches(1), epoch_batches(2));
+}
+
+TEST(DataTest, BucketBatchSamplerMultiReplicaProduceCorrectBatches) {
+  const auto lengths = bucket_test_lengths();
+  const size_t num_replicas = 3;
+  for (bool allow_duplicates : {true, false}) {
+    std::vector<size_t> res;
+    size_t num_batches = 0;
+    for (size_t rank = 0; rank < num_replicas; ++rank) {
+      samplers::BucketBatchSampler sampler(
+          lengths, 0, 0, num_replicas, rank, allow_duplicates);
+      size_t local_batches = 0;
+      torch::optional<std::vector<size_t>> batch;
+      while ((batch = sampler.next(3)).has_value()) {
+        res.insert(res.end(), batch->begin(), batch->end());
+        ++local_batches;
+      }
+      if (rank > 0) {
+        ASSERT_EQ(local_batches, num_batches);
+      }
+      num_batches = local_batches;
+    }
+    // 40 examples make 14 batches of at most 3.
+    ASSERT_EQ(num_batches, allow_duplicates ? 5 : 4);
+    std::unordered_set<size_t> unique(res.begin(), res.end());
+    ASSERT_EQ(unique.size() == lengths.size(), allow_duplicates);
+  }
+}
+
+TEST(DataTest, CanSaveAndLoadBucketBatchSampler) {
+  const auto lengths = bucket_test_lengths();
+  samplers::BucketBatchSampler a(lengths, 0, 8);
+  a.set_epoch(5);
+  a.reset();
+  a.next(3);
+  a.next(3);
+  ASSERT_EQ(a.index(), 2);
+  std::stringstream stream;
+  torch::save(a, stream);
+
+  samplers::BucketBatchSampler b(lengths, 0, 8);
+  torch::load(b, stream);
+  ASSERT_EQ(b.index(), 2);
+  ASSERT_EQ(b.epoch(), 5);
+  ASSERT_EQ(a.next(3), b.next(3));
+}
+
 TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   DataLoaderOptions partial_options;
   FullDataLoaderOptions full_options(partial_options);
@@ -1022,6 +1490,9 @@ TEST(DataLoaderTest, DataLoaderOptionsDefaultAsExpected) {
   ASSERT_EQ(full_options.max_jobs, 0);
   ASSERT_FALSE(full_options.timeout.has_value());
   ASSERT_TRUE(full_options.enforce_ordering);
+  ASSERT_FALSE(full_options.reorder_window.has_value());
+  ASSERT_FALSE(full_options.device.has_value());
+  ASSERT_FALSE(full_options.pin_memory);
 }
 
 TEST(DataLoaderTest, DataLoaderOptionsCoalesceOptionalValues) {
@@ -1399,6 +1870,41 @@ TEST(DataLoaderTest, EnforcesOrderingAmongThreadsWhenConfigured) {
   ASSERT_EQ(expected, output);
 }
 
+TEST(DataLoaderTest, BoundsReorderingWithReorderWindow) {
+  struct D : datasets::BatchDataset<D, size_t> {
+    size_t get_batch(torch::ArrayRef<size_t> indices) override {
+      // Every fourth batch is slow.
+      if (indices.front() % 4 == 0) {
+        std::this_thread::sleep_for(5 * kMillisecond);
+      }
+      return indices.front();
+    }
+    torch::optional<size_t> size() const override {
+      return 40;
+    }
+  };
+
+  const size_t kWindow = 3;
+  auto data_loader = torch::data::make_data_loader(
+      D{},
+      samplers::SequentialSampler(40),
+      DataLoaderOptions(1).workers(4).reorder_window(kWindow));
+  std::vector<size_t> output;
+  size_t oldest = 0;
+  std::vector<bool> seen(40, false);
+  for (size_t value : *data_loader) {
+    ASSERT_FALSE(seen.at(value));
+    ASSERT_LT(value, oldest + kWindow);
+    seen[value] = true;
+    while (oldest < seen.size() && seen[oldest]) {
+      ++oldest;
+    }
+    output.push_back(value);
+  }
+  ASSERT_EQ(output.size(), 40);
+  ASSERT_EQ(oldest, 40);
+}
+
 TEST(DataLoaderTest, Reset) {
   DummyDataset dataset;
   auto data_loader =
@@ -1603,6 +2109,135 @@ TEST(DataLoaderTest, StatefulDatasetWithCollate) {
   ASSERT_TRUE(batch->target[0].allclose(torch::zeros(kBatchSize - 1)));
 }
 
+struct RangeDataset : datasets::Dataset<RangeDataset> {
+  Example<> get(size_t index) override {
+    return {torch::full({2}, static_cast<int64_t>(index)),
+            torch::full({1}, static_cast<int64_t>(index))};
+  }
+  torch::optional<size_t> size() const override {
+    return 20;
+  }
+};
+
+TEST(DataLoaderTest, MovesBatchesToDevice) {
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        RangeDataset().map(transforms::Stack<>()),
+        samplers::SequentialSampler(20),
+        DataLoaderOptions(4).workers(workers).device(torch::kCPU));
+    int64_t expected = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.device().is_cpu());
+      ASSERT_EQ(batch.data.size(0), 4);
+      ASSERT_EQ(batch.target[0].item<int64_t>(), expected);
+      expected += 4;
+    }
+    ASSERT_EQ(expected, 20);
+  }
+}
+
+TEST(DataLoaderTest, DurationHistogramBucketsByPowersOfTwo) {
+  torch::data::DurationHistogram histogram;
+  histogram.record(std::chrono::nanoseconds(500));
+  histogram.record(std::chrono::microseconds(3));
+  histogram.record(std::chrono::microseconds(3));
+  histogram.record(std::chrono::milliseconds(1));
+  ASSERT_EQ(histogram.count(), 4);
+  ASSERT_EQ(histogram.max(), std::chrono::milliseconds(1));
+  ASSERT_EQ(
+      histogram.total(),
+      std::chrono::nanoseconds(500) + std::chrono::microseconds(1006));
+  const auto buckets = histogram.buckets();
+  ASSERT_EQ(buckets[0], 1);
+  ASSERT_EQ(buckets[2], 2);
+  ASSERT_EQ(buckets[10], 1);
+  ASSERT_EQ(histogram.quantile(0.5), std::chrono::microseconds(4));
+  ASSERT_EQ(histogram.quantile(1.0), std::chrono::microseconds(1024));
+  histogram.reset();
+  ASSERT_EQ(histogram.count(), 0);
+  ASSERT_EQ(histogram.quantile(0.5), std::chrono::microseconds(0));
+}
+
+TEST(DataLoaderTest, CollectsMetrics) {
+  for (size_t workers : {0, 2}) {
+    auto data_loader = torch::data::make_data_loader(
+        RangeDataset().map(transforms::Stack<>()),
+        samplers::SequentialSampler(20),
+        DataLoaderOptions(4).workers(workers).metrics_log_interval(
+            std::chrono::milliseconds(0)));
+    for (auto& batch : *data_loader) {
+      (void)batch;
+      if (workers > 0) {
+        ASSERT_LE(data_loader->jobs_in_flight(), 2 * workers);
+      }
+    }
+    const auto& metrics = data_loader->metrics();
+    ASSERT_EQ(metrics.workers.size(), workers);
+    ASSERT_EQ(metrics.fetch.count(), 5);
+    ASSERT_EQ(metrics.transfer.count(), 5);
+    ASSERT_EQ(metrics.next_wait.count(), 5);
+    ASSERT_EQ(metrics.queue_wait.count(), workers > 0 ? 5 : 0);
+    uint64_t batches = 0;
+    for (const auto& worker : metrics.workers) {
+      batches += worker.batches.load();
+    }
+    ASSERT_EQ(batches, workers > 0 ? 5 : 0);
+
+    data_loader->reset_metrics();
+    ASSERT_EQ(metrics.fetch.count(), 0);
+    ASSERT_EQ(metrics.next_wait.count(), 0);
+  }
+}
+
+TEST(DataLoaderTest, MovesUncollatedBatchesToDevice_CUDA) {
+  auto data_loader = torch::data::make_data_loader(
+      RangeDataset(),
+      samplers::SequentialSampler(20),
+      DataLoaderOptions(5).workers(2).device(torch::kCUDA));
+  int64_t expected = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_EQ(batch.size(), 5);
+    for (auto& example : batch) {
+      ASSERT_TRUE(example.data.is_cuda());
+      ASSERT_TRUE(example.target.is_cuda());
+      ASSERT_EQ(example.target.item<int64_t>(), expected++);
+    }
+  }
+  ASSERT_EQ(expected, 20);
+}
+
+TEST(DataLoaderTest, PinsMemoryAndCopiesAsynchronously_CUDA) {
+  for (size_t workers : {0, 3}) {
+    auto data_loader = torch::data::make_data_loader(
+        RangeDataset().map(transforms::Stack<>()),
+        samplers::SequentialSampler(20),
+        DataLoaderOptions(4).workers(workers).device(torch::kCUDA).pin_memory(
+            true));
+    int64_t expected = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_TRUE(batch.data.is_cuda());
+      ASSERT_TRUE(batch.target.is_cuda());
+      ASSERT_TRUE(batch.data.select(1, 0).cpu().equal(
+          torch::arange(expected, expected + 4, torch::kLong)));
+      expected += 4;
+    }
+    ASSERT_EQ(expected, 20);
+  }
+}
+
+TEST(DataLoaderTest, PinsMemoryWithoutDevice_CUDA) {
+  auto data_loader = torch::data::make_data_loader(
+      RangeDataset().map(transforms::Stack<>()),
+      DataLoaderOptions(10).workers(1).pin_memory(true));
+  size_t batches = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_TRUE(batch.data.device().is_cpu());
+    ASSERT_EQ(batch.data.size(0), 10);
+    ++batches;
+  }
+  ASSERT_EQ(batches, 2);
+}
+
 // This test tests the core function for iterate through a chunk dataset. It
 // contains test cases with different parameter combination. (For example,
 // different prefetch count, batch size and data loader worker count). It
@@ -1879,3 +2514,134 @@ TEST(DataLoaderTest, ChunkDatasetDoesNotHang) {
   // cleanly.
   auto iterator = data_loader->begin();
 }
+
+TEST(DataLoaderTest, ChunkDatasetKeepsMultipleChunkReadsInFlight) {
+  const size_t kChunksInFlight = 3;
+  const size_t kChunkCount = 6;
+
+  // Every read waits (up to a timeout) until `kChunksInFlight` reads are
+  // outstanding at the same time, or all reads were started. This is only
+  // possible if the preloader starts reads before waiting for the first one.
+  struct AsyncChunkDataReader : datasets::ChunkDataReader<std::vector<int>> {
+    using BatchType = std::vector<int>;
+
+    BatchType read_chunk(size_t chunk_index) override {
+      return BatchType(10, chunk_index);
+    }
+
+    std::future<BatchType> read_chunk_async(size_t chunk_index) override {
+      auto state = this->state;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        ++state->started;
+        ++state->outstanding;
+        state->max_outstanding =
+            std::max(state->max_outstanding, state->outstanding);
+      }
+      state->cv.notify_all();
+      return std::async(std::launch::async, [this, state, chunk_index] {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait_for(lock, std::chrono::seconds(5), [&state] {
+          return state->max_outstanding >= kChunksInFlight ||
+              state->started == kChunkCount;
+        });
+        --state->outstanding;
+        lock.unlock();
+        return this->read_chunk(chunk_index);
+      });
+    }
+
+    size_t chunk_count() override {
+      return kChunkCount;
+    };
+
+    void reset() override{};
+
+    struct State {
+      std::mutex mutex;
+      std::condition_variable cv;
+      size_t started = 0;
+      size_t outstanding = 0;
+      size_t max_outstanding = 0;
+    };
+    std::shared_ptr<State> state = std::make_shared<State>();
+  };
+
+  AsyncChunkDataReader data_reader;
+  auto state = data_reader.state;
+  samplers::SequentialSampler sampler(0);
+  datasets::SharedBatchDataset<datasets::ChunkDataset<
+      AsyncChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>>
+      dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+          AsyncChunkDataReader,
+          samplers::SequentialSampler,
+          samplers::SequentialSampler>>(
+          data_reader,
+          sampler,
+          sampler,
+          datasets::ChunkDatasetOptions(
+              /*preloader_count=*/1, /*batch_size=*/10)
+              .chunks_in_flight(kChunksInFlight));
+
+  auto data_loader = torch::data::make_data_loader(
+      dataset, DataLoaderOptions(10).workers(0));
+
+  // Chunks are added in the order they were started, so batches come in
+  // chunk order.
+  int expected = 0;
+  for (auto& batch : *data_loader) {
+    ASSERT_EQ(batch, std::vector<int>(10, expected));
+    ++expected;
+  }
+  ASSERT_EQ(expected, kChunkCount);
+  ASSERT_EQ(state->max_outstanding, kChunksInFlight);
+}
+
+TEST(DataLoaderTest, ChunkDatasetThrowsForZeroChunksInFlight) {
+  DummyChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+  using Dataset = datasets::ChunkDataset<
+      DummyChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>;
+  auto initialization_function = [&] {
+    Dataset dataset(
+        data_reader,
+        sampler,
+        sampler,
+        datasets::ChunkDatasetOptions(1, 1).chunks_in_flight(0));
+  };
+  ASSERT_THROWS_WITH(initialization_function(), "Chunks in flight is 0");
+}
+
+TEST(DataLoaderTest, ChunkDatasetCollectsMetrics) {
+  const size_t batch_size = 5;
+  DummyChunkDataReader data_reader;
+  samplers::SequentialSampler sampler(0);
+  auto dataset = datasets::make_shared_dataset<datasets::ChunkDataset<
+      DummyChunkDataReader,
+      samplers::SequentialSampler,
+      samplers::SequentialSampler>>(
+      data_reader,
+      sampler,
+      sampler,
+      datasets::ChunkDatasetOptions(1, batch_size));
+  auto data_loader =
+      torch::data::make_data_loader(dataset, DataLoaderOptions(batch_size));
+
+  size_t batch_count = 0;
+  for (auto& batch : *data_loader) {
+    (void)batch;
+    ++batch_count;
+  }
+  const auto& metrics = dataset->metrics();
+  ASSERT_EQ(metrics.chunk_read.count(), data_reader.chunk_count());
+  // One wait per returned batch plus the one that found the dataset exhausted.
+  ASSERT_EQ(metrics.batch_wait.count(), batch_count + 1);
+  ASSERT_GT(metrics.preloader_stall.count(), 0);
+
+  dataset->reset_metrics();
+  ASSERT_EQ(metrics.chunk_read.count(), 0);
+}
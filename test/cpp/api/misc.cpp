@@ -1,10 +1,25 @@
 #include <gtest/gtest.h>
 
 #include <torch/nn/init.h>
+#include <torch/nn/modules/dropout.h>
+#include <torch/nn/modules/functional.h>
 #include <torch/nn/modules/linear.h>
+#include <torch/nn/modules/sequential.h>
+#include <torch/nn/utils.h>
 #include <torch/types.h>
 #include <torch/utils.h>
 
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/forward_ad.h>
+#include <torch/csrc/autograd/record_function.h>
+#include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+
 #include <test/cpp/api/support.h>
 
 TEST(NoGradTest, SetsGradModeCorrectly) {
@@ -19,6 +34,147 @@ TEST(NoGradTest, SetsGradModeCorrectly) {
   ASSERT_FALSE(model->weight.grad().defined());
 }
 
+TEST(ClipGradNormTest, ScalesGradientsToTheGlobalNorm) {
+  torch::manual_seed(0);
+  std::vector<torch::Tensor> parameters = {
+      torch::randn({10, 10}, torch::requires_grad()),
+      torch::randn({100000}, torch::requires_grad()),
+      torch::randn({3}, torch::requires_grad()),
+      torch::randn({4, 5}, torch::requires_grad())};
+  parameters[0].grad() = torch::arange(1., 101.).view({10, 10});
+  parameters[1].grad() = torch::randn({100000});
+  // A non-contiguous gradient, scaled outside of the fused kernel.
+  parameters[3].grad() = torch::randn({5, 4}).t();
+
+  for (double norm_type : {0.5, 1.0, 2.0, 4.0, double(INFINITY)}) {
+    std::vector<torch::Tensor> grads, flat;
+    for (const auto& parameter : parameters) {
+      if (parameter.grad().defined()) {
+        grads.push_back(parameter.grad().clone());
+        flat.push_back(parameter.grad().reshape(-1));
+      }
+    }
+    const auto expected_norm = torch::cat(flat).norm(norm_type);
+
+    const auto norm =
+        torch::nn::utils::clip_grad_norm_(parameters, 2.0, norm_type);
+    ASSERT_EQ(norm.dim(), 0);
+    ASSERT_TRUE(norm.allclose(expected_norm, 1e-4));
+
+    const auto coef = 2.0 / (expected_norm.item<double>() + 1e-6);
+    for (size_t i = 0; i < grads.size(); ++i) {
+      const auto& grad = parameters[i == 2 ? 3 : i].grad();
+      ASSERT_TRUE(grad.allclose(grads[i] * coef, 1e-4, 1e-6));
+    }
+    for (size_t i = 0; i < grads.size(); ++i) {
+      parameters[i == 2 ? 3 : i].grad().copy_(grads[i]);
+    }
+  }
+
+  // Gradients under the limit are left unchanged.
+  const auto grad = parameters[0].grad().clone();
+  torch::nn::utils::clip_grad_norm_(parameters, 1e9);
+  ASSERT_TRUE(parameters[0].grad().equal(grad));
+}
+
+TEST(CheckpointTest, MatchesTheGradientsWithoutCheckpointing) {
+  torch::manual_seed(0);
+  torch::nn::Sequential model(
+      torch::nn::Linear(4, 8),
+      torch::nn::Functional(torch::tanh),
+      torch::nn::Dropout(0.5),
+      torch::nn::Linear(8, 8),
+      torch::nn::Functional(torch::sigmoid),
+      torch::nn::Linear(8, 2));
+  auto input = torch::randn({16, 4}, torch::requires_grad());
+
+  std::vector<torch::Tensor> expected_grads;
+  torch::Tensor expected_output;
+  for (size_t segments : {1, 2, 3, 6}) {
+    // Dropout draws the same mask in each run, and again when recomputing.
+    torch::manual_seed(1);
+    model->zero_grad();
+    input.grad() = torch::Tensor();
+    auto output = segments == 1
+        ? model->forward(input)
+        : torch::nn::utils::checkpoint_sequential(model, segments, input);
+    output.pow(2).sum().backward();
+
+    std::vector<torch::Tensor> grads = {input.grad()};
+    for (const auto& parameter : model->parameters()) {
+      grads.push_back(parameter.grad().clone());
+    }
+    if (segments == 1) {
+      expected_output = output;
+      expected_grads = grads;
+      continue;
+    }
+    ASSERT_TRUE(output.allclose(expected_output));
+    ASSERT_EQ(grads.size(), expected_grads.size());
+    for (size_t i = 0; i < grads.size(); ++i) {
+      ASSERT_TRUE(grads[i].allclose(expected_grads[i]));
+    }
+  }
+}
+
+TEST(CheckpointTest, ChecksThatInputsAreNotModified) {
+  auto input = torch::randn({3}, torch::requires_grad());
+  auto x = input * 2;
+  auto output = torch::nn::utils::checkpoint(
+      [](const torch::Tensor& x) { return x.exp(); }, x);
+  ASSERT_TRUE(output.requires_grad());
+  {
+    torch::NoGradGuard guard;
+    x.add_(1);
+  }
+  ASSERT_THROWS_WITH(
+      output.sum().backward(), "modified by an inplace operation");
+}
+
+namespace {
+// Saves clones of the data of the variables, and counts the calls.
+struct CloningHooks : torch::autograd::SavedTensorHooks {
+  struct Clone : torch::autograd::PackedTensor {
+    Clone(at::Tensor data, size_t& unpacked)
+        : data(std::move(data)), unpacked(unpacked) {}
+    at::Tensor unpack() override {
+      ++unpacked;
+      return data;
+    }
+    at::Tensor data;
+    size_t& unpacked;
+  };
+
+  std::shared_ptr<torch::autograd::PackedTensor> pack(
+      const torch::autograd::Variable& variable) override {
+    ++packed;
+    return std::make_shared<Clone>(variable.data().clone(), unpacked);
+  }
+
+  size_t packed = 0;
+  size_t unpacked = 0;
+};
+} // namespace
+
+TEST(SavedTensorHooksTest, PackAndUnpackTheSavedVariables) {
+  auto x = torch::randn({3, 3}, torch::requires_grad());
+  CloningHooks hooks;
+  torch::Tensor y;
+  {
+    torch::autograd::SavedTensorHooksGuard guard(&hooks);
+    ASSERT_EQ(torch::autograd::SavedTensorHooks::current(), &hooks);
+    y = (x * x).exp();
+  }
+  ASSERT_EQ(torch::autograd::SavedTensorHooks::current(), nullptr);
+  // self and other of mul, and the result of exp.
+  ASSERT_EQ(hooks.packed, 3u);
+  ASSERT_EQ(hooks.unpacked, 0u);
+
+  y.sum().backward();
+  ASSERT_EQ(hooks.unpacked, 3u);
+  ASSERT_TRUE(x.grad().allclose(2 * x * (x * x).exp()));
+}
+
 struct AutogradTest : torch::test::SeedingFixture {
   AutogradTest() {
     x = torch::randn({3, 3}, torch::requires_grad());
@@ -41,4 +197,197 @@ TEST_F(AutogradTest, CanTakeDerivativesOfZeroDimTensors) {
 TEST_F(AutogradTest, CanPassCustomGradientInputs) {
   z.sum().backward(torch::ones({}) * 2);
   ASSERT_TRUE(x.grad().allclose(y * 2));
-}
\ No newline at end of file
+}
+
+TEST_F(AutogradTest, AccumulatesIntoTheExistingGrad) {
+  // x receives several gradients, which are summed before AccumulateGrad.
+  auto loss = [&] { return (x * y + x.exp() + x * 2).sum(); };
+  loss().backward();
+  const auto expected = y + x.exp() + 2;
+  ASSERT_TRUE(x.grad().allclose(expected));
+
+  const auto data_ptr = x.grad().data_ptr();
+  x.grad().zero_();
+  loss().backward();
+  ASSERT_TRUE(x.grad().allclose(expected));
+  ASSERT_EQ(x.grad().data_ptr(), data_ptr);
+
+  // With create_graph, the sum is a new grad, part of the graph.
+  x.grad().zero_();
+  const auto grad = x.grad();
+  loss().backward(c10::nullopt, /*keep_graph=*/false, /*create_graph=*/true);
+  ASSERT_TRUE(x.grad().allclose(expected));
+  ASSERT_TRUE(x.grad().requires_grad());
+  ASSERT_EQ(grad.nonzero().numel(), 0);
+}
+
+TEST(AutogradEngineTest, MultipleCPUThreads) {
+  // Threads of an engine are never joined, so it has to outlive the test
+  static torch::autograd::Engine engine;
+  engine.set_num_cpu_threads(4);
+  ASSERT_EQ(engine.get_num_cpu_threads(), 4);
+
+  // A wide graph whose branches can be evaluated independently
+  auto x = torch::randn({8, 8}, torch::requires_grad());
+  auto y = torch::zeros({8, 8});
+  for (int i = 1; i <= 32; ++i) {
+    y = y + (x * i).sin();
+  }
+  auto loss = y.sum();
+
+  const auto& loss_var = torch::autograd::as_variable_ref(loss);
+  const auto& x_var = torch::autograd::as_variable_ref(x);
+  auto grads = engine.execute(
+      {loss_var.gradient_edge()},
+      {torch::ones({})},
+      /*keep_graph=*/true,
+      /*create_graph=*/false,
+      {x_var.gradient_edge()});
+  ASSERT_EQ(grads.size(), 1);
+
+  loss.backward();
+  ASSERT_TRUE(grads[0].allclose(x.grad()));
+
+  ASSERT_THROWS_WITH(
+      engine.set_num_cpu_threads(2),
+      "cannot set the number of autograd CPU threads");
+}
+
+TEST(AutogradEngineTest, WorkersTakeOnTheThreadLocalStateOfTheCaller) {
+  static torch::autograd::Engine engine;
+  engine.set_num_cpu_threads(4);
+
+  auto x = torch::randn({8, 8}, torch::requires_grad());
+  auto y = torch::zeros({8, 8});
+  for (int i = 1; i <= 8; ++i) {
+    y = y + (x * i).sin();
+  }
+  const auto& loss_var = torch::autograd::as_variable_ref(y.sum());
+  const auto& x_var = torch::autograd::as_variable_ref(x);
+
+  std::atomic<int> num_recorded{0};
+  torch::autograd::profiler::pushCallback(
+      [&](const torch::autograd::profiler::RecordFunction&) {
+        ++num_recorded;
+      });
+  CloningHooks hooks;
+  torch::autograd::variable_list grads;
+  {
+    torch::autograd::profiler::RecordFunctionGuard no_recording(false);
+    torch::autograd::SavedTensorHooksGuard guard(&hooks);
+    grads = engine.execute(
+        {loss_var.gradient_edge()},
+        {torch::ones({})},
+        /*keep_graph=*/false,
+        /*create_graph=*/true,
+        {x_var.gradient_edge()});
+  }
+  torch::autograd::profiler::popCallback();
+
+  ASSERT_EQ(grads.size(), 1);
+  // The backward of sin, in the graph of the grads, saves variables.
+  ASSERT_TRUE(grads[0].requires_grad());
+  ASSERT_GT(hooks.packed, 0u);
+  ASSERT_EQ(num_recorded.load(), 0);
+}
+
+TEST(ForwardADTest, ComputesJacobianVectorProducts) {
+  torch::manual_seed(0);
+  auto x = torch::randn({3, 4});
+  auto w = torch::randn({4, 2});
+  auto v = torch::randn({3, 4});
+  auto outputs = torch::autograd::forward_ad::jvp(
+      [&](const std::vector<torch::Tensor>& inputs) {
+        return std::vector<torch::Tensor>{inputs[0].mm(w).tanh(), w * 2};
+      },
+      {x},
+      {v});
+  auto y = x.mm(w).tanh();
+  ASSERT_TRUE(outputs.first[0].allclose(y));
+  ASSERT_TRUE(outputs.second[0].allclose((1 - y * y) * v.mm(w)));
+  // w * 2 does not depend on x.
+  ASSERT_TRUE(outputs.second[1].allclose(torch::zeros({4, 2})));
+  ASSERT_FALSE(torch::autograd::as_variable_ref(outputs.first[0])
+                   .fw_grad()
+                   .defined());
+}
+
+TEST(ForwardADTest, ComputesHessianVectorProductsInASingleBackward) {
+  torch::manual_seed(0);
+  auto loss = [](const torch::Tensor& x) {
+    return (x * x * x).sum() + (x.sigmoid() * x.exp()).sum();
+  };
+  auto x = torch::randn({5}, torch::requires_grad());
+  auto v = torch::randn({5});
+
+  loss(torch::autograd::forward_ad::make_dual(x, v)).backward();
+  const auto& grad = torch::autograd::as_variable_ref(x.grad());
+  ASSERT_TRUE(grad.fw_grad().defined());
+
+  // Reference: the gradient of <grad, v>, by double backward.
+  auto y = x.detach().clone().set_requires_grad(true);
+  loss(y).backward(c10::nullopt, /*keep_graph=*/false, /*create_graph=*/true);
+  const auto first = y.grad();
+  ASSERT_TRUE(grad.allclose(first));
+  (first * v).sum().backward();
+  ASSERT_TRUE(grad.fw_grad().allclose(y.grad() - first));
+}
+
+TEST(ForwardADTest, ThrowsForOperatorsWithoutAForwardFormula) {
+  auto dual =
+      torch::autograd::forward_ad::make_dual(torch::ones({3}), torch::ones({3}));
+  ASSERT_THROWS_WITH(dual.cumsum(0), "forward derivative of 'cumsum'");
+  ASSERT_THROWS_WITH(dual.add_(1), "forward derivative of 'add_'");
+  {
+    torch::autograd::forward_ad::DisableGuard guard;
+    auto result = dual.cumsum(0);
+    ASSERT_FALSE(torch::autograd::as_variable_ref(result).fw_grad().defined());
+  }
+}
+
+// Many threads run backward passes through one graph at once, so they push to
+// the ready queues of the engine concurrently. A function whose dependency
+// count went wrong would run before all of its gradients arrived, or never.
+TEST(AutogradEngineTest, ConcurrentBackwardPasses) {
+  // Threads of an engine are never joined, so it has to outlive the test
+  static torch::autograd::Engine engine;
+  engine.set_num_cpu_threads(4);
+
+  // A fan-in of many branches, all of which also depend on a shared h
+  auto x = torch::randn({4, 4}, torch::requires_grad());
+  auto h = x.exp();
+  auto y = torch::zeros({4, 4});
+  for (int i = 1; i <= 64; ++i) {
+    y = y + (h * i).sin() + x * i;
+  }
+  auto loss = y.sum();
+  loss.backward(c10::nullopt, /*keep_graph=*/true);
+  const auto expected = x.grad().clone();
+
+  const auto& loss_var = torch::autograd::as_variable_ref(loss);
+  const auto& x_var = torch::autograd::as_variable_ref(x);
+  const int kThreads = 8;
+  const int kIterations = 20;
+  std::vector<std::vector<torch::autograd::Variable>> grads(
+      kThreads * kIterations);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < kIterations; ++i) {
+        grads[t * kIterations + i] = engine.execute(
+            {loss_var.gradient_edge()},
+            {torch::ones({})},
+            /*keep_graph=*/true,
+            /*create_graph=*/false,
+            {x_var.gradient_edge()});
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const auto& grad : grads) {
+    ASSERT_EQ(grad.size(), 1);
+    ASSERT_TRUE(grad[0].allclose(expected));
+  }
+}
@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <torch/nn/mixed_precision.h>
 #include <torch/nn/module.h>
+#include <torch/nn/modules/batchnorm.h>
 #include <torch/nn/modules/linear.h>
 #include <torch/nn/modules/rnn.h>
 #include <torch/nn/modules/sequential.h>
+#include <torch/optim/sgd.h>
 #include <torch/types.h>
 #include <torch/utils.h>
 
@@ -76,6 +79,81 @@ TEST_F(ModuleTest, ZeroGradWithUndefined) {
   ASSERT_EQ(module.x.grad().sum().item<float>(), 0);
 }
 
+TEST_F(ModuleTest, ToMixedPrecisionKeepsBatchNormInFloat) {
+  Sequential model(Linear(3, 4), BatchNorm(4), Linear(4, 2));
+  to_mixed_precision(*model);
+
+  for (const auto& parameter : model[0]->parameters()) {
+    ASSERT_EQ(parameter.scalar_type(), torch::kHalf);
+  }
+  for (const auto& parameter : model[2]->parameters()) {
+    ASSERT_EQ(parameter.scalar_type(), torch::kHalf);
+  }
+  for (const auto& tensor : model[1]->parameters()) {
+    ASSERT_EQ(tensor.scalar_type(), torch::kFloat);
+  }
+  for (const auto& tensor : model[1]->buffers()) {
+    ASSERT_EQ(tensor.scalar_type(), torch::kFloat);
+  }
+
+  to_mixed_precision(
+      *model,
+      MixedPrecisionOptions().keep_batchnorm_fp32(false).keep_fp32(
+          [](const Module& module) {
+            return dynamic_cast<const LinearImpl*>(&module) != nullptr;
+          }));
+  ASSERT_EQ(model[0]->parameters().front().scalar_type(), torch::kFloat);
+  ASSERT_EQ(model[1]->parameters().front().scalar_type(), torch::kHalf);
+  ASSERT_EQ(model[2]->parameters().front().scalar_type(), torch::kFloat);
+}
+
+TEST_F(ModuleTest, FlattenParameters) {
+  Sequential model(Linear(3, 4), Linear(4, 2));
+  std::vector<torch::Tensor> values;
+  for (const auto& parameter : model->parameters()) {
+    values.push_back(parameter.clone());
+  }
+  model->flatten_parameters();
+
+  ASSERT_EQ(model->flat_parameters().size(), 1);
+  ASSERT_EQ(model->flat_gradients().size(), 1);
+  const auto flat = model->flat_parameters()[0];
+  const auto flat_grad = model->flat_gradients()[0];
+  ASSERT_EQ(flat.numel(), 3 * 4 + 4 + 4 * 2 + 2);
+  const auto parameters = model->parameters();
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    ASSERT_TRUE(parameters[i].is_alias_of(flat));
+    ASSERT_TRUE(parameters[i].grad().is_alias_of(flat_grad));
+    ASSERT_TRUE(parameters[i].equal(values[i]));
+  }
+
+  model->forward(torch::ones({5, 3})).sum().backward();
+  float grad_sum = 0;
+  for (const auto& parameter : parameters) {
+    ASSERT_TRUE(parameter.grad().is_alias_of(flat_grad));
+    grad_sum += parameter.grad().sum().item<float>();
+  }
+  ASSERT_FLOAT_EQ(flat_grad.sum().item<float>(), grad_sum);
+
+  // A step on the flat buffer updates all the parameters.
+  torch::optim::SGD optimizer(model->flat_parameters(), 0.1);
+  optimizer.step();
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    ASSERT_TRUE(parameters[i].allclose(values[i] - 0.1 * parameters[i].grad()));
+  }
+
+  model->zero_grad();
+  ASSERT_EQ(flat_grad.abs().sum().item<float>(), 0);
+  for (const auto& parameter : parameters) {
+    ASSERT_TRUE(parameter.grad().is_alias_of(flat_grad));
+  }
+
+  // Moving the module undoes the flattening.
+  model->to(torch::kFloat64);
+  ASSERT_TRUE(model->flat_parameters().empty());
+  ASSERT_FALSE(model->parameters()[0].is_alias_of(flat));
+}
+
 TEST_F(ModuleTest, RegisterModuleThrowsForEmptyOrDottedName) {
   struct TestModel : public torch::nn::Module {
     using torch::nn::Module::register_module;
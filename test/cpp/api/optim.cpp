@@ -206,6 +206,43 @@ TEST(OptimTest, ProducesPyTorchValues_AdamWithWeightDecayAndAMSGrad) {
       expected_parameters::Adam_with_weight_decay_and_amsgrad());
 }
 
+TEST(OptimTest, ProducesPyTorchValues_AdamFused) {
+  check_exact_values<Adam>(
+      AdamOptions(1.0).weight_decay(1e-6).amsgrad(true).fused(true),
+      expected_parameters::Adam_with_weight_decay_and_amsgrad());
+}
+
+TEST(OptimTest, FusedMatchesUnfused_AdamWithMissingGradients) {
+  torch::manual_seed(0);
+  std::vector<torch::Tensor> fused_parameters, parameters;
+  for (int64_t size : {3, 70000, 5}) {
+    const auto parameter = torch::randn({size});
+    fused_parameters.push_back(parameter.clone().set_requires_grad(true));
+    parameters.push_back(parameter.clone().set_requires_grad(true));
+  }
+  Adam fused_optimizer(fused_parameters, AdamOptions(0.1).fused(true));
+  Adam optimizer(parameters, AdamOptions(0.1));
+  for (size_t step = 0; step < 4; ++step) {
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      // The last parameter only gets a gradient every other step, so that it
+      // is at a different step than the others.
+      if (i == 2 && step % 2 == 1) {
+        fused_parameters[i].grad() = torch::Tensor();
+        parameters[i].grad() = torch::Tensor();
+        continue;
+      }
+      const auto grad = torch::randn(parameters[i].sizes());
+      fused_parameters[i].grad() = grad.clone();
+      parameters[i].grad() = grad;
+    }
+    fused_optimizer.step();
+    optimizer.step();
+    for (size_t i = 0; i < parameters.size(); ++i) {
+      ASSERT_TRUE(fused_parameters[i].allclose(parameters[i], 1e-5, 1e-6));
+    }
+  }
+}
+
 TEST(OptimTest, ProducesPyTorchValues_Adagrad) {
   check_exact_values<Adagrad>(
       AdagradOptions(1.0), expected_parameters::Adagrad());
@@ -223,6 +260,44 @@ TEST(OptimTest, ProducesPyTorchValues_AdagradWithWeightDecayAndLRDecay) {
       expected_parameters::Adagrad_with_weight_decay_and_lr_decay());
 }
 
+TEST(OptimTest, ProducesPyTorchValues_AdagradFused) {
+  check_exact_values<Adagrad>(
+      AdagradOptions(1.0).weight_decay(1e-6).lr_decay(1e-3).fused(true),
+      expected_parameters::Adagrad_with_weight_decay_and_lr_decay());
+}
+
+void check_sparse_adagrad(const AdagradOptions& options) {
+  torch::manual_seed(0);
+  const auto weight = torch::randn({10, 5});
+  auto sparse_weight = weight.clone().set_requires_grad(true);
+  auto dense_weight = weight.clone().set_requires_grad(true);
+  Adagrad sparse_optimizer(std::vector<torch::Tensor>{sparse_weight}, options);
+  Adagrad dense_optimizer(std::vector<torch::Tensor>{dense_weight}, options);
+  for (size_t step = 0; step < 5; ++step) {
+    // Uncoalesced, with duplicate indices.
+    const auto grad = torch::sparse_coo_tensor(
+        torch::tensor({3, 1, 3, 7, 1, 3}, torch::kLong).view({1, 6}),
+        torch::randn({6, 5}),
+        {10, 5});
+    sparse_weight.grad() = grad;
+    dense_weight.grad() = grad.to_dense();
+    sparse_optimizer.step();
+    dense_optimizer.step();
+    ASSERT_TRUE(sparse_weight.allclose(dense_weight, 1e-4, 1e-5));
+    ASSERT_TRUE(sparse_optimizer.sum_buffers[0].allclose(
+        dense_optimizer.sum_buffers[0], 1e-4, 1e-5));
+  }
+  ASSERT_TRUE(sparse_weight[0].equal(weight[0]));
+}
+
+TEST(OptimTest, SparseGradients_Adagrad) {
+  check_sparse_adagrad(AdagradOptions(0.1).lr_decay(1e-2));
+}
+
+TEST(OptimTest, SparseGradients_AdagradRowwise) {
+  check_sparse_adagrad(AdagradOptions(0.1).rowwise(true));
+}
+
 TEST(OptimTest, ProducesPyTorchValues_RMSprop) {
   check_exact_values<RMSprop>(
       RMSpropOptions(0.1), expected_parameters::RMSprop());
@@ -249,6 +324,17 @@ TEST(
           RMSprop_with_weight_decay_and_centered_and_momentum());
 }
 
+TEST(OptimTest, ProducesPyTorchValues_RMSpropFused) {
+  check_exact_values<RMSprop>(
+      RMSpropOptions(0.1)
+          .weight_decay(1e-6)
+          .centered(true)
+          .momentum(0.9)
+          .fused(true),
+      expected_parameters::
+          RMSprop_with_weight_decay_and_centered_and_momentum());
+}
+
 TEST(OptimTest, ProducesPyTorchValues_SGD) {
   check_exact_values<SGD>(SGDOptions(0.1), expected_parameters::SGD());
 }
@@ -271,6 +357,13 @@ TEST(OptimTest, ProducesPyTorchValues_SGDWithWeightDecayAndNesterovMomentum) {
       expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
 }
 
+TEST(OptimTest, ProducesPyTorchValues_SGDFused) {
+  check_exact_values<SGD>(
+      SGDOptions(0.1).weight_decay(1e-6).momentum(0.9).nesterov(true).fused(
+          true),
+      expected_parameters::SGD_with_weight_decay_and_nesterov_momentum());
+}
+
 TEST(OptimTest, ZeroGrad) {
   torch::manual_seed(0);
 
@@ -320,6 +413,64 @@ TEST(OptimTest, ExternalVectorOfParameters) {
   ASSERT_TRUE(parameters[2].allclose(original_parameters[2] - 1.0));
 }
 
+TEST(OptimTest, MasterWeights) {
+  auto parameter = torch::ones({100}, torch::kHalf).set_requires_grad(true);
+  parameter.grad() = torch::full({100}, 1e-4, torch::kHalf);
+
+  SGD optimizer(std::vector<torch::Tensor>{parameter}, 1.0);
+  optimizer.use_master_weights();
+  ASSERT_TRUE(optimizer.uses_master_weights());
+  ASSERT_EQ(optimizer.parameters().front().scalar_type(), torch::kFloat);
+
+  // The updates are too small to change the half parameter one at a time.
+  for (size_t step = 0; step < 100; ++step) {
+    optimizer.copy_gradients_to_master_weights();
+    optimizer.step();
+    optimizer.copy_master_weights_to_parameters();
+  }
+  ASSERT_TRUE(optimizer.parameters().front().allclose(
+      torch::full({100}, 0.99, torch::kFloat)));
+  ASSERT_EQ(parameter.scalar_type(), torch::kHalf);
+  ASSERT_TRUE(parameter.to(torch::kFloat)
+                  .allclose(torch::full({100}, 0.99), 1e-3, 1e-3));
+
+  optimizer.zero_grad();
+  ASSERT_EQ(parameter.grad().sum().item<float>(), 0);
+  ASSERT_EQ(optimizer.parameters().front().grad().sum().item<float>(), 0);
+}
+
+TEST(OptimTest, GradScalerSkipsStepsWithNonFiniteGradients) {
+  std::vector<torch::Tensor> parameters = {
+      torch::ones({4}).set_requires_grad(true),
+      torch::ones({2, 3}).t().set_requires_grad(true)};
+  SGD optimizer(parameters, 1.0);
+  GradScaler scaler(GradScalerOptions().init_scale(8).growth_interval(2));
+
+  auto loss =
+      scaler.scale((parameters[0].sum() + parameters[1].sum()) * 0.5);
+  loss.backward();
+  ASSERT_TRUE(scaler.step(optimizer));
+  ASSERT_TRUE(parameters[0].allclose(torch::full({4}, 0.5)));
+  ASSERT_TRUE(parameters[1].allclose(torch::full({3, 2}, 0.5)));
+  ASSERT_EQ(scaler.current_scale(), 8);
+
+  optimizer.zero_grad();
+  parameters[1].grad()[0][1] = INFINITY;
+  ASSERT_FALSE(scaler.step(optimizer));
+  ASSERT_TRUE(parameters[0].allclose(torch::full({4}, 0.5)));
+  ASSERT_EQ(scaler.current_scale(), 4);
+
+  optimizer.zero_grad();
+  parameters[0].grad()[3] = NAN;
+  ASSERT_FALSE(scaler.step(optimizer));
+  ASSERT_EQ(scaler.current_scale(), 2);
+
+  optimizer.zero_grad();
+  ASSERT_TRUE(scaler.step(optimizer));
+  ASSERT_TRUE(scaler.step(optimizer));
+  ASSERT_EQ(scaler.current_scale(), 4);
+}
+
 TEST(OptimTest, AddParameter_LBFGS) {
   torch::manual_seed(0);
 
@@ -6,6 +6,7 @@
 #include <torch/nn/parallel/data_parallel.h>
 #include <torch/nn/pimpl.h>
 #include <torch/types.h>
+#include <torch/utils.h>
 
 #include <test/cpp/api/support.h>
 
@@ -223,3 +224,49 @@ TEST_F(ParallelTest, DataParallelUsesAllAvailableCUDADevices_CUDA) {
     ASSERT_EQ(output[i].item<int32_t>(), i);
   }
 }
+
+TEST_F(ParallelTest, ReplicaCacheUpdatesOnlyChangedTensors_MultiCUDA) {
+  Linear linear(3, 4);
+  linear->to({torch::kCUDA, 0});
+  parallel::ReplicaCache<Linear> cache(
+      linear, std::vector<torch::Device>{{torch::kCUDA, 0}, {torch::kCUDA, 1}});
+
+  auto& replicas = cache.replicas();
+  ASSERT_EQ(replicas.size(), 2);
+  auto replica = replicas[1].ptr();
+  auto bias = replica->bias.data<float>();
+  auto weight = replica->weight.data<float>();
+
+  // Nothing changed, so the replicas are returned as they are.
+  ASSERT_EQ(cache.replicas()[1].ptr(), replica);
+  ASSERT_EQ(replica->weight.data<float>(), weight);
+  ASSERT_EQ(replica->bias.data<float>(), bias);
+
+  {
+    torch::NoGradGuard guard;
+    linear->weight.add_(1);
+  }
+  ASSERT_EQ(cache.replicas()[1].ptr(), replica);
+  ASSERT_NE(replica->weight.data<float>(), weight);
+  ASSERT_EQ(replica->bias.data<float>(), bias);
+  ASSERT_EQ(replica->weight.device(), torch::Device(torch::kCUDA, 1));
+  ASSERT_TRUE(replica->weight.cpu().allclose(linear->weight.cpu()));
+}
+
+TEST_F(ParallelTest, DataParallelWithReplicaCache_MultiCUDA) {
+  Linear linear(3, 4);
+  linear->to({torch::kCUDA, 0});
+  parallel::ReplicaCache<Linear> cache(
+      linear, std::vector<torch::Device>{{torch::kCUDA, 0}, {torch::kCUDA, 1}});
+
+  auto input = torch::randn({10, 3});
+  for (size_t step = 0; step < 3; ++step) {
+    auto output = parallel::data_parallel(cache, input);
+    ASSERT_EQ(output.device(), torch::Device(torch::kCUDA, 0));
+    ASSERT_TRUE(output.allclose(linear(input.cuda()), 1e-4, 1e-5));
+    torch::NoGradGuard guard;
+    for (auto& parameter : linear->parameters()) {
+      parameter.mul_(0.5);
+    }
+  }
+}
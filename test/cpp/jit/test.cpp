@@ -65,6 +65,7 @@ namespace jit {
   _(ContainerAliasing)             \
   _(AliasRegistration)             \
   _(WriteTracking)                 \
+  _(IncrementalAliasDb)            \
   _(Wildcards)                     \
   _(MemoryDAG)                     \
   _(IRParser)                      \
@@ -77,6 +78,7 @@ namespace jit {
   _(Profiler)                      \
   _(PeepholeOptimize)              \
   _(RecordFunction)                \
+  _(RecordFunctionSampling)        \
   _(SubgraphMatching)              \
   _(ModuleDefine)                  \
   _(QualifiedName)                 \
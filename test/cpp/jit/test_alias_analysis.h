@@ -4,6 +4,7 @@
 #include "test/cpp/jit/test_base.h"
 #include "torch/csrc/jit/custom_operator.h"
 #include "torch/csrc/jit/passes/alias_analysis.h"
+#include "torch/csrc/jit/passes/utils/subgraph_utils.h"
 #include "torch/csrc/jit/script/compiler.h"
 #include "torch/csrc/utils/memory.h"
 
@@ -512,6 +513,67 @@ void testWriteTracking() {
   }
 }
 
+// Checks that an AliasDb kept up to date through graph edits agrees with one
+// built from scratch for the edited graph.
+void expectSameAliasing(const std::shared_ptr<Graph>& graph, AliasDb& aliasDb) {
+  AliasDb fresh(graph);
+  std::vector<const Value*> values(
+      graph->inputs().begin(), graph->inputs().end());
+  for (Node* node : graph->nodes()) {
+    values.insert(values.end(), node->outputs().begin(), node->outputs().end());
+    if (node->kind() == prim::DifferentiableGraph) {
+      for (Node* inner : node->g(attr::Subgraph)->nodes()) {
+        values.insert(
+            values.end(), inner->outputs().begin(), inner->outputs().end());
+      }
+    }
+    ASSERT_EQ(aliasDb.hasWriters(node), fresh.hasWriters(node));
+  }
+  for (const Value* a : values) {
+    for (const Value* b : values) {
+      ASSERT_EQ(aliasDb.mayAlias(a, b), fresh.mayAlias(a, b));
+    }
+  }
+}
+
+void testIncrementalAliasDb() {
+  auto graph = std::make_shared<Graph>();
+  std::unordered_map<std::string, Value*> vmap;
+  script::parseIR(
+      R"IR(
+graph(%a : Tensor):
+  %one : int = prim::Constant[value=1]()
+  %zero : int = prim::Constant[value=0]()
+  %b : Tensor = aten::mul(%a, %a)
+  %x : Tensor = aten::add(%b, %b, %one)
+  %y : Tensor = aten::select(%x, %zero, %zero)
+  %z : Tensor = aten::mul(%y, %b)
+  %w : Tensor = aten::add_(%x, %b, %one)
+  return (%z, %w)
+  )IR",
+      &*graph,
+      vmap);
+  Node* x = vmap["x"]->node();
+  Node* y = vmap["y"]->node();
+  Node* z = vmap["z"]->node();
+
+  AliasDb aliasDb(graph);
+  auto subgraph = SubgraphUtils::createSingletonSubgraph(
+      z, prim::DifferentiableGraph, aliasDb);
+  SubgraphUtils::mergeNodeIntoSubgraph(y, subgraph, aliasDb);
+  SubgraphUtils::mergeNodeIntoSubgraph(x, subgraph, aliasDb);
+  graph->lint();
+  expectSameAliasing(graph, aliasDb);
+
+  // %x now comes out of the subgraph, which the write to it has to follow
+  Node* write = graph->outputs()[1]->node();
+  ASSERT_FALSE(aliasDb.moveBeforeTopologicallyValid(write, subgraph));
+
+  SubgraphUtils::unmergeSubgraph(subgraph, aliasDb);
+  graph->lint();
+  expectSameAliasing(graph, aliasDb);
+}
+
 void testContainerAliasing() {
   {
     auto graph = std::make_shared<Graph>();
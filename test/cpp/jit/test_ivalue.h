@@ -56,6 +56,24 @@ void testIValue() {
   ASSERT_TRUE(ten2.toTensor().equal(ten.toTensor()));
   std::move(ten2).toTensor();
   ASSERT_EQ(tv.use_count(), 2);
+
+  // Assignments between values that hold references and values that don't
+  IValue scalar(7);
+  IValue other(2.5);
+  scalar = other;
+  ASSERT_TRUE(scalar.isDouble());
+  ASSERT_EQ(scalar.toDouble(), 2.5);
+  scalar = ten;
+  ASSERT_EQ(tv.use_count(), 3);
+  scalar = IValue(true);
+  ASSERT_EQ(tv.use_count(), 2);
+  ASSERT_TRUE(scalar.toBool());
+  other = std::move(scalar);
+  ASSERT_TRUE(other.isBool());
+  ASSERT_TRUE(scalar.isNone());
+  IValue moved(std::move(ten));
+  ASSERT_TRUE(ten.isNone());
+  ASSERT_EQ(tv.use_count(), 2);
 }
 
 } // namespace
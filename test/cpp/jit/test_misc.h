@@ -51,12 +51,14 @@
 #include <c10/util/Exception.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -711,6 +713,60 @@ void testRecordFunction() {
   checkTracedInputs(jit_inputs);
 }
 
+void testRecordFunctionSampling() {
+  size_t num_all = 0;
+  size_t num_sampled = 0;
+  size_t num_never = 0;
+  autograd::profiler::pushCallback(
+      [&num_all](const autograd::profiler::RecordFunction&) { ++num_all; });
+  autograd::profiler::pushCallback(
+      [&num_sampled](const autograd::profiler::RecordFunction&) { ++num_sampled; },
+      [](const autograd::profiler::RecordFunction&) {},
+      /*needs_inputs=*/false,
+      /*sampling_prob=*/0.5);
+  autograd::profiler::pushCallback(
+      [&num_never](const autograd::profiler::RecordFunction&) { ++num_never; },
+      [](const autograd::profiler::RecordFunction&) {},
+      /*needs_inputs=*/false,
+      /*sampling_prob=*/0.0);
+
+  constexpr size_t num_calls = 1000;
+  for (size_t i = 0; i < num_calls; ++i) {
+    RECORD_FUNCTION("test", std::vector<c10::IValue>());
+  }
+  AT_CHECK(num_all == num_calls);
+  AT_CHECK(num_sampled > 0 && num_sampled < num_calls);
+  AT_CHECK(num_never == 0);
+
+  // recording can be turned off on a thread, e.g. for unsampled requests
+  {
+    autograd::profiler::RecordFunctionGuard disable_guard(/*enable=*/false);
+    RECORD_FUNCTION("test", std::vector<c10::IValue>());
+  }
+  AT_CHECK(num_all == num_calls);
+  AT_CHECK(autograd::profiler::isRecordFunctionEnabled());
+
+  // callbacks can be registered while other threads run RecordFunctions
+  std::atomic<bool> done{false};
+  std::thread worker([&done] {
+    while (!done) {
+      RECORD_FUNCTION("test", std::vector<c10::IValue>());
+    }
+  });
+  for (size_t i = 0; i < 100; ++i) {
+    autograd::profiler::pushCallback(
+        [](const autograd::profiler::RecordFunction&) {});
+    autograd::profiler::popCallback();
+  }
+  done = true;
+  worker.join();
+
+  autograd::profiler::popCallback();
+  autograd::profiler::popCallback();
+  autograd::profiler::popCallback();
+  AT_CHECK(!autograd::profiler::hasCallbacks());
+}
+
 void testAutogradProfiler() {
   constexpr int batch_size = 4;
   constexpr int input_size = 256;
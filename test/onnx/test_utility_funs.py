@@ -10,6 +10,9 @@ import onnx
 
 import io
 import copy
+import os
+import shutil
+import tempfile
 
 
 class TestUtilityFuns(TestCase):
@@ -161,5 +164,31 @@ class TestUtilityFuns(TestCase):
         # test strip_doc_string=False
         self.assertFalse(is_model_stripped(io.BytesIO(), False))
 
+    def test_external_data_format(self):
+        model = torch.nn.Linear(4, 5)
+        x = torch.randn(3, 4)
+        directory = tempfile.mkdtemp()
+        try:
+            f = os.path.join(directory, "model.onnx")
+            torch.onnx.export(model, x, f, use_external_data_format=True)
+            proto = onnx.ModelProto()
+            with open(f, "rb") as model_file:
+                proto.ParseFromString(model_file.read())
+
+            params = dict(model.named_parameters())
+            self.assertEqual(len(proto.graph.initializer), len(params))
+            for initializer in proto.graph.initializer:
+                self.assertEqual(initializer.data_location, onnx.TensorProto.EXTERNAL)
+                self.assertFalse(initializer.raw_data)
+                location = {e.key: e.value for e in initializer.external_data}["location"]
+                with open(os.path.join(directory, location), "rb") as data_file:
+                    data = data_file.read()
+                self.assertEqual(data, params[initializer.name].detach().numpy().tobytes())
+        finally:
+            shutil.rmtree(directory)
+
+        with self.assertRaisesRegex(RuntimeError, "file"):
+            torch.onnx.export(model, x, io.BytesIO(), use_external_data_format=True)
+
 if __name__ == '__main__':
     run_tests()
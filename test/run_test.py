@@ -39,6 +39,7 @@ TESTS = [
     'numba_integration',
     'optim',
     'quantized',
+    'rpc',
     'sparse',
     'thd_distributed',
     'torch',
@@ -52,6 +53,7 @@ TESTS = [
 
 WINDOWS_BLACKLIST = [
     'distributed',
+    'rpc',
     'thd_distributed',
 ]
 
@@ -61,6 +63,7 @@ ROCM_BLACKLIST = [
     'distributed',
     'multiprocessing',
     'nccl',
+    'rpc',
     'thd_distributed',
 ]
 
@@ -2411,6 +2411,31 @@ class TestAutograd(TestCase):
             self.assertEqual(info.name, expected_name)
             last_end = info.cpu_interval.end
 
+    @unittest.skipIf(sys.platform == "win32", "NamedTemporaryFile can't be reopened on Windows")
+    def test_profiler_streaming(self):
+        import json
+        x = torch.randn(10, 10)
+
+        with tempfile.NamedTemporaryFile(mode='r') as trace_file:
+            with profile(trace_path=trace_file.name) as p:
+                for _ in range(10):
+                    y = x * 2 + 4
+            with self.assertRaisesRegex(RuntimeError, "streamed"):
+                p.table()
+            events = json.load(trace_file)
+
+        ranges = [e for e in events if e['ph'] in ('B', 'E')]
+        begins = [e['name'] for e in ranges if e['ph'] == 'B']
+        self.assertEqual(begins, ['mul', 'add'] * 10)
+        depth = 0
+        last_ts = 0
+        for e in ranges:
+            depth += 1 if e['ph'] == 'B' else -1
+            self.assertGreaterEqual(depth, 0)
+            self.assertGreaterEqual(e['ts'], last_ts)
+            last_ts = e['ts']
+        self.assertEqual(depth, 0)
+
     def test_profiler_aggregation_fake(self):
         events = EventList()
         id = [0]
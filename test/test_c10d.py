@@ -183,6 +183,20 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        fs.set("key3", "value3")
+        self.assertEqual(
+            [b"value3", b"value0", b"value2"],
+            fs.multi_get(["key3", "key0", "key2"]))
+        self.assertEqual(b"value1", fs.get("key1"))
+        self.assertEqual([], fs.multi_get([]))
+        with self.assertRaisesRegex(ValueError, "as many values as keys"):
+            fs.multi_set(["key4"], [])
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -756,6 +770,37 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_allreduce_basics_cuda(self):
         self._test_allreduce_basics(lambda t: t.clone().cuda())
 
+    @skip_if_not_multigpu
+    def test_allreduce_chunked_cuda(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        opts = self.opts()
+        opts.cuda_chunk_bytes = 1024
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # 1000 floats are split into four chunks (the last one partial).
+        inputs = [
+            torch.arange(1000, dtype=torch.float).add_(self.rank + i).cuda(i)
+            for i in range(2)
+        ]
+        work = pg.allreduce(inputs)
+        work.wait()
+        expected = (
+            torch.arange(1000, dtype=torch.float).mul_(2 * self.world_size)
+            .add_(self.world_size * (self.world_size - 1) + self.world_size))
+        for tensor in inputs:
+            self.assertEqual(expected, tensor.cpu())
+
+        # Non-contiguous tensors are not chunked.
+        inputs = [
+            torch.ones(40, 40).add_(self.rank).cuda(i).t() for i in range(2)
+        ]
+        work = pg.allreduce(inputs)
+        work.wait()
+        expected = torch.ones(40, 40).mul_(2 * self.world_size).add_(
+            self.world_size * (self.world_size - 1))
+        for tensor in inputs:
+            self.assertEqual(expected, tensor.cpu())
+
     def _test_allreduce_stress(self, inputs):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts(threads=8))
@@ -1018,6 +1063,132 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_gather_basics_cuda(self):
         self._test_gather_basics(lambda t: t.clone().cuda())
 
+    def test_allreduce_coalesced_checks(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        with self.assertRaisesRegex(ValueError, "requires non-empty tensor list"):
+            pg.allreduce_coalesced([])
+
+        with self.assertRaisesRegex(ValueError, "only supports dense tensors"):
+            pg.allreduce_coalesced([torch.zeros(1), torch.sparse_coo_tensor([[0]], [1.], (2,))])
+
+    def test_allreduce_coalesced_basics(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Interleaved dtypes and sizes, and a non-contiguous tensor
+        tensors = [
+            torch.full((i + 1, 2), self.rank + i, dtype=dtype)
+            for i, dtype in enumerate([torch.float, torch.long, torch.double, torch.float])
+        ]
+        tensors.append(torch.full((3, 2), self.rank).t())
+        work = pg.allreduce_coalesced(tensors)
+        work.wait()
+        total = sum(range(self.world_size))
+        for i, tensor in enumerate(tensors[:4]):
+            self.assertEqual(
+                torch.full(tensor.size(), total + i * self.world_size, dtype=tensor.dtype),
+                tensor)
+        self.assertEqual(torch.full((2, 3), total), tensors[4])
+
+    def test_sparse_allreduce_checks(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+        t = torch.sparse_coo_tensor([[0]], [1.], (2,))
+
+        with self.assertRaisesRegex(ValueError, "only works with ReduceOp.SUM"):
+            opts = c10d.AllreduceOptions()
+            opts.reduceOp = c10d.ReduceOp.MAX
+            pg.allreduce([t], opts)
+
+        with self.assertRaisesRegex(ValueError, "invalid tensor type"):
+            pg.allreduce([t, torch.zeros(2)])
+
+    def test_sparse_allreduce_basics(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Rank r has entries at rows r and r + 1 of a 2D tensor with a dense
+        # dimension, and rank 1 has none
+        n = self.world_size + 1
+        if self.rank == 1:
+            indices = torch.zeros((1, 0), dtype=torch.long)
+            values = torch.zeros((0, 2))
+        else:
+            indices = torch.tensor([[self.rank, self.rank + 1]])
+            values = torch.tensor([[1., 2.], [3., 4.]]) * (self.rank + 1)
+        tensor = torch.sparse_coo_tensor(indices, values, (n, 2))
+        work = pg.allreduce([tensor])
+        work.wait()
+
+        expected = torch.zeros((n, 2))
+        for r in range(self.world_size):
+            if r != 1:
+                expected[r] += torch.tensor([1., 2.]) * (r + 1)
+                expected[r + 1] += torch.tensor([3., 4.]) * (r + 1)
+        self.assertTrue(tensor.is_coalesced())
+        self.assertEqual(expected, tensor.to_dense())
+
+    def test_reduce_scatter_basics(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Rank i receives the sum of the chunks of size i + 1
+        inputs = [torch.full((i + 1,), self.rank + i) for i in range(self.world_size)]
+        output = torch.full((self.rank + 1,), -1)
+        work = pg.reduce_scatter([output], [inputs], c10d.ReduceScatterOptions())
+        work.wait()
+        expected = sum(r + self.rank for r in range(self.world_size))
+        self.assertEqual(torch.full((self.rank + 1,), expected), output)
+        # the inputs are left untouched
+        self.assertEqual(torch.full((self.rank + 1,), 2 * self.rank), inputs[self.rank])
+
+    def test_alltoall_base_basics(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Even splits: rank r sends row i to rank i
+        input = torch.arange(self.world_size, dtype=torch.float) + self.rank * self.world_size
+        output = torch.full((self.world_size,), -1)
+        pg.alltoall_base(output, input, [], []).wait()
+        expected = torch.Tensor([r * self.world_size + self.rank for r in range(self.world_size)])
+        self.assertEqual(expected, output)
+
+        # Uneven splits: rank r sends r + 1 rows of width 2 to every rank
+        input = torch.full((self.world_size * (self.rank + 1), 2), self.rank)
+        input_splits = [self.rank + 1] * self.world_size
+        output_splits = [r + 1 for r in range(self.world_size)]
+        output = torch.full((sum(output_splits), 2), -1)
+        pg.alltoall_base(output, input, output_splits, input_splits).wait()
+        expected = torch.cat([torch.full((r + 1, 2), r) for r in range(self.world_size)])
+        self.assertEqual(expected, output)
+
+    def test_alltoall_basics(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Rank r sends r + i + 1 elements to rank i
+        inputs = [torch.full((self.rank + i + 1,), self.rank * 10 + i) for i in range(self.world_size)]
+        outputs = [torch.full((r + self.rank + 1,), -1) for r in range(self.world_size)]
+        pg.alltoall(outputs, inputs).wait()
+        expected = [torch.full((r + self.rank + 1,), r * 10 + self.rank) for r in range(self.world_size)]
+        self.assertEqual(expected, outputs)
+
+    def test_alltoall_checks(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        with self.assertRaisesRegex(ValueError, "one tensor per rank"):
+            pg.alltoall([torch.zeros(1)], [torch.zeros(1)])
+
+        with self.assertRaisesRegex(RuntimeError, "divisible by group size"):
+            pg.alltoall_base(torch.zeros(self.world_size), torch.zeros(self.world_size + 1), [], [])
+
+        with self.assertRaisesRegex(RuntimeError, "Split sizes must sum"):
+            pg.alltoall_base(torch.zeros(self.world_size), torch.zeros(self.world_size),
+                             [], [2] * self.world_size)
+
     def _test_gather_stress(self, inputs, fn):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts(threads=8))
@@ -1344,6 +1515,22 @@ class ProcessGroupNCCLTest(TestCase):
     def tearDown(self):
         pass
 
+    def test_warmup(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        with self.assertRaisesRegex(RuntimeError, "Devices must be distinct"):
+            pg.warmup([0, 0])
+
+        pg.warmup([torch.device("cuda", 1), 0])
+        self.assertEqual(["1,0"], list(pg.comm_init_times().keys()))
+
+        # A collective on the same device list reuses the communicators
+        tensors = [torch.Tensor([1]).cuda(1), torch.Tensor([2]).cuda(0)]
+        pg.allreduce(tensors).wait()
+        self.assertEqual(torch.Tensor([3]), tensors[0].cpu())
+        self.assertEqual(1, len(pg.comm_init_times()))
+
     def test_broadcast_ops(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -2548,6 +2735,128 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def test_rebuild_buckets(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reference = copy.deepcopy(model)
+        parameters = [list(model.parameters())]
+        # One bucket per parameter, in definition order, which is the
+        # opposite of the gradient ready order.
+        buckets = [[i] for i in range(len(parameters[0]))]
+        reducer = dist.Reducer(
+            parameters, buckets, self.process_group, [1024 * 1024])
+        loss = nn.CrossEntropyLoss()
+        for i in range(3):
+            self.assertEqual(i > 1, reducer.has_rebuilt_buckets())
+            model.zero_grad()
+            reference.zero_grad()
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            loss(reference(input), target).backward()
+            for p, ref in zip(model.parameters(), reference.parameters()):
+                self.assertEqual(p.grad, ref.grad)
+        self.assertTrue(reducer.has_rebuilt_buckets())
+
+    def test_gradient_as_bucket_view(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reference = copy.deepcopy(model)
+        parameters = [list(model.parameters())]
+        group_by_type = groupby(
+            range(len(parameters[0])),
+            key=lambda i: parameters[0][i].type())
+        buckets = [list(indices) for _, indices in group_by_type]
+        reducer = dist.Reducer(
+            parameters, buckets, self.process_group, [1024 * 1024],
+            gradient_as_bucket_view=True)
+        loss = nn.CrossEntropyLoss()
+        optimizer = torch.optim.SGD(model.parameters(), lr=0.1)
+        reference_optimizer = torch.optim.SGD(reference.parameters(), lr=0.1)
+        for i in range(4):
+            # `zero_grad` calls `detach_` on the gradients, which has to work
+            # on the bucket views too.
+            optimizer.zero_grad()
+            reference_optimizer.zero_grad()
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            # Unused parameter only in the first iteration.
+            output = loss(model(input, use_fc3=(i > 0)), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            loss(reference(input, use_fc3=(i > 0)), target).backward()
+            for p, ref in zip(model.parameters(), reference.parameters()):
+                if ref.grad is not None:
+                    self.assertEqual(p.grad, ref.grad)
+            optimizer.step()
+            reference_optimizer.step()
+
+        # The float parameters share a bucket, so their gradients share its
+        # storage, also after the buckets were rebuilt.
+        self.assertTrue(reducer.has_rebuilt_buckets())
+        self.assertEqual(model.fc2.weight.grad.storage().data_ptr(),
+                         model.fc3.weight.grad.storage().data_ptr())
+
+    def _run_with_comm_hook(self, hook_factory, iterations=1):
+        batch_size = 10
+        torch.manual_seed(0)
+        model = ReducerModule()
+        reference = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        reducer.register_comm_hook(hook_factory(self.process_group))
+        loss = nn.CrossEntropyLoss()
+        for _ in range(iterations):
+            model.zero_grad()
+            reference.zero_grad()
+            input = torch.rand([batch_size, 2])
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            loss(reference(input), target).backward()
+        return model, reference
+
+    def test_comm_hook_allreduce(self):
+        model, reference = self._run_with_comm_hook(c10d._AllreduceCommHook)
+        for p, ref in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p.grad, ref.grad)
+
+    def test_comm_hook_fp16(self):
+        model, reference = self._run_with_comm_hook(c10d._FP16CompressCommHook)
+        for p, ref in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p.grad, ref.grad, prec=1e-3)
+
+    def test_comm_hook_topk(self):
+        # With a single process and the full ratio nothing is dropped
+        model, reference = self._run_with_comm_hook(
+            lambda pg: c10d._TopKCompressCommHook(pg, 1.0), iterations=2)
+        for p, ref in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p.grad, ref.grad)
+
+        # All parameters share a single bucket, of which only a tenth of
+        # the entries is sent
+        model, _ = self._run_with_comm_hook(
+            lambda pg: c10d._TopKCompressCommHook(pg, 0.1))
+        numel = sum(p.numel() for p in model.parameters())
+        nonzero = sum((p.grad != 0).sum().item() for p in model.parameters())
+        self.assertLessEqual(nonzero, numel // 10)
+
+    def test_comm_hook_powersgd(self):
+        # A rank as large as the bucket matrix reconstructs the gradient
+        model, reference = self._run_with_comm_hook(
+            lambda pg: c10d._PowerSGDCommHook(pg, 1000))
+        for p, ref in zip(model.parameters(), reference.parameters()):
+            self.assertEqual(p.grad, ref.grad, prec=1e-4)
+
+    def test_comm_hook_register_twice(self):
+        model = ReducerModule()
+        reducer = self._create_reducer_for_models([model])
+        reducer.register_comm_hook(c10d._AllreduceCommHook(self.process_group))
+        with self.assertRaisesRegex(RuntimeError, "only be registered once"):
+            reducer.register_comm_hook(c10d._AllreduceCommHook(self.process_group))
+
 
 class ComputeBucketAssignmentTest(TestCase):
     def test_single_limit_single_dtype(self):
@@ -2595,6 +2904,100 @@ class ComputeBucketAssignmentTest(TestCase):
         self.assertEqual([[0], [1], [2, 4], [3, 5]], result)
 
 
+class PipelineTest(MultiProcessTestCase):
+
+    @property
+    def world_size(self):
+        return 3
+
+    def _model(self):
+        torch.manual_seed(0)
+        return nn.Sequential(
+            nn.Linear(4, 8), nn.ReLU(), nn.Dropout(0.5),
+            nn.Linear(8, 8), nn.Tanh(), nn.Linear(8, 2))
+
+    def _test_pipeline(self, schedule, checkpoint, chunks=4):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        c10d.init_process_group(
+            backend='gloo', store=store, rank=self.rank, world_size=self.world_size)
+        torch.manual_seed(1)
+        input = torch.randn(8, 4)
+        target = torch.randn(8, 2)
+
+        model = self._model()
+        stages = torch.nn.parallel.partition(model, [2, 2, 2])
+        pipe = torch.nn.parallel.Pipeline(
+            stages[self.rank], chunks, schedule=schedule, checkpoint=checkpoint)
+
+        # Only the stage of each process draws random numbers, for the dropout
+        # of the micro-batches in order, so a reference stage run on all the
+        # micro-batches after the same seed draws the same masks.
+        torch.manual_seed(2)
+        loss = pipe.run_batch(
+            input=input if pipe.is_first_stage() else None,
+            target=target if pipe.is_last_stage() else None,
+            loss_fn=F.mse_loss)
+
+        reference = self._model()
+        ref_stages = torch.nn.parallel.partition(reference, [2, 2, 2])
+        xs = input.chunk(chunks)
+        for stage in ref_stages:
+            torch.manual_seed(2)
+            xs = [stage(x) for x in xs]
+        ref_loss = 0
+        for x, t in zip(xs, target.chunk(chunks)):
+            l = F.mse_loss(x, t) / chunks
+            l.backward()
+            ref_loss += l.detach()
+
+        if pipe.is_last_stage():
+            self.assertEqual(loss, ref_loss)
+        else:
+            self.assertIsNone(loss)
+        for p, ref_p in zip(stages[self.rank].parameters(),
+                            ref_stages[self.rank].parameters()):
+            self.assertEqual(p.grad, ref_p.grad)
+
+    def test_pipeline_1f1b(self):
+        self._test_pipeline('1f1b', checkpoint=False)
+
+    def test_pipeline_gpipe(self):
+        self._test_pipeline('gpipe', checkpoint=False)
+
+    def test_pipeline_1f1b_checkpoint(self):
+        self._test_pipeline('1f1b', checkpoint=True)
+
+    def test_pipeline_gpipe_checkpoint(self):
+        self._test_pipeline('gpipe', checkpoint=True)
+
+    def test_pipeline_fewer_chunks_than_stages(self):
+        self._test_pipeline('1f1b', checkpoint=False, chunks=1)
+
+
+class PipelineBalanceTest(TestCase):
+    def test_partition(self):
+        model = nn.Sequential(nn.Linear(2, 2), nn.ReLU(), nn.Linear(2, 2))
+        stages = torch.nn.parallel.partition(model, [1, 2])
+        self.assertEqual(len(stages), 2)
+        self.assertIs(stages[0][0], model[0])
+        self.assertIs(stages[1][1], model[2])
+        with self.assertRaisesRegex(ValueError, "does not split"):
+            torch.nn.parallel.partition(model, [1, 1])
+
+    def test_split_costs(self):
+        from torch.nn.parallel.pipeline import _split_costs
+        self.assertEqual(_split_costs([1, 1, 1, 1], 2), [2, 2])
+        self.assertEqual(_split_costs([4, 1, 1, 1, 1], 2), [1, 4])
+        self.assertEqual(_split_costs([1, 2, 3], 3), [1, 1, 1])
+
+    def test_balance_by_time(self):
+        model = nn.Sequential(
+            nn.Linear(2, 2), nn.Linear(2, 512), nn.Linear(512, 512), nn.Linear(512, 2))
+        balance = torch.nn.parallel.balance_by_time(model, torch.randn(64, 2), 2)
+        self.assertEqual(sum(balance), len(model))
+        self.assertEqual(len(balance), 2)
+
+
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
 
@@ -2,7 +2,7 @@ import io
 import tempfile
 import unittest
 import sys
-from itertools import repeat
+from itertools import repeat, product
 import os
 from contextlib import contextmanager
 import threading
@@ -31,6 +31,8 @@ load_tests = load_tests
 # cause CUDA OOM error on Windows.
 TEST_CUDA = torch.cuda.is_available()
 TEST_MULTIGPU = TEST_CUDA and torch.cuda.device_count() >= 2
+TEST_CUDA_GRAPH = TEST_CUDA and torch.version.cuda is not None and \
+    tuple(int(v) for v in torch.version.cuda.split('.')[:2]) >= (10, 1)
 
 if not TEST_CUDA:
     print('CUDA not available, skipping tests')
@@ -808,6 +810,33 @@ class TestCuda(TestCase):
         for _ in self._test_memory_stats_generator(self):
             pass
 
+    def test_memory_snapshot(self):
+        torch.cuda.empty_cache()
+        torch.cuda._record_memory_history(True, 100)
+        x = torch.empty(1000, 1000, device='cuda')
+        address = x.data_ptr()
+
+        segments = torch.cuda.memory_snapshot()
+        segment = [s for s in segments
+                   if s['address'] <= address < s['address'] + s['total_size']]
+        self.assertEqual(len(segment), 1)
+        segment = segment[0]
+        self.assertEqual(segment['segment_type'], 'large')
+        self.assertEqual(sum(b['size'] for b in segment['blocks']), segment['total_size'])
+        self.assertGreaterEqual(segment['allocated_size'], x.numel() * x.element_size())
+        self.assertIn('active_allocated', [b['state'] for b in segment['blocks']])
+
+        del x
+        torch.cuda._record_memory_history(False)
+        actions = [e['action'] for e in torch.cuda._memory_history() if e['address'] == address]
+        self.assertEqual(actions[-2:], ['alloc', 'free'])
+
+        # the freed block stays cached until empty_cache
+        device = torch.cuda.current_device()
+        active = [b for s in torch.cuda.memory_snapshot() if s['device'] == device
+                  for b in s['blocks'] if b['state'] == 'active_allocated']
+        self.assertEqual(sum(b['size'] for b in active), torch.cuda.memory_allocated())
+
     def test_cuda_get_device_name(self):
         # Testing the behaviour with None as an argument
         current_device = torch.cuda.current_device()
@@ -1236,6 +1265,36 @@ class TestCuda(TestCase):
         ]
         self._test_reduce_add_coalesced(self, tensors, num_bytes * 5 // 2)
 
+    @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
+    def test_reduce_add_coalesced_destination_and_streams(self):
+        tensors = [torch.randn(5, 3), torch.randn(7).long(), torch.randn(2, 2)]
+        inputs = [[t.cuda(0) for t in tensors], [t.cuda(1) * 2 for t in tensors]]
+        streams = [torch.cuda.Stream(device=0), torch.cuda.Stream(device=1)]
+        for s in streams:
+            s.wait_stream(torch.cuda.current_stream(s.device))
+        # the destination doesn't have to hold the first inputs
+        results = comm.reduce_add_coalesced(inputs, destination=1, buffer_size=40,
+                                            streams=streams)
+        with torch.cuda.device(1):
+            torch.cuda.current_stream().wait_stream(streams[1])
+        for r, t in zip(results, tensors):
+            self.assertEqual(r.get_device(), 1)
+            self.assertEqual(r.cpu(), t * 3)
+
+        self.assertEqual(comm.reduce_add((inputs[0][0], inputs[1][0]), destination=1).cpu(),
+                         tensors[0] * 3)
+
+        outputs = comm.broadcast_coalesced(inputs[0], (0, 1), buffer_size=40,
+                                           streams=streams)
+        with torch.cuda.device(1):
+            torch.cuda.current_stream().wait_stream(streams[1])
+        for b, t in zip(outputs[1], tensors):
+            self.assertEqual(b.get_device(), 1)
+            self.assertEqual(b.cpu(), t)
+
+        with self.assertRaisesRegex(RuntimeError, r"Expected the device associated with the stream"):
+            comm.reduce_add_coalesced(inputs, destination=0, streams=streams[::-1])
+
     def _test_scatter(self, input, chunk_sizes=None, dim=0):
         if not TEST_MULTIGPU:
             raise unittest.SkipTest("only one GPU detected")
@@ -2056,6 +2115,88 @@ class TestCuda(TestCase):
         self.assertEqual(gpu_tensor1[0], 1)
         self.assertEqual(gpu_tensor0[0], 2)
 
+    def test_caching_pinned_memory_reserve(self):
+        torch.cuda.synchronize()
+        torch.cuda.empty_host_cache()
+        stats = torch.cuda.host_memory_stats()
+        torch.cuda.reserve_host_memory(64 * 1024 * 1024)
+        reserved = torch.cuda.host_memory_stats()
+        self.assertEqual(reserved['num_host_allocs'], stats['num_host_allocs'] + 1)
+        self.assertEqual(reserved['cached_bytes'], stats['cached_bytes'] + 64 * 1024 * 1024)
+
+        # allocations are split from the reserved region, without pinning
+        # new memory
+        tensors = [torch.empty(1024 * 1024, dtype=torch.uint8).pin_memory()
+                   for _ in range(8)]
+        tensors.append(torch.ones(10).pin_memory())
+        after = torch.cuda.host_memory_stats()
+        self.assertEqual(after['num_host_allocs'], reserved['num_host_allocs'])
+        self.assertEqual(after['allocated_bytes'], reserved['allocated_bytes'] + 8 * 1024 * 1024 + 512)
+        self.assertTrue(all(t.is_pinned() for t in tensors))
+        self.assertEqual(tensors[-1].cuda(), torch.ones(10))
+
+        # the region is released once all of its blocks are freed
+        del tensors
+        torch.cuda.synchronize()
+        torch.cuda.empty_host_cache()
+        freed = torch.cuda.host_memory_stats()
+        self.assertEqual(freed['allocated_bytes'], stats['allocated_bytes'])
+        self.assertEqual(freed['num_host_frees'], reserved['num_host_frees'] + 1)
+        self.assertGreaterEqual(freed['max_cached_bytes'], 64 * 1024 * 1024)
+
+    def test_elementwise_vectorized(self):
+        # Contiguous operands take the vectorized path when they are aligned
+        # for it. Offsets of 1 misalign them, and odd sizes leave a tail.
+        for dtype in [torch.float, torch.double, torch.half, torch.uint8]:
+            for size, offset in product([1, 3, 4, 1023, 4099], [0, 1]):
+                a = torch.randint(1, 10, (size + offset,), dtype=dtype, device='cuda')[offset:]
+                b = torch.randint(1, 10, (size + 1,), dtype=dtype, device='cuda')[1:]
+                a_cpu = a.cpu().double()
+                b_cpu = b.cpu().double()
+                self.assertEqual((a + b).double().cpu(), a_cpu + b_cpu)
+                self.assertEqual((a * b).double().cpu(), a_cpu * b_cpu)
+                self.assertEqual(a.lt(b).cpu(), a_cpu.lt(b_cpu))
+                self.assertEqual(torch.full_like(a, 7).double().cpu(), torch.full((size,), 7).double())
+                out = torch.empty_like(a)
+                torch.add(a, 2, out=out)
+                self.assertEqual(out.double().cpu(), a_cpu + 2)
+
+    def test_sort_long_slices(self):
+        # slice sizes covering the bitonic, block radix and segmented radix
+        # sorts, sorted along the last and a leading dimension
+        for size in [1000, 3000, 4096, 5000, 20000]:
+            for dtype in [torch.float, torch.double, torch.long, torch.uint8]:
+                if dtype.is_floating_point:
+                    x = torch.randn(3, size, dtype=dtype)
+                    x[1, ::7] = float('inf')
+                else:
+                    x = torch.randint(0, 100, (3, size), dtype=dtype)
+                for dim in [1, 0]:
+                    t = x if dim == 1 else x.t().contiguous()
+                    for descending in [False, True]:
+                        values, indices = t.cuda().sort(dim, descending)
+                        expected, _ = t.sort(dim, descending)
+                        self.assertEqual(values.cpu(), expected, 0)
+                        self.assertEqual(t.gather(dim, indices.cpu()), expected, 0)
+                        self.assertEqual(t.cuda().argsort(dim, descending), indices)
+
+        # non-contiguous outputs
+        x = torch.randn(8, 5000, device='cuda')
+        values = torch.empty(5000, 8, device='cuda').t()
+        indices = torch.empty(5000, 8, dtype=torch.long, device='cuda').t()
+        torch.sort(x, out=(values, indices))
+        self.assertEqual(values, x.sort()[0], 0)
+        self.assertEqual(x.gather(1, indices), values, 0)
+
+    def test_topk_large_k(self):
+        x = torch.randn(4, 20000, device='cuda')
+        for k in [100, 3000, 15000]:
+            for largest in [True, False]:
+                values, indices = x.topk(k, largest=largest)
+                expected = x.sort(descending=largest)[0][:, :k]
+                self.assertEqual(values, expected, 0)
+                self.assertEqual(x.gather(1, indices), values, 0)
+
     def test_caching_allocator_record_stream_oom(self):
         """allocations delayed by a record_stream call should still be freed on
         an out-of-memory in cuda_malloc_retry. see issue #19219"""
@@ -2076,6 +2217,89 @@ class TestCuda(TestCase):
         # cached blocks in case it affects future tests.
         torch.cuda.empty_cache()
 
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA graphs require CUDA 10.1")
+    @skipIfRocm
+    def test_graph_capture_replay(self):
+        s = torch.cuda.Stream()
+        static_input = torch.ones(1000, device='cuda')
+        # warmup, so that nothing is lazily initialized during capture
+        with torch.cuda.stream(s):
+            (static_input * 2 + 1).relu()
+        torch.cuda.current_stream().wait_stream(s)
+
+        g = torch.cuda.CUDAGraph()
+        with torch.cuda.graph(g, stream=s):
+            static_output = (static_input * 2 + 1).relu()
+        torch.cuda.synchronize()
+        self.assertEqual(static_output, torch.full_like(static_input, 3))
+
+        for value in [2., -5., 7.]:
+            static_input.fill_(value)
+            g.replay()
+            torch.cuda.synchronize()
+            expected = torch.full_like(static_input, max(value * 2 + 1, 0))
+            self.assertEqual(static_output, expected)
+
+        # The graph's memory isn't handed out outside of it
+        ptr = static_output.data_ptr()
+        del static_output
+        x = torch.empty(1000, device='cuda')
+        self.assertNotEqual(x.data_ptr(), ptr)
+        g.reset()
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA graphs require CUDA 10.1")
+    @skipIfRocm
+    def test_graph_rng(self):
+        s = torch.cuda.Stream()
+        x = torch.ones(10000, device='cuda')
+        with torch.cuda.stream(s):
+            torch.nn.functional.dropout(x, p=0.5)
+        torch.cuda.current_stream().wait_stream(s)
+
+        torch.cuda.manual_seed(5)
+        g = torch.cuda.CUDAGraph()
+        with torch.cuda.graph(g, stream=s):
+            out = torch.nn.functional.dropout(x, p=0.5)
+        results = []
+        for _ in range(3):
+            g.replay()
+            torch.cuda.synchronize()
+            results.append(out.clone())
+        # Each replay draws new numbers
+        self.assertNotEqual(results[0], results[1])
+        self.assertNotEqual(results[1], results[2])
+
+        # ... which are the numbers the same ops would draw eagerly
+        torch.cuda.manual_seed(5)
+        for expected in results:
+            self.assertEqual(torch.nn.functional.dropout(x, p=0.5), expected)
+        g.reset()
+
+    @unittest.skipIf(not TEST_CUDA_GRAPH, "CUDA graphs require CUDA 10.1")
+    @skipIfRocm
+    def test_graph_shared_pool(self):
+        s = torch.cuda.Stream()
+        a = torch.randn(1000, device='cuda')
+        with torch.cuda.stream(s):
+            (a + 1) * 2
+        torch.cuda.current_stream().wait_stream(s)
+
+        g1 = torch.cuda.CUDAGraph()
+        with torch.cuda.graph(g1, stream=s):
+            b = a + 1
+        g2 = torch.cuda.CUDAGraph()
+        with torch.cuda.graph(g2, pool=g1.pool(), stream=s):
+            c = b * 2
+        self.assertEqual(g1.pool(), g2.pool())
+
+        a.fill_(3)
+        g1.replay()
+        g2.replay()
+        torch.cuda.synchronize()
+        self.assertEqual(c, torch.full_like(a, 8))
+        g2.reset()
+        g1.reset()
+
     def test_reduction_gpu_memory_accessing(self):
         x = torch.ones(512, 8, dtype=torch.float32, device='cuda')
         torch.sum(x, 0)
@@ -2239,6 +2463,28 @@ class TestCuda(TestCase):
         with self.assertRaisesRegex(RuntimeError, r"read-only property"):
             torch.backends.cuda.cufft_plan_cache.size = -1
 
+        with self.assertRaisesRegex(RuntimeError, r"read-only property"):
+            torch.backends.cuda.cufft_plan_cache.hits = 0
+
+        # hit and miss counts
+        torch.backends.cuda.cufft_plan_cache.clear()
+        self.assertEqual(torch.backends.cuda.cufft_plan_cache.hits, 0)
+        self.assertEqual(torch.backends.cuda.cufft_plan_cache.misses, 0)
+        with plan_cache_max_size(10):
+            x = torch.randn(4, 5, device='cuda')
+            x.rfft(1)
+            self.assertEqual(torch.backends.cuda.cufft_plan_cache.misses, 1)
+            self.assertEqual(torch.backends.cuda.cufft_plan_cache.hits, 0)
+            x.rfft(1)
+            x.rfft(1)
+            self.assertEqual(torch.backends.cuda.cufft_plan_cache.misses, 1)
+            self.assertEqual(torch.backends.cuda.cufft_plan_cache.hits, 2)
+            torch.randn(4, 6, device='cuda').rfft(1)
+            self.assertEqual(torch.backends.cuda.cufft_plan_cache.misses, 2)
+        torch.backends.cuda.cufft_plan_cache.clear()
+        self.assertEqual(torch.backends.cuda.cufft_plan_cache.hits, 0)
+        self.assertEqual(torch.backends.cuda.cufft_plan_cache.misses, 0)
+
         with self.assertRaisesRegex(RuntimeError, r"but got device with index"):
             torch.backends.cuda.cufft_plan_cache[torch.cuda.device_count() + 10]
 
@@ -2427,6 +2673,22 @@ class TestCuda(TestCase):
     def test_kthvalue(self):
         _TestTorchMixin._test_kthvalue(self, device='cuda')
 
+    def test_kthvalue_slice_sizes(self):
+        # a warp per slice, a block per slice and several blocks per slice,
+        # with duplicates, unique values and non-contiguous slices
+        for num_slices, slice_size in [(1000, 9), (100, 200), (30, 3000), (2, 1 << 20), (1, 3 << 20)]:
+            for dtype in [torch.half, torch.float, torch.double, torch.long]:
+                x = torch.randint(-100, 100, (slice_size, num_slices), device='cuda').to(dtype).t()
+                for k in [1, (slice_size + 1) // 2, slice_size]:
+                    values, indices = x.kthvalue(k)
+                    self.assertEqual(values, x.sort()[0][:, k - 1])
+                    self.assertEqual(x.gather(1, indices.unsqueeze(1)).squeeze(1), values)
+                values, indices = x.median(1)
+                self.assertEqual(values, x.sort()[0][:, (slice_size - 1) // 2])
+                self.assertEqual(x.gather(1, indices.unsqueeze(1)).squeeze(1), values)
+            x = torch.randperm(num_slices * slice_size, device='cuda').view(num_slices, slice_size)
+            self.assertEqual(x.median(), (num_slices * slice_size - 1) // 2)
+
     @unittest.skipIf(not TEST_MAGMA, "no MAGMA library detected")
     def test_lu(self):
         _TestTorchMixin._test_lu(self, lambda t: t.cuda())
@@ -2454,6 +2716,48 @@ class TestCuda(TestCase):
     def test_tensor_scatterFill(self):
         _TestTorchMixin._test_scatter_base(self, lambda t: t.cuda(), 'scatter_', True, test_bounds=False)
 
+    def test_index_add_scatter_add(self):
+        # many duplicate indices, with the atomics and with the segment reduction
+        index = torch.randint(10, (1000,))
+        for dtype in [torch.half, torch.float, torch.double]:
+            src = torch.randint(-10, 10, (1000, 8), dtype=dtype)
+            dest = torch.zeros(10, 8, dtype=dtype)
+            expected_index_add = dest.double().index_add_(0, index, src.double())
+            expected_scatter_add = dest.double().scatter_add_(0, index.view(-1, 1).expand(-1, 8), src.double())
+            for deterministic in [False, True]:
+                torch.backends.cuda.deterministic_scatter = deterministic
+                try:
+                    result = dest.cuda().index_add_(0, index.cuda(), src.cuda())
+                    self.assertEqual(result.double().cpu(), expected_index_add)
+                    # odd sized rows don't take the paired half path
+                    result = dest[:, :7].cuda().index_add_(0, index.cuda(), src[:, :7].cuda())
+                    self.assertEqual(result.double().cpu(), expected_index_add[:, :7])
+                    result = dest.cuda().scatter_add_(0, index.cuda().view(-1, 1).expand(-1, 8), src.cuda())
+                    self.assertEqual(result.double().cpu(), expected_scatter_add)
+                finally:
+                    torch.backends.cuda.deterministic_scatter = False
+
+    def test_cublas_matmul_precision(self):
+        # small integers are exact in half precision, whatever the accumulation
+        a = torch.randint(-3, 3, (2, 24, 40)).cuda()
+        b = torch.randint(-3, 3, (2, 40, 16)).cuda()
+        expected = torch.bmm(a.double(), b.double())
+        matmul = torch.backends.cuda.matmul
+        self.assertFalse(matmul.allow_fp16_reduction)
+        self.assertFalse(matmul.allow_fp32_tensor_op)
+        for enabled in [False, True]:
+            matmul.allow_fp16_reduction = enabled
+            matmul.allow_fp32_tensor_op = enabled
+            try:
+                self.assertEqual(matmul.allow_fp16_reduction, enabled)
+                self.assertEqual(matmul.allow_fp32_tensor_op, enabled)
+                for dtype in [torch.half, torch.float]:
+                    self.assertEqual(torch.bmm(a.to(dtype), b.to(dtype)).double(), expected)
+                    self.assertEqual(torch.mm(a[0].to(dtype), b[0].to(dtype)).double(), expected[0])
+            finally:
+                matmul.allow_fp16_reduction = False
+                matmul.allow_fp32_tensor_op = False
+
     def test_min_max_inits(self):
         # Testing if THC_reduceAll received the correct index initialization.
         # This affects the result of THC_reduceAll operations at extreme values
@@ -17,7 +17,7 @@ from torch.onnx import OperatorExportTypes
 from torch._six import inf, PY2, builtins, StringIO
 from common_utils import TestCase, run_tests, IS_WINDOWS, TEST_WITH_UBSAN, \
     skipIfRocm, skipIfNoLapack, suppress_warnings, load_tests, IS_SANDCASTLE, \
-    freeze_rng_state, set_rng_seed, slowTest
+    freeze_rng_state, set_rng_seed, slowTest, TEST_MKL
 from common_nn import module_tests, new_module_tests, criterion_tests
 from textwrap import dedent
 from functools import wraps, reduce
@@ -1246,6 +1246,38 @@ graph(%x : Tensor,
         self.run_pass('cse', graph)
         FileCheck().run(input_str, graph)
 
+    def test_cse_sibling_blocks(self):
+        # an expression of a block is not available in its sibling blocks,
+        # nor after the node that owns it
+        input_str = """
+graph(%x : int,
+      %c : bool):
+  %1 : int = prim::Constant[value=1]()
+  %2 : int = prim::Constant[value=2]()
+  %z : int = prim::If(%c)
+    block0():
+      # CHECK: aten::add(%x, %1)
+      %a : int = aten::add(%x, %1)
+      # CHECK-NOT: aten::add(%x, %1)
+      %b : int = aten::add(%x, %1)
+      # CHECK: aten::mul
+      %c1 : int = aten::mul(%a, %b)
+      -> (%c1)
+    block1():
+      # CHECK: aten::add(%x, %1)
+      %d : int = aten::add(%x, %1)
+      # CHECK: aten::add(%x, %2)
+      %e : int = aten::add(%x, %2)
+      -> (%e)
+  # CHECK: aten::add(%x, %1)
+  %f : int = aten::add(%x, %1)
+  %g : int = aten::add(%z, %f)
+  return (%g)
+"""
+        graph = parse_ir(input_str)
+        self.run_pass('cse', graph)
+        FileCheck().run(input_str, graph)
+
     def test_expand_propagate_qinfo(self):
         pass
 
@@ -1439,6 +1471,55 @@ graph(%x : Tensor,
                    .check_next("int_repr").check("dequantize_linear") \
                    .run(str(trace.graph))
 
+    def test_quant_fusion_folds_requantization(self):
+        input_str = """
+graph(%x):
+  %scale : float = prim::Constant[value=0.1]()
+  %zero_point : int = prim::Constant[value=10]()
+  %x_quant = aten::quantize_linear(%x, %scale, %zero_point)
+  %x_intrepr = aten::int_repr(%x_quant)
+  %x_dequant = aten::dequantize_linear(%x_intrepr, %scale, %zero_point)
+  %y_quant = aten::quantize_linear(%x_dequant, %scale, %zero_point)
+  %y_intrepr = aten::int_repr(%y_quant)
+  %y_dequant = aten::dequantize_linear(%y_intrepr, %scale, %zero_point)
+  return (%y_dequant)"""
+        graph = parse_ir(input_str)
+        torch._C._jit_pass_quant_fusion(graph)
+        FileCheck().check_count("aten::quantize_linear", 1, exactly=True) \
+                   .check_count("aten::dequantize", 1, exactly=True) \
+                   .check_not("int_repr").run(str(graph))
+
+    @unittest.skipIf(TEST_WITH_UBSAN or not torch.fbgemm_is_cpu_supported(),
+                     'Quantized kernels require FBGEMM. FBGEMM does not play'
+                     ' well with UBSAN at the moment, so we skip the test if'
+                     ' we are in a UBSAN environment.')
+    def test_quantize_function(self):
+        linear1 = nn.Linear(8, 16).requires_grad_(False)
+        linear2 = nn.Linear(16, 4).requires_grad_(False)
+        conv = nn.Conv2d(3, 8, 3, padding=1).requires_grad_(False)
+
+        def fn(x, y):
+            return linear2(F.relu(linear1(x))), conv(y)
+
+        inputs = [(torch.rand(4, 8), torch.rand(2, 3, 6, 6)) for _ in range(4)]
+        traced = torch.jit.trace(fn, inputs[0])
+        for per_channel in [False, True]:
+            quantized = torch.jit.quantized.quantize_function(
+                traced, inputs, per_channel=per_channel)
+            FileCheck().check("quantized::fbgemm_linear_relu") \
+                       .check("quantized::fbgemm_linear(") \
+                       .check("quantized::fbgemm_conv2d(") \
+                       .run(str(quantized.graph))
+            FileCheck().check_not("aten::addmm").check_not("aten::_convolution") \
+                       .check_not("int_repr").check_not("prepack") \
+                       .run(str(quantized.graph))
+            for x, y in inputs:
+                for out, ref in zip(quantized(x, y), fn(x, y)):
+                    self.assertEqual(out, ref, prec=0.1)
+        # the function we started from is left intact
+        FileCheck().check("aten::addmm").check_not("quantize_linear") \
+                   .run(str(traced.graph))
+
     def test_pattern_based_rewrite(self):
         # mul(mul(mul(mul(x,y),z),x),y) --> mul(mul(mulmul(x,y,z), x), y) -->
         # --> mulmul(mulmul(x,y,z), x, y)
@@ -1697,6 +1778,29 @@ graph(%Ra, %Rb):
     def test_trace_size_with_grad(self):
         self.do_trace_size(True)
 
+    def test_trace_cache(self):
+        def fn(x):
+            return x.view(x.size(1), -1) * 2
+
+        x = torch.rand(2, 3)
+        traced = torch.jit.trace(fn, x, cache=True)
+        self.assertIs(torch.jit.trace(fn, torch.rand(2, 3), cache=True), traced)
+        self.assertIsNot(torch.jit.trace(fn, torch.rand(3, 3), cache=True), traced)
+        self.assertIsNot(torch.jit.trace(fn, x.double(), cache=True), traced)
+        self.assertIsNot(torch.jit.trace(fn, x.requires_grad_(), cache=True), traced)
+        self.assertIsNot(torch.jit.trace(fn, torch.rand(2, 3)), traced)
+
+    def test_trace_without_source_locations(self):
+        def fn(x):
+            return x * 2 + 1
+
+        traced = torch.jit.trace(fn, torch.rand(2), record_source_locations=False)
+        for n in traced.graph.nodes():
+            self.assertIsNone(n.getSourceLocation())
+
+        traced = torch.jit.trace(fn, torch.rand(2))
+        self.assertTrue(any(n.getSourceLocation() is not None for n in traced.graph.nodes()))
+
     def test_trace_casts(self):
         casts = [
             lambda x: x.byte(),
@@ -2420,6 +2524,124 @@ graph(%Ra, %Rb):
         does_decompose()
         doesnt_decompose()
 
+    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
+    def test_prepack_weights_linear(self):
+        linear = torch.nn.Linear(16, 8)
+        linear.requires_grad_(False)
+        x = torch.randn(4, 3, 16)
+
+        packed = torch.mkl_pack_linear_weight(linear.weight)
+        self.assertEqual(torch.mkl_linear_packed_weight(x, packed, linear.bias), linear(x))
+        self.assertEqual(torch.mkl_linear_packed_weight(x, packed), linear(x) - linear.bias)
+
+        # closed over, the parameters are traced as graph constants; a 2-d
+        # input is traced to addmm, others to matmul
+        for x in [torch.randn(4, 16), torch.randn(4, 3, 16)]:
+            traced = torch.jit.trace(lambda x: linear(x), x)
+            self.run_pass('prepack_weights', traced.graph)
+            FileCheck().check("aten::mkl_linear_packed_weight").check_not("aten::addmm") \
+                .check_not("aten::matmul").run(str(traced.graph))
+            # the weight is packed once for every batch size
+            for batch in [1, 7]:
+                x = torch.randn((batch,) + x.shape[1:])
+                self.assertEqual(traced(x), linear(x))
+
+    @unittest.skipIf(not torch._C.has_mkldnn, "MKL-DNN build is disabled")
+    def test_prepack_weights_conv2d(self):
+        conv = torch.nn.Conv2d(4, 8, 3, padding=1, groups=2)
+        conv.requires_grad_(False)
+        x = torch.randn(2, 4, 10, 10)
+
+        traced = torch.jit.trace(lambda x: conv(x), x)
+        self.run_pass('prepack_weights', traced.graph)
+        FileCheck().check("aten::mkldnn_convolution").check_not("aten::_convolution") \
+            .run(str(traced.graph))
+        self.assertEqual(traced(x), conv(x), prec=1e-4)
+        # strided inputs are made contiguous before MKL-DNN views them
+        x = torch.randn(2, 10, 10, 4).permute(0, 3, 1, 2)
+        self.assertEqual(traced(x), conv(x), prec=1e-4)
+
+    def test_freeze_module(self):
+        class ConvBN(torch.jit.ScriptModule):
+            def __init__(self):
+                super(ConvBN, self).__init__()
+                self.conv = torch.nn.Conv2d(3, 8, 3, bias=False)
+                self.bn = torch.nn.BatchNorm2d(8)
+                self.scale = torch.nn.Parameter(torch.rand(1))
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return self.bn(self.conv(x)) * self.scale
+
+        m = ConvBN()
+        m.bn.running_mean.uniform_()
+        m.bn.running_var.uniform_(1, 2)
+        x = torch.randn(2, 3, 10, 10)
+        frozen = torch.jit.ScriptModule()
+        with self.assertRaisesRegex(RuntimeError, "eval mode"):
+            torch._C._jit_pass_freeze_module(m._c, frozen._c)
+
+        m.eval()
+        frozen = torch.jit.ScriptModule()
+        torch._C._jit_pass_freeze_module(m._c, frozen._c)
+        self.assertEqual(len(list(frozen.parameters())), 0)
+        # the weights are constants, and batch norm is folded into the conv
+        FileCheck().check_not("aten::batch_norm").check_not("prim::GetAttr") \
+            .run(str(frozen.graph))
+        self.assertEqual(frozen(x), m(x), prec=1e-5)
+
+        class Mutating(torch.jit.ScriptModule):
+            def __init__(self):
+                super(Mutating, self).__init__()
+                self.register_buffer('count', torch.zeros(1))
+
+            @torch.jit.script_method
+            def forward(self, x):
+                self.count += 1
+                return x + self.count
+
+        m = Mutating()
+        m.eval()
+        with self.assertRaisesRegex(RuntimeError, "mutates"):
+            torch._C._jit_pass_freeze_module(m._c, torch.jit.ScriptModule()._c)
+
+    def test_convert_to_inplace_ops(self):
+        def fn(x, y):
+            a = x + y
+            b = torch.relu(a)
+            c = b * 2
+            d = c + y
+            return d, torch.sigmoid(x)
+
+        x, y = torch.randn(2, 3), torch.randn(2, 3)
+        graph = torch.jit.trace(fn, (x, y)).graph.copy()
+        self.run_pass('convert_to_inplace_ops', graph)
+        # the inputs are never written to
+        FileCheck().check("aten::add(").check("aten::relu_").check("aten::mul_") \
+                   .check("aten::add_").check("aten::sigmoid(").run(str(graph))
+        inplace = torch._C._create_function_from_graph("fn", graph)
+        x_copy, y_copy = x.clone(), y.clone()
+        self.assertEqual(inplace(x, y), fn(x, y))
+        self.assertEqual(x, x_copy)
+        self.assertEqual(y, y_copy)
+
+        def read_after(x):
+            a = x * 2
+            b = torch.relu(a)
+            return b + a
+
+        graph = torch.jit.trace(read_after, x).graph.copy()
+        self.run_pass('convert_to_inplace_ops', graph)
+        FileCheck().check("aten::relu(").check("aten::add_").run(str(graph))
+
+        def broadcast(x, y):
+            a = x * 2
+            return a + y
+
+        graph = torch.jit.trace(broadcast, (torch.randn(3), y)).graph.copy()
+        self.run_pass('convert_to_inplace_ops', graph)
+        FileCheck().check("aten::mul(").check("aten::add(").run(str(graph))
+
     def test_index_put(self):
         ten = torch.zeros(3, 3)
         mask = torch.Tensor([[True, True, True],
@@ -5700,6 +5922,135 @@ a")
         g = torch.jit.last_executed_optimized_graph()
         self.assertEqual(next(g.outputs()).type().str(), "Tensor")
 
+    def test_profiling_executor(self):
+        @torch.jit.script
+        def fn(x, y):
+            return x * y + x
+
+        old_mode = torch._C._jit_set_profiling_mode(True)
+        try:
+            x, y = torch.randn(2, 3), torch.randn(2, 3)
+            for _ in range(3):
+                self.assertEqual(fn(x, y), x * y + x)
+                g = torch.jit.last_executed_optimized_graph()
+                self.assertTrue(any(n.kind() == 'prim::profile' for n in g.nodes()))
+
+            # the observed shapes are stable, so the graph gets specialized to them
+            self.assertEqual(fn(x, y), x * y + x)
+            g = torch.jit.last_executed_optimized_graph()
+            self.assertFalse(any(n.kind() == 'prim::profile' for n in g.nodes()))
+            self.assertEqual(next(g.inputs()).type().kind(), 'CompleteTensorType')
+
+            # a new shape fails the guards and gets profiled again
+            x, y = torch.randn(4, 5), torch.randn(4, 5)
+            self.assertEqual(fn(x, y), x * y + x)
+            g = torch.jit.last_executed_optimized_graph()
+            self.assertTrue(any(n.kind() == 'prim::profile' for n in g.nodes()))
+        finally:
+            torch._C._jit_set_profiling_mode(old_mode)
+
+    def test_profiling_executor_symbolic_batch(self):
+        @torch.jit.script
+        def fn(x):
+            y = x.view(x.size(0), -1)
+            return y * 2, x.size(1)
+
+        old_mode = torch._C._jit_set_profiling_mode(True)
+        try:
+            for batch in [2, 5, 2]:
+                x = torch.randn(batch, 6)
+                self.assertEqual(fn(x), (x * 2, 6))
+
+            # the batch size varied while profiling, so it stays symbolic,
+            # while the sizes that didn't are specialized to
+            x = torch.randn(7, 6)
+            self.assertEqual(fn(x), (x * 2, 6))
+            g = torch.jit.last_executed_optimized_graph()
+            self.assertFalse(any(n.kind() == 'prim::profile' for n in g.nodes()))
+            FileCheck().check_not("aten::view").check_not("aten::size").run(str(g))
+
+            # a size that didn't vary fails the guards
+            x = torch.randn(3, 8)
+            self.assertEqual(fn(x), (x * 2, 8))
+            g = torch.jit.last_executed_optimized_graph()
+            self.assertTrue(any(n.kind() == 'prim::profile' for n in g.nodes()))
+        finally:
+            torch._C._jit_set_profiling_mode(old_mode)
+
+    def test_specialize_symbolic_shapes(self):
+        graph = parse_ir("""
+        graph(%x : Float(*, *), %w : Float(4, 3)):
+          %0 : int = prim::Constant[value=0]()
+          %1 : int = prim::Constant[value=1]()
+          %minus_one : int = prim::Constant[value=-1]()
+          %false : bool = prim::Constant[value=0]()
+          %y : Float(*, *) = aten::relu(%x)
+          %sizes : int[] = aten::size(%x)
+          %e : Float(*, *) = aten::expand(%y, %sizes, %false)
+          %batch : int = aten::size(%e, %0)
+          %view_sizes : int[] = prim::ListConstruct(%batch, %minus_one)
+          %v : Float(*, *) = aten::view(%e, %view_sizes)
+          %wt : Float(3, 4) = aten::t(%w)
+          %z : Float(*, *) = aten::mm(%v, %wt)
+          %n : int = aten::size(%z, %1)
+          return (%z, %n)
+        """)
+        torch._C._jit_pass_specialize_symbolic_shapes(graph)
+        # y keeps the sizes of x, whose batch dimension is symbolic, and
+        # z has 4 columns whatever the batch size
+        FileCheck().check_not("aten::expand").check_not("aten::view").run(str(graph))
+        FileCheck().check("aten::mm").check_not("aten::size") \
+            .check("prim::Constant[value=4]").run(str(graph))
+
+    def test_plan_memory(self):
+        def fn(x, y):
+            a = x * y
+            b = a + x
+            c = b * a
+            return c.relu()
+
+        x, y = torch.randn(3, 4), torch.randn(3, 4)
+        traced = torch.jit.trace(fn, (x, y))
+        g = traced.graph.copy()
+        torch._C._jit_pass_plan_memory(g)
+        # the output of relu is returned, so it isn't planned
+        FileCheck().check("prim::MemoryArena").check_count("prim::ArenaBuffer", 3, exactly=True) \
+            .check("aten::relu").run(str(g))
+
+        fn_script = torch.jit.script(fn)
+        old_mode = torch._C._jit_set_profiling_mode(True)
+        try:
+            with torch.no_grad():
+                for _ in range(4):
+                    self.assertEqual(fn_script(x, y), fn(x, y))
+                g = torch.jit.last_executed_optimized_graph()
+                self.assertTrue(any(n.kind() == 'prim::MemoryArena' for n in g.nodes()))
+        finally:
+            torch._C._jit_set_profiling_mode(old_mode)
+
+    def test_interpreter_inline_ops(self):
+        def fn(xs, fs, ts, n):
+            # type: (List[int], List[float], List[Tensor], int) -> Tuple[int, float, Tensor, bool]
+            total = 0
+            ftotal = 0.0
+            t = ts[-1]
+            i = 0
+            while i < n and i != 7:
+                total = total + xs[i] * 2 - xs[-1 - i]
+                ftotal = ftotal + fs[i]
+                if i >= 2 or i == 0:
+                    t = t + ts[i]
+                i = i + 1
+            return total, ftotal, t, i <= n
+
+        fn_script = torch.jit.script(fn)
+        xs, fs = [1, 2, 3, 4, 5], [0.5, 1.5, 2.5, 3.5, 4.5]
+        ts = [torch.randn(2) for _ in range(5)]
+        for n in range(6):
+            self.assertEqual(fn_script(xs, fs, ts, n), fn(xs, fs, ts, n))
+        with self.assertRaisesRegex(RuntimeError, "list index out of range"):
+            fn_script(xs, fs, ts, 6)
+
     def test_optional_list(self):
         @torch.jit.script
         def fn(x, y):
@@ -6826,6 +7177,48 @@ a")
             for out, ref_out in zip(outs, ref_outs):
                 torch.testing.assert_allclose(out, ref_out)
 
+    @unittest.skipIf(TEST_WITH_UBSAN or not torch.fbgemm_is_cpu_supported(),
+                     'Quantized RNN requires FBGEMM. FBGEMM does not play'
+                     ' well with UBSAN at the moment, so we skip the test if'
+                     ' we are in a UBSAN environment.')
+    def test_rnn_quantized(self):
+        from torch.nn.utils.rnn import pack_padded_sequence, pad_packed_sequence
+        d_in, d_hid, seq_len, batch = 4, 3, 5, 3
+
+        def flatten(hidden):
+            return list(hidden) if isinstance(hidden, tuple) else [hidden]
+
+        for rnn in [
+            torch.nn.LSTM(d_in, d_hid, num_layers=2, bidirectional=True).float(),
+            torch.nn.GRU(d_in, d_hid, num_layers=2, bidirectional=True).float(),
+        ]:
+            ref = copy.deepcopy(rnn)
+            rnn = torch.jit.quantized.quantize_rnn_modules(rnn)
+            x = torch.randn(seq_len, batch, d_in)
+
+            # int8 weights and activations only approximate the float results
+            out, hidden = rnn(x)
+            ref_out, ref_hidden = ref(x)
+            self.assertEqual(out, ref_out, prec=0.1)
+            for h, ref_h in zip(flatten(hidden), flatten(ref_hidden)):
+                self.assertEqual(h, ref_h, prec=0.1)
+
+            # sequences of the same length take the same steps when packed
+            packed_out, packed_hidden = rnn(pack_padded_sequence(x, [seq_len] * batch))
+            self.assertEqual(pad_packed_sequence(packed_out)[0], out)
+            for h, packed_h in zip(flatten(hidden), flatten(packed_hidden)):
+                self.assertEqual(h, packed_h)
+
+            lengths = [5, 3, 2]
+            packed_out, packed_hidden = rnn(pack_padded_sequence(x, lengths))
+            ref_out, ref_hidden = ref(pack_padded_sequence(x, lengths))
+            self.assertEqual(pad_packed_sequence(packed_out)[0], pad_packed_sequence(ref_out)[0], prec=0.1)
+            for h, ref_h in zip(flatten(packed_hidden), flatten(ref_hidden)):
+                self.assertEqual(h, ref_h, prec=0.1)
+
+            imported = self.getExportImportCopyWithPacking(rnn)
+            self.assertEqual(imported.forward_tensor(x), rnn(x))
+
     def test_script_module(self):
         class M1(torch.jit.ScriptModule):
             def __init__(self):
@@ -9413,6 +9806,47 @@ a")
         self.assertEqual(torch.autograd.grad(slstm(*inputs).sum(), inputs),
                          torch.autograd.grad(lstm(*inputs).sum(), inputs))
 
+    def test_mm_batching_shared_input_linears(self):
+        q, k, v = [torch.nn.Linear(16, n) for n in [8, 8, 4]]
+        for m in [q, k, v]:
+            m.requires_grad_(False)
+        k.bias = None
+
+        def qkv(x):
+            return q(x), k(x), v(x)
+
+        # closed over, the weights are traced as graph constants, and the
+        # layers as addmm, or matmul without a bias
+        x = torch.randn(5, 16)
+        traced = torch.jit.trace(qkv, x)
+        self.run_pass('batch_mm', traced.graph)
+        FileCheck().check_count("aten::linear", 1, exactly=True) \
+            .check("aten::split_with_sizes").check_not("aten::addmm") \
+            .check_not("aten::matmul").run(str(traced.graph))
+        self.assertEqual(traced(x), qkv(x))
+        self.assertEqual(traced(torch.randn(1, 16)), qkv(torch.randn(1, 16)))
+
+    def test_mm_batching_independent_linears(self):
+        def towers(x0, x1, x2, x3, w0, w1, w2, w3, b0, b1, b2, b3):
+            return (torch.addmm(b0, x0, w0), torch.addmm(b1, x1, w1),
+                    torch.addmm(b2, x2, w2), torch.addmm(b3, x3, w3))
+
+        inputs = [torch.randn(5, 16) for _ in range(4)] + \
+                 [torch.randn(16, 8) for _ in range(4)] + \
+                 [torch.randn(8) for _ in range(4)]
+        scripted = torch.jit.script(towers)
+        graph = scripted.graph
+        # the layers are only batched once shape analysis found their sizes
+        self.run_pass('batch_mm', graph)
+        FileCheck().check_not("prim::MMBatchLinear").run(str(graph))
+        torch._C._jit_pass_complete_shape_analysis(graph, tuple(inputs), False)
+        self.run_pass('batch_mm', graph)
+        FileCheck().check("prim::MMBatchLinear").check_not("aten::addmm").run(str(graph))
+        self.assertEqual(scripted(*inputs), towers(*inputs))
+        # layers of other shapes are computed one by one
+        inputs[0] = torch.randn(3, 16)
+        self.assertEqual(scripted(*inputs), towers(*inputs))
+
     def test_loop_unrolling(self):
         def fn(x):
             y = 0
@@ -9492,6 +9926,70 @@ a")
         self.checkScript(fn, (torch.tensor(1),))
         self.checkScript(fn, (torch.tensor(2),))
 
+    def test_loop_invariant_code_motion(self):
+        def fn(x, w, n):
+            # type: (Tensor, Tensor, int) -> Tensor
+            y = x
+            for _ in range(n):
+                y = torch.mm(y, w.t())
+            return y
+
+        graph = torch.jit.script(fn).graph
+        self.run_pass('loop_invariant_code_motion', graph)
+        # the loop may not run, so the hoisted transpose is guarded by an If
+        FileCheck().check("prim::If").check("aten::t").check("prim::Loop") \
+            .check_not("aten::t").check("aten::mm").run(str(graph))
+        x, w = torch.randn(3, 3), torch.randn(3, 3)
+        self.checkScript(fn, (x, w, 4))
+        self.checkScript(fn, (x, w, 0))
+
+    def test_loop_invariant_code_motion_mutation(self):
+        def fn(x, w):
+            y = x
+            for _ in range(3):
+                w.add_(1)
+                y = y + w.t()
+            return y
+
+        graph = torch.jit.script(fn).graph
+        self.run_pass('loop_invariant_code_motion', graph)
+        FileCheck().check_not("aten::t").check("prim::Loop").check("aten::t") \
+            .run(str(graph))
+        self.checkScript(fn, (torch.randn(3, 3), torch.randn(3, 3)))
+
+    def test_loop_fusion(self):
+        def fn(x, y):
+            a = x
+            b = y
+            for _ in range(4):
+                a = a * 2
+            for _ in range(4):
+                b = b + 1
+            return a, b
+
+        graph = torch.jit.script(fn).graph
+        self.run_pass('loop_fusion', graph)
+        FileCheck().check_count("prim::Loop", 1, exactly=True).check("aten::mul") \
+            .check("aten::add").run(str(graph))
+        self.checkScript(fn, (torch.randn(3), torch.randn(3)))
+
+    def test_loop_fusion_dependent(self):
+        def fn(x, n):
+            # type: (Tensor, int) -> Tensor
+            a = x
+            b = x
+            for _ in range(n):
+                a = a * 2
+            for _ in range(n):
+                b = b + a
+            return b
+
+        graph = torch.jit.script(fn).graph
+        self.run_pass('loop_fusion', graph)
+        # the second loop reads the result of the first one
+        FileCheck().check_count("prim::Loop", 2, exactly=True).run(str(graph))
+        self.checkScript(fn, (torch.randn(3), 3))
+
     def test_where(self):
         def fn(x, y):
             return torch.where(x > 0.0, x, y)
@@ -12203,6 +12701,41 @@ a")
             self.assertEqual(out[2], 99)
             self.assertEqual(out[6], [1, 2, 3, 4])
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: TemporaryFileName support for Windows or Sandcastle")
+    @unittest.skipIf(PY2, "Lists pickled as bytes need python 3 to unpickle")
+    def test_attribute_unpickling_large_lists(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.int_list = torch.jit.Attribute(list(range(-500, 500)), List[int])
+                self.float_list = torch.jit.Attribute([i / 4.0 for i in range(1000)], List[float])
+                self.small_int_list = torch.jit.Attribute([1, 2, 3], List[int])
+
+            @torch.jit.script_method
+            def forward(self):
+                return (self.int_list, self.float_list, self.small_int_list)
+
+        m = M()
+        with TemporaryFileName() as fname:
+            m.save(fname)
+            archive_name = os.path.basename(os.path.normpath(fname))
+            archive = zipfile.ZipFile(fname, 'r')
+            pickled_data = archive.read(os.path.join(archive_name, 'attributes.pkl'))
+            out = pickle.load(io.BytesIO(pickled_data))
+            self.assertEqual(out[0], list(range(-500, 500)))
+            self.assertEqual(out[1], [i / 4.0 for i in range(1000)])
+            self.assertEqual(out[2], [1, 2, 3])
+
+            # the large lists are stored as raw bytes rather than per element
+            disassembled = StringIO()
+            pickletools.dis(pickled_data, out=disassembled)
+            FileCheck().check("build_intlist_from_bytes").check("BINBYTES") \
+                .check("build_floatlist_from_bytes").check("BINBYTES") \
+                .check("build_intlist").run(disassembled.getvalue())
+
+            loaded = torch.jit.load(fname)
+            self.assertEqual(loaded(), m())
+
     @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: TemporaryFileName support for Windows or Sandcastle")
     def test_old_models_bc(self):
         model = {
@@ -13685,24 +14218,25 @@ nn_functional_tests = [
     ('relu', (S, S, S), (), '', (True,)),
     ('relu', (S, S, S), (), 'inplace'),
     ('glu', (S - 1, S - 1, S - 1), (),),
-    ('hardtanh', (S, S, S), (-0.5, 0.5),),
+    ('hardtanh', (S, S, S), (-0.5, 0.5), '', (True,)),
     ('hardtanh', (S, S, S), (-0.5, 0.5, True), 'inplace'),
     ('relu6', (S, S, S), (),),
     ('relu6', (S, S, S), (True), 'inplace'),
-    ('elu', (S, S, S), (0.9,),),
+    ('elu', (S, S, S), (0.9,), '', (True,)),
     ('elu', (S, S, S), (0.9, True), 'inplace'),
-    ('selu', (S, S, S), (),),
+    ('selu', (S, S, S), (), '', (True,)),
     ('selu', (S, S, S), (True), 'inplace'),
-    ('celu', (S, S, S), (0.9,),),
+    ('celu', (S, S, S), (0.9,), '', (True,)),
     ('celu', (S, S, S), (0.9, True), 'inplace'),
-    ('leaky_relu', (S, S, S), (0.02,),),
+    ('leaky_relu', (S, S, S), (0.02,), '', (True,)),
     ('leaky_relu', (S, S, S), (0.02,), 'inplace'),
     ('rrelu', (S, S), (0.1, 0.3, False),),
     ('rrelu', (S, S), (0.1, 0.3, False, True), 'inplace'),
-    ('hardshrink', (S, S, S), (0.4,),),
+    ('hardshrink', (S, S, S), (0.4,), '', (True,)),
+    ('softshrink', (S, S, S), (0.4,), '', (True,)),
     ('tanhshrink', (S, S, S), (),),
     ('softsign', (S, S, S), (),),
-    ('softplus', (S, S, S), (),),
+    ('softplus', (S, S, S), (), '', (True,)),
     ('softmin', (S, S, S), (0,),),
     ('softmax', (S, S, S), (0,), '', (True,)),
     ('softmax', (S, S, S), (0, 3, torch.double), 'with_all_args', (True,)),
@@ -14325,6 +14859,23 @@ class TestAsync(JitTestCase):
         self.assertEqual(y2, foo2(x1, x2))
         self.assertEqual(y3, foo3(x1, x2, x3))
 
+    def test_async_interop_threads(self):
+        @torch.jit.script
+        def foo(x):
+            return torch.neg(x)
+
+        @torch.jit.script
+        def wait_script(x):
+            fut = torch.jit._fork(foo, x)
+            return torch.jit._wait(fut)
+
+        x = torch.rand(3, 4)
+        self.assertEqual(wait_script(x), torch.neg(x))
+        self.assertGreater(torch.get_num_interop_threads(), 0)
+        # the pool is sized on first use and can't be resized afterwards
+        with self.assertRaisesRegex(RuntimeError, "interop threads"):
+            torch.set_num_interop_threads(2)
+
     def test_async_script_trace(self):
         class Traced(nn.Module):
             def __init__(self):
@@ -14561,6 +15112,54 @@ class TestAsync(JitTestCase):
             extra_files['bar'] = ''
             torch.jit.load(buffer, _extra_files=extra_files)
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: TemporaryFileName support for Windows or Sandcastle")
+    def test_save_load_for_mobile(self):
+        class Sub(torch.jit.ScriptModule):
+            def __init__(self):
+                super(Sub, self).__init__()
+                self.weight = nn.Parameter(torch.randn(4, 4))
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return torch.mm(x, self.weight)
+
+        class MyMod(torch.jit.ScriptModule):
+            def __init__(self):
+                super(MyMod, self).__init__()
+                self.sub = Sub()
+                self.register_buffer('bias', torch.randn(4))
+
+            @torch.jit.script_method
+            def forward(self, x, n):
+                # type: (Tensor, int) -> Tuple[Tensor, List[int]]
+                sizes = [1, 2]
+                for i in range(n):
+                    if i % 2 == 0:
+                        x = self.sub(x) + self.bias
+                    else:
+                        x = torch.relu(x)
+                    sizes.append(i)
+                return x, sizes
+
+            @torch.jit.script_method
+            def scale(self, x):
+                return x * 2
+
+        m = MyMod()
+        x = torch.randn(3, 4)
+        with TemporaryFileName() as fname:
+            m._save_for_mobile(fname)
+            mobile = torch._C._load_for_mobile(fname)
+            # the archive can still be loaded by the full runtime
+            loaded = torch.jit.load(fname)
+
+        # a list constant is not shared between runs
+        for _ in range(2):
+            self.assertEqual(mobile.forward(x, 3), m(x, 3))
+        self.assertEqual(mobile.run_method('scale', x), m.scale(x))
+        self.assertEqual(loaded(x, 3), m(x, 3))
+        self.assertFalse(mobile.forward(x, 1)[0].requires_grad)
+
 
 class TestDataParallel(JitTestCase):
     class Mpy(torch.nn.Module):
@@ -3,6 +3,9 @@ from __future__ import division
 from __future__ import print_function
 from __future__ import unicode_literals
 
+import os
+import shutil
+import tempfile
 import unittest
 import torch
 import torch.nn as nn
@@ -48,6 +51,141 @@ class TestFuser(JitTestCase):
     def test_abs_cuda(self):
         self._test_fused_abs(device="cuda")
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_kernel_disk_cache_cpu(self):
+        def fn(x, y):
+            return (x * y + x).sigmoid() * 3
+
+        def cached_libraries():
+            return [f for f in os.listdir(cache_dir) if f.endswith('.so')]
+
+        cache_dir = tempfile.mkdtemp()
+        old_cache_dir = torch._C._jit_get_fuser_kernel_cache_dir()
+        torch._C._jit_set_fuser_kernel_cache_dir(cache_dir)
+        try:
+            x, y = torch.randn(4, 4), torch.randn(4, 4)
+            scripted = torch.jit.script(fn)
+            self.assertEqual(scripted(x, y), fn(x, y))
+            self.assertAllFused(scripted.graph_for(x, y))
+            libraries = cached_libraries()
+            self.assertEqual(len(libraries), 1)
+            self.assertTrue(os.path.exists(os.path.join(cache_dir, libraries[0][:-3] + '.cpp')))
+
+            # a new argument specialization is a new entry
+            x_t = x.t()
+            self.assertEqual(scripted(x_t, y), fn(x_t, y))
+            self.assertEqual(len(cached_libraries()), 2)
+            self.assertFalse(any(f.startswith('tmp_fuser') for f in os.listdir(cache_dir)))
+        finally:
+            torch._C._jit_set_fuser_kernel_cache_dir(old_cache_dir)
+            shutil.rmtree(cache_dir)
+
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_contiguous_kernel_simd_cpu(self):
+        def fn(x, y):
+            return (x * y + x).relu() * 3
+
+        def kernel_sources():
+            return {f: open(os.path.join(cache_dir, f)).read()
+                    for f in os.listdir(cache_dir) if f.endswith('.cpp')}
+
+        cache_dir = tempfile.mkdtemp()
+        old_cache_dir = torch._C._jit_get_fuser_kernel_cache_dir()
+        torch._C._jit_set_fuser_kernel_cache_dir(cache_dir)
+        try:
+            x, y = torch.randn(64, 33), torch.randn(64, 33)
+            scripted = torch.jit.script(fn)
+            self.assertEqual(scripted(x, y), fn(x, y))
+            sources = kernel_sources()
+            self.assertEqual(len(sources), 1)
+            contiguous = next(iter(sources))
+            FileCheck().check("omp parallel for simd").run(sources[contiguous])
+
+            # strided arguments use the generic indexing, without simd
+            x_t = x.t().contiguous().t()
+            self.assertEqual(scripted(x_t, y), fn(x_t, y))
+            sources = kernel_sources()
+            self.assertEqual(len(sources), 2)
+            strided = [f for f in sources if f != contiguous][0]
+            FileCheck().check("omp parallel for").check_not("simd").run(sources[strided])
+        finally:
+            torch._C._jit_set_fuser_kernel_cache_dir(old_cache_dir)
+            shutil.rmtree(cache_dir)
+
+    @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
+    @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
+    @skipIfRocm
+    def test_kernel_disk_cache_cuda(self):
+        def fn(x, y):
+            return (x * y + x).sigmoid() * 3
+
+        def cached_ptx():
+            return [f for f in os.listdir(cache_dir) if f.endswith('.ptx')]
+
+        cache_dir = tempfile.mkdtemp()
+        old_cache_dir = torch._C._jit_get_fuser_kernel_cache_dir()
+        torch._C._jit_set_fuser_kernel_cache_dir(cache_dir)
+        try:
+            x, y = torch.randn(4, 4, device='cuda'), torch.randn(4, 4, device='cuda')
+            scripted = torch.jit.script(fn)
+            self.assertEqual(scripted(x, y), fn(x, y))
+            self.assertAllFused(scripted.graph_for(x, y))
+            self.assertEqual(len(cached_ptx()), 1)
+
+            # devices of the same compute capability share the PTX
+            if torch.cuda.device_count() > 1 and \
+                    torch.cuda.get_device_capability(0) == torch.cuda.get_device_capability(1):
+                x1, y1 = x.to('cuda:1'), y.to('cuda:1')
+                self.assertEqual(scripted(x1, y1), fn(x1, y1))
+                self.assertEqual(len(cached_ptx()), 1)
+        finally:
+            torch._C._jit_set_fuser_kernel_cache_dir(old_cache_dir)
+            shutil.rmtree(cache_dir)
+
+    def _test_fused_reduction(self, device='cpu'):
+        def sum_inner(x, y):
+            return (x * y + x).sigmoid().sum(-1)
+
+        def sum_last(x, y):
+            return (x * y - y).sum(1, keepdim=True)
+
+        def sum_outer(x, y):
+            return (x + y).tanh().sum(0)
+
+        x = torch.randn(7, 33, device=device)
+        y = torch.randn(7, 33, device=device)
+        b = torch.randn(33, device=device)
+        for fn in (sum_inner, sum_last, sum_outer):
+            scripted = torch.jit.script(fn)
+            for args in [(x, y), (x.t().contiguous().t(), y), (x, b)]:
+                self.assertEqual(scripted(*args), fn(*args))
+                self.assertAllFused(scripted.graph_for(*args))
+
+        # a reduction ends its fusion group, and the values it reduces can't be
+        # outputs of the group
+        def sum_then_map(x, y):
+            z = x * y
+            return z.sum(-1) * 2, z
+
+        scripted = torch.jit.script(sum_then_map)
+        self.assertEqual(scripted(x, y), sum_then_map(x, y))
+        graph = scripted.graph_for(x, y)
+        self.assertEqual(
+            [n.kind() for n in graph.nodes()].count('prim::FusionGroup'), 0, 'got {}'.format(graph))
+
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_reduction_cpu(self):
+        self._test_fused_reduction()
+
+    @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
+    @unittest.skipIf(not RUN_CUDA, "requires CUDA")
+    @skipIfRocm
+    def test_reduction_cuda(self):
+        self._test_fused_reduction(device="cuda")
+
     @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
     @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
     def test_arg_configurations_smoke_cuda(self):
@@ -479,6 +617,49 @@ class TestFuser(JitTestCase):
         test_norm_decompose(lm, ['aten::batch_norm_stats'],
                             ['aten::layer_norm('], ['aten::sub', 'aten::mul', 'aten::addcmul'])
 
+    @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
+    @skipIfRocm
+    def test_fuse_dropout_add_layer_norm(self):
+        def f(x, residual, weight, bias, training):
+            # type: (Tensor, Tensor, Tensor, Tensor, bool) -> Tensor
+            return F.layer_norm(residual + F.dropout(x, 0.1, training), [16], weight, bias)
+
+        scripted = torch.jit.script(f)
+        x = torch.randn(4, 8, 16, device='cuda')
+        residual = torch.randn(4, 8, 16, device='cuda')
+        weight = torch.randn(16, device='cuda')
+        bias = torch.randn(16, device='cuda')
+
+        self.assertEqual(scripted(x, residual, weight, bias, False),
+                         f(x, residual, weight, bias, False), prec=1e-5)
+        graph = str(scripted.graph_for(x, residual, weight, bias, False))
+        self.assertIn('aten::dropout_add_layer_norm', graph)
+        self.assertNotIn('aten::layer_norm', graph)
+
+        # Broadcasting adds are left alone
+        residual = torch.randn(16, device='cuda')
+        scripted(x, residual, weight, bias, False)
+        graph = str(scripted.graph_for(x, residual, weight, bias, False))
+        self.assertNotIn('aten::dropout_add_layer_norm', graph)
+
+    @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
+    @skipIfRocm
+    def test_fuse_linear_relu(self):
+        def f(x, weight, bias):
+            # type: (Tensor, Tensor, Tensor) -> Tensor
+            return F.relu(F.linear(x, weight, bias))
+
+        scripted = torch.jit.script(f)
+        weight = torch.randn(16, 8, device='cuda')
+        bias = torch.randn(16, device='cuda')
+        # 2-d inputs go through addmm, the others through matmul
+        for x in [torch.randn(4, 8, device='cuda'), torch.randn(2, 4, 8, device='cuda')]:
+            self.assertEqual(scripted(x, weight, bias), f(x, weight, bias))
+            graph = str(scripted.graph_for(x, weight, bias))
+            if x.dim() == 2:
+                self.assertIn('aten::_linear_relu', graph)
+                self.assertNotIn('aten::relu', graph)
+
     @unittest.skipIf(IS_WINDOWS, "NYI: fuser support for Windows")
     @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
     @skipIfRocm
@@ -529,6 +710,34 @@ class TestFuser(JitTestCase):
         # check that a, b share storage, i.e. were generated as a single output in the fuser
         self.assertEqual(ga.data_ptr(), gb.data_ptr())
 
+    @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
+    @enable_cpu_fuser
+    def test_activation_backward_fused_cpu(self):
+        # The gradients of these activations are written with fusible ops, and
+        # x + y is recomputed in the backward rather than saved by the forward
+        def leaky_relu(x, y):
+            return F.leaky_relu(x + y, 0.1)
+
+        def elu(x, y):
+            return F.elu(x + y, 0.9)
+
+        def hardtanh(x, y):
+            return F.hardtanh(x + y, -0.5, 0.5)
+
+        def softplus(x, y):
+            return F.softplus(x + y)
+
+        a = torch.randn(5, 5, requires_grad=True)
+        b = torch.randn(5, 5, requires_grad=True)
+        for fn in (leaky_relu, elu, hardtanh, softplus):
+            s = self.checkScript(fn, (a, b))
+            ga, gb = torch.autograd.grad(s(a, b).sum(), [a, b])
+            ra, rb = torch.autograd.grad(fn(a, b).sum(), [a, b])
+            self.assertEqual(ga, ra)
+            self.assertEqual(gb, rb)
+            graph = backward_graph(s)
+            self.assertAllFused(graph, except_for={'aten::size', 'prim::BroadcastSizes'})
+
     @unittest.skipIf(IS_WINDOWS or IS_SANDCASTLE, "NYI: fuser support for Windows or Sandcastle")
     @enable_cpu_fuser
     def test_fuser_iou(self):
@@ -73,6 +73,13 @@ class TestMkldnn(TestCase):
         self.assertWarnsRegex(lambda: gradcheck(func, [root], atol=4e-2, rtol=1e-2),
                               'double precision floating point')
 
+    def test_autograd_accumulate_mkldnn(self):
+        # The two MKLDNN gradients reaching root are summed before they are
+        # accumulated, which must not look at their (missing) storage.
+        root = torch.randn(4, 5, dtype=torch.float32).to_mkldnn().requires_grad_()
+        (root.to_dense() + root.to_dense() * 2).sum().backward()
+        self.assertEqual(root.grad.to_dense(), torch.full((4, 5), 3))
+
     def test_detach(self):
         root = torch.randn(4, 5, dtype=torch.float32).to_mkldnn().requires_grad_()
 
@@ -237,6 +244,61 @@ class TestMkldnn(TestCase):
                 linear(x),
                 mkldnn_linear(x.to_mkldnn()).to_dense())
 
+    def _trace_with_constant_weights(self, module, *inputs):
+        # closed over, the parameters are traced as graph constants
+        module.eval()
+        for param in module.parameters():
+            param.requires_grad_(False)
+        return torch.jit.trace(lambda *args: module(*args), inputs)
+
+    def test_jit_convert_to_mkldnn(self):
+        class Block(torch.nn.Module):
+            def __init__(self):
+                super(Block, self).__init__()
+                self.conv1 = torch.nn.Conv2d(3, 8, 3, padding=1)
+                self.bn1 = torch.nn.BatchNorm2d(8)
+                self.conv2 = torch.nn.Conv2d(8, 8, 3, padding=1, groups=2)
+                self.bn2 = torch.nn.BatchNorm2d(8)
+
+            def forward(self, x):
+                x = torch.nn.functional.relu(self.bn1(self.conv1(x)), inplace=True)
+                y = self.bn2(self.conv2(x))
+                y += x
+                y = torch.nn.functional.max_pool2d(torch.relu(y), 2)
+                return torch.nn.functional.adaptive_avg_pool2d(y, 1).flatten(1)
+
+        x = torch.randn(2, 3, 16, 16, dtype=torch.float32)
+        block = Block()
+        traced = self._trace_with_constant_weights(block, x)
+        expected = traced(x)
+
+        torch._C._jit_pass_convert_to_mkldnn(traced.graph)
+        graph = str(traced.graph)
+        # the whole block runs on MKL-DNN tensors, with a single conversion
+        # at each end
+        self.assertEqual(graph.count('aten::to_mkldnn'), 1)
+        self.assertEqual(graph.count('aten::to_dense'), 1)
+        self.assertEqual(traced(x), expected, prec=1e-4)
+
+    def test_jit_convert_to_mkldnn_escaping_write(self):
+        conv = torch.nn.Conv2d(3, 4, 3)
+
+        def fn(x):
+            y = conv(x)
+            z = y * 2
+            # z was computed before the write; keeping y in MKL-DNN layout
+            # would need a dense copy of y that misses it
+            return y.relu_(), z
+
+        x = torch.randn(2, 3, 8, 8, dtype=torch.float32)
+        conv.requires_grad_(False)
+        traced = torch.jit.trace(fn, x)
+        expected = traced(x)
+
+        torch._C._jit_pass_convert_to_mkldnn(traced.graph)
+        self.assertNotIn('aten::to_mkldnn', str(traced.graph))
+        self.assertEqual(traced(x), expected)
+
 
 if __name__ == '__main__':
     run_tests()
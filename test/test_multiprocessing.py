@@ -92,6 +92,13 @@ def sum_tensors(inq, outq):
                       tensor.numel(), tensor.storage().size()))
 
 
+def sum_each_tensor(inq, outq, count):
+    for _ in range(count):
+        tensor = inq.get()
+        outq.put(tensor.sum().item())
+        del tensor
+
+
 def queue_get_exception(inqueue, outqueue):
     os.close(2)  # hide expected error message
     try:
@@ -212,6 +219,8 @@ class leak_checker(object):
 
     def _has_shm_files(self):
         gc.collect()
+        # Slabs of the shared memory pool are kept for reuse until released
+        torch._C._release_shm_pool()
         names = ['torch_' + str(pid) for pid in self.checked_pids]
         for filename in os.listdir('/dev/shm'):
             for name in names:
@@ -349,6 +358,31 @@ class TestMultiprocessing(TestCase):
             for _ in range(TEST_REPEATS):
                 queue_put()
 
+    @unittest.skipIf(not HAS_SHM_FILES, "don't not how to check if shm files exist")
+    def test_fs_slab_reuse(self):
+        def shm_files():
+            prefix = 'torch_{}_'.format(os.getpid())
+            return [f for f in os.listdir('/dev/shm') if f.startswith(prefix)]
+
+        with fs_sharing(), leak_checker(self):
+            q = mp.Queue()
+            for i in range(20):
+                x = torch.FloatStorage._new_shared(1000).fill_(i)
+                q.put(x)
+                y = q.get(timeout=1)
+                self.assertEqual(y.tolist(), [i] * 1000)
+                del x, y
+                gc.collect()
+            # All of the storages were carved out of a single slab
+            self.assertEqual(len(shm_files()), 1)
+            # Sharing a pooled storage again keeps its memory
+            x = torch.zeros(10, 10).share_memory_()
+            q.put(x)
+            y = q.get(timeout=1)
+            self.assertEqual(y, x, 0)
+            self.assertEqual(y.storage()._cdata, x.storage()._cdata)
+            del x, y
+
     def test_inherit_tensor(self):
         t = torch.zeros(5, 5)
         p = SubProcess(t.share_memory_())
@@ -408,6 +442,38 @@ class TestMultiprocessing(TestCase):
         p2.join(1)
         p3.join(1)
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    def test_cuda_ipc_segment_reuse(self):
+        # Tensors of one segment share its IPC handle, and the receiver keeps
+        # the two most recently used segments mapped. Freeing a segment with
+        # empty_cache must not leave a stale handle behind on either side.
+        ctx = mp.get_context('spawn')
+        inq = ctx.Queue()
+        outq = ctx.Queue()
+        count = 6
+        prev_conf = os.environ.get('PYTORCH_CUDA_ALLOC_CONF')
+        os.environ['PYTORCH_CUDA_ALLOC_CONF'] = 'ipc_cache_size:2'
+        try:
+            p = ctx.Process(target=sum_each_tensor, args=(inq, outq, count))
+            p.start()
+        finally:
+            if prev_conf is None:
+                del os.environ['PYTORCH_CUDA_ALLOC_CONF']
+            else:
+                os.environ['PYTORCH_CUDA_ALLOC_CONF'] = prev_conf
+        for i in range(count):
+            x = torch.full((1000,), i, device='cuda')
+            inq.put(x[500:])
+            self.assertEqual(outq.get(), i * 500)
+            del x
+            if i % 2 == 1:
+                torch.cuda.ipc_collect()
+                torch.cuda.empty_cache()
+        p.join(10)
+        self.assertEqual(p.exitcode, 0)
+
     @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
                      don't support multiprocessing with spawn start method")
     @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
@@ -12,6 +12,9 @@ from functools import wraps, reduce
 from operator import mul
 from collections import OrderedDict
 import threading
+import os
+import shutil
+import tempfile
 
 import torch
 from torch._six import inf, nan
@@ -2235,6 +2238,47 @@ class TestNN(NNTestCase):
     def test_softmax_backward_cuda(self):
         self._test_softmax_backward(torch.device('cuda'))
 
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    @repeat_test_for_types([torch.float, torch.double, torch.half])
+    @skipIfRocm
+    def test_softmax_long_rows_cuda(self, dtype=torch.float):
+        prec = 1e-3 if dtype == torch.half else 1e-6
+        # 5001 elements can't be loaded 16 bytes at a time
+        for size in [(7, 4096), (3, 5001), (2, 3, 32768)]:
+            input = torch.randn(size, device='cuda', dtype=dtype) * 10
+            input_double = input.cpu().double()
+            for fn in [F.softmax, F.log_softmax]:
+                expected = fn(input_double, dim=-1)
+                self.assertEqual(fn(input, dim=-1).double().cpu(), expected, prec)
+                if dtype == torch.half:
+                    out = fn(input, dim=-1, dtype=torch.float)
+                    self.assertEqual(out.dtype, torch.float)
+                    self.assertEqual(out.double().cpu(), expected, prec)
+        input = torch.full((2, 8192), -float('inf'), device='cuda', dtype=dtype)
+        input[0, 5] = 0
+        self.assertEqual(F.softmax(input, dim=1)[0].sum().item(), 1)
+
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    @repeat_test_for_types([torch.float, torch.double, torch.half])
+    @skipIfRocm
+    def test_cross_entropy_large_vocab_cuda(self, dtype=torch.float):
+        prec = 1e-2 if dtype == torch.half else 1e-5
+        C = 10003
+        input = torch.randn(16, C, device='cuda', dtype=dtype, requires_grad=True)
+        target = torch.randint(C, (16,), device='cuda', dtype=torch.long)
+        target[3] = -100
+        weight = torch.rand(C, device='cuda', dtype=dtype)
+        for reduction, w in product(['none', 'mean', 'sum'], [None, weight]):
+            loss = F.cross_entropy(input, target, w, reduction=reduction)
+            expected = F.nll_loss(F.log_softmax(input.double(), 1), target,
+                                  None if w is None else w.double(), reduction=reduction)
+            self.assertEqual(loss.dtype, dtype)
+            self.assertEqual(loss.double(), expected, prec)
+            grad = torch.rand_like(expected)
+            grad_input, = torch.autograd.grad(loss, input, grad.to(dtype))
+            expected_grad, = torch.autograd.grad(expected, input, grad)
+            self.assertEqual(grad_input.double(), expected_grad.double(), prec)
+
     def _test_gumbel_softmax_st_shapes(self, cuda, dtype, shape, dim, count_expected):
         logits = torch.randn(shape, dtype=torch.float)
         logits = logits.to(dtype)
@@ -2573,6 +2617,60 @@ class TestNN(NNTestCase):
             self._test_EmbeddingBag(False, 'sum', True, test_backward=test_backward, dtype=dtype)
             self._test_EmbeddingBag(False, 'mean', True, test_backward=test_backward, dtype=dtype)
 
+    def test_embedding_bag_half_cpu(self):
+        weight = torch.randn(10, 21).half()
+        input = torch.tensor([3, 1, 1, 1, 4, 0, 9], dtype=torch.long)
+        offsets = torch.tensor([0, 0, 3, 3, 6], dtype=torch.long)
+        per_sample_weights = torch.randn(7).half()
+        for mode in ('sum', 'mean'):
+            expected = F.embedding_bag(input, weight.float(), offsets, mode=mode)
+            result = F.embedding_bag(input, weight, offsets, mode=mode)
+            self.assertEqual(result.dtype, torch.half)
+            self.assertEqual(result.float(), expected, prec=dtype2prec[torch.half])
+        expected = F.embedding_bag(input, weight.float(), offsets, mode='sum',
+                                   per_sample_weights=per_sample_weights.float())
+        result = F.embedding_bag(input, weight, offsets, mode='sum',
+                                 per_sample_weights=per_sample_weights)
+        self.assertEqual(result.float(), expected, prec=dtype2prec[torch.half])
+        # non-contiguous rows
+        weight = torch.randn(10, 42).half()[:, ::2]
+        expected = F.embedding_bag(input, weight.float(), offsets, mode='sum')
+        result = F.embedding_bag(input, weight, offsets, mode='sum')
+        self.assertEqual(result.float(), expected, prec=dtype2prec[torch.half])
+
+    @unittest.skipIf(not TEST_NUMPY, "numpy not found")
+    def test_fused_8bit_rowwise_embedding_bag(self):
+        # Quantizes each row to 256 steps between its minimum and maximum, and
+        # appends the float scale and bias, as caffe2's
+        # FloatToFused8BitRowwiseQuantized operator does.
+        weight = torch.randn(10, 19)
+        minimum = weight.min(1, keepdim=True)[0]
+        scale = (weight.max(1, keepdim=True)[0] - minimum) / 255
+        quantized = ((weight - minimum) / scale).round()
+        scale_bias = torch.from_numpy(torch.cat([scale, minimum], 1).numpy().view(np.uint8))
+        fused = torch.cat([quantized.to(torch.uint8), scale_bias], 1)
+        dequantized = quantized * scale + minimum
+
+        input = torch.tensor([3, 1, 1, 1, 4, 0, 9], dtype=torch.long)
+        offsets = torch.tensor([0, 0, 3, 3, 6], dtype=torch.long)
+        per_sample_weights = torch.randn(7)
+        for mode, mode_enum in (('sum', 0), ('mean', 1)):
+            expected = F.embedding_bag(input, dequantized, offsets, mode=mode)
+            result = torch.fused_8bit_rowwise_embedding_bag(fused, input, offsets, mode_enum)
+            self.assertEqual(result, expected, prec=1e-4)
+        expected = F.embedding_bag(input, dequantized, offsets, mode='sum',
+                                   per_sample_weights=per_sample_weights)
+        result = torch.fused_8bit_rowwise_embedding_bag(
+            fused, input, offsets, per_sample_weights=per_sample_weights)
+        self.assertEqual(result, expected, prec=1e-4)
+
+        with self.assertRaisesRegex(RuntimeError, "only mode='sum' and mode='mean'"):
+            torch.fused_8bit_rowwise_embedding_bag(fused, input, offsets, 2)
+        with self.assertRaisesRegex(RuntimeError, "more than 8 columns"):
+            torch.fused_8bit_rowwise_embedding_bag(fused[:, :8], input, offsets)
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            torch.fused_8bit_rowwise_embedding_bag(fused, input + 1, offsets)
+
     @staticmethod
     def _embedding_bag_reference_impl(input, weight, offsets=None, mode='sum',
                                       per_sample_weights=None):
@@ -2738,6 +2836,44 @@ class TestNN(NNTestCase):
             self._test_EmbeddingBag(True, 'sum', True, dtype)
             self._test_EmbeddingBag(True, 'mean', True, dtype)
 
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    def test_embedding_backward_skewed_indices_cuda(self):
+        # A few hot rows take most of the indices, so that their gradients are
+        # split over many partial sums
+        num_weights, dim = 50, 37
+        probs = 1. / torch.arange(1, num_weights + 1, dtype=torch.double) ** 2
+        indices = torch.multinomial(probs, 5000, replacement=True)
+        offsets = torch.arange(0, 5000, 7)
+        per_sample_weights = torch.randn(5000, dtype=torch.double)
+
+        def grads(device, **kwargs):
+            weight = torch.zeros(num_weights, dim, dtype=torch.double,
+                                 device=device, requires_grad=True)
+            out = F.embedding(indices.to(device), weight, **kwargs)
+            out.backward(torch.ones_like(out).cumsum(0))
+            return weight.grad
+
+        def bag_grads(device, mode, use_weights=False):
+            weight = torch.zeros(num_weights, dim, dtype=torch.double,
+                                 device=device, requires_grad=True)
+            out = F.embedding_bag(
+                indices.to(device), weight, offsets.to(device), mode=mode,
+                per_sample_weights=per_sample_weights.to(device) if use_weights else None)
+            out.backward(torch.ones_like(out).cumsum(0))
+            return weight.grad
+
+        for kwargs in [{}, {'padding_idx': 0}, {'scale_grad_by_freq': True}]:
+            expected = grads('cpu', **kwargs)
+            result = grads('cuda', **kwargs)
+            self.assertEqual(result, expected)
+            # The reduction happens in a fixed order
+            self.assertEqual((result - grads('cuda', **kwargs)).abs().max(), 0)
+        for mode, use_weights in [('sum', False), ('mean', False), ('sum', True)]:
+            expected = bag_grads('cpu', mode, use_weights)
+            result = bag_grads('cuda', mode, use_weights)
+            self.assertEqual(result, expected)
+            self.assertEqual((result - bag_grads('cuda', mode, use_weights)).abs().max(), 0)
+
     def test_fractional_max_pool2d(self):
         x = torch.randn(1, 2, 7, 7, requires_grad=True)
         samples = x.new(1, 2, 2).uniform_()
@@ -3006,6 +3142,69 @@ class TestNN(NNTestCase):
         self._test_LayerNorm_general("cuda")
         self._test_LayerNorm_cuda_half()
 
+    def _test_dropout_add_layer_norm(self, device, dtype, prec):
+        x = torch.randn(6, 5, 43, device=device, dtype=dtype, requires_grad=True)
+        residual = torch.randn_like(x, requires_grad=True)
+        weight = torch.randn(43, device=device, dtype=dtype, requires_grad=True)
+        bias = torch.randn(43, device=device, dtype=dtype, requires_grad=True)
+        grad = torch.randn_like(x)
+
+        def run(fn):
+            for t in (x, residual, weight, bias):
+                t.grad = None
+            out = fn()
+            out.backward(grad)
+            return [out] + [t.grad for t in (x, residual, weight, bias)]
+
+        for training, p in [(False, 0.5), (True, 0), (True, 1)]:
+            expected = run(lambda: F.layer_norm(
+                F.dropout(x, p, training) + residual, [43], weight, bias))
+            result = run(lambda: F.dropout_add_layer_norm(
+                x, residual, [43], weight, bias, p, training))
+            for e, r in zip(expected, result):
+                self.assertEqual(e, r, prec)
+        self.assertRaises(RuntimeError, lambda: F.dropout_add_layer_norm(
+            x, residual[0], [43], weight, bias))
+
+    def test_dropout_add_layer_norm(self):
+        self._test_dropout_add_layer_norm('cpu', torch.double, 1e-8)
+
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    @repeat_test_for_types([torch.float, torch.double, torch.half])
+    def test_dropout_add_layer_norm_cuda(self, dtype=torch.float):
+        prec = 1e-2 if dtype == torch.half else 1e-5
+        self._test_dropout_add_layer_norm('cuda', dtype, prec)
+
+        # The kept elements are the ones whose bit is set in the saved mask
+        D = 1000
+        x = torch.randn(64, D, device='cuda', dtype=dtype).abs() + 1
+        residual = torch.randn_like(x)
+        out, pre_norm, mask, mean, rstd = torch._fused_dropout_add_layer_norm(
+            x, residual, [D], None, None, 0.3, 1e-5)
+        keep = (pre_norm != residual).to(dtype)
+        idx = torch.arange(D, device='cuda')
+        bits = (mask.long()[:, idx // 8] / torch.pow(2, idx % 8)) % 2
+        self.assertEqual(bits.to(dtype), keep)
+        self.assertEqual(keep.mean().item(), 0.7, 2e-2)
+        self.assertEqual(mask.size(), (64, (D + 7) // 8))
+        self.assertEqual(out, F.layer_norm(x * keep / 0.7 + residual, [D]), prec)
+
+        x.requires_grad_()
+        residual.requires_grad_()
+        torch.cuda.manual_seed(0)
+        out = F.dropout_add_layer_norm(x, residual, [D], p=0.3)
+        torch.cuda.manual_seed(0)
+        _, pre_norm, _, _, _ = torch._fused_dropout_add_layer_norm(
+            x.detach(), residual.detach(), [D], None, None, 0.3, 1e-5)
+        keep = (pre_norm != residual.detach()).to(dtype)
+        expected = F.layer_norm(x * keep / 0.7 + residual, [D])
+        self.assertEqual(out, expected, prec)
+        grad = torch.randn_like(out)
+        grads = torch.autograd.grad(out, (x, residual), grad)
+        expected_grads = torch.autograd.grad(expected, (x, residual), grad)
+        for g, e in zip(grads, expected_grads):
+            self.assertEqual(g, e, prec * 10)
+
     def _test_GroupNorm_general(self, device="cpu", dtype=torch.float):
         good_shape_g = {
             (1, 2, 3, 4): 2,
@@ -3487,6 +3686,32 @@ class TestNN(NNTestCase):
     def test_batchnorm_eval(self):
         self._test_batchnorm_eval()
 
+    def test_batchnorm_channels_last_cpu(self):
+        # contiguous, channels last and spatially trivial inputs, in evaluation
+        # and in training
+        for size in [(2, 19, 5, 7), (3, 20, 1, 1), (1, 3, 2, 2)]:
+            input = torch.randn(*size, dtype=torch.double)
+            bn = nn.BatchNorm2d(size[1]).double()
+            bn.weight.data.uniform_()
+            bn.bias.data.uniform_()
+            bn.running_mean.uniform_()
+            bn.running_var.uniform_(0.5, 1.5)
+            state = deepcopy(bn.state_dict())
+            for training in [False, True]:
+                if training:
+                    mean = input.mean((0, 2, 3))
+                    var = input.var((0, 2, 3), unbiased=False)
+                else:
+                    mean, var = bn.running_mean, bn.running_var
+                expected = ((input - mean[:, None, None]) / (var[:, None, None] + bn.eps).sqrt() *
+                            bn.weight[:, None, None] + bn.bias[:, None, None])
+                for memory_format in [torch.contiguous_format, torch.channels_last]:
+                    bn.load_state_dict(state)
+                    bn.train(training)
+                    out = bn(input.contiguous(memory_format=memory_format))
+                    self.assertEqual(out, expected)
+                    self.assertTrue(out.is_contiguous(memory_format=memory_format))
+
     @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
     def test_batchnorm_eval_cuda(self, dtype=torch.float):
         self._test_batchnorm_eval("cuda", dtype)
@@ -4512,6 +4737,30 @@ class TestNN(NNTestCase):
             self.assertEqual(conv1.bias.grad.data, conv2.bias.grad.data, prec=0.0)
             self.assertEqual(conv1.weight.grad.data, conv2.weight.grad.data, prec=0.0)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_Conv2d_cudnn_benchmark_cache(self):
+        inputs = torch.randn(2, 3, 7, 9, device="cuda", requires_grad=True)
+        conv = torch.nn.Conv2d(3, 5, 3).cuda()
+        with cudnn.flags(enabled=True, benchmark=True):
+            out = conv(inputs)
+            out.sum().backward()
+        tmpdir = tempfile.mkdtemp()
+        try:
+            path = os.path.join(tmpdir, 'cudnn_cache')
+            saved = cudnn.save_benchmark_cache(path)
+            # forward, backward data and backward filter of conv at least
+            self.assertGreaterEqual(saved, 3)
+            self.assertEqual(cudnn.load_benchmark_cache(path), saved)
+            with cudnn.flags(enabled=True, benchmark=True):
+                self.assertEqual(conv(inputs), out)
+
+            with open(path, 'w') as f:
+                f.write('not a cache\n')
+            self.assertRaises(RuntimeError, lambda: cudnn.load_benchmark_cache(path))
+        finally:
+            shutil.rmtree(tmpdir)
+
     def test_Conv2d_missing_argument(self):
         c = nn.Conv2d(3, 3, 3)
         self.assertRaises(TypeError, lambda: c(None))
@@ -4669,6 +4918,59 @@ class TestNN(NNTestCase):
                              torch.cat([m1.weight.grad.data, m2.weight.grad.data], 0),
                              1e-1 if dtype == torch.half else dtype2prec[dtype])
 
+    def test_Conv2d_depthwise_cpu(self):
+        # groups == in_channels goes to the direct depthwise kernel on CPU
+        for depth_multiplier, stride, padding, dilation in [(1, 1, 1, 1), (2, 1, 0, 1), (1, 2, 1, 1),
+                                                            (1, (1, 3), (2, 1), (2, 1)), (3, 2, 3, 2)]:
+            m = nn.Conv2d(3, 3 * depth_multiplier, kernel_size=3, groups=3, stride=stride,
+                          padding=padding, dilation=dilation).double()
+            i = torch.randn(2, 3, 11, 17, dtype=torch.double, requires_grad=True)
+            output = m(i)
+            grad_output = torch.randn_like(output)
+            output.backward(grad_output)
+
+            outputs, i_grads, w_grads, b_grads = [], [], [], []
+            for g in range(3):
+                w_g = m.weight.detach()[g * depth_multiplier:(g + 1) * depth_multiplier].clone().requires_grad_()
+                b_g = m.bias.detach()[g * depth_multiplier:(g + 1) * depth_multiplier].clone().requires_grad_()
+                i_g = i.detach()[:, g:g + 1].clone().requires_grad_()
+                out_g = F.conv2d(i_g, w_g, b_g, stride=stride, padding=padding, dilation=dilation)
+                out_g.backward(grad_output[:, g * depth_multiplier:(g + 1) * depth_multiplier])
+                outputs.append(out_g)
+                i_grads.append(i_g.grad)
+                w_grads.append(w_g.grad)
+                b_grads.append(b_g.grad)
+
+            self.assertEqual(output, torch.cat(outputs, 1))
+            self.assertEqual(i.grad, torch.cat(i_grads, 1))
+            self.assertEqual(m.weight.grad, torch.cat(w_grads, 0))
+            self.assertEqual(m.bias.grad, torch.cat(b_grads, 0))
+
+            x = torch.randn(1, 3, 6, 7, dtype=torch.double, requires_grad=True)
+            self.assertTrue(gradgradcheck(lambda x, w, b: F.conv2d(x, w, b, stride=stride, padding=padding,
+                                                                   dilation=dilation, groups=3),
+                                          (x, m.weight, m.bias)))
+
+    def test_Conv2d_pointwise_cpu(self):
+        # 1x1 kernels with unit stride and no padding are a matrix product on CPU
+        for batch, bias in [(1, True), (3, False)]:
+            m = nn.Conv2d(5, 4, kernel_size=1, bias=bias).double()
+            i = torch.randn(batch, 5, 6, 7, dtype=torch.double, requires_grad=True)
+            output = m(i)
+            expected = torch.einsum('oc,nchw->nohw', m.weight.detach().view(4, 5), i.detach())
+            if bias:
+                expected = expected + m.bias.detach().view(1, 4, 1, 1)
+            self.assertEqual(output, expected)
+
+            x = torch.randn(batch, 5, 3, 2, dtype=torch.double, requires_grad=True)
+            params = (x, m.weight, m.bias) if bias else (x, m.weight)
+            self.assertTrue(gradgradcheck(lambda *args: F.conv2d(*args), params))
+
+        # non contiguous input
+        m = nn.Conv2d(3, 2, kernel_size=1).double()
+        i = torch.randn(2, 6, 4, 4, dtype=torch.double)[:, ::2]
+        self.assertEqual(m(i), m(i.contiguous()))
+
     # Very similar to test_Conv2d_naive_groups but with special care to handle
     # the number of groups == number of input channels
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
@@ -4877,6 +5179,22 @@ class TestNN(NNTestCase):
         with self.assertRaises(RuntimeError):
             torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths)
 
+    def test_CTCLoss_cpu_repeated_labels(self):
+        target_lengths = [30, 25, 20, 3]
+        input_lengths = [50, 50, 40, 10]
+        # few labels, so that the targets contain many repeats
+        targets = torch.randint(1, 3, (sum(target_lengths),), dtype=torch.int)
+        log_probs = torch.randn(50, 4, 3, dtype=torch.double).log_softmax(2).requires_grad_()
+        res = torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths,
+                                           reduction='none', zero_infinity=True)
+        expected = ctcloss_reference(log_probs, targets.long(), input_lengths, target_lengths, reduction='none')
+        finite = expected != float('inf')
+        self.assertEqual(res[finite], expected[finite])
+        self.assertTrue((res[~finite] == 0).all().item())
+        grad, = torch.autograd.grad(res.sum(), log_probs)
+        self.assertTrue((grad == grad).all().item())
+        self.assertTrue((grad[40:, 2] == 0).all().item())
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_CTCLoss_zero_infinity(self):
         target_lengths = [60, 25, 20]
@@ -5051,6 +5369,48 @@ class TestNN(NNTestCase):
                 _compatibility_test(unsorted_sequences, unsorted_sequences_lengths,
                                     batch_first)
 
+    def _test_jagged(self, device):
+        lengths = torch.tensor([3, 0, 1, 5])
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long), lengths.cumsum(0)])
+        values = torch.randn(9, 4, dtype=torch.double, device=device, requires_grad=True)
+        sequences = values.split(lengths.tolist())
+
+        padded = torch._jagged_to_padded(values, offsets, -1.)
+        self.assertEqual(padded.size(), (4, 5, 4))
+        for b, sequence in enumerate(sequences):
+            self.assertEqual(padded[b, :lengths[b]], sequence)
+            self.assertTrue((padded[b, lengths[b]:] == -1).all())
+        self.assertEqual(torch._jagged_to_padded(values, offsets, 0, 7).size(), (4, 7, 4))
+        with self.assertRaisesRegex(RuntimeError, "at least the length"):
+            torch._jagged_to_padded(values, offsets, 0, 4)
+        with self.assertRaisesRegex(RuntimeError, "length of 'values'"):
+            torch._jagged_to_padded(values[1:], offsets)
+
+        round_trip, round_trip_offsets = torch._padded_to_jagged(padded, lengths)
+        self.assertEqual(round_trip, values)
+        self.assertEqual(round_trip_offsets, offsets)
+
+        softmax = torch._jagged_softmax(values, offsets)
+        for output, sequence in zip(softmax.split(lengths.tolist()), sequences):
+            self.assertEqual(output, torch.softmax(sequence, 0))
+
+        other = torch.randn(4, 4, 2, dtype=torch.double, device=device, requires_grad=True)
+        product = torch._jagged_matmul(values, offsets, other)
+        for b, (output, sequence) in enumerate(zip(product.split(lengths.tolist()), sequences)):
+            self.assertEqual(output, sequence.mm(other[b]))
+
+        self.assertTrue(gradcheck(lambda v: torch._jagged_to_padded(v, offsets), (values,)))
+        self.assertTrue(gradcheck(lambda p: torch._padded_to_jagged(p, lengths)[0], (padded.detach().requires_grad_(),)))
+        self.assertTrue(gradcheck(lambda v: torch._jagged_softmax(v, offsets), (values,)))
+        self.assertTrue(gradcheck(lambda v, o: torch._jagged_matmul(v, offsets, o), (values, other)))
+
+    def test_jagged(self):
+        self._test_jagged('cpu')
+
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    def test_jagged_cuda(self):
+        self._test_jagged('cuda')
+
     def test_pack_padded_sequence(self):
         def generate_test_case(sorted_lengths, should_shuffle):
             def pad(tensor, length):
@@ -5228,6 +5588,80 @@ class TestNN(NNTestCase):
 
             (hx + cx).sum().backward()
 
+    def test_RNN_cpu_fused_cells(self):
+        # on CPU, LSTM and GRU cells run fused gate kernels with their own
+        # backward, and layers project the inputs of all timesteps at once
+        def lstm_ref(input, hidden, w_ih, w_hh, b_ih=None, b_hh=None):
+            hx, cx = hidden
+            gates = F.linear(input, w_ih, b_ih) + F.linear(hx, w_hh, b_hh)
+            ingate, forgetgate, cellgate, outgate = gates.chunk(4, 1)
+            cy = forgetgate.sigmoid() * cx + ingate.sigmoid() * cellgate.tanh()
+            return outgate.sigmoid() * cy.tanh(), cy
+
+        def gru_ref(input, hx, w_ih, w_hh, b_ih=None, b_hh=None):
+            i_r, i_i, i_n = F.linear(input, w_ih, b_ih).chunk(3, 1)
+            h_r, h_i, h_n = F.linear(hx, w_hh, b_hh).chunk(3, 1)
+            resetgate = (i_r + h_r).sigmoid()
+            inputgate = (i_i + h_i).sigmoid()
+            newgate = (i_n + resetgate * h_n).tanh()
+            return newgate + inputgate * (hx - newgate)
+
+        def run_ref(cell_ref, input, hidden, params):
+            outputs = []
+            for step_input in input.unbind(0):
+                hidden = cell_ref(step_input, hidden, *params)
+                outputs.append(hidden[0] if isinstance(hidden, tuple) else hidden)
+            return torch.stack(outputs, 0), hidden
+
+        # a hidden size that is not a multiple of the vector width
+        input_size, hidden_size, seq_len, batch = 5, 11, 4, 3
+        for bias in (True, False):
+            for module, cell_ref in ((nn.LSTM, lstm_ref), (nn.GRU, gru_ref)):
+                rnn = module(input_size, hidden_size, bias=bias, bidirectional=True).double()
+                input = torch.randn(seq_len, batch, input_size, dtype=torch.double, requires_grad=True)
+                output, hidden = rnn(input)
+
+                h0 = torch.zeros(batch, hidden_size, dtype=torch.double)
+                h0 = (h0, h0) if module is nn.LSTM else h0
+                params = [list(p) for p in rnn.all_weights]
+                fw_output, fw_hidden = run_ref(cell_ref, input, h0, params[0])
+                rev_output, rev_hidden = run_ref(cell_ref, input.flip(0), h0, params[1])
+                self.assertEqual(output, torch.cat([fw_output, rev_output.flip(0)], 2))
+                if module is nn.LSTM:
+                    self.assertEqual(hidden[0], torch.stack([fw_hidden[0], rev_hidden[0]], 0))
+                    self.assertEqual(hidden[1], torch.stack([fw_hidden[1], rev_hidden[1]], 0))
+                else:
+                    self.assertEqual(hidden, torch.stack([fw_hidden, rev_hidden], 0))
+
+                grad_output = torch.randn_like(output)
+                grads = torch.autograd.grad(output, [input] + list(rnn.parameters()), grad_output)
+                ref_output = torch.cat([fw_output, rev_output.flip(0)], 2)
+                ref_grads = torch.autograd.grad(ref_output, [input] + list(rnn.parameters()), grad_output)
+                for grad, ref_grad in zip(grads, ref_grads):
+                    self.assertEqual(grad, ref_grad)
+
+                # packed sequences of decreasing lengths match running each
+                # sequence on its own
+                lengths = [4, 3, 1]
+                packed = rnn_utils.pack_padded_sequence(input, lengths)
+                packed_output, _ = rnn(packed)
+                padded_output, _ = rnn_utils.pad_packed_sequence(packed_output)
+                for i, length in enumerate(lengths):
+                    seq_output, _ = rnn(input[:length, i:i + 1])
+                    self.assertEqual(padded_output[:length, i:i + 1], seq_output)
+
+            cell_input = torch.randn(batch, input_size, dtype=torch.double, requires_grad=True)
+            hx = torch.randn(batch, hidden_size, dtype=torch.double, requires_grad=True)
+            cx = torch.randn(batch, hidden_size, dtype=torch.double, requires_grad=True)
+            lstm = nn.LSTMCell(input_size, hidden_size, bias=bias).double()
+            self.assertEqual(lstm(cell_input, (hx, cx)), lstm_ref(cell_input, (hx, cx), *lstm.parameters()))
+            self.assertTrue(gradcheck(lambda i, h, c: lstm(i, (h, c)), (cell_input, hx, cx)))
+            # only one of the outputs receives a gradient
+            self.assertTrue(gradcheck(lambda i, h, c: lstm(i, (h, c))[1], (cell_input, hx, cx)))
+            gru = nn.GRUCell(input_size, hidden_size, bias=bias).double()
+            self.assertEqual(gru(cell_input, hx), gru_ref(cell_input, hx, *gru.parameters()))
+            self.assertTrue(gradcheck(lambda i, h: gru(i, h), (cell_input, hx)))
+
     @unittest.skipIf(not (TEST_CUDNN and TEST_MULTIGPU), 'CUDNN or multi-gpu not available')
     def test_cudnn_rnn_dropout_states_device(self):
         rnn = nn.RNN(10, 20, num_layers=2, dropout=.5)
@@ -7059,6 +7493,29 @@ class TestNN(NNTestCase):
                 input = torch.randn(1, 1, 2, 2, requires_grad=True)
                 gradcheck(lambda x: F.interpolate(x, out_size, **kwargs), [input])
 
+    def test_upsampling2d_channels_last(self):
+        # channels last inputs take the NHWC kernels and give channels last outputs
+        for mode, align_corners in [('nearest', None), ('bilinear', True), ('bilinear', False),
+                                    ('bicubic', True), ('bicubic', False)]:
+            for size in [(7, 9), (16, 16), (3, 20)]:
+                input = torch.randn(2, 19, 10, 11, dtype=torch.double)
+                input_cl = input.contiguous(memory_format=torch.channels_last)
+                out = F.interpolate(input, size, mode=mode, align_corners=align_corners)
+                out_cl = F.interpolate(input_cl, size, mode=mode, align_corners=align_corners)
+                self.assertTrue(out_cl.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(out, out_cl)
+
+                # non-contiguous inputs and the backward go through contiguous tensors
+                input_t = input.transpose(2, 3).requires_grad_()
+                out_t = F.interpolate(input_t, size, mode=mode, align_corners=align_corners)
+                self.assertEqual(out_t, F.interpolate(input_t.detach().contiguous(), size, mode=mode,
+                                                      align_corners=align_corners))
+                grad = torch.randn_like(out_t)
+                out_t.backward(grad)
+                input_c = input_t.detach().contiguous().requires_grad_()
+                F.interpolate(input_c, size, mode=mode, align_corners=align_corners).backward(grad)
+                self.assertEqual(input_t.grad, input_c.grad)
+
     def test_upsamplingBicubic2d(self):
         # test output against known input: align_corners=False result must match opencv
         in_t = torch.arange(8).view(1, 2, 2, 2).type(torch.FloatTensor)
@@ -7198,6 +7655,30 @@ class TestNN(NNTestCase):
         expected = m(inp.view(6, 5)).view(2, 3, 8)
         self.assertEqual(expected, m(inp))
 
+    def _test_linear_relu(self, device):
+        for sizes in [(4, 5), (2, 3, 5)]:
+            inp = torch.randn(*sizes, device=device)
+            weight = torch.randn(8, 5, device=device)
+            bias = torch.randn(8, device=device)
+            self.assertEqual(torch._linear_relu(inp, weight, bias),
+                             F.relu(F.linear(inp, weight, bias)))
+            self.assertEqual(torch._linear_relu(inp, weight),
+                             F.relu(F.linear(inp, weight)))
+
+        inp = torch.randn(2, 3, 5, dtype=torch.double, device=device, requires_grad=True)
+        weight = torch.randn(8, 5, dtype=torch.double, device=device, requires_grad=True)
+        bias = torch.randn(8, dtype=torch.double, device=device, requires_grad=True)
+        self.assertTrue(gradcheck(torch._linear_relu, (inp, weight, bias)))
+        self.assertTrue(gradgradcheck(torch._linear_relu, (inp, weight, bias)))
+        self.assertTrue(gradcheck(lambda i, w: torch._linear_relu(i, w), (inp, weight)))
+
+    def test_linear_relu(self):
+        self._test_linear_relu('cpu')
+
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    def test_linear_relu_cuda(self):
+        self._test_linear_relu('cuda')
+
     def test_bilinear(self):
         module = nn.Bilinear(10, 10, 8)
         input1 = torch.randn(4, 10, requires_grad=True)
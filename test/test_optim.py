@@ -389,6 +389,55 @@ class TestOptim(TestCase):
              lambda opt: ReduceLROnPlateau(opt, threshold=1e-4)]
         )
 
+    def _test_adagrad_sparse_embedding(self, rowwise):
+        # Uncoalesced sparse gradients of an embedding table, with duplicate
+        # indices, applied by the fused kernel and by the dense update.
+        torch.manual_seed(0)
+        weight = torch.randn(10, 5)
+        weight_sparse = weight.clone().requires_grad_()
+        weight_dense = weight.clone().requires_grad_()
+        optimizer_sparse = optim.Adagrad([weight_sparse], lr=0.1, lr_decay=1e-2,
+                                         initial_accumulator_value=0.1, rowwise=rowwise)
+        optimizer_dense = optim.Adagrad([weight_dense], lr=0.1, lr_decay=1e-2,
+                                        initial_accumulator_value=0.1, rowwise=rowwise)
+        for _ in range(5):
+            indices = torch.tensor([[3, 1, 3, 7, 1, 3]])
+            values = torch.randn(6, 5)
+            grad = torch.sparse_coo_tensor(indices, values, (10, 5))
+            self.assertFalse(grad.is_coalesced())
+            weight_sparse.grad = grad
+            weight_dense.grad = grad.to_dense()
+            optimizer_sparse.step()
+            optimizer_dense.step()
+            self.assertEqual(weight_sparse, weight_dense, prec=1e-5)
+            self.assertEqual(optimizer_sparse.state[weight_sparse]['sum'],
+                             optimizer_dense.state[weight_dense]['sum'], prec=1e-5)
+        # Rows without a gradient are left untouched.
+        self.assertEqual(weight_sparse[0], weight[0], prec=0)
+
+    def test_adagrad_sparse_embedding(self):
+        self._test_adagrad_sparse_embedding(rowwise=False)
+
+    def test_adagrad_sparse_embedding_rowwise(self):
+        self._test_adagrad_sparse_embedding(rowwise=True)
+
+    def test_adagrad_rowwise(self):
+        self._test_basic_cases(
+            lambda weight, bias: optim.Adagrad([weight, bias], lr=1e-1, rowwise=True)
+        )
+        self._test_rosenbrock_sparse(
+            lambda params: optim.Adagrad(params, lr=1e-1, rowwise=True)
+        )
+
+    def test_sparse_adagrad_errors(self):
+        weight = torch.zeros(4, 3)
+        grad = torch.sparse_coo_tensor(torch.tensor([[1, 4]]), torch.ones(2, 3), (4, 3))
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            torch._sparse_adagrad_(weight, torch.zeros(4, 3), grad, 0.1)
+        grad = torch.sparse_coo_tensor(torch.tensor([[1, 2]]), torch.ones(2, 3), (4, 3))
+        with self.assertRaisesRegex(RuntimeError, "one value per row"):
+            torch._sparse_adagrad_(weight, torch.zeros(3), grad, 0.1)
+
     @skipIfRocm
     def test_adamax(self):
         self._test_basic_cases(
@@ -176,6 +176,134 @@ class TestQuantizedOps(unittest.TestCase):
         qC_hat = sum_relu(qA, qB, scale=scale_C, zero_point=zero_point_C)
         np.testing.assert_equal(qC, qC_hat.int_repr())
 
+    """Tests the correctness of the quantized::add and quantized::add_relu ops."""
+    def test_qadd(self):
+        A = torch.arange(-25, 25, dtype=torch.float)
+        B = torch.arange(-25, 25, dtype=torch.float).flip(0)
+        qA = A.quantize_linear(scale=3.0, zero_point=7)
+        qB = B.quantize_linear(scale=5.0, zero_point=127)
+        scale_C = 0.5
+        zero_point_C = 5
+
+        C = (qA.dequantize() + qB.dequantize()).numpy()
+        qC = _quantize(C, scale_C, zero_point_C)
+        qC_hat = torch.ops.quantized.add(qA, qB, scale=scale_C, zero_point=zero_point_C)
+        np.testing.assert_equal(qC, qC_hat.int_repr())
+
+        C[C < 0] = 0
+        qC = _quantize(C, scale_C, zero_point_C)
+        qC_hat = torch.ops.quantized.add_relu(qA, qB, scale=scale_C, zero_point=zero_point_C)
+        np.testing.assert_equal(qC, qC_hat.int_repr())
+
+    """Tests the correctness of the quantized::cat op."""
+    def test_qcat(self):
+        X = torch.arange(-12, 12, dtype=torch.float).reshape(2, 3, 4)
+        Y = torch.arange(0, 16, dtype=torch.float).reshape(2, 2, 4)
+        qX = X.quantize_linear(scale=1.0, zero_point=64)
+        qY = Y.quantize_linear(scale=0.5, zero_point=0)
+
+        for scale, zero_point in [(1.0, 64), (0.25, 100)]:
+            Z = torch.cat([qX.dequantize(), qY.dequantize()], dim=1).numpy()
+            qZ = _quantize(Z, scale, zero_point)
+            qZ_hat = torch.ops.quantized.cat([qX, qY], axis=1, scale=scale,
+                                             zero_point=zero_point)
+            np.testing.assert_equal(qZ, qZ_hat.int_repr())
+            qZ_hat = torch.ops.quantized.cat([qX, qY], axis=-2, scale=scale,
+                                             zero_point=zero_point)
+            np.testing.assert_equal(qZ, qZ_hat.int_repr())
+
+    """Tests the correctness of the quantized::max_pool2d op on NHWC input."""
+    def test_qmaxpool2d(self):
+        X = torch.randn(2, 5, 7, 3, dtype=torch.float) * 10
+        qX = X.quantize_linear(scale=0.5, zero_point=128)
+
+        for kernel, stride, padding, dilation in [(3, 2, 1, 1), (2, 1, 0, 2), (2, None, 0, 1)]:
+            # the reference runs on NCHW
+            X_ref = qX.dequantize().permute(0, 3, 1, 2)
+            Y_ref = F.max_pool2d(X_ref, kernel, stride=stride, padding=padding,
+                                 dilation=dilation).permute(0, 2, 3, 1)
+            qY_ref = _quantize(Y_ref.numpy(), 0.5, 128)
+            stride = [] if stride is None else [stride] * 2
+            qY_hat = torch.ops.quantized.max_pool2d(qX, kernel_size=[kernel] * 2,
+                                                    stride=stride, padding=[padding] * 2,
+                                                    dilation=[dilation] * 2)
+            np.testing.assert_equal(qY_ref, qY_hat.int_repr())
+
+    """Tests the correctness of the quantized::avg_pool2d op on NHWC input."""
+    def test_qavgpool2d(self):
+        X = torch.randn(2, 6, 7, 3, dtype=torch.float) * 10
+        qX = X.quantize_linear(scale=0.5, zero_point=128)
+
+        for count_include_pad in [True, False]:
+            X_ref = qX.dequantize().permute(0, 3, 1, 2)
+            Y_ref = F.avg_pool2d(X_ref, 3, stride=2, padding=1,
+                                 count_include_pad=count_include_pad).permute(0, 2, 3, 1)
+            qY_ref = _quantize(Y_ref.numpy(), 0.5, 128)
+            qY_hat = torch.ops.quantized.avg_pool2d(qX, kernel_size=[3, 3], stride=[2, 2],
+                                                    padding=[1, 1],
+                                                    count_include_pad=count_include_pad)
+            # the float average may round a half-way value the other way
+            np.testing.assert_allclose(qY_ref.astype(np.int32),
+                                       qY_hat.int_repr().numpy().astype(np.int32), atol=1)
+
+
+class TestQuantizedEmbeddingBag(unittest.TestCase):
+    """Tests the row-wise quantized quantized::embedding_bag_* ops."""
+
+    def _test_embedding_bag(self, prepack, unpack, embedding_bag, levels):
+        weight = torch.randn(10, 16)
+        packed = prepack(weight)
+        dequantized = unpack(packed)
+        self.assertEqual(dequantized.shape, weight.shape)
+        # Every value is within half a quantization step of the original.
+        step = (weight.max(1, keepdim=True)[0] - weight.min(1, keepdim=True)[0]) / levels
+        self.assertTrue(((dequantized - weight).abs() <= step * 0.5 + 1e-2).all())
+
+        indices = torch.tensor([3, 1, 1, 1, 4, 0, 9], dtype=torch.long)
+        offsets = torch.tensor([0, 0, 3, 3, 6], dtype=torch.long)
+        per_sample_weights = torch.randn(7)
+        for mode, mode_enum in (('sum', 0), ('mean', 1)):
+            expected = F.embedding_bag(indices, dequantized, offsets, mode=mode)
+            result = embedding_bag(packed, indices, offsets, mode_enum)
+            np.testing.assert_allclose(result.numpy(), expected.numpy(), rtol=1e-4, atol=1e-4)
+        expected = F.embedding_bag(indices, dequantized, offsets, mode='sum',
+                                   per_sample_weights=per_sample_weights)
+        result = embedding_bag(packed, indices, offsets, 0, per_sample_weights)
+        np.testing.assert_allclose(result.numpy(), expected.numpy(), rtol=1e-4, atol=1e-4)
+
+        with self.assertRaisesRegex(RuntimeError, "only mode='sum' and mode='mean'"):
+            embedding_bag(packed, indices, offsets, 2)
+        with self.assertRaisesRegex(RuntimeError, "out of bounds"):
+            embedding_bag(packed, indices + 1, offsets)
+
+    def test_embedding_bag_byte(self):
+        ops = torch.ops.quantized
+        self._test_embedding_bag(ops.embedding_bag_byte_prepack,
+                                 ops.embedding_bag_byte_unpack,
+                                 ops.embedding_bag_byte, 255)
+
+    def test_embedding_bag_4bit(self):
+        ops = torch.ops.quantized
+        self._test_embedding_bag(ops.embedding_bag_4bit_prepack,
+                                 ops.embedding_bag_4bit_unpack,
+                                 ops.embedding_bag_4bit, 15)
+        with self.assertRaisesRegex(RuntimeError, "positive multiple of 2"):
+            ops.embedding_bag_4bit_prepack(torch.randn(4, 5))
+
+    def test_embedding_bag_byte_matches_caffe2_layout(self):
+        # Rows hold the uint8 values followed by the float scale and bias.
+        weight = torch.randn(3, 5)
+        packed = torch.ops.quantized.embedding_bag_byte_prepack(weight)
+        self.assertEqual(packed.shape, (3, 5 + 8))
+        scale_bias = packed[:, 5:].contiguous().numpy().view(np.float32)
+        minimum = weight.min(1)[0].numpy()
+        np.testing.assert_allclose(scale_bias[:, 1], minimum)
+        result = torch.fused_8bit_rowwise_embedding_bag(
+            packed, torch.tensor([0, 1, 2]), torch.tensor([0]))
+        expected = torch.ops.quantized.embedding_bag_byte(
+            packed, torch.tensor([0, 1, 2]), torch.tensor([0]))
+        np.testing.assert_allclose(result.numpy(), expected.numpy())
+
 
 @unittest.skipIf(
     TEST_WITH_UBSAN or not torch.fbgemm_is_cpu_supported(),
@@ -342,6 +470,104 @@ class TestQuantizedFC(unittest.TestCase):
         # Assert equal
         np.testing.assert_equal(Y_q_ref2.int_repr().numpy(), Y_q.int_repr().numpy())
 
+    """Tests quantized::fc with a weight quantized per output channel."""
+    def test_qfc_per_channel(self):
+        qfc_prepack = torch.ops.quantized.fbgemm_linear_prepack
+        qfc = torch.ops.quantized.fbgemm_linear
+
+        batch_size = 4
+        input_channels = 16
+        output_channels = 8
+
+        X_scale = 1.5
+        X_zp = 5
+        # Small values keep the pairwise products clear of the vpmaddubsw
+        # saturation.
+        X_q0 = np.random.randint(X_zp, X_zp + 40,
+                                 (batch_size, input_channels)).astype(np.uint8)
+        X = torch.from_numpy(_dequantize(X_q0, X_scale, X_zp)).to(dtype=torch.float)
+        X_q = X.quantize_linear(scale=X_scale, zero_point=X_zp)
+
+        # A weight whose output channels differ in range by orders of magnitude
+        W = torch.randn(output_channels, input_channels) * \
+            torch.logspace(-2, 1, output_channels).reshape(-1, 1)
+        W_scales = W.abs().max(dim=1)[0].to(dtype=torch.double) / 8
+        W_zps = torch.full((output_channels,), 128, dtype=torch.long)
+        W_q = W.quantize_linear_per_channel(W_scales, W_zps, [0])
+        b_q = torch.randint(-10, 10, (output_channels,), dtype=torch.int32)
+
+        Y_scale = 0.5
+        Y_zp = 128
+        Y_q = qfc(X_q, qfc_prepack(W_q), b_q, Y_scale, Y_zp)
+
+        # Reference from the float linear with the dequantized operands, the
+        # bias of each channel having the scale X_scale * W_scales[i]
+        b = b_q.to(dtype=torch.double) * X_scale * W_scales
+        Y_ref = F.linear(X_q.dequantize(), W_q.dequantize(), b.to(dtype=torch.float))
+        Y_q_ref = Y_ref.quantize_linear(Y_scale, Y_zp)
+        np.testing.assert_allclose(Y_q_ref.int_repr().numpy().astype(np.int32),
+                                   Y_q.int_repr().numpy().astype(np.int32), atol=1)
+
+
+@unittest.skipIf(
+    TEST_WITH_UBSAN or not torch.fbgemm_is_cpu_supported(),
+    " Quantized convolution requires FBGEMM. FBGEMM does not play"
+    " well with UBSAN at the moment, so we skip the test if"
+    " we are in a UBSAN environment.",
+)
+class TestQuantizedConv(unittest.TestCase):
+    """Tests the correctness of the quantized::fbgemm_conv2d op."""
+
+    def _test_qconv(self, qconv, relu):
+        qconv_prepack = torch.ops.quantized.fbgemm_conv_prepack
+
+        batch_size, groups = 2, 2
+        input_channels, output_channels = 4, 6
+        height, width = 8, 7
+        kernel, stride, padding = 3, 2, 1
+
+        X_scale, X_zp = 0.5, 10
+        W_scale, W_zp = 0.25, 2
+        Y_scale, Y_zp = 2.0, 5
+
+        # Small values keep the pairwise products clear of the vpmaddubsw
+        # saturation.
+        X_q0 = np.random.randint(X_zp, X_zp + 40,
+                                 (batch_size, height, width, input_channels)).astype(np.uint8)
+        W_q0 = np.random.randint(-8, 8,
+                                 (output_channels, kernel, kernel,
+                                  input_channels // groups)).astype(np.int8)
+        b_q = torch.randint(-10, 10, (output_channels,), dtype=torch.int32)
+
+        X = torch.from_numpy(_dequantize(X_q0, X_scale, X_zp)).to(dtype=torch.float)
+        W = torch.from_numpy(_dequantize(W_q0, W_scale, W_zp)).to(dtype=torch.float)
+        X_q = X.quantize_linear(scale=X_scale, zero_point=X_zp)
+        # W_zp + 128 is the zero point for uint8 quantization.
+        W_q = W.quantize_linear(scale=W_scale, zero_point=W_zp + 128)
+
+        W_prepack = qconv_prepack(W_q, groups)
+        Y_q = qconv(X_q, W_prepack, b_q, [stride] * 2, [padding] * 2, [1, 1],
+                    groups, Y_scale, Y_zp)
+
+        # Reference from the float convolution on NCHW
+        b = b_q.to(dtype=torch.float) * X_scale * W_scale
+        Y_ref = F.conv2d(X_q.dequantize().permute(0, 3, 1, 2),
+                         W_q.dequantize().permute(0, 3, 1, 2), b,
+                         stride=stride, padding=padding, groups=groups)
+        if relu:
+            Y_ref = F.relu(Y_ref)
+        Y_q_ref = Y_ref.permute(0, 2, 3, 1).quantize_linear(Y_scale, Y_zp)
+
+        self.assertEqual(Y_q.size(), Y_q_ref.size())
+        np.testing.assert_allclose(Y_q_ref.int_repr().numpy().astype(np.int32),
+                                   Y_q.int_repr().numpy().astype(np.int32), atol=1)
+
+    def test_qconv(self):
+        self._test_qconv(torch.ops.quantized.fbgemm_conv2d, relu=False)
+
+    def test_qconv_relu(self):
+        self._test_qconv(torch.ops.quantized.fbgemm_conv2d_relu, relu=True)
+
 
 if __name__ == "__main__":
     run_tests()
@@ -0,0 +1,167 @@
+import sys
+import unittest
+
+import torch
+import torch.distributed as dist
+
+from common_utils import load_tests, run_tests
+from test_c10d import MultiProcessTestCase
+
+# load_tests from common_utils is used to automatically filter tests for
+# sharding on sandcastle. This line silences flake warnings
+load_tests = load_tests
+
+if not dist.is_available():
+    print('c10d not available, skipping tests')
+    sys.exit(0)
+
+
+def my_function(a, b, c):
+    return a + b + c
+
+
+def no_result():
+    print("do nothing")
+
+
+def raise_func():
+    raise ValueError("Expected error")
+
+
+def _wrap_with_rpc(func):
+    def wrapper(self):
+        store = dist.FileStore(self.file.name, self.world_size)
+        dist.init_process_group(backend='gloo', rank=self.rank,
+                                world_size=self.world_size, store=store)
+        dist.init_rpc('worker{}'.format(self.rank))
+        func(self)
+        dist.join_rpc()
+
+    return wrapper
+
+
+@unittest.skipIf(not hasattr(torch._C, '_rpc_init'), "RPC is not available")
+class RpcTest(MultiProcessTestCase):
+
+    @property
+    def world_size(self):
+        return 4
+
+    @_wrap_with_rpc
+    def test_worker_name(self):
+        with self.assertRaisesRegex(RuntimeError, "is already initialized"):
+            dist.init_rpc('worker{}'.format(self.rank))
+
+    @_wrap_with_rpc
+    def test_add(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = dist.rpc('worker{}'.format(dst_rank), torch.add,
+                       args=(torch.ones(n, n), torch.ones(n, n)))
+        self.assertEqual(ret, torch.ones(n, n) * 2)
+
+    @_wrap_with_rpc
+    def test_scalar_add(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = dist.rpc('worker{}'.format(dst_rank), torch.add,
+                       args=(torch.ones(n, n), n))
+        self.assertEqual(ret, (torch.ones(n, n) + n))
+
+    @_wrap_with_rpc
+    def test_kwargs(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = dist.rpc('worker{}'.format(dst_rank), torch.add,
+                       args=(torch.ones(n, n), 2),
+                       kwargs={'alpha': 3})
+        self.assertEqual(ret, torch.ones(n, n) + 6)
+
+    @_wrap_with_rpc
+    def test_multi_return(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        values, indices = dist.rpc('worker{}'.format(dst_rank), torch.max,
+                                   args=(torch.arange(n * 2.).view(2, n), 1))
+        self.assertEqual(values, torch.tensor([n - 1., 2 * n - 1.]))
+        self.assertEqual(indices, torch.tensor([n - 1, n - 1]))
+
+    @_wrap_with_rpc
+    def test_async_add(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        fut = dist.rpc('worker{}'.format(dst_rank), torch.add,
+                       args=(torch.ones(n, n), torch.ones(n, n)),
+                       async_call=True)
+        self.assertEqual(fut.wait(), torch.ones(n, n) * 2)
+
+    @_wrap_with_rpc
+    def test_sync_rpc(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        for _ in range(20):
+            dist.sync_rpc()
+            ret = dist.rpc('worker{}'.format(dst_rank), torch.add,
+                           args=(torch.ones(n, n), torch.ones(n, n)))
+            self.assertEqual(ret, torch.ones(n, n) * 2)
+            dist.sync_rpc()
+
+    @_wrap_with_rpc
+    def test_self_add(self):
+        ret = dist.rpc('worker{}'.format(self.rank), torch.add,
+                       args=(torch.ones(2, 2), 1))
+        self.assertEqual(ret, torch.ones(2, 2) + 1)
+
+    @_wrap_with_rpc
+    def test_nonexisting_worker(self):
+        with self.assertRaisesRegex(RuntimeError, "Unknown RPC destination"):
+            dist.rpc('nonexisting', torch.add, args=(torch.ones(2, 2), 1))
+
+    @_wrap_with_rpc
+    def test_py_built_in(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = dist.rpc('worker{}'.format(dst_rank), min, args=(n, n + 1, n + 2))
+        self.assertEqual(ret, min(n, n + 1, n + 2))
+
+    @_wrap_with_rpc
+    def test_py_user_defined(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = dist.rpc('worker{}'.format(dst_rank), my_function,
+                       kwargs={'a': n, 'b': n + 1, 'c': n + 2})
+        self.assertEqual(ret, my_function(n, n + 1, n + 2))
+
+    @_wrap_with_rpc
+    def test_py_tensors(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = dist.rpc('worker{}'.format(dst_rank), my_function,
+                       args=(torch.ones(n, n), torch.ones(n, n), 1))
+        self.assertEqual(ret, torch.ones(n, n) * 2 + 1)
+
+    @_wrap_with_rpc
+    def test_py_no_return_result(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        ret = dist.rpc('worker{}'.format(dst_rank), no_result)
+        self.assertEqual(ret, no_result())
+
+    @_wrap_with_rpc
+    def test_py_raise_in_user_func(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        with self.assertRaisesRegex(RuntimeError, "Expected error"):
+            dist.rpc('worker{}'.format(dst_rank), raise_func)
+
+    @_wrap_with_rpc
+    def test_builtin_op_error(self):
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        with self.assertRaisesRegex(RuntimeError, "size of tensor"):
+            dist.rpc('worker{}'.format(dst_rank), torch.add,
+                     args=(torch.ones(2, 2), torch.ones(3, 3)))
+
+
+if __name__ == '__main__':
+    run_tests()
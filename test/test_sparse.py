@@ -674,6 +674,33 @@ class TestSparse(TestCase):
         test_shape(10, 20, 0, 0)
         test_shape(10, 20, 0, 20)
 
+    def test_coalesce_large(self):
+        def check(indices, values, size):
+            x = self.sparse_tensor(indices, values, size)
+            y = x.coalesce()
+            self.assertTrue(y.is_coalesced())
+            self.assertEqual(y.to_dense(), x.to_dense())
+            flat = y._indices()[0] * size[1] + y._indices()[1]
+            self.assertTrue((flat[1:] > flat[:-1]).all())
+            return y
+
+        size = [300, 400]
+        # Enough indices for the CPU sort to be split across threads, with
+        # many duplicates.
+        nnz = 100000
+        indices = torch.stack([torch.randint(0, size[0], (nnz,)),
+                               torch.randint(0, size[1], (nnz,))]).to(self.device)
+        check(indices, torch.randn(nnz, device=self.device), size)
+        check(indices, torch.randn(nnz, 3, device=self.device), size + [3])
+        check(indices, torch.randint(0, 5, (nnz,), device=self.device), size)
+
+        # Sorted indices, with and without duplicates, skip the sort.
+        y = check(indices, torch.randn(nnz, device=self.device), size)
+        check(y._indices(), y._values(), size)
+        sorted_indices = y._indices().repeat_interleave(2, dim=1)
+        z = check(sorted_indices, y._values().repeat_interleave(2), size)
+        self.assertEqual(z._values(), y._values() * 2)
+
     def test_t_empty(self):
         def test_in_place(x):
             shape_original = x.shape
@@ -897,6 +924,65 @@ class TestSparse(TestCase):
         test_shape(1000, 100, 0, 0)
         test_shape(1000, 100, 0, 20)
 
+    def test_sparse_mm_uncoalesced_and_repeated(self):
+        def test_shape(di, dj, dk, nnz):
+            x = self._gen_sparse(2, nnz, [di, dj])[0]
+            # duplicate the nonzeros so that x is never coalesced
+            x = self.sparse_tensor(torch.cat([x._indices(), x._indices()], 1),
+                                   torch.cat([x._values(), x._values()], 0),
+                                   x.shape)
+            y = self.randn(dj, dk)
+            expected = torch.mm(self.safeToDense(x), y)
+            self.assertEqual(torch.sparse.mm(x, y), expected)
+
+            # repeated products with a coalesced matrix reuse its row pointers
+            xc = x.coalesce()
+            for _ in range(2):
+                self.assertEqual(torch.sparse.mm(xc, y), expected)
+
+            # growing the matrix must not reuse stale row pointers
+            xc.sparse_resize_((di + 3, dj), 2, 0)
+            res = torch.sparse.mm(xc, y)
+            self.assertEqual(res.shape, (di + 3, dk))
+            self.assertEqual(res[:di], expected)
+            self.assertEqual(res[di:], torch.zeros(3, dk, device=self.device))
+
+        test_shape(7, 5, 3, 20)
+        test_shape(300, 64, 30, 1000)
+        test_shape(1000, 100, 0, 20)
+
+    def test_sparse_mm_row_pointers_invalidated(self):
+        def check(x):
+            self.assertEqual(torch.sparse.mm(x, y), torch.mm(self.safeToDense(x), y))
+
+        indices = self.index_tensor([[0, 0, 1, 2], [0, 2, 1, 0]])
+        other_indices = self.index_tensor([[0, 1, 1, 3], [0, 0, 1, 0]])
+        x = self.sparse_tensor(indices, self.value_tensor([1., 2., 3., 4.]), (4, 3)).coalesce()
+        y = self.randn(3, 2)
+        # caches the row pointers of x
+        check(x)
+
+        # a detached tensor shares the indices of x, but computes its own row
+        # pointers, so writes to the indices don't leave it with stale ones
+        detached = x.detach()
+        x._indices().copy_(other_indices)
+        check(detached)
+
+        # in-place writes to the indices aren't tracked, but setting the
+        # coalesced flag drops the cached row pointers
+        x._coalesced_(True)
+        check(x)
+
+        # so does resizing
+        x._indices().copy_(indices)
+        x.sparse_resize_((5, 3), 2, 0)
+        check(x)
+
+        # and an uncoalesced tensor doesn't use them
+        x._indices().copy_(other_indices)
+        x._coalesced_(False)
+        check(x)
+
     @skipIfRocm
     def test_hsmm(self):
         def test_shape(di, dj, dk, nnz):
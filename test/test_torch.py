@@ -482,6 +482,16 @@ class _TestTorchMixin(object):
         self.assertRaises(RuntimeError, lambda: torch.addr(m, v, s))
         self.assertRaises(RuntimeError, lambda: torch.addr(m, s, v))
 
+    def _assert_same_with_one_thread(self, fn):
+        # checks that the result of fn() doesn't depend on the number of threads
+        num_threads = torch.get_num_threads()
+        try:
+            torch.set_num_threads(1)
+            serial = fn()
+        finally:
+            torch.set_num_threads(num_threads)
+        self.assertEqual(fn(), serial, prec=0)
+
     def _test_math(self, torchfn, mathfn, input=None, test_expand=False):
         if input is None:
             input = []
@@ -1280,6 +1290,29 @@ class _TestTorchMixin(object):
             expected = brute_cdist(x, y, p=2)
             self.assertTrue(torch.allclose(expected, actual))
 
+    def test_cdist_pdist_large_mm(self):
+        # large p=2 inputs go through the matrix multiplication formulation
+        for device in torch.testing.get_all_device_types():
+            for dtype in [torch.float32, torch.float64]:
+                x = torch.randn(100, 64, dtype=dtype, device=device)
+                y = torch.randn(60, 64, dtype=dtype, device=device)
+                self.assertTrue(torch.allclose(brute_cdist(x, y, p=2), torch.cdist(x, y, p=2)))
+                self.assertTrue(torch.allclose(brute_cdist(y, x, p=2), torch.cdist(y, x, p=2)))
+                self.assertTrue(torch.allclose(brute_pdist(x, p=2), torch.pdist(x, p=2)))
+                # repeated rows have a zero distance and a zero gradient
+                x[1] = x[0]
+                self.assertEqual(torch.pdist(x, p=2)[0], 0)
+                self.assertEqual(torch.cdist(x, x[:1], p=2)[:2], torch.zeros(2, 1, dtype=dtype, device=device))
+
+            x = torch.randn(30, 8, dtype=torch.double, device=device, requires_grad=True)
+            y = torch.randn(5, 8, dtype=torch.double, device=device, requires_grad=True)
+            self.assertTrue(torch.autograd.gradcheck(lambda x, y: torch.cdist(x, y, p=2), (x, y)))
+            self.assertTrue(torch.autograd.gradcheck(lambda x: torch.pdist(x, p=2), (x,)))
+            x.data[1] = x.data[0]
+            x.grad = None
+            torch.pdist(x, p=2).sum().backward()
+            self.assertFalse(torch.isnan(x.grad).any())
+
     def test_cdist_non_contiguous(self):
         for device in torch.testing.get_all_device_types():
             x = torch.randn(5, 7, device=device).t()
@@ -1596,6 +1629,39 @@ class _TestTorchMixin(object):
             res2[i, 3] = res2[i, 3] / 2
         self.assertEqual(res1, res2)
 
+    def test_half_cpu_ops(self):
+        # 1000 elements cover the vectorized loops and their scalar tails
+        a = torch.randn(1000).half()
+        b = (torch.rand(1000) + 0.5).half()
+        af, bf = a.float(), b.float()
+
+        def check(res, expected, prec=1e-3):
+            self.assertEqual(res.dtype, torch.half)
+            self.assertEqual(res.float(), expected, prec)
+
+        check(a + b, (af + bf).half().float())
+        check(torch.add(a, 2, b), (af + 2 * bf).half().float())
+        check(a - b, (af - bf).half().float())
+        check(a * b, (af * bf).half().float())
+        check(a / b, (af / bf).half().float())
+        check(a.abs(), af.abs())
+        check(a.neg(), af.neg())
+        check(b.reciprocal(), bf.reciprocal(), 1e-2)
+        check(b.rsqrt(), bf.rsqrt(), 1e-2)
+        check(a.sigmoid(), af.sigmoid(), 1e-2)
+        check(a.frac(), af.frac(), 1e-2)
+        # non-contiguous inputs go through the strided loops
+        check(a[::2] * b[::2], (af[::2] * bf[::2]).half().float())
+
+        m = torch.randn(37, 53).half()
+        mf = m.float()
+        # the scalar tails accumulate in half precision
+        self.assertEqual(m.sum().float(), mf.sum(), 1)
+        self.assertEqual(m.sum(0).float(), mf.sum(0), 0.25)
+        self.assertEqual(m.sum(1).float(), mf.sum(1), 0.25)
+        p = (torch.rand(3, 40) * 0.2 + 0.9).half()
+        self.assertEqual(p.prod(1).float(), p.float().prod(1), 0.05)
+
     def test_floordiv(self):
         for dtype in torch.testing.get_all_math_dtypes('cpu'):
             if dtype is torch.float16:
@@ -1908,6 +1974,25 @@ class _TestTorchMixin(object):
         res6 = torch.baddbmm(.1, res2, .5, b1, b2)
         self.assertEqual(res6, res2 * .1 + res * .5)
 
+    def test_bmm_small(self):
+        # sizes covered by the fixed-size and the generic small-matrix kernels,
+        # with non-contiguous inputs and beta == 0 ignoring NaN in the output
+        for M, N, O in [(2, 2, 2), (3, 3, 3), (4, 4, 4), (8, 8, 8), (5, 3, 7), (16, 16, 16), (1, 16, 1)]:
+            for dtype in [torch.float, torch.double, torch.long]:
+                b1 = torch.randn(300, N, M).mul(10).to(dtype).transpose(1, 2)
+                b2 = torch.randn(300, N, O).mul(10).to(dtype)
+                res = torch.bmm(b1, b2)
+                expected = torch.stack([torch.mm(b1[i], b2[i]) for i in range(300)])
+                self.assertEqual(res, expected)
+
+                out = torch.full_like(res, float('nan')) if dtype.is_floating_point else res.clone()
+                torch.baddbmm(out, b1, b2, beta=0, out=out)
+                self.assertEqual(out, expected)
+
+                out = res.clone()
+                out.baddbmm_(b1, b2, beta=2, alpha=3)
+                self.assertEqual(out, res * 2 + expected * 3)
+
     @staticmethod
     def _test_clamp(self, device='cpu'):
         m1 = torch.rand(100, device=device).mul(5).add(-2.5)  # uniform in [-2.5, 2.5]
@@ -2276,6 +2361,91 @@ class _TestTorchMixin(object):
                 lambda n, d: n.var(d, ddof=1 if unbiased else 0),
                 use_integral=False)
 
+    def test_reduce_outer_dims(self):
+        # reductions over leading dimensions of inputs that are contiguous in
+        # the kept dimension take the column reduction paths on CPU
+        for device in torch.testing.get_all_device_types():
+            for dtype in [torch.float, torch.double]:
+                for shape, dim in [((1000, 13), 0), ((257, 40), 0), ((3, 500, 70), 1),
+                                   ((40000, 3), 0), ((5, 6, 7, 100), [0, 1])]:
+                    x = torch.randn(shape, dtype=dtype, device=device)
+                    dims = [dim] if isinstance(dim, int) else dim
+                    # move the reduced dims last, so that the reference reduces
+                    # over the contiguous dimensions instead
+                    kept = [d for d in range(x.dim()) if d not in dims]
+                    ref = x.permute(kept + dims).contiguous()
+                    ref_dims = list(range(len(kept), x.dim()))
+                    prec = 1e-3 if dtype == torch.float else 1e-8
+                    self.assertEqual(x.sum(dim), ref.sum(ref_dims), prec)
+                    self.assertEqual(x.mean(dim), ref.mean(ref_dims), prec)
+                    self.assertEqual(x.var(dim), ref.var(ref_dims), prec)
+                    self.assertEqual(x.std(dim, unbiased=False), ref.std(ref_dims, unbiased=False), prec)
+                    self.assertEqual(x.norm(3, dim), ref.norm(3, ref_dims), prec)
+                    self.assertEqual(x.max_values(dim), ref.max_values(ref_dims))
+
+    def test_var_mean_std_mean(self):
+        for device in torch.testing.get_all_device_types():
+            x = torch.randn(5, 7, 11, dtype=torch.double, device=device)
+            for unbiased in [False, True]:
+                for dim in [None, 0, 2, [0, 2], [-1, 1]]:
+                    for keepdim in [False, True]:
+                        if dim is None:
+                            var, mean = torch.var_mean(x, unbiased=unbiased)
+                            std, mean2 = torch.std_mean(x, unbiased=unbiased)
+                            self.assertEqual(var, x.var(unbiased=unbiased))
+                            self.assertEqual(std, x.std(unbiased=unbiased))
+                            self.assertEqual(mean, x.mean())
+                            self.assertEqual(mean2, x.mean())
+                            if keepdim:
+                                continue
+                        else:
+                            var, mean = torch.var_mean(x, dim, unbiased=unbiased, keepdim=keepdim)
+                            std, mean2 = torch.std_mean(x, dim, unbiased=unbiased, keepdim=keepdim)
+                            self.assertEqual(var, x.var(dim, unbiased=unbiased, keepdim=keepdim))
+                            self.assertEqual(std, x.std(dim, unbiased=unbiased, keepdim=keepdim))
+                            self.assertEqual(mean, x.mean(dim, keepdim=keepdim))
+                            self.assertEqual(mean2, x.mean(dim, keepdim=keepdim))
+
+            # large enough to be split across threads / thread blocks
+            x = torch.randn(300000, dtype=torch.float, device=device) * 3 + 5
+            var, mean = torch.var_mean(x)
+            self.assertEqual(var, x.var(), 1e-3)
+            self.assertEqual(mean, x.mean(), 1e-4)
+
+            # gradients flow through both outputs
+            x = torch.randn(3, 4, dtype=torch.double, device=device, requires_grad=True)
+            self.assertTrue(torch.autograd.gradcheck(lambda t: torch.var_mean(t, 1), (x,)))
+            self.assertTrue(torch.autograd.gradcheck(lambda t: torch.std_mean(t, [0, 1]), (x,)))
+            self.assertTrue(torch.autograd.gradcheck(lambda t: torch.std_mean(t)[1], (x,)))
+
+            empty = torch.empty(0, 3, device=device)
+            var, mean = torch.var_mean(empty, 0)
+            self.assertTrue(torch.isnan(var).all() and torch.isnan(mean).all())
+            self.assertRaises(RuntimeError, lambda: torch.var_mean(torch.ones(3, dtype=torch.long, device=device)))
+
+    def test_aminmax(self):
+        for device in torch.testing.get_all_device_types():
+            for dtype in [torch.float, torch.double, torch.int, torch.long, torch.uint8]:
+                x = (torch.randn(6, 8, 10, device=device) * 100).to(dtype)
+                mn, mx = torch.aminmax(x)
+                self.assertEqual(mn, x.min())
+                self.assertEqual(mx, x.max())
+                for dim in [0, 2, [0, 1], [-1, 0]]:
+                    for keepdim in [False, True]:
+                        mn, mx = x.aminmax(dim, keepdim=keepdim)
+                        self.assertEqual(mn, x.min_values(dim, keepdim=keepdim))
+                        self.assertEqual(mx, x.max_values(dim, keepdim=keepdim))
+
+            x = torch.randn(200000, device=device)
+            mn, mx = torch.aminmax(x)
+            self.assertEqual(mn, x.min())
+            self.assertEqual(mx, x.max())
+            x[12345] = float('nan')
+            mn, mx = torch.aminmax(x)
+            self.assertTrue(torch.isnan(mn) and torch.isnan(mx))
+
+            self.assertRaises(RuntimeError, lambda: torch.aminmax(torch.empty(0, device=device)))
+
     @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
     @unittest.skipIf(not TEST_SCIPY, 'Scipy not found')
     def test_logsumexp_dim(self):
@@ -2422,6 +2592,31 @@ class _TestTorchMixin(object):
         expected = torch.tensor([[0.]], dtype=torch.float16)
         self.assertEqual(halfTensor, expected)
 
+    def test_zeros_lazy_zero_fill(self):
+        prev = torch._C._get_lazy_zero_fill()
+        torch._C._set_lazy_zero_fill(True)
+        try:
+            self.assertTrue(torch._C._get_lazy_zero_fill())
+            for size in [(0,), (3, 4), (512, 1024)]:
+                for dtype in [torch.float, torch.double, torch.int64, torch.bool]:
+                    res = torch.zeros(*size, dtype=dtype)
+                    self.assertEqual(res.shape, size)
+                    self.assertEqual(res.dtype, dtype)
+                    self.assertFalse(res.any())
+                    res_like = torch.zeros_like(res)
+                    self.assertFalse(res_like.any())
+            res = torch.zeros(512, 1024, requires_grad=True)
+            self.assertTrue(res.requires_grad)
+            self.assertEqual(res.sum().item(), 0)
+            # writes and resizes of a lazily zeroed storage
+            res = torch.zeros(512, 1024)
+            res[-1, -1] = 1
+            self.assertEqual(res.sum().item(), 1)
+            res.resize_(1024, 1024)
+            self.assertEqual(res[511, 1023].item(), 1)
+        finally:
+            torch._C._set_lazy_zero_fill(prev)
+
     def test_zeros_like(self):
         expected = torch.zeros(100, 100)
 
@@ -2591,6 +2786,22 @@ class _TestTorchMixin(object):
             copied_dtype = copy.deepcopy(dtype)
             self.assertIs(dtype, copied_dtype)
 
+    def test_copy_cast_contiguous_and_strided(self):
+        # odd sizes exercise the scalar tail of the vectorized conversions
+        for n in [1, 7, 8, 31, 100]:
+            pairs = [(torch.randint(0, 256, (n,), dtype=torch.uint8), torch.float),
+                     (torch.randint(-128, 128, (n,), dtype=torch.int8), torch.float),
+                     (torch.randint(-2 ** 31, 2 ** 31, (n,), dtype=torch.int64), torch.int32),
+                     (torch.randint(-2 ** 31, 2 ** 31, (n,), dtype=torch.int32), torch.int64),
+                     (torch.randn(n), torch.half),
+                     (torch.randn(n).half(), torch.float),
+                     (torch.randn(n), torch.bool)]
+            for src, dtype in pairs:
+                expected = torch.tensor(src.tolist(), dtype=torch.double).to(dtype)
+                self.assertEqual(src.to(dtype), expected, 0)
+                strided = torch.stack([src, src], 1)[:, 0]
+                self.assertEqual(strided.to(dtype), expected, 0)
+
     def test_device(self):
         cpu = torch.device('cpu')
         self.assertEqual('cpu', str(cpu))
@@ -2728,6 +2939,34 @@ class _TestTorchMixin(object):
         rqr = qr.dequantize()
         self.assertTrue(np.allclose(r.numpy(), rqr.numpy(), atol=2 / scale))
 
+    def test_qtensor_per_channel(self):
+        r = torch.rand(3, 2, 4, dtype=torch.float) * 4 - 2
+        scales = torch.tensor([0.2, 0.03, 0.5], dtype=torch.double)
+        zero_points = torch.tensor([5, 10, 128], dtype=torch.long)
+        qr = r.quantize_linear_per_channel(scales, zero_points, [0])
+        self.assertTrue(qr.is_quantized)
+        self.assertEqual(qr.q_per_channel_scales(), scales)
+        self.assertEqual(qr.q_per_channel_zero_points(), zero_points)
+        self.assertRaises(RuntimeError, lambda: qr.q_scale())
+
+        # each channel is quantized with its own parameters
+        for c in range(3):
+            expected = r[c].quantize_linear(scales[c].item(), zero_points[c].item())
+            self.assertEqual(qr.int_repr()[c], expected.int_repr())
+            self.assertEqual(qr.dequantize()[c], expected.dequantize())
+
+        # an inner axis
+        scales = torch.tensor([0.1, 0.25], dtype=torch.double)
+        zero_points = torch.tensor([3, 7], dtype=torch.long)
+        qr = r.quantize_linear_per_channel(scales, zero_points, [-2])
+        for c in range(2):
+            expected = r[:, c].quantize_linear(scales[c].item(), zero_points[c].item())
+            self.assertEqual(qr.int_repr()[:, c], expected.int_repr())
+        self.assertTrue('zero_points=[3, 7]' in str(qr))
+
+        with self.assertRaisesRegex(RuntimeError, 'channels along axis'):
+            r.quantize_linear_per_channel(scales, zero_points, [0])
+
     def test_qtensor_creation(self):
         scale = 0.5
         zero_point = 10
@@ -3147,6 +3386,27 @@ class _TestTorchMixin(object):
                 x.resize_as_(y)
                 self.assertEqual(y.shape, x.shape)
 
+    def test_reserve(self):
+        for device in torch.testing.get_all_device_types():
+            x = torch.tensor([[1., 2.], [3., 4.]], device=device)
+            x.reserve_(10)
+            self.assertEqual(x.storage().size(), 10)
+            self.assertEqual(x, torch.tensor([[1., 2.], [3., 4.]], device=device))
+            # growing within the reserved space keeps the storage
+            data_ptr = x.data_ptr()
+            x.resize_(5, 2)
+            self.assertEqual(x.data_ptr(), data_ptr)
+            self.assertEqual(x[:2], torch.tensor([[1., 2.], [3., 4.]], device=device))
+            # growing past it reallocates geometrically
+            x.resize_(6, 2)
+            self.assertEqual(x.storage().size(), 15)
+            self.assertEqual(x[:2], torch.tensor([[1., 2.], [3., 4.]], device=device))
+            # tensors without reserved space grow to exactly the requested size
+            y = torch.zeros(5, 2, device=device)
+            y.resize_(6, 2)
+            self.assertEqual(y.storage().size(), 12)
+            self.assertRaises(RuntimeError, lambda: y.reserve_(-1))
+
     def test_view_all_dtypes_and_devices(self):
         for device in torch.testing.get_all_device_types():
             for dt in torch.testing.get_all_dtypes():
@@ -3662,6 +3922,23 @@ class _TestTorchMixin(object):
             torch.range(0, 10)
             self.assertEqual(len(w), 1)
 
+    def test_overload_cache(self):
+        # the signature picked for some argument types is remembered; calls
+        # whose tensors have different properties must still match afresh
+        x = torch.ones(3)
+        scalar = torch.tensor(2.)
+        scalar_grad = torch.tensor(2., requires_grad=True)
+        for _ in range(3):
+            self.assertEqual(torch.add(x, 2), torch.full((3,), 3))
+            self.assertEqual(torch.add(x, scalar), torch.full((3,), 3))
+            self.assertEqual(torch.add(x, x), torch.full((3,), 2))
+            self.assertEqual(torch.arange(torch.tensor(3)), torch.arange(3))
+            # a 0-dim tensor that requires grad doesn't bind to Scalar
+            self.assertRaises(TypeError, lambda: torch.arange(scalar_grad))
+            self.assertEqual(torch.arange(scalar), torch.arange(2.))
+            self.assertEqual(x.view(torch.tensor(3)), x)
+            self.assertRaises(TypeError, lambda: x.view(torch.tensor([3, 1])))
+
     def test_arange(self):
         res1 = torch.arange(0, 1)
         res2 = torch.Tensor()
@@ -4022,6 +4299,85 @@ class _TestTorchMixin(object):
     def test_contiguous(self):
         return self._test_contiguous(self, lambda t: t)
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    def test_conflicting_strides(self):
+        # inputs that run faster along a different dimension than the output
+        # are traversed in tiles; sizes aren't multiples of the tile size
+        for dtype in [torch.uint8, torch.float, torch.double]:
+            a = torch.rand(300, 170).mul(100).to(dtype)
+            b = torch.rand(170, 300).mul(100).to(dtype)
+            self.assertEqual((a.t() + b).numpy(), a.numpy().T + b.numpy())
+            self.assertEqual(a.t().contiguous().numpy(), np.ascontiguousarray(a.numpy().T))
+
+            # channels-last to contiguous
+            x = torch.rand(2, 67, 45, 19).mul(100).to(dtype).permute(0, 3, 1, 2)
+            self.assertEqual(x.contiguous().numpy(),
+                             np.ascontiguousarray(x.numpy()))
+            out = torch.empty(2, 19, 67, 45, dtype=dtype)
+            torch.add(x, x.contiguous(), out=out)
+            self.assertEqual(out.numpy(), x.numpy() * 2)
+
+    def test_memory_format(self):
+        for device in torch.testing.get_all_device_types():
+            x = torch.randn(4, 3, 8, 8, device=device)
+            nhwc = x.contiguous(memory_format=torch.channels_last)
+            self.assertEqual(nhwc, x)
+            self.assertEqual(nhwc.stride(), (192, 1, 24, 3))
+            self.assertFalse(nhwc.is_contiguous())
+            self.assertTrue(nhwc.is_contiguous(memory_format=torch.channels_last))
+            self.assertFalse(x.is_contiguous(memory_format=torch.channels_last))
+            # already in the requested format: no copy
+            self.assertEqual(nhwc.contiguous(memory_format=torch.channels_last).data_ptr(), nhwc.data_ptr())
+            self.assertTrue(nhwc.contiguous().is_contiguous())
+            self.assertEqual(nhwc.contiguous(), x)
+
+            # a permuted NHWC tensor is channels last contiguous as well
+            y = torch.randn(4, 8, 8, 3, device=device).permute(0, 3, 1, 2)
+            self.assertTrue(y.is_contiguous(memory_format=torch.channels_last))
+
+            # channels last is only defined for 4-d tensors
+            self.assertFalse(torch.randn(3, 8, 8, device=device).is_contiguous(memory_format=torch.channels_last))
+            self.assertRaises(RuntimeError, lambda: torch.randn(3, 8, 8, device=device).contiguous(
+                memory_format=torch.channels_last))
+
+    def test_empty_memory_format(self):
+        for device in torch.testing.get_all_device_types():
+            x = torch.empty((2, 3, 4, 5), device=device, memory_format=torch.channels_last)
+            self.assertEqual(x.stride(), (60, 1, 15, 3))
+            self.assertTrue(x.is_contiguous(memory_format=torch.channels_last))
+            x = torch.empty((2, 3, 4, 5), device=device, memory_format=torch.contiguous_format)
+            self.assertEqual(x.stride(), (60, 20, 5, 1))
+            self.assertRaises(RuntimeError, lambda: torch.empty((2, 3, 4), device=device,
+                                                                memory_format=torch.channels_last))
+            out = torch.empty(0, device=device)
+            torch.empty((2, 3, 4, 5), memory_format=torch.channels_last, out=out)
+            self.assertEqual(out.stride(), (60, 1, 15, 3))
+
+    def test_memory_format_preserved(self):
+        for device in torch.testing.get_all_device_types():
+            x = torch.randn(2, 3, 6, 6, device=device)
+            nhwc = x.contiguous(memory_format=torch.channels_last)
+
+            def check(fn):
+                result = fn(nhwc)
+                self.assertTrue(result.is_contiguous(memory_format=torch.channels_last))
+                self.assertEqual(result, fn(x))
+
+            # elementwise operators
+            check(lambda t: t + 1)
+            check(lambda t: t * t)
+            check(lambda t: t.relu())
+            check(lambda t: torch.sigmoid(t))
+
+            # convolution, batch norm and pooling
+            conv = torch.nn.Conv2d(3, 4, 3, padding=1).to(device)
+            bn = torch.nn.BatchNorm2d(3).to(device)
+            bn.eval()
+            check(conv)
+            check(bn)
+            check(lambda t: torch.nn.functional.max_pool2d(t, 2))
+            check(lambda t: torch.nn.functional.adaptive_avg_pool2d(t, 1))
+
     def test_empty_tensor_props(self):
         sizes = [(0,), (0, 3), (5, 0), (5, 0, 3, 0, 2), (0, 3, 0, 2), (0, 5, 0, 2, 0)]
         for size in sizes:
@@ -4365,6 +4721,59 @@ class _TestTorchMixin(object):
                         k = random.randint(1, testTensor.size(dim))
                         compare(testTensor, k, dim, dir)
 
+    @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
+    def test_sort_topk_large(self):
+        # long slices take the radix sort and the chunked top-k
+        for dtype in [torch.float, torch.double, torch.int8, torch.uint8, torch.int, torch.long]:
+            if dtype.is_floating_point:
+                x = torch.randn(100000, dtype=dtype)
+                x[10] = float('nan')
+                x[20] = float('-inf')
+            else:
+                x = torch.randint(0, 100, (100000,), dtype=dtype)
+            # numpy sorts NaN last
+            expected = torch.from_numpy(np.sort(x.numpy()))
+            for descending in (False, True):
+                values, indices = x.sort(descending=descending)
+                self.assertEqual(values, expected.flip(0) if descending else expected, 0)
+                self.assertEqual(x[indices], values, 0)
+                self.assertEqual(indices.sort()[0], torch.arange(x.numel()))
+            for largest in (True, False):
+                values, indices = x.topk(20, largest=largest)
+                expected = x.sort(descending=largest)[0][:20]
+                self.assertEqual(values, expected, 0)
+                self.assertEqual(x[indices], expected, 0)
+                values, indices = x.topk(20, largest=largest, sorted=False)
+                self.assertEqual(values.sort(descending=largest)[0], expected, 0)
+                self.assertEqual(x[indices], values, 0)
+
+        # many short slices, along a non-contiguous dim
+        x = torch.randn(50, 300, 7).transpose(0, 1)
+        values, indices = x.sort(dim=1)
+        self.assertEqual(x.gather(1, indices), values, 0)
+        self.assertTrue((values[:, 1:] >= values[:, :-1]).all())
+        values, indices = x.topk(3, dim=1, largest=False)
+        self.assertEqual(values, x.sort(dim=1)[0][:, :3], 0)
+
+    def test_topk_parallel_chunks(self):
+        # a single long slice is split into chunks whose candidates are
+        # selected in parallel
+        num_threads = torch.get_num_threads()
+        try:
+            torch.set_num_threads(4)
+            x = torch.randn(4 * 65536)
+            # put the largest values into the last chunks
+            x[-1000:] += 100
+            x[-70000:-69000] += 50
+            for k in (1, 20, 1500):
+                for largest in (True, False):
+                    values, indices = x.topk(k, largest=largest)
+                    expected = x.sort(descending=largest)[0][:k]
+                    self.assertEqual(values, expected, 0)
+                    self.assertEqual(x[indices], expected, 0)
+        finally:
+            torch.set_num_threads(num_threads)
+
     def test_topk_arguments(self):
         q = torch.randn(10, 2, 10)
         # Make sure True isn't mistakenly taken as the 2nd dimension (interpreted as 1)
@@ -4623,6 +5032,33 @@ class _TestTorchMixin(object):
             self.assertRaises(RuntimeError, lambda: torch.cat([]))
             self.assertRaisesRegex(TypeError, 'got None', lambda: torch.cat([x, None]))
 
+    def test_cat_stack_large(self):
+        # big enough to be copied in parallel chunks
+        for dtype in (torch.half, torch.float, torch.uint8, torch.bool):
+            images = [torch.randint(0, 2, (3, 64, 64)).to(dtype) for _ in range(64)]
+            stacked = torch.stack(images)
+            self.assertEqual(stacked.size(), (64, 3, 64, 64))
+            for i, image in enumerate(images):
+                self.assertEqual(stacked[i], image, 0)
+            stacked = torch.stack(images, dim=2)
+            for i, image in enumerate(images):
+                self.assertEqual(stacked[:, :, i], image, 0)
+            out = torch.empty(0, dtype=dtype)
+            torch.stack(images, dim=1, out=out)
+            self.assertEqual(out, torch.stack([image.float() for image in images], dim=1).to(dtype), 0)
+
+            # contiguous and not, a legacy empty tensor, and an empty piece
+            pieces = [images[0], images[1].transpose(1, 2), torch.empty(0, dtype=dtype),
+                      torch.empty(3, 64, 0, dtype=dtype), images[2]]
+            res = torch.cat(pieces, dim=2)
+            self.assertEqual(res.size(), (3, 64, 192))
+            self.assertEqual(res[:, :, :64], images[0], 0)
+            self.assertEqual(res[:, :, 64:128], images[1].transpose(1, 2), 0)
+            self.assertEqual(res[:, :, 128:], images[2], 0)
+
+        self.assertRaisesRegex(RuntimeError, 'scalar type',
+                               lambda: torch.cat([torch.zeros(2), torch.zeros(2, dtype=torch.double)]))
+
     def test_cat_bad_input_sizes(self):
         x = torch.randn(2, 1)
         y = torch.randn(2, 1, 1)
@@ -4971,6 +5407,25 @@ class _TestTorchMixin(object):
     def test_solve_batched(self):
         self._test_solve_batched(self, lambda t: t)
 
+    @skipIfNoLapack
+    def test_solve_inverse_many_small(self):
+        from common_utils import random_fullrank_matrix_distinct_singular_value
+        for n in [2, 3, 8]:
+            A = random_fullrank_matrix_distinct_singular_value(n, 500).double()
+            b = torch.randn(500, n, 2).double()
+            A_inv = torch.inverse(A)
+            x, _ = torch.solve(b, A)
+            for i in [0, 123, 499]:
+                self.assertEqual(A_inv[i], torch.inverse(A[i]))
+                self.assertEqual(x[i], torch.solve(b[i], A[i])[0])
+            self.assertEqual(torch.matmul(A, A_inv), torch.eye(n).double().expand_as(A))
+
+            # the first singular matrix of the batch is reported
+            A[321].zero_()
+            A[400].zero_()
+            self.assertRaisesRegex(RuntimeError, 'For batch 321', lambda: torch.inverse(A))
+            self.assertRaisesRegex(RuntimeError, 'For batch 321', lambda: torch.solve(b, A))
+
     @staticmethod
     def _test_solve_batched_dims(self, cast):
         if not TEST_NUMPY:
@@ -6098,6 +6553,24 @@ class _TestTorchMixin(object):
     def test_fft_ifft_rfft_irfft(self):
         self._test_fft_ifft_rfft_irfft(self)
 
+    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
+    def test_fft_plan_reuse(self):
+        # transforms of equal signal sizes but different layouts, batch sizes,
+        # directions and normalizations must not share a cached plan
+        x = torch.randn(8, 16, 2, dtype=torch.double)
+        expected = x.fft(1)
+        for _ in range(2):
+            self.assertEqual(x.fft(1), expected)
+            self.assertEqual(x[:5].fft(1), expected[:5])
+            self.assertEqual(x.transpose(0, 1).contiguous().transpose(0, 1).fft(1), expected)
+            self.assertEqual(x.fft(1, normalized=True), expected / 4)
+            self.assertEqual(expected.ifft(1), x)
+            self.assertEqual(x.float().fft(1), expected.float(), 1e-4)
+            real = x[..., 0]
+            full = torch.stack([real, torch.zeros_like(real)], -1).fft(1)
+            self.assertEqual(real.rfft(1), full[:, :9])
+            self.assertEqual(real.rfft(1, onesided=False), full)
+
     @staticmethod
     def _test_stft(self, device='cpu'):
         if not TEST_LIBROSA:
@@ -7376,6 +7849,37 @@ class _TestTorchMixin(object):
             dest2[idx[i]] = dest2[idx[i]] + src[i]
         self.assertEqual(dest, dest2)
 
+    def test_index_add_large(self):
+        # many duplicate indices, along the first, middle and last dim
+        num_nodes, num_edges = 100, 20000
+        index = torch.randint(num_nodes, (num_edges,))
+        for dim in range(3):
+            dest_shape = [3, 4, 5]
+            dest_shape[dim] = num_nodes
+            src_shape = list(dest_shape)
+            src_shape[dim] = num_edges
+            src = torch.randint(-10, 10, src_shape, dtype=torch.double)
+            dest = torch.randn(dest_shape, dtype=torch.double)
+            expected = dest.clone()
+            one_hot = torch.zeros(num_nodes, num_edges, dtype=torch.double)
+            one_hot[index, torch.arange(num_edges)] = 1
+            expected += torch.tensordot(one_hot, src.transpose(0, dim), 1).transpose(0, dim)
+            self.assertEqual(dest.clone().index_add_(dim, index, src), expected)
+            self.assertEqual(dest.transpose(0, 2).clone().transpose(0, 2).index_add_(dim, index, src), expected)
+
+        # index_put_ with accumulate=True takes the same path
+        dest = torch.zeros(num_nodes, 8)
+        src = torch.randn(num_edges, 8)
+        expected = torch.zeros(num_nodes, 8).index_add_(0, index, src)
+        self.assertEqual(torch.zeros(num_nodes, 8).index_put_((index,), src, accumulate=True), expected)
+        rows, cols = index // 10, index % 10
+        actual = torch.zeros(10, 10, 8).index_put_((rows, cols), src, accumulate=True)
+        self.assertEqual(actual.view(num_nodes, 8), expected)
+        actual = torch.zeros(8, 10, 10).permute(1, 0, 2).index_put_((cols, slice(None), rows), src, accumulate=True)
+        self.assertEqual(actual.permute(2, 0, 1).reshape(num_nodes, 8), expected)
+
+        self._assert_same_with_one_thread(lambda: torch.zeros(num_nodes, 8).index_add_(0, index, src))
+
     def test_index_select(self):
         src = torch.randn(3, 4, 5)
         # Index can be duplicated.
@@ -7610,6 +8114,28 @@ class _TestTorchMixin(object):
     def test_scatterFill(self):
         self._test_scatter_base(self, lambda t: t, 'scatter_', True)
 
+    def test_scatter_add_large(self):
+        # one long slice (threads split the destination), and many slices
+        # along a non-contiguous dim (threads split the slices)
+        for num_features in (1, 64):
+            num_nodes, num_edges = 100, 50000
+            index = torch.randint(num_nodes, (num_edges,))
+            src = torch.randn(num_edges, num_features, dtype=torch.double)
+            expected = torch.zeros(num_nodes, num_features, dtype=torch.double).index_add_(0, index, src)
+            actual = torch.zeros(num_nodes, num_features, dtype=torch.double).scatter_add_(
+                0, index.unsqueeze(1).expand(num_edges, num_features), src)
+            self.assertEqual(actual, expected)
+            actual_t = torch.zeros(num_features, num_nodes, dtype=torch.double).scatter_add_(
+                1, index.unsqueeze(0).expand(num_features, num_edges), src.t())
+            self.assertEqual(actual_t, expected.t())
+
+            self._assert_same_with_one_thread(lambda: torch.zeros(num_nodes, num_features).scatter_add_(
+                0, index.unsqueeze(1).expand(num_edges, num_features), src.float()))
+
+        x = torch.randn(100, 300)
+        index = torch.randint(100, (5000, 300))
+        self.assertEqual(x.gather(0, index), x[index, torch.arange(300)])
+
     def test_masked_scatter(self):
         for dtype in [torch.uint8, torch.bool]:
             num_copy, num_dest = 3, 10
@@ -8999,6 +9525,30 @@ class _TestTorchMixin(object):
         # test that it works with integral tensors
         self._test_bernoulli(self, torch.uint8, torch.float64, 'cpu')
 
+    def test_random_fill_parallel(self):
+        # CPU fills are generated in parallel from counter-based streams, so
+        # they only depend on the seed, not on the number of threads or strides
+        def fills(dtype):
+            torch.manual_seed(123)
+            return (torch.empty(100003, dtype=dtype).uniform_(-2, 3),
+                    torch.empty(100003, dtype=dtype).normal_(1, 2),
+                    torch.empty(100003, dtype=dtype).bernoulli_(0.3),
+                    torch.empty(100003, dtype=dtype).bernoulli_(torch.full((100003,), 0.7)),
+                    torch.empty(1000, 200, dtype=dtype).t().normal_().t())
+
+        for dtype in (torch.float, torch.double):
+            self._assert_same_with_one_thread(lambda: fills(dtype))
+
+            uniform, normal, bernoulli, bernoulli_tensor, transposed = parallel
+            self.assertTrue(uniform.min() >= -2 and uniform.max() < 3)
+            self.assertEqual(uniform.mean(), 0.5, 0.02)
+            self.assertEqual(normal.mean(), 1, 0.03)
+            self.assertEqual(normal.std(), 2, 0.03)
+            self.assertEqual(bernoulli.mean(), 0.3, 0.01)
+            self.assertEqual(bernoulli_tensor.mean(), 0.7, 0.01)
+            self.assertEqual(transposed.std(), 1, 0.02)
+            self.assertNotEqual(torch.empty(100, dtype=dtype).uniform_(), torch.empty(100, dtype=dtype).uniform_())
+
     def test_normal(self):
         q = torch.Tensor(100, 100)
         q.normal_()
@@ -9303,6 +9853,24 @@ class _TestTorchMixin(object):
             self.assertTrue(torch.equal(a, b))
             self.assertEqual(i, j)
 
+    def test_serialization_direct_io(self):
+        # storages of odd sizes at an unaligned offset in the file, and more
+        # than a staging buffer of data
+        devices = ['cpu'] + (['cuda'] if torch.cuda.is_available() else [])
+        for device in devices:
+            a = [torch.randn(7, device=device).half(), torch.arange(4099, device=device),
+                 torch.randn(17 << 20, device=device), torch.tensor([], device=device),
+                 torch.randint(2, (12345,), device=device).byte()]
+            for direct_io in (False, True):
+                with tempfile.NamedTemporaryFile() as f:
+                    pickle.dump(41, f)
+                    torch.save(a, f, direct_io=direct_io)
+                    f.seek(0)
+                    self.assertEqual(pickle.load(f), 41)
+                    b = torch.load(f)
+                self.assertEqual(a, b, 0)
+                self.assertEqual([t.device for t in a], [t.device for t in b])
+
     def test_serialization_offset_filelike(self):
         a = torch.randn(5, 5)
         i = 41
@@ -10822,6 +11390,32 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
         if torch.cuda.is_available():
             run_test(torch.device('cuda'))
 
+    @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
+    def test_unique_large(self):
+        # large inputs are deduplicated in parallel hash tables
+        for dtype in [torch.long, torch.int, torch.uint8, torch.double]:
+            x = torch.randint(0, 200 if dtype == torch.uint8 else 50000, (300000,)).to(dtype)
+            expected, expected_inverse, expected_counts = np.unique(
+                x.numpy(), return_inverse=True, return_counts=True)
+            output, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+            self.assertEqual(output, torch.from_numpy(expected))
+            self.assertEqual(inverse, torch.from_numpy(expected_inverse).long())
+            self.assertEqual(counts, torch.from_numpy(expected_counts).long())
+
+            output, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+            self.assertEqual(output[inverse], x)
+            self.assertEqual(output.sort()[0], torch.from_numpy(expected))
+            self.assertEqual(counts, torch.zeros_like(counts).index_add_(0, inverse, torch.ones_like(inverse)))
+
+            # the unsorted order doesn't depend on the number of threads
+            self._assert_same_with_one_thread(lambda: torch.unique(x, sorted=False))
+
+            y = x.sort()[0]
+            output, inverse, counts = torch.unique_consecutive(y, return_inverse=True, return_counts=True)
+            self.assertEqual(output, torch.from_numpy(expected))
+            self.assertEqual(counts, torch.from_numpy(expected_counts).long())
+            self.assertEqual(output[inverse], y)
+
     def test_unique_dim(self):
         self.assertFalse(hasattr(torch, 'unique_dim'))
 
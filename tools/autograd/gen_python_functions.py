@@ -297,7 +297,9 @@ def create_python_bindings(python_functions, has_self, is_module=False):
         'const Type &': 'scalartype',
         'const THPLayout &': 'layout',
         'const Device &': 'device',
+        'MemoryFormat': 'memoryformat',
         'c10::optional<ScalarType>': 'scalartypeOptional',
+        'c10::optional<MemoryFormat>': 'memoryformatOptional',
         'c10::optional<Scalar>': 'scalarOptional',
         'c10::optional<int64_t>': 'toInt64Optional',
         'c10::optional<bool>': 'toBoolOptional',
@@ -870,6 +872,8 @@ def get_python_signature(declaration, include_out):
             default = arg['default']
             if default == 'nullptr' or default == 'nullopt' or default == '{}':
                 default = 'None'
+            elif default == 'MemoryFormat::Contiguous':
+                default = 'torch.contiguous_format'
         if default is not None:
             param += '=' + str(default)
         return param
@@ -23,13 +23,14 @@
 #     differentiable subcomponents.
 #
 from __future__ import print_function
-from .utils import CodeTemplate, nested_dict, write, uninplace_api_name
+import re
+from .utils import CodeTemplate, nested_dict, write, uninplace_api_name, IDENT_REGEX
 from .gen_autograd import VIEW_FUNCTIONS
 from .gen_autograd_functions import uses_single_grad
 
 # These functions are written manually in templates/VariableType.cpp
 MANUAL_IMPLEMENTATIONS = {
-    'resize_', 'resize_as_', 'detach', 'detach_', 'copy_'
+    'resize_', 'resize_as_', 'reserve_', 'detach', 'detach_', 'copy_'
 }
 
 # These functions we don't want to record for tracing, because we always want
@@ -201,6 +202,20 @@ if (grad_fn) {
 }
 """)
 
+FORWARD_DERIVATIVE = CodeTemplate("""\
+if (forward_ad::is_enabled() && (${cond})) {
+  forward_ad::DisableGuard fw_guard;
+  ${tangents}
+  as_variable_ref(${output}).set_fw_grad(${formula});
+}
+""")
+
+FORWARD_DERIVATIVE_NOT_IMPLEMENTED = CodeTemplate("""\
+if (forward_ad::is_enabled() && (${cond})) {
+  AT_ERROR("the forward derivative of '${name}' is not implemented");
+}
+""")
+
 CONDITIONAL = CodeTemplate("""\
 if (${cond}) {
   ${statements}
@@ -211,6 +226,16 @@ RECORD_FUNCTION = CodeTemplate("""\
 RECORD_FUNCTION("${name}", std::vector<c10::IValue>({${input_names}}), Function::peek_at_next_sequence_nr());
 """)
 
+# USDT probes around every profiled op; a nop unless a tracer is attached.
+# variable_op_end does not fire when the op throws.
+SDT_OP_START = CodeTemplate("""\
+C10_SDT(variable_op_start, "${name}");
+""")
+
+SDT_OP_END = CodeTemplate("""\
+C10_SDT(variable_op_end, "${name}");
+""")
+
 SELECT = CodeTemplate("""\
 if (${cond}) {
   ${true}
@@ -741,7 +766,7 @@ def emit_body(declaration):
                 if output_idx in view_info_dict:
                     stmt = wrap_view_single(output_var, view_info_dict[output_idx])
                 elif 'Tensor' in return_info['type']:
-                    stmt = '{output_var} = as_variable({output_var});'.format(output_var=output_var)
+                    stmt = '{output_var} = as_variable(std::move({output_var}));'.format(output_var=output_var)
                 extra_wrapping_stmts.append(stmt)
             return call, extra_wrapping_stmts
         else:
@@ -781,7 +806,7 @@ def emit_body(declaration):
             # See NOTE [ Treating Variables as non-Variables in type dispatch ] for details.
             base_type_call = CALL_VIA_DERIVED.substitute(combined)
             if not modifies_arguments and not returns_void:
-                rhs_value, extra_wrapping_stmts = wrap_output('tmp')
+                rhs_value, extra_wrapping_stmts = wrap_output('std::move(tmp)')
                 call = DISPATCH_TO_NON_VAR_TYPE_WITH_RETURN_VALUES.substitute(
                     base_type_call=base_type_call,
                     return_values=tie_return_values(),
@@ -840,6 +865,37 @@ def emit_body(declaration):
             return CONDITIONAL.substitute(cond='grad_fn', statements=stmts)
         return ''
 
+    def fw_grad_defined_cond():
+        return ' || '.join('forward_ad::is_fw_grad_defined({})'.format(arg)
+                           for arg in reference_args(differentiable_inputs))
+
+    def emit_check_forward_derivative():
+        # The forward formulas are only used for the out-of-place functions
+        # with a single differentiable output; the others don't support dual
+        # tensors.
+        if (declaration.get('forward_formula') is not None and
+                len(differentiable_outputs) == 1 and not modifies_arguments):
+            return []
+        return [FORWARD_DERIVATIVE_NOT_IMPLEMENTED.substitute(
+            cond=fw_grad_defined_cond(), name=declaration['api_name'])]
+
+    def emit_forward_derivative():
+        formula = declaration.get('forward_formula')
+        if formula is None or len(differentiable_outputs) != 1 or modifies_arguments:
+            return []
+        output = differentiable_outputs[0]['name']
+        formula = re.sub(IDENT_REGEX.format('result'), r'\g<1>{}\g<2>'.format(output), formula)
+        tangents = []
+        for arg in differentiable_inputs:
+            tangent = arg['name'] + '_t'
+            if re.search(IDENT_REGEX.format(tangent), formula):
+                if arg['type'] == 'TensorList':
+                    raise RuntimeError('The forward formula of {} uses the tangent of {}, '
+                                       'which is a TensorList'.format(name, arg['name']))
+                tangents.append('auto {} = fw_grad_or_zeros({});'.format(tangent, arg['name']))
+        return [FORWARD_DERIVATIVE.substitute(
+            cond=fw_grad_defined_cond(), tangents=tangents, output=output, formula=formula)]
+
     def emit_check_inplace():
         if not inplace:
             return []
@@ -862,15 +918,18 @@ def emit_body(declaration):
     combined = nested_dict(env, declaration)
 
     body = []
-    if base_name not in DONT_PROFILE:
+    profiled = base_name not in DONT_PROFILE
+    if profiled:
         input_names = record_function_input_names()
         body.append(
             RECORD_FUNCTION.substitute(combined, input_names=input_names))
+        body.append(SDT_OP_START.substitute(combined))
     if strategy != 'use_type':
         body.extend(unpack_args(env, declaration))
     if requires_derivative:
         body.extend(emit_check_inplace())
         body.extend(setup_derivative(differentiable_inputs))
+        body.extend(emit_check_forward_derivative())
     body.append(declare_returned_variables())
 
     pre_record_trace, post_record_trace = emit_record_trace(env)
@@ -882,11 +941,14 @@ def emit_body(declaration):
         # requires that the counter is incremented before it is called
         body.extend(emit_increment_version())
         body.append(emit_history())
+        body.extend(emit_forward_derivative())
     # post_record_trace must appear before save_outputs so that saved outputs
     # have their tracing state saved (that is setup by recordTrace)
     body.append(post_record_trace)
     if requires_derivative:
         body.append(emit_save_outputs())
+    if profiled:
+        body.append(SDT_OP_END.substitute(combined))
     if not returns_void:
         body.append('return {};'.format(get_return_value()))
     return body
@@ -32,12 +32,13 @@ def load_derivatives(path, declarations):
 
 def create_differentiability_info(signature, non_differentiable_arg_names,
                                   output_differentiability,
-                                  autograd_fn):
+                                  autograd_fn, forward_formula):
     return {
         'signature': signature,
         'non_differentiable_arg_names': non_differentiable_arg_names,
         'output_differentiability': output_differentiability,
         'autograd_fn': autograd_fn,
+        'forward_formula': forward_formula,
     }
 
 
@@ -183,6 +184,10 @@ def process_definition(defn, declarations_by_signature):
     # NB: Removes 'output_differentiability' from defn dictionary
     #     `None` means all differentiable.
     output_differentiability = defn.pop('output_differentiability', None)
+    # NB: Removes 'result' from defn dictionary
+    #     The formula of the tangent of the result in forward mode, in terms of
+    #     the tangents `<name>_t` of the inputs. `None` means not implemented.
+    forward_formula = defn.pop('result', None)
     param_types, param_names = unzip([p.split(' ') for p in params if p != '*'])
 
     if 'grad_input_mask' in param_names:
@@ -224,8 +229,13 @@ def process_definition(defn, declarations_by_signature):
         autograd_fn = create_autograd_function(defn_name, derivatives, args_with_derivatives,
                                                canonical)
 
+    if forward_formula is not None and autograd_fn is None:
+        raise RuntimeError('Forward formula of {} in derivatives.yaml has no '
+                           'differentiable inputs'.format(defn_name))
+
     return create_differentiability_info(signature, non_differentiable_arg_names,
-                                         output_differentiability, autograd_fn)
+                                         output_differentiability, autograd_fn,
+                                         forward_formula)
 
 
 def ensure_unique_names(autograd_functions):
@@ -373,15 +383,18 @@ def match_declarations_with_differentiability_info(declarations, differentiabili
     def find_info(declaration):
         signature = get_signature(declaration)
         if signature in infos_by_signature:
-            return infos_by_signature[signature]
+            return infos_by_signature[signature], True
 
         # if there is no exact match look for the out-of-place signature.
         # i.e mul() for mul_() or mul_out()
         signature = get_signature(declaration, use_base_variant=True)
-        return infos_by_signature.get(signature)
+        return infos_by_signature.get(signature), False
 
     for declaration in declarations:
-        info = find_info(declaration)
+        info, is_exact_match = find_info(declaration)
         declaration['derivative'] = info['autograd_fn'] if info else None
+        # The forward formulas are written for the out-of-place functions
+        declaration['forward_formula'] = \
+            info['forward_formula'] if info and is_exact_match else None
         declaration['non_differentiable_arg_names'] = info['non_differentiable_arg_names'] if info else []
         declaration['output_differentiability'] = info['output_differentiability'] if info else None
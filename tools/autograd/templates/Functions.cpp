@@ -676,6 +676,32 @@ Tensor var_backward(Tensor grad, const Tensor & self, IntArrayRef dim, bool unbi
   return (2.0 / (_safe_size(self.sizes(), dim) - unbiased)) * grad * (self - self.mean(dim, true));
 }
 
+Tensor var_std_mean_backward(const variable_list& grads, const Tensor & self, const Tensor & r1, const Tensor & r2, IntArrayRef dim, bool unbiased, bool keepdim, bool is_std) {
+  Tensor grad;
+  if (grads[0].defined()) {
+    grad = is_std ? var_backward(grads[0] / (r1 * 2), self, dim, unbiased, keepdim)
+                  : var_backward(grads[0], self, dim, unbiased, keepdim);
+  }
+  if (grads[1].defined()) {
+    Tensor mean_grad = sum_backward(grads[1], self.sizes(), dim, keepdim) / _safe_size(self.sizes(), dim);
+    grad = grad.defined() ? grad + mean_grad : mean_grad;
+  }
+  return grad;
+}
+
+Tensor var_std_mean_backward(const variable_list& grads, const Tensor & self, const Tensor & r1, const Tensor & r2, bool unbiased, bool is_std) {
+  Tensor grad;
+  if (grads[0].defined()) {
+    grad = is_std ? var_backward(grads[0] / (r1 * 2), self, unbiased)
+                  : var_backward(grads[0], self, unbiased);
+  }
+  if (grads[1].defined()) {
+    Tensor mean_grad = grads[1].expand(self.sizes()) / self.numel();
+    grad = grad.defined() ? grad + mean_grad : mean_grad;
+  }
+  return grad;
+}
+
 Tensor masked_scatter_backward(const Tensor & grad, const Tensor & mask, IntArrayRef sizes) {
   int64_t numel = 1;
   for (auto size : sizes) {
@@ -2052,6 +2078,20 @@ std::tuple<Tensor, Tensor, Tensor> _trilinear_backward(const Tensor& grad_out, c
   return std::tuple<Tensor, Tensor, Tensor>(grad_i1, grad_i2, grad_i3);
 }
 
+std::tuple<Tensor, Tensor, Tensor> _linear_relu_backward(const Tensor& grad, const Tensor& input, const Tensor& weight,
+                                                         const Tensor& bias, const Tensor& result, std::array<bool, 3> grad_mask) {
+  // result is 0 exactly where the relu cut its input off
+  auto grad_linear = at::threshold_backward(grad, result, 0).reshape({-1, weight.size(0)});
+  Tensor grad_input, grad_weight, grad_bias;
+  if (grad_mask[0])
+    grad_input = grad_linear.mm(weight).view(input.sizes());
+  if (grad_mask[1])
+    grad_weight = grad_linear.t().mm(input.reshape({-1, input.size(-1)}));
+  if (grad_mask[2])
+    grad_bias = at::sum_to(grad_linear, bias.sizes());
+  return std::tuple<Tensor, Tensor, Tensor>(grad_input, grad_weight, grad_bias);
+}
+
 Tensor log1p_backward(const Tensor& grad, const Tensor& self) {
   if (self.is_sparse()) {
     AT_ERROR(
@@ -21,6 +21,7 @@ using at::Context;
 using at::Device;
 using at::Generator;
 using at::IntArrayRef;
+using at::MemoryFormat;
 using at::Scalar;
 using at::ScalarType;
 using at::SparseTensorRef;
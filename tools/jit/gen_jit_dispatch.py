@@ -27,7 +27,7 @@ from ..autograd.gen_autograd import RETURNS_VIEWS_OF_INPUT
 #      | Type[] # a dynamically sized list[ of a type
 #      | Scalar[N] # a homogenous fixed size scalar list, single scalars can expand to this list
 #      | (Type1, Type2, ...) # a heterogenous tuple
-#      | Layout | ScalarType | Device | Generator # special singleton types for built-in concepts in tensor lib
+#      | Layout | MemoryFormat | ScalarType | Device | Generator # special singleton types for built-in concepts in tensor lib
 
 # clean up the variety of C++ types in the ATen declarations
 # to be in the restricted set of types that the IR represents
@@ -51,6 +51,8 @@ TYPE_MAP = {
     'IntArrayRef': 'int[]',
     'Layout': 'Layout',
     'Layout?': 'Layout?',
+    'MemoryFormat': 'MemoryFormat',
+    'MemoryFormat?': 'MemoryFormat?',
     'Device': 'Device',
     'Device?': 'Device?',
     'ScalarType': 'ScalarType',
@@ -96,6 +98,8 @@ FROM_IVALUE = {
     'IntArrayRef': '{}.toIntList()->elements()',
     'Layout': '{}.toLayout()',
     'Layout?': '{}.toOptional<c10::Layout>()',
+    'MemoryFormat': '{}.toMemoryFormat()',
+    'MemoryFormat?': '{}.toOptional<c10::MemoryFormat>()',
     'Scalar': '{}.toScalar()',
     'Scalar?': '{}.toOptional<Scalar>()',
     'ScalarType': '{}.toScalarType()',
@@ -428,6 +432,13 @@ def annotate_op(decl):
         first_ret = decl['returns'][0]
         assert(jit_type_of(first_ret) == 'Tensor')
         first_ret['jit_type'] = 'Tensor(a!)'
+        # other tensors an in-place op writes to keep their own annotation,
+        # e.g. the optimizer state in _sparse_adagrad_
+        if decl.get('inplace'):
+            for arg in decl['arguments'][1:]:
+                annotation = arg.get('annotation')
+                if annotation and annotation.endswith('!') and jit_type_of(arg) == 'Tensor':
+                    arg['jit_type'] = 'Tensor({})'.format(annotation)
         if is_out_variant(decl):
             assert(first_arg['output'])
             # the output variant must go at the end
@@ -483,6 +494,7 @@ def signature(decl, should_match_schema=True):
                 .replace('true', 'True') \
                 .replace('false', 'False') \
                 .replace('Reduction::Mean', 'Mean') \
+                .replace('MemoryFormat::Contiguous', 'contiguous_format') \
                 .replace('{}', 'None' if is_tensor_arg(arg) else '[]') \
                 .replace('{', '[') \
                 .replace('}', ']')
@@ -107,6 +107,7 @@ def type_to_python(typename, size=None):
         'Device': 'Union[_device, str, None]',
         'Generator*': 'Generator',
         'IntegerTensor': 'Tensor',
+        'MemoryFormat': 'memory_format',
         'Scalar': 'Number',
         'ScalarType': '_dtype',
         'Storage': 'Storage',
@@ -149,6 +150,8 @@ def arg_to_type_hint(arg):
             default = None
         elif default == 'c10::nullopt':
             default = None
+        elif default == 'MemoryFormat::Contiguous':
+            default = 'contiguous_format'
         elif isinstance(default, str) and default.startswith('{') and default.endswith('}'):
             if arg['dynamic_type'] == 'Tensor' and default == '{}':
                 default = None
@@ -335,6 +338,8 @@ def gen_pyi(declarations_path, out):
         'as_tensor': ["def as_tensor(data: Any, dtype: _dtype=None, device: Optional[_device]=None) -> Tensor: ..."],
         'get_num_threads': ['def get_num_threads() -> _int: ...'],
         'set_num_threads': ['def set_num_threads(num: _int) -> None: ...'],
+        'get_num_interop_threads': ['def get_num_interop_threads() -> _int: ...'],
+        'set_num_interop_threads': ['def set_num_interop_threads(num: _int) -> None: ...'],
         # These functions are explicitly disabled by
         # SKIP_PYTHON_BINDINGS because they are hand bound.
         # Correspondingly, we must hand-write their signatures.
@@ -429,7 +434,7 @@ def gen_pyi(declarations_path, out):
         'type': ['def type(self, dtype: Union[None, str, _dtype]=None, non_blocking: bool=False)'
                  ' -> Union[str, Tensor]: ...'],
         'get_device': ['def get_device(self) -> _int: ...'],
-        'is_contiguous': ['def is_contiguous(self) -> bool: ...'],
+        'is_contiguous': ['def is_contiguous(self, *, memory_format: memory_format=contiguous_format) -> bool: ...'],
         'is_cuda': ['def is_cuda(self) -> bool: ...'],
         'is_leaf': ['def is_leaf(self) -> bool: ...'],
         'storage_offset': ['def storage_offset(self) -> _int: ...'],
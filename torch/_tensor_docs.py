@@ -331,6 +331,13 @@ allclose(other, rtol=1e-05, atol=1e-08, equal_nan=False) -> Tensor
 See :func:`torch.allclose`
 """)
 
+add_docstr_all('aminmax',
+               r"""
+aminmax(dim=None, keepdim=False) -> (Tensor, Tensor)
+
+See :func:`torch.aminmax`
+""")
+
 add_docstr_all('any',
                r"""
 .. function:: any() -> bool
@@ -563,11 +570,15 @@ type as :attr:`self`.
 
 add_docstr_all('contiguous',
                r"""
-contiguous() -> Tensor
+contiguous(memory_format=torch.contiguous_format) -> Tensor
 
-Returns a contiguous tensor containing the same data as :attr:`self` tensor. If
-:attr:`self` tensor is contiguous, this function returns the :attr:`self`
-tensor.
+Returns a contiguous in memory tensor containing the same data as :attr:`self` tensor. If
+:attr:`self` tensor is already in the specified memory format, this function returns the
+:attr:`self` tensor.
+
+Args:
+    memory_format (:class:`torch.memory_format`, optional): the desired memory format of
+        returned Tensor. Default: ``torch.contiguous_format``.
 """)
 
 add_docstr_all('copy_',
@@ -1253,9 +1264,14 @@ See :func:`torch.inverse`
 
 add_docstr_all('is_contiguous',
                r"""
-is_contiguous() -> bool
+is_contiguous(memory_format=torch.contiguous_format) -> bool
 
-Returns True if :attr:`self` tensor is contiguous in memory in C order.
+Returns True if :attr:`self` tensor is contiguous in memory in the order specified
+by memory format.
+
+Args:
+    memory_format (:class:`torch.memory_format`, optional): Specifies memory allocation
+        order. Default: ``torch.contiguous_format``.
 """)
 
 add_docstr_all('is_floating_point',
@@ -1791,6 +1807,17 @@ zero_point.
 returns the quantized Tensor.
 """)
 
+add_docstr_all('quantize_linear_per_channel',
+               r"""
+quantize_linear_per_channel(scales, zero_points, axis) -> Tensor
+
+Quantize a float Tensor using affine quantization scheme with a scale and
+zero_point for each channel, i.e. each slice along the dimension in the
+single-element list :attr:`axis`. :attr:`scales` and :attr:`zero_points` are
+1-d Tensors with one value for each channel.
+returns the quantized Tensor.
+""")
+
 add_docstr_all('q_scale',
                r"""
 q_scale() -> float
@@ -1807,6 +1834,32 @@ Given a Tensor quantized by linear(affine) quantization,
 returns the zero_point of the underlying quantizer().
 """)
 
+add_docstr_all('q_per_channel_scales',
+               r"""
+q_per_channel_scales() -> Tensor
+
+Given a Tensor quantized by per channel linear(affine) quantization,
+returns a Tensor of the scales of the underlying quantizer(), one for each
+channel.
+""")
+
+add_docstr_all('q_per_channel_zero_points',
+               r"""
+q_per_channel_zero_points() -> Tensor
+
+Given a Tensor quantized by per channel linear(affine) quantization,
+returns a Tensor of the zero_points of the underlying quantizer(), one for
+each channel.
+""")
+
+add_docstr_all('q_scheme',
+               r"""
+q_scheme() -> int
+
+Given a quantized Tensor, returns the quantization scheme of the underlying
+quantizer(), as enumerated in ``torch/nn/_qscheme.py``.
+""")
+
 add_docstr_all('random_',
                r"""
 random_(from=0, to=None, *, generator=None) -> Tensor
@@ -1968,6 +2021,29 @@ Args:
         as :attr:`other`.
 """)
 
+add_docstr_all('reserve_',
+               r"""
+reserve_(capacity) -> Tensor
+
+Makes sure the underlying storage of :attr:`self` can hold at least
+:attr:`capacity` elements without being reallocated. The size and contents of
+:attr:`self` are not changed.
+
+From then on, whenever :meth:`~Tensor.resize_` has to grow the storage of
+:attr:`self`, the storage grows geometrically instead of to exactly the new
+size, so that appending to :attr:`self` by repeatedly resizing it takes
+amortized constant time.
+
+Args:
+    capacity (int): the number of elements to reserve space for
+
+Example::
+
+    >>> x = torch.empty(0, 3).reserve_(300)
+    >>> for i in range(100):
+    ...     x.resize_(i + 1, 3)[i] = i
+""")
+
 add_docstr_all('resize_',
                r"""
 resize_(*sizes) -> Tensor
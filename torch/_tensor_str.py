@@ -270,11 +270,13 @@ def _str(self):
         suffixes.append('size=' + str(tuple(self.shape)))
         if not has_default_dtype:
             suffixes.append('dtype=' + str(self.dtype))
-        # TODO: change to a call to self.q_scheme() when we add q_scheme method
-        # and uncomment this
-        # suffixes.append('quantization_scheme=' + 'per_tensor_affine')
-        suffixes.append('scale=' + str(self.q_scale().item()))
-        suffixes.append('zero_point=' + str(self.q_zero_point().item()))
+        from torch.nn._qscheme import get_enum
+        if self.q_scheme() == get_enum('per_channel_affine'):
+            suffixes.append('scales=' + str(self.q_per_channel_scales().tolist()))
+            suffixes.append('zero_points=' + str(self.q_per_channel_zero_points().tolist()))
+        else:
+            suffixes.append('scale=' + str(self.q_scale().item()))
+            suffixes.append('zero_point=' + str(self.q_zero_point().item()))
         tensor_str = _tensor_str(self.dequantize(), indent)
     else:
         if self.numel() == 0 and not self.is_sparse:
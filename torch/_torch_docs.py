@@ -2150,6 +2150,14 @@ get_num_threads() -> int
 Gets the number of threads used for parallelizing CPU operations
 """)
 
+add_docstr(torch.get_num_interop_threads,
+           r"""
+get_num_interop_threads() -> int
+
+Returns the number of threads used for inter-op parallelism on CPU
+(e.g. in JIT interpreter)
+""")
+
 add_docstr(torch.gt,
            r"""
 gt(input, other, out=None) -> Tensor
@@ -2823,6 +2831,49 @@ Example::
     tensor([ 0.8722, -0.7416,  0.2653, -0.1584])
 """)
 
+add_docstr(torch.aminmax,
+           r"""
+.. function:: aminmax(input) -> (Tensor, Tensor)
+
+Returns the minimum and the maximum value of all elements in the :attr:`input`
+tensor, computed together in a single pass. If any element is ``nan``, both
+results are ``nan``.
+
+Args:
+    input (Tensor): the input tensor
+
+Example::
+
+    >>> a = torch.tensor([[-0.3425, -1.2636, -0.4864]])
+    >>> torch.aminmax(a)
+    (tensor(-1.2636), tensor(-0.3425))
+
+.. function:: aminmax(input, dim, keepdim=False) -> (Tensor, Tensor)
+
+Returns the minimum and the maximum value of each row of the :attr:`input`
+tensor in the dimension :attr:`dim`. If :attr:`dim` is a list of dimensions,
+reduce over all of them. Unlike :func:`torch.min` and :func:`torch.max`, the
+indices of the extreme values are not returned.
+
+{keepdim_details}
+
+Args:
+    input (Tensor): the input tensor
+    {dim}
+    {keepdim}
+
+Example::
+
+    >>> a = torch.randn(4, 4)
+    >>> a
+    tensor([[-0.3567,  1.7385, -1.3042,  0.7423],
+            [ 1.3436, -0.1015, -0.9834, -0.8438],
+            [ 0.6056,  0.1089, -0.3112, -1.4085],
+            [-0.7700,  0.6074, -0.1469,  0.7777]])
+    >>> torch.aminmax(a, 0)
+    (tensor([-0.7700, -0.1015, -1.3042, -1.4085]), tensor([ 1.3436,  1.7385, -0.1469,  0.7777]))
+""".format(**multi_dim_common))
+
 add_docstr(torch.argmax,
            r"""
 .. function:: argmax(input) -> LongTensor
@@ -4304,6 +4355,16 @@ To ensure that the correct number of threads is used, set_num_threads
 must be called before running eager, JIT or autograd code.
 """)
 
+add_docstr(torch.set_num_interop_threads,
+           r"""
+set_num_interop_threads(int)
+
+Sets the number of threads used for interop parallelism
+(e.g. in JIT interpreter) on CPU.
+WARNING: Can only be called once and before any inter-op parallel work
+is started (e.g. JIT execution).
+""")
+
 add_docstr(torch.sigmoid,
            r"""
 sigmoid(input, out=None) -> Tensor
@@ -4660,6 +4721,57 @@ Example::
     tensor([ 1.0311,  0.7477,  1.2204,  0.9087])
 """.format(**multi_dim_common))
 
+add_docstr(torch.std_mean,
+           r"""
+.. function:: std_mean(input, unbiased=True) -> (Tensor, Tensor)
+
+Returns the standard-deviation and mean of all elements in the :attr:`input`
+tensor, computed together in a single pass.
+
+If :attr:`unbiased` is ``False``, then the standard-deviation will be calculated
+via the biased estimator. Otherwise, Bessel's correction will be used.
+
+Args:
+    input (Tensor): the input tensor
+    unbiased (bool): whether to use the unbiased estimation or not
+
+Example::
+
+    >>> a = torch.randn(1, 3)
+    >>> a
+    tensor([[-0.3425, -1.2636, -0.4864]])
+    >>> torch.std_mean(a)
+    (tensor(0.4955), tensor(-0.6975))
+
+.. function:: std_mean(input, dim, keepdim=False, unbiased=True) -> (Tensor, Tensor)
+
+Returns the standard-deviation and mean of each row of the :attr:`input` tensor
+in the dimension :attr:`dim`. If :attr:`dim` is a list of dimensions,
+reduce over all of them.
+
+{keepdim_details}
+
+If :attr:`unbiased` is ``False``, then the standard-deviation will be calculated
+via the biased estimator. Otherwise, Bessel's correction will be used.
+
+Args:
+    input (Tensor): the input tensor
+    {dim}
+    {keepdim}
+    unbiased (bool): whether to use the unbiased estimation or not
+
+Example::
+
+    >>> a = torch.randn(4, 4)
+    >>> a
+    tensor([[-0.3567,  1.7385, -1.3042,  0.7423],
+            [ 1.3436, -0.1015, -0.9834, -0.8438],
+            [ 0.6056,  0.1089, -0.3112, -1.4085],
+            [-0.7700,  0.6074, -0.1469,  0.7777]])
+    >>> torch.std_mean(a, 1)
+    (tensor([1.3208, 1.0660, 0.8577, 0.7149]), tensor([ 0.2050, -0.1463, -0.2513,  0.1170]))
+""".format(**multi_dim_common))
+
 add_docstr(torch.sum,
            r"""
 .. function:: sum(input, dtype=None) -> Tensor
@@ -5513,6 +5625,57 @@ Example::
     tensor([ 1.7444,  1.1363,  0.7356,  0.5112])
 """.format(**multi_dim_common))
 
+add_docstr(torch.var_mean,
+           r"""
+.. function:: var_mean(input, unbiased=True) -> (Tensor, Tensor)
+
+Returns the variance and mean of all elements in the :attr:`input`
+tensor, computed together in a single pass.
+
+If :attr:`unbiased` is ``False``, then the variance will be calculated
+via the biased estimator. Otherwise, Bessel's correction will be used.
+
+Args:
+    input (Tensor): the input tensor
+    unbiased (bool): whether to use the unbiased estimation or not
+
+Example::
+
+    >>> a = torch.randn(1, 3)
+    >>> a
+    tensor([[-0.3425, -1.2636, -0.4864]])
+    >>> torch.var_mean(a)
+    (tensor(0.2455), tensor(-0.6975))
+
+.. function:: var_mean(input, dim, keepdim=False, unbiased=True) -> (Tensor, Tensor)
+
+Returns the variance and mean of each row of the :attr:`input` tensor
+in the dimension :attr:`dim`. If :attr:`dim` is a list of dimensions,
+reduce over all of them.
+
+{keepdim_details}
+
+If :attr:`unbiased` is ``False``, then the variance will be calculated
+via the biased estimator. Otherwise, Bessel's correction will be used.
+
+Args:
+    input (Tensor): the input tensor
+    {dim}
+    {keepdim}
+    unbiased (bool): whether to use the unbiased estimation or not
+
+Example::
+
+    >>> a = torch.randn(4, 4)
+    >>> a
+    tensor([[-0.3567,  1.7385, -1.3042,  0.7423],
+            [ 1.3436, -0.1015, -0.9834, -0.8438],
+            [ 0.6056,  0.1089, -0.3112, -1.4085],
+            [-0.7700,  0.6074, -0.1469,  0.7777]])
+    >>> torch.var_mean(a, 1)
+    (tensor([1.7445, 1.1364, 0.7356, 0.5111]), tensor([ 0.2050, -0.1463, -0.2513,  0.1170]))
+""".format(**multi_dim_common))
+
 add_docstr(torch.zeros,
            r"""
 zeros(*sizes, out=None, dtype=None, layout=torch.strided, device=None, requires_grad=False) -> Tensor
@@ -5569,7 +5732,7 @@ Example::
 
 add_docstr(torch.empty,
            r"""
-empty(*sizes, out=None, dtype=None, layout=torch.strided, device=None, requires_grad=False, pin_memory=False) -> Tensor
+empty(*sizes, out=None, dtype=None, layout=torch.strided, device=None, requires_grad=False, pin_memory=False, memory_format=torch.contiguous_format) -> Tensor
 
 Returns a tensor filled with uninitialized data. The shape of the tensor is
 defined by the variable argument :attr:`sizes`.
@@ -5583,6 +5746,8 @@ Args:
     {device}
     {requires_grad}
     {pin_memory}
+    memory_format (:class:`torch.memory_format`, optional): the desired memory format of
+        returned Tensor. Default: ``torch.contiguous_format``.
 
 Example::
 
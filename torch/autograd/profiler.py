@@ -212,6 +212,14 @@ class profile(object):
         self cpu time might be artificially increased because of the shape
         collection.
 
+        trace_path (str, optional): If set, events are streamed to this file
+        as a Chrome trace while profiling runs, instead of being kept in memory
+        until the profiler exits. The trace can be loaded under
+        ``chrome://tracing``. Memory used by the profiler stays bounded, which
+        makes it suitable for long runs, but no events are available to
+        ``table()``, ``key_averages()`` and the other summaries afterwards.
+        Default: ``None``
+
     .. warning:
         This context managers should not be called recursively, i.e. at most one
         instance should be enabled at any given time.
@@ -235,7 +243,7 @@ class profile(object):
         -----------------------------------  ---------------  ---------------  ---------------
 
     """
-    def __init__(self, enabled=True, use_cuda=False, record_shapes=False):
+    def __init__(self, enabled=True, use_cuda=False, record_shapes=False, trace_path=None):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
@@ -243,6 +251,7 @@ class profile(object):
             return
         self.entered = False
         self.record_shapes = record_shapes
+        self.trace_path = trace_path
 
     def __enter__(self):
         if not self.enabled:
@@ -253,14 +262,18 @@ class profile(object):
         profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
             else torch.autograd.ProfilerState.CPU
         torch.autograd._enable_profiler(
-            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes))
+            torch.autograd.ProfilerConfig(
+                profiler_kind, self.record_shapes, self.trace_path or ""))
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
         if not self.enabled:
             return
         records = torch.autograd._disable_profiler()
-        self.function_events = EventList(parse_cpu_trace(records))
+        if self.trace_path:
+            self.function_events = EventList()
+        else:
+            self.function_events = EventList(parse_cpu_trace(records))
         return False
 
     def __repr__(self):
@@ -276,6 +289,9 @@ class profile(object):
     def _check_finish(self):
         if self.function_events is None:
             raise RuntimeError("can't export a trace that didn't finish running")
+        if self.trace_path:
+            raise RuntimeError(
+                "events were streamed to {} and are not kept in memory".format(self.trace_path))
         self.function_events.populate_cpu_children()
 
     def table(self, sort_by=None, row_limit=100, header=None):
@@ -30,7 +30,9 @@ class cuFFTPlanCache(object):
     r"""
     Represents a specific plan cache for a specific `device_index`. The
     attributes `size` and `max_size`, and method `clear`, can fetch and/ or
-    change properties of the C++ cuFFT plan cache.
+    change properties of the C++ cuFFT plan cache. The read-only attributes
+    `hits` and `misses` count the FFTs that found their plan in the cache, and
+    that had to create one, since the cache was last cleared.
     """
     def __init__(self, device_index):
         self.device_index = device_index
@@ -43,6 +45,15 @@ class cuFFTPlanCache(object):
     max_size = cuFFTPlanCacheAttrContextProp(torch._cufft_get_plan_cache_max_size,
                                              torch._cufft_set_plan_cache_max_size)
 
+    hits = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_hits,
+        '.hits is a read-only property counting the plans found in the cache.')
+
+    misses = cuFFTPlanCacheAttrContextProp(
+        torch._cufft_get_plan_cache_misses,
+        '.misses is a read-only property counting the plans that were not found '
+        'in the cache.')
+
     def clear(self):
         return torch._cufft_clear_plan_cache(self.device_index)
 
@@ -83,6 +94,33 @@ class cuFFTPlanCacheManager(object):
             return super(cuFFTPlanCacheManager, self).__setattr__(name, value)
 
 
+class cuBLASModule(object):
+    r"""
+    Controls the precision of the CUDA matrix products (``mm``, ``bmm``,
+    ``matmul``, ``addmm`` and the layers built on them) through
+    ``torch.backends.cuda.matmul``:
+
+    - ``allow_fp16_reduction``: if True, half precision products accumulate in
+      half precision on devices with tensor cores. Default: False.
+    - ``allow_fp32_tensor_op``: if True, single precision products may round
+      their inputs to half precision to use the tensor cores of devices of
+      compute capability 7.0 or later, with CUDA 10. The sums are still
+      accumulated in single precision. Default: False.
+
+    Tensor cores are only used when the sizes of the matrices are multiples
+    of 8; padding the hidden sizes of a model to multiples of 8 gets the most
+    out of them.
+    """
+
+    allow_fp16_reduction = property(
+        lambda self: torch._C._get_cublas_allow_fp16_reduction(),
+        lambda self, value: torch._C._set_cublas_allow_fp16_reduction(value))
+
+    allow_fp32_tensor_op = property(
+        lambda self: torch._C._get_cublas_allow_fp32_tensor_op(),
+        lambda self, value: torch._C._set_cublas_allow_fp32_tensor_op(value))
+
+
 class CUDAModule(object):
     def __init__(self, m):
         self.__dict__ = m.__dict__
@@ -93,6 +131,14 @@ class CUDAModule(object):
 
     cufft_plan_cache = cuFFTPlanCacheManager()
 
+    # If True, scatter_add_ and index_add_ on CUDA sum floating point values in
+    # a deterministic order instead of with atomic additions.
+    deterministic_scatter = property(
+        lambda self: torch._C._get_deterministic_scatter(),
+        lambda self, value: torch._C._set_deterministic_scatter(value))
+
+    matmul = cuBLASModule()
+
 # This is the sys.modules replacement trick, see
 # https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
 sys.modules[__name__] = CUDAModule(sys.modules[__name__])
@@ -93,6 +93,29 @@ def version():
     return __cudnn_version
 
 
+def save_benchmark_cache(path):
+    r"""Saves the convolution algorithms picked with ``benchmark = True`` to the
+    file at :attr:`path`, and returns how many were saved.
+
+    With :func:`load_benchmark_cache`, this lets new processes skip the
+    benchmarks for the convolutions that were already benchmarked. Each entry
+    records the cuDNN version and GPU model it was found with, as well as the
+    largest workspace the benchmark was allowed to use.
+    """
+    return torch._cudnn_save_benchmark_cache(path)
+
+
+def load_benchmark_cache(path):
+    r"""Loads the convolution algorithms saved by :func:`save_benchmark_cache`
+    to the file at :attr:`path`, and returns how many were loaded.
+
+    Only the entries found with the loaded cuDNN version and the model of the
+    current GPU are used; they are then picked like algorithms benchmarked by
+    this process.
+    """
+    return torch._cudnn_load_benchmark_cache(path)
+
+
 CUDNN_TENSOR_TYPES = {
     'torch.cuda.HalfTensor',
     'torch.cuda.FloatTensor',
@@ -15,6 +15,7 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 #include <ATen/Utils.h>
+#include <c10/util/numa.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
@@ -25,15 +26,18 @@
 #include <torch/csrc/DataLoader.h>
 #include <torch/csrc/Generator.h>
 #include <torch/csrc/Layout.h>
+#include <torch/csrc/MemoryFormat.h>
 #include <torch/csrc/TypeInfo.h>
 #include <torch/csrc/autograd/generated/python_nn_functions.h>
 #include <torch/csrc/autograd/python_legacy_variable.h>
 #include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/multiprocessing/init.h>
 #include <torch/csrc/tensor/python_tensor.h>
+#include <torch/csrc/utils/auto_gil.h>
 #include <torch/csrc/utils/tensor_dtypes.h>
 #include <torch/csrc/utils/python_strings.h>
 #include <torch/csrc/utils/tensor_layouts.h>
+#include <torch/csrc/utils/tensor_memoryformats.h>
 #include <torch/csrc/utils/tensor_numpy.h>
 #include <torch/csrc/jit/python_tracer.h>
 #include <torch/csrc/jit/init.h>
@@ -48,6 +52,7 @@
 #ifdef USE_DISTRIBUTED
 #ifdef USE_C10D
 #include <torch/csrc/distributed/c10d/c10d.h>
+#include <torch/csrc/distributed/rpc/rpc.h>
 #endif
 #endif
 
@@ -97,6 +102,7 @@ static PyObject * THPModule_initExtension(PyObject *_unused, PyObject *shm_manag
     return nullptr;
   }
   torch::utils::initializeLayouts();
+  torch::utils::initializeMemoryFormats();
   torch::utils::initializeDtypes();
   torch::tensors::initialize_python_bindings();
   std::string path = THPUtils_unpackString(shm_manager_path);
@@ -159,6 +165,48 @@ static PyObject * THPModule_setNumThreads(PyObject *module, PyObject *arg)
   Py_RETURN_NONE;
 }
 
+static PyObject * THPModule_getNumInteropThreads(PyObject *module)
+{
+  return PyLong_FromLong(at::get_num_interop_threads());
+}
+
+static PyObject * THPModule_setNumInteropThreads(PyObject *module, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "set_num_interop_threads expects an int, "
+          "but got %s", THPUtils_typename(arg));
+  int nthreads = (int)THPUtils_unpackLong(arg);
+  THPUtils_assert(nthreads > 0, "set_num_interop_threads expects a positive integer");
+  at::set_num_interop_threads(nthreads);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_getNUMAPolicy(PyObject *module)
+{
+  return PyLong_FromLong(c10::GetNUMAPolicy());
+}
+
+static PyObject * THPModule_setNUMAPolicy(PyObject *module, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "set_numa_policy expects an int, "
+          "but got %s", THPUtils_typename(arg));
+  c10::SetNUMAPolicy((int)THPUtils_unpackLong(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THPModule_setThreadNUMAPolicy(PyObject *module, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "set_thread_numa_policy expects an int, "
+          "but got %s", THPUtils_typename(arg));
+  c10::SetThreadNUMAPolicy((int)THPUtils_unpackLong(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THPModule_setDefaultTensorType(PyObject *_unused, PyObject *type)
 {
   HANDLE_TH_ERRORS
@@ -365,6 +413,43 @@ PyObject *THPModule_fromDLPack(PyObject *_unused, PyObject *data)
   END_HANDLE_TH_ERRORS
 }
 
+// _write_storages(fd, storages, direct_io): writes the storages of torch.save
+// to the file descriptor, without the GIL
+PyObject *THPModule_writeStorages(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *fd_obj = nullptr, *storages_obj = nullptr, *direct_io_obj = nullptr;
+  if (!PyArg_ParseTuple(args, "OOO", &fd_obj, &storages_obj, &direct_io_obj)) {
+    return nullptr;
+  }
+  THPUtils_assert(THPUtils_checkLong(fd_obj), "_write_storages expects an int "
+          "file descriptor, but got %s", THPUtils_typename(fd_obj));
+  THPUtils_assert(PySequence_Check(storages_obj), "_write_storages expects a "
+          "sequence of storages, but got %s", THPUtils_typename(storages_obj));
+  THPUtils_assert(PyBool_Check(direct_io_obj), "_write_storages expects a bool "
+          "direct_io, but got %s", THPUtils_typename(direct_io_obj));
+  THPObjectPtr seq(PySequence_Fast(storages_obj, "expected a sequence"));
+  if (!seq) throw python_error();
+  const Py_ssize_t num_storages = PySequence_Fast_GET_SIZE(seq.get());
+  std::vector<at::Storage> storages;
+  storages.reserve(num_storages);
+  for (Py_ssize_t i = 0; i < num_storages; i++) {
+    PyObject *storage = PySequence_Fast_GET_ITEM(seq.get(), i);
+    THPUtils_assert(torch::isStorage(storage), "_write_storages expects "
+            "storages, but got %s", THPUtils_typename(storage));
+    storages.push_back(torch::createStorage(storage));
+  }
+  const int fd = (int)THPUtils_unpackLong(fd_obj);
+  StorageWriterOptions options;
+  options.direct_io = direct_io_obj == Py_True;
+  {
+    AutoNoGIL no_gil;
+    writeStorages(fd, storages, options);
+  }
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject *THPModule_setUserEnabledCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_enabled_cudnn expects a bool, "
@@ -393,6 +478,70 @@ PyObject *THPModule_deterministicCuDNN(PyObject *_unused)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_releaseShmPool(PyObject *_unused)
+{
+  HANDLE_TH_ERRORS
+  THManagedMapChunk::releasePool();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject *THPModule_setLazyZeroFill(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_lazy_zero_fill expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setLazyZeroFill(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_lazyZeroFill(PyObject *_unused)
+{
+  if (at::globalContext().lazyZeroFill()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setDeterministicScatter(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_deterministic_scatter expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setDeterministicScatter(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_deterministicScatter(PyObject *_unused)
+{
+  if (at::globalContext().deterministicScatter()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setAllowFP16ReductionCuBLAS(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cublas_allow_fp16_reduction expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setAllowFP16ReductionCuBLAS(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_allowFP16ReductionCuBLAS(PyObject *_unused)
+{
+  if (at::globalContext().allowFP16ReductionCuBLAS()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setAllowFP32TensorOpCuBLAS(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cublas_allow_fp32_tensor_op expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setAllowFP32TensorOpCuBLAS(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_allowFP32TensorOpCuBLAS(PyObject *_unused)
+{
+  if (at::globalContext().allowFP32TensorOpCuBLAS()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setBenchmarkCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_benchmark_cudnn expects a bool, "
@@ -455,12 +604,27 @@ static PyMethodDef TorchMethods[] = {
   {"_get_backcompat_keepdim_warn", (PyCFunction)THPModule_getBackcompatKeepdimWarn, METH_NOARGS, nullptr},
   {"get_num_threads", (PyCFunction)THPModule_getNumThreads,     METH_NOARGS,  nullptr},
   {"set_num_threads", (PyCFunction)THPModule_setNumThreads,     METH_O,       nullptr},
+  {"get_num_interop_threads", (PyCFunction)THPModule_getNumInteropThreads,     METH_NOARGS,  nullptr},
+  {"set_num_interop_threads", (PyCFunction)THPModule_setNumInteropThreads,     METH_O,  nullptr},
+  {"_get_numa_policy", (PyCFunction)THPModule_getNUMAPolicy, METH_NOARGS,  nullptr},
+  {"_set_numa_policy", (PyCFunction)THPModule_setNUMAPolicy, METH_O,  nullptr},
+  {"_set_thread_numa_policy", (PyCFunction)THPModule_setThreadNUMAPolicy, METH_O,  nullptr},
   {"_get_cudnn_enabled", (PyCFunction)THPModule_userEnabledCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_enabled", (PyCFunction)THPModule_setUserEnabledCuDNN, METH_O,  nullptr},
   {"_get_cudnn_benchmark", (PyCFunction)THPModule_benchmarkCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_deterministic", (PyCFunction)THPModule_setDeterministicCuDNN, METH_O,  nullptr},
+  {"_release_shm_pool", (PyCFunction)THPModule_releaseShmPool, METH_NOARGS,  nullptr},
+  {"_get_lazy_zero_fill", (PyCFunction)THPModule_lazyZeroFill, METH_NOARGS,     nullptr},
+  {"_set_lazy_zero_fill", (PyCFunction)THPModule_setLazyZeroFill, METH_O,  nullptr},
+  {"_write_storages", (PyCFunction)THPModule_writeStorages, METH_VARARGS, nullptr},
+  {"_get_deterministic_scatter", (PyCFunction)THPModule_deterministicScatter, METH_NOARGS,     nullptr},
+  {"_set_deterministic_scatter", (PyCFunction)THPModule_setDeterministicScatter, METH_O,  nullptr},
+  {"_get_cublas_allow_fp16_reduction", (PyCFunction)THPModule_allowFP16ReductionCuBLAS, METH_NOARGS,     nullptr},
+  {"_set_cublas_allow_fp16_reduction", (PyCFunction)THPModule_setAllowFP16ReductionCuBLAS, METH_O,  nullptr},
+  {"_get_cublas_allow_fp32_tensor_op", (PyCFunction)THPModule_allowFP32TensorOpCuBLAS, METH_NOARGS,     nullptr},
+  {"_set_cublas_allow_fp32_tensor_op", (PyCFunction)THPModule_setAllowFP32TensorOpCuBLAS, METH_O,  nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
@@ -567,6 +731,7 @@ PyObject* initModule() {
   THPUtils_addPyMethodDefs(methods, THDPModule_methods());
 #ifdef USE_C10D
   THPUtils_addPyMethodDefs(methods, torch::distributed::c10d::python_functions());
+  THPUtils_addPyMethodDefs(methods, torch::distributed::rpc::python_functions());
 #endif
 #endif
 
@@ -589,6 +754,7 @@ PyObject* initModule() {
   THPDtype_init(module);
   THPDTypeInfo_init(module);
   THPLayout_init(module);
+  THPMemoryFormat_init(module);
   THPDevice_init(module);
   ASSERT_TRUE(THPVariable_initModule(module));
   ASSERT_TRUE(THPFunction_initModule(module));
@@ -3,7 +3,9 @@
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
 #include <torch/data/detail/sequencers.h>
+#include <torch/data/detail/transfer.h>
 #include <torch/data/iterator.h>
+#include <torch/data/metrics.h>
 #include <torch/data/samplers/random.h>
 #include <torch/data/worker_exception.h>
 #include <torch/types.h>
@@ -12,7 +14,9 @@
 #include <torch/csrc/utils/variadic.h>
 
 #include <c10/util/Exception.h>
+#include <c10/util/Logging.h>
 
+#include <chrono>
 #include <cstddef>
 #include <exception>
 #include <memory>
@@ -37,7 +41,12 @@ class DataLoaderBase {
       std::unique_ptr<Dataset> main_thread_dataset = nullptr)
       : options_(std::move(options)),
         main_thread_dataset_(std::move(main_thread_dataset)),
-        sequencer_(new_sequencer()) {}
+        shuttle_(options_.workers),
+        sequencer_(new_sequencer()),
+        metrics_(options_.workers) {
+    transfer_.device = options_.device;
+    transfer_.pin_memory = options_.pin_memory;
+  }
 
   virtual ~DataLoaderBase() {
     join();
@@ -96,7 +105,27 @@ class DataLoaderBase {
     return options_;
   }
 
+  /// Returns timings of the stages batches went through since the DataLoader
+  /// was created or `reset_metrics()` was last called. The metrics are updated
+  /// concurrently by the worker threads, so they may be read at any time.
+  const DataLoaderMetrics& metrics() const noexcept {
+    return metrics_;
+  }
+
+  /// Clears the `metrics()`.
+  void reset_metrics() {
+    metrics_.reset();
+  }
+
+  /// Returns the number of batches currently requested from (or produced by,
+  /// but not yet returned from) the worker threads.
+  size_t jobs_in_flight() const noexcept {
+    return shuttle_.in_flight_jobs();
+  }
+
  protected:
+  using Clock = std::chrono::steady_clock;
+
   /// Simple mix-in to give something a sequence number.
   struct Sequenced {
     Sequenced() = default;
@@ -115,6 +144,8 @@ class DataLoaderBase {
         : Sequenced(sqn), batch_request(std::move(i)) {}
     optional<QuitWorker> quit;
     optional<BatchRequest> batch_request;
+    /// When the job was pushed into the job queue.
+    Clock::time_point enqueued = Clock::now();
   };
 
   /// The finished result of a job.
@@ -163,35 +194,91 @@ class DataLoaderBase {
   /// is exhausted. This operation will block until a batch is available if one
   /// is still expected.
   optional<BatchType> next() {
+    maybe_log_metrics();
+    const auto start = Clock::now();
     if (options_.workers > 0) {
       while (optional<Result> result = this->pop_result()) {
         if (result->exception) {
           throw WorkerException(result->exception);
         } else if (result->batch) {
+          metrics_.next_wait.record(Clock::now() - start);
           prefetch(1);
           return std::move(result->batch);
         }
       }
     } else if (auto batch_request = get_batch_request()) {
-      return this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      auto batch =
+          this->main_thread_dataset_->get_batch(std::move(*batch_request));
+      const auto fetched = Clock::now();
+      metrics_.fetch.record(fetched - start);
+      auto result = transfer(std::move(batch));
+      const auto end = Clock::now();
+      metrics_.transfer.record(end - fetched);
+      metrics_.next_wait.record(end - start);
+      return result;
     }
     return nullopt;
   }
 
-  /// The function that worker threads run.
-  void worker_thread(Dataset& dataset) {
+  /// The function that worker threads run. `worker` is the index of the
+  /// thread, which determines the job queue it pops from first.
+  void worker_thread(Dataset& dataset, size_t worker) {
+    auto& worker_metrics = metrics_.workers[worker];
     while (true) {
-      auto job = shuttle_.pop_job();
+      auto idle_start = Clock::now();
+      auto job = shuttle_.pop_job(worker);
+      const auto start = Clock::now();
+      worker_metrics.idle_ns.fetch_add(
+          nanoseconds(start - idle_start), std::memory_order_relaxed);
       if (job.quit) {
         break;
       }
+      metrics_.queue_wait.record(start - job.enqueued);
       try {
         auto batch = dataset.get_batch(std::move(*job.batch_request));
-        shuttle_.push_result({std::move(batch), job.sequence_number});
+        const auto fetched = Clock::now();
+        metrics_.fetch.record(fetched - start);
+        auto result = transfer(std::move(batch));
+        metrics_.transfer.record(Clock::now() - fetched);
+        shuttle_.push_result({std::move(result), job.sequence_number});
+        worker_metrics.batches.fetch_add(1, std::memory_order_relaxed);
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
       }
+      worker_metrics.busy_ns.fetch_add(
+          nanoseconds(Clock::now() - start), std::memory_order_relaxed);
+    }
+  }
+
+  /// Logs the `metrics()` if `metrics_log_interval` is set and has passed
+  /// since they were last logged.
+  void maybe_log_metrics() {
+    if (!options_.metrics_log_interval) {
+      return;
     }
+    const auto now = Clock::now();
+    if (now - last_metrics_log_ < *options_.metrics_log_interval) {
+      return;
+    }
+    last_metrics_log_ = now;
+    LOG(INFO) << "DataLoader metrics (jobs in flight: " << jobs_in_flight()
+              << "):\n"
+              << metrics_;
+  }
+
+  static uint64_t nanoseconds(Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+        .count();
+  }
+
+  /// Moves the tensors of `batch` to pinned memory and/or the configured
+  /// device, if the options ask for it.
+  template <typename T>
+  T transfer(T batch) const {
+    if (!transfer_.enabled()) {
+      return batch;
+    }
+    return transfer_(std::move(batch));
   }
 
   /// Convenience method that calls `shuttle_.push_job()` with the next sequence
@@ -208,8 +295,13 @@ class DataLoaderBase {
   }
 
   /// Convenience method that creates a new sequencer based on the
-  /// `enforce_ordering` option.
+  /// `enforce_ordering` and `reorder_window` options.
   std::unique_ptr<detail::sequencers::Sequencer<Result>> new_sequencer() {
+    if (options_.enforce_ordering && options_.reorder_window) {
+      return torch::make_unique<
+          detail::sequencers::WindowedSequencer<Result>>(
+          *options_.reorder_window, options_.max_jobs);
+    }
     if (options_.enforce_ordering) {
       return torch::make_unique<detail::sequencers::OrderedSequencer<Result>>(
           options_.max_jobs);
@@ -239,6 +331,15 @@ class DataLoaderBase {
   /// The `Sequencer`, which handles optional ordering of batches.
   std::unique_ptr<detail::sequencers::Sequencer<Result>> sequencer_;
 
+  /// Applies the `device` and `pin_memory` options to fetched batches.
+  detail::BatchTransfer transfer_;
+
+  /// Timings collected by `next()` and the worker threads.
+  DataLoaderMetrics metrics_;
+
+  /// When the `metrics_` were last logged (see `metrics_log_interval`).
+  Clock::time_point last_metrics_log_ = Clock::now();
+
   /// True if the DataLoader has joined its worker threads.
   bool joined_ = false;
 };
@@ -34,9 +34,30 @@ struct DataLoaderOptions {
   /// you do not care about determinism.
   TORCH_ARG(bool, enforce_ordering) = true;
 
+  /// If set (and `enforce_ordering` is true), relaxes the ordering of batches:
+  /// a batch may be returned before earlier ones as long as it is less than
+  /// `reorder_window` batches ahead of the oldest batch not yet returned. A
+  /// window of one is the same as strict ordering. Larger windows keep a single
+  /// slow batch from holding back all batches finished after it.
+  TORCH_ARG(optional<size_t>, reorder_window);
+
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// An optional device to move every tensor of a batch to before it is
+  /// returned. With worker threads, the copy is started by the worker that
+  /// produced the batch, so it overlaps with the processing of earlier batches.
+  TORCH_ARG(optional<Device>, device);
+
+  /// Whether to copy the tensors of each batch into page-locked (pinned) host
+  /// memory. Together with a CUDA `device`, this makes the host-to-device
+  /// copies asynchronous with respect to the worker threads.
+  TORCH_ARG(bool, pin_memory) = false;
+
+  /// If set, the DataLoader logs its `metrics()` at most once per
+  /// `metrics_log_interval` while batches are being fetched.
+  TORCH_ARG(optional<std::chrono::milliseconds>, metrics_log_interval);
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,14 +73,22 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs_.value_or(2 * workers)),
         timeout(options.timeout_),
         enforce_ordering(options.enforce_ordering_),
-        drop_last(options.drop_last_) {}
+        reorder_window(options.reorder_window_),
+        drop_last(options.drop_last_),
+        device(options.device_),
+        pin_memory(options.pin_memory_),
+        metrics_log_interval(options.metrics_log_interval_) {}
 
   size_t batch_size;
   size_t workers;
   size_t max_jobs;
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
+  optional<size_t> reorder_window;
   bool drop_last;
+  optional<Device> device;
+  bool pin_memory;
+  optional<std::chrono::milliseconds> metrics_log_interval;
 };
 } // namespace data
 } // namespace torch
@@ -4,6 +4,7 @@
 #include <torch/types.h>
 
 #include <c10/util/ArrayRef.h>
+#include <c10/util/C++17.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -30,6 +31,17 @@ template <typename T>
 struct is_optional : std::false_type {};
 template <typename T>
 struct is_optional<optional<T>> : std::true_type {};
+
+/// True for datasets that can return a batch of examples with the tensors
+/// already stacked, through `get_stacked_batch(indices, pin_memory)`.
+template <typename D, typename = void>
+struct has_stacked_batch : std::false_type {};
+template <typename D>
+struct has_stacked_batch<
+    D,
+    c10::guts::void_t<decltype(std::declval<D&>().get_stacked_batch(
+        std::declval<ArrayRef<size_t>>(),
+        /*pin_memory=*/false))>> : std::true_type {};
 } // namespace detail
 
 /// A dataset that can yield data only in batches.
@@ -72,6 +84,12 @@ class BatchDataset {
 /// therefore batched access is implemented (by default) by calling the random
 /// access indexing function for each index in the requested batch of indices.
 /// This can be customized.
+///
+/// Datasets backed by tensors can additionally define a method
+/// `ExampleType get_stacked_batch(ArrayRef<size_t> indices, bool pin_memory)`
+/// that returns the examples at `indices` stacked along a new first dimension,
+/// like `transforms::Stack` would. Mapping such a dataset with `Stack` then
+/// gathers the batch directly instead of going through `get()` per example.
 template <typename Self, typename SingleExample = Example<>>
 class Dataset : public BatchDataset<Self, std::vector<SingleExample>> {
  public:
@@ -1,6 +1,11 @@
 #pragma once
 
 #include <torch/data/datasets/stateful.h>
+#include <torch/data/metrics.h>
+
+#include <chrono>
+#include <deque>
+#include <future>
 
 namespace torch {
 namespace data {
@@ -20,6 +25,20 @@ class ChunkDataReader {
   /// Read an entire chunk.
   virtual ChunkType read_chunk(size_t chunk_index) = 0;
 
+  /// Starts reading an entire chunk and returns a future for it. Readers of
+  /// slow storage can override this to issue the I/O on their own threads, so
+  /// that a `ChunkDataset` with more than one chunk in flight per preloader
+  /// (see `ChunkDatasetOptions::chunks_in_flight`) overlaps reading chunks
+  /// with splitting and batching the chunks that are already read. Several
+  /// reads may be in flight at once, also from different preloader threads.
+  /// The default implementation defers to `read_chunk()`, which then runs
+  /// when the preloader waits for the future.
+  virtual std::future<ChunkType> read_chunk_async(size_t chunk_index) {
+    return std::async(std::launch::deferred, [this, chunk_index] {
+      return this->read_chunk(chunk_index);
+    });
+  }
+
   /// Returns the number of chunks available in this reader.
   virtual size_t chunk_count() = 0;
 
@@ -45,14 +64,17 @@ class BatchDataBuffer {
   BatchDataBuffer(
       size_t batch_size,
       ExampleSampler& example_sampler,
-      size_t queue_capacity)
+      size_t queue_capacity,
+      ChunkDatasetMetrics* metrics = nullptr)
       : batch_size_(batch_size),
         example_sampler_(example_sampler),
-        queue_capacity_(queue_capacity) {}
+        queue_capacity_(queue_capacity),
+        metrics_(metrics) {}
 
   /// Return batch data from the queue. Called from the ChunkDataset main
   /// thread.
   BatchType get_batch() {
+    const auto start = std::chrono::steady_clock::now();
     std::unique_lock<std::mutex> lock(queue_mutex_);
     cv_read_.wait(lock, [this] {
       // wait till there is available data in the queue or if all chunks are
@@ -61,6 +83,9 @@ class BatchDataBuffer {
           this->total_example_count_in_queue_ >= batch_size_ ||
           this->stop_);
     });
+    if (metrics_) {
+      metrics_->batch_wait.record(std::chrono::steady_clock::now() - start);
+    }
     if (batch_queue_.empty()) {
       AT_ASSERT(stop_);
       // All batches have been retrieved. Return an empty batch.
@@ -83,12 +108,17 @@ class BatchDataBuffer {
   /// Push preloaded chunks to batch queue. Called from the ChunkDataset worker
   /// threads.
   void add_chunk_data(UnwrappedBatchType data) {
+    const auto start = std::chrono::steady_clock::now();
     std::unique_lock<std::mutex> lock(queue_mutex_);
     cv_write_.wait(lock, [this] {
       // stop loading if we have preloaded enough data.
       return this->total_example_count_in_queue_ < this->queue_capacity_ ||
           this->stop_;
     });
+    if (metrics_) {
+      metrics_->preloader_stall.record(
+          std::chrono::steady_clock::now() - start);
+    }
     if (stop_) {
       // When stop_ is true, it means no further chunk loading is necessary.
       // Return without any further processing.
@@ -141,6 +171,14 @@ class BatchDataBuffer {
     cv_read_.notify_all();
   }
 
+  /// Returns true if the queue holds fewer examples than its capacity, i.e. if
+  /// more chunks should be loaded. Called from the ChunkDataset worker threads
+  /// before they start reading another chunk.
+  bool has_capacity() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return total_example_count_in_queue_ < queue_capacity_ && !stop_;
+  }
+
   /// Push exceptions thrown during preloading into batch queue. Called from
   /// the ChunkDataset worker threads.
   void add_chunk_data(std::exception_ptr e_ptr) {
@@ -230,6 +268,10 @@ class BatchDataBuffer {
   // preloader could be still waiting for the conditional variable, thus cause
   // the program to hang. This boolean is used to break this waiting condition.
   bool stop_ = false;
+
+  // optional sink for the time spent waiting in get_batch() and
+  // add_chunk_data().
+  ChunkDatasetMetrics* metrics_;
 };
 } // namespace detail
 
@@ -266,6 +308,11 @@ struct ChunkDatasetOptions {
 
   // the capacity of the queue for batch caching.
   TORCH_ARG(size_t, cache_size) = 2048;
+
+  /// The number of chunks each preloader reads ahead through
+  /// `ChunkDataReader::read_chunk_async`. Apart from the oldest one, reads
+  /// are only started while the cache has room for more examples.
+  TORCH_ARG(size_t, chunks_in_flight) = 1;
 };
 
 /// A stateful dataset that support hierarchical sampling and prefetching of
@@ -302,7 +349,11 @@ class ChunkDataset final
         example_sampler_(std::move(example_sampler)),
         options_(std::move(options)),
         quit_worker_(false),
-        running_preloaders_(0) {}
+        running_preloaders_(0) {
+    AT_CHECK(
+        options_.chunks_in_flight_ > 0,
+        "Chunks in flight is 0. At least one chunk needs to be read at a time.");
+  }
 
   virtual ~ChunkDataset() {
     // stop batch buffer first.
@@ -351,7 +402,8 @@ class ChunkDataset final
         detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>(
         options_.batch_size_,
         example_sampler_,
-        options_.cache_size_);
+        options_.cache_size_,
+        &metrics_);
 
     // create new workers for this new epoch.
     quit_worker_ = false;
@@ -374,21 +426,54 @@ class ChunkDataset final
     return chunk_sampler_;
   }
 
+  /// Returns timings of reading chunks and of waiting for the batch cache.
+  /// The preloader threads update them concurrently, so they may be read at
+  /// any time.
+  const ChunkDatasetMetrics& metrics() const noexcept {
+    return metrics_;
+  }
+
+  /// Clears the `metrics()`.
+  void reset_metrics() {
+    metrics_.reset();
+  }
+
  private:
-  /// running on worker thread to preload chunk data.
+  /// running on worker thread to preload chunk data. Each preloader keeps up
+  /// to `chunks_in_flight` chunk reads outstanding and adds the chunks to the
+  /// batch buffer in the order it started reading them.
   void preloader(size_t id) {
+    using Clock = std::chrono::steady_clock;
+    std::deque<std::pair<std::future<UnwrappedBatchType>, Clock::time_point>>
+        in_flight;
+    bool exhausted = false;
     while (!quit_worker_.load()) {
       try {
-        size_t chunk_id = 0;
-        {
-          std::lock_guard<std::mutex> lock(chunk_index_guard_);
-          if (auto chunk_sampler_result = chunk_sampler_.next(1)) {
-            chunk_id = chunk_sampler_result.value()[0];
-          } else {
-            break;
+        while (!exhausted &&
+               in_flight.size() < options_.chunks_in_flight_ &&
+               (in_flight.empty() || batch_buffer_->has_capacity())) {
+          size_t chunk_id = 0;
+          {
+            std::lock_guard<std::mutex> lock(chunk_index_guard_);
+            if (auto chunk_sampler_result = chunk_sampler_.next(1)) {
+              chunk_id = chunk_sampler_result.value()[0];
+            } else {
+              exhausted = true;
+              break;
+            }
           }
+          const auto started = Clock::now();
+          in_flight.emplace_back(
+              chunk_reader_.read_chunk_async(chunk_id), started);
+        }
+        if (in_flight.empty()) {
+          break;
         }
-        UnwrappedBatchType data = chunk_reader_.read_chunk(chunk_id);
+        auto future = std::move(in_flight.front().first);
+        const auto started = in_flight.front().second;
+        in_flight.pop_front();
+        UnwrappedBatchType data = future.get();
+        metrics_.chunk_read.record(Clock::now() - started);
         if (!data.empty()) { // skip empty chunks.
           batch_buffer_->add_chunk_data(std::move(data));
         }
@@ -396,6 +481,15 @@ class ChunkDataset final
         batch_buffer_->add_chunk_data(std::current_exception());
       }
     }
+    // The reader must not be reset while it is still reading, so wait for
+    // reads that were started but are no longer needed.
+    for (auto& read : in_flight) {
+      auto& future = read.first;
+      if (future.wait_for(std::chrono::seconds(0)) !=
+          std::future_status::deferred) {
+        future.wait();
+      }
+    }
     AT_ASSERT(running_preloaders_.load() > 0);
     --running_preloaders_;
     if (running_preloaders_.load() == 0) {
@@ -445,6 +539,9 @@ class ChunkDataset final
 
   // mutex to synchronize chunk sampler next() call.
   std::mutex chunk_index_guard_;
+
+  // timings of the preloaders and the batch buffer.
+  ChunkDatasetMetrics metrics_;
 };
 } // namespace datasets
 } // namespace data
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <torch/data/datasets/base.h>
+#include <torch/data/transforms/base.h>
+#include <torch/data/transforms/stack.h>
 #include <torch/types.h>
 
 #include <c10/util/ArrayRef.h>
@@ -15,6 +17,14 @@ namespace datasets {
 namespace detail {
 template <bool C, typename T>
 using optional_if_t = typename std::conditional<C, torch::optional<T>, T>::type;
+
+/// True if mapping dataset `D` with transform `T` can gather stacked batches
+/// directly from `D`, since `T` just stacks the examples of a batch.
+template <typename D, typename T>
+struct stacks_batch : std::integral_constant<
+                          bool,
+                          !D::is_stateful && has_stacked_batch<D>::value &&
+                              transforms::detail::is_stack<T>::value> {};
 } // namespace detail
 
 /// A `MapDataset` is a dataset that applies a transform to a source dataset.
@@ -42,6 +52,18 @@ class MapDataset : public BatchDataset<
     return get_batch_impl(std::move(indices));
   }
 
+  /// Returns the examples at `indices` stacked into one, transformed in one
+  /// call. Only available if the source dataset supports stacked batches and
+  /// the transform declares that it works batch-wise.
+  template <typename D = SourceDataset, typename T = AppliedTransform>
+  torch::enable_if_t<
+      detail::has_stacked_batch<D>::value &&
+          transforms::detail::is_batchwise<T>::value,
+      typename T::OutputType>
+  get_stacked_batch(ArrayRef<size_t> indices, bool pin_memory = false) {
+    return transform_.apply(dataset_.get_stacked_batch(indices, pin_memory));
+  }
+
   /// Returns the size of the source dataset.
   optional<size_t> size() const noexcept override {
     return dataset_.size();
@@ -68,13 +90,23 @@ class MapDataset : public BatchDataset<
  private:
   /// The implementation of `get_batch()` for the stateless case, which simply
   /// applies the transform to the output of `get_batch()` from the dataset.
-  template <
-      typename D = SourceDataset,
-      typename = torch::disable_if_t<D::is_stateful>>
-  OutputBatchType get_batch_impl(BatchRequestType indices) {
+  template <typename D = SourceDataset, typename T = AppliedTransform>
+  torch::enable_if_t<
+      !D::is_stateful && !detail::stacks_batch<D, T>::value,
+      OutputBatchType>
+  get_batch_impl(BatchRequestType indices) {
     return transform_.apply_batch(dataset_.get_batch(std::move(indices)));
   }
 
+  /// The implementation of `get_batch()` for a `Stack` over a dataset that
+  /// supports stacked batches, which gathers the stacked batch directly rather
+  /// than getting every example and stacking them afterwards.
+  template <typename D = SourceDataset, typename T = AppliedTransform>
+  torch::enable_if_t<detail::stacks_batch<D, T>::value, OutputBatchType>
+  get_batch_impl(BatchRequestType indices) {
+    return dataset_.get_stacked_batch(indices, transform_.pin_memory);
+  }
+
   /// The implementation of `get_batch()` for the stateful case. Here, we follow
   /// the semantics of `Optional.map()` in many functional languages, which
   /// applies a transformation to the optional's content when the optional
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+/// A dataset of tensor columns that are memory-mapped from a file.
+///
+/// The file holds a number of named columns, each with one tensor of a fixed
+/// shape and type per row, and is written by `MMapTensorDataset::write()`.
+/// Columns are mapped read-only and privately, so the data is paged in lazily
+/// and shared through the page cache by every process and worker that maps the
+/// same file, instead of each holding its own copy.
+///
+/// `get_batch()` returns one tensor per column. If the requested rows form a
+/// contiguous, ascending range, the tensors are views into the mapping and no
+/// data is copied. Otherwise the rows are gathered into new tensors.
+///
+/// The file format (all values in native little-endian byte order):
+///   - the magic bytes "TCOL" and a `uint32` format version,
+///   - the `uint64` number of rows and the `uint32` number of columns,
+///   - for each column: its `uint32` name length followed by the name, its
+///     `int32` scalar type, its `uint32` number of dimensions per row followed
+///     by the `int64` size of each, and the `uint64` offset of its data,
+///   - the data of each column, starting at its offset (aligned to 64 bytes),
+///     with the rows stored contiguously one after the other.
+class TORCH_API MMapTensorDataset
+    : public BatchDataset<MMapTensorDataset, std::vector<Tensor>> {
+ public:
+  /// Memory-maps the columns of the file at `path`.
+  explicit MMapTensorDataset(const std::string& path);
+
+  /// Returns the rows at the given `indices`, one tensor per column, in the
+  /// order of `column_names()`. Dimension zero of each tensor is the batch.
+  std::vector<Tensor> get_batch(ArrayRef<size_t> indices) override;
+
+  /// Returns the number of rows.
+  optional<size_t> size() const override;
+
+  /// Returns the names of the columns, in the order they are stored.
+  const std::vector<std::string>& column_names() const noexcept;
+
+  /// Returns all rows of the column with the given `name`, as a view into the
+  /// mapping.
+  const Tensor& column(const std::string& name) const;
+
+  /// Writes `columns` under the given `names` to a new file at `path`. All
+  /// columns must be CPU tensors with the same size in dimension zero, which
+  /// is the number of rows.
+  static void write(
+      const std::string& path,
+      const std::vector<std::string>& names,
+      const std::vector<Tensor>& columns);
+
+ private:
+  std::vector<std::string> names_;
+  std::vector<Tensor> columns_;
+  size_t rows_ = 0;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -27,6 +27,12 @@ class TORCH_API MNIST : public Dataset<MNIST> {
   /// Returns the `Example` at the given `index`.
   Example<> get(size_t index) override;
 
+  /// Returns the examples at `indices`, with the images and targets stacked
+  /// into one tensor each.
+  Example<> get_stacked_batch(
+      ArrayRef<size_t> indices,
+      bool pin_memory = false);
+
   /// Returns the size of the dataset.
   optional<size_t> size() const override;
 
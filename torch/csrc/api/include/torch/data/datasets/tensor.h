@@ -4,12 +4,54 @@
 #include <torch/data/example.h>
 #include <torch/types.h>
 
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+
 #include <cstddef>
 #include <vector>
 
 namespace torch {
 namespace data {
 namespace datasets {
+namespace detail {
+/// Gathers the rows of `source` (along dimension zero) at `indices` into a
+/// new tensor, allocated in page-locked memory if `pin_memory` is true. If the
+/// indices are an ascending range of consecutive rows and no pinned memory is
+/// requested, returns a view of `source` instead of copying.
+inline Tensor gather_rows(
+    const Tensor& source,
+    ArrayRef<size_t> indices,
+    bool pin_memory = false) {
+  const size_t rows = source.size(0);
+  bool contiguous = true;
+  for (size_t i = 0; i < indices.size(); ++i) {
+    AT_CHECK(
+        indices[i] < rows,
+        "Index ",
+        indices[i],
+        " is out of range for a dataset of ",
+        rows,
+        " rows");
+    contiguous = contiguous && indices[i] == indices.front() + i;
+  }
+  const int64_t start = indices.empty() ? 0 : indices.front();
+  if (contiguous && !pin_memory) {
+    return source.narrow(0, start, indices.size());
+  }
+  auto sizes = source.sizes().vec();
+  sizes[0] = indices.size();
+  auto output = torch::empty(sizes, source.options().pinned_memory(pin_memory));
+  if (contiguous) {
+    return output.copy_(source.narrow(0, start, indices.size()));
+  }
+  auto index = torch::empty(indices.size(), kLong);
+  auto* index_data = index.data<int64_t>();
+  for (size_t i = 0; i < indices.size(); ++i) {
+    index_data[i] = indices[i];
+  }
+  return torch::index_select_out(output, source, /*dim=*/0, index);
+}
+} // namespace detail
 
 /// A dataset of tensors.
 /// Stores a single tensor internally, which is then indexed inside `get()`.
@@ -25,6 +67,14 @@ struct TensorDataset : public Dataset<TensorDataset, TensorExample> {
     return tensor[index];
   }
 
+  /// Returns the tensors at `indices` stacked into one, gathered directly from
+  /// the underlying tensor.
+  TensorExample get_stacked_batch(
+      ArrayRef<size_t> indices,
+      bool pin_memory = false) {
+    return detail::gather_rows(tensor, indices, pin_memory);
+  }
+
   /// Returns the number of tensors in the dataset.
   optional<size_t> size() const override {
     return tensor.size(0);
@@ -1,11 +1,13 @@
 #pragma once
 
 #include <torch/data/detail/queue.h>
+#include <torch/data/detail/work_stealing_queue.h>
 #include <torch/types.h>
 
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
 
+#include <algorithm>
 #include <chrono>
 #include <utility>
 
@@ -22,9 +24,16 @@ namespace detail {
 /// dequeues a result is the count of in-flight jobs decremented. When the main
 /// thread attempts to dequeue a job but no jobs are in-flight, that means the
 /// epoch is complete and `pop_result` returns an empty optional.
+///
+/// Jobs are distributed over one queue per worker thread, and workers that run
+/// out of jobs steal them from the queues of other workers.
 template <typename Job, typename Result>
 class DataShuttle {
  public:
+  /// Constructs the `DataShuttle` for the given number of worker threads.
+  explicit DataShuttle(size_t workers = 1)
+      : new_jobs_(std::max<size_t>(workers, 1)) {}
+
   /// Pushes a new job. Called by the main thread.
   void push_job(Job job) {
     new_jobs_.push(std::move(job));
@@ -37,9 +46,9 @@ class DataShuttle {
   }
 
   /// Returns the next job, blocking until there is one available. Called by
-  /// worker threads.
-  Job pop_job() {
-    return new_jobs_.pop();
+  /// worker threads, which pass their index.
+  Job pop_job(size_t worker = 0) {
+    return new_jobs_.pop(worker);
   }
 
   /// Returns the result of a job, or nullopt if all jobs were exhausted. Called
@@ -74,7 +83,7 @@ class DataShuttle {
 
  private:
   /// The queue for jobs that are not yet in flight.
-  Queue<Job> new_jobs_;
+  WorkStealingQueue<Job> new_jobs_;
   /// The number of in-flight jobs.
   /// NOTE: Not atomic because only manipulated by the main thread.
   size_t in_flight_jobs_ = 0;
@@ -2,6 +2,8 @@
 
 #include <torch/types.h>
 
+#include <c10/util/Exception.h>
+
 #include <algorithm>
 #include <cstddef>
 #include <vector>
@@ -107,6 +109,90 @@ struct OrderedSequencer : public Sequencer<Result> {
   /// A fixed-size buffer (after construction).
   std::vector<optional<Result>> buffer_;
 };
+
+/// A `Sequencer` that only bounds how far out of order results are returned.
+/// Let `s` be the lowest sequence number not yet returned. Any result with a
+/// sequence number in `[s, s + window)` is returned as soon as it is received,
+/// while results further ahead are buffered until `s` catches up. A window of
+/// one is equivalent to the `OrderedSequencer`.
+///
+/// Implementation note: At most `m` (the maximum number of jobs) results are
+/// in flight or buffered at any point, and all of them have a sequence number
+/// of at least `s`. Between `s` and the highest sequence number scheduled,
+/// fewer than `window` results can have been returned, since each one was
+/// within the window at the time. Sequence numbers that are still relevant
+/// thus span less than `m + window` values, which is the size of the buffers.
+template <typename Result>
+struct WindowedSequencer : public Sequencer<Result> {
+  using typename Sequencer<Result>::ResultProducer;
+
+  /// Constructs the `WindowedSequencer` with the size of the reorder `window`
+  /// and the maximum number of jobs in flight.
+  WindowedSequencer(size_t window, size_t max_jobs)
+      : window_(window),
+        buffer_(window + max_jobs),
+        returned_(window + max_jobs, false) {
+    AT_CHECK(window > 0, "The reorder window must be at least one");
+  }
+
+  /// Returns the first result within the window, buffering any received
+  /// results that are ahead of it.
+  optional<Result> next(ResultProducer next_result) override {
+    // Buffered results may have moved into the window since the last call.
+    for (size_t s = next_sequence_number_; s < next_sequence_number_ + window_;
+         ++s) {
+      if (auto& maybe_result = buffer(s)) {
+        auto result = std::move(maybe_result);
+        maybe_result.reset();
+        mark_returned(s);
+        return result;
+      }
+    }
+    while (true) {
+      auto result = next_result();
+      if (!result) {
+        AT_ASSERT(!detail::buffer_contains_result(buffer_));
+        break;
+      }
+      const auto sequence_number = result->sequence_number;
+      AT_ASSERT(sequence_number >= next_sequence_number_);
+      if (sequence_number < next_sequence_number_ + window_) {
+        mark_returned(sequence_number);
+        return result;
+      }
+      AT_ASSERT(!buffer(sequence_number).has_value());
+      buffer(sequence_number) = std::move(result);
+    }
+    return nullopt;
+  }
+
+  /// Accesses the buffer at the `index` modulo the buffer size.
+  optional<Result>& buffer(size_t index) {
+    return buffer_.at(index % buffer_.size());
+  }
+
+  /// Records that the result with `sequence_number` was returned, and advances
+  /// the lowest sequence number not yet returned.
+  void mark_returned(size_t sequence_number) {
+    returned_.at(sequence_number % returned_.size()) = true;
+    while (returned_.at(next_sequence_number_ % returned_.size())) {
+      returned_.at(next_sequence_number_++ % returned_.size()) = false;
+    }
+  }
+
+  /// The size of the reorder window.
+  size_t window_;
+
+  /// The lowest sequence number not yet returned.
+  size_t next_sequence_number_ = 0;
+
+  /// Results ahead of the window.
+  std::vector<optional<Result>> buffer_;
+
+  /// Whether the result with a sequence number was returned already, for
+  /// sequence numbers at or after `next_sequence_number_`.
+  std::vector<bool> returned_;
+};
 } // namespace sequencers
 } // namespace detail
 } // namespace data
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Describes where the tensors of a batch should live once a worker is done
+/// with it. If `pin_memory` is set, tensors are first copied into page-locked
+/// host memory, which comes from the caching host allocator when PyTorch is
+/// built with CUDA. Copies to a CUDA `device` from such memory are then issued
+/// with `non_blocking=true`, so that the worker thread only enqueues them on
+/// the current stream of the device and the transfer overlaps with whatever
+/// the main thread is doing. Since the copy is ordered on the stream before any
+/// work the consumer enqueues afterwards, no further synchronization is needed.
+struct BatchTransfer {
+  /// Returns true if batches have to be touched at all.
+  bool enabled() const noexcept {
+    return pin_memory || device.has_value();
+  }
+
+  Tensor operator()(Tensor tensor) const {
+    if (!tensor.defined()) {
+      return tensor;
+    }
+    const bool to_device = device.has_value() && tensor.device() != *device;
+    if (pin_memory && tensor.device().is_cpu() &&
+        (!to_device || !device->is_cpu())) {
+      tensor = tensor.pin_memory();
+    }
+    if (to_device) {
+      tensor = tensor.to(
+          tensor.options().device(*device), /*non_blocking=*/pin_memory);
+    }
+    return tensor;
+  }
+
+  template <typename Data, typename Target>
+  Example<Data, Target> operator()(Example<Data, Target> example) const {
+    return {(*this)(std::move(example.data)),
+            (*this)(std::move(example.target))};
+  }
+
+  template <typename Data>
+  Example<Data, example::NoTarget> operator()(
+      Example<Data, example::NoTarget> example) const {
+    return {(*this)(std::move(example.data))};
+  }
+
+  template <typename T>
+  std::vector<T> operator()(std::vector<T> batch) const {
+    for (auto& element : batch) {
+      element = (*this)(std::move(element));
+    }
+    return batch;
+  }
+
+  template <typename T>
+  optional<T> operator()(optional<T> batch) const {
+    if (batch) {
+      batch = (*this)(std::move(*batch));
+    }
+    return batch;
+  }
+
+  /// Anything that is neither a tensor nor holds tensors is left untouched.
+  template <typename T>
+  T operator()(T value) const {
+    return value;
+  }
+
+  optional<Device> device;
+  bool pin_memory = false;
+};
+
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <torch/types.h>
+
+#include <torch/csrc/utils/memory.h>
+
+#include <c10/util/Exception.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// A blocking queue that distributes its elements over one deque per
+/// consumer.
+///
+/// Elements are pushed round-robin to the deques of the consumers, each of
+/// which is guarded by its own mutex, so that consumers do not contend on a
+/// single lock. A consumer first pops from its own deque and, if that is empty,
+/// steals from the deques of the other consumers. Only consumers that find
+/// every deque empty go to sleep on a shared condition variable.
+///
+/// Both owners and thieves take elements from the front of the deques: the
+/// oldest jobs are the ones an ordered `DataLoader` waits for first.
+///
+/// Note that this data structure is written specifically for use with the
+/// `DataLoader`. It supports a single producer (the main thread) only.
+template <typename T>
+class WorkStealingQueue {
+ public:
+  /// Constructs the queue with one deque for each of `consumers` consumers.
+  explicit WorkStealingQueue(size_t consumers = 1) {
+    AT_CHECK(consumers > 0, "WorkStealingQueue needs at least one consumer");
+    deques_.reserve(consumers);
+    for (size_t c = 0; c < consumers; ++c) {
+      deques_.push_back(torch::make_unique<LockedDeque>());
+    }
+  }
+
+  /// Pushes a new value to the back of the deque of the next consumer and
+  /// wakes up one waiting consumer, if any.
+  void push(T value) {
+    auto& deque = *deques_[next_deque_];
+    next_deque_ = (next_deque_ + 1) % deques_.size();
+    {
+      std::lock_guard<std::mutex> lock(deque.mutex);
+      deque.values.push_back(std::move(value));
+      ++size_;
+    }
+    {
+      // Taking the lock orders the notification after the check of `size_` in
+      // any consumer that is about to wait.
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+    }
+    cv_.notify_one();
+  }
+
+  /// Blocks until an element could be popped, from the deque of `consumer`
+  /// or, failing that, from the deque of any other consumer.
+  T pop(size_t consumer = 0) {
+    AT_ASSERT(consumer < deques_.size());
+    while (true) {
+      for (size_t offset = 0; offset < deques_.size(); ++offset) {
+        auto& deque = *deques_[(consumer + offset) % deques_.size()];
+        std::lock_guard<std::mutex> lock(deque.mutex);
+        if (!deque.values.empty()) {
+          T value = std::move(deque.values.front());
+          deque.values.pop_front();
+          --size_;
+          return value;
+        }
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      cv_.wait(lock, [this] { return this->size_ > 0; });
+    }
+  }
+
+  /// Empties all deques and returns the number of elements that were removed.
+  /// No threads are notified about this event as it is assumed to be used to
+  /// drain the queue during shutdown of a `DataLoader`.
+  size_t clear() {
+    size_t cleared = 0;
+    for (auto& deque : deques_) {
+      std::lock_guard<std::mutex> lock(deque->mutex);
+      cleared += deque->values.size();
+      size_ -= deque->values.size();
+      deque->values.clear();
+    }
+    return cleared;
+  }
+
+  /// Returns the number of consumers (and deques) of the queue.
+  size_t consumers() const noexcept {
+    return deques_.size();
+  }
+
+ private:
+  struct LockedDeque {
+    std::deque<T> values;
+    std::mutex mutex;
+  };
+
+  /// One deque per consumer. Held by pointer since mutexes cannot be moved.
+  std::vector<std::unique_ptr<LockedDeque>> deques_;
+  /// The deque the next pushed element goes to. Only touched by the producer.
+  size_t next_deque_ = 0;
+  /// The total number of elements in all deques. Only modified while holding
+  /// the mutex of the deque that changes.
+  std::atomic<size_t> size_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable cv_;
+};
+} // namespace detail
+} // namespace data
+} // namespace torch
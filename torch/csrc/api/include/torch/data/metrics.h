@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace torch {
+namespace data {
+
+/// A histogram of durations that can be updated from many threads at once
+/// without locking. Durations are counted in power-of-two buckets of
+/// microseconds, so quantiles are only known up to a factor of two.
+class DurationHistogram {
+ public:
+  /// Bucket 0 counts durations below one microsecond, bucket `i > 0` those in
+  /// `[2^(i-1), 2^i)` microseconds. The last bucket also counts all longer
+  /// durations.
+  static constexpr size_t kBuckets = 32;
+
+  DurationHistogram() {
+    reset();
+  }
+
+  /// Adds one `duration` to the histogram.
+  template <typename Duration>
+  void record(Duration duration) {
+    const uint64_t ns = std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+        0);
+    size_t bucket = 0;
+    for (uint64_t us = ns / 1000; us > 0 && bucket + 1 < kBuckets; us >>= 1) {
+      ++bucket;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max &&
+           !max_ns_.compare_exchange_weak(
+               max, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  /// Returns the number of recorded durations.
+  uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  /// Returns the sum of all recorded durations.
+  std::chrono::nanoseconds total() const {
+    return std::chrono::nanoseconds(total_ns_.load(std::memory_order_relaxed));
+  }
+
+  /// Returns the mean of the recorded durations, or zero if there are none.
+  std::chrono::nanoseconds mean() const {
+    const auto n = count();
+    return n == 0 ? std::chrono::nanoseconds(0)
+                  : total() / static_cast<int64_t>(n);
+  }
+
+  /// Returns the longest recorded duration.
+  std::chrono::nanoseconds max() const {
+    return std::chrono::nanoseconds(max_ns_.load(std::memory_order_relaxed));
+  }
+
+  /// Returns an upper bound of the `q` quantile (e.g. 0.99) of the recorded
+  /// durations, i.e. the upper end of the bucket the quantile falls into.
+  std::chrono::microseconds quantile(double q) const {
+    const auto counts = buckets();
+    uint64_t total = 0;
+    for (const auto c : counts) {
+      total += c;
+    }
+    const double target = q * total;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; ++i) {
+      seen += counts[i];
+      if (seen > 0 && seen >= target) {
+        return std::chrono::microseconds(int64_t(1) << i);
+      }
+    }
+    return std::chrono::microseconds(0);
+  }
+
+  /// Returns the number of durations counted in each bucket.
+  std::vector<uint64_t> buckets() const {
+    std::vector<uint64_t> counts(kBuckets);
+    for (size_t i = 0; i < kBuckets; ++i) {
+      counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return counts;
+  }
+
+  /// Forgets all recorded durations.
+  void reset() {
+    for (auto& bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    total_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, kBuckets> buckets_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> total_ns_;
+  std::atomic<uint64_t> max_ns_;
+};
+
+/// Prints the count, mean, median, 99th percentile and maximum of `histogram`.
+inline std::ostream& operator<<(
+    std::ostream& stream,
+    const DurationHistogram& histogram) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  return stream << "count=" << histogram.count()
+                << " mean=" << duration_cast<microseconds>(histogram.mean()).count()
+                << "us p50<=" << histogram.quantile(0.5).count()
+                << "us p99<=" << histogram.quantile(0.99).count()
+                << "us max=" << duration_cast<microseconds>(histogram.max()).count()
+                << "us";
+}
+
+/// How a DataLoader worker thread spent its time.
+struct WorkerMetrics {
+  WorkerMetrics() {
+    reset();
+  }
+
+  /// Time spent fetching and transferring batches.
+  std::chrono::nanoseconds busy() const {
+    return std::chrono::nanoseconds(busy_ns.load(std::memory_order_relaxed));
+  }
+
+  /// Time spent waiting for jobs.
+  std::chrono::nanoseconds idle() const {
+    return std::chrono::nanoseconds(idle_ns.load(std::memory_order_relaxed));
+  }
+
+  void reset() {
+    busy_ns.store(0, std::memory_order_relaxed);
+    idle_ns.store(0, std::memory_order_relaxed);
+    batches.store(0, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> busy_ns;
+  std::atomic<uint64_t> idle_ns;
+  /// The number of batches the worker produced.
+  std::atomic<uint64_t> batches;
+};
+
+/// Timings of the stages a batch goes through in a DataLoader, collected
+/// since the DataLoader was created (or its metrics were last reset). They
+/// show whether the consumer is starved, and if so by which stage.
+struct DataLoaderMetrics {
+  explicit DataLoaderMetrics(size_t workers) : workers(workers) {}
+
+  /// Time jobs spent queued before a worker started on them.
+  DurationHistogram queue_wait;
+  /// Time spent in the dataset's `get_batch()`, i.e. reading, decoding and
+  /// collating the examples of a batch.
+  DurationHistogram fetch;
+  /// Time spent moving batches to pinned memory or the target device.
+  DurationHistogram transfer;
+  /// Time the consumer spent blocked in the DataLoader waiting for the next
+  /// batch (or, without workers, loading it).
+  DurationHistogram next_wait;
+  /// One entry per worker thread.
+  std::vector<WorkerMetrics> workers;
+
+  void reset() {
+    queue_wait.reset();
+    fetch.reset();
+    transfer.reset();
+    next_wait.reset();
+    for (auto& worker : workers) {
+      worker.reset();
+    }
+  }
+};
+
+inline std::ostream& operator<<(
+    std::ostream& stream,
+    const DataLoaderMetrics& metrics) {
+  using std::chrono::duration_cast;
+  using std::chrono::milliseconds;
+  stream << "queue_wait: " << metrics.queue_wait << "\n"
+         << "fetch: " << metrics.fetch << "\n"
+         << "transfer: " << metrics.transfer << "\n"
+         << "next_wait: " << metrics.next_wait;
+  for (size_t w = 0; w < metrics.workers.size(); ++w) {
+    const auto& worker = metrics.workers[w];
+    stream << "\nworker " << w
+           << ": batches=" << worker.batches.load(std::memory_order_relaxed)
+           << " busy=" << duration_cast<milliseconds>(worker.busy()).count()
+           << "ms idle=" << duration_cast<milliseconds>(worker.idle()).count()
+           << "ms";
+  }
+  return stream;
+}
+
+/// Timings of the chunk preloading of a `ChunkDataset`, collected since the
+/// dataset was created (or its metrics were last reset).
+struct ChunkDatasetMetrics {
+  /// Time from starting to read a chunk until a preloader had its data.
+  DurationHistogram chunk_read;
+  /// Time preloaders blocked because the batch cache was full.
+  DurationHistogram preloader_stall;
+  /// Time `get_batch()` blocked until the batch cache held a full batch.
+  DurationHistogram batch_wait;
+
+  void reset() {
+    chunk_read.reset();
+    preloader_stall.reset();
+    batch_wait.reset();
+  }
+};
+
+inline std::ostream& operator<<(
+    std::ostream& stream,
+    const ChunkDatasetMetrics& metrics) {
+  return stream << "chunk_read: " << metrics.chunk_read << "\n"
+                << "preloader_stall: " << metrics.preloader_stall << "\n"
+                << "batch_wait: " << metrics.batch_wait;
+}
+
+} // namespace data
+} // namespace torch
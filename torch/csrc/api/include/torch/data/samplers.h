@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/data/samplers/base.h>
+#include <torch/data/samplers/bucket.h>
 #include <torch/data/samplers/custom_batch_request.h>
 #include <torch/data/samplers/distributed.h>
 #include <torch/data/samplers/random.h>
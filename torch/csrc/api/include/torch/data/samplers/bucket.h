@@ -0,0 +1,85 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/data/samplers/distributed.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace torch {
+namespace serialize {
+class OutputArchive;
+class InputArchive;
+} // namespace serialize
+} // namespace torch
+
+namespace torch {
+namespace data {
+namespace samplers {
+
+/// A `Sampler` that batches together examples of similar length, to reduce
+/// the padding of batches of variable length sequences.
+///
+/// At each `reset()`, the indices are shuffled with the epoch as the seed, and
+/// cut into buckets of `bucket_size` examples (all of them if `bucket_size` is
+/// zero) that are sorted by length. The batches are cut from the buckets, and
+/// it is their order that is shuffled, so a batch never mixes examples of
+/// different buckets. A batch holds at most `batch_size` examples and, if
+/// `max_tokens` is not zero, at most `max_tokens` tokens once padded to its
+/// longest example (an example longer than that is a batch on its own). The
+/// indices of a batch are sorted by decreasing length, so that the padded
+/// batch can be packed with `torch::_pack_padded_sequence` without sorting.
+///
+/// In a distributed setting, every replica cuts the same batches, and takes
+/// every `num_replicas`-th one after `rank`, so that the replicas run the same
+/// number of steps: with `allow_duplicates`, the first batches are repeated to
+/// make up the batches of the last replicas, otherwise the last batches are
+/// dropped.
+///
+/// The same `batch_size` must be passed to every call to `next()` before the
+/// next `reset()`, which is the case in a `DataLoader`.
+class TORCH_API BucketBatchSampler : public DistributedSampler<> {
+ public:
+  /// Constructs a `BucketBatchSampler` from the length, e.g. the number of
+  /// tokens, of every example of the dataset.
+  explicit BucketBatchSampler(
+      std::vector<size_t> lengths,
+      size_t max_tokens = 0,
+      size_t bucket_size = 0,
+      size_t num_replicas = 1,
+      size_t rank = 0,
+      bool allow_duplicates = true);
+
+  /// Resets the `BucketBatchSampler` to a new shuffle of the batches. The size
+  /// of the dataset can't change, since it is given by the lengths.
+  void reset(optional<size_t> new_size = nullopt) override;
+
+  /// Returns the next batch of at most `batch_size` indices.
+  optional<std::vector<size_t>> next(size_t batch_size) override;
+
+  /// Serializes the `BucketBatchSampler` to the `archive`.
+  void save(serialize::OutputArchive& archive) const override;
+
+  /// Deserializes the `BucketBatchSampler` from the `archive`.
+  void load(serialize::InputArchive& archive) override;
+
+  /// Returns the number of batches this replica returned since the last
+  /// `reset()`.
+  size_t index() const noexcept;
+
+ private:
+  /// Cuts the batches of the current epoch, and selects those of this replica.
+  void populate_batches(size_t batch_size);
+
+  std::vector<size_t> lengths_;
+  size_t max_tokens_;
+  size_t bucket_size_;
+  // The batch size the batches were cut with, zero until the first `next()`.
+  size_t batch_size_;
+  size_t batch_index_;
+  std::vector<std::vector<size_t>> batches_;
+};
+
+} // namespace samplers
+} // namespace data
+} // namespace torch
@@ -3,7 +3,9 @@
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/data/samplers/base.h>
 
+#include <array>
 #include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace torch {
@@ -96,6 +98,54 @@ class TORCH_API DistributedRandomSampler : public DistributedSampler<> {
   std::vector<size_t> all_indices_;
 };
 
+/// Select samples randomly, like `DistributedRandomSampler`, without storing
+/// the indices. The shuffled index at a position is computed when it is
+/// sampled, by a Feistel network keyed by the seed and the epoch, so the
+/// sampler uses constant memory whatever the size of the dataset, and resumes
+/// from a saved position without replaying the epoch.
+class TORCH_API DistributedFeistelSampler : public DistributedSampler<> {
+ public:
+  DistributedFeistelSampler(
+      size_t size,
+      size_t num_replicas = 1,
+      size_t rank = 0,
+      bool allow_duplicates = true,
+      uint64_t seed = 0);
+
+  /// Resets the `DistributedFeistelSampler` to a new shuffle of the indices.
+  void reset(optional<size_t> new_size = nullopt) override;
+
+  /// Returns the next batch of indices.
+  optional<std::vector<size_t>> next(size_t batch_size) override;
+
+  /// Serializes the `DistributedFeistelSampler` to the `archive`.
+  void save(serialize::OutputArchive& archive) const override;
+
+  /// Deserializes the `DistributedFeistelSampler` from the `archive`.
+  void load(serialize::InputArchive& archive) override;
+
+  /// Returns the current index of the `DistributedFeistelSampler`.
+  size_t index() const noexcept;
+
+ private:
+  static constexpr size_t kRounds = 6;
+
+  void populate_indices();
+
+  /// Returns the shuffled index at a position of the whole epoch.
+  size_t shuffled_index(size_t position) const;
+
+  uint64_t seed_;
+  size_t begin_index_;
+  size_t end_index_;
+  size_t sample_index_;
+  // The number of samples of all the replicas, duplicates included.
+  size_t sample_count_;
+  // The Feistel network permutes the 2 * half_bits_ bit integers.
+  size_t half_bits_;
+  std::array<uint64_t, kRounds> keys_;
+};
+
 /// Select samples sequentially.
 class TORCH_API DistributedSequentialSampler : public DistributedSampler<> {
  public:
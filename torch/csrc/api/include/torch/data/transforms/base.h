@@ -2,6 +2,9 @@
 
 #include <torch/types.h>
 
+#include <c10/util/C++17.h>
+
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -28,6 +31,12 @@ class BatchTransform {
 /// `BatchTransform` that can operate on the level of individual examples rather
 /// than entire batches. The batch-level transform is implemented (by default)
 /// in terms of the example-level transform, though this can be customized.
+///
+/// A `Transform` may declare `static constexpr bool is_batchwise = true` if
+/// `apply()` can also be called on an example whose tensors are a stacked batch
+/// of examples, with the same result as stacking the transformed examples.
+/// Batches of datasets that support stacked batches are then transformed in one
+/// call instead of once per example.
 template <typename Input, typename Output>
 class Transform
     : public BatchTransform<std::vector<Input>, std::vector<Output>> {
@@ -48,6 +57,16 @@ class Transform
     return output_batch;
   }
 };
+
+namespace detail {
+/// True if the transform `T` declares that it can be applied to stacked
+/// batches.
+template <typename T, typename = void>
+struct is_batchwise : std::false_type {};
+template <typename T>
+struct is_batchwise<T, c10::guts::void_t<decltype(T::is_batchwise)>>
+    : std::integral_constant<bool, T::is_batchwise> {};
+} // namespace detail
 } // namespace transforms
 } // namespace data
 } // namespace torch
@@ -4,20 +4,40 @@
 #include <torch/data/transforms/collate.h>
 #include <torch/types.h>
 
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace torch {
 namespace data {
 namespace transforms {
+namespace detail {
+/// Stacks `tensors` along a new first dimension, directly into page-locked
+/// memory if `pin_memory` is true.
+inline Tensor stack(const std::vector<Tensor>& tensors, bool pin_memory) {
+  if (!pin_memory || tensors.empty()) {
+    return torch::stack(tensors);
+  }
+  auto sizes = tensors.front().sizes().vec();
+  sizes.insert(sizes.begin(), tensors.size());
+  auto output =
+      torch::empty(sizes, tensors.front().options().pinned_memory(true));
+  return torch::stack_out(output, tensors);
+}
+} // namespace detail
 
 template <typename T = Example<>>
 struct Stack;
 
 /// A `Collation` for `Example<Tensor, Tensor>` types that stacks all data
 /// tensors into one tensor, and all target (label) tensors into one tensor.
+///
+/// If `pin_memory` is true, the stacked tensors are allocated in page-locked
+/// memory, from which they can be copied to CUDA asynchronously.
 template <>
 struct Stack<Example<>> : public Collation<Example<>> {
+  explicit Stack(bool pin_memory = false) : pin_memory(pin_memory) {}
+
   Example<> apply_batch(std::vector<Example<>> examples) override {
     std::vector<torch::Tensor> data, targets;
     data.reserve(examples.size());
@@ -26,8 +46,11 @@ struct Stack<Example<>> : public Collation<Example<>> {
       data.push_back(std::move(example.data));
       targets.push_back(std::move(example.target));
     }
-    return {torch::stack(data), torch::stack(targets)};
+    return {detail::stack(data, pin_memory),
+            detail::stack(targets, pin_memory)};
   }
+
+  bool pin_memory;
 };
 
 /// A `Collation` for `Example<Tensor, NoTarget>` types that stacks all data
@@ -35,15 +58,27 @@ struct Stack<Example<>> : public Collation<Example<>> {
 template <>
 struct Stack<TensorExample>
     : public Collation<Example<Tensor, example::NoTarget>> {
+  explicit Stack(bool pin_memory = false) : pin_memory(pin_memory) {}
+
   TensorExample apply_batch(std::vector<TensorExample> examples) override {
     std::vector<torch::Tensor> data;
     data.reserve(examples.size());
     for (auto& example : examples) {
       data.push_back(std::move(example.data));
     }
-    return torch::stack(data);
+    return detail::stack(data, pin_memory);
   }
+
+  bool pin_memory;
 };
+
+namespace detail {
+/// True if `T` is one of the `Stack` collations.
+template <typename T>
+struct is_stack : std::false_type {};
+template <typename E>
+struct is_stack<Stack<E>> : std::true_type {};
+} // namespace detail
 } // namespace transforms
 } // namespace data
 } // namespace torch
@@ -55,6 +55,9 @@ class TensorLambda : public TensorTransform<Target> {
 /// the given standard deviation.
 template <typename Target = Tensor>
 struct Normalize : public TensorTransform<Target> {
+  /// The mean and standard deviation broadcast over batches just as well.
+  static constexpr bool is_batchwise = true;
+
   /// Constructs a `Normalize` transform. The mean and standard deviation can be
   /// anything that is broadcastable over the input tensors (like single
   /// scalars).
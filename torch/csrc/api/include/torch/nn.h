@@ -2,6 +2,8 @@
 
 #include <torch/nn/cloneable.h>
 #include <torch/nn/init.h>
+#include <torch/nn/mixed_precision.h>
 #include <torch/nn/module.h>
 #include <torch/nn/modules.h>
 #include <torch/nn/pimpl.h>
+#include <torch/nn/utils.h>
@@ -40,6 +40,9 @@ class Cloneable : public virtual Module {
     copy->parameters_.clear();
     copy->buffers_.clear();
     copy->children_.clear();
+    copy->flat_parameters_.clear();
+    copy->flat_gradients_.clear();
+    copy->parameters_flattened_ = false;
     copy->reset();
     AT_CHECK(
         copy->parameters_.size() == parameters_.size(),
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <torch/arg.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/nn/module.h>
+#include <torch/types.h>
+
+#include <functional>
+
+namespace torch {
+namespace nn {
+
+/// Options for `to_mixed_precision()`, which decide in which dtype the
+/// parameters and buffers of each module are kept.
+struct TORCH_API MixedPrecisionOptions {
+  /// The reduced precision dtype to convert to.
+  TORCH_ARG(Dtype, dtype) = kHalf;
+  /// Keeps `BatchNorm` modules in fp32, since their running statistics and
+  /// the variance they divide by lose too much precision in half. Their
+  /// CUDA kernels accept half inputs with fp32 parameters.
+  TORCH_ARG(bool, keep_batchnorm_fp32) = true;
+  /// Keeps the modules for which this returns true in fp32, in addition to the
+  /// `BatchNorm` modules.
+  TORCH_ARG(std::function<bool(const Module&)>, keep_fp32) = nullptr;
+};
+
+/// Converts the floating point parameters and buffers of `module` and of all
+/// its submodules to `options.dtype()`, except those of the modules that
+/// `options` keeps in fp32, which are converted to fp32. This is the usual
+/// casting policy of mixed precision training; pair it with
+/// `OptimizerBase::use_master_weights()` and `optim::GradScaler`.
+///
+/// Must be called before `Module::flatten_parameters()`.
+TORCH_API void to_mixed_precision(
+    Module& module,
+    const MixedPrecisionOptions& options = {});
+
+} // namespace nn
+} // namespace torch
@@ -300,8 +300,37 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
   virtual void to(torch::Device device, bool non_blocking = false);
 
   /// Recursively zeros out the `grad` value of each registered parameter.
+  ///
+  /// After `flatten_parameters()`, this zeros each buffer of
+  /// `flat_gradients()` at once, and only the gradients which are no longer
+  /// views of these buffers one by one, instead of calling `zero_grad()` on
+  /// the submodules.
   virtual void zero_grad();
 
+  /// Moves the parameters of this `Module` and of its submodules (recursively)
+  /// into one contiguous buffer per device and dtype, and makes every
+  /// parameter a view of its buffer. The gradients of the parameters that
+  /// require gradients likewise become views of zeroed gradient buffers, into
+  /// which the backward pass accumulates.
+  ///
+  /// The buffers of `flat_parameters()`, whose `grad()` is the matching buffer
+  /// of `flat_gradients()`, can then be given to an optimizer or reduced
+  /// across processes to update or reduce all the parameters with a few large
+  /// operations. Note that every parameter that requires gradients now has a
+  /// gradient, if only zeros, and that an optimizer which replaces the
+  /// gradients (e.g. when applying weight decay) breaks their sharing.
+  ///
+  /// Moving this `Module` with `to()` undoes the flattening.
+  void flatten_parameters();
+
+  /// The parameter buffers made by the last `flatten_parameters()`, one per
+  /// device and dtype, or nothing if the parameters aren't flattened.
+  const std::vector<Tensor>& flat_parameters() const noexcept;
+
+  /// The gradient buffers made by the last `flatten_parameters()`, matching
+  /// `flat_parameters()`.
+  const std::vector<Tensor>& flat_gradients() const noexcept;
+
   /// Attempts to cast this `Module` to the given `ModuleType`.
   ///
   /// This method is useful when calling `apply()`.
@@ -519,6 +548,15 @@ class TORCH_API Module : public std::enable_shared_from_this<Module> {
   /// The registered (direct) submodules of this `Module`.
   OrderedDict<std::string, std::shared_ptr<Module>> children_;
 
+  /// The buffers of `flatten_parameters()`, if it was called on this `Module`.
+  std::vector<Tensor> flat_parameters_;
+  std::vector<Tensor> flat_gradients_;
+
+  /// Whether the parameters of this `Module` are views of the buffers of a
+  /// `flatten_parameters()` call on it or on a parent, so that loading them
+  /// must copy into them rather than replace their storage.
+  bool parameters_flattened_ = false;
+
   /// The module's name (e.g. "LSTM").
   mutable optional<std::string> name_;
 
@@ -597,6 +635,9 @@ void Module::to_impl(Ts&&... ts) {
   for (auto& buffer : buffers_) {
     buffer->set_data(autograd::Variable(*buffer).data().to(ts...));
   }
+  flat_parameters_.clear();
+  flat_gradients_.clear();
+  parameters_flattened_ = false;
 }
 
 } // namespace nn
@@ -6,6 +6,8 @@
 #include <torch/types.h>
 
 #include <torch/csrc/autograd/functions/comm.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/variable.h>
 #ifdef USE_CUDA
 #include <torch/csrc/cuda/comm.h>
 #endif
@@ -13,13 +15,19 @@
 
 #include <ATen/Device.h>
 #include <ATen/Parallel.h>
+#include <c10/core/DeviceGuard.h>
 #include <c10/core/TensorOptions.h>
 #include <c10/util/Exception.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <exception>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace torch {
@@ -54,10 +62,93 @@ std::vector<ModuleHolder<ModuleType>> replicate(
   return std::vector<ModuleHolder<ModuleType>>(ptrs.begin(), ptrs.end());
 }
 
+namespace detail {
+/// Calls `function(index)` for every index in `[0, count)` concurrently, on the
+/// inter-op thread pool of ATen (see `at::launch()`), which persists across
+/// calls. The calling thread runs indices too, so that the call makes progress
+/// even when all the threads of the pool are busy. Every call runs with the
+/// grad mode of the caller.
+///
+/// The first exception thrown by any call is stashed and rethrown after all
+/// calls have completed.
+inline void parallel_invoke(
+    size_t count,
+    const std::function<void(size_t)>& function) {
+  if (count == 0) {
+    return;
+  }
+
+  struct State {
+    std::atomic<size_t> next{0};
+    size_t count = 0;
+    size_t completed = 0;
+    std::mutex mutex;
+    std::condition_variable all_completed;
+    // std::exception_ptr can be passed between threads:
+    // > An instance of std::exception_ptr may be passed to another function,
+    // > possibly on another thread, where the exception may be rethrown [...].
+    // https://en.cppreference.com/w/cpp/error/exception_ptr
+    std::exception_ptr exception;
+  };
+  auto state = std::make_shared<State>();
+  state->count = count;
+  const bool grad_mode = autograd::GradMode::is_enabled();
+
+  // A task of the pool that starts after the caller claimed every index only
+  // touches `state`, which it keeps alive; `function` is only called for the
+  // claimed indices, which the caller waits for.
+  const std::function<void()> run = [state, grad_mode, &function]() {
+    autograd::AutoGradMode grad_mode_guard(grad_mode);
+    for (size_t index = state->next++; index < state->count;
+         index = state->next++) {
+      std::exception_ptr exception;
+      try {
+        function(index);
+      } catch (...) {
+        exception = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (exception && !state->exception) {
+        state->exception = exception;
+      }
+      if (++state->completed == state->count) {
+        state->all_completed.notify_all();
+      }
+    }
+  };
+  for (size_t task = 1; task < count; ++task) {
+    at::launch(run);
+  }
+  run();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->all_completed.wait(
+      lock, [&state] { return state->completed == state->count; });
+  if (state->exception) {
+    std::rethrow_exception(state->exception);
+  }
+}
+
+/// Returns all the available CUDA devices.
+inline std::vector<Device> cuda_devices() {
+  const auto device_count = torch::cuda::device_count();
+  AT_CHECK(
+      device_count > 0, "Expected at least one CUDA device to be available");
+  std::vector<Device> devices;
+  devices.reserve(device_count);
+  for (size_t index = 0; index < device_count; ++index) {
+    devices.emplace_back(kCUDA, index);
+  }
+  return devices;
+}
+} // namespace detail
+
 /// Applies the given inputs to the given modules in a parallel fashion.
 /// Conceptually, a thread is spawned for each `(module, input)` pair, in which
 /// `forward()` is called on the module with its corresponding input. The
-/// outputs of the individual calls are stored in a vector and returned.
+/// outputs of the individual calls are stored in a vector and returned. The
+/// threads are taken from the inter-op thread pool, so no thread is created
+/// per call.
 ///
 /// The first exception caught by any thread is stashed and rethrown after all
 /// threads have completed their operation.
@@ -82,88 +173,209 @@ std::vector<Tensor> parallel_apply(
   }
 
   std::vector<Tensor> outputs(modules.size());
-  std::mutex mutex;
-
-  // std::exception_ptr can be passed between threads:
-  // > An instance of std::exception_ptr may be passed to another function,
-  // > possibly on another thread, where the exception may be rethrown [...].
-  // https://en.cppreference.com/w/cpp/error/exception_ptr
-  std::exception_ptr exception;
-
-  at::parallel_for(
-      /*begin=*/0,
-      /*end=*/modules.size(),
-      /*grain_size=*/1,
-      [&modules, &inputs, &devices, &outputs, &mutex, &exception](
-          int64_t index, int64_t stop) {
-        for (; index < stop; ++index) {
-          try {
-            auto output = modules[index]->forward(inputs[index]);
-            output =
-                output.to(devices ? (*devices)[index] : inputs[index].device());
-            std::lock_guard<std::mutex> lock(mutex);
-            outputs[index] = output;
-          } catch (...) {
-            std::lock_guard<std::mutex> lock(mutex);
-            if (!exception) {
-              exception = std::current_exception();
-            }
-          }
+  detail::parallel_invoke(
+      modules.size(), [&modules, &inputs, &devices, &outputs](size_t index) {
+        c10::OptionalDeviceGuard device_guard;
+        if (devices && (*devices)[index].is_cuda()) {
+          device_guard.reset_device((*devices)[index]);
         }
+        auto output = modules[index]->forward(inputs[index]);
+        outputs[index] =
+            output.to(devices ? (*devices)[index] : inputs[index].device());
       });
+  return outputs;
+}
 
-  if (exception) {
-    std::rethrow_exception(exception);
+/// Replicas of a module on a list of devices, which are kept across calls of
+/// `data_parallel()`.
+///
+/// The first call of `replicas()` replicates the module with `replicate()`.
+/// Later calls only copy the parameters and buffers of the module whose data or
+/// version changed since the previous call (e.g. by an optimizer step) into
+/// the replicas, without cloning the module again. When the module and the
+/// replicas are on CUDA devices, the module being on the first of them, the
+/// tensors are broadcast together with `torch::cuda::broadcast_coalesced()`.
+/// The replicas on the first device then share the data of the module.
+///
+/// The module must keep the same structure, i.e. the same parameters and
+/// buffers, between calls; call `clear()` after changing it.
+template <typename ModuleType>
+class ReplicaCache {
+ public:
+  using Replicas = decltype(replicate(
+      std::declval<const ModuleType&>(),
+      std::declval<const std::vector<Device>&>()));
+
+  /// The size of the buffers the tensors are coalesced into for a broadcast.
+  static constexpr size_t kBroadcastBufferSize = 10 * 1024 * 1024;
+
+  /// Caches replicas of `module` on `devices`, or on all available CUDA
+  /// devices if `devices` is not supplied.
+  explicit ReplicaCache(
+      ModuleType module,
+      optional<std::vector<Device>> devices = nullopt)
+      : module_(std::move(module)),
+        devices_(devices ? std::move(*devices) : detail::cuda_devices()) {
+    AT_CHECK(!devices_.empty(), "Expected at least one device");
   }
 
-  return outputs;
-}
+  /// Returns the replicas, up to date with the module.
+  Replicas& replicas() {
+    const auto sources = state_of(*module_);
+    if (replicas_.empty() || sources.size() != versions_.size()) {
+      replicas_ = replicate(module_, devices_);
+      record(sources);
+      return replicas_;
+    }
 
-/// Evaluates `module(input)` in parallel across the given `devices`. If
-/// `devices` is not supplied, the invocation is parallelized across all
-/// available CUDA devices. If `output_device` is supplied, the final, combined
-/// tensor will be placed on this device. If not, it defaults to the first
-/// device in `devices`.
+    std::vector<size_t> stale;
+    std::vector<Tensor> data;
+    for (size_t index = 0; index < sources.size(); ++index) {
+      autograd::Variable source(sources[index]);
+      if (source.current_version() != versions_[index] ||
+          source.data().data_ptr() != data_ptrs_[index]) {
+        stale.push_back(index);
+        data.push_back(autograd::make_variable(source.data()));
+      }
+    }
+    if (stale.empty()) {
+      return replicas_;
+    }
+
+    const auto copies = copy_to_devices(data);
+    for (size_t replica = 0; replica < replicas_.size(); ++replica) {
+      const auto targets = state_of(*replicas_[replica]);
+      AT_CHECK(
+          targets.size() == sources.size(),
+          "The replicas have ", targets.size(),
+          " parameters and buffers, but the module has ", sources.size());
+      for (size_t index = 0; index < stale.size(); ++index) {
+        autograd::Variable(targets[stale[index]])
+            .set_data(autograd::Variable(copies[replica][index]).data());
+      }
+    }
+    record(sources);
+    return replicas_;
+  }
+
+  /// Drops the replicas, so that the next call of `replicas()` replicates the
+  /// module again.
+  void clear() {
+    replicas_.clear();
+    versions_.clear();
+    data_ptrs_.clear();
+  }
+
+  /// Returns the replicated module.
+  ModuleType& module() {
+    return module_;
+  }
+
+  /// Returns the devices of the replicas.
+  const std::vector<Device>& devices() const {
+    return devices_;
+  }
+
+ private:
+  /// Returns the parameters followed by the buffers of `module`, in an order
+  /// its replicas share.
+  static std::vector<Tensor> state_of(const Module& module) {
+    auto tensors = module.parameters();
+    const auto buffers = module.buffers();
+    tensors.insert(tensors.end(), buffers.begin(), buffers.end());
+    return tensors;
+  }
+
+  /// Remembers the version and data of every tensor of the module.
+  void record(const std::vector<Tensor>& sources) {
+    versions_.clear();
+    data_ptrs_.clear();
+    for (const auto& source : sources) {
+      autograd::Variable variable(source);
+      versions_.push_back(variable.current_version());
+      data_ptrs_.push_back(variable.data().data_ptr());
+    }
+  }
+
+  /// Returns copies of `tensors` on every device, indexed by device.
+  std::vector<std::vector<Tensor>> copy_to_devices(
+      const std::vector<Tensor>& tensors) const {
+#ifdef USE_CUDA
+    std::vector<int64_t> indices;
+    bool broadcastable = true;
+    for (const auto& device : devices_) {
+      broadcastable = broadcastable && device.is_cuda() && device.has_index();
+      indices.push_back(device.index());
+    }
+    for (const auto& tensor : tensors) {
+      broadcastable = broadcastable && tensor.is_cuda() &&
+          tensor.get_device() == indices.front();
+    }
+    if (broadcastable) {
+      return torch::cuda::broadcast_coalesced(
+          tensors, indices, kBroadcastBufferSize);
+    }
+#endif
+    std::vector<std::vector<Tensor>> copies;
+    copies.reserve(devices_.size());
+    for (const auto& device : devices_) {
+      copies.push_back(fmap(tensors, [&device](const Tensor& tensor) {
+        return tensor.to(device);
+      }));
+    }
+    return copies;
+  }
+
+  ModuleType module_;
+  std::vector<Device> devices_;
+  Replicas replicas_;
+  std::vector<uint32_t> versions_;
+  std::vector<const void*> data_ptrs_;
+};
+
+template <typename ModuleType>
+constexpr size_t ReplicaCache<ModuleType>::kBroadcastBufferSize;
+
+/// Evaluates `module(input)` in parallel across the devices of the cached
+/// `replicas`, which are updated with the parameters and buffers of the module
+/// first (see `ReplicaCache`). If `output_device` is supplied, the final,
+/// combined tensor will be placed on this device. If not, it defaults to the
+/// first device of the replicas.
 ///
-/// In detail, this method performs the following four distinct steps:
-/// 1. *Scatter* the input to the given devices,
-/// 2. *Replicate* (deep clone) the model on each device,
-/// 3. *Evaluate* each module with its input on its device,
-/// 4. *Gather* the outputs of each replica into a single output tensor, located
-/// on the `output_device`.
+/// The input is split into chunks along `dim`, like `autograd::Scatter` does;
+/// each chunk is copied to its device by the thread that then evaluates the
+/// replica on it, so that the copies to the devices overlap with the
+/// evaluation on the devices that already received their chunk.
 template <typename ModuleType>
 Tensor data_parallel(
-    ModuleType module,
+    ReplicaCache<ModuleType>& replicas,
     Tensor input,
-    optional<std::vector<Device>> devices = nullopt,
     optional<Device> output_device = nullopt,
     int64_t dim = 0) {
-  if (!devices) {
-    const auto device_count = torch::cuda::device_count();
-    AT_CHECK(
-        device_count > 0, "Expected at least one CUDA device to be available");
-    devices = std::vector<Device>();
-    devices->reserve(device_count);
-    for (size_t index = 0; index < device_count; ++index) {
-      devices->emplace_back(kCUDA, index);
-    }
-  }
+  const auto& devices = replicas.devices();
   if (!output_device) {
-    output_device = devices->front();
+    output_device = devices.front();
   }
 
-  if (devices->size() == 1) {
-    module->to(devices->front());
-    input = input.to(devices->front());
+  if (devices.size() == 1) {
+    auto& module = replicas.module();
+    module->to(devices.front());
+    input = input.to(devices.front());
     return module->forward(std::move(input)).to(*output_device);
   }
 
 #ifdef USE_CUDA
-  autograd::Scatter scatter(*devices, /*chunk_sizes=*/nullopt, dim);
-  auto scattered_inputs = fmap<Tensor>(scatter.apply({std::move(input)}));
-
-  auto replicas = replicate(module, *devices);
-  auto outputs = parallel_apply(replicas, scattered_inputs, *devices);
+  auto& modules = replicas.replicas();
+  const auto chunks = input.chunk(devices.size(), dim);
+  std::vector<Tensor> outputs(chunks.size());
+  detail::parallel_invoke(
+      chunks.size(), [&modules, &devices, &chunks, &outputs](size_t index) {
+        const auto& device = devices[index];
+        c10::DeviceGuard device_guard(device);
+        auto chunk = chunks[index].to(
+            device, chunks[index].scalar_type(), /*non_blocking=*/true);
+        outputs[index] = modules[index]->forward(std::move(chunk)).to(device);
+      });
   return autograd::Gather(*output_device, dim)
       .apply(fmap<autograd::Variable>(std::move(outputs)))
       .front();
@@ -173,6 +385,32 @@ Tensor data_parallel(
 #endif
 }
 
+/// Evaluates `module(input)` in parallel across the given `devices`. If
+/// `devices` is not supplied, the invocation is parallelized across all
+/// available CUDA devices. If `output_device` is supplied, the final, combined
+/// tensor will be placed on this device. If not, it defaults to the first
+/// device in `devices`.
+///
+/// In detail, this method performs the following four distinct steps:
+/// 1. *Scatter* the input to the given devices,
+/// 2. *Replicate* (deep clone) the model on each device,
+/// 3. *Evaluate* each module with its input on its device,
+/// 4. *Gather* the outputs of each replica into a single output tensor, located
+/// on the `output_device`.
+///
+/// The module is replicated anew on every call; to replicate it once for
+/// several calls, use a `ReplicaCache`.
+template <typename ModuleType>
+Tensor data_parallel(
+    ModuleType module,
+    Tensor input,
+    optional<std::vector<Device>> devices = nullopt,
+    optional<Device> output_device = nullopt,
+    int64_t dim = 0) {
+  ReplicaCache<ModuleType> replicas(std::move(module), std::move(devices));
+  return data_parallel(replicas, std::move(input), output_device, dim);
+}
+
 } // namespace parallel
 } // namespace nn
 } // namespace torch
@@ -0,0 +1,4 @@
+#pragma once
+
+#include <torch/nn/utils/checkpoint.h>
+#include <torch/nn/utils/clip_grad.h>
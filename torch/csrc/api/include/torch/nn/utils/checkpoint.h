@@ -0,0 +1,97 @@
+#pragma once
+
+#include <torch/csrc/autograd/functions/checkpoint.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/nn/modules/sequential.h>
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace torch {
+namespace nn {
+namespace utils {
+
+/// Evaluates `function(inputs)` without keeping the intermediate values its
+/// operators save for backward; they are recomputed by running `function`
+/// again during backward (see `torch::autograd::checkpoint()`). This trades
+/// compute for the memory of activations. `function` must be deterministic,
+/// except for random operators drawing from the CPU generator if
+/// `preserve_rng_state` is true, and the inputs must not be modified in place
+/// before backward.
+inline std::vector<Tensor> checkpoint(
+    const std::function<std::vector<Tensor>(const std::vector<Tensor>&)>&
+        function,
+    const std::vector<Tensor>& inputs,
+    bool preserve_rng_state = true) {
+  auto forward = [function](const autograd::variable_list& inputs) {
+    const auto outputs =
+        function(std::vector<Tensor>(inputs.begin(), inputs.end()));
+    return autograd::variable_list(outputs.begin(), outputs.end());
+  };
+  const auto outputs = autograd::checkpoint(
+      forward,
+      autograd::variable_list(inputs.begin(), inputs.end()),
+      preserve_rng_state);
+  return std::vector<Tensor>(outputs.begin(), outputs.end());
+}
+
+/// Checkpoints a function of a single tensor.
+inline Tensor checkpoint(
+    const std::function<Tensor(const Tensor&)>& function,
+    const Tensor& input,
+    bool preserve_rng_state = true) {
+  return checkpoint(
+             [function](const std::vector<Tensor>& inputs) {
+               return std::vector<Tensor>{function(inputs.front())};
+             },
+             std::vector<Tensor>{input},
+             preserve_rng_state)
+      .front();
+}
+
+/// Evaluates `sequential(input)` in `segments` segments of consecutive modules
+/// of about the same length, each of which is checkpointed except the last
+/// one, whose activations backward needs first. Only the inputs of the
+/// segments are then kept, which is the usual choice of boundaries for deep
+/// chains of modules: about the square root of the number of modules as
+/// `segments` minimizes the memory.
+inline Tensor checkpoint_sequential(
+    Sequential sequential,
+    size_t segments,
+    Tensor input,
+    bool preserve_rng_state = true) {
+  const auto impl = sequential.ptr();
+  const auto size = impl->size();
+  AT_CHECK(segments > 0, "Expected at least one segment");
+  AT_CHECK(size > 0, "Cannot checkpoint an empty Sequential");
+  segments = std::min(segments, size);
+  const auto segment_size = (size + segments - 1) / segments;
+
+  auto run = [impl](size_t begin, size_t end, Tensor input) {
+    for (auto module = impl->begin() + begin; module != impl->begin() + end;
+         ++module) {
+      input = module->forward(std::move(input));
+    }
+    return input;
+  };
+  size_t begin = 0;
+  for (; begin + segment_size < size; begin += segment_size) {
+    const auto end = begin + segment_size;
+    input = checkpoint(
+        [run, begin, end](const Tensor& input) {
+          return run(begin, end, input);
+        },
+        input,
+        preserve_rng_state);
+  }
+  return run(begin, size, std::move(input));
+}
+
+} // namespace utils
+} // namespace nn
+} // namespace torch
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <torch/types.h>
+#include <torch/utils.h>
+
+#include <vector>
+
+namespace torch {
+namespace nn {
+namespace utils {
+
+/// Clips the gradients of `parameters` in place, so that their norm, computed
+/// over all of them together as if they were concatenated into a single
+/// vector, is at most `max_norm`. `norm_type` may be `INFINITY` for the
+/// infinity norm. Parameters without a gradient are skipped.
+///
+/// The norm and the clipping take a few fused kernels per device and dtype
+/// (see `torch::_clip_grads_by_norm`) instead of a few operators per
+/// parameter, and never wait for the device. Returns the total norm of the
+/// gradients before clipping, as a 0-dim tensor on the device of the first
+/// gradient.
+inline Tensor clip_grad_norm_(
+    const std::vector<Tensor>& parameters,
+    double max_norm,
+    double norm_type = 2.0) {
+  std::vector<Tensor> grads;
+  grads.reserve(parameters.size());
+  for (const auto& parameter : parameters) {
+    if (parameter.grad().defined()) {
+      grads.push_back(parameter.grad());
+    }
+  }
+  NoGradGuard guard;
+  return torch::_clip_grads_by_norm(grads, max_norm, norm_type);
+}
+
+} // namespace utils
+} // namespace nn
+} // namespace torch
@@ -23,6 +23,12 @@ struct TORCH_API AdagradOptions {
   TORCH_ARG(double, learning_rate);
   TORCH_ARG(double, lr_decay) = 0;
   TORCH_ARG(double, weight_decay) = 0;
+  /// Keep a single accumulator per row (the first dimension) of each
+  /// parameter, updated with the mean of the squared gradient over the row.
+  TORCH_ARG(bool, rowwise) = false;
+  /// Updates the parameters with dense gradients with
+  /// `torch::_fused_adagrad_step`; rowwise Adagrad is never fused.
+  TORCH_ARG(bool, fused) = false;
 };
 
 class TORCH_API Adagrad : public Optimizer {
@@ -47,6 +53,8 @@ class TORCH_API Adagrad : public Optimizer {
  private:
   Adagrad() : options(0) {}
 
+  void fused_step(const std::vector<size_t>& indices);
+
   template <typename Self, typename Archive>
   static void serialize(Self& self, Archive& archive) {
     _TORCH_OPTIM_SERIALIZE(sum_buffers);
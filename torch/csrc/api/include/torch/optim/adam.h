@@ -26,6 +26,9 @@ struct TORCH_API AdamOptions {
   TORCH_ARG(double, weight_decay) = 0;
   TORCH_ARG(double, eps) = 1e-8;
   TORCH_ARG(bool, amsgrad) = false;
+  /// Updates the eligible parameters with `torch::_fused_adam_step`, a few
+  /// multi-tensor kernels for all the parameters of a device and dtype.
+  TORCH_ARG(bool, fused) = false;
 };
 
 class TORCH_API Adam : public Optimizer {
@@ -50,6 +53,8 @@ class TORCH_API Adam : public Optimizer {
  private:
   Adam() : options(0) {}
 
+  void fused_step(const std::vector<size_t>& indices);
+
   template <typename Self, typename Archive>
   static void serialize(Self& self, Archive& archive) {
     _TORCH_OPTIM_SERIALIZE(step_buffers);
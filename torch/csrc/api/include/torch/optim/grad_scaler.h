@@ -0,0 +1,73 @@
+#pragma once
+
+#include <torch/arg.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/optim/optimizer.h>
+#include <torch/types.h>
+
+#include <cstdint>
+
+namespace torch {
+namespace optim {
+
+struct TORCH_API GradScalerOptions {
+  /// The scale of the first steps.
+  TORCH_ARG(double, init_scale) = 65536.0;
+  /// The factor the scale grows by after `growth_interval` steps in a row
+  /// with finite gradients.
+  TORCH_ARG(double, growth_factor) = 2.0;
+  /// The factor the scale shrinks by after a step with an inf or a NaN in the
+  /// gradients.
+  TORCH_ARG(double, backoff_factor) = 0.5;
+  TORCH_ARG(int64_t, growth_interval) = 2000;
+};
+
+/// Dynamic loss scaling for mixed precision training. The loss is multiplied
+/// by a scale before `backward()`, so that the small gradients of reduced
+/// precision values, such as half ones, don't flush to zero; `step()` divides
+/// the gradients by the scale again before updating the parameters, and skips
+/// the update if scaling made any gradient overflow, in which case the scale
+/// shrinks. The scale grows back after a number of steps without overflows.
+///
+/// \rst
+/// .. code-block:: cpp
+///
+///   optimizer.use_master_weights();
+///   torch::optim::GradScaler scaler;
+///   for (auto& batch : data_loader) {
+///     optimizer.zero_grad();
+///     auto loss = model->forward(batch.data.to(torch::kHalf)) ...;
+///     scaler.scale(loss).backward();
+///     scaler.step(optimizer);
+///   }
+/// \endrst
+class TORCH_API GradScaler {
+ public:
+  explicit GradScaler(GradScalerOptions options = {});
+
+  /// Returns `loss` multiplied by the current scale, to call `backward()` on.
+  Tensor scale(const Tensor& loss) const;
+
+  /// Unscales the gradients of the parameters of `optimizer`, first copying
+  /// them into its master weights if it has any (see
+  /// `OptimizerBase::use_master_weights()`), and calls `optimizer.step()`
+  /// unless a gradient is an inf or a NaN. Unscaling and checking the
+  /// gradients takes a single fused kernel per device and dtype (see
+  /// `torch::_unscale_grads_and_check_finite`). Then updates the scale.
+  /// Returns whether the step was taken.
+  bool step(Optimizer& optimizer);
+
+  /// Returns the current scale.
+  double current_scale() const noexcept;
+
+  GradScalerOptions options;
+
+ private:
+  double scale_;
+
+  /// The number of steps in a row with finite gradients, since the scale last
+  /// changed.
+  int64_t growth_tracker_{0};
+};
+} // namespace optim
+} // namespace torch
@@ -41,7 +41,8 @@ class TORCH_API OptimizerBase {
   /// Adds the given vector of parameters to the optimizer's parameter list.
   void add_parameters(const std::vector<Tensor>& parameters);
 
-  /// Zeros out the gradients of all parameters.
+  /// Zeros out the gradients of all parameters, and of their master weights if
+  /// any.
   virtual void zero_grad();
 
   /// Provides a const reference to the parameters this optimizer holds.
@@ -53,6 +54,25 @@ class TORCH_API OptimizerBase {
   /// Returns the number of parameters referenced by the optimizer.
   size_t size() const noexcept;
 
+  /// Makes the optimizer keep fp32 copies ("master weights") of its floating
+  /// point parameters of a lower precision, such as half, and update those
+  /// instead, so that small updates are not lost to rounding. `parameters()`
+  /// then returns the master weights, and parameters added later get master
+  /// weights too. Around each `step()`, call
+  /// `copy_gradients_to_master_weights()` before and
+  /// `copy_master_weights_to_parameters()` after, as `GradScaler::step()` does.
+  void use_master_weights();
+
+  /// Whether `use_master_weights()` was called.
+  bool uses_master_weights() const noexcept;
+
+  /// Copies the gradients of the parameters that have master weights into the
+  /// gradients of their master weights.
+  void copy_gradients_to_master_weights();
+
+  /// Copies the master weights into the parameters they are copies of.
+  void copy_master_weights_to_parameters();
+
   /// Serializes the optimizer state into the given `archive`.
   virtual void save(serialize::OutputArchive& archive) const;
 
@@ -79,8 +99,36 @@ class TORCH_API OptimizerBase {
   /// Additionally, zeros out the buffers when this is called on the index
   Tensor& buffer_at(std::vector<Tensor>& buffers, size_t index);
 
+  /// Whether the update of `parameter` can be fused with the updates of other
+  /// parameters into a `torch::_fused_*_step` call: it must be a contiguous
+  /// floating point CPU or CUDA tensor (but not a half one on the CPU), with a
+  /// dense and contiguous gradient.
+  static bool is_fusable(const Tensor& parameter);
+
+  /// Splits the parameters at `indices` into the groups of parameters with the
+  /// same device, dtype and `key` (if any), which can each be updated by a
+  /// single `torch::_fused_*_step` call.
+  std::vector<std::vector<size_t>> fused_groups(
+      const std::vector<size_t>& indices,
+      const std::function<int64_t(size_t)>& key = nullptr) const;
+
+  /// Increments the version counters of parameters updated by a
+  /// `torch::_fused_*_step` call, as an in-place operation would.
+  static void bump_versions(const std::vector<Tensor>& parameters);
+
   /// The parameters this optimizer optimizes.
   std::vector<Tensor> parameters_;
+
+  /// With master weights, the parameters whose master weights are at the same
+  /// index of `parameters_`; undefined for the parameters that are updated
+  /// directly.
+  std::vector<Tensor> model_parameters_;
+
+ private:
+  /// Replaces the parameters from `index` on with master weights if needed.
+  void add_master_weights(size_t index);
+
+  bool master_weights_{false};
 };
 
 /// Serializes an `OptimizerBase` into an `OutputArchive`.
@@ -29,6 +29,8 @@ struct TORCH_API RMSpropOptions {
   TORCH_ARG(double, weight_decay) = 0;
   TORCH_ARG(double, momentum) = 0;
   TORCH_ARG(bool, centered) = false;
+  /// Updates the eligible parameters with `torch::_fused_rmsprop_step`.
+  TORCH_ARG(bool, fused) = false;
 };
 
 class TORCH_API RMSprop : public Optimizer {
@@ -54,6 +56,8 @@ class TORCH_API RMSprop : public Optimizer {
  private:
   RMSprop() : options(0) {}
 
+  void fused_step(const std::vector<size_t>& indices);
+
   template <typename Self, typename Archive>
   static void serialize(Self& self, Archive& archive) {
     _TORCH_OPTIM_SERIALIZE(square_average_buffers);
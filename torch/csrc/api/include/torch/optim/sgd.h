@@ -26,6 +26,9 @@ struct TORCH_API SGDOptions {
   TORCH_ARG(double, dampening) = 0;
   TORCH_ARG(double, weight_decay) = 0;
   TORCH_ARG(bool, nesterov) = false;
+  /// Updates all the eligible parameters of a device and dtype at once, with
+  /// `torch::_fused_sgd_step`, instead of with a few operations per parameter.
+  TORCH_ARG(bool, fused) = false;
 };
 
 class TORCH_API SGD : public Optimizer {
@@ -47,6 +50,8 @@ class TORCH_API SGD : public Optimizer {
  private:
   SGD() : options(0) {}
 
+  void fused_step(const std::vector<size_t>& indices);
+
   /// Counts how often `step()` is called, for dampening.
   size_t iteration_{0};
 };
@@ -0,0 +1,254 @@
+#include <torch/data/datasets/mmap_tensor.h>
+
+#include <torch/data/datasets/tensor.h>
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+constexpr char kMagic[4] = {'T', 'C', 'O', 'L'};
+constexpr uint32_t kVersion = 1;
+constexpr uint64_t kDataAlignment = 64;
+
+bool check_is_little_endian() {
+  const uint32_t word = 1;
+  return reinterpret_cast<const uint8_t*>(&word)[0] == 1;
+}
+
+uint64_t align(uint64_t offset) {
+  return (offset + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+}
+
+template <typename T>
+void append(std::string& buffer, T value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+template <typename T>
+T read(std::ifstream& stream, const std::string& path) {
+  T value;
+  AT_CHECK(
+      stream.read(reinterpret_cast<char*>(&value), sizeof value),
+      "Unexpected end of the header of ",
+      path);
+  return value;
+}
+
+struct ColumnHeader {
+  std::string name;
+  ScalarType dtype;
+  std::vector<int64_t> row_sizes;
+  uint64_t offset;
+};
+
+// Serializes the header, given the data offset of each column.
+std::string make_header(
+    const std::vector<std::string>& names,
+    const std::vector<Tensor>& columns,
+    const std::vector<uint64_t>& offsets) {
+  std::string header(kMagic, sizeof kMagic);
+  append<uint32_t>(header, kVersion);
+  append<uint64_t>(header, columns.front().size(0));
+  append<uint32_t>(header, columns.size());
+  for (size_t c = 0; c < columns.size(); ++c) {
+    append<uint32_t>(header, names[c].size());
+    header += names[c];
+    append<int32_t>(header, static_cast<int32_t>(columns[c].scalar_type()));
+    append<uint32_t>(header, columns[c].dim() - 1);
+    for (int64_t d = 1; d < columns[c].dim(); ++d) {
+      append<int64_t>(header, columns[c].size(d));
+    }
+    append<uint64_t>(header, offsets[c]);
+  }
+  return header;
+}
+} // namespace
+
+MMapTensorDataset::MMapTensorDataset(const std::string& path) {
+  AT_CHECK(
+      check_is_little_endian(),
+      "MMapTensorDataset is only supported on little-endian machines");
+  std::ifstream stream(path, std::ios::binary | std::ios::ate);
+  AT_CHECK(stream, "Error opening dataset file at ", path);
+  const uint64_t file_size = stream.tellg();
+  stream.seekg(0);
+
+  char magic[sizeof kMagic];
+  AT_CHECK(
+      stream.read(magic, sizeof magic) &&
+          std::memcmp(magic, kMagic, sizeof kMagic) == 0,
+      path,
+      " is not a MMapTensorDataset file");
+  const auto version = read<uint32_t>(stream, path);
+  AT_CHECK(
+      version == kVersion,
+      "Unsupported MMapTensorDataset file version ",
+      version,
+      " in ",
+      path);
+  rows_ = read<uint64_t>(stream, path);
+  const auto column_count = read<uint32_t>(stream, path);
+
+  std::vector<ColumnHeader> headers(column_count);
+  for (auto& header : headers) {
+    header.name.resize(read<uint32_t>(stream, path));
+    AT_CHECK(
+        stream.read(&header.name[0], header.name.size()),
+        "Unexpected end of the header of ",
+        path);
+    const auto dtype = read<int32_t>(stream, path);
+    AT_CHECK(
+        dtype >= 0 &&
+            dtype < static_cast<int32_t>(ScalarType::Undefined) &&
+            !isQIntType(static_cast<ScalarType>(dtype)),
+        "Invalid scalar type ",
+        dtype,
+        " of column '",
+        header.name,
+        "' in ",
+        path);
+    header.dtype = static_cast<ScalarType>(dtype);
+    header.row_sizes.resize(read<uint32_t>(stream, path));
+    for (auto& size : header.row_sizes) {
+      size = read<int64_t>(stream, path);
+      AT_CHECK(size >= 0, "Invalid size of column '", header.name, "'");
+    }
+    header.offset = read<uint64_t>(stream, path);
+  }
+
+  // Map the whole file once, and expose each column as a view that keeps the
+  // mapping alive.
+  auto mapping = torch::from_file(
+      path,
+      /*shared=*/false,
+      static_cast<int64_t>(file_size),
+      TensorOptions(kByte));
+  auto* base = static_cast<char*>(mapping.data_ptr());
+  for (auto& header : headers) {
+    std::vector<int64_t> sizes = {static_cast<int64_t>(rows_)};
+    sizes.insert(sizes.end(), header.row_sizes.begin(), header.row_sizes.end());
+    uint64_t nbytes = elementSize(header.dtype);
+    for (auto size : sizes) {
+      nbytes *= size;
+    }
+    AT_CHECK(
+        header.offset % kDataAlignment == 0 && header.offset <= file_size &&
+            nbytes <= file_size - header.offset,
+        "The data of column '",
+        header.name,
+        "' lies outside of ",
+        path);
+    names_.push_back(header.name);
+    columns_.push_back(torch::from_blob(
+        base + header.offset,
+        sizes,
+        [mapping](void*) {},
+        TensorOptions(header.dtype)));
+  }
+}
+
+std::vector<Tensor> MMapTensorDataset::get_batch(ArrayRef<size_t> indices) {
+  std::vector<Tensor> batch;
+  batch.reserve(columns_.size());
+  for (const auto& column : columns_) {
+    batch.push_back(detail::gather_rows(column, indices));
+  }
+  return batch;
+}
+
+optional<size_t> MMapTensorDataset::size() const {
+  return rows_;
+}
+
+const std::vector<std::string>& MMapTensorDataset::column_names() const
+    noexcept {
+  return names_;
+}
+
+const Tensor& MMapTensorDataset::column(const std::string& name) const {
+  for (size_t c = 0; c < names_.size(); ++c) {
+    if (names_[c] == name) {
+      return columns_[c];
+    }
+  }
+  AT_ERROR("No column named '", name, "' in the dataset");
+}
+
+void MMapTensorDataset::write(
+    const std::string& path,
+    const std::vector<std::string>& names,
+    const std::vector<Tensor>& columns) {
+  AT_CHECK(
+      check_is_little_endian(),
+      "MMapTensorDataset is only supported on little-endian machines");
+  AT_CHECK(!columns.empty(), "Expected at least one column");
+  AT_CHECK(
+      names.size() == columns.size(),
+      "Expected one name per column, but got ",
+      names.size(),
+      " names for ",
+      columns.size(),
+      " columns");
+  std::unordered_set<std::string> unique_names;
+  for (size_t c = 0; c < columns.size(); ++c) {
+    AT_CHECK(
+        unique_names.insert(names[c]).second,
+        "Duplicate column name '",
+        names[c],
+        "'");
+    AT_CHECK(
+        columns[c].device().is_cpu() && columns[c].layout() == kStrided &&
+            !isQIntType(columns[c].scalar_type()) && columns[c].dim() > 0,
+        "Column '",
+        names[c],
+        "' must be a dense, non-quantized CPU tensor with at least one "
+        "dimension");
+    AT_CHECK(
+        columns[c].size(0) == columns.front().size(0),
+        "All columns must have the same number of rows, but column '",
+        names[c],
+        "' has ",
+        columns[c].size(0),
+        " rows and column '",
+        names.front(),
+        "' has ",
+        columns.front().size(0));
+  }
+
+  // The header size does not depend on the offsets, so serialize it once to
+  // find where the data starts.
+  std::vector<uint64_t> offsets(columns.size(), 0);
+  uint64_t offset = align(make_header(names, columns, offsets).size());
+  for (size_t c = 0; c < columns.size(); ++c) {
+    offsets[c] = offset;
+    offset = align(offset + columns[c].numel() * columns[c].element_size());
+  }
+  const auto header = make_header(names, columns, offsets);
+
+  std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+  AT_CHECK(stream, "Error opening ", path, " for writing");
+  stream.write(header.data(), header.size());
+  for (size_t c = 0; c < columns.size(); ++c) {
+    const auto column = columns[c].contiguous();
+    const std::string padding(offsets[c] - stream.tellp(), '\0');
+    stream.write(padding.data(), padding.size());
+    stream.write(
+        static_cast<const char*>(column.data_ptr()),
+        column.numel() * column.element_size());
+  }
+  AT_CHECK(stream, "Error writing ", path);
+}
+} // namespace datasets
+} // namespace data
+} // namespace torch
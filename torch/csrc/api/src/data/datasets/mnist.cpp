@@ -1,5 +1,6 @@
 #include <torch/data/datasets/mnist.h>
 
+#include <torch/data/datasets/tensor.h>
 #include <torch/data/example.h>
 #include <torch/types.h>
 
@@ -104,6 +105,11 @@ Example<> MNIST::get(size_t index) {
   return {images_[index], targets_[index]};
 }
 
+Example<> MNIST::get_stacked_batch(ArrayRef<size_t> indices, bool pin_memory) {
+  return {detail::gather_rows(images_, indices, pin_memory),
+          detail::gather_rows(targets_, indices, pin_memory)};
+}
+
 optional<size_t> MNIST::size() const {
   return images_.size(0);
 }
@@ -0,0 +1,142 @@
+#include <torch/data/samplers/bucket.h>
+#include <torch/serialize/archive.h>
+#include <torch/types.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace samplers {
+
+BucketBatchSampler::BucketBatchSampler(
+    std::vector<size_t> lengths,
+    size_t max_tokens,
+    size_t bucket_size,
+    size_t num_replicas,
+    size_t rank,
+    bool allow_duplicates)
+    : DistributedSampler(lengths.size(), num_replicas, rank, allow_duplicates),
+      lengths_(std::move(lengths)),
+      max_tokens_(max_tokens),
+      bucket_size_(bucket_size),
+      batch_size_(0),
+      batch_index_(0) {
+  AT_CHECK(rank_ < num_replicas_, "Rank ", rank_, " out of ", num_replicas_, " replicas");
+}
+
+void BucketBatchSampler::reset(optional<size_t> new_size) {
+  AT_CHECK(
+      !new_size.has_value() || *new_size == lengths_.size(),
+      "Cannot reset a BucketBatchSampler of ",
+      lengths_.size(),
+      " examples to ",
+      *new_size,
+      " examples, since their lengths are not known");
+  batch_size_ = 0;
+  batch_index_ = 0;
+  batches_.clear();
+}
+
+void BucketBatchSampler::populate_batches(size_t batch_size) {
+  AT_CHECK(batch_size > 0, "The batch size must be positive");
+  std::mt19937 rand(epoch_);
+  std::vector<size_t> indices(size_);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), rand);
+
+  const size_t bucket_size = bucket_size_ == 0 ? size_ : bucket_size_;
+  std::vector<std::vector<size_t>> batches;
+  for (size_t begin = 0; begin < size_; begin += bucket_size) {
+    const auto bucket_begin = indices.begin() + begin;
+    const auto bucket_end = indices.begin() + std::min(begin + bucket_size, size_);
+    std::stable_sort(bucket_begin, bucket_end, [this](size_t a, size_t b) {
+      return lengths_[a] > lengths_[b];
+    });
+    // The bucket is sorted by decreasing length, so the first example of a
+    // batch is its longest.
+    for (auto it = bucket_begin; it != bucket_end;) {
+      const size_t tokens = std::max<size_t>(lengths_[*it], 1);
+      size_t count = batch_size;
+      if (max_tokens_ > 0) {
+        count = std::min(count, std::max<size_t>(max_tokens_ / tokens, 1));
+      }
+      count = std::min<size_t>(count, bucket_end - it);
+      batches.emplace_back(it, it + count);
+      it += count;
+    }
+  }
+  std::shuffle(batches.begin(), batches.end(), rand);
+
+  size_t local_batches = batches.size() / num_replicas_;
+  if (allow_duplicates_) {
+    local_batches = (batches.size() + num_replicas_ - 1) / num_replicas_;
+  }
+  batches_.clear();
+  batches_.reserve(local_batches);
+  for (size_t i = 0; i < local_batches && !batches.empty(); ++i) {
+    batches_.push_back(batches[(i * num_replicas_ + rank_) % batches.size()]);
+  }
+  batch_size_ = batch_size;
+}
+
+optional<std::vector<size_t>> BucketBatchSampler::next(size_t batch_size) {
+  if (batch_size_ == 0) {
+    populate_batches(batch_size);
+  } else {
+    AT_CHECK(
+        batch_size == batch_size_,
+        "BucketBatchSampler::next() expects the batch size ",
+        batch_size_,
+        " it was first called with since the last reset(), but got ",
+        batch_size);
+  }
+  if (batch_index_ == batches_.size()) {
+    return nullopt;
+  }
+  return batches_[batch_index_++];
+}
+
+void BucketBatchSampler::save(serialize::OutputArchive& archive) const {
+  archive.write(
+      "batch_index_",
+      torch::tensor(static_cast<int64_t>(batch_index_)),
+      /*is_buffer=*/true);
+  archive.write(
+      "batch_size_",
+      torch::tensor(static_cast<int64_t>(batch_size_)),
+      /*is_buffer=*/true);
+  archive.write(
+      "epoch_",
+      torch::tensor(static_cast<int64_t>(epoch_)),
+      /*is_buffer=*/true);
+}
+
+void BucketBatchSampler::load(serialize::InputArchive& archive) {
+  auto tensor = torch::empty(1, torch::kInt64);
+  archive.read("epoch_", tensor, /*is_buffer=*/true);
+  epoch_ = tensor.item<int64_t>();
+  reset();
+
+  // The batches are cut again from the epoch and the batch size.
+  tensor = torch::empty(1, torch::kInt64);
+  archive.read("batch_size_", tensor, /*is_buffer=*/true);
+  const auto batch_size = tensor.item<int64_t>();
+  if (batch_size > 0) {
+    populate_batches(batch_size);
+  }
+  tensor = torch::empty(1, torch::kInt64);
+  archive.read("batch_index_", tensor, /*is_buffer=*/true);
+  batch_index_ = tensor.item<int64_t>();
+}
+
+size_t BucketBatchSampler::index() const noexcept {
+  return batch_index_;
+}
+
+} // namespace samplers
+} // namespace data
+} // namespace torch
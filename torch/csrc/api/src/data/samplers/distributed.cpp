@@ -93,6 +93,132 @@ size_t DistributedRandomSampler::index() const noexcept {
   return sample_index_;
 }
 
+namespace {
+// The finalizer of splitmix64, a bijection of the 64 bit integers that mixes
+// every input bit into every output bit.
+uint64_t mix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+} // namespace
+
+constexpr size_t DistributedFeistelSampler::kRounds;
+
+DistributedFeistelSampler::DistributedFeistelSampler(
+    size_t size,
+    size_t num_replicas,
+    size_t rank,
+    bool allow_duplicates,
+    uint64_t seed)
+    : DistributedSampler(size, num_replicas, rank, allow_duplicates),
+      seed_(seed),
+      begin_index_(0),
+      end_index_(0),
+      sample_index_(0),
+      sample_count_(0),
+      half_bits_(1) {
+  reset(size_);
+}
+
+optional<std::vector<size_t>> DistributedFeistelSampler::next(
+    size_t batch_size) {
+  if (sample_index_ == end_index_) {
+    return nullopt;
+  }
+
+  size_t end = sample_index_ + batch_size;
+  if (end > end_index_) {
+    end = end_index_;
+  }
+
+  std::vector<size_t> res(end - sample_index_);
+  for (size_t& index : res) {
+    index = shuffled_index(sample_index_++);
+  }
+  return res;
+}
+
+void DistributedFeistelSampler::reset(optional<size_t> new_size) {
+  size_ = new_size.value_or(size_);
+  populate_indices();
+
+  uint64_t key = mix64(seed_ ^ mix64(epoch_));
+  for (auto& round_key : keys_) {
+    round_key = key = mix64(key);
+  }
+  sample_index_ = begin_index_;
+}
+
+void DistributedFeistelSampler::populate_indices() {
+  size_t num_local_samples = local_sample_count();
+  sample_count_ =
+      num_replicas_ == 1 ? size_ : num_local_samples * num_replicas_;
+  half_bits_ = 1;
+  while (half_bits_ < 32 && (uint64_t(1) << (2 * half_bits_)) < sample_count_) {
+    ++half_bits_;
+  }
+  begin_index_ = rank_ * num_local_samples;
+  end_index_ = begin_index_ + num_local_samples;
+  sample_index_ = begin_index_;
+}
+
+size_t DistributedFeistelSampler::shuffled_index(size_t position) const {
+  // The network permutes the integers below 2^(2 * half_bits_), which is less
+  // than 4 * sample_count_, so walking the cycle of the position until it is
+  // below sample_count_ permutes the positions in a few steps on average.
+  const uint64_t mask = (uint64_t(1) << half_bits_) - 1;
+  uint64_t value = position;
+  do {
+    uint64_t left = value >> half_bits_;
+    uint64_t right = value & mask;
+    for (const auto round_key : keys_) {
+      const uint64_t next = left ^ (mix64(right ^ round_key) & mask);
+      left = right;
+      right = next;
+    }
+    value = (left << half_bits_) | right;
+  } while (value >= sample_count_);
+  // The positions past the size are duplicates of the first samples, that
+  // make all replicas have the same number of samples.
+  return value < size_ ? value : value - size_;
+}
+
+void DistributedFeistelSampler::save(serialize::OutputArchive& archive) const {
+  archive.write(
+      "sample_index_",
+      torch::tensor(static_cast<int64_t>(sample_index_)),
+      /*is_buffer=*/true);
+  archive.write(
+      "epoch_",
+      torch::tensor(static_cast<int64_t>(epoch_)),
+      /*is_buffer=*/true);
+  archive.write(
+      "seed_",
+      torch::tensor(static_cast<int64_t>(seed_)),
+      /*is_buffer=*/true);
+}
+
+void DistributedFeistelSampler::load(serialize::InputArchive& archive) {
+  auto tensor = torch::empty(1, torch::kInt64);
+  archive.read("epoch_", tensor, /*is_buffer=*/true);
+  epoch_ = tensor.item<int64_t>();
+  tensor = torch::empty(1, torch::kInt64);
+  archive.read("seed_", tensor, /*is_buffer=*/true);
+  seed_ = static_cast<uint64_t>(tensor.item<int64_t>());
+  // call reset() after loading epoch_ and seed_ to derive the keys.
+  reset(size_);
+
+  tensor = torch::empty(1, torch::kInt64);
+  archive.read("sample_index_", tensor, /*is_buffer=*/true);
+  sample_index_ = tensor.item<int64_t>();
+}
+
+size_t DistributedFeistelSampler::index() const noexcept {
+  return sample_index_;
+}
+
 DistributedSequentialSampler::DistributedSequentialSampler(
     size_t size,
     size_t num_replicas,
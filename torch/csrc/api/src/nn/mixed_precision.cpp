@@ -0,0 +1,51 @@
+#include <torch/nn/mixed_precision.h>
+
+#include <torch/csrc/autograd/variable.h>
+#include <torch/nn/modules/batchnorm.h>
+#include <torch/types.h>
+
+#include <c10/util/Exception.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace nn {
+namespace {
+void convert(Module& module, const MixedPrecisionOptions& options) {
+  AT_CHECK(
+      module.flat_parameters().empty(),
+      "to_mixed_precision() must be called before flatten_parameters()");
+  const bool keep_fp32 =
+      (options.keep_batchnorm_fp32() &&
+       dynamic_cast<const BatchNormImpl*>(&module) != nullptr) ||
+      (options.keep_fp32() && options.keep_fp32()(module));
+  const auto dtype = keep_fp32 ? kFloat : options.dtype();
+  auto convert_tensor = [dtype](Tensor& tensor) {
+    if (tensor.is_floating_point() && tensor.scalar_type() != dtype) {
+      autograd::Variable variable(tensor);
+      variable.set_data(variable.data().to(dtype));
+    }
+  };
+  for (auto& parameter : module.named_parameters(/*recurse=*/false)) {
+    convert_tensor(parameter.value());
+  }
+  for (auto& buffer : module.named_buffers(/*recurse=*/false)) {
+    convert_tensor(buffer.value());
+  }
+}
+} // namespace
+
+void to_mixed_precision(Module& module, const MixedPrecisionOptions& options) {
+  AT_CHECK(
+      isFloatingType(options.dtype()),
+      "to_mixed_precision() expects a floating point dtype, but got ",
+      options.dtype());
+  convert(module, options);
+  for (const auto& child : module.modules(/*include_self=*/false)) {
+    convert(*child, options);
+  }
+}
+
+} // namespace nn
+} // namespace torch
@@ -1,6 +1,7 @@
 #include <torch/nn/module.h>
 
 #include <torch/ordered_dict.h>
+#include <torch/utils.h>
 
 #include <torch/csrc/autograd/generated/VariableType.h>
 
@@ -12,6 +13,7 @@
 #include <ostream>
 #include <string>
 #include <typeinfo>
+#include <unordered_set>
 
 namespace torch {
 namespace nn {
@@ -258,6 +260,26 @@ bool Module::is_training() const noexcept {
 }
 
 void Module::zero_grad() {
+  if (!flat_gradients_.empty()) {
+    for (auto& gradient : flat_gradients_) {
+      gradient.zero_();
+    }
+    for (auto& parameter : parameters()) {
+      auto& grad = parameter.grad();
+      if (!grad.defined()) {
+        continue;
+      }
+      const bool is_flat = std::any_of(
+          flat_gradients_.begin(),
+          flat_gradients_.end(),
+          [&](const Tensor& gradient) { return grad.is_alias_of(gradient); });
+      if (!is_flat) {
+        grad = grad.detach();
+        grad.zero_();
+      }
+    }
+    return;
+  }
   for (auto& child : children_) {
     child.value()->zero_grad();
   }
@@ -270,6 +292,72 @@ void Module::zero_grad() {
   }
 }
 
+void Module::flatten_parameters() {
+  NoGradGuard guard;
+  flat_parameters_.clear();
+  flat_gradients_.clear();
+  apply([](Module& module) { module.parameters_flattened_ = true; });
+
+  // Group the parameters by device and dtype, once each even if they are
+  // shared between submodules.
+  std::vector<std::vector<Tensor>> groups;
+  std::unordered_set<TensorImpl*> seen;
+  for (auto& parameter : parameters()) {
+    if (!seen.insert(parameter.unsafeGetTensorImpl()).second) {
+      continue;
+    }
+    auto group = std::find_if(
+        groups.begin(), groups.end(), [&](const std::vector<Tensor>& group) {
+          return group.front().device() == parameter.device() &&
+              group.front().scalar_type() == parameter.scalar_type();
+        });
+    if (group == groups.end()) {
+      groups.emplace_back();
+      group = groups.end() - 1;
+    }
+    group->push_back(parameter);
+  }
+
+  for (auto& group : groups) {
+    int64_t numel = 0;
+    for (const auto& parameter : group) {
+      numel += parameter.numel();
+    }
+    const auto options =
+        autograd::Variable(group.front()).data().options();
+    auto flat_data = at::empty({numel}, options);
+    auto flat_grad = at::zeros({numel}, options);
+    int64_t offset = 0;
+    for (auto& parameter : group) {
+      const auto size = parameter.numel();
+      auto data = flat_data.narrow(0, offset, size).view(parameter.sizes());
+      data.copy_(autograd::Variable(parameter).data());
+      if (parameter.requires_grad()) {
+        auto grad = flat_grad.narrow(0, offset, size).view(parameter.sizes());
+        const auto& old_grad = parameter.grad();
+        if (old_grad.defined()) {
+          const auto old_data = autograd::Variable(old_grad).data();
+          grad.copy_(old_data.is_sparse() ? old_data.to_dense() : old_data);
+        }
+        parameter.grad() = autograd::make_variable(grad);
+      }
+      parameter.set_data(data);
+      offset += size;
+    }
+    flat_parameters_.push_back(autograd::make_variable(flat_data));
+    flat_gradients_.push_back(autograd::make_variable(flat_grad));
+    flat_parameters_.back().grad() = flat_gradients_.back();
+  }
+}
+
+const std::vector<Tensor>& Module::flat_parameters() const noexcept {
+  return flat_parameters_;
+}
+
+const std::vector<Tensor>& Module::flat_gradients() const noexcept {
+  return flat_gradients_;
+}
+
 void Module::save(serialize::OutputArchive& archive) const {
   for (const auto& parameter : parameters_) {
     archive.write(parameter.key(), parameter.value());
@@ -288,6 +376,19 @@ void Module::save(serialize::OutputArchive& archive) const {
 
 void Module::load(serialize::InputArchive& archive) {
   for (auto& parameter : parameters_) {
+    if (parameters_flattened_) {
+      // Keep the parameter a view of its flat buffer.
+      Tensor loaded;
+      archive.read(parameter.key(), loaded);
+      AT_CHECK(
+          loaded.sizes() == parameter->sizes(),
+          "Expected the deserialized parameter '", parameter.key(),
+          "' of a module with flattened parameters to be of size ",
+          parameter->sizes(), ", but got ", loaded.sizes());
+      NoGradGuard guard;
+      parameter->copy_(loaded);
+      continue;
+    }
     archive.read(parameter.key(), parameter.value());
   }
   for (auto& buffer : buffers_) {
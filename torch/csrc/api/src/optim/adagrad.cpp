@@ -7,6 +7,7 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -17,13 +18,22 @@ AdagradOptions::AdagradOptions(double learning_rate)
 /// Adapted from
 /// https://github.com/pytorch/pytorch/blob/master/torch/optim/adagrad.py
 void Adagrad::step() {
+  std::vector<size_t> fused;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
       continue;
     }
 
+    if (options.fused_ && !options.rowwise_ && is_fusable(p)) {
+      fused.push_back(i);
+      continue;
+    }
+
     if (options.weight_decay_ > 0) {
+      AT_CHECK(
+          !p.grad().is_sparse(),
+          "weight_decay is not compatible with sparse gradients");
       p.grad() = p.grad() + options.weight_decay_ * p;
     }
 
@@ -31,12 +41,70 @@ void Adagrad::step() {
     const auto clr = options.learning_rate_ /
         (1.0 + (buffer_at(step_buffers, i) - 1.0) * options.lr_decay_);
 
+    if (options.rowwise_) {
+      // Allocate one accumulator per row, instead of the zeros_like(p) that
+      // buffer_at() would.
+      while (sum_buffers.size() <= i) {
+        const auto& parameter = parameters_.at(sum_buffers.size());
+        sum_buffers.push_back(
+            torch::zeros({parameter.size(0)}, parameter.options()));
+      }
+    }
     auto& sum = buffer_at(sum_buffers, i);
-    sum.addcmul_(p.grad(), p.grad(), 1.0);
+
+    // Sparse gradients of float CPU parameters are applied directly to the
+    // rows they touch, summing any duplicate indices.
+    const auto& grad = p.grad();
+    if (grad.is_sparse() && grad.sparse_dim() == 1 &&
+        grad.device().is_cpu() && grad.scalar_type() == torch::kFloat &&
+        p.is_contiguous()) {
+      NoGradGuard guard;
+      torch::_sparse_adagrad_(p, sum, grad, clr);
+      continue;
+    }
+    const auto dense_grad = grad.is_sparse() ? grad.to_dense() : grad;
+
+    if (options.rowwise_) {
+      const auto rows = p.size(0);
+      sum.add_(dense_grad.pow(2).view({rows, -1}).mean(1));
+      std::vector<int64_t> std_sizes(p.dim(), 1);
+      std_sizes[0] = rows;
+      const auto std = sum.sqrt().add_(1e-10).view(std_sizes);
+
+      NoGradGuard guard;
+      p.addcdiv_(dense_grad, std, -clr);
+      continue;
+    }
+
+    sum.addcmul_(dense_grad, dense_grad, 1.0);
     const auto std = buffer_at(sum_buffers, i).sqrt().add_(1e-10);
 
     NoGradGuard guard;
-    p.addcdiv_(p.grad(), std, -clr);
+    p.addcdiv_(dense_grad, std, -clr);
+  }
+  fused_step(fused);
+}
+
+void Adagrad::fused_step(const std::vector<size_t>& indices) {
+  for (auto i : indices) {
+    buffer_at(step_buffers, i) += 1.0;
+  }
+  const auto groups =
+      fused_groups(indices, [this](size_t i) { return step_buffers[i]; });
+  for (const auto& group : groups) {
+    std::vector<Tensor> params, grads, sums;
+    for (auto i : group) {
+      params.push_back(parameters_[i]);
+      grads.push_back(parameters_[i].grad());
+      sums.push_back(buffer_at(sum_buffers, i));
+    }
+    const auto clr = options.learning_rate_ /
+        (1.0 + (step_buffers[group.front()] - 1.0) * options.lr_decay_);
+
+    NoGradGuard guard;
+    torch::_fused_adagrad_step(
+        params, grads, sums, clr, options.weight_decay_, 1e-10);
+    bump_versions(params);
   }
 }
 
@@ -16,12 +16,18 @@ AdamOptions::AdamOptions(double learning_rate)
     : learning_rate_(learning_rate) {}
 
 void Adam::step() {
+  std::vector<size_t> fused;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
       continue;
     }
 
+    if (options.fused_ && is_fusable(p)) {
+      fused.push_back(i);
+      continue;
+    }
+
     if (options.weight_decay_ > 0) {
       p.grad() = p.grad() + options.weight_decay_ * p;
     }
@@ -52,6 +58,51 @@ void Adam::step() {
     NoGradGuard guard;
     p.addcdiv_(exp_average, denom.sqrt() + options.eps_, -step_size);
   }
+  fused_step(fused);
+}
+
+void Adam::fused_step(const std::vector<size_t>& indices) {
+  for (auto i : indices) {
+    buffer_at(step_buffers, i) += 1;
+  }
+  // The bias corrections depend on the step, which differs between parameters
+  // that didn't always have a gradient.
+  const auto groups =
+      fused_groups(indices, [this](size_t i) { return step_buffers[i]; });
+  for (const auto& group : groups) {
+    std::vector<Tensor> params, grads, exp_averages, exp_average_sqs,
+        max_exp_average_sqs;
+    for (auto i : group) {
+      params.push_back(parameters_[i]);
+      grads.push_back(parameters_[i].grad());
+      exp_averages.push_back(buffer_at(exp_average_buffers, i));
+      exp_average_sqs.push_back(buffer_at(exp_average_sq_buffers, i));
+      if (options.amsgrad_) {
+        max_exp_average_sqs.push_back(
+            buffer_at(max_exp_average_sq_buffers, i));
+      }
+    }
+
+    const auto step = step_buffers[group.front()];
+    const auto bias_correction1 = 1 - std::pow(options.beta1_, step);
+    const auto bias_correction2 = 1 - std::pow(options.beta2_, step);
+    const auto step_size =
+        options.learning_rate_ * std::sqrt(bias_correction2) / bias_correction1;
+
+    NoGradGuard guard;
+    torch::_fused_adam_step(
+        params,
+        grads,
+        exp_averages,
+        exp_average_sqs,
+        max_exp_average_sqs,
+        step_size,
+        options.beta1_,
+        options.beta2_,
+        options.weight_decay_,
+        options.eps_);
+    bump_versions(params);
+  }
 }
 
 void Adam::save(serialize::OutputArchive& archive) const {
@@ -0,0 +1,65 @@
+#include <torch/optim/grad_scaler.h>
+
+#include <torch/optim/optimizer.h>
+#include <torch/types.h>
+#include <torch/utils.h>
+
+#include <c10/util/Exception.h>
+
+#include <vector>
+
+namespace torch {
+namespace optim {
+GradScaler::GradScaler(GradScalerOptions options)
+    : options(options), scale_(options.init_scale()) {
+  AT_CHECK(scale_ > 0, "GradScaler: expected a positive init_scale");
+  AT_CHECK(
+      options.growth_factor() >= 1,
+      "GradScaler: expected a growth_factor of at least 1");
+  AT_CHECK(
+      options.backoff_factor() > 0 && options.backoff_factor() < 1,
+      "GradScaler: expected a backoff_factor between 0 and 1");
+}
+
+Tensor GradScaler::scale(const Tensor& loss) const {
+  return loss * scale_;
+}
+
+bool GradScaler::step(Optimizer& optimizer) {
+  if (optimizer.uses_master_weights()) {
+    optimizer.copy_gradients_to_master_weights();
+  }
+
+  std::vector<Tensor> grads;
+  for (const auto& parameter : optimizer.parameters()) {
+    if (parameter.grad().defined()) {
+      grads.push_back(parameter.grad());
+    }
+  }
+  bool finite;
+  {
+    NoGradGuard guard;
+    finite = torch::_unscale_grads_and_check_finite(grads, 1.0 / scale_);
+  }
+
+  if (finite) {
+    optimizer.step();
+    if (optimizer.uses_master_weights()) {
+      optimizer.copy_master_weights_to_parameters();
+    }
+    if (++growth_tracker_ == options.growth_interval()) {
+      scale_ *= options.growth_factor();
+      growth_tracker_ = 0;
+    }
+  } else {
+    scale_ *= options.backoff_factor();
+    growth_tracker_ = 0;
+  }
+  return finite;
+}
+
+double GradScaler::current_scale() const noexcept {
+  return scale_;
+}
+} // namespace optim
+} // namespace torch
@@ -1,10 +1,13 @@
 #include <torch/optim/optimizer.h>
 
 #include <torch/csrc/autograd/generated/variable_factories.h>
+#include <torch/csrc/autograd/variable.h>
 #include <torch/ordered_dict.h>
 #include <torch/serialize/archive.h>
 #include <torch/types.h>
+#include <torch/utils.h>
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -16,7 +19,11 @@ OptimizerBase::OptimizerBase(std::vector<Tensor> parameters)
     : parameters_(std::move(parameters)) {}
 
 void OptimizerBase::add_parameters(const std::vector<Tensor>& parameters) {
+  const auto index = parameters_.size();
   parameters_.insert(parameters_.end(), parameters.begin(), parameters.end());
+  if (master_weights_) {
+    add_master_weights(index);
+  }
 }
 
 void OptimizerBase::zero_grad() {
@@ -26,6 +33,12 @@ void OptimizerBase::zero_grad() {
       parameter.grad().zero_();
     }
   }
+  for (auto& parameter : model_parameters_) {
+    if (parameter.defined() && parameter.grad().defined()) {
+      parameter.grad().detach_();
+      parameter.grad().zero_();
+    }
+  }
 }
 
 const std::vector<Tensor>& OptimizerBase::parameters() const noexcept {
@@ -40,6 +53,62 @@ size_t OptimizerBase::size() const noexcept {
   return parameters_.size();
 }
 
+void OptimizerBase::use_master_weights() {
+  if (!master_weights_) {
+    master_weights_ = true;
+    add_master_weights(0);
+  }
+}
+
+bool OptimizerBase::uses_master_weights() const noexcept {
+  return master_weights_;
+}
+
+void OptimizerBase::copy_gradients_to_master_weights() {
+  NoGradGuard guard;
+  for (size_t i = 0; i < model_parameters_.size(); ++i) {
+    const auto& parameter = model_parameters_[i];
+    if (!parameter.defined()) {
+      continue;
+    }
+    auto& master_grad = parameters_[i].grad();
+    const auto& grad = parameter.grad();
+    if (!grad.defined()) {
+      master_grad = Tensor();
+    } else if (
+        master_grad.defined() && !grad.is_sparse() &&
+        !master_grad.is_sparse()) {
+      master_grad.copy_(grad);
+    } else {
+      master_grad =
+          autograd::make_variable(autograd::Variable(grad).data().to(kFloat));
+    }
+  }
+}
+
+void OptimizerBase::copy_master_weights_to_parameters() {
+  NoGradGuard guard;
+  for (size_t i = 0; i < model_parameters_.size(); ++i) {
+    if (model_parameters_[i].defined()) {
+      model_parameters_[i].copy_(parameters_[i]);
+    }
+  }
+}
+
+void OptimizerBase::add_master_weights(size_t index) {
+  model_parameters_.resize(parameters_.size());
+  for (auto i = index; i < parameters_.size(); ++i) {
+    const auto& parameter = parameters_[i];
+    if (parameter.is_floating_point() && parameter.scalar_type() != kFloat &&
+        parameter.scalar_type() != kDouble) {
+      model_parameters_[i] = parameter;
+      parameters_[i] = autograd::make_variable(
+          autograd::Variable(parameter).data().to(kFloat),
+          /*requires_grad=*/true);
+    }
+  }
+}
+
 Tensor& OptimizerBase::buffer_at(std::vector<Tensor>& buffers, size_t index) {
   if (buffers.size() <= index) {
     buffers.reserve(index);
@@ -57,6 +126,42 @@ Tensor& OptimizerBase::buffer_at(std::vector<Tensor>& buffers, size_t index) {
   return buffers[index];
 }
 
+bool OptimizerBase::is_fusable(const Tensor& parameter) {
+  const auto& grad = parameter.grad();
+  return parameter.is_floating_point() &&
+      (parameter.is_cuda() ||
+       (parameter.device().is_cpu() && parameter.scalar_type() != kHalf)) &&
+      parameter.is_contiguous() && !grad.is_sparse() && grad.is_contiguous();
+}
+
+std::vector<std::vector<size_t>> OptimizerBase::fused_groups(
+    const std::vector<size_t>& indices,
+    const std::function<int64_t(size_t)>& key) const {
+  std::vector<std::vector<size_t>> groups;
+  for (auto index : indices) {
+    const auto& parameter = parameters_.at(index);
+    auto group = std::find_if(
+        groups.begin(), groups.end(), [&](const std::vector<size_t>& group) {
+          const auto& other = parameters_.at(group.front());
+          return other.device() == parameter.device() &&
+              other.scalar_type() == parameter.scalar_type() &&
+              (!key || key(group.front()) == key(index));
+        });
+    if (group == groups.end()) {
+      groups.emplace_back();
+      group = groups.end() - 1;
+    }
+    group->push_back(index);
+  }
+  return groups;
+}
+
+void OptimizerBase::bump_versions(const std::vector<Tensor>& parameters) {
+  for (Tensor parameter : parameters) {
+    autograd::as_variable_ref(parameter).bump_version();
+  }
+}
+
 void OptimizerBase::save(serialize::OutputArchive& archive) const {}
 void OptimizerBase::load(serialize::InputArchive& archive) {}
 
@@ -17,12 +17,18 @@ RMSpropOptions::RMSpropOptions(double learning_rate)
 /// Adapted from
 /// https://github.com/pytorch/pytorch/blob/master/torch/optim/rmsprop.py
 void RMSprop::step() {
+  std::vector<size_t> fused;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
       continue;
     }
 
+    if (options.fused_ && is_fusable(p)) {
+      fused.push_back(i);
+      continue;
+    }
+
     if (options.weight_decay_ > 0) {
       p.grad() = p.grad() + options.weight_decay_ * p;
     }
@@ -51,6 +57,39 @@ void RMSprop::step() {
       p.addcdiv_(p.grad(), average, -options.learning_rate_);
     }
   }
+  fused_step(fused);
+}
+
+void RMSprop::fused_step(const std::vector<size_t>& indices) {
+  for (const auto& group : fused_groups(indices)) {
+    std::vector<Tensor> params, grads, square_averages, grad_averages,
+        momentums;
+    for (auto i : group) {
+      params.push_back(parameters_[i]);
+      grads.push_back(parameters_[i].grad());
+      square_averages.push_back(buffer_at(square_average_buffers, i));
+      if (options.centered_) {
+        grad_averages.push_back(buffer_at(grad_average_buffers, i));
+      }
+      if (options.momentum_ > 0) {
+        momentums.push_back(buffer_at(momentum_buffers, i));
+      }
+    }
+
+    NoGradGuard guard;
+    torch::_fused_rmsprop_step(
+        params,
+        grads,
+        square_averages,
+        grad_averages,
+        momentums,
+        options.learning_rate_,
+        options.alpha_,
+        options.eps_,
+        options.weight_decay_,
+        options.momentum_);
+    bump_versions(params);
+  }
 }
 
 void RMSprop::save(serialize::OutputArchive& archive) const {
@@ -16,6 +16,7 @@ namespace optim {
 SGDOptions::SGDOptions(double learning_rate) : learning_rate_(learning_rate) {}
 
 void SGD::step() {
+  std::vector<size_t> fused;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
 
@@ -23,6 +24,11 @@ void SGD::step() {
       continue;
     }
 
+    if (options.fused_ && is_fusable(p)) {
+      fused.push_back(i);
+      continue;
+    }
+
     auto update = p.grad();
 
     if (options.weight_decay_ > 0) {
@@ -45,9 +51,35 @@ void SGD::step() {
     NoGradGuard guard;
     p.add_(-options.learning_rate_ * update);
   }
+  fused_step(fused);
   iteration_ += 1;
 }
 
+void SGD::fused_step(const std::vector<size_t>& indices) {
+  const auto dampening = iteration_ == 0 ? 1 : 1 - options.dampening_;
+  for (const auto& group : fused_groups(indices)) {
+    std::vector<Tensor> params, grads, momentums;
+    for (auto i : group) {
+      params.push_back(parameters_[i]);
+      grads.push_back(parameters_[i].grad());
+      if (options.momentum_ != 0) {
+        momentums.push_back(buffer_at(momentum_buffers, i));
+      }
+    }
+    NoGradGuard guard;
+    torch::_fused_sgd_step(
+        params,
+        grads,
+        momentums,
+        options.learning_rate_,
+        options.weight_decay_,
+        options.momentum_,
+        dampening,
+        options.nesterov_);
+    bump_versions(params);
+  }
+}
+
 void SGD::save(serialize::OutputArchive& archive) const {
   optim::serialize(archive, "momentum_buffers", momentum_buffers);
 }
@@ -286,6 +286,17 @@ Tensor & VariableType::resize_(Tensor & self, IntArrayRef size) const {
   return self;
 }
 
+Tensor & VariableType::reserve_(Tensor & self, int64_t capacity) const {
+  auto& self_ = unpack(self, "self", 0);
+  // Reserving keeps the size and contents of self, so there is nothing to
+  // record for autograd or the tracer.
+  {
+    at::AutoNonVariableTypeMode non_var_type_mode(true);
+    baseType->reserve_(self_, capacity);
+  }
+  return self;
+}
+
 Tensor & VariableType::resize_as_(Tensor & self, const Tensor & the_template) const {
   auto& self_ = unpack(self, "self", 0);
   auto& the_template_ = unpack(the_template, "the_template", 1);
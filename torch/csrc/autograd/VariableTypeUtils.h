@@ -3,6 +3,7 @@
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/edge.h>
+#include <torch/csrc/autograd/forward_ad.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/saved_variable.h>
 #include <torch/csrc/autograd/generated/Functions.h>
@@ -17,6 +18,7 @@
 #include <torch/csrc/autograd/functions/utils.h>
 
 #include <ATen/core/VariableHooksInterface.h>
+#include <c10/util/StaticTracepoint.h>
 
 #include <array>
 #include <cstddef>
@@ -141,6 +143,19 @@ inline void check_no_requires_grad(TensorList tensors, const char* name) {
   }
 }
 
+// The tangent of an input of a forward formula: its forward gradient, or zeros
+// if it is not a dual tensor.
+inline Tensor fw_grad_or_zeros(const Tensor& tensor) {
+  if (!tensor.defined()) {
+    return Tensor();
+  }
+  const auto& fw_grad = as_variable_ref(tensor).fw_grad();
+  if (fw_grad.defined()) {
+    return fw_grad;
+  }
+  return at::zeros_like(tensor);
+}
+
 // Assumed that saved tensor lists are never inplace outputs
 inline std::vector<SavedVariable> make_saved_variable_list(TensorList tensors) {
   return fmap(tensors, [](const Tensor& tensor) -> SavedVariable {
@@ -148,6 +163,13 @@ inline std::vector<SavedVariable> make_saved_variable_list(TensorList tensors) {
 }
 
 inline Tensor as_variable(Tensor tensor) {
+  // The outputs of the base type are usually fresh tensors nothing else refers
+  // to. They can become the data of the Variable as they are, without the
+  // shallow copy make_variable makes of the TensorImpl.
+  const auto& impl = tensor.getIntrusivePtr();
+  if (impl.defined() && impl.unique() && impl.weak_use_count() == 1) {
+    return make_variable_consuming(std::move(tensor), /*requires_grad=*/false);
+  }
   return make_variable(std::move(tensor), /*requires_grad=*/false);
 }
 
@@ -157,6 +179,13 @@ inline std::vector<Tensor> as_variable(TensorList tl) {
   });
 }
 
+inline std::vector<Tensor> as_variable(std::vector<Tensor> tensors) {
+  for (Tensor& tensor : tensors) {
+    tensor = as_variable(std::move(tensor));
+  }
+  return tensors;
+}
+
 template <typename... Tensors, size_t... Is>
 std::tuple<Tensors...> as_variable_impl(
     std::tuple<Tensors...> tensors,
@@ -165,7 +194,7 @@ std::tuple<Tensors...> as_variable_impl(
   // constructions. This turns into (boolean omitted):
   // Variable(std::get<0>(tensors)), Variable(std::get<1>(tensors)), ...
   return std::tuple<Tensors...>(
-      as_variable(std::get<Is>(tensors))...);
+      as_variable(std::move(std::get<Is>(tensors)))...);
 }
 
 // NB: Because this was not forward declared, recursive std::tuple won't work.
@@ -177,7 +206,7 @@ std::tuple<Tensors...> as_variable(std::tuple<Tensors...> tensors) {
   // expand into an Indices object containing the numbers 0 to
   // sizeof...(Tensors) - 1.
   return as_variable_impl(
-      tensors, typename MakeIndices<sizeof...(Tensors)>::indices());
+      std::move(tensors), typename MakeIndices<sizeof...(Tensors)>::indices());
 }
 
 inline std::vector<std::vector<int64_t>> to_args_sizes(TensorList tensors) {
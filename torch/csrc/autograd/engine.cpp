@@ -4,6 +4,8 @@
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
+#include <torch/csrc/autograd/record_function.h>
+#include <torch/csrc/autograd/saved_variable.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/utils/memory.h>
 
@@ -11,6 +13,7 @@
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <c10/util/Exception.h>
+#include <c10/util/StaticTracepoint.h>
 
 #include <atomic>
 #include <condition_variable>
@@ -39,6 +42,10 @@ static constexpr int NO_DEVICE = -2;
 // handling reentrant backwards calls; see Note [Reentrant backwards]
 static thread_local int worker_device = NO_DEVICE;
 
+// Index of the thread among the CPU workers when the engine runs more than
+// one of them (see Engine::set_num_cpu_threads), -1 otherwise.
+static thread_local int cpu_worker_index = -1;
+
 // This variable is true if ALL invocations in the stack of re-entrant engine
 // invocations are imperative backwards. This special variable is needed for the
 // gradient checkpointing feature only.
@@ -50,6 +57,14 @@ static thread_local bool checkpoint_valid = true;
 // executed at the same time). Adding multiple threads per-device or removing
 // engine thread affinity to the device can break this invariant, and we depend
 // on it in a few places (e.g. AccumulateGrad function).
+//
+// With more than one CPU worker (Engine::set_num_cpu_threads), every CPU
+// worker has a ReadyQueue of its own and idle workers steal tasks from the
+// others, so independent branches of a graph run in parallel. The invariant
+// above is kept by FunctionExecutionOwnership: a task whose function is
+// being applied by another worker is parked until that worker is done.
+// Device queues keep their single worker thread, so work on a device is
+// still issued from one thread in sequence_nr order.
 
 struct FunctionTask {
   GraphTask* base;
@@ -79,13 +94,58 @@ struct CompareFunctionTaskTime {
   }
 };
 
+// Tasks are pushed onto a lock-free intake list and only moved into the
+// priority heap by whoever pops, so producers (which are usually other
+// workers finishing a function) never wait for the heap mutex. The mutex
+// and condition variable are only touched by producers when the queue's
+// worker is asleep.
 struct ReadyQueue {
+  struct IntakeNode {
+    explicit IntakeNode(FunctionTask task) : task(std::move(task)), next(nullptr) {}
+    FunctionTask task;
+    IntakeNode* next;
+  };
+
+  ReadyQueue() : intake(nullptr), num_waiting(0) {}
+  ~ReadyQueue();
+
   std::priority_queue<FunctionTask, std::vector<FunctionTask>, CompareFunctionTaskTime> heap;
+  std::atomic<IntakeNode*> intake;
+  std::atomic<int> num_waiting;
   std::condition_variable not_empty;
+  // guards heap
   std::mutex mutex;
 
   void push(FunctionTask item);
   FunctionTask pop();
+  // Pops the next task without blocking. Wakeup (empty) tasks are only
+  // returned to the queue's own worker, never to a thief.
+  bool try_pop(FunctionTask& task, bool steal);
+
+ private:
+  // Moves the intake list into the heap; must hold mutex
+  void drain_intake();
+};
+
+// The ReadyQueues of the CPU workers when there is more than one of them.
+// Workers push the tasks they produce onto their own queue and, when it runs
+// dry, steal the highest priority task of another queue; tasks from outside
+// the pool are spread round-robin.
+struct CPUReadyQueues {
+  explicit CPUReadyQueues(size_t num_workers);
+
+  void push(int index, FunctionTask item);
+  FunctionTask pop(int index);
+
+  std::vector<std::unique_ptr<ReadyQueue>> queues;
+  std::atomic<size_t> next_queue;
+  // Number of stealable tasks, across all queues
+  std::atomic<int64_t> num_stealable;
+  // Idle workers sleep here instead of on their own queue, so that work
+  // pushed onto any queue can wake them
+  std::mutex idle_mutex;
+  std::condition_variable work_available;
+  std::atomic<int> num_idle;
 };
 
 // Note [Reentrant backwards]
@@ -133,14 +193,36 @@ struct GraphTask {
   std::atomic_bool has_error;
   std::atomic<uint64_t> outstanding_tasks;
   bool keep_graph;
+
+  // The thread local state in which the functions of this task run, on any
+  // worker (see GraphTaskStateGuard): the grad mode is create_graph, and the
+  // rest is taken from the thread that calls Engine::execute. The anomaly
+  // mode and the profiler state are global, and need no carrying over.
   bool grad_mode;
+  bool checkpoint_valid;
+  bool record_function_enabled;
+  SavedTensorHooks* saved_tensor_hooks;
 
   std::mutex mutex;
   // Notified when a task finishes executing.  Check outstanding_tasks to see
   // if all tasks are done.
   std::condition_variable not_done;
-  std::unordered_map<Function*, InputBuffer> not_ready;
-  std::unordered_map<Function*, int> dependencies;
+
+  // Bookkeeping of a function waiting for the gradients of its inputs. The
+  // map of these is filled by compute_dependencies before execution starts
+  // and doesn't change shape afterwards, so workers look entries up without
+  // a lock; only producers feeding the same function synchronize, on the
+  // entry's own mutex.
+  struct DependencyState {
+    // number of producers that haven't delivered their gradient yet
+    std::atomic<int> dependencies{0};
+    // guards inputs when there is more than one producer
+    std::mutex mutex;
+    std::unique_ptr<InputBuffer> inputs;
+  };
+  std::unordered_map<Function*, DependencyState> dependency_states;
+  // Number of functions that received some but not all their inputs
+  std::atomic<int> num_not_ready{0};
 
   struct ExecInfo {
     struct Capture {
@@ -169,6 +251,8 @@ struct GraphTask {
   // The value of worker_device in the thread that created this task.
   // See Note [Reentrant backwards]
   int owner;
+  // The value of cpu_worker_index in the thread that created this task.
+  int owner_cpu_worker;
 
   bool can_checkpoint() {
     return exec_info.empty();
@@ -179,26 +263,214 @@ struct GraphTask {
     , outstanding_tasks(0)
     , keep_graph(keep_graph)
     , grad_mode(grad_mode)
-    , owner(NO_DEVICE) {}
+    , checkpoint_valid(true)
+    , record_function_enabled(profiler::isRecordFunctionEnabled())
+    , saved_tensor_hooks(SavedTensorHooks::current())
+    , owner(NO_DEVICE)
+    , owner_cpu_worker(-1) {}
+};
+
+// Sets the thread local state of a GraphTask on the worker running one of its
+// functions, and restores the worker's own afterwards, which matters when a
+// reentrant backward runs the functions of another GraphTask in between.
+struct GraphTaskStateGuard {
+  explicit GraphTaskStateGuard(const GraphTask& task)
+    : grad_mode_(task.grad_mode)
+    , checkpoint_valid_(checkpoint_valid)
+    , record_function_(task.record_function_enabled)
+    , saved_tensor_hooks_(task.saved_tensor_hooks) {
+    checkpoint_valid = task.checkpoint_valid;
+  }
+
+  ~GraphTaskStateGuard() {
+    checkpoint_valid = checkpoint_valid_;
+  }
+
+ private:
+  AutoGradMode grad_mode_;
+  bool checkpoint_valid_;
+  profiler::RecordFunctionGuard record_function_;
+  SavedTensorHooksGuard saved_tensor_hooks_;
+};
+
+// Makes sure a function is never applied by two CPU workers at once. A worker
+// may re-enter a function it is already applying (reentrant backwards does
+// that with a single worker thread as well); tasks for it popped by other
+// workers are deferred and pushed again once it is released.
+struct FunctionExecutionOwnership {
+  struct Owner {
+    std::thread::id thread;
+    int depth;
+    std::vector<FunctionTask> deferred;
+  };
+
+  // Returns false if the task was deferred
+  bool acquire(FunctionTask& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = owners.find(task.fn.get());
+    if (it == owners.end()) {
+      owners.emplace(task.fn.get(),
+          Owner{std::this_thread::get_id(), 1, std::vector<FunctionTask>()});
+      return true;
+    }
+    if (it->second.thread == std::this_thread::get_id()) {
+      ++it->second.depth;
+      return true;
+    }
+    it->second.deferred.push_back(std::move(task));
+    return false;
+  }
+
+  // Returns the tasks deferred while the function was applied
+  std::vector<FunctionTask> release(Function* fn) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = owners.find(fn);
+    AT_ASSERT(it != owners.end());
+    std::vector<FunctionTask> deferred;
+    if (--it->second.depth == 0) {
+      deferred = std::move(it->second.deferred);
+      owners.erase(it);
+    }
+    return deferred;
+  }
+
+  std::mutex mutex;
+  std::unordered_map<Function*, Owner> owners;
 };
 
+static FunctionExecutionOwnership& function_execution_ownership() {
+  static FunctionExecutionOwnership ownership;
+  return ownership;
+}
+
+ReadyQueue::~ReadyQueue() {
+  auto node = intake.exchange(nullptr);
+  while (node) {
+    auto next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
 auto ReadyQueue::push(FunctionTask item) -> void {
-  {
+  ++item.base->outstanding_tasks;
+  auto node = new IntakeNode(std::move(item));
+  node->next = intake.load(std::memory_order_relaxed);
+  while (!intake.compare_exchange_weak(node->next, node)) {
+  }
+  // Pairs with the increment of num_waiting in pop(): either the sleeper
+  // sees the node when it drains again, or we see the sleeper
+  if (num_waiting.load() > 0) {
     std::lock_guard<std::mutex> lock(mutex);
-    ++item.base->outstanding_tasks;
-    heap.push(std::move(item));
+    not_empty.notify_one();
+  }
+}
+
+auto ReadyQueue::drain_intake() -> void {
+  auto node = intake.exchange(nullptr);
+  while (node) {
+    auto next = node->next;
+    heap.push(std::move(node->task));
+    delete node;
+    node = next;
   }
-  not_empty.notify_one();
 }
 
 auto ReadyQueue::pop() -> FunctionTask {
   std::unique_lock<std::mutex> lock(mutex);
-  not_empty.wait(lock, [this]{ return !heap.empty(); });
+  drain_intake();
+  while (heap.empty()) {
+    ++num_waiting;
+    drain_intake();
+    if (heap.empty()) {
+      not_empty.wait(lock);
+      drain_intake();
+    }
+    --num_waiting;
+  }
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   auto task = std::move(const_cast<FunctionTask&>(heap.top())); heap.pop();
   return task;
 }
 
+auto ReadyQueue::try_pop(FunctionTask& task, bool steal) -> bool {
+  std::lock_guard<std::mutex> lock(mutex);
+  drain_intake();
+  if (heap.empty() || (steal && !heap.top().fn)) {
+    return false;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  task = std::move(const_cast<FunctionTask&>(heap.top())); heap.pop();
+  return true;
+}
+
+CPUReadyQueues::CPUReadyQueues(size_t num_workers)
+  : queues(num_workers)
+  , next_queue(0)
+  , num_stealable(0)
+  , num_idle(0) {
+  for (auto& queue : queues) {
+    queue.reset(new ReadyQueue());
+  }
+}
+
+auto CPUReadyQueues::push(int index, FunctionTask item) -> void {
+  if (index < 0) {
+    index = next_queue++ % queues.size();
+  }
+  const bool stealable = item.fn != nullptr;
+  queues[index]->push(std::move(item));
+  if (stealable) {
+    ++num_stealable;
+  }
+  // Pairs with the increment of num_idle before a worker re-checks the
+  // queues, so either the worker sees the task or we see the worker
+  if (num_idle.load() > 0) {
+    std::lock_guard<std::mutex> lock(idle_mutex);
+    if (stealable) {
+      work_available.notify_one();
+    } else {
+      // Only the owner of the queue can take a wakeup task
+      work_available.notify_all();
+    }
+  }
+}
+
+auto CPUReadyQueues::pop(int index) -> FunctionTask {
+  FunctionTask task(nullptr, nullptr, InputBuffer(0));
+  auto try_pop = [&]() {
+    if (queues[index]->try_pop(task, /*steal=*/false)) {
+      if (task.fn) {
+        --num_stealable;
+      }
+      return true;
+    }
+    if (num_stealable.load() > 0) {
+      const size_t num_queues = queues.size();
+      for (size_t i = 1; i < num_queues; ++i) {
+        if (queues[(index + i) % num_queues]->try_pop(task, /*steal=*/true)) {
+          --num_stealable;
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+  while (true) {
+    if (try_pop()) {
+      return task;
+    }
+    std::unique_lock<std::mutex> lock(idle_mutex);
+    ++num_idle;
+    if (try_pop()) {
+      --num_idle;
+      return task;
+    }
+    work_available.wait(lock);
+    --num_idle;
+  }
+}
+
 Engine::Engine() = default;
 
 // This Engine's ReadyQueues and their corresponding threads are leaked here
@@ -267,17 +539,33 @@ auto Engine::thread_init(int device) -> void {
 // in case this code is to be changed.
 auto Engine::thread_main(GraphTask *graph_task) -> void {
   auto queue = ready_queues[worker_device + 1];
+  const bool is_pool_worker = cpu_worker_index >= 0;
   // Why the test on graph_task->outstanding_tasks?  See
   // Note [Reentrant backwards]
   while (!graph_task || graph_task->outstanding_tasks > 0) {
-    FunctionTask task = queue->pop();
+    FunctionTask task = is_pool_worker ? cpu_ready_queues->pop(cpu_worker_index)
+                                       : queue->pop();
     if (task.fn && !task.base->has_error.load()) {
-      GradMode::set_enabled(task.base->grad_mode);
+      // The deferred task stays outstanding until it is run
+      if (is_pool_worker && !function_execution_ownership().acquire(task)) {
+        continue;
+      }
       try {
+        GraphTaskStateGuard state_guard(*task.base);
         evaluate_function(task);
       } catch (std::exception& e) {
         thread_on_exception(task, e);
       }
+      if (is_pool_worker) {
+        auto deferred = function_execution_ownership().release(task.fn.get());
+        for (auto& deferred_task : deferred) {
+          // Undo the increment push() does for this already counted task,
+          // afterwards so that the count can't drop to zero in between
+          auto base = deferred_task.base;
+          cpu_ready_queues->push(cpu_worker_index, std::move(deferred_task));
+          --base->outstanding_tasks;
+        }
+      }
     }
     // Notify downstream about the completion of tasks depending
     // on both where the task was executed, and who owned the overall
@@ -292,17 +580,23 @@ auto Engine::thread_main(GraphTask *graph_task) -> void {
     } else {
       // If it's a task initiated from this thread, decrease the counter, but
       // don't do anything - loop condition will do all checks for us next.
-      if (base_owner == worker_device) {
+      if (base_owner == worker_device &&
+          task.base->owner_cpu_worker == cpu_worker_index) {
         --task.base->outstanding_tasks;
       // Otherwise send a dummy function task to the owning thread just to
       // ensure that it's not sleeping. If it has work, it might see that
       // graph_task->outstanding_tasks == 0 before it gets to the task, but
       // it's a no-op anyway.
-      } else if (base_owner != worker_device) {
+      } else {
         if (--task.base->outstanding_tasks == 0) {
           // Synchronize outstanding_tasks with queue mutex
           std::atomic_thread_fence(std::memory_order_release);
-          ready_queue_by_index(base_owner).push(FunctionTask(task.base, nullptr, InputBuffer(0)));
+          FunctionTask wakeup(task.base, nullptr, InputBuffer(0));
+          if (task.base->owner_cpu_worker >= 0) {
+            cpu_ready_queues->push(task.base->owner_cpu_worker, std::move(wakeup));
+          } else {
+            ready_queue_by_index(base_owner).push(std::move(wakeup));
+          }
         }
       }
     }
@@ -389,8 +683,6 @@ static void validate_outputs(const edge_list& edges, variable_list& grads, const
 }
 
 static variable_list call_function(FunctionTask& task) {
-  bool prev_checkpoint_valid_state = checkpoint_valid;
-  checkpoint_valid = task.base->can_checkpoint() && prev_checkpoint_valid_state;
   auto& fn = *task.fn;
   auto inputs = call_pre_hooks(fn, InputBuffer::variables(std::move(task.inputs)));
 
@@ -425,7 +717,6 @@ static variable_list call_function(FunctionTask& task) {
     ss << "Function "  << fn.name() << " returned an " << msg;
     return ss.str();
   });
-  checkpoint_valid = prev_checkpoint_valid_state;
 
   if(has_post_hooks){
     // NOLINTNEXTLINE(bugprone-use-after-move)
@@ -448,7 +739,15 @@ auto Engine::evaluate_function(FunctionTask& task) -> void {
     if (!fn_info.needed) return;
   }
 
+  // The probes pass the mangled type name of the node, which unlike
+  // fn.name() costs nothing to compute when no tracer is attached.
+  C10_SDT(
+      autograd_node_start,
+      task.fn.get(),
+      typeid(*task.fn).name(),
+      task.fn->sequence_nr());
   auto outputs = call_function(task);
+  C10_SDT(autograd_node_end, task.fn.get());
 
   auto& fn = *task.fn;
   if (!task.base->keep_graph) {
@@ -471,53 +770,48 @@ auto Engine::evaluate_function(FunctionTask& task) -> void {
     }
   }
 
-  std::lock_guard<std::mutex> lock(task.base->mutex);
   for (int i = 0; i < num_outputs; ++i) {
     auto& output = outputs[i];
     const auto& next = fn.next_edge(i);
 
     if (!next.is_valid()) continue;
 
-    // Check if the next function is ready to be computed
-    bool is_ready = false;
-    auto& dependencies = task.base->dependencies;
-    auto it = dependencies.find(next.function.get());
-    if (it == dependencies.end()) {
+    auto& dependency_states = task.base->dependency_states;
+    auto it = dependency_states.find(next.function.get());
+    if (it == dependency_states.end()) {
       auto name = next.function->name();
       throw std::runtime_error(std::string("dependency not found for ") + name);
-    } else if (--it->second == 0) {
-      dependencies.erase(it);
-      is_ready = true;
     }
+    auto& state = it->second;
 
-    auto& not_ready = task.base->not_ready;
-    auto not_ready_it = not_ready.find(next.function.get());
-    if (not_ready_it == not_ready.end()) {
-      // Skip functions that aren't supposed to be executed
-      if (!exec_info.empty()) {
-        auto it = exec_info.find(next.function.get());
-        if (it == exec_info.end() || !it->second.should_execute()) {
-          continue;
-        }
-      }
-      // No buffers have been allocated for the function
-      InputBuffer input_buffer(next.function->num_inputs());
-      input_buffer.add(next.input_nr, std::move(output));
-      if (is_ready) {
-        auto& queue = ready_queue(input_buffer.device());
-        queue.push(FunctionTask(task.base, next.function, std::move(input_buffer)));
-      } else {
-        not_ready.emplace(next.function.get(), std::move(input_buffer));
+    // Skip functions that aren't supposed to be executed
+    bool should_execute = true;
+    if (!exec_info.empty()) {
+      auto exec_it = exec_info.find(next.function.get());
+      should_execute = exec_it != exec_info.end() && exec_it->second.should_execute();
+    }
+
+    // Deliver the gradient, then count it. The producer that brings the
+    // count to zero sees the inputs of all the others and runs the function.
+    if (should_execute) {
+      std::unique_lock<std::mutex> lock(state.mutex, std::defer_lock);
+      // A function with a single producer left has nobody to race with;
+      // the producers before it are done with inputs
+      if (state.dependencies.load() > 1 || state.inputs) {
+        lock.lock();
       }
-    } else {
-      // The function already has a buffer
-      auto &input_buffer = not_ready_it->second;
-      input_buffer.add(next.input_nr, std::move(output));
-      if (is_ready) {
-        auto& queue = ready_queue(input_buffer.device());
-        queue.push(FunctionTask(task.base, next.function, std::move(input_buffer)));
-        not_ready.erase(not_ready_it);
+      if (!state.inputs) {
+        state.inputs.reset(new InputBuffer(next.function->num_inputs()));
+        ++task.base->num_not_ready;
       }
+      state.inputs->add(next.input_nr, std::move(output));
+    }
+    if (--state.dependencies == 0 && should_execute) {
+      InputBuffer input_buffer(std::move(*state.inputs));
+      state.inputs.reset();
+      --task.base->num_not_ready;
+      auto device = input_buffer.device();
+      push_ready(device, FunctionTask(task.base, next.function, std::move(input_buffer)));
     }
   }
 }
@@ -530,12 +824,12 @@ auto Engine::compute_dependencies(Function* root, GraphTask& task) -> void {
 
   // Queue contains all nodes that will start propagating gradients.
   // We no longer have to expand functions that don't require grad.
-  auto& dependencies = task.dependencies;
+  auto& dependency_states = task.dependency_states;
   while (!queue.empty()) {
     auto fn = queue.back(); queue.pop_back();
     for (const auto& edge : fn->next_edges()) {
       if (auto next_ptr = edge.function.get()) {
-        dependencies[next_ptr] += 1;
+        dependency_states[next_ptr].dependencies += 1;
         const bool was_inserted = seen.insert(next_ptr).second;
         if (was_inserted) queue.push_back(next_ptr);
       }
@@ -583,7 +877,10 @@ auto Engine::execute(const edge_list& roots,
   if (!outputs.empty()) {
     graph_task.init_to_execute(*graph_root, outputs);
   }
-  ready_queue(at::kCPU).push(FunctionTask(&graph_task, std::move(graph_root), InputBuffer(0)));
+  // Checkpointing is valid if ALL the backward passes this one is nested in
+  // are imperative too
+  graph_task.checkpoint_valid = graph_task.can_checkpoint() && checkpoint_valid;
+  push_ready(at::kCPU, FunctionTask(&graph_task, std::move(graph_root), InputBuffer(0)));
 
   // Not a worker
   if (worker_device == NO_DEVICE) {
@@ -596,6 +893,7 @@ auto Engine::execute(const edge_list& roots,
     // complete!
     // See Note [Reentrant backwards]
     graph_task.owner = worker_device;
+    graph_task.owner_cpu_worker = cpu_worker_index;
     lock.unlock();
     thread_main(&graph_task);
   }
@@ -605,7 +903,7 @@ auto Engine::execute(const edge_list& roots,
     std::rethrow_exception(graph_task.exception);
   }
 
-  if (!graph_task.not_ready.empty()) {
+  if (graph_task.num_not_ready.load() != 0) {
     throw std::runtime_error("could not compute gradients for some functions");
   }
 
@@ -653,6 +951,27 @@ bool Engine::is_checkpoint_valid() {
   return checkpoint_valid;
 }
 
+void Engine::set_num_cpu_threads(size_t num_threads) {
+  AT_CHECK(num_threads > 0, "Expected a positive number of autograd CPU threads");
+  std::lock_guard<std::mutex> lock(num_cpu_threads_mutex);
+  AT_CHECK(!threads_started,
+      "cannot set the number of autograd CPU threads after the first backward pass");
+  num_cpu_threads = num_threads;
+}
+
+size_t Engine::get_num_cpu_threads() {
+  std::lock_guard<std::mutex> lock(num_cpu_threads_mutex);
+  return num_cpu_threads;
+}
+
+auto Engine::push_ready(at::Device device, FunctionTask task) -> void {
+  if (device.type() == at::kCPU && cpu_ready_queues) {
+    cpu_ready_queues->push(cpu_worker_index, std::move(task));
+  } else {
+    ready_queue(device).push(std::move(task));
+  }
+}
+
 auto Engine::ready_queue(at::Device device) -> ReadyQueue& {
   // See Note [Allocating GPUs to autograd threads]
   if (device.type() == at::kCPU) {
@@ -679,13 +998,35 @@ auto Engine::start_threads() -> void {
     }
   }
 
+  size_t cpu_threads;
+  {
+    std::lock_guard<std::mutex> lock(num_cpu_threads_mutex);
+    threads_started = true;
+    cpu_threads = num_cpu_threads;
+  }
+
   // One for CPU, plus one for every GPU device (but colocate GPUs of different
   // types)
   int num_threads = num_devices + 1;
   ready_queues = std::vector<std::shared_ptr<ReadyQueue>>(num_threads);
   for (auto& queue : ready_queues)
     queue.reset(new ReadyQueue());
-  for (int i = 0; i < num_threads; ++i) {
+  // With several CPU workers, CPU work goes to their own queues and
+  // ready_queues[0] stays unused
+  if (cpu_threads > 1) {
+    cpu_ready_queues = std::make_shared<CPUReadyQueues>(cpu_threads);
+    for (size_t i = 0; i < cpu_threads; ++i) {
+      std::thread t([this, i]() {
+        cpu_worker_index = i;
+        thread_init(-1);
+      });
+      t.detach();
+    }
+  } else {
+    std::thread t(&Engine::thread_init, this, -1);
+    t.detach();
+  }
+  for (int i = 1; i < num_threads; ++i) {
     std::thread t(&Engine::thread_init, this, i - 1);
     t.detach();
   }
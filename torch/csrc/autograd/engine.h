@@ -18,6 +18,7 @@
 
 namespace torch { namespace autograd {
 struct ReadyQueue;
+struct CPUReadyQueues;
 struct FunctionTask;
 struct GraphTask;
 }} // namespace torch::autograd
@@ -51,11 +52,18 @@ struct TORCH_API Engine {
 
   bool is_checkpoint_valid();
 
+  // Number of worker threads running CPU functions, 1 by default. With more
+  // than one, independent branches of the graph are evaluated in parallel.
+  // Must be set before the first backward pass.
+  void set_num_cpu_threads(size_t num_threads);
+  size_t get_num_cpu_threads();
+
 protected:
   void compute_dependencies(Function* root, GraphTask& task);
   void evaluate_function(FunctionTask& task);
   ReadyQueue& ready_queue(at::Device device);
   ReadyQueue& ready_queue_by_index(int device_index);
+  void push_ready(at::Device device, FunctionTask task);
   void start_threads();
   virtual void thread_init(int device);
   virtual void thread_main(GraphTask *graph_task);
@@ -63,6 +71,10 @@ protected:
 
   std::once_flag start_threads_flag;
   std::vector<std::shared_ptr<ReadyQueue>> ready_queues;
+  std::shared_ptr<CPUReadyQueues> cpu_ready_queues;
+  std::mutex num_cpu_threads_mutex;
+  size_t num_cpu_threads = 1;
+  bool threads_started = false;
   std::vector<std::function<void()>> final_callbacks;
   std::mutex post_callbacks_lock;
 };
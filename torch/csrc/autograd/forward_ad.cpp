@@ -0,0 +1,86 @@
+#include <torch/csrc/autograd/forward_ad.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+
+#include <utility>
+
+namespace torch { namespace autograd { namespace forward_ad {
+
+namespace detail {
+
+std::atomic<bool> has_dual_tensors{false};
+
+namespace {
+thread_local bool enabled_on_this_thread = true;
+} // namespace
+
+bool is_enabled_on_this_thread() {
+  return enabled_on_this_thread;
+}
+
+} // namespace detail
+
+DisableGuard::DisableGuard() : prev_enabled_(detail::enabled_on_this_thread) {
+  detail::enabled_on_this_thread = false;
+}
+
+DisableGuard::~DisableGuard() {
+  detail::enabled_on_this_thread = prev_enabled_;
+}
+
+at::Tensor make_dual(const at::Tensor& primal, const at::Tensor& tangent) {
+  AT_CHECK(primal.defined(), "make_dual: expected a defined primal");
+  AT_CHECK(
+      !as_variable_ref(primal).fw_grad().defined(),
+      "make_dual: the primal is already a dual tensor, and nested forward "
+      "mode AD is not supported");
+  AT_CHECK(
+      tangent.defined() && tangent.sizes() == primal.sizes() &&
+          tangent.type() == primal.type(),
+      "make_dual: expected a tangent of type ", primal.type(), " and size ",
+      primal.sizes());
+  detail::has_dual_tensors = true;
+  auto dual = primal.alias();
+  as_variable_ref(dual).set_fw_grad(tangent);
+  return dual;
+}
+
+std::pair<at::Tensor, at::Tensor> unpack_dual(const at::Tensor& dual) {
+  at::Tensor tangent = as_variable_ref(dual).fw_grad();
+  at::Tensor primal;
+  {
+    DisableGuard guard;
+    primal = dual.alias();
+  }
+  return {std::move(primal), std::move(tangent)};
+}
+
+std::pair<std::vector<at::Tensor>, std::vector<at::Tensor>> jvp(
+    const std::function<std::vector<at::Tensor>(const std::vector<at::Tensor>&)>&
+        function,
+    const std::vector<at::Tensor>& primals,
+    const std::vector<at::Tensor>& tangents) {
+  AT_CHECK(
+      primals.size() == tangents.size(),
+      "jvp: expected one tangent per primal, but got ", tangents.size(),
+      " tangents for ", primals.size(), " primals");
+  std::vector<at::Tensor> duals;
+  duals.reserve(primals.size());
+  for (size_t i = 0; i < primals.size(); ++i) {
+    duals.push_back(make_dual(primals[i], tangents[i]));
+  }
+  std::vector<at::Tensor> outputs;
+  std::vector<at::Tensor> output_tangents;
+  for (const auto& output : function(duals)) {
+    auto unpacked = unpack_dual(output);
+    if (!unpacked.second.defined()) {
+      unpacked.second = at::zeros_like(unpacked.first);
+    }
+    outputs.push_back(std::move(unpacked.first));
+    output_tangents.push_back(std::move(unpacked.second));
+  }
+  return {std::move(outputs), std::move(output_tangents)};
+}
+
+}}} // namespace torch::autograd::forward_ad
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <atomic>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd { namespace forward_ad {
+
+// Forward mode AD computes Jacobian-vector products alongside the forward
+// pass. A dual tensor made by make_dual carries a tangent, its forward
+// gradient, and the operators with a forward formula in derivatives.yaml (the
+// `result:` entries) give their results the tangent of the Jacobian of the
+// operator applied to the tangents of their inputs. Operators that are
+// implemented in terms of other operators propagate tangents through them;
+// differentiable operators without a forward formula throw when an input is
+// a dual tensor. Only one level of tangents is supported.
+//
+// The tangents are saved for backward along with the variables, so that the
+// backward pass of a function of dual tensors computes the tangents of the
+// gradients too: a Hessian-vector product is a JVP of the gradient function,
+// computed alongside a single backward pass instead of by a second backward
+// pass through a graph built with create_graph.
+
+namespace detail {
+// Set by the first make_dual, so that the operators skip the forward mode
+// with a single relaxed load until then.
+TORCH_API extern std::atomic<bool> has_dual_tensors;
+TORCH_API bool is_enabled_on_this_thread();
+} // namespace detail
+
+/// Whether the operators propagate tangents on this thread: a dual tensor was
+/// made at some point, and the tangents are not being computed right now.
+inline bool is_enabled() {
+  return detail::has_dual_tensors.load(std::memory_order_relaxed) &&
+      detail::is_enabled_on_this_thread();
+}
+
+/// Disables the propagation of tangents on this thread for the lifetime of the
+/// guard. The operators computing the tangents run under it.
+struct TORCH_API DisableGuard {
+  DisableGuard();
+  ~DisableGuard();
+
+ private:
+  bool prev_enabled_;
+};
+
+/// Returns an alias of `primal` whose forward gradient is `tangent`, which must
+/// have the same size, type and device.
+TORCH_API at::Tensor make_dual(
+    const at::Tensor& primal,
+    const at::Tensor& tangent);
+
+/// Returns an alias of `dual` without a forward gradient, and its forward
+/// gradient (undefined if it has none).
+TORCH_API std::pair<at::Tensor, at::Tensor> unpack_dual(const at::Tensor& dual);
+
+/// Computes the outputs of `function` at `primals` and their Jacobian-vector
+/// product with `tangents` in a single forward pass. The tangents of the
+/// outputs that do not depend on the primals are zeros.
+TORCH_API std::pair<std::vector<at::Tensor>, std::vector<at::Tensor>> jvp(
+    const std::function<std::vector<at::Tensor>(const std::vector<at::Tensor>&)>&
+        function,
+    const std::vector<at::Tensor>& primals,
+    const std::vector<at::Tensor>& tangents);
+
+inline bool is_fw_grad_defined(const at::Tensor& tensor) {
+  return tensor.defined() && as_variable_ref(tensor).fw_grad().defined();
+}
+
+inline bool is_fw_grad_defined(at::TensorList tensors) {
+  for (const auto& tensor : tensors) {
+    if (is_fw_grad_defined(tensor)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}}} // namespace torch::autograd::forward_ad
@@ -27,6 +27,82 @@ uint64_t& Function::get_next_sequence_nr() {
   return Function_next_sequence_nr_;
 }
 
+namespace {
+
+// Memory of freed Functions is kept in thread local free lists, one for each
+// size class of kFunctionSizeClass bytes, and reused for the next Functions
+// of that size. The lists are capped, so that threads freeing more Functions
+// than they allocate (e.g. ones releasing a graph built on another thread)
+// don't hold on to that memory.
+constexpr size_t kFunctionSizeClass = 16;
+constexpr size_t kNumFunctionSizeClasses = 64;
+constexpr size_t kMaxFreeFunctionsPerSizeClass = 64;
+
+struct FreeFunctionBlock {
+  FreeFunctionBlock* next;
+};
+
+struct FunctionPool {
+  ~FunctionPool();
+
+  FreeFunctionBlock* free_blocks[kNumFunctionSizeClasses] = {};
+  size_t num_free_blocks[kNumFunctionSizeClasses] = {};
+};
+
+// Set when the pool of the thread is destroyed at thread exit. Functions freed
+// after that (e.g. by destructors of other thread locals) go to the heap.
+thread_local bool function_pool_destroyed = false;
+thread_local FunctionPool function_pool;
+
+FunctionPool::~FunctionPool() {
+  for (size_t i = 0; i < kNumFunctionSizeClasses; ++i) {
+    while (free_blocks[i] != nullptr) {
+      FreeFunctionBlock* block = free_blocks[i];
+      free_blocks[i] = block->next;
+      ::operator delete(block);
+    }
+  }
+  function_pool_destroyed = true;
+}
+
+inline size_t function_size_class(size_t size) {
+  return (size + kFunctionSizeClass - 1) / kFunctionSizeClass - 1;
+}
+
+} // namespace
+
+void* Function::operator new(size_t size) {
+  const size_t size_class = function_size_class(size);
+  if (size_class >= kNumFunctionSizeClasses || function_pool_destroyed) {
+    return ::operator new(size);
+  }
+  FunctionPool& pool = function_pool;
+  FreeFunctionBlock* block = pool.free_blocks[size_class];
+  if (block == nullptr) {
+    return ::operator new((size_class + 1) * kFunctionSizeClass);
+  }
+  pool.free_blocks[size_class] = block->next;
+  --pool.num_free_blocks[size_class];
+  return block;
+}
+
+void Function::operator delete(void* ptr, size_t size) noexcept {
+  const size_t size_class = function_size_class(size);
+  if (size_class >= kNumFunctionSizeClasses || function_pool_destroyed) {
+    ::operator delete(ptr);
+    return;
+  }
+  FunctionPool& pool = function_pool;
+  if (pool.num_free_blocks[size_class] >= kMaxFreeFunctionsPerSizeClass) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto block = static_cast<FreeFunctionBlock*>(ptr);
+  block->next = pool.free_blocks[size_class];
+  pool.free_blocks[size_class] = block;
+  ++pool.num_free_blocks[size_class];
+}
+
 auto Function::name() const -> std::string {
   return c10::demangle(typeid(*this).name());
 }
@@ -109,6 +109,15 @@ struct TORCH_API Function : std::enable_shared_from_this<Function> {
   Function& operator=(Function&& other) = delete;
   virtual ~Function() = default;
 
+  /// A `Function` is allocated for every differentiable op, so their memory is
+  /// taken from and returned to a per-thread pool (see function.cpp).
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size) noexcept;
+  static void* operator new(size_t size, void* ptr) noexcept {
+    return ptr;
+  }
+  static void operator delete(void* ptr, void* place) noexcept {}
+
   /// Evaluates the function on the given inputs and returns the result of the
   /// function call.
   variable_list operator()(variable_list&& inputs) {
@@ -38,10 +38,14 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
     new_grad = (*hook)({new_grad})[0];
   }
 
+  // The tangent of a gradient computed from dual tensors (see forward_ad.h)
+  // is only kept by the out-of-place operators.
+  const bool is_dual = new_grad.fw_grad().defined();
   at::Tensor& grad = variable.grad();
   if (!grad.defined()) {
     // under following condition, we can avoid clone()
     if (!GradMode::is_enabled()
+        && !is_dual
         && !new_grad.is_sparse()
         && new_grad.is_contiguous()
         && new_grad.use_count() <= 1 + !post_hooks().empty()) {
@@ -56,7 +60,7 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
     } else {
       variable.grad() = new_grad.clone();
     }
-  } else if (!GradMode::is_enabled()) {
+  } else if (!GradMode::is_enabled() && !is_dual) {
     Variable& grad_variable = as_variable_ref(grad);
     // This case is not strictly necessary, but it makes the first-order only case
     // slightly more efficient and, what's more important, more predictable for
@@ -64,7 +68,16 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
     // a thing never promised and documented, but used in some hacks seen
     // on the internet.
     if (grad_variable.is_sparse() && !new_grad.is_sparse()) {
-      grad_variable.set_data(new_grad.data() + grad_variable.data());
+      // As above, the incoming gradient is reused for the dense sum if
+      // nothing else refers to it.
+      if (new_grad.layout() == at::kStrided
+          && new_grad.is_contiguous()
+          && new_grad.use_count() <= 1 + !post_hooks().empty()
+          && new_grad.storage().use_count() == 1) {
+        grad_variable.set_data(new_grad.data().add_(grad_variable.data()));
+      } else {
+        grad_variable.set_data(new_grad.data() + grad_variable.data());
+      }
     } else {
       grad_variable.data() += new_grad.data();
     }
@@ -0,0 +1,165 @@
+#include <torch/csrc/autograd/functions/checkpoint.h>
+
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/functions/utils.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/Exception.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+std::unique_ptr<at::Generator> copy_cpu_rng_state() {
+  auto state = at::getNonVariableType(at::Backend::CPU, at::kFloat).generator();
+  state->copy(at::globalContext().defaultGenerator(at::kCPU));
+  return state;
+}
+
+// Sets the state of the CPU generator for the lifetime of the guard.
+struct RNGStateGuard {
+  explicit RNGStateGuard(const at::Generator* state) {
+    if (state) {
+      original_ = copy_cpu_rng_state();
+      at::globalContext().defaultGenerator(at::kCPU).copy(*state);
+    }
+  }
+  ~RNGStateGuard() {
+    if (original_) {
+      at::globalContext().defaultGenerator(at::kCPU).copy(*original_);
+    }
+  }
+  std::unique_ptr<at::Generator> original_;
+};
+
+} // namespace
+
+CheckpointBackward::CheckpointBackward(
+    Forward forward,
+    const variable_list& inputs,
+    bool preserve_rng_state)
+    : forward_(std::move(forward)) {
+  inputs_.reserve(inputs.size());
+  inputs_require_grad_.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    inputs_.emplace_back(input, /*is_output=*/false);
+    inputs_require_grad_.push_back(input.defined() && input.requires_grad());
+  }
+  if (preserve_rng_state) {
+    rng_state_ = copy_cpu_rng_state();
+  }
+}
+
+auto CheckpointBackward::apply(variable_list&& grads) -> variable_list {
+  AT_CHECK(
+      Engine::get_default_engine().is_checkpoint_valid(),
+      "Checkpointing is not compatible with grad() restricted to some inputs, "
+      "please use backward() if possible");
+  AT_CHECK(
+      forward_,
+      "Trying to backward through a checkpointed function a second time, but "
+      "its inputs have already been freed. Specify keep_graph=true when "
+      "calling backward the first time.");
+
+  // Reruns the forward on leaves detached from the outer graph, so that the
+  // recomputed graph ends at them.
+  variable_list inputs;
+  inputs.reserve(inputs_.size());
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    auto input = inputs_[i].unpack();
+    if (input.defined()) {
+      input = input.detach();
+      input.set_requires_grad(inputs_require_grad_[i]);
+    }
+    inputs.push_back(std::move(input));
+  }
+  variable_list outputs;
+  {
+    RNGStateGuard rng_guard(rng_state_.get());
+    AutoGradMode grad_mode(true);
+    outputs = forward_(inputs);
+  }
+  AT_CHECK(
+      outputs.size() == grads.size(),
+      "The checkpointed function returned ", outputs.size(),
+      " outputs when recomputed, but ", grads.size(), " the first time");
+
+  edge_list roots;
+  variable_list root_grads;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (grads[i].defined() && outputs[i].defined() &&
+        outputs[i].requires_grad()) {
+      roots.push_back(outputs[i].gradient_edge());
+      root_grads.push_back(grads[i]);
+    }
+  }
+  variable_list grad_inputs(inputs.size());
+  if (roots.empty()) {
+    return grad_inputs;
+  }
+  // Like the backward of the outer graph, this accumulates into the grads of
+  // the leaves the function uses, such as parameters, and into the detached
+  // inputs. The engine runs this function with grad mode on if the outer
+  // backward creates a graph, which the recomputed backward must do too.
+  Engine::get_default_engine().execute(
+      roots,
+      root_grads,
+      /*keep_graph=*/false,
+      /*create_graph=*/GradMode::is_enabled());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (inputs_require_grad_[i]) {
+      grad_inputs[i] = inputs[i].grad();
+    }
+  }
+  return grad_inputs;
+}
+
+void CheckpointBackward::release_variables() {
+  forward_ = nullptr;
+  inputs_.clear();
+  rng_state_.reset();
+}
+
+variable_list checkpoint(
+    const CheckpointBackward::Forward& forward,
+    const variable_list& inputs,
+    bool preserve_rng_state) {
+  std::shared_ptr<CheckpointBackward> grad_fn;
+  if (compute_requires_grad(inputs)) {
+    grad_fn = std::make_shared<CheckpointBackward>(
+        forward, inputs, preserve_rng_state);
+    grad_fn->set_next_edges(collect_next_edges(inputs));
+  }
+
+  variable_list outputs;
+  {
+    // The outputs must not become views of the inputs' graph.
+    variable_list detached;
+    detached.reserve(inputs.size());
+    for (const auto& input : inputs) {
+      detached.push_back(input.defined() ? input.detach() : input);
+    }
+    AutoGradMode grad_mode(false);
+    outputs = forward(detached);
+  }
+  if (!grad_fn) {
+    return outputs;
+  }
+
+  for (auto& output : outputs) {
+    if (output.defined()) {
+      output = make_variable(output.data(), /*requires_grad=*/false);
+    }
+  }
+  set_history(outputs, grad_fn);
+  return outputs;
+}
+
+}}
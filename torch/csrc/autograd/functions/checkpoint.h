@@ -0,0 +1,58 @@
+#pragma once
+
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <ATen/ATen.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+// The backward of a checkpointed function (see `checkpoint()`). It holds the
+// inputs of the function instead of what the operators of the function saved
+// for their backward; apply() runs the function again on them with grad mode
+// on, rematerializing that state, and backpropagates through the recomputed
+// graph into the inputs. The recomputed graph is freed right after.
+struct TORCH_API CheckpointBackward : public Function {
+  using Forward = std::function<variable_list(const variable_list&)>;
+
+  CheckpointBackward(
+      Forward forward,
+      const variable_list& inputs,
+      bool preserve_rng_state);
+
+  variable_list apply(variable_list&& grads) override;
+  void release_variables() override;
+
+  Forward forward_;
+  std::vector<SavedVariable> inputs_;
+  std::vector<bool> inputs_require_grad_;
+  // The state of the CPU generator when the forward ran, restored for the
+  // recomputation so that random operators, such as dropout, make the same
+  // choices again.
+  std::unique_ptr<at::Generator> rng_state_;
+};
+
+// Runs `forward` on `inputs` without recording a graph, so that none of the
+// intermediate values its operators would save for backward stay alive, and
+// returns its outputs with a `CheckpointBackward` as their grad_fn. Backward
+// then recomputes the forward, trading compute for the memory of activations.
+// This is the C++ counterpart of torch.utils.checkpoint, without going through
+// Python, for the boundaries the caller chooses.
+//
+// `forward` must be deterministic, apart from the operators that draw from the
+// CPU generator if `preserve_rng_state`. The inputs must not be modified in
+// place before backward, which is checked like for a saved variable.
+// Checkpointing is not compatible with torch::autograd::grad() restricted to
+// some inputs; use backward().
+TORCH_API variable_list checkpoint(
+    const CheckpointBackward::Forward& forward,
+    const variable_list& inputs,
+    bool preserve_rng_state = true);
+
+}}
@@ -36,7 +36,11 @@ PyObject* THPAutograd_initExtension(PyObject* _unused) {
       .value("NVTX", ProfilerState::NVTX);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool>());
+      .def(
+          py::init<ProfilerState, bool, std::string>(),
+          py::arg("state"),
+          py::arg("report_input_shapes"),
+          py::arg("trace_path") = "");
 
   py::class_<Event>(m, "ProfilerEvent")
       .def("kind", &Event::kind)
@@ -9,6 +9,27 @@
 namespace torch { namespace autograd {
 
 
+namespace {
+
+// Returns whether the sum of two dense gradients can be accumulated in place
+// into var, instead of into a new tensor: var must be the only reference to
+// its storage, and must not be part of a graph, as when it is computed with
+// create_graph=True. Opaque tensors (e.g. MKL-DNN) have no storage to check,
+// so they are always summed into a new tensor.
+bool can_accumulate_into(const Variable& var, const Variable& other) {
+  if (var.layout() != at::kStrided || other.layout() != at::kStrided ||
+      !var.has_storage()) {
+    return false;
+  }
+  // The in-place operators do not support dual tensors
+  return !var.requires_grad() && var.use_count() == 1 &&
+      var.storage().use_count() == 1 && var.sizes() == other.sizes() &&
+      var.scalar_type() == other.scalar_type() && !var.fw_grad().defined() &&
+      !other.fw_grad().defined();
+}
+
+} // namespace
+
 void InputBuffer::add(size_t pos, Variable var) {
   AT_ASSERT(pos < buffer.size());
   if (!var.defined()) {
@@ -28,12 +49,20 @@ void InputBuffer::add(size_t pos, Variable var) {
       } else {
           buffer[pos] = var + old_var;
       }
-    } else {
-      if (var.is_sparse() && !old_var.is_sparse() && old_var.is_contiguous() && old_var.storage().use_count() == 1) {
-          buffer[pos] = old_var.add_(var);
+    } else if (var.is_sparse()) {
+      if (old_var.is_contiguous() && old_var.storage().use_count() == 1) {
+          old_var.add_(var);
       } else {
           buffer[pos] = old_var + var;
       }
+    } else if (can_accumulate_into(old_var, var)) {
+      // The gradients reaching the same input are mostly temporaries, so
+      // their sum reuses the memory of one of them.
+      old_var.add_(var);
+    } else if (can_accumulate_into(var, old_var)) {
+      buffer[pos] = var.add_(old_var);
+    } else {
+      buffer[pos] = old_var + var;
     }
   }
 }
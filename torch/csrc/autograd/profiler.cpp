@@ -1,11 +1,17 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/jit/code_template.h>
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <iomanip>
 #include <list>
+#include <map>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace torch { namespace autograd { namespace profiler {
@@ -27,6 +33,201 @@ std::list<std::shared_ptr<RangeEventList>> all_event_lists;
 thread_local std::shared_ptr<RangeEventList> event_list;
 thread_local uint16_t thread_id;
 
+namespace {
+
+// Streams events to a Chrome trace file from a background thread. Recording
+// threads hand their full blocks of events over through a bounded queue, and
+// wait for the writer when it falls behind instead of growing the queue, so
+// the memory held by the profiler doesn't grow with the length of the run.
+//
+// Ranges are written as begin/end pairs, which don't need to be matched up
+// before writing, and CUDA timings are attached per device, relative to a
+// start event recorded on each device when the writer is created.
+class TraceWriter {
+ public:
+  constexpr static size_t max_queued_blocks = 16;
+
+  TraceWriter(const std::string& path, bool record_cuda) : out_(path) {
+    AT_CHECK(out_, "could not open profiler trace file ", path);
+    out_ << std::fixed << std::setprecision(3) << "[";
+    start_ns_ = getTime();
+    if (record_cuda) {
+      // see the comments in enableProfiler on CUDA startup and start events
+      for (int i = 0; i < 5; i++) {
+        cuda_stubs->onEachDevice([](int d) {
+          Event(EventKind::Mark, StringView("__cuda_startup"), 0, true)
+              .destroy_cuda_event();
+          cuda_stubs->synchronize();
+        });
+      }
+      cuda_stubs->onEachDevice([this](int d) {
+        cuda_start_events_.emplace(
+            d, Event(EventKind::Mark, StringView("__cuda_start_event"), 0, true));
+      });
+    }
+    thread_ = std::thread([this] { run(); });
+  }
+
+  ~TraceWriter() {
+    if (thread_.joinable()) {
+      stop();
+    }
+  }
+
+  void submit(RangeEventList::block_type&& block) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    space_available_.wait(
+        lock, [this] { return queue_.size() < max_queued_blocks; });
+    queue_.push_back(std::move(block));
+    lock.unlock();
+    work_available_.notify_one();
+  }
+
+  // Writes out the queued blocks and closes the trace.
+  void finish() {
+    stop();
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    AT_CHECK(out_, "failed to write the profiler trace");
+  }
+
+ private:
+  void stop() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      done_ = true;
+    }
+    work_available_.notify_one();
+    thread_.join();
+    for (auto& start : cuda_start_events_) {
+      start.second.destroy_cuda_event();
+    }
+    out_ << "\n]\n";
+    out_.close();
+  }
+
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      work_available_.wait(lock, [this] { return done_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;
+      }
+      RangeEventList::block_type block = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      space_available_.notify_all();
+      if (!error_) {
+        try {
+          for (auto& e : block) {
+            write(e);
+          }
+        } catch (...) {
+          error_ = std::current_exception();
+        }
+      }
+      // free the block before taking the lock again
+      block = RangeEventList::block_type();
+      lock.lock();
+    }
+  }
+
+  void write(Event& e) {
+    const char* phase = nullptr;
+    switch (e.event_kind()) {
+      case EventKind::PushRange: phase = "B"; break;
+      case EventKind::PopRange: phase = "E"; break;
+      case EventKind::Mark: phase = "i"; break;
+    }
+    writeEvent(phase, e, (e.cpu_ns() - start_ns_) / 1000.0, "CPU functions");
+    if (e.has_cuda()) {
+      auto start = cuda_start_events_.find(e.device());
+      if (start != cuda_start_events_.end()) {
+        double ts = (start->second.cpu_ns() - start_ns_) / 1000.0 +
+            start->second.cuda_elapsed_us(e);
+        std::ostringstream pid;
+        pid << "CUDA device " << e.device();
+        writeEvent(phase, e, ts, pid.str());
+      }
+      e.destroy_cuda_event();
+    }
+  }
+
+  void writeEvent(const char* phase, const Event& e, double ts, const std::string& pid) {
+    out_ << (first_ ? "\n" : ",\n");
+    first_ = false;
+    out_ << "{\"name\": \"";
+    writeEscaped(e.name());
+    out_ << "\", \"ph\": \"" << phase << "\", \"ts\": " << ts
+         << ", \"pid\": \"" << pid << "\", \"tid\": " << e.thread_id();
+    if (e.event_kind() == EventKind::Mark) {
+      out_ << ", \"s\": \"t\"";
+    }
+    auto shapes = e.shapes();
+    if (!shapes.empty()) {
+      out_ << ", \"args\": {\"input_shapes\": [";
+      for (size_t i = 0; i < shapes.size(); ++i) {
+        out_ << (i > 0 ? ", " : "") << "[";
+        for (size_t j = 0; j < shapes[i].size(); ++j) {
+          out_ << (j > 0 ? ", " : "") << shapes[i][j];
+        }
+        out_ << "]";
+      }
+      out_ << "]}";
+    }
+    out_ << "}";
+  }
+
+  void writeEscaped(const char* str) {
+    for (; *str; ++str) {
+      if (*str == '"' || *str == '\\') {
+        out_ << '\\';
+      }
+      if (static_cast<unsigned char>(*str) >= 0x20) {
+        out_ << *str;
+      }
+    }
+  }
+
+  std::ofstream out_;
+  int64_t start_ns_;
+  std::map<int, Event> cuda_start_events_;
+  bool first_ = true;
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable space_available_;
+  std::deque<RangeEventList::block_type> queue_;
+  bool done_ = false;
+  std::exception_ptr error_;
+  std::thread thread_;
+};
+
+std::unique_ptr<TraceWriter> trace_writer;
+
+} // namespace
+
+void RangeEventList::allocBlock() {
+  size_t num_elements = num_block_elements;
+  if (trace_writer) {
+    if (!blocks.empty()) {
+      trace_writer->submit(std::move(blocks.front()));
+      blocks.pop_front();
+    }
+    num_elements = num_stream_block_elements;
+  }
+  blocks.emplace_front();
+  auto & new_block = blocks.front();
+  new_block.reserve(num_elements);
+  // Materialize all pages in the new block to release jitter when recording events.
+  const char * const end_ptr = reinterpret_cast<char*>(new_block.data() + num_elements);
+  for (volatile const char * ptr = reinterpret_cast<char*>(new_block.data());
+       ptr < end_ptr; ptr += 4 * 1024) {
+    (*ptr);
+  }
+}
+
 RangeEventList& getEventList() {
   if (!event_list) {
     std::lock_guard<std::mutex> guard(all_event_lists_mutex);
@@ -105,6 +306,16 @@ void enableProfiler(ProfilerConfig config) {
   if (state != ProfilerState::Disabled && new_state != state) {
     throw std::runtime_error("can't change kind of profiling (e.g. NVTX to CPU) while profiler is running");
   }
+  if (!config.trace_path.empty()) {
+    AT_CHECK(
+        new_state != ProfilerState::NVTX,
+        "NVTX profiling can't be streamed to a trace file");
+    AT_CHECK(
+        state == ProfilerState::Disabled,
+        "can't stream a profiler trace while the profiler is running");
+    trace_writer.reset(
+        new TraceWriter(config.trace_path, new_state == ProfilerState::CUDA));
+  }
 
   pushCallback(
       [config](const RecordFunction& fn) {
@@ -133,7 +344,8 @@ void enableProfiler(ProfilerConfig config) {
       config.report_input_shapes);
   state = new_state;
 
-  if(state == ProfilerState::CUDA) {
+  // the trace writer records its own start events
+  if(state == ProfilerState::CUDA && !trace_writer) {
     // event recording appears to have some startup overhead, so we need to
     // to generate some dummy events first before recording syncrhonization events
     for(int i = 0; i < 5; i++) {
@@ -170,7 +382,16 @@ thread_event_lists disableProfiler() {
     std::lock_guard<std::mutex> guard(all_event_lists_mutex);
     for (auto it = all_event_lists.begin(); it != all_event_lists.end();) {
       auto & list = *it;
-      result.emplace_back(list->consolidate());
+      if (trace_writer) {
+        // blocks are kept newest first
+        list->blocks.reverse();
+        for (auto & block : list->blocks) {
+          trace_writer->submit(std::move(block));
+        }
+        list->blocks.clear();
+      } else {
+        result.emplace_back(list->consolidate());
+      }
       // GC lists that are not held by any threads
       if (list.use_count() == 1) {
         auto current_it = it;
@@ -180,10 +401,21 @@ thread_event_lists disableProfiler() {
         ++it;
       }
     }
+    if (trace_writer) {
+      std::unique_ptr<TraceWriter> writer = std::move(trace_writer);
+      writer->finish();
+    }
     return result;
   }
 }
 
+void Event::destroy_cuda_event() {
+  if (event) {
+    cuda_stubs->destroy(event);
+    event = nullptr;
+  }
+}
+
 void Event::record(bool record_cuda) {
   if (record_cuda) {
     cuda_stubs->record(&device_, &event, &cpu_ns_);
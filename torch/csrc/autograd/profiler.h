@@ -33,6 +33,9 @@ struct TORCH_API CUDAStubs {
     fail();
     return 0.f;
   }
+  virtual void destroy(CUDAEventStub event) {
+    fail();
+  }
   virtual void nvtxMarkA(const char* name) {
     fail();
   }
@@ -102,10 +105,18 @@ enum class TORCH_API ProfilerState {
 };
 
 struct ProfilerConfig {
-  ProfilerConfig(ProfilerState state, bool report_input_shapes)
-      : state(state), report_input_shapes(report_input_shapes) {}
+  ProfilerConfig(
+      ProfilerState state,
+      bool report_input_shapes,
+      std::string trace_path = "")
+      : state(state),
+        report_input_shapes(report_input_shapes),
+        trace_path(std::move(trace_path)) {}
   ProfilerState state;
   bool report_input_shapes;
+  // If set, events are streamed to this file as a Chrome trace while
+  // profiling runs instead of being kept until disableProfiler().
+  std::string trace_path;
 };
 
 enum class TORCH_API EventKind : uint16_t {
@@ -132,6 +143,9 @@ struct TORCH_API Event final {
   }
 
   void record(bool record_cuda);
+  EventKind event_kind() const {
+    return kind_;
+  }
   std::string kind() const {
     switch(kind_) {
       case EventKind::Mark: return "mark";
@@ -149,10 +163,15 @@ struct TORCH_API Event final {
   std::vector<std::vector<int64_t>> shapes() const {
     return shapes_;
   }
+  int64_t cpu_ns() const {
+    return cpu_ns_;
+  }
   double cpu_elapsed_us(const Event & e) {
     return (e.cpu_ns_ - cpu_ns_)/(1000.0);
   }
   double cuda_elapsed_us(const Event & e);
+  // Releases the CUDA event once it is no longer needed for timing.
+  void destroy_cuda_event();
   bool has_cuda() const {
     return event != nullptr;
   }
@@ -173,6 +192,10 @@ private:
 // a linked-list of fixed sized vectors, to avoid
 // a std::vector resize from taking a large amount of time inside
 // a profiling  event
+//
+// When streaming to a trace file, full blocks are handed over to the trace
+// writer instead, so each thread only ever holds the block it records into.
+// Blocks are smaller then, to bound the memory held by idle threads.
 struct RangeEventList {
   constexpr static size_t MB = 1024 * 1024;
   constexpr static size_t event_block_size = 16 * MB;
@@ -180,23 +203,17 @@ struct RangeEventList {
     event_block_size / ceilToMultiple(sizeof(Event), alignof(Event));
   static_assert(sizeof(Event[num_block_elements]) <= event_block_size,
                 "num_block_elements is calculated incorrectly");
+  constexpr static size_t stream_block_size = 1 * MB;
+  constexpr static size_t num_stream_block_elements =
+    stream_block_size / ceilToMultiple(sizeof(Event), alignof(Event));
   using block_type = std::vector<Event>;
 
-  void allocBlock() {
-    blocks.emplace_front();
-    auto & new_block = blocks.front();
-    new_block.reserve(num_block_elements);
-    // Materialize all pages in the new block to release jitter when recording events.
-    const char * const end_ptr = reinterpret_cast<char*>(new_block.data() + num_block_elements);
-    for (volatile const char * ptr = reinterpret_cast<char*>(new_block.data());
-         ptr < end_ptr; ptr += 4 * 1024) {
-      (*ptr);
-    }
-  }
+  // Defined in profiler.cpp, as it hands full blocks to the trace writer.
+  void allocBlock();
 
   template<typename... Args>
   void record(Args&&... args) {
-    if (blocks.empty() || blocks.front().size() == num_block_elements) {
+    if (blocks.empty() || blocks.front().size() == blocks.front().capacity()) {
       allocBlock();
     }
     blocks.front().emplace_back(std::forward<Args>(args)...);
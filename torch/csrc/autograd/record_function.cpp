@@ -1,47 +1,132 @@
 #include <torch/csrc/autograd/record_function.h>
 #include <torch/csrc/autograd/function.h>
 
+#include <mutex>
+#include <random>
+
 namespace torch { namespace autograd { namespace profiler {
 
+namespace detail {
+
+struct Callback {
+  RecordFunctionCallback start;
+  RecordFunctionCallback end;
+  bool needs_inputs;
+  double sampling_prob;
+};
+
+struct CallbackList {
+  std::vector<Callback> callbacks;
+};
+
+std::atomic<bool> has_callbacks{false};
+
+} // namespace detail
+
 namespace {
-std::vector<RecordFunctionCallback> start_callbacks;
-std::vector<RecordFunctionCallback> end_callbacks;
-size_t callback_needs_inputs = 0;
+
+constexpr size_t kMaxCallbacks = 64;
+
+std::mutex callbacks_mutex;
+std::atomic<bool> callbacks_need_inputs{false};
+
+// The registered callbacks. The list is never modified but replaced under
+// callbacks_mutex, so that RecordFunctions can read it without locking and
+// keep the one they started with.
+std::shared_ptr<const detail::CallbackList>& registered_callbacks() {
+  static std::shared_ptr<const detail::CallbackList> callbacks =
+      std::make_shared<detail::CallbackList>();
+  return callbacks;
+}
+
+// Precondition: callbacks_mutex is locked
+void set_callbacks(std::shared_ptr<const detail::CallbackList> callbacks) {
+  bool need_inputs = false;
+  for (const auto& cb : callbacks->callbacks) {
+    need_inputs |= cb.needs_inputs;
+  }
+  callbacks_need_inputs = need_inputs;
+  detail::has_callbacks = !callbacks->callbacks.empty();
+  std::atomic_store(&registered_callbacks(), std::move(callbacks));
+}
+
 thread_local RecordFunction* thread_local_func_ = nullptr;
+thread_local bool record_function_enabled_ = true;
+
+bool sample_callback(double sampling_prob) {
+  if (sampling_prob >= 1.0) {
+    return true;
+  }
+  static thread_local std::minstd_rand generator{std::random_device{}()};
+  return std::uniform_real_distribution<double>(0.0, 1.0)(generator) < sampling_prob;
 }
 
+} // namespace
+
 void pushCallback(
     RecordFunctionCallback start,
     RecordFunctionCallback end,
-    bool needs_inputs) {
-  start_callbacks.push_back(start);
-  end_callbacks.push_back(end);
-  if (callback_needs_inputs > 0 || needs_inputs) {
-    ++callback_needs_inputs;
-  }
+    bool needs_inputs,
+    double sampling_prob) {
+  AT_CHECK(
+      sampling_prob >= 0.0 && sampling_prob <= 1.0,
+      "RecordFunction callbacks need a sampling probability in [0, 1], got ",
+      sampling_prob);
+  std::lock_guard<std::mutex> guard(callbacks_mutex);
+  auto callbacks = std::make_shared<detail::CallbackList>(*registered_callbacks());
+  AT_CHECK(
+      callbacks->callbacks.size() < kMaxCallbacks,
+      "Can't register more than ", kMaxCallbacks, " RecordFunction callbacks");
+  callbacks->callbacks.push_back(
+      detail::Callback{std::move(start), std::move(end), needs_inputs, sampling_prob});
+  set_callbacks(std::move(callbacks));
 }
 
 void popCallback() {
-  if (start_callbacks.empty()) {
+  std::lock_guard<std::mutex> guard(callbacks_mutex);
+  if (registered_callbacks()->callbacks.empty()) {
     throw std::runtime_error("Empty callbacks stack");
   }
-  start_callbacks.pop_back();
-  end_callbacks.pop_back();
-  if (callback_needs_inputs > 0) {
-    --callback_needs_inputs;
-  }
+  auto callbacks = std::make_shared<detail::CallbackList>(*registered_callbacks());
+  callbacks->callbacks.pop_back();
+  set_callbacks(std::move(callbacks));
 }
 
-bool hasCallbacks() {
-  return !start_callbacks.empty();
+bool needsInputs() {
+  return callbacks_need_inputs;
 }
 
-bool needsInputs() {
-  return callback_needs_inputs > 0;
+bool isRecordFunctionEnabled() {
+  return record_function_enabled_;
+}
+
+void enableRecordFunction(bool enable) {
+  record_function_enabled_ = enable;
+}
+
+bool RecordFunction::sample() {
+  if (!sampled_) {
+    sampled_ = true;
+    if (!hasCallbacks() || !record_function_enabled_) {
+      return false;
+    }
+    auto callbacks = std::atomic_load(&registered_callbacks());
+    for (size_t i = 0; i < callbacks->callbacks.size(); ++i) {
+      const auto& cb = callbacks->callbacks[i];
+      if (sample_callback(cb.sampling_prob)) {
+        picked_callbacks_ |= (uint64_t(1) << i);
+        needs_inputs_ |= cb.needs_inputs;
+      }
+    }
+    if (picked_callbacks_ != 0) {
+      callbacks_ = std::move(callbacks);
+    }
+  }
+  return picked_callbacks_ != 0;
 }
 
 void RecordFunction::before(const char* name, int64_t sequence_nr) {
-  if (!hasCallbacks()) {
+  if (!sample()) {
     return;
   }
   AT_ASSERT(!initialized_);
@@ -53,7 +138,7 @@ void RecordFunction::before(const char* name, int64_t sequence_nr) {
 }
 
 void RecordFunction::before(std::string name, int64_t sequence_nr) {
-  if (!hasCallbacks()) {
+  if (!sample()) {
     return;
   }
   AT_ASSERT(!initialized_);
@@ -65,7 +150,7 @@ void RecordFunction::before(std::string name, int64_t sequence_nr) {
 }
 
 void RecordFunction::before(Function* fn, int64_t sequence_nr) {
-  if (!hasCallbacks()) {
+  if (!sample()) {
     return;
   }
   AT_ASSERT(!initialized_);
@@ -81,18 +166,22 @@ void RecordFunction::processCallbacks() {
   parent_ = thread_local_func_;
   thread_local_func_ = this;
 
-  for (const auto& cb : start_callbacks) {
-    cb(*this);
+  const auto& callbacks = callbacks_->callbacks;
+  for (size_t i = 0; i < callbacks.size(); ++i) {
+    if (picked_callbacks_ & (uint64_t(1) << i)) {
+      callbacks[i].start(*this);
+    }
   }
 }
 
-RecordFunction::~RecordFunction() {
-  if (initialized_) {
-    for (const auto& cb : end_callbacks) {
-      cb(*this);
+void RecordFunction::end() {
+  const auto& callbacks = callbacks_->callbacks;
+  for (size_t i = 0; i < callbacks.size(); ++i) {
+    if (picked_callbacks_ & (uint64_t(1) << i)) {
+      callbacks[i].end(*this);
     }
-    thread_local_func_ = parent_;
   }
+  thread_local_func_ = parent_;
 }
 
 }}}
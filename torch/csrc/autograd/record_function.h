@@ -4,6 +4,8 @@
 #include <c10/util/SmallVector.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <atomic>
+
 namespace torch { namespace autograd {
 
 struct Function;
@@ -26,10 +28,28 @@ struct TORCH_API StringView {
   const char* str_ptr_;
 };
 
+namespace detail {
+struct CallbackList;
+// Whether any callbacks are registered, see hasCallbacks()
+TORCH_API extern std::atomic<bool> has_callbacks;
+}
+
 struct TORCH_API RecordFunction {
   // Default constructor is used with before function called afterwards
   RecordFunction() {}
 
+  // Picks the callbacks that run for this function: none if recording is
+  // disabled on this thread, otherwise each callback with the probability it
+  // was registered with. Returns whether any callback was picked; if not,
+  // calls to before() don't do anything. before() calls this itself if it
+  // wasn't called yet.
+  bool sample();
+
+  // Whether any of the picked callbacks looks at the inputs
+  bool needsInputs() const {
+    return needs_inputs_;
+  }
+
   // before function initializes RecordFunction members and calls
   // start callbacks
   void before(const char* name, int64_t sequence_nr = -1);
@@ -41,6 +61,9 @@ struct TORCH_API RecordFunction {
       F fn,
       c10::ArrayRef<c10::IValue> args,
       int64_t current_sequence_nr = -1) {
+    if (!sample()) {
+      return;
+    }
     inputs_ = args.vec();
     before(fn, current_sequence_nr);
   }
@@ -50,12 +73,19 @@ struct TORCH_API RecordFunction {
       F fn,
       std::vector<c10::IValue>&& args,
       int64_t current_sequence_nr = -1) {
+    if (!sample()) {
+      return;
+    }
     inputs_ = std::move(args);
     before(fn, current_sequence_nr);
   }
 
   // Destructor calls end callbacks
-  virtual ~RecordFunction();
+  virtual ~RecordFunction() {
+    if (initialized_) {
+      end();
+    }
+  }
 
   inline Function* func() const {
     return fn_;
@@ -79,6 +109,7 @@ struct TORCH_API RecordFunction {
 
  private:
   void processCallbacks();
+  void end();
 
   Function* fn_ = nullptr;
   StringView name_;
@@ -86,31 +117,70 @@ struct TORCH_API RecordFunction {
   std::vector<c10::IValue> inputs_;
   RecordFunction* parent_ = nullptr;
 
+  // The callbacks registered when this function was sampled, and a bit mask
+  // of the ones picked to run for it
+  std::shared_ptr<const detail::CallbackList> callbacks_;
+  uint64_t picked_callbacks_ = 0;
+  bool sampled_ = false;
+  bool needs_inputs_ = false;
+
   bool initialized_ = false;
 };
 
-TORCH_API bool hasCallbacks();
+// Whether any callbacks are registered. This is a single relaxed load,
+// so unprofiled code only pays for a branch.
+inline bool hasCallbacks() {
+  return detail::has_callbacks.load(std::memory_order_relaxed);
+}
+
 TORCH_API bool needsInputs();
 
 // optional argument - function's seq_no
 #define RECORD_FUNCTION(fn, inputs, ...) \
   torch::autograd::profiler::RecordFunction guard; \
-  if (torch::autograd::profiler::hasCallbacks()) { \
-    if (torch::autograd::profiler::needsInputs()) { \
+  if (torch::autograd::profiler::hasCallbacks() && guard.sample()) { \
+    if (guard.needsInputs()) { \
       guard.before(fn, inputs, ##__VA_ARGS__); \
     } else { \
       guard.before(fn, ##__VA_ARGS__); \
     } \
   }
 
-// WARNING: all calls to pushCallback/popCallback are not thread safe and
-// must not overlap with other code execution
+// Registers start and end callbacks, called around every RecordFunction.
+// If sampling_prob is less than 1, each RecordFunction only calls them with
+// that probability, so that e.g. 0.001 profiles about 1 in 1000 ops.
+// Calls to pushCallback/popCallback are thread safe. RecordFunctions that are
+// running while the callbacks change keep calling the callbacks they started
+// with. Up to 64 callbacks can be registered at the same time.
 using RecordFunctionCallback = std::function<void(const RecordFunction&)>;
 TORCH_API void pushCallback(
     RecordFunctionCallback start,
     RecordFunctionCallback end = [](const RecordFunction&){},
-    bool needs_inputs = false);
+    bool needs_inputs = false,
+    double sampling_prob = 1.0);
 TORCH_API void popCallback();
 
+// Whether RecordFunctions call the registered callbacks on this thread
+// (default: true). A server can use this to only profile the ops of some of
+// its requests.
+TORCH_API bool isRecordFunctionEnabled();
+TORCH_API void enableRecordFunction(bool enable);
+
+// RAII guard that enables or disables RecordFunction callbacks on this thread
+// and restores the previous setting on destruction.
+struct TORCH_API RecordFunctionGuard {
+  explicit RecordFunctionGuard(bool enable = true)
+      : prev_enabled_(isRecordFunctionEnabled()) {
+    enableRecordFunction(enable);
+  }
+
+  ~RecordFunctionGuard() {
+    enableRecordFunction(prev_enabled_);
+  }
+
+ private:
+  bool prev_enabled_;
+};
+
 } // namespace profiler
 }} // namespace torch::autograd
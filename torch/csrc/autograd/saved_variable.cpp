@@ -14,6 +14,23 @@
 
 namespace torch { namespace autograd {
 
+namespace {
+thread_local SavedTensorHooks* current_hooks = nullptr;
+} // namespace
+
+SavedTensorHooks* SavedTensorHooks::current() {
+  return current_hooks;
+}
+
+SavedTensorHooksGuard::SavedTensorHooksGuard(SavedTensorHooks* hooks)
+    : previous_(current_hooks) {
+  current_hooks = hooks;
+}
+
+SavedTensorHooksGuard::~SavedTensorHooksGuard() {
+  current_hooks = previous_;
+}
+
 SavedVariable::SavedVariable(const Variable& variable, bool is_output) {
   if (variable.defined()) {
     was_default_constructed_ = false;
@@ -22,7 +39,19 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output) {
     has_grad_fn_ = !variable.is_leaf();
     // These copies are all shared_ptr copies, so slightly more expensive.
     // Do them here instead of in the init list in case data is undefined.
-    data_ = variable.data();
+    if (auto hooks = current_hooks) {
+      // The hooks are not applied to the variables saved by their own ops.
+      SavedTensorHooksGuard guard(nullptr);
+      packed_ = hooks->pack(variable);
+    }
+    if (!packed_) {
+      data_ = variable.data();
+    }
+    // Saved with the variable, so that the backward of a function of dual
+    // tensors computes the tangents of the gradients (see forward_ad.h).
+    if (variable.fw_grad().defined()) {
+      fw_grad_ = variable.fw_grad().detach();
+    }
     if (variable.is_leaf()) {
       grad_accumulator_ = variable.grad_accumulator();
     } else if (!is_output) {
@@ -34,7 +63,7 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output) {
 }
 
 Variable SavedVariable::unpack(std::shared_ptr<Function> saved_for) const {
-  if (!data_.defined()) {
+  if (!data_.defined() && !packed_) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -51,11 +80,13 @@ Variable SavedVariable::unpack(std::shared_ptr<Function> saved_for) const {
     grad_fn = std::move(saved_for);
   }
 
+  const auto data = packed_ ? packed_->unpack() : data_;
+
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.type().toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation: [" << data.type().toString() << " "
+        << data.sizes() << "]";
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -80,11 +111,14 @@ Variable SavedVariable::unpack(std::shared_ptr<Function> saved_for) const {
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   var.set_version_counter(saved_version_);
+  if (fw_grad_.defined()) {
+    var.set_fw_grad(fw_grad_);
+  }
 
   // If a Variable is a leaf (no grad_fn saved), and it requires_grad, then we
   // should have saved the grad accumulator. Even if the Variable no longer
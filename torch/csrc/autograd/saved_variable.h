@@ -14,6 +14,45 @@ struct Function;
 
 TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
+/// The form in which `SavedTensorHooks` store the data of a saved variable
+/// until it is unpacked.
+struct TORCH_API PackedTensor {
+  virtual ~PackedTensor() = default;
+
+  /// Returns the data of the saved variable, which like `Variable::data()` is
+  /// not a variable. Called every time the variable is unpacked, from the
+  /// thread running the backward pass.
+  virtual at::Tensor unpack() = 0;
+};
+
+/// Hooks that decide how the data of the variables saved for the backward
+/// pass is stored in the meantime, e.g. to move it out of device memory.
+/// The hooks installed on a thread with `SavedTensorHooksGuard` are called
+/// for every variable saved on that thread.
+struct TORCH_API SavedTensorHooks {
+  virtual ~SavedTensorHooks() = default;
+
+  /// Returns the packed form of the data of `variable`, or nullptr to save
+  /// the data as is.
+  virtual std::shared_ptr<PackedTensor> pack(const Variable& variable) = 0;
+
+  /// Returns the hooks installed on the current thread, or nullptr.
+  static SavedTensorHooks* current();
+};
+
+/// Installs `hooks` on the current thread for the lifetime of the guard. The
+/// hooks must outlive the guard; the variables they packed may outlive both.
+struct TORCH_API SavedTensorHooksGuard {
+  explicit SavedTensorHooksGuard(SavedTensorHooks* hooks);
+  ~SavedTensorHooksGuard();
+
+  SavedTensorHooksGuard(const SavedTensorHooksGuard&) = delete;
+  SavedTensorHooksGuard& operator=(const SavedTensorHooksGuard&) = delete;
+
+ private:
+  SavedTensorHooks* previous_;
+};
+
 /// A snapshot of a variable at a certain version. A `SavedVariable` stores
 /// enough information to reconstruct a variable from a certain point in time.
 class TORCH_API SavedVariable {
@@ -29,7 +68,9 @@ class TORCH_API SavedVariable {
   Variable unpack(std::shared_ptr<Function> saved_for = nullptr) const;
 
   void reset_data() {
-    return data_.reset();
+    data_.reset();
+    packed_.reset();
+    fw_grad_.reset();
   }
 
   void reset_grad_function() {
@@ -38,6 +79,11 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // The data as packed by the SavedTensorHooks, in which case data_ is
+  // undefined.
+  std::shared_ptr<PackedTensor> packed_;
+  // The forward gradient of a dual tensor, detached from its graph.
+  at::Tensor fw_grad_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
@@ -282,6 +282,18 @@ struct TORCH_API Variable : public at::Tensor {
   const std::vector<std::shared_ptr<FunctionPreHook>>& hooks() const noexcept;
   void clear_hooks();
 
+  // Forward Mode
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  /// Returns the forward gradient (the tangent) of this `Variable`, which is
+  /// only defined for dual tensors and the results of operators on them. See
+  /// forward_ad.h.
+  const Variable& fw_grad() const noexcept;
+
+  /// Sets the forward gradient of this `Variable`, which must have the same
+  /// size, or be undefined to make it a regular `Variable` again.
+  void set_fw_grad(const at::Tensor& fw_grad);
+
   // View Variables
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -330,6 +342,8 @@ struct TORCH_API Variable::AutogradMeta : public c10::AutogradMetaInterface {
   std::string name;
 
   Variable grad_;
+  // The tangent of a dual tensor, propagated by the operators in forward mode
+  Variable fw_grad_;
   std::shared_ptr<Function> grad_fn_;
   std::weak_ptr<Function> grad_accumulator_;
 
@@ -409,7 +423,7 @@ struct TORCH_API Variable::Impl : public at::TensorImpl {
   int64_t numel() const override;
   at::IntArrayRef sizes() const override;
   at::IntArrayRef strides() const override;
-  bool is_contiguous() const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
   int64_t size(int64_t d) const override;
   int64_t stride(int64_t d) const override;
   void resize_dim(int64_t ndim) override;
@@ -721,6 +735,18 @@ inline void Variable::clear_hooks() {
   get_autograd_meta()->hooks_.clear();
 }
 
+// Forward Mode
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+inline const Variable& Variable::fw_grad() const noexcept {
+  return get_autograd_meta()->fw_grad_;
+}
+
+inline void Variable::set_fw_grad(const at::Tensor& fw_grad) {
+  get_autograd_meta()->fw_grad_ =
+      fw_grad.defined() ? as_variable_ref(fw_grad) : Variable();
+}
+
 // View Variables
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -0,0 +1,34 @@
+#include <torch/csrc/python_headers.h>
+
+#include <torch/csrc/utils/pybind.h>
+
+#include <ATen/cuda/CUDAGraph.h>
+
+template <typename T>
+using shared_ptr_class_ = py::class_<T, std::shared_ptr<T>>;
+
+void THCPGraph_init(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+
+  // The GIL is released around the calls that only queue or tear down CUDA
+  // work; capture_begin allocates, which may run Python free memory hooks
+  shared_ptr_class_<at::cuda::CUDAGraph>(m, "_CUDAGraph")
+      .def(py::init<>())
+      .def(
+          "capture_begin",
+          &at::cuda::CUDAGraph::capture_begin,
+          py::arg("pool") = 0)
+      .def(
+          "capture_end",
+          &at::cuda::CUDAGraph::capture_end,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "replay",
+          &at::cuda::CUDAGraph::replay,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "reset",
+          &at::cuda::CUDAGraph::reset,
+          py::call_guard<py::gil_scoped_release>())
+      .def("pool", &at::cuda::CUDAGraph::pool);
+}
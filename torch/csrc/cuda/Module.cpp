@@ -205,6 +205,43 @@ PyObject * THCPModule_cudaHostAllocator(PyObject *_unused)
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_hostEmptyCache(PyObject *_unused)
+{
+  HANDLE_TH_ERRORS
+  THCCachingHostAllocator_emptyCache();
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_hostReserve(PyObject *_unused, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkLong(arg), "invalid argument to reserve_host_memory");
+  int64_t size = THPUtils_unpackLong(arg);
+  THPUtils_assert(size >= 0, "reserve_host_memory: size must be non-negative");
+  {
+    pybind11::gil_scoped_release no_gil;
+    THCudaCheck(THCCachingHostAllocator_reserve(static_cast<size_t>(size)));
+  }
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused)
+{
+  HANDLE_TH_ERRORS
+  auto stats = THCCachingHostAllocator_getStats();
+  py::dict result;
+  result["allocated_bytes"] = stats.allocated;
+  result["max_allocated_bytes"] = stats.max_allocated;
+  result["cached_bytes"] = stats.cached;
+  result["max_cached_bytes"] = stats.max_cached;
+  result["num_host_allocs"] = stats.num_host_allocs;
+  result["num_host_frees"] = stats.num_host_frees;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject * THCPModule_cudaSynchronize(PyObject *_unused)
 {
   HANDLE_TH_ERRORS
@@ -334,6 +371,91 @@ PyObject * THCPModule_resetMaxMemoryCached(PyObject *_unused, PyObject *arg)
   Py_RETURN_NONE;
 }
 
+PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  using c10::cuda::CUDACachingAllocator::SegmentInfo;
+  using c10::cuda::CUDACachingAllocator::BlockInfo;
+
+  std::vector<SegmentInfo> snapshot;
+  {
+    pybind11::gil_scoped_release no_gil;
+    snapshot = c10::cuda::CUDACachingAllocator::snapshot();
+  }
+
+  py::list result;
+  for (const SegmentInfo& segment_info : snapshot) {
+    py::dict segment;
+    segment["device"] = segment_info.device;
+    segment["address"] = segment_info.address;
+    segment["total_size"] = segment_info.total_size;
+    segment["allocated_size"] = segment_info.allocated_size;
+    segment["stream"] = reinterpret_cast<int64_t>(segment_info.stream);
+    segment["segment_type"] = segment_info.is_large ? "large" : "small";
+    segment["is_expandable"] = segment_info.is_expandable;
+
+    py::list blocks;
+    for (const BlockInfo& block_info : segment_info.blocks) {
+      py::dict block;
+      block["size"] = block_info.size;
+      block["state"] = block_info.allocated
+          ? "active_allocated"
+          : (block_info.pending_free ? "active_pending_free" : "inactive");
+      blocks.append(block);
+    }
+    segment["blocks"] = blocks;
+    result.append(segment);
+  }
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_recordMemoryHistory(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject *enabled_o = nullptr;
+  PyObject *max_entries_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &enabled_o, &max_entries_o)) {
+    return nullptr;
+  }
+  THPUtils_assert(PyBool_Check(enabled_o) && THPUtils_checkLong(max_entries_o),
+      "invalid arguments to _record_memory_history");
+  bool enabled = enabled_o == Py_True;
+  int64_t max_entries = THPUtils_unpackLong(max_entries_o);
+  THPUtils_assert(max_entries > 0, "max_entries must be positive");
+  c10::cuda::CUDACachingAllocator::recordHistory(enabled, nullptr, max_entries);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject * THCPModule_memoryHistory(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  using c10::cuda::CUDACachingAllocator::TraceEntry;
+
+  std::vector<TraceEntry> history =
+      c10::cuda::CUDACachingAllocator::getHistory();
+
+  py::list result;
+  for (const TraceEntry& entry : history) {
+    py::dict trace;
+    switch (entry.action) {
+      case TraceEntry::ALLOC: trace["action"] = "alloc"; break;
+      case TraceEntry::FREE: trace["action"] = "free"; break;
+      case TraceEntry::SEGMENT_ALLOC: trace["action"] = "segment_alloc"; break;
+      case TraceEntry::SEGMENT_FREE: trace["action"] = "segment_free"; break;
+    }
+    trace["device"] = entry.device;
+    trace["address"] = entry.address;
+    trace["size"] = entry.size;
+    trace["stream"] = reinterpret_cast<int64_t>(entry.stream);
+    trace["stack_id"] = entry.stack_id;
+    result.append(trace);
+  }
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -445,12 +567,18 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_memoryCached", (PyCFunction) THCPModule_memoryCached, METH_O,  nullptr},
   {"_cuda_maxMemoryCached", (PyCFunction) THCPModule_maxMemoryCached, METH_O,  nullptr},
   {"_cuda_resetMaxMemoryCached", (PyCFunction) THCPModule_resetMaxMemoryCached, METH_O,  nullptr},
+  {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
+  {"_cuda_recordMemoryHistory", (PyCFunction) THCPModule_recordMemoryHistory, METH_VARARGS, nullptr},
+  {"_cuda_memoryHistory", (PyCFunction) THCPModule_memoryHistory, METH_NOARGS, nullptr},
   {"_cuda_manualSeed",  (PyCFunction)THCPModule_manualSeed,       METH_O,       nullptr},
   {"_cuda_manualSeedAll", (PyCFunction)THCPModule_manualSeedAll,  METH_O,       nullptr},
   {"_cuda_seed",        (PyCFunction)THCPModule_seed,             METH_NOARGS,  nullptr},
   {"_cuda_seedAll",     (PyCFunction)THCPModule_seedAll,          METH_NOARGS,  nullptr},
   {"_cuda_initialSeed", (PyCFunction)THCPModule_initialSeed,      METH_NOARGS,  nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
+  {"_cuda_hostEmptyCache", (PyCFunction)THCPModule_hostEmptyCache, METH_NOARGS, nullptr},
+  {"_cuda_hostReserve", (PyCFunction)THCPModule_hostReserve, METH_O, nullptr},
+  {"_cuda_hostMemoryStats", (PyCFunction)THCPModule_hostMemoryStats, METH_NOARGS, nullptr},
   {"_cuda_synchronize", (PyCFunction)THCPModule_cudaSynchronize, METH_NOARGS, nullptr},
   {"_cuda_ipc_collect", (PyCFunction)THCPModule_cudaIPCCollect, METH_NOARGS, nullptr},
   {"_cuda_sleep", (PyCFunction)THCPModule_cudaSleep, METH_O, nullptr},
@@ -473,10 +601,13 @@ PyMethodDef* THCPModule_methods() {
   return _THCPModule_methods;
 }
 
+void THCPGraph_init(PyObject *module);
+
 namespace torch { namespace cuda {
 
 void initModule(PyObject *module) {
   python::initCommMethods(module);
+  THCPGraph_init(module);
 }
 
 }}
@@ -0,0 +1,164 @@
+#include <torch/csrc/cuda/activation_offload.h>
+
+#include <torch/csrc/autograd/variable.h>
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace cuda {
+
+using autograd::PackedTensor;
+using autograd::Variable;
+
+namespace {
+
+struct OffloadedTensor;
+
+} // namespace
+
+struct ActivationOffloader::State {
+  explicit State(ActivationOffloadOptions options) : options(options) {}
+
+  // Returns the stream of `device` on which the copies are queued. Requires
+  // the mutex.
+  at::cuda::CUDAStream side_stream(at::DeviceIndex device) {
+    auto it = side_streams.find(device);
+    if (it == side_streams.end()) {
+      it = side_streams
+               .emplace(device, at::cuda::getStreamFromPool(false, device))
+               .first;
+    }
+    return it->second;
+  }
+
+  // Starts copying back the tensors offloaded before the one at `index`.
+  // Requires the mutex.
+  void prefetch_before(size_t index);
+
+  const ActivationOffloadOptions options;
+  std::mutex mutex;
+  std::map<at::DeviceIndex, at::cuda::CUDAStream> side_streams;
+  // The offloaded tensors, in the order they were saved.
+  std::vector<std::weak_ptr<OffloadedTensor>> offloaded;
+};
+
+namespace {
+
+struct OffloadedTensor : public PackedTensor {
+  // Queues the copy of `data` to pinned host memory on the side stream.
+  // Requires the mutex of the state.
+  OffloadedTensor(
+      std::shared_ptr<ActivationOffloader::State> state,
+      size_t index,
+      const at::Tensor& data)
+      : state_(std::move(state)), index_(index), device_(data.device()) {
+    const auto current = at::cuda::getCurrentCUDAStream(device_.index());
+    const auto side = state_->side_stream(device_.index());
+    // The copy waits for the ops that compute data, and the memory of data is
+    // not reused until the copy is done.
+    at::cuda::CUDAEvent computed;
+    computed.record(current);
+    computed.block(side);
+    c10::cuda::CUDACachingAllocator::recordStream(data.storage().data(), side);
+
+    c10::cuda::CUDAStreamGuard guard(side);
+    host_ = at::empty(
+        data.sizes(), data.options().device(at::kCPU).pinned_memory(true));
+    host_.copy_(data, /*non_blocking=*/true);
+    offloaded_.record(side);
+  }
+
+  at::Tensor unpack() override {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    const auto current = at::cuda::getCurrentCUDAStream(device_.index());
+    at::Tensor data;
+    if (prefetched_.defined()) {
+      data = std::move(prefetched_);
+      prefetched_ = at::Tensor();
+      prefetched_event_.block(current);
+      c10::cuda::CUDACachingAllocator::recordStream(
+          data.storage().data(), current);
+    } else {
+      offloaded_.block(current);
+      c10::cuda::CUDAStreamGuard guard(current);
+      data = to_device();
+    }
+    state_->prefetch_before(index_);
+    return data;
+  }
+
+  // Queues the copy back to the device on the side stream, unless it is
+  // already queued. Requires the mutex of the state.
+  void prefetch() {
+    if (prefetched_.defined()) {
+      return;
+    }
+    const auto side = state_->side_stream(device_.index());
+    c10::cuda::CUDAStreamGuard guard(side);
+    prefetched_ = to_device();
+    prefetched_event_.record(side);
+  }
+
+ private:
+  // Copies the host tensor back to the device, on the current stream.
+  at::Tensor to_device() const {
+    auto data = at::empty(host_.sizes(), host_.options().device(device_));
+    data.copy_(host_, /*non_blocking=*/true);
+    return data;
+  }
+
+  std::shared_ptr<ActivationOffloader::State> state_;
+  size_t index_;
+  at::Device device_;
+  at::Tensor host_;
+  // Recorded on the side stream after the copy to host memory.
+  at::cuda::CUDAEvent offloaded_;
+  at::Tensor prefetched_;
+  // Recorded on the side stream after the copy to prefetched_.
+  at::cuda::CUDAEvent prefetched_event_;
+};
+
+} // namespace
+
+void ActivationOffloader::State::prefetch_before(size_t index) {
+  const size_t first = index - std::min(index, options.prefetch);
+  for (size_t i = index; i > first; --i) {
+    if (auto tensor = offloaded[i - 1].lock()) {
+      tensor->prefetch();
+    }
+  }
+}
+
+ActivationOffloader::ActivationOffloader(ActivationOffloadOptions options)
+    : state_(std::make_shared<State>(options)) {}
+
+std::shared_ptr<PackedTensor> ActivationOffloader::pack(
+    const Variable& variable) {
+  const auto& data = variable.data();
+  if (!data.is_cuda() || data.is_sparse() ||
+      (variable.is_leaf() && variable.requires_grad()) ||
+      data.numel() * data.element_size() < state_->options.min_bytes) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  const auto index = state_->offloaded.size();
+  auto tensor = std::make_shared<OffloadedTensor>(state_, index, data);
+  state_->offloaded.push_back(tensor);
+  return tensor;
+}
+
+size_t ActivationOffloader::num_offloaded() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->offloaded.size();
+}
+
+}} // namespace torch::cuda
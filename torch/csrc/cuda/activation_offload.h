@@ -0,0 +1,58 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace torch { namespace cuda {
+
+struct ActivationOffloadOptions {
+  // The saved CUDA tensors of fewer bytes stay in device memory.
+  int64_t min_bytes = 1 << 20;
+  // How many of the offloaded tensors saved before the one being unpacked are
+  // copied back to the device ahead of time.
+  size_t prefetch = 2;
+};
+
+// SavedTensorHooks that move the CUDA activations saved for the backward pass
+// to pinned host memory, so that their device memory is freed until backward:
+//
+//   torch::cuda::ActivationOffloader offloader;
+//   {
+//     torch::autograd::SavedTensorHooksGuard guard(&offloader);
+//     loss = model->forward(input);
+//   }
+//   loss.backward();
+//
+// The device to host copies run on a side stream of each device, after the
+// work queued on the current stream so far, and do not block the forward
+// pass. The backward pass visits the nodes of a chain roughly in the reverse
+// order of the forward pass, so when an offloaded tensor is unpacked, the
+// `prefetch` tensors offloaded just before it start being copied back on the
+// side stream, overlapping with the backward of the nodes in between. The
+// tensors that were not prefetched are copied back on the current stream when
+// they are unpacked.
+//
+// Leaves that require grad (i.e. parameters) are referenced by the model
+// anyway, and are never offloaded. Each offloader keeps track of the tensors
+// it offloaded to prefetch them, so it should be used for one forward pass.
+class TORCH_API ActivationOffloader : public autograd::SavedTensorHooks {
+ public:
+  explicit ActivationOffloader(ActivationOffloadOptions options = {});
+
+  std::shared_ptr<autograd::PackedTensor> pack(
+      const autograd::Variable& variable) override;
+
+  // The number of tensors offloaded so far.
+  size_t num_offloaded() const;
+
+  struct State;
+
+ private:
+  std::shared_ptr<State> state_;
+};
+
+}} // namespace torch::cuda
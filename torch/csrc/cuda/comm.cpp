@@ -46,21 +46,74 @@ struct unique_type_checker {
   bool unique = true;
 };
 
-std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices) {
+namespace {
+
+void check_streams(const stream_list& streams, IntArrayRef devices) {
+  if (streams.empty()) {
+    return;
+  }
+  AT_CHECK(
+      streams.size() == devices.size(),
+      "Expected one stream per device (got ", streams.size(),
+      " streams for ", devices.size(), " devices)");
+  for (size_t i = 0; i < streams.size(); ++i) {
+    AT_CHECK(
+        !streams[i] || streams[i]->device_index() == devices[i],
+        "Expected the device associated with the stream at index ",
+        i, " (was ", streams[i]->device_index(), ") ",
+        "to match the device supplied at that index ",
+        "(expected ", devices[i], ")");
+  }
+}
+
+// The stream to make current for the i-th device, if the caller gave one
+c10::optional<c10::Stream> stream_at(const stream_list& streams, size_t i) {
+  if (i < streams.size() && streams[i]) {
+    return streams[i]->unwrap();
+  }
+  return c10::nullopt;
+}
+
+// Sums tensors from several devices by copying them to devices[root]
+Tensor reduce_add_copies(
+    TensorList inputs,
+    size_t root,
+    IntArrayRef devices,
+    const stream_list& streams) {
+  at::cuda::CUDAGuard device_guard(devices[root]);
+  at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, root));
+  auto result = inputs[root].clone();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (i != root) {
+      result.add_(inputs[i].to(
+          result.device(), inputs[i].scalar_type(), /*non_blocking=*/true));
+    }
+  }
+  return result;
+}
+
+} // namespace
+
+std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices,
+                              const stream_list& streams) {
   if (tensor.is_cuda() && tensor.get_device() != devices[0])
     throw std::runtime_error("device of broadcasted tensor must appear as the "
                              "first on devices list");
+  check_streams(streams, devices);
   std::vector<Tensor> tensors;
   tensors.reserve(devices.size());
 #ifdef USE_NCCL
   if (nccl::is_available({tensor})) {
     tensors.push_back(tensor);
-    for (auto device : devices.slice(1)) {
+    for (size_t i = 1, num_devices = devices.size(); i < num_devices; ++i) {
+      // Allocated on the stream the broadcast writes them on
+      at::cuda::CUDAGuard device_guard(devices[i]);
+      at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, i));
       tensors.push_back(
           at::empty(tensor.sizes(),
-          tensor.options().device(at::Device(kCUDA, device))));
+          tensor.options().device(at::Device(kCUDA, devices[i]))));
     }
-    nccl::broadcast(tensors);
+    nccl::broadcast(tensors, streams);
   } else {
 #else
   {
@@ -68,10 +121,12 @@ std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices) {
     if (tensor.is_cuda()) {
       tensors.push_back(tensor);
     }
-    IntArrayRef loop_devices = tensor.is_cuda() ? devices.slice(1) : devices;
-    for (auto device : loop_devices) {
+    for (size_t i = tensor.is_cuda() ? 1 : 0, num_devices = devices.size();
+         i < num_devices; ++i) {
+      at::cuda::CUDAGuard device_guard(devices[i]);
+      at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, i));
       tensors.push_back(tensor.to(
-          at::Device(kCUDA, device),
+          at::Device(kCUDA, devices[i]),
           tensor.scalar_type(),
           /*non_blocking=*/true,
           /*copy=*/true));
@@ -110,11 +165,13 @@ std::vector<Tensor> broadcast(const Tensor& tensor, IntArrayRef devices) {
 //
 // Similarly for reduce_add_coalesced, when the output are newly created
 // Variables.
-tensor_list2d broadcast_coalesced(TensorList tensors, IntArrayRef devices, size_t buffer_size) {
+tensor_list2d broadcast_coalesced(TensorList tensors, IntArrayRef devices, size_t buffer_size,
+                                  const stream_list& streams) {
   if (!std::all_of(tensors.begin(), tensors.end(),
                    [&](const at::Tensor& t) { return t.get_device() == devices[0]; })) {
     throw std::runtime_error("all tensors must be on devices[0]");
   }
+  check_streams(streams, devices);
 #ifdef USE_NCCL
   buffer_size = std::min(torch::cuda::nccl::get_max_count(), buffer_size);
 #endif
@@ -126,17 +183,19 @@ tensor_list2d broadcast_coalesced(TensorList tensors, IntArrayRef devices, size_
 
   unique_type_checker type_checker;
   at::cuda::CUDAGuard device_guard(devices[0]);
+  at::cuda::OptionalCUDAStreamGuard source_stream_guard(stream_at(streams, 0));
   for (auto & chunk : utils::take_tensors(tensors, buffer_size)) {
     auto & type = chunk.type();
     type_checker.show(type);
     std::vector<at::Tensor> results;
     if (chunk.type().is_sparse()) {
       auto flat_tuple = utils::flatten_sparse_tensors(chunk.tensors);
-      std::vector<at::Tensor> broadcast_indices = broadcast(flat_tuple.first, devices);
-      std::vector<at::Tensor> broadcast_values = broadcast(flat_tuple.second, devices);
+      std::vector<at::Tensor> broadcast_indices = broadcast(flat_tuple.first, devices, streams);
+      std::vector<at::Tensor> broadcast_values = broadcast(flat_tuple.second, devices, streams);
       results.reserve(devices.size());
       for (size_t i = 1, num_devices = devices.size(); i < num_devices; ++i) {
         device_guard.set_index(devices[i]);
+        at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, i));
         auto & device_outputs = outputs[i];
         auto & inds = broadcast_indices[i];
         auto & vals = broadcast_values[i];
@@ -149,9 +208,10 @@ tensor_list2d broadcast_coalesced(TensorList tensors, IntArrayRef devices, size_
       }
     } else {
       std::vector<Tensor> results = broadcast(utils::flatten_dense_tensors(chunk.tensors),
-                                              devices);
+                                              devices, streams);
       for (size_t i = 1, num_devices = devices.size(); i < num_devices; ++i) {
         device_guard.set_index(devices[i]);
+        at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, i));
         auto & device_outputs = outputs[i];
         for (auto & t : utils::unflatten_dense_tensors(results[i], chunk.tensors)) {
           // See NOTE [ Version Counter in comm.*_coalesced ]
@@ -171,6 +231,124 @@ tensor_list2d broadcast_coalesced(TensorList tensors, IntArrayRef devices, size_
   return outputs;
 }
 
+std::vector<Tensor> reduce_add_coalesced(
+    const tensor_list2d& inputs,
+    int64_t destination,
+    size_t buffer_size,
+    const stream_list& streams) {
+  AT_CHECK(!inputs.empty(), "reduce_add_coalesced expects at least one list of inputs");
+  const size_t num_devices = inputs.size();
+  const size_t num_tensors = inputs[0].size();
+  if (num_tensors == 0) {
+    return {};
+  }
+  std::vector<int64_t> devices(num_devices);
+  int64_t root = -1;
+  for (size_t i = 0; i < num_devices; ++i) {
+    AT_CHECK(
+        inputs[i].size() == num_tensors,
+        "reduce_add_coalesced expects the same number of tensors from every "
+        "device (got ", inputs[i].size(), " and ", num_tensors, ")");
+    devices[i] = inputs[i][0].get_device();
+    for (size_t j = 0; j < num_tensors; ++j) {
+      const auto& tensor = inputs[i][j];
+      AT_CHECK(tensor.is_cuda(), "reduce_add_coalesced expects all inputs to be on GPUs");
+      AT_CHECK(
+          tensor.get_device() == devices[i],
+          "reduce_add_coalesced expects the tensors of each list to be on a "
+          "single device");
+      AT_CHECK(
+          tensor.sizes() == inputs[0][j].sizes(),
+          "input ", j, " on device ", devices[i], " has invalid size: got ",
+          tensor.sizes(), ", but expected ", inputs[0][j].sizes());
+    }
+    if (devices[i] == destination) {
+      root = i;
+    }
+  }
+  AT_CHECK(
+      root != -1,
+      "reduce_add_coalesced expects destination to be on the same GPU with one "
+      "of the tensors");
+  check_streams(streams, devices);
+#ifdef USE_NCCL
+  buffer_size = std::min(torch::cuda::nccl::get_max_count(), buffer_size);
+#endif
+
+  std::vector<Tensor> outputs;
+  std::vector<Tensor> ref_order;
+  outputs.reserve(num_tensors);
+  ref_order.reserve(num_tensors);
+
+  // process sparse ones first since they may have different sizes on
+  // different gpus
+  tensor_list2d dense_inputs(num_devices);
+  for (size_t j = 0; j < num_tensors; ++j) {
+    std::vector<Tensor> tensor_at_gpus;
+    tensor_at_gpus.reserve(num_devices);
+    for (size_t i = 0; i < num_devices; ++i) {
+      tensor_at_gpus.push_back(inputs[i][j]);
+    }
+    if (std::all_of(tensor_at_gpus.begin(), tensor_at_gpus.end(),
+                    [](const Tensor& t) { return t.is_sparse(); })) {
+      outputs.push_back(reduce_add_copies(tensor_at_gpus, root, devices, streams));
+      ref_order.push_back(tensor_at_gpus[0]);
+      continue;
+    }
+    for (size_t i = 0; i < num_devices; ++i) {
+      at::cuda::CUDAGuard device_guard(devices[i]);
+      at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, i));
+      const auto& t = tensor_at_gpus[i];
+      dense_inputs[i].push_back(t.is_sparse() ? t.to_dense() : t);
+    }
+    ref_order.push_back(dense_inputs[0].back());
+  }
+
+  // now the dense ones, which have consistent sizes, so that they are split
+  // into the same chunks on every device
+  std::vector<std::vector<utils::TensorGroup>> chunks;
+  chunks.reserve(num_devices);
+  for (auto& tensors : dense_inputs) {
+    chunks.push_back(utils::take_tensors(tensors, buffer_size));
+  }
+  for (size_t k = 0, num_chunks = chunks[0].size(); k < num_chunks; ++k) {
+    std::vector<Tensor> flat_tensors;
+    flat_tensors.reserve(num_devices);
+    for (size_t i = 0; i < num_devices; ++i) {
+      at::cuda::CUDAGuard device_guard(devices[i]);
+      at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, i));
+      flat_tensors.push_back(utils::flatten_dense_tensors(chunks[i][k].tensors));
+    }
+    Tensor flat_result;
+#ifdef USE_NCCL
+    if (nccl::is_available(flat_tensors)) {
+      // NCCL only writes the output of the root; the inputs stand in for the
+      // others
+      std::vector<Tensor> flat_outputs(flat_tensors);
+      {
+        at::cuda::CUDAGuard device_guard(destination);
+        at::cuda::OptionalCUDAStreamGuard stream_guard(stream_at(streams, root));
+        flat_outputs[root] = at::empty_like(flat_tensors[root]);
+      }
+      nccl::reduce(flat_tensors, flat_outputs, root, ncclSum, streams);
+      flat_result = flat_outputs[root];
+    } else
+#endif
+    {
+      flat_result = reduce_add_copies(flat_tensors, root, devices, streams);
+    }
+    for (auto& t : utils::unflatten_dense_tensors(flat_result, chunks[0][k].tensors)) {
+      // See NOTE [ Version Counter in comm.*_coalesced ]
+      AT_ASSERT(t.is_variable());
+      Variable var = t;
+      outputs.push_back(make_variable(var.data(), false));
+    }
+  }
+
+  utils::reorder_tensors_like(outputs, ref_order);
+  return outputs;
+}
+
 std::vector<at::Tensor> scatter(
     const at::Tensor& tensor,
     at::IntArrayRef devices,
@@ -12,10 +12,28 @@
 namespace torch { namespace cuda {
 
 using tensor_list2d = std::vector<std::vector<at::Tensor>>;
+using stream_list = std::vector<c10::optional<at::cuda::CUDAStream>>;
 
-TORCH_API std::vector<at::Tensor> broadcast(const at::Tensor& tensor, at::IntArrayRef devices);
+// The collectives below queue their copies and NCCL kernels on one stream per
+// device: streams[i] if it is given, and the current stream of the device
+// otherwise. They return without waiting for that work, and the outputs are
+// allocated on those streams, so a consumer on another stream must wait on
+// them first (e.g. with CUDAStream::wait_stream in Python).
+
+TORCH_API std::vector<at::Tensor> broadcast(const at::Tensor& tensor, at::IntArrayRef devices,
+                                            const stream_list& streams = {});
 TORCH_API tensor_list2d broadcast_coalesced(at::TensorList tensors, at::IntArrayRef devices,
-                                  size_t buffer_size);
+                                  size_t buffer_size, const stream_list& streams = {});
+
+// Sums inputs[i][j] over i into output j on device destination, where
+// inputs[i] are tensors on a single device, and one of them is destination.
+// Dense tensors are coalesced into buffers of at most buffer_size bytes,
+// which are reduced with NCCL when it is available.
+TORCH_API std::vector<at::Tensor> reduce_add_coalesced(
+    const tensor_list2d& inputs,
+    int64_t destination,
+    size_t buffer_size,
+    const stream_list& streams = {});
 
 TORCH_API std::vector<at::Tensor> scatter(
     const at::Tensor& tensor,
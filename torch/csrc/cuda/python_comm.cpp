@@ -13,19 +13,48 @@
 #include <vector>
 
 namespace torch { namespace cuda { namespace python {
+namespace {
+stream_list to_stream_list(const c10::optional<py::object>& py_streams) {
+  if (!py_streams || py_streams->is_none()) {
+    return {};
+  }
+  py::handle handle = *py_streams;
+  return THPUtils_PySequence_to_CUDAStreamList(handle.ptr());
+}
+} // namespace
+
 void initCommMethods(PyObject *module) {
   auto m = py::cast<py::module>(module);
   m.def(
        "_broadcast_coalesced",
        [](std::vector<at::Tensor>& tensors,
           std::vector<int64_t> devices,
-          size_t buffer_size) {
-         return broadcast_coalesced(tensors, devices, buffer_size);
+          size_t buffer_size,
+          c10::optional<py::object> py_streams) {
+         auto streams = to_stream_list(py_streams);
+         // Note: We're holding the GIL up to here.
+         AutoNoGIL no_gil;
+         return broadcast_coalesced(tensors, devices, buffer_size, streams);
        },
        py::arg("tensors"),
        py::arg("devices"),
        py::arg("buffer_size"),
-       py::call_guard<py::gil_scoped_release>())
+       py::arg("streams") = c10::nullopt)
+      .def(
+          "_reduce_add_coalesced",
+          [](std::vector<std::vector<at::Tensor>>& inputs,
+             int64_t destination,
+             size_t buffer_size,
+             c10::optional<py::object> py_streams) {
+            auto streams = to_stream_list(py_streams);
+            // Note: We're holding the GIL up to here.
+            AutoNoGIL no_gil;
+            return reduce_add_coalesced(inputs, destination, buffer_size, streams);
+          },
+          py::arg("inputs"),
+          py::arg("destination"),
+          py::arg("buffer_size"),
+          py::arg("streams") = c10::nullopt)
       .def(
           "_broadcast",
           [](at::Tensor& tensor, std::vector<int64_t> devices) {
@@ -0,0 +1,183 @@
+#include <torch/csrc/distributed/c10d/comm.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+#include <c10/util/Exception.h>
+
+namespace c10d {
+namespace {
+
+void check_single_replica(const GradBucket& bucket, const char* hook_name) {
+  AT_CHECK(
+      bucket.tensors.size() == 1,
+      hook_name,
+      " supports a single model replica per process, got ",
+      bucket.tensors.size());
+}
+
+} // namespace
+
+AllreduceCommHook::AllreduceCommHook(
+    std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+std::shared_ptr<ProcessGroup::Work> AllreduceCommHook::runHook(
+    GradBucket& bucket) {
+  return process_group_->allreduce(bucket.tensors);
+}
+
+FP16CompressCommHook::FP16CompressCommHook(
+    std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+std::shared_ptr<ProcessGroup::Work> FP16CompressCommHook::runHook(
+    GradBucket& bucket) {
+  auto& compressed = compressed_[bucket.index];
+  compressed.clear();
+  for (const auto& tensor : bucket.tensors) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  return process_group_->allreduce(compressed);
+}
+
+void FP16CompressCommHook::finalizeHook(GradBucket& bucket) {
+  auto& compressed = compressed_[bucket.index];
+  for (size_t i = 0; i < bucket.tensors.size(); i++) {
+    bucket.tensors[i].copy_(compressed[i]);
+  }
+}
+
+void FP16CompressCommHook::reset() {
+  compressed_.clear();
+}
+
+TopKCompressCommHook::TopKCompressCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    double ratio)
+    : process_group_(std::move(process_group)), ratio_(ratio) {
+  AT_CHECK(
+      ratio > 0 && ratio <= 1,
+      "Expected the top-k ratio to be in (0, 1], got ",
+      ratio);
+}
+
+std::shared_ptr<ProcessGroup::Work> TopKCompressCommHook::runHook(
+    GradBucket& bucket) {
+  check_single_replica(bucket, "TopKCompressCommHook");
+  auto& state = states_[bucket.index];
+  const auto& tensor = bucket.tensors[0];
+  if (!state.residual.defined()) {
+    state.residual = at::zeros_like(tensor);
+  }
+
+  // Select the largest entries of the error corrected gradient and keep
+  // the rest for the next iteration.
+  auto corrected = tensor + state.residual;
+  const int64_t numel = corrected.numel();
+  const int64_t k = std::max<int64_t>(
+      1, std::min<int64_t>(numel, static_cast<int64_t>(ratio_ * numel)));
+  auto indices = std::get<1>(corrected.abs().topk(
+      k, /* dim */ 0, /* largest */ true, /* sorted */ false));
+  auto values = corrected.index_select(0, indices);
+  corrected.index_fill_(0, indices, 0);
+  state.residual = std::move(corrected);
+
+  // Different processes select different indices, so the values can't be
+  // summed in place; gather everybody's selection instead.
+  const auto world_size = process_group_->getSize();
+  state.values = {values};
+  state.indices = {indices};
+  state.gathered_values = {std::vector<at::Tensor>()};
+  state.gathered_indices = {std::vector<at::Tensor>()};
+  for (int i = 0; i < world_size; i++) {
+    state.gathered_values[0].push_back(at::empty_like(values));
+    state.gathered_indices[0].push_back(at::empty_like(indices));
+  }
+  state.indices_work =
+      process_group_->allgather(state.gathered_indices, state.indices);
+  return process_group_->allgather(state.gathered_values, state.values);
+}
+
+void TopKCompressCommHook::finalizeHook(GradBucket& bucket) {
+  auto& state = states_[bucket.index];
+  state.indices_work->wait();
+  auto& tensor = bucket.tensors[0];
+  tensor.zero_();
+  for (size_t i = 0; i < state.gathered_values[0].size(); i++) {
+    tensor.index_add_(
+        0, state.gathered_indices[0][i], state.gathered_values[0][i]);
+  }
+  state.values.clear();
+  state.indices.clear();
+  state.gathered_values.clear();
+  state.gathered_indices.clear();
+  state.indices_work.reset();
+}
+
+void TopKCompressCommHook::reset() {
+  states_.clear();
+}
+
+PowerSGDCommHook::PowerSGDCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t rank)
+    : process_group_(std::move(process_group)), rank_(rank) {
+  AT_CHECK(rank > 0, "Expected a positive PowerSGD rank, got ", rank);
+}
+
+std::shared_ptr<ProcessGroup::Work> PowerSGDCommHook::runHook(
+    GradBucket& bucket) {
+  check_single_replica(bucket, "PowerSGDCommHook");
+  auto& state = states_[bucket.index];
+  const auto& tensor = bucket.tensors[0];
+  const int64_t numel = tensor.numel();
+  if (!state.residual.defined()) {
+    state.residual = at::zeros_like(tensor);
+    // The flat bucket is zero padded to a close to square matrix
+    const int64_t cols =
+        static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(numel))));
+    const int64_t rows = (numel + cols - 1) / cols;
+    const int64_t rank = std::min(rank_, std::min(rows, cols));
+    state.matrix = at::zeros({rows, cols}, tensor.options());
+    // Every process has to start from the same Q; use a deterministic,
+    // well conditioned matrix rather than the (per process) random state.
+    state.q = at::arange(cols * rank, tensor.options())
+                  .add_(1)
+                  .sin_()
+                  .view({cols, rank});
+  }
+
+  auto corrected = tensor + state.residual;
+  state.matrix.view({-1}).narrow(0, 0, numel).copy_(corrected);
+  state.p = at::mm(state.matrix, state.q);
+  std::vector<at::Tensor> p = {state.p};
+  return process_group_->allreduce(p);
+}
+
+void PowerSGDCommHook::finalizeHook(GradBucket& bucket) {
+  auto& state = states_[bucket.index];
+  auto& tensor = bucket.tensors[0];
+  const int64_t numel = tensor.numel();
+
+  // P is identical on all processes after the allreduce, and so is its
+  // orthogonalization.
+  state.p = std::get<0>(at::qr(state.p));
+  state.q = at::mm(state.matrix.t(), state.p);
+  std::vector<at::Tensor> q = {state.q};
+  process_group_->allreduce(q)->wait();
+
+  // The approximation is of the sum of all processes' (pre-averaged)
+  // contributions; the residual is what this process' share of it lost.
+  auto approximation = at::mm(state.p, state.q.t()).view({-1}).narrow(0, 0, numel);
+  state.residual = state.matrix.view({-1}).narrow(0, 0, numel) -
+      approximation / process_group_->getSize();
+  tensor.copy_(approximation);
+}
+
+void PowerSGDCommHook::reset() {
+  states_.clear();
+}
+
+} // namespace c10d
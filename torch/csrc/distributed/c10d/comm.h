@@ -0,0 +1,126 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10d/ProcessGroup.hpp>
+
+namespace c10d {
+
+// A bucket of gradients handed to a communication hook. `tensors` holds the
+// flattened bucket contents, one tensor per model replica, already divided
+// by the number of processes, so that summing them across processes yields
+// the average gradient.
+struct GradBucket {
+  // Index of the bucket, identical across processes. Hooks can use it to
+  // keep per-bucket state, e.g. error feedback residuals.
+  size_t index;
+  std::vector<at::Tensor>& tensors;
+};
+
+// A communication hook replaces the allreduce that the Reducer runs for
+// every bucket. `runHook` is called as soon as the bucket is ready, from the
+// autograd thread that produced its last gradient and with the reducer lock
+// held, so it should only launch asynchronous work to keep communication
+// overlapped with the rest of the backward pass. `finalizeHook` is called
+// after the returned work has completed, before the bucket contents are
+// copied back into the gradients, and must leave the averaged gradients in
+// `bucket.tensors`. `reset` is called when the Reducer changes its bucket
+// assignment, after which per-bucket state must be dropped.
+class CommHook {
+ public:
+  virtual ~CommHook() {}
+
+  virtual std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) = 0;
+
+  virtual void finalizeHook(GradBucket& bucket) {}
+
+  virtual void reset() {}
+};
+
+// Plain allreduce of the bucket contents; what the Reducer does without a
+// hook.
+class AllreduceCommHook : public CommHook {
+ public:
+  explicit AllreduceCommHook(std::shared_ptr<ProcessGroup> process_group);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// Casts the bucket contents to half precision before the allreduce, which
+// halves the bytes sent for fp32 gradients.
+class FP16CompressCommHook : public CommHook {
+ public:
+  explicit FP16CompressCommHook(std::shared_ptr<ProcessGroup> process_group);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) override;
+  void finalizeHook(GradBucket& bucket) override;
+  void reset() override;
+
+ protected:
+  std::shared_ptr<ProcessGroup> process_group_;
+  std::unordered_map<size_t, std::vector<at::Tensor>> compressed_;
+};
+
+// Sends only the `ratio` fraction of largest magnitude gradient entries of
+// every bucket (as values and indices gathered from all processes). What is
+// left out is kept as a per-bucket residual and added to the bucket the next
+// iteration (error feedback). Supports a single model replica per process.
+class TopKCompressCommHook : public CommHook {
+ public:
+  TopKCompressCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      double ratio);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) override;
+  void finalizeHook(GradBucket& bucket) override;
+  void reset() override;
+
+ protected:
+  struct State {
+    at::Tensor residual;
+    std::vector<at::Tensor> values;
+    std::vector<at::Tensor> indices;
+    std::vector<std::vector<at::Tensor>> gathered_values;
+    std::vector<std::vector<at::Tensor>> gathered_indices;
+    std::shared_ptr<ProcessGroup::Work> indices_work;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  double ratio_;
+  std::unordered_map<size_t, State> states_;
+};
+
+// PowerSGD low-rank compression: every bucket is viewed as a matrix M and
+// approximated by P * Q^T with P = M * Q and Q = M^T * P of rank `rank`, so
+// only P and Q are allreduced. Q is reused across iterations (warm start) and
+// the approximation error is fed back into the next iteration. The allreduce
+// of P overlaps with the backward pass; the allreduce of Q, which depends on
+// it, runs in finalizeHook. Supports a single model replica per process.
+class PowerSGDCommHook : public CommHook {
+ public:
+  PowerSGDCommHook(std::shared_ptr<ProcessGroup> process_group, int64_t rank);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) override;
+  void finalizeHook(GradBucket& bucket) override;
+  void reset() override;
+
+ protected:
+  struct State {
+    at::Tensor residual;
+    at::Tensor matrix;
+    at::Tensor p;
+    at::Tensor q;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  int64_t rank_;
+  std::unordered_map<size_t, State> states_;
+};
+
+} // namespace c10d
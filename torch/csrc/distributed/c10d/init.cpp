@@ -17,6 +17,7 @@
 #include <gloo/transport/tcp/device.h>
 #include <pybind11/chrono.h>
 
+#include <torch/csrc/Device.h>
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/distributed/c10d/ddp.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
@@ -30,6 +31,8 @@ namespace c10d {
 namespace {
 
 constexpr char* GLOO_SOCKET_IFNAME_ENV = "GLOO_SOCKET_IFNAME";
+constexpr char* GLOO_HIERARCHICAL_ALLREDUCE_ENV =
+    "TORCH_GLOO_HIERARCHICAL_ALLREDUCE";
 
 template <typename T>
 using shared_ptr_class_ = py::class_<T, std::shared_ptr<T>>;
@@ -46,7 +49,14 @@ PyObject* c10d_init(PyObject* _unused) {
       .def(py::init<
            std::vector<std::vector<torch::autograd::Variable>>,
            std::vector<std::vector<size_t>>,
-           std::shared_ptr<::c10d::ProcessGroup>>())
+           std::shared_ptr<::c10d::ProcessGroup>,
+           std::vector<size_t>,
+           bool>(),
+          py::arg("replicas"),
+          py::arg("bucket_indices"),
+          py::arg("process_group"),
+          py::arg("bucket_size_limits") = std::vector<size_t>(),
+          py::arg("gradient_as_bucket_view") = false)
       .def(
           "initialize_buckets",
           &::c10d::Reducer::initialize_buckets,
@@ -60,7 +70,41 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def("has_rebuilt_buckets", &::c10d::Reducer::has_rebuilt_buckets)
+      .def(
+          "register_comm_hook",
+          &::c10d::Reducer::register_comm_hook,
+          py::arg("hook"),
+          py::call_guard<py::gil_scoped_release>());
+
+  shared_ptr_class_<::c10d::CommHook>(module, "_CommHook");
+
+  shared_ptr_class_<::c10d::AllreduceCommHook, ::c10d::CommHook>(
+      module, "_AllreduceCommHook")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>>(),
+          py::arg("process_group"));
+
+  shared_ptr_class_<::c10d::FP16CompressCommHook, ::c10d::CommHook>(
+      module, "_FP16CompressCommHook")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>>(),
+          py::arg("process_group"));
+
+  shared_ptr_class_<::c10d::TopKCompressCommHook, ::c10d::CommHook>(
+      module, "_TopKCompressCommHook")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, double>(),
+          py::arg("process_group"),
+          py::arg("ratio"));
+
+  shared_ptr_class_<::c10d::PowerSGDCommHook, ::c10d::CommHook>(
+      module, "_PowerSGDCommHook")
+      .def(
+          py::init<std::shared_ptr<::c10d::ProcessGroup>, int64_t>(),
+          py::arg("process_group"),
+          py::arg("rank"));
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class of available reduce operations: ``SUM``, ``PRODUCT``,
@@ -85,6 +129,10 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def_readwrite("reduceOp", &::c10d::AllreduceOptions::reduceOp)
       .def_readwrite("timeout", &::c10d::AllreduceOptions::timeout);
 
+  py::class_<::c10d::AllreduceCoalescedOptions, ::c10d::AllreduceOptions>(
+      module, "AllreduceCoalescedOptions")
+      .def(py::init<>());
+
   py::class_<::c10d::ReduceOptions>(module, "ReduceOptions")
       .def(py::init<>())
       .def_readwrite("reduceOp", &::c10d::ReduceOptions::reduceOp)
@@ -111,6 +159,10 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def_readwrite("reduceOp", &::c10d::ReduceScatterOptions::reduceOp)
       .def_readwrite("timeout", &::c10d::ReduceScatterOptions::timeout);
 
+  py::class_<::c10d::AllToAllOptions>(module, "AllToAllOptions")
+      .def(py::init<>())
+      .def_readwrite("timeout", &::c10d::AllToAllOptions::timeout);
+
   py::class_<::c10d::BarrierOptions>(module, "BarrierOptions")
       .def(py::init<>())
       .def_readwrite("timeout", &::c10d::BarrierOptions::timeout);
@@ -141,6 +193,36 @@ They are used in specifying strategies for reduction collectives, e.g.,
               "add",
               &::c10d::Store::add,
               py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          // The values are converted to py::bytes with the GIL held.
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
           .def(
               "set_timeout",
               &::c10d::Store::setTimeout,
@@ -225,6 +307,17 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("op") = ::c10d::ReduceOp::SUM,
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "allreduce_coalesced",
+              [](::c10d::ProcessGroup& pg,
+                 std::vector<at::Tensor>& xs,
+                 ::c10d::AllreduceCoalescedOptions opts) {
+                return pg.allreduce_coalesced(xs, opts);
+              },
+              py::arg("tensors"),
+              py::arg("opts") = ::c10d::AllreduceCoalescedOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "reduce",
               &::c10d::ProcessGroup::reduce,
@@ -343,6 +436,24 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("input_tensor"),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "alltoall_base",
+              &::c10d::ProcessGroup::alltoall_base,
+              py::arg("output_tensor"),
+              py::arg("input_tensor"),
+              py::arg("output_split_sizes"),
+              py::arg("input_split_sizes"),
+              py::arg("opts") = ::c10d::AllToAllOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
+          .def(
+              "alltoall",
+              &::c10d::ProcessGroup::alltoall,
+              py::arg("output_tensors"),
+              py::arg("input_tensors"),
+              py::arg("opts") = ::c10d::AllToAllOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "send",
               &::c10d::ProcessGroup::send,
@@ -380,7 +491,13 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "hierarchical_allreduce",
+          &::c10d::ProcessGroupGloo::Options::hierarchicalAllreduce)
+      .def_readwrite(
+          "cuda_chunk_bytes",
+          &::c10d::ProcessGroupGloo::Options::cudaChunkBytes);
 
   processGroupGloo.def_static(
       "create_tcp_device",
@@ -433,6 +550,9 @@ They are used in specifying strategies for reduction collectives, e.g.,
             options.devices.push_back(
                 ::gloo::transport::tcp::CreateDevice(attr));
             options.timeout = timeout;
+            char* hierarchicalEnv = getenv(GLOO_HIERARCHICAL_ALLREDUCE_ENV);
+            options.hierarchicalAllreduce =
+                hierarchicalEnv && std::string(hierarchicalEnv) == "1";
             return std::make_shared<::c10d::ProcessGroupGloo>(
                 store, rank, size, options);
           }),
@@ -453,7 +573,28 @@ They are used in specifying strategies for reduction collectives, e.g.,
           py::arg("store"),
           py::arg("rank"),
           py::arg("size"),
-          py::arg("groupName") = "");
+          py::arg("groupName") = "")
+      // Takes torch.device objects or CUDA device indices.
+      .def(
+          "warmup",
+          [](::c10d::ProcessGroupNCCL& pg, const py::list& devices) {
+            std::vector<at::Device> devices_;
+            for (const auto& device : devices) {
+              if (THPDevice_Check(device.ptr())) {
+                devices_.push_back(
+                    reinterpret_cast<THPDevice*>(device.ptr())->device);
+              } else {
+                devices_.emplace_back(at::kCUDA, device.cast<int16_t>());
+              }
+            }
+            py::gil_scoped_release release;
+            pg.warmup(devices_);
+          },
+          py::arg("devices"))
+      .def(
+          "comm_init_times",
+          &::c10d::ProcessGroupNCCL::getCommInitTimes,
+          py::call_guard<py::gil_scoped_release>());
 #endif
 
 #ifdef USE_C10D_MPI
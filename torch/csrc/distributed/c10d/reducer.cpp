@@ -36,19 +36,33 @@ inline int64_t current_time_in_nanos() {
   return torch::autograd::profiler::getTime();
 }
 
+// Whether `grad` is `bucket_view` itself, rather than any other tensor that
+// shares the storage of the bucket contents.
+bool is_bucket_view(const at::Tensor& grad, const at::Tensor& bucket_view) {
+  return grad.is_alias_of(bucket_view) &&
+      grad.data_ptr() == bucket_view.data_ptr() &&
+      grad.sizes() == bucket_view.sizes() &&
+      grad.strides() == bucket_view.strides();
+}
+
 } // namespace
 
 Reducer::Reducer(
     std::vector<std::vector<torch::autograd::Variable>> replicas,
     std::vector<std::vector<size_t>> bucket_indices,
-    std::shared_ptr<c10d::ProcessGroup> process_group)
+    std::shared_ptr<c10d::ProcessGroup> process_group,
+    std::vector<size_t> bucket_size_limits,
+    bool gradient_as_bucket_view)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
+      gradient_as_bucket_view_(gradient_as_bucket_view),
       expect_autograd_hooks_(false),
       require_finalize_(false),
       has_marked_unused_parameters_(false),
       next_bucket_(0),
-      backward_stats_base_(0) {
+      backward_stats_base_(0),
+      bucket_size_limits_(std::move(bucket_size_limits)),
+      has_rebuilt_buckets_(bucket_size_limits_.empty()) {
   AT_ASSERTM(replicas_.size() >= 1, "Expected at least one model replica.");
   AT_ASSERTM(replicas_[0].size() >= 1, "Expected at least one parameter.");
 
@@ -161,6 +175,11 @@ void Reducer::mark_variable_ready(
   backward_stats_[replica_index][variable_index] =
       current_time_in_nanos() - backward_stats_base_;
 
+  // Record the ready order until the buckets have been rebuilt.
+  if (!has_rebuilt_buckets_ && replica_index == 0) {
+    rebuilt_params_order_.push_back(variable_index);
+  }
+
   // Any time we mark a variable ready (be it in line due to unused parameters,
   // or via an autograd hook), we require a call to the finalize function. If
   // this doesn't happen before the next iteration (or call to
@@ -196,25 +215,29 @@ void Reducer::mark_variable_ready(
   }
 
   auto& variable = replica.variables[bucket_index.intra_bucket_index];
-  const auto offset = replica.offsets[bucket_index.intra_bucket_index];
   const auto length = replica.lengths[bucket_index.intra_bucket_index];
+  auto& bucket_view = replica.bucket_views[bucket_index.intra_bucket_index];
 
-  // Copy contents of gradient tensor to bucket tensor.
+  // Copy contents of gradient tensor to bucket tensor, unless the gradient
+  // already is the bucket view and autograd accumulated into it in place.
   // If the gradient is not set, we assume it wasn't computed
   // as part of the current backwards pass, and zero the part
   // of the bucket it would otherwise hold.
-  auto bucket_view = replica.contents.narrow(0, offset, length);
   auto& grad = variable.grad();
   if (grad.defined()) {
-    // Assert that the grad tensor and the bucket don't share storage.
-    // If they did, we could avoid the copy altogether.
-    // The reason for not doing this is that existing code calls
-    // `detach_` from `zero_grad`, which is incompatible with views.
-    AT_ASSERT(!grad.is_alias_of(bucket_view));
     AT_ASSERT(grad.type() == variable.type());
     AT_ASSERT(grad.device() == variable.device());
     AT_ASSERT(grad.numel() == length);
-    bucket_view.copy_(grad.view({-1}), /* non_blocking */ true);
+    if (!gradient_as_bucket_view_) {
+      // Assert that the grad tensor and the bucket don't share storage.
+      AT_ASSERT(!grad.is_alias_of(bucket_view));
+      bucket_view.copy_(grad.view(bucket_view.sizes()), /* non_blocking */ true);
+    } else if (!is_bucket_view(grad, bucket_view)) {
+      // The gradient was stolen from autograd in the first iteration, or it
+      // was replaced since. From now on it is accumulated into the bucket.
+      bucket_view.copy_(grad.view(bucket_view.sizes()), /* non_blocking */ true);
+      grad = bucket_view;
+    }
   } else {
     bucket_view.zero_();
   }
@@ -278,14 +301,35 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       //
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    if (comm_hook_) {
+      GradBucket grad_bucket{next_bucket_, tensors};
+      bucket.work = comm_hook_->runHook(grad_bucket);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
+    }
   }
 }
 
+void Reducer::register_comm_hook(std::shared_ptr<CommHook> hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AT_CHECK(hook, "Expected a communication hook.");
+  AT_CHECK(
+      !comm_hook_,
+      "A communication hook can only be registered once for a reducer.");
+  AT_CHECK(
+      !expect_autograd_hooks_,
+      "A communication hook can't be registered during a backward pass.");
+  comm_hook_ = std::move(hook);
+}
+
 void Reducer::initialize_buckets(
     std::vector<std::vector<size_t>> bucket_indices) {
   std::lock_guard<std::mutex> lock(mutex_);
+  initialize_buckets_locked(std::move(bucket_indices));
+}
 
+void Reducer::initialize_buckets_locked(
+    std::vector<std::vector<size_t>> bucket_indices) {
   // This shouldn't be called if we're expecting autograd hooks to fire.
   AT_ASSERTM(
       !expect_autograd_hooks_,
@@ -351,6 +395,30 @@ void Reducer::initialize_buckets(
       replica.contents = torch::autograd::make_variable_consuming(
           at::empty({static_cast<long>(offset)}, options));
 
+      // The bucket views are made from the data of the contents, so that
+      // they are not views as far as autograd is concerned: `zero_grad`
+      // calls `detach_` on the gradients, which is not allowed on views.
+      const auto& contents_data =
+          torch::autograd::as_variable_ref(replica.contents).data();
+      const auto variable_count = replica.variables.size();
+      replica.bucket_views.reserve(variable_count);
+      for (size_t i = 0; i < variable_count; i++) {
+        auto& variable = replica.variables[i];
+        auto bucket_view = torch::autograd::make_variable(
+            contents_data.narrow(0, replica.offsets[i], replica.lengths[i])
+                .view(variable.sizes()));
+        if (gradient_as_bucket_view_) {
+          // Existing gradients, e.g. views into the buckets before they were
+          // rebuilt, move into the new bucket.
+          auto& grad = variable.grad();
+          if (grad.defined()) {
+            bucket_view.copy_(grad.view(bucket_view.sizes()));
+            grad = bucket_view;
+          }
+        }
+        replica.bucket_views.push_back(std::move(bucket_view));
+      }
+
       // Add bucket replica to enclosing bucket.
       bucket.replicas.push_back(std::move(replica));
     }
@@ -370,6 +438,51 @@ void Reducer::initialize_buckets(
 
     buckets_.push_back(std::move(bucket));
   }
+
+  // Hooks may keep state per bucket index, which is meaningless now.
+  if (comm_hook_) {
+    comm_hook_->reset();
+  }
+}
+
+void Reducer::rebuild_buckets() {
+  const auto variable_count = replicas_[0].size();
+  AT_ASSERT(rebuilt_params_order_.size() == variable_count);
+
+  // Gradients of different processes may be ready in a different order,
+  // while the bucket assignment has to be identical. Use the order that
+  // rank 0 observed.
+  auto order = at::empty(
+      {static_cast<int64_t>(variable_count)},
+      at::TensorOptions().dtype(at::kLong));
+  auto order_data = order.data<int64_t>();
+  for (size_t i = 0; i < variable_count; i++) {
+    order_data[i] = rebuilt_params_order_[i];
+  }
+  std::vector<at::Tensor> tensors = {
+      order.to(replicas_[0][0].device())};
+  process_group_->broadcast(tensors)->wait();
+  order = tensors[0].cpu();
+  order_data = order.data<int64_t>();
+
+  // Bucket the variables as if they were defined in the ready order; the
+  // resulting buckets are sorted by their first ready variable.
+  std::vector<at::Tensor> ordered_variables;
+  ordered_variables.reserve(variable_count);
+  for (size_t i = 0; i < variable_count; i++) {
+    ordered_variables.push_back(replicas_[0][order_data[i]]);
+  }
+  auto bucket_indices =
+      compute_bucket_assignment_by_size(ordered_variables, bucket_size_limits_);
+  for (auto& bucket : bucket_indices) {
+    for (auto& index : bucket) {
+      index = order_data[index];
+    }
+  }
+
+  initialize_buckets_locked(std::move(bucket_indices));
+  has_rebuilt_buckets_ = true;
+  rebuilt_params_order_.clear();
 }
 
 // Traverse the autograd graph starting at the specified output.
@@ -408,6 +521,13 @@ void Reducer::prepare_for_backward(
         "your module when reporting this issue (e.g. list, dict, iterable).");
   }
 
+  // Rebuild the buckets once a full iteration worth of ready order has been
+  // recorded.
+  if (!has_rebuilt_buckets_ &&
+      rebuilt_params_order_.size() == replicas_[0].size()) {
+    rebuild_buckets();
+  }
+
   // Reset accounting.
   has_marked_unused_parameters_ = true;
   expect_autograd_hooks_ = true;
@@ -477,20 +597,42 @@ void Reducer::finalize_backward() {
   // Check that all buckets were completed and had their work kicked off.
   AT_ASSERT(next_bucket_ == buckets_.size());
 
+  // A variable ready more than once (or not at all) means the recorded
+  // order is unusable; try again next iteration.
+  if (!has_rebuilt_buckets_ &&
+      rebuilt_params_order_.size() != replicas_[0].size()) {
+    rebuilt_params_order_.clear();
+  }
+
   // Wait for asynchronous reduction to complete and unflatten contents.
-  for (auto& bucket : buckets_) {
+  for (size_t bucket_index = 0; bucket_index < buckets_.size();
+       bucket_index++) {
+    auto& bucket = buckets_[bucket_index];
     AT_ASSERT(bucket.work);
     bucket.work->wait();
+    if (comm_hook_) {
+      std::vector<at::Tensor> tensors;
+      tensors.reserve(bucket.replicas.size());
+      for (const auto& replica : bucket.replicas) {
+        tensors.push_back(replica.contents);
+      }
+      GradBucket grad_bucket{bucket_index, tensors};
+      comm_hook_->finalizeHook(grad_bucket);
+    }
     for (auto& replica : bucket.replicas) {
       for (size_t intra_bucket_index = 0;
            intra_bucket_index < replica.variables.size();
            intra_bucket_index++) {
         auto& variable = replica.variables[intra_bucket_index];
-        const auto offset = replica.offsets[intra_bucket_index];
-        const auto length = replica.lengths[intra_bucket_index];
-        auto bucket_view =
-            replica.contents.narrow(0, offset, length).view(variable.sizes());
+        const auto& bucket_view = replica.bucket_views[intra_bucket_index];
         auto& grad = variable.grad();
+        if (gradient_as_bucket_view_) {
+          // The reduced gradient already is in the bucket view.
+          if (!grad.defined() || !is_bucket_view(grad, bucket_view)) {
+            grad = bucket_view;
+          }
+          continue;
+        }
         if (!grad.defined()) {
           grad = at::empty(bucket_view.sizes(), bucket_view.options());
         }
@@ -9,6 +9,7 @@
 
 #include <c10d/ProcessGroup.hpp>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/distributed/c10d/comm.h>
 #include <torch/csrc/autograd/variable.h>
 
 namespace c10d {
@@ -19,10 +20,22 @@ class Reducer {
   // The bucket assignment for this reducer is specified as a list of
   // buckets, each of which is specified as a list of indices into the
   // variables list for **a single replica** (i.e. `variables[0]`).
+  //
+  // If `bucket_size_limits` is specified, the buckets are rebuilt once
+  // after the first iteration, following the order in which gradients
+  // became ready, and using the same size limits as
+  // `compute_bucket_assignment_by_size`.
+  //
+  // If `gradient_as_bucket_view` is set, the gradients of the variables are
+  // views into the flattened bucket contents, so that autograd accumulates
+  // them in place and they don't have to be copied into the buckets before
+  // the reduction and back out after it.
   explicit Reducer(
       std::vector<std::vector<torch::autograd::Variable>> replicas,
       std::vector<std::vector<size_t>> bucket_indices,
-      std::shared_ptr<c10d::ProcessGroup> process_group);
+      std::shared_ptr<c10d::ProcessGroup> process_group,
+      std::vector<size_t> bucket_size_limits = {},
+      bool gradient_as_bucket_view = false);
 
   // To (re-)initialize bucket assignment, pass a list of buckets, each
   // of which is specified by a list of indices in the variables list.
@@ -44,6 +57,17 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Replaces the allreduce of bucket contents by the given communication
+  // hook (see comm.h), e.g. to compress gradients before sending them.
+  // Can only be registered once, and not during a backward pass.
+  void register_comm_hook(std::shared_ptr<CommHook> hook);
+
+  // Returns true if the buckets were rebuilt according to the observed
+  // gradient ready order.
+  bool has_rebuilt_buckets() const {
+    return has_rebuilt_buckets_;
+  }
+
  protected:
   std::mutex mutex_;
   std::vector<std::vector<torch::autograd::Variable>> replicas_;
@@ -53,6 +77,8 @@ class Reducer {
       grad_accumulators_;
   std::unordered_map<torch::autograd::Function*, std::tuple<int, int>> func_;
 
+  const bool gradient_as_bucket_view_;
+
   bool expect_autograd_hooks_;
   bool require_finalize_;
   bool has_marked_unused_parameters_;
@@ -67,6 +93,15 @@ class Reducer {
 
   void finalize_backward();
 
+  // Same as `initialize_buckets`, for callers already holding `mutex_`.
+  void initialize_buckets_locked(
+      std::vector<std::vector<size_t>> bucket_indices);
+
+  // Replaces the bucket assignment by one that follows the order recorded
+  // in `rebuilt_params_order_`. The order of rank 0 is broadcast first, so
+  // that all processes end up with the same buckets.
+  void rebuild_buckets();
+
   // A bucket replica represents [1..N] gradients to be reduced,
   // with the same dtype, on the same device.
   //
@@ -91,6 +126,11 @@ class Reducer {
     std::vector<size_t> offsets;
     std::vector<size_t> lengths;
 
+    // Per-variable views into the flat bucket contents tensor, with the
+    // sizes of the variables. With `gradient_as_bucket_view`, these are the
+    // gradients of the variables.
+    std::vector<torch::autograd::Variable> bucket_views;
+
     // Number of tensors to be added before this bucket is complete.
     // This is reset to `variables.size()` every iteration.
     size_t pending;
@@ -119,6 +159,9 @@ class Reducer {
 
   std::vector<Bucket> buckets_;
 
+  // Communication hook run for every bucket instead of allreduce, if set.
+  std::shared_ptr<CommHook> comm_hook_;
+
   // A variable locator locates a particular variable in the bucket
   // structure. The `bucket_index` field points to the bucket in the `buckets_`
   // vector. The `intra_bucket_index` field points to the index of the variable
@@ -138,6 +181,14 @@ class Reducer {
   // the point in time buckets were ready, or ideal bucket assignment/ordering.
   int64_t backward_stats_base_;
   std::vector<std::vector<int64_t>> backward_stats_;
+
+  // The initial bucket assignment assumes that gradients are computed in
+  // the reverse order of parameter definition. This doesn't hold for models
+  // that share weights or branch, so until the buckets have been rebuilt we
+  // record the order in which the gradients of the first replica are ready.
+  std::vector<size_t> bucket_size_limits_;
+  bool has_rebuilt_buckets_;
+  std::vector<size_t> rebuilt_params_order_;
 };
 
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
@@ -0,0 +1,64 @@
+#include <torch/csrc/distributed/rpc/functions.h>
+
+#include <torch/csrc/distributed/rpc/python_rpc_handler.h>
+#include <torch/csrc/distributed/rpc/script_call.h>
+#include <torch/csrc/distributed/rpc/script_ret.h>
+#include <torch/csrc/jit/pybind_utils.h>
+#include <torch/csrc/utils/auto_gil.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+Message processRequestBlocking(Message&& request) {
+  switch (request.type()) {
+    case MessageType::BUILTIN_OP: {
+      auto call = ScriptCall::fromMessage(request);
+      auto stack = call.stack();
+      call.op()->getOperation()(stack);
+
+      at::IValue value;
+      if (stack.size() == 1) {
+        value = std::move(stack.front());
+      } else if (!stack.empty()) {
+        value = c10::ivalue::Tuple::create(std::move(stack));
+      }
+      return ScriptRet(std::move(value)).toMessage();
+    }
+    case MessageType::PYTHON_CALL: {
+      auto payload = PythonRpcHandler::generatePythonUDFResult(request);
+      return Message(
+          std::move(payload),
+          std::vector<at::Tensor>(),
+          MessageType::PYTHON_RET);
+    }
+    default: {
+      AT_ERROR("Request type ", request.type(), " not supported.");
+    }
+  }
+}
+
+py::object toPyObj(const Message& message) {
+  switch (message.type()) {
+    case MessageType::BUILTIN_RET: {
+      auto ret = ScriptRet::fromMessage(message);
+      auto value = ret.value();
+      AutoGIL ag;
+      return torch::jit::toPyObject(std::move(value));
+    }
+    case MessageType::PYTHON_RET: {
+      return PythonRpcHandler::loadPythonUDFResult(message);
+    }
+    case MessageType::EXCEPTION: {
+      std::string err(message.payload().begin(), message.payload().end());
+      throw std::runtime_error(err);
+    }
+    default: {
+      AT_ERROR("Unrecognized response message type ", message.type());
+    }
+  }
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/utils/pybind.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// Processes a BUILTIN_OP or PYTHON_CALL request and returns its response.
+// This is the RequestCallback of the agents created from Python.
+Message processRequestBlocking(Message&& request);
+
+// Converts the response to a request into its Python value, or throws the
+// error that the request raised remotely.
+py::object toPyObj(const Message& message);
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
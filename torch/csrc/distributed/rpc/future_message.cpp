@@ -0,0 +1,44 @@
+#include <torch/csrc/distributed/rpc/future_message.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+const Message& FutureMessage::wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  finished_cv_.wait(lock, [this] { return completed_.load(); });
+  return message_;
+}
+
+void FutureMessage::markCompleted(Message message) {
+  std::vector<Callback> callbacks;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    AT_ASSERTM(!completed_, "A FutureMessage can only be completed once.");
+    message_ = std::move(message);
+    completed_ = true;
+    callbacks.swap(callbacks_);
+  }
+  finished_cv_.notify_all();
+  for (auto& callback : callbacks) {
+    callback(message_);
+  }
+}
+
+bool FutureMessage::completed() const {
+  return completed_;
+}
+
+void FutureMessage::addCallback(const Callback& callback) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (completed_) {
+    lock.unlock();
+    callback(message_);
+    return;
+  }
+  callbacks_.push_back(callback);
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/message.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// The response of an RPC. ``RpcAgent::send`` returns a FutureMessage that the
+// agent completes when the response arrives.
+class TORCH_API FutureMessage final {
+ public:
+  using Callback = std::function<void(const Message&)>;
+
+  // Blocks until the response has arrived, and returns it.
+  const Message& wait();
+
+  void markCompleted(Message message);
+
+  bool completed() const;
+
+  // Runs `callback` with the response once it has arrived, or right away if
+  // it already has. The callbacks run on the thread that completes the
+  // future, without holding its lock.
+  void addCallback(const Callback& callback);
+
+ private:
+  mutable std::mutex mutex_;
+  std::atomic_bool completed_{false};
+  std::condition_variable finished_cv_;
+  std::vector<Callback> callbacks_;
+  Message message_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
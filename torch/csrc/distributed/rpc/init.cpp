@@ -0,0 +1,130 @@
+#include <torch/csrc/python_headers.h>
+
+#include <torch/csrc/distributed/rpc/functions.h>
+#include <torch/csrc/distributed/rpc/future_message.h>
+#include <torch/csrc/distributed/rpc/process_group_agent.h>
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
+#include <torch/csrc/distributed/rpc/script_call.h>
+#include <torch/csrc/jit/pybind_utils.h>
+#include <torch/csrc/utils/object_ptr.h>
+#include <torch/csrc/utils/pybind.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+template <typename T>
+using shared_ptr_class_ = py::class_<T, std::shared_ptr<T>>;
+
+// Sends a call of the builtin operator `opName` with the overload that
+// matches the arguments.
+std::shared_ptr<FutureMessage> invokeRpcBuiltin(
+    RpcAgent& agent,
+    const std::string& dstName,
+    const std::string& opName,
+    const py::args& args,
+    const py::kwargs& kwargs) {
+  const auto symbol = c10::Symbol::fromQualString(opName);
+  for (const auto& op : torch::jit::getAllOperatorsFor(symbol)) {
+    std::vector<at::IValue> stack;
+    try {
+      stack = torch::jit::createStackForSchema(op->schema(), args, kwargs);
+    } catch (std::runtime_error& e) {
+      continue;
+    }
+    auto message = ScriptCall(op, std::move(stack)).toMessage();
+    AutoNoGIL no_gil;
+    return agent.send(dstName, std::move(message));
+  }
+  AT_ERROR(
+      "Failed to match operator name ",
+      opName,
+      " and arguments "
+      "(args: ",
+      py::str(args),
+      ", kwargs: ",
+      py::str(kwargs),
+      ") to a builtin operator");
+}
+
+std::shared_ptr<FutureMessage> invokeRpcPythonUdf(
+    RpcAgent& agent,
+    const std::string& dstName,
+    const std::string& pickledPythonUDF) {
+  std::vector<char> payload(pickledPythonUDF.begin(), pickledPythonUDF.end());
+  AutoNoGIL no_gil;
+  return agent.send(
+      dstName,
+      Message(
+          std::move(payload),
+          std::vector<at::Tensor>(),
+          MessageType::PYTHON_CALL));
+}
+
+PyObject* rpc_init(PyObject* /* unused */) {
+  auto dist_module = THPObjectPtr(PyImport_ImportModule("torch.distributed"));
+  if (!dist_module) {
+    throw python_error();
+  }
+
+  auto module = py::handle(dist_module).cast<py::module>();
+
+  auto rpcAgent = shared_ptr_class_<RpcAgent>(module, "RpcAgent")
+                      .def(
+                          "join",
+                          &RpcAgent::join,
+                          py::call_guard<py::gil_scoped_release>())
+                      .def(
+                          "sync",
+                          &RpcAgent::sync,
+                          py::call_guard<py::gil_scoped_release>())
+                      .def_property_readonly(
+                          "worker_name", &RpcAgent::getWorkerName);
+
+  shared_ptr_class_<FutureMessage>(module, "FutureMessage")
+      .def("wait", [](FutureMessage& future) {
+        const Message* message;
+        {
+          AutoNoGIL no_gil;
+          message = &future.wait();
+        }
+        return toPyObj(*message);
+      });
+
+  shared_ptr_class_<ProcessGroupAgent>(module, "ProcessGroupAgent", rpcAgent)
+      .def(
+          py::init([](std::string workerName,
+                      std::shared_ptr<::c10d::ProcessGroup> pg,
+                      int numSendRecvThreads) {
+            return std::make_shared<ProcessGroupAgent>(
+                std::move(workerName),
+                std::move(pg),
+                processRequestBlocking,
+                numSendRecvThreads);
+          }),
+          py::arg("name"),
+          py::arg("process_group"),
+          py::arg("num_send_recv_threads") = 4,
+          py::call_guard<py::gil_scoped_release>());
+
+  module.def("invoke_rpc_builtin", &invokeRpcBuiltin);
+  module.def("invoke_rpc_python_udf", &invokeRpcPythonUdf);
+
+  Py_RETURN_TRUE;
+}
+
+} // namespace
+
+static PyMethodDef methods[] = {
+    {"_rpc_init", (PyCFunction)rpc_init, METH_NOARGS, nullptr},
+    {nullptr, nullptr, 0, nullptr}};
+
+PyMethodDef* python_functions() {
+  return methods;
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
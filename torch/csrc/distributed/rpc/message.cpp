@@ -0,0 +1,93 @@
+#include <torch/csrc/distributed/rpc/message.h>
+
+#include <cstring>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+Message::Message() = default;
+
+Message::Message(
+    std::vector<char>&& payload,
+    std::vector<at::Tensor>&& tensors,
+    MessageType type)
+    : payload_(std::move(payload)), tensors_(std::move(tensors)), type_(type) {}
+
+Message::Message(
+    std::vector<char>&& payload,
+    std::vector<at::Tensor>&& tensors,
+    MessageType type,
+    int64_t id)
+    : payload_(std::move(payload)),
+      tensors_(std::move(tensors)),
+      type_(type),
+      id_(id) {}
+
+Message::Message(const Message& other) = default;
+
+Message::Message(Message&& other) noexcept = default;
+
+Message& Message::operator=(Message const& rhs) & {
+  Message(rhs).swap(*this);
+  return *this;
+}
+
+Message& Message::operator=(Message&& rhs) & {
+  Message(std::move(rhs)).swap(*this);
+  return *this;
+}
+
+void Message::swap(Message& rhs) noexcept {
+  std::swap(payload_, rhs.payload_);
+  std::swap(tensors_, rhs.tensors_);
+  std::swap(type_, rhs.type_);
+  std::swap(id_, rhs.id_);
+}
+
+const std::vector<char>& Message::payload() const {
+  return payload_;
+}
+
+const std::vector<at::Tensor>& Message::tensors() const {
+  return tensors_;
+}
+
+const MessageType& Message::type() const {
+  return type_;
+}
+
+bool Message::isRequest() const {
+  return MessageType::BUILTIN_OP == type_ || MessageType::PYTHON_CALL == type_;
+}
+
+bool Message::isResponse() const {
+  return MessageType::BUILTIN_RET == type_ ||
+      MessageType::PYTHON_RET == type_ || MessageType::EXCEPTION == type_;
+}
+
+bool Message::isShutdown() const {
+  return MessageType::SHUTDOWN == type_;
+}
+
+int64_t Message::id() const {
+  return id_;
+}
+
+void Message::setId(int64_t id) {
+  id_ = id;
+}
+
+Message createException(const std::exception& e, int64_t id) {
+  const char* err = e.what();
+  std::vector<char> payload(err, err + strlen(err));
+  return Message(
+      std::move(payload),
+      std::vector<at::Tensor>(),
+      MessageType::EXCEPTION,
+      id);
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+enum MessageType {
+  BUILTIN_OP = 0,
+  BUILTIN_RET,
+  PYTHON_CALL,
+  PYTHON_RET,
+  SHUTDOWN,
+  EXCEPTION,
+  UNKNOWN
+};
+
+// A message to be sent/received by an RpcAgent.
+//
+// A message object contains 4 fields:
+//    payload (std::vector<char>): a binary chunk of data.
+//    tensors (std::vector<at::Tensor>): all tensors. Tensor data are not
+//        included in the payload, and it is up to the RpcAgent implementation
+//        to determine how to serialize them. This design is helpful for
+//        communicating super large tensors where serializing all the data at
+//        once leads to excessively large memory footprint. An implementation
+//        can then serialize and send tensors chunk-by-chunk, in the streaming
+//        fashion.
+//    type (MessageType): type of the message.
+//    id (int64_t): message id, this is used by the agent to match a request
+//        with its response.
+//
+// Layers above ``RpcAgent`` only convert ScriptCall, ScriptRet, PythonUDF,
+// etc. into a Message, and it is up to the RpcAgent implementation to
+// determine how to serialize a message.
+class TORCH_API Message final {
+ public:
+  Message();
+
+  Message(
+      std::vector<char>&& payload,
+      std::vector<at::Tensor>&& tensors,
+      MessageType type);
+
+  Message(
+      std::vector<char>&& payload,
+      std::vector<at::Tensor>&& tensors,
+      MessageType type,
+      int64_t id);
+
+  Message(const Message& other);
+  Message(Message&& other) noexcept;
+  Message& operator=(Message const& rhs) &;
+  Message& operator=(Message&& rhs) &;
+  void swap(Message& rhs) noexcept;
+
+  const std::vector<char>& payload() const;
+  const std::vector<at::Tensor>& tensors() const;
+  const MessageType& type() const;
+
+  // Request messages expect a response, the others are responses or
+  // notifications.
+  bool isRequest() const;
+  bool isResponse() const;
+  bool isShutdown() const;
+
+  // id is an optional field to match request/response. If an RpcAgent
+  // implementation is able to do the matching without using this id, it can
+  // be dropped during message serialization.
+  int64_t id() const;
+  void setId(int64_t id);
+
+ private:
+  std::vector<char> payload_;
+  std::vector<at::Tensor> tensors_;
+  MessageType type_ = MessageType::UNKNOWN;
+  int64_t id_ = -1;
+};
+
+// Returns an EXCEPTION message that carries the error message of `e` as its
+// payload, in response to the request with the given id.
+TORCH_API Message createException(const std::exception& e, int64_t id);
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
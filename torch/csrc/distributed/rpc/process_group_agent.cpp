@@ -0,0 +1,299 @@
+#include <torch/csrc/distributed/rpc/process_group_agent.h>
+
+#include <c10/util/Exception.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <cstring>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+// All the tensors of the messages are sent with this tag.
+constexpr int kTag = 0;
+
+// The preamble holds the type of the message, its id, the size of its payload,
+// the number of its tensors and the number of int64 values of their metadata.
+constexpr int64_t kPreambleSize = 5;
+
+// The names of the workers are exchanged as char tensors of this size.
+constexpr size_t kMaxNameLength = 128;
+
+void checkTensors(const Message& message) {
+  for (const auto& tensor : message.tensors()) {
+    AT_CHECK(
+        !tensor.is_sparse() && tensor.device().is_cpu(),
+        "RPCs only support dense CPU tensors");
+  }
+}
+
+void waitAll(const std::vector<std::shared_ptr<c10d::ProcessGroup::Work>>& works) {
+  for (const auto& work : works) {
+    work->wait();
+  }
+}
+
+} // namespace
+
+ProcessGroupAgent::ProcessGroupAgent(
+    std::string workerName,
+    std::shared_ptr<c10d::ProcessGroup> pg,
+    RequestCallback cb,
+    int numSendRecvThreads)
+    : RpcAgent(std::move(workerName), std::move(cb)),
+      pg_(std::move(pg)),
+      nextId_(0),
+      joined_(false),
+      threadPool_(numSendRecvThreads) {
+  AT_CHECK(
+      workerName_.size() <= kMaxNameLength,
+      "RPC worker names can have at most ",
+      kMaxNameLength,
+      " characters, got ",
+      workerName_);
+
+  // Exchange the names of the workers.
+  const int worldSize = pg_->getSize();
+  std::vector<at::Tensor> inputs = {at::zeros({kMaxNameLength}, at::kChar)};
+  std::memcpy(
+      inputs[0].data_ptr(), workerName_.c_str(), workerName_.size());
+  std::vector<std::vector<at::Tensor>> outputs(1);
+  for (int rank = 0; rank < worldSize; rank++) {
+    outputs[0].push_back(at::empty({kMaxNameLength}, at::kChar));
+  }
+  pg_->allgather(outputs, inputs)->wait();
+  for (int rank = 0; rank < worldSize; rank++) {
+    const auto data = static_cast<const char*>(outputs[0][rank].data_ptr());
+    std::string name(data, strnlen(data, kMaxNameLength));
+    AT_CHECK(
+        nameMap_.emplace(name, rank).second,
+        "RPC worker name ",
+        name,
+        " is used by both rank ",
+        nameMap_[name],
+        " and rank ",
+        rank);
+    names_.push_back(std::move(name));
+  }
+
+  // With a single worker, every message is processed locally.
+  if (worldSize > 1) {
+    listenerThread_ = std::thread(&ProcessGroupAgent::listenLoop, this);
+  }
+}
+
+ProcessGroupAgent::~ProcessGroupAgent() {
+  if (listenerThread_.joinable()) {
+    AT_WARN("ProcessGroupAgent destroyed without join(), the pending RPCs are lost.");
+    listenerThread_.detach();
+  }
+}
+
+std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
+    const std::string& to,
+    Message&& message) {
+  auto it = nameMap_.find(to);
+  AT_CHECK(it != nameMap_.end(), "Unknown RPC destination ", to);
+  AT_CHECK(!joined_, "Cannot send RPCs after join()");
+  checkTensors(message);
+  const int dstRank = it->second;
+
+  auto future = std::make_shared<FutureMessage>();
+  if (message.isRequest()) {
+    const int64_t id = nextId_++;
+    message.setId(id);
+    std::lock_guard<std::mutex> lock(futureMutex_);
+    futures_[id] = future;
+  } else {
+    future->markCompleted(Message());
+  }
+
+  // The capture of a std::function has to be copyable.
+  auto shared = std::make_shared<Message>(std::move(message));
+  threadPool_.run([this, dstRank, shared] {
+    try {
+      sendToRank(dstRank, *shared);
+    } catch (const std::exception& e) {
+      // Whoever waits for the response gets the error instead.
+      if (shared->isRequest()) {
+        completeFuture(createException(e, shared->id()));
+      }
+    }
+  });
+  return future;
+}
+
+void ProcessGroupAgent::sendToRank(int dstRank, const Message& message) {
+  if (dstRank == pg_->getRank()) {
+    processMessage(dstRank, message);
+    return;
+  }
+
+  const auto& payload = message.payload();
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(message.tensors().size());
+  std::vector<int64_t> meta;
+  for (const auto& tensor : message.tensors()) {
+    tensors.push_back(tensor.contiguous());
+    meta.push_back(static_cast<int64_t>(tensor.scalar_type()));
+    meta.push_back(tensor.dim());
+    meta.insert(meta.end(), tensor.sizes().begin(), tensor.sizes().end());
+  }
+
+  std::vector<std::vector<at::Tensor>> buffers;
+  buffers.push_back({at::tensor(
+      std::vector<int64_t>{message.type(),
+                           message.id(),
+                           static_cast<int64_t>(payload.size()),
+                           static_cast<int64_t>(tensors.size()),
+                           static_cast<int64_t>(meta.size())},
+      at::kLong)});
+  if (!meta.empty()) {
+    buffers.push_back({at::tensor(meta, at::kLong)});
+  }
+  if (!payload.empty()) {
+    // Aliases the payload, which outlives the sends.
+    buffers.push_back({at::from_blob(
+        const_cast<char*>(payload.data()),
+        {static_cast<int64_t>(payload.size())},
+        at::kChar)});
+  }
+  for (auto& tensor : tensors) {
+    if (tensor.numel() > 0) {
+      buffers.push_back({tensor});
+    }
+  }
+
+  std::vector<std::shared_ptr<c10d::ProcessGroup::Work>> works;
+  {
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    for (auto& buffer : buffers) {
+      works.push_back(pg_->send(buffer, dstRank, kTag));
+    }
+  }
+  waitAll(works);
+}
+
+void ProcessGroupAgent::processMessage(int srcRank, Message message) {
+  if (message.isRequest()) {
+    const auto id = message.id();
+    Message response;
+    try {
+      response = cb_(std::move(message));
+      checkTensors(response);
+    } catch (const std::exception& e) {
+      response = createException(e, id);
+    }
+    response.setId(id);
+    sendToRank(srcRank, response);
+  } else if (message.isResponse()) {
+    completeFuture(std::move(message));
+  } else {
+    AT_ERROR("Unrecognized RPC message type ", message.type());
+  }
+}
+
+void ProcessGroupAgent::completeFuture(Message response) {
+  std::shared_ptr<FutureMessage> future;
+  {
+    std::lock_guard<std::mutex> lock(futureMutex_);
+    auto it = futures_.find(response.id());
+    AT_ASSERTM(
+        it != futures_.end(), "Received a response to an unknown request");
+    future = std::move(it->second);
+    futures_.erase(it);
+  }
+  future->markCompleted(std::move(response));
+  futureCV_.notify_all();
+}
+
+void ProcessGroupAgent::listenLoop() {
+  while (true) {
+    std::vector<at::Tensor> preamble = {at::empty({kPreambleSize}, at::kLong)};
+    auto work = pg_->recvAnysource(preamble, kTag);
+    work->wait();
+    const int srcRank = work->sourceRank();
+    const auto values = preamble[0].data<int64_t>();
+    const auto type = static_cast<MessageType>(values[0]);
+    const int64_t id = values[1];
+    const int64_t payloadSize = values[2];
+    const int64_t numTensors = values[3];
+    const int64_t metaSize = values[4];
+
+    if (type == MessageType::SHUTDOWN) {
+      return;
+    }
+
+    std::vector<int64_t> meta(metaSize);
+    if (metaSize > 0) {
+      std::vector<at::Tensor> buffer = {at::empty({metaSize}, at::kLong)};
+      pg_->recv(buffer, srcRank, kTag)->wait();
+      std::memcpy(meta.data(), buffer[0].data_ptr(), metaSize * sizeof(int64_t));
+    }
+
+    std::vector<char> payload(payloadSize);
+    if (payloadSize > 0) {
+      // Receives straight into the payload of the message.
+      std::vector<at::Tensor> buffer = {
+          at::from_blob(payload.data(), {payloadSize}, at::kChar)};
+      pg_->recv(buffer, srcRank, kTag)->wait();
+    }
+
+    std::vector<at::Tensor> tensors;
+    tensors.reserve(numTensors);
+    size_t offset = 0;
+    for (int64_t i = 0; i < numTensors; i++) {
+      const auto scalarType = static_cast<at::ScalarType>(meta[offset]);
+      const auto dim = meta[offset + 1];
+      std::vector<int64_t> sizes(
+          meta.begin() + offset + 2, meta.begin() + offset + 2 + dim);
+      offset += 2 + dim;
+      // The tensors are handed to operators and to Python, which expect
+      // variables.
+      std::vector<at::Tensor> buffer = {
+          torch::autograd::make_variable(at::empty(sizes, scalarType))};
+      if (buffer[0].numel() > 0) {
+        pg_->recv(buffer, srcRank, kTag)->wait();
+      }
+      tensors.push_back(std::move(buffer[0]));
+    }
+
+    auto message = std::make_shared<Message>(
+        std::move(payload), std::move(tensors), type, id);
+    threadPool_.run([this, srcRank, message] {
+      processMessage(srcRank, std::move(*message));
+    });
+  }
+}
+
+void ProcessGroupAgent::sync() {
+  std::unique_lock<std::mutex> lock(futureMutex_);
+  futureCV_.wait(lock, [this] { return futures_.empty(); });
+}
+
+void ProcessGroupAgent::join() {
+  AT_CHECK(!joined_, "join() can only be called once");
+  // Once every worker has all the responses to its requests, nobody sends
+  // messages anymore.
+  sync();
+  pg_->barrier()->wait();
+  joined_ = true;
+  if (listenerThread_.joinable()) {
+    // Every worker stops the listener of the next one. The SHUTDOWN message
+    // follows all the other messages this worker sent it.
+    const int dstRank = (pg_->getRank() + 1) % pg_->getSize();
+    std::vector<at::Tensor> preamble = {at::tensor(
+        std::vector<int64_t>{MessageType::SHUTDOWN, -1, 0, 0, 0}, at::kLong)};
+    {
+      std::lock_guard<std::mutex> lock(sendMutex_);
+      pg_->send(preamble, dstRank, kTag)->wait();
+    }
+    listenerThread_.join();
+  }
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
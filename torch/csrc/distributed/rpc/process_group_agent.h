@@ -0,0 +1,94 @@
+#pragma once
+
+#include <c10/core/thread_pool.h>
+#include <c10d/ProcessGroup.hpp>
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// An RpcAgent that sends the messages with the point-to-point operations of a
+// ProcessGroup, in which every worker has a rank. A message is sent as a
+// sequence of tensors, all with the same tag:
+//
+//   1. a preamble of int64 values: the message type, its id, the size of its
+//      payload, the number of its tensors and the size of their metadata,
+//   2. the metadata of the tensors, i.e. their scalar type, dimension and
+//      sizes, as int64 values,
+//   3. the payload, as a char tensor that aliases the payload of the message,
+//   4. the tensors of the message themselves.
+//
+// The payload and the tensors are sent without copying them, except for the
+// tensors that aren't contiguous. Only dense CPU tensors can be sent.
+//
+// The receiver only waits for a preamble from any rank, and then receives the
+// rest of the message from the rank that sent it. The messages that a worker
+// sends are not interleaved, so they arrive in the order they were sent.
+// Requests are processed, and the responses sent, on a thread pool.
+class TORCH_API ProcessGroupAgent : public RpcAgent {
+ public:
+  // Exchanges the names of the workers with all the other ranks of `pg`,
+  // which must be unique.
+  ProcessGroupAgent(
+      std::string workerName,
+      std::shared_ptr<c10d::ProcessGroup> pg,
+      RequestCallback cb,
+      int numSendRecvThreads = 4);
+
+  ~ProcessGroupAgent() override;
+
+  std::shared_ptr<FutureMessage> send(const std::string& to, Message&& message)
+      override;
+
+  void join() override;
+
+  void sync() override;
+
+ private:
+  // Sends `message` to `dstRank` through the process group, or processes it
+  // here if this is its own rank. Runs on the thread pool.
+  void sendToRank(int dstRank, const Message& message);
+
+  // Processes a message received from `srcRank`: runs the callback on
+  // requests and sends back their responses, and completes the futures of
+  // responses.
+  void processMessage(int srcRank, Message message);
+
+  // Completes the future of the request that `response` responds to.
+  void completeFuture(Message response);
+
+  // Receives messages until a SHUTDOWN message arrives.
+  void listenLoop();
+
+  std::shared_ptr<c10d::ProcessGroup> pg_;
+  // The names of the workers, by rank.
+  std::vector<std::string> names_;
+  std::unordered_map<std::string, int> nameMap_;
+
+  std::atomic<int64_t> nextId_;
+  // The futures of the requests this worker has sent, by message id, until
+  // their responses arrive.
+  std::unordered_map<int64_t, std::shared_ptr<FutureMessage>> futures_;
+  std::mutex futureMutex_;
+  std::condition_variable futureCV_;
+
+  // Held while the tensors of a message are posted, so that the messages
+  // sent by different threads are not interleaved.
+  std::mutex sendMutex_;
+
+  std::atomic<bool> joined_;
+  std::thread listenerThread_;
+  c10::ThreadPool threadPool_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
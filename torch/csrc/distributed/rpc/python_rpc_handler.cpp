@@ -0,0 +1,42 @@
+#include <torch/csrc/distributed/rpc/python_rpc_handler.h>
+
+#include <torch/csrc/utils/auto_gil.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+py::object getFunction(const char* name) {
+  return py::module::import("torch.distributed.internal_rpc_utils").attr(name);
+}
+
+} // namespace
+
+std::vector<char> PythonRpcHandler::generatePythonUDFResult(
+    const Message& request) {
+  AutoGIL ag;
+  try {
+    const auto& payload = request.payload();
+    py::bytes pargs(payload.data(), payload.size());
+    py::bytes pres = getFunction("run_python_udf_internal")(pargs);
+    const auto res = static_cast<std::string>(pres);
+    return std::vector<char>(res.begin(), res.end());
+  } catch (py::error_already_set& e) {
+    // The Python error has to be released while holding the GIL, so only its
+    // message leaves this function.
+    throw std::runtime_error(e.what());
+  }
+}
+
+py::object PythonRpcHandler::loadPythonUDFResult(const Message& message) {
+  AutoGIL ag;
+  const auto& payload = message.payload();
+  py::bytes pres(payload.data(), payload.size());
+  return getFunction("load_python_udf_result_internal")(pres);
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
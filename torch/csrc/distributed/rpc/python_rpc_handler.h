@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/utils/pybind.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// Runs the Python functions of the RPCs, which are pickled together with
+// their arguments by torch.distributed.internal_rpc_utils. Both functions
+// acquire the GIL.
+class PythonRpcHandler {
+ public:
+  // Unpickles the function and the arguments in the payload of `request`,
+  // runs the function, and returns its pickled result.
+  static std::vector<char> generatePythonUDFResult(const Message& request);
+
+  // Unpickles the result in the payload of a PYTHON_RET message.
+  static py::object loadPythonUDFResult(const Message& message);
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
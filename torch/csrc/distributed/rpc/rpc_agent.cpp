@@ -0,0 +1,18 @@
+#include <torch/csrc/distributed/rpc/rpc_agent.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+RpcAgent::RpcAgent(std::string workerName, RequestCallback cb)
+    : workerName_(std::move(workerName)), cb_(std::move(cb)) {}
+
+RpcAgent::~RpcAgent() = default;
+
+const std::string& RpcAgent::getWorkerName() const {
+  return workerName_;
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
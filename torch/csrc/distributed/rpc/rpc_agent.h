@@ -0,0 +1,60 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/future_message.h>
+#include <torch/csrc/distributed/rpc/message.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// Processes a request message and returns its response. It runs on the
+// threads of the agent that received the request.
+using RequestCallback = std::function<Message(Message)>;
+
+// RpcAgent is the base class for sending and receiving RPC messages. It
+// provides a unified ``send`` API for both request and response messages, and
+// will invoke the given ``RequestCallback`` to process received requests. It
+// should immediately become ready to serve requests and accept responses after
+// construction.
+class TORCH_API RpcAgent {
+ public:
+  // The ``workerName`` is the globally unique name for this RpcAgent. It is up
+  // to the ``RpcAgent`` implementation to determine how to resolve names.
+  // The ``RequestCallback`` processes the requests this agent receives.
+  RpcAgent(std::string workerName, RequestCallback cb);
+
+  virtual ~RpcAgent();
+
+  // Sends a message to the ``RpcAgent`` named ``to`` and returns a
+  // ``FutureMessage`` ptr. The implementation must be asynchronous, i.e., it
+  // cannot block until it receives the response.
+  //
+  // If ``message.isRequest()`` is true, the ``FutureMessage`` will be
+  // completed when the response arrives. For other message types, the Future
+  // should be ignored by the caller.
+  virtual std::shared_ptr<FutureMessage> send(
+      const std::string& to,
+      Message&& message) = 0;
+
+  // Returns the name of this worker.
+  const std::string& getWorkerName() const;
+
+  // Blocks until all local and remote RPC processing is complete, and stops
+  // the agent. Every worker must call it, once.
+  virtual void join() = 0;
+
+  // Blocks until all the requests that this worker has sent are complete.
+  virtual void sync() = 0;
+
+ protected:
+  const std::string workerName_;
+  const RequestCallback cb_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -0,0 +1,66 @@
+#include <torch/csrc/distributed/rpc/script_call.h>
+
+#include <torch/csrc/jit/pickler.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+ScriptCall::ScriptCall(
+    std::shared_ptr<Operator> op,
+    std::vector<at::IValue>&& args)
+    : op_(std::move(op)), stack_(std::move(args)) {}
+
+std::shared_ptr<Operator> ScriptCall::op() const {
+  return op_;
+}
+
+const std::vector<at::IValue>& ScriptCall::stack() const {
+  return stack_;
+}
+
+Message ScriptCall::toMessage() const {
+  std::vector<at::Tensor> tensor_table;
+  torch::jit::Pickler pickler(&tensor_table);
+  pickler.start();
+  pickler.startTuple();
+  for (const auto& value : stack_) {
+    pickler.addIValue(value);
+  }
+  // The schema goes last, so that the arguments are a prefix of the values.
+  pickler.addIValue(at::IValue(toString(op_->schema())));
+  pickler.endTuple();
+  pickler.finish();
+
+  auto payload = pickler.stack();
+  return Message(
+      std::move(payload), std::move(tensor_table), MessageType::BUILTIN_OP);
+}
+
+ScriptCall ScriptCall::fromMessage(const Message& message) {
+  const auto& payload = message.payload();
+  torch::jit::Unpickler unpickler(
+      const_cast<char*>(payload.data()), payload.size(), &message.tensors());
+  auto values = unpickler.parse_ivalue_list();
+  AT_CHECK(!values.empty(), "Malformed builtin operator call");
+
+  auto op = matchOperator(values.back().toStringRef());
+  values.pop_back();
+  return ScriptCall(std::move(op), std::move(values));
+}
+
+std::shared_ptr<Operator> ScriptCall::matchOperator(const std::string& schema) {
+  // The schema starts with the qualified name of the operator.
+  const auto name = schema.substr(0, schema.find('('));
+  for (const auto& op :
+       torch::jit::getAllOperatorsFor(c10::Symbol::fromQualString(name))) {
+    if (toString(op->schema()) == schema) {
+      return op;
+    }
+  }
+  AT_ERROR("Cannot find builtin operator matching ", schema);
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
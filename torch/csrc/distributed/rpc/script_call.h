@@ -0,0 +1,40 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/jit/operator.h>
+
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+using torch::jit::Operator;
+
+// A ScriptCall instance represents an invocation of a builtin operator of the
+// JIT. The arguments are pickled together with the schema of the operator,
+// which identifies its overload. The tensors in the arguments are not
+// pickled, they are the tensors of the message.
+class TORCH_API ScriptCall final {
+ public:
+  ScriptCall(std::shared_ptr<Operator> op, std::vector<at::IValue>&& args);
+
+  std::shared_ptr<Operator> op() const;
+  // return the argument stack of this builtin operator
+  const std::vector<at::IValue>& stack() const;
+
+  Message toMessage() const;
+  static ScriptCall fromMessage(const Message& message);
+
+ private:
+  // Returns the operator with the given schema.
+  static std::shared_ptr<Operator> matchOperator(const std::string& schema);
+
+  std::shared_ptr<Operator> op_;
+  const std::vector<at::IValue> stack_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
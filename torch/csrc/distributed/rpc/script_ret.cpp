@@ -0,0 +1,40 @@
+#include <torch/csrc/distributed/rpc/script_ret.h>
+
+#include <torch/csrc/jit/pickler.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+ScriptRet::ScriptRet(at::IValue&& value) : value_(std::move(value)) {}
+
+const at::IValue& ScriptRet::value() const {
+  return value_;
+}
+
+Message ScriptRet::toMessage() const {
+  std::vector<at::Tensor> tensor_table;
+  torch::jit::Pickler pickler(&tensor_table);
+  pickler.start();
+  pickler.startTuple();
+  pickler.addIValue(value_);
+  pickler.endTuple();
+  pickler.finish();
+
+  auto payload = pickler.stack();
+  return Message(
+      std::move(payload), std::move(tensor_table), MessageType::BUILTIN_RET);
+}
+
+ScriptRet ScriptRet::fromMessage(const Message& message) {
+  const auto& payload = message.payload();
+  torch::jit::Unpickler unpickler(
+      const_cast<char*>(payload.data()), payload.size(), &message.tensors());
+  auto values = unpickler.parse_ivalue_list();
+  AT_CHECK(values.size() == 1, "Malformed builtin operator return value");
+  return ScriptRet(std::move(values.front()));
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
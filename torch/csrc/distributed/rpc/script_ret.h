@@ -0,0 +1,26 @@
+#pragma once
+
+#include <torch/csrc/distributed/rpc/message.h>
+#include <torch/csrc/jit/operator.h>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+// Return value of a builtin operator invoked by a ScriptCall. Operators with
+// several return values return them as a tuple.
+class TORCH_API ScriptRet final {
+ public:
+  explicit ScriptRet(at::IValue&& value);
+
+  const at::IValue& value() const;
+  Message toMessage() const;
+  static ScriptRet fromMessage(const Message& message);
+
+ private:
+  const at::IValue value_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
@@ -14,6 +14,8 @@ static PyObject * THPStorage_(sharedDecref)(THPStorage *self)
   THManagedMapAllocator *ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
   if (ctx) {
     ctx->decref();
+  } else if (auto chunk = THManagedMapChunk::fromDataPtr(storage->data_ptr())) {
+    chunk->decref();
   }
 #endif
   Py_INCREF(self);
@@ -29,6 +31,8 @@ static PyObject * THPStorage_(sharedIncref)(THPStorage *self)
   THManagedMapAllocator *ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
   if (ctx) {
     ctx->incref();
+  } else if (auto chunk = THManagedMapChunk::fromDataPtr(storage->data_ptr())) {
+    chunk->incref();
   }
 #endif
   Py_RETURN_NONE;
@@ -52,6 +56,11 @@ static std::string THPStorage_(__newHandle)() {
 
 static THWStorage* THPStorage_(newFilenameStorage)(ptrdiff_t size)
 {
+  // Carve the storage out of a pooled slab if it isn't too large
+  auto chunk = THManagedMapChunk::makeDataPtr(size * sizeof(scalar_t));
+  if (chunk) {
+    return THWStorage_(newWithDataAndAllocator)(std::move(chunk), size, /* allocator */ nullptr);
+  }
   int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE;
   std::string handle = THPStorage_(__newHandle)();
   return THWStorage_(newWithDataAndAllocator)(
@@ -73,32 +82,43 @@ static PyObject * THPStorage_(shareFilename)(THPStorage *self)
 {
   HANDLE_TH_ERRORS
   THWStorage *storage = self->cdata;
-  THManagedMapAllocator *ctx;
+  THManagedMapAllocator *ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
+  THManagedMapChunk *chunk = THManagedMapChunk::fromDataPtr(storage->data_ptr());
   // Storage is already in shared memory, just return a handle
-  if ((ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr()))) {
-    // done
-  } else {
+  if (!ctx && !chunk) {
     // TODO: retry on collision
     // TODO: free GIL - but remember to reacquire it when an exception is thrown
     THWStoragePtr new_storage(THPStorage_(newFilenameStorage)(storage->numel()));
     THWStorage_(copy)(new_storage, storage);
     THWStorage_(swap)(storage, new_storage);
     ctx = THManagedMapAllocator::fromDataPtr(storage->data_ptr());
-    AT_ASSERT(ctx);
+    chunk = THManagedMapChunk::fromDataPtr(storage->data_ptr());
+    AT_ASSERT(ctx || chunk);
   }
 
-  THPObjectPtr manager_handle(PyBytes_FromString(ctx->manager_handle()));
+  // Chunks of pooled slabs are shared with their offset in the slab
+  THPObjectPtr manager_handle(PyBytes_FromString(
+      ctx ? ctx->manager_handle() : chunk->manager_handle()));
   if (!manager_handle) return nullptr;
-  THPObjectPtr storage_handle(PyBytes_FromString(ctx->filename()));
+  THPObjectPtr storage_handle(PyBytes_FromString(
+      ctx ? ctx->filename() : chunk->filename()));
   if (!storage_handle) return nullptr;
   THPObjectPtr size(PyLong_FromLong(storage->numel()));
   if (!size) return nullptr;
+  THPObjectPtr offset;
+  if (chunk) {
+    offset = PyLong_FromLong(chunk->offset());
+    if (!offset) return nullptr;
+  }
 
-  THPObjectPtr tuple(PyTuple_New(3));
+  THPObjectPtr tuple(PyTuple_New(chunk ? 4 : 3));
   if (!tuple) return nullptr;
   PyTuple_SET_ITEM(tuple.get(), 0, manager_handle.release());
   PyTuple_SET_ITEM(tuple.get(), 1, storage_handle.release());
   PyTuple_SET_ITEM(tuple.get(), 2, size.release());
+  if (chunk) {
+    PyTuple_SET_ITEM(tuple.get(), 3, offset.release());
+  }
   return tuple.release();
   END_HANDLE_TH_ERRORS
 }
@@ -106,18 +126,29 @@ static PyObject * THPStorage_(shareFilename)(THPStorage *self)
 static PyObject * THPStorage_(newSharedFilename)(PyObject *_unused, PyObject *args)
 {
   HANDLE_TH_ERRORS
-  THPUtils_assert(PyTuple_GET_SIZE(args) == 3, "tuple of 3 items expected");
+  Py_ssize_t num_args = PyTuple_GET_SIZE(args);
+  THPUtils_assert(num_args == 3 || num_args == 4, "tuple of 3 or 4 items expected");
   PyObject *_manager_handle = PyTuple_GET_ITEM(args, 0);
   PyObject *_object_handle = PyTuple_GET_ITEM(args, 1);
   PyObject *_size = PyTuple_GET_ITEM(args, 2);
-  if (!PyBytes_Check(_manager_handle) || !PyBytes_Check(_object_handle) || !THPUtils_checkLong(_size)) {
+  PyObject *_offset = num_args == 4 ? PyTuple_GET_ITEM(args, 3) : nullptr;
+  if (!PyBytes_Check(_manager_handle) || !PyBytes_Check(_object_handle) || !THPUtils_checkLong(_size) ||
+      (_offset && !THPUtils_checkLong(_offset))) {
     THPUtils_invalidArguments(args, nullptr, "_new_shared in file system mode", 1,
-        "a handle (string/bytes) and storage size (int)");
+        "a handle (string/bytes), storage size (int) and optionally an offset into a slab (int)");
     return nullptr;
   }
   const char *manager_handle = PyBytes_AS_STRING(_manager_handle);
   const char *object_handle = PyBytes_AS_STRING(_object_handle);
   int64_t size = THPUtils_unpackLong(_size);
+  if (_offset) {
+    int64_t offset = THPUtils_unpackLong(_offset);
+    return THPStorage_(New)(
+            THWStorage_(newWithDataAndAllocator)(
+              THManagedMapChunk::openDataPtr(manager_handle, object_handle, offset, size * sizeof(scalar_t)),
+              size,
+              /* allocator */ nullptr));
+  }
   int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM |
               TH_ALLOCATOR_MAPPED_NOCREATE;
   return THPStorage_(New)(
@@ -241,10 +272,9 @@ static PyObject * THPStorage_(shareCuda)(THPStorage *self)
     void *base_ptr = c10::cuda::CUDACachingAllocator::getBaseAllocation(THWStorage_(data)(LIBRARY_STATE storage), &base_size);
     ptrdiff_t offset_bytes = (char*)storage->data<scalar_t>() - (char*)base_ptr;
 
-    cudaIpcMemHandle_t handle;
-    THCudaCheck(cudaIpcGetMemHandle(&handle, base_ptr));
+    std::string handle = c10::cuda::CUDACachingAllocator::getIpcMemHandle(base_ptr);
 
-    _handle = PyBytes_FromStringAndSize((char *)&handle, CUDA_IPC_HANDLE_SIZE);
+    _handle = PyBytes_FromStringAndSize(handle.data(), handle.size());
     _offset_bytes = PyLong_FromSsize_t((Py_ssize_t)offset_bytes);
 
     // Put Storage Data behind new ref counting context
@@ -516,7 +546,8 @@ PyObject * THPStorage_(isShared)(THPStorage *self)
   Py_RETURN_TRUE;
 #else
   if (THMapAllocator::fromDataPtr(self->cdata->data_ptr()) ||
-      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr())) {
+      THManagedMapAllocator::fromDataPtr(self->cdata->data_ptr()) ||
+      THManagedMapChunk::fromDataPtr(self->cdata->data_ptr())) {
     Py_RETURN_TRUE;
   } else {
     Py_RETURN_FALSE;
@@ -670,6 +670,96 @@ static void deduplicateSizeCaptures(
   }
 }
 
+// Elementwise ops that cost less to recompute in the reverse graph than to
+// save their results for it. Recomputed nodes also end up fused with the
+// gradient computations that use them, while a saved value has to be
+// written out by the forward and read back by the backward.
+static bool isCheapToRecompute(Node* n) {
+  static OperatorSet cheap_ops = {
+      "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::add(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+      "aten::sub(Tensor self, Scalar other, Scalar alpha) -> Tensor",
+      "aten::mul(Tensor self, Tensor other) -> Tensor",
+      "aten::mul(Tensor self, Scalar other) -> Tensor",
+      "aten::div(Tensor self, Scalar other) -> Tensor",
+      "aten::neg(Tensor self) -> Tensor",
+      "aten::type_as(Tensor self, Tensor other) -> Tensor",
+      "aten::lt(Tensor self, Scalar other) -> Tensor",
+      "aten::le(Tensor self, Scalar other) -> Tensor",
+      "aten::gt(Tensor self, Scalar other) -> Tensor",
+      "aten::ge(Tensor self, Scalar other) -> Tensor",
+      "aten::eq(Tensor self, Scalar other) -> Tensor",
+      "aten::ne(Tensor self, Scalar other) -> Tensor",
+  };
+  return cheap_ops.find(n);
+}
+
+static bool isInBlock(const Node* n, const Block* b) {
+  for (const Block* owner = n->owningBlock(); owner;
+       owner = owner->owningNode() ? owner->owningNode()->owningBlock()
+                                   : nullptr) {
+    if (owner == b)
+      return true;
+  }
+  return false;
+}
+
+// Captured intermediates that are produced by a cheap elementwise op from
+// values the reverse graph gets anyway (inputs of f, constants and other
+// captures) are recomputed at the start of the reverse block instead of being
+// captured. This never makes the backward capture more values, and saves the
+// forward from keeping the intermediate alive. Outputs of f are left alone,
+// as capturing them is free.
+static void recomputeCheapCaptures(
+    Gradient& grad_desc,
+    ReverseDetails& rev_info) {
+  static const auto err = [](Value*) -> Value* {
+    throw std::runtime_error("unexpected input");
+  };
+  auto& graph = *grad_desc.f;
+  Block* primal_block = graph.block();
+  Block* reverse_block = rev_info.reverse_block;
+  auto captures = getReverseCaptures(grad_desc);
+  value_set available(captures.begin(), captures.end());
+  value_set outputs(graph.outputs().begin(), graph.outputs().end());
+  value_map recomputed;
+
+  const auto can_use = [&](Value* v) {
+    return v->node()->kind() == prim::Constant ||
+        v->node() == graph.param_node() || available.count(v) > 0;
+  };
+  // Clones are inserted in topological order, ahead of all gradient code
+  WithInsertPoint insert_guard{*reverse_block->nodes().begin()};
+  for (Value* capture : captures) {
+    Node* node = capture->node();
+    if (node->owningBlock() != primal_block || node->outputs().size() != 1 ||
+        outputs.count(capture) > 0 || !isCheapToRecompute(node)) {
+      continue;
+    }
+    const auto inputs = node->inputs();
+    if (!std::all_of(inputs.begin(), inputs.end(), can_use)) {
+      continue;
+    }
+    Node* clone = graph.insertNode(graph.createClone(node, [&](Value* v) {
+      auto it = recomputed.find(v);
+      if (it != recomputed.end())
+        return it->second;
+      if (v->node()->kind() == prim::Constant) {
+        return graph.insertNode(graph.createClone(v->node(), err))->output();
+      }
+      return v;
+    }));
+    const auto uses = capture->uses();
+    for (const Use& use : uses) {
+      if (isInBlock(use.user, reverse_block)) {
+        use.user->replaceInput(use.offset, clone->output());
+      }
+    }
+    recomputed[capture] = clone->output();
+  }
+}
+
 static void eliminateDeadCode(ReverseDetails& rev_info) {
   // addReverseInline has to call gradientForNode if *any* of the inputs
   // require grad, but it will emit vjps for *all* inputs. Use DCE to remove
@@ -710,6 +800,8 @@ static void Optimize(Gradient& grad_desc, ReverseDetails& rev_info) {
   EliminateCommonSubexpression(grad_desc.f);
   deduplicateSizeCaptures(grad_desc, rev_info);
   eliminateDeadCode(rev_info);
+  // Only the captures that are still live are worth recomputing
+  recomputeCheapCaptures(grad_desc, rev_info);
 }
 
 // Takes a grad_desc.f returned from `addReverseInline` and splits off the
@@ -7,7 +7,10 @@
 
 #include <ATen/core/functional.h>
 #include <c10/util/Exception.h>
+#include <torch/csrc/jit/graph_executor.h>
 #include <torch/csrc/jit/import_export_helpers.h>
+#include <torch/csrc/jit/interpreter.h>
+#include <torch/csrc/jit/mobile/bytecode.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/python_print.h>
 #include <torch/csrc/jit/pickler.h>
@@ -19,9 +22,13 @@
 #include <onnx/onnx_pb.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <c10/util/Optional.h>
 
+#include <cctype>
+#include <deque>
 #include <fstream>
+#include <future>
 #include <memory>
 #include <set>
 #include <sstream>
@@ -113,7 +120,7 @@ class EncoderBase {
       onnx_torch::OperatorExportTypes operator_export_type,
       bool strip_doc);
 
-  onnx::ModelProto get_model_proto() {
+  const onnx::ModelProto& get_model_proto() const {
     return model_proto_;
   }
 
@@ -403,7 +410,8 @@ class GraphEncoder : public EncoderBase {
       onnx_torch::OperatorExportTypes operator_export_type,
       const std::map<std::string, at::Tensor>& initializers,
       bool defer_weight_export,
-      bool strip_doc);
+      bool strip_doc,
+      const std::string& external_data_dir = std::string());
 
   RawDataExportMap get_raw_data_export_map() {
     return raw_data_export_map_;
@@ -415,8 +423,21 @@ class GraphEncoder : public EncoderBase {
       const at::Tensor& tensor,
       const c10::optional<std::string> external_ref = {}) override;
 
+  // Gives the initializer a file of its own in external_data_dir_ and
+  // starts writing its data there.
+  void EncodeExternalTensor(
+      onnx::TensorProto* tensor_proto,
+      const at::Tensor& tensor,
+      const std::string& name);
+
+  // Waits until at most max_pending external data writes are running.
+  void waitForWrites(size_t max_pending);
+
   RawDataExportMap raw_data_export_map_;
   bool defer_weight_export_;
+  std::string external_data_dir_;
+  std::set<std::string> external_files_;
+  std::deque<std::future<void>> pending_writes_;
 };
 
 GraphEncoder::GraphEncoder(
@@ -425,9 +446,15 @@ GraphEncoder::GraphEncoder(
     onnx_torch::OperatorExportTypes operator_export_type,
     const std::map<std::string, at::Tensor>& initializers,
     bool defer_weight_export,
-    bool strip_doc)
+    bool strip_doc,
+    const std::string& external_data_dir)
     : EncoderBase(operator_export_type, strip_doc),
-      defer_weight_export_(defer_weight_export) {
+      defer_weight_export_(defer_weight_export),
+      external_data_dir_(external_data_dir) {
+  AT_CHECK(
+      !defer_weight_export || external_data_dir.empty(),
+      "the weights of an ONNX model can't both be deferred and written as "
+      "external data");
   if (operator_export_type != onnx_torch::OperatorExportTypes::RAW) {
     validateGraph(graph, operator_export_type);
   }
@@ -437,6 +464,7 @@ GraphEncoder::GraphEncoder(
   imp->set_version(onnx_opset_version);
 
   EncodeGraph(model_proto_.mutable_graph(), graph, initializers);
+  waitForWrites(0);
 
   for (const std::string& domain : domains_) {
     auto* opset = model_proto_.add_opset_import();
@@ -453,6 +481,10 @@ void GraphEncoder::EncodeTensor(
     tensor_proto->add_dims(d);
   }
   tensor_proto->set_data_type(ATenTypeToOnnxType(tensor.scalar_type()));
+  if (!external_data_dir_.empty() && external_ref) {
+    EncodeExternalTensor(tensor_proto, tensor, *external_ref);
+    return;
+  }
   // CPU's HalfTensor doesn't have contiguous(), so first calling contiguous()
   auto t = tensor.contiguous().cpu();
   // Add a buffer to the raw_data_export_map for the caller to dump into an
@@ -472,6 +504,62 @@ void GraphEncoder::EncodeTensor(
   }
 }
 
+void GraphEncoder::EncodeExternalTensor(
+    onnx::TensorProto* tensor_proto,
+    const at::Tensor& tensor,
+    const std::string& name) {
+  // the file is named after the initializer, with the characters that can't
+  // be in a file name replaced
+  std::string file_name = name;
+  for (char& c : file_name) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' &&
+        c != '-') {
+      c = '_';
+    }
+  }
+  if (file_name.empty() || file_name[0] == '.') {
+    file_name = "_" + file_name;
+  }
+  std::string unique_name = file_name;
+  for (size_t i = 1; !external_files_.insert(unique_name).second; ++i) {
+    unique_name = file_name + "_" + std::to_string(i);
+  }
+  tensor_proto->set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+  auto* location = tensor_proto->add_external_data();
+  location->set_key("location");
+  location->set_value(unique_name);
+
+  // copying the tensors to contiguous CPU memory and writing them out happens
+  // in parallel with encoding the rest of the model. Bounding the writes in
+  // flight also bounds the memory their copies take.
+  waitForWrites(std::max<size_t>(at::get_num_interop_threads(), 1) - 1);
+  const std::string path = external_data_dir_ + "/" + unique_name;
+  auto promise = std::make_shared<std::promise<void>>();
+  at::launch([promise, tensor, path]() {
+    try {
+      auto t = tensor.contiguous().cpu();
+      std::ofstream file(path, std::ios::binary);
+      file.write(
+          static_cast<const char*>(t.data_ptr()),
+          t.element_size() * t.numel());
+      file.close();
+      AT_CHECK(file, "failed to write the ONNX external data file ", path);
+      promise->set_value();
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+    }
+  });
+  pending_writes_.push_back(promise->get_future());
+}
+
+void GraphEncoder::waitForWrites(size_t max_pending) {
+  while (pending_writes_.size() > max_pending) {
+    std::future<void> write = std::move(pending_writes_.front());
+    pending_writes_.pop_front();
+    write.get();
+  }
+}
+
 // this is a serializer class which saves script modules to pt files. the
 // content of the file is written using PyTorchStreamWriter, for details please
 // check caffe2/serialize/inline_container.h. all the records except the last
@@ -486,35 +574,55 @@ class ScriptModuleSerializer final {
 
   void serialize(
       const script::Module& module,
-      const script::ExtraFilesMap& extra_files = script::ExtraFilesMap());
+      const script::ExtraFilesMap& extra_files = script::ExtraFilesMap(),
+      bool bytecode_format = false);
 
  private:
   void convertModel(
       const script::Module& module,
       torch::ModelDef* model_def,
-      const script::ExtraFilesMap& extra_files);
+      const script::ExtraFilesMap& extra_files,
+      bool bytecode_format);
 
   // add a tensor to the tensorTable
   // returns the offset into the tensor table
   size_t addTensor(const at::Tensor& tensor);
 
-  // write the content of the tensor to the file/stream, and save the
-  // offset in the storageMap_
-  void convertAndWriteTensor(
+  // fill the metadata of the tensor, and if its storage hasn't been seen
+  // yet, give it a record name in the storageMap and add it to the storages
+  // to write
+  void convertTensor(
       size_t tensor_id,
       const at::Tensor& tensor,
       torch::TensorDef* tensor_proto,
-      std::unordered_map<const void*, std::string>& storageMap);
+      std::unordered_map<const void*, std::string>& storageMap,
+      std::vector<std::pair<std::string, at::Tensor>>& storages);
+
+  // write the content of the storages to the file/stream, one at a time. the
+  // copy to CPU of the next CUDA storage overlaps the write of the current
+  // one, so at most two storages are staged in host memory at once
+  void writeStorages(
+      const std::vector<std::pair<std::string, at::Tensor>>& storages);
 
   // dump all the tensors in the tensorTable_ to a ModelDef (metadata) and
   // the file/stream (the content), assuming all the information of the
-  // tensors has been collected. the method calls convertAndWriteTensor
-  // to dump the content of a tensor
+  // tensors has been collected. the method calls convertTensor and
+  // writeStorages to dump the content of the tensors
   void writeTensorTable(torch::ModelDef* model_def);
 
   void writeAttributeTable();
   void writeLibs(torch::ModelDef* model_def);
 
+  // write the methods of the module as the bytecode of the mobile
+  // interpreter to bytecode.pkl. the tensors go to the tensorTable, so this
+  // must be called before writeTensorTable
+  void writeBytecode(const script::Module& module);
+
+  // write the metadata of the tensors in the tensorTable to
+  // bytecode_tensors.pkl, so that the mobile loader can rebuild them without
+  // parsing model.json. must be called after writeTensorTable
+  void writeBytecodeTensorTable(const torch::ModelDef& model_def);
+
   void convertModule(
       const script::Module& module,
       const std::string& prefix,
@@ -555,9 +663,10 @@ ScriptModuleSerializer::ScriptModuleSerializer(std::ostream* ofs)
 
 void ScriptModuleSerializer::serialize(
     const script::Module& module,
-    const script::ExtraFilesMap& extra_files) {
+    const script::ExtraFilesMap& extra_files,
+    bool bytecode_format) {
   torch::ModelDef model_def;
-  convertModel(module, &model_def, extra_files);
+  convertModel(module, &model_def, extra_files, bytecode_format);
   std::string output;
   // NB: cannot use MessageToJsonString, since fbcode's protobuf is too old
   // be consistent with MessageToJsonString
@@ -656,7 +765,8 @@ void ScriptModuleSerializer::convertClass(
 void ScriptModuleSerializer::convertModel(
     const script::Module& module,
     torch::ModelDef* model_def,
-    const script::ExtraFilesMap& extra_files) {
+    const script::ExtraFilesMap& extra_files,
+    bool bytecode_format) {
   model_def->set_producer_name("pytorch");
   model_def->set_producer_version("1.0"); // TODO: set the producer version
                                           // using appropriate function call
@@ -667,8 +777,14 @@ void ScriptModuleSerializer::convertModel(
 
   // This may write some attributes to the tensor_table_
   writeAttributeTable();
+  if (bytecode_format) {
+    writeBytecode(module);
+  }
 
   writeTensorTable(model_def);
+  if (bytecode_format) {
+    writeBytecodeTensorTable(*model_def);
+  }
   writeLibs(model_def);
 
   // Write out extra files.
@@ -683,11 +799,12 @@ size_t ScriptModuleSerializer::addTensor(const at::Tensor& tensor) {
   return tensor_table_.size() - 1;
 }
 
-void ScriptModuleSerializer::convertAndWriteTensor(
+void ScriptModuleSerializer::convertTensor(
     size_t tensor_id,
     const at::Tensor& tensor,
     torch::TensorDef* tensor_proto,
-    std::unordered_map<const void*, std::string>& storageMap) {
+    std::unordered_map<const void*, std::string>& storageMap,
+    std::vector<std::pair<std::string, at::Tensor>>& storages) {
   for (auto d : tensor.sizes()) {
     tensor_proto->add_dims(d);
   }
@@ -703,11 +820,8 @@ void ScriptModuleSerializer::convertAndWriteTensor(
   auto* key = tensor.storage().unsafeGetStorageImpl();
   auto storage_it = storageMap.find(key);
   if (storage_it == storageMap.end()) {
-    uint64_t record_size;
-    at::Tensor storage_tensor;
-    std::tie(storage_tensor, record_size) = getWriteableTensor(tensor);
     std::string name = "tensors/" + std::to_string(tensor_id);
-    writer_.writeRecord(name, storage_tensor.storage().data(), record_size);
+    storages.emplace_back(name, tensor);
     storage_it = storageMap.insert({key, name}).first;
   }
 
@@ -720,13 +834,53 @@ void ScriptModuleSerializer::convertAndWriteTensor(
   tensor_proto->set_device(ss.str());
 }
 
+void ScriptModuleSerializer::writeStorages(
+    const std::vector<std::pair<std::string, at::Tensor>>& storages) {
+  using WriteableTensor = std::pair<at::Tensor, uint64_t>;
+  auto stage = [](const at::Tensor& tensor) {
+    auto promise = std::make_shared<std::promise<WriteableTensor>>();
+    auto copy = [promise, tensor]() {
+      try {
+        promise->set_value(getWriteableTensor(tensor));
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+      }
+    };
+    if (tensor.storage().device_type() == at::DeviceType::CUDA) {
+      at::launch(copy);
+    } else {
+      copy();
+    }
+    return promise->get_future();
+  };
+
+  if (storages.empty()) {
+    return;
+  }
+  auto current = stage(storages[0].second);
+  for (size_t i = 0; i < storages.size(); ++i) {
+    std::future<WriteableTensor> next;
+    if (i + 1 < storages.size()) {
+      next = stage(storages[i + 1].second);
+    }
+    uint64_t record_size;
+    at::Tensor storage_tensor;
+    std::tie(storage_tensor, record_size) = current.get();
+    writer_.writeRecord(
+        storages[i].first, storage_tensor.storage().data(), record_size);
+    current = std::move(next);
+  }
+}
+
 void ScriptModuleSerializer::writeTensorTable(torch::ModelDef* model_def) {
   std::unordered_map<const void*, std::string> storageMap;
+  std::vector<std::pair<std::string, at::Tensor>> storages;
   size_t tensor_id = 0;
   for (const at::Tensor& t : tensor_table_) {
     auto* tensor_proto = model_def->add_tensors();
-    convertAndWriteTensor(tensor_id++, t, tensor_proto, storageMap);
+    convertTensor(tensor_id++, t, tensor_proto, storageMap, storages);
   }
+  writeStorages(storages);
 }
 
 void ScriptModuleSerializer::writeAttributeTable() {
@@ -742,6 +896,53 @@ void ScriptModuleSerializer::writeAttributeTable() {
       "attributes.pkl", pickler.stack().data(), pickler.stack().size());
 }
 
+void ScriptModuleSerializer::writeBytecode(const script::Module& module) {
+  Pickler pickler(&tensor_table_);
+  pickler.start();
+  pickler.startTuple();
+  for (const auto& method : module.get_methods()) {
+    // the graph as the graph executor runs it without optimizations
+    auto graph = method->graph()->copy();
+    runRequiredPasses(graph);
+    mobile::Bytecode code = Code(graph).bytecode();
+
+    std::vector<IValue> slots;
+    for (const script::Slot& slot : method->initial_ivalues()) {
+      slots.push_back(slot.value());
+    }
+    pickler.addIValue(Tuple::create(
+        {method->name(),
+         static_cast<int64_t>(method->num_inputs()),
+         code.toIValue(),
+         std::move(slots)}));
+  }
+  pickler.endTuple();
+  pickler.finish();
+  writer_.writeRecord(
+      "bytecode.pkl", pickler.stack().data(), pickler.stack().size());
+}
+
+void ScriptModuleSerializer::writeBytecodeTensorTable(
+    const torch::ModelDef& model_def) {
+  AT_ASSERT(model_def.tensors_size() == (int)tensor_table_.size());
+  Pickler pickler;
+  pickler.start();
+  pickler.startTuple();
+  for (size_t i = 0; i < tensor_table_.size(); ++i) {
+    const at::Tensor& tensor = tensor_table_[i];
+    pickler.addIValue(Tuple::create(
+        {model_def.tensors(i).data().key(),
+         static_cast<int64_t>(tensor.scalar_type()),
+         tensor.sizes().vec(),
+         tensor.strides().vec(),
+         tensor.storage_offset()}));
+  }
+  pickler.endTuple();
+  pickler.finish();
+  writer_.writeRecord(
+      "bytecode_tensors.pkl", pickler.stack().data(), pickler.stack().size());
+}
+
 void ScriptModuleSerializer::convertModule(
     const script::Module& module,
     const std::string& prefix,
@@ -1012,14 +1213,16 @@ std::tuple<std::string, RawDataExportMap> export_onnx(
     int64_t onnx_opset_version,
     bool defer_weight_export,
     ::torch::onnx::OperatorExportTypes operator_export_type,
-    bool strip_doc_string) {
+    bool strip_doc_string,
+    const std::string& external_data_dir) {
   auto graph_encoder = GraphEncoder(
       graph,
       onnx_opset_version,
       operator_export_type,
       initializers,
       defer_weight_export,
-      strip_doc_string);
+      strip_doc_string,
+      external_data_dir);
   return std::make_tuple(
       graph_encoder.get_model_proto().SerializeAsString(),
       graph_encoder.get_raw_data_export_map());
@@ -1028,17 +1231,19 @@ std::tuple<std::string, RawDataExportMap> export_onnx(
 void ExportModule(
     const script::Module& module,
     std::ostream& out,
-    const script::ExtraFilesMap& extra_files) {
+    const script::ExtraFilesMap& extra_files,
+    bool bytecode_format) {
   ScriptModuleSerializer serializer(&out);
-  serializer.serialize(module, extra_files);
+  serializer.serialize(module, extra_files, bytecode_format);
 }
 
 void ExportModule(
     const script::Module& module,
     const std::string& filename,
-    const script::ExtraFilesMap& extra_files) {
+    const script::ExtraFilesMap& extra_files,
+    bool bytecode_format) {
   ScriptModuleSerializer serializer(filename);
-  serializer.serialize(module, extra_files);
+  serializer.serialize(module, extra_files, bytecode_format);
 }
 
 } // namespace jit
@@ -19,6 +19,11 @@ namespace jit {
 // file contents being the raw tensor data.
 using RawDataExportMap = std::unordered_map<std::string, at::Tensor>;
 
+// When `external_data_dir` is given, the initializers are instead written to
+// files of their own in that directory, in parallel with the encoding of the
+// rest of the model, and the model refers to them as ONNX external data. The
+// model then holds no tensor data, which keeps it far from the 2GB limit of
+// protobuf messages.
 TORCH_API std::tuple<std::string, RawDataExportMap> export_onnx(
     const std::shared_ptr<Graph>& graph,
     const std::map<std::string, at::Tensor>& initializers,
@@ -26,7 +31,8 @@ TORCH_API std::tuple<std::string, RawDataExportMap> export_onnx(
     bool defer_weight_export = false,
     ::torch::onnx::OperatorExportTypes operator_export_type =
         ::torch::onnx::OperatorExportTypes::ONNX,
-    bool strip_doc_string = true);
+    bool strip_doc_string = true,
+    const std::string& external_data_dir = std::string());
 
 // For testing purposes
 TORCH_API std::string pretty_print_onnx(
@@ -38,15 +44,20 @@ TORCH_API std::string pretty_print_onnx(
         ::torch::onnx::OperatorExportTypes::ONNX,
     bool google_printer = false);
 
+// With bytecode_format, the archive also holds the methods of the module as
+// the bytecode of the mobile interpreter (see mobile/import.h), in addition
+// to what torch::jit::load reads.
 TORCH_API void ExportModule(
     const script::Module& module,
     std::ostream& out,
-    const script::ExtraFilesMap& metadata = script::ExtraFilesMap());
+    const script::ExtraFilesMap& metadata = script::ExtraFilesMap(),
+    bool bytecode_format = false);
 
 TORCH_API void ExportModule(
     const script::Module& module,
     const std::string& filename,
-    const script::ExtraFilesMap& metadata = script::ExtraFilesMap());
+    const script::ExtraFilesMap& metadata = script::ExtraFilesMap(),
+    bool bytecode_format = false);
 
 } // namespace jit
 } // namespace torch
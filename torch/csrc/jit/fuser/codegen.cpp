@@ -11,6 +11,7 @@
 #include <torch/csrc/jit/fuser/cpu/resource_strings.h>
 #include <torch/csrc/jit/fuser/cuda/resource_strings.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
@@ -293,11 +294,17 @@ static void emitIndexingFor(
     std::ostream& out,
     const std::string& tensor,
     const int ndim,
-    const bool last_is_cont) {
+    const bool last_is_cont,
+    const std::string& index) {
   TemplateEnv env;
   env.s("tensor", tensor);
+  env.s("index", index);
+  if (ndim == 1 && last_is_cont) {
+    out << format("const IndexType ${tensor}_offset = ${index};\n", env);
+    return;
+  }
   out << format("IndexType ${tensor}_offset = 0;\n", env);
-  out << format("IndexType ${tensor}_linearIndex = linearIndex;\n", env);
+  out << format("IndexType ${tensor}_linearIndex = ${index};\n", env);
   for (int d = ndim - 1; d >= 0; --d) {
     env.d("d", d);
     env.s("mod_sizes", d > 0 ? format("% ${tensor}.sizes[${d}]", env) : "");
@@ -319,6 +326,7 @@ std::string generateKernel(
     const Graph& graph,
     const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>& inputs,
     const std::vector<std::pair<const Value*, const TensorDesc>>& outputs,
+    const ReductionDesc& reduction,
     const bool use_cuda) {
   TemplateEnv env;
   env.s("kernelName", name);
@@ -326,23 +334,45 @@ std::string generateKernel(
       "IndexType",
       "unsigned int"); // Note: not uint32_t to avoid including cstdint
 
+  // Reduction kernels take the number of elements reduced into each output
+  // element as their second argument. Their inputs are indexed by the
+  // position in the map (mapIndex) and their output by the position of the
+  // output element (linearIndex).
+  const bool is_reduction = !reduction.isNoop();
+  const size_t first_formal = is_reduction ? 2 : 1;
+  const std::string input_index = is_reduction ? "mapIndex" : "linearIndex";
+  const Node* reduce_node = nullptr;
+  if (is_reduction) {
+    AT_ASSERT(outputs.size() == 1);
+    reduce_node = outputs[0].first->node();
+    AT_ASSERT(reduce_node->kind() == aten::sum);
+  }
+
   std::stringstream body;
   std::stringstream tensorOffsets;
+  std::stringstream outputOffsets;
+  std::stringstream outputWrites;
   std::vector<std::string> formals;
   std::vector<std::string> argument_loads;
+  if (is_reduction) {
+    argument_loads.push_back("*static_cast<IndexType*>(args[1])");
+  }
 
   // Lambda for writing arguments
-  auto emitFormal = [&](const Value* n, const TensorDesc& desc) {
+  auto emitFormal = [&](const Value* n,
+                        const TensorDesc& desc,
+                        std::ostream& offsets,
+                        const std::string& index) {
     env.d(
         "formal_index",
         formals.size() +
-            1); // + 1 because the first argument is the linearIndex
+            first_formal); // skips numel (and reduce_numel) arguments
       std::string tensor =
           "t" +
           std::to_string(
               formals.size()); // can't be unique() because Param may be an output
       const auto nDim = desc.nDim();
-      emitIndexingFor(tensorOffsets, tensor, nDim, desc.lastIsContiguous());
+      emitIndexingFor(offsets, tensor, nDim, desc.lastIsContiguous(), index);
       env.s("tensor", tensor);
       env.d("nDim", nDim);
       env.s("scalar_type", scalarTypeName(desc.scalar_type));
@@ -357,7 +387,7 @@ std::string generateKernel(
     env.d(
         "formal_index",
         formals.size() +
-            1); // + 1 because the first argument is the linearIndex
+            first_formal); // skips numel (and reduce_numel) arguments
     std::string scalar =
         "s" +
         std::to_string(
@@ -365,7 +395,7 @@ std::string generateKernel(
     env.d(
         "formal_index",
         formals.size() +
-            1); // + 1 because the first argument is the linearIndex
+            first_formal); // skips numel (and reduce_numel) arguments
     env.s("scalar", scalar);
     env.s("scalar_type", variableType(n->type()));
     formals.push_back(format("${scalar_type} ${scalar}", env));
@@ -377,7 +407,7 @@ std::string generateKernel(
   // Writes input parameters
   for (const auto& input : inputs) {
     if (input.second.has_value()){
-      emitFormal(input.first, *input.second);
+      emitFormal(input.first, *input.second, tensorOffsets, input_index);
     } else {
       emitScalarFormal(input.first);
     }
@@ -385,7 +415,11 @@ std::string generateKernel(
 
   // Writes output parameters
   for (const auto& output : outputs) {
-    emitFormal(output.first, output.second);
+    emitFormal(
+        output.first,
+        output.second,
+        is_reduction ? outputOffsets : tensorOffsets,
+        "linearIndex");
   }
 
   // Acquires input values
@@ -436,8 +470,18 @@ std::string generateKernel(
       continue;
     if (n->mustBeNone())
       continue;
+    // Note: the sum ending a reduction kernel is implemented by the template,
+    // which accumulates its input, and its arguments are constants
+    if (n == reduce_node)
+      continue;
+    if (is_reduction && n->kind() == prim::Constant &&
+        std::all_of(
+            n->output()->uses().begin(),
+            n->output()->uses().end(),
+            [&](const Use& u) { return u.user == reduce_node; }))
+      continue;
     if (n->kind() == aten::rand_like) {
-      AT_ASSERT(use_cuda);
+      AT_ASSERT(use_cuda && !is_reduction);
       has_random = true;
     }
     // Always emit double for prim::Constant. This will be narrowed later based
@@ -468,23 +512,35 @@ std::string generateKernel(
   }
 
   // Generates writes to output tensors
+  // Note: reduction kernels write the accumulated sum once per output element
   for (const auto& output : outputs) {
     env.d("formal", formal_count++);
     env.s("access", format("t${formal}.data[t${formal}_offset]", env));
-    env.s("node", valueName(output.first));
+    env.s("node", is_reduction ? "acc" : valueName(output.first));
+    std::ostream& writes = is_reduction ? outputWrites : body;
 
     // Acquires and converts (if needed) outputs
     // Note: conversion to half is only supported for CUDA kernels.
     const auto is_half = (output.second.scalar_type == at::ScalarType::Half);
     if (is_half) {
       AT_ASSERT(use_cuda);
-      body << format("${access} = __float2half(${node});\n", env);
+      writes << format("${access} = __float2half(${node});\n", env);
       has_half_tensor = true;
     } else {
-      body << format("${access} = ${node};\n", env);
+      writes << format("${access} = ${node};\n", env);
     }
   }
 
+  if (is_reduction) {
+    env.s("accType", calcScalarTypeName(outputs[0].second.scalar_type));
+    env.s("reduceValue", valueName(reduce_node->inputs()[0]));
+    env.s(
+        "mapIndex",
+        reduction.isInnermost()
+            ? "linearIndex * reduceElements + reduceIndex"
+            : "reduceIndex * totalElements + linearIndex");
+  }
+
   // Includes headers
   // Note: CUDA kernels support halfs and random generation, CPU kernels do not
   if (has_half_tensor) {
@@ -506,14 +562,50 @@ std::string generateKernel(
   // Insantiates the CUDA or CPU-specific templates
   env.s("tensorOffsets", tensorOffsets.str());
   env.s("kernelBody", body.str());
+  env.s("outputOffsets", outputOffsets.str());
+  env.s("outputWrites", outputWrites.str());
   env.v("formals", formals);
   env.v("argument_loads", argument_loads);
   std::string code_string;
   if (use_cuda) {
     env.s("type_declarations", cuda::type_declarations_template.format(env));
-    code_string = cuda::cuda_compilation_unit_template.format(env);
+    if (!is_reduction) {
+      code_string = cuda::cuda_compilation_unit_template.format(env);
+    } else if (reduction.isInnermost()) {
+      code_string =
+          cuda::cuda_inner_reduction_compilation_unit_template.format(env);
+    } else {
+      code_string =
+          cuda::cuda_outer_reduction_compilation_unit_template.format(env);
+    }
   } else {
+    // Note: contiguity is part of the kernel's specialization, so the
+    // vectorized loops are only generated for arguments that allow them
+    const bool inputs_contiguous = std::all_of(
+        inputs.begin(),
+        inputs.end(),
+        [](const std::pair<const Value*, const c10::optional<TensorDesc>>& input) {
+          return !input.second.has_value() || input.second->isContiguous();
+        });
+    const bool outputs_contiguous = std::all_of(
+        outputs.begin(),
+        outputs.end(),
+        [](const std::pair<const Value*, const TensorDesc>& output) {
+          return output.second.isContiguous();
+        });
+    env.s(
+        "simd",
+        !is_reduction && inputs_contiguous && outputs_contiguous ? " simd" : "");
+    env.s(
+        "reduceSimd",
+        is_reduction && reduction.isInnermost() && inputs_contiguous
+            ? "#pragma omp simd reduction(+:acc)"
+            : "");
     env.s("type_declarations", cpu::type_declarations_template.format(env));
+    env.s(
+        "kernelFunction",
+        is_reduction ? cpu::cpu_reduction_kernel_template.format(env)
+                     : cpu::cpu_map_kernel_template.format(env));
     code_string = cpu::cpu_compilation_unit_template.format(env);
   }
 
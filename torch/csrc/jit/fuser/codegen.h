@@ -3,6 +3,7 @@
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <torch/csrc/jit/fuser/arg_spec.h>
 #include <torch/csrc/jit/fuser/partition_desc.h>
+#include <torch/csrc/jit/fuser/reduction_desc.h>
 #include <torch/csrc/jit/fuser/tensor_desc.h>
 #include <torch/csrc/jit/ir.h>
 
@@ -16,12 +17,15 @@ namespace jit {
 namespace fuser {
 
 // Creates a CPU or CUDA kernel for the given graph.
+// If reduction is not a noop, the kernel sums the value of the (single) output
+// over the reduced dimension instead of writing it to every map element.
 // Returns the C++ or CUDA string implementing the kernel.
 TORCH_API std::string generateKernel(
     const std::string& name,
     const Graph& graph,
     const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>& inputs,
     const std::vector<std::pair<const Value*, const TensorDesc>>& outputs,
+    const ReductionDesc& reduction,
     const bool use_cuda);
 
 } // namespace fuser
@@ -15,6 +15,7 @@
 #include <torch/csrc/jit/passes/shape_analysis.h>
 
 #include <atomic>
+#include <cctype>
 #include <iostream>
 #include <memory>
 #include <sstream>
@@ -62,6 +63,35 @@ size_t nCompiledKernels() {
   return next_kernel_id.load();
 }
 
+const std::string cached_kernel_name = "fused_kernel";
+
+// Note: kernel names are "kernel_<id>", so an occurrence of name followed by
+// a digit is the name of another kernel.
+std::string withCachedKernelName(
+    const std::string& code,
+    const std::string& name) {
+  std::string result;
+  size_t pos = 0;
+  for (size_t found = code.find(name); found != std::string::npos;
+       found = code.find(name, pos)) {
+    result.append(code, pos, found - pos);
+    pos = found + name.size();
+    const bool is_prefix = pos < code.size() && std::isdigit(code[pos]);
+    result.append(is_prefix ? name : cached_kernel_name);
+  }
+  result.append(code, pos, std::string::npos);
+  return result;
+}
+
+uint64_t hashKernelCode(const std::string& code) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const unsigned char c : code) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
 int debugFuser() {
   if (debug_fusion < 0) {
     const char* debug_env = getenv("PYTORCH_FUSION_DEBUG");
@@ -157,6 +187,24 @@ static void setInputBroadcastGroups(KernelSpec& spec) {
       std::back_inserter(spec.inputBroadcastGroups()));
 }
 
+// Records the sum that ends the fusion group, if any. The graph fuser only
+// fuses a sum over a single (constant) dimension as the only output of
+// a fusion group.
+static void setReductionDescriptor(KernelSpec& spec) {
+  const auto& outputs = spec.graph()->outputs();
+  for (const Value* output : outputs) {
+    const Node* node = output->node();
+    if (node->kind() != aten::sum) {
+      continue;
+    }
+    AT_ASSERT(outputs.size() == 1);
+    const auto dims = node->get<std::vector<int64_t>>(attr::dim).value();
+    AT_ASSERT(dims.size() == 1);
+    spec.reduction() =
+        ReductionDesc(dims[0], node->get<bool>(attr::keepdim).value());
+  }
+}
+
 // This function moves _grad_sum_to_size nodes along the computation graph
 // of the fusion group to the outputs and then records the shape inputs
 // in order for summation to be applied after the kernel.
@@ -234,6 +282,7 @@ void processGradSumToSize(KernelSpec& spec) {
 static void upfrontCompilation(KernelSpec& spec) {
   setInputBroadcastGroups(spec);
   setInputChunkDescriptors(spec);
+  setReductionDescriptor(spec);
   processGradSumToSize(spec);
 }
 
@@ -310,7 +359,7 @@ std::shared_ptr<FusedKernel> compileKernel(
   std::vector<std::pair<const Value*, const TensorDesc>> flat_outputs;
   for (const Value* o : graph->outputs()) {
     // Creates output description
-    std::vector<int64_t> sizes = map_size;
+    std::vector<int64_t> sizes = spec.reduction().outputSizes(map_size);
     if (o->node()->kind() == prim::FusedConcat) {
       sizes.at(o->node()->i(attr::dim)) *= o->node()->inputs().size();
     }
@@ -338,8 +387,8 @@ std::shared_ptr<FusedKernel> compileKernel(
 
   const bool use_cuda = device.is_cuda();
   const std::string name = "kernel_" + std::to_string(next_kernel_id++);
-  std::string code =
-      generateKernel(name, *graph, flat_inputs, flat_outputs, use_cuda);
+  std::string code = generateKernel(
+      name, *graph, flat_inputs, flat_outputs, spec.reduction(), use_cuda);
   const FusedKernelConstructor& kernel_ctor =
       getConstructor(use_cuda ? at::DeviceType::CUDA : at::DeviceType::CPU);
   return kernel_ctor(
@@ -350,6 +399,7 @@ std::shared_ptr<FusedKernel> compileKernel(
       output_desc,
       chunk_desc,
       concat_desc,
+      spec.reduction(),
       spec.hasRandom());
 }
 
@@ -9,6 +9,7 @@
 #include <ATen/core/stack.h>
 
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace torch {
@@ -31,6 +32,21 @@ TORCH_API std::shared_ptr<FusedKernel> compileKernel(
 
 TORCH_API size_t nCompiledKernels();
 
+// Kernel names are assigned in creation order, so they differ between
+// processes, and devices, compiling the same fusion. Kernels that are cached
+// are generated with this name instead.
+TORCH_API extern const std::string cached_kernel_name;
+
+// Returns code, the code generated for the kernel called name, with the
+// kernel named cached_kernel_name instead.
+TORCH_API std::string withCachedKernelName(
+    const std::string& code,
+    const std::string& name);
+
+// Hashes the code of a cached kernel (64-bit FNV-1a, which unlike std::hash
+// is the same in every build)
+TORCH_API uint64_t hashKernelCode(const std::string& code);
+
 TORCH_API int debugFuser();
 
 using FusedKernelConstructor = std::function<std::shared_ptr<FusedKernel>(
@@ -41,6 +57,7 @@ using FusedKernelConstructor = std::function<std::shared_ptr<FusedKernel>(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
+    ReductionDesc reduction_desc,
     bool has_random)>;
 
 TORCH_API void registerFusionBackend(
@@ -4,9 +4,15 @@
 #include <torch/csrc/jit/fuser/compiler.h>
 #include <torch/csrc/jit/fuser/cpu/dynamic_library.h>
 #include <torch/csrc/jit/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/utils/memory.h>
 
+#include <unistd.h>
+
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -100,6 +106,77 @@ static void disas(const std::string& so_file) {
   AT_ASSERT(r == 0);
 }
 
+// Compiles `code` into a temporary library in /tmp and loads it.
+static std::unique_ptr<DynamicLibrary> compileKernel(const std::string& code) {
+  TempFile so_file(so_template, 3);
+  TempFile cpp_file(cpp_template, 4);
+  cpp_file.write(code);
+  cpp_file.sync();
+  runCompiler(cpp_file.name(), so_file.name());
+  if (debugFuser() >= 2)
+    disas(so_file.name());
+  // the mapping of the library outlives the unlinked file
+  return make_unique<DynamicLibrary>(so_file.name().c_str());
+}
+
+static bool readFile(const std::string& path, std::string& contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  contents = ss.str();
+  return true;
+}
+
+// Loads the kernel of `code` from the cache in `dir`, compiling and adding it
+// first if not present. The cache is content addressed: the generated code is
+// a function of the normalized fusion graph and the argument specialization,
+// and the files are named after a hash of it and of the compiler
+// configuration. The source is stored next to the library and compared on
+// load, so that a hash collision costs a compilation rather than running
+// the wrong kernel.
+static std::unique_ptr<DynamicLibrary> loadCachedKernel(
+    const std::string& dir,
+    const std::string& code) {
+  const auto& config = getConfig();
+  std::ostringstream path;
+  path << dir << "/fused_kernel_" << std::hex << std::setw(16)
+       << std::setfill('0')
+       << hashKernelCode(
+              config.cxx + (config.openmp ? " -fopenmp\n" : "\n") + code);
+  const std::string so_path = path.str() + ".so";
+  const std::string cpp_path = path.str() + ".cpp";
+
+  std::string cached_code;
+  if (readFile(cpp_path, cached_code) && cached_code == code &&
+      access(so_path.c_str(), R_OK) == 0) {
+    return make_unique<DynamicLibrary>(so_path.c_str());
+  }
+  if (access(dir.c_str(), W_OK) != 0) {
+    // a read-only cache still serves the kernels it has
+    return compileKernel(code);
+  }
+
+  // Compiles next to the cache entries and renames the files into place,
+  // library first, so that processes sharing the directory never load a
+  // partially written entry.
+  TempFile so_file(dir + "/tmp_fuserXXXXXX.so", 3);
+  TempFile cpp_file(dir + "/tmp_fuserXXXXXX.cpp", 4);
+  cpp_file.write(code);
+  cpp_file.sync();
+  runCompiler(cpp_file.name(), so_file.name());
+  if (debugFuser() >= 2)
+    disas(so_file.name());
+  std::string so_name = so_file.name();
+  if (std::rename(so_file.name().c_str(), so_path.c_str()) == 0) {
+    so_name = so_path;
+    std::rename(cpp_file.name().c_str(), cpp_path.c_str());
+  }
+  return make_unique<DynamicLibrary>(so_name.c_str());
+}
+
 FusedKernelCPU::FusedKernelCPU(
     std::string name,
     std::string code,
@@ -107,6 +184,7 @@ FusedKernelCPU::FusedKernelCPU(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
+    ReductionDesc reduction_desc,
     bool has_random)
     : FusedKernel(
           std::move(name),
@@ -115,18 +193,19 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(output_desc),
           std::move(chunk_desc),
           std::move(concat_desc),
+          std::move(reduction_desc),
           has_random) {
-  TempFile so_file(so_template, 3);
-  TempFile cpp_file(cpp_template, 4);
-  cpp_file.write(code_);
-  cpp_file.sync();
-  runCompiler(cpp_file.name(), so_file.name());
-  if (debugFuser() >= 2)
-    disas(so_file.name());
-  so_lib = make_unique<DynamicLibrary>(so_file.name().c_str());
+  const std::string cache_dir = getFusionKernelCacheDir();
+  std::string symbol = name_;
+  if (cache_dir.empty()) {
+    so_lib = compileKernel(code_);
+  } else {
+    so_lib = loadCachedKernel(cache_dir, withCachedKernelName(code_, name_));
+    symbol = cached_kernel_name;
+  }
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
-      reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
+      reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(symbol.c_str()));
 #pragma GCC diagnostic pop
 }
 
@@ -138,6 +217,7 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
+    ReductionDesc reduction_desc,
     bool has_random) {
   return std::make_shared<FusedKernelCPU>(
       std::move(name),
@@ -146,6 +226,7 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
       std::move(output_desc),
       std::move(chunk_desc),
       std::move(concat_desc),
+      std::move(reduction_desc),
       has_random);
 }
 
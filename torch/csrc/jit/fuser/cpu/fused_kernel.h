@@ -24,6 +24,7 @@ struct TORCH_API FusedKernelCPU : public ::torch::jit::fuser::FusedKernel {
       std::vector<TensorDesc> output_desc,
       std::vector<PartitionDesc> chunk_desc,
       std::vector<PartitionDesc> concat_desc,
+      ReductionDesc reduction_desc,
       bool has_random);
 
   at::Backend backend() const override {
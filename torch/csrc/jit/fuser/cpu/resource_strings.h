@@ -54,8 +54,20 @@ float fracf(float x) {
 ${type_declarations}
 
 #define OMP_THRESHOLD 100000
+${kernelFunction}
+
+extern "C"
+void ${kernelName}(IndexType totalElements, void ** args) {
+  ${kernelName}_kernel(totalElements ${,argument_loads});
+}
+)");
+
+// When all tensors are contiguous, every offset is `linearIndex` and the
+// loop is marked `simd`, so that each thread's chunk of it is vectorized
+// without runtime aliasing checks.
+static auto cpu_map_kernel_template = CodeTemplate(R"(
 static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
-  #pragma omp parallel for if(totalElements > OMP_THRESHOLD)
+  #pragma omp parallel for${simd} if(totalElements > OMP_THRESHOLD)
   for (IndexType linearIndex = 0;
         linearIndex < totalElements;
         linearIndex += 1) {
@@ -65,10 +77,34 @@ static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
       ${kernelBody}
     }
 }
+)");
 
-extern "C"
-void ${kernelName}(IndexType totalElements, void ** args) {
-  ${kernelName}_kernel(totalElements ${,argument_loads});
+// Each output element is accumulated by a single thread, iterating over the
+// map elements it reduces; `mapIndex` is the linear index of such an element.
+// For an innermost reduction over contiguous inputs those elements are
+// adjacent, and the inner loop is marked `simd` as well.
+static auto cpu_reduction_kernel_template = CodeTemplate(R"(
+static void ${kernelName}_kernel(IndexType totalElements, IndexType reduceElements, ${formals}) {
+  #pragma omp parallel for if(totalElements * reduceElements > OMP_THRESHOLD)
+  for (IndexType linearIndex = 0;
+        linearIndex < totalElements;
+        linearIndex += 1) {
+      ${accType} acc = 0;
+      ${reduceSimd}
+      for (IndexType reduceIndex = 0;
+            reduceIndex < reduceElements;
+            reduceIndex += 1) {
+        const IndexType mapIndex = ${mapIndex};
+        // Convert `mapIndex` into an offset of tensor:
+        ${tensorOffsets}
+        // calculate the value to reduce
+        ${kernelBody}
+        acc += ${reduceValue};
+      }
+      // Convert `linearIndex` into an offset of the output:
+      ${outputOffsets}
+      ${outputWrites}
+    }
 }
 )");
 
@@ -5,7 +5,9 @@
 #include <THC/THC.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <torch/csrc/jit/fuser/cpu/dynamic_library.h>
+#include <torch/csrc/jit/fuser/cpu/temp_file.h>
 #include <torch/csrc/jit/fuser/cuda/thnvrtc.h>
+#include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/jit/resource_guard.h>
 
 // Note: unclear why this forward declaration is necessary
@@ -14,12 +16,19 @@
 THCGenerator* THCRandom_getGenerator(THCState* state);
 
 #include <cuda_runtime.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace torch {
@@ -132,6 +141,147 @@ static void getMajorMinor(
   }
 }
 
+// Compiles code into PTX for the given compute architecture
+static std::vector<char> compileToPTX(
+    const std::string& code,
+    const int major,
+    const int minor) {
+  // Creates the NVRTC program
+  nvrtcProgram program;
+  TORCH_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
+      &program, code.c_str(), nullptr, 0, nullptr, nullptr));
+
+  const std::string compute = "--gpu-architecture=compute_" +
+      std::to_string(major) + std::to_string(minor);
+  const std::vector<const char*> args = {
+      "--std=c++11", compute.c_str(), "-default-device"};
+  const auto result =
+      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
+  if (result == NVRTC_ERROR_COMPILATION) {
+    size_t logsize;
+    nvrtc().nvrtcGetProgramLogSize(program, &logsize);
+    std::vector<char> log(logsize);
+    nvrtc().nvrtcGetProgramLog(program, log.data());
+    std::stringstream cu;
+    cu << log.data();
+    throw std::runtime_error(cu.str());
+  }
+  ResourceGuard holdProgram(
+      [&] { TORCH_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
+  TORCH_NVRTC_CHECK(result);
+  size_t ptx_size;
+  TORCH_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
+  std::vector<char> ptx(ptx_size);
+  TORCH_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx.data()));
+  return ptx;
+}
+
+static bool readFile(const std::string& path, std::string& contents) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  std::stringstream ss;
+  ss << file.rdbuf();
+  contents = ss.str();
+  return true;
+}
+
+// Writes contents to path through a temporary file in dir, so that processes
+// sharing the directory never read a partially written file.
+static bool writeFileAtomically(
+    const std::string& dir,
+    const std::string& path,
+    const std::string& contents) {
+  cpu::TempFile file(dir + "/tmp_fuserXXXXXX.tmp", 4);
+  file.write(contents);
+  file.sync();
+  return std::rename(file.name().c_str(), path.c_str()) == 0;
+}
+
+// PTX is cached per compute architecture for the lifetime of the process
+// and, if a fuser kernel cache directory is set (see
+// setFusionKernelCacheDir), on disk. The devices of a process then compile
+// each kernel once and only load the PTX into their own context, and
+// restarted processes don't compile at all.
+// Note: NVRTC only produces PTX. The driver compiles it for the device when
+// the module is loaded and keeps its own cache of the results.
+// Note: entries are keyed by the code with the kernel named
+// cached_kernel_name, the target architecture and the NVRTC version. On disk
+// the key is stored next to the PTX and compared on load, so that a hash
+// collision costs a compilation rather than running the wrong kernel.
+static std::mutex ptx_cache_mutex;
+static std::unordered_map<std::string, std::vector<char>>& getPTXCache() {
+  static std::unordered_map<std::string, std::vector<char>> ptx_cache;
+  return ptx_cache;
+}
+
+static bool loadCachedPTX(
+    const std::string& path,
+    const std::string& key,
+    std::vector<char>& ptx) {
+  std::string cached_key, cached_ptx;
+  if (!readFile(path + ".cu", cached_key) || cached_key != key ||
+      !readFile(path + ".ptx", cached_ptx) || cached_ptx.empty()) {
+    return false;
+  }
+  ptx.assign(cached_ptx.begin(), cached_ptx.end());
+  return true;
+}
+
+static void storeCachedPTX(
+    const std::string& dir,
+    const std::string& path,
+    const std::string& key,
+    const std::vector<char>& ptx) {
+  if (access(dir.c_str(), W_OK) != 0) {
+    // a read-only cache still serves the kernels it has
+    return;
+  }
+  // PTX first, so that the key never describes a stale PTX file
+  const std::string contents(ptx.begin(), ptx.end());
+  if (writeFileAtomically(dir, path + ".ptx", contents)) {
+    writeFileAtomically(dir, path + ".cu", key);
+  }
+}
+
+static std::vector<char> getPTX(
+    const std::string& code,
+    const int major,
+    const int minor) {
+  int nvrtc_major, nvrtc_minor;
+  TORCH_NVRTC_CHECK(nvrtc().nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+  std::ostringstream header;
+  header << "// nvrtc " << nvrtc_major << "." << nvrtc_minor << " compute_"
+         << major << minor << "\n";
+  const std::string key = header.str() + code;
+
+  {
+    std::lock_guard<std::mutex> guard{ptx_cache_mutex};
+    auto& cache = getPTXCache();
+    const auto it = cache.find(key);
+    if (it != cache.end()) {
+      return it->second;
+    }
+  }
+
+  std::vector<char> ptx;
+  const std::string dir = getFusionKernelCacheDir();
+  std::ostringstream path;
+  path << dir << "/fused_kernel_" << std::hex << std::setw(16)
+       << std::setfill('0') << hashKernelCode(key);
+  if (dir.empty() || !loadCachedPTX(path.str(), key, ptx)) {
+    ptx = compileToPTX(code, major, minor);
+    if (!dir.empty()) {
+      storeCachedPTX(dir, path.str(), key, ptx);
+    }
+  }
+
+  std::lock_guard<std::mutex> guard{ptx_cache_mutex};
+  getPTXCache().emplace(key, ptx);
+  return ptx;
+}
+
 // Compiles the specified kernel and stores the metadata required to run it
 FusedKernelCUDA::FusedKernelCUDA(
     int16_t device,
@@ -141,6 +291,7 @@ FusedKernelCUDA::FusedKernelCUDA(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
+    ReductionDesc reduction_desc,
     bool has_random)
     : FusedKernel(
           std::move(name),
@@ -149,6 +300,7 @@ FusedKernelCUDA::FusedKernelCUDA(
           std::move(output_desc),
           std::move(chunk_desc),
           std::move(concat_desc),
+          std::move(reduction_desc),
           has_random),
       device_(device) {
   // Initializes driver's API context (if necessary)
@@ -171,37 +323,14 @@ FusedKernelCUDA::FusedKernelCUDA(
   int major, minor;
   getMajorMinor(prop_, major, minor);
 
-  // Creates the NVRTC program
-  nvrtcProgram program;
-  TORCH_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
-      &program, code_.c_str(), nullptr, 0, nullptr, nullptr));
-
-  const std::string compute = "--gpu-architecture=compute_" +
-      std::to_string(major) + std::to_string(minor);
-  const std::vector<const char*> args = {
-      "--std=c++11", compute.c_str(), "-default-device"};
-  const auto result =
-      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
-  if (result == NVRTC_ERROR_COMPILATION) {
-    size_t logsize;
-    nvrtc().nvrtcGetProgramLogSize(program, &logsize);
-    std::vector<char> log(logsize);
-    nvrtc().nvrtcGetProgramLog(program, log.data());
-    std::stringstream cu;
-    cu << log.data();
-    throw std::runtime_error(cu.str());
-  }
-  ResourceGuard holdProgram(
-      [&] { TORCH_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
-  TORCH_NVRTC_CHECK(result);
-  size_t ptx_size;
-  TORCH_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
-  ptx_.resize(ptx_size);
-  TORCH_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx_.data()));
+  // Acquires the PTX of the kernel, which is shared by devices of the same
+  // compute architecture
+  ptx_ = getPTX(withCachedKernelName(code_, name_), major, minor);
 
   TORCH_CU_CHECK(nvrtc().cuModuleLoadData(&module_, ptx_.data()));
   TORCH_CU_CHECK(
-      nvrtc().cuModuleGetFunction(&function_, module_, name_.c_str()));
+      nvrtc().cuModuleGetFunction(
+          &function_, module_, cached_kernel_name.c_str()));
 
   // Computes max blocks
   TORCH_CU_CHECK(nvrtc().cuOccupancyMaxActiveBlocksPerMultiprocessor(
@@ -224,7 +353,10 @@ void FusedKernelCUDA::launch_raw(
   const auto prior_device = at::cuda::current_device();
   at::cuda::set_device(device_);
 
-  const auto nBlocks = std::min(maxBlocks_, ceilDiv(numel, kBlockSize));
+  // Kernels reducing the innermost dimension use a warp per output element
+  const auto nThreads =
+      reduction_desc_.isInnermost() ? numel * kWarpSize : numel;
+  const auto nBlocks = std::min(maxBlocks_, ceilDiv(nThreads, kBlockSize));
 
   // Adds random state to arguments if necessary
   // Note: offset defined here so its lifetime extends to the launch
@@ -269,6 +401,7 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
     std::vector<TensorDesc> output_desc,
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
+    ReductionDesc reduction_desc,
     bool has_random) {
   return std::make_shared<FusedKernelCUDA>(
       device,
@@ -278,6 +411,7 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
       std::move(output_desc),
       std::move(chunk_desc),
       std::move(concat_desc),
+      std::move(reduction_desc),
       has_random);
 }
 
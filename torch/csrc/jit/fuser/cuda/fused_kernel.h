@@ -28,6 +28,7 @@ struct TORCH_API FusedKernelCUDA : public ::torch::jit::fuser::FusedKernel {
       std::vector<TensorDesc> output_desc,
       std::vector<PartitionDesc> chunk_desc,
       std::vector<PartitionDesc> concat_desc,
+      ReductionDesc reduction_desc,
       bool has_random);
 
   ~FusedKernelCUDA() override;
@@ -41,6 +42,10 @@ struct TORCH_API FusedKernelCUDA : public ::torch::jit::fuser::FusedKernel {
 
  private:
   static constexpr auto kBlockSize = 128;
+  // Number of threads that reduce each output element of kernels reducing
+  // the innermost dimension. Must match the warp reduction in
+  // cuda_inner_reduction_compilation_unit_template.
+  static constexpr auto kWarpSize = 32;
 
   // Note: per device to store device properties and compute launch heuristics
   //  Acquiring these values at launch time would be too slow
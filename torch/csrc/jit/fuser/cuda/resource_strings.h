@@ -159,6 +159,75 @@ void ${kernelName}(IndexType totalElements, ${formals} ${RandParam}) {
 }
 )");
 
+// Reduces the innermost dimension of the map with a warp per output element.
+// The lanes of the warp accumulate strided map elements, which reads
+// contiguous inputs in coalesced transactions, and the partial sums are then
+// combined with warp shuffles.
+// Note: the launch configuration relies on the size of the blocks being a
+// multiple of the warp size, so all lanes of a warp share the same output.
+static auto cuda_inner_reduction_compilation_unit_template = CodeTemplate(R"(
+${type_declarations}
+
+#define WARP_SIZE 32
+
+extern "C" __global__
+void ${kernelName}(IndexType totalElements, IndexType reduceElements, ${formals}) {
+  const IndexType lane = threadIdx.x % WARP_SIZE;
+  for (IndexType linearIndex = (blockIdx.x * blockDim.x + threadIdx.x) / WARP_SIZE;
+        linearIndex < totalElements;
+        linearIndex += gridDim.x * blockDim.x / WARP_SIZE) {
+      ${accType} acc = 0;
+      for (IndexType reduceIndex = lane;
+            reduceIndex < reduceElements;
+            reduceIndex += WARP_SIZE) {
+        const IndexType mapIndex = linearIndex * reduceElements + reduceIndex;
+        // Convert `mapIndex` into an offset of tensor:
+        ${tensorOffsets}
+        // calculate the value to reduce
+        ${kernelBody}
+        acc += ${reduceValue};
+      }
+      for (int offset = WARP_SIZE / 2; offset > 0; offset /= 2) {
+        acc += __shfl_down_sync(0xffffffff, acc, offset);
+      }
+      if (lane == 0) {
+        // Convert `linearIndex` into an offset of the output:
+        ${outputOffsets}
+        ${outputWrites}
+      }
+    }
+}
+)");
+
+// Reduces the outermost dimension of the map with a thread per output
+// element. Neighbouring threads accumulate neighbouring map elements, so the
+// reads of contiguous inputs are coalesced at every step.
+static auto cuda_outer_reduction_compilation_unit_template = CodeTemplate(R"(
+${type_declarations}
+
+extern "C" __global__
+void ${kernelName}(IndexType totalElements, IndexType reduceElements, ${formals}) {
+  for (IndexType linearIndex = blockIdx.x * blockDim.x + threadIdx.x;
+        linearIndex < totalElements;
+        linearIndex += gridDim.x * blockDim.x) {
+      ${accType} acc = 0;
+      for (IndexType reduceIndex = 0;
+            reduceIndex < reduceElements;
+            reduceIndex += 1) {
+        const IndexType mapIndex = reduceIndex * totalElements + linearIndex;
+        // Convert `mapIndex` into an offset of tensor:
+        ${tensorOffsets}
+        // calculate the value to reduce
+        ${kernelBody}
+        acc += ${reduceValue};
+      }
+      // Convert `linearIndex` into an offset of the output:
+      ${outputOffsets}
+      ${outputWrites}
+    }
+}
+)");
+
 // This snippet enables half support in the jit. Following the pattern for
 // reductions, fp16 input data is immediately upconverted to float
 // with __half2float(). All mathematical operations are done on float
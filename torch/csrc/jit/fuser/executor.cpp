@@ -223,6 +223,15 @@ void launchFusion(
     numel = computeNumel(map_size);
   }
 
+  // Reduction kernels run over the output elements, each of which sums
+  // reduce_numel elements of the map
+  const auto& reduction = fusion.reductionDesc();
+  uint32_t reduce_numel = 1;
+  if (!reduction.isNoop()) {
+    reduce_numel = reduction.reducedSize(map_size);
+    numel = computeNumel(reduction.outputSizes(map_size));
+  }
+
   // compute number of scalar inputs and convert them to float
   std::vector<double> scalar_inputs;
   scalar_inputs.reserve(all_inputs.size());
@@ -240,10 +249,14 @@ void launchFusion(
   std::vector<char> buffer(maxPossibleBufferSize);
   char* buffer_next = buffer.data();
 
-  // A vector of arguments to the kernel (numel, *input_desc_s, *output_desc_s)
+  // A vector of arguments to the kernel
+  // (numel, [reduce_numel], *input_desc_s, *output_desc_s)
   std::vector<void*> arguments;
-  arguments.reserve(3 + scalar_inputs.size() + flat_inputs_size + flat_outputs_size);
+  arguments.reserve(4 + scalar_inputs.size() + flat_inputs_size + flat_outputs_size);
   arguments.push_back(&numel);
+  if (!reduction.isNoop()) {
+    arguments.push_back(&reduce_numel);
+  }
 
   auto addTensorInfoRaw = [&](const TensorDesc& desc,
                               void* data_ptr,
@@ -294,7 +307,8 @@ void launchFusion(
     const auto& c = fusion.concatDesc()[i];
     if (c.isNoop()) {
       outputs.push_back(at::empty(
-          map_size, ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
+          reduction.outputSizes(map_size),
+          ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
       addTensorInfo(fusion.outputDesc()[i], outputs[i]);
     } else {
       size_t small_size = map_size[c.dim()];
@@ -357,6 +371,11 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   // Tries to run fallback if map size can't be computed
   if (!maybe_map_size)
     return false;
+  // Reductions are only generated over the outermost or innermost dimension
+  // of the map, which may not be the reduced one for this number of
+  // dimensions
+  if (!spec.reduction().canReduce(maybe_map_size->size()))
+    return false;
   if (spec.hasRandom()) {
       bool hasBroadcast = shouldExpandArgs(spec,inputs, *maybe_map_size);
       if (hasBroadcast) return false;
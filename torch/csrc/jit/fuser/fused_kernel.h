@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <torch/csrc/jit/fuser/partition_desc.h>
+#include <torch/csrc/jit/fuser/reduction_desc.h>
 #include <torch/csrc/jit/fuser/tensor_desc.h>
 #include <torch/csrc/utils/disallow_copy.h>
 
@@ -23,6 +24,7 @@ struct FusedKernel {
       std::vector<TensorDesc> output_desc,
       std::vector<PartitionDesc> chunk_desc,
       std::vector<PartitionDesc> concat_desc,
+      ReductionDesc reduction_desc,
       bool has_random)
       : name_(std::move(name)),
         code_(std::move(code)),
@@ -30,6 +32,7 @@ struct FusedKernel {
         output_desc_(std::move(output_desc)),
         chunk_desc_(std::move(chunk_desc)),
         concat_desc_(std::move(concat_desc)),
+        reduction_desc_(std::move(reduction_desc)),
         has_random_(has_random) {}
 
   virtual ~FusedKernel() = default;
@@ -39,7 +42,8 @@ struct FusedKernel {
   // The format of arguments is suitable for directly passing to a call to
   // cuLaunchKernel as the kernel arguments.
   // Currently the first argument is a pointer to numel (for passing to
-  // CUDA code), and the remainder are pointers to the TensorInfo<T> structs
+  // CUDA code), followed by a pointer to the number of elements reduced into
+  // each output element for reduction kernels, and the remainder are pointers to the TensorInfo<T> structs
   // that compiled code uses to load Tensor data.
   // launch_with_tensors handles packing at::Tensors into this arguments array.
   // CPU code uses the same convension so that launch_with_tensors can be
@@ -67,6 +71,9 @@ struct FusedKernel {
   const std::vector<PartitionDesc>& concatDesc() const {
     return concat_desc_;
   }
+  const ReductionDesc& reductionDesc() const {
+    return reduction_desc_;
+  }
   bool hasRandom() const {
     return has_random_;
   }
@@ -87,6 +94,10 @@ struct FusedKernel {
   // many subtensors that the fusion group produces
   const std::vector<PartitionDesc> concat_desc_;
 
+  // describes the sum that produces the (single) output
+  // of reduction kernels
+  const ReductionDesc reduction_desc_;
+
   const bool has_random_;
 };
 
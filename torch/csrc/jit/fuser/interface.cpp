@@ -5,7 +5,10 @@
 #include <torch/csrc/jit/fuser/fallback.h>
 #include <torch/csrc/jit/fuser/kernel_cache.h>
 
+#include <cstdlib>
+#include <mutex>
 #include <stdexcept>
+#include <string>
 
 namespace torch {
 namespace jit {
@@ -15,6 +18,16 @@ namespace detail {
 // Note: CPU fusion is currently disabled due to test flakiness
 bool cpu_fuser_enabled = false;
 
+std::mutex kernel_cache_dir_mutex;
+
+std::string& kernelCacheDir() {
+  static std::string dir = [] {
+    const char* env = std::getenv("PYTORCH_FUSER_CACHE_DIR");
+    return std::string(env ? env : "");
+  }();
+  return dir;
+}
+
 } // namespace detail
 
 int64_t registerFusion(const Node* fusion_group) {
@@ -40,6 +53,16 @@ void overrideCanFuseOnCPU(bool value) {
   detail::cpu_fuser_enabled = value;
 }
 
+void setFusionKernelCacheDir(const std::string& dir) {
+  std::lock_guard<std::mutex> guard(detail::kernel_cache_dir_mutex);
+  detail::kernelCacheDir() = dir;
+}
+
+std::string getFusionKernelCacheDir() {
+  std::lock_guard<std::mutex> guard(detail::kernel_cache_dir_mutex);
+  return detail::kernelCacheDir();
+}
+
 // Uses the above interface by stuffing the graph into a node and treating that
 // node as a fusion group.
 std::vector<at::Tensor> debugLaunchGraph(
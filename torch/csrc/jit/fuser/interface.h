@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace torch {
@@ -32,6 +33,15 @@ TORCH_API bool canFuseOnGPU();
 // flakiness)
 TORCH_API void overrideCanFuseOnCPU(bool value);
 
+// Sets the directory of the persistent cache of compiled CPU fusion kernels.
+// A kernel found there is loaded instead of being compiled, and newly compiled
+// kernels are added to it, so the directory can be filled ahead of time (e.g.
+// by running a model on example inputs when exporting it) and shipped to the
+// processes serving it. The empty string disables the cache; the initial
+// value is taken from the PYTORCH_FUSER_CACHE_DIR environment variable.
+TORCH_API void setFusionKernelCacheDir(const std::string& dir);
+TORCH_API std::string getFusionKernelCacheDir();
+
 // Treats the given graph as a fusion group and launches it on the
 // specified device with the given inputs.
 // Returns the outputs.
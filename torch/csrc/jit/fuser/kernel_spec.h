@@ -91,6 +91,7 @@ struct TORCH_API KernelSpec {
         inputBroadcastGroups_{},
         inputChunks_{},
         outputMapAndSizes_{},
+        reduction_{},
         has_random_{false},
         kernels_{} {
     for (const auto& n : graph_->nodes()) {
@@ -140,6 +141,13 @@ struct TORCH_API KernelSpec {
     return outputMapAndSizes_;
   }
 
+  ReductionDesc& reduction() {
+    return reduction_;
+  }
+  const ReductionDesc& reduction() const {
+    return reduction_;
+  }
+
   bool hasRandom() const {
     return has_random_;
   }
@@ -172,6 +180,8 @@ struct TORCH_API KernelSpec {
   // element per fusion group output (which may be larger than the
   // number of kernel outputs).
   std::vector<OutputMapAndSize> outputMapAndSizes_;
+  // Set during upfront compilation if the fusion group ends in a sum
+  ReductionDesc reduction_;
   bool has_random_;
   mutable std::mutex mutex_;
   mutable std::
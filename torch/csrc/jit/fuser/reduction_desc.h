@@ -0,0 +1,79 @@
+#pragma once
+
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// Descriptor for the sum that ends a fusion group, if any. The sum reduces
+// either the outermost or the innermost dimension of the map size and its
+// result is the only output of the kernel.
+// Note: default constructed for kernels that perform no reduction.
+// Note: dimension 0 is always treated as the outermost dimension, even for a
+// one-dimensional map, so that the kernels generated for a given descriptor
+// do not depend on the number of dimensions of the map.
+struct TORCH_API ReductionDesc {
+  ReductionDesc() : isNoop_{true}, dim_{0}, keepdim_{false} {}
+
+  ReductionDesc(int64_t _dim, bool _keepdim)
+      : isNoop_{false}, dim_{_dim}, keepdim_{_keepdim} {}
+
+  bool isNoop() const {
+    return isNoop_;
+  }
+  int64_t dim() const {
+    return dim_;
+  }
+  bool keepdim() const {
+    return keepdim_;
+  }
+  bool isInnermost() const {
+    return !isNoop_ && dim_ != 0;
+  }
+
+  // Returns true if the reduction can be run on a map with ndim dimensions,
+  // i.e. if it reduces its outermost or its innermost dimension.
+  bool canReduce(const size_t ndim) const {
+    if (isNoop_) {
+      return true;
+    }
+    return ndim > 0 &&
+        (dim_ == 0 || dim_ == -1 || dim_ == static_cast<int64_t>(ndim) - 1);
+  }
+
+  // Number of elements reduced into each output element
+  int64_t reducedSize(at::IntArrayRef map_size) const {
+    AT_ASSERT(!isNoop_ && canReduce(map_size.size()));
+    return isInnermost() ? map_size.back() : map_size.front();
+  }
+
+  std::vector<int64_t> outputSizes(at::IntArrayRef map_size) const {
+    std::vector<int64_t> sizes(map_size.begin(), map_size.end());
+    if (isNoop_) {
+      return sizes;
+    }
+    AT_ASSERT(canReduce(map_size.size()));
+    const auto it = isInnermost() ? sizes.end() - 1 : sizes.begin();
+    if (keepdim_) {
+      *it = 1;
+    } else {
+      sizes.erase(it);
+    }
+    return sizes;
+  }
+
+ private:
+  bool isNoop_;
+  int64_t dim_; // as given to aten::sum, possibly wrapped
+  bool keepdim_;
+};
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -54,6 +54,12 @@ struct TORCH_API TensorDesc {
     return (contiguity.size() == 0 || contiguity.back());
   }
 
+  // True iff the tensor is dense and row-major, so that the offset of an
+  // element is its linear index
+  bool isContiguous() const {
+    return nDim_ == 1 && lastIsContiguous();
+  }
+
   static std::vector<bool> findContiguous(
       const at::IntArrayRef& sizes,
       const at::IntArrayRef& strides) {
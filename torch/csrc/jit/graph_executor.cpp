@@ -9,6 +9,7 @@
 #include <torch/csrc/jit/interpreter.h>
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/pass_manager.h>
+#include <torch/csrc/jit/profiling_record.h>
 #include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
@@ -20,13 +21,17 @@
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/inplace_check.h>
+#include <torch/csrc/jit/passes/loop_fusion.h>
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_grad_of.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/peephole.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/requires_grad_analysis.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
 #include <torch/csrc/jit/resource_guard.h>
 #include <torch/csrc/jit/tracer.h>
 
@@ -36,6 +41,7 @@
 
 #include <cstdint>
 #include <iterator>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -53,6 +59,11 @@ void debugSetAutodiffSubgraphInlining(bool state) {
   autodiff_subgraph_inlining = state;
 }
 
+bool& getProfilingMode() {
+  static bool profiling_mode = false;
+  return profiling_mode;
+}
+
 thread_local std::weak_ptr<Graph> last_executed_optimized_graph;
 std::shared_ptr<Graph> lastExecutedOptimizedGraph() {
   return last_executed_optimized_graph.lock();
@@ -70,6 +81,11 @@ using autograd::variable_list;
 const size_t autodiffSubgraphNodeThreshold = 2;
 const size_t autodiffSubgraphInlineThreshold = 5;
 
+// In profiling mode, the maximum number of shape specializations compiled for
+// a single ArgumentSpec. Inputs that fail all of their guards beyond that run
+// the plan specialized only to the ArgumentSpec.
+const size_t profiledSpecializationLimit = 8;
+
 struct ExecutionPlan {
   ExecutionPlan() = default;
   ExecutionPlan(std::shared_ptr<Graph> graph)
@@ -95,6 +111,89 @@ struct ExecutionPlan {
   std::shared_ptr<Graph> graph;
 };
 
+// A plan compiled for the input shapes observed while profiling. guards holds,
+// for every graph input, the ProfiledTensorType the plan was specialized to,
+// or nullptr for inputs whose rank varied between the profiled runs. The
+// dimensions that varied match any size.
+struct ProfiledPlan {
+  bool matches(at::ArrayRef<IValue> inputs) const {
+    for (size_t i = 0; i < guards.size(); ++i) {
+      if (!guards[i]) {
+        continue;
+      }
+      if (!inputs[i].isTensor()) {
+        return false;
+      }
+      const auto& t = inputs[i].toTensor();
+      if (!t.defined() || t.scalar_type() != *guards[i]->scalarType() ||
+          t.device() != *guards[i]->device() ||
+          !matchesShape(t.sizes(), guards[i]->sizes()) ||
+          !matchesShape(t.strides(), guards[i]->strides())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static bool matchesShape(
+      at::IntArrayRef sizes,
+      const c10::VaryingShape& shape) {
+    if (!shape.size()) {
+      return true;
+    }
+    if (*shape.size() != sizes.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      const auto& size = shape[static_cast<int>(i)];
+      if (size && *size != sizes[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  std::vector<ProfiledTensorTypePtr> guards;
+  ExecutionPlan plan;
+};
+
+// The CompleteTensorType of a profiled input whose shape stayed the same
+// across all of the profiled runs, or nullptr.
+CompleteTensorTypePtr completeType(const ProfiledTensorTypePtr& type) {
+  if (!type) {
+    return nullptr;
+  }
+  auto sizes = type->sizes().concrete_sizes();
+  auto strides = type->strides().concrete_sizes();
+  if (!type->scalarType() || !type->device() || !sizes || !strides) {
+    return nullptr;
+  }
+  return CompleteTensorType::create(
+      *type->scalarType(),
+      *type->device(),
+      *sizes,
+      *strides,
+      type->requiresGrad().value_or(false));
+}
+
+// Profiling state for a single ArgumentSpec. The graph is first run with
+// profile nodes recording the types of its values, then specialized to the
+// input shapes that stayed the same across the profiled runs. When an input
+// misses all of the specializations, it is profiled again, until
+// profiledSpecializationLimit is reached.
+struct ProfilingState {
+  struct Run {
+    std::unique_ptr<ProfilingRecord> record;
+    ExecutionPlan plan;
+  };
+  // Runs are never freed, as other threads may still be executing them and
+  // their profile nodes refer to the records.
+  std::list<Run> runs;
+  bool profiling = false;
+  std::list<ProfiledPlan> specializations;
+  ExecutionPlan generic;
+};
+
 struct CaptureList {
   CaptureList(size_t capture_size) {
     capture_types_.reserve(capture_size);
@@ -524,6 +623,9 @@ struct GraphExecutorImpl {
       return runTraced(stack);
     }
 
+    if (optimize && getProfilingMode()) {
+      return getOrCompileProfiled(stack).run(stack);
+    }
     auto& execution_plan =
         optimize ? getOrCompile(stack) : getOrCompileFallback();
     return execution_plan.run(stack);
@@ -575,9 +677,81 @@ struct GraphExecutorImpl {
     }
   }
 
-  ExecutionPlan compileSpec(const ArgumentSpec& spec) {
+  const ExecutionPlan& getOrCompileProfiled(const Stack& stack) {
+    ArgumentSpec spec =
+        arg_spec_creator_.create(autograd::GradMode::is_enabled(), stack);
+    auto inputs = last(stack, num_inputs);
+    std::lock_guard<std::mutex> lock(compile_mutex);
+    auto& state = profiling_states[spec];
+    if (state.profiling) {
+      auto& run = state.runs.back();
+      size_t remaining;
+      {
+        std::lock_guard<std::mutex> record_lock(run.record->mutex_);
+        remaining = run.record->profiling_count_;
+      }
+      if (remaining > 0) {
+        return run.plan;
+      }
+      state.profiling = false;
+      state.specializations.emplace_back(
+          compileProfiled(spec, *run.record->profiled_graph_));
+    }
+    for (const auto& specialization : state.specializations) {
+      if (specialization.matches(inputs)) {
+        return specialization.plan;
+      }
+    }
+    if (state.runs.size() < profiledSpecializationLimit) {
+      auto profiled_graph = graph->copy();
+      arg_spec_creator_.specializeTypes(*profiled_graph, spec);
+      runRequiredPasses(profiled_graph);
+      ProfilingState::Run run;
+      run.record = ProfilingRecord::instrumentGraph(profiled_graph);
+      run.plan = ExecutionPlan(run.record->profiled_graph_);
+      state.runs.push_back(std::move(run));
+      state.profiling = true;
+      return state.runs.back().plan;
+    }
+    if (!state.generic) {
+      state.generic = compileSpec(spec);
+    }
+    return state.generic;
+  }
+
+  // Compiles a plan specialized to the input shapes that were stable across
+  // all of the runs of profiled_graph.
+  ProfiledPlan compileProfiled(
+      const ArgumentSpec& spec,
+      const Graph& profiled_graph) {
+    ProfiledPlan result;
+    for (auto input : profiled_graph.inputs()) {
+      ProfiledTensorTypePtr guard;
+      if (auto type = input->type()->cast<ProfiledTensorType>()) {
+        if (type->scalarType() && type->device() && type->sizes().size()) {
+          guard = type;
+        }
+      }
+      result.guards.push_back(std::move(guard));
+    }
+    result.plan = compileSpec(spec, result.guards);
+    return result;
+  }
+
+  // input_shapes optionally gives the shapes of the graph inputs observed
+  // while profiling; null entries are left as they are. The inputs whose
+  // shapes were stable are specialized to them, the others to the sizes that
+  // were.
+  ExecutionPlan compileSpec(
+      const ArgumentSpec& spec,
+      at::ArrayRef<ProfiledTensorTypePtr> input_shapes = {}) {
     auto opt_graph = graph->copy();
     arg_spec_creator_.specializeTypes(*opt_graph, spec);
+    for (size_t i = 0; i < input_shapes.size(); ++i) {
+      if (auto type = completeType(input_shapes[i])) {
+        opt_graph->inputs()[i]->setType(type);
+      }
+    }
 
     // Phase 1. Specialize to input definedness (this is very important for
     //          gradient graphs), and run required passes to bring the graph
@@ -591,6 +765,7 @@ struct GraphExecutorImpl {
     //          information anyway, so it's better to run it first.
     ConstantPropagation(opt_graph);
     PropagateInputShapes(opt_graph);
+    SpecializeSymbolicShapes(opt_graph, input_shapes);
     PropagateRequiresGrad(opt_graph);
 
     // Phase 3. Run differentiable optimizations (i.e. simple graph rewrites
@@ -626,6 +801,12 @@ struct GraphExecutorImpl {
     }
     // Make sure there are no leftovers from any passes.
     EliminateDeadCode(opt_graph);
+    // Phase 6. Sizes are only known to hold when the inputs are guarded on
+    //          them, so only graphs specialized to profiled shapes can have
+    //          their memory planned.
+    if (!input_shapes.empty() && !needsGradient(opt_graph)) {
+      PlanMemory(opt_graph);
+    }
     return ExecutionPlan(opt_graph);
   }
 
@@ -638,6 +819,13 @@ struct GraphExecutorImpl {
 
     PeepholeOptimize(graph);
     ConstantPropagation(graph);
+    FuseDropoutAddLayerNorm(graph);
+    FuseLinearRelu(graph);
+
+    // Merge loops that walk the same range and hoist computations that don't
+    // change between iterations (e.g. transposed weights in decoder steps).
+    FuseLoops(graph);
+    HoistLoopInvariants(graph);
 
     // Unroll small loops, and eliminate expressions that are the same at every
     // iteration.
@@ -740,8 +928,12 @@ struct GraphExecutorImpl {
   // that are specialized to the spec.
   std::unordered_map<ArgumentSpec, ExecutionPlan> plan_cache;
 
+  // Used instead of plan_cache in profiling mode.
+  std::unordered_map<ArgumentSpec, ProfilingState> profiling_states;
+
   // GraphExecutors can be accessed from multiple threads, so this thread needs
-  // to be held every time we access the fallback or plan_cache.
+  // to be held every time we access the fallback, plan_cache or
+  // profiling_states.
   std::mutex compile_mutex;
 };
 
@@ -48,6 +48,10 @@ TORCH_API void runRequiredPasses(const std::shared_ptr<Graph>& g);
 TORCH_API void debugSetAutodiffSubgraphInlining(bool state);
 TORCH_API std::shared_ptr<Graph> lastExecutedOptimizedGraph();
 
+// When set, GraphExecutors first run a profiled version of the graph and
+// then specialize it, behind guards, to the input shapes they observed.
+TORCH_API bool& getProfilingMode();
+
 namespace detail {
 
 GraphExecutor* getGradExecutor(Operation& op);
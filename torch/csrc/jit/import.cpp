@@ -19,10 +19,12 @@
 #include "caffe2/serialize/istream_adapter.h"
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 
 #include <fstream>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace torch {
@@ -51,6 +53,8 @@ class ScriptModuleDeserializer final {
       script::ExtraFilesMap& extra_files);
 
  private:
+  at::Device tensorDevice(const torch::TensorDef& tensor_proto) const;
+  at::Storage loadStorage(const torch::TensorDef& tensor_proto);
   at::Tensor loadTensor(
       const torch::TensorDef& tensor_proto,
       std::unordered_map<std::string, at::Storage>& storageMap);
@@ -76,9 +80,7 @@ class ScriptModuleDeserializer final {
 };
 
 ScriptModuleDeserializer::ScriptModuleDeserializer(const std::string& filename)
-    : reader_(filename.c_str()) {
-  // TODO appropriate support for mmap, right now still use stream reader
-}
+    : reader_(filename.c_str()) {}
 
 ScriptModuleDeserializer::ScriptModuleDeserializer(std::istream* is)
     : reader_(is) {}
@@ -148,7 +150,28 @@ void ScriptModuleDeserializer::deserialize(
 }
 
 void ScriptModuleDeserializer::loadTensorTable(torch::ModelDef* model_def) {
+  // Tensors may share storages; each storage is loaded for the first tensor
+  // that uses it, on the device of that tensor.
+  std::vector<const torch::TensorDef*> storage_defs;
+  std::unordered_set<std::string> storage_keys;
+  for (const torch::TensorDef& tensor : model_def->tensors()) {
+    if (storage_keys.insert(tensor.data().key()).second) {
+      storage_defs.push_back(&tensor);
+    }
+  }
+  // The storages are read, and copied to their devices, in parallel.
+  std::vector<at::Storage> storages(storage_defs.size());
+  at::parallel_for(
+      0, storage_defs.size(), 1, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+          storages[i] = loadStorage(*storage_defs[i]);
+        }
+      });
+
   std::unordered_map<std::string, at::Storage> storageMap;
+  for (size_t i = 0; i < storage_defs.size(); ++i) {
+    storageMap.emplace(storage_defs[i]->data().key(), std::move(storages[i]));
+  }
   for (const torch::TensorDef& tensor : model_def->tensors()) {
     tensor_table_.emplace_back(loadTensor(tensor, storageMap));
   }
@@ -163,6 +186,44 @@ void ScriptModuleDeserializer::loadAttributeTable() {
   attribute_table_ = unpickler.parse_ivalue_list();
 }
 
+at::Device ScriptModuleDeserializer::tensorDevice(
+    const torch::TensorDef& tensor_proto) const {
+  AT_ASSERT(tensor_proto.has_device() && !tensor_proto.device().empty());
+  if (device_.has_value()) {
+    // override the device, if user provides map_location
+    return device_.value();
+  }
+  return at::Device(tensor_proto.device());
+}
+
+at::Storage ScriptModuleDeserializer::loadStorage(
+    const torch::TensorDef& tensor_proto) {
+  auto type = at::typeMetaToScalarType(
+      caffe2::DataTypeToTypeMeta(tensor_proto.data_type()));
+  at::Device device = tensorDevice(tensor_proto);
+
+  at::DataPtr storage_ptr;
+  uint64_t record_size;
+  std::tie(storage_ptr, record_size) =
+      reader_.getRecord(tensor_proto.data().key());
+  auto cpu_storage = at::Storage(
+      at::CPU(type).typeMeta(),
+      record_size / at::CPU(type).typeMeta().itemsize(),
+      std::move(storage_ptr),
+      /*allocator=*/nullptr,
+      /*resizable=*/false); // NB: we didn't set any allocator for the tensor
+  if (device.type() == at::DeviceType::CPU) {
+    return cpu_storage;
+  } else if (device.type() == at::DeviceType::CUDA) {
+    at::Tensor cpu_tensor =
+        at::empty({0}, at::CPU(type).options()).set_(cpu_storage);
+    return cpu_tensor.to(device, cpu_tensor.scalar_type()).storage();
+  }
+  AT_ERROR(
+      "supported devices include CPU and CUDA, however got ",
+      at::DeviceTypeName(device.type(), false));
+}
+
 at::Tensor ScriptModuleDeserializer::loadTensor(
     const torch::TensorDef& tensor_proto,
     std::unordered_map<std::string, at::Storage>& storageMap) {
@@ -172,41 +233,10 @@ at::Tensor ScriptModuleDeserializer::loadTensor(
       tensor_proto.strides().begin(), tensor_proto.strides().end());
   auto type = at::typeMetaToScalarType(
       caffe2::DataTypeToTypeMeta(tensor_proto.data_type()));
-  const std::string& record_key = tensor_proto.data().key();
-  AT_ASSERT(tensor_proto.has_device() && !tensor_proto.device().empty());
-  at::Device device(tensor_proto.device());
-  if (device_.has_value()) {
-    // override the device, if user provides map_location
-    device = device_.value();
-  }
+  at::Device device = tensorDevice(tensor_proto);
 
-  auto storage_it = storageMap.find(record_key);
-  if (storage_it == storageMap.end()) {
-    at::DataPtr storage_ptr;
-    uint64_t record_size;
-    std::tie(storage_ptr, record_size) = reader_.getRecord(record_key);
-    auto cpu_storage = at::Storage(
-        at::CPU(type).typeMeta(),
-        record_size / at::CPU(type).typeMeta().itemsize(),
-        std::move(storage_ptr),
-        /*allocator=*/nullptr,
-        /*resizable=*/false); // NB: we didn't set any allocator for the tensor
-    if (device.type() == at::DeviceType::CPU) {
-      storage_it =
-          storageMap.insert(std::make_pair(record_key, cpu_storage)).first;
-    } else if (device.type() == at::DeviceType::CUDA) {
-      at::Tensor cpu_tensor =
-          at::empty({0}, at::CPU(type).options()).set_(cpu_storage);
-      at::Storage cuda_storage =
-          cpu_tensor.to(device, cpu_tensor.scalar_type()).storage();
-      storage_it =
-          storageMap.insert(std::make_pair(record_key, cuda_storage)).first;
-    } else {
-      AT_ERROR(
-          "supported devices include CPU and CUDA, however got ",
-          at::DeviceTypeName(device.type(), false));
-    }
-  }
+  auto storage_it = storageMap.find(tensor_proto.data().key());
+  AT_ASSERT(storage_it != storageMap.end());
   if (storage_it->second.device().type() != device.type() ||
       (device.has_index() &&
        storage_it->second.device().index() != device.index())) {
@@ -10,31 +10,40 @@
 #include <torch/csrc/jit/import.h>
 #include <torch/csrc/jit/irparser.h>
 #include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/constant_pooling.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/convert_to_inplace_ops.h>
+#include <torch/csrc/jit/passes/convert_to_mkldnn.h>
 #include <torch/csrc/jit/passes/create_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
 #include <torch/csrc/jit/passes/erase_number_types.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
+#include <torch/csrc/jit/passes/loop_fusion.h>
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
+#include <torch/csrc/jit/passes/memory_planning.h>
 #include <torch/csrc/jit/passes/onnx.h>
 #include <torch/csrc/jit/passes/onnx/constant_fold.h>
 #include <torch/csrc/jit/passes/onnx/fixup_onnx_loop.h>
 #include <torch/csrc/jit/passes/onnx/peephole.h>
 #include <torch/csrc/jit/passes/onnx/prepare_division_for_onnx.h>
 #include <torch/csrc/jit/passes/peephole.h>
+#include <torch/csrc/jit/passes/prepack_weights.h>
 #include <torch/csrc/jit/passes/quantization.h>
 #include <torch/csrc/jit/passes/remove_expands.h>
 #include <torch/csrc/jit/passes/remove_inplace_ops.h>
 #include <torch/csrc/jit/passes/shape_analysis.h>
 #include <torch/csrc/jit/passes/specialize_autogradzero.h>
 #include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
 #include <torch/csrc/jit/passes/utils/check_alias_annotation.h>
 #include <torch/csrc/jit/pybind_utils.h>
 #include <torch/csrc/jit/python_arg_flatten.h>
@@ -106,6 +115,9 @@ void initJITBindings(PyObject* module) {
           torch::jit::fuser::debugNumCachedKernelSpecs)
       .def("_jit_pass_onnx", ToONNX)
       .def("_jit_pass_lower_all_tuples", LowerAllTuples)
+      .def(
+          "_jit_pass_plan_memory",
+          [](std::shared_ptr<Graph>& g) { return PlanMemory(g); })
       .def("_jit_pass_onnx_peephole", PeepholeOptimizeONNX)
       .def(
           "_jit_pass_onnx_constant_fold",
@@ -195,6 +207,13 @@ void initJITBindings(PyObject* module) {
             subgraph_rewriter.RegisterRewritePattern(pattern, fused_node_name);
             subgraph_rewriter.runOnGraph(g);
           })
+      .def(
+          "_jit_pass_quant_fusion",
+          [](std::shared_ptr<Graph>& g, bool per_channel) {
+            return QuantFusion(g, per_channel);
+          },
+          py::arg("graph"),
+          py::arg("per_channel") = false)
       .def(
           "_jit_pass_fold_quant_inputs",
           [](std::shared_ptr<Graph>& g) {
@@ -242,6 +261,8 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_inline_fork_wait", InlineForkWait)
       .def("_jit_pass_prepare_division_for_onnx", PrepareDivisionForONNX)
       .def("_jit_pass_loop_unrolling", UnrollLoops)
+      .def("_jit_pass_loop_fusion", FuseLoops)
+      .def("_jit_pass_loop_invariant_code_motion", HoistLoopInvariants)
       .def(
           "_jit_pass_constant_propagation",
           [](std::shared_ptr<Graph>& g) { return ConstantPropagation(g); })
@@ -276,8 +297,32 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_fixup_onnx_loops", FixupONNXLoops)
       .def("_jit_pass_canonicalize_ops", CanonicalizeOps)
       .def("_jit_pass_decompose_ops", DecomposeOps)
+      .def("_jit_pass_convert_to_mkldnn", ConvertToMKLDNN)
+      .def("_jit_pass_convert_to_inplace_ops", ConvertToInplaceOps)
+      .def("_jit_pass_prepack_weights", PrepackWeights)
+      .def("_jit_pass_batch_mm", BatchMM)
+      .def(
+          "_jit_pass_freeze_module",
+          [](std::shared_ptr<script::Module>& module,
+             std::shared_ptr<script::Module>& frozen) {
+            FreezeModule(*module, *frozen);
+          })
       .def("_jit_pass_specialize_autogradzero", specializeAutogradZero)
+      .def(
+          "_jit_pass_specialize_symbolic_shapes",
+          [](const std::shared_ptr<Graph>& g) {
+            return SpecializeSymbolicShapes(g);
+          })
       .def("_jit_override_can_fuse_on_cpu", &overrideCanFuseOnCPU)
+      .def("_jit_set_fuser_kernel_cache_dir", &setFusionKernelCacheDir)
+      .def("_jit_get_fuser_kernel_cache_dir", &getFusionKernelCacheDir)
+      .def(
+          "_jit_set_profiling_mode",
+          [](bool profiling_flag) {
+            bool oldState = getProfilingMode();
+            getProfilingMode() = profiling_flag;
+            return oldState;
+          })
       .def(
           "_jit_differentiate",
           [](Graph& g) {
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace torch {
+namespace jit {
+
+// How the interpreter runs an instruction. OP calls the operator through the
+// stack; the other opcodes are handled inline by the dispatch loop, reading
+// and writing the registers directly, which avoids the std::function call and
+// the stack traffic for the control flow and the scalar arithmetic that
+// dominate loops.
+//
+// The opcodes are also those of the bytecode the mobile interpreter runs (see
+// mobile/bytecode.h), so their values are part of the serialized format:
+// only ever append to this list.
+enum OpCode : uint8_t {
+  OP, // outputs = callback(inputs)
+  ASSIGN, // outputs = inputs, leaving any extra inputs on the stack
+  DROP, // free the inputs
+  LOADC, // output = constants[X]
+  JF, // jump by X if the condition is false
+  JT, // jump by X if the condition is true
+  JMP, // jump by X
+  INT_ADD,
+  INT_SUB,
+  INT_MUL,
+  INT_LT,
+  INT_GT,
+  INT_LE,
+  INT_GE,
+  INT_EQ,
+  INT_NE,
+  BOOL_AND,
+  BOOL_OR,
+  LIST_SELECT_INT,
+  LIST_SELECT_FLOAT,
+  LIST_SELECT_TENSOR,
+  NUM_OPCODES
+};
+
+} // namespace jit
+} // namespace torch
@@ -1,14 +1,16 @@
 #include <torch/csrc/jit/interpreter.h>
 
+#include <ATen/Parallel.h>
 #include <ATen/core/ivalue.h>
-#include <c10/core/thread_pool.h>
 #include <c10/util/Exception.h>
 #include <torch/csrc/autograd/edge.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/jit/constants.h>
 #include <torch/csrc/jit/graph_executor.h>
+#include <torch/csrc/jit/instruction.h>
 #include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/mobile/bytecode.h>
 #include <torch/csrc/jit/operator.h>
 #include <torch/csrc/jit/script/jit_exception.h>
 
@@ -326,7 +328,10 @@ struct UseList {
 // one instruction plus meta-data
 // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
 struct Instruction {
-  Operation callback;
+  OpCode op = OP;
+  // the relative jump target of JF, JT and JMP, or the constant of LOADC
+  int X = 0;
+  Operation callback; // only set for OP
   UseList inputs;
   ListHandle<int> outputs;
   Symbol debug_name; // used in dump to understand the generated code
@@ -337,6 +342,51 @@ int relativeJump(int from_inst, int to_inst) {
   return to_inst - (from_inst + 1);
 }
 
+// The suffix of the variadic list primitives in bytecode, by which the mobile
+// interpreter knows the type of list to create or read.
+std::string bytecodeListSuffix(const TypePtr& list_type) {
+  const TypePtr& elem_type = list_type->expect<ListType>()->getElementType();
+  if (elem_type == IntType::get()) {
+    return ".int";
+  } else if (elem_type == FloatType::get()) {
+    return ".float";
+  } else if (elem_type == BoolType::get()) {
+    return ".bool";
+  } else if (elem_type->isSubtypeOf(TensorType::get())) {
+    return ".Tensor";
+  }
+  return ".generic";
+}
+
+// The name the mobile interpreter finds the operator of n by. Operators that
+// are created for their node can't be looked up without it; of those, only
+// the primitives that the mobile interpreter implements itself are supported.
+std::string bytecodeOperatorName(Node* n) {
+  switch (n->kind()) {
+    case prim::Load:
+    case prim::Store:
+    case prim::TupleConstruct:
+    case prim::TupleUnpack:
+    case prim::TupleIndex:
+      return n->kind().toQualString();
+    case prim::ListConstruct:
+      return n->kind().toQualString() +
+          bytecodeListSuffix(n->output()->type());
+    case prim::ListUnpack:
+      return n->kind().toQualString() + bytecodeListSuffix(n->input()->type());
+    default:
+      break;
+  }
+  auto op = findOperatorFor(n);
+  if (!op || !op->hasOperation()) {
+    AT_ERROR(
+        "bytecode does not support the operator ",
+        n->kind().toQualString(),
+        ", which is created for the node it runs");
+  }
+  return canonicalSchemaString(op->schema());
+}
+
 struct CodeImpl {
   CodeImpl(const std::shared_ptr<Graph>& graph_) : preprocess(*graph_) {
     graph = preprocess.graph;
@@ -347,11 +397,8 @@ struct CodeImpl {
   void createJumpFalse(int from_inst, int to_inst) {
     auto& inst = instructions[from_inst];
     AT_ASSERT(inst.debug_name == prim::Placeholder);
-    auto offset = relativeJump(from_inst, to_inst);
-    inst.callback = [offset](Stack& stack) {
-      auto t = pop(stack).toBool();
-      return t ? 0 : offset;
-    };
+    inst.op = JF;
+    inst.X = relativeJump(from_inst, to_inst);
     inst.debug_name = prim::JumpZ;
   }
 
@@ -359,19 +406,16 @@ struct CodeImpl {
   void createJumpTrue(int from_inst, int to_inst) {
     auto& inst = instructions[from_inst];
     AT_ASSERT(inst.debug_name == prim::Placeholder);
-    auto offset = relativeJump(from_inst, to_inst);
-    inst.callback = [offset](Stack& stack) {
-      auto t = pop(stack).toBool();
-      return t ? offset : 0;
-    };
+    inst.op = JT;
+    inst.X = relativeJump(from_inst, to_inst);
     inst.debug_name = prim::JumpNZ;
   }
 
   void createJump(int from_inst, int to_inst) {
     auto& inst = instructions[from_inst];
     AT_ASSERT(inst.debug_name == prim::Placeholder);
-    auto offset = relativeJump(from_inst, to_inst);
-    inst.callback = [=](Stack& stack) { return offset; };
+    inst.op = JMP;
+    inst.X = relativeJump(from_inst, to_inst);
     inst.debug_name = prim::Jump;
   }
 
@@ -485,9 +529,95 @@ struct CodeImpl {
         n->inputs(),
         moveFlags(n),
         n->outputs());
-    instructions[inst].callback = getOperation(n);
+    op_nodes[inst] = n;
+    auto& instruction = instructions[inst];
+    instruction.op = inlineOpCodeFor(n);
+    if (instruction.op == LOADC) {
+      instruction.X = constants.size();
+      constants.push_back(*toIValue(n->output()));
+    } else if (instruction.op == OP) {
+      instruction.callback = getOperation(n);
+    }
     return inst;
   }
+
+  // The opcode running n without calling its operator, or OP if there is
+  // none. The inline opcodes must behave exactly like the operators.
+  static OpCode inlineOpCodeFor(Node* n) {
+    if (n->kind() == prim::Drop) {
+      return DROP;
+    }
+    if (n->kind() == prim::Constant) {
+      // constants of mutable types are created anew on every run
+      const auto kind = n->output()->type()->kind();
+      switch (kind) {
+        case TypeKind::IntType:
+        case TypeKind::FloatType:
+        case TypeKind::BoolType:
+        case TypeKind::NoneType:
+        case TypeKind::StringType:
+        case TypeKind::DeviceObjType:
+          return LOADC;
+        default:
+          return n->output()->type()->isSubtypeOf(TensorType::get()) ? LOADC
+                                                                     : OP;
+      }
+    }
+    if (n->inputs().size() != 2 || n->outputs().size() != 1) {
+      return OP;
+    }
+    auto inputsAre = [&](TypeKind a, TypeKind b) {
+      return n->input(0)->type()->kind() == a &&
+          n->input(1)->type()->kind() == b;
+    };
+    if (inputsAre(TypeKind::IntType, TypeKind::IntType)) {
+      switch (n->kind()) {
+        case aten::add:
+          return INT_ADD;
+        case aten::sub:
+          return INT_SUB;
+        case aten::mul:
+          return INT_MUL;
+        case aten::lt:
+          return INT_LT;
+        case aten::gt:
+          return INT_GT;
+        case aten::le:
+          return INT_LE;
+        case aten::ge:
+          return INT_GE;
+        case aten::eq:
+          return INT_EQ;
+        case aten::ne:
+          return INT_NE;
+        default:
+          return OP;
+      }
+    }
+    if (inputsAre(TypeKind::BoolType, TypeKind::BoolType)) {
+      switch (n->kind()) {
+        case aten::__and__:
+          return BOOL_AND;
+        case aten::__or__:
+          return BOOL_OR;
+        default:
+          return OP;
+      }
+    }
+    if (n->kind() == aten::select &&
+        inputsAre(TypeKind::ListType, TypeKind::IntType)) {
+      const auto elem_type =
+          n->input(0)->type()->expect<ListType>()->getElementType();
+      if (elem_type->kind() == TypeKind::IntType) {
+        return LIST_SELECT_INT;
+      } else if (elem_type->kind() == TypeKind::FloatType) {
+        return LIST_SELECT_FLOAT;
+      } else if (elem_type->kind() == TypeKind::TensorType) {
+        return LIST_SELECT_TENSOR;
+      }
+    }
+    return OP;
+  }
   size_t insertInstruction(
       Symbol sym,
       std::shared_ptr<SourceLocation> debug_location,
@@ -495,6 +625,7 @@ struct CodeImpl {
       ArrayRef<uint8_t> move_flags,
       ArrayRef<Value*> outputs) {
     instructions.emplace_back();
+    op_nodes.push_back(nullptr);
     auto& inst = instructions.back();
     inst.debug_name = sym;
     inst.debug_location = std::move(debug_location);
@@ -530,7 +661,7 @@ struct CodeImpl {
     // register list. We don't need to manipulate the stack in any way, because
     // all inputs are also outputs, and the interpreter will take care of
     // putting them in correct places.
-    instructions[inst].callback = [](Stack& stack) { return 0; };
+    instructions[inst].op = ASSIGN;
     return inst;
   }
 
@@ -590,6 +721,9 @@ struct CodeImpl {
     if (!grad_executors_) {
       grad_executors_.emplace();
       for (Instruction& instr : instructions) {
+        if (instr.op != OP) {
+          continue;
+        }
         if (auto executor = detail::getGradExecutor(instr.callback)) {
           grad_executors_->push_back(executor);
         }
@@ -598,6 +732,47 @@ struct CodeImpl {
     return *grad_executors_;
   }
 
+  mobile::Bytecode bytecode() const {
+    mobile::Bytecode code;
+    code.constants = constants;
+    std::unordered_map<std::string, int64_t> operator_ids;
+    for (size_t pc = 0; pc < instructions.size(); ++pc) {
+      const Instruction& inst = instructions[pc];
+      mobile::Bytecode::Instruction out;
+      out.op = inst.op;
+      out.X = inst.X;
+      for (int i = 0; i < inst.inputs.values.size; i++) {
+        out.inputs.push_back(get(inst.inputs.values, i));
+        out.free_flags.push_back(get(inst.inputs.free_flags, i));
+      }
+      for (int i = 0; i < inst.outputs.size; i++) {
+        out.outputs.push_back(get(inst.outputs, i));
+      }
+      if (inst.op == OP) {
+        Node* n = op_nodes[pc];
+        if (n->kind() == prim::Constant) {
+          // a constant of a mutable type, which the mobile interpreter copies
+          // when it loads it
+          out.op = LOADC;
+          out.X = code.constants.size();
+          code.constants.push_back(*toIValue(n->output()));
+        } else {
+          auto name = bytecodeOperatorName(n);
+          auto it = operator_ids.find(name);
+          if (it == operator_ids.end()) {
+            it = operator_ids.emplace(name, code.operators.size()).first;
+            code.operators.push_back(name);
+          }
+          out.X = it->second;
+        }
+      }
+      code.instructions.push_back(std::move(out));
+    }
+    code.register_size = register_size;
+    code.num_outputs = preprocess.n_outputs;
+    return code;
+  }
+
   void dumpInstruction(std::ostream& out, size_t pc) const {
     auto writeList = [&](const ListHandle<int>& list) {
       for (int i = 0; i < list.size; i++) {
@@ -644,7 +819,11 @@ struct CodeImpl {
 
   friend struct InterpreterState;
   std::vector<Instruction> instructions;
+  // the node of each instruction that was created for one
+  std::vector<Node*> op_nodes;
   int register_size = 0;
+  // the values loaded by LOADC instructions
+  std::vector<IValue> constants;
 
   // all memory ArrayRef<int> are slices of this, to make sure
   // the interpreter is mostly linearly scanning through memory
@@ -676,14 +855,92 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
       // std::cout << "\n";
       auto& inst = instructions[pc];
       try {
-        loadTensorsFromRegisters(inst.inputs, stack);
-        size_t new_pc = pc + 1 + inst.callback(stack);
-        for (int i = inst.outputs.size - 1; i >= 0; --i) {
-          int reg = get(inst.outputs, i);
-          registers[reg] = pop(stack);
-          // std::cout << "pop reg[" << reg << "];\n" << registers[reg] << "\n";
+        switch (inst.op) {
+          case OP: {
+            loadTensorsFromRegisters(inst.inputs, stack);
+            size_t new_pc = pc + 1 + inst.callback(stack);
+            storeOutputsToRegisters(inst.outputs, stack);
+            pc = new_pc;
+          } break;
+          case ASSIGN:
+            loadTensorsFromRegisters(inst.inputs, stack);
+            storeOutputsToRegisters(inst.outputs, stack);
+            ++pc;
+            break;
+          case DROP:
+            releaseInputs(inst);
+            ++pc;
+            break;
+          case LOADC:
+            output(inst) = function->constants[inst.X];
+            ++pc;
+            break;
+          case JF:
+            pc += 1 + (popCondition(inst, stack) ? 0 : inst.X);
+            break;
+          case JT:
+            pc += 1 + (popCondition(inst, stack) ? inst.X : 0);
+            break;
+          case JMP:
+            pc += 1 + inst.X;
+            break;
+          case INT_ADD:
+            output(inst) = input(inst, 0).toInt() + input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_SUB:
+            output(inst) = input(inst, 0).toInt() - input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_MUL:
+            output(inst) = input(inst, 0).toInt() * input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_LT:
+            output(inst) = input(inst, 0).toInt() < input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_GT:
+            output(inst) = input(inst, 0).toInt() > input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_LE:
+            output(inst) = input(inst, 0).toInt() <= input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_GE:
+            output(inst) = input(inst, 0).toInt() >= input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_EQ:
+            output(inst) = input(inst, 0).toInt() == input(inst, 1).toInt();
+            ++pc;
+            break;
+          case INT_NE:
+            output(inst) = input(inst, 0).toInt() != input(inst, 1).toInt();
+            ++pc;
+            break;
+          case BOOL_AND:
+            output(inst) = input(inst, 0).toBool() && input(inst, 1).toBool();
+            ++pc;
+            break;
+          case BOOL_OR:
+            output(inst) = input(inst, 0).toBool() || input(inst, 1).toBool();
+            ++pc;
+            break;
+          case LIST_SELECT_INT:
+            selectFromList(inst, input(inst, 0).toIntListRef());
+            ++pc;
+            break;
+          case LIST_SELECT_FLOAT:
+            selectFromList(inst, input(inst, 0).toDoubleListRef());
+            ++pc;
+            break;
+          case LIST_SELECT_TENSOR:
+            selectFromList(inst, input(inst, 0).toTensorListRef());
+            ++pc;
+            break;
         }
-        pc = new_pc;
       } catch (Suspend& e) {
         // wait() expects a single input
         AT_ASSERT(inst.inputs.values.size == 1);
@@ -698,10 +955,14 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
         // Make sure adding callback is the last step.
         // Otherwise if e.future has completed,
         // the current thread will continue running before it suspends.
+        // The waiting interpreter holds up whoever waits for it in turn, so
+        // it resumes ahead of newly forked tasks.
         InterpreterState state(intrusive_from_this());
         e.future->addCallback([state]() {
-          c10::global_work_queue().run(InterpreterContinuation(
-              state, Stack(), autograd::GradMode::is_enabled()));
+          at::launch(
+              InterpreterContinuation(
+                  state, Stack(), autograd::GradMode::is_enabled()),
+              c10::TaskPriority::HIGH);
         });
 
         return true;
@@ -783,6 +1044,59 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   bool get(const ListHandle<bool>& list, int i) {
     return bool_data[list.start + i];
   }
+  void storeOutputsToRegisters(const ListHandle<int>& outputs, Stack& stack) {
+    for (int i = outputs.size - 1; i >= 0; --i) {
+      int reg = get(outputs, i);
+      registers[reg] = pop(stack);
+      // std::cout << "pop reg[" << reg << "];\n" << registers[reg] << "\n";
+    }
+  }
+
+  // Accessors for the inline opcodes, which use the registers in place. The
+  // inputs they read are scalars or are released by releaseInputs, so they
+  // ignore the free flags.
+  const IValue& input(const Instruction& inst, int i) {
+    return registers[get(inst.inputs.values, i)];
+  }
+  IValue& output(const Instruction& inst) {
+    return registers[get(inst.outputs, 0)];
+  }
+  void releaseInputs(const Instruction& inst) {
+    for (int i = 0; i < inst.inputs.values.size; i++) {
+      if (get(inst.inputs.free_flags, i)) {
+        registers[get(inst.inputs.values, i)] = IValue();
+      }
+    }
+  }
+
+  // The condition of a branch is its input, or for the branches of loops, the
+  // value the preceding assignment left on the stack.
+  bool popCondition(const Instruction& inst, Stack& stack) {
+    if (inst.inputs.values.size == 0) {
+      return pop(stack).toBool();
+    }
+    bool cond = input(inst, 0).toBool();
+    releaseInputs(inst);
+    return cond;
+  }
+
+  template <typename T>
+  void selectFromList(const Instruction& inst, const std::vector<T>& list) {
+    const int64_t list_size = list.size();
+    int64_t idx = input(inst, 1).toInt();
+    if (idx < 0) {
+      // Handle negative indexing
+      idx += list_size;
+    }
+    if (idx < 0 || idx >= list_size) {
+      throw std::out_of_range("list index out of range");
+    }
+    // the element has to be copied before the list may be released
+    IValue element = list[idx];
+    releaseInputs(inst);
+    output(inst) = std::move(element);
+  }
+
   void loadTensorsFromRegisters(const UseList& uses, Stack& stack) {
     for (int i = 0; i < uses.values.size; i++) {
       int reg = get(uses.values, i);
@@ -833,6 +1147,10 @@ const std::vector<GraphExecutor*>& Code::grad_executors() {
   return pImpl->grad_executors();
 }
 
+mobile::Bytecode Code::bytecode() const {
+  return pImpl->bytecode();
+}
+
 InterpreterState::InterpreterState(const Code& code)
     : pImpl(c10::make_intrusive<InterpreterStateImpl>(code)) {}
 InterpreterState::~InterpreterState() = default;
@@ -25,6 +25,9 @@ struct CodeImpl;
 struct InterpreterStateImpl;
 struct Graph;
 struct Node;
+namespace mobile {
+struct Bytecode;
+}
 using Stack = std::vector<c10::IValue>;
 using c10::ivalue::Future;
 using c10::ivalue::Tuple;
@@ -36,6 +39,10 @@ struct TORCH_API Code {
 
   const std::vector<GraphExecutor*>& grad_executors();
 
+  // The instructions in the format of the mobile interpreter. Throws if the
+  // code uses operators that it does not support.
+  mobile::Bytecode bytecode() const;
+
   explicit operator bool() const {
     return pImpl != nullptr;
   }
@@ -805,6 +805,8 @@ const FunctionSchema* Node::maybeSchema() const {
 bool Node::isNondeterministic() const {
   static const OperatorSet nondeterministic_ops = {
       "aten::dropout(Tensor input, float p, bool train) -> Tensor",
+      "aten::dropout_add_layer_norm(Tensor input, Tensor residual, int[] normalized_shape, Tensor? weight, Tensor? bias, float p, bool train, float eps) -> Tensor",
+      "aten::_fused_dropout_add_layer_norm(Tensor input, Tensor residual, int[] normalized_shape, Tensor? weight, Tensor? bias, float p, float eps) -> (Tensor, Tensor, Tensor, Tensor, Tensor)",
       "aten::_fused_dropout(Tensor self, float p, Generator? generator) -> (Tensor, Tensor)",
       "aten::_standard_gamma(Tensor self, Generator? generator) -> Tensor",
       "aten::bernoulli(Tensor self, *, Generator? generator) -> Tensor",
@@ -834,7 +836,8 @@ bool Node::isNondeterministic() const {
     return false;
   }
   // Dropout with train = False is deterministic
-  if (matches("aten::dropout(Tensor input, float p, bool train) -> Tensor") &&
+  if ((matches("aten::dropout(Tensor input, float p, bool train) -> Tensor") ||
+       matches("aten::dropout_add_layer_norm(Tensor input, Tensor residual, int[] normalized_shape, Tensor? weight, Tensor? bias, float p, bool train, float eps) -> Tensor")) &&
       is_constant(attr::train) && !get<bool>(attr::train).value()) {
     return false;
   }
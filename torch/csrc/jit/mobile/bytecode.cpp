@@ -0,0 +1,66 @@
+#include <torch/csrc/jit/mobile/bytecode.h>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+using c10::ivalue::Tuple;
+
+IValue Bytecode::toIValue() const {
+  std::vector<IValue> insts;
+  insts.reserve(instructions.size());
+  for (const Instruction& inst : instructions) {
+    std::vector<int64_t> free_flags(
+        inst.free_flags.begin(), inst.free_flags.end());
+    insts.emplace_back(Tuple::create({static_cast<int64_t>(inst.op),
+                                      inst.X,
+                                      inst.inputs,
+                                      std::move(free_flags),
+                                      inst.outputs}));
+  }
+  std::vector<IValue> ops(operators.begin(), operators.end());
+  return Tuple::create({kBytecodeVersion,
+                        std::move(insts),
+                        std::move(ops),
+                        constants,
+                        register_size,
+                        num_outputs});
+}
+
+Bytecode Bytecode::fromIValue(const IValue& value) {
+  const auto& elems = value.toTuple()->elements();
+  AT_CHECK(
+      elems.size() == 6 && elems[0].toInt() == kBytecodeVersion,
+      "unsupported bytecode version, expected version ",
+      kBytecodeVersion);
+  Bytecode code;
+  for (const IValue& inst_value : elems[1].toGenericListRef()) {
+    const auto& fields = inst_value.toTuple()->elements();
+    AT_CHECK(fields.size() == 5, "malformed bytecode instruction");
+    Instruction inst;
+    const int64_t op = fields[0].toInt();
+    AT_CHECK(
+        op >= 0 && op < NUM_OPCODES, "unknown opcode ", op, " in bytecode");
+    inst.op = static_cast<OpCode>(op);
+    inst.X = fields[1].toInt();
+    inst.inputs = fields[2].toIntListRef();
+    const auto& free_flags = fields[3].toIntListRef();
+    inst.free_flags.assign(free_flags.begin(), free_flags.end());
+    inst.outputs = fields[4].toIntListRef();
+    AT_CHECK(
+        inst.inputs.size() == inst.free_flags.size(),
+        "malformed bytecode instruction");
+    code.instructions.push_back(std::move(inst));
+  }
+  for (const IValue& op : elems[2].toGenericListRef()) {
+    code.operators.push_back(op.toStringRef());
+  }
+  code.constants = elems[3].toGenericListRef();
+  code.register_size = elems[4].toInt();
+  code.num_outputs = elems[5].toInt();
+  return code;
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
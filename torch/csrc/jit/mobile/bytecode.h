@@ -0,0 +1,54 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/instruction.h>
+
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+using c10::IValue;
+
+// The code of one method, as the interpreter of the full runtime lays it out
+// (see Code::bytecode) and the mobile interpreter runs it: the registers and
+// the jumps are resolved, the constants are values, and the operators are
+// named by their schema so that loading the code needs no graph and no
+// compiler.
+struct TORCH_API Bytecode {
+  struct Instruction {
+    OpCode op = OP;
+    // the index into operators of OP, the constant of LOADC, or the relative
+    // jump target of JF, JT and JMP
+    int64_t X = 0;
+    std::vector<int64_t> inputs;
+    // whether each input is the last use of its register
+    std::vector<bool> free_flags;
+    std::vector<int64_t> outputs;
+  };
+
+  std::vector<Instruction> instructions;
+  // canonical schema strings of the operators, or for the variadic
+  // primitives the mobile interpreter implements itself, their names (see
+  // mobile::Function)
+  std::vector<std::string> operators;
+  std::vector<IValue> constants;
+  int64_t register_size = 0;
+  int64_t num_outputs = 0;
+
+  // The code as a tuple of lists, ints and strings, as it is pickled into
+  // bytecode.pkl. Constant tensors are left to the pickler's tensor table.
+  IValue toIValue() const;
+  static Bytecode fromIValue(const IValue& value);
+};
+
+// Bumped whenever the layout of the tuples or the meaning of an opcode
+// changes.
+constexpr int64_t kBytecodeVersion = 1;
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
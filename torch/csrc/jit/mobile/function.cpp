@@ -0,0 +1,222 @@
+#include <torch/csrc/jit/mobile/function.h>
+
+#include <torch/csrc/jit/mobile/interpreter.h>
+#include <torch/csrc/jit/operator.h>
+
+#include <functional>
+#include <unordered_map>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+namespace {
+
+template <typename T>
+Operation listConstruct(size_t num_inputs) {
+  return [=](Stack& stack) {
+    std::vector<T> elems;
+    elems.reserve(num_inputs);
+    for (size_t i = stack.size() - num_inputs; i < stack.size(); ++i) {
+      elems.push_back(std::move(stack[i]).to<T>());
+    }
+    drop(stack, num_inputs);
+    push(stack, std::move(elems));
+    return 0;
+  };
+}
+
+template <typename T, const std::vector<T>& (IValue::*Elements)() const>
+Operation listUnpack(size_t num_outputs) {
+  return [=](Stack& stack) {
+    IValue list = pop(stack);
+    const std::vector<T>& elems = (list.*Elements)();
+    AT_CHECK(
+        elems.size() == num_outputs,
+        "Expected ",
+        num_outputs,
+        " elements in a list but found ",
+        elems.size());
+    stack.insert(stack.end(), elems.begin(), elems.end());
+    return 0;
+  };
+}
+
+Operation noop(size_t, size_t) {
+  return [](Stack& stack) { return 0; };
+}
+
+// The variadic primitives, which the operator registry creates for their
+// nodes, made from the numbers of inputs and outputs of their instructions.
+// Their names are those given by bytecodeOperatorName in interpreter.cpp.
+using PrimitiveCreator =
+    std::function<Operation(size_t num_inputs, size_t num_outputs)>;
+
+const std::unordered_map<std::string, PrimitiveCreator>& primitives() {
+  static const std::unordered_map<std::string, PrimitiveCreator> creators = {
+      {"prim::Load", noop},
+      {"prim::Store", noop},
+      {"prim::TupleConstruct",
+       [](size_t num_inputs, size_t) -> Operation {
+         return [=](Stack& stack) {
+           std::vector<IValue> elems{
+               std::make_move_iterator(stack.end() - num_inputs),
+               std::make_move_iterator(stack.end())};
+           drop(stack, num_inputs);
+           push(stack, c10::ivalue::Tuple::create(std::move(elems)));
+           return 0;
+         };
+       }},
+      {"prim::TupleUnpack",
+       [](size_t, size_t num_outputs) -> Operation {
+         return [=](Stack& stack) {
+           auto tuple = pop(stack).toTuple();
+           const auto& elems = tuple->elements();
+           AT_CHECK(
+               elems.size() == num_outputs,
+               "Expected a tuple of ",
+               num_outputs,
+               " elements, but got ",
+               elems.size());
+           stack.insert(stack.end(), elems.begin(), elems.end());
+           return 0;
+         };
+       }},
+      {"prim::TupleIndex",
+       [](size_t, size_t) -> Operation {
+         return [](Stack& stack) {
+           int64_t index = pop(stack).toInt();
+           auto tuple = pop(stack).toTuple();
+           const auto& elems = tuple->elements();
+           const int64_t size = elems.size();
+           if (index < 0) {
+             index += size;
+           }
+           if (index < 0 || index >= size) {
+             throw std::out_of_range("Tuple list index out of range");
+           }
+           stack.emplace_back(elems[index]);
+           return 0;
+         };
+       }},
+      {"prim::ListConstruct.int",
+       [](size_t num_inputs, size_t) {
+         return listConstruct<int64_t>(num_inputs);
+       }},
+      {"prim::ListConstruct.float",
+       [](size_t num_inputs, size_t) {
+         return listConstruct<double>(num_inputs);
+       }},
+      {"prim::ListConstruct.bool",
+       [](size_t num_inputs, size_t) {
+         return listConstruct<bool>(num_inputs);
+       }},
+      {"prim::ListConstruct.Tensor",
+       [](size_t num_inputs, size_t) {
+         return listConstruct<at::Tensor>(num_inputs);
+       }},
+      {"prim::ListConstruct.generic",
+       [](size_t num_inputs, size_t) -> Operation {
+         return [=](Stack& stack) {
+           std::vector<IValue> elems{
+               std::make_move_iterator(stack.end() - num_inputs),
+               std::make_move_iterator(stack.end())};
+           drop(stack, num_inputs);
+           push(stack, std::move(elems));
+           return 0;
+         };
+       }},
+      {"prim::ListUnpack.int",
+       [](size_t, size_t num_outputs) {
+         return listUnpack<int64_t, &IValue::toIntListRef>(num_outputs);
+       }},
+      {"prim::ListUnpack.float",
+       [](size_t, size_t num_outputs) {
+         return listUnpack<double, &IValue::toDoubleListRef>(num_outputs);
+       }},
+      {"prim::ListUnpack.bool",
+       [](size_t, size_t num_outputs) {
+         return listUnpack<bool, &IValue::toBoolListRef>(num_outputs);
+       }},
+      {"prim::ListUnpack.Tensor",
+       [](size_t, size_t num_outputs) {
+         return listUnpack<at::Tensor, &IValue::toTensorListRef>(num_outputs);
+       }},
+      {"prim::ListUnpack.generic",
+       [](size_t, size_t num_outputs) {
+         return listUnpack<IValue, &IValue::toGenericListRef>(num_outputs);
+       }},
+  };
+  return creators;
+}
+
+// The operator of the registry whose canonical schema string is name.
+Operation findOperation(const std::string& name) {
+  const auto paren = name.find('(');
+  AT_CHECK(
+      paren != std::string::npos,
+      "unknown operator ",
+      name,
+      " in bytecode");
+  const auto symbol = Symbol::fromQualString(name.substr(0, paren));
+  for (const auto& op : getAllOperatorsFor(symbol)) {
+    if (op->hasOperation() && canonicalSchemaString(op->schema()) == name) {
+      return op->getOperation();
+    }
+  }
+  AT_ERROR("unknown operator ", name, " in bytecode");
+}
+
+} // namespace
+
+Function::Function(std::string name, size_t num_inputs, Bytecode code)
+    : name_(std::move(name)),
+      num_inputs_(num_inputs),
+      code_(std::move(code)),
+      operations_(code_.instructions.size()) {
+  std::unordered_map<int64_t, Operation> found;
+  for (size_t pc = 0; pc < code_.instructions.size(); ++pc) {
+    const Bytecode::Instruction& inst = code_.instructions[pc];
+    for (int64_t reg : inst.inputs) {
+      AT_CHECK(
+          reg >= 0 && reg < code_.register_size,
+          "register index out of range in bytecode");
+    }
+    for (int64_t reg : inst.outputs) {
+      AT_CHECK(
+          reg >= 0 && reg < code_.register_size,
+          "register index out of range in bytecode");
+    }
+    if (inst.op == LOADC) {
+      AT_CHECK(
+          inst.X >= 0 && inst.X < (int64_t)code_.constants.size(),
+          "constant index out of range in bytecode");
+    }
+    if (inst.op != OP) {
+      continue;
+    }
+    AT_CHECK(
+        inst.X >= 0 && inst.X < (int64_t)code_.operators.size(),
+        "operator index out of range in bytecode");
+    const std::string& op_name = code_.operators[inst.X];
+    auto primitive = primitives().find(op_name);
+    if (primitive != primitives().end()) {
+      operations_[pc] =
+          primitive->second(inst.inputs.size(), inst.outputs.size());
+      continue;
+    }
+    auto it = found.find(inst.X);
+    if (it == found.end()) {
+      it = found.emplace(inst.X, findOperation(op_name)).first;
+    }
+    operations_[pc] = it->second;
+  }
+}
+
+void Function::run(Stack& stack) const {
+  InterpreterState(*this).run(stack);
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
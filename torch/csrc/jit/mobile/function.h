@@ -0,0 +1,49 @@
+#pragma once
+
+#include <ATen/core/stack.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/mobile/bytecode.h>
+
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// A method loaded from bytecode, its operators resolved to the Operations of
+// the operator registry when it is created.
+class TORCH_API Function {
+ public:
+  Function(std::string name, size_t num_inputs, Bytecode code);
+
+  const std::string& name() const {
+    return name_;
+  }
+  // the inputs the caller passes; the values of the module's slots the
+  // method uses follow them on the stack
+  size_t num_inputs() const {
+    return num_inputs_;
+  }
+  const Bytecode& code() const {
+    return code_;
+  }
+  // the Operation of each OP instruction, by instruction
+  const std::vector<Operation>& operations() const {
+    return operations_;
+  }
+
+  // Runs the method on the inputs on the stack, replacing them by its
+  // outputs.
+  void run(Stack& stack) const;
+
+ private:
+  std::string name_;
+  size_t num_inputs_;
+  Bytecode code_;
+  std::vector<Operation> operations_;
+};
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,121 @@
+#include <torch/csrc/jit/mobile/import.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/mobile/bytecode.h>
+#include <torch/csrc/jit/pickler.h>
+
+#include "caffe2/serialize/inline_container.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+using caffe2::serialize::PyTorchStreamReader;
+using caffe2::serialize::ReadAdapterInterface;
+
+namespace {
+
+// Reads bytecode.pkl and bytecode_tensors.pkl, the records ExportModule
+// writes with bytecode_format, out of the archive.
+class BytecodeDeserializer final {
+ public:
+  explicit BytecodeDeserializer(std::unique_ptr<ReadAdapterInterface> rai)
+      : reader_(std::move(rai)) {}
+  explicit BytecodeDeserializer(std::istream* in) : reader_(in) {}
+  explicit BytecodeDeserializer(const std::string& filename)
+      : reader_(filename) {}
+
+  Module deserialize();
+
+ private:
+  std::vector<IValue> readPickle(
+      const std::string& name,
+      const std::vector<at::Tensor>* tensor_table);
+  void loadTensorTable();
+
+  PyTorchStreamReader reader_;
+  std::vector<at::Tensor> tensor_table_;
+};
+
+std::vector<IValue> BytecodeDeserializer::readPickle(
+    const std::string& name,
+    const std::vector<at::Tensor>* tensor_table) {
+  at::DataPtr data;
+  size_t size;
+  std::tie(data, size) = reader_.getRecord(name);
+  Unpickler unpickler(data.get(), size, tensor_table);
+  return unpickler.parse_ivalue_list();
+}
+
+void BytecodeDeserializer::loadTensorTable() {
+  // tensors may share storages, each of which is read once
+  std::unordered_map<std::string, at::Storage> storages;
+  for (const IValue& value : readPickle("bytecode_tensors.pkl", nullptr)) {
+    const auto& fields = value.toTuple()->elements();
+    AT_CHECK(fields.size() == 5, "malformed tensor in bytecode_tensors.pkl");
+    const std::string& key = fields[0].toStringRef();
+    const auto type = static_cast<at::ScalarType>(fields[1].toInt());
+    auto storage_it = storages.find(key);
+    if (storage_it == storages.end()) {
+      at::DataPtr storage_ptr;
+      size_t record_size;
+      std::tie(storage_ptr, record_size) = reader_.getRecord(key);
+      const auto& meta = at::CPU(type).typeMeta();
+      at::Storage storage(
+          meta,
+          record_size / meta.itemsize(),
+          std::move(storage_ptr),
+          /*allocator=*/nullptr,
+          /*resizable=*/false);
+      storage_it = storages.emplace(key, std::move(storage)).first;
+    }
+    at::Tensor tensor = at::empty({0}, at::CPU(type).options())
+                            .set_(
+                                storage_it->second,
+                                fields[4].toInt(),
+                                fields[2].toIntListRef(),
+                                fields[3].toIntListRef());
+    tensor_table_.push_back(
+        autograd::make_variable(tensor, /*requires_grad=*/false));
+  }
+}
+
+Module BytecodeDeserializer::deserialize() {
+  loadTensorTable();
+  Module module;
+  for (const IValue& value : readPickle("bytecode.pkl", &tensor_table_)) {
+    const auto& fields = value.toTuple()->elements();
+    AT_CHECK(fields.size() == 4, "malformed method in bytecode.pkl");
+    auto function = std::unique_ptr<Function>(new Function(
+        fields[0].toStringRef(),
+        fields[1].toInt(),
+        Bytecode::fromIValue(fields[2])));
+    module.add_method(std::move(function), fields[3].toGenericListRef());
+  }
+  return module;
+}
+
+} // namespace
+
+Module _load_for_mobile(std::istream& in) {
+  BytecodeDeserializer deserializer(&in);
+  return deserializer.deserialize();
+}
+
+Module _load_for_mobile(const std::string& filename) {
+  BytecodeDeserializer deserializer(filename);
+  return deserializer.deserialize();
+}
+
+Module _load_for_mobile(std::unique_ptr<ReadAdapterInterface> rai) {
+  BytecodeDeserializer deserializer(std::move(rai));
+  return deserializer.deserialize();
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <torch/csrc/jit/mobile/module.h>
+
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace caffe2 {
+namespace serialize {
+class ReadAdapterInterface;
+} // namespace serialize
+} // namespace caffe2
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+/// Loads the bytecode of a module saved with `_save_for_mobile` in Python or
+/// `script::Module::_save_for_mobile` in C++.
+///
+/// Unlike `torch::jit::load`, this neither parses model.json nor compiles
+/// the code of the module: it only unpickles the bytecode of the methods,
+/// looks up their operators, and loads the tensors, on the CPU and without
+/// requiring grad.
+TORCH_API Module _load_for_mobile(std::istream& in);
+
+TORCH_API Module _load_for_mobile(const std::string& filename);
+
+TORCH_API Module _load_for_mobile(
+    std::unique_ptr<caffe2::serialize::ReadAdapterInterface> rai);
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
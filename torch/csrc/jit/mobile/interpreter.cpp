@@ -0,0 +1,193 @@
+#include <torch/csrc/jit/mobile/interpreter.h>
+
+#include <stdexcept>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+namespace {
+
+// Constants of mutable types are loaded as copies, as the full runtime
+// creates them anew on every run, so that a method mutating its list
+// doesn't change the constant.
+IValue loadConstant(const IValue& constant) {
+  if (constant.isIntList()) {
+    return constant.toIntListRef();
+  } else if (constant.isDoubleList()) {
+    return constant.toDoubleListRef();
+  } else if (constant.isBoolList()) {
+    return constant.toBoolListRef();
+  } else if (constant.isTensorList()) {
+    return constant.toTensorListRef();
+  } else if (constant.isGenericList()) {
+    return constant.toGenericListRef();
+  }
+  return constant;
+}
+
+} // namespace
+
+InterpreterState::InterpreterState(const Function& function)
+    : function_(function), registers_(function.code().register_size) {}
+
+void InterpreterState::run(Stack& stack) {
+  const Bytecode& code = function_.code();
+  const auto& instructions = code.instructions;
+  const auto& operations = function_.operations();
+  size_t pc = 0;
+  while (pc < instructions.size()) {
+    const Bytecode::Instruction& inst = instructions[pc];
+    switch (inst.op) {
+      case OP: {
+        loadInputs(inst, stack);
+        size_t new_pc = pc + 1 + operations[pc](stack);
+        storeOutputs(inst, stack);
+        pc = new_pc;
+      } break;
+      case ASSIGN:
+        loadInputs(inst, stack);
+        storeOutputs(inst, stack);
+        ++pc;
+        break;
+      case DROP:
+        releaseInputs(inst);
+        ++pc;
+        break;
+      case LOADC:
+        output(inst) = loadConstant(code.constants[inst.X]);
+        ++pc;
+        break;
+      case JF:
+        pc += 1 + (popCondition(inst, stack) ? 0 : inst.X);
+        break;
+      case JT:
+        pc += 1 + (popCondition(inst, stack) ? inst.X : 0);
+        break;
+      case JMP:
+        pc += 1 + inst.X;
+        break;
+      case INT_ADD:
+        output(inst) = input(inst, 0).toInt() + input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_SUB:
+        output(inst) = input(inst, 0).toInt() - input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_MUL:
+        output(inst) = input(inst, 0).toInt() * input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_LT:
+        output(inst) = input(inst, 0).toInt() < input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_GT:
+        output(inst) = input(inst, 0).toInt() > input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_LE:
+        output(inst) = input(inst, 0).toInt() <= input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_GE:
+        output(inst) = input(inst, 0).toInt() >= input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_EQ:
+        output(inst) = input(inst, 0).toInt() == input(inst, 1).toInt();
+        ++pc;
+        break;
+      case INT_NE:
+        output(inst) = input(inst, 0).toInt() != input(inst, 1).toInt();
+        ++pc;
+        break;
+      case BOOL_AND:
+        output(inst) = input(inst, 0).toBool() && input(inst, 1).toBool();
+        ++pc;
+        break;
+      case BOOL_OR:
+        output(inst) = input(inst, 0).toBool() || input(inst, 1).toBool();
+        ++pc;
+        break;
+      case LIST_SELECT_INT:
+        selectFromList(inst, input(inst, 0).toIntListRef());
+        ++pc;
+        break;
+      case LIST_SELECT_FLOAT:
+        selectFromList(inst, input(inst, 0).toDoubleListRef());
+        ++pc;
+        break;
+      case LIST_SELECT_TENSOR:
+        selectFromList(inst, input(inst, 0).toTensorListRef());
+        ++pc;
+        break;
+      default:
+        AT_ERROR("unknown opcode ", static_cast<int>(inst.op), " in bytecode");
+    }
+  }
+}
+
+void InterpreterState::loadInputs(
+    const Bytecode::Instruction& inst,
+    Stack& stack) {
+  for (size_t i = 0; i < inst.inputs.size(); ++i) {
+    if (inst.free_flags[i]) {
+      stack.push_back(std::move(registers_[inst.inputs[i]]));
+    } else {
+      stack.push_back(registers_[inst.inputs[i]]);
+    }
+  }
+}
+
+void InterpreterState::storeOutputs(
+    const Bytecode::Instruction& inst,
+    Stack& stack) {
+  for (size_t i = inst.outputs.size(); i > 0; --i) {
+    registers_[inst.outputs[i - 1]] = pop(stack);
+  }
+}
+
+void InterpreterState::releaseInputs(const Bytecode::Instruction& inst) {
+  for (size_t i = 0; i < inst.inputs.size(); ++i) {
+    if (inst.free_flags[i]) {
+      registers_[inst.inputs[i]] = IValue();
+    }
+  }
+}
+
+// The condition of a branch is its input, or for the branches of loops, the
+// value the preceding assignment left on the stack.
+bool InterpreterState::popCondition(
+    const Bytecode::Instruction& inst,
+    Stack& stack) {
+  if (inst.inputs.empty()) {
+    return pop(stack).toBool();
+  }
+  bool cond = input(inst, 0).toBool();
+  releaseInputs(inst);
+  return cond;
+}
+
+template <typename T>
+void InterpreterState::selectFromList(
+    const Bytecode::Instruction& inst,
+    const std::vector<T>& list) {
+  const int64_t list_size = list.size();
+  int64_t idx = input(inst, 1).toInt();
+  if (idx < 0) {
+    idx += list_size;
+  }
+  if (idx < 0 || idx >= list_size) {
+    throw std::out_of_range("list index out of range");
+  }
+  // the element has to be copied before the list may be released
+  IValue element = list[idx];
+  releaseInputs(inst);
+  output(inst) = std::move(element);
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <torch/csrc/jit/mobile/function.h>
+
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// The state of one run of a Function. Unlike the interpreter of the full
+// runtime it runs synchronously: the bytecode has no forks and no waits.
+struct InterpreterState {
+  explicit InterpreterState(const Function& function);
+  void run(Stack& stack);
+
+ private:
+  void loadInputs(const Bytecode::Instruction& inst, Stack& stack);
+  void storeOutputs(const Bytecode::Instruction& inst, Stack& stack);
+  void releaseInputs(const Bytecode::Instruction& inst);
+  bool popCondition(const Bytecode::Instruction& inst, Stack& stack);
+  template <typename T>
+  void selectFromList(
+      const Bytecode::Instruction& inst,
+      const std::vector<T>& list);
+
+  const IValue& input(const Bytecode::Instruction& inst, size_t i) {
+    return registers_[inst.inputs[i]];
+  }
+  IValue& output(const Bytecode::Instruction& inst) {
+    return registers_[inst.outputs[0]];
+  }
+
+  const Function& function_;
+  std::vector<IValue> registers_;
+};
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
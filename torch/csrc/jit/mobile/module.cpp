@@ -0,0 +1,51 @@
+#include <torch/csrc/jit/mobile/module.h>
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/autograd/grad_mode.h>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+void Module::add_method(
+    std::unique_ptr<Function> function,
+    std::vector<IValue> slots) {
+  const std::string name = function->name();
+  AT_CHECK(!has_method(name), "method '", name, "' already defined");
+  methods_[name] = Method{std::move(function), std::move(slots)};
+}
+
+const Function& Module::get_method(const std::string& name) const {
+  auto it = methods_.find(name);
+  AT_CHECK(it != methods_.end(), "method '", name, "' is not defined");
+  return *it->second.function;
+}
+
+IValue Module::run_method(const std::string& name, std::vector<IValue> inputs)
+    const {
+  auto it = methods_.find(name);
+  AT_CHECK(it != methods_.end(), "method '", name, "' is not defined");
+  const Method& method = it->second;
+  AT_CHECK(
+      inputs.size() == method.function->num_inputs(),
+      name,
+      "() expected ",
+      method.function->num_inputs(),
+      " arguments but got ",
+      inputs.size());
+
+  autograd::AutoGradMode no_grad(false);
+  Stack stack = std::move(inputs);
+  stack.insert(stack.end(), method.slots.begin(), method.slots.end());
+  method.function->run(stack);
+  const size_t num_outputs = method.function->code().num_outputs;
+  AT_ASSERT(stack.size() == num_outputs);
+  if (num_outputs == 1) {
+    return std::move(stack.back());
+  }
+  return c10::ivalue::Tuple::create(std::move(stack));
+}
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
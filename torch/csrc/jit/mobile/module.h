@@ -0,0 +1,49 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/mobile/function.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace mobile {
+
+// A module loaded by _load_for_mobile: the methods of a script::Module with
+// the values of the parameters and attributes each of them uses. There are no
+// submodules, their methods having been inlined into the ones that call them
+// when the module was saved, and none of the compiler.
+class TORCH_API Module {
+ public:
+  Module() = default;
+  Module(Module&&) = default;
+  Module& operator=(Module&&) = default;
+
+  void add_method(std::unique_ptr<Function> function, std::vector<IValue> slots);
+
+  bool has_method(const std::string& name) const {
+    return methods_.count(name) > 0;
+  }
+  const Function& get_method(const std::string& name) const;
+
+  // Runs the method with autograd disabled, and returns its output.
+  IValue run_method(const std::string& name, std::vector<IValue> inputs) const;
+
+  IValue forward(std::vector<IValue> inputs) const {
+    return run_method("forward", std::move(inputs));
+  }
+
+ private:
+  struct Method {
+    std::unique_ptr<Function> function;
+    std::vector<IValue> slots;
+  };
+  std::unordered_map<std::string, Method> methods_;
+};
+
+} // namespace mobile
+} // namespace jit
+} // namespace torch
@@ -85,6 +85,54 @@ bool attributesEqualCSE(const Node* lhs, const Node* rhs) {
   return true;
 }
 
+// Hash of the attributes compared by attributesEqualCSE. Without it, nodes
+// that only differ in their attributes, like all the constants of a type,
+// would land in the same bucket.
+size_t hashAttributes(const Node* k) {
+  auto names = k->attributeNames();
+  std::sort(names.begin(), names.end());
+  size_t seed = 0;
+  for (auto name : names) {
+    seed = hash_combine(seed, get_hash(name, k->kindOf(name)));
+    switch (k->kindOf(name)) {
+      case AttributeKind::f:
+        seed = hash_combine(seed, get_hash(k->f(name)));
+        break;
+      case AttributeKind::fs:
+        seed = hash_combine(seed, get_hash(k->fs(name)));
+        break;
+      case AttributeKind::i:
+        seed = hash_combine(seed, get_hash(k->i(name)));
+        break;
+      case AttributeKind::is:
+        seed = hash_combine(seed, get_hash(k->is(name)));
+        break;
+      case AttributeKind::s:
+        seed = hash_combine(seed, get_hash(k->s(name)));
+        break;
+      case AttributeKind::ss:
+        seed = hash_combine(seed, get_hash(k->ss(name)));
+        break;
+      case AttributeKind::t: {
+        // equal tensors have the same type and sizes, hashing the data would
+        // cost as much as comparing it
+        const auto& t = k->t(name);
+        if (t.defined()) {
+          seed = hash_combine(seed, get_hash(t.scalar_type(), t.sizes().vec()));
+        }
+        break;
+      }
+      case AttributeKind::ts:
+        seed = hash_combine(seed, get_hash(k->ts(name).size()));
+        break;
+      case AttributeKind::g:
+      case AttributeKind::gs:
+        break;
+    }
+  }
+  return seed;
+}
+
 } // anonymous namespace
 
 size_t HashNode::operator()(const Node* k) const {
@@ -92,7 +140,8 @@ size_t HashNode::operator()(const Node* k) const {
   return get_hash(
       k->kind(),
       fmap(k->outputs(), [](const Value* v) { return v->type()->kind(); }),
-      fmap(k->inputs(), [](const Value* v) { return v->unique(); }));
+      fmap(k->inputs(), [](const Value* v) { return v->unique(); }),
+      hashAttributes(k));
 };
 
 bool EqualNode::operator()(const Node* lhs, const Node* rhs) const {
@@ -121,6 +121,12 @@ struct TORCH_API Operator {
     return op_creator_(node);
   }
 
+  // Whether the operator runs the same Operation for every node, which can
+  // then be had without a node.
+  bool hasOperation() const {
+    return op_ != nullptr;
+  }
+
   const FunctionSchema& schema() const {
     // we lazily parse schema initialized from strings so that
     // we do less work during static operator registration
@@ -237,6 +237,12 @@ ValueSet AliasDb::getReads(Node* n, bool recurseBlocks) const {
 }
 
 void AliasDb::dump() const {
+  // Elements outlive the values they were created for, if those were
+  // erased by an incremental update.
+  auto name = [](const Element* element) -> std::string {
+    return element->value ? element->value->uniqueName() : "(erased)";
+  };
+
   std::cout << "\n===1. GRAPH===\n";
   graph_->dump();
 
@@ -244,16 +250,16 @@ void AliasDb::dump() const {
   for (const auto& ptrPair : elementMap_) {
     const auto element = ptrPair.second;
     if (element->pointsTo.size() > 0) {
-      std::cout << element->value->uniqueName() << " points to: ";
+      std::cout << ptrPair.first->uniqueName() << " points to: ";
       for (const auto pointedTo : element->pointsTo) {
-        std::cout << pointedTo->value->uniqueName() << ", ";
+        std::cout << name(pointedTo) << ", ";
       }
       std::cout << "\n";
     }
     if (element->contained_elements.size() > 0) {
-      std::cout << element->value->uniqueName() << " contains: ";
+      std::cout << ptrPair.first->uniqueName() << " contains: ";
       for (const auto contained : element->contained_elements) {
-        std::cout << contained->value->uniqueName() << ", ";
+        std::cout << name(contained) << ", ";
       }
       std::cout << "\n";
     }
@@ -412,6 +418,7 @@ void AliasDb::analyzeImpl(Node* node) {
     case prim::FusedConcat:
     case prim::MMTreeReduce:
     case prim::MMBatchSide:
+    case prim::MMBatchLinear:
     case prim::BroadcastSizes:
     case prim::ChunkSizes:
     case prim::Function:
@@ -1286,6 +1293,120 @@ c10::optional<const Node*> AliasDb::getLastWildcard() const {
   }
 }
 
+void AliasDb::createValue(const Value* value) {
+  if (!shouldAnnotate(value)) {
+    return;
+  }
+  wildcards_.erase(value);
+  elementMap_[value] = memoryDAG_->makeFreshValue(value);
+}
+
+void AliasDb::copyValue(const Value* from, const Value* to) {
+  if (!shouldAnnotate(to)) {
+    return;
+  }
+  wildcards_.erase(to);
+  elementMap_.erase(to);
+  if (isWildcard(from)) {
+    wildcards_.insert(to);
+  } else if (elementMap_.count(from)) {
+    elementMap_[to] = elementMap_.at(from);
+  }
+}
+
+void AliasDb::replaceWithNewValue(
+    const Value* existing,
+    const Value* new_value) {
+  if (existing == new_value) {
+    return;
+  }
+  if (!isTracked(new_value)) {
+    copyValue(existing, new_value);
+  }
+  if (elementMap_.count(existing)) {
+    const auto element = elementMap_.at(existing);
+    if (element->value == existing) {
+      element->value = new_value;
+    }
+  }
+  for (auto& pr : writeIndex_) {
+    if (pr.second.erase(existing)) {
+      pr.second.insert(new_value);
+    }
+  }
+  elementMap_.erase(existing);
+  wildcards_.erase(existing);
+}
+
+void AliasDb::eraseValue(const Value* value) {
+  if (elementMap_.count(value)) {
+    const auto element = elementMap_.at(value);
+    if (element->value == value) {
+      element->value = nullptr;
+    }
+    elementMap_.erase(value);
+  }
+  wildcards_.erase(value);
+  for (auto& pr : writeIndex_) {
+    pr.second.erase(value);
+  }
+  isWriteCacheStale_ = true;
+}
+
+void AliasDb::replaceWithNewNode(Node* existing, Node* new_node) {
+  AT_ASSERT(existing->inputs().size() == new_node->inputs().size());
+  AT_ASSERT(existing->outputs().size() == new_node->outputs().size());
+  const auto writes = writeIndex_.find(existing);
+  if (writes != writeIndex_.end()) {
+    // The written values are the node's own inputs and outputs, so they are
+    // replaced by their partners in `new_node`.
+    ValueSet newWrites;
+    for (const auto value : writes->second) {
+      const Value* replacement = value;
+      for (size_t i = 0; i < existing->inputs().size(); i++) {
+        if (existing->inputs()[i] == value) {
+          replacement = new_node->inputs()[i];
+        }
+      }
+      for (size_t i = 0; i < existing->outputs().size(); i++) {
+        if (existing->outputs()[i] == value) {
+          replacement = new_node->outputs()[i];
+        }
+      }
+      newWrites.insert(replacement);
+    }
+    writeIndex_.erase(writes);
+    writeIndex_[new_node] = std::move(newWrites);
+    isWriteCacheStale_ = true;
+  }
+  if (wildcardWriters_.erase(existing)) {
+    wildcardWriters_.insert(new_node);
+  }
+  wildcardNodes_.erase(existing);
+  if (hasWildcard(new_node)) {
+    wildcardNodes_.insert(new_node);
+  }
+}
+
+void AliasDb::eraseNode(Node* node) {
+  if (node->hasAttribute(attr::Subgraph)) {
+    subgraphToOwner_.erase(node->g(attr::Subgraph).get());
+  }
+  if (writeIndex_.erase(node)) {
+    isWriteCacheStale_ = true;
+  }
+  wildcardWriters_.erase(node);
+  wildcardNodes_.erase(node);
+}
+
+void AliasDb::registerSubgraphNode(Node* node) {
+  subgraphToOwner_[node->g(attr::Subgraph).get()] = node;
+  wildcardNodes_.erase(node);
+  if (hasWildcard(node)) {
+    wildcardNodes_.insert(node);
+  }
+}
+
 bool aliasAnalysisHasSpecialCaseFor(Symbol symbol) {
   // WARNING: by adding a case to this list, you are asserting that you have
   // added a case for the unschematized node in AliasDb::analyze
@@ -1303,6 +1424,7 @@ bool aliasAnalysisHasSpecialCaseFor(Symbol symbol) {
       prim::GradOf,
       prim::MMTreeReduce,
       prim::MMBatchSide,
+      prim::MMBatchLinear,
       prim::BroadcastSizes,
       prim::ChunkSizes,
       prim::Function,
@@ -1350,6 +1472,7 @@ void AliasDb::setWildcard(const Value* v) {
 }
 
 void AliasDb::rebuildWriteCache() const {
+  writeCache_.clear();
   for (const auto& pr : writeIndex_) {
     const auto& writtenValues = pr.second;
 
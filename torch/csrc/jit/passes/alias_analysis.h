@@ -121,6 +121,35 @@ class AliasDb {
   bool couldMoveAfterTopologically(Node* n, Node* movePoint);
   bool couldMoveBeforeTopologically(Node* n, Node* movePoint);
 
+  /**
+   * Incremental updates
+   *
+   * Passes that restructure the graph without changing what it computes
+   * (e.g. moving nodes into and out of subgraphs) can keep the AliasDb in
+   * sync through these instead of rebuilding it after every change.
+   */
+  // Give `value` a fresh memory location, as for a newly created tensor.
+  TORCH_API void createValue(const Value* value);
+  // Make `to` share the memory locations (or wildcard-ness) of `from`.
+  TORCH_API void copyValue(const Value* from, const Value* to);
+  // `new_value` replaces `existing`, which is about to be destroyed. If
+  // `new_value` is not tracked yet, it takes over the memory locations of
+  // `existing`.
+  TORCH_API void replaceWithNewValue(
+      const Value* existing,
+      const Value* new_value);
+  // Forget `value`, which is about to be destroyed.
+  TORCH_API void eraseValue(const Value* value);
+  // `new_node` replaces `existing`, which is about to be destroyed. The two
+  // must have matching inputs and outputs, whose values have already been
+  // replaced or copied.
+  TORCH_API void replaceWithNewNode(Node* existing, Node* new_node);
+  // Forget `node`, which is about to be destroyed.
+  TORCH_API void eraseNode(Node* node);
+  // Register `node`'s subgraph as owned by it, after its nodes or values
+  // changed.
+  TORCH_API void registerSubgraphNode(Node* node);
+
   // For debugging: print alias db state to stdout
   TORCH_API void dump() const;
 
@@ -11,6 +11,7 @@
 
 #include <ATen/ATen.h>
 #include <algorithm>
+#include <sstream>
 #include <unordered_map>
 
 namespace torch {
@@ -356,33 +357,45 @@ RegisterOperators mm_batch_side_reg(
       };
     })});
 
-std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
-    Value* value,
+// Sorts nodes in topological order and drops those that depend on an earlier
+// one. This algorithm might do very badly if e.g. you have a lot of
+// independent nodes, that depend on the first one, but I doubt this will be a
+// common scenario.
+std::vector<Node*> sortAndFilterIndependent(
+    std::vector<Node*> nodes,
     AliasDb& alias_db) {
-  const auto postprocess = [&](std::vector<Node*> mms) {
-    if (mms.size() == 0) {
-      return mms;
-    }
-    std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
-      return n->isBefore(m);
-    });
-    // Filter out dependent MMs. This algorithm might do very badly if e.g. you
-    // have a lot of independent MMs, that depend on the first one, but I doubt
-    // this will be a common scenario.
-    for (size_t i = 0; i < mms.size(); ++i) {
-      if (mms[i] == nullptr)
+  if (nodes.size() == 0) {
+    return nodes;
+  }
+  std::sort(nodes.begin(), nodes.end(), [](Node* n, Node* m) {
+    return n->isBefore(m);
+  });
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    if (nodes[i] == nullptr)
+      continue;
+    for (size_t j = i + 1; j < nodes.size(); ++j) {
+      if (nodes[j] == nullptr)
         continue;
-      for (size_t j = i + 1; j < mms.size(); ++j) {
-        if (mms[j] == nullptr)
-          continue;
-        if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
-          mms[j] = nullptr;
-        }
+      if (!alias_db.couldMoveBeforeTopologically(nodes[j], nodes[i])) {
+        nodes[j] = nullptr;
       }
     }
-    return c10::filter(mms, [](Node* n) { return n != nullptr; });
-  };
+  }
+  return c10::filter(nodes, [](Node* n) { return n != nullptr; });
+}
+
+// Moves the independent nodes next to each other, right before the last one.
+void moveTogether(const std::vector<Node*>& nodes, AliasDb& alias_db) {
+  for (int64_t i = static_cast<int64_t>(nodes.size()) - 2; i >= 0; --i) {
+    bool move_ok =
+        alias_db.moveBeforeTopologicallyValid(nodes[i], nodes[i + 1]);
+    AT_ASSERT(move_ok);
+  }
+}
 
+std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
+    Value* value,
+    AliasDb& alias_db) {
   Block* block = value->node()->owningBlock();
   std::vector<Node*> lhses; // Will contain nodes where value is used as an lhs
   std::vector<Node*> rhses; // Like above, but rhs
@@ -396,7 +409,9 @@ std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
       }
     }
   }
-  return std::make_pair(postprocess(lhses), postprocess(rhses));
+  return std::make_pair(
+      sortAndFilterIndependent(lhses, alias_db),
+      sortAndFilterIndependent(rhses, alias_db));
 }
 
 void BatchMMSide(Block* block, AliasDb& alias_db) {
@@ -404,10 +419,7 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   static constexpr size_t how_many_is_many = 8;
   const auto batch_side = [&](std::vector<Node*>& mms, Side side) {
     AT_ASSERT(!mms.empty());
-    for (int64_t i = static_cast<int64_t>(mms.size()) - 2; i >= 0; --i) {
-      bool move_ok = alias_db.moveBeforeTopologicallyValid(mms[i], mms[i + 1]);
-      AT_ASSERT(move_ok);
-    }
+    moveTogether(mms, alias_db);
     WithInsertPoint insert_guard{mms[0]};
     Graph* graph = mms[0]->owningGraph();
     Node* batch_mm = graph->create(
@@ -447,6 +459,338 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+// Independent linear layers are batched too, which shows up in attention
+// (the Q/K/V projections of one input) and in multi-head or multi-task towers
+// (the same layer shape applied to different inputs side by side, or to the
+// inputs of different timesteps of an unrolled loop).
+//
+// 1. Linear layers of the same input with constant weights (and biases) are
+//    replaced by a single one, whose weight is the concatenation of all the
+//    weights, computed once here, followed by a split of its output:
+//
+//      linear(x, W1, b1), linear(x, W2, b2)
+//        ==> split(linear(x, cat(W1, W2), cat(b1, b2)), [out1, out2], -1)
+//
+// 2. Linear layers with different inputs and weights whose shapes are known
+//    to match from shape analysis are replaced by a prim::MMBatchLinear, which
+//    stacks the inputs and the weights and does a single bmm. The shapes are
+//    checked again at runtime, where the layers are computed one by one
+//    instead if they don't match.
+
+// Tunable parameters, like min_fusion_size.
+static constexpr size_t min_shared_input_linears = 2;
+static constexpr size_t min_independent_linears = 4;
+
+// A node computing input.matmul(weight^T) + bias for aten::linear, or
+// input.matmul(weight) + bias for aten::addmm, aten::mm and aten::matmul.
+// bias is nullptr if there is none.
+struct LinearOperands {
+  Node* node;
+  Value* input;
+  Value* weight;
+  Value* bias;
+  bool weight_transposed;
+};
+
+c10::optional<LinearOperands> matchLinear(Node* n) {
+  if (n->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+    Value* bias = n->input(2)->mustBeNone() ? nullptr : n->input(2);
+    return LinearOperands{n, n->input(0), n->input(1), bias, true};
+  }
+  if (n->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor",
+          /*const_inputs=*/{attr::beta, attr::alpha})) {
+    if (n->get<at::Scalar>(attr::alpha)->toDouble() != 1.0 ||
+        n->get<at::Scalar>(attr::beta)->toDouble() != 1.0) {
+      return c10::nullopt;
+    }
+    return LinearOperands{n, n->input(1), n->input(2), n->input(0), false};
+  }
+  if (n->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor") ||
+      n->matches("aten::matmul(Tensor self, Tensor other) -> Tensor")) {
+    return LinearOperands{n, n->input(0), n->input(1), nullptr, false};
+  }
+  return c10::nullopt;
+}
+
+c10::optional<at::Tensor> constantTensor(Value* v) {
+  if (v->node()->kind() != prim::Constant) {
+    return c10::nullopt;
+  }
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  return ival->toTensor();
+}
+
+// The constant weight of a linear layer, as an (out_features, in_features)
+// matrix, and its bias, a vector of out_features elements or undefined.
+c10::optional<std::pair<at::Tensor, at::Tensor>> constantLinearParams(
+    const LinearOperands& linear) {
+  // a traced nn.Linear transposes its weight in the graph
+  bool transposed = linear.weight_transposed;
+  Value* weight_value = linear.weight;
+  if (weight_value->node()->matches("aten::t(Tensor self) -> Tensor")) {
+    weight_value = weight_value->node()->input();
+    transposed = !transposed;
+  }
+  auto weight = constantTensor(weight_value);
+  if (!weight || weight->dim() != 2) {
+    return c10::nullopt;
+  }
+  at::Tensor w = transposed ? *weight : weight->t();
+  at::Tensor b;
+  if (linear.bias) {
+    auto bias = constantTensor(linear.bias);
+    // addmm may also broadcast a matrix, which no longer is a bias
+    if (!bias || bias->dim() != 1 || bias->size(0) != w.size(0) ||
+        bias->scalar_type() != w.scalar_type() ||
+        bias->device() != w.device()) {
+      return c10::nullopt;
+    }
+    b = *bias;
+  }
+  return std::make_pair(w, b);
+}
+
+void batchSharedInputLinears(
+    Graph* graph,
+    Value* input,
+    const std::vector<LinearOperands>& linears) {
+  std::vector<at::Tensor> weights;
+  std::vector<at::Tensor> biases;
+  std::vector<int64_t> split_sizes;
+  bool has_bias = false;
+  for (const LinearOperands& linear : linears) {
+    auto params = *constantLinearParams(linear);
+    weights.push_back(params.first);
+    biases.push_back(params.second);
+    split_sizes.push_back(params.first.size(0));
+    has_bias |= params.second.defined();
+  }
+  if (has_bias) {
+    for (size_t i = 0; i < biases.size(); ++i) {
+      if (!biases[i].defined()) {
+        biases[i] = at::zeros({split_sizes[i]}, weights[i].options());
+      }
+    }
+  }
+
+  // the nodes all use `input`, so the batched one can replace the first
+  Node* first = linears[0].node;
+  for (const LinearOperands& linear : linears) {
+    if (linear.node->isBefore(first)) {
+      first = linear.node;
+    }
+  }
+  WithInsertPoint insert_guard{first};
+  Value* weight = graph->insertConstant(at::cat(weights, /*dim=*/0));
+  Value* bias = has_bias
+      ? graph->insertConstant(at::cat(biases, /*dim=*/0))
+      : graph->insertNode(graph->createNone(TensorType::get()))->output();
+  Value* output = graph->insert(aten::linear, {input, weight, bias});
+  Value* outputs = graph->insert(
+      aten::split_with_sizes, {output, split_sizes, static_cast<int64_t>(-1)});
+  Node* unpack =
+      graph->insertNode(graph->createListUnpack(outputs, linears.size()));
+  for (size_t i = 0; i < linears.size(); ++i) {
+    unpack->outputs().at(i)->setType(linears[i].node->output()->type());
+    linears[i].node->output()->replaceAllUsesWith(unpack->outputs().at(i));
+  }
+}
+
+void BatchLinearSharedInput(Block* block) {
+  // in the order of the first use of the input, to be deterministic
+  std::vector<Value*> inputs;
+  std::unordered_map<Value*, std::vector<LinearOperands>> linears_of_input;
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      BatchLinearSharedInput(subblock);
+    }
+    auto linear = matchLinear(node);
+    if (!linear || !constantLinearParams(*linear)) {
+      continue;
+    }
+    auto& linears = linears_of_input[linear->input];
+    if (linears.empty()) {
+      inputs.push_back(linear->input);
+    }
+    linears.push_back(*linear);
+  }
+
+  Graph* graph = block->owningGraph();
+  for (Value* input : inputs) {
+    // only weights of the same type and number of input features can be
+    // concatenated; group them by the first such weight
+    std::vector<LinearOperands> linears = linears_of_input[input];
+    while (linears.size() >= min_shared_input_linears) {
+      at::Tensor reference = constantLinearParams(linears[0])->first;
+      std::vector<LinearOperands> same, rest;
+      for (const LinearOperands& linear : linears) {
+        at::Tensor w = constantLinearParams(linear)->first;
+        bool matches = w.size(1) == reference.size(1) &&
+            w.scalar_type() == reference.scalar_type() &&
+            w.device() == reference.device();
+        (matches ? same : rest).push_back(linear);
+      }
+      if (same.size() >= min_shared_input_linears) {
+        batchSharedInputLinears(graph, input, same);
+      }
+      linears = std::move(rest);
+    }
+  }
+}
+
+bool can_batch_linears(
+    at::TensorList inputs,
+    at::TensorList weights,
+    at::TensorList biases) {
+  const auto same_type = [](at::TensorList tensors) {
+    return std::all_of(
+        tensors.begin(), tensors.end(), [&](const at::Tensor& t) {
+          return t.type() == tensors[0].type();
+        });
+  };
+  if (inputs[0].dim() != 2 || weights[0].dim() != 2 ||
+      !have_same_shape(inputs) || !have_same_shape(weights) ||
+      !same_type(inputs) || !same_type(weights) ||
+      inputs[0].type() != weights[0].type()) {
+    return false;
+  }
+  if (!biases[0].defined()) {
+    return std::none_of(biases.begin(), biases.end(), [](const at::Tensor& t) {
+      return t.defined();
+    });
+  }
+  return std::all_of(biases.begin(), biases.end(), [&](const at::Tensor& t) {
+    return t.defined() && t.dim() == 1 && t.size(0) == weights[0].size(1) &&
+        t.type() == weights[0].type();
+  });
+}
+
+// Inputs are the inputs, weights and biases (or None) of num_outputs linear
+// layers, in three consecutive groups.
+RegisterOperators mm_batch_linear_reg(
+    {Operator(prim::MMBatchLinear, [](const Node* node) {
+      size_t num_linears = node->outputs().size();
+      std::vector<int64_t> weight_transposed =
+          node->is(Symbol::attr("weight_transposed"));
+      return [num_linears, weight_transposed](Stack& stack) {
+        std::vector<at::Tensor> inputs, weights, biases, rhses;
+        auto args = last(stack, 3 * num_linears);
+        for (size_t i = 0; i < num_linears; ++i) {
+          inputs.push_back(args[i].toTensor());
+          weights.push_back(args[num_linears + i].toTensor());
+          const IValue& bias = args[2 * num_linears + i];
+          biases.push_back(bias.isNone() ? at::Tensor() : bias.toTensor());
+          rhses.push_back(
+              weight_transposed[i] ? weights.back().t() : weights.back());
+        }
+        drop(stack, 3 * num_linears);
+
+        if (can_batch_linears(inputs, rhses, biases)) {
+          auto lhs = at::stack(inputs);
+          auto rhs = at::stack(rhses);
+          auto out = biases[0].defined()
+              ? at::baddbmm(at::stack(biases).unsqueeze(1), lhs, rhs)
+              : at::bmm(lhs, rhs);
+          auto outputs = out.unbind(0);
+          stack.insert(
+              stack.end(),
+              std::make_move_iterator(outputs.begin()),
+              std::make_move_iterator(outputs.end()));
+        } else {
+          for (size_t i = 0; i < num_linears; ++i) {
+            if (weight_transposed[i]) {
+              stack.emplace_back(at::linear(inputs[i], weights[i], biases[i]));
+            } else if (biases[i].defined()) {
+              stack.emplace_back(at::addmm(biases[i], inputs[i], weights[i]));
+            } else {
+              stack.emplace_back(inputs[i].matmul(weights[i]));
+            }
+          }
+        }
+        return 0;
+      };
+    })});
+
+// The layers of a batch need to agree on the sizes shape analysis found for
+// their inputs and (transposed) weights, on the type of both, and on whether
+// they have a bias. Layers whose types are not complete are left alone.
+c10::optional<std::string> independentLinearKey(const LinearOperands& linear) {
+  auto input = linear.input->type()->cast<CompleteTensorType>();
+  auto weight = linear.weight->type()->cast<CompleteTensorType>();
+  if (!input || !weight || input->dim() != 2 || weight->dim() != 2) {
+    return c10::nullopt;
+  }
+  std::vector<int64_t> weight_sizes = weight->sizes();
+  if (linear.weight_transposed) {
+    std::swap(weight_sizes[0], weight_sizes[1]);
+  }
+  std::ostringstream key;
+  key << *input << " " << weight->scalarType() << " " << weight->device()
+      << " " << at::IntArrayRef(weight_sizes) << " " << (linear.bias != nullptr);
+  return key.str();
+}
+
+void BatchLinearIndependent(Block* block, AliasDb& alias_db) {
+  std::vector<std::string> keys;
+  std::unordered_map<std::string, std::vector<Node*>> nodes_of_key;
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      BatchLinearIndependent(subblock, alias_db);
+    }
+    // nodes replaced by the other batching transformations have no uses
+    auto linear = matchLinear(node);
+    if (!linear || node->output()->uses().empty()) {
+      continue;
+    }
+    if (auto key = independentLinearKey(*linear)) {
+      auto& nodes = nodes_of_key[*key];
+      if (nodes.empty()) {
+        keys.push_back(*key);
+      }
+      nodes.push_back(node);
+    }
+  }
+
+  Graph* graph = block->owningGraph();
+  for (const std::string& key : keys) {
+    auto nodes = sortAndFilterIndependent(nodes_of_key[key], alias_db);
+    if (nodes.size() < min_independent_linears) {
+      continue;
+    }
+    moveTogether(nodes, alias_db);
+    WithInsertPoint insert_guard{nodes[0]};
+    auto linears = fmap(nodes, [](Node* n) { return *matchLinear(n); });
+    Value* none = nullptr;
+    if (!linears[0].bias) {
+      none = graph->insertNode(graph->createNone(TensorType::get()))->output();
+    }
+    Node* batch_linear = graph->create(
+        prim::MMBatchLinear, /*inputs=*/{}, /*num_outputs=*/nodes.size());
+    graph->insertNode(batch_linear);
+    std::vector<int64_t> weight_transposed;
+    for (const LinearOperands& linear : linears) {
+      batch_linear->addInput(linear.input);
+      weight_transposed.push_back(linear.weight_transposed);
+    }
+    for (const LinearOperands& linear : linears) {
+      batch_linear->addInput(linear.weight);
+    }
+    for (const LinearOperands& linear : linears) {
+      batch_linear->addInput(linear.bias ? linear.bias : none);
+    }
+    batch_linear->is_(Symbol::attr("weight_transposed"), weight_transposed);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      batch_linear->outputs().at(i)->setType(nodes[i]->output()->type());
+      nodes[i]->output()->replaceAllUsesWith(batch_linear->outputs().at(i));
+    }
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -464,9 +808,11 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
     // TODO(suo): make BatchMM mutability-safe
     return;
   }
+  BatchLinearSharedInput(graph->block());
   AliasDb alias_db(graph);
   BatchMMTreeReduce(graph->block());
   BatchMMSide(graph->block(), alias_db);
+  BatchLinearIndependent(graph->block(), alias_db);
   EliminateDeadCode(graph);
   // It's possible that transpose rearrangements have created sequences of
   // consecutive transposes that didn't exist before.
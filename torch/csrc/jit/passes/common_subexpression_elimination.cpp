@@ -4,7 +4,8 @@
 #include <torch/csrc/jit/node_hashing.h>
 #include <torch/csrc/jit/passes/alias_analysis.h>
 
-#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace torch {
 namespace jit {
@@ -12,11 +13,15 @@ namespace {
 
 // The function implements common subexpression elimination.
 // Since the nodes are visited in topological order, one pass is enough.
+//
+// `subexprs` holds the nodes visible from `block`, i.e. those of `block` and
+// of the blocks enclosing it, so every node is looked up once whatever its
+// nesting depth. The nodes of `block` are removed again when leaving it.
 void EliminateCommonSubexpression(
     Block* block,
     const AliasDb& aliasDb,
-    std::function<Node*(Node*)> parent_lookup_fn) {
-  std::unordered_set<Node*, HashNode, EqualNode> subexprs;
+    std::unordered_set<Node*, HashNode, EqualNode>& subexprs) {
+  std::vector<Node*> scope;
   for (auto it = block->nodes().begin(); it != block->nodes().end(); ++it) {
     auto node = *it;
     if (node->hasSideEffects() || node->isNondeterministic() ||
@@ -28,44 +33,23 @@ void EliminateCommonSubexpression(
     if (!node->blocks().empty()) {
       // Traverse sub-blocks.
       for (auto block : node->blocks()) {
-        EliminateCommonSubexpression(block, aliasDb, [&](Node* n) {
-          auto existing = subexprs.find(n);
-          if (existing != subexprs.end()) {
-            return *existing;
-          }
-
-          return parent_lookup_fn(n);
-        });
-      }
-
-      continue;
-    }
-
-    // Check for CSE opportunities in the parent block.
-    auto parent_lookup = parent_lookup_fn(node);
-    auto g_out = node->owningGraph()->outputs();
-    if (parent_lookup) {
-      // since the graph outputs may be mutated after they are returned,
-      // don't introduce new aliasing among graph outputs
-      if (aliasDb.mayContainAlias(node->outputs(), g_out) &&
-          aliasDb.mayContainAlias(parent_lookup->outputs(), g_out)) {
-        continue;
+        EliminateCommonSubexpression(block, aliasDb, subexprs);
       }
 
-      node->replaceAllUsesWith(parent_lookup);
-      it.destroyCurrent();
       continue;
     }
 
-    // Check whether the same subexpression already exists.
+    // Check whether the same subexpression already exists, here or in a
+    // parent block.
     auto subit = subexprs.insert(node);
     if (!subit.second) {
       // Subexpression exists, replace the uses of node, and destroy it.
       auto existing = *subit.first;
 
+      // since the graph outputs may be mutated after they are returned,
       // don't introduce new aliasing among graph outputs
-      if (aliasDb.mayContainAlias(
-              node->outputs(), node->owningGraph()->outputs()) &&
+      auto g_out = node->owningGraph()->outputs();
+      if (aliasDb.mayContainAlias(node->outputs(), g_out) &&
           aliasDb.mayContainAlias(existing->outputs(), g_out)) {
         continue;
       }
@@ -73,15 +57,21 @@ void EliminateCommonSubexpression(
       node->replaceAllUsesWith(existing);
       // Destroy the node.
       it.destroyCurrent();
+      continue;
     }
+    scope.push_back(node);
+  }
+
+  for (auto node : scope) {
+    subexprs.erase(node);
   }
 }
 } // namespace
 
 void EliminateCommonSubexpression(std::shared_ptr<Graph>& graph) {
   AliasDb aliasDb(graph);
-  EliminateCommonSubexpression(
-      graph->block(), aliasDb, [](Node*) { return nullptr; });
+  std::unordered_set<Node*, HashNode, EqualNode> subexprs;
+  EliminateCommonSubexpression(graph->block(), aliasDb, subexprs);
 }
 } // namespace jit
 } // namespace torch
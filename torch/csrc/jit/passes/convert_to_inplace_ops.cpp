@@ -0,0 +1,243 @@
+#include <torch/csrc/jit/passes/convert_to_inplace_ops.h>
+
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Elementwise ops whose result has the sizes and scalar type of `self` when
+// their other tensor operands, if any, broadcast to `self`.
+bool isElementwise(const Node* n) {
+  static const std::unordered_set<Symbol> ops = {
+      aten::add,
+      aten::sub,
+      aten::mul,
+      aten::div,
+      aten::relu,
+      aten::sigmoid,
+      aten::tanh,
+      aten::hardtanh,
+      aten::clamp,
+      aten::threshold,
+      aten::leaky_relu,
+      aten::elu,
+  };
+  return ops.count(n->kind()) != 0;
+}
+
+// Ops that always return a newly allocated tensor. Alias analysis would also
+// consider fresh the results of unannotated ops that may return their input,
+// like aten::contiguous or aten::dropout in eval mode, which must not be
+// written to.
+bool allocatesOutput(const Node* n) {
+  static const std::unordered_set<Symbol> ops = {
+      aten::_convolution,
+      aten::conv1d,
+      aten::conv2d,
+      aten::conv3d,
+      aten::mkldnn_convolution,
+      aten::batch_norm,
+      aten::instance_norm,
+      aten::layer_norm,
+      aten::linear,
+      aten::addmm,
+      aten::mm,
+      aten::matmul,
+      aten::mkl_linear_packed_weight,
+      aten::max_pool2d,
+      aten::avg_pool2d,
+      aten::adaptive_avg_pool2d,
+      aten::softmax,
+      aten::log_softmax,
+      aten::cat,
+      aten::clone,
+  };
+  return ops.count(n->kind()) != 0 || isElementwise(n);
+}
+
+// Returns the in-place variant of the operator of n: the same arguments, with
+// `self` written to and returned, or nullptr.
+std::shared_ptr<Operator> findInplaceVariant(Graph& graph, Node* n) {
+  const auto schema = n->maybeSchema();
+  if (!schema || schema->returns().size() != 1 || schema->is_vararg()) {
+    return nullptr;
+  }
+  const auto& args = schema->arguments();
+  const auto inplace_kind =
+      Symbol::fromQualString(std::string(n->kind().toQualString()) + "_");
+  for (const auto& op : getAllOperatorsFor(inplace_kind)) {
+    const auto& inplace_args = op->schema().arguments();
+    if (inplace_args.size() != args.size() || inplace_args.empty() ||
+        !inplace_args[0].alias_info() ||
+        !inplace_args[0].alias_info()->isWrite()) {
+      continue;
+    }
+    bool same_args = true;
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (inplace_args[i].name() != args[i].name() ||
+          *inplace_args[i].type() != *args[i].type()) {
+        same_args = false;
+        break;
+      }
+    }
+    if (!same_args) {
+      continue;
+    }
+    // make sure the interpreter selects this overload
+    auto trial = graph.create(inplace_kind, n->inputs(), 1);
+    trial->output()->setType(n->output()->type());
+    const bool selected = findOperatorFor(trial) == op;
+    trial->destroy();
+    if (selected) {
+      return op;
+    }
+  }
+  return nullptr;
+}
+
+// Without sizes, only ops whose other operands are all scalars are known to
+// produce a result of the sizes of `self`.
+bool resultHasSizesOfSelf(const Node* n) {
+  bool scalar_operands = true;
+  for (size_t i = 1; i < n->inputs().size(); ++i) {
+    if (n->input(i)->type()->isSubtypeOf(TensorType::get())) {
+      scalar_operands = false;
+    }
+  }
+  if (scalar_operands) {
+    return true;
+  }
+  auto self = n->input(0)->type()->cast<CompleteTensorType>();
+  auto result = n->output()->type()->cast<CompleteTensorType>();
+  return self && result && self->sizes() == result->sizes() &&
+      self->scalarType() == result->scalarType() &&
+      self->device() == result->device();
+}
+
+class InplaceConverter {
+ public:
+  explicit InplaceConverter(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), aliasDb_(graph_) {
+    for (Value* input : graph_->inputs()) {
+      if (input->type()->isSubtypeOf(TensorType::get())) {
+        externalValues_.push_back(input);
+      }
+    }
+    collectConstants(graph_->block());
+  }
+
+  void run() {
+    run(graph_->block());
+  }
+
+ private:
+  void collectConstants(Block* block) {
+    for (Node* n : block->nodes()) {
+      if (n->kind() == prim::Constant &&
+          n->output()->type()->isSubtypeOf(TensorType::get())) {
+        externalValues_.push_back(n->output());
+      }
+      for (Block* b : n->blocks()) {
+        collectConstants(b);
+      }
+    }
+  }
+
+  void run(Block* block) {
+    for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+      Node* n = *it++;
+      for (Block* b : n->blocks()) {
+        run(b);
+      }
+      if (canWriteToSelf(n)) {
+        if (auto op = findInplaceVariant(*graph_, n)) {
+          replaceWithInplace(n, op);
+        }
+      }
+    }
+  }
+
+  bool canWriteToSelf(Node* n) {
+    if (!isElementwise(n) || n->outputs().size() != 1 ||
+        n->inputs().empty() ||
+        !n->output()->type()->isSubtypeOf(TensorType::get()) ||
+        !resultHasSizesOfSelf(n)) {
+      return false;
+    }
+    Value* self = n->input(0);
+    // the value must be computed in this block, or each iteration of a loop
+    // would see the previous one's write
+    Node* producer = self->node();
+    if (producer->owningBlock() != n->owningBlock() ||
+        producer->outputs().size() != 1 ||
+        (!allocatesOutput(producer) && rewritten_.count(producer) == 0)) {
+      return false;
+    }
+    for (Value* external : externalValues_) {
+      if (aliasDb_.mayAlias(self, external)) {
+        return false;
+      }
+    }
+    // the other operands are read after being written to, unless they read
+    // the same elements
+    for (size_t i = 1; i < n->inputs().size(); ++i) {
+      Value* other = n->input(i);
+      if (other != self && aliasDb_.mayAlias(self, other)) {
+        return false;
+      }
+    }
+    // nothing may read `self` afterwards, nor keep a view or a container of it
+    for (const Use& use : self->uses()) {
+      Node* user = use.user;
+      if (user == n) {
+        continue;
+      }
+      if (user->owningBlock() != n->owningBlock() || !n->isAfter(user)) {
+        return false;
+      }
+      for (Value* output : user->outputs()) {
+        if (aliasDb_.mayContainAlias(output, self)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  void replaceWithInplace(Node* n, const std::shared_ptr<Operator>& op) {
+    const auto& schema = op->schema();
+    Node* inplace =
+        graph_->create(Symbol::fromQualString(schema.name()), n->inputs(), 1);
+    inplace->insertBefore(n);
+    inplace->output()->copyMetadata(n->output());
+    aliasDb_.replaceWithNewValue(n->output(), inplace->output());
+    aliasDb_.replaceWithNewNode(n, inplace);
+    rewritten_.insert(inplace);
+    n->output()->replaceAllUsesWith(inplace->output());
+    n->destroy();
+  }
+
+  std::shared_ptr<Graph> graph_;
+  // The aliasing of the original graph. A rewritten op's result aliases
+  // `self` only once nothing else can see `self`, so it can keep the fresh
+  // memory location of the out-of-place result.
+  AliasDb aliasDb_;
+  // The rewritten ops, whose results can be written to again
+  std::unordered_set<Node*> rewritten_;
+  // Tensors whose memory outlives a run of the graph
+  std::vector<Value*> externalValues_;
+};
+
+} // namespace
+
+void ConvertToInplaceOps(std::shared_ptr<Graph>& graph) {
+  InplaceConverter(graph).run();
+}
+
+} // namespace jit
+} // namespace torch
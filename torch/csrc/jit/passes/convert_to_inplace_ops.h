@@ -0,0 +1,27 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+#include <memory>
+
+namespace torch {
+namespace jit {
+
+// The inverse of RemoveInplaceOps for inference graphs: rewrites elementwise
+// ops like add, mul and relu into their in-place variants, e.g.
+//   %y = aten::relu(%x)
+// becomes
+//   %y = aten::relu_(%x)
+// when alias analysis proves that %x is an intermediate tensor that nothing
+// reads after the op. This saves an allocation and the memory traffic of a
+// second buffer per op.
+//
+// Values that may alias the graph inputs or constants (e.g. the weights of a
+// frozen module) are never written to. Binary ops with a tensor operand are
+// only rewritten when the types show that the result has the sizes of `self`.
+// The tensors written to may have been saved for backward, so this should
+// only run on graphs that won't be differentiated.
+TORCH_API void ConvertToInplaceOps(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
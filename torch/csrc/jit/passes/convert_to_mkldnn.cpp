@@ -0,0 +1,392 @@
+#include <torch/csrc/jit/passes/convert_to_mkldnn.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// How the inputs of a node that runs on MKL-DNN tensors are converted.
+struct MKLDNNOp {
+  // inputs that have to be MKL-DNN tensors when the node runs
+  std::vector<size_t> activations;
+  // constant inputs the pass converts to MKL-DNN tensors once
+  std::vector<size_t> weights;
+  // constant convolution weight the pass prepacks into the blocked format
+  c10::optional<size_t> conv_weight;
+  // the node writes to its first input, and returns it
+  bool inplace = false;
+};
+
+bool isActivation(const MKLDNNOp& op, size_t i) {
+  return std::find(op.activations.begin(), op.activations.end(), i) !=
+      op.activations.end();
+}
+
+bool isFloatCPU(const Value* v, int64_t dim = -1) {
+  auto type = v->type()->cast<CompleteTensorType>();
+  return type && type->scalarType() == at::kFloat &&
+      type->device().is_cpu() && (dim < 0 || type->dim() == dim);
+}
+
+bool isConstantFloatTensor(const Value* v) {
+  if (v->node()->kind() != prim::Constant) {
+    return false;
+  }
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return false;
+  }
+  const auto& t = ival->toTensor();
+  return t.defined() && !t.is_mkldnn() && t.layout() == at::kStrided &&
+      t.device().is_cpu() && t.scalar_type() == at::kFloat;
+}
+
+bool isConstantIntList(const Node* n, Symbol name, int64_t value) {
+  auto list = n->get<std::vector<int64_t>>(name);
+  return list &&
+      std::all_of(list->begin(), list->end(), [&](int64_t v) {
+        return v == value;
+      });
+}
+
+bool isConstantFalse(const Node* n, Symbol name) {
+  auto v = n->get<bool>(name);
+  return v && !*v;
+}
+
+// Returns how `n` is run on MKL-DNN tensors, or nullopt if the MKL-DNN
+// kernels do not support it.
+c10::optional<MKLDNNOp> mkldnnOp(Node* n) {
+  MKLDNNOp op;
+  if (n->matches(
+          "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor") ||
+      n->matches(
+          "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+    // the MKL-DNN convolution supports neither dilation nor transposition
+    if (!isFloatCPU(n->input(0), 4) ||
+        !isConstantIntList(n, attr::dilation, 1) ||
+        (n->kind() == aten::_convolution &&
+         !isConstantFalse(n, attr::transposed))) {
+      return c10::nullopt;
+    }
+    op.activations = {0};
+    // a dense weight works too, it is just reordered on every call
+    if (isConstantFloatTensor(n->input(1)) && n->is_constant(attr::stride) &&
+        n->is_constant(attr::padding) && n->is_constant(attr::groups)) {
+      op.conv_weight = 1;
+    }
+    return op;
+  }
+  if (n->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+    if (!isFloatCPU(n->input(0), 2) || !isConstantFloatTensor(n->input(1))) {
+      return c10::nullopt;
+    }
+    op.activations = {0};
+    op.weights = {1};
+    if (!n->input(2)->mustBeNone()) {
+      if (!isConstantFloatTensor(n->input(2))) {
+        return c10::nullopt;
+      }
+      op.weights.push_back(2);
+    }
+    return op;
+  }
+  if (n->matches(
+          "aten::batch_norm(Tensor input, Tensor? weight, Tensor? bias, Tensor? running_mean, Tensor? running_var, bool training, float momentum, float eps, bool cudnn_enabled) -> Tensor")) {
+    // MKL-DNN batch norm only supports inference, with all parameters given
+    if (!isFloatCPU(n->input(0), 4) || !isConstantFalse(n, attr::training)) {
+      return c10::nullopt;
+    }
+    op.activations = {0};
+    for (size_t i = 1; i <= 4; ++i) {
+      if (!isConstantFloatTensor(n->input(i))) {
+        return c10::nullopt;
+      }
+      op.weights.push_back(i);
+    }
+    return op;
+  }
+  if (n->matches("aten::relu(Tensor self) -> Tensor") ||
+      n->matches("aten::relu_(Tensor(a!) self) -> Tensor(a!)")) {
+    if (!isFloatCPU(n->input(0))) {
+      return c10::nullopt;
+    }
+    op.activations = {0};
+    op.inplace = n->kind() == aten::relu_;
+    return op;
+  }
+  if (n->matches(
+          "aten::max_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor") ||
+      n->matches(
+          "aten::avg_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad) -> Tensor")) {
+    // the MKL-DNN pooling supports neither ceil_mode nor dilation
+    if (!isFloatCPU(n->input(0), 4) || !isConstantFalse(n, attr::ceil_mode) ||
+        (n->kind() == aten::max_pool2d &&
+         !isConstantIntList(n, attr::dilation, 1))) {
+      return c10::nullopt;
+    }
+    op.activations = {0};
+    return op;
+  }
+  if (n->matches(
+          "aten::adaptive_avg_pool2d(Tensor self, int[] output_size) -> Tensor")) {
+    auto output_size = n->get<std::vector<int64_t>>(attr::output_size);
+    if (!isFloatCPU(n->input(0), 4) || !output_size || output_size->empty()) {
+      return c10::nullopt;
+    }
+    // MKL-DNN only pools windows that evenly divide the input
+    auto sizes = n->input(0)->type()->expect<CompleteTensorType>()->sizes();
+    for (size_t i = 0; i < 2; ++i) {
+      auto out = (*output_size)[output_size->size() == 1 ? 0 : i];
+      if (out == 0 || sizes[i + 2] % out != 0) {
+        return c10::nullopt;
+      }
+    }
+    op.activations = {0};
+    return op;
+  }
+  if (n->matches(
+          "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor") ||
+      n->matches(
+          "aten::add_(Tensor(a!) self, Tensor other, *, Scalar alpha) -> Tensor(a!)")) {
+    // MKL-DNN sum does not broadcast
+    if (!isFloatCPU(n->input(0)) || !isFloatCPU(n->input(1)) ||
+        n->input(0)->type()->expect<CompleteTensorType>()->sizes() !=
+            n->input(1)->type()->expect<CompleteTensorType>()->sizes()) {
+      return c10::nullopt;
+    }
+    op.activations = {0, 1};
+    op.inplace = n->kind() == aten::add_;
+    return op;
+  }
+  return c10::nullopt;
+}
+
+class MKLDNNConverter {
+ public:
+  explicit MKLDNNConverter(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)), alias_db_(graph_) {}
+
+  void run() {
+    collect(graph_->block());
+    removeEscapingWrites();
+    if (ops_.empty()) {
+      return;
+    }
+    autograd::AutoGradMode no_grad(false);
+    rewrite(graph_->block());
+    EliminateDeadCode(graph_);
+  }
+
+ private:
+  void collect(Block* block) {
+    for (Node* n : block->nodes()) {
+      for (Block* sub : n->blocks()) {
+        collect(sub);
+      }
+      auto op = mkldnnOp(n);
+      // an in-place operator can only write to a tensor that already is an
+      // MKL-DNN result; writing to a converted copy would lose the write
+      if (!op || (op->inplace && !ops_.count(n->input(0)->node()))) {
+        continue;
+      }
+      ops_.emplace(n, std::move(*op));
+    }
+  }
+
+  bool isMKLDNN(Value* v) const {
+    return ops_.count(v->node());
+  }
+
+  // The value an in-place MKL-DNN node (transitively) writes to.
+  Value* writtenValue(Value* v) const {
+    auto it = ops_.find(v->node());
+    while (it != ops_.end() && it->second.inplace) {
+      v = it->first->input(0);
+      it = ops_.find(v->node());
+    }
+    return v;
+  }
+
+  // The dense copy that feeds a node outside of the MKL-DNN region is taken
+  // when that node runs. That is only correct if nothing writes to the tensor
+  // afterwards, so an MKL-DNN result that is written to (by any node) and
+  // also leaves the region is computed in dense layout instead, together with
+  // the in-place MKL-DNN nodes writing to it.
+  void removeEscapingWrites() {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      std::vector<Node*> producers;
+      for (const auto& entry : ops_) {
+        if (!entry.second.inplace) {
+          producers.push_back(entry.first);
+        }
+      }
+      for (Node* n : producers) {
+        std::vector<Value*> group{n->output()};
+        std::vector<Node*> writers;
+        bool escapes = false;
+        for (size_t i = 0; i < group.size(); ++i) {
+          for (const Use& use : group[i]->uses()) {
+            auto it = ops_.find(use.user);
+            if (it == ops_.end() || !isActivation(it->second, use.offset)) {
+              escapes = true;
+            } else if (it->second.inplace && use.offset == 0) {
+              writers.push_back(use.user);
+              group.push_back(use.user->output());
+            }
+          }
+        }
+        if (escapes && (!writers.empty() || alias_db_.hasWriters(n))) {
+          ops_.erase(n);
+          for (Node* writer : writers) {
+            ops_.erase(writer);
+          }
+          changed = true;
+        }
+      }
+      // in-place nodes whose target is no longer an MKL-DNN result
+      std::vector<Node*> orphans;
+      for (const auto& entry : ops_) {
+        if (entry.second.inplace &&
+            !ops_.count(writtenValue(entry.first->input(0))->node())) {
+          orphans.push_back(entry.first);
+        }
+      }
+      for (Node* n : orphans) {
+        ops_.erase(n);
+        changed = true;
+      }
+    }
+  }
+
+  Value* toMKLDNN(Value* v, Node* user) {
+    // a dense tensor that is written to has to be converted at every use
+    bool cacheable = !alias_db_.hasWriters(v->node());
+    auto& cache = to_mkldnn_[user->owningBlock()];
+    if (cacheable) {
+      auto it = cache.find(v);
+      if (it != cache.end()) {
+        return it->second;
+      }
+    }
+    Node* convert = graph_->create(aten::to_mkldnn, {v});
+    convert->output()->setType(TensorType::get());
+    convert->insertBefore(user);
+    if (cacheable) {
+      cache.emplace(v, convert->output());
+    }
+    return convert->output();
+  }
+
+  Value* toDense(Value* v, Node* user) {
+    auto& cache = to_dense_[user->owningBlock()];
+    auto it = cache.find(v);
+    if (it != cache.end()) {
+      return it->second;
+    }
+    Node* convert = graph_->create(aten::to_dense, {v});
+    convert->output()->setType(dense_types_.at(v));
+    convert->insertBefore(user);
+    cache.emplace(v, convert->output());
+    return convert->output();
+  }
+
+  Value* insertMKLDNNConstant(at::Tensor t, Node* user) {
+    Node* constant = graph_->create(prim::Constant);
+    constant->t_(attr::value, std::move(t));
+    // MKL-DNN tensors have no strides to describe in a complete type
+    constant->output()->setType(TensorType::get());
+    constant->insertBefore(user);
+    return constant->output();
+  }
+
+  void rewriteMKLDNNNode(Node* n, const MKLDNNOp& op) {
+    for (size_t i : op.activations) {
+      if (!isMKLDNN(n->input(i))) {
+        n->replaceInput(i, toMKLDNN(n->input(i), n));
+      }
+    }
+    for (size_t i : op.weights) {
+      auto weight = toIValue(n->input(i))->toTensor();
+      n->replaceInput(i, insertMKLDNNConstant(weight.to_mkldnn(), n));
+    }
+    if (op.conv_weight) {
+      size_t i = *op.conv_weight;
+      auto weight = toIValue(n->input(i))->toTensor();
+      auto packed = at::mkldnn_reorder_conv2d_weight(
+          weight.to_mkldnn(),
+          *n->get<std::vector<int64_t>>(attr::padding),
+          *n->get<std::vector<int64_t>>(attr::stride),
+          *n->get<std::vector<int64_t>>(attr::dilation),
+          *n->get<int64_t>(attr::groups));
+      n->replaceInput(i, insertMKLDNNConstant(std::move(packed), n));
+    }
+    // the remaining inputs, e.g. a convolution bias, stay dense
+    for (size_t i = 0; i < n->inputs().size(); ++i) {
+      if (isMKLDNN(n->input(i)) && !isActivation(op, i)) {
+        n->replaceInput(i, toDense(n->input(i), n));
+      }
+    }
+    dense_types_.emplace(n->output(), n->output()->type());
+    n->output()->setType(TensorType::get());
+  }
+
+  void rewriteDenseUses(Node* n) {
+    for (size_t i = 0; i < n->inputs().size(); ++i) {
+      if (isMKLDNN(n->input(i))) {
+        n->replaceInput(i, toDense(n->input(i), n));
+      }
+    }
+  }
+
+  void rewrite(Block* block) {
+    for (Node* n : block->nodes()) {
+      auto it = ops_.find(n);
+      if (it != ops_.end()) {
+        rewriteMKLDNNNode(n, it->second);
+        continue;
+      }
+      rewriteDenseUses(n);
+      for (Block* sub : n->blocks()) {
+        rewrite(sub);
+      }
+    }
+    rewriteDenseUses(block->return_node());
+  }
+
+  std::shared_ptr<Graph> graph_;
+  AliasDb alias_db_;
+  // the nodes that run on MKL-DNN tensors
+  std::unordered_map<Node*, MKLDNNOp> ops_;
+  // the type the outputs of those nodes had as dense tensors
+  std::unordered_map<Value*, TypePtr> dense_types_;
+  // conversions already inserted, per block they are visible in
+  std::unordered_map<Block*, std::unordered_map<Value*, Value*>> to_mkldnn_;
+  std::unordered_map<Block*, std::unordered_map<Value*, Value*>> to_dense_;
+};
+
+} // namespace
+
+void ConvertToMKLDNN(std::shared_ptr<Graph>& graph) {
+  if (!at::hasMKLDNN()) {
+    return;
+  }
+  MKLDNNConverter(graph).run();
+}
+
+} // namespace jit
+} // namespace torch
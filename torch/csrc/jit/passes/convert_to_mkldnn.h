@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Runs the MKL-DNN capable operators of an inference graph on MKL-DNN
+// tensors.
+//
+// Maximal chains of convolution, linear, batch norm, relu, pooling and add
+// nodes on float CPU tensors keep their activations in MKL-DNN layout: a
+// single aten::to_mkldnn is inserted where a dense tensor enters such a chain
+// and a single aten::to_dense where a result leaves it, so no reorder happens
+// between two MKL-DNN operators. Weights that are graph constants are
+// converted once, by this pass; convolution weights are prepacked into the
+// blocked format the MKL-DNN convolution expects.
+//
+// The pass needs complete tensor types (e.g. a traced graph), is meant for
+// inference only and should run last: the MKL-DNN constants it creates can
+// not be serialized. It does nothing if PyTorch was built without MKL-DNN.
+TORCH_API void ConvertToMKLDNN(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
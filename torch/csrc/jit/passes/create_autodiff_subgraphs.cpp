@@ -17,12 +17,23 @@ class SubgraphSlicer {
   SubgraphSlicer(
       Block* block,
       std::shared_ptr<Graph> graph,
-      size_t minSubgraphSize)
+      size_t minSubgraphSize,
+      AliasDb& aliasDb)
       : block_(block),
         graph_(std::move(graph)),
-        minSubgraphSize_(minSubgraphSize) {}
+        minSubgraphSize_(minSubgraphSize),
+        aliasDb_(aliasDb) {}
 
   void run(std::vector<Node*>& diffGraphs) {
+    buildupSubgraphs();
+    cleanupSubgraphs(diffGraphs);
+    // Run CSE one more time to eliminate duplicates that may have occured
+    // while re-inlining subgraphs.
+    EliminateCommonSubexpression(graph_);
+  }
+
+ private:
+  void buildupSubgraphs() {
     // We need to run the slicer multiple times in order to get all merge
     // opportunities. This is because moveBeforeTopologicalValid may reorder
     // nodes to be AFTER the current iteration point. In order to properly
@@ -37,24 +48,40 @@ class SubgraphSlicer {
     //   c = f(a, b)
     //   e = f(d)  <- iter still here
     //   d = f(c)  <- this was node moved on the other side.
+    //
+    // The merges keep aliasDb_ up to date, so it is built only once for the
+    // whole graph.
     bool any_changed = true;
     while (any_changed) {
       any_changed = false;
-      AliasDb aliasDb(graph_);
       for (auto it = block_->nodes().rbegin(); it != block_->nodes().rend();) {
         bool changed;
-        std::tie(it, changed) = scanNode(*it, aliasDb);
+        std::tie(it, changed) = scanNode(*it);
         any_changed |= changed;
       }
     }
 
-    // Done constructing subgraphs. Do some post-processing cleanup:
-    // 1. Run CSE to delete redundanet constant nodes.
-    // 2. We may need to re-inline ones that are too small.
+    for (auto it = block_->nodes().rbegin(); it != block_->nodes().rend();
+         ++it) {
+      for (auto subBlock : it->blocks()) {
+        SubgraphSlicer(subBlock, graph_, minSubgraphSize_, aliasDb_)
+            .buildupSubgraphs();
+      }
+    }
+  }
+
+  // Done constructing subgraphs. Do some post-processing cleanup:
+  // 1. Run CSE to delete redundanet constant nodes.
+  // 2. We may need to re-inline ones that are too small.
+  //
+  // This edits the subgraphs behind aliasDb_'s back, so it must not be used
+  // from here on.
+  void cleanupSubgraphs(std::vector<Node*>& diffGraphs) {
     auto curNode = *block_->nodes().rbegin();
     while (curNode != *block_->nodes().rend()) {
       for (auto subBlock : curNode->blocks()) {
-        SubgraphSlicer(subBlock, graph_, minSubgraphSize_).run(diffGraphs);
+        SubgraphSlicer(subBlock, graph_, minSubgraphSize_, aliasDb_)
+            .cleanupSubgraphs(diffGraphs);
       }
 
       // Save the previous node, since we might delete `curNode` in next block
@@ -71,12 +98,8 @@ class SubgraphSlicer {
       }
       curNode = prevNode;
     }
-    // Run CSE one more time to eliminate duplicates that may have occured
-    // while re-inlining subgraphs.
-    EliminateCommonSubexpression(graph_);
   }
 
- private:
   // Inline this node's group subgraph into the outer graph if it's smaller
   // than the specified minimum size.
   //
@@ -121,17 +144,15 @@ class SubgraphSlicer {
     return isDifferentiable(node);
   }
 
-  std::pair<graph_node_list::iterator, bool> scanNode(
-      Node* consumer,
-      AliasDb& aliasDb) {
+  std::pair<graph_node_list::iterator, bool> scanNode(Node* consumer) {
     if (shouldConsiderForMerge(consumer)) {
       if (consumer->kind() != prim::DifferentiableGraph) {
         consumer = SubgraphUtils::createSingletonSubgraph(
-            consumer, prim::DifferentiableGraph);
+            consumer, prim::DifferentiableGraph, aliasDb_);
       }
       auto inputs = sortReverseTopological(consumer->inputs());
       for (auto input : inputs) {
-        if (auto group = tryMerge(consumer, input->node(), aliasDb)) {
+        if (auto group = tryMerge(consumer, input->node())) {
           // we successfully merged, so the new group's `inputs` may have
           // changed. So rescan the new group for more merging opportunities.
           return std::make_pair(group.value()->reverseIterator(), true);
@@ -144,19 +165,16 @@ class SubgraphSlicer {
 
   // Try to merge `producer` into `consumer`. If successful, this destroys
   // `producer` and returns the `consumer` group.
-  c10::optional<Node*> tryMerge(
-      Node* consumer,
-      Node* producer,
-      AliasDb& aliasDb) {
+  c10::optional<Node*> tryMerge(Node* consumer, Node* producer) {
     AT_ASSERT(consumer->kind() == prim::DifferentiableGraph);
     bool canMerge = shouldConsiderForMerge(producer) &&
-        aliasDb.moveBeforeTopologicallyValid(producer, consumer);
+        aliasDb_.moveBeforeTopologicallyValid(producer, consumer);
 
     if (!canMerge) {
       return c10::nullopt;
     }
 
-    SubgraphUtils::mergeNodeIntoSubgraph(producer, consumer);
+    SubgraphUtils::mergeNodeIntoSubgraph(producer, consumer, aliasDb_);
 
     return consumer;
   }
@@ -164,6 +182,7 @@ class SubgraphSlicer {
   Block* block_;
   std::shared_ptr<Graph> graph_;
   size_t minSubgraphSize_;
+  AliasDb& aliasDb_;
 };
 } // anonymous namespace
 
@@ -171,7 +190,8 @@ std::vector<Node*> CreateAutodiffSubgraphs(
     const std::shared_ptr<Graph>& graph,
     size_t threshold) {
   std::vector<Node*> diff_nodes;
-  SubgraphSlicer(graph->block(), graph, threshold).run(diff_nodes);
+  AliasDb db(graph);
+  SubgraphSlicer(graph->block(), graph, threshold, db).run(diff_nodes);
   return diff_nodes;
 }
 } // namespace jit
@@ -0,0 +1,211 @@
+#include <torch/csrc/jit/passes/freeze_module.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/constant_pooling.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/convert_to_inplace_ops.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/prepack_weights.h>
+
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Replaces the slot inputs that follow the user inputs of a lowered method
+// graph by constants holding the slots' current values.
+void inlineSlots(
+    Graph& graph,
+    size_t num_inputs,
+    const std::vector<script::Slot>& slots) {
+  AT_ASSERT(graph.inputs().size() == num_inputs + slots.size());
+  WithInsertPoint guard(graph.block()->nodes().front());
+  for (size_t i = 0; i < slots.size(); i++) {
+    const script::Slot& slot = slots[i];
+    IValue value = slot.value();
+    if (value.isTensor() && value.toTensor().defined()) {
+      value = value.toTensor().detach();
+    }
+    auto constant = tryInsertConstant(graph, value, slot.type());
+    if (!constant) {
+      AT_ERROR(
+          "cannot freeze attribute '",
+          slot.name(),
+          "' of type ",
+          slot.type()->str(),
+          ", only tensors and values that can be graph constants are supported");
+    }
+    graph.inputs().at(num_inputs + i)->replaceAllUsesWith(*constant);
+  }
+  for (size_t i = slots.size(); i > 0; i--) {
+    graph.eraseInput(num_inputs + i - 1);
+  }
+}
+
+// The constants share storage with the module's tensors and reads of them
+// may have been folded, so a write to one would not be seen by the frozen
+// graph the way it is by the original method.
+void checkNoMutatedConstants(std::shared_ptr<Graph>& graph) {
+  ValueSet constants;
+  for (Node* n : graph->nodes()) {
+    if (n->kind() == prim::Constant &&
+        n->output()->type()->isSubtypeOf(TensorType::get())) {
+      constants.insert(n->output());
+    }
+  }
+  AliasDb aliasDb(graph);
+  for (Node* n : graph->nodes()) {
+    if (aliasDb.writesToAlias(n, constants, /*recurseBlocks=*/true)) {
+      AT_ERROR(
+          "cannot freeze a method that mutates a parameter or attribute of "
+          "its module, in ",
+          n->kind().toQualString());
+    }
+  }
+}
+
+c10::optional<at::Tensor> constantTensor(Value* v) {
+  if (v->node()->kind() != prim::Constant) {
+    return c10::nullopt;
+  }
+  auto ival = toIValue(v);
+  if (!ival) {
+    return c10::nullopt;
+  }
+  if (ival->isNone()) {
+    return at::Tensor();
+  }
+  if (!ival->isTensor()) {
+    return c10::nullopt;
+  }
+  return ival->toTensor();
+}
+
+bool isConvolution(Node* n) {
+  if (n->kind() == aten::conv1d || n->kind() == aten::conv2d ||
+      n->kind() == aten::conv3d) {
+    return true;
+  }
+  // the weights of transposed convolutions hold the output channels in
+  // their second dimension
+  if (n->kind() == aten::_convolution) {
+    auto transposed = n->get<bool>(attr::transposed);
+    return transposed && !*transposed;
+  }
+  return false;
+}
+
+// batch_norm(conv(x, w, b), bn_w, bn_b, mean, var, training=False, eps)
+//   == conv(x, w * scale, (b - mean) * scale + bn_b)
+// per output channel, with scale = bn_w / sqrt(var + eps).
+bool foldConvBatchNorm(Graph& graph, Node* bn) {
+  if (bn->kind() != aten::batch_norm) {
+    return false;
+  }
+  Value* conv_output = bn->namedInput(attr::input);
+  Node* conv = conv_output->node();
+  if (!isConvolution(conv) || conv_output->uses().size() != 1) {
+    return false;
+  }
+  auto training = bn->get<bool>(attr::training);
+  auto eps = bn->get<double>(attr::eps);
+  auto bn_weight = constantTensor(bn->namedInput(attr::weight));
+  auto bn_bias = constantTensor(bn->namedInput(attr::bias));
+  auto mean = constantTensor(bn->namedInput(attr::running_mean));
+  auto var = constantTensor(bn->namedInput(attr::running_var));
+  auto weight = constantTensor(conv->namedInput(attr::weight));
+  auto bias = constantTensor(conv->namedInput(attr::bias));
+  if (!training || *training || !eps || !bn_weight || !bn_bias || !mean ||
+      !var || !mean->defined() || !var->defined() || !weight ||
+      !weight->defined() || !bias) {
+    return false;
+  }
+  const int64_t channels = weight->size(0);
+  if (mean->numel() != channels) {
+    return false;
+  }
+
+  at::Tensor scale = (*var + *eps).rsqrt();
+  if (bn_weight->defined()) {
+    scale = scale * *bn_weight;
+  }
+  at::Tensor new_bias = bias->defined() ? *bias - *mean : -*mean;
+  new_bias = new_bias * scale;
+  if (bn_bias->defined()) {
+    new_bias = new_bias + *bn_bias;
+  }
+  std::vector<int64_t> scale_sizes(weight->dim(), 1);
+  scale_sizes[0] = channels;
+  at::Tensor new_weight = *weight * scale.reshape(scale_sizes);
+
+  // all the convolutions take the weight and bias as their second and third
+  // inputs
+  WithInsertPoint guard(conv);
+  conv->replaceInput(
+      1, graph.insertConstant(new_weight.to(weight->scalar_type())));
+  conv->replaceInput(
+      2, graph.insertConstant(new_bias.to(weight->scalar_type())));
+  bn->output()->replaceAllUsesWith(conv_output);
+  return true;
+}
+
+bool foldConvBatchNorm(Graph& graph, Block* block) {
+  bool changed = false;
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* n = *it++;
+    for (Block* sub : n->blocks()) {
+      changed |= foldConvBatchNorm(graph, sub);
+    }
+    if (foldConvBatchNorm(graph, n)) {
+      n->destroy();
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+void optimizeFrozenGraph(std::shared_ptr<Graph>& graph) {
+  ConstantPropagation(graph);
+  checkNoMutatedConstants(graph);
+  {
+    // the folded weights are constants of an inference graph, not parameters
+    autograd::AutoGradMode no_grad(false);
+    foldConvBatchNorm(*graph, graph->block());
+  }
+  PrepackWeights(graph);
+  ConstantPooling(graph);
+  EliminateDeadCode(graph);
+  ConvertToInplaceOps(graph);
+}
+
+} // namespace
+
+void FreezeModule(script::Module& module, script::Module& frozen) {
+  AT_CHECK(
+      !module.is_training(),
+      "only modules in eval mode can be frozen, call eval() first");
+  frozen.eval();
+  const TypePtr self_type = frozen.module_object()->type();
+  for (const auto& method : module.get_methods()) {
+    auto graph = method->graph()->copy();
+    inlineSlots(*graph, method->num_inputs(), method->initial_ivalues());
+    optimizeFrozenGraph(graph);
+
+    // the frozen module's methods take an unused self, like any other method
+    graph->insertInput(0, "self")->setType(self_type);
+    const FunctionSchema& schema = method->getSchema();
+    std::vector<Argument> args = {Argument("self", self_type)};
+    args.insert(args.end(), schema.arguments().begin(), schema.arguments().end());
+    auto fn = frozen.class_compilation_unit().create_function(
+        method->name(), graph);
+    fn->setSchema(schema.cloneWithArguments(std::move(args)));
+  }
+}
+
+} // namespace jit
+} // namespace torch
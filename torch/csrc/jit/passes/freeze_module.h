@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/script/module.h>
+
+namespace torch {
+namespace jit {
+
+// Freezes an eval-mode module for inference: every method of `module` is
+// copied into `frozen` with the parameters and attributes it reads (those of
+// submodules included) inlined as graph constants, so running it does no
+// attribute lookups and the passes see the weights as constants.
+//
+// With the weights and the training flag constant, the frozen graphs are
+// simplified by constant propagation, convolutions followed by batch norm
+// are folded into a single convolution with rescaled weights, and the
+// weights of float CPU linear layers and convolutions are prepacked where
+// the activation types allow it (see PrepackWeights; run shape propagation
+// and PrepackWeights again on a graph specialized to its inputs to pack the
+// rest). Finally, elementwise ops on intermediate tensors that nothing reads
+// afterwards are rewritten in place (see ConvertToInplaceOps), so the frozen
+// methods must not be differentiated.
+//
+// The constants share storage with the original module's tensors, except
+// for folded weights, and it is an error for a method to mutate any of them.
+// `frozen` should be a fresh module; it ends up without parameters, and is
+// itself in eval mode.
+TORCH_API void FreezeModule(script::Module& module, script::Module& frozen);
+
+} // namespace jit
+} // namespace torch
@@ -250,7 +250,69 @@ struct GraphFuser {
         fusableDevice &= isFusableDevice(output);
       }
     }
-    return fusableDevice && (isFusableMap(node) || isFusableNorm(node));
+    return fusableDevice &&
+        (isFusableMap(node) || isFusableNorm(node) ||
+         isFusableReduction(node));
+  }
+
+  // A sum of floating point values over their outermost or innermost
+  // dimension can end a fusion group: the kernel then accumulates the values
+  // computed by the rest of the group instead of writing them out.
+  // Note: the sum must be the only output of the group, see
+  // canFuseIntoReduction.
+  bool isFusableReduction(Node* node) {
+    if (node->owningBlock() != block_)
+      return false;
+    if (!node->matches(
+            "aten::sum(Tensor self, int[] dim, bool keepdim) -> Tensor",
+            /*const_inputs=*/{attr::dim, attr::keepdim})) {
+      return false;
+    }
+    auto type =
+        node->namedInput(attr::self)->type()->cast<DimensionedTensorType>();
+    if (!type || type->dim() == 0 || !at::isFloatingType(type->scalarType()))
+      return false;
+    const auto dims = node->get<std::vector<int64_t>>(attr::dim).value();
+    if (dims.size() != 1)
+      return false;
+    return dims[0] == 0 || dims[0] == -1 || dims[0] == type->dim() - 1;
+  }
+
+  // Returns true if node is a reduction or a fusion group ending in one.
+  // Those can't be fused into their consumers.
+  bool endsInReduction(Node* node) {
+    if (node->kind() == kind_) {
+      auto outputs = getSubgraph(node).outputs();
+      return std::any_of(outputs.begin(), outputs.end(), [](Value* v) {
+        return v->node()->kind() == aten::sum;
+      });
+    }
+    return node->kind() == aten::sum;
+  }
+
+  // The only output of a fusion group ending in a reduction is the sum, so
+  // the producers fused into it must not be used anywhere else. Random
+  // numbers, _grad_sum_to_size and concatenations aren't supported by
+  // reduction kernels either.
+  bool canFuseIntoReduction(Node* consumer, Value* producer) {
+    Node* node = producer->node();
+    for (Value* output : node->outputs()) {
+      for (const auto& u : output->uses()) {
+        if (u.user != consumer) {
+          return false;
+        }
+      }
+    }
+    auto isUnsupported = [](Node* n) {
+      return n->kind() == aten::rand_like ||
+          n->kind() == aten::_grad_sum_to_size ||
+          n->kind() == prim::FusedConcat;
+    };
+    if (node->kind() == kind_) {
+      auto nodes = getSubgraph(node).nodes();
+      return std::none_of(nodes.begin(), nodes.end(), isUnsupported);
+    }
+    return !isUnsupported(node);
   }
 
   bool isFusableMap(Node* node) {
@@ -591,6 +653,13 @@ struct GraphFuser {
       return at::nullopt;
     }
 
+    if (kind_ == prim::FusionGroup &&
+        (endsInReduction(producer->node()) ||
+         (endsInReduction(consumer) &&
+          !canFuseIntoReduction(consumer, producer)))) {
+      return at::nullopt;
+    }
+
     if ((consumer->inputs().size() + consumer->outputs().size() +
          producer->node()->inputs().size() +
          producer->node()->outputs().size()) > fusion_kernel_args_limit) {
@@ -1138,6 +1207,11 @@ struct GraphFuser {
         shape_of.emplace(outputs.at(outputs.size() - 1), last_size);
         continue;
       }
+      if (n->kind() == aten::sum) {
+        // A reduction always ends the fusion group, and its output doesn't
+        // have the shape of its input. Don't replace the queries of its size.
+        continue;
+      }
       auto tensor_inputs = filter(n->inputs(), [](Value* v) {
         return v->type()->isSubtypeOf(TensorType::get());
       });
@@ -1185,6 +1259,9 @@ struct GraphFuser {
     if (!isFusable(producer->node())) {
       return false;
     }
+    if (endsInReduction(producer->node())) {
+      return false;
+    }
     // NB: it is important that this check happens after isFusable, which checks
     // that the blocks match, and it's not a special node like prim::Param
     if (!aliasDb_->couldMoveBeforeTopologically(
@@ -1465,6 +1542,147 @@ bool trackSingleGradSumToSizeToOutputs(
   return true;
 }
 
+namespace {
+
+bool isCUDATensorOfSize(Value* v, const std::vector<int64_t>& sizes) {
+  auto type = v->type()->cast<CompleteTensorType>();
+  return type && type->device().is_cuda() && type->sizes() == sizes;
+}
+
+void FuseDropoutAddLayerNorm(Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* norm = *it;
+    ++it;
+    for (Block* sub : norm->blocks()) {
+      FuseDropoutAddLayerNorm(sub);
+    }
+    if (!norm->matches(
+            "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight, Tensor? bias, float eps, bool cudnn_enable) -> Tensor")) {
+      continue;
+    }
+    Value* sum = norm->input(0);
+    Node* add = sum->node();
+    if (add->owningBlock() != block || sum->uses().size() != 1 ||
+        !add->matches(
+            "aten::add(Tensor self, Tensor other, *, Scalar alpha) -> Tensor",
+            /*const_inputs=*/attr::alpha) ||
+        add->get<at::Scalar>(attr::alpha)->toDouble() != 1) {
+      continue;
+    }
+    auto type = sum->type()->cast<CompleteTensorType>();
+    if (!type) {
+      continue;
+    }
+    // The add is commutative, so the dropout can be on either side
+    for (size_t i = 0; i < 2; ++i) {
+      Value* dropped = add->input(i);
+      Value* residual = add->input(1 - i);
+      Node* dropout = dropped->node();
+      if (dropout->owningBlock() != block || dropped->uses().size() != 1 ||
+          !dropout->matches(
+              "aten::dropout(Tensor input, float p, bool train) -> Tensor")) {
+        continue;
+      }
+      // No broadcasting in the add
+      Value* input = dropout->input(0);
+      if (!isCUDATensorOfSize(input, type->sizes()) ||
+          !isCUDATensorOfSize(residual, type->sizes())) {
+        continue;
+      }
+      Node* fused = block->owningGraph()->create(
+          aten::dropout_add_layer_norm,
+          {input,
+           residual,
+           norm->input(1),
+           norm->input(2),
+           norm->input(3),
+           dropout->input(1),
+           dropout->input(2),
+           norm->input(4)});
+      fused->insertBefore(norm);
+      fused->output()->setType(norm->output()->type());
+      norm->output()->replaceAllUsesWith(fused->output());
+      norm->destroy();
+      add->destroy();
+      dropout->destroy();
+      break;
+    }
+  }
+}
+
+bool isCUDATensor(Value* v) {
+  auto type = v->type()->cast<CompleteTensorType>();
+  return type && type->device().is_cuda();
+}
+
+void FuseLinearRelu(Block* block) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* relu = *it;
+    ++it;
+    for (Block* sub : relu->blocks()) {
+      FuseLinearRelu(sub);
+    }
+    if (!relu->matches("aten::relu(Tensor self) -> Tensor")) {
+      continue;
+    }
+    Value* linear = relu->input(0);
+    Node* producer = linear->node();
+    if (producer->owningBlock() != block || linear->uses().size() != 1) {
+      continue;
+    }
+    Value* input;
+    Value* weight;
+    Value* bias;
+    Node* transpose = nullptr;
+    if (producer->matches(
+            "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      input = producer->input(0);
+      weight = producer->input(1);
+      bias = producer->input(2);
+    } else if (
+        producer->matches(
+            "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor",
+            /*const_inputs=*/{attr::beta, attr::alpha}) &&
+        producer->get<at::Scalar>(attr::beta)->toDouble() == 1 &&
+        producer->get<at::Scalar>(attr::alpha)->toDouble() == 1) {
+      // linear on 2-d inputs is scripted as addmm(bias, input, weight.t())
+      Value* mat2 = producer->input(2);
+      transpose = mat2->node();
+      if (!transpose->matches("aten::t(Tensor self) -> Tensor")) {
+        continue;
+      }
+      input = producer->input(1);
+      weight = transpose->input();
+      bias = producer->input(0);
+    } else {
+      continue;
+    }
+    if (!isCUDATensor(input) || !isCUDATensor(weight)) {
+      continue;
+    }
+    Node* fused = block->owningGraph()->create(
+        aten::_linear_relu, {input, weight, bias});
+    fused->insertBefore(relu);
+    fused->output()->setType(relu->output()->type());
+    relu->output()->replaceAllUsesWith(fused->output());
+    relu->destroy();
+    producer->destroy();
+    if (transpose && !transpose->hasUses()) {
+      transpose->destroy();
+    }
+  }
+}
+
+} // namespace
+
+void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph) {
+  FuseDropoutAddLayerNorm(graph->block());
+}
+
+void FuseLinearRelu(std::shared_ptr<Graph>& graph) {
+  FuseLinearRelu(graph->block());
+}
+
 void FuseGraph(std::shared_ptr<Graph>& graph) {
   GraphFuser(graph->block(), graph).run();
   // After FuseGraph some common subexpressions may come back
@@ -19,6 +19,18 @@ constexpr size_t fusion_kernel_args_limit = 128;
 // On Windows will noop, NYI
 TORCH_API void FuseGraph(std::shared_ptr<Graph>& graph);
 
+// Replaces layer_norm(dropout(x) + residual) on CUDA tensors by
+// dropout_add_layer_norm, which runs as a single kernel. The op keeps its own
+// autograd formula, so this has to run before autodiff subgraphs are created,
+// which would otherwise expand the dropout and the layer_norm.
+TORCH_API void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph);
+
+// Replaces relu(linear(x, w, b)), and the addmm(b, x, w.t()) that linear is
+// scripted as for 2-d inputs, on CUDA tensors by _linear_relu, which adds the
+// bias and applies the relu in a single pass over the matrix product. Like
+// FuseDropoutAddLayerNorm, it has to run before autodiff subgraphs are created.
+TORCH_API void FuseLinearRelu(std::shared_ptr<Graph>& graph);
+
 TORCH_API void CustomFuseGraph(
     std::shared_ptr<Graph>& graph,
     std::function<bool(Node*)> is_fusable,
@@ -0,0 +1,141 @@
+#include <torch/csrc/jit/passes/loop_fusion.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isTrueConstant(Value* val) {
+  c10::optional<bool> maybe_value = constant_as<bool>(val);
+  return maybe_value && *maybe_value;
+}
+
+bool isForLoop(Node* node) {
+  if (node->kind() != prim::Loop)
+    return false;
+  Value* start_cond = node->inputs().at(1);
+  Value* continue_cond = node->blocks().at(0)->outputs().at(0);
+  return isTrueConstant(start_cond) && isTrueConstant(continue_cond);
+}
+
+bool sameTripCount(Node* a, Node* b) {
+  Value* a_trip_count = a->inputs().at(0);
+  Value* b_trip_count = b->inputs().at(0);
+  if (a_trip_count == b_trip_count) {
+    return true;
+  }
+  c10::optional<int64_t> a_const = constant_as<int64_t>(a_trip_count);
+  c10::optional<int64_t> b_const = constant_as<int64_t>(b_trip_count);
+  return a_const && b_const && *a_const == *b_const;
+}
+
+// Could the iterations of a loop with this body be interleaved with the
+// iterations of another loop without anyone noticing?
+bool canInterleave(Block* body, const AliasDb& aliasDb) {
+  for (Node* node : body->nodes()) {
+    if (node->kind() == prim::fork || node->kind() == aten::wait ||
+        node->hasSideEffects() || node->isNondeterministic() ||
+        aliasDb.hasWriters(node)) {
+      return false;
+    }
+    for (Block* subblock : node->blocks()) {
+      if (!canInterleave(subblock, aliasDb)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Does `second` (or anything nested in it) use the results of `first`?
+bool dependsOn(Node* second, Node* first) {
+  for (Value* output : first->outputs()) {
+    for (const Use& use : output->uses()) {
+      Node* user = use.user;
+      while (user->owningBlock() != second->owningBlock()) {
+        user = user->owningBlock()->owningNode();
+      }
+      if (user == second) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool canFuse(Node* first, Node* second, const AliasDb& aliasDb) {
+  return isForLoop(first) && isForLoop(second) &&
+      sameTripCount(first, second) && !dependsOn(second, first) &&
+      canInterleave(first->blocks().at(0), aliasDb) &&
+      canInterleave(second->blocks().at(0), aliasDb);
+}
+
+// Appends the body of `second` to the body of `first`, adding the carried
+// values of `second` to the end of the carried values of `first`, and
+// destroys `second`.
+void fuse(Node* first, Node* second, AliasDb& aliasDb) {
+  Block* first_body = first->blocks().at(0);
+  Block* second_body = second->blocks().at(0);
+
+  // Loop node has extra (max_iters, initial_cond) inputs,
+  // body has an extra (loop_counter) input.
+  second_body->inputs().at(0)->replaceAllUsesWith(first_body->inputs().at(0));
+  for (size_t i = 2; i < second->inputs().size(); ++i) {
+    first->addInput(second->inputs()[i]);
+  }
+  for (size_t i = 1; i < second_body->inputs().size(); ++i) {
+    Value* old_input = second_body->inputs()[i];
+    Value* new_input = first_body->addInput()->copyMetadata(old_input);
+    aliasDb.copyValue(old_input, new_input);
+    old_input->replaceAllUsesWith(new_input);
+    aliasDb.eraseValue(old_input);
+  }
+
+  for (auto it = second_body->nodes().begin();
+       it != second_body->nodes().end();) {
+    Node* node = *it;
+    ++it;
+    node->moveBefore(first_body->return_node());
+  }
+  // Body has an extra (continue_cond) output.
+  for (size_t i = 1; i < second_body->outputs().size(); ++i) {
+    first_body->registerOutput(second_body->outputs()[i]);
+  }
+
+  for (Value* old_output : second->outputs()) {
+    Value* new_output = first->addOutput()->copyMetadata(old_output);
+    aliasDb.copyValue(old_output, new_output);
+    old_output->replaceAllUsesWith(new_output);
+    aliasDb.eraseValue(old_output);
+  }
+  aliasDb.eraseNode(second);
+  second->destroy();
+}
+
+void fuseLoops(Block* block, AliasDb& aliasDb) {
+  for (Node* node : block->nodes()) {
+    for (Block* subblock : node->blocks()) {
+      fuseLoops(subblock, aliasDb);
+    }
+  }
+  for (Node* node : block->nodes()) {
+    // Keep fusing into `node` while the loop right after it is compatible.
+    while (node->kind() == prim::Loop && node->next()->kind() == prim::Loop &&
+           canFuse(node, node->next(), aliasDb)) {
+      fuse(node, node->next(), aliasDb);
+    }
+  }
+}
+
+} // anonymous namespace
+
+void FuseLoops(std::shared_ptr<Graph>& graph) {
+  AliasDb aliasDb(graph);
+  fuseLoops(graph->block(), aliasDb);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Fuses adjacent for-loops that run for the same trip count into a single
+// loop. This is intentionally conservative: the second loop must not read
+// anything the first one computes, and neither loop may contain side effects,
+// nondeterministic ops or writes to memory, so interleaving their iterations
+// cannot change the result.
+TORCH_API void FuseLoops(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
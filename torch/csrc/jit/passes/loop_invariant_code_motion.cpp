@@ -0,0 +1,147 @@
+#include <torch/csrc/jit/passes/loop_invariant_code_motion.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isTrueConstant(Value* val) {
+  c10::optional<bool> maybe_value = constant_as<bool>(val);
+  return maybe_value && *maybe_value;
+}
+
+bool isHoistable(
+    Node* node,
+    Block* body,
+    const std::unordered_set<Node*>& hoisted,
+    const AliasDb& aliasDb) {
+  if (node->kind() == prim::Constant) {
+    return true;
+  }
+  // Nodes with blocks are left alone, hoisting them would also require the
+  // whole sub-block to be invariant. Forks are excluded because moving them
+  // changes how many tasks get launched.
+  if (!node->blocks().empty() || node->kind() == prim::fork ||
+      node->kind() == aten::wait || node->hasSideEffects() ||
+      node->isNondeterministic()) {
+    return false;
+  }
+  for (Value* input : node->inputs()) {
+    Node* producer = input->node();
+    if (producer->owningBlock() == body && hoisted.count(producer) == 0) {
+      return false;
+    }
+  }
+  // If anything writes to the inputs they may change between iterations, and
+  // if anything writes to the outputs every iteration needs a fresh value.
+  return !aliasDb.hasWriters(node);
+}
+
+// Returns the condition under which `loop` runs at least once, or nullptr if
+// it can't be expressed without combining two runtime conditions. When the
+// loop is known to run, the returned condition is a true constant.
+Value* entryCondition(Node* loop) {
+  Graph* graph = loop->owningGraph();
+  Value* max_trip_count = loop->inputs().at(0);
+  Value* start_cond = loop->inputs().at(1);
+  c10::optional<int64_t> trip_count = constant_as<int64_t>(max_trip_count);
+  bool runs_some_iterations = trip_count && *trip_count > 0;
+  if (isTrueConstant(start_cond)) {
+    if (runs_some_iterations) {
+      return start_cond;
+    }
+    WithInsertPoint guard(loop);
+    return graph->insert(aten::gt, {max_trip_count, 0});
+  }
+  // while loops have a constant maximum trip count, so only the start
+  // condition has to be checked
+  if (runs_some_iterations) {
+    return start_cond;
+  }
+  return nullptr;
+}
+
+// Moves `loop` into the true branch of a new prim::If on `cond`. The false
+// branch forwards the initial values of the loop-carried variables, which is
+// what the loop would return if it didn't run.
+void wrapInGuard(Node* loop, Value* cond, AliasDb& aliasDb) {
+  Graph* graph = loop->owningGraph();
+  Node* guard = graph->create(prim::If, {cond}, 0)->insertBefore(loop);
+  Block* then_block = guard->addBlock();
+  Block* else_block = guard->addBlock();
+  for (size_t i = 0; i < loop->outputs().size(); ++i) {
+    Value* loop_output = loop->outputs()[i];
+    Value* output = guard->addOutput()->setType(loop_output->type());
+    aliasDb.copyValue(loop_output, output);
+    loop_output->replaceAllUsesWith(output);
+    then_block->registerOutput(loop_output);
+    // Loop node has extra (max_iters, initial_cond) inputs
+    else_block->registerOutput(loop->inputs().at(i + 2));
+  }
+  loop->moveBefore(then_block->return_node());
+}
+
+void hoistLoop(Node* loop, AliasDb& aliasDb) {
+  Block* body = loop->blocks().at(0);
+  std::unordered_set<Node*> hoisted;
+  std::vector<Node*> constants;
+  std::vector<Node*> invariants;
+  for (Node* node : body->nodes()) {
+    if (!isHoistable(node, body, hoisted, aliasDb)) {
+      continue;
+    }
+    hoisted.insert(node);
+    if (node->kind() == prim::Constant) {
+      constants.push_back(node);
+    } else {
+      invariants.push_back(node);
+    }
+  }
+  // Constants alone are not worth a guard, constant pooling moves them out.
+  if (invariants.empty()) {
+    return;
+  }
+  Value* cond = entryCondition(loop);
+  if (!cond) {
+    return;
+  }
+  for (Node* node : constants) {
+    node->moveBefore(loop);
+  }
+  if (!isTrueConstant(cond)) {
+    wrapInGuard(loop, cond, aliasDb);
+  }
+  for (Node* node : invariants) {
+    node->moveBefore(loop);
+  }
+}
+
+void hoistLoopInvariants(Block* block, AliasDb& aliasDb) {
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* node = *it;
+    // XXX: advance the iterator first, since hoisting may wrap `node` in an If
+    ++it;
+    // Inner loops go first, so their invariants can be hoisted further out.
+    for (Block* subblock : node->blocks()) {
+      hoistLoopInvariants(subblock, aliasDb);
+    }
+    if (node->kind() == prim::Loop) {
+      hoistLoop(node, aliasDb);
+    }
+  }
+}
+
+} // anonymous namespace
+
+void HoistLoopInvariants(std::shared_ptr<Graph>& graph) {
+  AliasDb aliasDb(graph);
+  hoistLoopInvariants(graph->block(), aliasDb);
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Moves nodes whose result is the same on every iteration of a prim::Loop
+// (e.g. the transpose of a weight in a decoder step) in front of the loop.
+// A node is only hoisted if all of its inputs are defined outside of the loop
+// body, it has no side effects, and alias analysis shows that nothing writes
+// to its inputs or outputs. Loops that may run zero times are wrapped in a
+// prim::If so the hoisted nodes still only run when the loop does.
+TORCH_API void HoistLoopInvariants(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,244 @@
+#include <torch/csrc/jit/passes/memory_planning.h>
+
+#include <ATen/core/interned_strings.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// All buffers start at a multiple of this many bytes in the arena, which is
+// enough for any scalar type and for vectorized kernels.
+constexpr int64_t kBufferAlignment = 64;
+
+struct PlannedValue {
+  Node* node;
+  std::shared_ptr<Operator> out_op;
+  int64_t nbytes;
+  // The top-level nodes between which the value (or anything that may alias
+  // it) is live, inclusive.
+  size_t begin;
+  size_t end;
+  int64_t offset;
+};
+
+// Returns the out= overload of the operator of n: the same arguments followed
+// by a single tensor `out` that is written to, or nullptr.
+std::shared_ptr<Operator> findOutVariant(Node* n) {
+  const auto schema = n->maybeSchema();
+  if (!schema || schema->returns().size() != 1 || schema->is_vararg()) {
+    return nullptr;
+  }
+  const auto& args = schema->arguments();
+  for (const auto& op : getAllOperatorsFor(n->kind())) {
+    const auto& out_schema = op->schema();
+    const auto& out_args = out_schema.arguments();
+    if (out_schema.returns().size() != 1 ||
+        out_args.size() != args.size() + 1) {
+      continue;
+    }
+    const auto& out = out_args.back();
+    if (out.name() != "out" || !out.alias_info() ||
+        !out.alias_info()->isWrite()) {
+      continue;
+    }
+    bool same_args = true;
+    for (size_t i = 0; i < args.size(); ++i) {
+      if (out_args[i].name() != args[i].name() ||
+          *out_args[i].type() != *args[i].type()) {
+        same_args = false;
+        break;
+      }
+    }
+    if (same_args) {
+      return op;
+    }
+  }
+  return nullptr;
+}
+
+// Nodes that have an out= overload selected by the interpreter when they get
+// the buffer as an extra input.
+std::shared_ptr<Operator> findPlannableOp(Graph& graph, Node* n) {
+  if (n->outputs().size() != 1 || !n->blocks().empty()) {
+    return nullptr;
+  }
+  auto op = findOutVariant(n);
+  if (!op) {
+    return nullptr;
+  }
+  auto trial = graph.create(n->kind(), n->inputs(), 1);
+  trial->addInput(n->output());
+  trial->output()->setType(n->output()->type());
+  const bool selected = findOperatorFor(trial) == op;
+  trial->destroy();
+  return selected ? op : nullptr;
+}
+
+void collectValues(Block* block, std::vector<Value*>& values) {
+  for (auto input : block->inputs()) {
+    values.push_back(input);
+  }
+  for (auto n : block->nodes()) {
+    for (auto output : n->outputs()) {
+      values.push_back(output);
+    }
+    for (auto b : n->blocks()) {
+      collectValues(b, values);
+    }
+  }
+}
+
+// Greedily assigns offsets, largest buffers first, placing each buffer at the
+// lowest offset that doesn't overlap any buffer live at the same time.
+int64_t assignOffsets(std::vector<PlannedValue>& planned) {
+  std::vector<PlannedValue*> order;
+  for (auto& p : planned) {
+    order.push_back(&p);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [](PlannedValue* a, PlannedValue* b) {
+        return a->nbytes > b->nbytes;
+      });
+
+  int64_t arena_size = 0;
+  std::vector<PlannedValue*> assigned;
+  for (auto p : order) {
+    std::vector<PlannedValue*> live;
+    for (auto other : assigned) {
+      if (other->begin <= p->end && p->begin <= other->end) {
+        live.push_back(other);
+      }
+    }
+    std::sort(live.begin(), live.end(), [](PlannedValue* a, PlannedValue* b) {
+      return a->offset < b->offset;
+    });
+    int64_t offset = 0;
+    for (auto other : live) {
+      if (offset + p->nbytes <= other->offset) {
+        break;
+      }
+      offset = std::max(offset, other->offset + other->nbytes);
+    }
+    p->offset = offset;
+    arena_size = std::max(arena_size, offset + p->nbytes);
+    assigned.push_back(p);
+  }
+  return arena_size;
+}
+
+} // namespace
+
+void PlanMemory(std::shared_ptr<Graph>& graph) {
+  AliasDb aliasDb(graph);
+  std::unordered_map<Node*, size_t> positions;
+  size_t position = 0;
+  for (auto n : graph->nodes()) {
+    // we can't tell what is safe to share in the presence of untracked
+    // effects
+    if (aliasDb.hasUntrackedEffects(n)) {
+      return;
+    }
+    positions[n] = position++;
+  }
+  // the graph outputs are used at the very end
+  positions[graph->return_node()] = position;
+
+  // Uses in nested blocks keep a value live until the end of the top-level
+  // node holding the block.
+  auto topLevelPosition = [&](Node* n) {
+    while (n->owningBlock() != graph->block()) {
+      n = n->owningBlock()->owningNode();
+    }
+    return positions.at(n);
+  };
+
+  std::vector<Value*> values;
+  collectValues(graph->block(), values);
+
+  std::vector<PlannedValue> planned;
+  for (auto n : graph->nodes()) {
+    auto type = n->outputs().size() == 1
+        ? n->output()->type()->cast<CompleteTensorType>()
+        : nullptr;
+    if (!type || !type->device().is_cpu() || type->requires_grad() ||
+        type->numel() == 0) {
+      continue;
+    }
+    auto v = n->output();
+    if (aliasDb.mayContainAlias({v}, graph->inputs()) ||
+        aliasDb.mayContainAlias({v}, graph->outputs())) {
+      continue;
+    }
+    auto out_op = findPlannableOp(*graph, n);
+    if (!out_op) {
+      continue;
+    }
+
+    PlannedValue p;
+    p.node = n;
+    p.out_op = std::move(out_op);
+    p.nbytes = at::elementSize(type->scalarType()) * type->numel();
+    p.nbytes = (p.nbytes + kBufferAlignment - 1) / kBufferAlignment *
+        kBufferAlignment;
+    p.begin = positions.at(n);
+    p.end = p.begin;
+    p.offset = 0;
+    for (auto w : values) {
+      if (w != v && !aliasDb.mayContainAlias(v, w)) {
+        continue;
+      }
+      for (const auto& use : w->uses()) {
+        p.end = std::max(p.end, topLevelPosition(use.user));
+      }
+    }
+    planned.push_back(std::move(p));
+  }
+  if (planned.empty()) {
+    return;
+  }
+
+  const int64_t arena_size = assignOffsets(planned);
+  Value* arena;
+  {
+    WithInsertPoint guard(*graph->nodes().begin());
+    auto nbytes = graph->insertConstant(arena_size);
+    arena = graph->insertNode(graph->create(prim::MemoryArena, {nbytes}))
+                ->output()
+                ->setType(TensorType::get());
+  }
+
+  for (auto& p : planned) {
+    auto n = p.node;
+    auto v = n->output();
+    auto type = v->type()->expect<CompleteTensorType>();
+    WithInsertPoint guard(n);
+    auto buffer =
+        graph
+            ->insertNode(graph->create(
+                prim::ArenaBuffer,
+                {arena,
+                 graph->insertConstant(p.offset),
+                 graph->insertConstant(type->sizes()),
+                 graph->insertConstant(
+                     static_cast<int64_t>(type->scalarType()))}))
+            ->output()
+            ->setType(v->type());
+    auto out_node = graph->insertNode(graph->create(n->kind(), n->inputs(), 1));
+    out_node->addInput(buffer);
+    out_node->output()->setType(v->type());
+    AT_ASSERT(findOperatorFor(out_node) == p.out_op);
+    v->replaceAllUsesWith(out_node->output());
+    n->destroy();
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Statically plans the memory of the intermediate tensors of an inference
+// graph. Every CPU tensor produced by a top-level node whose sizes are fully
+// known (CompleteTensorType) and whose operator has an out= overload is
+// assigned an offset in a single arena, allocated once per run by
+// prim::MemoryArena. The node is rewritten to write into a prim::ArenaBuffer
+// view of the arena, and tensors whose lifetimes don't overlap share memory.
+//
+// The sizes are only trusted, so this should only run on graphs whose inputs
+// are guaranteed to have the sizes in their types, and that won't be
+// differentiated. Values that may alias the graph inputs or outputs are left
+// alone.
+TORCH_API void PlanMemory(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
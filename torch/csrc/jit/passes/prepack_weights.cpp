@@ -0,0 +1,190 @@
+#include <torch/csrc/jit/passes/prepack_weights.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+bool isFloatCPU(const Value* v, int64_t dim = -1) {
+  auto type = v->type()->cast<CompleteTensorType>();
+  return type && type->scalarType() == at::kFloat &&
+      type->device().is_cpu() && (dim < 0 || type->dim() == dim);
+}
+
+c10::optional<at::Tensor> constantFloatTensor(const Value* v, int64_t dim) {
+  if (v->node()->kind() != prim::Constant) {
+    return c10::nullopt;
+  }
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  auto t = ival->toTensor();
+  if (!t.defined() || t.is_mkldnn() || t.layout() != at::kStrided ||
+      !t.device().is_cpu() || t.scalar_type() != at::kFloat ||
+      t.dim() != dim) {
+    return c10::nullopt;
+  }
+  return t;
+}
+
+bool isConstantIntList(const Node* n, Symbol name, int64_t value) {
+  auto list = n->get<std::vector<int64_t>>(name);
+  return list &&
+      std::all_of(list->begin(), list->end(), [&](int64_t v) {
+        return v == value;
+      });
+}
+
+bool isConstantFalse(const Node* n, Symbol name) {
+  auto v = n->get<bool>(name);
+  return v && !*v;
+}
+
+Value* insertPackedConstant(Graph& graph, at::Tensor packed, Node* user) {
+  Node* constant = graph.create(prim::Constant);
+  constant->t_(attr::value, std::move(packed));
+  // the packed weight is opaque, its sizes say nothing about the weight
+  constant->output()->setType(TensorType::get());
+  constant->insertBefore(user);
+  return constant->output();
+}
+
+// Creates `kind(inputs)` in place of `n`, with the output type of `n`.
+void replaceNode(Graph& graph, Node* n, Symbol kind, at::ArrayRef<Value*> inputs) {
+  Node* replacement = graph.create(kind, inputs);
+  replacement->insertBefore(n);
+  replacement->output()->setType(n->output()->type());
+  n->output()->replaceAllUsesWith(replacement->output());
+}
+
+// Returns the weight of the linear layer computing `input * mat2`, if mat2 is
+// the transpose of a constant, as in the addmm and matmul nodes
+// nn.functional.linear is traced to.
+c10::optional<at::Tensor> transposedWeight(Value* mat2) {
+  if (mat2->node()->kind() == aten::t) {
+    return constantFloatTensor(mat2->node()->input(), 2);
+  }
+  if (auto weight_t = constantFloatTensor(mat2, 2)) {
+    return weight_t->t();
+  }
+  return c10::nullopt;
+}
+
+bool prepackLinear(Graph& graph, Node* n) {
+  if (!at::hasMKL()) {
+    return false;
+  }
+  Value* input = nullptr;
+  Value* bias = nullptr;
+  c10::optional<at::Tensor> weight;
+  if (n->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+    input = n->input(0);
+    weight = constantFloatTensor(n->input(1), 2);
+    bias = n->input(2);
+  } else if (n->matches(
+                 "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor",
+                 /*const_inputs=*/{attr::beta, attr::alpha})) {
+    // only the broadcast of a bias vector is a linear layer
+    if (!isFloatCPU(n->input(0), 1) ||
+        n->get<at::Scalar>(attr::alpha)->toDouble() != 1.0 ||
+        n->get<at::Scalar>(attr::beta)->toDouble() != 1.0) {
+      return false;
+    }
+    input = n->input(1);
+    weight = transposedWeight(n->input(2));
+    bias = n->input(0);
+  } else if (n->matches(
+                 "aten::matmul(Tensor self, Tensor other) -> Tensor")) {
+    input = n->input(0);
+    weight = transposedWeight(n->input(1));
+  } else {
+    return false;
+  }
+  if (!weight || !isFloatCPU(input) ||
+      (bias && !bias->mustBeNone() && !isFloatCPU(bias, 1))) {
+    return false;
+  }
+  if (!bias) {
+    bias = graph.createNone(TensorType::get())->insertBefore(n)->output();
+  }
+  replaceNode(
+      graph,
+      n,
+      aten::mkl_linear_packed_weight,
+      {input,
+       insertPackedConstant(graph, at::mkl_pack_linear_weight(*weight), n),
+       bias});
+  return true;
+}
+
+bool prepackConv2d(Graph& graph, Node* n) {
+  bool is_convolution = n->matches(
+      "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor");
+  if ((!is_convolution &&
+       !n->matches(
+           "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) ||
+      !at::hasMKLDNN()) {
+    return false;
+  }
+  // the MKL-DNN convolution supports neither dilation nor transposition
+  auto weight = constantFloatTensor(n->input(1), 4);
+  if (!weight || !isFloatCPU(n->input(0), 4) ||
+      !isConstantIntList(n, attr::dilation, 1) ||
+      (is_convolution && !isConstantFalse(n, attr::transposed)) ||
+      !n->is_constant(attr::stride) || !n->is_constant(attr::padding) ||
+      !n->is_constant(attr::groups)) {
+    return false;
+  }
+  auto packed = at::mkldnn_reorder_conv2d_weight(
+      weight->to_mkldnn(),
+      *n->get<std::vector<int64_t>>(attr::padding),
+      *n->get<std::vector<int64_t>>(attr::stride),
+      *n->get<std::vector<int64_t>>(attr::dilation),
+      *n->get<int64_t>(attr::groups));
+  replaceNode(
+      graph,
+      n,
+      aten::mkldnn_convolution,
+      {n->namedInput(attr::input),
+       insertPackedConstant(graph, std::move(packed), n),
+       n->namedInput(attr::bias),
+       n->namedInput(attr::padding),
+       n->namedInput(attr::stride),
+       n->namedInput(attr::dilation),
+       n->namedInput(attr::groups)});
+  return true;
+}
+
+bool prepackWeights(Graph& graph, Block* block) {
+  bool changed = false;
+  for (Node* n : block->nodes()) {
+    for (Block* sub : n->blocks()) {
+      changed |= prepackWeights(graph, sub);
+    }
+    changed |= prepackLinear(graph, n) || prepackConv2d(graph, n);
+  }
+  return changed;
+}
+
+} // namespace
+
+void PrepackWeights(std::shared_ptr<Graph>& graph) {
+  // the packed weights are constants of an inference graph, not parameters
+  autograd::AutoGradMode no_grad(false);
+  if (prepackWeights(*graph, graph->block())) {
+    EliminateDeadCode(graph);
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Replaces the constant weights of float CPU linear layers (aten::linear, or
+// the addmm and matmul nodes a traced nn.Linear becomes) and 2-d convolutions
+// by handles to weights packed once, ahead of time, so inference no longer
+// re-reads and re-lays out the weights on every call. Linear weights are
+// packed for the MKL packed GEMM (aten::mkl_linear_packed_weight) and
+// convolution weights are reordered into the blocked MKL-DNN format
+// (aten::mkldnn_convolution); a node is left alone if the library it needs
+// is not available.
+//
+// Only weights that are graph constants are packed, e.g. those of a module
+// traced as a closure once its parameters no longer require grad. The pass
+// needs complete input types and is meant for inference only; the packed
+// constants can not be serialized. Run ConvertToMKLDNN first when using both,
+// so that chains of MKL-DNN operators stay on MKL-DNN tensors.
+TORCH_API void PrepackWeights(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
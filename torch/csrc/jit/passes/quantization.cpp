@@ -1,9 +1,17 @@
 #include <torch/csrc/jit/passes/quantization.h>
 
+#include <ATen/ATen.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/variable.h>
+#include <torch/csrc/jit/constants.h>
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/node_hashing.h>
 #include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
 
+#include <algorithm>
+#include <cmath>
 #include <stack>
 
 namespace torch {
@@ -21,7 +29,10 @@ stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor",
       "aten::relu(Tensor self) -> Tensor",
       "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] \
 stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, \
-int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor"};
+int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor",
+      "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor",
+      "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, \
+Scalar alpha) -> Tensor"};
   return quantnodeLookup.find(n);
 }
 
@@ -417,6 +428,417 @@ void InsertQuantDequantNodes(
   }
 }
 
+namespace {
+
+Symbol quantizeLinearSymbol() {
+  static const Symbol sym = Symbol::fromQualString("aten::quantize_linear");
+  return sym;
+}
+
+Symbol dequantizeSymbol() {
+  static const Symbol sym = Symbol::fromQualString("aten::dequantize");
+  return sym;
+}
+
+bool isQuantizedLinear(const Node* n) {
+  static const Symbol linear =
+      Symbol::fromQualString("quantized::fbgemm_linear");
+  static const Symbol linear_relu =
+      Symbol::fromQualString("quantized::fbgemm_linear_relu");
+  return n->kind() == linear || n->kind() == linear_relu;
+}
+
+// InsertQuantDequantNodes spells fake quantization through the integer
+// representation of the quantized tensor, which no kernel dequantizes.
+void rewriteIntReprChains(std::shared_ptr<Graph>& graph) {
+  std::string pattern = R"IR(
+graph(%x, %scale, %zero_point):
+  %x_quant = aten::quantize_linear(%x, %scale, %zero_point)
+  %x_intrepr = aten::int_repr(%x_quant)
+  %x_dequant = aten::dequantize_linear(%x_intrepr, %scale, %zero_point)
+  return (%x_dequant))IR";
+  std::string replacement = R"IR(
+graph(%x, %scale, %zero_point):
+  %x_quant = aten::quantize_linear(%x, %scale, %zero_point)
+  %x_dequant = aten::dequantize(%x_quant)
+  return (%x_dequant))IR";
+  SubgraphRewriter rewriter;
+  rewriter.RegisterRewritePattern(pattern, replacement);
+  rewriter.runOnGraph(graph);
+}
+
+using QParams = std::pair<double, int64_t>;
+
+c10::optional<QParams> constantQParams(Value* scale, Value* zero_point) {
+  auto s = constant_as<double>(scale);
+  auto z = constant_as<int64_t>(zero_point);
+  if (!s || !z) {
+    return c10::nullopt;
+  }
+  return QParams(*s, *z);
+}
+
+// The qparams a quantized tensor was produced with, if they are constants.
+c10::optional<QParams> quantizedWith(Value* q) {
+  Node* n = q->node();
+  if (n->kind() == quantizeLinearSymbol() && n->inputs().size() == 3) {
+    return constantQParams(n->input(1), n->input(2));
+  }
+  if (isQuantizedLinear(n)) {
+    return constantQParams(n->input(3), n->input(4));
+  }
+  return c10::nullopt;
+}
+
+// quantize_linear(dequantize(q), scale, zero_point) is q itself when q was
+// quantized with the same qparams.
+bool foldRequantization(Node* n) {
+  if (n->kind() != quantizeLinearSymbol() || n->inputs().size() != 3 ||
+      n->input(0)->node()->kind() != dequantizeSymbol()) {
+    return false;
+  }
+  Value* q = n->input(0)->node()->input();
+  auto qparams = quantizedWith(q);
+  if (!qparams || qparams != constantQParams(n->input(1), n->input(2))) {
+    return false;
+  }
+  n->output()->replaceAllUsesWith(q);
+  return true;
+}
+
+bool foldRequantizations(Block* block) {
+  bool changed = false;
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    Node* n = *it++;
+    for (Block* sub : n->blocks()) {
+      changed |= foldRequantizations(sub);
+    }
+    if (foldRequantization(n)) {
+      n->destroy();
+      changed = true;
+    }
+  }
+  return changed;
+}
+
+c10::optional<at::Tensor> constantFloatTensor(Value* v, int64_t dim) {
+  if (v->node()->kind() != prim::Constant) {
+    return c10::nullopt;
+  }
+  auto ival = toIValue(v);
+  if (!ival || !ival->isTensor()) {
+    return c10::nullopt;
+  }
+  auto t = ival->toTensor();
+  if (!t.defined() || t.layout() != at::kStrided || !t.device().is_cpu() ||
+      t.scalar_type() != at::kFloat || t.dim() != dim) {
+    return c10::nullopt;
+  }
+  return autograd::as_variable_ref(t).data();
+}
+
+// An undefined tensor stands for a bias of None.
+c10::optional<at::Tensor> constantBias(Value* v) {
+  if (v->mustBeNone()) {
+    return at::Tensor();
+  }
+  return constantFloatTensor(v, 1);
+}
+
+// The weights of traced linear layers reach aten::addmm transposed, and
+// their transpose is observed and fake quantized like any activation.
+c10::optional<at::Tensor> transposedWeight(Value* mat2) {
+  Node* n = mat2->node();
+  if (n->kind() == dequantizeSymbol() &&
+      n->input()->node()->kind() == quantizeLinearSymbol()) {
+    mat2 = n->input()->node()->input(0);
+  }
+  if (mat2->node()->kind() == aten::t) {
+    return constantFloatTensor(mat2->node()->input(), 2);
+  }
+  if (auto weight_t = constantFloatTensor(mat2, 2)) {
+    return weight_t->t();
+  }
+  return c10::nullopt;
+}
+
+bool isConstantIntList(const Node* n, Symbol name, int64_t value) {
+  auto list = n->get<std::vector<int64_t>>(name);
+  return list &&
+      std::all_of(list->begin(), list->end(), [&](int64_t v) {
+        return v == value;
+      });
+}
+
+// Affine quantization of [min, max] to the uint8 range. The range is widened
+// to contain zero, so that zero, e.g. padding, is exact.
+QParams chooseQParams(float min, float max) {
+  min = std::min(min, 0.f);
+  max = std::max(max, 0.f);
+  double scale = (static_cast<double>(max) - min) / 255;
+  if (scale == 0) {
+    scale = 1;
+  }
+  int64_t zero_point = static_cast<int64_t>(std::nearbyint(-min / scale));
+  zero_point = std::min<int64_t>(std::max<int64_t>(zero_point, 0), 255);
+  return QParams(scale, zero_point);
+}
+
+struct QuantizedWeight {
+  at::Tensor weight;
+  // one scale per tensor, or per output channel
+  at::Tensor scales;
+};
+
+QuantizedWeight quantizeWeight(const at::Tensor& weight, bool per_channel) {
+  if (!per_channel) {
+    auto qparams =
+        chooseQParams(weight.min().item<float>(), weight.max().item<float>());
+    return {at::quantize_linear(weight, qparams.first, qparams.second),
+            at::full({1}, qparams.first, at::kFloat)};
+  }
+  const int64_t channels = weight.size(0);
+  auto rows = weight.reshape({channels, -1});
+  auto mins = std::get<0>(rows.min(1));
+  auto maxs = std::get<0>(rows.max(1));
+  auto min_acc = mins.accessor<float, 1>();
+  auto max_acc = maxs.accessor<float, 1>();
+  std::vector<double> scales;
+  std::vector<int64_t> zero_points;
+  for (int64_t c = 0; c < channels; ++c) {
+    auto qparams = chooseQParams(min_acc[c], max_acc[c]);
+    scales.push_back(qparams.first);
+    zero_points.push_back(qparams.second);
+  }
+  return {at::quantize_linear_per_channel(
+              weight, at::tensor(scales), at::tensor(zero_points), {0}),
+          at::tensor(scales).to(at::kFloat)};
+}
+
+// The int32 bias of the fbgemm kernels is quantized with the scale of the
+// product of the input and weight, and a zero point of 0.
+at::Tensor quantizeBias(
+    const at::Tensor& bias,
+    double input_scale,
+    const QuantizedWeight& weight) {
+  if (!bias.defined()) {
+    return at::zeros({weight.weight.size(0)}, at::kInt);
+  }
+  return (bias / (weight.scales * input_scale)).round().to(at::kInt);
+}
+
+// Runs `kind(inputs)` on constant inputs and inserts the opaque result.
+Value* insertPacked(
+    Graph& graph,
+    const char* kind,
+    at::ArrayRef<NamedValue> inputs) {
+  Node* call = graph.insert(Symbol::fromQualString(kind), inputs)->node();
+  Stack stack;
+  for (Value* input : call->inputs()) {
+    stack.push_back(*toIValue(input));
+  }
+  getOperation(call)(stack);
+  Node* constant = graph.create(prim::Constant);
+  constant->t_(attr::value, stack.back().toTensor());
+  // the packed weight is opaque, its sizes say nothing about the weight
+  constant->output()->setType(TensorType::get());
+  constant->insertBefore(call);
+  call->output()->replaceAllUsesWith(constant->output());
+  call->destroy();
+  return constant->output();
+}
+
+// The quantization of the output of `n`, through a relu when the relu can be
+// fused into the kernel.
+struct OutputQuantization {
+  Node* relu;
+  Node* quant;
+  QParams qparams;
+};
+
+c10::optional<OutputQuantization> outputQuantization(Node* n) {
+  auto soleUser = [](Value* v, Symbol kind) -> Node* {
+    if (v->uses().size() != 1 || v->uses()[0].user->kind() != kind) {
+      return nullptr;
+    }
+    return v->uses()[0].user;
+  };
+  Node* quant = soleUser(n->output(), quantizeLinearSymbol());
+  auto qparams = quant ? quantizedWith(quant->output()) : c10::nullopt;
+  if (!qparams) {
+    return c10::nullopt;
+  }
+  if (Node* dequant = soleUser(quant->output(), dequantizeSymbol())) {
+    if (Node* relu = soleUser(dequant->output(), aten::relu)) {
+      Node* relu_quant = soleUser(relu->output(), quantizeLinearSymbol());
+      auto relu_qparams =
+          relu_quant ? quantizedWith(relu_quant->output()) : c10::nullopt;
+      if (relu_qparams) {
+        return OutputQuantization{relu, relu_quant, *relu_qparams};
+      }
+    }
+  }
+  return OutputQuantization{nullptr, quant, *qparams};
+}
+
+// The quantized tensor `input` is the dequantization of, with the qparams it
+// was quantized with.
+c10::optional<std::pair<Value*, QParams>> quantizedInput(Value* input) {
+  if (input->node()->kind() != dequantizeSymbol()) {
+    return c10::nullopt;
+  }
+  Value* q = input->node()->input();
+  auto qparams = quantizedWith(q);
+  if (!qparams) {
+    return c10::nullopt;
+  }
+  return std::make_pair(q, *qparams);
+}
+
+bool isDim(const Value* v, int64_t dim) {
+  auto type = v->type()->cast<DimensionedTensorType>();
+  return type && type->dim() == dim;
+}
+
+bool fuseLinear(Graph& graph, Node* n, bool per_channel) {
+  Value* input = nullptr;
+  c10::optional<at::Tensor> weight;
+  c10::optional<at::Tensor> bias;
+  if (n->matches(
+          "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+    // the kernel flattens its input to a matrix
+    if (!isDim(n->input(0), 2)) {
+      return false;
+    }
+    input = n->input(0);
+    weight = constantFloatTensor(n->input(1), 2);
+    bias = constantBias(n->input(2));
+  } else if (n->matches(
+                 "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor",
+                 /*const_inputs=*/{attr::beta, attr::alpha})) {
+    // only the broadcast of a bias vector is a linear layer
+    if (n->get<at::Scalar>(attr::alpha)->toDouble() != 1.0 ||
+        n->get<at::Scalar>(attr::beta)->toDouble() != 1.0) {
+      return false;
+    }
+    input = n->input(1);
+    weight = transposedWeight(n->input(2));
+    bias = constantFloatTensor(n->input(0), 1);
+  } else {
+    return false;
+  }
+  auto quantized_input = quantizedInput(input);
+  auto output = outputQuantization(n);
+  if (!weight || !bias || !quantized_input || !output) {
+    return false;
+  }
+
+  auto qweight = quantizeWeight(*weight, per_channel);
+  WithInsertPoint guard(output->quant);
+  Value* packed =
+      insertPacked(graph, "quantized::fbgemm_linear_prepack", {qweight.weight});
+  Value* qbias = graph.insertConstant(
+      quantizeBias(*bias, quantized_input->second.first, qweight));
+  Value* result = graph.insert(
+      Symbol::fromQualString(
+          output->relu ? "quantized::fbgemm_linear_relu"
+                       : "quantized::fbgemm_linear"),
+      {quantized_input->first,
+       packed,
+       qbias,
+       output->qparams.first,
+       output->qparams.second});
+  output->quant->output()->replaceAllUsesWith(result);
+  return true;
+}
+
+bool fuseConv2d(Graph& graph, Node* n) {
+  bool is_convolution = n->matches(
+      "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor");
+  if (!is_convolution &&
+      !n->matches(
+          "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+    return false;
+  }
+  // the fbgemm convolution supports neither dilation nor transposition
+  auto weight = constantFloatTensor(n->namedInput(attr::weight), 4);
+  auto bias = constantBias(n->namedInput(attr::bias));
+  auto groups = n->get<int64_t>(attr::groups);
+  auto transposed = n->get<bool>(attr::transposed);
+  if (!weight || !bias || !groups ||
+      !isConstantIntList(n, attr::dilation, 1) ||
+      (is_convolution && (!transposed || *transposed))) {
+    return false;
+  }
+  auto quantized_input = quantizedInput(n->namedInput(attr::input));
+  auto output = outputQuantization(n);
+  if (!quantized_input || !output) {
+    return false;
+  }
+
+  // the kernel takes NHWC activations and KRSC weights
+  const std::vector<int64_t> to_nhwc = {0, 2, 3, 1};
+  const std::vector<int64_t> to_nchw = {0, 3, 1, 2};
+  auto qweight = quantizeWeight(
+      weight->permute(to_nhwc).contiguous(), /*per_channel=*/false);
+  WithInsertPoint guard(output->quant);
+  Value* packed = insertPacked(
+      graph, "quantized::fbgemm_conv_prepack", {qweight.weight, *groups});
+  Value* qbias = graph.insertConstant(
+      quantizeBias(*bias, quantized_input->second.first, qweight));
+  // quantized tensors can't be made contiguous, so the layouts are converted
+  // in floats, where requantizing with the same qparams is exact
+  Value* input = graph.insert(
+      aten::permute, {n->namedInput(attr::input), IValue(to_nhwc)});
+  Value* qinput = graph.insert(
+      quantizeLinearSymbol(),
+      {input, quantized_input->second.first, quantized_input->second.second});
+  Value* result = graph.insert(
+      Symbol::fromQualString(
+          output->relu ? "quantized::fbgemm_conv2d_relu"
+                       : "quantized::fbgemm_conv2d"),
+      {qinput,
+       packed,
+       qbias,
+       n->namedInput(attr::stride),
+       n->namedInput(attr::padding),
+       n->namedInput(attr::dilation),
+       *groups,
+       output->qparams.first,
+       output->qparams.second});
+  result = graph.insert(dequantizeSymbol(), {result});
+  result = graph.insert(aten::permute, {result, IValue(to_nchw)});
+  result = graph.insert(
+      quantizeLinearSymbol(),
+      {result, output->qparams.first, output->qparams.second});
+  output->quant->output()->replaceAllUsesWith(result);
+  return true;
+}
+
+bool fuseQuantizedOps(Graph& graph, Block* block, bool per_channel) {
+  bool changed = false;
+  for (Node* n : block->nodes()) {
+    for (Block* sub : n->blocks()) {
+      changed |= fuseQuantizedOps(graph, sub, per_channel);
+    }
+    changed |= fuseLinear(graph, n, per_channel) || fuseConv2d(graph, n);
+  }
+  return changed;
+}
+
+} // namespace
+
+void QuantFusion(std::shared_ptr<Graph>& graph, bool per_channel) {
+  // the quantized weights are constants of an inference graph, not parameters
+  autograd::AutoGradMode no_grad(false);
+  rewriteIntReprChains(graph);
+  foldRequantizations(graph->block());
+  if (fuseQuantizedOps(*graph, graph->block(), per_channel)) {
+    foldRequantizations(graph->block());
+  }
+  EliminateDeadCode(graph);
+}
+
 void QuantLinting(std::shared_ptr<Graph>& graph) {
   throw std::runtime_error("Pass not implemented yet!");
 }
@@ -62,6 +62,25 @@ TORCH_API void InsertQuantDequantNodes(
     const std::unordered_map<std::string, std::tuple<std::string, float, int>>&
         qparam_dict);
 
+/** \brief Replaces quant-dequant nodes around quantizable ops by quantized
+ * kernels.
+ *
+ * The quant-int_repr-dequant chains inserted by InsertQuantDequantNodes are
+ * first rewritten into runnable aten::quantize_linear - aten::dequantize
+ * pairs. Linear layers and 2d convolutions with constant weights whose inputs
+ * and outputs are quantized are then replaced by the fbgemm kernels, with the
+ * weights quantized and prepacked once and a relu on the output fused in.
+ * Finally, dequantize - quantize pairs that requantize a tensor with its own
+ * qparams are removed.
+ * \param graph whose quant-dequant nodes are replaced.
+ * \param per_channel quantizes the weights of linear layers with one scale and
+ * zero point per output channel. The weights of convolutions are always
+ * quantized per tensor.
+ */
+TORCH_API void QuantFusion(
+    std::shared_ptr<Graph>& graph,
+    bool per_channel = false);
+
 /** \brief Check that all expected optimizations after quant-dequant nodes
  * insertion actually happened.
  *
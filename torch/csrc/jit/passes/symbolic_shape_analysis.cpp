@@ -0,0 +1,810 @@
+#include <torch/csrc/jit/passes/symbolic_shape_analysis.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/utils/memory.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// A size that is either concrete, or a symbol standing for a size that is
+// only known at runtime. Sizes with the same symbol are equal.
+struct Dim {
+  static Dim concrete(int64_t size) {
+    return Dim{size, false};
+  }
+  bool isConcrete(int64_t size) const {
+    return !is_symbol && value == size;
+  }
+  bool operator==(const Dim& other) const {
+    return value == other.value && is_symbol == other.is_symbol;
+  }
+  bool operator!=(const Dim& other) const {
+    return !(*this == other);
+  }
+
+  int64_t value;
+  bool is_symbol;
+};
+
+using Shape = std::vector<Dim>;
+
+// The product of some sizes, as a concrete factor times their symbols.
+struct Product {
+  template <typename It>
+  Product(It begin, It end) {
+    for (It it = begin; it != end; ++it) {
+      if (it->is_symbol) {
+        symbols.push_back(it->value);
+      } else {
+        factor *= it->value;
+      }
+    }
+  }
+
+  // Divides the product by d, if d provably divides it.
+  bool divide(const Dim& d) {
+    if (d.is_symbol) {
+      auto it = std::find(symbols.begin(), symbols.end(), d.value);
+      if (it == symbols.end()) {
+        return false;
+      }
+      symbols.erase(it);
+      return true;
+    }
+    if (d.value <= 0 || factor % d.value != 0) {
+      return false;
+    }
+    factor /= d.value;
+    return true;
+  }
+
+  int64_t factor = 1;
+  std::vector<int64_t> symbols;
+};
+
+bool isShapePreserving(Node* n) {
+  static const std::unordered_set<Symbol> kinds = {
+      aten::relu,       aten::relu_,     aten::sigmoid,     aten::tanh,
+      aten::neg,        aten::abs,       aten::exp,         aten::log,
+      aten::sqrt,       aten::rsqrt,     aten::reciprocal,  aten::erf,
+      aten::sin,        aten::cos,       aten::floor,       aten::ceil,
+      aten::round,      aten::trunc,     aten::sign,        aten::hardtanh,
+      aten::clamp,      aten::threshold, aten::leaky_relu,  aten::elu,
+      aten::dropout,    aten::softmax,   aten::log_softmax, aten::batch_norm,
+      aten::layer_norm, aten::contiguous, aten::clone,      aten::detach,
+      aten::type_as,    aten::to,        aten::masked_fill,
+  };
+  return kinds.count(n->kind());
+}
+
+bool isBroadcasting(Node* n) {
+  static const std::unordered_set<Symbol> kinds = {
+      aten::add,     aten::sub,     aten::mul,     aten::div,
+      aten::pow,     aten::remainder, aten::fmod,  aten::lt,
+      aten::le,      aten::gt,      aten::ge,      aten::eq,
+      aten::ne,      aten::__and__, aten::__or__,  aten::__xor__,
+      aten::where,   aten::addcmul, aten::addcdiv,
+  };
+  return kinds.count(n->kind());
+}
+
+bool isTensor(Value* v) {
+  return v->type()->isSubtypeOf(TensorType::get());
+}
+
+c10::optional<int64_t> constantInt(Value* v) {
+  auto ival = toIValue(v);
+  if (!ival || !ival->isInt()) {
+    return c10::nullopt;
+  }
+  return ival->toInt();
+}
+
+// Wraps a possibly negative dimension index of a tensor of the given rank.
+c10::optional<size_t> wrapDim(int64_t dim, size_t rank) {
+  if (dim < 0) {
+    dim += static_cast<int64_t>(rank);
+  }
+  if (dim < 0 || dim >= static_cast<int64_t>(rank)) {
+    return c10::nullopt;
+  }
+  return static_cast<size_t>(dim);
+}
+
+class SymbolicShapePropagator {
+ public:
+  explicit SymbolicShapePropagator(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  void run(at::ArrayRef<ProfiledTensorTypePtr> input_shapes) {
+    for (size_t i = 0; i < graph_->inputs().size(); ++i) {
+      Value* input = graph_->inputs()[i];
+      setFromType(input);
+      if (i < input_shapes.size() && input_shapes[i]) {
+        setFromProfile(input, *input_shapes[i]);
+      }
+    }
+    run(graph_->block());
+    EliminateDeadCode(graph_);
+  }
+
+ private:
+  void run(Block* block) {
+    for (Node* n : block->nodes()) {
+      for (Block* b : n->blocks()) {
+        for (Value* input : b->inputs()) {
+          setFromType(input);
+        }
+        run(b);
+      }
+      propagate(n);
+      // the replaced nodes are left to dead code elimination, so that the
+      // alias analysis never sees a destroyed value
+      simplify(n);
+    }
+  }
+
+  Dim freshSymbol() {
+    return Dim{next_symbol_++, true};
+  }
+
+  Dim dimOf(const Product& product) {
+    if (product.symbols.empty()) {
+      return Dim::concrete(product.factor);
+    }
+    if (product.symbols.size() == 1 && product.factor == 1) {
+      return Dim{product.symbols[0], true};
+    }
+    return freshSymbol();
+  }
+
+  void setFromType(Value* v) {
+    if (auto type = v->type()->cast<CompleteTensorType>()) {
+      Shape shape;
+      for (int64_t size : type->sizes()) {
+        shape.push_back(Dim::concrete(size));
+      }
+      shapes_[v] = std::move(shape);
+    } else if (auto type = v->type()->cast<DimensionedTensorType>()) {
+      Shape shape;
+      for (int64_t i = 0; i < type->dim(); ++i) {
+        shape.push_back(freshSymbol());
+      }
+      shapes_[v] = std::move(shape);
+    }
+  }
+
+  void setFromProfile(Value* input, const ProfiledTensorType& profiled) {
+    auto it = shapes_.find(input);
+    const c10::VaryingShape& sizes = profiled.sizes();
+    if (it == shapes_.end() || !sizes.size() ||
+        *sizes.size() != it->second.size()) {
+      return;
+    }
+    for (size_t i = 0; i < it->second.size(); ++i) {
+      if (const auto& size = sizes[static_cast<int>(i)]) {
+        it->second[i] = Dim::concrete(*size);
+      }
+    }
+  }
+
+  // Records the sizes computed for v, unless its type knows better.
+  void setShape(Value* v, Shape shape) {
+    auto type = v->type()->cast<DimensionedTensorType>();
+    if (!type || v->type()->cast<CompleteTensorType>() ||
+        static_cast<size_t>(type->dim()) != shape.size()) {
+      setFromType(v);
+      return;
+    }
+    shapes_[v] = std::move(shape);
+  }
+
+  const Shape* shapeOf(Value* v) const {
+    auto it = shapes_.find(v);
+    return it == shapes_.end() ? nullptr : &it->second;
+  }
+
+  c10::optional<Dim> intOf(Value* v) const {
+    auto it = ints_.find(v);
+    if (it != ints_.end()) {
+      return it->second;
+    }
+    if (auto value = constantInt(v)) {
+      return Dim::concrete(*value);
+    }
+    return c10::nullopt;
+  }
+
+  c10::optional<Shape> listOf(Value* v) const {
+    auto it = lists_.find(v);
+    if (it != lists_.end()) {
+      return it->second;
+    }
+    auto ival = toIValue(v);
+    if (!ival || !ival->isIntList()) {
+      return c10::nullopt;
+    }
+    Shape list;
+    for (int64_t value : ival->toIntListRef()) {
+      list.push_back(Dim::concrete(value));
+    }
+    return list;
+  }
+
+  // Constant list arguments of convolutions and poolings, which may give a
+  // single value for all of the spatial dimensions.
+  c10::optional<std::vector<int64_t>> constantParams(Value* v, size_t count) {
+    auto ival = toIValue(v);
+    if (!ival || !ival->isIntList()) {
+      return c10::nullopt;
+    }
+    std::vector<int64_t> params = ival->toIntListRef();
+    if (params.size() == 1) {
+      params.resize(count, params[0]);
+    }
+    if (params.size() != count) {
+      return c10::nullopt;
+    }
+    return params;
+  }
+
+  AliasDb& aliasDb() {
+    if (!aliasDb_) {
+      aliasDb_ = torch::make_unique<AliasDb>(graph_);
+    }
+    return *aliasDb_;
+  }
+
+  void propagate(Node* n) {
+    if (n->kind() == prim::If) {
+      propagateIf(n);
+    } else if (n->kind() == prim::ListConstruct) {
+      Shape list;
+      for (Value* input : n->inputs()) {
+        auto value = intOf(input);
+        if (!value) {
+          return;
+        }
+        list.push_back(*value);
+      }
+      lists_[n->output()] = std::move(list);
+    } else if (n->kind() == prim::ListUnpack) {
+      auto list = listOf(n->input());
+      if (list && list->size() == n->outputs().size()) {
+        for (size_t i = 0; i < list->size(); ++i) {
+          ints_[n->outputs()[i]] = (*list)[i];
+        }
+      }
+    } else if (n->matches("aten::select(int[] a, int b) -> int")) {
+      auto list = listOf(n->input(0));
+      auto index = constantInt(n->input(1));
+      if (list && index) {
+        if (auto i = wrapDim(*index, list->size())) {
+          ints_[n->output()] = (*list)[*i];
+        }
+      }
+    } else if (n->matches("aten::size(Tensor self) -> int[]")) {
+      if (const Shape* shape = shapeOf(n->input())) {
+        lists_[n->output()] = *shape;
+      }
+    } else if (n->matches("aten::size(Tensor self, int dim) -> int")) {
+      const Shape* shape = shapeOf(n->input(0));
+      auto dim = constantInt(n->input(1));
+      if (shape && dim) {
+        if (auto d = wrapDim(*dim, shape->size())) {
+          ints_[n->output()] = (*shape)[*d];
+        }
+      }
+    } else if (n->outputs().size() == 1 && isTensor(n->output())) {
+      if (auto shape = outputShape(n)) {
+        setShape(n->output(), std::move(*shape));
+      }
+    }
+    for (Value* output : n->outputs()) {
+      if (!shapes_.count(output)) {
+        setFromType(output);
+      }
+    }
+  }
+
+  // The outputs of an if keep the sizes both of its branches agree on.
+  void propagateIf(Node* n) {
+    for (size_t i = 0; i < n->outputs().size(); ++i) {
+      Value* output = n->outputs()[i];
+      Value* then_output = n->blocks()[0]->outputs()[i];
+      Value* else_output = n->blocks()[1]->outputs()[i];
+      auto then_int = intOf(then_output);
+      auto else_int = intOf(else_output);
+      if (then_int && else_int && *then_int == *else_int) {
+        ints_[output] = *then_int;
+      }
+      const Shape* then_shape = shapeOf(then_output);
+      const Shape* else_shape = shapeOf(else_output);
+      if (!then_shape || !else_shape ||
+          then_shape->size() != else_shape->size()) {
+        continue;
+      }
+      Shape shape = *then_shape;
+      for (size_t d = 0; d < shape.size(); ++d) {
+        if (shape[d] != (*else_shape)[d]) {
+          shape[d] = freshSymbol();
+        }
+      }
+      setShape(output, std::move(shape));
+    }
+  }
+
+  Dim broadcast(const Dim& a, const Dim& b) {
+    if (a == b || b.isConcrete(1)) {
+      return a;
+    }
+    if (a.isConcrete(1)) {
+      return b;
+    }
+    // a symbol can only be broadcast with a concrete size other than 1 if
+    // it is 1 or equal to it
+    if (!a.is_symbol) {
+      return a;
+    }
+    if (!b.is_symbol) {
+      return b;
+    }
+    return freshSymbol();
+  }
+
+  c10::optional<Shape> broadcastShape(Node* n) {
+    c10::optional<Shape> result;
+    for (Value* input : n->inputs()) {
+      if (!isTensor(input)) {
+        continue;
+      }
+      const Shape* shape = shapeOf(input);
+      if (!shape) {
+        return c10::nullopt;
+      }
+      if (!result) {
+        result = *shape;
+        continue;
+      }
+      if (result->size() < shape->size()) {
+        result->insert(
+            result->begin(),
+            shape->begin(),
+            shape->begin() + (shape->size() - result->size()));
+      }
+      const size_t offset = result->size() - shape->size();
+      for (size_t i = 0; i < shape->size(); ++i) {
+        (*result)[offset + i] = broadcast((*result)[offset + i], (*shape)[i]);
+      }
+    }
+    return result;
+  }
+
+  // The sizes given to view and reshape, with the one of -1 inferred from
+  // the number of elements of self.
+  Shape inferSize(const Shape* self, Shape sizes) {
+    auto infer = std::find_if(sizes.begin(), sizes.end(), [](const Dim& d) {
+      return d.isConcrete(-1);
+    });
+    if (infer == sizes.end()) {
+      return sizes;
+    }
+    if (!self) {
+      *infer = freshSymbol();
+      return sizes;
+    }
+    Product numel(self->begin(), self->end());
+    for (auto it = sizes.begin(); it != sizes.end(); ++it) {
+      if (it != infer && !numel.divide(*it)) {
+        *infer = freshSymbol();
+        return sizes;
+      }
+    }
+    *infer = dimOf(numel);
+    return sizes;
+  }
+
+  // Output size of a convolution or pooling along one spatial dimension.
+  Dim windowedSize(
+      const Dim& input,
+      const Dim& kernel,
+      int64_t stride,
+      int64_t padding,
+      int64_t dilation) {
+    if (kernel.is_symbol || stride <= 0) {
+      return freshSymbol();
+    }
+    const int64_t extent = dilation * (kernel.value - 1) + 1;
+    if (stride == 1 && 2 * padding == extent - 1) {
+      return input;
+    }
+    if (input.is_symbol) {
+      return freshSymbol();
+    }
+    return Dim::concrete((input.value + 2 * padding - extent) / stride + 1);
+  }
+
+  c10::optional<Shape> convolutionShape(Node* n) {
+    const Shape* self = shapeOf(n->namedInput(attr::input));
+    const Shape* weight = shapeOf(n->namedInput(attr::weight));
+    if (!self || !weight || self->size() < 3 ||
+        self->size() != weight->size()) {
+      return c10::nullopt;
+    }
+    const size_t spatial = self->size() - 2;
+    auto stride = constantParams(n->namedInput(attr::stride), spatial);
+    auto padding = constantParams(n->namedInput(attr::padding), spatial);
+    auto dilation = constantParams(n->namedInput(attr::dilation), spatial);
+    if (!stride || !padding || !dilation) {
+      return c10::nullopt;
+    }
+    Shape result = {(*self)[0], (*weight)[0]};
+    for (size_t i = 0; i < spatial; ++i) {
+      result.push_back(windowedSize(
+          (*self)[2 + i],
+          (*weight)[2 + i],
+          (*stride)[i],
+          (*padding)[i],
+          (*dilation)[i]));
+    }
+    return result;
+  }
+
+  c10::optional<Shape> poolingShape(Node* n, size_t spatial) {
+    const Shape* self = shapeOf(n->namedInput(attr::self));
+    auto kernel = constantParams(n->namedInput(attr::kernel_size), spatial);
+    auto stride = constantParams(n->namedInput(attr::stride), spatial);
+    auto padding = constantParams(n->namedInput(attr::padding), spatial);
+    auto ceil_mode = n->get<bool>(attr::ceil_mode);
+    if (!self || self->size() < spatial || !kernel || !padding ||
+        !ceil_mode || *ceil_mode) {
+      return c10::nullopt;
+    }
+    // an empty stride defaults to the kernel size
+    if (!stride) {
+      auto ival = toIValue(n->namedInput(attr::stride));
+      if (!ival || !ival->isIntList() || !ival->toIntListRef().empty()) {
+        return c10::nullopt;
+      }
+      stride = kernel;
+    }
+    std::vector<int64_t> dilation(spatial, 1);
+    if (n->kind() == aten::max_pool1d || n->kind() == aten::max_pool2d ||
+        n->kind() == aten::max_pool3d) {
+      auto params = constantParams(n->namedInput(attr::dilation), spatial);
+      if (!params) {
+        return c10::nullopt;
+      }
+      dilation = *params;
+    }
+    Shape result(self->begin(), self->end() - spatial);
+    for (size_t i = 0; i < spatial; ++i) {
+      result.push_back(windowedSize(
+          (*self)[self->size() - spatial + i],
+          Dim::concrete((*kernel)[i]),
+          (*stride)[i],
+          (*padding)[i],
+          dilation[i]));
+    }
+    return result;
+  }
+
+  c10::optional<Shape> catShape(Node* n) {
+    Node* list = n->namedInput(attr::tensors)->node();
+    auto dim = constantInt(n->namedInput(attr::dim));
+    if (list->kind() != prim::ListConstruct || list->inputs().empty() ||
+        !dim) {
+      return c10::nullopt;
+    }
+    const Shape* first = shapeOf(list->inputs()[0]);
+    if (!first) {
+      return c10::nullopt;
+    }
+    auto d = wrapDim(*dim, first->size());
+    if (!d) {
+      return c10::nullopt;
+    }
+    Shape result = *first;
+    for (size_t i = 1; i < list->inputs().size(); ++i) {
+      const Shape* shape = shapeOf(list->inputs()[i]);
+      if (!shape || shape->size() != result.size()) {
+        return c10::nullopt;
+      }
+      for (size_t j = 0; j < result.size(); ++j) {
+        if (j == *d) {
+          result[j] = !result[j].is_symbol && !(*shape)[j].is_symbol
+              ? Dim::concrete(result[j].value + (*shape)[j].value)
+              : freshSymbol();
+        } else if (result[j].is_symbol) {
+          // the other sizes of the tensors must be equal
+          result[j] = (*shape)[j];
+        }
+      }
+    }
+    return result;
+  }
+
+  c10::optional<Shape> outputShape(Node* n) {
+    if (n->inputs().empty()) {
+      return c10::nullopt;
+    }
+    if (isShapePreserving(n)) {
+      if (const Shape* self = shapeOf(n->input(0))) {
+        return *self;
+      }
+      return c10::nullopt;
+    }
+    if (isBroadcasting(n)) {
+      return broadcastShape(n);
+    }
+
+    const Shape* self = shapeOf(n->input(0));
+    if (n->matches(
+            "aten::expand(Tensor self, int[] size, *, bool implicit) -> Tensor")) {
+      auto sizes = listOf(n->namedInput(attr::size));
+      if (!self || !sizes || sizes->size() < self->size()) {
+        return c10::nullopt;
+      }
+      const size_t offset = sizes->size() - self->size();
+      for (size_t i = 0; i < sizes->size(); ++i) {
+        if ((*sizes)[i].isConcrete(-1)) {
+          if (i < offset) {
+            return c10::nullopt;
+          }
+          (*sizes)[i] = (*self)[i - offset];
+        }
+      }
+      return sizes;
+    } else if (
+        n->matches("aten::expand_as(Tensor self, Tensor other) -> Tensor") ||
+        n->matches("aten::view_as(Tensor self, Tensor other) -> Tensor") ||
+        n->matches("aten::reshape_as(Tensor self, Tensor other) -> Tensor")) {
+      if (const Shape* other = shapeOf(n->input(1))) {
+        return *other;
+      }
+    } else if (
+        n->matches("aten::view(Tensor self, int[] size) -> Tensor") ||
+        n->matches("aten::reshape(Tensor self, int[] shape) -> Tensor")) {
+      if (auto sizes = listOf(n->input(1))) {
+        return inferSize(self, std::move(*sizes));
+      }
+    } else if (n->matches(
+                   "aten::_grad_sum_to_size(Tensor(a) self, int[] size) -> Tensor(a)")) {
+      return listOf(n->input(1));
+    } else if (!self) {
+      return c10::nullopt;
+    } else if (n->matches(
+                   "aten::flatten(Tensor self, int start_dim, int end_dim) -> Tensor")) {
+      auto start = constantInt(n->namedInput(attr::start_dim));
+      auto end = constantInt(n->namedInput(attr::end_dim));
+      if (self->empty()) {
+        return Shape{Dim::concrete(1)};
+      }
+      auto first = start ? wrapDim(*start, self->size()) : c10::nullopt;
+      auto last = end ? wrapDim(*end, self->size()) : c10::nullopt;
+      if (!first || !last || *first > *last) {
+        return c10::nullopt;
+      }
+      Shape result(self->begin(), self->begin() + *first);
+      result.push_back(
+          dimOf(Product(self->begin() + *first, self->begin() + *last + 1)));
+      result.insert(result.end(), self->begin() + *last + 1, self->end());
+      return result;
+    } else if (n->matches("aten::permute(Tensor self, int[] dims) -> Tensor")) {
+      auto dims = listOf(n->namedInput(attr::dims));
+      if (!dims || dims->size() != self->size()) {
+        return c10::nullopt;
+      }
+      Shape result;
+      for (const Dim& dim : *dims) {
+        auto d = dim.is_symbol ? c10::nullopt : wrapDim(dim.value, self->size());
+        if (!d) {
+          return c10::nullopt;
+        }
+        result.push_back((*self)[*d]);
+      }
+      return result;
+    } else if (n->matches(
+                   "aten::transpose(Tensor self, int dim0, int dim1) -> Tensor")) {
+      auto dim0 = constantInt(n->namedInput(attr::dim0));
+      auto dim1 = constantInt(n->namedInput(attr::dim1));
+      auto d0 = dim0 ? wrapDim(*dim0, self->size()) : c10::nullopt;
+      auto d1 = dim1 ? wrapDim(*dim1, self->size()) : c10::nullopt;
+      if (!d0 || !d1) {
+        return c10::nullopt;
+      }
+      Shape result = *self;
+      std::swap(result[*d0], result[*d1]);
+      return result;
+    } else if (n->matches("aten::t(Tensor self) -> Tensor")) {
+      return Shape(self->rbegin(), self->rend());
+    } else if (n->matches("aten::unsqueeze(Tensor self, int dim) -> Tensor")) {
+      auto dim = constantInt(n->namedInput(attr::dim));
+      auto d = dim ? wrapDim(*dim, self->size() + 1) : c10::nullopt;
+      if (!d) {
+        return c10::nullopt;
+      }
+      Shape result = *self;
+      result.insert(result.begin() + *d, Dim::concrete(1));
+      return result;
+    } else if (n->matches("aten::squeeze(Tensor self, int dim) -> Tensor")) {
+      auto dim = constantInt(n->namedInput(attr::dim));
+      if (self->empty()) {
+        return *self;
+      }
+      auto d = dim ? wrapDim(*dim, self->size()) : c10::nullopt;
+      // whether a symbolic size gets squeezed is only known at runtime
+      if (!d || (*self)[*d].is_symbol) {
+        return c10::nullopt;
+      }
+      Shape result = *self;
+      if (result[*d].isConcrete(1)) {
+        result.erase(result.begin() + *d);
+      }
+      return result;
+    } else if (
+        n->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor") ||
+        n->matches("aten::matmul(Tensor self, Tensor other) -> Tensor")) {
+      const Shape* other = shapeOf(n->input(1));
+      if (!other || other->size() != 2 || self->size() < 2 ||
+          (n->kind() == aten::mm && self->size() != 2)) {
+        return c10::nullopt;
+      }
+      Shape result(self->begin(), self->end() - 1);
+      result.push_back((*other)[1]);
+      return result;
+    } else if (n->matches("aten::bmm(Tensor self, Tensor mat2) -> Tensor")) {
+      const Shape* other = shapeOf(n->input(1));
+      if (!other || other->size() != 3 || self->size() != 3) {
+        return c10::nullopt;
+      }
+      return Shape{(*self)[0], (*self)[1], (*other)[2]};
+    } else if (n->matches(
+                   "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor")) {
+      const Shape* mat1 = shapeOf(n->input(1));
+      const Shape* mat2 = shapeOf(n->input(2));
+      if (!mat1 || !mat2 || mat1->size() != 2 || mat2->size() != 2) {
+        return c10::nullopt;
+      }
+      return Shape{(*mat1)[0], (*mat2)[1]};
+    } else if (n->matches(
+                   "aten::linear(Tensor input, Tensor weight, Tensor? bias) -> Tensor")) {
+      const Shape* weight = shapeOf(n->input(1));
+      if (!weight || weight->size() != 2 || self->empty()) {
+        return c10::nullopt;
+      }
+      Shape result(self->begin(), self->end() - 1);
+      result.push_back((*weight)[0]);
+      return result;
+    } else if (
+        n->matches(
+            "aten::conv1d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+        n->matches(
+            "aten::conv2d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor") ||
+        n->matches(
+            "aten::conv3d(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, int groups) -> Tensor")) {
+      return convolutionShape(n);
+    } else if (n->matches(
+                   "aten::_convolution(Tensor input, Tensor weight, Tensor? bias, int[] stride, int[] padding, int[] dilation, bool transposed, int[] output_padding, int groups, bool benchmark, bool deterministic, bool cudnn_enabled) -> Tensor")) {
+      auto transposed = n->get<bool>(attr::transposed);
+      if (transposed && !*transposed) {
+        return convolutionShape(n);
+      }
+    } else if (
+        n->matches(
+            "aten::max_pool1d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor") ||
+        n->matches(
+            "aten::avg_pool1d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad) -> Tensor")) {
+      return poolingShape(n, 1);
+    } else if (
+        n->matches(
+            "aten::max_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor") ||
+        n->matches(
+            "aten::avg_pool2d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad) -> Tensor")) {
+      return poolingShape(n, 2);
+    } else if (
+        n->matches(
+            "aten::max_pool3d(Tensor self, int[] kernel_size, int[] stride, int[] padding, int[] dilation, bool ceil_mode) -> Tensor") ||
+        n->matches(
+            "aten::avg_pool3d(Tensor self, int[] kernel_size, int[] stride, int[] padding, bool ceil_mode, bool count_include_pad) -> Tensor")) {
+      return poolingShape(n, 3);
+    } else if (
+        n->matches(
+            "aten::adaptive_avg_pool1d(Tensor self, int[] output_size) -> Tensor") ||
+        n->matches(
+            "aten::adaptive_avg_pool2d(Tensor self, int[] output_size) -> Tensor") ||
+        n->matches(
+            "aten::adaptive_avg_pool3d(Tensor self, int[] output_size) -> Tensor")) {
+      auto output_size = listOf(n->namedInput(attr::output_size));
+      if (!output_size || self->size() < output_size->size()) {
+        return c10::nullopt;
+      }
+      Shape result(self->begin(), self->end() - output_size->size());
+      result.insert(result.end(), output_size->begin(), output_size->end());
+      return result;
+    } else if (n->matches("aten::cat(Tensor[] tensors, int dim) -> Tensor")) {
+      return catShape(n);
+    }
+    return c10::nullopt;
+  }
+
+  bool keepsShape(Node* n) {
+    const Shape* input = shapeOf(n->input(0));
+    const Shape* output = shapeOf(n->output());
+    return input && output && *input == *output;
+  }
+
+  void replaceWithConstant(Node* n, IValue value) {
+    WithInsertPoint guard(n);
+    n->output()->replaceAllUsesWith(graph_->insertConstant(std::move(value)));
+  }
+
+  void simplify(Node* n) {
+    if (n->matches("aten::size(Tensor self) -> int[]")) {
+      const Shape* shape = shapeOf(n->input());
+      if (!shape) {
+        return;
+      }
+      std::vector<int64_t> sizes;
+      for (const Dim& d : *shape) {
+        if (d.is_symbol) {
+          return;
+        }
+        sizes.push_back(d.value);
+      }
+      replaceWithConstant(n, std::move(sizes));
+    } else if (n->matches("aten::size(Tensor self, int dim) -> int")) {
+      auto size = intOf(n->output());
+      if (size && !size->is_symbol) {
+        replaceWithConstant(n, size->value);
+      }
+    } else if (
+        n->matches(
+            "aten::expand(Tensor self, int[] size, *, bool implicit) -> Tensor") ||
+        n->matches("aten::expand_as(Tensor self, Tensor other) -> Tensor") ||
+        n->matches("aten::view(Tensor self, int[] size) -> Tensor") ||
+        n->matches("aten::view_as(Tensor self, Tensor other) -> Tensor") ||
+        n->matches(
+            "aten::_grad_sum_to_size(Tensor(a) self, int[] size) -> Tensor(a)")) {
+      // the output would have been a view of self anyway
+      if (keepsShape(n)) {
+        n->output()->replaceAllUsesWith(n->input(0));
+      }
+    } else if (
+        n->matches("aten::reshape(Tensor self, int[] shape) -> Tensor") ||
+        n->matches("aten::reshape_as(Tensor self, Tensor other) -> Tensor")) {
+      // reshape may copy self, so neither of them can be written to
+      if (keepsShape(n) && !aliasDb().hasWriters(n)) {
+        n->output()->replaceAllUsesWith(n->input(0));
+      }
+    }
+  }
+
+  std::shared_ptr<Graph> graph_;
+  std::unique_ptr<AliasDb> aliasDb_;
+  int64_t next_symbol_ = 0;
+  std::unordered_map<Value*, Shape> shapes_;
+  std::unordered_map<Value*, Shape> lists_;
+  std::unordered_map<Value*, Dim> ints_;
+};
+
+} // namespace
+
+void SpecializeSymbolicShapes(
+    const std::shared_ptr<Graph>& graph,
+    at::ArrayRef<ProfiledTensorTypePtr> input_shapes) {
+  SymbolicShapePropagator(graph).run(input_shapes);
+}
+
+} // namespace jit
+} // namespace torch
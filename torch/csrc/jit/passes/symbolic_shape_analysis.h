@@ -0,0 +1,27 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Propagates tensor sizes through the graph symbolically: every size that
+// isn't known when the graph is specialized, like a batch dimension that
+// varies between runs, becomes a symbol, and symbols flow through the ops the
+// way concrete sizes do, while the other sizes stay concrete. Complete shapes
+// are only ever known for graphs specialized to every size, so this is what
+// lets us
+//    - replace aten::size calls on concrete dimensions by constants,
+//    - remove expand, view, reshape and _grad_sum_to_size nodes that
+//      provably keep the sizes of their input, e.g. x.view(x.size(0), -1)
+//      of an x of sizes [B, 512].
+//
+// input_shapes optionally gives partially known sizes of the graph inputs,
+// as recorded while profiling. The sizes of the inputs it has no (or a null)
+// entry for are taken from their types.
+TORCH_API void SpecializeSymbolicShapes(
+    const std::shared_ptr<Graph>& graph,
+    at::ArrayRef<ProfiledTensorTypePtr> input_shapes = {});
+
+} // namespace jit
+} // namespace torch
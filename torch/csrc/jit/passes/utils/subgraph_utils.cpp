@@ -9,12 +9,39 @@ bool hasSubgraph(Node* n) {
   return n->hasAttribute(attr::Subgraph);
 }
 
+void unmergeSubgraph(Node* subgraphNode, AliasDb* aliasDb);
+void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode, AliasDb* aliasDb);
+
+// `clone` is a copy of `existing`, which is about to be destroyed. Hand the
+// values and nodes in `existing`'s blocks over to their copies.
+void replaceClonedBlocks(Node* existing, Node* clone, AliasDb& aliasDb) {
+  AT_ASSERT(existing->blocks().size() == clone->blocks().size());
+  for (size_t i = 0; i < existing->blocks().size(); ++i) {
+    Block* block = existing->blocks()[i];
+    Block* clonedBlock = clone->blocks()[i];
+    for (size_t j = 0; j < block->inputs().size(); ++j) {
+      aliasDb.replaceWithNewValue(
+          block->inputs()[j], clonedBlock->inputs()[j]);
+    }
+    auto clonedIt = clonedBlock->nodes().begin();
+    for (Node* node : block->nodes()) {
+      Node* clonedNode = *clonedIt++;
+      for (size_t j = 0; j < node->outputs().size(); ++j) {
+        aliasDb.replaceWithNewValue(
+            node->outputs()[j], clonedNode->outputs()[j]);
+      }
+      replaceClonedBlocks(node, clonedNode, aliasDb);
+      aliasDb.replaceWithNewNode(node, clonedNode);
+    }
+  }
+}
+
 // Combine the nodes in two subgraph together. The nodes will end up in
 // `mergeTo`, and `mergeFrom` is destroyed.
-void mergeSubgraph(Node* mergeTo, Node* mergeFrom) {
+void mergeSubgraph(Node* mergeTo, Node* mergeFrom, AliasDb* aliasDb) {
   Node* nodeBeforeMergeFrom = mergeFrom->prev();
   Node* nodeAfterMergeFrom = mergeFrom->next();
-  unmergeSubgraph(mergeFrom);
+  unmergeSubgraph(mergeFrom, aliasDb);
   std::vector<Node*> nodes;
   const auto end_it = nodeBeforeMergeFrom->reverseIterator();
   auto it = nodeAfterMergeFrom->reverseIterator();
@@ -23,34 +50,57 @@ void mergeSubgraph(Node* mergeTo, Node* mergeFrom) {
     // NB: mergeNodeIntoSubgraph destroys node, hence the complications
     Node* node = *it;
     ++it;
-    mergeNodeIntoSubgraph(node, mergeTo);
+    mergeNodeIntoSubgraph(node, mergeTo, aliasDb);
   }
 }
-} // namespace
-
-std::shared_ptr<Graph> getSubgraph(Node* n) {
-  return n->g(attr::Subgraph);
-}
 
-void unmergeSubgraph(Node* subgraphNode) {
+void unmergeSubgraph(Node* subgraphNode, AliasDb* aliasDb) {
   AT_ASSERT(subgraphNode->kind() == prim::DifferentiableGraph);
 
   // Inline the graph, replace uses of node outputs and destroy the node
   auto outerGraph = subgraphNode->owningGraph();
+  const auto subgraph = getSubgraph(subgraphNode);
+  Node* nodeBeforeSubgraph = subgraphNode->prev();
   WithInsertPoint guard(subgraphNode);
-  const auto subgraphOutputs = inlineCallTo(
-      *outerGraph, *getSubgraph(subgraphNode), subgraphNode->inputs());
+  const auto subgraphOutputs =
+      inlineCallTo(*outerGraph, *subgraph, subgraphNode->inputs());
   AT_ASSERT(subgraphOutputs.size() >= subgraphNode->outputs().size());
+
+  if (aliasDb) {
+    // The inlined nodes are clones of the subgraph's nodes, in the same order
+    Node* inlined = nodeBeforeSubgraph->next();
+    for (Node* node : subgraph->nodes()) {
+      AT_ASSERT(inlined != subgraphNode);
+      for (size_t i = 0; i < node->outputs().size(); ++i) {
+        aliasDb->replaceWithNewValue(node->outputs()[i], inlined->outputs()[i]);
+      }
+      replaceClonedBlocks(node, inlined, *aliasDb);
+      aliasDb->replaceWithNewNode(node, inlined);
+      inlined = inlined->next();
+    }
+    for (Value* input : subgraph->inputs()) {
+      aliasDb->eraseValue(input);
+    }
+    for (size_t i = 0; i < subgraphNode->outputs().size(); ++i) {
+      aliasDb->replaceWithNewValue(
+          subgraphNode->outputs()[i], subgraphOutputs[i]);
+    }
+    aliasDb->eraseNode(subgraphNode);
+  }
+
   for (size_t i = 0; i < subgraphNode->outputs().size(); ++i) {
     subgraphNode->outputs()[i]->replaceAllUsesWith(subgraphOutputs[i]);
   }
   subgraphNode->destroy();
 }
 
-void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
+void mergeNodeIntoSubgraph(
+    Node* toMerge,
+    Node* subgraphNode,
+    AliasDb* aliasDb) {
   AT_ASSERT(hasSubgraph(subgraphNode));
   if (hasSubgraph(toMerge)) {
-    return mergeSubgraph(subgraphNode, toMerge);
+    return mergeSubgraph(subgraphNode, toMerge, aliasDb);
   }
 
   auto subgraph = getSubgraph(subgraphNode);
@@ -75,6 +125,9 @@ void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
         auto nv = subgraph->insertConstant(*value);
         nv->setType(input->type()); // Need to retain type information on Nones
         inputsMap[input] = nv;
+        if (aliasDb) {
+          aliasDb->createValue(nv);
+        }
       } else {
         // The common case: this is a regular input, so just register it with
         // the group node and inner subgraph
@@ -82,6 +135,9 @@ void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
         auto inputToGraph = subgraph->addInput();
         inputToGraph->setType(input->type());
         inputsMap[input] = inputToGraph;
+        if (aliasDb) {
+          aliasDb->copyValue(input, inputToGraph);
+        }
       }
     }
   }
@@ -89,6 +145,13 @@ void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
   // Merge the node into the graph
   auto mergedNode = subgraph->insertNode(
       subgraph->createClone(toMerge, [&](Value* v) { return inputsMap[v]; }));
+  if (aliasDb) {
+    for (size_t i = 0; i < toMerge->outputs().size(); ++i) {
+      aliasDb->copyValue(toMerge->outputs()[i], mergedNode->outputs()[i]);
+    }
+    replaceClonedBlocks(toMerge, mergedNode, *aliasDb);
+    aliasDb->replaceWithNewNode(toMerge, mergedNode);
+  }
 
   // If n's outputs were inputs to `group`, remove them since we just merged
   // n in.
@@ -102,6 +165,10 @@ void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
     if (it != inputs.end()) {
       size_t p = it - inputs.begin();
       subgraphNode->removeInput(p);
+      if (aliasDb) {
+        aliasDb->replaceWithNewValue(
+            subgraph->inputs()[p], mergedNode->outputs()[i]);
+      }
       subgraph->inputs()[p]->replaceAllUsesWith(mergedNode->outputs()[i]);
       subgraph->eraseInput(p);
     }
@@ -110,6 +177,7 @@ void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
   // Add n's outputs to the group node and inner subgraph outputs.
   for (size_t i = 0; i < toMerge->outputs().size(); i++) {
     auto oldOutput = toMerge->outputs()[i];
+    auto newOutput = mergedNode->outputs()[i];
 
     // Only register the output in the group node if it's actually used
     // outside the subgraph.
@@ -119,25 +187,67 @@ void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
         [&](const Use& use) { return use.user->isAfter(subgraphNode); });
 
     if (hasUsesOutsideSubgraph) {
-      auto newOutput = mergedNode->outputs()[i];
       subgraph->registerOutput(newOutput);
       auto groupOutput = subgraphNode->addOutput();
       groupOutput->copyMetadata(oldOutput);
+      if (aliasDb) {
+        aliasDb->replaceWithNewValue(oldOutput, groupOutput);
+      }
       oldOutput->replaceAllUsesWith(groupOutput);
+    } else if (aliasDb) {
+      aliasDb->replaceWithNewValue(oldOutput, newOutput);
     }
   }
+  if (aliasDb) {
+    aliasDb->registerSubgraphNode(subgraphNode);
+  }
   // Remove the original node now that the merge is complete
   toMerge->destroy();
 }
 
-Node* createSingletonSubgraph(Node* n, Symbol subgraphKind) {
+Node* createSingletonSubgraph(Node* n, Symbol subgraphKind, AliasDb* aliasDb) {
   auto graph = n->owningGraph();
   auto subgraph = graph->create(subgraphKind, 0);
   subgraph->g_(attr::Subgraph, std::make_shared<Graph>(graph->current_scope()));
   subgraph->insertBefore(n);
-  mergeNodeIntoSubgraph(n, subgraph);
+  mergeNodeIntoSubgraph(n, subgraph, aliasDb);
   return subgraph;
 }
+} // namespace
+
+std::shared_ptr<Graph> getSubgraph(Node* n) {
+  return n->g(attr::Subgraph);
+}
+
+void unmergeSubgraph(Node* subgraphNode) {
+  unmergeSubgraph(subgraphNode, nullptr);
+}
+
+void unmergeSubgraph(Node* subgraphNode, AliasDb& aliasDb) {
+  unmergeSubgraph(subgraphNode, &aliasDb);
+}
+
+void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode) {
+  mergeNodeIntoSubgraph(toMerge, subgraphNode, nullptr);
+}
+
+void mergeNodeIntoSubgraph(
+    Node* toMerge,
+    Node* subgraphNode,
+    AliasDb& aliasDb) {
+  mergeNodeIntoSubgraph(toMerge, subgraphNode, &aliasDb);
+}
+
+Node* createSingletonSubgraph(Node* n, Symbol subgraphKind) {
+  return createSingletonSubgraph(n, subgraphKind, nullptr);
+}
+
+Node* createSingletonSubgraph(
+    Node* n,
+    Symbol subgraphKind,
+    AliasDb& aliasDb) {
+  return createSingletonSubgraph(n, subgraphKind, &aliasDb);
+}
 
 } // namespace SubgraphUtils
 } // namespace jit
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
 namespace torch {
@@ -10,6 +11,9 @@ namespace jit {
 //
 // They handle the complexity of editing inputs/outputs as you merge nodes in
 // and out of subgraphs.
+//
+// The overloads taking an AliasDb keep it up to date with the edits, so that
+// a pass can keep using a single AliasDb while it builds its subgraphs.
 namespace SubgraphUtils {
 
 // Create a new subgraph node that contains only `n`. The new subgraph will have
@@ -19,15 +23,24 @@ namespace SubgraphUtils {
 //
 // Returns the new subgraph node.
 TORCH_API Node* createSingletonSubgraph(Node* n, Symbol subgraphKind);
+TORCH_API Node* createSingletonSubgraph(
+    Node* n,
+    Symbol subgraphKind,
+    AliasDb& aliasDb);
 
 // Merge a node into a subgraph node. If `toMerge` is also a subgraph, the
 // subgraphs are merged.
 // `toMerge` is destroyed.
 TORCH_API void mergeNodeIntoSubgraph(Node* toMerge, Node* subgraphNode);
+TORCH_API void mergeNodeIntoSubgraph(
+    Node* toMerge,
+    Node* subgraphNode,
+    AliasDb& aliasDb);
 
 // Move nodes from a subgraph node to the outer graph.
 // `subgraphNode` is destroyed.
 TORCH_API void unmergeSubgraph(Node* subgraphNode);
+TORCH_API void unmergeSubgraph(Node* subgraphNode, AliasDb& aliasDb);
 
 // Convenience function
 std::shared_ptr<Graph> getSubgraph(Node* n);
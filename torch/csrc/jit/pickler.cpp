@@ -11,11 +11,20 @@ using ::c10::IValue;
 // See https://docs.python.org/3/library/pickle.html#data-stream-format
 constexpr static uint8_t PROTOCOL_VERSION = 2;
 
+// Lists of ints with at least this many elements are pickled as the bytes of
+// their elements instead of one opcode per element. Smaller lists keep the
+// per-element format, which any Python version can unpickle.
+constexpr static size_t kRawIntListSize = 64;
+
 PicklerClass getClass(const std::string& str) {
   if (str == "build_tensor_from_id") {
     return PicklerClass::TENSOR;
   } else if (str == "build_intlist") {
     return PicklerClass::INTLIST;
+  } else if (str == "build_intlist_from_bytes") {
+    return PicklerClass::INTLIST_RAW;
+  } else if (str == "build_floatlist_from_bytes") {
+    return PicklerClass::DOUBLELIST_RAW;
   }
 
   // TODO [unpickler refactor]
@@ -30,11 +39,18 @@ PicklerClass getClass(const std::string& str) {
 const std::string& getClassName(PicklerClass cls) {
   static const std::string tensor_class("build_tensor_from_id\n");
   static const std::string intlist_class("build_intlist\n");
+  static const std::string intlist_raw_class("build_intlist_from_bytes\n");
+  static const std::string doublelist_raw_class(
+      "build_floatlist_from_bytes\n");
   switch (cls) {
     case PicklerClass::TENSOR:
       return tensor_class;
     case PicklerClass::INTLIST:
       return intlist_class;
+    case PicklerClass::INTLIST_RAW:
+      return intlist_raw_class;
+    case PicklerClass::DOUBLELIST_RAW:
+      return doublelist_raw_class;
     default:
       AT_ERROR("Unknown class for pickler");
   }
@@ -50,22 +66,22 @@ const std::vector<char>& Pickler::stack() {
 }
 
 void Pickler::start() {
-  push<OpCode>(OpCode::PROTO);
+  push<PickleOpCode>(PickleOpCode::PROTO);
   push<uint8_t>(PROTOCOL_VERSION);
 }
 
 void Pickler::startTuple() {
   // All attributes get pushed into a tuple and their indices saved in the
   // module def
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
 }
 
 void Pickler::endTuple() {
-  push<OpCode>(OpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
 }
 
 void Pickler::finish() {
-  push<OpCode>(OpCode::STOP);
+  push<PickleOpCode>(PickleOpCode::STOP);
 
 
   // Add the binary data for all the tensors to be included in the same binary
@@ -75,15 +91,15 @@ void Pickler::finish() {
     // As another pickle program in the same binary archive, add a list of
     // keys for each tensor (see torch/serialization.py)
     start();
-    push<OpCode>(OpCode::MARK);
+    push<PickleOpCode>(PickleOpCode::MARK);
     for (const auto& tensor : literal_tensors_) {
       std::string key = std::to_string(getStorageKey(tensor));
-      push<OpCode>(OpCode::BINUNICODE);
+      push<PickleOpCode>(PickleOpCode::BINUNICODE);
       push<uint32_t>(key.size());
       pushString(key);
     }
-    push<OpCode>(OpCode::TUPLE);
-    push<OpCode>(OpCode::STOP);
+    push<PickleOpCode>(PickleOpCode::TUPLE);
+    push<PickleOpCode>(PickleOpCode::STOP);
 
     // Now dump the tensor binary data
     for (const auto& tensor : literal_tensors_) {
@@ -109,24 +125,24 @@ void Pickler::pushMetadata() {
   // Output data to match torch.save, see torch/serialization.py for details
   // Magic number (0x1950a86a20f9469cfc6c)
   start();
-  push<OpCode>(OpCode::LONG1);
+  push<PickleOpCode>(PickleOpCode::LONG1);
   // LONG1 size
   pushString("\x0a");
   // LONG1 data
   pushString("\x6c\xfc\x9c\x46\xf9\x20\x6a\xa8\x50\x19");
-  push<OpCode>(OpCode::STOP);
+  push<PickleOpCode>(PickleOpCode::STOP);
 
   // Protocol Version (1001)
   start();
-  push<OpCode>(OpCode::BININT2);
+  push<PickleOpCode>(PickleOpCode::BININT2);
   pushString("\xe9\x03");
-  push<OpCode>(OpCode::STOP);
+  push<PickleOpCode>(PickleOpCode::STOP);
 
   // sys_info, this isn't actually used in de-serialization so we can leave this
   // one empty
   start();
-  push<OpCode>(OpCode::EMPTY_DICT);
-  push<OpCode>(OpCode::STOP);
+  push<PickleOpCode>(PickleOpCode::EMPTY_DICT);
+  push<PickleOpCode>(PickleOpCode::STOP);
 }
 
 void Pickler::addIValue(const IValue& ivalue) {
@@ -151,9 +167,9 @@ void Pickler::addIValue(const IValue& ivalue) {
     pushInt(ivalue);
   } else if (ivalue.isBool()) {
     if (ivalue.toBool()) {
-      push<OpCode>(OpCode::NEWTRUE);
+      push<PickleOpCode>(PickleOpCode::NEWTRUE);
     } else {
-      push<OpCode>(OpCode::NEWFALSE);
+      push<PickleOpCode>(PickleOpCode::NEWFALSE);
     }
   } else if (ivalue.isString()) {
     pushMemoizedString(ivalue);
@@ -162,9 +178,11 @@ void Pickler::addIValue(const IValue& ivalue) {
   } else if (ivalue.isGenericDict()) {
     pushDict(ivalue);
   } else if (ivalue.isNone()) {
-    push<OpCode>(OpCode::NONE);
+    push<PickleOpCode>(PickleOpCode::NONE);
   } else if (ivalue.isIntList()) {
     pushIntList(ivalue);
+  } else if (ivalue.isDoubleList()) {
+    pushDoubleList(ivalue);
   } else {
     AT_ERROR("Unknown IValue type for pickling: ", ivalue.tagKind());
   }
@@ -185,6 +203,8 @@ const void* Pickler::getPointer(const IValue& ivalue) {
     return ivalue.toString().get();
   } else if (ivalue.isIntList()) {
     return ivalue.toIntList().get();
+  } else if (ivalue.isDoubleList()) {
+    return ivalue.toDoubleList().get();
   }
 
   return nullptr;
@@ -194,16 +214,16 @@ void Pickler::pushInt(const IValue& ivalue) {
   auto n = ivalue.toInt();
   if (n >= std::numeric_limits<int8_t>::min() &&
       n <= std::numeric_limits<int8_t>::max()) {
-    push<OpCode>(OpCode::BININT1);
+    push<PickleOpCode>(PickleOpCode::BININT1);
     push<int8_t>(n);
   } else if (
       n >= std::numeric_limits<int32_t>::min() &&
       n <= std::numeric_limits<int32_t>::max()) {
-    push<OpCode>(OpCode::BININT);
+    push<PickleOpCode>(PickleOpCode::BININT);
     push<int32_t>(n);
   } else {
     // Push 8 byte integer
-    push<OpCode>(OpCode::LONG1);
+    push<PickleOpCode>(PickleOpCode::LONG1);
     push<uint8_t>(8);
     push<int64_t>(n);
   }
@@ -211,11 +231,11 @@ void Pickler::pushInt(const IValue& ivalue) {
 
 void Pickler::pushBinGet(uint32_t memo_id) {
   if (memo_id <= std::numeric_limits<uint8_t>::max()) {
-    push<OpCode>(OpCode::BINGET);
+    push<PickleOpCode>(PickleOpCode::BINGET);
     push<uint8_t>(memo_id);
   } else {
     // Memoized too many items, issue a LONG_BINGET instead
-    push<OpCode>(OpCode::LONG_BINGET);
+    push<PickleOpCode>(PickleOpCode::LONG_BINGET);
     push<uint32_t>(memo_id);
   }
 }
@@ -223,7 +243,7 @@ void Pickler::pushBinGet(uint32_t memo_id) {
 void Pickler::pushMemoizedString(const IValue& ivalue) {
   const auto& string = ivalue.toStringRef();
 
-  push<OpCode>(OpCode::BINUNICODE);
+  push<PickleOpCode>(PickleOpCode::BINUNICODE);
   push<uint32_t>(string.size());
   pushString(string);
   pushMemoization(ivalue);
@@ -236,7 +256,7 @@ void Pickler::pushString(const std::string& string) {
 void Pickler::pushGlobal(const std::string& name_temp) {
   auto memo_entry = memoized_strings_map_.find(name_temp);
   if (memo_entry == memoized_strings_map_.end()) {
-    push<OpCode>(OpCode::GLOBAL);
+    push<PickleOpCode>(PickleOpCode::GLOBAL);
     pushString(name_temp);
 
     // Push BINPUT without adding anything to the memo_map_
@@ -268,10 +288,10 @@ void Pickler::pushLiteralTensor(const IValue& ivalue) {
   // The arguments to this function are:
   //    storage, storage_offset, size, stride, requires_grad, backward_hooks
   pushGlobal("torch._utils\n_rebuild_tensor_v2\n");
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
 
   // Tuple for persistent_load
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
   // typename
   pushMemoizedString(std::string("storage"));
   // data_type
@@ -285,41 +305,41 @@ void Pickler::pushLiteralTensor(const IValue& ivalue) {
   // size
   pushInt(tensor.numel());
   // view_metadata
-  push<OpCode>(OpCode::NONE);
-  push<OpCode>(OpCode::TUPLE);
-  push<OpCode>(OpCode::BINPERSID);
+  push<PickleOpCode>(PickleOpCode::NONE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::BINPERSID);
 
   // storage offset
   int64_t storage_offset = 0;
   pushInt(storage_offset);
 
   // size
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
   for (auto size : tensor.sizes()) {
     pushInt(size);
   }
-  push<OpCode>(OpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
 
   // stride
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
   for (auto stride : tensor.strides()) {
     pushInt(stride);
   }
-  push<OpCode>(OpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
 
   // requires_grad
   addIValue(tensor.requires_grad());
 
   // backward_hooks
   pushGlobal("collections\nOrderedDict\n");
-  push<OpCode>(OpCode::EMPTY_TUPLE);
+  push<PickleOpCode>(PickleOpCode::EMPTY_TUPLE);
   // Construct the collections.OrderedDict for the backward_hooks
-  push<OpCode>(OpCode::REDUCE);
+  push<PickleOpCode>(PickleOpCode::REDUCE);
 
-  push<OpCode>(OpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
 
   // Call torch._utils._rebuild_tensor_v2
-  push<OpCode>(OpCode::REDUCE);
+  push<PickleOpCode>(PickleOpCode::REDUCE);
 
   // Store tensor so it can be placed into the binary after the pickle program
   literal_tensors_.push_back(ivalue.toTensor());
@@ -335,24 +355,49 @@ void Pickler::pushTensorReference(const IValue& ivalue) {
   int64_t tensor_id = tensor_table_->size() - 1;
   // Reduce arguments are spread (e.g. `*args`) before calling the global,
   // so wrap in a tuple
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
   addIValue(tensor_id);
-  push<OpCode>(OpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
+
+  push<PickleOpCode>(PickleOpCode::REDUCE);
+}
+
+void Pickler::pushRawList(PicklerClass cls, const void* data, size_t nbytes) {
+  pushClass(cls);
+
+  // Reduce arguments are spread (e.g. `*args`) before calling the global,
+  // so wrap in a tuple
+  push<PickleOpCode>(PickleOpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::BINBYTES);
+  push<uint32_t>(nbytes);
+  const char* begin = static_cast<const char*>(data);
+  stack_.insert(stack_.end(), begin, begin + nbytes);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
 
-  push<OpCode>(OpCode::REDUCE);
+  // Call reduce
+  push<PickleOpCode>(PickleOpCode::REDUCE);
 }
 
 void Pickler::pushIntList(const IValue& ivalue) {
+  const auto& list = ivalue.toIntListRef();
+  const size_t nbytes = list.size() * sizeof(int64_t);
+  if (list.size() >= kRawIntListSize &&
+      nbytes <= std::numeric_limits<uint32_t>::max()) {
+    pushRawList(PicklerClass::INTLIST_RAW, list.data(), nbytes);
+    pushMemoization(ivalue);
+    return;
+  }
+
   pushClass(PicklerClass::INTLIST);
 
 
   // Reduce arguments are spread (e.g. `*args`) before calling the global,
   // so wrap in a tuple
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
 
-  push<OpCode>(OpCode::EMPTY_LIST);
+  push<PickleOpCode>(PickleOpCode::EMPTY_LIST);
   // Mark list
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
 
   // Add items
   for (const auto& item : ivalue.toIntListRef()) {
@@ -360,13 +405,13 @@ void Pickler::pushIntList(const IValue& ivalue) {
   }
 
   // Finish list
-  push<OpCode>(OpCode::APPENDS);
+  push<PickleOpCode>(PickleOpCode::APPENDS);
 
   // Finish tuple
-  push<OpCode>(OpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
 
   // Call reduce
-  push<OpCode>(OpCode::REDUCE);
+  push<PickleOpCode>(PickleOpCode::REDUCE);
   pushMemoization(ivalue);
 }
 
@@ -375,17 +420,29 @@ void Pickler::pushDouble(const IValue& ivalue) {
   AT_ASSERT(sizeof(double) == 8);
   char* bytes = reinterpret_cast<char*>(&value);
 
-  push<OpCode>(OpCode::BINFLOAT);
+  push<PickleOpCode>(PickleOpCode::BINFLOAT);
   for (size_t i = 0; i < 8; ++i) {
     push<uint8_t>(bytes[8 - i - 1]);
   }
 }
 
+void Pickler::pushDoubleList(const IValue& ivalue) {
+  const auto& list = ivalue.toDoubleListRef();
+  const size_t nbytes = list.size() * sizeof(double);
+  AT_CHECK(
+      nbytes <= std::numeric_limits<uint32_t>::max(),
+      "Pickler cannot serialize a List[float] of ",
+      list.size(),
+      " elements");
+  pushRawList(PicklerClass::DOUBLELIST_RAW, list.data(), nbytes);
+  pushMemoization(ivalue);
+}
+
 void Pickler::pushDict(const IValue& ivalue) {
-  push<OpCode>(OpCode::EMPTY_DICT);
+  push<PickleOpCode>(PickleOpCode::EMPTY_DICT);
   pushMemoization(ivalue);
 
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
 
   // Sort the dict for deterministic keys
   auto dict_items = ivalue.toGenericDict()->iterationOrder();
@@ -394,7 +451,7 @@ void Pickler::pushDict(const IValue& ivalue) {
     addIValue(pair.second);
   }
 
-  push<OpCode>(OpCode::SETITEMS);
+  push<PickleOpCode>(PickleOpCode::SETITEMS);
 }
 
 void Pickler::pushMemoization(const void* item) {
@@ -404,11 +461,11 @@ void Pickler::pushMemoization(const void* item) {
 
 size_t Pickler::pushNextBinPut() {
   if (memo_id_ <= std::numeric_limits<uint8_t>::max()) {
-    push<OpCode>(OpCode::BINPUT);
+    push<PickleOpCode>(PickleOpCode::BINPUT);
     push<uint8_t>(memo_id_);
   } else {
     // Memoized too many items, issue a LONG_BINPUT instead
-    push<OpCode>(OpCode::LONG_BINPUT);
+    push<PickleOpCode>(PickleOpCode::LONG_BINPUT);
     push<uint32_t>(memo_id_);
   }
   AT_ASSERT(memo_id_ <= std::numeric_limits<uint32_t>::max());
@@ -430,28 +487,28 @@ void Pickler::pushMemoization(const IValue& ivalue) {
 
 void Pickler::pushList(const IValue& ivalue) {
   auto list = ivalue.toGenericListRef();
-  push<OpCode>(OpCode::EMPTY_LIST);
+  push<PickleOpCode>(PickleOpCode::EMPTY_LIST);
   pushMemoization(ivalue);
 
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
 
   for (const auto& item : list) {
     addIValue(item);
   }
 
-  push<OpCode>(OpCode::APPENDS);
+  push<PickleOpCode>(PickleOpCode::APPENDS);
 }
 
 void Pickler::pushTuple(const IValue& ivalue) {
   // TODO: Small tuple unrolling (e.g. TUPLE3)
-  push<OpCode>(OpCode::MARK);
+  push<PickleOpCode>(PickleOpCode::MARK);
   auto tuple = ivalue.toTuple()->elements();
 
   for (const auto& item : tuple) {
     addIValue(item);
   }
 
-  push<OpCode>(OpCode::TUPLE);
+  push<PickleOpCode>(PickleOpCode::TUPLE);
   pushMemoization(ivalue);
 }
 
@@ -488,7 +545,7 @@ double Unpickler::readFloat() {
 void Unpickler::run() {
   // Expect a PROTO opcode and protocol number at the start of blob
   AT_CHECK(
-      readOpCode() == OpCode::PROTO,
+      readOpCode() == PickleOpCode::PROTO,
       "Expected PROTO opcode at the start"
       " of pickle archive");
   uint8_t protocol = read<uint8_t>();
@@ -498,8 +555,8 @@ void Unpickler::run() {
       protocol);
 
   while (bytes_ < end_ptr_) {
-    OpCode opcode = readInstruction();
-    if (opcode == OpCode::STOP) {
+    PickleOpCode opcode = readInstruction();
+    if (opcode == PickleOpCode::STOP) {
       return;
     }
     last_opcode_ = opcode;
@@ -509,11 +566,11 @@ void Unpickler::run() {
 }
 
 
-OpCode Unpickler::readInstruction() {
+PickleOpCode Unpickler::readInstruction() {
   auto opcode = readOpCode();
   switch (opcode) {
-    case OpCode::EMPTY_LIST: {
-      if (last_opcode_ == OpCode::NEWOBJ) {
+    case PickleOpCode::EMPTY_LIST: {
+      if (last_opcode_ == PickleOpCode::NEWOBJ) {
         // TODO [unpickler refactor] remove this case
         // It's a list specialization, the enum ID of which is on the stack
         AT_CHECK(
@@ -540,17 +597,17 @@ OpCode Unpickler::readInstruction() {
         stack_.emplace_back(std::vector<IValue>());
       }
     } break;
-    case OpCode::EMPTY_TUPLE: {
+    case PickleOpCode::EMPTY_TUPLE: {
       stack_.emplace_back(c10::ivalue::Tuple::create({}));
     } break;
-    case OpCode::BINPUT: {
+    case PickleOpCode::BINPUT: {
       size_t memo_id = read<uint8_t>();
       if (memo_table_.size() <= memo_id) {
         memo_table_.reserve(1 + 2 * memo_id);
       }
       memo_table_.push_back(stack_.back());
     } break;
-    case OpCode::LONG_BINPUT: {
+    case PickleOpCode::LONG_BINPUT: {
       AT_CHECK(
           std::numeric_limits<size_t>::max() >=
               std::numeric_limits<uint32_t>::max(),
@@ -562,76 +619,87 @@ OpCode Unpickler::readInstruction() {
       }
       memo_table_.push_back(stack_.back());
     } break;
-    case OpCode::MARK: {
+    case PickleOpCode::MARK: {
       // Mark location of the container ivalue in the stack
       marks_.push_back(stack_.size());
     } break;
-    case OpCode::NEWTRUE: {
+    case PickleOpCode::NEWTRUE: {
       stack_.emplace_back(true);
     } break;
-    case OpCode::NEWFALSE: {
+    case PickleOpCode::NEWFALSE: {
       stack_.emplace_back(false);
     } break;
-    case OpCode::BININT1: {
+    case PickleOpCode::BININT1: {
       int8_t value = read<int8_t>();
       stack_.emplace_back(int64_t(value));
     } break;
-    case OpCode::BININT: {
+    case PickleOpCode::BININT: {
       int32_t value = read<int32_t>();
       stack_.emplace_back(int64_t(value));
     } break;
-    case OpCode::LONG1: {
+    case PickleOpCode::LONG1: {
       // Only read LONG1s with 8 as the length
       uint8_t length = read<uint8_t>();
       AT_ASSERT(length == 8);
       stack_.emplace_back(int64_t(read<int64_t>()));
     } break;
-    case OpCode::BINUNICODE: {
+    case PickleOpCode::BINUNICODE: {
       uint32_t length = read<uint32_t>();
       const char* characters = reinterpret_cast<const char*>(bytes_);
       AT_ASSERT(bytes_ + length < end_ptr_);
       bytes_ += length;
       stack_.emplace_back(std::string(characters, /*n=*/length));
     } break;
-    case OpCode::BINFLOAT:
+    case PickleOpCode::BINBYTES: {
+      uint32_t length = read<uint32_t>();
+      const char* characters = reinterpret_cast<const char*>(bytes_);
+      AT_CHECK(
+          bytes_ + length < end_ptr_,
+          "Unpickler overran buffer while reading bytes");
+      bytes_ += length;
+      stack_.emplace_back(std::string(characters, /*n=*/length));
+    } break;
+    case PickleOpCode::BINFLOAT:
       stack_.emplace_back(readFloat());
       break;
-    case OpCode::TUPLE: {
+    case PickleOpCode::TUPLE: {
       size_t start = marks_.back();
       marks_.pop_back();
       auto tuple = c10::ivalue::Tuple::create({});
       tuple->elements().reserve(stack_.size() - start);
       auto start_it = stack_.begin() + start;
       for (auto it = start_it; it != stack_.end(); ++it) {
-        tuple->elements().emplace_back(it->ivalue());
+        tuple->elements().emplace_back(it->takeIValue());
       }
       stack_.erase(start_it, stack_.end());
       stack_.emplace_back(IValue(tuple));
     } break;
-    case OpCode::EMPTY_DICT:
+    case PickleOpCode::EMPTY_DICT:
       stack_.emplace_back(c10::ivalue::UnorderedMap());
       break;
-    case OpCode::APPENDS: {
+    case PickleOpCode::APPENDS: {
       readList();
     } break;
-    case OpCode::SETITEMS: {
+    case PickleOpCode::SETITEMS: {
       size_t start = marks_.back();
       marks_.pop_back();
       auto dict = stack_.at(start - 1).ivalue().toGenericDict();
+      dict->elements().reserve(
+          dict->elements().size() + (stack_.size() - start) / 2);
       for (size_t i = start; i < stack_.size(); i += 2) {
-        dict->elements()[stack_[i].ivalue()] = stack_[i + 1].ivalue();
+        dict->elements()[stack_[i].takeIValue()] = stack_[i + 1].takeIValue();
       }
       stack_.erase(stack_.begin() + start, stack_.end());
     } break;
-    case OpCode::BINGET: {
+    case PickleOpCode::BINGET: {
       stack_.push_back(memo_table_.at(read<uint8_t>()));
     } break;
-    case OpCode::LONG_BINGET: {
+    case PickleOpCode::LONG_BINGET: {
       stack_.push_back(memo_table_.at(read<uint32_t>()));
     } break;
-    case OpCode::STOP:
+    case PickleOpCode::STOP:
       break;
-    case OpCode::GLOBAL: {
+    case PickleOpCode::GLOBAL: {
       // Module name, it's not needed for anything
       auto module_name = readString();
       // TODO [unpickler refactor] __main__ isn't used by the pickler anymore
@@ -642,11 +710,11 @@ OpCode Unpickler::readInstruction() {
         stack_.emplace_back(getClass(readString()));
       }
     } break;
-    case OpCode::NEWOBJ: {
+    case PickleOpCode::NEWOBJ: {
       // pop empty tuple
       stack_.pop_back();
     } break;
-    case OpCode::BUILD: {
+    case PickleOpCode::BUILD: {
       // TODO: [unpickler refactor]
       auto setitem_data = stack_.back().ivalue();
       stack_.pop_back();
@@ -667,7 +735,7 @@ OpCode Unpickler::readInstruction() {
         AT_ERROR("Unknown pickler class id");
       }
     } break;
-    case OpCode::REDUCE: {
+    case PickleOpCode::REDUCE: {
       // Pop reduce arg off the stack
       auto data = stack_.back().ivalue().toTuple();
       stack_.pop_back();
@@ -684,6 +752,14 @@ OpCode Unpickler::readInstruction() {
         case PicklerClass::INTLIST:
           stack_.emplace_back(data->elements().at(0).toIntListRef());
           break;
+        case PicklerClass::INTLIST_RAW:
+          stack_.emplace_back(
+              readRawList<int64_t>(data->elements().at(0).toStringRef()));
+          break;
+        case PicklerClass::DOUBLELIST_RAW:
+          stack_.emplace_back(
+              readRawList<double>(data->elements().at(0).toStringRef()));
+          break;
         default:
           AT_ERROR("Unknown pickler class id");
       }
@@ -709,7 +785,7 @@ void Unpickler::readList() {
     auto list = stack_.at(start - 1).ivalue().toGenericList();
     list->elements().reserve(num_elements);
     for (auto it = stack_.begin() + start; it != stack_.end(); ++it) {
-      list->elements().emplace_back(it->ivalue());
+      list->elements().emplace_back(it->takeIValue());
     }
   }
 
@@ -752,8 +828,8 @@ std::string Unpickler::readString() {
   return std::string(chars, n);
 }
 
-OpCode Unpickler::readOpCode() {
-  return static_cast<OpCode>(read<uint8_t>());
+PickleOpCode Unpickler::readOpCode() {
+  return static_cast<PickleOpCode>(read<uint8_t>());
 }
 
 std::pair<at::Tensor, uint64_t> getWriteableTensor(const at::Tensor& tensor) {
@@ -764,14 +840,20 @@ std::pair<at::Tensor, uint64_t> getWriteableTensor(const at::Tensor& tensor) {
     // NB: This new tensor is created to support cuda tensors.
     // Storages can be mutated when converting tensors from cuda to cpu,
     // and we need a cpu tensor to copy data from.
-    storage_tensor = at::empty({0}, tensor.options())
-                         .set_(
-                             tensor.storage(),
-                             /* storage_offset = */ 0,
-                             /* size = */
-                             {static_cast<int64_t>(tensor.storage().size())},
-                             /* stride = */ {1})
-                         .cpu();
+    // The copy goes through pinned memory, which is faster to copy to and
+    // doesn't make the device wait for pageable host memory.
+    const auto storage_view =
+        at::empty({0}, tensor.options())
+            .set_(
+                tensor.storage(),
+                /* storage_offset = */ 0,
+                /* size = */
+                {static_cast<int64_t>(tensor.storage().size())},
+                /* stride = */ {1});
+    storage_tensor = at::empty(
+        storage_view.sizes(),
+        storage_view.options().device(at::kCPU).pinned_memory(true));
+    storage_tensor.copy_(storage_view);
     AT_CHECK(
         storage_tensor.element_size() * storage_tensor.storage().size() ==
             record_size,
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -11,7 +12,7 @@ namespace torch {
 namespace jit {
 
 // See Python's pickletools.py for a detailed description of each of these codes
-enum class OpCode : char {
+enum class PickleOpCode : char {
   MARK = '(',
   STOP = '.',
   POP = '0',
@@ -90,6 +91,10 @@ enum PicklerClass : uint8_t {
   TENSOR = 0,
   // List[int]
   INTLIST = 1,
+  // List[int] stored as the bytes of its little-endian int64 elements
+  INTLIST_RAW = 2,
+  // List[float] stored as the bytes of its little-endian double elements
+  DOUBLELIST_RAW = 3,
 };
 
 using ::c10::IValue;
@@ -106,7 +111,7 @@ class Pickler {
   // Push protocol onto the stack
   void start();
 
-  // Push STOP OpCode onto the stack
+  // Push STOP PickleOpCode onto the stack
   void finish();
 
   void addIValue(const IValue& ivalue);
@@ -122,6 +127,7 @@ class Pickler {
  private:
   void pushDict(const IValue& ivalue);
   void pushDouble(const IValue& ivalue);
+  void pushDoubleList(const IValue& ivalue);
   void pushInt(const IValue& ivalue);
   void pushIntList(const IValue& ivalue);
   void pushList(const IValue& ivalue);
@@ -136,6 +142,7 @@ class Pickler {
   void pushClass(PicklerClass cls);
   void pushGlobal(const std::string& name);
   void pushMemoization(const void* item);
+  void pushRawList(PicklerClass cls, const void* data, size_t nbytes);
   void pushString(const std::string& string);
   void pushTensorData(const at::Tensor& tensor);
 
@@ -190,6 +197,11 @@ struct StackItem {
     return *ivalue_;
   }
 
+  // Moves the value out of the item, which must not be used afterwards
+  IValue takeIValue() {
+    return std::move(*ivalue_);
+  }
+
   PicklerClass pickler_class() {
     return *pickler_class_;
   }
@@ -207,10 +219,10 @@ struct StackItem {
   c10::optional<IValue> ivalue_;
 };
 
-// [unpickler refactor] there is some cruft around OpCode::BUILD,
-// OpCode::NEWOBJ, and the last_opcode_ member below that should be deleted at
-// some point, the Pickler doesn't produce it and it's only around to support
-// models saved before 1.1
+// [unpickler refactor] there is some cruft around PickleOpCode::BUILD,
+// PickleOpCode::NEWOBJ, and the last_opcode_ member below that should be
+// deleted at some point, the Pickler doesn't produce it and it's only around
+// to support models saved before 1.1
 class Unpickler {
   TH_DISALLOW_COPY_AND_ASSIGN(Unpickler);
 
@@ -222,7 +234,7 @@ class Unpickler {
       : bytes_(static_cast<const uint8_t*>(data)),
         end_ptr_(bytes_ + size),
         tensor_table_(tensor_table),
-        last_opcode_(OpCode::STOP) {}
+        last_opcode_(PickleOpCode::STOP) {}
 
   std::vector<IValue> parse_ivalue_list();
 
@@ -240,9 +252,24 @@ class Unpickler {
     return item;
   }
 
+  // Decodes the elements of a list pickled as the bytes of its elements
+  template <typename T>
+  std::vector<T> readRawList(const std::string& bytes) {
+    AT_CHECK(
+        bytes.size() % sizeof(T) == 0,
+        "Unpickler found a list of ",
+        bytes.size(),
+        " bytes, which is not a multiple of its element size");
+    std::vector<T> list(bytes.size() / sizeof(T));
+    if (!list.empty()) {
+      std::memcpy(list.data(), bytes.data(), bytes.size());
+    }
+    return list;
+  }
+
   double readFloat();
-  OpCode readInstruction();
-  OpCode readOpCode();
+  PickleOpCode readInstruction();
+  PickleOpCode readOpCode();
   std::string readString();
   void readList();
   void run();
@@ -255,7 +282,7 @@ class Unpickler {
   const std::vector<at::Tensor>* tensor_table_;
 
   // [unpickler refactor]
-  OpCode last_opcode_;
+  PickleOpCode last_opcode_;
 };
 
 // returns a (tensor, record_size) for a tensor, converting it to a CPU tensor
@@ -17,33 +17,34 @@ Node* ProfilingRecord::createProfileNode(
   return pn;
 }
 
+Node* ProfilingRecord::createShapeProfileNode(Value* o) {
+  std::function<void(Stack&)> shape_profiler = [this, o](Stack& stack) {
+    IValue t;
+    pop(stack, t);
+    if (t.isTensor()) {
+      auto pttp = ProfiledTensorType::create(t.toTensor());
+      std::lock_guard<std::mutex> lock(this->mutex_);
+      if (o->type()->isSubclass(TypeKind::ProfiledTensorType)) {
+        auto type = o->type()->cast<ProfiledTensorType>();
+        o->setType(type->merge(pttp));
+      } else {
+        o->setType(pttp);
+      }
+    }
+  };
+  return createProfileNode(shape_profiler, {o});
+}
+
 void ProfilingRecord::instrumentBlock(Block* block) {
-  // iterating backwards allows us to easily insert profile nodes
-  // without affecting an iterator
-  for (auto it = block->nodes().rend(); it != block->nodes().rbegin(); --it) {
-    auto n = *it;
+  // the iterator is advanced before profile nodes are inserted after n,
+  // so they are never visited themselves
+  for (auto it = block->nodes().begin(); it != block->nodes().end();) {
+    auto n = *it++;
     for (auto o : n->outputs()) {
       if (!o->type()->isSubclass(TypeKind::TensorType)) {
         continue;
       }
-
-      std::function<void(Stack&)> shape_profiler = [this, o](Stack& stack) {
-        IValue t;
-        pop(stack, t);
-        if (t.isTensor()) {
-          auto pttp = ProfiledTensorType::create(t.toTensor());
-          std::lock_guard<std::mutex> lock(this->mutex_);
-          if (o->type()->isSubclass(TypeKind::ProfiledTensorType)) {
-            auto type = o->type()->cast<ProfiledTensorType>();
-            o->setType(type->merge(pttp));
-          } else {
-            o->setType(pttp);
-          }
-        }
-      };
-
-      auto pn = createProfileNode(shape_profiler, {o});
-      pn->insertAfter(n);
+      createShapeProfileNode(o)->insertAfter(n);
     }
 
     for (auto b : n->blocks()) {
@@ -59,6 +60,12 @@ std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
   auto raw_pr = pr.get();
 
   pr->instrumentBlock(new_g->block());
+  // the shapes of the graph inputs are the ones specializations guard on
+  for (auto i : new_g->inputs()) {
+    if (i->type()->isSubclass(TypeKind::TensorType)) {
+      new_g->prependNode(pr->createShapeProfileNode(i));
+    }
+  }
   std::function<void(Stack&)> counter = [raw_pr](Stack&) {
     std::lock_guard<std::mutex> lock(raw_pr->mutex_);
     raw_pr->profiling_count_--;
@@ -33,6 +33,7 @@ struct ProfilingRecord {
   Node* createProfileNode(
       const std::function<void(Stack&)>& fp,
       at::ArrayRef<Value*> inputs);
+  Node* createShapeProfileNode(Value* o);
   void instrumentBlock(Block* block);
   ProfilingRecord(std::shared_ptr<Graph> g);
 };
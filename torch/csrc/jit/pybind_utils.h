@@ -267,8 +267,8 @@ inline IValue toIValue(
           if (!N || !py::isinstance<py::int_>(obj)) {
             return py::cast<std::vector<int64_t>>(obj);
           } else {
-            double value = py::cast<int64_t>(obj);
-            std::vector<double> repeated(*N, value);
+            int64_t value = py::cast<int64_t>(obj);
+            std::vector<int64_t> repeated(*N, value);
             return repeated;
           }
         case TypeKind::FloatType:
@@ -279,6 +279,8 @@ inline IValue toIValue(
             std::vector<double> repeated(*N, value);
             return repeated;
           }
+        case TypeKind::BoolType:
+          return py::cast<std::vector<bool>>(obj);
         case TypeKind::DimensionedTensorType:
         case TypeKind::TensorType:
           return py::cast<std::vector<at::Tensor>>(obj);
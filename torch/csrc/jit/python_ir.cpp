@@ -231,7 +231,8 @@ void initPythonIRBindings(PyObject* module_) {
              int64_t onnx_opset_version,
              bool defer_weight_export,
              ::torch::onnx::OperatorExportTypes operator_export_type,
-             bool strip_doc_string) {
+             bool strip_doc_string,
+             const std::string& external_data_dir) {
             std::string graph;
             RawDataExportMap export_map;
             std::tie(graph, export_map) = export_onnx(
@@ -240,7 +241,8 @@ void initPythonIRBindings(PyObject* module_) {
                 onnx_opset_version,
                 defer_weight_export,
                 operator_export_type,
-                strip_doc_string);
+                strip_doc_string,
+                external_data_dir);
             std::unordered_map<std::string, py::bytes>
                 python_serialized_export_map;
             for (auto& kv : export_map) {
@@ -260,7 +262,8 @@ void initPythonIRBindings(PyObject* module_) {
           py::arg("defer_weight_export") = false,
           py::arg("operator_export_type") =
               ::torch::onnx::OperatorExportTypes::ONNX,
-          py::arg("strip_doc_string") = true)
+          py::arg("strip_doc_string") = true,
+          py::arg("external_data_dir") = std::string())
       .def(
           "_pretty_print_onnx",
           [](const std::shared_ptr<Graph> g,
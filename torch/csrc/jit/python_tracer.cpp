@@ -41,6 +41,7 @@ std::shared_ptr<torch::jit::Graph> createGraphByTracing(
     TypedStack trace_inputs,
     const py::function& var_name_lookup_fn,
     bool force_outplace,
+    bool record_source_locations,
     const std::shared_ptr<script::Module>& self) {
   auto enter_info = tracer::enter(std::move(trace_inputs), self);
   auto graph = enter_info.first->graph;
@@ -51,6 +52,7 @@ std::shared_ptr<torch::jit::Graph> createGraphByTracing(
     return py::cast<std::string>(var_name_lookup_fn(var));
   };
   getTracingState()->force_outplace = force_outplace;
+  getTracingState()->record_source_locations = record_source_locations;
   try {
     size_t num_func_inputs = enter_info.second.size();
     py::tuple py_inputs(num_func_inputs);
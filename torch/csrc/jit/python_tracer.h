@@ -29,6 +29,7 @@ std::shared_ptr<Graph> createGraphByTracing(
     TypedStack inputs,
     const py::function& var_name_lookup_fn,
     bool force_outplace,
+    bool record_source_locations,
     const std::shared_ptr<script::Module>& self = nullptr);
 } // namespace tracer
 } // namespace jit
@@ -15,9 +15,9 @@
 #include <torch/csrc/jit/script/logging.h>
 
 #include <ATen/ExpandUtils.h>
+#include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
 #include <ATen/core/ivalue.h>
-#include <c10/core/thread_pool.h>
 #include <c10/util/SmallVector.h>
 
 #include <algorithm>
@@ -237,6 +237,38 @@ RegisterOperators reg(
            push(stack, autograd::make_variable(at::scalar_to_tensor(b)));
            return 0;
          }),
+     // Memory planning, see passes/memory_planning.h. The buffers are views
+     // into the arena, which they keep alive.
+     Operator(
+         "prim::MemoryArena(int nbytes) -> Tensor",
+         [](Stack& stack) {
+           int64_t nbytes;
+           pop(stack, nbytes);
+           push(
+               stack,
+               autograd::make_variable(at::empty({nbytes}, at::kByte)));
+           return 0;
+         }),
+     Operator(
+         "prim::ArenaBuffer(Tensor(a) arena, int offset, int[] sizes, int dtype) -> Tensor(a)",
+         [](Stack& stack) {
+           auto dtype = static_cast<at::ScalarType>(pop(stack).toInt());
+           auto sizes = pop(stack).toIntList()->elements();
+           auto offset = pop(stack).toInt();
+           auto arena = pop(stack).toTensor();
+           int64_t nbytes = at::elementSize(dtype);
+           for (auto size : sizes) {
+             nbytes *= size;
+           }
+           AT_ASSERT(offset >= 0 && offset + nbytes <= arena.numel());
+           auto buffer = at::from_blob(
+               arena.data<uint8_t>() + offset,
+               sizes,
+               [arena](void*) {},
+               arena.options().dtype(dtype));
+           push(stack, autograd::make_variable(buffer));
+           return 0;
+         }),
      Operator(
          "prim::Float(Scalar a) -> float",
          [](Stack& stack) {
@@ -894,7 +926,7 @@ RegisterOperators reg(
 
              push(stack, forked_interprester.getFuture());
 
-             c10::global_work_queue().run(std::move(continuation));
+             at::launch(std::move(continuation));
              return 0;
            };
          }),
@@ -14,6 +14,7 @@
 #include <torch/csrc/jit/hooks_for_testing.h>
 #include <torch/csrc/jit/import_source.h>
 #include <torch/csrc/jit/irparser.h>
+#include <torch/csrc/jit/mobile/import.h>
 #include <torch/csrc/jit/passes/python_print.h>
 #include <torch/csrc/jit/pybind_utils.h>
 #include <torch/csrc/jit/python_tracer.h>
@@ -263,6 +264,15 @@ void initJitScriptBindings(PyObject* module) {
             return py::bytes(buf.str());
           },
           py::arg("_extra_files") = ExtraFilesMap())
+      .def(
+          "_save_for_mobile",
+          [](std::shared_ptr<Module> m,
+             const std::string& filename,
+             const ExtraFilesMap& _extra_files = ExtraFilesMap()) {
+            m->_save_for_mobile(filename, _extra_files);
+          },
+          py::arg("filename"),
+          py::arg("_extra_files") = ExtraFilesMap())
       .def("_set_optimized", &Module::set_optimized)
       .def(
           "_define",
@@ -402,12 +412,18 @@ void initJitScriptBindings(PyObject* module) {
              py::function func,
              py::tuple input_tuple,
              py::function var_lookup_fn,
-             bool force_outplace) {
+             bool force_outplace,
+             bool record_source_locations) {
             // prereq: Module's buffers and parameters are unique
             // this was ensured in python before calling this function
             auto typed_inputs = toTypedStack(input_tuple);
             auto graph = tracer::createGraphByTracing(
-                func, typed_inputs, var_lookup_fn, force_outplace, self);
+                func,
+                typed_inputs,
+                var_lookup_fn,
+                force_outplace,
+                record_source_locations,
+                self);
             self->module_object()->type()->compilation_unit().create_function(
                 name, graph);
             didFinishEmitModule(self);
@@ -539,10 +555,15 @@ void initJitScriptBindings(PyObject* module) {
          py::function func,
          py::tuple input_tuple,
          py::function var_lookup_fn,
-         bool force_outplace) {
+         bool force_outplace,
+         bool record_source_locations) {
         auto typed_inputs = toTypedStack(input_tuple);
         auto graph = tracer::createGraphByTracing(
-            func, typed_inputs, var_lookup_fn, force_outplace);
+            func,
+            typed_inputs,
+            var_lookup_fn,
+            force_outplace,
+            record_source_locations);
         CompilationUnit cu;
         auto result = cu.create_function(std::move(name), std::move(graph));
         didFinishEmitFunction(result);
@@ -604,6 +625,23 @@ void initJitScriptBindings(PyObject* module) {
         import_ir_module(module_lookup, in, optional_device, extra_files);
       });
 
+  py::class_<mobile::Module>(m, "LiteScriptModule")
+      .def(
+          "forward",
+          [](const mobile::Module& self, py::args args) {
+            return toPyObject(self.forward(toStack(args)));
+          })
+      .def(
+          "run_method",
+          [](const mobile::Module& self,
+             const std::string& method_name,
+             py::args args) {
+            return toPyObject(self.run_method(method_name, toStack(args)));
+          });
+  m.def("_load_for_mobile", [](const std::string& filename) {
+    return mobile::_load_for_mobile(filename);
+  });
+
   m.def(
       "_jit_import_functions",
       [](CompilationUnit& cu,
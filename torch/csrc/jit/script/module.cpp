@@ -101,6 +101,18 @@ void Module::save(
   ExportModule(*this, filename, extra_files);
 }
 
+void Module::_save_for_mobile(
+    std::ostream& out,
+    const ExtraFilesMap& extra_files) {
+  ExportModule(*this, out, extra_files, /*bytecode_format=*/true);
+}
+
+void Module::_save_for_mobile(
+    const std::string& filename,
+    const ExtraFilesMap& extra_files) {
+  ExportModule(*this, filename, extra_files, /*bytecode_format=*/true);
+}
+
 void module_state_to(
     const Slot& s,
     const c10::optional<at::Device>& device,
@@ -400,6 +400,16 @@ struct TORCH_API Module {
       const std::string& filename,
       const ExtraFilesMap& extra_files = ExtraFilesMap());
 
+  // Like save, and also writes the methods as the bytecode of the mobile
+  // interpreter, for torch::jit::mobile::_load_for_mobile.
+  void _save_for_mobile(
+      std::ostream& out,
+      const ExtraFilesMap& extra_files = ExtraFilesMap());
+
+  void _save_for_mobile(
+      const std::string& filename,
+      const ExtraFilesMap& extra_files = ExtraFilesMap());
+
   void copy_into(
       const ModuleLookup& module_lookup,
       // translate current module singleton type to new module
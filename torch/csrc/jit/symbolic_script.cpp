@@ -402,11 +402,13 @@ const std::vector<std::string> functions = {
 
             return torch._dim_arange(like, dim), backward
 
-        def contiguous(self):
+        def contiguous(self,
+                       *,
+                       memory_format: int=0):
             def backward(grad_output):
-                return grad_output
+                return grad_output, None
 
-            return self.contiguous(), backward
+            return self.contiguous(memory_format=memory_format), backward
 
         def dot(self, tensor):
             def backward(grad_output):
@@ -738,6 +740,86 @@ const std::vector<std::string> functions = {
 
             return result, backward
 
+        # The activation gradients below are written with elementwise ops
+        # only, so that the backward gets fused like the forward does
+        def leaky_relu(self, negative_slope: number):
+            def backward(grad_output):
+                grad_self = torch.where(self > 0, grad_output, grad_output * negative_slope)
+                return grad_self, None
+
+            return torch.leaky_relu(self, negative_slope), backward
+
+        def hardtanh(self,
+                     min_val: number,
+                     max_val: number):
+            def backward(grad_output):
+                mask = (self > min_val).type_as(grad_output) * (self < max_val).type_as(grad_output)
+                return grad_output * mask, None, None
+
+            return torch.hardtanh(self, min_val, max_val), backward
+
+        def elu(self,
+                alpha: number,
+                scale: number,
+                input_scale: number):
+            result = torch.elu(self, alpha, scale, input_scale)
+            def backward(grad_output):
+                negcoef = float(alpha) * float(scale)
+                grad_self = torch.where(result > 0,
+                                        grad_output * scale,
+                                        grad_output * input_scale * (result + negcoef))
+                return grad_self, None, None, None
+
+            return result, backward
+
+        def selu(self):
+            result = torch.selu(self)
+            def backward(grad_output):
+                # Precomputed constants alpha and scale of selu, see torch.selu
+                scale = 1.0507009873554804934193349852946
+                negcoef = 1.6732632423543772848170429916717 * scale
+                return torch.where(result > 0, grad_output * scale, grad_output * (result + negcoef))
+
+            return result, backward
+
+        def celu(self, alpha: number):
+            result = torch.celu(self, alpha)
+            def backward(grad_output):
+                grad_self = torch.where(result > 0, grad_output, grad_output * (result / alpha + 1))
+                return grad_self, None
+
+            return result, backward
+
+        def softplus(self,
+                     beta: number,
+                     threshold: number):
+            result = torch.softplus(self, beta, threshold)
+            def backward(grad_output):
+                z = torch.exp(result * beta)
+                grad_self = torch.where(result * beta > threshold, grad_output, grad_output * (z - 1) / z)
+                return grad_self, None, None
+
+            return result, backward
+
+        def AD_shrink_backward(grad,
+                               self,
+                               lambd: number):
+            bound = float(lambd)
+            mask = (self > bound).type_as(grad) + (self < -bound).type_as(grad)
+            return grad * mask
+
+        def hardshrink(self, lambd: number):
+            def backward(grad_output):
+                return AD_shrink_backward(grad_output, self, lambd), None
+
+            return torch.hardshrink(self, lambd), backward
+
+        def softshrink(self, lambd: number):
+            def backward(grad_output):
+                return AD_shrink_backward(grad_output, self, lambd), None
+
+            return torch.softshrink(self, lambd), backward
+
         def erfc(self):
             def backward(grad_output):
                 # Precomputed constant C = -2.0 / math.sqrt(math.pi)
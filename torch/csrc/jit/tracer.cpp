@@ -461,6 +461,21 @@ void addInputs(
     n->addInput(none);
   }
 }
+void addInputs(Node* n, const char* name, at::MemoryFormat value) {
+  detail::genericAddInput(n, static_cast<int64_t>(value));
+}
+void addInputs(
+    Node* n,
+    const char* name,
+    const c10::optional<at::MemoryFormat>& value) {
+  if (value) {
+    detail::genericAddInput(n, static_cast<int64_t>(*value));
+  } else {
+    Graph* g = n->owningGraph();
+    Value* none = g->insertNode(g->createNone(IntType::get()))->output();
+    n->addInput(none);
+  }
+}
 
 void addInputs(
     Node* n,
@@ -651,6 +666,10 @@ void defaultRecordSourceLocation(Node* n) {}
 std::atomic<decltype(&defaultRecordSourceLocation)> record_source_location(
     defaultRecordSourceLocation);
 void recordSourceLocation(Node* n) {
+  const auto& state = getTracingState();
+  if (state && !state->record_source_locations) {
+    return;
+  }
   return record_source_location.load()(n);
 }
 void setRecordSourceLocation(void (*v)(Node*)) {
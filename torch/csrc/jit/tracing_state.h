@@ -59,6 +59,9 @@ struct TORCH_API TracingState
   std::shared_ptr<Graph> graph;
   bool warn = true;
   bool force_outplace = false;
+  // Capturing the Python stack of every node dominates the time to trace
+  // large models, and the locations are only used in error messages.
+  bool record_source_locations = true;
   std::function<std::string(const Variable& var)> lookup_var_name_fn =
       [](const Variable& var) { return ""; };
 };
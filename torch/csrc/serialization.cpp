@@ -4,6 +4,26 @@
 #include <torch/csrc/THP.h>
 #include <torch/csrc/serialization.h>
 
+#ifdef USE_CUDA
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/PinnedMemoryAllocator.h>
+#include <c10/cuda/CUDAGuard.h>
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 template <class io>
 ssize_t doPartialRead(io fildes, void* buf, size_t nbytes);
 
@@ -177,6 +197,353 @@ void doWrite(io fildes, void* raw_buf, size_t nbytes) {
   }
 }
 
+namespace {
+
+// The alignment of the offsets, sizes and addresses of O_DIRECT writes
+constexpr size_t kDirectIOAlignment = 4096;
+
+void deleteAlignedBuffer(void* ptr) {
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  free(ptr);
+#endif
+}
+
+at::DataPtr allocateAlignedBuffer(size_t nbytes) {
+  void* ptr = nullptr;
+#ifdef _WIN32
+  ptr = _aligned_malloc(nbytes, kDirectIOAlignment);
+#else
+  if (posix_memalign(&ptr, kDirectIOAlignment, nbytes) != 0) {
+    ptr = nullptr;
+  }
+#endif
+  AT_CHECK(ptr, "writeStorages(): failed to allocate ", nbytes, " bytes");
+  return {ptr, ptr, &deleteAlignedBuffer, at::Device(at::kCPU)};
+}
+
+// Writes the bytes appended to it to fd in buffer-sized writes, on a
+// background thread, while the caller fills the next buffer.
+class StorageWriter {
+ public:
+  StorageWriter(
+      int fd,
+      size_t buffer_size,
+      size_t num_buffers,
+      bool pinned,
+      bool direct_io)
+      : fd_(fd), buffer_size_(buffer_size), direct_io_(direct_io) {
+    for (size_t i = 0; i < num_buffers; ++i) {
+#ifdef USE_CUDA
+      if (pinned) {
+        // Pinned memory is page-aligned
+        buffers_.push_back(
+            at::cuda::getPinnedMemoryAllocator()->allocate(buffer_size));
+        free_.push_back(i);
+        continue;
+      }
+#endif
+      buffers_.push_back(allocateAlignedBuffer(buffer_size));
+      free_.push_back(i);
+    }
+    capacity_ = buffer_size_;
+    if (direct_io_) {
+      setUpDirectIO();
+    }
+    thread_ = std::thread(&StorageWriter::run, this);
+    acquireBuffer();
+  }
+
+  ~StorageWriter() {
+    stopThread();
+    restoreFlags();
+  }
+
+  // Appends nbytes, copied by copy(dst, offset, n) for each range of n bytes
+  // at offset that fits in a buffer.
+  template <typename Copy>
+  void append(size_t nbytes, const Copy& copy) {
+    size_t offset = 0;
+    while (offset < nbytes) {
+      const size_t n = std::min(nbytes - offset, capacity_ - filled_);
+      copy(static_cast<char*>(buffers_[current_].get()) + filled_, offset, n);
+      filled_ += n;
+      offset += n;
+      if (filled_ == capacity_) {
+        submitBuffer();
+        acquireBuffer();
+      }
+    }
+  }
+
+  void appendHost(const void* data, size_t nbytes) {
+    const char* src = static_cast<const char*>(data);
+    append(nbytes, [src](char* dst, size_t offset, size_t n) {
+      memcpy(dst, src + offset, n);
+    });
+  }
+
+  // Waits for all the writes, and rethrows the error of the first one that
+  // failed
+  void finish() {
+    if (filled_ > 0) {
+      submitBuffer();
+    }
+    stopThread();
+    restoreFlags();
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+  }
+
+ private:
+  void setUpDirectIO() {
+#if defined(__linux__)
+    original_flags_ = fcntl(fd_, F_GETFL);
+    const off_t offset = lseek(fd_, 0, SEEK_CUR);
+    if (original_flags_ == -1 || offset == -1) {
+      direct_io_ = false;
+      return;
+    }
+    file_offset_ = offset;
+    // Probe for the support of O_DIRECT, which fcntl rejects on file systems
+    // that don't have it (e.g. tmpfs)
+    o_direct_ = fcntl(fd_, F_SETFL, original_flags_ | O_DIRECT) == 0;
+    if (o_direct_) {
+      fcntl(fd_, F_SETFL, original_flags_);
+      // The first buffer ends at an aligned offset, so that the next ones
+      // start at one
+      capacity_ = buffer_size_ - file_offset_ % kDirectIOAlignment;
+    }
+#elif defined(__APPLE__)
+    fcntl(fd_, F_NOCACHE, 1);
+#else
+    direct_io_ = false;
+#endif
+  }
+
+  void restoreFlags() {
+#if defined(__linux__)
+    if (o_direct_ && direct_enabled_) {
+      fcntl(fd_, F_SETFL, original_flags_);
+      direct_enabled_ = false;
+    }
+#elif defined(__APPLE__)
+    if (direct_io_) {
+      fcntl(fd_, F_NOCACHE, 0);
+      direct_io_ = false;
+    }
+#endif
+  }
+
+  void acquireBuffer() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !free_.empty() || error_; });
+    if (error_) {
+      std::rethrow_exception(error_);
+    }
+    current_ = free_.front();
+    free_.pop_front();
+    filled_ = 0;
+    if (submitted_ > 0) {
+      capacity_ = buffer_size_;
+    }
+  }
+
+  void submitBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.emplace_back(current_, filled_);
+    ++submitted_;
+    cv_.notify_all();
+  }
+
+  void stopThread() {
+    if (!thread_.joinable()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  void run() {
+    for (;;) {
+      std::pair<size_t, size_t> job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return !pending_.empty() || done_; });
+        if (pending_.empty()) {
+          return;
+        }
+        job = pending_.front();
+        pending_.pop_front();
+      }
+      std::exception_ptr error;
+      if (!failed_) {
+        try {
+          write(buffers_[job.first].get(), job.second);
+        } catch (...) {
+          error = std::current_exception();
+          failed_ = true;
+        }
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error) {
+          error_ = error;
+        }
+        free_.push_back(job.first);
+      }
+      cv_.notify_all();
+    }
+  }
+
+  void write(void* data, size_t nbytes) {
+#if defined(__linux__)
+    if (direct_io_) {
+      const bool aligned = file_offset_ % kDirectIOAlignment == 0 &&
+          nbytes % kDirectIOAlignment == 0;
+      if (o_direct_ && aligned != direct_enabled_) {
+        const int flags = aligned ? original_flags_ | O_DIRECT : original_flags_;
+        if (fcntl(fd_, F_SETFL, flags) == 0) {
+          direct_enabled_ = aligned;
+        }
+      }
+      doWrite(fd_, data, nbytes);
+      if (!direct_enabled_) {
+        // Written back first, since dirty pages can't be dropped
+        fdatasync(fd_);
+        posix_fadvise(fd_, file_offset_, nbytes, POSIX_FADV_DONTNEED);
+      }
+      file_offset_ += nbytes;
+      return;
+    }
+#endif
+    doWrite(fd_, data, nbytes);
+  }
+
+  const int fd_;
+  const size_t buffer_size_;
+  bool direct_io_;
+  std::vector<at::DataPtr> buffers_;
+
+  // Owned by the caller
+  size_t current_ = 0;
+  size_t filled_ = 0;
+  size_t capacity_ = 0;
+  size_t submitted_ = 0;
+
+  // Owned by the writer thread
+  int original_flags_ = 0;
+  int64_t file_offset_ = 0;
+  bool o_direct_ = false;
+  bool direct_enabled_ = false;
+  bool failed_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<size_t> free_;
+  // The buffers to write, and how many bytes of each
+  std::deque<std::pair<size_t, size_t>> pending_;
+  bool done_ = false;
+  std::exception_ptr error_;
+  std::thread thread_;
+};
+
+} // namespace
+
+void writeStorages(
+    int fd,
+    const std::vector<at::Storage>& storages,
+    const StorageWriterOptions& options) {
+  AT_CHECK(
+      options.buffer_size > 0 && options.buffer_size % kDirectIOAlignment == 0,
+      "writeStorages(): the buffer size must be a multiple of ",
+      kDirectIOAlignment);
+  AT_CHECK(options.num_buffers > 0, "writeStorages(): expected a buffer");
+  size_t total_bytes = 0;
+  bool any_cuda = false;
+  for (const auto& storage : storages) {
+    total_bytes += sizeof(int64_t) + storage.numel() * storage.itemsize();
+    any_cuda |= storage.device_type() == at::kCUDA;
+  }
+  // Small checkpoints don't need the full buffers
+  const size_t buffer_size = std::min(
+      options.buffer_size,
+      (total_bytes + 2 * kDirectIOAlignment - 1) / kDirectIOAlignment *
+          kDirectIOAlignment);
+  const size_t num_buffers = std::min(
+      options.num_buffers,
+      std::max<size_t>(2, (total_bytes + buffer_size - 1) / buffer_size));
+
+  StorageWriter writer(fd, buffer_size, num_buffers, any_cuda, options.direct_io);
+  for (const auto& storage : storages) {
+    int64_t size = storage.numel();
+    const size_t itemsize = storage.itemsize();
+    const size_t nbytes = size * itemsize;
+    writer.appendHost(&size, sizeof(int64_t));
+    if (nbytes == 0) {
+      continue;
+    }
+    const bool swap_bytes = itemsize > 1 &&
+        THP_nativeByteOrder() != THPByteOrder::THP_LITTLE_ENDIAN;
+
+    const void* data = storage.data();
+    std::unique_ptr<char[]> cpu_data;
+    if (storage.device_type() == at::kCUDA) {
+#ifdef USE_CUDA
+      c10::cuda::CUDAGuard guard(storage.device());
+      const auto stream = at::cuda::getCurrentCUDAStream();
+      if (!swap_bytes) {
+        // Copied on the current stream, after the kernels that wrote the data
+        const char* src = static_cast<const char*>(data);
+        writer.append(nbytes, [src, stream](char* dst, size_t offset, size_t n) {
+          AT_CUDA_CHECK(cudaMemcpyAsync(
+              dst, src + offset, n, cudaMemcpyDeviceToHost, stream));
+          AT_CUDA_CHECK(cudaStreamSynchronize(stream));
+        });
+        continue;
+      }
+      cpu_data.reset(new char[nbytes]);
+      AT_CUDA_CHECK(cudaMemcpyAsync(
+          cpu_data.get(), data, nbytes, cudaMemcpyDeviceToHost, stream));
+      AT_CUDA_CHECK(cudaStreamSynchronize(stream));
+      data = cpu_data.get();
+#else
+      AT_ERROR("writeStorages(): PyTorch was built without CUDA");
+#endif
+    }
+
+    if (!swap_bytes) {
+      writer.appendHost(data, nbytes);
+      continue;
+    }
+    // The data is saved in little endian, like in writeFileRaw
+    const int64_t buffer_size = std::min(size, (int64_t)5000);
+    std::unique_ptr<uint8_t[]> le_buffer(new uint8_t[buffer_size * itemsize]);
+    for (int64_t i = 0; i < size; i += buffer_size) {
+      const size_t to_convert = std::min(size - i, buffer_size);
+      const char* src = static_cast<const char*>(data) + i * itemsize;
+      if (itemsize == 2) {
+        THP_encodeInt16Buffer(le_buffer.get(), (const int16_t*)src,
+            THPByteOrder::THP_LITTLE_ENDIAN, to_convert);
+      } else if (itemsize == 4) {
+        THP_encodeInt32Buffer(le_buffer.get(), (const int32_t*)src,
+            THPByteOrder::THP_LITTLE_ENDIAN, to_convert);
+      } else if (itemsize == 8) {
+        THP_encodeInt64Buffer(le_buffer.get(), (const int64_t*)src,
+            THPByteOrder::THP_LITTLE_ENDIAN, to_convert);
+      }
+      writer.appendHost(le_buffer.get(), to_convert * itemsize);
+    }
+  }
+  writer.finish();
+}
+
 #include <torch/csrc/generic/serialization.cpp>
 #include <TH/THGenerateAllTypes.h>
 
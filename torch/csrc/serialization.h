@@ -1,6 +1,10 @@
 #ifndef THP_SERIALIZATION_INC
 #define THP_SERIALIZATION_INC
 
+#include <c10/core/Storage.h>
+
+#include <vector>
+
 #include <torch/csrc/generic/serialization.h>
 #include <TH/THGenerateAllTypes.h>
 
@@ -16,4 +20,26 @@ void doRead(io fildes, void* buf, size_t nbytes);
 template <class io>
 void doWrite(io fildes, void* buf, size_t nbytes);
 
+struct StorageWriterOptions {
+  // The size of the staging buffers, and of most of the writes; a multiple of
+  // 4096
+  size_t buffer_size = 64 << 20;
+  size_t num_buffers = 3;
+  // Keeps the written file out of the page cache, so that a large checkpoint
+  // doesn't evict the pages of the other processes of a shared host: the
+  // aligned blocks are written with O_DIRECT where the file system supports
+  // it, and the other pages are dropped once written (Linux and macOS only)
+  bool direct_io = false;
+};
+
+// Writes the storages to fd one after the other, each like
+// THPStorage_(writeFileRaw), through pinned staging buffers: a background
+// thread writes the filled ones to the file while the next ones are copied
+// from the device (or the host), so that the copies and the writes overlap.
+// Doesn't call into Python, and can run without the GIL.
+void writeStorages(
+    int fd,
+    const std::vector<at::Storage>& storages,
+    const StorageWriterOptions& options = {});
+
 #endif
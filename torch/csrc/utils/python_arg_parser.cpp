@@ -2,6 +2,7 @@
 
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/Layout.h>
+#include <torch/csrc/MemoryFormat.h>
 #include <torch/csrc/utils/invalid_arguments.h>
 #include <torch/csrc/utils/python_strings.h>
 
@@ -28,6 +29,7 @@ static std::unordered_map<std::string, ParameterType> type_map = {
   {"PyObject*", ParameterType::PYOBJECT},
   {"ScalarType", ParameterType::SCALARTYPE},
   {"Layout", ParameterType::LAYOUT},
+  {"MemoryFormat", ParameterType::MEMORY_FORMAT},
   {"Device", ParameterType::DEVICE},
   {"std::string", ParameterType::STRING},
 };
@@ -145,6 +147,7 @@ bool FunctionParameter::check(PyObject* obj) {
     case ParameterType::PYOBJECT: return true;
     case ParameterType::SCALARTYPE: return THPDtype_Check(obj);
     case ParameterType::LAYOUT: return THPLayout_Check(obj);
+    case ParameterType::MEMORY_FORMAT: return THPMemoryFormat_Check(obj);
     case ParameterType::DEVICE:
       return THPUtils_checkLong(obj) || THPUtils_checkString(obj) || THPDevice_Check(obj);
     case ParameterType::STRING: return THPUtils_checkString(obj);
@@ -166,6 +169,7 @@ std::string FunctionParameter::type_name() const {
     case ParameterType::PYOBJECT: return "object";
     case ParameterType::SCALARTYPE: return "torch.dtype";
     case ParameterType::LAYOUT: return "torch.layout";
+    case ParameterType::MEMORY_FORMAT: return "torch.memory_format";
     case ParameterType::DEVICE: return "torch.device";
     case ParameterType::STRING: return "str";
     default: throw std::runtime_error("unknown parameter type");
@@ -256,6 +260,12 @@ void FunctionParameter::set_default_str(const std::string& str) {
     } else {
       throw std::runtime_error("invalid default value for layout: " + str);
     }
+  } else if (type_ == ParameterType::MEMORY_FORMAT) {
+    if (str == "None" || str == "c10::nullopt" || str == "torch.contiguous_format") {
+      default_memory_format = at::MemoryFormat::Contiguous;
+    } else {
+      throw std::runtime_error("invalid default value for memory format: " + str);
+    }
   } else if (type_ == ParameterType::DEVICE) {
     if (str != "None") {
       throw std::runtime_error("invalid device: " + str);
@@ -535,6 +545,87 @@ PythonArgParser::PythonArgParser(std::vector<std::string> fmts, bool traceable)
   }
 }
 
+// Finds the type of obj and the properties of it that decide which parameters
+// it can bind to.  Returns false if these aren't decided by its type and the
+// properties, e.g. for objects of user types, whose __index__ may depend on
+// their value.  See Note [Overload cache]
+static bool overload_cache_arg_type(PyObject* obj, PyTypeObject*& type, uint8_t& flags) {
+  type = Py_TYPE(obj);
+  flags = 0;
+  if (THPVariable_Check(obj)) {
+    // what FunctionParameter::check and THPUtils_checkIndex look at
+    auto& var = reinterpret_cast<THPVariable*>(obj)->cdata;
+    if (var.dim() == 0 && !var.requires_grad()) {
+      flags |= 1;
+    }
+    if (at::isIntegralType(var.scalar_type())) {
+      flags |= 2;
+    }
+    if (var.numel() == 1) {
+      flags |= 4;
+    }
+    return true;
+  }
+  return obj == Py_None || PyBool_Check(obj) || PyLong_CheckExact(obj) ||
+#if PY_MAJOR_VERSION == 2
+      PyInt_CheckExact(obj) ||
+#endif
+      PyFloat_CheckExact(obj) || PyComplex_CheckExact(obj) ||
+      PyTuple_CheckExact(obj) || PyList_CheckExact(obj) ||
+      PyUnicode_CheckExact(obj) || PyBytes_CheckExact(obj) ||
+      THPDtype_Check(obj) || THPLayout_Check(obj) || THPMemoryFormat_Check(obj) ||
+      THPDevice_Check(obj) || THPGenerator_Check(obj);
+}
+
+bool PythonArgParser::make_overload_cache_key(PyObject* args, PyObject* kwargs, OverloadCacheKey& key) {
+  if (kwargs && PyDict_Size(kwargs) > 0) {
+    return false;
+  }
+  auto nargs = PyTuple_GET_SIZE(args);
+  if (nargs > max_cached_args) {
+    return false;
+  }
+  for (ssize_t i = 0; i < nargs; i++) {
+    if (!overload_cache_arg_type(PyTuple_GET_ITEM(args, i), key.arg_types[i], key.arg_flags[i])) {
+      return false;
+    }
+  }
+  key.nargs = nargs;
+  return true;
+}
+
+bool PythonArgParser::OverloadCacheKey::operator==(const OverloadCacheKey& other) const {
+  if (nargs != other.nargs) {
+    return false;
+  }
+  for (ssize_t i = 0; i < nargs; i++) {
+    if (arg_types[i] != other.arg_types[i] || arg_flags[i] != other.arg_flags[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t PythonArgParser::OverloadCacheKey::hash() const {
+  size_t h = nargs;
+  for (ssize_t i = 0; i < nargs; i++) {
+    h = h * 31 + (reinterpret_cast<uintptr_t>(arg_types[i]) >> 4);
+    h = h * 31 + arg_flags[i];
+  }
+  return h;
+}
+
+void PythonArgParser::OverloadCacheEntry::set(const OverloadCacheKey& new_key, int new_signature_idx) {
+  for (ssize_t i = 0; i < new_key.nargs; i++) {
+    Py_INCREF(reinterpret_cast<PyObject*>(new_key.arg_types[i]));
+  }
+  for (ssize_t i = 0; i < key.nargs; i++) {
+    Py_DECREF(reinterpret_cast<PyObject*>(key.arg_types[i]));
+  }
+  key = new_key;
+  signature_idx = new_signature_idx;
+}
+
 PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]) {
   if (signatures_.size() == 1) {
     auto& signature = signatures_[0];
@@ -542,9 +633,30 @@ PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject
     return PythonArgs(0, traceable, signature, parsed_args);
   }
 
+  // Try the signature that matched the last call with the same argument types
+  // first; the signatures before it can't match.  See Note [Overload cache]
+  OverloadCacheKey key;
+  OverloadCacheEntry* cache_entry = nullptr;
+  if (make_overload_cache_key(args, kwargs, key)) {
+    if (overload_cache_.empty()) {
+      overload_cache_.resize(overload_cache_size);
+    }
+    cache_entry = &overload_cache_[key.hash() % overload_cache_size];
+    if (cache_entry->signature_idx >= 0 && cache_entry->key == key) {
+      auto idx = cache_entry->signature_idx;
+      auto& signature = signatures_[idx];
+      if (signature.parse(args, kwargs, parsed_args, false)) {
+        return PythonArgs(idx, traceable, signature, parsed_args);
+      }
+    }
+  }
+
   int i = 0;
   for (auto& signature : signatures_) {
     if (signature.parse(args, kwargs, parsed_args, false)) {
+      if (cache_entry) {
+        cache_entry->set(key, i);
+      }
       return PythonArgs(i, traceable, signature, parsed_args);
     }
     i++;
@@ -38,6 +38,17 @@
 //    - Zero-dim tensors (e.g., torch.tensor(2)) bind to both
 //      Scalar and Tensor, UNLESS they require grad (in which case
 //      they only bind to Tensor).
+//
+//    - Note [Overload cache]
+//      A parser with several signatures remembers which signature
+//      matched for the last few combinations of positional argument
+//      types, and tries that one directly the next time, instead of
+//      failing to match all the signatures before it.  This is only
+//      done when the types decide the match: calls without keyword
+//      arguments, whose arguments are Tensors (keyed by their type and
+//      the properties 'check' looks at) or objects of builtin or torch
+//      types.  See PythonArgParser::raw_parse.  The GIL is held while
+//      parsing, so the cache needs no other synchronization.
 
 
 #include <torch/csrc/python_headers.h>
@@ -47,6 +58,7 @@
 #include <torch/csrc/DynamicTypes.h>
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/Generator.h>
+#include <torch/csrc/MemoryFormat.h>
 #include <torch/csrc/autograd/python_variable.h>
 #include <torch/csrc/jit/tracer.h>
 #include <torch/csrc/tensor/python_tensor.h>
@@ -70,7 +82,7 @@ namespace torch {
 
 enum class ParameterType {
   TENSOR, SCALAR, INT64, DOUBLE, TENSOR_LIST, INT_LIST, GENERATOR,
-  BOOL, STORAGE, PYOBJECT, SCALARTYPE, LAYOUT, DEVICE, STRING
+  BOOL, STORAGE, PYOBJECT, SCALARTYPE, LAYOUT, MEMORY_FORMAT, DEVICE, STRING
 };
 
 struct FunctionParameter;
@@ -95,10 +107,30 @@ private:
   void print_error(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
   PythonArgs raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
 
+  // See Note [Overload cache]
+  enum { max_cached_args = 6, overload_cache_size = 8 };
+  struct OverloadCacheKey {
+    bool operator==(const OverloadCacheKey& other) const;
+    size_t hash() const;
+
+    ssize_t nargs = -1;
+    std::array<PyTypeObject*, max_cached_args> arg_types;
+    std::array<uint8_t, max_cached_args> arg_flags;
+  };
+  struct OverloadCacheEntry {
+    // holds a reference to the types of the key, so they can't be reused
+    void set(const OverloadCacheKey& new_key, int new_signature_idx);
+
+    OverloadCacheKey key;
+    int signature_idx = -1;
+  };
+  static bool make_overload_cache_key(PyObject* args, PyObject* kwargs, OverloadCacheKey& key);
+
   std::vector<FunctionSignature> signatures_;
   std::string function_name;
   ssize_t max_args;
   bool traceable;
+  std::vector<OverloadCacheEntry> overload_cache_;
 };
 
 struct PythonArgs {
@@ -131,6 +163,8 @@ struct PythonArgs {
   inline c10::optional<bool> toBoolOptional(int i);
   inline const THPLayout& layout(int i);
   inline const THPLayout& layoutWithDefault(int i, const THPLayout& default_layout);
+  inline at::MemoryFormat memoryformat(int i);
+  inline c10::optional<at::MemoryFormat> memoryformatOptional(int i);
   inline at::Device device(int i);
   inline at::Device deviceWithDefault(int i, const at::Device& default_device);
   inline c10::optional<at::Device> deviceOptional(int i);
@@ -185,6 +219,7 @@ struct FunctionParameter {
     double default_double;
     at::ScalarType default_scalartype;
     THPLayout* default_layout;
+    at::MemoryFormat default_memory_format;
   };
 };
 
@@ -353,6 +388,17 @@ inline const THPLayout& PythonArgs::layoutWithDefault(int i, const THPLayout& de
   return layout(i);
 }
 
+inline at::MemoryFormat PythonArgs::memoryformat(int i) {
+  if (!args[i]) return signature.params[i].default_memory_format;
+  return reinterpret_cast<THPMemoryFormat*>(args[i])->memory_format;
+}
+
+inline c10::optional<at::MemoryFormat> PythonArgs::memoryformatOptional(int i) {
+  if (!args[i])
+    return c10::nullopt;
+  return memoryformat(i);
+}
+
 static std::string cuda_str = "cuda";
 static std::string cpu_str = "cpu";
 static std::string cuda_prefix = "cuda:";
@@ -0,0 +1,27 @@
+#include <torch/csrc/utils/tensor_memoryformats.h>
+#include <ATen/MemoryFormat.h>
+#include <torch/csrc/Exceptions.h>
+#include <torch/csrc/MemoryFormat.h>
+#include <torch/csrc/python_headers.h>
+#include <torch/csrc/utils/object_ptr.h>
+
+namespace torch { namespace utils {
+
+void initializeMemoryFormats() {
+  auto torch_module = THPObjectPtr(PyImport_ImportModule("torch"));
+  if (!torch_module) throw python_error();
+
+  PyObject *contiguous_format = THPMemoryFormat_New(at::MemoryFormat::Contiguous, "torch.contiguous_format");
+  Py_INCREF(contiguous_format);
+  if (PyModule_AddObject(torch_module, "contiguous_format", contiguous_format) != 0) {
+    throw python_error();
+  }
+
+  PyObject *channels_last = THPMemoryFormat_New(at::MemoryFormat::ChannelsLast, "torch.channels_last");
+  Py_INCREF(channels_last);
+  if (PyModule_AddObject(torch_module, "channels_last", channels_last) != 0) {
+    throw python_error();
+  }
+}
+
+}} // namespace torch::utils
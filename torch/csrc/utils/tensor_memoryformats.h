@@ -0,0 +1,7 @@
+#pragma once
+
+namespace torch { namespace utils {
+
+void initializeMemoryFormats();
+
+}} // namespace torch::utils
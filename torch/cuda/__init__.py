@@ -563,6 +563,97 @@ def reset_max_memory_cached(device=None):
     return torch._C._cuda_resetMaxMemoryCached(device)
 
 
+def memory_snapshot():
+    r"""Returns a snapshot of the CUDA memory allocator state across all
+    devices.
+
+    The result is a list of segments, one for every chunk of memory the
+    allocator obtained from CUDA, sorted by address. Each segment is a dict
+    with the keys ``device``, ``address``, ``total_size``,
+    ``allocated_size``, ``stream``, ``segment_type`` (``'large'`` or
+    ``'small'``), ``is_expandable`` and ``blocks``. ``blocks`` lists the
+    blocks the segment is split into, in address order, as dicts with a
+    ``size`` and a ``state`` that is one of ``'active_allocated'``,
+    ``'active_pending_free'`` (freed, but still in use by another stream) or
+    ``'inactive'`` (cached).
+
+    Lots of ``inactive`` blocks that are each too small for a failing
+    allocation point to fragmentation rather than to memory held by live
+    tensors.
+
+    .. note::
+        See :ref:`cuda-memory-management` for more details about GPU memory
+        management.
+    """
+    return torch._C._cuda_memorySnapshot()
+
+
+def empty_host_cache():
+    r"""Releases the pinned host memory cached by the caching host allocator
+    (used by :meth:`~torch.Tensor.pin_memory` and ``pin_memory=True``).
+
+    Only memory that is no longer used by tensors or pending copies is
+    released, including what was reserved with
+    :func:`~torch.cuda.reserve_host_memory`.
+    """
+    if _initialized:
+        torch._C._cuda_hostEmptyCache()
+
+
+def reserve_host_memory(size):
+    r"""Pins :attr:`size` bytes of host memory upfront, and adds them to the
+    cache of the caching host allocator.
+
+    Pinning memory is slow, since the driver has to lock its pages, and the
+    allocator otherwise does it the first time it sees an allocation it can't
+    serve from its cache, e.g. during the first epoch of a data pipeline.
+    Later pinned allocations are carved from the reserved region, and given
+    back to it when freed.
+
+    Arguments:
+        size (int): number of bytes to reserve
+    """
+    _lazy_init()
+    torch._C._cuda_hostReserve(size)
+
+
+def host_memory_stats():
+    r"""Returns a dict of statistics of the caching host allocator:
+
+    - ``allocated_bytes``, ``max_allocated_bytes``: pinned memory currently
+      used by tensors, and its peak.
+    - ``cached_bytes``, ``max_cached_bytes``: pinned memory held by the
+      allocator, used or not, and its peak.
+    - ``num_host_allocs``, ``num_host_frees``: how many times the allocator
+      pinned new memory and released memory. Each of these calls is slow.
+    """
+    return torch._C._cuda_hostMemoryStats()
+
+
+def _record_memory_history(enabled, max_entries=1000000):
+    r"""Turns recording of CUDA allocator events on or off.
+
+    While enabled, the allocator keeps the last :attr:`max_entries` allocs,
+    frees and segment allocs/frees in a ring buffer, which can be read with
+    :func:`~torch.cuda._memory_history`. Turning recording on clears
+    previously recorded events.
+
+    Arguments:
+        enabled (bool): whether to record events
+        max_entries (int, optional): size of the ring buffer
+    """
+    torch._C._cuda_recordMemoryHistory(enabled, max_entries)
+
+
+def _memory_history():
+    r"""Returns the events recorded since :func:`~torch.cuda._record_memory_history`
+    was enabled, oldest first. Each event is a dict with the keys ``action``
+    (``'alloc'``, ``'free'``, ``'segment_alloc'`` or ``'segment_free'``),
+    ``device``, ``address``, ``size``, ``stream`` and ``stack_id``.
+    """
+    return torch._C._cuda_memoryHistory()
+
+
 def _host_allocator():
     _lazy_init()
     return torch._C._cuda_cudaHostAllocator()
@@ -606,6 +697,7 @@ if not hasattr(torch._C, 'CudaDoubleStorageBase'):
 
     torch._C.__dict__['_CudaStreamBase'] = _dummy_type('CudaStreamBase')
     torch._C.__dict__['_CudaEventBase'] = _dummy_type('CudaEventBase')
+    torch._C.__dict__['_CUDAGraph'] = _dummy_type('CUDAGraph')
 
 
 @staticmethod
@@ -676,3 +768,4 @@ from . import sparse  # noqa: F401
 from . import profiler  # noqa: F401
 from . import nvtx  # noqa: F401
 from .streams import Stream, Event  # noqa: F401
+from .graphs import CUDAGraph, graph  # noqa: F401
@@ -1,7 +1,5 @@
 import torch
 from . import nccl
-from torch._utils import _take_tensors, _flatten_dense_tensors, \
-    _unflatten_dense_tensors, _reorder_tensors_as
 
 
 def broadcast(tensor, devices):
@@ -20,7 +18,7 @@ def broadcast(tensor, devices):
     return torch._C._broadcast(tensor, devices)
 
 
-def broadcast_coalesced(tensors, devices, buffer_size=10485760):
+def broadcast_coalesced(tensors, devices, buffer_size=10485760, streams=None):
     """Broadcasts a sequence tensors to the specified GPUs.
     Small tensors are first coalesced into a buffer to reduce the number
     of synchronizations.
@@ -31,12 +29,16 @@ def broadcast_coalesced(tensors, devices, buffer_size=10485760):
           Note that it should be like (src, dst1, dst2, ...), the first element
           of which is the source device to broadcast from.
         buffer_size (int): maximum size of the buffer used for coalescing
+        streams (Iterable[Stream], optional): a stream for each device, on
+          which the broadcast is queued (default: the current streams). The
+          call returns without waiting for the broadcast, and streams that use
+          the outputs must wait on these first.
 
     Returns:
         A tuple containing copies of the ``tensor``, placed on devices
         corresponding to indices from ``devices``.
     """
-    return torch._C._broadcast_coalesced(tensors, devices, buffer_size)
+    return torch._C._broadcast_coalesced(tensors, devices, buffer_size, streams)
 
 
 def reduce_add(inputs, destination=None):
@@ -72,8 +74,10 @@ def reduce_add(inputs, destination=None):
         raise RuntimeError("reduce_add expects destination to be on the same GPU with one of the tensors")
     result = inp.new(device=destination).resize_as_(inp).zero_()
 
-    if nccl.is_available(inputs) and inputs[0].get_device() == destination:
-        outputs = [result] + [t.new(t.size()) for t in inputs[1:]]
+    if nccl.is_available(inputs):
+        # only the output of the root is written
+        outputs = list(inputs)
+        outputs[nccl_root] = result
         nccl.reduce(inputs, outputs, root=nccl_root)
         return result
     for inp in inputs:
@@ -82,11 +86,12 @@ def reduce_add(inputs, destination=None):
     return result
 
 
-def reduce_add_coalesced(inputs, destination=None, buffer_size=10485760):
+def reduce_add_coalesced(inputs, destination=None, buffer_size=10485760, streams=None):
     """Sums tensors from multiple GPUs.
 
     Small tensors are first coalesced into a buffer to reduce the number
-    of synchronizations.
+    of synchronizations, and the buffers are reduced with NCCL when it is
+    available.
 
     Arguments:
         inputs (Iterable[Iterable[Tensor]]): iterable of iterables that
@@ -94,6 +99,11 @@ def reduce_add_coalesced(inputs, destination=None, buffer_size=10485760):
         destination (int, optional): a device on which the output will be
             placed (default: current device).
         buffer_size (int): maximum size of the buffer used for coalescing
+        streams (Iterable[Stream], optional): a stream for each element of
+            ``inputs``, on the device of its tensors, on which the reduction
+            is queued (default: the current streams). The call returns without
+            waiting for the reduction, and streams that use the outputs must
+            wait on these first.
 
     Returns:
         A tuple of tensors containing an elementwise sum of each group of
@@ -101,30 +111,10 @@ def reduce_add_coalesced(inputs, destination=None, buffer_size=10485760):
     """
     # TODO: When `len(inputs) == 1` and all inputs are on `destination`, just
     #       return `inputs`.
-    dense_tensors = [[] for _ in inputs]  # shape (num_gpus, num_tensors)
-    output = []
-    ref_order = []
-    # process sparse ones first since they may have different sizes on different gpus
-    for tensor_at_gpus in zip(*inputs):
-        if all(t.is_sparse for t in tensor_at_gpus):
-            result = reduce_add(tensor_at_gpus, destination)
-            output.append(result)
-            ref_order.append(tensor_at_gpus[0])
-        else:
-            for coll, t in zip(dense_tensors, tensor_at_gpus):
-                coll.append(t.to_dense() if t.is_sparse else t)
-            ref_order.append(dense_tensors[0][-1])
-    itrs = [_take_tensors(tensors, buffer_size) for tensors in dense_tensors]
-    # now the dense ones, which have consistent sizes
-    for chunks in zip(*itrs):
-        flat_tensors = [_flatten_dense_tensors(chunk) for chunk in chunks]
-        flat_result = reduce_add(flat_tensors, destination)
-        for t in _unflatten_dense_tensors(flat_result, chunks[0]):
-            # The unflattened tensors do not share storage, and we don't expose
-            # base flat tensor anyways, so give them different version counters.
-            # See NOTE [ Version Counter in comm.*_coalesced ]
-            output.append(t.data)
-    return tuple(_reorder_tensors_as(output, ref_order))
+    if destination is None:
+        destination = torch.cuda.current_device()
+    inputs = [list(tensors) for tensors in inputs]
+    return tuple(torch._C._reduce_add_coalesced(inputs, destination, buffer_size, streams))
 
 
 def scatter(tensor, devices, chunk_sizes=None, dim=0, streams=None):
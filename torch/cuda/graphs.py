@@ -0,0 +1,97 @@
+import contextlib
+
+import torch
+
+
+class CUDAGraph(torch._C._CUDAGraph):
+    r"""Wrapper around a CUDA graph.
+
+    A CUDA graph records the work queued on a stream between
+    :meth:`capture_begin` and :meth:`capture_end`, and :meth:`replay` launches
+    all of it again at once, without the CPU overhead of the captured ops. The
+    replayed kernels read and write the same memory as during capture, so new
+    inputs must be copied into the tensors used during capture, and outputs
+    read from the tensors the capture produced.
+
+    Memory allocated during capture comes from a private pool of the caching
+    allocator, which is kept for the graph until :meth:`reset`.
+
+    .. warning::
+        Capture must happen on a non-default stream, after the captured work
+        was run at least once (e.g. to run lazy initialization and cuDNN
+        benchmarking outside of it). Ops that synchronize with the CPU, like
+        ``.item()``, can't be captured. Requires CUDA 10.1 or newer.
+    """
+
+    def __new__(cls):
+        return super(CUDAGraph, cls).__new__(cls)
+
+    def capture_begin(self, pool=None):
+        r"""Begins capturing CUDA work on the current stream.
+
+        Arguments:
+            pool (int, optional): the :meth:`pool` of another graph, to share
+                its memory pool. Graphs sharing a pool must be replayed in
+                the order they were captured in.
+        """
+        super(CUDAGraph, self).capture_begin(0 if pool is None else pool)
+
+    def capture_end(self):
+        r"""Ends capturing CUDA work on the current stream, and instantiates
+        the graph."""
+        super(CUDAGraph, self).capture_end()
+
+    def replay(self):
+        r"""Replays the captured work on the current stream."""
+        super(CUDAGraph, self).replay()
+
+    def reset(self):
+        r"""Destroys the graph and releases its memory pool."""
+        super(CUDAGraph, self).reset()
+
+    def pool(self):
+        r"""Returns an id of the graph's memory pool, which can be passed to
+        :meth:`capture_begin` of another graph to share it."""
+        return super(CUDAGraph, self).pool()
+
+
+@contextlib.contextmanager
+def graph(cuda_graph, pool=None, stream=None):
+    r"""Context-manager that captures the CUDA work queued in its body into
+    ``cuda_graph``.
+
+    Capture happens on ``stream``, or on a new side stream if it isn't given.
+    The side stream waits for the work queued so far on the current stream,
+    and the current stream waits for the capture when the context exits.
+
+    Arguments:
+        cuda_graph (CUDAGraph): the graph to capture into.
+        pool (int, optional): see :meth:`CUDAGraph.capture_begin`.
+        stream (Stream, optional): the stream to capture on.
+
+    Example::
+
+        >>> static_input = torch.randn(8, 16, device='cuda')
+        >>> # warmup
+        >>> s = torch.cuda.Stream()
+        >>> s.wait_stream(torch.cuda.current_stream())
+        >>> with torch.cuda.stream(s):
+        >>>     model(static_input)
+        >>> torch.cuda.current_stream().wait_stream(s)
+        >>> g = torch.cuda.CUDAGraph()
+        >>> with torch.cuda.graph(g):
+        >>>     static_output = model(static_input)
+        >>> static_input.copy_(new_input)
+        >>> g.replay()  # static_output now holds model(new_input)
+    """
+    if stream is None:
+        stream = torch.cuda.Stream()
+    current = torch.cuda.current_stream()
+    stream.wait_stream(current)
+    with torch.cuda.stream(stream):
+        cuda_graph.capture_begin(pool)
+        try:
+            yield cuda_graph
+        finally:
+            cuda_graph.capture_end()
+    current.wait_stream(stream)
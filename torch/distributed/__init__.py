@@ -15,3 +15,6 @@ if is_available():
     # See the comment in `distributed_c10d.py` above `_backend` on why we expose
     # this.
     from .distributed_c10d import _backend  # noqa: F401
+
+    if hasattr(torch._C, "_rpc_init") and torch._C._rpc_init():
+        from .rpc import *  # noqa: F401
@@ -9,6 +9,8 @@ from datetime import timedelta
 from .rendezvous import rendezvous, register_rendezvous_handler  # noqa: F401
 from . import (
     AllreduceOptions,
+    AllreduceCoalescedOptions,
+    AllToAllOptions,
     BroadcastOptions,
     GatherOptions,
     ReduceOptions,
@@ -875,6 +877,10 @@ def all_reduce(tensor,
 
     After the call ``tensor`` is going to be bitwise identical in all processes.
 
+    The gloo backend also supports sparse COO CPU tensors with
+    ``ReduceOp.SUM``, which are replaced by the coalesced sum of the
+    tensors of all processes.
+
     Arguments:
         tensor (Tensor): Input and output of the collective. The function
             operates in-place.
@@ -907,6 +913,51 @@ def all_reduce(tensor,
         work.wait()
 
 
+def all_reduce_coalesced(tensors,
+                         op=ReduceOp.SUM,
+                         group=group.WORLD,
+                         async_op=False):
+    """
+    Reduces each tensor of the list across all machines, like
+    :func:`all_reduce` called on every tensor, but with a single collective
+    per dtype: the tensors of a dtype are flattened into one buffer, which is
+    reduced and copied back. This is much faster than reducing many small
+    tensors one by one.
+
+    Arguments:
+        tensors (List[Tensor]): Inputs and outputs of the collective. The
+            function operates in-place. The tensors may have different sizes
+            and dtypes, but all processes must pass tensors with the same
+            sizes and dtypes in the same order, on the same device.
+        op (optional): One of the values from
+            ``torch.distributed.ReduceOp``
+            enum.  Specifies an operation used for element-wise reductions.
+        group (ProcessGroup, optional): The process group to work on
+        async_op (bool, optional): Whether this op should be an async op
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group
+
+    """
+    _check_tensor_list(tensors, "tensors")
+    if _rank_not_in_group(group):
+        return
+
+    opts = AllreduceCoalescedOptions()
+    opts.reduceOp = op
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.allreduce_coalesced(tensors, opts)
+    else:
+        work = group.allreduce_coalesced(tensors, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
 def reduce_multigpu(tensor_list,
                     dst,
                     op=ReduceOp.SUM,
@@ -1334,6 +1385,98 @@ def reduce_scatter(output,
         work.wait()
 
 
+def all_to_all_single(output,
+                      input,
+                      output_split_sizes=None,
+                      input_split_sizes=None,
+                      group=group.WORLD,
+                      async_op=False):
+    """
+    Splits the input tensor along its first dimension, scatters the chunks to
+    all processes in a group, and concatenates the chunks received from all
+    processes, in rank order, into the output tensor.
+
+    Arguments:
+        output (Tensor): Output tensor.
+        input (Tensor): Input tensor to scatter.
+        output_split_sizes (list[int], optional): Sizes along the first
+            dimension of the chunks received from each rank. If None or
+            empty, the first dimension of ``output`` is split evenly.
+        input_split_sizes (list[int], optional): Sizes along the first
+            dimension of the chunks sent to each rank. If None or empty, the
+            first dimension of ``input`` is split evenly.
+        group (ProcessGroup, optional): The process group to work on.
+        async_op (bool, optional): Whether this op should be an async op.
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group.
+
+    """
+    _check_single_tensor(output, "output")
+    _check_single_tensor(input, "input")
+    if _rank_not_in_group(group):
+        return
+
+    opts = AllToAllOptions()
+    output_split_sizes = [] if output_split_sizes is None else output_split_sizes
+    input_split_sizes = [] if input_split_sizes is None else input_split_sizes
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes, opts)
+    else:
+        work = group.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
+def all_to_all(output_tensor_list,
+               input_tensor_list,
+               group=group.WORLD,
+               async_op=False):
+    """
+    Scatters a list of tensors to all processes in a group and gathers the
+    tensors they send into a list: ``input_tensor_list[i]`` is sent to rank
+    ``i``, and ``output_tensor_list[i]`` is received from rank ``i``. The
+    tensors may have different sizes.
+
+    Arguments:
+        output_tensor_list (list[Tensor]): List of tensors to receive, one
+            per rank.
+        input_tensor_list (list[Tensor]): List of tensors to send, one per
+            rank.
+        group (ProcessGroup, optional): The process group to work on.
+        async_op (bool, optional): Whether this op should be an async op.
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group.
+
+    """
+    _check_tensor_list(output_tensor_list, "output_tensor_list")
+    _check_tensor_list(input_tensor_list, "input_tensor_list")
+    if _rank_not_in_group(group):
+        return
+
+    opts = AllToAllOptions()
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.alltoall(output_tensor_list, input_tensor_list, opts)
+    else:
+        work = group.alltoall(output_tensor_list, input_tensor_list, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
 def barrier(group=group.WORLD,
             async_op=False):
     """
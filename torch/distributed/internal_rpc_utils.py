@@ -0,0 +1,34 @@
+import pickle
+
+
+def run_python_udf_internal(pickled_python_udf):
+    r"""
+    Internal function that runs a pickled ``(func, args, kwargs)`` triple sent
+    by :func:`torch.distributed.rpc` and returns the pickled result. It is
+    called from the RPC agent on the callee.
+    """
+    python_udf = pickle.loads(pickled_python_udf)
+    result = python_udf.func(*python_udf.args, **python_udf.kwargs)
+    return pickle.dumps(result)
+
+
+def load_python_udf_result_internal(pickled_python_result):
+    r"""
+    Internal function that unpickles the result of a Python UDF on the caller.
+    """
+    return pickle.loads(pickled_python_result)
+
+
+class PythonUDF(object):
+    __slots__ = ['func', 'args', 'kwargs']
+
+    def __init__(self, func, args, kwargs):
+        self.func = func
+        self.args = args
+        self.kwargs = kwargs
+
+    def __getstate__(self):
+        return (self.func, self.args, self.kwargs)
+
+    def __setstate__(self, state):
+        self.func, self.args, self.kwargs = state
@@ -0,0 +1,130 @@
+import pickle
+
+import torch
+from . import invoke_rpc_builtin, invoke_rpc_python_udf
+from . import ProcessGroupAgent
+from .distributed_c10d import _get_default_group
+from .internal_rpc_utils import PythonUDF
+
+__all__ = ['init_rpc', 'join_rpc', 'sync_rpc', 'rpc']
+
+_agent = None
+
+
+def _require_initialized(func):
+    def wrapper(*args, **kwargs):
+        if _agent is None:
+            raise RuntimeError("RPC has not been initialized. "
+                               "Call torch.distributed.init_rpc first.")
+        return func(*args, **kwargs)
+    return wrapper
+
+
+def init_rpc(name, backend='pg', num_send_recv_threads=4):
+    r"""
+    Initializes the local RPC agent, which immediately makes the current
+    process ready to send and receive RPC calls. The agent uses the default
+    process group, so :func:`torch.distributed.init_process_group` must be
+    called first.
+
+    Arguments:
+        name (str): a globally unique name of the local RPC agent. (e.g.,
+                    ``Trainer3``, ``ParameterServer2``, ``Master``, ``Worker1``)
+        backend (str): type of RPC backend implementation. Currently, only
+                       process group backend ``"pg"`` is supported.
+        num_send_recv_threads (int): number of threads of the agent that run
+                                     the received requests (default: 4).
+    """
+    global _agent
+
+    if _agent:
+        raise RuntimeError("RPC is already initialized")
+
+    if backend == 'pg':
+        _agent = ProcessGroupAgent(
+            name, _get_default_group(), num_send_recv_threads)
+    else:
+        raise RuntimeError("Unrecognized RPC backend {}".format(backend))
+
+
+@_require_initialized
+def join_rpc():
+    r"""
+    Blocks until all local and remote RPC processes reach this method, processes
+    all pending messages, and then shuts down the local RPC agent. This should
+    be called before the process exits.
+    """
+    global _agent
+
+    if _agent:
+        _agent.join()
+        _agent = None
+
+
+@_require_initialized
+def sync_rpc():
+    r"""
+    Blocks until all the RPC messages sent by the workers before this call are
+    processed. It must be called by all the workers.
+    """
+    _agent.sync()
+
+
+@_require_initialized
+def rpc(to, func, args=None, kwargs=None, async_call=False):
+    r"""
+    Makes an RPC call to run function ``func`` on worker ``to``. By default,
+    this blocks until the return value is locally available. RPC messages are
+    sent and received in parallel to execution of Python code. This method is
+    thread-safe.
+
+    Arguments:
+        to (str): name of the destination worker.
+        func (callable): a builtin operator (e.g., :meth:`torch.add`) or a
+                         picklable Python function.
+        args (tuple): the argument tuple for the ``func`` invocation.
+        kwargs (dict): a dictionary of keyword arguments for the ``func``
+                       invocation.
+        async_call (bool): if set to ``True``, this will be an asynchronous
+                           RPC, and returns a future whose ``wait()`` returns
+                           the return value (default: ``False``).
+
+    .. note::
+        The tensor arguments of builtin operators and their return values
+        are sent along with the message without being copied into it. The
+        arguments and return values of Python functions are pickled.
+
+    Returns:
+        The return value of ``func`` on worker ``to``, or a future of it if
+        ``async_call`` is ``True``. An exception raised on the destination
+        worker is raised by the caller when the result is retrieved.
+
+    Example::
+
+        On worker 0:
+        >>> import torch.distributed as dist
+        >>> dist.init_process_group(backend='gloo', rank=0, world_size=2)
+        >>> dist.init_rpc("worker0")
+        >>> ret = dist.rpc("worker1", torch.add, args=(torch.ones(2), 3))
+        >>> dist.join_rpc()
+
+        On worker 1:
+        >>> import torch.distributed as dist
+        >>> dist.init_process_group(backend='gloo', rank=1, world_size=2)
+        >>> dist.init_rpc("worker1")
+        >>> dist.join_rpc()
+    """
+    args = args if args else ()
+    kwargs = kwargs if kwargs else {}
+
+    qualified_name = torch.jit._find_builtin(func)
+    if qualified_name is not None:
+        fut = invoke_rpc_builtin(_agent, to, qualified_name, *args, **kwargs)
+    else:
+        fut = invoke_rpc_python_udf(
+            _agent, to, pickle.dumps(PythonUDF(func, args, kwargs)))
+
+    if async_call:
+        return fut
+    else:
+        return fut.wait()
@@ -630,6 +630,38 @@ def make_tuple(example_inputs):
         return tuple(example_inputs)
     return example_inputs
 
+# Traces made with cache=True, by traced function and then by the signature of
+# the example inputs, see _trace_cache_key.
+_trace_cache = weakref.WeakKeyDictionary()
+
+
+def _input_signature(value):
+    if isinstance(value, torch.Tensor):
+        return (value.dtype, value.device, tuple(value.size()), value.requires_grad)
+    if isinstance(value, (tuple, list)):
+        signatures = tuple(_input_signature(v) for v in value)
+        if any(sig is None for sig in signatures):
+            return None
+        return (type(value), signatures)
+    if isinstance(value, dict):
+        keys = sorted(value.keys())
+        signatures = tuple(_input_signature(value[k]) for k in keys)
+        if any(sig is None for sig in signatures):
+            return None
+        return (dict, tuple(keys), signatures)
+    return None
+
+
+# A trace is specialized to the dtypes, devices and shapes of the inputs it was
+# made with (shapes show up as constants in views, for instance), so those make
+# up the key, along with the options that change the trace.
+def _trace_cache_key(example_inputs, optimize, force_outplace):
+    signature = _input_signature(example_inputs)
+    if signature is None:
+        return None
+    return (signature, bool(optimize), force_outplace)
+
+
 def make_module(mod, _module_class, executor_options):
     if _module_class is None:
         _module_class = TopLevelTracedModule
@@ -642,7 +674,9 @@ def trace(func,
           check_inputs=None,
           check_tolerance=1e-5,
           _force_outplace=False,
-          _module_class=None):
+          _module_class=None,
+          record_source_locations=True,
+          cache=False):
     """
     Trace a function and return an executable ``ScriptModule`` that will be optimized
     using just-in-time compilation.
@@ -687,6 +721,15 @@ def trace(func,
         check_tolerance (float, optional): Floating-point comparison tolerance to use in the checker procedure.
                                            This can be used to relax the checker strictness in the event that
                                            results diverge numerically for a known reason, such as operator fusion.
+        record_source_locations (bool, optional): whether to record the Python stack of every traced
+                                                  operation, to be shown in error messages and by the checker.
+                                                  Capturing it takes most of the time tracing large models.
+                                                  Default: ``True``.
+        cache (bool, optional): reuse the result of an earlier call with the same ``func`` and inputs of
+                                the same types, devices, shapes and ``requires_grad``, instead of tracing
+                                again. Only use this if ``func`` does not depend on anything that may change
+                                between the calls, other than the values of a module's parameters.
+                                Default: ``False``.
 
     Returns:
         A ``ScriptModule`` object with a single ``forward()`` method containing the traced code.
@@ -721,6 +764,20 @@ def trace(func,
     # done primarily so that weird iterables fail here and not pybind11 code
     elif not isinstance(example_inputs, tuple):
         example_inputs = tuple(example_inputs)
+
+    cache_key = None
+    if cache and _module_class is None:
+        cache_key = _trace_cache_key(example_inputs, optimize, _force_outplace)
+    if cache_key is not None:
+        try:
+            cached = _trace_cache.get(func, {}).get(cache_key)
+        except TypeError:
+            # func can't be weakly referenced
+            cache_key = None
+        else:
+            if cached is not None:
+                return cached
+
     var_lookup_fn = _create_interpreter_name_lookup_fn(0)
 
     if isinstance(func, torch.nn.Module):
@@ -728,14 +785,16 @@ def trace(func,
             _module_class = TopLevelTracedModule
         traced = _module_class(func, **executor_options)
         traced._c._create_method_from_trace('forward', func, example_inputs,
-                                            var_lookup_fn, _force_outplace)
+                                            var_lookup_fn, _force_outplace,
+                                            record_source_locations)
     else:
         name = getattr(func, '__name__', 'forward')
         if name == '<lambda>':
             name = '_lambda'  # make name a valid identifier
         traced = torch._C._create_function_from_trace(name, func, example_inputs,
                                                       var_lookup_fn,
-                                                      _force_outplace)
+                                                      _force_outplace,
+                                                      record_source_locations)
 
     # Check the trace against new traces created from user-specified inputs
     if check_trace:
@@ -744,6 +803,8 @@ def trace(func,
         else:
             _check_trace([example_inputs], func, executor_options, traced, check_tolerance, _force_outplace, False)
 
+    if cache_key is not None:
+        _trace_cache.setdefault(func, {})[cache_key] = traced
     return traced
 
 def trace_module(mod,
@@ -753,7 +814,8 @@ def trace_module(mod,
                  check_inputs=None,
                  check_tolerance=1e-5,
                  _force_outplace=False,
-                 _module_class=None):
+                 _module_class=None,
+                 record_source_locations=True):
     """
     Trace a function and return an executable ``ScriptModule`` that will be optimized
     using just-in-time compilation.
@@ -794,6 +856,10 @@ def trace_module(mod,
         check_tolerance (float, optional): Floating-point comparison tolerance to use in the checker procedure.
                                            This can be used to relax the checker strictness in the event that
                                            results diverge numerically for a known reason, such as operator fusion.
+        record_source_locations (bool, optional): whether to record the Python stack of every traced
+                                                  operation, to be shown in error messages and by the checker.
+                                                  Capturing it takes most of the time tracing large models.
+                                                  Default: ``True``.
 
     Returns:
         A ``ScriptModule`` object with a single ``forward()`` method containing the traced code.
@@ -824,7 +890,8 @@ def trace_module(mod,
 
         func = getattr(mod, method_name)
         example_inputs = make_tuple(example_inputs)
-        module._c._create_method_from_trace(method_name, func, example_inputs, var_lookup_fn, _force_outplace)
+        module._c._create_method_from_trace(method_name, func, example_inputs, var_lookup_fn, _force_outplace,
+                                            record_source_locations)
         check_trace_method = module._c._get_method(method_name)
 
         # Check the trace against new traces created from user-specified inputs
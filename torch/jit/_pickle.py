@@ -1,7 +1,18 @@
+import struct
+
+
 def build_intlist(data):
     return data
 
 
+def build_intlist_from_bytes(data):
+    return list(struct.unpack('<{}q'.format(len(data) // 8), data))
+
+
+def build_floatlist_from_bytes(data):
+    return list(struct.unpack('<{}d'.format(len(data) // 8), data))
+
+
 def build_tensor_from_id(data):
     if isinstance(data, int):
         # just the id, can't really do anything
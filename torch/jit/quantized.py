@@ -1,8 +1,10 @@
 import torch
-from typing import Tuple, Optional  # noqa: F401
+from typing import Tuple, Optional, List  # noqa: F401
 from torch import Tensor
 
 from torch.nn import _VF
+from torch.nn.modules.rnn import apply_permutation
+from torch.nn.utils.rnn import PackedSequence, get_packed_sequence
 
 
 class QuantizedLinear(torch.jit.ScriptModule):
@@ -205,6 +207,265 @@ class QuantizedGRUCell(QuantizedRNNCellBase):
         )
 
 
+# Quantized RNN layer implementations
+class QuantizedRNNBase(torch.jit.ScriptModule):
+    __constants__ = ['mode', 'input_size', 'hidden_size', 'num_layers', 'bias',
+                     'batch_first', 'dropout', 'bidirectional']
+
+    def __init__(self, other):
+        super(QuantizedRNNBase, self).__init__()
+        self.mode = other.mode
+        self.input_size = other.input_size
+        self.hidden_size = other.hidden_size
+        self.num_layers = other.num_layers
+        self.bias = other.bias
+        self.batch_first = other.batch_first
+        self.dropout = float(other.dropout)
+        self.bidirectional = other.bidirectional
+        if not self.bias:
+            raise ValueError("Quantized RNN modules require bias terms")
+
+        # The weights are quantized and packed once here; the activations are
+        # quantized with parameters computed at every step. For each layer and
+        # direction, _all_weights holds the 12 tensors the quantized RNN ops
+        # expect: the i2h and h2h weights, biases, packed weights, column
+        # offsets, scales and zero points.
+        all_weights = []
+        num_directions = 2 if self.bidirectional else 1
+        for layer in range(self.num_layers):
+            for direction in range(num_directions):
+                suffix = '_reverse' if direction == 1 else ''
+                quantized = [torch.fbgemm_linear_quantize_weight(
+                    getattr(other, 'weight_{}_l{}{}'.format(ihhh, layer, suffix)).clone().float())
+                    for ihhh in ['ih', 'hh']]
+                weights = [q[0] for q in quantized]
+                all_weights += weights
+                all_weights += [getattr(other, 'bias_{}_l{}{}'.format(ihhh, layer, suffix)).clone().float().detach()
+                                for ihhh in ['ih', 'hh']]
+                all_weights += [torch.fbgemm_pack_quantized_matrix(w, w.size(1), w.size(0)) for w in weights]
+                all_weights += [q[1] for q in quantized]
+                all_weights += [torch.tensor(q[2], dtype=torch.double) for q in quantized]
+                all_weights += [torch.tensor(q[3], dtype=torch.long) for q in quantized]
+        self._all_weights = torch.jit.Attribute(all_weights, List[Tensor])
+
+    def extra_repr(self):
+        s = '{input_size}, {hidden_size}'
+        if self.num_layers != 1:
+            s += ', num_layers={num_layers}'
+        if self.batch_first is not False:
+            s += ', batch_first={batch_first}'
+        if self.dropout != 0:
+            s += ', dropout={dropout}'
+        if self.bidirectional is not False:
+            s += ', bidirectional={bidirectional}'
+        return s.format(**self.__dict__)
+
+    @torch.jit.script_method
+    def check_input(self, input, batch_sizes):
+        # type: (Tensor, Optional[Tensor]) -> None
+        expected_input_dim = 2 if batch_sizes is not None else 3
+        if input.dim() != expected_input_dim:
+            raise RuntimeError(
+                'input must have {} dimensions, got {}'.format(
+                    expected_input_dim, input.dim()))
+        if self.input_size != input.size(-1):
+            raise RuntimeError(
+                'input.size(-1) must be equal to input_size. Expected {}, got {}'.format(
+                    self.input_size, input.size(-1)))
+
+    @torch.jit.script_method
+    def get_expected_hidden_size(self, input, batch_sizes):
+        # type: (Tensor, Optional[Tensor]) -> Tuple[int, int, int]
+        if batch_sizes is not None:
+            mini_batch = batch_sizes[0]
+            mini_batch = int(mini_batch)
+        else:
+            mini_batch = input.size(0) if self.batch_first else input.size(1)
+        num_directions = 2 if self.bidirectional else 1
+        expected_hidden_size = (self.num_layers * num_directions,
+                                mini_batch, self.hidden_size)
+        return expected_hidden_size
+
+    @torch.jit.script_method
+    def check_hidden_size(self, hx, expected_hidden_size, msg='Expected hidden size {}, got {}'):
+        # type: (Tensor, Tuple[int, int, int], str) -> None
+        if hx.size() != expected_hidden_size:
+            raise RuntimeError(msg.format(expected_hidden_size, tuple(hx.size())))
+
+    @torch.jit.script_method
+    def _unpack(self):
+        for i in range(len(self._all_weights) // 12):
+            for j in range(2):
+                weight = self._all_weights[12 * i + j]
+                self._all_weights[12 * i + 4 + j].set_(
+                    torch.fbgemm_pack_quantized_matrix(weight, weight.size(1), weight.size(0)))
+
+    @torch.jit.script_method
+    def _pack(self):
+        for i in range(len(self._all_weights) // 12):
+            for j in range(2):
+                self._all_weights[12 * i + 4 + j].set_(
+                    torch.zeros(torch.jit.annotate(List[int], []), dtype=torch.uint8).detach())
+
+
+class QuantizedLSTM(QuantizedRNNBase):
+    __overloads__ = {'forward': ['forward_packed', 'forward_tensor']}
+
+    def __init__(self, other):
+        super(QuantizedLSTM, self).__init__(other)
+
+    @torch.jit.script_method
+    def check_forward_args(self, input, hidden, batch_sizes):
+        # type: (Tensor, Tuple[Tensor, Tensor], Optional[Tensor]) -> None
+        self.check_input(input, batch_sizes)
+        expected_hidden_size = self.get_expected_hidden_size(input, batch_sizes)
+
+        self.check_hidden_size(hidden[0], expected_hidden_size,
+                               'Expected hidden[0] size {}, got {}')
+        self.check_hidden_size(hidden[1], expected_hidden_size,
+                               'Expected hidden[1] size {}, got {}')
+
+    @torch.jit.script_method
+    def permute_hidden(self, hx, permutation):
+        # type: (Tuple[Tensor, Tensor], Optional[Tensor]) -> Tuple[Tensor, Tensor]
+        if permutation is None:
+            return hx
+        return apply_permutation(hx[0], permutation), apply_permutation(hx[1], permutation)
+
+    @torch.jit.script_method
+    def forward_impl(self, input, hx, batch_sizes, max_batch_size, sorted_indices):
+        # type: (Tensor, Optional[Tuple[Tensor, Tensor]], Optional[Tensor], int, Optional[Tensor]) -> Tuple[Tensor, Tuple[Tensor, Tensor]]  # noqa
+        if hx is None:
+            num_directions = 2 if self.bidirectional else 1
+            zeros = torch.zeros(self.num_layers * num_directions,
+                                max_batch_size, self.hidden_size,
+                                dtype=input.dtype, device=input.device)
+            hx = (zeros, zeros)
+        else:
+            # Each batch of the hidden state should match the input sequence that
+            # the user believes he/she is passing in.
+            hx = self.permute_hidden(hx, sorted_indices)
+
+        self.check_forward_args(input, hx, batch_sizes)
+        if batch_sizes is None:
+            result = _VF.quantized_lstm(input, hx, self._all_weights, self.bias, self.num_layers,
+                                        self.dropout, False, self.bidirectional, self.batch_first)
+        else:
+            result = _VF.quantized_lstm(input, batch_sizes, hx, self._all_weights, self.bias,
+                                        self.num_layers, self.dropout, False, self.bidirectional)
+        output = result[0]
+        hidden = result[1:]
+
+        return output, hidden
+
+    @torch.jit.script_method
+    def forward_tensor(self, input, hx=None):
+        # type: (Tensor, Optional[Tuple[Tensor, Tensor]]) -> Tuple[Tensor, Tuple[Tensor, Tensor]]
+        batch_sizes = None
+        max_batch_size = input.size(0) if self.batch_first else input.size(1)
+        sorted_indices = None
+        unsorted_indices = None
+
+        output, hidden = self.forward_impl(input, hx, batch_sizes, max_batch_size, sorted_indices)
+
+        return output, self.permute_hidden(hidden, unsorted_indices)
+
+    @torch.jit.script_method
+    def forward_packed(self, input, hx=None):
+        # type: (Tuple[Tensor, Tensor, Optional[Tensor], Optional[Tensor]], Optional[Tuple[Tensor, Tensor]]) -> Tuple[Tuple[Tensor, Tensor, Optional[Tensor], Optional[Tensor]], Tuple[Tensor, Tensor]]  # noqa
+        input, batch_sizes, sorted_indices, unsorted_indices = input
+        max_batch_size = batch_sizes[0]
+        max_batch_size = int(max_batch_size)
+
+        output, hidden = self.forward_impl(input, hx, batch_sizes, max_batch_size, sorted_indices)
+
+        output = get_packed_sequence(output, batch_sizes, sorted_indices, unsorted_indices)
+        return output, self.permute_hidden(hidden, unsorted_indices)
+
+    def forward(self, input, hx=None):
+        if isinstance(input, PackedSequence):
+            return self.forward_packed(input, hx)
+        else:
+            return self.forward_tensor(input, hx)
+
+
+class QuantizedGRU(QuantizedRNNBase):
+    __overloads__ = {'forward': ['forward_packed', 'forward_tensor']}
+
+    def __init__(self, other):
+        super(QuantizedGRU, self).__init__(other)
+
+    @torch.jit.script_method
+    def check_forward_args(self, input, hidden, batch_sizes):
+        # type: (Tensor, Tensor, Optional[Tensor]) -> None
+        self.check_input(input, batch_sizes)
+        expected_hidden_size = self.get_expected_hidden_size(input, batch_sizes)
+
+        self.check_hidden_size(hidden, expected_hidden_size)
+
+    @torch.jit.script_method
+    def permute_hidden(self, hx, permutation):
+        # type: (Tensor, Optional[Tensor]) -> Tensor
+        if permutation is None:
+            return hx
+        return apply_permutation(hx, permutation)
+
+    @torch.jit.script_method
+    def forward_impl(self, input, hx, batch_sizes, max_batch_size, sorted_indices):
+        # type: (Tensor, Optional[Tensor], Optional[Tensor], int, Optional[Tensor]) -> Tuple[Tensor, Tensor]  # noqa
+        if hx is None:
+            num_directions = 2 if self.bidirectional else 1
+            hx = torch.zeros(self.num_layers * num_directions,
+                             max_batch_size, self.hidden_size,
+                             dtype=input.dtype, device=input.device)
+        else:
+            # Each batch of the hidden state should match the input sequence that
+            # the user believes he/she is passing in.
+            hx = self.permute_hidden(hx, sorted_indices)
+
+        self.check_forward_args(input, hx, batch_sizes)
+        if batch_sizes is None:
+            result = _VF.quantized_gru(input, hx, self._all_weights, self.bias, self.num_layers,
+                                       self.dropout, False, self.bidirectional, self.batch_first)
+        else:
+            result = _VF.quantized_gru(input, batch_sizes, hx, self._all_weights, self.bias,
+                                       self.num_layers, self.dropout, False, self.bidirectional)
+        output = result[0]
+        hidden = result[1]
+
+        return output, hidden
+
+    @torch.jit.script_method
+    def forward_tensor(self, input, hx=None):
+        # type: (Tensor, Optional[Tensor]) -> Tuple[Tensor, Tensor]
+        batch_sizes = None
+        max_batch_size = input.size(0) if self.batch_first else input.size(1)
+        sorted_indices = None
+        unsorted_indices = None
+
+        output, hidden = self.forward_impl(input, hx, batch_sizes, max_batch_size, sorted_indices)
+
+        return output, self.permute_hidden(hidden, unsorted_indices)
+
+    @torch.jit.script_method
+    def forward_packed(self, input, hx=None):
+        # type: (Tuple[Tensor, Tensor, Optional[Tensor], Optional[Tensor]], Optional[Tensor]) -> Tuple[Tuple[Tensor, Tensor, Optional[Tensor], Optional[Tensor]], Tensor]  # noqa
+        input, batch_sizes, sorted_indices, unsorted_indices = input
+        max_batch_size = batch_sizes[0]
+        max_batch_size = int(max_batch_size)
+
+        output, hidden = self.forward_impl(input, hx, batch_sizes, max_batch_size, sorted_indices)
+
+        output = get_packed_sequence(output, batch_sizes, sorted_indices, unsorted_indices)
+        return output, self.permute_hidden(hidden, unsorted_indices)
+
+    def forward(self, input, hx=None):
+        if isinstance(input, PackedSequence):
+            return self.forward_packed(input, hx)
+        else:
+            return self.forward_tensor(input, hx)
+
+
 def quantize_rnn_cell_modules(module):
     reassign = {}
     for name, mod in module.named_modules():
@@ -239,3 +500,86 @@ def quantize_linear_modules(module):
     if isinstance(mod, torch.nn.Linear):
         return QuantizedLinear(mod)
     return module
+
+
+def quantize_rnn_modules(module):
+    reassign = {}
+    for name, mod in module.named_modules():
+        if mod is module:
+            continue
+        new_mod = quantize_rnn_modules(mod)
+        if new_mod is not mod:
+            reassign[name] = new_mod
+
+    for name, mod in reassign.items():
+        setattr(module, name, mod)
+    if isinstance(module, torch.nn.LSTM):
+        return QuantizedLSTM(module)
+    if isinstance(module, torch.nn.GRU):
+        return QuantizedGRU(module)
+    return module
+
+
+class _MinMaxObserver(object):
+    """Records the range of every value it observes, keyed by its name."""
+
+    def __init__(self):
+        self.ranges = {}
+
+    def observe(self, x, name):
+        x_min, x_max = x.min().item(), x.max().item()
+        if name in self.ranges:
+            x_min = min(x_min, self.ranges[name][0])
+            x_max = max(x_max, self.ranges[name][1])
+        self.ranges[name] = (x_min, x_max)
+        return x
+
+    def qparams(self):
+        return {name: ('per_tensor_quant',) + _choose_qparams(x_min, x_max)
+                for name, (x_min, x_max) in self.ranges.items()}
+
+
+def _choose_qparams(x_min, x_max):
+    # The range is widened to contain zero, so that zero is exact
+    x_min, x_max = min(x_min, 0.), max(x_max, 0.)
+    scale = (x_max - x_min) / 255.
+    if scale == 0:
+        scale = 1.
+    zero_point = min(max(int(round(-x_min / scale)), 0), 255)
+    return scale, zero_point
+
+
+def quantize_function(fn, calibration_inputs, per_channel=False):
+    r"""
+    Quantizes the activations and weights of a script function to 8 bits.
+
+    The values computed by ``fn`` are observed while it runs on
+    ``calibration_inputs``, and the tensors flowing through its convolutions,
+    linear layers and relus are quantized with the ranges they were observed
+    to take. The convolutions and linear layers whose weights are constants,
+    like those of a traced function, then run the quantized FBGEMM kernels,
+    with their weights quantized and packed once.
+
+    Arguments:
+        fn (torch._C.Function): the function to quantize, e.g. returned by
+            :func:`torch.jit.trace`. It is left unchanged.
+        calibration_inputs (iterable): the inputs to observe ``fn`` on, each a
+            tensor or a tuple of arguments.
+        per_channel (bool, optional): quantize the weights of linear layers
+            with one scale and zero point per output channel, rather than one
+            for the whole weight. Default: ``False``.
+
+    Returns:
+        A new ``torch._C.Function`` computing the quantized ``fn``.
+    """
+    graph = fn.graph.copy()
+    observed = torch._C._create_function_from_graph(fn.name, graph)
+    observer = _MinMaxObserver()
+    torch._C._jit_pass_insert_observers(observed, observer.observe)
+    for inputs in calibration_inputs:
+        if not isinstance(inputs, tuple):
+            inputs = (inputs,)
+        observed(*inputs)
+    torch._C._jit_pass_insert_quantdequant(graph, observer.qparams())
+    torch._C._jit_pass_quant_fusion(graph, per_channel)
+    return torch._C._create_function_from_graph(fn.name, graph)
@@ -4,6 +4,13 @@
 
 #include <nccl.h>
 
+// ncclSend and ncclRecv, which the all-to-all collectives are built on, were
+// added in NCCL 2.7
+#if defined(NCCL_MAJOR) && \
+    ((NCCL_MAJOR > 2) || (NCCL_MAJOR == 2 && NCCL_MINOR >= 7))
+#define ENABLE_NCCL_P2P_SUPPORT
+#endif
+
 #define C10D_NCCL_CHECK(cmd)                                              \
   do {                                                                    \
     ncclResult_t error = cmd;                                             \
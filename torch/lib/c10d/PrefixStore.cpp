@@ -50,4 +50,15 @@ void PrefixStore::wait(
   store_.wait(joinedKeys, timeout);
 }
 
+std::vector<std::vector<uint8_t>> PrefixStore::multiGet(
+    const std::vector<std::string>& keys) {
+  return store_.multiGet(joinKeys(keys));
+}
+
+void PrefixStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  store_.multiSet(joinKeys(keys), values);
+}
+
 } // namespace c10d
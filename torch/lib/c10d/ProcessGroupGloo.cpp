@@ -7,6 +7,7 @@
 #include <gloo/gather.h>
 #include <gloo/reduce.h>
 #include <gloo/scatter.h>
+#include <gloo/types.h>
 
 #ifdef USE_CUDA
 #include <ATen/cuda/CUDAEvent.h>
@@ -18,8 +19,17 @@
 #endif
 
 #include <gloo/rendezvous/context.h>
+#include <gloo/rendezvous/prefix_store.h>
 #include <gloo/transport/tcp/device.h>
 
+#include <c10/util/StaticTracepoint.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <system_error>
+
 #define GENERATE_ALL_TYPES(type, func, args...)        \
   switch (type) {                                      \
     case ::at::ScalarType::Float:                      \
@@ -259,7 +269,9 @@ void ProcessGroupGloo::RecvWork::wait() {
 
 ProcessGroupGloo::Options::Options()
     : timeout(std::chrono::milliseconds(10 * 1000)),
-      threads(2) {}
+      threads(2),
+      hierarchicalAllreduce(false),
+      cudaChunkBytes(4 * 1024 * 1024) {}
 
 ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<Store>& store,
@@ -268,6 +280,7 @@ ProcessGroupGloo::ProcessGroupGloo(
     Options options)
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
+      cudaChunkBytes_(options.cudaChunkBytes),
       stop_(false),
       collectiveCounter_(0) {
   auto& devices = options.devices;
@@ -282,6 +295,10 @@ ProcessGroupGloo::ProcessGroupGloo(
     contexts_.push_back(std::move(context));
   }
 
+  if (options.hierarchicalAllreduce) {
+    connectHierarchy(options);
+  }
+
   // Every worker thread stores the AsyncWork object it's currently
   // working on in the workInProgress_ vector. It must have size equal
   // to the number of workers such that they can simply index into it
@@ -312,6 +329,69 @@ ProcessGroupGloo::~ProcessGroupGloo() {
   }
 }
 
+void ProcessGroupGloo::connectHierarchy(const Options& options) {
+  std::array<char, 256> hostname{};
+  if (gethostname(hostname.data(), hostname.size() - 1) != 0) {
+    throw std::system_error(errno, std::system_category());
+  }
+  const std::string host(hostname.data());
+  const std::string prefix = "hierarchy/";
+  store_->set(
+      prefix + "host/" + std::to_string(rank_),
+      std::vector<char>(host.begin(), host.end()));
+
+  // Every process computes the same topology from the hostnames of all ranks
+  std::vector<std::string> keys;
+  for (int i = 0; i < size_; i++) {
+    keys.push_back(prefix + "host/" + std::to_string(i));
+  }
+  store_->wait(keys, options.timeout);
+  std::vector<int> localRanks;
+  std::vector<int> leaderRanks;
+  std::unordered_map<std::string, int> hostLeaders;
+  for (int i = 0; i < size_; i++) {
+    const auto value = store_->get(keys[i]);
+    const std::string otherHost(value.begin(), value.end());
+    if (hostLeaders.emplace(otherHost, i).second) {
+      leaderRanks.push_back(i);
+    }
+    if (otherHost == host) {
+      localRanks.push_back(i);
+    }
+  }
+
+  // With a single host, or a process per host, the flat allreduce is
+  // already the best we can do
+  if (leaderRanks.size() == 1 ||
+      leaderRanks.size() == static_cast<size_t>(size_)) {
+    return;
+  }
+
+  const auto& device = options.devices[0];
+  const int localRank =
+      std::find(localRanks.begin(), localRanks.end(), rank_) -
+      localRanks.begin();
+  ::gloo::rendezvous::PrefixStore localStore(
+      prefix + "local/" + std::to_string(localRanks[0]), *store_);
+  auto localContext = std::make_shared<::gloo::rendezvous::Context>(
+      localRank, localRanks.size());
+  localContext->setTimeout(options.timeout);
+  localContext->connectFullMesh(localStore, device);
+  localContext_ = std::move(localContext);
+
+  if (localRank == 0) {
+    const int leaderRank =
+        std::find(leaderRanks.begin(), leaderRanks.end(), rank_) -
+        leaderRanks.begin();
+    ::gloo::rendezvous::PrefixStore leaderStore(prefix + "leaders", *store_);
+    auto leaderContext = std::make_shared<::gloo::rendezvous::Context>(
+        leaderRank, leaderRanks.size());
+    leaderContext->setTimeout(options.timeout);
+    leaderContext->connectFullMesh(leaderStore, device);
+    leaderContext_ = std::move(leaderContext);
+  }
+}
+
 uint32_t ProcessGroupGloo::nextTag() {
   return collectiveCounter_++;
 }
@@ -334,7 +414,10 @@ void ProcessGroupGloo::runLoop(int workerIndex) {
     // does not immediately block.
     workConsumeCV_.notify_one();
 
+    C10_SDT(collective_start, this, work.get(), rank_, size_);
+    auto* workPtr = work.get();
     AsyncWork::execute(std::move(work));
+    C10_SDT(collective_end, this, workPtr, rank_, size_);
     lock.lock();
     workInProgress_[workerIndex] = nullptr;
   }
@@ -504,15 +587,29 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
       const std::shared_ptr<gloo::Context>& context,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
-      uint32_t tag)
-      : context(context), inputs(inputs), reduceOp(reduceOp), tag(tag) {}
+      uint32_t tag,
+      const std::shared_ptr<gloo::Context>& localContext = nullptr,
+      const std::shared_ptr<gloo::Context>& leaderContext = nullptr)
+      : context(context),
+        inputs(inputs),
+        reduceOp(reduceOp),
+        tag(tag),
+        localContext(localContext),
+        leaderContext(leaderContext) {}
 
   std::shared_ptr<gloo::Context> context;
   std::vector<at::Tensor> inputs;
   const ReduceOp reduceOp;
   const uint32_t tag;
+  // Set for the hierarchical allreduce
+  std::shared_ptr<gloo::Context> localContext;
+  std::shared_ptr<gloo::Context> leaderContext;
 
   void allreduce(std::vector<at::Tensor>& tensors) {
+    if (localContext && tensors.size() == 1) {
+      hierarchicalAllreduce(tensors);
+      return;
+    }
     const auto& scalarType = tensors[0].scalar_type();
     gloo::AllreduceOptions opts(context);
     opts.setReduceFunction(getFunction(scalarType, reduceOp));
@@ -521,6 +618,33 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
     gloo::allreduce(opts);
   }
 
+  // Only the processes with local rank 0 send data between hosts.
+  void hierarchicalAllreduce(std::vector<at::Tensor>& tensors) {
+    const auto& scalarType = tensors[0].scalar_type();
+    {
+      gloo::ReduceOptions opts(localContext);
+      opts.setRoot(0);
+      opts.setTag(tag);
+      opts.setReduceFunction(getFunction(scalarType, reduceOp));
+      GENERATE_ALL_TYPES(scalarType, setOutput, opts, tensors[0]);
+      gloo::reduce(opts);
+    }
+    if (localContext->rank == 0) {
+      gloo::AllreduceOptions opts(leaderContext);
+      opts.setReduceFunction(getFunction(scalarType, reduceOp));
+      opts.setTag(tag);
+      GENERATE_ALL_TYPES(scalarType, setOutputs, opts, tensors);
+      gloo::allreduce(opts);
+    }
+    {
+      gloo::BroadcastOptions opts(localContext);
+      opts.setRoot(0);
+      opts.setTag(tag);
+      GENERATE_ALL_TYPES(scalarType, setOutput, opts, tensors[0]);
+      gloo::broadcast(opts);
+    }
+  }
+
   void run() override {
     allreduce(inputs);
 
@@ -547,48 +671,218 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
   }
 };
 
+// Runs one allreduce per scalar type on a flat copy of the tensors of that
+// type, instead of one per tensor.
+class AsyncAllreduceCoalescedWork : public AsyncAllreduceWork {
+ public:
+  AsyncAllreduceCoalescedWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      ReduceOp reduceOp,
+      uint32_t tag,
+      const std::shared_ptr<gloo::Context>& localContext,
+      const std::shared_ptr<gloo::Context>& leaderContext)
+      : AsyncAllreduceWork(
+            context,
+            inputs,
+            reduceOp,
+            tag,
+            localContext,
+            leaderContext) {}
+
+  void run() override {
+    for (auto& group : groupByScalarType(inputs)) {
+      std::vector<at::Tensor> flat = {flattenDenseTensors(group)};
+      allreduce(flat);
+      unflattenDenseTensors(flat[0], group);
+    }
+  }
+};
+
+// Sums sparse COO tensors by allgathering the indices and the values of
+// every process and coalescing the result, which adds up the values of
+// duplicate indices. The number of non-zero entries differs between
+// processes, so the indices and values are padded to the largest.
+class AsyncSparseAllreduceWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncSparseAllreduceWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      uint32_t tag)
+      : context(context), inputs(inputs), tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  std::vector<at::Tensor> inputs;
+  const uint32_t tag;
+
+  std::vector<int64_t> allgatherNnz(int64_t nnz) {
+    std::vector<int64_t> counts(context->size);
+    gloo::AllgatherOptions opts(context);
+    opts.setTag(tag);
+    opts.setInput(&nnz, 1);
+    opts.setOutput(counts.data(), counts.size());
+    gloo::allgather(opts);
+    return counts;
+  }
+
+  // Returns a tensor with one entry per process along a new first
+  // dimension. The first dimension of the tensor is padded to maxNnz.
+  at::Tensor allgatherPadded(const at::Tensor& tensor, int64_t maxNnz) {
+    auto sizes = tensor.sizes().vec();
+    sizes[0] = maxNnz;
+    auto input = at::zeros(sizes, tensor.options());
+    input.narrow(0, 0, tensor.size(0)).copy_(tensor);
+    sizes.insert(sizes.begin(), context->size);
+    auto output = at::empty(sizes, tensor.options());
+
+    const auto& scalarType = tensor.scalar_type();
+    gloo::AllgatherOptions opts(context);
+    opts.setTag(tag);
+    GENERATE_ALL_TYPES(scalarType, setInput, opts, input);
+    GENERATE_ALL_TYPES(scalarType, setOutput, opts, output);
+    gloo::allgather(opts);
+    return output;
+  }
+
+  at::Tensor allreduce(std::vector<at::Tensor>& tensors) {
+    // Sum the local tensors first, so that every process sends one
+    auto input = tensors[0];
+    for (size_t i = 1; i < tensors.size(); i++) {
+      input = input + tensors[i];
+    }
+    input = input.coalesce();
+
+    const auto counts = allgatherNnz(input._nnz());
+    const auto maxNnz = *std::max_element(counts.begin(), counts.end());
+    if (maxNnz == 0) {
+      return input;
+    }
+    // The indices have a column per entry, transpose them so that they are
+    // padded and concatenated along the first dimension like the values
+    auto indices = allgatherPadded(input._indices().t().contiguous(), maxNnz);
+    auto values = allgatherPadded(input._values().contiguous(), maxNnz);
+
+    std::vector<at::Tensor> allIndices;
+    std::vector<at::Tensor> allValues;
+    for (int i = 0; i < context->size; i++) {
+      allIndices.push_back(indices[i].narrow(0, 0, counts[i]));
+      allValues.push_back(values[i].narrow(0, 0, counts[i]));
+    }
+    auto output = at::_sparse_coo_tensor_unsafe(
+        at::cat(allIndices).t().contiguous(),
+        at::cat(allValues),
+        input.sizes(),
+        input.options());
+    return output.coalesce();
+  }
+
+  void run() override {
+    auto output = allreduce(inputs);
+    for (auto& input : inputs) {
+      input.copy_(output);
+    }
+  }
+};
+
 #ifdef USE_CUDA
 
+// Copies the CUDA tensors to pinned host memory, allreduces them there, and
+// copies the result back. Contiguous tensors are split into chunks that are
+// pipelined: all device to host copies are started up front, the allreduce
+// of a chunk starts as soon as its copy finished, and its copy back is
+// started right after the allreduce, on a separate stream so that it can
+// run concurrently with the device to host copies still in progress.
 class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
  public:
   AsyncAllreduceCUDAWork(
       const std::shared_ptr<gloo::Context>& context,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
-      uint32_t tag)
-      : AsyncAllreduceWork(context, inputs, reduceOp, tag) {
+      uint32_t tag,
+      const std::shared_ptr<gloo::Context>& localContext,
+      const std::shared_ptr<gloo::Context>& leaderContext,
+      size_t chunkBytes)
+      : AsyncAllreduceWork(
+            context,
+            inputs,
+            reduceOp,
+            tag,
+            localContext,
+            leaderContext) {
     initializeStreamsEvents(inputs, streams, events);
 
-    // Kick off copy from CUDA tensors to pinned CPU tensors.
+    // The copies back run on a second stream per tensor that must also be
+    // ordered after the pending work on the current streams, which the
+    // events recorded above mark.
+    at::cuda::OptionalCUDAGuard device_guard;
+    copyBackStreams.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+      const auto device = inputs[i].device().index();
+      device_guard.set_index(device);
+      copyBackStreams.push_back(
+          at::cuda::getStreamFromPool(/* isHighPriority */ true, device));
+      events[i].block(copyBackStreams[i]);
+      c10::cuda::CUDACachingAllocator::recordStream(
+          inputs[i].storage().data(), copyBackStreams[i]);
+    }
+
+    const int64_t numel = inputs[0].numel();
+    const int64_t chunkNumel = chunkBytes / inputs[0].element_size();
+    bool chunked = chunkNumel > 0 && numel > chunkNumel;
+    for (const auto& input : inputs) {
+      chunked = chunked && input.is_contiguous();
+    }
+    if (chunked) {
+      for (int64_t offset = 0; offset < numel; offset += chunkNumel) {
+        chunks.emplace_back(offset, std::min(chunkNumel, numel - offset));
+      }
+    } else {
+      chunks.emplace_back(0, numel);
+    }
+
+    // Kick off copy from CUDA tensors to pinned CPU tensors, recording
+    // an event after every chunk.
     tmp.reserve(inputs.size());
+    copyEvents.resize(inputs.size());
     at::cuda::OptionalCUDAStreamGuard guard;
     for (size_t i = 0; i < inputs.size(); i++) {
       guard.reset_stream(streams[i]);
-      tmp.push_back(pinnedLike(inputs[i]).copy_(inputs[i], true));
+      tmp.push_back(pinnedLike(inputs[i]));
+      copyEvents[i].resize(chunks.size());
+      for (size_t c = 0; c < chunks.size(); c++) {
+        chunk(tmp[i], c).copy_(chunk(inputs[i], c), true);
+        copyEvents[i][c].record(streams[i]);
+      }
     }
   }
 
   void run() override {
-    // Synchronize with copy operations.
     at::cuda::OptionalCUDAGuard device_guard;
-    for (size_t i = 0; i < inputs.size(); i++) {
-      device_guard.set_index(inputs[i].device().index());
-      AT_CUDA_CHECK(cudaStreamSynchronize(streams[i]));
-    }
-
-    // Run allreduce on host side tensors.
-    allreduce(tmp);
-
-    // Kick off copy back to the CUDA tensors.
-    // Only the first output in the tensor list contains the results.
-    // See https://github.com/facebookincubator/gloo/issues/152.
-    // The contents is the same for every entry in the tensor list, so
-    // we can use the first entry as the source of the copy below.
     at::cuda::OptionalCUDAStreamGuard stream_guard;
+    std::vector<at::Tensor> pieces(inputs.size());
+    for (size_t c = 0; c < chunks.size(); c++) {
+      // Synchronize with the copies of this chunk.
+      for (size_t i = 0; i < inputs.size(); i++) {
+        device_guard.set_index(inputs[i].device().index());
+        copyEvents[i][c].synchronize();
+        pieces[i] = chunk(tmp[i], c);
+      }
+
+      // Run allreduce on host side tensors.
+      allreduce(pieces);
+
+      // Kick off copy back to the CUDA tensors.
+      // Only the first output in the tensor list contains the results.
+      // See https://github.com/facebookincubator/gloo/issues/152.
+      // The contents is the same for every entry in the tensor list, so
+      // we can use the first entry as the source of the copy below.
+      for (size_t i = 0; i < inputs.size(); i++) {
+        stream_guard.reset_stream(copyBackStreams[i]);
+        chunk(inputs[i], c).copy_(pieces[0], /* non_blocking */ true);
+      }
+    }
     for (size_t i = 0; i < inputs.size(); i++) {
-      stream_guard.reset_stream(streams[i]);
-      inputs[i].copy_(tmp[0], /* non_blocking */ true);
-      events[i].record(streams[i]);
+      events[i].record(copyBackStreams[i]);
     }
   }
 
@@ -601,9 +895,22 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
     }
   }
 
+  // Returns chunk `c` of `tensor`, or all of it if it isn't chunked.
+  at::Tensor chunk(at::Tensor& tensor, size_t c) {
+    if (chunks.size() == 1) {
+      return tensor;
+    }
+    return tensor.view({-1}).narrow(0, chunks[c].first, chunks[c].second);
+  }
+
   std::vector<at::Tensor> tmp;
   std::vector<at::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAStream> copyBackStreams;
   std::vector<at::cuda::CUDAEvent> events;
+  // Offset and number of elements of every chunk.
+  std::vector<std::pair<int64_t, int64_t>> chunks;
+  // Recorded after the copy of every chunk of every input to tmp.
+  std::vector<std::vector<at::cuda::CUDAEvent>> copyEvents;
 };
 
 #endif
@@ -618,7 +925,6 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   };
 
   assertNonEmpty(invalidArgument, inputs);
-  assertDense(invalidArgument, inputs);
   assertTypeAndSizesMatch(invalidArgument, inputs);
 
   const auto& device = inputs[0].device();
@@ -632,15 +938,43 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
       invalidArgument("unsupported device type");
   }
 
-  std::shared_ptr<AsyncAllreduceWork> work;
+  const auto& layout = inputs[0].layout();
+  if (layout == at::kSparse) {
+    if (device.type() != at::kCPU) {
+      invalidArgument("only supports sparse CPU tensors");
+    }
+    if (opts.reduceOp != ReduceOp::SUM) {
+      invalidArgument(
+          "unsupported reduction operation "
+          "(allreduce of sparse tensors only works with ReduceOp.SUM)");
+    }
+  } else if (layout != at::kStrided) {
+    invalidArgument("unsupported layout");
+  }
+
+  std::shared_ptr<ProcessGroupGloo::AsyncWork> work;
   auto& context = contexts_[0];
-  if (device.type() == at::kCPU) {
+  if (layout == at::kSparse) {
+    work = std::make_shared<AsyncSparseAllreduceWork>(
+        context, inputs, nextTag());
+  } else if (device.type() == at::kCPU) {
     work = std::make_shared<AsyncAllreduceWork>(
-        context, inputs, opts.reduceOp, nextTag());
+        context,
+        inputs,
+        opts.reduceOp,
+        nextTag(),
+        localContext_,
+        leaderContext_);
 #ifdef USE_CUDA
   } else if (device.type() == at::kCUDA) {
     work = std::make_shared<AsyncAllreduceCUDAWork>(
-        context, inputs, opts.reduceOp, nextTag());
+        context,
+        inputs,
+        opts.reduceOp,
+        nextTag(),
+        localContext_,
+        leaderContext_,
+        cudaChunkBytes_);
 #endif
   } else {
     throw std::runtime_error("Invalid backend");
@@ -650,6 +984,35 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   return work;
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceCoalescedOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument(
+        "ProcessGroupGloo::allreduce_coalesced: " + msg);
+  };
+
+  assertNonEmpty(invalidArgument, tensors);
+  for (const auto& tensor : tensors) {
+    if (tensor.layout() != at::kStrided) {
+      invalidArgument("only supports dense tensors");
+    }
+    if (tensor.device().type() != at::kCPU) {
+      invalidArgument("only supports CPU tensors");
+    }
+  }
+
+  auto work = std::make_shared<AsyncAllreduceCoalescedWork>(
+      contexts_[0],
+      tensors,
+      opts.reduceOp,
+      nextTag(),
+      localContext_,
+      leaderContext_);
+  enqueue(work);
+  return work;
+}
+
 namespace {
 
 class AsyncReduceWork : public ProcessGroupGloo::AsyncWork {
@@ -1387,11 +1750,257 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::scatter(
   return work;
 }
 
+namespace {
+
+// Gloo has no reduce-scatter taking one buffer per rank, so the inputs are
+// flattened and allreduced, and each process keeps its own chunk. This moves
+// twice the data of an optimal reduce-scatter, which is still far less than
+// emulating it with a reduce per rank.
+class AsyncReduceScatterWork : public AsyncAllreduceWork {
+ public:
+  AsyncReduceScatterWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& outputs,
+      std::vector<at::Tensor>& inputTensors,
+      ReduceOp reduceOp,
+      uint32_t tag)
+      : AsyncAllreduceWork(context, outputs, reduceOp, tag),
+        outputs(outputs),
+        offset(0) {
+    // Always copies, so the allreduce doesn't modify the inputs
+    inputs = {at::cat(::c10d::fmap(inputTensors, [](at::Tensor& t) {
+      return t.contiguous().view({-1});
+    }))};
+    for (int i = 0; i < context->rank; i++) {
+      offset += inputTensors[i].numel();
+    }
+  }
+
+  std::vector<at::Tensor> outputs;
+  int64_t offset;
+
+  void run() override {
+    allreduce(inputs);
+    outputs[0].copy_(inputs[0]
+                         .narrow(0, offset, outputs[0].numel())
+                         .view(outputs[0].sizes()));
+  }
+};
+
+} // namespace
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter(
     std::vector<at::Tensor>& outputs,
     std::vector<std::vector<at::Tensor>>& inputs,
     const ReduceScatterOptions& opts) {
-  throw std::runtime_error("ProcessGroupGloo does not support reduce_scatter");
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::reduce_scatter: " + msg);
+  };
+
+  assertSingleElementOutput(invalidArgument, outputs);
+  assertDense(invalidArgument, outputs);
+  assertCPU(invalidArgument, outputs);
+  if (inputs.size() != 1) {
+    invalidArgument("requires a single-element input list");
+  }
+  if (inputs[0].size() != static_cast<size_t>(size_)) {
+    invalidArgument(
+        "requires input list to contain one tensor per rank");
+  }
+  assertDense(invalidArgument, inputs[0]);
+  assertCPU(invalidArgument, inputs[0]);
+  for (int i = 0; i < size_; i++) {
+    assertTypeMatch(invalidArgument, outputs[0].type(), inputs[0], i);
+  }
+  if (inputs[0][rank_].numel() != outputs[0].numel()) {
+    invalidArgument(
+        "requires the input tensor for this rank to match the output size");
+  }
+
+  auto work = std::make_shared<AsyncReduceScatterWork>(
+      contexts_[0], outputs, inputs[0], opts.reduceOp, nextTag());
+  enqueue(work);
+  return work;
+}
+
+namespace {
+
+// Picks a slot prefix that the Gloo collectives don't use, so the
+// point-to-point operations of an all-to-all can't match those of other
+// collectives or of user send/recv calls.
+constexpr uint8_t kAlltoallSlotPrefix = 0x80;
+
+// Exchanges chunks of CPU tensors with every other process through
+// point-to-point operations. recvPtrs/sendPtrs[i] and their byte counts
+// describe the chunk received from and sent to rank i.
+class AsyncAlltoallWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncAlltoallWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor> outputs,
+      std::vector<at::Tensor> inputs,
+      std::vector<char*> recvPtrs,
+      std::vector<size_t> recvBytes,
+      std::vector<char*> sendPtrs,
+      std::vector<size_t> sendBytes,
+      uint32_t tag)
+      : context(context),
+        outputs(std::move(outputs)),
+        inputs(std::move(inputs)),
+        recvPtrs(std::move(recvPtrs)),
+        recvBytes(std::move(recvBytes)),
+        sendPtrs(std::move(sendPtrs)),
+        sendBytes(std::move(sendBytes)),
+        tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  // Hold the tensors the pointers below point into
+  std::vector<at::Tensor> outputs;
+  std::vector<at::Tensor> inputs;
+  std::vector<char*> recvPtrs;
+  std::vector<size_t> recvBytes;
+  std::vector<char*> sendPtrs;
+  std::vector<size_t> sendBytes;
+  const uint32_t tag;
+
+  void run() override {
+    const int rank = context->rank;
+    const int size = context->size;
+    if (recvBytes[rank] != sendBytes[rank]) {
+      throw std::runtime_error(
+          "ProcessGroupGloo::alltoall: the chunk this rank sends to itself"
+          " must have the size of the chunk it receives from itself");
+    }
+    std::memcpy(recvPtrs[rank], sendPtrs[rank], sendBytes[rank]);
+
+    const uint64_t slot = gloo::Slot::build(kAlltoallSlotPrefix, tag);
+    std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> recvBufs;
+    std::vector<std::unique_ptr<gloo::transport::UnboundBuffer>> sendBufs;
+    for (int i = 1; i < size; i++) {
+      // Post the operations in the order of the distance to this rank, so
+      // that every pair of processes exchanges chunks at about the same time
+      const int recvRank = (rank - i + size) % size;
+      const int sendRank = (rank + i) % size;
+      if (recvBytes[recvRank] > 0) {
+        recvBufs.push_back(context->createUnboundBuffer(
+            recvPtrs[recvRank], recvBytes[recvRank]));
+        recvBufs.back()->recv(recvRank, slot);
+      }
+      if (sendBytes[sendRank] > 0) {
+        sendBufs.push_back(context->createUnboundBuffer(
+            sendPtrs[sendRank], sendBytes[sendRank]));
+        sendBufs.back()->send(sendRank, slot);
+      }
+    }
+    for (auto& buf : recvBufs) {
+      buf->waitRecv();
+    }
+    for (auto& buf : sendBufs) {
+      buf->waitSend();
+    }
+  }
+};
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::alltoall_base: " + msg);
+  };
+
+  std::vector<at::Tensor> outputs = {outputTensor};
+  std::vector<at::Tensor> inputs = {inputTensor};
+  assertDense(invalidArgument, outputs);
+  assertDense(invalidArgument, inputs);
+  assertCPU(invalidArgument, outputs);
+  assertCPU(invalidArgument, inputs);
+  assertTypeMatch(invalidArgument, outputTensor.type(), inputs, 0);
+  if (!outputTensor.is_contiguous() || !inputTensor.is_contiguous()) {
+    invalidArgument("requires contiguous tensors");
+  }
+
+  std::vector<int64_t> recvLengths, recvOffsets, sendLengths, sendOffsets;
+  computeLengthsAndOffsets(
+      outputSplitSizes, outputTensor, size_, &recvLengths, &recvOffsets);
+  computeLengthsAndOffsets(
+      inputSplitSizes, inputTensor, size_, &sendLengths, &sendOffsets);
+
+  const size_t elementSize = inputTensor.element_size();
+  auto* recvBase = static_cast<char*>(outputTensor.data_ptr());
+  auto* sendBase = static_cast<char*>(inputTensor.data_ptr());
+  std::vector<char*> recvPtrs(size_), sendPtrs(size_);
+  std::vector<size_t> recvBytes(size_), sendBytes(size_);
+  for (int i = 0; i < size_; i++) {
+    recvPtrs[i] = recvBase + recvOffsets[i] * elementSize;
+    recvBytes[i] = recvLengths[i] * elementSize;
+    sendPtrs[i] = sendBase + sendOffsets[i] * elementSize;
+    sendBytes[i] = sendLengths[i] * elementSize;
+  }
+
+  auto work = std::make_shared<AsyncAlltoallWork>(
+      contexts_[0],
+      std::move(outputs),
+      std::move(inputs),
+      std::move(recvPtrs),
+      std::move(recvBytes),
+      std::move(sendPtrs),
+      std::move(sendBytes),
+      nextTag());
+  enqueue(work);
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::alltoall(
+    std::vector<at::Tensor>& outputTensors,
+    std::vector<at::Tensor>& inputTensors,
+    const AllToAllOptions& /* unused */) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::alltoall: " + msg);
+  };
+
+  if (outputTensors.size() != static_cast<size_t>(size_) ||
+      inputTensors.size() != static_cast<size_t>(size_)) {
+    invalidArgument("requires tensor lists with one tensor per rank");
+  }
+  assertDense(invalidArgument, outputTensors);
+  assertDense(invalidArgument, inputTensors);
+  assertCPU(invalidArgument, outputTensors);
+  assertCPU(invalidArgument, inputTensors);
+  const auto& type = inputTensors[0].type();
+  for (int i = 0; i < size_; i++) {
+    assertTypeMatch(invalidArgument, type, outputTensors, i);
+    assertTypeMatch(invalidArgument, type, inputTensors, i);
+    if (!outputTensors[i].is_contiguous() ||
+        !inputTensors[i].is_contiguous()) {
+      invalidArgument("requires contiguous tensors");
+    }
+  }
+
+  std::vector<char*> recvPtrs(size_), sendPtrs(size_);
+  std::vector<size_t> recvBytes(size_), sendBytes(size_);
+  for (int i = 0; i < size_; i++) {
+    recvPtrs[i] = static_cast<char*>(outputTensors[i].data_ptr());
+    recvBytes[i] = outputTensors[i].numel() * outputTensors[i].element_size();
+    sendPtrs[i] = static_cast<char*>(inputTensors[i].data_ptr());
+    sendBytes[i] = inputTensors[i].numel() * inputTensors[i].element_size();
+  }
+
+  auto work = std::make_shared<AsyncAlltoallWork>(
+      contexts_[0],
+      outputTensors,
+      inputTensors,
+      std::move(recvPtrs),
+      std::move(recvBytes),
+      std::move(sendPtrs),
+      std::move(sendBytes),
+      nextTag());
+  enqueue(work);
+  return work;
 }
 
 at::Tensor& checkSingleTensor(std::vector<at::Tensor>& tensors) {
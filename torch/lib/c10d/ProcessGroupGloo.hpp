@@ -125,6 +125,19 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // Runs allreduce in three steps: a reduce among the processes on the
+    // same host, an allreduce among one process per host, and a broadcast
+    // back within every host. Hosts are found by exchanging hostnames through
+    // the store. Only single tensor allreduces use it.
+    bool hierarchicalAllreduce;
+
+    // CUDA tensors are allreduced through pinned host memory. Contiguous
+    // tensors larger than this many bytes are copied and reduced in chunks
+    // of this size, so that the device to host copies of later chunks and
+    // the copies back of earlier chunks overlap with the reduction of the
+    // current one. Zero disables chunking.
+    size_t cudaChunkBytes;
   };
 
   explicit ProcessGroupGloo(
@@ -143,6 +156,11 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const AllreduceOptions& opts = AllreduceOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) override;
@@ -167,6 +185,18 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputs,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> alltoall(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> send(
       std::vector<at::Tensor>& tensors,
       int dstRank,
@@ -187,6 +217,20 @@ class ProcessGroupGloo : public ProcessGroup {
  protected:
   std::unique_ptr<::gloo::rendezvous::Store> store_;
   std::vector<std::shared_ptr<::gloo::Context>> contexts_;
+
+  // For the hierarchical allreduce (see Options), a context for the processes
+  // on the same host as this one and, if this process has the lowest rank on
+  // its host, one for the processes with the lowest rank on their host.
+  // Null if the hierarchical allreduce is disabled or wouldn't help.
+  std::shared_ptr<::gloo::Context> localContext_;
+  std::shared_ptr<::gloo::Context> leaderContext_;
+
+  // Creates localContext_ and leaderContext_.
+  void connectHierarchy(const Options& options);
+
+  // See Options::cudaChunkBytes.
+  const size_t cudaChunkBytes_;
+
   std::vector<std::thread> threads_;
   bool stop_;
 
@@ -2,6 +2,8 @@
 
 #include <map>
 
+#include <c10/util/StaticTracepoint.h>
+
 #if defined(OPEN_MPI) && OPEN_MPI
 #include <mpi-ext.h> // Needed for CUDA-aware check
 #endif
@@ -77,6 +79,20 @@ void checkSingleTensor(const std::vector<at::Tensor>& tensors) {
   checkSingleTensorHelper(tensors[0]);
 }
 
+// Converts element counts or displacements to the ints MPI takes
+std::vector<int> toMpiCounts(const std::vector<int64_t>& counts) {
+  std::vector<int> mpiCounts(counts.size());
+  for (size_t i = 0; i < counts.size(); ++i) {
+    if (counts[i] > std::numeric_limits<int>::max()) {
+      throw std::runtime_error(
+          "MPI process group does not support collectives on more than "
+          "INT_MAX elements");
+    }
+    mpiCounts[i] = static_cast<int>(counts[i]);
+  }
+  return mpiCounts;
+}
+
 void checkSameSizeAndType(
     const at::Tensor& tensor,
     const std::vector<at::Tensor>& tensors) {
@@ -288,12 +304,14 @@ void ProcessGroupMPI::runLoop() {
     lock.unlock();
     queueConsumeCV_.notify_one();
 
+    C10_SDT(collective_start, this, work.get(), rank_, size_);
     try {
       workEntry->run(workEntry);
       work->finish();
     } catch (...) {
       work->finish(std::current_exception());
     }
+    C10_SDT(collective_end, this, work.get(), rank_, size_);
 
     lock.lock();
   }
@@ -351,6 +369,44 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce(
   return enqueue(std::move(entry));
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceCoalescedOptions& opts) {
+  if (tensors.empty()) {
+    throw std::runtime_error(
+        "allreduce_coalesced requires non-empty tensor list");
+  }
+  for (const auto& tensor : tensors) {
+    checkSingleTensorHelper(tensor);
+    if (tensor.device() != tensors[0].device()) {
+      throw std::runtime_error(
+          "allreduce_coalesced requires tensors on the same device");
+    }
+  }
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [opts, this](std::unique_ptr<WorkEntry>& entry) {
+        // One allreduce per scalar type, on a flat copy of its tensors
+        for (auto& group : groupByScalarType(entry->src)) {
+          auto flat = flattenDenseTensors(group);
+          {
+            std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+            MPI_CHECK(MPI_Allreduce(
+                MPI_IN_PLACE,
+                flat.data_ptr(),
+                flat.numel(),
+                mpiDatatype.at(flat.scalar_type()),
+                mpiOp.at(opts.reduceOp),
+                pgComm_));
+          }
+          unflattenDenseTensors(flat, group);
+        }
+      };
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&tensors, nullptr, std::move(runFunc)));
+  return enqueue(std::move(entry));
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
     std::vector<at::Tensor>& tensors,
     const ReduceOptions& opts) {
@@ -556,7 +612,168 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce_scatter(
     std::vector<at::Tensor>& outputTensors,
     std::vector<std::vector<at::Tensor>>& inputTensors,
     const ReduceScatterOptions& opts) {
-  throw std::runtime_error("ProcessGroupMPI does not support reduce_scatter");
+  checkSingleTensor(outputTensors);
+  if (inputTensors.size() != 1) {
+    throw std::runtime_error(
+        "Reduce scatter: multi-GPU collective is not supported");
+  }
+  if (static_cast<size_t>(size_) != inputTensors[0].size()) {
+    throw std::runtime_error(
+        "Reduce scatter: number of input tensors should equal "
+        "to the world size");
+  }
+  for (const auto& input : inputTensors[0]) {
+    checkSingleTensorHelper(input);
+    if (input.type() != outputTensors[0].type()) {
+      throw std::runtime_error("Tensors are not equal in data type");
+    }
+  }
+  if (inputTensors[0][rank_].numel() != outputTensors[0].numel()) {
+    throw std::runtime_error(
+        "Reduce scatter: the input tensor for this rank should have the "
+        "size of the output tensor");
+  }
+
+  // The chunks may have different sizes, as long as every process passes
+  // the same sizes
+  std::vector<int64_t> counts;
+  for (const auto& input : inputTensors[0]) {
+    counts.push_back(input.numel());
+  }
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [opts, counts, this](std::unique_ptr<WorkEntry>& entry) {
+        auto data = (entry->dst)[0];
+        auto flatInputTensor = flattenDenseTensors(entry->src);
+        auto recvCounts = toMpiCounts(counts);
+
+        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        MPI_CHECK(MPI_Reduce_scatter(
+            flatInputTensor.data_ptr(),
+            data.data_ptr(),
+            recvCounts.data(),
+            mpiDatatype.at(data.scalar_type()),
+            mpiOp.at(opts.reduceOp),
+            pgComm_));
+      };
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&inputTensors[0], &outputTensors, std::move(runFunc)));
+  return enqueue(std::move(entry));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& opts) {
+  checkSingleTensorHelper(inputTensor);
+  checkSingleTensorHelper(outputTensor);
+  if (inputTensor.type() != outputTensor.type()) {
+    throw std::runtime_error("Tensors are not equal in data type");
+  }
+
+  std::vector<int64_t> sendLengths, sendOffsets, recvLengths, recvOffsets;
+  computeLengthsAndOffsets(
+      inputSplitSizes, inputTensor, size_, &sendLengths, &sendOffsets);
+  computeLengthsAndOffsets(
+      outputSplitSizes, outputTensor, size_, &recvLengths, &recvOffsets);
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [sendLengths, sendOffsets, recvLengths, recvOffsets, this](
+          std::unique_ptr<WorkEntry>& entry) {
+        auto src = (entry->src)[0];
+        auto dst = (entry->dst)[0];
+        auto sendCounts = toMpiCounts(sendLengths);
+        auto sendDispls = toMpiCounts(sendOffsets);
+        auto recvCounts = toMpiCounts(recvLengths);
+        auto recvDispls = toMpiCounts(recvOffsets);
+
+        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        MPI_CHECK(MPI_Alltoallv(
+            src.data_ptr(),
+            sendCounts.data(),
+            sendDispls.data(),
+            mpiDatatype.at(src.scalar_type()),
+            dst.data_ptr(),
+            recvCounts.data(),
+            recvDispls.data(),
+            mpiDatatype.at(dst.scalar_type()),
+            pgComm_));
+      };
+  std::vector<at::Tensor> inputTensors = {inputTensor};
+  std::vector<at::Tensor> outputTensors = {outputTensor};
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&inputTensors, &outputTensors, std::move(runFunc)));
+  return enqueue(std::move(entry));
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::alltoall(
+    std::vector<at::Tensor>& outputTensors,
+    std::vector<at::Tensor>& inputTensors,
+    const AllToAllOptions& opts) {
+  if (static_cast<size_t>(size_) != inputTensors.size() ||
+      static_cast<size_t>(size_) != outputTensors.size()) {
+    throw std::runtime_error(
+        "All to all: number of input and output tensors should equal "
+        "to the world size");
+  }
+  for (const auto* tensors : {&inputTensors, &outputTensors}) {
+    for (const auto& tensor : *tensors) {
+      checkSingleTensorHelper(tensor);
+      if (tensor.type() != inputTensors[0].type()) {
+        throw std::runtime_error("Tensors are not equal in data type");
+      }
+    }
+  }
+
+  std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
+      [this](std::unique_ptr<WorkEntry>& entry) {
+        std::vector<at::Tensor>& inputDataVec = entry->src;
+        std::vector<at::Tensor>& outputDataVec = entry->dst;
+        std::vector<int64_t> sendLengths, sendOffsets;
+        std::vector<int64_t> recvLengths, recvOffsets;
+        int64_t sendOffset = 0, recvOffset = 0;
+        for (int i = 0; i < size_; ++i) {
+          sendLengths.push_back(inputDataVec[i].numel());
+          sendOffsets.push_back(sendOffset);
+          sendOffset += sendLengths.back();
+          recvLengths.push_back(outputDataVec[i].numel());
+          recvOffsets.push_back(recvOffset);
+          recvOffset += recvLengths.back();
+        }
+        auto flatInputTensor = flattenDenseTensors(inputDataVec);
+        auto flatOutputTensor =
+            at::empty({recvOffset}, outputDataVec[0].options());
+        auto sendCounts = toMpiCounts(sendLengths);
+        auto sendDispls = toMpiCounts(sendOffsets);
+        auto recvCounts = toMpiCounts(recvLengths);
+        auto recvDispls = toMpiCounts(recvOffsets);
+
+        {
+          std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+          MPI_CHECK(MPI_Alltoallv(
+              flatInputTensor.data_ptr(),
+              sendCounts.data(),
+              sendDispls.data(),
+              mpiDatatype.at(flatInputTensor.scalar_type()),
+              flatOutputTensor.data_ptr(),
+              recvCounts.data(),
+              recvDispls.data(),
+              mpiDatatype.at(flatOutputTensor.scalar_type()),
+              pgComm_));
+        }
+
+        // copy the flattened output tensor to the outputs
+        for (int i = 0; i < size_; ++i) {
+          outputDataVec[i].copy_(
+              flatOutputTensor.narrow(0, recvOffsets[i], recvLengths[i])
+                  .view(outputDataVec[i].sizes()));
+        }
+      };
+  auto entry = std::unique_ptr<WorkEntry>(
+      new WorkEntry(&inputTensors, &outputTensors, std::move(runFunc)));
+  return enqueue(std::move(entry));
 }
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::send(
@@ -8,6 +8,7 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/util/StaticTracepoint.h>
 
 #include <c10d/Utils.hpp>
 
@@ -217,6 +218,26 @@ void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
   }
 }
 
+void ProcessGroupNCCL::warmup(const std::vector<at::Device>& devices) {
+  if (devices.empty()) {
+    throw std::runtime_error("Device list must be nonempty");
+  }
+  std::unordered_set<at::DeviceIndex> usedDevices;
+  for (const auto& device : devices) {
+    if (!device.is_cuda() || !device.has_index()) {
+      throw std::runtime_error(c10::str(
+          "Devices must be CUDA devices with an index, got ", device));
+    }
+    if (device.index() >= static_cast<int>(at::cuda::getNumGPUs())) {
+      throw std::runtime_error(c10::str("Invalid CUDA device ", device));
+    }
+    if (!usedDevices.insert(device.index()).second) {
+      throw std::runtime_error("Devices must be distinct");
+    }
+  }
+  getNCCLComm(getKeyFromDevices(devices), devices);
+}
+
 std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     const std::string& devicesKey,
     const std::vector<at::Device>& devices) {
@@ -236,6 +257,7 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     return devNCCLCommMap_[devicesKey];
   }
   // NCCL communicator not cached, create a new entry
+  const auto start = std::chrono::steady_clock::now();
   std::vector<std::shared_ptr<NCCLComm>> ncclComms;
   ncclComms.resize(devices.size());
 
@@ -254,7 +276,8 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
   std::vector<at::cuda::CUDAStream> streamVal;
   streamVal.reserve(devices.size());
 
-  // Create the NCCL communicators for each GPU
+  // Create the NCCL communicators for each GPU. Within a group the devices
+  // are initialized concurrently instead of one after the other.
   C10D_NCCL_CHECK(ncclGroupStart());
 
   for (size_t i = 0; i < devices.size(); ++i) {
@@ -271,6 +294,10 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
 
   C10D_NCCL_CHECK(ncclGroupEnd());
 
+  commInitTimes_[devicesKey] =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start);
+
   // Move the NCCL resource to cache
   devNCCLCommMap_.emplace(devicesKey, std::move(ncclComms));
   ncclStreams_.emplace(devicesKey, std::move(streamVal));
@@ -399,6 +426,9 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
 
   pre(ncclStreams_[key]);
 
+  // The collective runs asynchronously on the NCCL streams, so the end probe
+  // marks when it has been enqueued, not when it completes on the devices.
+  C10_SDT(collective_start, this, work.get(), rank_, size_);
   C10D_NCCL_CHECK(ncclGroupStart());
 
   for (size_t i = 0; i < inputs.size(); ++i) {
@@ -433,6 +463,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     at::cuda::CUDAStream& ncclStream = ncclStreams_[key][i];
     work->cudaEvents_[i].record(ncclStream);
   }
+  C10_SDT(collective_end, this, work.get(), rank_, size_);
 
   return work;
 }
@@ -491,6 +522,62 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::broadcast(
   );
 }
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allreduce_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceCoalescedOptions& opts) {
+  if (tensors.empty()) {
+    throw std::runtime_error("Tensor list must be nonempty");
+  }
+  for (const auto& t : tensors) {
+    if (!t.is_cuda() || t.is_sparse()) {
+      throw std::runtime_error("Tensors must be CUDA and dense");
+    }
+    if (t.device() != tensors[0].device()) {
+      throw std::runtime_error("Tensors must be on the same GPU device");
+    }
+  }
+
+  // Flatten on the current stream, the NCCL stream waits for it in
+  // collective(). Every flat buffer is reduced in the same NCCL group and
+  // copied back on the NCCL stream before the work's event is recorded.
+  auto groups = groupByScalarType(tensors);
+  std::vector<at::Tensor> flats;
+  flats.reserve(groups.size());
+  for (auto& group : groups) {
+    flats.push_back(flattenDenseTensors(group));
+  }
+  std::vector<at::Tensor> firstFlat = {flats[0]};
+  return collective(firstFlat, firstFlat,
+    [&] (at::Tensor& /* unused */, at::Tensor& /* unused */,
+         ncclComm_t comm, at::cuda::CUDAStream& stream) -> ncclResult_t {
+      for (auto& flat : flats) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+          flat.storage().data(), stream);
+        auto result = ncclAllReduce(
+          flat.data_ptr(),
+          flat.data_ptr(),
+          flat.numel(),
+          getNcclDataType(flat.scalar_type()),
+          ncclOp[opts.reduceOp],
+          comm,
+          stream.stream()
+        );
+        if (result != ncclSuccess) {
+          return result;
+        }
+      }
+      return ncclSuccess;
+    },
+    [] (std::vector<at::cuda::CUDAStream>&) {},
+    [&] (std::vector<at::cuda::CUDAStream>& ncclStreams) {
+      at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+      for (size_t i = 0; i < groups.size(); ++i) {
+        unflattenDenseTensors(flats[i], groups[i]);
+      }
+    }
+  );
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce(
     std::vector<at::Tensor>& tensors,
     const ReduceOptions& opts) {
@@ -601,6 +688,182 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::reduce_scatter(
   );
 }
 
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+
+namespace {
+
+// Sends lengths[i] elements at sendOffsets[i] of `input' to rank i and
+// receives recvLengths[i] elements at recvOffsets[i] of `output' from rank i,
+// as a single group of point-to-point operations.
+ncclResult_t ncclAlltoallv(
+    at::Tensor& input,
+    const std::vector<int64_t>& sendLengths,
+    const std::vector<int64_t>& sendOffsets,
+    at::Tensor& output,
+    const std::vector<int64_t>& recvLengths,
+    const std::vector<int64_t>& recvOffsets,
+    ncclComm_t comm,
+    at::cuda::CUDAStream& stream) {
+  const auto type = getNcclDataType(input.scalar_type());
+  const size_t elementSize = input.element_size();
+  auto* sendBase = static_cast<char*>(input.data_ptr());
+  auto* recvBase = static_cast<char*>(output.data_ptr());
+  C10D_NCCL_CHECK(ncclGroupStart());
+  for (size_t r = 0; r < sendLengths.size(); ++r) {
+    if (sendLengths[r] > 0) {
+      C10D_NCCL_CHECK(ncclSend(
+          sendBase + sendOffsets[r] * elementSize,
+          sendLengths[r],
+          type,
+          r,
+          comm,
+          stream.stream()));
+    }
+    if (recvLengths[r] > 0) {
+      C10D_NCCL_CHECK(ncclRecv(
+          recvBase + recvOffsets[r] * elementSize,
+          recvLengths[r],
+          type,
+          r,
+          comm,
+          stream.stream()));
+    }
+  }
+  return ncclGroupEnd();
+}
+
+void check_alltoall_tensors(
+    const std::vector<at::Tensor>& outputTensors,
+    const std::vector<at::Tensor>& inputTensors,
+    size_t world_size) {
+  if (outputTensors.size() != world_size ||
+      inputTensors.size() != world_size) {
+    throw std::runtime_error(
+      "Tensor lists to alltoall must have one tensor per rank");
+  }
+  const auto& first = inputTensors.front();
+  for (const auto* tensors : {&outputTensors, &inputTensors}) {
+    for (const auto& t : *tensors) {
+      if (!t.is_cuda() || t.is_sparse() || !t.is_contiguous()) {
+        throw std::runtime_error("Tensors must be CUDA, dense and contiguous");
+      }
+      if (t.scalar_type() != first.scalar_type()) {
+        throw std::runtime_error("Tensors must have identical type");
+      }
+      if (t.get_device() != first.get_device()) {
+        throw std::runtime_error("Tensors must be on the same GPU device");
+      }
+    }
+  }
+}
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+  std::vector<at::Tensor> inputTensors = {inputTensor};
+  std::vector<at::Tensor> outputTensors = {outputTensor};
+  check_gpu_tensors(inputTensors);
+  check_gpu_tensors(outputTensors);
+  if (inputTensor.get_device() != outputTensor.get_device() ||
+      inputTensor.scalar_type() != outputTensor.scalar_type()) {
+    throw std::runtime_error(
+      "Input and output tensors to alltoall must have the same type and"
+      " device");
+  }
+
+  std::vector<int64_t> sendLengths, sendOffsets, recvLengths, recvOffsets;
+  computeLengthsAndOffsets(
+    inputSplitSizes, inputTensor, size_, &sendLengths, &sendOffsets);
+  computeLengthsAndOffsets(
+    outputSplitSizes, outputTensor, size_, &recvLengths, &recvOffsets);
+
+  return collective(inputTensors, outputTensors,
+    [&] (at::Tensor& input, at::Tensor& output,
+         ncclComm_t comm, at::cuda::CUDAStream& stream) {
+      c10::cuda::CUDACachingAllocator::recordStream(
+        output.storage().data(), stream
+      );
+      return ncclAlltoallv(
+        input, sendLengths, sendOffsets,
+        output, recvLengths, recvOffsets,
+        comm, stream
+      );
+    }
+  );
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
+    std::vector<at::Tensor>& outputTensors,
+    std::vector<at::Tensor>& inputTensors,
+    const AllToAllOptions& /* unused */) {
+  check_alltoall_tensors(outputTensors, inputTensors, size_);
+
+  // The collective runs on the stream of the device of the first input; the
+  // lambda sends and receives every tensor of the lists.
+  std::vector<at::Tensor> firstInput = {inputTensors[0]};
+  std::vector<at::Tensor> firstOutput = {outputTensors[0]};
+  return collective(firstInput, firstOutput,
+    [&] (at::Tensor& /* unused */, at::Tensor& /* unused */,
+         ncclComm_t comm, at::cuda::CUDAStream& stream) {
+      const auto type = getNcclDataType(inputTensors[0].scalar_type());
+      C10D_NCCL_CHECK(ncclGroupStart());
+      for (size_t r = 0; r < inputTensors.size(); ++r) {
+        // See [Sync Streams].
+        c10::cuda::CUDACachingAllocator::recordStream(
+          inputTensors[r].storage().data(), stream);
+        c10::cuda::CUDACachingAllocator::recordStream(
+          outputTensors[r].storage().data(), stream);
+        if (inputTensors[r].numel() > 0) {
+          C10D_NCCL_CHECK(ncclSend(
+            inputTensors[r].data_ptr(),
+            inputTensors[r].numel(),
+            type,
+            r,
+            comm,
+            stream.stream()));
+        }
+        if (outputTensors[r].numel() > 0) {
+          C10D_NCCL_CHECK(ncclRecv(
+            outputTensors[r].data_ptr(),
+            outputTensors[r].numel(),
+            type,
+            r,
+            comm,
+            stream.stream()));
+        }
+      }
+      return ncclGroupEnd();
+    }
+  );
+}
+
+#else
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& /* unused */,
+    at::Tensor& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    const AllToAllOptions& /* unused */) {
+  throw std::runtime_error(
+    "ProcessGroupNCCL only supports alltoall with NCCL 2.7 or later");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const AllToAllOptions& /* unused */) {
+  throw std::runtime_error(
+    "ProcessGroupNCCL only supports alltoall with NCCL 2.7 or later");
+}
+
+#endif
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::barrier(
     const BarrierOptions& opts) {
   std::vector<at::Device> devices;
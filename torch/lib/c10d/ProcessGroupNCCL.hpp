@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <mutex>
 #include <unordered_map>
 
@@ -119,6 +120,21 @@ class ProcessGroupNCCL : public ProcessGroup {
 
   virtual ~ProcessGroupNCCL();
 
+  // Creates the NCCL communicators for a list of devices now instead of in
+  // the first collective on tensors on these devices, which would otherwise
+  // pay for the exchange of the NCCL ID through the store and for
+  // ncclCommInitRank on every device. Like a collective, it must be called by
+  // every rank, with the same number of devices. As for the tensor lists of
+  // the collectives, the order of the devices matters.
+  void warmup(const std::vector<at::Device>& devices);
+
+  // Time taken to create the NCCL communicators of every device list used so
+  // far, keyed by the comma-separated device indices (see devNCCLCommMap_).
+  std::unordered_map<std::string, std::chrono::microseconds> getCommInitTimes()
+      const {
+    return commInitTimes_;
+  }
+
   std::shared_ptr<ProcessGroup::Work> broadcast(
       std::vector<at::Tensor>& tensors,
       const BroadcastOptions& opts = BroadcastOptions()) override;
@@ -127,6 +143,11 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const AllreduceOptions& opts = AllreduceOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) override;
@@ -141,6 +162,18 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputTensors,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> alltoall(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> barrier(
       const BarrierOptions& opts = BarrierOptions()) override;
 
@@ -235,6 +268,10 @@ class ProcessGroupNCCL : public ProcessGroup {
   // The CUDA events used to sync NCCL streams
   std::unordered_map<std::string, std::vector<at::cuda::CUDAEvent>> ncclEvents_;
 
+  // Time taken by getNCCLComm to create the communicators of every key of
+  // devNCCLCommMap_, including the exchange of the NCCL ID
+  std::unordered_map<std::string, std::chrono::microseconds> commInitTimes_;
+
   // ID of this process group
   std::string processGroupID_;
 
@@ -35,6 +35,16 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Gets or sets several keys at once. The default implementations call get
+  // and set for every key; stores that talk to a server override them to
+  // batch the requests.
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
@@ -1,23 +1,129 @@
 #include <c10d/TCPStore.hpp>
 
+#include <fcntl.h>
 #include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #include <unistd.h>
 #include <algorithm>
+#include <cstring>
 #include <system_error>
 
 namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_GET,
+  MULTI_SET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+// Size of the chunks read from the sockets, and maximal number of events
+// handled per iteration of the daemon's loop
+constexpr size_t kRecvChunkSize = 64 * 1024;
+constexpr int kMaxEvents = 256;
+
+// Thrown by QueryReader when the buffer ends in the middle of a query
+struct IncompleteQuery {};
+
+// Appends values in the format read by tcputil::recv*, so that a whole query
+// or response is sent with a single call.
+template <typename T>
+void appendValue(std::vector<uint8_t>& buffer, const T& value) {
+  auto bytes = reinterpret_cast<const uint8_t*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+void appendBytes(std::vector<uint8_t>& buffer, const void* data, size_t size) {
+  appendValue<SizeType>(buffer, size);
+  auto bytes = reinterpret_cast<const uint8_t*>(data);
+  buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void appendString(std::vector<uint8_t>& buffer, const std::string& str) {
+  appendBytes(buffer, str.data(), str.size());
+}
+
+void setNonBlocking(int socket) {
+  int flags;
+  SYSCHECK_ERR_RETURN_NEG1(flags = ::fcntl(socket, F_GETFL));
+  SYSCHECK_ERR_RETURN_NEG1(::fcntl(socket, F_SETFL, flags | O_NONBLOCK));
+}
+
 } // anonymous namespace
 
+class TCPStoreDaemon::QueryReader {
+ public:
+  QueryReader(const uint8_t* data, size_t size)
+      : data_(data), size_(size), offset_(0) {}
+
+  template <typename T>
+  T readValue() {
+    require(sizeof(T));
+    T value;
+    std::memcpy(&value, data_ + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return value;
+  }
+
+  std::string readString() {
+    const auto size = readValue<SizeType>();
+    require(size);
+    std::string str(reinterpret_cast<const char*>(data_ + offset_), size);
+    offset_ += size;
+    return str;
+  }
+
+  std::vector<uint8_t> readVector() {
+    const auto size = readValue<SizeType>();
+    require(size);
+    std::vector<uint8_t> vec(data_ + offset_, data_ + offset_ + size);
+    offset_ += size;
+    return vec;
+  }
+
+  std::vector<std::string> readKeys() {
+    const auto nargs = readValue<SizeType>();
+    std::vector<std::string> keys;
+    // Don't trust nargs with the allocation before the keys have arrived
+    keys.reserve(std::min<SizeType>(nargs, remaining() / sizeof(SizeType)));
+    for (SizeType i = 0; i < nargs; ++i) {
+      keys.push_back(readString());
+    }
+    return keys;
+  }
+
+  size_t offset() const {
+    return offset_;
+  }
+
+  size_t remaining() const {
+    return size_ - offset_;
+  }
+
+ private:
+  void require(size_t size) const {
+    if (size > remaining()) {
+      throw IncompleteQuery();
+    }
+  }
+
+  const uint8_t* data_;
+  size_t size_;
+  size_t offset_;
+};
+
 // TCPStoreDaemon class methods
 // Simply start the daemon thread
 TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket)
@@ -28,6 +134,14 @@ TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket)
         "Failed to create the control pipe to start the "
         "TCPStoreDaemon run");
   }
+  // Only the daemon accepts connections, and it accepts them until there are
+  // no more pending
+  setNonBlocking(storeListenSocket_);
+#ifdef __linux__
+  SYSCHECK_ERR_RETURN_NEG1(epollFd_ = ::epoll_create1(EPOLL_CLOEXEC));
+  watch(storeListenSocket_);
+  watch(controlPipeFd_[0]);
+#endif
   daemonThread_ = std::thread(&TCPStoreDaemon::run, this);
 }
 
@@ -37,10 +151,11 @@ TCPStoreDaemon::~TCPStoreDaemon() {
   // Join the thread
   join();
   // Close unclosed sockets
-  for (auto socket : sockets_) {
-    if (socket != -1) {
-      ::close(socket);
-    }
+  for (auto& it : connections_) {
+    ::close(it.first);
+  }
+  if (epollFd_ != -1) {
+    ::close(epollFd_);
   }
   // Now close the rest control pipe
   for (auto fd : controlPipeFd_) {
@@ -54,104 +169,162 @@ void TCPStoreDaemon::join() {
   daemonThread_.join();
 }
 
+void TCPStoreDaemon::watch(int socket) {
+#ifdef __linux__
+  struct epoll_event event;
+  std::memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.fd = socket;
+  SYSCHECK_ERR_RETURN_NEG1(
+      ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, socket, &event));
+#endif
+}
+
+// Only the sockets whose send buffer is full are polled for writability
+void TCPStoreDaemon::setWritable(int socket, bool writable) {
+#ifdef __linux__
+  struct epoll_event event;
+  std::memset(&event, 0, sizeof(event));
+  event.events = writable ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+  event.data.fd = socket;
+  SYSCHECK_ERR_RETURN_NEG1(
+      ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, socket, &event));
+#endif
+}
+
 void TCPStoreDaemon::run() {
+  // (fd, revents) of the sockets that have an event, with POLL* flags
+  std::vector<std::pair<int, short>> events;
+#ifdef __linux__
+  std::vector<struct epoll_event> epollEvents(kMaxEvents);
+#else
   std::vector<struct pollfd> fds;
-  fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
-  // Push the read end of the pipe to signal the stopping of the daemon run
-  fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
+#endif
 
   // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
+  while (true) {
+    events.clear();
+#ifdef __linux__
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents =
+            ::epoll_wait(epollFd_, epollEvents.data(), kMaxEvents, -1));
+    for (int i = 0; i < numEvents; ++i) {
+      const auto flags = epollEvents[i].events;
+      short revents = 0;
+      revents |= (flags & EPOLLIN) ? POLLIN : 0;
+      revents |= (flags & EPOLLOUT) ? POLLOUT : 0;
+      revents |= (flags & EPOLLHUP) ? POLLHUP : 0;
+      revents |= (flags & EPOLLERR) ? POLLERR : 0;
+      const int fd = epollEvents[i].data.fd;
+      events.emplace_back(fd, revents);
+    }
+#else
+    fds.clear();
+    fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
+    // Push the read end of the pipe to signal the stopping of the daemon run
+    fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
+    for (const auto& it : connections_) {
+      short flags = it.second.blocked ? (POLLIN | POLLOUT) : POLLIN;
+      fds.push_back({.fd = it.first, .events = flags});
     }
-
     SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
-
-    // TCPStore's listening socket has an event and it should now be able to
-    // accept new connections.
-    if (fds[0].revents != 0) {
-      if (fds[0].revents ^ POLLIN) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the master's listening socket: " +
-                std::to_string(fds[0].revents));
+    for (const auto& fd : fds) {
+      if (fd.revents != 0) {
+        events.emplace_back(fd.fd, fd.revents);
       }
-      int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
     }
-    // The pipe receives an event which tells us to shutdown the daemon
-    if (fds[1].revents != 0) {
-      // Will be POLLUP when the pipe is closed
-      if (fds[1].revents ^ POLLHUP) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the control pipe's reading fd: " +
-                std::to_string(fds[1].revents));
+#endif
+
+    for (const auto& event : events) {
+      const int fd = event.first;
+      const short revents = event.second;
+      // The pipe receives an event which tells us to shutdown the daemon,
+      // it will be POLLHUP when the pipe is closed
+      if (fd == controlPipeFd_[0]) {
+        if (revents ^ POLLHUP) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected poll revent on the control pipe's reading fd: " +
+                  std::to_string(revents));
+        }
+        return;
       }
-      finished = true;
-      break;
-    }
-    // Skipping the fds[0] and fds[1],
-    // fds[0] is master's listening socket
-    // fds[1] is control pipe's reading fd
-    for (size_t fdIdx = 2; fdIdx < fds.size(); ++fdIdx) {
-      if (fds[fdIdx].revents == 0) {
+      // TCPStore's listening socket has an event and it should now be able
+      // to accept new connections.
+      if (fd == storeListenSocket_) {
+        if (revents ^ POLLIN) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected poll revent on the master's listening socket: " +
+                  std::to_string(revents));
+        }
+        acceptConnections();
         continue;
       }
 
-      if (fds[fdIdx].revents ^ POLLIN) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent: " + std::to_string(fds[fdIdx].revents) +
-                " on socket: " + std::to_string(fds[fdIdx].fd));
+      auto it = connections_.find(fd);
+      if (it == connections_.end()) {
+        // Closed earlier in this iteration
+        continue;
       }
-      // Now query the socket that has the event
+      // There was an error when processing the socket. Probably recv/send
+      // failed, what would indicate that the socket on the other side has
+      // been closed. If the closing was due to normal exit, then the store
+      // should continue executing. Otherwise, if it was different
+      // exception, other connections will get an exception once they try to
+      // use the store. We will go ahead and close this connection whenever
+      // we hit an exception here.
       try {
-        query(fds[fdIdx].fd);
-      } catch (...) {
-        // There was an error when processing query. Probably an exception
-        // occurred in recv/send what would indicate that socket on the other
-        // side has been closed. If the closing was due to normal exit, then
-        // the store should continue executing. Otherwise, if it was different
-        // exception, other connections will get an exception once they try to
-        // use the store. We will go ahead and close this connection whenever
-        // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
+        auto& conn = it->second;
+        if ((revents & POLLOUT) && conn.blocked) {
+          flush(fd, conn);
         }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
+        if (revents & (POLLIN | POLLHUP | POLLERR)) {
+          // A client may close its socket right after its last queries, so
+          // they are handled before the connection is closed
+          const bool open = receive(fd, conn);
+          processQueries(fd, conn);
+          if (!open) {
+            closeConnection(fd);
           }
         }
-        fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
-        --fdIdx;
+      } catch (...) {
+        closeConnection(fd);
+      }
+    }
+
+    // Answering waits may let their clients' next queries through, which
+    // may in turn answer other waits
+    while (!resumedSockets_.empty()) {
+      const int fd = resumedSockets_.back();
+      resumedSockets_.pop_back();
+      auto it = connections_.find(fd);
+      if (it == connections_.end()) {
         continue;
       }
+      try {
+        processQueries(fd, it->second);
+      } catch (...) {
+        closeConnection(fd);
+      }
     }
+
+    for (const int fd : dirtySockets_) {
+      auto it = connections_.find(fd);
+      if (it == connections_.end()) {
+        continue;
+      }
+      it->second.dirty = false;
+      try {
+        flush(fd, it->second);
+      } catch (...) {
+        closeConnection(fd);
+      }
+    }
+    dirtySockets_.clear();
   }
 }
 
@@ -163,108 +336,278 @@ void TCPStoreDaemon::stop() {
   }
 }
 
+void TCPStoreDaemon::acceptConnections() {
+  while (true) {
+    int socket = ::accept(storeListenSocket_, nullptr, nullptr);
+    if (socket == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return;
+      }
+      throw std::system_error(errno, std::system_category());
+    }
+    ResourceGuard socketGuard([socket]() { ::close(socket); });
+    setNonBlocking(socket);
+    tcputil::setSocketNoDelay(socket);
+    watch(socket);
+    socketGuard.release();
+    connections_.emplace(socket, Connection());
+  }
+}
+
+void TCPStoreDaemon::closeConnection(int socket) {
+  auto it = connections_.find(socket);
+  if (it == connections_.end()) {
+    return;
+  }
+  // Remove all the tracking state of the closed socket. Only the keys of its
+  // pending wait can refer to it.
+  for (const auto& key : it->second.awaitedKeys) {
+    auto waiting = waitingSockets_.find(key);
+    if (waiting == waitingSockets_.end()) {
+      continue;
+    }
+    auto& sockets = waiting->second;
+    sockets.erase(
+        std::remove(sockets.begin(), sockets.end(), socket), sockets.end());
+    if (sockets.empty()) {
+      waitingSockets_.erase(waiting);
+    }
+  }
+  connections_.erase(it);
+  // Closing the socket also removes it from the epoll set
+  ::close(socket);
+}
+
+// Reads everything available on the socket, returns false if it was closed
+// or failed.
+bool TCPStoreDaemon::receive(int socket, Connection& conn) {
+  uint8_t chunk[kRecvChunkSize];
+  while (true) {
+    ssize_t bytesReceived = ::recv(socket, chunk, sizeof(chunk), 0);
+    if (bytesReceived == 0) {
+      return false;
+    }
+    if (bytesReceived == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return true;
+      }
+      return false;
+    }
+    conn.in.insert(conn.in.end(), chunk, chunk + bytesReceived);
+    if (static_cast<size_t>(bytesReceived) < sizeof(chunk)) {
+      return true;
+    }
+  }
+}
+
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of check, wait and multi_get
 // type of query | number of args | size of arg1 | arg1 | ...
-void TCPStoreDaemon::query(int socket) {
-  QueryType qt;
-  tcputil::recvBytes<QueryType>(socket, &qt, 1);
+// or, in the case of multi_set
+// type of query | number of keys | size of key1 | key1 | size of value1 | ...
+void TCPStoreDaemon::processQueries(int socket, Connection& conn) {
+  QueryReader reader(conn.in.data(), conn.in.size());
+  size_t consumed = 0;
+  // Handlers only act once their query has been read completely, so a query
+  // is simply parsed again from its start once more bytes have arrived.
+  try {
+    while (conn.keysAwaited == 0 && reader.remaining() > 0) {
+      query(socket, conn, reader);
+      consumed = reader.offset();
+    }
+  } catch (const IncompleteQuery&) {
+  }
+  conn.in.erase(conn.in.begin(), conn.in.begin() + consumed);
+}
+
+void TCPStoreDaemon::query(int socket, Connection& conn, QueryReader& reader) {
+  const auto qt = reader.readValue<QueryType>();
 
   if (qt == QueryType::SET) {
-    setHandler(socket);
+    setHandler(reader);
 
   } else if (qt == QueryType::ADD) {
-    addHandler(socket);
+    addHandler(conn, reader);
 
   } else if (qt == QueryType::GET) {
-    getHandler(socket);
+    getHandler(conn, reader);
 
   } else if (qt == QueryType::CHECK) {
-    checkHandler(socket);
+    checkHandler(conn, reader);
 
   } else if (qt == QueryType::WAIT) {
-    waitHandler(socket);
+    waitHandler(socket, conn, reader);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(conn, reader);
+
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(reader);
 
   } else {
     throw std::runtime_error("Unexpected query type");
   }
+  respond(socket, conn);
+}
+
+// Schedules the connection's buffered responses to be flushed at the end of
+// the current iteration.
+void TCPStoreDaemon::respond(int socket, Connection& conn) {
+  if (!conn.dirty && !conn.blocked && conn.out.size() > conn.outOffset) {
+    conn.dirty = true;
+    dirtySockets_.push_back(socket);
+  }
+}
+
+void TCPStoreDaemon::flush(int socket, Connection& conn) {
+  while (conn.outOffset < conn.out.size()) {
+    int flags = 0;
+#ifdef MSG_NOSIGNAL
+    flags |= MSG_NOSIGNAL;
+#endif
+    ssize_t bytesSent = ::send(
+        socket,
+        conn.out.data() + conn.outOffset,
+        conn.out.size() - conn.outOffset,
+        flags);
+    if (bytesSent == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // Wait for the client to drain its receive buffer
+        if (!conn.blocked) {
+          conn.blocked = true;
+          setWritable(socket, true);
+        }
+        return;
+      }
+      throw std::system_error(errno, std::system_category());
+    }
+    conn.outOffset += bytesSent;
+  }
+  conn.out.clear();
+  conn.outOffset = 0;
+  if (conn.blocked) {
+    conn.blocked = false;
+    setWritable(socket, false);
+  }
 }
 
 void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   auto socketsToWait = waitingSockets_.find(key);
   if (socketsToWait != waitingSockets_.end()) {
     for (int socket : socketsToWait->second) {
-      if (--keysAwaited_[socket] == 0) {
-        tcputil::sendValue<WaitResponseType>(
-            socket, WaitResponseType::STOP_WAITING);
+      auto it = connections_.find(socket);
+      if (it == connections_.end()) {
+        continue;
+      }
+      auto& conn = it->second;
+      if (--conn.keysAwaited == 0) {
+        conn.awaitedKeys.clear();
+        appendValue(conn.out, WaitResponseType::STOP_WAITING);
+        respond(socket, conn);
+        resumedSockets_.push_back(socket);
       }
     }
     waitingSockets_.erase(socketsToWait);
   }
 }
 
-void TCPStoreDaemon::setHandler(int socket) {
-  std::string key = tcputil::recvString(socket);
-  tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+void TCPStoreDaemon::setHandler(QueryReader& reader) {
+  std::string key = reader.readString();
+  tcpStore_[key] = reader.readVector();
   // On "set", wake up all clients that have been waiting
   wakeupWaitingClients(key);
 }
 
-void TCPStoreDaemon::addHandler(int socket) {
-  std::string key = tcputil::recvString(socket);
-  int64_t addVal = tcputil::recvValue<int64_t>(socket);
+void TCPStoreDaemon::multiSetHandler(QueryReader& reader) {
+  const auto nargs = reader.readValue<SizeType>();
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> items;
+  for (SizeType i = 0; i < nargs; ++i) {
+    auto key = reader.readString();
+    items.emplace_back(std::move(key), reader.readVector());
+  }
+  // Now we have received all the items
+  for (auto& item : items) {
+    tcpStore_[item.first] = std::move(item.second);
+    wakeupWaitingClients(item.first);
+  }
+}
+
+void TCPStoreDaemon::addHandler(Connection& conn, QueryReader& reader) {
+  std::string key = reader.readString();
+  int64_t addVal = reader.readValue<int64_t>();
 
-  if (tcpStore_.find(key) != tcpStore_.end()) {
-    auto buf = reinterpret_cast<const char*>(tcpStore_[key].data());
-    auto len = tcpStore_[key].size();
+  auto it = tcpStore_.find(key);
+  if (it != tcpStore_.end()) {
+    auto buf = reinterpret_cast<const char*>(it->second.data());
+    auto len = it->second.size();
     addVal += std::stoll(std::string(buf, len));
   }
   auto addValStr = std::to_string(addVal);
   tcpStore_[key] = std::vector<uint8_t>(addValStr.begin(), addValStr.end());
   // Now send the new value
-  tcputil::sendValue<int64_t>(socket, addVal);
+  appendValue<int64_t>(conn.out, addVal);
   // On "add", wake up all clients that have been waiting
   wakeupWaitingClients(key);
 }
 
-void TCPStoreDaemon::getHandler(int socket) const {
-  std::string key = tcputil::recvString(socket);
-  auto data = tcpStore_.at(key);
-  tcputil::sendVector<uint8_t>(socket, data);
+void TCPStoreDaemon::getHandler(Connection& conn, QueryReader& reader) const {
+  std::string key = reader.readString();
+  const auto& data = tcpStore_.at(key);
+  appendBytes(conn.out, data.data(), data.size());
 }
 
-void TCPStoreDaemon::checkHandler(int socket) const {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
+void TCPStoreDaemon::multiGetHandler(Connection& conn, QueryReader& reader)
+    const {
+  const auto keys = reader.readKeys();
+  // Look all the keys up before answering, so that a missing key doesn't
+  // leave a partial response behind
+  std::vector<const std::vector<uint8_t>*> values;
+  values.reserve(keys.size());
+  for (const auto& key : keys) {
+    values.push_back(&tcpStore_.at(key));
   }
+  for (const auto value : values) {
+    appendBytes(conn.out, value->data(), value->size());
+  }
+}
+
+void TCPStoreDaemon::checkHandler(Connection& conn, QueryReader& reader)
+    const {
+  const auto keys = reader.readKeys();
   // Now we have received all the keys
   if (checkKeys(keys)) {
-    tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::READY);
+    appendValue(conn.out, CheckResponseType::READY);
   } else {
-    tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::NOT_READY);
+    appendValue(conn.out, CheckResponseType::NOT_READY);
   }
 }
 
-void TCPStoreDaemon::waitHandler(int socket) {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
-  }
-  if (checkKeys(keys)) {
-    tcputil::sendValue<WaitResponseType>(
-        socket, WaitResponseType::STOP_WAITING);
-  } else {
-    for (auto& key : keys) {
+void TCPStoreDaemon::waitHandler(
+    int socket,
+    Connection& conn,
+    QueryReader& reader) {
+  const auto keys = reader.readKeys();
+  // Only wait on the keys that are missing, the others were already set
+  for (const auto& key : keys) {
+    if (tcpStore_.count(key) == 0) {
       waitingSockets_[key].push_back(socket);
+      conn.awaitedKeys.push_back(key);
     }
-    keysAwaited_[socket] = keys.size();
+  }
+  conn.keysAwaited = conn.awaitedKeys.size();
+  if (conn.keysAwaited == 0) {
+    appendValue(conn.out, WaitResponseType::STOP_WAITING);
   }
 }
 
@@ -398,6 +741,50 @@ void TCPStore::wait(
   waitHelper_(regKeys, timeout);
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.reserve(keys.size());
+  for (const auto& key : keys) {
+    regKeys.push_back(regularPrefix_ + key);
+  }
+  waitHelper_(regKeys, timeout_);
+
+  std::vector<uint8_t> buffer;
+  appendValue(buffer, QueryType::MULTI_GET);
+  appendValue<SizeType>(buffer, regKeys.size());
+  for (const auto& regKey : regKeys) {
+    appendString(buffer, regKey);
+  }
+  tcputil::sendBytes<uint8_t>(storeSocket_, buffer.data(), buffer.size());
+
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(regKeys.size());
+  for (size_t i = 0; i < regKeys.size(); ++i) {
+    values.push_back(tcputil::recvVector<uint8_t>(storeSocket_));
+  }
+  return values;
+}
+
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet expects as many values as keys, got " +
+        std::to_string(values.size()) + " values for " +
+        std::to_string(keys.size()) + " keys");
+  }
+  std::vector<uint8_t> buffer;
+  appendValue(buffer, QueryType::MULTI_SET);
+  appendValue<SizeType>(buffer, keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    appendString(buffer, regularPrefix_ + keys[i]);
+    appendBytes(buffer, values[i].data(), values[i].size());
+  }
+  tcputil::sendBytes<uint8_t>(storeSocket_, buffer.data(), buffer.size());
+}
+
 void TCPStore::waitHelper_(
     const std::vector<std::string>& keys,
     const std::chrono::milliseconds& timeout) {
@@ -9,6 +9,11 @@
 
 namespace c10d {
 
+// Serves the store to all TCPStore clients from a single thread. Sockets are
+// non-blocking and multiplexed with epoll (poll on other platforms), so a
+// client that sends a query in several pieces never stalls the others. The
+// responses produced while handling one batch of events are buffered per
+// client and flushed with a single send each.
 class TCPStoreDaemon {
  public:
   explicit TCPStoreDaemon(int storeListenSocket);
@@ -17,16 +22,49 @@ class TCPStoreDaemon {
   void join();
 
  protected:
+  // Parses queries out of a connection's input buffer, defined in
+  // TCPStore.cpp.
+  class QueryReader;
+
+  struct Connection {
+    // Received bytes that don't form a complete query yet
+    std::vector<uint8_t> in;
+    // Responses that haven't been sent yet, starting at outOffset
+    std::vector<uint8_t> out;
+    size_t outOffset = 0;
+    // Set when out is waiting in dirtySockets_ to be flushed
+    bool dirty = false;
+    // Set when the socket's send buffer is full and we wait for it to
+    // become writable again
+    bool blocked = false;
+    // Keys the pending wait query is registered on, and how many of them
+    // still have to be set. Queries received after a wait are only
+    // processed once it has been answered, to keep the responses in order.
+    std::vector<std::string> awaitedKeys;
+    size_t keysAwaited = 0;
+  };
+
   void run();
   void stop();
 
-  void query(int socket);
-
-  void setHandler(int socket);
-  void addHandler(int socket);
-  void getHandler(int socket) const;
-  void checkHandler(int socket) const;
-  void waitHandler(int socket);
+  void watch(int socket);
+  void setWritable(int socket, bool writable);
+  void acceptConnections();
+  void closeConnection(int socket);
+
+  bool receive(int socket, Connection& conn);
+  void processQueries(int socket, Connection& conn);
+  void query(int socket, Connection& conn, QueryReader& reader);
+  void respond(int socket, Connection& conn);
+  void flush(int socket, Connection& conn);
+
+  void setHandler(QueryReader& reader);
+  void multiSetHandler(QueryReader& reader);
+  void addHandler(Connection& conn, QueryReader& reader);
+  void getHandler(Connection& conn, QueryReader& reader) const;
+  void multiGetHandler(Connection& conn, QueryReader& reader) const;
+  void checkHandler(Connection& conn, QueryReader& reader) const;
+  void waitHandler(int socket, Connection& conn, QueryReader& reader);
 
   bool checkKeys(const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
@@ -35,11 +73,14 @@ class TCPStoreDaemon {
   std::unordered_map<std::string, std::vector<uint8_t>> tcpStore_;
   // From key -> the list of sockets waiting on it
   std::unordered_map<std::string, std::vector<int>> waitingSockets_;
-  // From socket -> number of keys awaited
-  std::unordered_map<int, size_t> keysAwaited_;
 
-  std::vector<int> sockets_;
+  std::unordered_map<int, Connection> connections_;
+  // Sockets with responses to flush at the end of the current iteration
+  std::vector<int> dirtySockets_;
+  // Sockets whose wait was answered and that may have more queries buffered
+  std::vector<int> resumedSockets_;
   int storeListenSocket_;
+  int epollFd_ = -1;
   std::vector<int> controlPipeFd_{-1, -1};
 };
 
@@ -67,6 +108,15 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  // Both take a single round trip to the daemon, after waiting for the keys
+  // in the case of multiGet.
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
  protected:
   int64_t addHelper_(const std::string& key, int64_t value);
   std::vector<uint8_t> getHelper_(const std::string& key);
@@ -26,6 +26,8 @@ struct AllreduceOptions {
   std::chrono::milliseconds timeout = kUnsetTimeout;
 };
 
+struct AllreduceCoalescedOptions : AllreduceOptions {};
+
 struct ReduceOptions {
   ReduceOp reduceOp = ReduceOp::SUM;
   int rootRank = 0;
@@ -52,6 +54,10 @@ struct ReduceScatterOptions {
   std::chrono::milliseconds timeout = kUnsetTimeout;
 };
 
+struct AllToAllOptions {
+  std::chrono::milliseconds timeout = kUnsetTimeout;
+};
+
 struct BarrierOptions {
   std::chrono::milliseconds timeout = kUnsetTimeout;
 };
@@ -19,16 +19,19 @@
 namespace c10d {
 namespace tcputil {
 
-namespace {
-
-constexpr int LISTEN_QUEUE_SIZE = 64;
-
 void setSocketNoDelay(int socket) {
   int flag = 1;
   socklen_t optlen = sizeof(flag);
   SYSCHECK_ERR_RETURN_NEG1(setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, (char*)&flag, optlen));
 }
 
+namespace {
+
+// All the workers of a large job connect to the store at about the same time,
+// and connections that overflow the queue may be reset or stalled by the
+// kernel. The effective size is capped by net.core.somaxconn.
+constexpr int LISTEN_QUEUE_SIZE = 2048;
+
 PortType getSocketPort(int fd) {
   PortType listenPort;
   struct ::sockaddr_storage addrStorage;
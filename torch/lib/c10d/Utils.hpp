@@ -3,6 +3,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -218,6 +219,38 @@ inline at::Tensor flattenDenseTensors(at::TensorList tensors) {
   return at::cat(::c10d::fmap(tensors, flatten));
 }
 
+// Copies consecutive chunks of a flat tensor, as returned by
+// flattenDenseTensors, back into the tensors.
+inline void unflattenDenseTensors(
+    const at::Tensor& flat,
+    std::vector<at::Tensor>& tensors) {
+  int64_t offset = 0;
+  for (auto& tensor : tensors) {
+    const auto numel = tensor.numel();
+    tensor.copy_(flat.narrow(0, offset, numel).view(tensor.sizes()));
+    offset += numel;
+  }
+}
+
+// Groups the tensors by scalar type, in order of first appearance, for the
+// coalesced collectives that use one flat buffer per type.
+inline std::vector<std::vector<at::Tensor>> groupByScalarType(
+    const std::vector<at::Tensor>& tensors) {
+  std::vector<at::ScalarType> types;
+  std::vector<std::vector<at::Tensor>> groups;
+  for (const auto& tensor : tensors) {
+    const auto it =
+        std::find(types.begin(), types.end(), tensor.scalar_type());
+    if (it == types.end()) {
+      types.push_back(tensor.scalar_type());
+      groups.push_back({tensor});
+    } else {
+      groups[it - types.begin()].push_back(tensor);
+    }
+  }
+  return groups;
+}
+
 inline at::Tensor newLikeFlat(
     std::vector<std::vector<at::Tensor>>& tensors,
     size_t deviceIdx) {
@@ -251,6 +284,52 @@ inline at::Tensor newLikeFlat(std::vector<at::Tensor>& tensors) {
   return at::empty(sizes, t.options());
 }
 
+// Splits a tensor along its first dimension into one chunk per rank, as the
+// all-to-all collectives do, and returns the number of elements of each chunk
+// and its offset (in elements) in the tensor. An empty splitSizes splits the
+// tensor evenly.
+inline void computeLengthsAndOffsets(
+    const std::vector<int64_t>& splitSizes,
+    const at::Tensor& tensor,
+    int groupSize,
+    std::vector<int64_t>* lengths,
+    std::vector<int64_t>* offsets) {
+  const int64_t dimSize = tensor.dim() == 0 ? 1 : tensor.size(0);
+  const int64_t rowSize = dimSize == 0 ? 0 : tensor.numel() / dimSize;
+  lengths->resize(groupSize);
+  offsets->resize(groupSize);
+  if (splitSizes.empty()) {
+    if (dimSize % groupSize != 0) {
+      throw std::runtime_error(
+          "Tensor's first dimension must be divisible by group size");
+    }
+    for (int i = 0; i < groupSize; i++) {
+      (*lengths)[i] = dimSize / groupSize * rowSize;
+    }
+  } else {
+    if (splitSizes.size() != static_cast<size_t>(groupSize)) {
+      throw std::runtime_error("Number of split sizes must equal group size");
+    }
+    int64_t total = 0;
+    for (int i = 0; i < groupSize; i++) {
+      if (splitSizes[i] < 0) {
+        throw std::runtime_error("Split sizes must be non-negative");
+      }
+      total += splitSizes[i];
+      (*lengths)[i] = splitSizes[i] * rowSize;
+    }
+    if (total != dimSize) {
+      throw std::runtime_error(
+          "Split sizes must sum to the tensor's first dimension");
+    }
+  }
+  int64_t offset = 0;
+  for (int i = 0; i < groupSize; i++) {
+    (*offsets)[i] = offset;
+    offset += (*lengths)[i];
+  }
+}
+
 inline std::vector<std::vector<int64_t>> getSizes(
     const std::vector<at::Tensor>& tensors) {
   std::vector<std::vector<int64_t>> sizes(tensors.size());
@@ -451,6 +530,8 @@ inline std::string recvString(int socket) {
 }
 
 // Other helpers
+void setSocketNoDelay(int socket);
+
 std::string sockaddrToString(struct sockaddr* addr);
 
 std::pair<int, PortType> listen(PortType port);
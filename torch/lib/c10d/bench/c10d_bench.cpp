@@ -0,0 +1,436 @@
+// Measures the latency and bandwidth of c10d collectives.
+//
+// Start one process per rank. Ranks rendezvous through a FileStore or a
+// TCPStore (rank 0 runs the server), e.g. for 2 ranks on one host:
+//
+//   RANK=0 SIZE=2 ./c10d_bench --backend=gloo --store=file:/tmp/bench &
+//   RANK=1 SIZE=2 ./c10d_bench --backend=gloo --store=file:/tmp/bench
+//
+// With --backend=mpi, launch through mpirun instead; rank and size then come
+// from MPI and no store is used.
+//
+// Message sizes are per rank. Like nccl-tests, algbw is the size divided by
+// the time per iteration (using the gathered output size for allgather) and
+// busbw scales algbw to the traffic on the busiest link, so it can be compared
+// against the peak bandwidth of the fabric. Times are measured on rank 0.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gloo/transport/tcp/device.h>
+
+#include <c10d/FileStore.hpp>
+#include <c10d/ProcessGroupGloo.hpp>
+#include <c10d/TCPStore.hpp>
+
+#ifdef USE_C10D_MPI
+#include <c10d/ProcessGroupMPI.hpp>
+#endif
+
+#ifdef USE_C10D_NCCL
+#include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+#include <c10d/ProcessGroupNCCL.hpp>
+#endif
+
+using namespace ::c10d;
+
+namespace {
+
+struct Options {
+  std::string backend = "gloo";
+  std::string store = "file:/tmp/c10d_bench";
+  std::string iface;
+  std::vector<std::string> ops = {"allreduce", "allgather", "broadcast",
+                                  "sendrecv"};
+  std::string dtype = "float";
+  int64_t minBytes = 8;
+  int64_t maxBytes = 64 << 20;
+  int64_t stepFactor = 2;
+  int warmup = 5;
+  int iters = 20;
+  // Split every message into this many tensors, like DDP buckets
+  int numTensors = 1;
+  // Transfer the tensors as one coalesced bucket instead of one by one
+  bool coalesce = false;
+};
+
+void usage(const char* argv0) {
+  std::cerr
+      << "usage: " << argv0 << " [options]\n"
+      << "  --backend=gloo|nccl|mpi     process group backend (gloo)\n"
+      << "  --store=file:PATH|tcp:HOST:PORT\n"
+      << "                              rendezvous store (file:/tmp/c10d_bench)\n"
+      << "  --iface=NAME                network interface for gloo\n"
+      << "  --ops=OP[,OP...]            allreduce,allgather,broadcast,sendrecv\n"
+      << "  --dtype=float|double|half|int|long\n"
+      << "  --min-bytes=N --max-bytes=N --step-factor=N\n"
+      << "                              message sizes to sweep (8 B to 64 MB)\n"
+      << "  --warmup=N --iters=N        iterations per size (5, 20)\n"
+      << "  --num-tensors=N             split each message into N tensors (1)\n"
+      << "  --coalesce                  send the tensors as one bucket\n"
+      << "Rank and world size are read from RANK and SIZE (or WORLD_SIZE).\n";
+}
+
+std::vector<std::string> split(const std::string& s, char delim) {
+  std::vector<std::string> parts;
+  std::stringstream ss(s);
+  std::string part;
+  while (std::getline(ss, part, delim)) {
+    if (!part.empty()) {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+
+Options parseOptions(int argc, char** argv) {
+  Options opts;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const auto eq = arg.find('=');
+    const auto key = arg.substr(0, eq);
+    const auto value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--backend") {
+      opts.backend = value;
+    } else if (key == "--store") {
+      opts.store = value;
+    } else if (key == "--iface") {
+      opts.iface = value;
+    } else if (key == "--ops") {
+      opts.ops = split(value, ',');
+    } else if (key == "--dtype") {
+      opts.dtype = value;
+    } else if (key == "--min-bytes") {
+      opts.minBytes = std::stoll(value);
+    } else if (key == "--max-bytes") {
+      opts.maxBytes = std::stoll(value);
+    } else if (key == "--step-factor") {
+      opts.stepFactor = std::stoll(value);
+    } else if (key == "--warmup") {
+      opts.warmup = std::stoi(value);
+    } else if (key == "--iters") {
+      opts.iters = std::stoi(value);
+    } else if (key == "--num-tensors") {
+      opts.numTensors = std::stoi(value);
+    } else if (key == "--coalesce") {
+      opts.coalesce = true;
+    } else {
+      usage(argv[0]);
+      std::exit(key == "--help" ? 0 : 1);
+    }
+  }
+  if (opts.minBytes <= 0 || opts.maxBytes < opts.minBytes ||
+      opts.stepFactor < 2 || opts.iters <= 0 || opts.numTensors <= 0) {
+    usage(argv[0]);
+    std::exit(1);
+  }
+  return opts;
+}
+
+at::ScalarType parseDtype(const std::string& dtype) {
+  if (dtype == "float") {
+    return at::kFloat;
+  } else if (dtype == "double") {
+    return at::kDouble;
+  } else if (dtype == "half") {
+    return at::kHalf;
+  } else if (dtype == "int") {
+    return at::kInt;
+  } else if (dtype == "long") {
+    return at::kLong;
+  }
+  throw std::invalid_argument("Unknown dtype: " + dtype);
+}
+
+int getEnvInt(const char* name, const char* fallback) {
+  const char* value = std::getenv(name);
+  if (value == nullptr && fallback != nullptr) {
+    value = std::getenv(fallback);
+  }
+  if (value == nullptr) {
+    throw std::runtime_error(std::string("Environment variable not set: ") +
+        name);
+  }
+  return std::stoi(value);
+}
+
+std::shared_ptr<Store> createStore(
+    const Options& opts,
+    int rank,
+    int size) {
+  const auto colon = opts.store.find(':');
+  const auto kind = opts.store.substr(0, colon);
+  const auto address =
+      colon == std::string::npos ? "" : opts.store.substr(colon + 1);
+  if (kind == "file") {
+    return std::make_shared<FileStore>(address, size);
+  } else if (kind == "tcp") {
+    const auto portPos = address.rfind(':');
+    if (portPos == std::string::npos) {
+      throw std::invalid_argument("TCP store needs HOST:PORT: " + address);
+    }
+    return std::make_shared<TCPStore>(
+        address.substr(0, portPos),
+        static_cast<PortType>(std::stoi(address.substr(portPos + 1))),
+        size,
+        rank == 0);
+  }
+  throw std::invalid_argument("Unknown store: " + opts.store);
+}
+
+std::shared_ptr<ProcessGroup> createProcessGroup(const Options& opts) {
+#ifdef USE_C10D_MPI
+  if (opts.backend == "mpi") {
+    return ProcessGroupMPI::createProcessGroupMPI();
+  }
+#endif
+  const auto rank = getEnvInt("RANK", nullptr);
+  const auto size = getEnvInt("SIZE", "WORLD_SIZE");
+  auto store = createStore(opts, rank, size);
+  if (opts.backend == "gloo") {
+    ProcessGroupGloo::Options options;
+    ::gloo::transport::tcp::attr attr;
+    attr.iface = opts.iface;
+    options.devices.push_back(::gloo::transport::tcp::CreateDevice(attr));
+    return std::make_shared<ProcessGroupGloo>(store, rank, size, options);
+  }
+#ifdef USE_C10D_NCCL
+  if (opts.backend == "nccl") {
+    return std::make_shared<ProcessGroupNCCL>(store, rank, size);
+  }
+#endif
+  throw std::invalid_argument("Unsupported backend: " + opts.backend);
+}
+
+// Bus bandwidth correction factors, see the nccl-tests performance notes.
+double busBandwidthFactor(const std::string& op, int size) {
+  if (op == "allreduce") {
+    return 2.0 * (size - 1) / size;
+  } else if (op == "allgather") {
+    return static_cast<double>(size - 1) / size;
+  }
+  return 1.0;
+}
+
+class Benchmark {
+ public:
+  Benchmark(const Options& opts, std::shared_ptr<ProcessGroup> pg)
+      : opts_(opts),
+        pg_(std::move(pg)),
+        rank_(pg_->getRank()),
+        size_(pg_->getSize()),
+        dtype_(parseDtype(opts.dtype)),
+        device_(at::kCPU) {
+#ifdef USE_C10D_NCCL
+    if (opts_.backend == "nccl") {
+      // One GPU per rank
+      device_ = at::Device(at::kCUDA, rank_ % c10::cuda::device_count());
+    }
+#endif
+  }
+
+  void run() {
+    if (rank_ == 0) {
+      std::printf(
+          "# backend %s, %d ranks, dtype %s, %d tensor(s)%s per message\n",
+          opts_.backend.c_str(),
+          size_,
+          opts_.dtype.c_str(),
+          opts_.numTensors,
+          opts_.coalesce ? " coalesced" : "");
+      std::printf(
+          "# %10s %12s %12s %12s %12s %12s\n",
+          "op",
+          "size(B)",
+          "count",
+          "time(us)",
+          "algbw(GB/s)",
+          "busbw(GB/s)");
+    }
+    for (const auto& op : opts_.ops) {
+      for (int64_t bytes = opts_.minBytes; bytes <= opts_.maxBytes;
+           bytes *= opts_.stepFactor) {
+        runOne(op, bytes);
+      }
+    }
+  }
+
+ private:
+  void runOne(const std::string& op, int64_t bytes) {
+    const int64_t elementSize = c10::elementSize(dtype_);
+    const int64_t count =
+        std::max<int64_t>(bytes / elementSize, opts_.numTensors);
+
+    std::function<void()> step;
+    try {
+      step = makeStep(op, count);
+      for (int i = 0; i < opts_.warmup; i++) {
+        step();
+      }
+    } catch (const std::exception& e) {
+      if (rank_ == 0) {
+        std::printf(
+            "  %10s %12lld  skipped: %s\n",
+            op.c_str(),
+            static_cast<long long>(count * elementSize),
+            e.what());
+      }
+      return;
+    }
+
+    pg_->barrier()->wait();
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < opts_.iters; i++) {
+      step();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const double us =
+        std::chrono::duration<double, std::micro>(end - start).count() /
+        opts_.iters;
+
+    if (rank_ == 0) {
+      const double messageBytes = count * elementSize;
+      const double algBytes =
+          op == "allgather" ? messageBytes * size_ : messageBytes;
+      // bytes per microsecond is 1e6 B/s, report GB/s
+      const double algbw = algBytes / us / 1e3;
+      const double busbw = algbw * busBandwidthFactor(op, size_);
+      std::printf(
+          "  %10s %12lld %12lld %12.2f %12.3f %12.3f\n",
+          op.c_str(),
+          static_cast<long long>(messageBytes),
+          static_cast<long long>(count),
+          us,
+          algbw,
+          busbw);
+      std::fflush(stdout);
+    }
+  }
+
+  std::vector<at::Tensor> makeTensors(int64_t count) {
+    std::vector<at::Tensor> tensors;
+    for (int i = 0; i < opts_.numTensors; i++) {
+      const int64_t n = count / opts_.numTensors +
+          (i < count % opts_.numTensors ? 1 : 0);
+      tensors.push_back(
+          at::ones({n}, at::TensorOptions(device_).dtype(dtype_)));
+    }
+    return tensors;
+  }
+
+  // Returns a function that runs one iteration of `op` on `count` elements
+  // per rank and waits for it to finish.
+  std::function<void()> makeStep(const std::string& op, int64_t count) {
+    auto tensors = makeTensors(count);
+    std::function<std::vector<std::shared_ptr<ProcessGroup::Work>>(
+        std::vector<at::Tensor>&)>
+        issue;
+
+    if (op == "allreduce") {
+      if (opts_.coalesce && tensors.size() > 1) {
+        return [this, tensors]() mutable {
+          finish({pg_->allreduce_coalesced(tensors)});
+        };
+      }
+      issue = [this](std::vector<at::Tensor>& inputs) {
+        return std::vector<std::shared_ptr<ProcessGroup::Work>>{
+            pg_->allreduce(inputs)};
+      };
+    } else if (op == "broadcast") {
+      issue = [this](std::vector<at::Tensor>& inputs) {
+        return std::vector<std::shared_ptr<ProcessGroup::Work>>{
+            pg_->broadcast(inputs)};
+      };
+    } else if (op == "allgather") {
+      issue = [this](std::vector<at::Tensor>& inputs) {
+        std::vector<std::vector<at::Tensor>> outputs(1);
+        for (int i = 0; i < size_; i++) {
+          outputs[0].push_back(at::empty_like(inputs[0]));
+        }
+        return std::vector<std::shared_ptr<ProcessGroup::Work>>{
+            pg_->allgather(outputs, inputs)};
+      };
+    } else if (op == "sendrecv") {
+      if (size_ < 2) {
+        throw std::invalid_argument("sendrecv needs at least 2 ranks");
+      }
+      // Every rank sends to the next one and receives from the previous one.
+      issue = [this](std::vector<at::Tensor>& inputs) {
+        std::vector<at::Tensor> recvTensors = {at::empty_like(inputs[0])};
+        auto recvWork = pg_->recv(recvTensors, (rank_ + size_ - 1) % size_, 0);
+        auto sendWork = pg_->send(inputs, (rank_ + 1) % size_, 0);
+        return std::vector<std::shared_ptr<ProcessGroup::Work>>{sendWork,
+                                                                recvWork};
+      };
+    } else {
+      throw std::invalid_argument("unknown op");
+    }
+
+    if (opts_.coalesce && tensors.size() > 1) {
+      // Copy the tensors into one bucket and back, as DDP does.
+      return [this, tensors, issue]() mutable {
+        std::vector<at::Tensor> bucket = {at::cat(tensors)};
+        finish(issue(bucket));
+        int64_t offset = 0;
+        for (auto& tensor : tensors) {
+          tensor.copy_(bucket[0].narrow(0, offset, tensor.numel()));
+          offset += tensor.numel();
+        }
+      };
+    }
+    return [this, tensors, issue]() mutable {
+      std::vector<std::shared_ptr<ProcessGroup::Work>> pending;
+      for (auto& tensor : tensors) {
+        std::vector<at::Tensor> inputs = {tensor};
+        for (auto& work : issue(inputs)) {
+          pending.push_back(std::move(work));
+        }
+      }
+      finish(pending);
+    };
+  }
+
+  void finish(const std::vector<std::shared_ptr<ProcessGroup::Work>>& pending) {
+    for (auto& work : pending) {
+      work->wait();
+    }
+#ifdef USE_C10D_NCCL
+    // NCCL work only makes the current stream wait for the collective
+    if (device_.is_cuda()) {
+      c10::cuda::CUDAGuard guard(device_);
+      c10::cuda::getCurrentCUDAStream().synchronize();
+    }
+#endif
+  }
+
+  const Options opts_;
+  std::shared_ptr<ProcessGroup> pg_;
+  const int rank_;
+  const int size_;
+  const at::ScalarType dtype_;
+  at::Device device_;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const auto opts = parseOptions(argc, argv);
+  try {
+    Benchmark bench(opts, createProcessGroup(opts));
+    bench.run();
+  } catch (const std::exception& e) {
+    std::cerr << "c10d_bench: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -22,6 +22,19 @@ void testHelper(const std::string& prefix = "") {
   c10d::test::check(serverStore, "key1", "value1");
   c10d::test::check(serverStore, "key2", "value2");
 
+  // Multi set/get on the server store
+  serverStore.multiSet(
+      {"key3", "key4"},
+      {std::vector<uint8_t>{'v', '3'}, std::vector<uint8_t>{'v', '4'}});
+  c10d::test::check(serverStore, "key3", "v3");
+  auto values = serverStore.multiGet({"key4", "key0", "key3"});
+  if (values.size() != 3 ||
+      std::string(values[0].begin(), values[0].end()) != "v4" ||
+      std::string(values[1].begin(), values[1].end()) != "value0" ||
+      std::string(values[2].begin(), values[2].end()) != "v3") {
+    throw std::runtime_error("Unexpected multiGet result");
+  }
+
   // Hammer on TCPStore
   std::vector<std::thread> threads;
   const auto numIterations = 1000;
@@ -53,6 +66,15 @@ void testHelper(const std::string& prefix = "") {
             c10d::test::check(*clientStores[i], key, val);
           }
 
+          // Wait for the keys of the other threads, which wakes up the
+          // waiting clients as they get set
+          std::vector<std::string> keys;
+          for (auto j = 0; j < numThreads; j++) {
+            keys.push_back("ready_" + std::to_string(j));
+          }
+          c10d::test::set(*clientStores[i], keys[i], "1");
+          clientStores[i]->wait(keys);
+
           sem1.post();
           sem2.wait();
           // Check the counter results
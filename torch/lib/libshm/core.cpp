@@ -1,6 +1,11 @@
+#include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <mutex>
+#include <random>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <TH/TH.h>
 #include <libshm/err.h>
@@ -124,3 +129,241 @@ at::DataPtr THManagedMapAllocator::makeDataPtr(const char* manager_handle, const
 THManagedMapAllocator* THManagedMapAllocator::fromDataPtr(const at::DataPtr& dptr) {
   return dptr.cast_context<THManagedMapAllocator>(&deleteTHManagedMapAllocator);
 }
+
+// Pooled chunks.  Slab layout, after the THRefcountedMapAllocator header:
+//
+//   | ChunkHeader | data ... | ChunkHeader | data ... | ...
+//   <-------- chunk --------> <-------- chunk -------->
+//
+// The chunk size is the storage size plus the header, rounded up to a power
+// of two, and the slab size follows from the chunk size, so a process opening
+// a chunk knows how much of the slab to map from the storage size alone.
+
+namespace {
+
+constexpr ptrdiff_t kChunkHeaderSize = 64;  // keeps the data 64-byte aligned
+constexpr ptrdiff_t kMinChunkSize = 4096;
+constexpr ptrdiff_t kMaxChunkSize = 64 << 20;  // larger storages aren't pooled
+constexpr ptrdiff_t kMinSlabSize = 16 << 20;
+
+struct ChunkHeader {
+  std::atomic<int> refcount;
+};
+
+ptrdiff_t chunk_size(ptrdiff_t size) {
+  ptrdiff_t chunk = kMinChunkSize;
+  while (chunk < size + kChunkHeaderSize) {
+    chunk *= 2;
+  }
+  return chunk;
+}
+
+ptrdiff_t slab_size(ptrdiff_t chunk) {
+  return std::max(kMinSlabSize, chunk);
+}
+
+std::string new_slab_handle() {
+  static std::random_device rd;
+  std::string handle = "/torch_";
+  handle += std::to_string(getpid());
+  handle += "_slab_";
+  handle += std::to_string(rd());
+  return handle;
+}
+
+} // namespace
+
+struct THManagedSlab {
+  THManagedSlab(const char* manager_handle, const char* filename, int flags, ptrdiff_t size)
+    : mapping(new THManagedMapAllocator(manager_handle, filename, flags, size)), pid(getpid()) {}
+
+  ~THManagedSlab() {
+    // A forked child must not drop the refcounts of its parent's mappings
+    if (getpid() != pid) {
+      mapping.release();
+    }
+  }
+
+  ChunkHeader* header(ptrdiff_t offset) const {
+    return reinterpret_cast<ChunkHeader*>(static_cast<char*>(mapping->data()) + offset);
+  }
+
+  std::unique_ptr<THManagedMapAllocator> mapping;
+  pid_t pid;
+};
+
+namespace {
+
+struct PooledSlab {
+  std::shared_ptr<THManagedSlab> slab;
+  std::vector<ptrdiff_t> free_chunks;
+  std::vector<ptrdiff_t> used_chunks;
+
+  // Moves the chunks freed since the last sweep (possibly by other processes)
+  // back to the free list
+  void sweep() {
+    auto it = std::partition(used_chunks.begin(), used_chunks.end(),
+        [this](ptrdiff_t offset) { return slab->header(offset)->refcount.load() != 0; });
+    free_chunks.insert(free_chunks.end(), it, used_chunks.end());
+    used_chunks.erase(it, used_chunks.end());
+  }
+};
+
+struct SlabPool {
+  std::mutex mutex;
+  pid_t pid = getpid();
+  // Slabs allocated by this process, by chunk size
+  std::unordered_map<ptrdiff_t, std::vector<PooledSlab>> pooled_slabs;
+  // Slabs mapped by this process, by filename
+  std::unordered_map<std::string, std::weak_ptr<THManagedSlab>> open_slabs;
+
+  // Precondition: mutex is locked
+  void check_fork() {
+    if (getpid() != pid) {
+      // The slabs belong to the parent, which keeps allocating from them
+      pooled_slabs.clear();
+      open_slabs.clear();
+      pid = getpid();
+    }
+  }
+
+  // Precondition: mutex is locked
+  void add_open_slab(const std::string& filename, const std::shared_ptr<THManagedSlab>& slab) {
+    for (auto it = open_slabs.begin(); it != open_slabs.end();) {
+      if (it->second.expired()) {
+        it = open_slabs.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    open_slabs[filename] = slab;
+  }
+};
+
+SlabPool& slab_pool() {
+  // Leaked, so that it's never destroyed after the manager sockets
+  static SlabPool* pool = new SlabPool();
+  return *pool;
+}
+
+void deleteTHManagedMapChunk(void* ptr) {
+  delete static_cast<THManagedMapChunk*>(ptr);
+}
+
+at::DataPtr make_chunk_data_ptr(std::shared_ptr<THManagedSlab> slab, ptrdiff_t offset) {
+  auto* context = new THManagedMapChunk(std::move(slab), offset);
+  return {context->data(), context, &deleteTHManagedMapChunk, at::DeviceType::CPU};
+}
+
+} // namespace
+
+THManagedMapChunk::THManagedMapChunk(std::shared_ptr<THManagedSlab> slab, ptrdiff_t offset)
+  : slab_(std::move(slab)), offset_(offset), pid_(getpid()) {}
+
+THManagedMapChunk::~THManagedMapChunk() {
+  if (getpid() == pid_) {
+    --slab_->header(offset_)->refcount;
+  }
+}
+
+void THManagedMapChunk::incref() {
+  ++slab_->header(offset_)->refcount;
+  slab_->mapping->incref();
+}
+
+void THManagedMapChunk::decref() {
+  --slab_->header(offset_)->refcount;
+  slab_->mapping->decref();
+}
+
+void* THManagedMapChunk::data() const {
+  return reinterpret_cast<char*>(slab_->header(offset_)) + kChunkHeaderSize;
+}
+
+const char* THManagedMapChunk::manager_handle() const {
+  return slab_->mapping->manager_handle();
+}
+
+const char* THManagedMapChunk::filename() const {
+  return slab_->mapping->filename();
+}
+
+at::DataPtr THManagedMapChunk::makeDataPtr(ptrdiff_t size) {
+  if (size <= 0 || size + kChunkHeaderSize > kMaxChunkSize) {
+    return at::DataPtr();
+  }
+  const ptrdiff_t chunk = chunk_size(size);
+  auto& pool = slab_pool();
+  std::lock_guard<std::mutex> guard(pool.mutex);
+  pool.check_fork();
+  auto& slabs = pool.pooled_slabs[chunk];
+  for (auto& pooled : slabs) {
+    // Recycled chunks go to the back of the free list, so they're reused
+    // before the pages of chunks that were never touched
+    pooled.sweep();
+    if (!pooled.free_chunks.empty()) {
+      ptrdiff_t offset = pooled.free_chunks.back();
+      pooled.free_chunks.pop_back();
+      pooled.used_chunks.push_back(offset);
+      pooled.slab->header(offset)->refcount = 1;
+      return make_chunk_data_ptr(pooled.slab, offset);
+    }
+  }
+
+  const ptrdiff_t slab_bytes = slab_size(chunk);
+  int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE;
+  std::string handle = new_slab_handle();
+  PooledSlab pooled;
+  pooled.slab = std::make_shared<THManagedSlab>("", handle.c_str(), flags, slab_bytes);
+  // Hand out the chunks from the start of the slab
+  for (ptrdiff_t offset = slab_bytes - chunk; offset >= 0; offset -= chunk) {
+    pooled.free_chunks.push_back(offset);
+  }
+  ptrdiff_t offset = pooled.free_chunks.back();
+  pooled.free_chunks.pop_back();
+  pooled.used_chunks.push_back(offset);
+  new (&pooled.slab->header(offset)->refcount) std::atomic<int>(1);
+  for (ptrdiff_t other : pooled.free_chunks) {
+    new (&pooled.slab->header(other)->refcount) std::atomic<int>(0);
+  }
+  pool.add_open_slab(handle, pooled.slab);
+  auto slab = pooled.slab;
+  slabs.push_back(std::move(pooled));
+  return make_chunk_data_ptr(std::move(slab), offset);
+}
+
+at::DataPtr THManagedMapChunk::openDataPtr(const char* manager_handle, const char* filename, ptrdiff_t offset, ptrdiff_t size) {
+  const ptrdiff_t chunk = chunk_size(size);
+  const ptrdiff_t slab_bytes = slab_size(chunk);
+  if (size <= 0 || offset < 0 || offset % chunk != 0 || offset + chunk > slab_bytes) {
+    THError("invalid shared memory chunk at offset %td of size %td", offset, size);
+  }
+  std::shared_ptr<THManagedSlab> slab;
+  {
+    auto& pool = slab_pool();
+    std::lock_guard<std::mutex> guard(pool.mutex);
+    pool.check_fork();
+    auto it = pool.open_slabs.find(filename);
+    if (it != pool.open_slabs.end()) {
+      slab = it->second.lock();
+    }
+    if (!slab) {
+      int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+      slab = std::make_shared<THManagedSlab>(manager_handle, filename, flags, slab_bytes);
+      pool.add_open_slab(filename, slab);
+    }
+  }
+  ++slab->header(offset)->refcount;
+  return make_chunk_data_ptr(std::move(slab), offset);
+}
+
+THManagedMapChunk* THManagedMapChunk::fromDataPtr(const at::DataPtr& dptr) {
+  return dptr.cast_context<THManagedMapChunk>(&deleteTHManagedMapChunk);
+}
+
+void THManagedMapChunk::releasePool() {
+  auto& pool = slab_pool();
+  std::lock_guard<std::mutex> guard(pool.mutex);
+  pool.check_fork();
+  pool.pooled_slabs.clear();
+}
@@ -4,6 +4,9 @@
 
 #ifdef __cplusplus
 
+#include <memory>
+#include <unistd.h>
+
 void libshm_init(const char *manager_exec_path);
 
 // Superclass to run a constructor before THRefcountedMapAllocator
@@ -30,4 +33,48 @@ public:
   const char* manager_handle() const { return manager_handle_.c_str(); }
 };
 
+struct THManagedSlab;
+
+// A storage carved out of a pooled shared memory slab.
+//
+// Giving every shared storage its own THManagedMapAllocator costs an
+// shm_open, an ftruncate and an mmap per storage (e.g. per batch sent by a
+// DataLoader worker), and fills /dev/shm with small segments.  Instead, each
+// process keeps a pool of long-lived slabs, each of them a managed segment
+// split into chunks of one power-of-two size, and hands out chunks.  Every
+// chunk starts with a refcount in shared memory, which counts the storages
+// using the chunk in all processes, plus the references in flight between
+// processes (incref/decref, which also keep the slab alive).  Once it drops
+// to zero, the producing process reuses the chunk.
+class THManagedMapChunk {
+public:
+  // Allocates a chunk of at least size bytes from this process' pool.
+  // Returns an empty DataPtr if size is too large (or too small) to be pooled.
+  static at::DataPtr makeDataPtr(ptrdiff_t size);
+  // Maps the chunk at offset of the slab filename, shared by another process.
+  static at::DataPtr openDataPtr(const char* manager_handle, const char* filename, ptrdiff_t offset, ptrdiff_t size);
+  static THManagedMapChunk* fromDataPtr(const at::DataPtr&);
+  // Drops this process' hold on the slabs of its pool, so that their
+  // segments are freed once no storage uses them anymore.  Chunks that are
+  // still in use stay valid.  Processes that exit without running static
+  // destructors (like multiprocessing workers) should call this first.
+  static void releasePool();
+
+  THManagedMapChunk(std::shared_ptr<THManagedSlab> slab, ptrdiff_t offset);
+  ~THManagedMapChunk();
+
+  void incref();
+  void decref();
+
+  void* data() const;
+  const char* manager_handle() const;
+  const char* filename() const;
+  ptrdiff_t offset() const { return offset_; }
+
+private:
+  std::shared_ptr<THManagedSlab> slab_;
+  ptrdiff_t offset_;
+  pid_t pid_;
+};
+
 #endif
@@ -23,4 +23,24 @@ public:
   const char* manager_handle() const { return "no_manager"; }
 };
 
+// Shared memory slabs aren't pooled on Windows: makeDataPtr always returns an
+// empty DataPtr, so every storage gets its own THManagedMapAllocator.
+class THManagedMapChunk {
+public:
+  static at::DataPtr makeDataPtr(ptrdiff_t size) { return at::DataPtr(); }
+  static at::DataPtr openDataPtr(const char* manager_handle, const char* filename, ptrdiff_t offset, ptrdiff_t size) {
+    AT_ERROR("pooled shared memory chunks are not supported on Windows");
+  }
+  static THManagedMapChunk* fromDataPtr(const at::DataPtr&) { return nullptr; }
+  static void releasePool() {}
+
+  void incref() {}
+  void decref() {}
+
+  void* data() const { return nullptr; }
+  const char* manager_handle() const { return "no_manager"; }
+  const char* filename() const { return ""; }
+  ptrdiff_t offset() const { return 0; }
+};
+
 #endif
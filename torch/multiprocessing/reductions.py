@@ -3,6 +3,7 @@ import torch.utils.hooks
 import os
 import threading
 import multiprocessing
+import multiprocessing.util
 from multiprocessing.reduction import ForkingPickler
 import sys
 try:
@@ -285,12 +286,36 @@ def rebuild_storage_fd(cls, df, size):
         os.close(fd)
 
 
-def rebuild_storage_filename(cls, manager, handle, size):
-    storage = storage_from_cache(cls, handle)
+_shm_pool_release_pid = None
+
+
+def _release_shm_pool_at_exit():
+    r"""Makes this process let go of its pooled shared memory slabs on exit.
+
+    In file_system mode, storages are carved out of shared memory slabs that
+    every process keeps around for reuse. Processes started by multiprocessing
+    exit without running C++ static destructors, so the slabs are released by
+    a multiprocessing finalizer, which is registered once per process.
+    """
+    global _shm_pool_release_pid
+    pid = os.getpid()
+    if _shm_pool_release_pid != pid:
+        _shm_pool_release_pid = pid
+        multiprocessing.util.Finalize(None, torch._C._release_shm_pool, exitpriority=-10)
+
+
+def rebuild_storage_filename(cls, manager, handle, size, offset=None):
+    # Storages carved out of a pooled shared memory slab come with their
+    # offset in the slab
+    cache_key = handle if offset is None else (handle, offset)
+    storage = storage_from_cache(cls, cache_key)
     if storage is not None:
         return storage._shared_decref()
-    storage = cls._new_shared_filename(manager, handle, size)
-    shared_cache[handle] = StorageWeakRef(storage)
+    if offset is None:
+        storage = cls._new_shared_filename(manager, handle, size)
+    else:
+        storage = cls._new_shared_filename(manager, handle, size, offset)
+    shared_cache[cache_key] = StorageWeakRef(storage)
     return storage._shared_decref()
 
 
@@ -303,8 +328,9 @@ def reduce_storage(storage):
     if storage.is_cuda:
         raise RuntimeError("Cannot pickle CUDA storage; try pickling a CUDA tensor instead")
     elif get_sharing_strategy() == 'file_system':
+        _release_shm_pool_at_exit()
         metadata = storage._share_filename_()
-        cache_key = metadata[1]
+        cache_key = metadata[1] if len(metadata) == 3 else (metadata[1], metadata[3])
         rebuild = rebuild_storage_filename
         storage._shared_incref()
     elif storage.size() == 0:
@@ -6,16 +6,14 @@ from .._jit_internal import weak_script
 @weak_script
 def get_enum(qscheme):
     # type: (str) -> int
-    if qscheme == 'none':
+    if qscheme == 'per_tensor_affine':
         ret = 0
-    elif qscheme == 'per_tensor_affine':
-        ret = 1
     elif qscheme == 'per_channel_affine':
-        ret = 2
+        ret = 1
     elif qscheme == 'per_tensor_symmetric':
-        ret = 3
+        ret = 2
     elif qscheme == 'per_channel_symmetric':
-        ret = 4
+        ret = 3
     else:
         raise ValueError(qscheme + " is not a valid value for qscheme")
     return ret
@@ -1725,6 +1725,23 @@ def layer_norm(input, normalized_shape, weight=None, bias=None, eps=1e-5):
                             torch.backends.cudnn.enabled)
 
 
+@weak_script
+def dropout_add_layer_norm(input, residual, normalized_shape, weight=None, bias=None,
+                           p=0.5, training=True, eps=1e-5):
+    # type: (Tensor, Tensor, List[int], Optional[Tensor], Optional[Tensor], float, bool, float) -> Tensor
+    r"""Computes ``layer_norm(dropout(input, p, training) + residual, normalized_shape,
+    weight, bias, eps)``, as at the end of the sublayers of Transformer blocks.
+
+    On CUDA, this runs as a single kernel, which keeps the dropout mask as one
+    bit per element for the backward. ``input`` and ``residual`` must have the
+    same shape.
+
+    See :func:`dropout` and :class:`~torch.nn.LayerNorm` for details.
+    """
+    return torch.dropout_add_layer_norm(input, residual, normalized_shape, weight, bias,
+                                        p, training, eps)
+
+
 @weak_script
 def group_norm(input, num_groups, weight=None, bias=None, eps=1e-5):
     # type: (Tensor, int, Optional[Tensor], Optional[Tensor], float) -> Tensor
@@ -2044,6 +2061,11 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
             and :attr:`reduce` are in the process of being deprecated, and in the meantime,
             specifying either of those two args will override :attr:`reduction`. Default: ``'mean'``
 
+    .. note::
+        For CUDA inputs of shape :math:`(N, C)` with :math:`C \geq 4096`, the loss
+        is computed by a single kernel that doesn't store the output of `log_softmax`.
+        Its gradient can't be differentiated again.
+
     Examples::
 
         >>> input = torch.randn(3, 5, requires_grad=True)
@@ -2053,6 +2075,11 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
     """
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
+    if input.is_cuda and input.dim() == 2 and input.size(1) >= 4096:
+        # Large numbers of classes, e.g. the vocabulary of a language model:
+        # computes the loss without materializing log_softmax(input)
+        return torch._log_softmax_nll_loss(input, target, weight, _Reduction.get_enum(reduction),
+                                           ignore_index)[0]
     return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
 
 
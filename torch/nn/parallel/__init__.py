@@ -4,7 +4,9 @@ from .data_parallel import DataParallel, data_parallel
 from .scatter_gather import scatter, gather
 from .distributed import DistributedDataParallel
 from .distributed_cpu import DistributedDataParallelCPU
+from .pipeline import Pipeline, partition, balance_by_time
 import torch.nn.parallel.deprecated  # noqa: F401
 
 __all__ = ['replicate', 'scatter', 'parallel_apply', 'gather', 'data_parallel',
-           'DataParallel', 'DistributedDataParallel', 'DistributedDataParallelCPU']
+           'DataParallel', 'DistributedDataParallel', 'DistributedDataParallelCPU',
+           'Pipeline', 'partition', 'balance_by_time']
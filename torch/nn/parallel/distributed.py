@@ -208,6 +208,14 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        gradient_as_bucket_view (bool): when set to ``True``, the ``.grad`` of
+                                        the parameters are views into the
+                                        flattened buckets that are
+                                        all-reduced, so that the gradients are
+                                        accumulated in place and not copied
+                                        into the buckets and back. This halves
+                                        the memory taken by gradients.
+                                        (default: ``False``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -221,7 +229,8 @@ class DistributedDataParallel(Module):
                  output_device=None, dim=0, broadcast_buffers=True,
                  process_group=None, bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 gradient_as_bucket_view=False):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -264,6 +273,7 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.gradient_as_bucket_view = gradient_as_bucket_view
 
         if check_reduction:
             # This argument is no longer used since the reducer
@@ -325,17 +335,22 @@ class DistributedDataParallel(Module):
         # that are defined first, such that their gradients don't spill into
         # a much larger bucket, adding unnecessary latency after gradient
         # computation finishes. Experiments showed 1MB is a reasonable value.
+        bucket_size_limits = [1024 * 1024, self.bucket_bytes_cap]
         bucket_indices = dist._compute_bucket_assignment_by_size(
             param_list[0],
-            [1024 * 1024, self.bucket_bytes_cap])
+            bucket_size_limits)
 
         # Note: reverse list of buckets because we want to approximate the
         # order in which their gradients are produced, and assume they
         # are used in the forward pass in the order they are defined.
+        # The reducer records the actual order in the first iteration and
+        # rebuilds the buckets accordingly, with the same size limits.
         self.reducer = dist.Reducer(
             param_list,
             list(reversed(bucket_indices)),
-            self.process_group)
+            self.process_group,
+            bucket_size_limits,
+            self.gradient_as_bucket_view)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -406,6 +421,17 @@ class DistributedDataParallel(Module):
         for module in self._module_copies[1:]:
             module.train(mode)
 
+    def _register_comm_hook(self, hook):
+        r"""Replaces the allreduce of every gradient bucket by a
+        communication hook, e.g. ``dist._FP16CompressCommHook(process_group)``
+        to send gradients in half precision, ``dist._TopKCompressCommHook``
+        or ``dist._PowerSGDCommHook``. The compressing hooks keep the part of
+        the gradient they don't send and add it back in the next iteration.
+
+        Must be called before the first backward pass, at most once.
+        """
+        self.reducer.register_comm_hook(hook)
+
     def _dist_broadcast_coalesced(self, tensors, buffer_size):
         dist._dist_broadcast_coalesced(self.process_group, tensors, buffer_size, False)
 
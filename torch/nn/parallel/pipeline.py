@@ -0,0 +1,389 @@
+from collections import OrderedDict
+
+import torch
+import torch.distributed as dist
+from torch.autograd import profiler
+from torch.nn.modules import Module, Sequential
+from torch.utils.checkpoint import get_device_states, set_device_states
+
+
+# The dtypes of the activations that can be sent between stages, indexed by the
+# code sent in the header of an activation.
+_DTYPES = [torch.float32, torch.float64, torch.float16, torch.uint8,
+           torch.int8, torch.int16, torch.int32, torch.int64, torch.bool]
+
+# Activations flow to the next stage and their gradients to the previous one,
+# each with its own tag, so a message is always matched by the next receive
+# of its kind from the same peer.
+_ACTIVATION_TAG = 0
+_GRADIENT_TAG = 1
+
+
+def partition(module, balance):
+    r"""Splits a :class:`~torch.nn.Sequential` into consecutive stages.
+
+    Arguments:
+        module (Sequential): the module to split.
+        balance (list of int): the number of layers of each stage, which sum
+            to the number of layers of :attr:`module`.
+
+    Returns:
+        A list of :class:`~torch.nn.Sequential`, one per stage, that share the
+        layers of :attr:`module`.
+    """
+    if not isinstance(module, Sequential):
+        raise TypeError("partition expects a Sequential module, got {}"
+                        .format(type(module).__name__))
+    if sum(balance) != len(module) or any(n <= 0 for n in balance):
+        raise ValueError("balance {} does not split the {} layers of the module "
+                         "into non-empty stages".format(balance, len(module)))
+    layers = list(module.named_children())
+    stages = []
+    begin = 0
+    for n in balance:
+        stages.append(Sequential(OrderedDict(layers[begin:begin + n])))
+        begin += n
+    return stages
+
+
+def _profile_layers(module, sample, repeat):
+    # Returns the time in microseconds that each layer of module takes to run
+    # forward and backward on sample, according to the autograd profiler: the
+    # time of the kernels of the outermost operators on CUDA, and the time of
+    # all the operators on CPU otherwise.
+    use_cuda = sample.is_cuda
+    costs = [0.] * len(module)
+    for _ in range(repeat):
+        x = sample.detach().requires_grad_(sample.is_floating_point())
+        for i, layer in enumerate(module):
+            with profiler.profile(use_cuda=use_cuda) as prof:
+                y = layer(x)
+                if y.requires_grad:
+                    torch.autograd.backward(y, torch.ones_like(y))
+            events = prof.function_events
+            if use_cuda:
+                events.populate_cpu_children()
+                children = set(id(c) for e in events for c in e.cpu_children)
+                costs[i] += sum(e.cuda_time_total for e in events
+                                if id(e) not in children)
+            else:
+                costs[i] += events.self_cpu_time_total
+            x = y.detach().requires_grad_(y.is_floating_point())
+    return costs
+
+
+def _split_costs(costs, partitions):
+    # Splits costs into partitions consecutive non-empty groups that minimize
+    # the largest sum of a group, and returns the size of each group.
+    n = len(costs)
+    prefix = [0.]
+    for c in costs:
+        prefix.append(prefix[-1] + c)
+    inf = float('inf')
+    # best[p][i] is the smallest largest sum of splitting the first i costs
+    # into p groups, and cut[p][i] the start of the last of these groups.
+    best = [[inf] * (n + 1) for _ in range(partitions + 1)]
+    cut = [[0] * (n + 1) for _ in range(partitions + 1)]
+    best[0][0] = 0.
+    for p in range(1, partitions + 1):
+        for i in range(p, n + 1):
+            for j in range(p - 1, i):
+                cost = max(best[p - 1][j], prefix[i] - prefix[j])
+                if cost < best[p][i]:
+                    best[p][i] = cost
+                    cut[p][i] = j
+    balance = []
+    i = n
+    for p in range(partitions, 0, -1):
+        balance.append(i - cut[p][i])
+        i = cut[p][i]
+    return list(reversed(balance))
+
+
+def balance_by_time(module, sample, partitions, repeat=1):
+    r"""Computes a balance for :func:`partition` from the time the layers of a
+    :class:`~torch.nn.Sequential` take to run forward and backward on a
+    micro-batch, as measured by the autograd profiler (on CUDA when
+    :attr:`sample` is a CUDA tensor).
+
+    The layers are split into :attr:`partitions` consecutive stages so that
+    the slowest stage, which sets the pace of the pipeline, is as fast as
+    possible.
+
+    Arguments:
+        module (Sequential): the module to balance, on the device of
+            :attr:`sample`.
+        sample (Tensor): a micro-batch of the input of :attr:`module`.
+        partitions (int): the number of stages.
+        repeat (int, optional): the number of runs the timings are summed
+            over (default: 1).
+
+    Returns:
+        A list of :attr:`partitions` numbers of layers.
+
+    Example::
+
+        >>> balance = balance_by_time(model, torch.randn(8, 1024), 4)
+        >>> stage = partition(model, balance)[dist.get_rank()]
+    """
+    if partitions > len(module):
+        raise ValueError("cannot split {} layers into {} stages"
+                         .format(len(module), partitions))
+    return _split_costs(_profile_layers(module, sample, repeat), partitions)
+
+
+class Pipeline(Module):
+    r"""Implements pipeline parallelism over the point-to-point operations of a
+    process group.
+
+    Every process of the group runs one stage of the model, in the order of
+    their ranks in the group: the first stage takes the batches, and the last
+    one computes the loss. Each batch is cut into :attr:`chunks` micro-batches
+    along the batch dimension, and the stages run the forward and backward
+    passes of different micro-batches at the same time, sending activations to
+    the next stage and their gradients to the previous one.
+
+    There are two schedules:
+
+    * ``'gpipe'`` runs the forward passes of all the micro-batches, then
+      their backward passes. A stage holds the activations of every
+      micro-batch of the batch.
+    * ``'1f1b'`` starts the backward pass of a micro-batch as soon as it
+      comes back from the last stage, alternating with the forward passes of
+      the next micro-batches. A stage holds the activations of at most as many
+      micro-batches as there are stages after it, whatever the number of
+      micro-batches.
+
+    With :attr:`checkpoint`, a stage stashes only the input of each
+    micro-batch, and recomputes its forward pass before the backward pass, so
+    only the activations of one micro-batch are held at a time.
+
+    The gradients of the parameters of a stage are accumulated over the
+    micro-batches, as for a single backward pass through the whole batch when
+    the loss averages over the batch.
+
+    Creation of this class requires the distributed package to be already
+    initialized in the process group mode
+    (see :func:`torch.distributed.init_process_group`). Activations are sent
+    through host memory, so any backend that implements
+    :func:`~torch.distributed.send` and :func:`~torch.distributed.recv` for CPU
+    tensors can be used, such as ``gloo``.
+
+    .. warning::
+        The activations passed between stages must be single tensors with the
+        batch dimension first, and the model must not depend on the other
+        samples of its batch (e.g. ``BatchNorm`` in training mode), since it
+        only sees a micro-batch.
+
+    .. warning::
+        :meth:`run_batch` is a synchronization point between the stages: all
+        of them must call it for every batch, with the same number of
+        micro-batches.
+
+    Arguments:
+        module (Module): the stage of the model run by this process, e.g. one
+            of the modules returned by :func:`partition`.
+        chunks (int): the number of micro-batches a batch is cut into.
+        schedule (str, optional): ``'1f1b'`` or ``'gpipe'``
+            (default: ``'1f1b'``).
+        checkpoint (bool, optional): recompute the forward pass of the
+            micro-batches in their backward pass instead of holding their
+            activations (default: ``False``).
+        group (ProcessGroup, optional): the process group of the stages
+            (default: the default process group).
+
+    Example::
+
+        >>> torch.distributed.init_process_group(backend='gloo', ...)
+        >>> stages = partition(model, balance)
+        >>> pipe = Pipeline(stages[dist.get_rank()], chunks=8)
+        >>> # on the first stage
+        >>> pipe.run_batch(input=batch)
+        >>> # on the last stage
+        >>> loss = pipe.run_batch(target=target, loss_fn=F.cross_entropy)
+        >>> # on every stage
+        >>> optimizer.step()
+    """
+
+    def __init__(self, module, chunks, schedule='1f1b', checkpoint=False,
+                 group=dist.group.WORLD):
+        super(Pipeline, self).__init__()
+        if chunks <= 0:
+            raise ValueError("chunks must be positive, got {}".format(chunks))
+        if schedule not in ('1f1b', 'gpipe'):
+            raise ValueError("Unknown pipeline schedule {}".format(schedule))
+        self.module = module
+        self.chunks = chunks
+        self.schedule = schedule
+        self.checkpoint = checkpoint
+        self.group = group
+        self.stage = dist.get_rank(group)
+        self.num_stages = dist.get_world_size(group)
+
+    def _global_rank(self, stage):
+        if self.group is dist.group.WORLD:
+            return stage
+        return dist.distributed_c10d._get_global_rank(self.group, stage)
+
+    def _device(self):
+        for p in self.module.parameters():
+            return p.device
+        return torch.device('cpu')
+
+    def is_first_stage(self):
+        return self.stage == 0
+
+    def is_last_stage(self):
+        return self.stage == self.num_stages - 1
+
+    def forward(self, input):
+        r"""Runs the stage on :attr:`input`, without pipelining."""
+        return self.module(input)
+
+    def _send(self, tensor, stage, tag, header):
+        # Returns the works of the isends, which hold the sent tensors until
+        # they are waited for.
+        tensor = tensor.detach().cpu().contiguous()
+        dst = self._global_rank(stage)
+        works = []
+        if header:
+            shape = torch.tensor([_DTYPES.index(tensor.dtype)] + list(tensor.size()))
+            works.append(dist.isend(torch.tensor([shape.numel()]), dst, self.group, tag))
+            works.append(dist.isend(shape, dst, self.group, tag))
+        works.append(dist.isend(tensor, dst, self.group, tag))
+        return works
+
+    def _recv_activation(self):
+        src = self._global_rank(self.stage - 1)
+        length = torch.zeros(1, dtype=torch.long)
+        dist.recv(length, src, self.group, _ACTIVATION_TAG)
+        shape = torch.zeros(int(length.item()), dtype=torch.long)
+        dist.recv(shape, src, self.group, _ACTIVATION_TAG)
+        shape = shape.tolist()
+        tensor = torch.empty(shape[1:], dtype=_DTYPES[shape[0]])
+        dist.recv(tensor, src, self.group, _ACTIVATION_TAG)
+        return tensor.to(self._device())
+
+    def _recv_gradient(self, like):
+        src = self._global_rank(self.stage + 1)
+        tensor = torch.empty(like.size(), dtype=like.dtype)
+        dist.recv(tensor, src, self.group, _GRADIENT_TAG)
+        return tensor.to(like.device)
+
+    def _forward_step(self, input, target, loss_fn, stash, works):
+        if self.is_first_stage():
+            x = input
+        else:
+            x = self._recv_activation()
+            x.requires_grad_(x.is_floating_point())
+        if self.checkpoint:
+            # The recomputation must draw the same random numbers, e.g. for
+            # dropout.
+            rng_state = (torch.get_rng_state(),) + get_device_states(x)
+            with torch.no_grad():
+                y = self.module(x)
+        else:
+            y = self.module(x)
+        if self.is_last_stage():
+            y = loss_fn(y, target) / self.chunks
+        else:
+            works.extend(self._send(y, self.stage + 1, _ACTIVATION_TAG, header=True))
+        if self.checkpoint:
+            stash.append((x, None, rng_state))
+        else:
+            stash.append((x, y, None))
+        return y.detach() if self.is_last_stage() else None
+
+    def _recompute(self, x, target, loss_fn, rng_state):
+        cpu_state, devices, device_states = rng_state
+        with torch.random.fork_rng(devices=devices), torch.enable_grad():
+            torch.set_rng_state(cpu_state)
+            set_device_states(devices, device_states)
+            y = self.module(x)
+            if self.is_last_stage():
+                y = loss_fn(y, target) / self.chunks
+        return y
+
+    def _backward_step(self, target, loss_fn, stash, works):
+        x, y, rng_state = stash.pop(0)
+        if y is None:
+            y = self._recompute(x, target, loss_fn, rng_state)
+        grad = None if self.is_last_stage() else self._recv_gradient(y)
+        if y.requires_grad:
+            torch.autograd.backward(y, grad)
+        if not self.is_first_stage():
+            # The previous stage waits for a gradient even if its output does
+            # not contribute to the loss.
+            grad = x.grad if x.grad is not None else torch.zeros_like(x)
+            works.extend(self._send(grad, self.stage - 1, _GRADIENT_TAG, header=False))
+
+    def run_batch(self, input=None, target=None, loss_fn=None):
+        r"""Runs the forward and backward passes of a batch through the
+        pipeline, accumulating the gradients of the parameters of the stage.
+
+        Arguments:
+            input (Tensor, optional): the batch, given to the first stage only.
+            target (Tensor, optional): the target of the batch, given to the
+                last stage only.
+            loss_fn (callable, optional): called by the last stage on its
+                output and the target of every micro-batch; returns the loss
+                averaged over the micro-batch.
+
+        Returns:
+            On the last stage, the loss of the batch, averaged over the
+            micro-batches. ``None`` on the other stages.
+        """
+        if self.is_first_stage():
+            if input is None:
+                raise ValueError("The first stage of the pipeline takes the input")
+            inputs = input.chunk(self.chunks)
+            if len(inputs) != self.chunks:
+                raise ValueError("Cannot cut a batch of {} samples into {} "
+                                 "micro-batches".format(input.size(0), self.chunks))
+        if self.is_last_stage():
+            if target is None or loss_fn is None:
+                raise ValueError("The last stage of the pipeline takes the "
+                                 "target and the loss function")
+            targets = target.chunk(self.chunks)
+            if len(targets) != self.chunks:
+                raise ValueError("Cannot cut a batch of {} targets into {} "
+                                 "micro-batches".format(target.size(0), self.chunks))
+
+        def input_of(i):
+            return inputs[i] if self.is_first_stage() else None
+
+        def target_of(i):
+            return targets[i] if self.is_last_stage() else None
+
+        # The stashed (input, output, rng state) of the micro-batches whose
+        # backward pass is yet to run, in order. With checkpointing, the output
+        # is None and the rng state is that of the forward pass.
+        stash = []
+        works = []
+        losses = []
+
+        def forward(i):
+            loss = self._forward_step(input_of(i), target_of(i), loss_fn, stash, works)
+            if loss is not None:
+                losses.append(loss)
+
+        def backward(i):
+            self._backward_step(target_of(i), loss_fn, stash, works)
+
+        if self.schedule == 'gpipe':
+            warmup = self.chunks
+        else:
+            warmup = min(self.num_stages - self.stage - 1, self.chunks)
+        for i in range(warmup):
+            forward(i)
+        for i in range(self.chunks - warmup):
+            forward(warmup + i)
+            backward(i)
+        for i in range(self.chunks - warmup, self.chunks):
+            backward(i)
+
+        for work in works:
+            work.wait()
+        if self.is_last_stage():
+            return sum(losses)
+        return None
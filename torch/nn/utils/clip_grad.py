@@ -17,13 +17,20 @@ def clip_grad_norm_(parameters, max_norm, norm_type=2):
             infinity norm.
 
     Returns:
-        Total norm of the parameters (viewed as a single vector).
+        Total norm of the parameters (viewed as a single vector). Unless a
+        gradient is sparse, this is a 0-dim tensor on the device of the first
+        gradient, so that clipping does not wait for the device.
     """
     if isinstance(parameters, torch.Tensor):
         parameters = [parameters]
     parameters = list(filter(lambda p: p.grad is not None, parameters))
     max_norm = float(max_norm)
     norm_type = float(norm_type)
+    if not any(p.grad.is_sparse for p in parameters):
+        # Computes the norm and scales every gradient with a few fused
+        # kernels, without waiting for the device.
+        return torch._clip_grads_by_norm([p.grad.data for p in parameters],
+                                         max_norm, norm_type)
     if norm_type == inf:
         total_norm = max(p.grad.data.abs().max() for p in parameters)
     else:
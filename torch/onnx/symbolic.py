@@ -1658,7 +1658,7 @@ def detach(g, input):
     return input
 
 
-def contiguous(g, input):
+def contiguous(g, input, memory_format=None):
     return input
 
 
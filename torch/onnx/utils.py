@@ -56,7 +56,7 @@ def set_training(model, mode):
 def export(model, args, f, export_params=True, verbose=False, training=False,
            input_names=None, output_names=None, aten=False, export_raw_ir=False,
            operator_export_type=None, opset_version=None, _retain_param_name=True,
-           do_constant_folding=False, strip_doc_string=True):
+           do_constant_folding=False, strip_doc_string=True, use_external_data_format=False):
     r"""
     Export a model into ONNX format.  This exporter runs your model
     once in order to get a trace of its execution to be exported;
@@ -115,6 +115,12 @@ def export(model, args, f, export_params=True, verbose=False, training=False,
         strip_doc_string (bool, default True): if True, strips the field
             "doc_string" from the exported model, which information about the stack
             trace.
+        use_external_data_format (bool, default False): if True, every parameter
+            is written to a file of its own in the directory of ``f``, which must
+            then be a file name, and the model refers to them as ONNX external
+            data. This is needed to export models over the 2GB limit of protobuf,
+            and also keeps the parameters from being copied into the model in
+            memory.
     """
     if aten or export_raw_ir:
         assert operator_export_type is None
@@ -128,7 +134,7 @@ def export(model, args, f, export_params=True, verbose=False, training=False,
     _export(model, args, f, export_params, verbose, training, input_names, output_names,
             operator_export_type=operator_export_type, opset_version=opset_version,
             _retain_param_name=_retain_param_name, do_constant_folding=do_constant_folding,
-            strip_doc_string=strip_doc_string)
+            strip_doc_string=strip_doc_string, use_external_data_format=use_external_data_format)
 
 
 # ONNX can't handle constants that are lists of tensors, which can
@@ -347,7 +353,7 @@ def _export(model, args, f, export_params=True, verbose=False, training=False,
             input_names=None, output_names=None, operator_export_type=OperatorExportTypes.ONNX,
             export_type=ExportTypes.PROTOBUF_FILE, example_outputs=None, propagate=False,
             opset_version=None, _retain_param_name=False, do_constant_folding=False,
-            strip_doc_string=True):
+            strip_doc_string=True, use_external_data_format=False):
     global __IN_ONNX_EXPORT
     assert __IN_ONNX_EXPORT is False
     __IN_ONNX_EXPORT = True
@@ -364,9 +370,15 @@ def _export(model, args, f, export_params=True, verbose=False, training=False,
 
         # TODO: Don't allocate a in-memory string for the protobuf
         defer_weight_export = export_type is not ExportTypes.PROTOBUF_FILE
+        external_data_dir = ""
+        if use_external_data_format:
+            if export_type is not ExportTypes.PROTOBUF_FILE or not isinstance(f, string_classes):
+                raise RuntimeError("use_external_data_format requires f to be the name of a protobuf file")
+            import os
+            external_data_dir = os.path.dirname(os.path.abspath(f))
         if export_params:
             proto, export_map = graph._export_onnx(params_dict, opset_version, defer_weight_export, operator_export_type,
-                                                   strip_doc_string)
+                                                   strip_doc_string, external_data_dir)
         else:
             proto, export_map = graph._export_onnx({}, opset_version, False, operator_export_type, strip_doc_string)
 
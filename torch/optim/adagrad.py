@@ -14,12 +14,20 @@ class Adagrad(Optimizer):
         lr (float, optional): learning rate (default: 1e-2)
         lr_decay (float, optional): learning rate decay (default: 0)
         weight_decay (float, optional): weight decay (L2 penalty) (default: 0)
+        rowwise (boolean, optional): whether to keep a single accumulator per
+            row (the first dimension) of each parameter, updated with the mean
+            of the squared gradient over the row, instead of one per element
+            (default: False)
+
+    Sparse gradients of float CPU parameters are applied directly to the rows
+    they touch, without coalescing them first.
 
     .. _Adaptive Subgradient Methods for Online Learning and Stochastic
         Optimization: http://jmlr.org/papers/v12/duchi11a.html
     """
 
-    def __init__(self, params, lr=1e-2, lr_decay=0, weight_decay=0, initial_accumulator_value=0):
+    def __init__(self, params, lr=1e-2, lr_decay=0, weight_decay=0, initial_accumulator_value=0,
+                 rowwise=False):
         if not 0.0 <= lr:
             raise ValueError("Invalid learning rate: {}".format(lr))
         if not 0.0 <= lr_decay:
@@ -30,14 +38,17 @@ class Adagrad(Optimizer):
             raise ValueError("Invalid initial_accumulator_value value: {}".format(initial_accumulator_value))
 
         defaults = dict(lr=lr, lr_decay=lr_decay, weight_decay=weight_decay,
-                        initial_accumulator_value=initial_accumulator_value)
+                        initial_accumulator_value=initial_accumulator_value, rowwise=rowwise)
         super(Adagrad, self).__init__(params, defaults)
 
         for group in self.param_groups:
             for p in group['params']:
                 state = self.state[p]
                 state['step'] = 0
-                state['sum'] = torch.full_like(p.data, initial_accumulator_value)
+                if group['rowwise']:
+                    state['sum'] = p.data.new_full((p.size(0),), initial_accumulator_value)
+                else:
+                    state['sum'] = torch.full_like(p.data, initial_accumulator_value)
 
     def share_memory(self):
         for group in self.param_groups:
@@ -73,7 +84,17 @@ class Adagrad(Optimizer):
 
                 clr = group['lr'] / (1 + (state['step'] - 1) * group['lr_decay'])
 
-                if grad.is_sparse:
+                if grad.is_sparse and grad.sparse_dim() == 1 and not grad.is_cuda and \
+                        grad.dtype == torch.float and p.data.is_contiguous():
+                    torch._sparse_adagrad_(p.data, state['sum'], grad, clr)
+                elif group['rowwise']:
+                    if grad.is_sparse:
+                        grad = grad.to_dense()
+                    rows = p.size(0)
+                    state['sum'].add_(grad.pow(2).view(rows, -1).mean(1))
+                    std = state['sum'].sqrt().add_(1e-10)
+                    p.data.addcdiv_(-clr, grad, std.view((rows,) + (1,) * (p.dim() - 1)))
+                elif grad.is_sparse:
                     grad = grad.coalesce()  # the update is non-linear so indices must be unique
                     grad_indices = grad._indices()
                     grad_values = grad._values()
@@ -194,7 +194,7 @@ def _check_seekable(f):
         raise_err_msg(["seek", "tell"], e)
 
 
-def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
+def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL, direct_io=False):
     """Saves an object to a disk file.
 
     See also: :ref:`recommend-saving-models`
@@ -205,6 +205,9 @@ def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
            containing a file name
         pickle_module: module used for pickling metadata and objects
         pickle_protocol: can be specified to override the default protocol
+        direct_io: if ``True``, the storages written to a real file bypass the
+           page cache where possible, so that saving a large checkpoint doesn't
+           evict the cached pages of other processes (Linux and macOS only)
 
     .. warning::
         If you are using Python 2, torch.save does NOT support StringIO.StringIO
@@ -221,10 +224,10 @@ def save(obj, f, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
         >>> buffer = io.BytesIO()
         >>> torch.save(x, buffer)
     """
-    return _with_file_like(f, "wb", lambda f: _save(obj, f, pickle_module, pickle_protocol))
+    return _with_file_like(f, "wb", lambda f: _save(obj, f, pickle_module, pickle_protocol, direct_io))
 
 
-def _save(obj, f, pickle_module, pickle_protocol):
+def _save(obj, f, pickle_module, pickle_protocol, direct_io=False):
     if sys.version_info[0] == 2:
         import StringIO
         if isinstance(f, StringIO.StringIO):
@@ -299,8 +302,13 @@ def _save(obj, f, pickle_module, pickle_protocol):
     serialized_storage_keys = sorted(serialized_storages.keys())
     pickle_module.dump(serialized_storage_keys, f, protocol=pickle_protocol)
     f.flush()
-    for key in serialized_storage_keys:
-        serialized_storages[key]._write_file(f, _should_read_directly(f))
+    storages = [serialized_storages[key] for key in serialized_storage_keys]
+    if _should_read_directly(f):
+        # The copies from the GPU overlap with the writes, without the GIL
+        torch._C._write_storages(f.fileno(), storages, direct_io)
+    else:
+        for storage in storages:
+            storage._write_file(f, False)
 
 
 def load(f, map_location=None, pickle_module=pickle, **pickle_load_args):
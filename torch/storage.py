@@ -106,9 +106,11 @@ class _StorageBase(object):
         Returns: self
         """
         from torch.multiprocessing import get_sharing_strategy
+        from torch.multiprocessing.reductions import _release_shm_pool_at_exit
         if self.is_cuda:
             pass  # CUDA doesn't use POSIX shared memory
         elif get_sharing_strategy() == 'file_system':
+            _release_shm_pool_at_exit()
             self._share_filename_()
         else:
             self._share_fd_()
@@ -118,9 +120,11 @@ class _StorageBase(object):
     def _new_shared(cls, size):
         """Creates a new storage in shared memory with the same data type"""
         from torch.multiprocessing import get_sharing_strategy
+        from torch.multiprocessing.reductions import _release_shm_pool_at_exit
         if cls.is_cuda:
             return cls(size)
         elif get_sharing_strategy() == 'file_system':
+            _release_shm_pool_at_exit()
             return cls._new_using_filename(size)
         else:
             return cls._new_using_fd(size)